@@ -166,6 +166,7 @@ static jmethodID method_onPeriodicAdvertisingEnabled;
  */
 static jmethodID method_onScannerRegistered;
 static jmethodID method_onScanResult;
+static jmethodID method_onScanResultBatch;
 static jmethodID method_onScanFilterConfig;
 static jmethodID method_onScanFilterParamsConfigured;
 static jmethodID method_onScanFilterEnableDisabled;
@@ -202,6 +203,12 @@ static const btgatt_interface_t* sGattIf = NULL;
 static BleScannerInterface* sScanner = NULL;
 static jobject mCallbacksObj = NULL;
 static jobject mScanCallbacksObj = NULL;
+/** Direct buffer of ScanNativeInterface the scan result batches are written
+ * to, see ScanNativeInterface.onScanResultBatch() for the layout. */
+static jobject mScanResultBufferObj = NULL;
+static uint8_t* sScanResultBuffer = NULL;
+static size_t sScanResultBufferSize = 0;
+static constexpr size_t kScanResultHeaderSize = 18;
 static jobject mAdvertiseCallbacksObj = NULL;
 static jobject mPeriodicScanCallbacksObj = NULL;
 static jobject mDistanceMeasurementCallbacksObj = NULL;
@@ -542,21 +549,43 @@ void fillGattDbElementArray(JNIEnv* env, jobject* array,
   }
 }
 
+// Size of an element of the GATT database handed to onGetGattDb(), see
+// GattNativeInterface.onGetGattDb() for the layout
+static constexpr size_t kPackedGattDbElementSize = 26;
+
 void btgattc_get_gatt_db_cb(int conn_id, const btgatt_db_element_t* db,
                             int count) {
   std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
   CallbackEnv sCallbackEnv(__func__);
   if (!sCallbackEnv.valid() || !mCallbacksObj) return;
 
-  jclass arrayListclazz = sCallbackEnv->FindClass("java/util/ArrayList");
-  ScopedLocalRef<jobject> array(
-      sCallbackEnv.get(),
-      sCallbackEnv->NewObject(
-          arrayListclazz,
-          sCallbackEnv->GetMethodID(arrayListclazz, "<init>", "()V")));
+  // The database is packed and crosses JNI at once, rather than with one Java
+  // object built field by field for each element
+  std::vector<uint8_t> packed(count * kPackedGattDbElementSize);
+  uint8_t* p = packed.data();
+  auto put_u16 = [&p](uint16_t value) {
+    *p++ = value & 0xff;
+    *p++ = value >> 8;
+  };
+  auto put_u64 = [&p](uint64_t value) {
+    for (int i = 0; i < 8; i++) *p++ = (value >> (8 * i)) & 0xff;
+  };
+  for (int i = 0; i < count; i++) {
+    const btgatt_db_element_t& curr = db[i];
+    put_u16(curr.id);
+    *p++ = curr.type;
+    put_u16(curr.attribute_handle);
+    put_u16(curr.start_handle);
+    put_u16(curr.end_handle);
+    *p++ = curr.properties;
+    put_u64(uuid_msb(curr.uuid));
+    put_u64(uuid_lsb(curr.uuid));
+  }
 
-  jobject arrayPtr = array.get();
-  fillGattDbElementArray(sCallbackEnv.get(), &arrayPtr, db, count);
+  ScopedLocalRef<jbyteArray> array(sCallbackEnv.get(),
+                                   sCallbackEnv->NewByteArray(packed.size()));
+  sCallbackEnv->SetByteArrayRegion(array.get(), 0, packed.size(),
+                                   (jbyte*)packed.data());
 
   sCallbackEnv->CallVoidMethod(mCallbacksObj, method_onGetGattDb, conn_id,
                                array.get());
@@ -1037,6 +1066,86 @@ class JniScanningCallbacks : ScanningCallbacks {
         rssi, periodic_adv_int, jb.get(), fake_address.get());
   }
 
+  void OnScanResultBatch(ScanResultBatch batch) {
+    std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
+    CallbackEnv sCallbackEnv(__func__);
+    if (!sCallbackEnv.valid() || !mScanCallbacksObj) return;
+
+    if (sScanResultBuffer == NULL) {
+      OnScanResultBatchPerResult(sCallbackEnv, batch);
+      return;
+    }
+
+    // Pack the results in the buffer shared with Java: a single call hands
+    // over a buffer full of results, which Java consumes before returning.
+    size_t length = 0;
+    int num_results = 0;
+    for (const ScanResultBatch::ScanResult& result : batch.results) {
+      size_t record_len = kScanResultHeaderSize + result.adv_data_len;
+      if (length + record_len > sScanResultBufferSize && num_results != 0) {
+        sCallbackEnv->CallVoidMethod(mScanCallbacksObj,
+                                     method_onScanResultBatch, num_results,
+                                     (jint)length);
+        length = 0;
+        num_results = 0;
+      }
+      if (record_len > sScanResultBufferSize) {
+        log::warn("Dropping scan result with {} bytes of advertising data",
+                  result.adv_data_len);
+        continue;
+      }
+
+      uint8_t* p = sScanResultBuffer + length;
+      *p++ = result.event_type & 0xff;
+      *p++ = result.event_type >> 8;
+      *p++ = result.addr_type;
+      memcpy(p, result.bda.address, sizeof(result.bda.address));
+      p += sizeof(result.bda.address);
+      *p++ = result.primary_phy;
+      *p++ = result.secondary_phy;
+      *p++ = result.advertising_sid;
+      *p++ = (uint8_t)result.tx_power;
+      *p++ = (uint8_t)result.rssi;
+      *p++ = result.periodic_adv_int & 0xff;
+      *p++ = result.periodic_adv_int >> 8;
+      *p++ = result.adv_data_len & 0xff;
+      *p++ = result.adv_data_len >> 8;
+      memcpy(p, batch.adv_data.data() + result.adv_data_offset,
+             result.adv_data_len);
+
+      length += record_len;
+      num_results++;
+    }
+    if (num_results != 0) {
+      sCallbackEnv->CallVoidMethod(mScanCallbacksObj, method_onScanResultBatch,
+                                   num_results, (jint)length);
+    }
+  }
+
+  void OnScanResultBatchPerResult(CallbackEnv& sCallbackEnv,
+                                  ScanResultBatch& batch) {
+    // One thread attachment and callback lock for all the results
+    char empty_address[18] = "00:00:00:00:00:00";
+    ScopedLocalRef<jstring> fake_address(
+        sCallbackEnv.get(), sCallbackEnv->NewStringUTF(empty_address));
+
+    for (ScanResultBatch::ScanResult& result : batch.results) {
+      ScopedLocalRef<jstring> address(
+          sCallbackEnv.get(), bdaddr2newjstr(sCallbackEnv.get(), &result.bda));
+      ScopedLocalRef<jbyteArray> jb(
+          sCallbackEnv.get(), sCallbackEnv->NewByteArray(result.adv_data_len));
+      sCallbackEnv->SetByteArrayRegion(
+          jb.get(), 0, result.adv_data_len,
+          (jbyte*)batch.adv_data.data() + result.adv_data_offset);
+
+      sCallbackEnv->CallVoidMethod(
+          mScanCallbacksObj, method_onScanResult, result.event_type,
+          result.addr_type, address.get(), result.primary_phy,
+          result.secondary_phy, result.advertising_sid, result.tx_power,
+          result.rssi, result.periodic_adv_int, jb.get(), fake_address.get());
+    }
+  }
+
   void OnTrackAdvFoundLost(AdvertisingTrackInfo track_info) {
     std::shared_lock<std::shared_mutex> lock(callbacks_mutex);
     CallbackEnv sCallbackEnv(__func__);
@@ -2467,7 +2576,8 @@ static void periodicScanCleanupNative(JNIEnv* env, jobject /* object */) {
   }
 }
 
-static void scanInitializeNative(JNIEnv* env, jobject object) {
+static void scanInitializeNative(JNIEnv* env, jobject object,
+                                 jobject scan_result_buffer) {
   std::unique_lock<std::shared_mutex> lock(callbacks_mutex);
 
   sScanner = bluetooth::shim::get_ble_scanner_instance();
@@ -2480,6 +2590,24 @@ static void scanInitializeNative(JNIEnv* env, jobject object) {
   }
 
   mScanCallbacksObj = env->NewGlobalRef(object);
+
+  if (mScanResultBufferObj != NULL) {
+    env->DeleteGlobalRef(mScanResultBufferObj);
+    mScanResultBufferObj = NULL;
+  }
+  sScanResultBuffer = NULL;
+  sScanResultBufferSize = 0;
+  if (scan_result_buffer != NULL) {
+    void* address = env->GetDirectBufferAddress(scan_result_buffer);
+    jlong capacity = env->GetDirectBufferCapacity(scan_result_buffer);
+    if (address != NULL && capacity > 0) {
+      mScanResultBufferObj = env->NewGlobalRef(scan_result_buffer);
+      sScanResultBuffer = (uint8_t*)address;
+      sScanResultBufferSize = capacity;
+    } else {
+      log::warn("Scan result buffer is not a direct buffer");
+    }
+  }
 }
 
 static void scanCleanupNative(JNIEnv* env, jobject /* object */) {
@@ -2488,6 +2616,12 @@ static void scanCleanupNative(JNIEnv* env, jobject /* object */) {
     env->DeleteGlobalRef(mScanCallbacksObj);
     mScanCallbacksObj = NULL;
   }
+  if (mScanResultBufferObj != NULL) {
+    env->DeleteGlobalRef(mScanResultBufferObj);
+    mScanResultBufferObj = NULL;
+  }
+  sScanResultBuffer = NULL;
+  sScanResultBufferSize = 0;
   if (sScanner != NULL) {
     sScanner = NULL;
   }
@@ -2590,7 +2724,8 @@ static void stopDistanceMeasurementNative(JNIEnv* env, jobject /* object */,
 // JNI functions defined in ScanNativeInterface class.
 static int register_com_android_bluetooth_gatt_scan(JNIEnv* env) {
   const JNINativeMethod methods[] = {
-      {"initializeNative", "()V", (void*)scanInitializeNative},
+      {"initializeNative", "(Ljava/nio/ByteBuffer;)V",
+       (void*)scanInitializeNative},
       {"cleanupNative", "()V", (void*)scanCleanupNative},
       {"registerScannerNative", "(JJ)V", (void*)registerScannerNative},
       {"unregisterScannerNative", "(I)V", (void*)unregisterScannerNative},
@@ -2633,6 +2768,7 @@ static int register_com_android_bluetooth_gatt_scan(JNIEnv* env) {
       {"onScannerRegistered", "(IIJJ)V", &method_onScannerRegistered},
       {"onScanResult", "(IILjava/lang/String;IIIIII[BLjava/lang/String;)V",
        &method_onScanResult},
+      {"onScanResultBatch", "(II)V", &method_onScanResultBatch},
       {"onScanFilterConfig", "(IIIII)V", &method_onScanFilterConfig},
       {"onScanFilterParamsConfigured", "(IIII)V",
        &method_onScanFilterParamsConfigured},
@@ -2882,7 +3018,7 @@ static int register_com_android_bluetooth_gatt_(JNIEnv* env) {
       {"onClientCongestion", "(IZ)V", &method_onClientCongestion},
       {"getSampleGattDbElement", "()Lcom/android/bluetooth/gatt/GattDbElement;",
        &method_getSampleGattDbElement},
-      {"onGetGattDb", "(ILjava/util/ArrayList;)V", &method_onGetGattDb},
+      {"onGetGattDb", "(I[B)V", &method_onGetGattDb},
       {"onClientPhyRead", "(ILjava/lang/String;III)V", &method_onClientPhyRead},
       {"onClientPhyUpdate", "(IIII)V", &method_onClientPhyUpdate},
       {"onClientConnUpdate", "(IIIII)V", &method_onClientConnUpdate},
@@ -21,13 +21,19 @@ import android.os.RemoteException;
 import com.android.internal.annotations.GuardedBy;
 import com.android.internal.annotations.VisibleForTesting;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayList;
 import java.util.List;
+import java.util.UUID;
 
 /** GATT Profile Native Interface to/from JNI. */
 public class GattNativeInterface {
     private static final String TAG = GattNativeInterface.class.getSimpleName();
 
+    // Size of an element of the database passed to onGetGattDb()
+    private static final int PACKED_GATT_DB_ELEMENT_SIZE = 26;
+
     private GattService mGattService;
 
     @GuardedBy("INSTANCE_LOCK")
@@ -133,8 +139,36 @@ public class GattNativeInterface {
         return getGattService().getSampleGattDbElement();
     }
 
-    void onGetGattDb(int connId, ArrayList<GattDbElement> db) throws RemoteException {
-        getGattService().onGetGattDb(connId, db);
+    /**
+     * Receives the GATT database of a connection packed by the native stack, which is cheaper
+     * than building the elements through JNI. Each element takes PACKED_GATT_DB_ELEMENT_SIZE
+     * bytes, in little endian: id (2), type (1), attribute handle (2), start handle (2), end
+     * handle (2), properties (1), UUID most significant bits (8), UUID least significant bits
+     * (8).
+     */
+    void onGetGattDb(int connId, byte[] db) throws RemoteException {
+        getGattService().onGetGattDb(connId, unpackGattDb(db));
+    }
+
+    @VisibleForTesting
+    static ArrayList<GattDbElement> unpackGattDb(byte[] db) {
+        ByteBuffer buffer = ByteBuffer.wrap(db).order(ByteOrder.LITTLE_ENDIAN);
+        ArrayList<GattDbElement> elements =
+                new ArrayList<>(db.length / PACKED_GATT_DB_ELEMENT_SIZE);
+        while (buffer.remaining() >= PACKED_GATT_DB_ELEMENT_SIZE) {
+            GattDbElement element = new GattDbElement();
+            element.id = buffer.getShort() & 0xffff;
+            element.type = buffer.get() & 0xff;
+            element.attributeHandle = buffer.getShort() & 0xffff;
+            element.startHandle = buffer.getShort() & 0xffff;
+            element.endHandle = buffer.getShort() & 0xffff;
+            element.properties = buffer.get() & 0xff;
+            long msb = buffer.getLong();
+            long lsb = buffer.getLong();
+            element.uuid = new UUID(msb, lsb);
+            elements.add(element);
+        }
+        return elements;
     }
 
     void onRegisterForNotifications(int connId, int status, int registered, int handle) {
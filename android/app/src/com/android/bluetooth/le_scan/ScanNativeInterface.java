@@ -20,9 +20,12 @@ import android.annotation.Nullable;
 import android.os.RemoteException;
 import android.util.Log;
 
+import com.android.bluetooth.Utils;
 import com.android.bluetooth.gatt.FilterParams;
 import com.android.internal.annotations.VisibleForTesting;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.concurrent.CountDownLatch;
 import java.util.concurrent.TimeUnit;
 
@@ -32,8 +35,17 @@ public class ScanNativeInterface {
 
     private static ScanNativeInterface sInterface;
 
+    // Batches of scan results are written by the native code in this buffer, then handed over
+    // with onScanResultBatch(). The batch must be consumed before the callback returns.
+    private static final int SCAN_RESULT_BUFFER_SIZE = 64 * 1024;
+    // Size of the fixed fields of a scan result in the buffer, see onScanResultBatch()
+    private static final int SCAN_RESULT_HEADER_SIZE = 18;
+    private static final int BD_ADDR_LEN = 6;
+
     private CountDownLatch mLatch = new CountDownLatch(1);
     @Nullable private TransitionalScanHelper mScanHelper;
+    private final ByteBuffer mScanResultBuffer =
+            ByteBuffer.allocateDirect(SCAN_RESULT_BUFFER_SIZE).order(ByteOrder.LITTLE_ENDIAN);
 
     private ScanNativeInterface() {}
 
@@ -61,7 +73,7 @@ public class ScanNativeInterface {
 
     void init(TransitionalScanHelper scanHelper) {
         mScanHelper = scanHelper;
-        initializeNative();
+        initializeNative(mScanResultBuffer);
     }
 
     void cleanup() {
@@ -69,7 +81,7 @@ public class ScanNativeInterface {
     }
 
     /* Native methods */
-    private native void initializeNative();
+    private native void initializeNative(ByteBuffer scanResultBuffer);
 
     private native void cleanupNative();
 
@@ -253,6 +265,58 @@ public class ScanNativeInterface {
                 originalAddress);
     }
 
+    /**
+     * Dispatches the {@code numResults} scan results written in the first {@code length} bytes of
+     * the scan result buffer. Each result is laid out in little endian as: event type (2 bytes),
+     * address type, address (6 bytes, most significant first), primary PHY, secondary PHY,
+     * advertising SID, TX power, RSSI, periodic advertising interval (2 bytes), advertising data
+     * length (2 bytes), then the advertising data.
+     */
+    void onScanResultBatch(int numResults, int length) {
+        if (mScanHelper == null) {
+            Log.e(TAG, "Scan helper is null!");
+            return;
+        }
+        ByteBuffer buffer = mScanResultBuffer.duplicate().order(ByteOrder.LITTLE_ENDIAN);
+        buffer.limit(length);
+        byte[] address = new byte[BD_ADDR_LEN];
+        for (int i = 0; i < numResults; i++) {
+            if (buffer.remaining() < SCAN_RESULT_HEADER_SIZE) {
+                Log.e(TAG, "Truncated scan result batch: " + i + "/" + numResults);
+                return;
+            }
+            int eventType = buffer.getShort() & 0xffff;
+            int addressType = buffer.get() & 0xff;
+            buffer.get(address);
+            int primaryPhy = buffer.get() & 0xff;
+            int secondaryPhy = buffer.get() & 0xff;
+            int advertisingSid = buffer.get() & 0xff;
+            int txPower = buffer.get();
+            int rssi = buffer.get();
+            int periodicAdvInt = buffer.getShort() & 0xffff;
+            int advDataLen = buffer.getShort() & 0xffff;
+            if (buffer.remaining() < advDataLen) {
+                Log.e(TAG, "Truncated scan result batch: " + i + "/" + numResults);
+                return;
+            }
+            byte[] advData = new byte[advDataLen];
+            buffer.get(advData);
+
+            mScanHelper.onScanResult(
+                    eventType,
+                    addressType,
+                    Utils.getAddressStringFromByte(address),
+                    primaryPhy,
+                    secondaryPhy,
+                    advertisingSid,
+                    txPower,
+                    rssi,
+                    periodicAdvInt,
+                    advData,
+                    "00:00:00:00:00:00");
+        }
+    }
+
     void onScannerRegistered(int status, int scannerId, long uuidLsb, long uuidMsb)
             throws RemoteException {
         if (mScanHelper == null) {
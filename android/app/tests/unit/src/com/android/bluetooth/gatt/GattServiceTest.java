@@ -733,4 +733,36 @@ public class GattServiceTest {
                 clientIf, connId, BluetoothGatt.GATT_SUCCESS, REMOTE_DEVICE_ADDRESS);
         assertThat(mService.mRestrictedHandles).doesNotContainKey(connId);
     }
+
+    @Test
+    public void unpackGattDb() {
+        byte[] db = {
+            // Primary service 0x1812, handles 0x0001-0x0005
+            0x01, 0x00, GattDbElement.TYPE_PRIMARY_SERVICE, 0x01, 0x00, 0x01, 0x00, 0x05, 0x00,
+            0x00,
+            0x00, 0x10, 0x00, 0x00, 0x12, 0x18, 0x00, 0x00,
+            (byte) 0xfb, 0x34, (byte) 0x9b, 0x5f, (byte) 0x80, 0x00, 0x00, (byte) 0x80,
+            // Characteristic 0x2a4a, handle 0x0003, properties 0x02
+            0x03, 0x00, GattDbElement.TYPE_CHARACTERISTIC, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x02,
+            0x00, 0x10, 0x00, 0x00, 0x4a, 0x2a, 0x00, 0x00,
+            (byte) 0xfb, 0x34, (byte) 0x9b, 0x5f, (byte) 0x80, 0x00, 0x00, (byte) 0x80,
+        };
+
+        List<GattDbElement> elements = GattNativeInterface.unpackGattDb(db);
+
+        assertThat(elements).hasSize(2);
+        assertThat(elements.get(0).id).isEqualTo(1);
+        assertThat(elements.get(0).type).isEqualTo(GattDbElement.TYPE_PRIMARY_SERVICE);
+        assertThat(elements.get(0).startHandle).isEqualTo(1);
+        assertThat(elements.get(0).endHandle).isEqualTo(5);
+        assertThat(elements.get(0).uuid)
+                .isEqualTo(UUID.fromString("00001812-0000-1000-8000-00805F9B34FB"));
+        assertThat(elements.get(1).id).isEqualTo(3);
+        assertThat(elements.get(1).type).isEqualTo(GattDbElement.TYPE_CHARACTERISTIC);
+        assertThat(elements.get(1).attributeHandle).isEqualTo(3);
+        assertThat(elements.get(1).properties).isEqualTo(0x02);
+        assertThat(elements.get(1).uuid)
+                .isEqualTo(UUID.fromString("00002A4A-0000-1000-8000-00805F9B34FB"));
+    }
 }
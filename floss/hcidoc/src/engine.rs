@@ -3,6 +3,9 @@
 use chrono::NaiveDateTime;
 use std::collections::BTreeMap;
 use std::io::Write;
+use std::sync::mpsc::sync_channel;
+use std::sync::Arc;
+use std::thread;
 
 use crate::parser::Packet;
 
@@ -19,10 +22,47 @@ pub struct Signal {
     pub tag: &'static str,
 }
 
+/// Most reportable events kept by a rule. Logs of stress tests can produce millions of them, the
+/// ones past this limit are only counted.
+const MAX_REPORTABLE: usize = 10000;
+
+/// Reportable events of a rule, bounded to |MAX_REPORTABLE| events.
+pub struct Reportable {
+    events: Vec<(NaiveDateTime, String)>,
+    omitted: usize,
+}
+
+impl Reportable {
+    pub fn new() -> Self {
+        Reportable { events: vec![], omitted: 0 }
+    }
+
+    pub fn push(&mut self, event: (NaiveDateTime, String)) {
+        if self.events.len() < MAX_REPORTABLE {
+            self.events.push(event);
+        } else {
+            self.omitted += 1;
+        }
+    }
+
+    /// Write the events under |title|, if there are any.
+    pub fn write_report(&self, writer: &mut dyn Write, title: &str) {
+        if self.events.len() > 0 {
+            let _ = writeln!(writer, "{}:", title);
+            for (ts, message) in self.events.iter() {
+                let _ = writeln!(writer, "[{:?}] {}", ts, message);
+            }
+            if self.omitted > 0 {
+                let _ = writeln!(writer, "... {} more", self.omitted);
+            }
+        }
+    }
+}
+
 /// Trait that describes a single rule processor. A rule should be used to represent a certain type
 /// of analysis (for example: ACL Connections rule may keep track of all ACL connections and report
-/// on failed connections).
-pub trait Rule {
+/// on failed connections). Rules are sent to the thread processing their group.
+pub trait Rule: Send {
     /// Process a single packet.
     fn process(&mut self, packet: &Packet);
 
@@ -73,6 +113,14 @@ impl RuleGroup {
         }
     }
 }
+
+/// Number of packets sent at once to the thread of each rule group.
+const PACKET_BATCH_SIZE: usize = 1024;
+
+/// Number of batches queued to a rule group before the reader waits for it. This bounds the packets
+/// held in memory regardless of the size of the log.
+const MAX_QUEUED_BATCHES: usize = 4;
+
 /// Main entry point to process input data and run rules on them.
 pub struct RuleEngine {
     groups: BTreeMap<String, RuleGroup>,
@@ -87,11 +135,45 @@ impl RuleEngine {
         self.groups.insert(name, group);
     }
 
-    /// Consume a packet and run it through the various rules processors.
-    pub fn process(&mut self, packet: Packet) {
-        for group in self.groups.values_mut() {
-            group.process(&packet);
-        }
+    /// Consume all the packets of |packets|. Rule groups don't share any state, so each of them
+    /// processes the packets on its own thread, in order. Packets are dropped once all the groups
+    /// processed them.
+    pub fn process_all(&mut self, packets: impl Iterator<Item = Packet>) {
+        thread::scope(|scope| {
+            let mut senders = vec![];
+            for group in self.groups.values_mut() {
+                let (sender, receiver) = sync_channel::<Arc<Vec<Packet>>>(MAX_QUEUED_BATCHES);
+                senders.push(sender);
+                scope.spawn(move || {
+                    for batch in receiver {
+                        for packet in batch.iter() {
+                            group.process(packet);
+                        }
+                    }
+                });
+            }
+
+            let mut batch = Vec::with_capacity(PACKET_BATCH_SIZE);
+            for packet in packets {
+                batch.push(packet);
+                if batch.len() == PACKET_BATCH_SIZE {
+                    let full = Arc::new(std::mem::replace(
+                        &mut batch,
+                        Vec::with_capacity(PACKET_BATCH_SIZE),
+                    ));
+                    for sender in &senders {
+                        let _ = sender.send(full.clone());
+                    }
+                }
+            }
+            if batch.len() > 0 {
+                let last = Arc::new(batch);
+                for sender in &senders {
+                    let _ = sender.send(last.clone());
+                }
+            }
+            // Dropping the senders ends the group threads, which are joined by the scope.
+        });
     }
 
     pub fn report(&self, writer: &mut dyn Write) {
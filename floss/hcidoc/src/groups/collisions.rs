@@ -3,7 +3,7 @@ use chrono::NaiveDateTime;
 use std::convert::Into;
 use std::io::Write;
 
-use crate::engine::{Rule, RuleGroup, Signal};
+use crate::engine::{Reportable, Rule, RuleGroup, Signal};
 use crate::parser::{Packet, PacketChild};
 use hcidoc_packets::hci::{ErrorCode, EventChild, OpCode};
 
@@ -47,7 +47,7 @@ struct ConnectionSerializationRule {
     signals: Vec<Signal>,
 
     /// Interesting occurrences surfaced by this rule.
-    reportable: Vec<(NaiveDateTime, String)>,
+    reportable: Reportable,
 }
 
 impl ConnectionSerializationRule {
@@ -56,7 +56,7 @@ impl ConnectionSerializationRule {
             state: CollisionState::Nothing,
             state_set_at: None,
             signals: vec![],
-            reportable: vec![],
+            reportable: Reportable::new(),
         }
     }
 
@@ -205,12 +205,7 @@ impl Rule for ConnectionSerializationRule {
     }
 
     fn report(&self, writer: &mut dyn Write) {
-        if self.reportable.len() > 0 {
-            let _ = writeln!(writer, "ConnectionSerializationRule report:");
-            for (ts, message) in self.reportable.iter() {
-                let _ = writeln!(writer, "[{:?}] {}", ts, message);
-            }
-        }
+        self.reportable.write_report(writer, "ConnectionSerializationRule report");
     }
 
     fn report_signals(&self) -> &[Signal] {
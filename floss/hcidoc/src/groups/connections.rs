@@ -5,7 +5,7 @@ use std::convert::Into;
 use std::io::Write;
 use std::slice::Iter;
 
-use crate::engine::{Rule, RuleGroup, Signal};
+use crate::engine::{Reportable, Rule, RuleGroup, Signal};
 use crate::parser::{Packet, PacketChild};
 use hcidoc_packets::hci::{
     Acl, AclCommandChild, Address, AuthenticatedPayloadTimeoutExpired, CommandChild,
@@ -120,7 +120,7 @@ struct OddDisconnectionsRule {
     signals: Vec<Signal>,
 
     /// Interesting occurrences surfaced by this rule.
-    reportable: Vec<(NaiveDateTime, String)>,
+    reportable: Reportable,
 }
 
 impl OddDisconnectionsRule {
@@ -143,7 +143,7 @@ impl OddDisconnectionsRule {
             last_feat_handle: HashMap::new(),
             pending_disconnect_due_to_host_power_off: HashSet::new(),
             signals: vec![],
-            reportable: vec![],
+            reportable: Reportable::new(),
         }
     }
 
@@ -824,12 +824,7 @@ impl Rule for OddDisconnectionsRule {
     }
 
     fn report(&self, writer: &mut dyn Write) {
-        if self.reportable.len() > 0 {
-            let _ = writeln!(writer, "OddDisconnectionsRule report:");
-            for (ts, message) in self.reportable.iter() {
-                let _ = writeln!(writer, "[{:?}] {}", ts, message);
-            }
-        }
+        self.reportable.write_report(writer, "OddDisconnectionsRule report");
     }
 
     fn report_signals(&self) -> &[Signal] {
@@ -865,7 +860,7 @@ struct LinkKeyMismatchRule {
     signals: Vec<Signal>,
 
     /// Interesting occurrences surfaced by this rule.
-    reportable: Vec<(NaiveDateTime, String)>,
+    reportable: Reportable,
 }
 
 impl LinkKeyMismatchRule {
@@ -875,7 +870,7 @@ impl LinkKeyMismatchRule {
             handles: HashMap::new(),
             pending_le_encrypt: HashSet::new(),
             signals: vec![],
-            reportable: vec![],
+            reportable: Reportable::new(),
         }
     }
 
@@ -1060,12 +1055,7 @@ impl Rule for LinkKeyMismatchRule {
     }
 
     fn report(&self, writer: &mut dyn Write) {
-        if self.reportable.len() > 0 {
-            let _ = writeln!(writer, "LinkKeyMismatchRule report:");
-            for (ts, message) in self.reportable.iter() {
-                let _ = writeln!(writer, "[{:?}] {}", ts, message);
-            }
-        }
+        self.reportable.write_report(writer, "LinkKeyMismatchRule report");
     }
 
     fn report_signals(&self) -> &[Signal] {
@@ -1078,12 +1068,12 @@ struct SecurityMode3Rule {
     signals: Vec<Signal>,
 
     /// Interesting occurrences surfaced by this rule.
-    reportable: Vec<(NaiveDateTime, String)>,
+    reportable: Reportable,
 }
 
 impl SecurityMode3Rule {
     pub fn new() -> Self {
-        SecurityMode3Rule { signals: vec![], reportable: vec![] }
+        SecurityMode3Rule { signals: vec![], reportable: Reportable::new() }
     }
 
     fn process_connect_complete(
@@ -1130,12 +1120,7 @@ impl Rule for SecurityMode3Rule {
     }
 
     fn report(&self, writer: &mut dyn Write) {
-        if self.reportable.len() > 0 {
-            let _ = writeln!(writer, "SecurityMode3Rule report:");
-            for (ts, message) in self.reportable.iter() {
-                let _ = writeln!(writer, "[{:?}] {}", ts, message);
-            }
-        }
+        self.reportable.write_report(writer, "SecurityMode3Rule report");
     }
 
     fn report_signals(&self) -> &[Signal] {
@@ -1,11 +1,10 @@
 ///! Rule group for tracking controller related issues.
-use chrono::NaiveDateTime;
 use lazy_static::lazy_static;
 use std::collections::HashSet;
 use std::convert::Into;
 use std::io::Write;
 
-use crate::engine::{Rule, RuleGroup, Signal};
+use crate::engine::{Reportable, Rule, RuleGroup, Signal};
 use crate::parser::{NewIndex, Packet, PacketChild};
 use hcidoc_packets::hci::{CommandCompleteChild, ErrorCode, EventChild, LocalVersionInformation};
 
@@ -46,7 +45,7 @@ struct ControllerRule {
     signals: Vec<Signal>,
 
     /// Interesting occurrences surfaced by this rule.
-    reportable: Vec<(NaiveDateTime, String)>,
+    reportable: Reportable,
 
     /// All detected open_index.
     controllers: HashSet<String>,
@@ -54,7 +53,11 @@ struct ControllerRule {
 
 impl ControllerRule {
     pub fn new() -> Self {
-        ControllerRule { signals: vec![], reportable: vec![], controllers: HashSet::new() }
+        ControllerRule {
+            signals: vec![],
+            reportable: Reportable::new(),
+            controllers: HashSet::new(),
+        }
     }
 
     pub fn report_hardware_error(&mut self, packet: &Packet) {
@@ -144,12 +147,7 @@ impl Rule for ControllerRule {
     }
 
     fn report(&self, writer: &mut dyn Write) {
-        if self.reportable.len() > 0 {
-            let _ = writeln!(writer, "Controller report:");
-            for (ts, message) in self.reportable.iter() {
-                let _ = writeln!(writer, "[{:?}] {}", ts, message);
-            }
-        }
+        self.reportable.write_report(writer, "Controller report");
     }
 
     fn report_signals(&self) -> &[Signal] {
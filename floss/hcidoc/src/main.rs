@@ -13,7 +13,9 @@ fn main() {
     let matches = Command::new("hcidoc")
         .version("0.1")
         .author("Abhishek Pandit-Subedi <abhishekpandit@google.com>")
-        .about("Analyzes a linux HCI snoop log for specific behaviors and errors.")
+        .about(
+            "Analyzes a linux HCI snoop log, plain or gzipped, for specific behaviors and errors.",
+        )
         .arg(
             Arg::new("filename")
                 .help("Path to the snoop log. If omitted, read from stdin instead."),
@@ -94,21 +96,26 @@ fn main() {
     let mut writer: Box<dyn Write> = Box::new(std::io::stdout());
 
     if let LogType::LinuxSnoop(_header) = log_type {
-        for (pos, v) in parser.get_snoop_iterator().expect("Not a linux snoop file").enumerate() {
-            match Packet::try_from((pos, &v)) {
-                Ok(p) => engine.process(p),
-                Err(e) => {
-                    if !ignore_unknown_opcode {
-                        match v.opcode() {
-                            LinuxSnoopOpcodes::Command | LinuxSnoopOpcodes::Event => {
-                                eprintln!("#{}: {}", pos, e);
+        // Packets are parsed while the rules process the previous ones, and never all held in
+        // memory at once.
+        let packets =
+            parser.get_snoop_iterator().expect("Not a linux snoop file").enumerate().filter_map(
+                |(pos, v)| match Packet::try_from((pos, &v)) {
+                    Ok(p) => Some(p),
+                    Err(e) => {
+                        if !ignore_unknown_opcode {
+                            match v.opcode() {
+                                LinuxSnoopOpcodes::Command | LinuxSnoopOpcodes::Event => {
+                                    eprintln!("#{}: {}", pos, e);
+                                }
+                                _ => (),
                             }
-                            _ => (),
                         }
+                        None
                     }
-                }
-            }
-        }
+                },
+            );
+        engine.process_all(packets);
 
         if !report_only_signals {
             engine.report(&mut writer);
@@ -1,10 +1,12 @@
 //! Parsing of various Bluetooth packets.
 use chrono::NaiveDateTime;
+use flate2::bufread::MultiGzDecoder;
 use num_derive::{FromPrimitive, ToPrimitive};
 use num_traits::cast::FromPrimitive;
 use std::convert::TryFrom;
 use std::fs::File;
-use std::io::{BufRead, BufReader, Error, ErrorKind, Read};
+use std::io::{BufRead, BufReader, Cursor, Error, ErrorKind, Read};
+use std::os::unix::io::AsRawFd;
 
 use hcidoc_packets::hci::{Acl, AclChild, Command, Event};
 use hcidoc_packets::l2cap::{
@@ -204,12 +206,13 @@ impl<'a> Iterator for LinuxSnoopReader<'a> {
             Ok(mut p) => {
                 if p.included_length > 0 {
                     let size: usize = p.included_length.try_into().unwrap();
-                    let mut rem_data = [0u8; LINUX_SNOOP_MAX_PACKET_SIZE];
-                    match self.fd.read_exact(&mut rem_data[0..size]) {
-                        Ok(()) => {
-                            p.data = rem_data[0..size].to_vec();
-                            Some(p)
-                        }
+                    if size > LINUX_SNOOP_MAX_PACKET_SIZE {
+                        eprintln!("Packet data is too large: {}", size);
+                        return None;
+                    }
+                    p.data = vec![0u8; size];
+                    match self.fd.read_exact(&mut p.data) {
+                        Ok(()) => Some(p),
                         Err(e) => {
                             eprintln!("Couldn't read any packet data: {}", e);
                             None
@@ -231,6 +234,77 @@ pub enum LogType {
     LinuxSnoop(LinuxSnoopHeader),
 }
 
+/// Read-only memory mapping of a whole file. Logs of stress tests can be several gigabytes, mapping
+/// them avoids copying every byte through a read buffer and lets the kernel drop the pages already
+/// parsed.
+struct MappedFile {
+    addr: *mut libc::c_void,
+    len: usize,
+}
+
+impl MappedFile {
+    /// Map |file|. Fails for empty files and for files that can't be mapped, such as pipes.
+    fn new(file: &File) -> std::io::Result<Self> {
+        let len: usize = file
+            .metadata()?
+            .len()
+            .try_into()
+            .map_err(|_| Error::new(ErrorKind::Other, "File too large to map"))?;
+        if len == 0 {
+            return Err(Error::new(ErrorKind::Other, "Empty file"));
+        }
+
+        // SAFETY: A private read-only mapping of a file we opened. Logs are parsed after they are
+        // written, so the file isn't expected to be truncated while mapped.
+        let addr = unsafe {
+            libc::mmap(
+                std::ptr::null_mut(),
+                len,
+                libc::PROT_READ,
+                libc::MAP_PRIVATE,
+                file.as_raw_fd(),
+                0,
+            )
+        };
+        if addr == libc::MAP_FAILED {
+            return Err(Error::last_os_error());
+        }
+
+        // Packets are parsed front to back: read ahead aggressively and free the pages behind.
+        // SAFETY: |addr| and |len| describe the mapping above.
+        unsafe { libc::madvise(addr, len, libc::MADV_SEQUENTIAL) };
+
+        Ok(MappedFile { addr, len })
+    }
+}
+
+impl AsRef<[u8]> for MappedFile {
+    fn as_ref(&self) -> &[u8] {
+        // SAFETY: The mapping is valid and readable until |self| is dropped.
+        unsafe { std::slice::from_raw_parts(self.addr as *const u8, self.len) }
+    }
+}
+
+impl Drop for MappedFile {
+    fn drop(&mut self) {
+        // SAFETY: |addr| and |len| describe a mapping owned by |self|.
+        unsafe { libc::munmap(self.addr, self.len) };
+    }
+}
+
+/// First bytes of a gzip stream, such as the compressed snoop logs (btsnoop_hci.log.gz).
+const GZIP_MAGIC: [u8; 2] = [0x1f, 0x8b];
+
+/// Decompress |fd| on the fly if it holds a gzip stream. Compressed logs left by a writer that
+/// didn't close them end mid stream, and are read up to their last complete packet.
+fn maybe_decompress(mut fd: Box<dyn BufRead>) -> std::io::Result<Box<dyn BufRead>> {
+    if fd.fill_buf()?.starts_with(&GZIP_MAGIC) {
+        Ok(Box::new(BufReader::new(MultiGzDecoder::new(fd))))
+    } else {
+        Ok(fd)
+    }
+}
+
 /// Parses different Bluetooth log types.
 pub struct LogParser {
     fd: Box<dyn BufRead>,
@@ -238,15 +312,21 @@ pub struct LogParser {
 }
 
 impl<'a> LogParser {
+    /// Open the log at |filepath|, or stdin if it is empty. Files are memory mapped when possible,
+    /// and gzip compressed logs are decompressed while they are parsed.
     pub fn new(filepath: &str) -> std::io::Result<Self> {
         let fd: Box<dyn BufRead>;
         if filepath.len() == 0 {
             fd = Box::new(BufReader::new(std::io::stdin()));
         } else {
-            fd = Box::new(BufReader::new(File::open(filepath)?));
+            let file = File::open(filepath)?;
+            fd = match MappedFile::new(&file) {
+                Ok(mapped) => Box::new(Cursor::new(mapped)),
+                Err(_) => Box::new(BufReader::new(file)),
+            };
         }
 
-        Ok(Self { fd, log_type: None })
+        Ok(Self { fd: maybe_decompress(fd)?, log_type: None })
     }
 
     /// Check the log file type for the current log file. This advances the read pointer.
@@ -276,7 +356,7 @@ impl<'a> LogParser {
             return None;
         }
 
-        Some(LinuxSnoopReader::new(Box::new(BufReader::new(&mut self.fd))))
+        Some(LinuxSnoopReader::new(Box::new(&mut self.fd)))
     }
 }
 
@@ -202,7 +202,7 @@ class SourceAudioHalAsrc::ClockRecovery
   }
 
   ~ClockRecovery() override {
-    hal::LinkClocker::Unregister();
+    hal::LinkClocker::Unregister(this);
     read_clock_timer_.Cancel();
   }
 
@@ -230,6 +230,150 @@ class SourceAudioHalAsrc::ClockRecovery
   }
 };
 
+//
+// Resampler Filtering
+//
+// The kernels apply the transfer coefficients `h`, corrected by linear
+// interpolation given the fraction position `mu` weighted by `d` values, to
+// the windows `x` of `channels` channels, spaced by `x_stride` samples.
+// The coefficients are interpolated once, and shared by all the channels.
+// The accumulations, in Q31, are returned in `s`. All the kernels return
+// exactly the same values.
+//
+
+using FilterFn = void (*)(const int32_t* x, int x_stride, int channels,
+                          const int32_t* h, int16_t mu, const int16_t* d,
+                          int64_t* s);
+
+static const int FILTER_TAPS = 2 * asrc::ResamplerTables::KERNEL_A;
+
+__attribute__((no_sanitize("integer"))) static void FilterGeneric(
+    const int32_t* x, int x_stride, int channels, const int32_t* h, int16_t mu,
+    const int16_t* d, int64_t* s) {
+  int32_t hi[FILTER_TAPS - 1];
+  for (int i = 0; i < FILTER_TAPS - 1; i++)
+    hi[i] = h[i] + ((mu * d[i] + (1 << 6)) >> 7);
+
+  for (int ch = 0; ch < channels; ch++, x += x_stride) {
+    int64_t sx = 0;
+    for (int i = 0; i < FILTER_TAPS - 1; i++) sx += int64_t(x[i]) * hi[i];
+
+    s[ch] = sx;
+  }
+}
+
+//
+// ARM AArch 64 Neon Resampler Filtering
+//
+
+#if __ARM_NEON && __ARM_ARCH_ISA_A64
+
+#include <arm_neon.h>
+
+static inline int32x4_t vmull_low_s16(int16x8_t a, int16x8_t b) {
+  return vmull_s16(vget_low_s16(a), vget_low_s16(b));
+}
+
+static inline int64x2_t vmull_low_s32(int32x4_t a, int32x4_t b) {
+  return vmull_s32(vget_low_s32(a), vget_low_s32(b));
+}
+
+static inline int64x2_t vmlal_low_s32(int64x2_t r, int32x4_t a, int32x4_t b) {
+  return vmlal_s32(r, vget_low_s32(a), vget_low_s32(b));
+}
+
+static void FilterNeon(const int32_t* x, int x_stride, int channels,
+                       const int32_t* h, int16_t _mu, const int16_t* d,
+                       int64_t* s) {
+  int16x8_t mu = vdupq_n_s16(_mu);
+  int32x4_t hi[FILTER_TAPS / 4];
+
+  for (int i = 0; i < FILTER_TAPS; i += 8) {
+    int16x8_t d8 = vld1q_s16(d + i);
+    int32x4_t h8 = vld1q_s32(h + i), h12 = vld1q_s32(h + i + 4);
+
+    hi[i / 4 + 0] = vaddq_s32(h8, vrshrq_n_s32(vmull_low_s16(d8, mu), 7));
+    hi[i / 4 + 1] = vaddq_s32(h12, vrshrq_n_s32(vmull_high_s16(d8, mu), 7));
+  }
+
+  for (int ch = 0; ch < channels; ch++, x += x_stride) {
+    int32x4_t x0 = vld1q_s32(x + 0);
+
+    int64x2_t sx = vmull_low_s32(x0, hi[0]);
+    sx = vmlal_high_s32(sx, x0, hi[0]);
+
+    for (int i = 1; i < FILTER_TAPS / 4; i++) {
+      int32x4_t x4 = vld1q_s32(x + 4 * i);
+
+      sx = vmlal_low_s32(sx, x4, hi[i]);
+      sx = vmlal_high_s32(sx, x4, hi[i]);
+    }
+
+    s[ch] = vaddvq_s64(sx);
+  }
+}
+
+//
+// x86-64 AVX2 Resampler Filtering
+//
+
+#elif __x86_64__
+
+#include <immintrin.h>
+
+// `_mm256_mul_epi32` multiplies the even 32 bits lanes, the odd lanes are
+// shifted in place for a second multiplication.
+
+__attribute__((target("avx2"))) static void FilterAvx2(
+    const int32_t* x, int x_stride, int channels, const int32_t* h,
+    int16_t _mu, const int16_t* d, int64_t* s) {
+  const __m256i mu = _mm256_set1_epi32(_mu);
+  const __m256i round = _mm256_set1_epi32(1 << 6);
+  __m256i hi[FILTER_TAPS / 8];
+
+  for (int i = 0; i < FILTER_TAPS / 8; i++) {
+    __m256i d8 = _mm256_cvtepi16_epi32(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(d + 8 * i)));
+    __m256i h8 = _mm256_load_si256(reinterpret_cast<const __m256i*>(h + 8 * i));
+
+    hi[i] = _mm256_add_epi32(
+        h8, _mm256_srai_epi32(
+                _mm256_add_epi32(_mm256_mullo_epi32(d8, mu), round), 7));
+  }
+
+  for (int ch = 0; ch < channels; ch++, x += x_stride) {
+    __m256i sx = _mm256_setzero_si256();
+
+    for (int i = 0; i < FILTER_TAPS / 8; i++) {
+      __m256i x8 =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + 8 * i));
+
+      sx = _mm256_add_epi64(sx, _mm256_mul_epi32(x8, hi[i]));
+      sx = _mm256_add_epi64(
+          sx, _mm256_mul_epi32(_mm256_srli_epi64(x8, 32),
+                               _mm256_srli_epi64(hi[i], 32)));
+    }
+
+    __m128i s2 = _mm_add_epi64(_mm256_castsi256_si128(sx),
+                               _mm256_extracti128_si256(sx, 1));
+    s[ch] = _mm_cvtsi128_si64(s2) + _mm_extract_epi64(s2, 1);
+  }
+}
+
+#endif
+
+// Return the SIMD kernel supported by the platform when `use_simd` is set,
+// and the generic kernel otherwise.
+
+static FilterFn SelectFilter(bool use_simd) {
+#if __ARM_NEON && __ARM_ARCH_ISA_A64
+  if (use_simd) return FilterNeon;
+#elif __x86_64__
+  if (use_simd && __builtin_cpu_supports("avx2")) return FilterAvx2;
+#endif
+  return FilterGeneric;
+}
+
 class SourceAudioHalAsrc::Resampler {
   static const int KERNEL_Q = asrc::ResamplerTables::KERNEL_Q;
   static const int KERNEL_A = asrc::ResamplerTables::KERNEL_A;
@@ -238,25 +382,52 @@ class SourceAudioHalAsrc::Resampler {
   const int16_t (*d_)[2 * KERNEL_A];
 
   static const unsigned WSIZE = 64;
+  static const int MAX_CHANNELS = 8;
+
+  // The windows of the channels, share the same positions. The interleaved
+  // PCM stream is resampled in a single pass, the position and the
+  // interpolated coefficients are computed once for all the channels.
 
-  int32_t win_[2][WSIZE];
+  int32_t win_[MAX_CHANNELS][2][WSIZE];
   unsigned out_pos_, in_pos_;
+  const int channels_;
   const int32_t pcm_min_, pcm_max_;
+  const FilterFn filter_;
+
+  // Produce an interleaved output frame, from the window position `idx`
+  // and the fraction position of the filter.
+
+  template <typename T>
+  inline void Filter(unsigned idx, unsigned phy, int16_t mu, T* out) {
+    unsigned wbuf = idx < WSIZE / 2 || idx >= WSIZE + WSIZE / 2;
+    auto w = win_[0][wbuf] + ((idx + wbuf * WSIZE / 2) % WSIZE) - WSIZE / 2;
+
+    int64_t s[MAX_CHANNELS];
+    filter_(w, 2 * WSIZE, channels_, h_[phy], mu, d_[phy], s);
+
+    for (int ch = 0; ch < channels_; ch++)
+      out[ch] = std::clamp((s[ch] + (1 << 30)) >> 31, int64_t(pcm_min_),
+                           int64_t(pcm_max_));
+  }
 
-  // Apply the transfer coefficients `h`, corrected by linear interpolation,
-  // given fraction position `mu` weigthed by `d` values.
+  // Push an interleaved input frame in the windows.
 
-  inline int32_t Filter(const int32_t* in, const int32_t* h, int16_t mu,
-                        const int16_t* d);
+  template <typename T>
+  inline void Push(const T* in) {
+    for (int ch = 0; ch < channels_; ch++)
+      win_[ch][0][(out_pos_ + WSIZE / 2) % WSIZE] = win_[ch][1][(out_pos_)] =
+          in[ch];
+
+    out_pos_ = (out_pos_ + 1) % WSIZE;
+  }
 
   // Upsampling loop, the ratio is less than 1.0 in Q26 format,
   // more output samples are produced compared to input.
 
   template <typename T>
   __attribute__((no_sanitize("integer"))) void Upsample(
-      unsigned ratio, const T* in, int in_stride, size_t in_len,
-      size_t* in_count, T* out, int out_stride, size_t out_len,
-      size_t* out_count) {
+      unsigned ratio, const T* in, size_t in_len, size_t* in_count, T* out,
+      size_t out_len, size_t* out_count) {
     int nin = in_len, nout = out_len;
 
     while (nin > 0 && nout > 0) {
@@ -264,20 +435,15 @@ class SourceAudioHalAsrc::Resampler {
       unsigned phy = (in_pos_ >> 17) & 0x1ff;
       int16_t mu = (in_pos_ >> 2) & 0x7fff;
 
-      unsigned wbuf = idx < WSIZE / 2 || idx >= WSIZE + WSIZE / 2;
-      auto w = win_[wbuf] + ((idx + wbuf * WSIZE / 2) % WSIZE) - WSIZE / 2;
-
-      *out = Filter(w, h_[phy], mu, d_[phy]);
-      out += out_stride;
+      Filter(idx, phy, mu, out);
+      out += channels_;
       nout--;
       in_pos_ += ratio;
 
       if (in_pos_ - (out_pos_ << 26) >= (1u << 26)) {
-        win_[0][(out_pos_ + WSIZE / 2) % WSIZE] = win_[1][(out_pos_)] = *in;
-
-        in += in_stride;
+        Push(in);
+        in += channels_;
         nin--;
-        out_pos_ = (out_pos_ + 1) % WSIZE;
       }
     }
 
@@ -290,9 +456,8 @@ class SourceAudioHalAsrc::Resampler {
 
   template <typename T>
   __attribute__((no_sanitize("integer"))) void Downsample(
-      unsigned ratio, const T* in, int in_stride, size_t in_len,
-      size_t* in_count, T* out, int out_stride, size_t out_len,
-      size_t* out_count) {
+      unsigned ratio, const T* in, size_t in_len, size_t* in_count, T* out,
+      size_t out_len, size_t* out_count) {
     size_t nin = in_len, nout = out_len;
 
     while (nin > 0 && nout > 0) {
@@ -301,20 +466,15 @@ class SourceAudioHalAsrc::Resampler {
         unsigned phy = (in_pos_ >> 17) & 0x1ff;
         int16_t mu = (in_pos_ >> 2) & 0x7fff;
 
-        unsigned wbuf = idx < WSIZE / 2 || idx >= WSIZE + WSIZE / 2;
-        auto w = win_[wbuf] + ((idx + wbuf * WSIZE / 2) % WSIZE) - WSIZE / 2;
-
-        *out = Filter(w, h_[phy], mu, d_[phy]);
-        out += out_stride;
+        Filter(idx, phy, mu, out);
+        out += channels_;
         nout--;
         in_pos_ += ratio;
       }
 
-      win_[0][(out_pos_ + WSIZE / 2) % WSIZE] = win_[1][(out_pos_)] = *in;
-
-      in += in_stride;
+      Push(in);
+      in += channels_;
       nin--;
-      out_pos_ = (out_pos_ + 1) % WSIZE;
     }
 
     *in_count = in_len - nin;
@@ -322,112 +482,40 @@ class SourceAudioHalAsrc::Resampler {
   }
 
  public:
-  Resampler(int bit_depth)
+  // The SIMD kernel of the platform is used, unless `use_simd` is cleared.
+
+  Resampler(int channels, int bit_depth, bool use_simd = true)
       : h_(asrc::resampler_tables.h),
         d_(asrc::resampler_tables.d),
-        win_{{0}, {0}},
+        win_{},
         out_pos_(0),
         in_pos_(0),
+        channels_(std::clamp(channels, 1, MAX_CHANNELS)),
         pcm_min_(-(int32_t(1) << (bit_depth - 1))),
-        pcm_max_((int32_t(1) << (bit_depth - 1)) - 1) {}
+        pcm_max_((int32_t(1) << (bit_depth - 1)) - 1),
+        filter_(SelectFilter(use_simd)) {}
 
-  // Resample from `in` buffer to `out` buffer, until the end of any of
-  // the two buffers. `in_count` returns the number of consumed samples,
-  // and `out_count` the number produced. `in_sub` returns the phase in
-  // the input stream, in Q26 format.
+  int channels() const { return channels_; }
+
+  // Resample from the interleaved `in` buffer to the interleaved `out`
+  // buffer, until the end of any of the two buffers. The lengths are
+  // expressed in frames of `channels()` samples. `in_count` returns the
+  // number of consumed frames, and `out_count` the number produced.
+  // `in_sub` returns the phase in the input stream, in Q26 format.
 
   template <typename T>
-  void Resample(unsigned ratio_q26, const T* in, int in_stride, size_t in_len,
-                size_t* in_count, T* out, int out_stride, size_t out_len,
-                size_t* out_count, unsigned* in_sub_q26) {
+  void Resample(unsigned ratio_q26, const T* in, size_t in_len,
+                size_t* in_count, T* out, size_t out_len, size_t* out_count,
+                unsigned* in_sub_q26) {
     auto fn = ratio_q26 < (1u << 26) ? &Resampler::Upsample<T>
                                      : &Resampler::Downsample<T>;
 
-    (this->*fn)(ratio_q26, in, in_stride, in_len, in_count, out, out_stride,
-                out_len, out_count);
+    (this->*fn)(ratio_q26, in, in_len, in_count, out, out_len, out_count);
 
     *in_sub_q26 = in_pos_ & ((1u << 26) - 1);
   }
 };
 
-//
-// ARM AArch 64 Neon Resampler Filtering
-//
-
-#if __ARM_NEON && __ARM_ARCH_ISA_A64
-
-#include <arm_neon.h>
-
-static inline int32x4_t vmull_low_s16(int16x8_t a, int16x8_t b) {
-  return vmull_s16(vget_low_s16(a), vget_low_s16(b));
-}
-
-static inline int64x2_t vmull_low_s32(int32x4_t a, int32x4_t b) {
-  return vmull_s32(vget_low_s32(a), vget_low_s32(b));
-}
-
-static inline int64x2_t vmlal_low_s32(int64x2_t r, int32x4_t a, int32x4_t b) {
-  return vmlal_s32(r, vget_low_s32(a), vget_low_s32(b));
-}
-
-inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* x,
-                                                     const int32_t* h,
-                                                     int16_t _mu,
-                                                     const int16_t* d) {
-  int64x2_t sx;
-
-  int16x8_t mu = vdupq_n_s16(_mu);
-
-  int16x8_t d0 = vld1q_s16(d + 0);
-  int32x4_t h0 = vld1q_s32(h + 0), h4 = vld1q_s32(h + 4);
-  int32x4_t x0 = vld1q_s32(x + 0), x4 = vld1q_s32(x + 4);
-
-  h0 = vaddq_s32(h0, vrshrq_n_s32(vmull_low_s16(d0, mu), 7));
-  h4 = vaddq_s32(h4, vrshrq_n_s32(vmull_high_s16(d0, mu), 7));
-
-  sx = vmull_low_s32(x0, h0);
-  sx = vmlal_high_s32(sx, x0, h0);
-  sx = vmlal_low_s32(sx, x4, h4);
-  sx = vmlal_high_s32(sx, x4, h4);
-
-  for (int i = 8; i < 32; i += 8) {
-    int16x8_t d8 = vld1q_s16(d + i);
-    int32x4_t h8 = vld1q_s32(h + i), h12 = vld1q_s32(h + i + 4);
-    int32x4_t x8 = vld1q_s32(x + i), x12 = vld1q_s32(x + i + 4);
-
-    h8 = vaddq_s32(h8, vrshrq_n_s32(vmull_low_s16(d8, mu), 7));
-    h12 = vaddq_s32(h12, vrshrq_n_s32(vmull_high_s16(d8, mu), 7));
-
-    sx = vmlal_low_s32(sx, x8, h8);
-    sx = vmlal_high_s32(sx, x8, h8);
-    sx = vmlal_low_s32(sx, x12, h12);
-    sx = vmlal_high_s32(sx, x12, h12);
-  }
-
-  int64_t s = (vaddvq_s64(sx) + (1 << 30)) >> 31;
-  return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
-}
-
-//
-// Generic Resampler Filtering
-//
-
-#else
-
-inline int32_t SourceAudioHalAsrc::Resampler::Filter(const int32_t* in,
-                                                     const int32_t* h,
-                                                     int16_t mu,
-                                                     const int16_t* d) {
-  int64_t s = 0;
-  for (int i = 0; i < 2 * KERNEL_A - 1; i++)
-    s += int64_t(in[i]) * (h[i] + ((mu * d[i] + (1 << 6)) >> 7));
-
-  s = (s + (1 << 30)) >> 31;
-  return std::clamp(s, int64_t(pcm_min_), int64_t(pcm_max_));
-}
-
-#endif
-
 SourceAudioHalAsrc::SourceAudioHalAsrc(
     bluetooth::common::MessageLoopThread* thread, int channels, int sample_rate,
     int bit_depth, int interval_us, int num_burst_buffers, int burst_delay_ms)
@@ -470,7 +558,7 @@ SourceAudioHalAsrc::SourceAudioHalAsrc(
   // when the PCM bit_depth is higher than 16 bits.
 
   clock_recovery_ = std::make_unique<ClockRecovery>(thread);
-  resamplers_ = std::make_unique<std::vector<Resampler>>(channels, bit_depth_);
+  resampler_ = std::make_unique<Resampler>(channels, bit_depth_);
 
   // Deduct from the PCM stream characteristics, the size of the pool buffers
   // It needs 3 buffers (one almost full, an entire one, and a last which can be
@@ -504,9 +592,9 @@ template <typename T>
 __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
     double ratio, const std::vector<uint8_t>& in,
     std::vector<const std::vector<uint8_t>*>* out, uint32_t* output_us) {
-  auto& resamplers = *resamplers_;
+  auto& resampler = *resampler_;
   auto& buffers = buffers_;
-  auto channels = resamplers.size();
+  auto channels = resampler.channels();
 
   // Convert the resampling ration in fixed Q16,
   // then loop until the input buffer is consumed.
@@ -522,7 +610,7 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
 
     // Load from the context the current output buffer, the offset
     // and deduct the remaning size. Let's resample the interleaved
-    // PCM stream, a separate reampler is used for each channel.
+    // PCM stream, all the channels are processed in a single pass.
 
     auto buffer = &buffers.pool[buffers.index];
     auto out_data = (T*)buffer->data() + buffers.offset;
@@ -531,9 +619,8 @@ __attribute__((no_sanitize("integer"))) void SourceAudioHalAsrc::Resample(
 
     size_t in_count, out_count;
 
-    for (auto& r : resamplers)
-      r.Resample<T>(ratio_q26, in_data++, channels, in_length, &in_count,
-                    out_data++, channels, out_length, &out_count, &sub_q26);
+    resampler.Resample<T>(ratio_q26, in_data, in_length, &in_count, out_data,
+                          out_length, &out_count, &sub_q26);
 
     in_length -= in_count;
     buffers.offset += out_count * channels;
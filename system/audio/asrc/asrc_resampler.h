@@ -78,7 +78,7 @@ class SourceAudioHalAsrc {
   std::unique_ptr<ClockRecovery> clock_recovery_;
 
   class Resampler;
-  std::unique_ptr<std::vector<Resampler>> resamplers_;
+  std::unique_ptr<Resampler> resampler_;
   struct {
     unsigned seconds;
     int samples;
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// CPU time of the resampler per 10 ms frame at 48 kHz, with the generic and
+// the SIMD kernel. The `rms_error` counter is expressed in LSB, against the
+// output of the generic kernel, which is the reference implementation.
+// The `realtime` counter is the number of seconds of audio resampled per
+// second of CPU.
+
+#include <benchmark/benchmark.h>
+
+#include "asrc_resampler.cc"
+#include "asrc_resampler_test_util.h"
+
+bluetooth::common::MessageLoopThread message_loop_thread("main message loop");
+bluetooth::common::MessageLoopThread* get_main_thread() {
+  return &message_loop_thread;
+}
+
+namespace bluetooth::hal {
+void LinkClocker::Register(ReadClockHandler*) {}
+void LinkClocker::Unregister(ReadClockHandler*) {}
+}  // namespace bluetooth::hal
+
+namespace bluetooth::audio::asrc {
+namespace {
+
+using ::benchmark::State;
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kFrameLength = kSampleRate / 100;
+constexpr size_t kNumFrames = 100;
+
+// Drift of the audio clock corrected by the ASRC, in both directions.
+constexpr double kRatios[] = {1 - 100e-6, 1 + 100e-6};
+
+template <typename T>
+double RmsError(const std::vector<T>& ref, const std::vector<T>& out) {
+  size_t n = std::min(ref.size(), out.size());
+  double sum = 0;
+  for (size_t i = 0; i < n; i++) sum += pow(double(ref[i]) - out[i], 2);
+  return n ? sqrt(sum / n) : 0;
+}
+
+template <typename T>
+void Run(State& state, int channels, int bit_depth, double ratio,
+         bool use_simd) {
+  auto in = MakeSignal<T>(channels, bit_depth, kNumFrames * kFrameLength,
+                          kSampleRate);
+
+  auto ref = SourceAudioHalAsrcTest::Resample(channels, bit_depth, false,
+                                              ratio, in, kFrameLength);
+  auto out = SourceAudioHalAsrcTest::Resample(channels, bit_depth, use_simd,
+                                              ratio, in, kFrameLength);
+
+  SourceAudioHalAsrc::Resampler resampler(channels, bit_depth, use_simd);
+  unsigned ratio_q26 = round(ldexp(ratio, 26));
+  std::vector<T> frame((kFrameLength + 1) * channels);
+  size_t index = 0;
+
+  for (auto _ : state) {
+    size_t in_count, out_count;
+    unsigned sub_q26;
+
+    resampler.Resample(ratio_q26, in.data() + index * kFrameLength * channels,
+                       kFrameLength, &in_count, frame.data(),
+                       kFrameLength + 1, &out_count, &sub_q26);
+    benchmark::DoNotOptimize(frame.data());
+    index = (index + 1) % kNumFrames;
+  }
+
+  state.counters["rms_error"] = RmsError(ref, out);
+  double frame_sec = double(kFrameLength) / kSampleRate;
+  state.counters["realtime"] = benchmark::Counter(
+      state.iterations() * frame_sec, benchmark::Counter::kIsRate);
+}
+
+// state.range(0) is the number of channels, state.range(1) the bit depth,
+// state.range(2) indexes `kRatios` and state.range(3) enables SIMD.
+void BM_AsrcResample(State& state) {
+  int channels = state.range(0), bit_depth = state.range(1);
+  double ratio = kRatios[state.range(2)];
+  bool use_simd = state.range(3);
+
+  if (use_simd && !SourceAudioHalAsrcTest::HasSimdFilter()) {
+    state.SkipWithError("No SIMD resampler kernel on this platform");
+    return;
+  }
+
+  if (bit_depth <= 16)
+    Run<int16_t>(state, channels, bit_depth, ratio, use_simd);
+  else
+    Run<int32_t>(state, channels, bit_depth, ratio, use_simd);
+
+  state.SetLabel(std::to_string(channels) + " ch, " +
+                 std::to_string(bit_depth) + " bits, " +
+                 (ratio < 1 ? "upsample" : "downsample") +
+                 (use_simd ? ", simd" : ", generic"));
+}
+
+BENCHMARK(BM_AsrcResample)
+    ->ArgsProduct({{1, 2}, {16, 24}, {0, 1}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace bluetooth::audio::asrc
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "asrc_resampler.cc"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+
+#include "asrc_resampler_test_util.h"
+
+bluetooth::common::MessageLoopThread message_loop_thread("main message loop");
+bluetooth::common::MessageLoopThread* get_main_thread() {
+  return &message_loop_thread;
+}
+
+namespace bluetooth::hal {
+void LinkClocker::Register(ReadClockHandler*) {}
+void LinkClocker::Unregister(ReadClockHandler*) {}
+}  // namespace bluetooth::hal
+
+namespace bluetooth::audio::asrc {
+namespace {
+
+// Parameters are the number of channels, the bit depth and the ratio.
+class AsrcResamplerKernelTest
+    : public ::testing::TestWithParam<std::tuple<int, int, double>> {
+ protected:
+  template <typename T>
+  void ExpectSimdMatchesGeneric() {
+    auto [channels, bit_depth, ratio] = GetParam();
+    auto in = MakeSignal<T>(channels, bit_depth, 4800);
+
+    auto generic = SourceAudioHalAsrcTest::Resample(channels, bit_depth,
+                                                    false, ratio, in);
+    auto simd = SourceAudioHalAsrcTest::Resample(channels, bit_depth, true,
+                                                 ratio, in);
+    ASSERT_EQ(generic.size(), simd.size());
+    EXPECT_TRUE(generic == simd);
+  }
+
+  template <typename T>
+  void ExpectInterleavedMatchesMono() {
+    auto [channels, bit_depth, ratio] = GetParam();
+    auto in = MakeSignal<T>(channels, bit_depth, 4800);
+    auto out = SourceAudioHalAsrcTest::Resample(channels, bit_depth, true,
+                                                ratio, in);
+
+    for (int ch = 0; ch < channels; ch++) {
+      std::vector<T> mono_in;
+      for (size_t i = ch; i < in.size(); i += channels)
+        mono_in.push_back(in[i]);
+
+      auto mono_out = SourceAudioHalAsrcTest::Resample(1, bit_depth, false,
+                                                       ratio, mono_in);
+      ASSERT_EQ(mono_out.size() * channels, out.size());
+      for (size_t i = 0; i < mono_out.size(); i++)
+        ASSERT_EQ(mono_out[i], out[i * channels + ch])
+            << "channel " << ch << " sample " << i;
+    }
+  }
+};
+
+TEST_P(AsrcResamplerKernelTest, simd_matches_generic) {
+  if (!SourceAudioHalAsrcTest::HasSimdFilter())
+    GTEST_SKIP() << "No SIMD resampler kernel on this platform";
+
+  if (std::get<1>(GetParam()) <= 16)
+    ExpectSimdMatchesGeneric<int16_t>();
+  else
+    ExpectSimdMatchesGeneric<int32_t>();
+}
+
+TEST_P(AsrcResamplerKernelTest, interleaved_matches_mono) {
+  if (std::get<1>(GetParam()) <= 16)
+    ExpectInterleavedMatchesMono<int16_t>();
+  else
+    ExpectInterleavedMatchesMono<int32_t>();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AsrcResamplerKernelTestAllModes, AsrcResamplerKernelTest,
+    ::testing::Combine(::testing::Values(1, 2, 8), ::testing::Values(16, 24),
+                       ::testing::Values(44.1 / 48.0, 1 - 1e-4, 1 + 1e-4,
+                                         48.0 / 44.1)));
+
+}  // namespace
+}  // namespace bluetooth::audio::asrc
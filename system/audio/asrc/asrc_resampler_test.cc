@@ -26,7 +26,7 @@ bluetooth::common::MessageLoopThread* get_main_thread() {
 
 namespace bluetooth::hal {
 void LinkClocker::Register(ReadClockHandler*) {}
-void LinkClocker::Unregister() {}
+void LinkClocker::Unregister(ReadClockHandler*) {}
 }  // namespace bluetooth::hal
 
 namespace bluetooth::audio::asrc {
@@ -40,14 +40,12 @@ class SourceAudioHalAsrcTest : public SourceAudioHalAsrc {
   template <typename T>
   void Resample(double ratio, const T* in, size_t in_length, size_t* in_count,
                 T* out, size_t out_length, size_t* out_count) {
-    auto resamplers = *resamplers_;
-    auto channels = resamplers.size();
+    auto channels = resampler_->channels();
     unsigned sub_q26;
 
-    for (auto& r : resamplers)
-      r.Resample(round(ldexp(ratio, 26)), in, channels, in_length / channels,
-                 in_count, out, channels, out_length / channels, out_count,
-                 &sub_q26);
+    resampler_->Resample(round(ldexp(ratio, 26)), in, in_length / channels,
+                         in_count, out, out_length / channels, out_count,
+                         &sub_q26);
   }
 };
 
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Helpers of the resampler kernel tests and benchmark. The translation unit
+// includes "asrc_resampler.cc" before this header, to reach the private
+// resampler class.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth::audio::asrc {
+
+class SourceAudioHalAsrcTest {
+ public:
+  // Resample the interleaved `in` signal of `channels` channels, in runs of
+  // `run_length` frames, as done by the ASRC on each input buffer.
+
+  template <typename T>
+  static std::vector<T> Resample(int channels, int bit_depth, bool use_simd,
+                                 double ratio, const std::vector<T>& in,
+                                 size_t run_length = 480) {
+    SourceAudioHalAsrc::Resampler resampler(channels, bit_depth, use_simd);
+    unsigned ratio_q26 = round(ldexp(ratio, 26));
+
+    size_t in_length = in.size() / channels;
+    std::vector<T> out((size_t(ceil(in_length / ratio)) + 1) * channels);
+    size_t out_length = out.size() / channels;
+    size_t in_pos = 0, out_pos = 0;
+
+    while (in_pos < in_length && out_pos < out_length) {
+      size_t in_count, out_count;
+      unsigned sub_q26;
+
+      resampler.Resample(ratio_q26, in.data() + in_pos * channels,
+                         std::min(run_length, in_length - in_pos), &in_count,
+                         out.data() + out_pos * channels,
+                         out_length - out_pos, &out_count, &sub_q26);
+
+      in_pos += in_count;
+      out_pos += out_count;
+    }
+
+    out.resize(out_pos * channels);
+    return out;
+  }
+
+  // Return whether the platform provides a SIMD kernel.
+
+  static bool HasSimdFilter() { return SelectFilter(true) != FilterGeneric; }
+};
+
+// A different tone on each channel, with pseudo random noise. The amplitude
+// exceeds full scale, so that the clamping of the output is exercised.
+
+template <typename T>
+std::vector<T> MakeSignal(int channels, int bit_depth, size_t length,
+                          double sample_rate = 48000) {
+  std::vector<T> pcm(length * channels);
+  const double full_scale = ldexp(1, bit_depth - 1);
+  uint32_t lcg = 12345;
+
+  for (size_t i = 0; i < length; i++)
+    for (int ch = 0; ch < channels; ch++) {
+      lcg = lcg * 1103515245 + 12345;
+      double v = 1.05 * sin(2 * M_PI * (440. + 1000. * ch) * i / sample_rate) +
+                 ldexp(int16_t(lcg >> 16), -18);
+      pcm[i * channels + ch] =
+          T(std::clamp(round(v * full_scale), -full_scale, full_scale - 1));
+    }
+
+  return pcm;
+}
+
+}  // namespace bluetooth::audio::asrc
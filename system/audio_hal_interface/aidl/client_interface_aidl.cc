@@ -537,10 +537,11 @@ void BluetoothAudioClientInterface::FlushAudioData() {
     log::warn("data_mq_ invalid");
     return;
   }
+  /* Drop the pending data by moving the read pointer, there is no need to copy
+   * it out of the shared ring first. */
   size_t size = data_mq_->availableToRead();
-  std::vector<MqDataType> buffer(size);
-
-  if (data_mq_->read(buffer.data(), size) != size) {
+  DataMQ::MemTransaction tx;
+  if (!data_mq_->beginRead(size, &tx) || !data_mq_->commitRead(size)) {
     log::warn("failed to flush data queue!");
   }
 }
@@ -750,10 +750,11 @@ void BluetoothAudioClientInterface::FlushAudioData() {
     log::warn("mDataMQ invalid");
     return;
   }
+  /* Drop the pending data by moving the read pointer, there is no need to copy
+   * it out of the shared ring first. */
   size_t size = mDataMQ->availableToRead();
-  uint8_t p_buf[size];
-
-  if (mDataMQ->read(p_buf, size) != size)
+  DataMQ::MemTransaction tx;
+  if (!mDataMQ->beginRead(size, &tx) || !mDataMQ->commitRead(size))
     log::warn("failed to flush data queue!");
 }
 
@@ -75,6 +75,42 @@ void bta_ag_at_reinit(tBTA_AG_AT_CB* p_cb) {
   p_cb->cmd_pos = 0;
 }
 
+/******************************************************************************
+ *
+ * Function         bta_ag_at_find
+ *
+ * Description      Find the command received in the AT command table, through
+ *                  the table index when there is one.
+ *
+ *
+ * Returns          index of the matching entry, or of the end-of-table marker
+ *                  if there is no match
+ *
+ *****************************************************************************/
+static uint16_t bta_ag_at_find(const tBTA_AG_AT_CB* p_cb) {
+  const tBTA_AG_AT_INDEX* p_idx = p_cb->p_at_idx;
+  uint16_t idx;
+
+  if (p_idx == nullptr || !p_idx->valid) {
+    for (idx = 0; p_cb->p_at_tbl[idx].p_cmd[0] != 0; idx++) {
+      if (!utl_strucmp(p_cb->p_at_tbl[idx].p_cmd, p_cb->p_cmd_buf)) {
+        break;
+      }
+    }
+    return idx;
+  }
+
+  int hash = bta_ag_at_hash(p_cb->p_cmd_buf);
+  if (hash >= 0) {
+    for (uint8_t i = p_idx->bucket[hash]; i != 0; i = p_idx->next[i - 1]) {
+      if (!utl_strucmp(p_cb->p_at_tbl[i - 1].p_cmd, p_cb->p_cmd_buf)) {
+        return i - 1;
+      }
+    }
+  }
+  return p_idx->num_cmds;
+}
+
 /******************************************************************************
  *
  * Function         bta_ag_process_at
@@ -92,12 +128,8 @@ void bta_ag_process_at(tBTA_AG_AT_CB* p_cb, char* p_end) {
   uint8_t arg_type;
   char* p_arg;
   int16_t int_arg = 0;
-  /* loop through at command table looking for match */
-  for (idx = 0; p_cb->p_at_tbl[idx].p_cmd[0] != 0; idx++) {
-    if (!utl_strucmp(p_cb->p_at_tbl[idx].p_cmd, p_cb->p_cmd_buf)) {
-      break;
-    }
-  }
+  /* look up the command in the at command table */
+  idx = bta_ag_at_find(p_cb);
 
   /* if there is a match; verify argument type */
   if (p_cb->p_at_tbl[idx].p_cmd[0] != 0) {
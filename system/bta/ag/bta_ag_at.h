@@ -43,6 +43,10 @@
 #define BTA_AG_AT_STR 0 /* string */
 #define BTA_AG_AT_INT 1 /* integer */
 
+/* AT command table index */
+#define BTA_AG_AT_HASH_SIZE 64 /* number of hash buckets */
+#define BTA_AG_AT_MAX_CMDS 63  /* maximum number of commands of a table */
+
 /*****************************************************************************
  *  Data types
  ****************************************************************************/
@@ -57,6 +61,61 @@ typedef struct {
   int16_t max;       /* maximum value for int arg */
 } tBTA_AG_AT_CMD;
 
+/* Hash index of an AT command table.
+ *
+ * Extended commands ("+XXX") are hashed on the three characters that follow
+ * the '+', which tells apart almost all of the HFP commands, and basic
+ * commands ("A", "D") on their only character. A received command is hashed
+ * the same way and only compared with the few entries of its bucket, in
+ * table order, so the first match is the one the table scan would find. */
+typedef struct {
+  uint8_t bucket[BTA_AG_AT_HASH_SIZE]; /* first entry + 1, 0 if empty */
+  uint8_t next[BTA_AG_AT_MAX_CMDS];    /* next entry + 1 in the bucket */
+  uint8_t num_cmds;                    /* entries, end-of-table marker excl. */
+  bool valid;                          /* every command could be hashed */
+} tBTA_AG_AT_INDEX;
+
+constexpr char bta_ag_at_toupper(char c) {
+  return (c >= 'a' && c <= 'z') ? c - 0x20 : c;
+}
+
+/* Returns the bucket of the command at the start of |p_cmd|, or -1 if it is
+ * an extended command too short to be hashed */
+constexpr int bta_ag_at_hash(const char* p_cmd) {
+  if (p_cmd[0] != '+') {
+    return (uint8_t)bta_ag_at_toupper(p_cmd[0]) % BTA_AG_AT_HASH_SIZE;
+  }
+  uint32_t hash = 0;
+  for (int i = 1; i <= 3; i++) {
+    if (p_cmd[i] == 0) return -1;
+    hash = hash * 31 + (uint8_t)bta_ag_at_toupper(p_cmd[i]);
+  }
+  return hash % BTA_AG_AT_HASH_SIZE;
+}
+
+/* Builds the index of |tbl|, which ends with its end-of-table marker. Meant
+ * to be evaluated at compile time, next to the table. */
+template <size_t N>
+constexpr tBTA_AG_AT_INDEX bta_ag_at_make_index(
+    const tBTA_AG_AT_CMD (&tbl)[N]) {
+  tBTA_AG_AT_INDEX index{};
+  if (N - 1 > BTA_AG_AT_MAX_CMDS) return index;
+
+  index.num_cmds = N - 1;
+  index.valid = true;
+  /* insert from the end so that the buckets keep the table order */
+  for (size_t i = N - 1; i-- > 0;) {
+    int hash = bta_ag_at_hash(tbl[i].p_cmd);
+    if (hash < 0) {
+      index.valid = false;
+      continue;
+    }
+    index.next[i] = index.bucket[hash];
+    index.bucket[hash] = i + 1;
+  }
+  return index;
+}
+
 /* callback function executed when command is parsed */
 struct tBTA_AG_SCB;
 typedef void(tBTA_AG_AT_CMD_CBACK)(tBTA_AG_SCB* p_user, uint16_t command_id,
@@ -70,6 +129,7 @@ typedef void(tBTA_AG_AT_ERR_CBACK)(tBTA_AG_SCB* p_user, bool unknown,
 /* AT command parsing control block */
 typedef struct {
   const tBTA_AG_AT_CMD* p_at_tbl;    /* AT command table */
+  const tBTA_AG_AT_INDEX* p_at_idx;  /* index of the table, may be null */
   tBTA_AG_AT_CMD_CBACK* p_cmd_cback; /* command callback */
   tBTA_AG_AT_ERR_CBACK* p_err_cback; /* error callback */
   void* p_user;                      /* user-defined data */
@@ -61,7 +61,7 @@ using namespace bluetooth;
 #define COLON_IDX_4_VGSVGM 4
 
 /* AT command interpreter table for HSP */
-static const tBTA_AG_AT_CMD bta_ag_hsp_cmd[] = {
+static constexpr tBTA_AG_AT_CMD bta_ag_hsp_cmd[] = {
     {"+CKPD", BTA_AG_AT_CKPD_EVT, BTA_AG_AT_SET, BTA_AG_AT_INT, 200, 200},
     {"+VGS", BTA_AG_SPK_EVT, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
     {"+VGM", BTA_AG_MIC_EVT, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
@@ -69,7 +69,7 @@ static const tBTA_AG_AT_CMD bta_ag_hsp_cmd[] = {
     {"", 0, 0, 0, 0, 0}};
 
 /* AT command interpreter table for HFP */
-static const tBTA_AG_AT_CMD bta_ag_hfp_cmd[] = {
+static constexpr tBTA_AG_AT_CMD bta_ag_hfp_cmd[] = {
     {"A", BTA_AG_AT_A_EVT, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
     {"D", BTA_AG_AT_D_EVT, BTA_AG_AT_NONE | BTA_AG_AT_FREE, BTA_AG_AT_STR, 0,
      0},
@@ -117,10 +117,14 @@ static const tBTA_AG_AT_CMD bta_ag_hfp_cmd[] = {
 /* AT result code table element */
 typedef struct {
   const char* result_string; /* AT result string */
+  uint8_t result_len;        /* length of the result string */
   size_t result_id;          /* Local or BTA result id */
   uint8_t arg_type;          /* whether argument is int or string */
 } tBTA_AG_RESULT;
 
+#define BTA_AG_RESULT_ENTRY(str, id, fmt) \
+  { str, sizeof(str) - 1, id, fmt }
+
 /* AT result code argument types */
 enum {
   BTA_AG_RES_FMT_NONE, /* no argument */
@@ -142,31 +146,32 @@ enum {
 
 /* AT result code constant table */
 static const tBTA_AG_RESULT bta_ag_result_tbl[] = {
-    {"OK", BTA_AG_LOCAL_RES_OK, BTA_AG_RES_FMT_NONE},
-    {"ERROR", BTA_AG_LOCAL_RES_ERROR, BTA_AG_RES_FMT_NONE},
-    {"RING", BTA_AG_LOCAL_RES_RING, BTA_AG_RES_FMT_NONE},
-    {"+VGS: ", BTA_AG_SPK_RES, BTA_AG_RES_FMT_INT},
-    {"+VGM: ", BTA_AG_MIC_RES, BTA_AG_RES_FMT_INT},
-    {"+CCWA: ", BTA_AG_CALL_WAIT_RES, BTA_AG_RES_FMT_STR},
-    {"+CHLD: ", BTA_AG_IN_CALL_HELD_RES, BTA_AG_RES_FMT_STR},
-    {"+CIND: ", BTA_AG_CIND_RES, BTA_AG_RES_FMT_STR},
-    {"+CLIP: ", BTA_AG_LOCAL_RES_CLIP, BTA_AG_RES_FMT_STR},
-    {"+CIEV: ", BTA_AG_IND_RES, BTA_AG_RES_FMT_STR},
-    {"+BINP: ", BTA_AG_BINP_RES, BTA_AG_RES_FMT_STR},
-    {"+BVRA: ", BTA_AG_BVRA_RES, BTA_AG_RES_FMT_INT},
-    {"+BRSF: ", BTA_AG_LOCAL_RES_BRSF, BTA_AG_RES_FMT_INT},
-    {"+BSIR: ", BTA_AG_INBAND_RING_RES, BTA_AG_RES_FMT_INT},
-    {"+CNUM: ", BTA_AG_CNUM_RES, BTA_AG_RES_FMT_STR},
-    {"+BTRH: ", BTA_AG_BTRH_RES, BTA_AG_RES_FMT_INT},
-    {"+CLCC: ", BTA_AG_CLCC_RES, BTA_AG_RES_FMT_STR},
-    {"+COPS: ", BTA_AG_COPS_RES, BTA_AG_RES_FMT_STR},
-    {"+CME ERROR: ", BTA_AG_LOCAL_RES_CMEE, BTA_AG_RES_FMT_INT},
-    {"+BCS: ", BTA_AG_LOCAL_RES_BCS, BTA_AG_RES_FMT_INT},
-    {"+BIND: ", BTA_AG_BIND_RES, BTA_AG_RES_FMT_STR},
-    {"+%QAC: ", BTA_AG_LOCAL_RES_QAC, BTA_AG_RES_FMT_STR},
-    {"+%QCS: ", BTA_AG_LOCAL_RES_QCS, BTA_AG_RES_FMT_INT},
-
-    {"", BTA_AG_UNAT_RES, BTA_AG_RES_FMT_STR}};
+    BTA_AG_RESULT_ENTRY("OK", BTA_AG_LOCAL_RES_OK, BTA_AG_RES_FMT_NONE),
+    BTA_AG_RESULT_ENTRY("ERROR", BTA_AG_LOCAL_RES_ERROR, BTA_AG_RES_FMT_NONE),
+    BTA_AG_RESULT_ENTRY("RING", BTA_AG_LOCAL_RES_RING, BTA_AG_RES_FMT_NONE),
+    BTA_AG_RESULT_ENTRY("+VGS: ", BTA_AG_SPK_RES, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+VGM: ", BTA_AG_MIC_RES, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+CCWA: ", BTA_AG_CALL_WAIT_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+CHLD: ", BTA_AG_IN_CALL_HELD_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+CIND: ", BTA_AG_CIND_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+CLIP: ", BTA_AG_LOCAL_RES_CLIP, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+CIEV: ", BTA_AG_IND_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+BINP: ", BTA_AG_BINP_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+BVRA: ", BTA_AG_BVRA_RES, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+BRSF: ", BTA_AG_LOCAL_RES_BRSF, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+BSIR: ", BTA_AG_INBAND_RING_RES, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+CNUM: ", BTA_AG_CNUM_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+BTRH: ", BTA_AG_BTRH_RES, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+CLCC: ", BTA_AG_CLCC_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+COPS: ", BTA_AG_COPS_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+CME ERROR: ", BTA_AG_LOCAL_RES_CMEE,
+                        BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+BCS: ", BTA_AG_LOCAL_RES_BCS, BTA_AG_RES_FMT_INT),
+    BTA_AG_RESULT_ENTRY("+BIND: ", BTA_AG_BIND_RES, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+%QAC: ", BTA_AG_LOCAL_RES_QAC, BTA_AG_RES_FMT_STR),
+    BTA_AG_RESULT_ENTRY("+%QCS: ", BTA_AG_LOCAL_RES_QCS, BTA_AG_RES_FMT_INT),
+
+    BTA_AG_RESULT_ENTRY("", BTA_AG_UNAT_RES, BTA_AG_RES_FMT_STR)};
 
 static const tBTA_AG_RESULT* bta_ag_result_by_code(size_t code) {
   for (size_t i = 0;
@@ -179,6 +184,17 @@ static const tBTA_AG_RESULT* bta_ag_result_by_code(size_t code) {
 const tBTA_AG_AT_CMD* bta_ag_at_tbl[BTA_AG_NUM_IDX] = {bta_ag_hsp_cmd,
                                                        bta_ag_hfp_cmd};
 
+/* AT command table indexes, built at compile time */
+static constexpr tBTA_AG_AT_INDEX bta_ag_hsp_idx =
+    bta_ag_at_make_index(bta_ag_hsp_cmd);
+static constexpr tBTA_AG_AT_INDEX bta_ag_hfp_idx =
+    bta_ag_at_make_index(bta_ag_hfp_cmd);
+static_assert(bta_ag_hsp_idx.valid && bta_ag_hfp_idx.valid,
+              "AT command too short to be indexed");
+
+const tBTA_AG_AT_INDEX* bta_ag_at_idx[BTA_AG_NUM_IDX] = {&bta_ag_hsp_idx,
+                                                         &bta_ag_hfp_idx};
+
 typedef struct {
   size_t result_code;
   size_t indicator;
@@ -202,6 +218,151 @@ static size_t bta_ag_indicator_by_result_code(size_t code) {
   return BTA_AG_CALLSETUP_NONE;
 }
 
+/* Longest run of +CIEV results written at once, one per indicator that can
+ * be pending */
+#define BTA_AG_IND_BATCH_LEN (BTA_AG_IND_BATTCHG * 20)
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_ind_masked_out
+ *
+ * Description      Check if the HF deactivated an indicator with AT+BIA.
+ *                  Mandatory indicators can not be masked out.
+ *
+ *
+ * Returns          true if the indicator must not be sent
+ *
+ ******************************************************************************/
+static bool bta_ag_ind_masked_out(const tBTA_AG_SCB* p_scb, uint16_t id) {
+  return (p_scb->bia_masked_out & ((uint32_t)1 << id)) &&
+         ((id != BTA_AG_IND_CALL) && (id != BTA_AG_IND_CALLSETUP) &&
+          (id != BTA_AG_IND_CALLHELD));
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_ind_value
+ *
+ * Description      Get the last value set for an indicator that can be
+ *                  pending.
+ *
+ *
+ * Returns          indicator value
+ *
+ ******************************************************************************/
+static uint8_t bta_ag_ind_value(const tBTA_AG_SCB* p_scb, uint16_t id) {
+  switch (id) {
+    case BTA_AG_IND_CALL:
+      return p_scb->call_ind;
+    case BTA_AG_IND_CALLSETUP:
+      return p_scb->callsetup_ind;
+    case BTA_AG_IND_SERVICE:
+      return p_scb->service_ind;
+    case BTA_AG_IND_SIGNAL:
+      return p_scb->signal_ind;
+    case BTA_AG_IND_ROAM:
+      return p_scb->roam_ind;
+    case BTA_AG_IND_BATTCHG:
+      return p_scb->battchg_ind;
+    default:
+      return 0;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_fmt_pending_inds
+ *
+ * Description      Format the CIEV result codes of the pending indicators in
+ *                  p_buf, which holds BTA_AG_IND_BATCH_LEN bytes, and clear
+ *                  them. Indicators deactivated by the HF since they were
+ *                  queued are dropped.
+ *
+ *
+ * Returns          length of the formatted result codes
+ *
+ ******************************************************************************/
+static uint16_t bta_ag_fmt_pending_inds(tBTA_AG_SCB* p_scb, char* p_buf) {
+  static const char ciev[] = "\r\n+CIEV: ";
+  uint32_t pending = p_scb->ind_pending;
+  char* p = p_buf;
+
+  if (pending == 0) return 0;
+
+  p_scb->ind_pending = 0;
+  alarm_cancel(p_scb->ind_timer);
+  if (!p_scb->cmer_enabled) return 0;
+
+  for (uint16_t id = BTA_AG_IND_CALL; id <= BTA_AG_IND_BATTCHG; id++) {
+    if (!(pending & ((uint32_t)1 << id)) || bta_ag_ind_masked_out(p_scb, id)) {
+      continue;
+    }
+    memcpy(p, ciev, sizeof(ciev) - 1);
+    p += sizeof(ciev) - 1;
+    p += utl_itoa(id, p);
+    *p++ = ',';
+    p += utl_itoa(bta_ag_ind_value(p_scb, id), p);
+    *p++ = '\r';
+    *p++ = '\n';
+  }
+  return (uint16_t)(p - p_buf);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_write_data
+ *
+ * Description      Write AT result codes to the RFCOMM channel.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_ag_write_data(tBTA_AG_SCB* p_scb, const char* p_buf,
+                              uint16_t buf_len) {
+  uint16_t len = 0;
+  if (PORT_WriteData(p_scb->conn_handle, p_buf, buf_len, &len) !=
+      PORT_SUCCESS) {
+    log::warn(
+        "Unable to write RFCOMM data peer:{} handle:{} len_exp:{} len_act:{}",
+        p_scb->peer_addr, p_scb->conn_handle, buf_len, len);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_send_pending_inds
+ *
+ * Description      Send the pending indicators in a single write.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_ag_send_pending_inds(tBTA_AG_SCB* p_scb) {
+  char buf[BTA_AG_IND_BATCH_LEN];
+  uint16_t len = bta_ag_fmt_pending_inds(p_scb, buf);
+  if (len > 0) {
+    bta_ag_write_data(p_scb, buf, len);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_ind_timer_cback
+ *
+ * Description      Send the status indicators merged during the coalescing
+ *                  window.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_ag_ind_timer_cback(void* data) {
+  tBTA_AG_SCB* p_scb = (tBTA_AG_SCB*)data;
+  bta_ag_send_pending_inds(p_scb);
+}
+
 /*******************************************************************************
  *
  * Function         bta_ag_send_result
@@ -220,15 +381,17 @@ static void bta_ag_send_result(tBTA_AG_SCB* p_scb, size_t code,
     return;
   }
 
-  char buf[BTA_AG_AT_MAX_LEN + 16] = "";
-  char* p = buf;
+  char buf[BTA_AG_IND_BATCH_LEN + BTA_AG_AT_MAX_LEN + 16] = "";
+
+  /* pending indicators go first, in the same write */
+  char* p = buf + bta_ag_fmt_pending_inds(p_scb, buf);
 
   /* init with \r\n */
   *p++ = '\r';
   *p++ = '\n';
 
   /* copy result code string */
-  strlcpy(p, result->result_string, sizeof(buf) - 2);
+  memcpy(p, result->result_string, result->result_len);
 
   if (p_scb->conn_service == BTA_AG_HSP) {
     /* If HSP then ":"symbol should be changed as "=" for HSP compatibility */
@@ -242,14 +405,15 @@ static void bta_ag_send_result(tBTA_AG_SCB* p_scb, size_t code,
     }
   }
 
-  p += strlen(result->result_string);
+  p += result->result_len;
 
   /* copy argument if any */
   if (result->arg_type == BTA_AG_RES_FMT_INT) {
     p += utl_itoa((uint16_t)int_arg, p);
   } else if (result->arg_type == BTA_AG_RES_FMT_STR) {
-    strcpy(p, p_arg);
-    p += strlen(p_arg);
+    size_t arg_len = strlen(p_arg);
+    memcpy(p, p_arg, arg_len);
+    p += arg_len;
   }
 
   /* finish with \r\n */
@@ -257,13 +421,7 @@ static void bta_ag_send_result(tBTA_AG_SCB* p_scb, size_t code,
   *p++ = '\n';
 
   /* send to RFCOMM */
-  uint16_t len = 0;
-  if (PORT_WriteData(p_scb->conn_handle, buf, (uint16_t)(p - buf), &len) !=
-      PORT_SUCCESS) {
-    log::warn(
-        "Unable to write RFCOMM data peer:{} handle:{} len_exp:{} len_act:{}",
-        p_scb->peer_addr, p_scb->conn_handle, (uint16_t)(p - buf), len);
-  }
+  bta_ag_write_data(p_scb, buf, (uint16_t)(p - buf));
 }
 
 /*******************************************************************************
@@ -301,74 +459,99 @@ static void bta_ag_send_error(tBTA_AG_SCB* p_scb, int16_t errcode) {
 
 /*******************************************************************************
  *
- * Function         bta_ag_send_ind
+ * Function         bta_ag_update_ind
  *
- * Description      Send an indicator CIEV result code.
+ * Description      Update the value of an indicator.
  *
  *
- * Returns          void
+ * Returns          true if the CIEV result code must be sent
  *
  ******************************************************************************/
-static void bta_ag_send_ind(tBTA_AG_SCB* p_scb, uint16_t id, uint16_t value,
-                            bool on_demand) {
-  char str[12];
-  char* p = str;
-
+static bool bta_ag_update_ind(tBTA_AG_SCB* p_scb, uint16_t id, uint16_t value,
+                              bool on_demand) {
   /* If the indicator is masked out, just return */
-  /* Mandatory indicators can not be masked out. */
-  if ((p_scb->bia_masked_out & ((uint32_t)1 << id)) &&
-      ((id != BTA_AG_IND_CALL) && (id != BTA_AG_IND_CALLSETUP) &&
-       (id != BTA_AG_IND_CALLHELD)))
-    return;
+  if (bta_ag_ind_masked_out(p_scb, id)) return false;
 
   /* Ensure we do not send duplicate indicators if not requested by app */
   /* If it was requested by app, transmit CIEV even if it is duplicate. */
   if (id == BTA_AG_IND_CALL) {
-    if ((value == p_scb->call_ind) && (!on_demand)) return;
+    if ((value == p_scb->call_ind) && (!on_demand)) return false;
 
     p_scb->call_ind = (uint8_t)value;
   }
 
   if ((id == BTA_AG_IND_CALLSETUP) && (!on_demand)) {
-    if (value == p_scb->callsetup_ind) return;
+    if (value == p_scb->callsetup_ind) return false;
 
     p_scb->callsetup_ind = (uint8_t)value;
   }
 
   if ((id == BTA_AG_IND_SERVICE) && (!on_demand)) {
-    if (value == p_scb->service_ind) return;
+    if (value == p_scb->service_ind) return false;
 
     p_scb->service_ind = (uint8_t)value;
   }
   if ((id == BTA_AG_IND_SIGNAL) && (!on_demand)) {
-    if (value == p_scb->signal_ind) return;
+    if (value == p_scb->signal_ind) return false;
 
     p_scb->signal_ind = (uint8_t)value;
   }
   if ((id == BTA_AG_IND_ROAM) && (!on_demand)) {
-    if (value == p_scb->roam_ind) return;
+    if (value == p_scb->roam_ind) return false;
 
     p_scb->roam_ind = (uint8_t)value;
   }
   if ((id == BTA_AG_IND_BATTCHG) && (!on_demand)) {
-    if (value == p_scb->battchg_ind) return;
+    if (value == p_scb->battchg_ind) return false;
 
     p_scb->battchg_ind = (uint8_t)value;
   }
 
   if ((id == BTA_AG_IND_CALLHELD) && (!on_demand)) {
     /* call swap could result in sending callheld=1 multiple times */
-    if ((value != 1) && (value == p_scb->callheld_ind)) return;
+    if ((value != 1) && (value == p_scb->callheld_ind)) return false;
 
     p_scb->callheld_ind = (uint8_t)value;
   }
 
-  if (p_scb->cmer_enabled) {
-    p += utl_itoa(id, p);
-    *p++ = ',';
-    utl_itoa(value, p);
-    bta_ag_send_result(p_scb, BTA_AG_IND_RES, str, 0);
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_ag_send_ind
+ *
+ * Description      Send an indicator CIEV result code.
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_ag_send_ind(tBTA_AG_SCB* p_scb, uint16_t id, uint16_t value,
+                            bool on_demand) {
+  char str[12];
+  char* p = str;
+
+  if (!bta_ag_update_ind(p_scb, id, value, on_demand)) return;
+  if (!p_scb->cmer_enabled) return;
+
+  /* Status indicators often change together, for example the service, the
+   * signal and the roaming ones when the phone camps on a network. Their
+   * updates are merged and sent in a single write at the end of a short
+   * window, or before the next result code. */
+  if (!on_demand && id >= BTA_AG_IND_SERVICE && id <= BTA_AG_IND_BATTCHG) {
+    p_scb->ind_pending |= (uint32_t)1 << id;
+    if (!alarm_is_scheduled(p_scb->ind_timer)) {
+      alarm_set_on_mloop(p_scb->ind_timer, BTA_AG_IND_COALESCE_MS,
+                         bta_ag_ind_timer_cback, p_scb);
+    }
+    return;
   }
+
+  p += utl_itoa(id, p);
+  *p++ = ',';
+  utl_itoa(value, p);
+  bta_ag_send_result(p_scb, BTA_AG_IND_RES, str, 0);
 }
 
 /*******************************************************************************
@@ -579,9 +762,14 @@ void bta_ag_send_call_inds(tBTA_AG_SCB* p_scb, tBTA_AG_RES result) {
     call = p_scb->call_ind;
   }
 
-  /* Send indicator function tracks if the values have actually changed */
-  bta_ag_send_ind(p_scb, BTA_AG_IND_CALL, call, false);
-  bta_ag_send_ind(p_scb, BTA_AG_IND_CALLSETUP, callsetup, false);
+  /* Only the indicators that actually changed are sent, in a single write */
+  if (bta_ag_update_ind(p_scb, BTA_AG_IND_CALL, call, false)) {
+    p_scb->ind_pending |= (uint32_t)1 << BTA_AG_IND_CALL;
+  }
+  if (bta_ag_update_ind(p_scb, BTA_AG_IND_CALLSETUP, callsetup, false)) {
+    p_scb->ind_pending |= (uint32_t)1 << BTA_AG_IND_CALLSETUP;
+  }
+  bta_ag_send_pending_inds(p_scb);
 }
 
 /*******************************************************************************
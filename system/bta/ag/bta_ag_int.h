@@ -70,6 +70,9 @@
 /* Timeout for alarm in 2018 toyota camry carkit workaround */
 #define BTA_AG_BIND_TIMEOUT_MS 500
 
+/* Window in which the status indicator updates are merged in one write */
+#define BTA_AG_IND_COALESCE_MS 50
+
 enum {
   /* these events are handled by the state machine */
   BTA_AG_API_REGISTER_EVT = BTA_SYS_EVT_START(BTA_ID_AG),
@@ -287,6 +290,8 @@ struct tBTA_AG_SCB {
   uint8_t battchg_ind;      /* CIEV battery charge indicator value */
   uint8_t callheld_ind;     /* CIEV call held indicator value */
   uint32_t bia_masked_out;  /* indicators HF does not want us to send */
+  uint32_t ind_pending;     /* CIEV indicators waiting to be sent */
+  alarm_t* ind_timer;       /* Timer merging the status indicator updates */
   alarm_t* bind_timer;      /* Timer for toyota camry 2018 carkit workaround */
   alarm_t* collision_timer;
   alarm_t* ring_timer;
@@ -359,6 +364,7 @@ typedef struct {
 extern const uint16_t bta_ag_uuid[BTA_AG_NUM_IDX];
 extern const uint8_t bta_ag_sec_id[BTA_AG_NUM_IDX];
 extern const tBTA_AG_AT_CMD* bta_ag_at_tbl[BTA_AG_NUM_IDX];
+extern const tBTA_AG_AT_INDEX* bta_ag_at_idx[BTA_AG_NUM_IDX];
 
 /* control block declaration */
 extern tBTA_AG_CB bta_ag_cb;
@@ -159,6 +159,7 @@ static tBTA_AG_SCB* bta_ag_scb_alloc(void) {
       p_scb->collision_timer = alarm_new("bta_ag.scb_collision_timer");
       p_scb->codec_negotiation_timer =
           alarm_new("bta_ag.scb_codec_negotiation_timer");
+      p_scb->ind_timer = alarm_new("bta_ag.scb_ind_timer");
       /* reset to CVSD S4 settings as the preferred */
       p_scb->codec_cvsd_settings = BTA_AG_SCO_CVSD_SETTINGS_S4;
       /* set eSCO mSBC setting to T2 as the preferred */
@@ -200,6 +201,7 @@ void bta_ag_scb_dealloc(tBTA_AG_SCB* p_scb) {
   alarm_free(p_scb->ring_timer);
   alarm_free(p_scb->codec_negotiation_timer);
   alarm_free(p_scb->collision_timer);
+  alarm_free(p_scb->ind_timer);
 
   /* initialize control block */
   *p_scb = {};
@@ -413,6 +415,7 @@ void bta_ag_api_enable(tBTA_AG_CBACK* p_cback) {
     alarm_free(scb.ring_timer);
     alarm_free(scb.codec_negotiation_timer);
     alarm_free(scb.collision_timer);
+    alarm_free(scb.ind_timer);
     scb = {};
   }
 
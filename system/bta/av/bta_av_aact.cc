@@ -25,12 +25,14 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "bta_av"
 
 #include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include <vector>
 
 #include "bta/av/bta_av_int.h"
@@ -92,6 +94,12 @@ constexpr char kBtmLogTag[] = "A2DP";
 /* ACL quota we are letting FW use for A2DP Offload Tx. */
 #define BTA_AV_A2DP_OFFLOAD_XMIT_QUOTA 4
 
+/* Set to false to always discover the stream endpoints of the peer */
+#define BTA_AV_SEP_CACHE_PROPERTY "bluetooth.a2dp.sep_cache.enabled"
+
+/* Version of the stream endpoints saved in the storage */
+#define BTA_AV_SEP_CACHE_VERSION 1
+
 static void bta_av_offload_codec_builder(tBTA_AV_SCB* p_scb,
                                          tBT_A2DP_OFFLOAD* p_a2dp_offload);
 
@@ -209,6 +217,128 @@ static uint8_t bta_av_get_scb_sep_type(tBTA_AV_SCB* p_scb,
   return AVDT_TSEP_INVALID;
 }
 
+/* Stream endpoint of a peer and its capabilities, as saved in the storage */
+typedef struct {
+  uint8_t seid;
+  uint8_t media_type;
+  uint8_t tsep;
+  uint8_t has_caps;
+  uint8_t codec_info[AVDT_CODEC_SIZE];
+  uint8_t protect_info[AVDT_PROTECT_SIZE];
+  uint8_t num_codec;
+  uint8_t num_protect;
+  uint16_t psc_mask;
+  uint8_t recov_type;
+  uint8_t recov_mrws;
+  uint8_t recov_mnmp;
+  uint8_t hdrcmp_mask;
+} __attribute__((packed)) tBTA_AV_SEP_CACHE_ENTRY;
+
+/*******************************************************************************
+ *
+ * Function         bta_av_sep_cache_load
+ *
+ * Description      Read the stream endpoints of the peer and their
+ *                  capabilities, saved by the last stream discovery, into
+ *                  sep_info and peer_caps.
+ *
+ * Returns          true if the stream endpoints were read.
+ *
+ ******************************************************************************/
+bool bta_av_sep_cache_load(tBTA_AV_SCB* p_scb) {
+  if (!osi_property_get_bool(BTA_AV_SEP_CACHE_PROPERTY, true)) return false;
+
+  const std::string section = p_scb->PeerAddress().ToString();
+  size_t size =
+      btif_config_get_bin_length(section, BTIF_STORAGE_KEY_AVDTP_SEP_CACHE);
+  if (size <= 1 || (size - 1) % sizeof(tBTA_AV_SEP_CACHE_ENTRY) != 0 ||
+      (size - 1) / sizeof(tBTA_AV_SEP_CACHE_ENTRY) > BTA_AV_NUM_SEPS) {
+    return false;
+  }
+
+  std::vector<uint8_t> value(size);
+  if (!btif_config_get_bin(section, BTIF_STORAGE_KEY_AVDTP_SEP_CACHE,
+                           value.data(), &size) ||
+      value[0] != BTA_AV_SEP_CACHE_VERSION) {
+    return false;
+  }
+
+  p_scb->num_seps = (size - 1) / sizeof(tBTA_AV_SEP_CACHE_ENTRY);
+  p_scb->peer_caps_mask = 0;
+  for (uint8_t i = 0; i < p_scb->num_seps; i++) {
+    tBTA_AV_SEP_CACHE_ENTRY entry;
+    memcpy(&entry, value.data() + 1 + i * sizeof(entry), sizeof(entry));
+
+    /* the stream endpoints in use are rejected by the peer on configuration */
+    p_scb->sep_info[i] = {
+        .in_use = false,
+        .seid = entry.seid,
+        .media_type = entry.media_type,
+        .tsep = entry.tsep,
+    };
+    if (!entry.has_caps) continue;
+
+    AvdtpSepConfig& caps = p_scb->peer_caps[i];
+    memcpy(caps.codec_info, entry.codec_info, AVDT_CODEC_SIZE);
+    memcpy(caps.protect_info, entry.protect_info, AVDT_PROTECT_SIZE);
+    caps.num_codec = entry.num_codec;
+    caps.num_protect = entry.num_protect;
+    caps.psc_mask = entry.psc_mask;
+    caps.recov_type = entry.recov_type;
+    caps.recov_mrws = entry.recov_mrws;
+    caps.recov_mnmp = entry.recov_mnmp;
+    caps.hdrcmp_mask = entry.hdrcmp_mask;
+    p_scb->peer_caps_mask |= 1u << i;
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_sep_cache_store
+ *
+ * Description      Save the stream endpoints of the peer and the capabilities
+ *                  read from them, to configure a stream on reconnection
+ *                  without discovering them again.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_sep_cache_store(tBTA_AV_SCB* p_scb) {
+  if (!osi_property_get_bool(BTA_AV_SEP_CACHE_PROPERTY, true)) return;
+
+  std::vector<uint8_t> value(
+      1 + p_scb->num_seps * sizeof(tBTA_AV_SEP_CACHE_ENTRY));
+  value[0] = BTA_AV_SEP_CACHE_VERSION;
+  for (uint8_t i = 0; i < p_scb->num_seps; i++) {
+    tBTA_AV_SEP_CACHE_ENTRY entry = {
+        .seid = p_scb->sep_info[i].seid,
+        .media_type = p_scb->sep_info[i].media_type,
+        .tsep = p_scb->sep_info[i].tsep,
+        .has_caps = (p_scb->peer_caps_mask & (1u << i)) != 0,
+    };
+    if (entry.has_caps) {
+      const AvdtpSepConfig& caps = p_scb->peer_caps[i];
+      memcpy(entry.codec_info, caps.codec_info, AVDT_CODEC_SIZE);
+      memcpy(entry.protect_info, caps.protect_info, AVDT_PROTECT_SIZE);
+      entry.num_codec = caps.num_codec;
+      entry.num_protect = caps.num_protect;
+      entry.psc_mask = caps.psc_mask;
+      entry.recov_type = caps.recov_type;
+      entry.recov_mrws = caps.recov_mrws;
+      entry.recov_mnmp = caps.recov_mnmp;
+      entry.hdrcmp_mask = caps.hdrcmp_mask;
+    }
+    memcpy(value.data() + 1 + i * sizeof(entry), &entry, sizeof(entry));
+  }
+
+  if (!btif_config_set_bin(p_scb->PeerAddress().ToString(),
+                           BTIF_STORAGE_KEY_AVDTP_SEP_CACHE, value.data(),
+                           value.size())) {
+    log::warn("Failed to store stream endpoints of {}", p_scb->PeerAddress());
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_save_addr
@@ -319,7 +449,20 @@ static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
         (p_scb->sep_info[i].media_type == p_scb->media_type)) {
       p_scb->sep_info_idx = i;
 
+      /* the capabilities read from the storage are reported as if the peer
+       * answered */
+      if (p_scb->sep_cache_used && (p_scb->peer_caps_mask & (1u << i))) {
+        tAVDT_CTRL avdt_ctrl = {};
+        p_scb->peer_cap = p_scb->peer_caps[i];
+        avdt_ctrl.getcap_cfm.p_cfg = &p_scb->peer_cap;
+        bta_av_proc_stream_evt(0, p_scb->PeerAddress(), AVDT_GETCAP_CFM_EVT,
+                               &avdt_ctrl, p_scb->hdi);
+        sent_cmd = true;
+        break;
+      }
+
       /* we got a stream; get its capabilities */
+      p_scb->sep_cache_changed = true;
       bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
                          (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
       AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info[i].seid,
@@ -478,10 +621,9 @@ void bta_av_sink_data_cback(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     return;
   }
   p_pkt->event = BTA_AV_SINK_MEDIA_DATA_EVT;
+  /* The application takes ownership of the packet */
   p_scb->seps[p_scb->sep_idx].p_app_sink_data_cback(
       p_scb->PeerAddress(), BTA_AV_SINK_MEDIA_DATA_EVT, (tBTA_AV_MEDIA*)p_pkt);
-  /* Free the buffer: a copy of the packet has been delivered */
-  osi_free(p_pkt);
 }
 
 /*******************************************************************************
@@ -875,6 +1017,9 @@ void bta_av_cleanup(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
   p_scb->num_disc_snks = 0;
   p_scb->coll_mask = 0;
   p_scb->uuid_int = 0;
+  p_scb->peer_caps_mask = 0;
+  p_scb->sep_cache_used = false;
+  p_scb->sep_cache_changed = false;
   alarm_cancel(p_scb->avrc_ct_timer);
   alarm_cancel(p_scb->link_signalling_timer);
   alarm_cancel(p_scb->accept_signalling_timer);
@@ -1200,6 +1345,11 @@ void bta_av_str_opened(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   msg.peer_addr = p_scb->PeerAddress();
   p_scb->l2c_cid = AVDT_GetL2CapChannel(p_scb->avdt_handle);
   bta_av_conn_chg((tBTA_AV_DATA*)&msg);
+  if (p_scb->sep_cache_changed && p_scb->peer_caps_mask != 0) {
+    bta_av_sep_cache_store(p_scb);
+  }
+  p_scb->sep_cache_used = false;
+  p_scb->sep_cache_changed = false;
   /* set the congestion flag, so AV would not send media packets by accident */
   p_scb->cong = true;
   // Don't use AVDTP SUSPEND for restrict listed devices
@@ -1737,6 +1887,10 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   log::verbose("media type 0x{:x}, 0x{:x}", media_type, p_scb->media_type);
   log::verbose("codec: {}", A2DP_CodecInfoString(p_scb->cfg.codec_info));
 
+  /* keep the capabilities, they are saved once the stream is opened */
+  p_scb->peer_caps[p_scb->sep_info_idx] = p_scb->peer_cap;
+  p_scb->peer_caps_mask |= 1u << p_scb->sep_info_idx;
+
   /* if codec present and we get a codec configuration */
   if ((p_scb->peer_cap.num_codec != 0) && (media_type == p_scb->media_type) &&
       (p_scb->p_cos->getcfg(p_scb->hndl, p_scb->PeerAddress(), cfg.codec_info,
@@ -1837,12 +1991,59 @@ void bta_av_setconfig_rej(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
  *
  ******************************************************************************/
 void bta_av_discover_req(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* /* p_data */) {
+  /* when opening a stream to a known peer, configure one of the stream
+   * endpoints it reported the last time, without discovering them again */
+  if (bta_av_is_scb_opening(p_scb) && bta_av_sep_cache_load(p_scb)) {
+    log::info("peer {} using {} stored stream endpoints", p_scb->PeerAddress(),
+              p_scb->num_seps);
+    p_scb->sep_cache_used = true;
+    p_scb->sep_cache_changed = false;
+
+    tAVDT_CTRL avdt_ctrl = {};
+    avdt_ctrl.discover_cfm.p_sep_info = p_scb->sep_info;
+    avdt_ctrl.discover_cfm.num_seps = p_scb->num_seps;
+    bta_av_proc_stream_evt(0, p_scb->PeerAddress(), AVDT_DISCOVER_CFM_EVT,
+                           &avdt_ctrl, p_scb->hdi);
+    return;
+  }
+
+  p_scb->sep_cache_used = false;
+  p_scb->sep_cache_changed = true;
+  p_scb->peer_caps_mask = 0;
+
   /* send avdtp discover request */
 
   AVDT_DiscoverReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info,
                    BTA_AV_NUM_SEPS, &bta_av_proc_stream_evt);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_av_sep_cache_rej
+ *
+ * Description      The stream could not be opened with the stream endpoints
+ *                  read from the storage, they are cleared and discovered
+ *                  again.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_sep_cache_rej(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
+  log::warn("peer {} rejected stored stream endpoints, status:{}",
+            p_scb->PeerAddress(), p_data->str_msg.msg.hdr.err_code);
+
+  if (!btif_config_remove(p_scb->PeerAddress().ToString(),
+                          BTIF_STORAGE_KEY_AVDTP_SEP_CACHE)) {
+    log::warn("Failed to remove stream endpoints of {}", p_scb->PeerAddress());
+  }
+
+  p_scb->sep_cache_used = false;
+  p_scb->sep_cache_changed = true;
+  p_scb->peer_caps_mask = 0;
+  AVDT_DiscoverReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info,
+                   BTA_AV_NUM_SEPS, &bta_av_proc_stream_evt);
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_conn_failed
@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "bta_av"
 
 #include <bluetooth/log.h>
 
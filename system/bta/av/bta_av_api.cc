@@ -62,7 +62,7 @@ static const tBTA_SYS_REG bta_av_reg = {bta_av_hdl_event, BTA_AvDisable};
  ******************************************************************************/
 void BTA_AvEnable(tBTA_AV_FEAT features, tBTA_AV_CBACK* p_cback) {
   tBTA_AV_API_ENABLE* p_buf =
-      (tBTA_AV_API_ENABLE*)osi_malloc(sizeof(tBTA_AV_API_ENABLE));
+      (tBTA_AV_API_ENABLE*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_ENABLE));
 
   /* register with BTA system manager */
   bta_sys_register(BTA_ID_AV, &bta_av_reg);
@@ -84,7 +84,7 @@ void BTA_AvEnable(tBTA_AV_FEAT features, tBTA_AV_CBACK* p_cback) {
  *
  ******************************************************************************/
 void BTA_AvDisable(void) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   bta_sys_deregister(BTA_ID_AV);
   p_buf->event = BTA_AV_API_DISABLE_EVT;
@@ -109,7 +109,7 @@ void BTA_AvRegister(tBTA_AV_CHNL chnl, const char* p_service_name,
                     uint8_t app_id, tBTA_AV_SINK_DATA_CBACK* p_sink_data_cback,
                     uint16_t service_uuid) {
   tBTA_AV_API_REG* p_buf =
-      (tBTA_AV_API_REG*)osi_malloc(sizeof(tBTA_AV_API_REG));
+      (tBTA_AV_API_REG*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_REG));
 
   p_buf->hdr.layer_specific = chnl;
   p_buf->hdr.event = BTA_AV_API_REGISTER_EVT;
@@ -134,7 +134,7 @@ void BTA_AvRegister(tBTA_AV_CHNL chnl, const char* p_service_name,
  *
  ******************************************************************************/
 void BTA_AvDeregister(tBTA_AV_HNDL hndl) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->layer_specific = hndl;
   p_buf->event = BTA_AV_API_DEREGISTER_EVT;
@@ -159,7 +159,7 @@ void BTA_AvOpen(const RawAddress& bd_addr, tBTA_AV_HNDL handle, bool use_rc,
             use_rc, uuid);
 
   tBTA_AV_API_OPEN* p_buf =
-      (tBTA_AV_API_OPEN*)osi_malloc(sizeof(tBTA_AV_API_OPEN));
+      (tBTA_AV_API_OPEN*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_OPEN));
 
   p_buf->hdr.event = BTA_AV_API_OPEN_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -194,7 +194,7 @@ void BTA_AvOpen(const RawAddress& bd_addr, tBTA_AV_HNDL handle, bool use_rc,
 void BTA_AvClose(tBTA_AV_HNDL handle) {
   log::info("bta_handle:0x{:x}", handle);
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_AV_API_CLOSE_EVT;
   p_buf->layer_specific = handle;
@@ -215,7 +215,7 @@ void BTA_AvDisconnect(tBTA_AV_HNDL handle) {
   log::info("bta_handle=0x{:x}", handle);
 
   tBTA_AV_API_DISCNT* p_buf =
-      (tBTA_AV_API_DISCNT*)osi_malloc(sizeof(tBTA_AV_API_DISCNT));
+      (tBTA_AV_API_DISCNT*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_DISCNT));
 
   p_buf->hdr.event = BTA_AV_API_DISCONNECT_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -239,7 +239,7 @@ void BTA_AvStart(tBTA_AV_HNDL handle, bool use_latency_mode) {
       handle, use_latency_mode);
 
   tBTA_AV_DO_START* p_buf =
-      (tBTA_AV_DO_START*)osi_malloc(sizeof(tBTA_AV_DO_START));
+      (tBTA_AV_DO_START*)bta_sys_msg_alloc(sizeof(tBTA_AV_DO_START));
   p_buf->hdr.event = BTA_AV_API_START_EVT;
   p_buf->hdr.layer_specific = handle;
   p_buf->use_latency_mode = use_latency_mode;
@@ -259,7 +259,7 @@ void BTA_AvStart(tBTA_AV_HNDL handle, bool use_latency_mode) {
 void BTA_AvOffloadStart(tBTA_AV_HNDL hndl) {
   log::info("bta_handle=0x{:x}", hndl);
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_AV_API_OFFLOAD_START_EVT;
   p_buf->layer_specific = hndl;
@@ -282,7 +282,7 @@ void BTA_AvStop(tBTA_AV_HNDL handle, bool suspend) {
   log::info("bta_handle=0x{:x} suspend={}", handle, suspend);
 
   tBTA_AV_API_STOP* p_buf =
-      (tBTA_AV_API_STOP*)osi_malloc(sizeof(tBTA_AV_API_STOP));
+      (tBTA_AV_API_STOP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_STOP));
 
   p_buf->hdr.event = BTA_AV_API_STOP_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -312,8 +312,8 @@ void BTA_AvReconfig(tBTA_AV_HNDL hndl, bool suspend, uint8_t sep_info_idx,
   log::info("bta_handle=0x{:x} suspend={} sep_info_idx={}", hndl, suspend,
             sep_info_idx);
 
-  tBTA_AV_API_RCFG* p_buf =
-      (tBTA_AV_API_RCFG*)osi_malloc(sizeof(tBTA_AV_API_RCFG) + num_protect);
+  tBTA_AV_API_RCFG* p_buf = (tBTA_AV_API_RCFG*)bta_sys_msg_alloc(
+      sizeof(tBTA_AV_API_RCFG) + num_protect);
 
   p_buf->hdr.layer_specific = hndl;
   p_buf->hdr.event = BTA_AV_API_RECONFIG_EVT;
@@ -338,7 +338,7 @@ void BTA_AvReconfig(tBTA_AV_HNDL hndl, bool suspend, uint8_t sep_info_idx,
  *
  ******************************************************************************/
 void BTA_AvProtectReq(tBTA_AV_HNDL hndl, uint8_t* p_data, uint16_t len) {
-  tBTA_AV_API_PROTECT_REQ* p_buf = (tBTA_AV_API_PROTECT_REQ*)osi_malloc(
+  tBTA_AV_API_PROTECT_REQ* p_buf = (tBTA_AV_API_PROTECT_REQ*)bta_sys_msg_alloc(
       sizeof(tBTA_AV_API_PROTECT_REQ) + len);
 
   p_buf->hdr.layer_specific = hndl;
@@ -368,7 +368,7 @@ void BTA_AvProtectReq(tBTA_AV_HNDL hndl, uint8_t* p_data, uint16_t len) {
  ******************************************************************************/
 void BTA_AvProtectRsp(tBTA_AV_HNDL hndl, uint8_t error_code, uint8_t* p_data,
                       uint16_t len) {
-  tBTA_AV_API_PROTECT_RSP* p_buf = (tBTA_AV_API_PROTECT_RSP*)osi_malloc(
+  tBTA_AV_API_PROTECT_RSP* p_buf = (tBTA_AV_API_PROTECT_RSP*)bta_sys_msg_alloc(
       sizeof(tBTA_AV_API_PROTECT_RSP) + len);
 
   p_buf->hdr.layer_specific = hndl;
@@ -397,8 +397,8 @@ void BTA_AvProtectRsp(tBTA_AV_HNDL hndl, uint8_t error_code, uint8_t* p_data,
  ******************************************************************************/
 void BTA_AvRemoteCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_RC rc_id,
                      tBTA_AV_STATE key_state) {
-  tBTA_AV_API_REMOTE_CMD* p_buf =
-      (tBTA_AV_API_REMOTE_CMD*)osi_malloc(sizeof(tBTA_AV_API_REMOTE_CMD));
+  tBTA_AV_API_REMOTE_CMD* p_buf = (tBTA_AV_API_REMOTE_CMD*)bta_sys_msg_alloc(
+      sizeof(tBTA_AV_API_REMOTE_CMD));
 
   p_buf->hdr.event = BTA_AV_API_REMOTE_CMD_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -425,7 +425,7 @@ void BTA_AvRemoteCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_RC rc_id,
 void BTA_AvRemoteVendorUniqueCmd(uint8_t rc_handle, uint8_t label,
                                  tBTA_AV_STATE key_state, uint8_t* p_msg,
                                  uint8_t buf_len) {
-  tBTA_AV_API_REMOTE_CMD* p_buf = (tBTA_AV_API_REMOTE_CMD*)osi_malloc(
+  tBTA_AV_API_REMOTE_CMD* p_buf = (tBTA_AV_API_REMOTE_CMD*)bta_sys_msg_alloc(
       sizeof(tBTA_AV_API_REMOTE_CMD) + buf_len);
 
   p_buf->label = label;
@@ -457,7 +457,7 @@ void BTA_AvRemoteVendorUniqueCmd(uint8_t rc_handle, uint8_t label,
 void BTA_AvVendorCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE cmd_code,
                      uint8_t* p_data, uint16_t len) {
   tBTA_AV_API_VENDOR* p_buf =
-      (tBTA_AV_API_VENDOR*)osi_malloc(sizeof(tBTA_AV_API_VENDOR) + len);
+      (tBTA_AV_API_VENDOR*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_VENDOR) + len);
 
   p_buf->hdr.event = BTA_AV_API_VENDOR_CMD_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -492,7 +492,7 @@ void BTA_AvVendorCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE cmd_code,
 void BTA_AvVendorRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
                      uint8_t* p_data, uint16_t len, uint32_t company_id) {
   tBTA_AV_API_VENDOR* p_buf =
-      (tBTA_AV_API_VENDOR*)osi_malloc(sizeof(tBTA_AV_API_VENDOR) + len);
+      (tBTA_AV_API_VENDOR*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_VENDOR) + len);
 
   p_buf->hdr.event = BTA_AV_API_VENDOR_RSP_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -527,7 +527,7 @@ void BTA_AvVendorRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
  ******************************************************************************/
 void BTA_AvOpenRc(tBTA_AV_HNDL handle) {
   tBTA_AV_API_OPEN_RC* p_buf =
-      (tBTA_AV_API_OPEN_RC*)osi_malloc(sizeof(tBTA_AV_API_OPEN_RC));
+      (tBTA_AV_API_OPEN_RC*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_OPEN_RC));
 
   p_buf->hdr.event = BTA_AV_API_RC_OPEN_EVT;
   p_buf->hdr.layer_specific = handle;
@@ -546,7 +546,7 @@ void BTA_AvOpenRc(tBTA_AV_HNDL handle) {
  ******************************************************************************/
 void BTA_AvCloseRc(uint8_t rc_handle) {
   tBTA_AV_API_CLOSE_RC* p_buf =
-      (tBTA_AV_API_CLOSE_RC*)osi_malloc(sizeof(tBTA_AV_API_CLOSE_RC));
+      (tBTA_AV_API_CLOSE_RC*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_CLOSE_RC));
 
   p_buf->hdr.event = BTA_AV_API_RC_CLOSE_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -570,7 +570,7 @@ void BTA_AvCloseRc(uint8_t rc_handle) {
 void BTA_AvMetaRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
                    BT_HDR* p_pkt) {
   tBTA_AV_API_META_RSP* p_buf =
-      (tBTA_AV_API_META_RSP*)osi_malloc(sizeof(tBTA_AV_API_META_RSP));
+      (tBTA_AV_API_META_RSP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_META_RSP));
 
   p_buf->hdr.event = BTA_AV_API_META_RSP_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -602,7 +602,7 @@ void BTA_AvMetaRsp(uint8_t rc_handle, uint8_t label, tBTA_AV_CODE rsp_code,
 void BTA_AvMetaCmd(uint8_t rc_handle, uint8_t label, tBTA_AV_CMD cmd_code,
                    BT_HDR* p_pkt) {
   tBTA_AV_API_META_RSP* p_buf =
-      (tBTA_AV_API_META_RSP*)osi_malloc(sizeof(tBTA_AV_API_META_RSP));
+      (tBTA_AV_API_META_RSP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_META_RSP));
 
   p_buf->hdr.event = BTA_AV_API_META_RSP_EVT;
   p_buf->hdr.layer_specific = rc_handle;
@@ -628,8 +628,8 @@ void BTA_AvSetLatency(tBTA_AV_HNDL handle, bool is_low_latency) {
       "Set audio/video stream low latency bta_handle:{}, is_low_latency:{}",
       handle, is_low_latency);
 
-  tBTA_AV_API_SET_LATENCY* p_buf =
-      (tBTA_AV_API_SET_LATENCY*)osi_malloc(sizeof(tBTA_AV_API_SET_LATENCY));
+  tBTA_AV_API_SET_LATENCY* p_buf = (tBTA_AV_API_SET_LATENCY*)bta_sys_msg_alloc(
+      sizeof(tBTA_AV_API_SET_LATENCY));
   p_buf->hdr.event = BTA_AV_API_SET_LATENCY_EVT;
   p_buf->hdr.layer_specific = handle;
   p_buf->is_low_latency = is_low_latency;
@@ -650,7 +650,7 @@ void BTA_AvSetLatency(tBTA_AV_HNDL handle, bool is_low_latency) {
  ******************************************************************************/
 void BTA_AvSetPeerSep(const RawAddress& bdaddr, uint8_t sep) {
   tBTA_AV_API_PEER_SEP* p_buf =
-      (tBTA_AV_API_PEER_SEP*)osi_malloc(sizeof(tBTA_AV_API_PEER_SEP));
+      (tBTA_AV_API_PEER_SEP*)bta_sys_msg_alloc(sizeof(tBTA_AV_API_PEER_SEP));
 
   p_buf->hdr.event = BTA_AV_API_PEER_SEP_EVT;
   p_buf->addr = bdaddr;
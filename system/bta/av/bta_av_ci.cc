@@ -46,7 +46,7 @@ using namespace bluetooth;
  *
  ******************************************************************************/
 void bta_av_ci_src_data_ready(tBTA_AV_CHNL chnl) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->layer_specific = chnl;
   p_buf->event = BTA_AV_CI_SRC_DATA_READY_EVT;
@@ -76,7 +76,7 @@ void bta_av_ci_setconfig(tBTA_AV_HNDL bta_av_handle, uint8_t err_code,
       bta_av_handle, err_code, category, num_seid, recfg_needed, avdt_handle);
 
   tBTA_AV_CI_SETCONFIG* p_buf =
-      (tBTA_AV_CI_SETCONFIG*)osi_malloc(sizeof(tBTA_AV_CI_SETCONFIG));
+      (tBTA_AV_CI_SETCONFIG*)bta_sys_msg_alloc(sizeof(tBTA_AV_CI_SETCONFIG));
 
   p_buf->hdr.layer_specific = bta_av_handle;
   p_buf->hdr.event = (err_code == A2DP_SUCCESS) ? BTA_AV_CI_SETCONFIG_OK_EVT
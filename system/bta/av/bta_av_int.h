@@ -566,6 +566,11 @@ struct tBTA_AV_SCB final {
   uint8_t q_tag; /* identify the associated q_info union member */
   bool no_rtp_header; /* true if add no RTP header */
   uint16_t uuid_int; /*intended UUID of Initiator to connect to */
+  AvdtpSepConfig
+      peer_caps[BTA_AV_NUM_SEPS]; /* capabilities of the sep_info entries */
+  uint32_t peer_caps_mask;  /* sep_info entries with saved peer_caps */
+  bool sep_cache_used;      /* true if stream discovery was read from storage */
+  bool sep_cache_changed;   /* true if the peer was asked for its SEPs */
 
   /**
    * Called to setup the state when connected to a peer.
@@ -810,6 +815,9 @@ void bta_av_open_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_setconfig_rej(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_discover_req(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
+void bta_av_sep_cache_rej(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
+bool bta_av_sep_cache_load(tBTA_AV_SCB* p_scb);
+void bta_av_sep_cache_store(tBTA_AV_SCB* p_scb);
 void bta_av_conn_failed(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_do_start(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
 void bta_av_str_stopped(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data);
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "bta_av"
 
 #include <bluetooth/log.h>
 
@@ -41,6 +42,7 @@
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "osi/include/properties.h"
+#include "stack/include/a2dp_codec_api.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_uuid16.h"
@@ -1159,7 +1161,7 @@ bool bta_av_link_role_ok(tBTA_AV_SCB* p_scb, uint8_t bits) {
  * Function         bta_av_dup_audio_buf
  *
  * Description      dup the audio data to the q_info.a2dp of other audio
- *                  channels
+ *                  channels streaming with the same codec configuration
  *
  * Returns          void
  *
@@ -1177,6 +1179,12 @@ void bta_av_dup_audio_buf(tBTA_AV_SCB* p_scb, BT_HDR* p_buf) {
       continue; /* Ignore if SCB is not used or started */
     if (!(bta_av_cb.conn_audio & BTA_AV_HNDL_TO_MSK(i)))
       continue; /* Audio is not connected */
+    if (!A2DP_CodecEquals(p_scb->cfg.codec_info, p_scbi->cfg.codec_info)) {
+      /* The encoded audio cannot be decoded by this peer */
+      log::verbose("peer {} codec differs from peer {}, not duplicated",
+                   p_scbi->PeerAddress(), p_scb->PeerAddress());
+      continue;
+    }
 
     /* Enqueue the data */
     BT_HDR* p_new = (BT_HDR*)osi_malloc(copy_size);
@@ -37,6 +37,7 @@
 #include "bta_sec_api.h"
 #include "btif/include/btif_storage.h"
 #include "common/init_flags.h"
+#include "common/lru.h"
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "csis_types.h"
 #include "gap_api.h"
@@ -168,6 +169,7 @@ class CsisClientImpl : public CsisClient {
         log::debug(": Create a new group {}", group_id);
         auto g = std::make_shared<CsisGroup>(group_id, uuid);
         csis_groups_.push_back(g);
+        rsi_cache_.Clear();
         csis_group = FindCsisGroup(group_id);
       } else {
         log::error(": Missing group - that shall not happen");
@@ -655,6 +657,7 @@ class CsisClientImpl : public CsisClient {
 
         csis_group->SetDesiredSize(size);
         csis_group->SetSirk(sirk);
+        rsi_cache_.Clear();
 
         // TODO: Save it for later, so we won't have to read it using GATT
         group_rank_map[gid] = rank;
@@ -715,6 +718,7 @@ class CsisClientImpl : public CsisClient {
 
     devices_.clear();
     csis_groups_.clear();
+    rsi_cache_.Clear();
 
     CsisObserverSetBackground(false);
     dev_groups_->CleanUp(device_group_callbacks);
@@ -851,6 +855,7 @@ class CsisClientImpl : public CsisClient {
     for (auto it = csis_groups_.begin(); it != csis_groups_.end(); it++) {
       if ((*it)->GetGroupId() == group_id) {
         csis_groups_.erase(it);
+        rsi_cache_.Clear();
         return;
       }
     }
@@ -1315,6 +1320,28 @@ class CsisClientImpl : public CsisClient {
     return std::move(devices);
   }
 
+  /* Set members advertise the same RSI until their RPA rotates, and scan
+   * results repeat it many times in the meantime. Each RSI is resolved against
+   * the SIRK of every group once, and the ids of the groups it resolves to are
+   * cached until a group or SIRK changes.
+   */
+  bool IsRsiMatchingGroup(const RawAddress& rsi, int group_id) {
+    std::vector<int>* group_ids = rsi_cache_.Find(rsi);
+    if (group_ids == nullptr) {
+      std::vector<int> resolved_group_ids;
+      for (const auto& group : csis_groups_) {
+        if (group->IsRsiMatching(rsi)) {
+          resolved_group_ids.push_back(group->GetGroupId());
+        }
+      }
+      rsi_cache_.Put(rsi, resolved_group_ids);
+      group_ids = rsi_cache_.Find(rsi);
+    }
+
+    return std::find(group_ids->begin(), group_ids->end(), group_id) !=
+           group_ids->end();
+  }
+
   int GetNumOfKnownExpectedDevicesWaitingForBonding(int group_id) {
     return std::count_if(
         devices_.begin(), devices_.end(), [group_id](const auto& device) {
@@ -1375,8 +1402,8 @@ class CsisClientImpl : public CsisClient {
     }
 
     auto discovered_group_rsi = std::find_if(
-        all_rsi.cbegin(), all_rsi.cend(), [&csis_group](const auto& rsi) {
-          return csis_group->IsRsiMatching(rsi);
+        all_rsi.cbegin(), all_rsi.cend(), [this, &csis_group](const auto& rsi) {
+          return IsRsiMatchingGroup(rsi, csis_group->GetGroupId());
         });
     if (discovered_group_rsi != all_rsi.cend()) {
       log::debug("Found set member {}", result->bd_addr);
@@ -1452,7 +1479,7 @@ class CsisClientImpl : public CsisClient {
          inq_ent != nullptr;
          inq_ent = get_btm_client_interface().db.BTM_InqDbNext(inq_ent)) {
       RawAddress rsi = inq_ent->results.ble_ad_rsi;
-      if (!csis_group->IsRsiMatching(rsi)) continue;
+      if (!IsRsiMatchingGroup(rsi, csis_group->GetGroupId())) continue;
 
       RawAddress address = inq_ent->results.remote_bd_addr;
       auto device = FindDeviceByAddress(address);
@@ -1513,7 +1540,7 @@ class CsisClientImpl : public CsisClient {
     /* Notify all the groups this device belongs to. */
     for (auto& group : csis_groups_) {
       for (auto& rsi : all_rsi) {
-        if (group->IsRsiMatching(rsi)) {
+        if (IsRsiMatchingGroup(rsi, group->GetGroupId())) {
           log::info("Device {} match to group id {}", result->bd_addr,
                     group->GetGroupId());
           if (group->GetDesiredSize() > 0 &&
@@ -1661,6 +1688,7 @@ class CsisClientImpl : public CsisClient {
     }
 
     csis_group->SetSirk(received_sirk);
+    rsi_cache_.Clear();
     device->is_gatt_service_valid = true;
     btif_storage_update_csis_info(device->addr);
 
@@ -2345,6 +2373,10 @@ class CsisClientImpl : public CsisClient {
   std::list<std::shared_ptr<CsisGroup>> csis_groups_;
   DeviceGroups* dev_groups_;
   int discovering_group_ = bluetooth::groups::kGroupUnknown;
+  /* Ids of the groups each recently seen RSI resolves to */
+  static constexpr size_t kRsiCacheCapacity = 128;
+  bluetooth::common::LegacyLruCache<RawAddress, std::vector<int>> rsi_cache_{
+      kRsiCacheCapacity, "CsisRsi"};
 
   base::WeakPtrFactory<CsisClientImpl> weak_factory_{this};
 };
@@ -811,6 +811,9 @@ static void bta_dm_acl_down(const RawAddress& bd_addr,
   }
 
   bta_dm_disc_acl_down(bd_addr, transport);
+  if (transport == BT_TRANSPORT_BR_EDR) {
+    bta_dm_pm_acl_down(bd_addr);
+  }
 
   if (bta_dm_cb.disabling) {
     if (!BTM_GetNumAclLinks()) {
@@ -609,6 +609,15 @@ tBTA_DM_SSR_SPEC bta_dm_ssr_spec[] = {
 
 tBTA_DM_SSR_SPEC* p_bta_dm_ssr_spec = &bta_dm_ssr_spec[0];
 
+/* Services that keep the sniff and SSR parameters of their power mode spec.
+ * The traffic based power mode policy does not adapt the parameters of a link
+ * while one of these services is connected on it. A2DP has its own streaming
+ * SSR entry and HID reads the per device SSR preference. */
+const tBTA_SYS_ID bta_dm_pm_policy_fixed_ids[] = {BTA_ID_AV, BTA_ID_HH,
+                                                  BTA_ID_HD};
+const size_t bta_dm_pm_policy_fixed_ids_count =
+    sizeof(bta_dm_pm_policy_fixed_ids) / sizeof(bta_dm_pm_policy_fixed_ids[0]);
+
 const tBTA_DM_PM_CFG* p_bta_dm_pm_cfg = &bta_dm_pm_cfg[0];
 const tBTM_PM_PWR_MD* p_bta_dm_pm_md = &bta_dm_pm_md[0];
 
@@ -42,6 +42,7 @@
 #include "main/shim/dumpsys.h"
 #include "os/logging/log_adapter.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/include/bt_name.h"
 #include "stack/include/bt_uuid16.h"
@@ -50,6 +51,7 @@
 #include "stack/include/gap_api.h"      // GAP_BleReadPeerPrefConnParams
 #include "stack/include/hidh_api.h"
 #include "stack/include/main_thread.h"
+#include "stack/include/sdp_api.h"
 #include "stack/include/sdp_status.h"
 #include "types/raw_address.h"
 
@@ -224,6 +226,9 @@ void bta_dm_disc_gattc_register() {
 
 static void bta_dm_discovery_set_state(tBTA_DM_SERVICE_DISCOVERY_STATE state) {
   bta_dm_discovery_cb.service_discovery_state = state;
+  if (state == BTA_DM_DISCOVER_IDLE) {
+    alarm_cancel(bta_dm_discovery_cb.discovery_timer);
+  }
 }
 static tBTA_DM_SERVICE_DISCOVERY_STATE bta_dm_discovery_get_state() {
   return bta_dm_discovery_cb.service_discovery_state;
@@ -269,18 +274,39 @@ void bta_dm_sdp_finished(RawAddress bda, tBTA_STATUS result,
                          }));
 }
 
+/* Returns true if |sdp_state| is the state of the SDP discovery in progress */
+static bool bta_dm_sdp_is_pending(const tBTA_DM_SDP_STATE* sdp_state) {
+  return (bta_dm_discovery_cb.transports & BT_TRANSPORT_BR_EDR) &&
+         sdp_state != nullptr &&
+         sdp_state == bta_dm_discovery_cb.sdp_state.get();
+}
+
+static void bta_dm_sdp_pending_result(tSDP_STATUS sdp_status,
+                                      tBTA_DM_SDP_STATE* sdp_state) {
+  /* The discovery may have timed out while the result was posted */
+  if (!bta_dm_sdp_is_pending(sdp_state)) {
+    log::warn("Ignoring the result of a finished SDP discovery");
+    return;
+  }
+  bta_dm_sdp_result(sdp_status, sdp_state);
+}
+
 /* Callback from sdp with discovery status */
-void bta_dm_sdp_callback(const RawAddress& /* bd_addr */,
-                         tSDP_STATUS sdp_status) {
+void bta_dm_sdp_callback(const RawAddress& bd_addr, tSDP_STATUS sdp_status) {
   log::info("{}", bta_dm_state_text(bta_dm_discovery_get_state()));
 
   if (bta_dm_discovery_get_state() == BTA_DM_DISCOVER_IDLE) {
     return;
   }
 
-  do_in_main_thread(FROM_HERE,
-                    base::BindOnce(&bta_dm_sdp_result, sdp_status,
-                                   bta_dm_discovery_cb.sdp_state.get()));
+  tBTA_DM_SDP_STATE* sdp_state = bta_dm_discovery_cb.sdp_state.get();
+  if (!bta_dm_sdp_is_pending(sdp_state) || sdp_state->bd_addr != bd_addr) {
+    log::warn("Ignoring the SDP result of {}, not discovering it", bd_addr);
+    return;
+  }
+
+  do_in_main_thread(FROM_HERE, base::BindOnce(&bta_dm_sdp_pending_result,
+                                              sdp_status, sdp_state));
 }
 
 /** Callback of peer's DIS reply. This is only called for floss */
@@ -516,6 +542,11 @@ void bta_dm_disc_override_gatt_performer_for_testing(
 #define BTA_DM_GATT_CLOSE_DELAY_TOUT 1000
 #endif
 
+/* Time after which the service discovery of a device is abandoned, 0 to wait
+ * for the discoveries to complete */
+constexpr char kPropertyDiscoveryTimeoutMs[] =
+    "bluetooth.bta.dm.service_discovery_timeout_ms";
+
 /*******************************************************************************
  *
  * Function         bta_dm_gattc_register
@@ -554,6 +585,10 @@ static void gatt_close_timer_cb(void*) {
   bta_dm_disc_sm_execute(BTA_DM_DISC_CLOSE_TOUT_EVT, nullptr);
 }
 
+static void discovery_timer_cb(void*) {
+  bta_dm_disc_sm_execute(BTA_DM_DISC_TIMEOUT_EVT, nullptr);
+}
+
 void bta_dm_gatt_finished(RawAddress bda, tBTA_STATUS result,
                           std::vector<bluetooth::Uuid> gatt_uuids) {
   bta_dm_disc_sm_execute(BTA_DM_DISCOVERY_RESULT_EVT,
@@ -654,6 +689,49 @@ static void bta_dm_close_gatt_conn() {
   bta_dm_discovery_cb.pending_close_bda = RawAddress::kEmpty;
   bta_dm_discovery_cb.conn_id = GATT_INVALID_CONN_ID;
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_disc_timeout
+ *
+ * Description      Abandons the service discovery of the current device when
+ *                  it did not complete in time, so that the queued discovery
+ *                  requests of the other devices are not held up by it.
+ *
+ * Parameters:
+ *
+ ******************************************************************************/
+static void bta_dm_disc_timeout() {
+  const RawAddress bd_addr = bta_dm_discovery_cb.peer_bdaddr;
+  const uint8_t transports = bta_dm_discovery_cb.transports;
+
+  log::warn("Service discovery of {} timed out after {}ms, transports:0x{:x}",
+            bd_addr, bta_dm_discovery_cb.discovery_timeout_ms, transports);
+  BTM_LogHistory(kBtmLogTag, bd_addr, "Discovery timed out");
+
+  if ((transports & BT_TRANSPORT_BR_EDR) && bta_dm_discovery_cb.sdp_state) {
+    if (!get_legacy_stack_sdp_api()->service.SDP_CancelServiceSearch(
+            (tSDP_DISCOVERY_DB*)bta_dm_discovery_cb.sdp_state->sdp_db_buffer)) {
+      log::warn("Unable to cancel the SDP search of {}", bd_addr);
+    }
+  }
+  if (transports & BT_TRANSPORT_LE) {
+    if (bta_dm_discovery_cb.conn_id != GATT_INVALID_CONN_ID) {
+      bta_dm_close_gatt_conn();
+    } else {
+      get_gatt_interface().BTA_GATTC_CancelOpen(bta_dm_discovery_cb.client_if,
+                                                bd_addr, true);
+    }
+  }
+
+  /* The late results of the cancelled searches are ignored */
+  if (transports & BT_TRANSPORT_BR_EDR) {
+    bta_dm_sdp_finished(bd_addr, BTA_FAILURE);
+  }
+  if (transports & BT_TRANSPORT_LE) {
+    bta_dm_gatt_finished(bd_addr, BTA_FAILURE);
+  }
+}
 /*******************************************************************************
  *
  * Function         btm_dm_start_gatt_discovery
@@ -716,6 +794,17 @@ static void bta_dm_proc_open_evt(tBTA_GATTC_OPEN* p_data) {
   log::debug("BTA_GATTC_OPEN_EVT conn_id = {} client_if={} status = {}",
              p_data->conn_id, p_data->client_if, p_data->status);
 
+  if (!(bta_dm_discovery_cb.transports & BT_TRANSPORT_LE) ||
+      p_data->remote_bda != bta_dm_discovery_cb.peer_bdaddr) {
+    /* The GATT discovery of this device timed out */
+    log::warn("Ignoring GATT connection to {}, not discovering it",
+              p_data->remote_bda);
+    if (p_data->status == GATT_SUCCESS) {
+      BTA_GATTC_Close(p_data->conn_id);
+    }
+    return;
+  }
+
   bta_dm_discovery_cb.conn_id = p_data->conn_id;
 
   if (p_data->status == GATT_SUCCESS) {
@@ -744,7 +833,8 @@ static void bta_dm_gattc_callback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
       break;
 
     case BTA_GATTC_SEARCH_CMPL_EVT:
-      if (bta_dm_discovery_get_state() == BTA_DM_DISCOVER_ACTIVE) {
+      if (bta_dm_discovery_get_state() == BTA_DM_DISCOVER_ACTIVE &&
+          p_data->search_cmpl.conn_id == bta_dm_discovery_cb.conn_id) {
         bta_dm_gatt_disc_complete(p_data->search_cmpl.conn_id,
                                   p_data->search_cmpl.status);
       }
@@ -846,6 +936,11 @@ static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event,
           log::assert_that(std::holds_alternative<tBTA_DM_API_DISCOVER>(*msg),
                            "bad message type: {}", msg->index());
 
+          if (bta_dm_discovery_cb.discovery_timer != nullptr) {
+            alarm_set_on_mloop(bta_dm_discovery_cb.discovery_timer,
+                               bta_dm_discovery_cb.discovery_timeout_ms,
+                               discovery_timer_cb, nullptr);
+          }
           bta_dm_discover_services(std::get<tBTA_DM_API_DISCOVER>(*msg));
           break;
         case BTA_DM_DISC_CLOSE_TOUT_EVT:
@@ -881,6 +976,9 @@ static void bta_dm_disc_sm_execute(tBTA_DM_DISC_EVT event,
         case BTA_DM_DISC_CLOSE_TOUT_EVT:
           bta_dm_close_gatt_conn();
           break;
+        case BTA_DM_DISC_TIMEOUT_EVT:
+          bta_dm_disc_timeout();
+          break;
         default:
           log::info("Received unexpected event {}[0x{:x}] in state {}",
                     bta_dm_event_text(event), event,
@@ -899,6 +997,7 @@ static void bta_dm_disc_init_discovery_cb(
 
 static void bta_dm_disc_reset() {
   alarm_free(bta_dm_discovery_cb.gatt_close_timer);
+  alarm_free(bta_dm_discovery_cb.discovery_timer);
   bta_dm_disc_init_discovery_cb(::bta_dm_discovery_cb);
 }
 
@@ -911,6 +1010,13 @@ void bta_dm_disc_start(bool delay_close_gatt) {
   bta_dm_disc_reset();
   bta_dm_discovery_cb.gatt_close_timer =
       delay_close_gatt ? alarm_new("bta_dm_search.gatt_close_timer") : nullptr;
+  const int32_t discovery_timeout_ms =
+      osi_property_get_int32(kPropertyDiscoveryTimeoutMs, 0);
+  if (discovery_timeout_ms > 0) {
+    bta_dm_discovery_cb.discovery_timeout_ms = discovery_timeout_ms;
+    bta_dm_discovery_cb.discovery_timer =
+        alarm_new("bta_dm_search.discovery_timer");
+  }
   bta_dm_discovery_cb.pending_discovery_queue = {};
 }
 
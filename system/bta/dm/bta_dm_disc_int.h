@@ -38,6 +38,7 @@ typedef enum : uint16_t {
   BTA_DM_SDP_RESULT_EVT,
   BTA_DM_DISCOVERY_RESULT_EVT,
   BTA_DM_DISC_CLOSE_TOUT_EVT,
+  BTA_DM_DISC_TIMEOUT_EVT,
 } tBTA_DM_DISC_EVT;
 
 inline std::string bta_dm_event_text(const tBTA_DM_DISC_EVT& event) {
@@ -46,6 +47,7 @@ inline std::string bta_dm_event_text(const tBTA_DM_DISC_EVT& event) {
     CASE_RETURN_TEXT(BTA_DM_SDP_RESULT_EVT);
     CASE_RETURN_TEXT(BTA_DM_DISCOVERY_RESULT_EVT);
     CASE_RETURN_TEXT(BTA_DM_DISC_CLOSE_TOUT_EVT);
+    CASE_RETURN_TEXT(BTA_DM_DISC_TIMEOUT_EVT);
   }
 }
 
@@ -113,6 +115,8 @@ typedef struct {
   uint16_t conn_id;
   alarm_t* gatt_close_timer;    /* GATT channel close delay timer */
   RawAddress pending_close_bda; /* pending GATT channel remote device address */
+  alarm_t* discovery_timer;     /* service discovery timeout timer */
+  uint64_t discovery_timeout_ms; /* 0 if the discoveries don't time out */
 } tBTA_DM_SERVICE_DISCOVERY_CB;
 
 extern const uint32_t bta_service_id_to_btm_srv_id_lkup_tbl[];
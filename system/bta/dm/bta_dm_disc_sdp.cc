@@ -21,6 +21,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -32,8 +33,12 @@
 #include "common/init_flags.h"
 #include "common/strings.h"
 #include "internal_include/bt_target.h"
+#include "osi/include/properties.h"
+#include "stack/btm/neighbor_inquiry.h"
 #include "stack/include/bt_uuid16.h"
+#include "stack/include/btm_client_interface.h"
 #include "stack/include/btm_log_history.h"
+#include "stack/include/btm_sec_api.h"
 #include "stack/include/hidh_api.h"
 #include "stack/include/main_thread.h"
 #include "stack/include/sdp_status.h"
@@ -84,6 +89,148 @@ const uint16_t bta_service_id_to_uuid_lkup_tbl[BTA_MAX_SERVICE_ID] = {
 
 namespace {
 constexpr char kBtmLogTag[] = "SDP";
+
+/* Reuse the services found by the last discovery of a bonded peer while its
+ * inquiry response and Device ID record are unchanged */
+constexpr char kPropertySdpCacheEnabled[] =
+    "bluetooth.core.classic.sdp_cache.enabled";
+constexpr size_t kSdpCacheMaxLength = 1024;
+}  // namespace
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_cache_fingerprint
+ *
+ * Description      Describes the services of a peer with the UUIDs of its
+ *                  latest inquiry response and its Device ID record.
+ *
+ * Returns          The fingerprint, or an empty string when the inquiry
+ *                  response did not carry the complete list of services.
+ *
+ ******************************************************************************/
+static std::string bta_dm_sdp_cache_fingerprint(const RawAddress& bd_addr) {
+  tBTM_INQ_INFO* p_inq_info =
+      get_btm_client_interface().db.BTM_InqDbRead(bd_addr);
+  if (p_inq_info == nullptr || !p_inq_info->results.eir_complete_list) {
+    return "";
+  }
+
+  std::string fingerprint;
+  for (uint32_t eir_uuid : p_inq_info->results.eir_uuid) {
+    fingerprint += base::StringPrintf("%08x", eir_uuid);
+  }
+
+  /* The Device ID record is updated by every SDP discovery of the peer */
+  const std::string bdstr = bd_addr.ToString();
+  for (const char* key : {BTIF_STORAGE_KEY_SDP_DI_VENDOR_ID_SRC,
+                          BTIF_STORAGE_KEY_SDP_DI_MANUFACTURER,
+                          BTIF_STORAGE_KEY_SDP_DI_MODEL,
+                          BTIF_STORAGE_KEY_SDP_DI_HW_VERSION}) {
+    int value = 0;
+    fingerprint += btif_config_get_int(bdstr, key, &value)
+                       ? base::StringPrintf(":%x", value)
+                       : std::string(":-");
+  }
+  return fingerprint;
+}
+
+static std::string bta_dm_sdp_cache_uuids_to_string(
+    const std::vector<Uuid>& uuids) {
+  std::string str;
+  for (const auto& uuid : uuids) {
+    if (!str.empty()) str += " ";
+    str += uuid.ToString();
+  }
+  return str;
+}
+
+static bool bta_dm_sdp_cache_uuids_from_string(const std::string& str,
+                                               std::vector<Uuid>* p_uuids) {
+  std::istringstream stream(str);
+  std::string token;
+  while (stream >> token) {
+    bool is_valid = false;
+    Uuid uuid = Uuid::FromString(token, &is_valid);
+    if (!is_valid) return false;
+    p_uuids->push_back(uuid);
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_cache_store
+ *
+ * Description      Stores the services found by a complete discovery, as
+ *                  "<fingerprint>;<uuids>;<gatt uuids>".
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_sdp_cache_store(const RawAddress& bd_addr,
+                                   const std::vector<Uuid>& uuids,
+                                   const std::vector<Uuid>& gatt_uuids) {
+  if (!osi_property_get_bool(kPropertySdpCacheEnabled, false) ||
+      !btm_sec_is_a_bonded_dev(bd_addr)) {
+    return;
+  }
+
+  std::string fingerprint = bta_dm_sdp_cache_fingerprint(bd_addr);
+  if (fingerprint.empty()) {
+    log::debug("No complete inquiry response to validate the cache of {}",
+               bd_addr);
+    return;
+  }
+
+  std::string value = fingerprint + ";" +
+                      bta_dm_sdp_cache_uuids_to_string(uuids) + ";" +
+                      bta_dm_sdp_cache_uuids_to_string(gatt_uuids);
+  if (value.size() >= kSdpCacheMaxLength) {
+    log::info("Too many services to cache for {}", bd_addr);
+    return;
+  }
+  if (!btif_config_set_str(bd_addr.ToString(), BTIF_STORAGE_KEY_SDP_CACHE,
+                           value)) {
+    log::warn("Unable to store the SDP cache of {}", bd_addr);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_sdp_cache_lookup
+ *
+ * Description      Reads the services of a bonded peer stored by its last
+ *                  complete discovery, if they are still valid.
+ *
+ * Returns          true if the cached services can be reported, else false
+ *
+ ******************************************************************************/
+static bool bta_dm_sdp_cache_lookup(const RawAddress& bd_addr,
+                                    std::vector<Uuid>* p_uuids,
+                                    std::vector<Uuid>* p_gatt_uuids) {
+  if (!osi_property_get_bool(kPropertySdpCacheEnabled, false) ||
+      !btm_sec_is_a_bonded_dev(bd_addr)) {
+    return false;
+  }
+
+  char value[kSdpCacheMaxLength];
+  int size = sizeof(value);
+  if (!btif_config_get_str(bd_addr.ToString(), BTIF_STORAGE_KEY_SDP_CACHE,
+                           value, &size)) {
+    return false;
+  }
+
+  std::vector<std::string> fields = bluetooth::common::StringSplit(value, ";");
+  std::string fingerprint = bta_dm_sdp_cache_fingerprint(bd_addr);
+  if (fields.size() != 3 || fingerprint.empty() || fields[0] != fingerprint) {
+    log::info("SDP cache of {} is not valid", bd_addr);
+    return false;
+  }
+
+  p_uuids->clear();
+  p_gatt_uuids->clear();
+  return bta_dm_sdp_cache_uuids_from_string(fields[1], p_uuids) &&
+         bta_dm_sdp_cache_uuids_from_string(fields[2], p_gatt_uuids);
 }
 
 static void store_avrcp_profile_feature(tSDP_DISC_REC* sdp_rec) {
@@ -293,6 +440,10 @@ void bta_dm_sdp_result(tSDP_STATUS sdp_result, tBTA_DM_SDP_STATE* sdp_state) {
                    sdp_state->peer_scn);
     }
 
+    if (sdp_result == SDP_SUCCESS && result == BTA_SUCCESS) {
+      bta_dm_sdp_cache_store(sdp_state->bd_addr, uuid_list, gatt_uuids);
+    }
+
     bta_dm_sdp_finished(sdp_state->bd_addr, result, uuid_list, gatt_uuids);
   } else {
     BTM_LogHistory(
@@ -315,6 +466,23 @@ void bta_dm_sdp_result(tSDP_STATUS sdp_result, tBTA_DM_SDP_STATE* sdp_state) {
  *
  ******************************************************************************/
 void bta_dm_sdp_find_services(tBTA_DM_SDP_STATE* sdp_state) {
+#if !TARGET_FLOSS
+  /* Floss reports the Device ID record of each discovery, which is not
+   * cached */
+  if (sdp_state->service_index == 0 &&
+      sdp_state->services_to_search == BTA_ALL_SERVICE_MASK) {
+    std::vector<Uuid> uuids;
+    std::vector<Uuid> gatt_uuids;
+    if (bta_dm_sdp_cache_lookup(sdp_state->bd_addr, &uuids, &gatt_uuids)) {
+      BTM_LogHistory(kBtmLogTag, sdp_state->bd_addr, "Discovery cached",
+                     base::StringPrintf("services:%zu", uuids.size()));
+      sdp_state->service_index = BTA_MAX_SERVICE_ID;
+      bta_dm_sdp_finished(sdp_state->bd_addr, BTA_SUCCESS, uuids, gatt_uuids);
+      return;
+    }
+  }
+#endif
+
   while (sdp_state->service_index < BTA_MAX_SERVICE_ID) {
     if (sdp_state->services_to_search &
         (tBTA_SERVICE_MASK)(BTA_SERVICE_ID_TO_SERVICE_MASK(
@@ -293,6 +293,8 @@ extern const tBTA_DM_PM_CFG* p_bta_dm_pm_cfg;
 tBTA_DM_PM_TYPE_QUALIFIER tBTA_DM_PM_SPEC* get_bta_dm_pm_spec();
 extern const tBTM_PM_PWR_MD* p_bta_dm_pm_md;
 extern tBTA_DM_SSR_SPEC* p_bta_dm_ssr_spec;
+extern const tBTA_SYS_ID bta_dm_pm_policy_fixed_ids[];
+extern const size_t bta_dm_pm_policy_fixed_ids_count;
 
 /* update dynamic BRCM Aware EIR data */
 extern const tBTA_DM_EIR_CONF bta_dm_eir_cfg;
@@ -322,6 +324,8 @@ void bta_dm_ble_get_energy_info(tBTA_BLE_ENERGY_INFO_CBACK*);
 
 void bta_dm_init_pm(void);
 void bta_dm_disable_pm(void);
+void bta_dm_pm_acl_down(const RawAddress& peer_addr);
+void DumpsysBtaDmPm(int fd);
 
 uint8_t bta_dm_get_av_count(void);
 tBTA_DM_PEER_DEVICE* bta_dm_find_peer_device(const RawAddress& peer_addr);
@@ -26,11 +26,15 @@
 #include <base/functional/bind.h>
 #include <bluetooth/log.h>
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "bta/dm/bta_dm_int.h"
+#include "bta/dm/bta_dm_pm_policy.h"
 #include "bta/include/bta_api.h"
 #include "bta/include/bta_dm_api.h"
 #include "bta/sys/bta_sys.h"
@@ -68,6 +72,10 @@ static void bta_dm_pm_stop_timer_by_index(tBTA_PM_TIMER* p_timer,
 static tBTM_PM_PWR_MD get_sniff_entry(uint8_t index);
 static void bta_dm_pm_timer(const RawAddress& bd_addr,
                             tBTA_DM_PM_ACTION pm_request);
+static uint8_t bta_dm_pm_policy_sniff_index(const RawAddress& peer_addr,
+                                            uint8_t index);
+static uint16_t bta_dm_pm_policy_max_latency(const RawAddress& peer_addr,
+                                             uint16_t max_lat);
 
 #include "../hh/bta_hh_int.h"
 /* BTA_DM_PM_SSR1 will be dedicated for HH SSR setting entry, no other profile
@@ -88,6 +96,12 @@ static const char kPropertySniffAttempts[] =
     "bluetooth.core.classic.sniff_attempts";
 static const char kPropertySniffTimeouts[] =
     "bluetooth.core.classic.sniff_timeouts";
+static const char kPropertySniffPolicyEnabled[] =
+    "bluetooth.core.classic.sniff_policy.enabled";
+
+/* Traffic based selection of the sniff parameters, null when disabled */
+static std::mutex pm_policy_mutex;
+static std::unique_ptr<bluetooth::bta::dm::PowerModePolicy> pm_policy;
 
 /*******************************************************************************
  *
@@ -119,6 +133,16 @@ void bta_dm_init_pm(void) {
     for (int j = 0; j < BTA_DM_PM_MODE_TIMER_MAX; j++)
       bta_dm_cb.pm_timer[i].srvc_id[j] = BTA_ID_MAX;
   }
+
+  if (osi_property_get_bool(kPropertySniffPolicyEnabled, true)) {
+    std::vector<uint16_t> sniff_intervals;
+    for (uint8_t i = 0; i < BTA_DM_PM_PARK_IDX; i++) {
+      sniff_intervals.push_back(get_sniff_entry(i).max);
+    }
+    std::lock_guard<std::mutex> lock(pm_policy_mutex);
+    pm_policy = std::make_unique<bluetooth::bta::dm::PowerModePolicy>(
+        std::move(sniff_intervals));
+  }
 }
 
 /*******************************************************************************
@@ -150,6 +174,26 @@ void bta_dm_disable_pm(void) {
       bta_dm_cb.pm_timer[i].pm_action[j] = BTA_DM_PM_NO_ACTION;
     }
   }
+
+  std::lock_guard<std::mutex> lock(pm_policy_mutex);
+  pm_policy.reset();
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_acl_down
+ *
+ * Description      Forgets the traffic pattern of a disconnected link
+ *
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_dm_pm_acl_down(const RawAddress& peer_addr) {
+  std::lock_guard<std::mutex> lock(pm_policy_mutex);
+  if (pm_policy) {
+    pm_policy->RemoveLink(peer_addr);
+  }
 }
 
 /*******************************************************************************
@@ -434,6 +478,19 @@ static void bta_dm_pm_cback(tBTA_SYS_CONN_STATUS status, const tBTA_SYS_ID id,
                bta_sys_conn_status_text(status), status, BtaIdSysText(id), id,
                app_id);
 
+  /* feed the traffic pattern of the link to the policy, for all services */
+  if (status == BTA_SYS_CONN_BUSY || status == BTA_SYS_CONN_IDLE) {
+    std::lock_guard<std::mutex> lock(pm_policy_mutex);
+    if (pm_policy) {
+      auto now = bluetooth::bta::dm::PowerModePolicy::Clock::now();
+      if (status == BTA_SYS_CONN_BUSY) {
+        pm_policy->OnLinkBusy(peer_addr, now);
+      } else {
+        pm_policy->OnLinkIdle(peer_addr, now);
+      }
+    }
+  }
+
   /* find if there is an power mode entry for the service */
   for (i = 1; i <= p_bta_dm_pm_cfg[0].app_id; i++) {
     if ((p_bta_dm_pm_cfg[i].id == id) &&
@@ -747,7 +804,9 @@ static void bta_dm_pm_set_mode(const RawAddress& peer_addr,
       log::verbose("Link policy allows sniff mode so setting mode peer:{}",
                    peer_addr);
       p_peer_device->pm_mode_attempted = BTA_DM_PM_SNIFF;
-      bta_dm_pm_sniff(p_peer_device, (uint8_t)(pm_action & 0x0F));
+      bta_dm_pm_sniff(p_peer_device,
+                      bta_dm_pm_policy_sniff_index(
+                          peer_addr, (uint8_t)(pm_action & 0x0F)));
     } else {
       log::debug("Link policy disallows sniff mode, ignore request peer:{}",
                  peer_addr);
@@ -963,7 +1022,8 @@ static void bta_dm_pm_ssr(const RawAddress& peer_addr, const int ssr) {
     }
   }
 
-  if (p_spec->max_lat) {
+  uint16_t max_lat = bta_dm_pm_policy_max_latency(peer_addr, p_spec->max_lat);
+  if (max_lat) {
     /* Avoid SSR reset on device which has SCO connected */
     int idx = bta_dm_get_sco_index();
     if (idx != -1) {
@@ -977,13 +1037,13 @@ static void bta_dm_pm_ssr(const RawAddress& peer_addr, const int ssr) {
         "Setting sniff subrating for device:{} spec_name:{} "
         "max_latency(s):{:.2f} min_local_timeout(s):{:.2f} "
         "min_remote_timeout(s):{:.2f}",
-        peer_addr, p_spec->name, ticks_to_seconds(p_spec->max_lat),
+        peer_addr, p_spec->name, ticks_to_seconds(max_lat),
         ticks_to_seconds(p_spec->min_loc_to),
         ticks_to_seconds(p_spec->min_rmt_to));
     /* set the SSR parameters. */
     if (get_btm_client_interface().link_policy.BTM_SetSsrParams(
-            peer_addr, p_spec->max_lat, p_spec->min_rmt_to,
-            p_spec->min_loc_to) != BTM_SUCCESS) {
+            peer_addr, max_lat, p_spec->min_rmt_to, p_spec->min_loc_to) !=
+        BTM_SUCCESS) {
       log::warn("Unable to set link into sniff mode peer:{}", peer_addr);
     }
   }
@@ -1115,6 +1175,17 @@ static void bta_dm_pm_btm_status(const RawAddress& bd_addr,
           bta_dm_pm_ssr(p_dev->peer_bdaddr, BTA_DM_PM_SSR0);
         }
         p_dev->prev_low = BTM_PM_STS_ACTIVE;
+        {
+          std::lock_guard<std::mutex> lock(pm_policy_mutex);
+          if (pm_policy) {
+            auto cost = pm_policy->OnActiveMode(
+                bd_addr, bluetooth::bta::dm::PowerModePolicy::Clock::now());
+            if (cost.count() != 0) {
+              log::debug("Peer:{} left sniff mode, latency cost:{}us", bd_addr,
+                         cost.count());
+            }
+          }
+        }
         /* link to active mode, need to restart the timer for next low power
          * mode if needed */
         bta_dm_pm_stop_timer(bd_addr);
@@ -1151,6 +1222,12 @@ static void bta_dm_pm_btm_status(const RawAddress& bd_addr,
          * in sniff mode from host side.
          */
         bta_dm_pm_stop_timer(bd_addr);
+        std::lock_guard<std::mutex> lock(pm_policy_mutex);
+        if (pm_policy) {
+          pm_policy->OnSniffMode(
+              bd_addr, interval,
+              bluetooth::bta::dm::PowerModePolicy::Clock::now());
+        }
       } else {
         bool is_sniff_command_sent = p_dev->is_sniff_command_sent();
         p_dev->reset_sniff_flags();
@@ -1221,6 +1298,121 @@ static int bta_dm_get_sco_index() {
   return -1;
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_policy_is_fixed
+ *
+ * Description      Checks if the power mode parameters of the link must be
+ *                  kept as specified by its connected services
+ *
+ * Returns          true if a service connected on the link keeps its
+ *                  parameters or SCO is open, false otherwise
+ *
+ ******************************************************************************/
+static bool bta_dm_pm_policy_is_fixed(const RawAddress& peer_addr) {
+  for (int i = 0; i < bta_dm_conn_srvcs.count; i++) {
+    const tBTA_DM_SRVCS& service = bta_dm_conn_srvcs.conn_srvc[i];
+    if (service.peer_bdaddr != peer_addr) {
+      continue;
+    }
+    if (service.state == BTA_SYS_SCO_OPEN) {
+      return true;
+    }
+    for (size_t j = 0; j < bta_dm_pm_policy_fixed_ids_count; j++) {
+      if (service.id == bta_dm_pm_policy_fixed_ids[j]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_policy_sniff_index
+ *
+ * Description      Adapts the sniff table entry selected by the services of
+ *                  the link to the traffic pattern of the link
+ *
+ * Returns          index of the sniff table entry to use
+ *
+ ******************************************************************************/
+static uint8_t bta_dm_pm_policy_sniff_index(const RawAddress& peer_addr,
+                                            uint8_t index) {
+  if (index >= BTA_DM_PM_PARK_IDX || bta_dm_pm_policy_is_fixed(peer_addr)) {
+    return index;
+  }
+  std::lock_guard<std::mutex> lock(pm_policy_mutex);
+  if (!pm_policy) {
+    return index;
+  }
+  auto predicted = pm_policy->PredictedSniffIndex(peer_addr);
+  if (!predicted.has_value() || *predicted == index) {
+    return index;
+  }
+  log::debug("Sniff entry for peer:{} adapted to the traffic {} ==> {}",
+             peer_addr, index, *predicted);
+  return *predicted;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_pm_policy_max_latency
+ *
+ * Description      Limits the sniff subrating max latency selected by the
+ *                  services of the link to what the link traffic tolerates
+ *
+ * Returns          max latency in slots, 0 for no subrating
+ *
+ ******************************************************************************/
+static uint16_t bta_dm_pm_policy_max_latency(const RawAddress& peer_addr,
+                                             uint16_t max_lat) {
+  if (max_lat == 0 || bta_dm_pm_policy_is_fixed(peer_addr)) {
+    return max_lat;
+  }
+  std::lock_guard<std::mutex> lock(pm_policy_mutex);
+  if (!pm_policy) {
+    return max_lat;
+  }
+  auto budget = pm_policy->LatencyBudget(peer_addr);
+  if (!budget.has_value() || *budget >= max_lat) {
+    return max_lat;
+  }
+  log::debug("Sniff subrating max latency for peer:{} limited {} ==> {}",
+             peer_addr, max_lat, *budget);
+  return *budget;
+}
+
+#define DUMPSYS_TAG "shim::legacy::bta::dm"
+void DumpsysBtaDmPm(int fd) {
+  std::lock_guard<std::mutex> lock(pm_policy_mutex);
+  if (!pm_policy) {
+    LOG_DUMPSYS(fd, " sniff policy disabled");
+    return;
+  }
+  auto link_stats = pm_policy->GetLinkStats();
+  LOG_DUMPSYS(fd, " sniff policy links:%zu", link_stats.size());
+  for (const auto& [peer_addr, stats] : link_stats) {
+    LOG_DUMPSYS(
+        fd,
+        "   peer:%s gaps:%zu average_gap_ms:%lld sniff_entry:%s "
+        "sniff_entries:%zu sniff_exits:%zu time_in_sniff_ms:%lld "
+        "exit_latency_cost_ms:%lld",
+        ADDRESS_TO_LOGGABLE_CSTR(peer_addr), stats.gap_samples,
+        static_cast<long long>(stats.average_gap.count()),
+        stats.sniff_index.has_value()
+            ? std::to_string(*stats.sniff_index).c_str()
+            : "none",
+        stats.sniff_entries, stats.sniff_exits,
+        static_cast<long long>(stats.time_in_sniff.count()),
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                stats.exit_latency_cost)
+                .count()));
+  }
+}
+#undef DUMPSYS_TAG
+
 /*******************************************************************************
  *
  * Function         bta_dm_pm_obtain_controller_state
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/dm/bta_dm_pm_policy.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace bluetooth::bta::dm {
+
+namespace {
+
+constexpr std::chrono::microseconds kSlot{625};
+
+}  // namespace
+
+PowerModePolicy::PowerModePolicy(std::vector<uint16_t> sniff_intervals)
+    : sniff_intervals_(std::move(sniff_intervals)) {}
+
+void PowerModePolicy::OnLinkBusy(const RawAddress& peer_addr,
+                                 Clock::time_point now) {
+  Link& link = links_[peer_addr];
+  if (!link.busy && link.idle_since != Clock::time_point{}) {
+    auto gap = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - link.idle_since);
+    AddGap(link, std::min(gap, kMaxGap));
+  }
+  link.busy = true;
+}
+
+void PowerModePolicy::OnLinkIdle(const RawAddress& peer_addr,
+                                 Clock::time_point now) {
+  Link& link = links_[peer_addr];
+  // The gap starts at the end of the burst, or at the first report of the
+  // link when no burst was seen yet
+  if (link.busy || link.idle_since == Clock::time_point{}) {
+    link.idle_since = now;
+  }
+  link.busy = false;
+}
+
+void PowerModePolicy::OnSniffMode(const RawAddress& peer_addr,
+                                  uint16_t interval, Clock::time_point now) {
+  Link& link = links_[peer_addr];
+  // Sniff mode is reported again when its interval changes, only count the
+  // entries
+  if (link.sniff_interval == 0) {
+    link.stats.sniff_entries++;
+    link.sniff_since = now;
+  }
+  link.sniff_interval = std::max<uint16_t>(interval, 1);
+}
+
+std::chrono::microseconds PowerModePolicy::OnActiveMode(
+    const RawAddress& peer_addr, Clock::time_point now) {
+  auto it = links_.find(peer_addr);
+  if (it == links_.end() || it->second.sniff_interval == 0) {
+    return std::chrono::microseconds(0);
+  }
+  Link& link = it->second;
+  auto cost = kSlot * link.sniff_interval / 2;
+  link.stats.sniff_exits++;
+  link.stats.time_in_sniff +=
+      std::chrono::duration_cast<std::chrono::milliseconds>(now -
+                                                            link.sniff_since);
+  link.stats.exit_latency_cost += cost;
+  link.sniff_interval = 0;
+  return cost;
+}
+
+void PowerModePolicy::RemoveLink(const RawAddress& peer_addr) {
+  links_.erase(peer_addr);
+}
+
+std::optional<uint8_t> PowerModePolicy::PredictedSniffIndex(
+    const RawAddress& peer_addr) const {
+  const Link* link = FindPredictedLink(peer_addr);
+  if (link == nullptr) {
+    return std::nullopt;
+  }
+  return link->stats.sniff_index;
+}
+
+std::optional<uint16_t> PowerModePolicy::LatencyBudget(
+    const RawAddress& peer_addr) const {
+  const Link* link = FindPredictedLink(peer_addr);
+  if (link == nullptr) {
+    return std::nullopt;
+  }
+  auto budget = link->stats.average_gap / kGapToIntervalRatio / kSlot;
+  return static_cast<uint16_t>(std::clamp<int64_t>(
+      budget, 1, std::numeric_limits<uint16_t>::max() - 1));
+}
+
+std::vector<std::pair<RawAddress, PowerModePolicy::LinkStats>>
+PowerModePolicy::GetLinkStats() const {
+  std::vector<std::pair<RawAddress, LinkStats>> stats;
+  stats.reserve(links_.size());
+  for (const auto& [peer_addr, link] : links_) {
+    stats.emplace_back(peer_addr, link.stats);
+  }
+  return stats;
+}
+
+void PowerModePolicy::AddGap(Link& link, std::chrono::milliseconds gap) {
+  LinkStats& stats = link.stats;
+  // Exponential moving average with a weight of 1/4 for the new gap
+  stats.average_gap =
+      stats.gap_samples == 0 ? gap : (3 * stats.average_gap + gap) / 4;
+  stats.gap_samples++;
+  if (stats.gap_samples < kMinGapSamples || sniff_intervals_.empty()) {
+    return;
+  }
+
+  uint8_t index = SelectSniffIndex(stats.average_gap);
+  if (!stats.sniff_index.has_value() || index == stats.sniff_index) {
+    stats.sniff_index = index;
+    link.candidate_count = 0;
+    return;
+  }
+  // An outlier keeps the average away from the current entry for a few gaps,
+  // only follow the average once the last gaps agree with it
+  if (SelectSniffIndex(gap) != index) {
+    link.candidate_count = 0;
+    return;
+  }
+  if (link.candidate_index != index) {
+    link.candidate_index = index;
+    link.candidate_count = 0;
+  }
+  if (++link.candidate_count >= kConfirmations) {
+    stats.sniff_index = index;
+    link.candidate_count = 0;
+  }
+}
+
+uint8_t PowerModePolicy::SelectSniffIndex(std::chrono::milliseconds gap) const {
+  auto budget = gap / kGapToIntervalRatio / kSlot;
+  for (size_t i = 0; i < sniff_intervals_.size(); i++) {
+    if (sniff_intervals_[i] <= budget) {
+      return static_cast<uint8_t>(i);
+    }
+  }
+  // Traffic too frequent for any entry, use the most reactive one
+  return static_cast<uint8_t>(sniff_intervals_.size() - 1);
+}
+
+const PowerModePolicy::Link* PowerModePolicy::FindPredictedLink(
+    const RawAddress& peer_addr) const {
+  auto it = links_.find(peer_addr);
+  if (it == links_.end() || !it->second.stats.sniff_index.has_value()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+}  // namespace bluetooth::bta::dm
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "types/raw_address.h"
+
+namespace bluetooth::bta::dm {
+
+// The power mode policy predicts the sniff parameters of a link from its
+// traffic pattern.
+//
+// The profiles report the traffic of their links as busy and idle
+// transitions. For each link the policy keeps a moving average of the idle
+// gaps, the time from the end of a traffic burst to the start of the next
+// one, and selects the sniff table entry with the longest interval that keeps
+// the wake-up latency small compared to the gap. A new selection only takes
+// effect once consecutive gaps taken alone select the same entry as the
+// average, so that a single outlier does not make the link flip between sniff
+// entries.
+//
+// The policy also accounts for the mode transitions of the links: leaving
+// sniff mode delays the traffic that woke the link by half a sniff interval
+// on average, which is reported as the latency cost of the transition.
+class PowerModePolicy {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct LinkStats {
+    size_t gap_samples{0};
+    std::chrono::milliseconds average_gap{0};
+    std::optional<uint8_t> sniff_index;
+    size_t sniff_entries{0};
+    size_t sniff_exits{0};
+    std::chrono::milliseconds time_in_sniff{0};
+    std::chrono::microseconds exit_latency_cost{0};
+  };
+
+  // |sniff_intervals| are the maximum intervals of the sniff table entries in
+  // slots, ordered from the highest latency entry to the lowest latency one.
+  explicit PowerModePolicy(std::vector<uint16_t> sniff_intervals);
+
+  PowerModePolicy(const PowerModePolicy&) = delete;
+
+  PowerModePolicy& operator=(const PowerModePolicy&) = delete;
+
+  void OnLinkBusy(const RawAddress& peer_addr, Clock::time_point now);
+
+  void OnLinkIdle(const RawAddress& peer_addr, Clock::time_point now);
+
+  // The link entered sniff mode with an interval of |interval| slots.
+  void OnSniffMode(const RawAddress& peer_addr, uint16_t interval,
+                   Clock::time_point now);
+
+  // The link went back to active mode. Returns the latency cost of the
+  // transition, zero when the link was not in sniff mode.
+  std::chrono::microseconds OnActiveMode(const RawAddress& peer_addr,
+                                         Clock::time_point now);
+
+  void RemoveLink(const RawAddress& peer_addr);
+
+  // Index in the sniff table of the entry predicted for the link, nullopt
+  // until enough gaps have been observed.
+  std::optional<uint8_t> PredictedSniffIndex(const RawAddress& peer_addr) const;
+
+  // Largest wake-up latency in slots that the traffic of the link tolerates,
+  // nullopt until enough gaps have been observed.
+  std::optional<uint16_t> LatencyBudget(const RawAddress& peer_addr) const;
+
+  std::vector<std::pair<RawAddress, LinkStats>> GetLinkStats() const;
+
+  // Number of gaps averaged before the first prediction of a link.
+  static constexpr size_t kMinGapSamples = 3;
+  // Number of consecutive gaps that must agree with the average on a new
+  // sniff entry.
+  static constexpr size_t kConfirmations = 2;
+  // The sniff interval is kept below this fraction of the average gap.
+  static constexpr int kGapToIntervalRatio = 4;
+  // Gaps are clamped so that a long silence does not pin the average.
+  static constexpr std::chrono::milliseconds kMaxGap{10000};
+
+ private:
+  struct Link {
+    LinkStats stats;
+    bool busy{false};
+    Clock::time_point idle_since{};
+    std::optional<uint8_t> candidate_index;
+    size_t candidate_count{0};
+    uint16_t sniff_interval{0};
+    Clock::time_point sniff_since{};
+  };
+
+  void AddGap(Link& link, std::chrono::milliseconds gap);
+  uint8_t SelectSniffIndex(std::chrono::milliseconds gap) const;
+  const Link* FindPredictedLink(const RawAddress& peer_addr) const;
+
+  std::vector<uint16_t> sniff_intervals_;
+  std::map<RawAddress, Link> links_;
+};
+
+}  // namespace bluetooth::bta::dm
@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bt_bta_gattc"
+#define OSI_ALLOC_TAG "bta_gatt"
 
 #include <base/functional/bind.h>
 #include <base/strings/stringprintf.h>
@@ -1487,10 +1488,10 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
 
   const gatt::Characteristic* p_char =
       bta_gattc_get_characteristic_srcb(p_srcb, p_notify->handle);
-  if (!p_char) return false;
+  if (!p_char || p_char->uuid != srvc_chg_uuid) return false;
   const gatt::Service* p_svc =
       bta_gattc_get_service_for_handle_srcb(p_srcb, p_char->value_handle);
-  if (!p_svc || p_svc->uuid != gattp_uuid || p_char->uuid != srvc_chg_uuid) {
+  if (!p_svc || p_svc->uuid != gattp_uuid) {
     return false;
   }
 
@@ -1557,17 +1558,19 @@ static void bta_gattc_proc_other_indication(tBTA_GATTC_CLCB* p_clcb, uint8_t op,
                                             tBTA_GATTC_NOTIFY* p_notify) {
   log::verbose("check p_data->att_value.handle={} p_data->handle={}",
                p_data->att_value.handle, p_data->handle);
-  log::verbose("is_notify {}", p_notify->is_notify);
-
-  p_notify->is_notify = (op == GATTC_OPTYPE_INDICATION) ? false : true;
-  p_notify->len = p_data->att_value.len;
-  p_notify->bda = p_clcb->bda;
-  memcpy(p_notify->value, p_data->att_value.value, p_data->att_value.len);
-  p_notify->conn_id = p_clcb->bta_conn_id;
+  log::verbose("is_notify {}", op == GATTC_OPTYPE_NOTIFICATION);
 
   if (p_clcb->p_rcb->p_cback) {
+    /* the value is copied straight into the event, only its length */
     tBTA_GATTC bta_gattc;
-    bta_gattc.notify = *p_notify;
+    tBTA_GATTC_NOTIFY& notify = bta_gattc.notify;
+    notify.conn_id = p_clcb->bta_conn_id;
+    notify.bda = p_clcb->bda;
+    notify.handle = p_notify->handle;
+    notify.len = p_data->att_value.len;
+    memcpy(notify.value, p_data->att_value.value, p_data->att_value.len);
+    notify.is_notify = (op == GATTC_OPTYPE_INDICATION) ? false : true;
+    notify.cid = p_notify->cid;
     (*p_clcb->p_rcb->p_cback)(BTA_GATTC_NOTIF_EVT, &bta_gattc);
   }
 }
@@ -192,8 +192,9 @@ void BTA_GATTC_Open(tGATT_IF client_if, const RawAddress& remote_bda,
  ******************************************************************************/
 void BTA_GATTC_CancelOpen(tGATT_IF client_if, const RawAddress& remote_bda,
                           bool is_direct) {
-  tBTA_GATTC_API_CANCEL_OPEN* p_buf = (tBTA_GATTC_API_CANCEL_OPEN*)osi_malloc(
-      sizeof(tBTA_GATTC_API_CANCEL_OPEN));
+  tBTA_GATTC_API_CANCEL_OPEN* p_buf =
+      (tBTA_GATTC_API_CANCEL_OPEN*)bta_sys_msg_alloc(
+          sizeof(tBTA_GATTC_API_CANCEL_OPEN));
 
   p_buf->hdr.event = BTA_GATTC_API_CANCEL_OPEN_EVT;
   p_buf->client_if = client_if;
@@ -215,7 +216,7 @@ void BTA_GATTC_CancelOpen(tGATT_IF client_if, const RawAddress& remote_bda,
  *
  ******************************************************************************/
 void BTA_GATTC_Close(uint16_t conn_id) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_GATTC_API_CLOSE_EVT;
   p_buf->layer_specific = conn_id;
@@ -243,8 +244,8 @@ void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu) {
 
 void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu,
                             GATT_CONFIGURE_MTU_OP_CB callback, void* cb_data) {
-  tBTA_GATTC_API_CFG_MTU* p_buf =
-      (tBTA_GATTC_API_CFG_MTU*)osi_malloc(sizeof(tBTA_GATTC_API_CFG_MTU));
+  tBTA_GATTC_API_CFG_MTU* p_buf = (tBTA_GATTC_API_CFG_MTU*)bta_sys_msg_alloc(
+      sizeof(tBTA_GATTC_API_CFG_MTU));
 
   p_buf->hdr.event = BTA_GATTC_API_CFG_MTU_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -255,9 +256,31 @@ void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu,
   bta_sys_sendmsg(p_buf);
 }
 
+static void set_throughput_profile_impl(uint16_t conn_id,
+                                       tGATT_THROUGHPUT_PROFILE profile) {
+  tGATT_STATUS status = GATT_SetThroughputProfile(conn_id, profile);
+  if (status != GATT_SUCCESS) {
+    log::warn("Unable to set throughput profile conn_id:{} status:{}", conn_id,
+              gatt_status_text(status));
+    return;
+  }
+
+  /* The data length and PHY procedures are already running in the
+   * controller, the MTU exchange is queued with the other client requests */
+  if (profile == GATT_THROUGHPUT_BULK) {
+    BTA_GATTC_ConfigureMTU(conn_id, GATT_MAX_MTU_SIZE);
+  }
+}
+
+void BTA_GATTC_SetThroughputProfile(uint16_t conn_id,
+                                    tGATT_THROUGHPUT_PROFILE profile) {
+  do_in_main_thread(FROM_HERE, base::BindOnce(&set_throughput_profile_impl,
+                                              conn_id, profile));
+}
+
 void BTA_GATTC_ServiceSearchAllRequest(uint16_t conn_id) {
   const size_t len = sizeof(tBTA_GATTC_API_SEARCH);
-  tBTA_GATTC_API_SEARCH* p_buf = (tBTA_GATTC_API_SEARCH*)osi_calloc(len);
+  tBTA_GATTC_API_SEARCH* p_buf = (tBTA_GATTC_API_SEARCH*)bta_sys_msg_alloc(len);
 
   p_buf->hdr.event = BTA_GATTC_API_SEARCH_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -268,7 +291,7 @@ void BTA_GATTC_ServiceSearchAllRequest(uint16_t conn_id) {
 
 void BTA_GATTC_ServiceSearchRequest(uint16_t conn_id, Uuid p_srvc_uuid) {
   const size_t len = sizeof(tBTA_GATTC_API_SEARCH) + sizeof(Uuid);
-  tBTA_GATTC_API_SEARCH* p_buf = (tBTA_GATTC_API_SEARCH*)osi_calloc(len);
+  tBTA_GATTC_API_SEARCH* p_buf = (tBTA_GATTC_API_SEARCH*)bta_sys_msg_alloc(len);
 
   p_buf->hdr.event = BTA_GATTC_API_SEARCH_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -388,7 +411,7 @@ void BTA_GATTC_ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                   tGATT_AUTH_REQ auth_req,
                                   GATT_READ_OP_CB callback, void* cb_data) {
   tBTA_GATTC_API_READ* p_buf =
-      (tBTA_GATTC_API_READ*)osi_calloc(sizeof(tBTA_GATTC_API_READ));
+      (tBTA_GATTC_API_READ*)bta_sys_msg_alloc(sizeof(tBTA_GATTC_API_READ));
 
   p_buf->hdr.event = BTA_GATTC_API_READ_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -410,7 +433,7 @@ void BTA_GATTC_ReadUsingCharUuid(uint16_t conn_id, const Uuid& uuid,
                                  tGATT_AUTH_REQ auth_req,
                                  GATT_READ_OP_CB callback, void* cb_data) {
   tBTA_GATTC_API_READ* p_buf =
-      (tBTA_GATTC_API_READ*)osi_calloc(sizeof(tBTA_GATTC_API_READ));
+      (tBTA_GATTC_API_READ*)bta_sys_msg_alloc(sizeof(tBTA_GATTC_API_READ));
 
   p_buf->hdr.event = BTA_GATTC_API_READ_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -442,7 +465,7 @@ void BTA_GATTC_ReadCharDescr(uint16_t conn_id, uint16_t handle,
                              tGATT_AUTH_REQ auth_req, GATT_READ_OP_CB callback,
                              void* cb_data) {
   tBTA_GATTC_API_READ* p_buf =
-      (tBTA_GATTC_API_READ*)osi_calloc(sizeof(tBTA_GATTC_API_READ));
+      (tBTA_GATTC_API_READ*)bta_sys_msg_alloc(sizeof(tBTA_GATTC_API_READ));
 
   p_buf->hdr.event = BTA_GATTC_API_READ_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -475,7 +498,8 @@ void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI& handles,
                             bool variable_len, tGATT_AUTH_REQ auth_req,
                             GATT_READ_MULTI_OP_CB callback, void* cb_data) {
   tBTA_GATTC_API_READ_MULTI* p_buf =
-      (tBTA_GATTC_API_READ_MULTI*)osi_calloc(sizeof(tBTA_GATTC_API_READ_MULTI));
+      (tBTA_GATTC_API_READ_MULTI*)bta_sys_msg_alloc(
+          sizeof(tBTA_GATTC_API_READ_MULTI));
 
   p_buf->hdr.event = BTA_GATTC_API_READ_MULTI_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -507,7 +531,7 @@ void BTA_GATTC_WriteCharValue(uint16_t conn_id, uint16_t handle,
                               std::vector<uint8_t> value,
                               tGATT_AUTH_REQ auth_req,
                               GATT_WRITE_OP_CB callback, void* cb_data) {
-  tBTA_GATTC_API_WRITE* p_buf = (tBTA_GATTC_API_WRITE*)osi_calloc(
+  tBTA_GATTC_API_WRITE* p_buf = (tBTA_GATTC_API_WRITE*)bta_sys_msg_alloc(
       sizeof(tBTA_GATTC_API_WRITE) + value.size());
 
   p_buf->hdr.event = BTA_GATTC_API_WRITE_EVT;
@@ -544,7 +568,7 @@ void BTA_GATTC_WriteCharDescr(uint16_t conn_id, uint16_t handle,
                               std::vector<uint8_t> value,
                               tGATT_AUTH_REQ auth_req,
                               GATT_WRITE_OP_CB callback, void* cb_data) {
-  tBTA_GATTC_API_WRITE* p_buf = (tBTA_GATTC_API_WRITE*)osi_calloc(
+  tBTA_GATTC_API_WRITE* p_buf = (tBTA_GATTC_API_WRITE*)bta_sys_msg_alloc(
       sizeof(tBTA_GATTC_API_WRITE) + value.size());
 
   p_buf->hdr.event = BTA_GATTC_API_WRITE_EVT;
@@ -582,7 +606,7 @@ void BTA_GATTC_WriteCharDescr(uint16_t conn_id, uint16_t handle,
 void BTA_GATTC_PrepareWrite(uint16_t conn_id, uint16_t handle, uint16_t offset,
                             std::vector<uint8_t> value, tGATT_AUTH_REQ auth_req,
                             GATT_WRITE_OP_CB callback, void* cb_data) {
-  tBTA_GATTC_API_WRITE* p_buf = (tBTA_GATTC_API_WRITE*)osi_calloc(
+  tBTA_GATTC_API_WRITE* p_buf = (tBTA_GATTC_API_WRITE*)bta_sys_msg_alloc(
       sizeof(tBTA_GATTC_API_WRITE) + value.size());
 
   p_buf->hdr.event = BTA_GATTC_API_WRITE_EVT;
@@ -619,7 +643,7 @@ void BTA_GATTC_PrepareWrite(uint16_t conn_id, uint16_t handle, uint16_t offset,
  ******************************************************************************/
 void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute) {
   tBTA_GATTC_API_EXEC* p_buf =
-      (tBTA_GATTC_API_EXEC*)osi_calloc(sizeof(tBTA_GATTC_API_EXEC));
+      (tBTA_GATTC_API_EXEC*)bta_sys_msg_alloc(sizeof(tBTA_GATTC_API_EXEC));
 
   p_buf->hdr.event = BTA_GATTC_API_EXEC_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -641,8 +665,8 @@ void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute) {
  *
  ******************************************************************************/
 void BTA_GATTC_SendIndConfirm(uint16_t conn_id, uint16_t cid) {
-  tBTA_GATTC_API_CONFIRM* p_buf =
-      (tBTA_GATTC_API_CONFIRM*)osi_calloc(sizeof(tBTA_GATTC_API_CONFIRM));
+  tBTA_GATTC_API_CONFIRM* p_buf = (tBTA_GATTC_API_CONFIRM*)bta_sys_msg_alloc(
+      sizeof(tBTA_GATTC_API_CONFIRM));
 
   log::verbose("conn_id={} cid=0x{:x}", conn_id, cid);
 
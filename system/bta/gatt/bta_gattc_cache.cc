@@ -24,6 +24,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bt_bta_gattc"
+#define OSI_ALLOC_TAG "bta_gatt"
 
 #include <base/functional/bind.h>
 #include <base/strings/string_number_conversions.h>
@@ -32,6 +33,7 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <optional>
 #include <vector>
 
 #include "bta/gatt/bta_gattc_int.h"
@@ -309,14 +311,14 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
 
   // If robust caching is enabled, do something optimized
   Octet16 hash = p_clcb->p_srcb->gatt_database.Hash();
-  bool success = bta_gattc_hash_write(hash, p_clcb->p_srcb->gatt_database);
 
-  // If the device is trusted, link the addr file to hash file
-  if (success && btm_sec_is_a_bonded_dev(p_srvc_cb->server_bda)) {
-    log::debug("Linking db hash to address {}",
-               p_clcb->p_srcb->server_bda.ToRedactedStringForLogging());
-    bta_gattc_cache_link(p_clcb->p_srcb->server_bda, hash);
+  // If the device is trusted, link the addr file to hash file once written
+  std::optional<RawAddress> link_bda;
+  if (btm_sec_is_a_bonded_dev(p_srvc_cb->server_bda)) {
+    link_bda = p_clcb->p_srcb->server_bda;
   }
+  bta_gattc_hash_write_in_worker(hash, p_clcb->p_srcb->gatt_database,
+                                 link_bda);
 
   // After success, reset the count.
   log::debug("service discovery succeed, reset count to zero, conn_id=0x{:04x}",
@@ -331,8 +333,15 @@ void bta_gattc_start_disc_char_dscp(uint16_t conn_id,
                                     tBTA_GATTC_SERV* p_srvc_cb) {
   log::verbose("starting discover characteristics descriptor");
 
+  /* Discover the descriptors of consecutive characteristics together when
+   * their whole range fits in one Find Information Response with 16-bit UUIDs,
+   * which takes no more round trips than exploring the first one alone */
+  uint16_t mtu = p_srvc_cb->mtu ? p_srvc_cb->mtu : GATT_DEF_BLE_MTU_SIZE;
+  uint16_t max_range_handles = (mtu - 2) / 4;
+
   std::pair<uint16_t, uint16_t> range =
-      p_srvc_cb->pending_discovery.NextDescriptorRangeToExplore();
+      p_srvc_cb->pending_discovery.NextDescriptorRangeToExplore(
+          max_range_handles);
   if (range == DatabaseBuilder::EXPLORE_END) {
     goto descriptor_discovery_done;
   }
@@ -644,16 +653,9 @@ const Service* bta_gattc_get_service_for_handle(uint16_t conn_id,
 
 const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                         uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    if (handle == charac.value_handle) return &charac;
-  }
+  if (!p_srcb) return NULL;
 
-  return NULL;
+  return p_srcb->gatt_database.FindCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
@@ -668,20 +670,9 @@ const Characteristic* bta_gattc_get_characteristic(uint16_t conn_id,
 
 const Descriptor* bta_gattc_get_descriptor_srcb(tBTA_GATTC_SERV* p_srcb,
                                                 uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
+  if (!p_srcb) return NULL;
 
-  if (!service) {
-    return NULL;
-  }
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &desc;
-    }
-  }
-
-  return NULL;
+  return p_srcb->gatt_database.FindDescriptor(handle);
 }
 
 const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
@@ -695,18 +686,9 @@ const Descriptor* bta_gattc_get_descriptor(uint16_t conn_id, uint16_t handle) {
 
 const Characteristic* bta_gattc_get_owning_characteristic_srcb(
     tBTA_GATTC_SERV* p_srcb, uint16_t handle) {
-  const Service* service =
-      bta_gattc_get_service_for_handle_srcb(p_srcb, handle);
-
-  if (!service) return NULL;
-
-  for (const Characteristic& charac : service->characteristics) {
-    for (const Descriptor& desc : charac.descriptors) {
-      if (handle == desc.handle) return &charac;
-    }
-  }
+  if (!p_srcb) return NULL;
 
-  return NULL;
+  return p_srcb->gatt_database.FindOwningCharacteristic(handle);
 }
 
 const Characteristic* bta_gattc_get_owning_characteristic(uint16_t conn_id,
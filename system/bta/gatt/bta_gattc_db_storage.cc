@@ -23,6 +23,9 @@
 #include <dirent.h>
 #include <sys/stat.h>
 
+#include <list>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -30,6 +33,7 @@
 #include "gatt/database.h"
 #include "os/log.h"
 #include "stack/include/gattdefs.h"
+#include "stack/include/main_thread.h"
 #include "types/bluetooth/uuid.h"
 
 using namespace bluetooth;
@@ -59,8 +63,76 @@ using std::vector;
 // Default expired time is 7 days
 #define GATT_HASH_EXPIRED_TIME 604800
 
+// Number of loaded GATT databases kept in memory
+#define GATT_LOADED_DB_MAX_SIZE 8
+
 static void bta_gattc_hash_remove_least_recently_used_if_possible();
 
+namespace {
+
+/* GATT database read from a cache file, identified by the file inode. The
+ * address files are hard links to the hash files, so all the devices with the
+ * same database hash share the entry, and rewriting the file changes its
+ * modification time and invalidates the entry. */
+struct LoadedDb {
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  struct timespec mtime;
+  gatt::Database database;
+
+  bool Matches(const struct stat& buf) const {
+    return dev == buf.st_dev && ino == buf.st_ino && size == buf.st_size &&
+           mtime.tv_sec == buf.st_mtim.tv_sec &&
+           mtime.tv_nsec == buf.st_mtim.tv_nsec;
+  }
+};
+
+/* Most recently used first */
+std::list<LoadedDb> loaded_dbs;
+
+}  // namespace
+
+static const gatt::Database* bta_gattc_find_loaded_db(const struct stat& buf) {
+  for (auto it = loaded_dbs.begin(); it != loaded_dbs.end(); it++) {
+    if (it->Matches(buf)) {
+      loaded_dbs.splice(loaded_dbs.begin(), loaded_dbs, it);
+      return &loaded_dbs.front().database;
+    }
+  }
+  return nullptr;
+}
+
+static void bta_gattc_forget_loaded_db(const struct stat& buf) {
+  loaded_dbs.remove_if([&](const LoadedDb& db) {
+    return db.dev == buf.st_dev && db.ino == buf.st_ino;
+  });
+}
+
+static void bta_gattc_remember_loaded_db(const struct stat& buf,
+                                         const gatt::Database& database) {
+  bta_gattc_forget_loaded_db(buf);
+  loaded_dbs.push_front(LoadedDb{
+      .dev = buf.st_dev,
+      .ino = buf.st_ino,
+      .size = buf.st_size,
+      .mtime = buf.st_mtim,
+      .database = database,
+  });
+  if (loaded_dbs.size() > GATT_LOADED_DB_MAX_SIZE) {
+    loaded_dbs.pop_back();
+  }
+}
+
+/* Removes a cache file, and the database loaded from it */
+static void bta_gattc_unlink_db(const char* fname) {
+  struct stat buf;
+  if (stat(fname, &buf) == 0 && buf.st_nlink <= 1) {
+    bta_gattc_forget_loaded_db(buf);
+  }
+  unlink(fname);
+}
+
 static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
                                                const RawAddress& bda) {
   snprintf(buffer, buffer_len, "%s%02x%02x%02x%02x%02x%02x", GATT_CACHE_PREFIX,
@@ -96,6 +168,16 @@ static gatt::Database bta_gattc_load_db(const char* fname) {
     return EMPTY_DB;
   }
 
+  struct stat buf;
+  bool has_stat = fstat(fileno(fd), &buf) == 0;
+  if (has_stat) {
+    const gatt::Database* database = bta_gattc_find_loaded_db(buf);
+    if (database != nullptr) {
+      fclose(fd);
+      return *database;
+    }
+  }
+
   uint16_t cache_ver = 0;
   uint16_t num_attr = 0;
 
@@ -125,7 +207,9 @@ static gatt::Database bta_gattc_load_db(const char* fname) {
 
     bool success = false;
     gatt::Database result = gatt::Database::Deserialize(attr, &success);
-    return success ? result : EMPTY_DB;
+    if (!success) return EMPTY_DB;
+    if (has_stat) bta_gattc_remember_loaded_db(buf, result);
+    return result;
   }
 
 done:
@@ -345,7 +429,72 @@ bool bta_gattc_hash_write(const Octet16& hash, const gatt::Database& database) {
   char fname[255] = {0};
   bta_gattc_generate_hash_file_name(fname, sizeof(fname), hash);
   bta_gattc_hash_remove_least_recently_used_if_possible();
-  return bta_gattc_store_db(fname, database.Serialize());
+  if (!bta_gattc_store_db(fname, database.Serialize())) return false;
+
+  // The next connection to a device with this hash doesn't read the file
+  struct stat buf;
+  if (stat(fname, &buf) == 0) {
+    bta_gattc_remember_loaded_db(buf, database);
+  }
+  return true;
+}
+
+/* Serializes the writes of the worker pool, which may write the same hash */
+static std::mutex worker_write_mutex;
+
+static bool bta_gattc_store_db_in_worker(std::string fname,
+                                         std::vector<StoredAttribute> attr) {
+  std::lock_guard<std::mutex> lock(worker_write_mutex);
+  return bta_gattc_store_db(fname.c_str(), attr);
+}
+
+static void bta_gattc_hash_write_done(Octet16 hash, gatt::Database database,
+                                      std::optional<RawAddress> link_bda,
+                                      bool written) {
+  if (!written) return;
+
+  char fname[255] = {0};
+  bta_gattc_generate_hash_file_name(fname, sizeof(fname), hash);
+  struct stat buf;
+  if (stat(fname, &buf) == 0) {
+    bta_gattc_remember_loaded_db(buf, database);
+  }
+
+  if (link_bda.has_value()) {
+    log::debug("Linking db hash to address {}",
+               link_bda->ToRedactedStringForLogging());
+    bta_gattc_cache_link(*link_bda, hash);
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_hash_write_in_worker
+ *
+ * Description      Same as bta_gattc_hash_write, with the file written from
+ *                  the worker pool. Once it is written, the database is
+ *                  remembered and the file linked to link_bda, if set, on the
+ *                  main thread.
+ *
+ * Parameter        hash: 16-byte value
+ *                  database: gatt::Database instance.
+ *                  link_bda: bonded server to link to the hash file
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_gattc_hash_write_in_worker(const Octet16& hash,
+                                    const gatt::Database& database,
+                                    std::optional<RawAddress> link_bda) {
+  char fname[255] = {0};
+  bta_gattc_generate_hash_file_name(fname, sizeof(fname), hash);
+  bta_gattc_hash_remove_least_recently_used_if_possible();
+
+  do_in_worker_pool_and_reply(
+      FROM_HERE,
+      base::BindOnce(&bta_gattc_store_db_in_worker, std::string(fname),
+                     database.Serialize()),
+      base::BindOnce(&bta_gattc_hash_write_done, hash, database, link_bda));
 }
 
 /*******************************************************************************
@@ -444,13 +593,13 @@ static void bta_gattc_hash_remove_least_recently_used_if_possible() {
 
   // if the number of hash files exceeds the limit, remove the cadidate item.
   if (count > GATT_HASH_MAX_SIZE && !candidate_item.empty()) {
-    unlink(candidate_item.c_str());
+    bta_gattc_unlink_db(candidate_item.c_str());
     log::debug("delete hash file (size), name={}", candidate_item);
   }
 
   // If there is any file expired, also delete it.
   for (string expired_item : expired_items) {
-    unlink(expired_item.c_str());
+    bta_gattc_unlink_db(expired_item.c_str());
     log::debug("delete hash file (expired), name={}", expired_item);
   }
 }
@@ -28,6 +28,7 @@
 
 #include <cstdint>
 #include <deque>
+#include <optional>
 
 #include "bta/gatt/database.h"
 #include "bta/gatt/database_builder.h"
@@ -521,6 +522,9 @@ bool bta_gattc_read_db_hash(tBTA_GATTC_CLCB* p_clcb, bool is_svc_chg);
 /* bta_gattc_db_storage */
 gatt::Database bta_gattc_hash_load(const Octet16& hash);
 bool bta_gattc_hash_write(const Octet16& hash, const gatt::Database& database);
+void bta_gattc_hash_write_in_worker(const Octet16& hash,
+                                    const gatt::Database& database,
+                                    std::optional<RawAddress> link_bda);
 gatt::Database bta_gattc_cache_load(const RawAddress& server_bda);
 void bta_gattc_cache_write(const RawAddress& server_bda,
                            const gatt::Database& database);
@@ -15,19 +15,23 @@
  */
 
 #define LOG_TAG "gatt"
+#define OSI_ALLOC_TAG "bta_gatt"
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "bta_gatt_queue.h"
+#include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/allocator.h"
 
 using gatt_operation = BtaGattQueue::gatt_operation;
+using bluetooth::common::time_get_os_boottime_us;
 using namespace bluetooth;
 
 constexpr uint8_t GATT_READ_CHAR = 1;
@@ -45,9 +49,32 @@ struct gatt_read_op_data {
 std::unordered_map<uint16_t, std::list<gatt_operation>>
     BtaGattQueue::gatt_op_queue;
 std::unordered_set<uint16_t> BtaGattQueue::gatt_op_queue_executing;
+std::unordered_map<uint16_t, BtaGattQueue::gatt_queue_stats>
+    BtaGattQueue::gatt_op_queue_stats;
+
+void BtaGattQueue::enqueue_op(uint16_t conn_id, gatt_operation op) {
+  op.enqueue_time_us = time_get_os_boottime_us();
+
+  std::list<gatt_operation>& gatt_ops = gatt_op_queue[conn_id];
+  gatt_ops.push_back(std::move(op));
+
+  gatt_queue_stats& stats = gatt_op_queue_stats[conn_id];
+  if (stats.first_op_us == 0) {
+    stats.first_op_us = gatt_ops.back().enqueue_time_us;
+  }
+  stats.max_queue_depth = std::max(stats.max_queue_depth, gatt_ops.size());
+
+  gatt_execute_next_op(conn_id);
+}
 
 void BtaGattQueue::mark_as_not_executing(uint16_t conn_id) {
-  gatt_op_queue_executing.erase(conn_id);
+  if (gatt_op_queue_executing.erase(conn_id) == 0) return;
+
+  auto stats = gatt_op_queue_stats.find(conn_id);
+  if (stats != gatt_op_queue_stats.end()) {
+    stats->second.busy_us +=
+        time_get_os_boottime_us() - stats->second.executing_since_us;
+  }
 }
 
 void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
@@ -163,6 +190,14 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 
   gatt_operation& op = gatt_ops.front();
 
+  uint64_t now_us = time_get_os_boottime_us();
+  gatt_queue_stats& stats = gatt_op_queue_stats[conn_id];
+  uint64_t wait_us = now_us - op.enqueue_time_us;
+  stats.ops_executed++;
+  stats.queue_wait_us += wait_us;
+  stats.max_queue_wait_us = std::max(stats.max_queue_wait_us, wait_us);
+  stats.executing_since_us = now_us;
+
   if (op.type == GATT_READ_CHAR) {
     gatt_read_op_data* data =
         (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
@@ -217,61 +252,71 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 }
 
 void BtaGattQueue::Clean(uint16_t conn_id) {
+  mark_as_not_executing(conn_id);
   gatt_op_queue.erase(conn_id);
-  gatt_op_queue_executing.erase(conn_id);
+
+  auto it = gatt_op_queue_stats.find(conn_id);
+  if (it == gatt_op_queue_stats.end()) return;
+
+  const gatt_queue_stats& stats = it->second;
+  if (stats.ops_executed > 0) {
+    uint64_t elapsed_us = time_get_os_boottime_us() - stats.first_op_us;
+    log::info(
+        "conn_id=0x{:x}, ops={}, max_depth={}, avg_wait_ms={}, "
+        "max_wait_ms={}, utilization={}%",
+        conn_id, stats.ops_executed, stats.max_queue_depth,
+        stats.queue_wait_us / stats.ops_executed / 1000,
+        stats.max_queue_wait_us / 1000,
+        elapsed_us == 0 ? 0 : stats.busy_us * 100 / elapsed_us);
+  }
+  gatt_op_queue_stats.erase(it);
 }
 
 void BtaGattQueue::ReadCharacteristic(uint16_t conn_id, uint16_t handle,
                                       GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_CHAR,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  enqueue_op(conn_id, {.type = GATT_READ_CHAR,
+                       .handle = handle,
+                       .read_cb = cb,
+                       .read_cb_data = cb_data});
 }
 
 void BtaGattQueue::ReadDescriptor(uint16_t conn_id, uint16_t handle,
                                   GATT_READ_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_DESC,
-                                    .handle = handle,
-                                    .read_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  enqueue_op(conn_id, {.type = GATT_READ_DESC,
+                       .handle = handle,
+                       .read_cb = cb,
+                       .read_cb_data = cb_data});
 }
 
 void BtaGattQueue::WriteCharacteristic(uint16_t conn_id, uint16_t handle,
                                        std::vector<uint8_t> value,
                                        tGATT_WRITE_TYPE write_type,
                                        GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_CHAR,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  enqueue_op(conn_id, {.type = GATT_WRITE_CHAR,
+                       .handle = handle,
+                       .write_cb = cb,
+                       .write_cb_data = cb_data,
+                       .write_type = write_type,
+                       .value = std::move(value)});
 }
 
 void BtaGattQueue::WriteDescriptor(uint16_t conn_id, uint16_t handle,
                                    std::vector<uint8_t> value,
                                    tGATT_WRITE_TYPE write_type,
                                    GATT_WRITE_OP_CB cb, void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_WRITE_DESC,
-                                    .handle = handle,
-                                    .write_cb = cb,
-                                    .write_cb_data = cb_data,
-                                    .write_type = write_type,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  enqueue_op(conn_id, {.type = GATT_WRITE_DESC,
+                       .handle = handle,
+                       .write_cb = cb,
+                       .write_cb_data = cb_data,
+                       .write_type = write_type,
+                       .value = std::move(value)});
 }
 
 void BtaGattQueue::ConfigureMtu(uint16_t conn_id, uint16_t mtu) {
   log::info("mtu: {}", static_cast<int>(mtu));
   std::vector<uint8_t> value = {static_cast<uint8_t>(mtu & 0xff),
                                 static_cast<uint8_t>(mtu >> 8)};
-  gatt_op_queue[conn_id].push_back({.type = GATT_CONFIG_MTU,
-                                    .value = std::move(value)});
-  gatt_execute_next_op(conn_id);
+  enqueue_op(conn_id, {.type = GATT_CONFIG_MTU, .value = std::move(value)});
 }
 
 void BtaGattQueue::ReadMultiCharacteristic(uint16_t conn_id,
@@ -279,10 +324,9 @@ void BtaGattQueue::ReadMultiCharacteristic(uint16_t conn_id,
                                            bool variable_len,
                                            GATT_READ_MULTI_OP_CB cb,
                                            void* cb_data) {
-  gatt_op_queue[conn_id].push_back({.type = GATT_READ_MULTI,
-                                    .handles = handles,
-                                    .variable_len = variable_len,
-                                    .read_multi_cb = cb,
-                                    .read_cb_data = cb_data});
-  gatt_execute_next_op(conn_id);
+  enqueue_op(conn_id, {.type = GATT_READ_MULTI,
+                       .handles = handles,
+                       .variable_len = variable_len,
+                       .read_multi_cb = cb,
+                       .read_cb_data = cb_data});
 }
@@ -23,6 +23,8 @@
  *
  ******************************************************************************/
 
+#define OSI_ALLOC_TAG "bta_gatt"
+
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
@@ -65,7 +65,7 @@ void BTA_GATTS_Disable(void) {
     return;
   }
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
   p_buf->event = BTA_GATTS_API_DISABLE_EVT;
   bta_sys_sendmsg(p_buf);
   bta_sys_deregister(BTA_ID_GATTS);
@@ -87,7 +87,7 @@ void BTA_GATTS_Disable(void) {
 void BTA_GATTS_AppRegister(const bluetooth::Uuid& app_uuid,
                            tBTA_GATTS_CBACK* p_cback, bool eatt_support) {
   tBTA_GATTS_API_REG* p_buf =
-      (tBTA_GATTS_API_REG*)osi_malloc(sizeof(tBTA_GATTS_API_REG));
+      (tBTA_GATTS_API_REG*)bta_sys_msg_alloc(sizeof(tBTA_GATTS_API_REG));
 
   /* register with BTA system manager */
   if (!bta_sys_is_register(BTA_ID_GATTS))
@@ -114,7 +114,7 @@ void BTA_GATTS_AppRegister(const bluetooth::Uuid& app_uuid,
  ******************************************************************************/
 void BTA_GATTS_AppDeregister(tGATT_IF server_if) {
   tBTA_GATTS_API_DEREG* p_buf =
-      (tBTA_GATTS_API_DEREG*)osi_malloc(sizeof(tBTA_GATTS_API_DEREG));
+      (tBTA_GATTS_API_DEREG*)bta_sys_msg_alloc(sizeof(tBTA_GATTS_API_DEREG));
 
   p_buf->hdr.event = BTA_GATTS_API_DEREG_EVT;
   p_buf->server_if = server_if;
@@ -197,7 +197,7 @@ void BTA_GATTS_AddService(tGATT_IF server_if,
  *
  ******************************************************************************/
 void BTA_GATTS_DeleteService(uint16_t service_id) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_GATTS_API_DEL_SRVC_EVT;
   p_buf->layer_specific = service_id;
@@ -217,7 +217,7 @@ void BTA_GATTS_DeleteService(uint16_t service_id) {
  *
  ******************************************************************************/
 void BTA_GATTS_StopService(uint16_t service_id) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_GATTS_API_STOP_SRVC_EVT;
   p_buf->layer_specific = service_id;
@@ -251,7 +251,8 @@ void BTA_GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_id,
   }
 
   tBTA_GATTS_API_INDICATION* p_buf =
-      (tBTA_GATTS_API_INDICATION*)osi_calloc(sizeof(tBTA_GATTS_API_INDICATION));
+      (tBTA_GATTS_API_INDICATION*)bta_sys_msg_alloc(
+          sizeof(tBTA_GATTS_API_INDICATION));
 
   p_buf->hdr.event = BTA_GATTS_API_INDICATION_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -282,7 +283,7 @@ void BTA_GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_id,
 void BTA_GATTS_SendRsp(uint16_t conn_id, uint32_t trans_id, tGATT_STATUS status,
                        tGATTS_RSP* p_msg) {
   const size_t len = sizeof(tBTA_GATTS_API_RSP) + sizeof(tGATTS_RSP);
-  tBTA_GATTS_API_RSP* p_buf = (tBTA_GATTS_API_RSP*)osi_calloc(len);
+  tBTA_GATTS_API_RSP* p_buf = (tBTA_GATTS_API_RSP*)bta_sys_msg_alloc(len);
 
   p_buf->hdr.event = BTA_GATTS_API_RSP_EVT;
   p_buf->hdr.layer_specific = conn_id;
@@ -316,7 +317,7 @@ void BTA_GATTS_Open(tGATT_IF server_if, const RawAddress& remote_bda,
                     tBLE_ADDR_TYPE addr_type, bool is_direct,
                     tBT_TRANSPORT transport) {
   tBTA_GATTS_API_OPEN* p_buf =
-      (tBTA_GATTS_API_OPEN*)osi_malloc(sizeof(tBTA_GATTS_API_OPEN));
+      (tBTA_GATTS_API_OPEN*)bta_sys_msg_alloc(sizeof(tBTA_GATTS_API_OPEN));
 
   p_buf->hdr.event = BTA_GATTS_API_OPEN_EVT;
   p_buf->server_if = server_if;
@@ -348,8 +349,9 @@ void BTA_GATTS_Open(tGATT_IF server_if, const RawAddress& remote_bda,
  ******************************************************************************/
 void BTA_GATTS_CancelOpen(tGATT_IF server_if, const RawAddress& remote_bda,
                           bool is_direct) {
-  tBTA_GATTS_API_CANCEL_OPEN* p_buf = (tBTA_GATTS_API_CANCEL_OPEN*)osi_malloc(
-      sizeof(tBTA_GATTS_API_CANCEL_OPEN));
+  tBTA_GATTS_API_CANCEL_OPEN* p_buf =
+      (tBTA_GATTS_API_CANCEL_OPEN*)bta_sys_msg_alloc(
+          sizeof(tBTA_GATTS_API_CANCEL_OPEN));
 
   p_buf->hdr.event = BTA_GATTS_API_CANCEL_OPEN_EVT;
   p_buf->server_if = server_if;
@@ -371,7 +373,7 @@ void BTA_GATTS_CancelOpen(tGATT_IF server_if, const RawAddress& remote_bda,
  *
  ******************************************************************************/
 void BTA_GATTS_Close(uint16_t conn_id) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_GATTS_API_CLOSE_EVT;
   p_buf->layer_specific = conn_id;
@@ -382,7 +384,7 @@ void BTA_GATTS_Close(uint16_t conn_id) {
 void BTA_GATTS_InitBonded(void) {
   log::info("");
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
   p_buf->event = BTA_GATTS_API_INIT_BONDED_EVT;
   bta_sys_sendmsg(p_buf);
 }
@@ -217,10 +217,64 @@ Database Database::Deserialize(const std::vector<StoredAttribute>& nv_attr,
       }
     }
   }
+  result.BuildIndex();
   *success = true;
   return result;
 }
 
+void Database::BuildIndex() {
+  handle_index.clear();
+  for (const Service& service : services) {
+    for (const Characteristic& charac : service.characteristics) {
+      if (HandleInRange(service, charac.value_handle)) {
+        handle_index.push_back(IndexEntry{.handle = charac.value_handle,
+                                          .characteristic = &charac,
+                                          .descriptor = nullptr});
+      }
+      for (const Descriptor& desc : charac.descriptors) {
+        if (HandleInRange(service, desc.handle)) {
+          handle_index.push_back(IndexEntry{.handle = desc.handle,
+                                            .characteristic = &charac,
+                                            .descriptor = &desc});
+        }
+      }
+    }
+  }
+  // Keep the first attribute of a handle first, as the service search did
+  std::stable_sort(handle_index.begin(), handle_index.end(),
+                   [](const IndexEntry& a, const IndexEntry& b) {
+                     return a.handle < b.handle;
+                   });
+}
+
+const Database::IndexEntry* Database::FindIndexEntry(uint16_t handle,
+                                                     bool descriptor) const {
+  auto it = std::lower_bound(handle_index.begin(), handle_index.end(), handle,
+                             [](const IndexEntry& entry, uint16_t handle) {
+                               return entry.handle < handle;
+                             });
+  for (; it != handle_index.end() && it->handle == handle; it++) {
+    if ((it->descriptor != nullptr) == descriptor) return &(*it);
+  }
+  return nullptr;
+}
+
+const Characteristic* Database::FindCharacteristic(uint16_t handle) const {
+  const IndexEntry* entry = FindIndexEntry(handle, false);
+  return entry ? entry->characteristic : nullptr;
+}
+
+const Descriptor* Database::FindDescriptor(uint16_t handle) const {
+  const IndexEntry* entry = FindIndexEntry(handle, true);
+  return entry ? entry->descriptor : nullptr;
+}
+
+const Characteristic* Database::FindOwningCharacteristic(
+    uint16_t handle) const {
+  const IndexEntry* entry = FindIndexEntry(handle, true);
+  return entry ? entry->characteristic : nullptr;
+}
+
 Octet16 Database::Hash() const {
   int len = 0;
   // Compute how much space we need to actually hold the data.
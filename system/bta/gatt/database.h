@@ -104,12 +104,29 @@ class DatabaseBuilder;
 
 class Database {
  public:
+  Database() = default;
+  /* The handle index points into the services, copies rebuild it. Moving the
+   * services keeps the elements in place. */
+  Database(const Database& other) : services(other.services) { BuildIndex(); }
+  Database& operator=(const Database& other) {
+    if (this != &other) {
+      services = other.services;
+      BuildIndex();
+    }
+    return *this;
+  }
+  Database(Database&&) = default;
+  Database& operator=(Database&&) = default;
+
   /* Return true if there are no services in this database. */
   bool IsEmpty() const { return services.empty(); }
 
   /* Clear the GATT database. This method forces relocation to ensure no extra
    * space is used unnecesarly */
-  void Clear() { std::list<Service>().swap(services); }
+  void Clear() {
+    std::list<Service>().swap(services);
+    std::vector<IndexEntry>().swap(handle_index);
+  }
 
   /* Return list of services available in this database */
   const std::list<Service>& Services() const { return services; }
@@ -124,10 +141,35 @@ class Database {
   /* Return 128 bit unique identifier of this GATT database */
   Octet16 Hash() const;
 
+  /* Return the characteristic whose value has |handle|, or nullptr */
+  const Characteristic* FindCharacteristic(uint16_t handle) const;
+
+  /* Return the descriptor with |handle|, or nullptr */
+  const Descriptor* FindDescriptor(uint16_t handle) const;
+
+  /* Return the characteristic owning the descriptor with |handle|, or nullptr
+   */
+  const Characteristic* FindOwningCharacteristic(uint16_t handle) const;
+
   friend class DatabaseBuilder;
 
  private:
+  /* Characteristic value or descriptor of the database */
+  struct IndexEntry {
+    uint16_t handle;
+    const Characteristic* characteristic;
+    /* nullptr for the characteristic value */
+    const Descriptor* descriptor;
+  };
+
+  /* Index the characteristic values and descriptors by handle, to be called
+   * once the services are complete */
+  void BuildIndex();
+  const IndexEntry* FindIndexEntry(uint16_t handle, bool descriptor) const;
+
   std::list<Service> services;
+  /* sorted by handle */
+  std::vector<IndexEntry> handle_index;
 };
 
 /* Find a service that should contain handle. Helper method for internal use
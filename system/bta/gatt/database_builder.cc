@@ -134,6 +134,13 @@ void DatabaseBuilder::AddDescriptor(uint16_t handle, const Uuid& uuid) {
     char_node = &(*it);
   }
 
+  /* Descriptor ranges spanning several characteristics also report their
+   * declarations and values */
+  if (handle == char_node->declaration_handle ||
+      handle == char_node->value_handle) {
+    return;
+  }
+
   char_node->descriptors.emplace_back(
       gatt::Descriptor{.handle = handle, .uuid = uuid});
 
@@ -163,31 +170,46 @@ DatabaseBuilder::CurrentlyExploredService() {
   return pending_service;
 }
 
-std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore() {
+std::pair<uint16_t, uint16_t> DatabaseBuilder::NextDescriptorRangeToExplore(
+    uint16_t max_range_handles) {
   Service* service = FindService(database.services, pending_service.first);
   if (!service || service->characteristics.empty()) {
     return {HANDLE_MAX, HANDLE_MAX};
   }
 
+  /* Last handle that can hold descriptors of the characteristic |it| */
+  auto descriptors_end = [&](auto it) -> uint16_t {
+    auto next = std::next(it);
+    if (next != service->characteristics.cend())
+      return next->declaration_handle - 1;
+    return service->end_handle;
+  };
+
   for (auto it = service->characteristics.cbegin();
        it != service->characteristics.cend(); it++) {
     if (it->declaration_handle > pending_characteristic) {
-      auto next = std::next(it);
-
       /* Characteristic Declaration is followed by Characteristic Value
        * Declaration, first descriptor is after that, see BT Spect 5.0 Vol 3,
        * Part G 3.3.2 and 3.3.3 */
       uint16_t start = it->declaration_handle + 2;
-      uint16_t end;
-      if (next != service->characteristics.end())
-        end = next->declaration_handle - 1;
-      else
-        end = service->end_handle;
+      uint16_t end = descriptors_end(it);
 
       // No place for descriptor - skip to next characteristic
       if (start > end) continue;
 
-      pending_characteristic = start;
+      // Merge the ranges of the following characteristics that fit
+      for (auto next = std::next(it); next != service->characteristics.cend();
+           next++) {
+        uint16_t next_end = descriptors_end(next);
+        if (next_end < next->declaration_handle ||
+            next_end - start + 1 > max_range_handles) {
+          break;
+        }
+        end = next_end;
+        it = next;
+      }
+
+      pending_characteristic = it->declaration_handle;
       return {start, end};
     }
   }
@@ -244,8 +266,9 @@ bool DatabaseBuilder::SetValueOfDescriptors(
 bool DatabaseBuilder::InProgress() const { return !database.services.empty(); }
 
 Database DatabaseBuilder::Build() {
-  Database tmp = database;
+  Database tmp = std::move(database);
   database.Clear();
+  tmp.BuildIndex();
   return tmp;
 }
 
@@ -50,8 +50,15 @@ class DatabaseBuilder {
 
   /* Return pair with start and end handle of the descriptor range to discover,
    * or DatabaseBuilder::EXPLORE_END if no more descriptors left.
+   *
+   * The range of a characteristic is extended over the ranges of the following
+   * characteristics of the service, as long as it spans at most
+   * |max_range_handles| handles, so that the descriptors of several
+   * characteristics are discovered at once. The declarations and values of the
+   * characteristics in such a range are ignored by AddDescriptor.
    */
-  std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore();
+  std::pair<uint16_t, uint16_t> NextDescriptorRangeToExplore(
+      uint16_t max_range_handles = 0);
 
   /* Return vector of "Characteristic Extended Properties" descriptors that must
    * be read as part of service discovery process */
@@ -60,8 +60,8 @@ void BTA_HdEnable(tBTA_HD_CBACK* p_cback) {
 
   bta_sys_register(BTA_ID_HD, &bta_hd_reg);
 
-  tBTA_HD_API_ENABLE* p_buf =
-      (tBTA_HD_API_ENABLE*)osi_malloc((uint16_t)sizeof(tBTA_HD_API_ENABLE));
+  tBTA_HD_API_ENABLE* p_buf = (tBTA_HD_API_ENABLE*)bta_sys_msg_alloc(
+      (uint16_t)sizeof(tBTA_HD_API_ENABLE));
 
   memset(p_buf, 0, sizeof(tBTA_HD_API_ENABLE));
 
@@ -83,7 +83,7 @@ void BTA_HdEnable(tBTA_HD_CBACK* p_cback) {
 void BTA_HdDisable(void) {
   log::verbose("");
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
   p_buf->event = BTA_HD_API_DISABLE_EVT;
   bta_sys_sendmsg(p_buf);
 }
@@ -103,7 +103,7 @@ void BTA_HdRegisterApp(tBTA_HD_APP_INFO* p_app_info, tBTA_HD_QOS_INFO* p_in_qos,
   log::verbose("");
 
   tBTA_HD_REGISTER_APP* p_buf =
-      (tBTA_HD_REGISTER_APP*)osi_malloc(sizeof(tBTA_HD_REGISTER_APP));
+      (tBTA_HD_REGISTER_APP*)bta_sys_msg_alloc(sizeof(tBTA_HD_REGISTER_APP));
   p_buf->hdr.event = BTA_HD_API_REGISTER_APP_EVT;
 
   if (p_app_info->p_name) {
@@ -154,7 +154,7 @@ void BTA_HdRegisterApp(tBTA_HD_APP_INFO* p_app_info, tBTA_HD_QOS_INFO* p_in_qos,
 void BTA_HdUnregisterApp(void) {
   log::verbose("");
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
   p_buf->event = BTA_HD_API_UNREGISTER_APP_EVT;
 
   bta_sys_sendmsg(p_buf);
@@ -181,7 +181,7 @@ void BTA_HdSendReport(tBTA_HD_REPORT* p_report) {
   }
 
   tBTA_HD_SEND_REPORT* p_buf =
-      (tBTA_HD_SEND_REPORT*)osi_malloc(sizeof(tBTA_HD_SEND_REPORT));
+      (tBTA_HD_SEND_REPORT*)bta_sys_msg_alloc(sizeof(tBTA_HD_SEND_REPORT));
   p_buf->hdr.event = BTA_HD_API_SEND_REPORT_EVT;
 
   p_buf->use_intr = p_report->use_intr;
@@ -205,7 +205,7 @@ void BTA_HdSendReport(tBTA_HD_REPORT* p_report) {
 void BTA_HdVirtualCableUnplug(void) {
   log::verbose("");
 
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
   p_buf->event = BTA_HD_API_VC_UNPLUG_EVT;
 
   bta_sys_sendmsg(p_buf);
@@ -225,7 +225,7 @@ void BTA_HdConnect(const RawAddress& addr) {
   log::verbose("");
 
   tBTA_HD_DEVICE_CTRL* p_buf =
-      (tBTA_HD_DEVICE_CTRL*)osi_malloc(sizeof(tBTA_HD_DEVICE_CTRL));
+      (tBTA_HD_DEVICE_CTRL*)bta_sys_msg_alloc(sizeof(tBTA_HD_DEVICE_CTRL));
   p_buf->hdr.event = BTA_HD_API_CONNECT_EVT;
 
   p_buf->addr = addr;
@@ -244,7 +244,7 @@ void BTA_HdConnect(const RawAddress& addr) {
  ******************************************************************************/
 void BTA_HdDisconnect(void) {
   log::verbose("");
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
   p_buf->event = BTA_HD_API_DISCONNECT_EVT;
 
   bta_sys_sendmsg(p_buf);
@@ -262,7 +262,7 @@ void BTA_HdDisconnect(void) {
 void BTA_HdAddDevice(const RawAddress& addr) {
   log::verbose("");
   tBTA_HD_DEVICE_CTRL* p_buf =
-      (tBTA_HD_DEVICE_CTRL*)osi_malloc(sizeof(tBTA_HD_DEVICE_CTRL));
+      (tBTA_HD_DEVICE_CTRL*)bta_sys_msg_alloc(sizeof(tBTA_HD_DEVICE_CTRL));
   p_buf->hdr.event = BTA_HD_API_ADD_DEVICE_EVT;
 
   p_buf->addr = addr;
@@ -282,7 +282,7 @@ void BTA_HdAddDevice(const RawAddress& addr) {
 void BTA_HdRemoveDevice(const RawAddress& addr) {
   log::verbose("");
   tBTA_HD_DEVICE_CTRL* p_buf =
-      (tBTA_HD_DEVICE_CTRL*)osi_malloc(sizeof(tBTA_HD_DEVICE_CTRL));
+      (tBTA_HD_DEVICE_CTRL*)bta_sys_msg_alloc(sizeof(tBTA_HD_DEVICE_CTRL));
   p_buf->hdr.event = BTA_HD_API_REMOVE_DEVICE_EVT;
 
   p_buf->addr = addr;
@@ -302,7 +302,7 @@ void BTA_HdRemoveDevice(const RawAddress& addr) {
 void BTA_HdReportError(uint8_t error) {
   log::verbose("");
   tBTA_HD_REPORT_ERR* p_buf =
-      (tBTA_HD_REPORT_ERR*)osi_malloc(sizeof(tBTA_HD_REPORT_ERR));
+      (tBTA_HD_REPORT_ERR*)bta_sys_msg_alloc(sizeof(tBTA_HD_REPORT_ERR));
   p_buf->hdr.event = BTA_HD_API_REPORT_ERROR_EVT;
   p_buf->error = error;
 
@@ -1451,6 +1451,8 @@ class HearingAidImpl : public HearingAid {
 
     std::vector<uint16_t> chan_left;
     std::vector<uint16_t> chan_right;
+    chan_left.reserve(num_samples);
+    chan_right.reserve(num_samples);
     if (left == nullptr || right == nullptr) {
       for (int i = 0; i < num_samples; i++) {
         const uint8_t* sample = data.data() + i * 4;
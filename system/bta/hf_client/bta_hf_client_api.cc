@@ -89,8 +89,8 @@ void BTA_HfClientDisable(void) { bta_hf_client_api_disable(); }
  ******************************************************************************/
 bt_status_t BTA_HfClientOpen(const RawAddress& bd_addr, uint16_t* p_handle) {
   log::verbose("");
-  tBTA_HF_CLIENT_API_OPEN* p_buf =
-      (tBTA_HF_CLIENT_API_OPEN*)osi_malloc(sizeof(tBTA_HF_CLIENT_API_OPEN));
+  tBTA_HF_CLIENT_API_OPEN* p_buf = (tBTA_HF_CLIENT_API_OPEN*)bta_sys_msg_alloc(
+      sizeof(tBTA_HF_CLIENT_API_OPEN));
 
   if (!bta_hf_client_allocate_handle(bd_addr, p_handle)) {
     log::error("could not allocate handle");
@@ -117,7 +117,7 @@ bt_status_t BTA_HfClientOpen(const RawAddress& bd_addr, uint16_t* p_handle) {
  *
  ******************************************************************************/
 void BTA_HfClientClose(uint16_t handle) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_HF_CLIENT_API_CLOSE_EVT;
   p_buf->layer_specific = handle;
@@ -137,7 +137,7 @@ void BTA_HfClientClose(uint16_t handle) {
  *
  ******************************************************************************/
 void BTA_HfClientAudioOpen(uint16_t handle) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_HF_CLIENT_API_AUDIO_OPEN_EVT;
   p_buf->layer_specific = handle;
@@ -157,7 +157,7 @@ void BTA_HfClientAudioOpen(uint16_t handle) {
  *
  ******************************************************************************/
 void BTA_HfClientAudioClose(uint16_t handle) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_HF_CLIENT_API_AUDIO_CLOSE_EVT;
   p_buf->layer_specific = handle;
@@ -177,8 +177,8 @@ void BTA_HfClientAudioClose(uint16_t handle) {
  ******************************************************************************/
 void BTA_HfClientSendAT(uint16_t handle, tBTA_HF_CLIENT_AT_CMD_TYPE at,
                         uint32_t val1, uint32_t val2, const char* str) {
-  tBTA_HF_CLIENT_DATA_VAL* p_buf =
-      (tBTA_HF_CLIENT_DATA_VAL*)osi_malloc(sizeof(tBTA_HF_CLIENT_DATA_VAL));
+  tBTA_HF_CLIENT_DATA_VAL* p_buf = (tBTA_HF_CLIENT_DATA_VAL*)bta_sys_msg_alloc(
+      sizeof(tBTA_HF_CLIENT_DATA_VAL));
 
   p_buf->hdr.event = BTA_HF_CLIENT_SEND_AT_CMD_EVT;
   p_buf->uint8_val = at;
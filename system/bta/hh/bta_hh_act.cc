@@ -1135,6 +1135,32 @@ void bta_hh_write_dev_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
 /*****************************************************************************
  *  Static Function
  ****************************************************************************/
+/*******************************************************************************
+ *
+ * Function         bta_hh_input_report_fast_path
+ *
+ * Description      Hands an input report of a connected device to the HID
+ *                  device right away. The state machine only forwards it in
+ *                  that state, posting it to the main thread again would only
+ *                  add an allocation and a task per report.
+ *
+ * Returns          true if the report was handled, false if it has to go
+ *                  through the state machine
+ *
+ ******************************************************************************/
+static bool bta_hh_input_report_fast_path(uint8_t dev_handle, BT_HDR* pdata) {
+  uint8_t index = bta_hh_dev_handle_to_cb_idx(dev_handle);
+  if (index == BTA_HH_IDX_INVALID ||
+      bta_hh_cb.kdev[index].state != BTA_HH_CONN_ST) {
+    return false;
+  }
+
+  bta_hh_co_data(dev_handle, (uint8_t*)(pdata + 1) + pdata->offset,
+                 pdata->len);
+  osi_free(pdata);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_cback
@@ -1160,6 +1186,7 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
       sm_event = BTA_HH_INT_CLOSE_EVT;
       break;
     case HID_HDEV_EVT_INTR_DATA:
+      if (bta_hh_input_report_fast_path(dev_handle, pdata)) return;
       sm_event = BTA_HH_INT_DATA_EVT;
       break;
     case HID_HDEV_EVT_HANDSHAKE:
@@ -104,7 +104,7 @@ void BTA_HhDisable(void) {
  *
  ******************************************************************************/
 void BTA_HhClose(uint8_t dev_handle) {
-  BT_HDR* p_buf = (BT_HDR*)osi_calloc(sizeof(BT_HDR));
+  BT_HDR* p_buf = (BT_HDR*)bta_sys_msg_alloc(sizeof(BT_HDR));
 
   p_buf->event = BTA_HH_API_CLOSE_EVT;
   p_buf->layer_specific = (uint16_t)dev_handle;
@@ -124,7 +124,7 @@ void BTA_HhClose(uint8_t dev_handle) {
  ******************************************************************************/
 void BTA_HhOpen(const tAclLinkSpec& link_spec) {
   tBTA_HH_API_CONN* p_buf =
-      (tBTA_HH_API_CONN*)osi_calloc(sizeof(tBTA_HH_API_CONN));
+      (tBTA_HH_API_CONN*)bta_sys_msg_alloc(sizeof(tBTA_HH_API_CONN));
   tBTA_HH_PROTO_MODE mode = BTA_HH_PROTO_RPT_MODE;
 
   p_buf->hdr.event = BTA_HH_API_OPEN_EVT;
@@ -144,7 +144,7 @@ static void bta_hh_snd_write_dev(uint8_t dev_handle, uint8_t t_type,
                                  uint8_t param, uint16_t data, uint8_t rpt_id,
                                  BT_HDR* p_data) {
   tBTA_HH_CMD_DATA* p_buf =
-      (tBTA_HH_CMD_DATA*)osi_calloc(sizeof(tBTA_HH_CMD_DATA));
+      (tBTA_HH_CMD_DATA*)bta_sys_msg_alloc(sizeof(tBTA_HH_CMD_DATA));
 
   p_buf->hdr.event = BTA_HH_API_WRITE_DEV_EVT;
   p_buf->hdr.layer_specific = (uint16_t)dev_handle;
@@ -293,7 +293,7 @@ void BTA_HhSendData(uint8_t dev_handle, const tAclLinkSpec& /* link_spec */,
  *
  ******************************************************************************/
 void BTA_HhGetDscpInfo(uint8_t dev_handle) {
-  BT_HDR* p_buf = (BT_HDR*)osi_calloc(sizeof(BT_HDR));
+  BT_HDR* p_buf = (BT_HDR*)bta_sys_msg_alloc(sizeof(BT_HDR));
 
   p_buf->event = BTA_HH_API_GET_DSCP_EVT;
   p_buf->layer_specific = (uint16_t)dev_handle;
@@ -317,7 +317,7 @@ void BTA_HhAddDev(const tAclLinkSpec& link_spec, tBTA_HH_ATTR_MASK attr_mask,
                   uint8_t sub_class, uint8_t app_id,
                   tBTA_HH_DEV_DSCP_INFO dscp_info) {
   size_t len = sizeof(tBTA_HH_MAINT_DEV) + dscp_info.descriptor.dl_len;
-  tBTA_HH_MAINT_DEV* p_buf = (tBTA_HH_MAINT_DEV*)osi_calloc(len);
+  tBTA_HH_MAINT_DEV* p_buf = (tBTA_HH_MAINT_DEV*)bta_sys_msg_alloc(len);
 
   p_buf->hdr.event = BTA_HH_API_MAINT_DEV_EVT;
   p_buf->sub_event = BTA_HH_ADD_DEV_EVT;
@@ -353,7 +353,7 @@ void BTA_HhAddDev(const tAclLinkSpec& link_spec, tBTA_HH_ATTR_MASK attr_mask,
  ******************************************************************************/
 void BTA_HhRemoveDev(uint8_t dev_handle) {
   tBTA_HH_MAINT_DEV* p_buf =
-      (tBTA_HH_MAINT_DEV*)osi_calloc(sizeof(tBTA_HH_MAINT_DEV));
+      (tBTA_HH_MAINT_DEV*)bta_sys_msg_alloc(sizeof(tBTA_HH_MAINT_DEV));
 
   p_buf->hdr.event = BTA_HH_API_MAINT_DEV_EVT;
   p_buf->sub_event = BTA_HH_RMV_DEV_EVT;
@@ -225,6 +225,11 @@ typedef struct {
 #define BTA_HH_LE_SCPS_NOTIFY_ENB 0x02
   uint8_t scps_notify; /* scan refresh supported/notification enabled */
   bool security_pending;
+
+  /* LE link subrate following the input activity */
+  bool input_active;         /* link at the active subrate */
+  uint64_t last_input_ms;    /* boot time of the last input report */
+  alarm_t* input_idle_timer; /* switches the link to the idle subrate */
 } tBTA_HH_DEV_CB;
 
 /******************************************************************************
@@ -30,9 +30,11 @@
 #include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_hh_co.h"
 #include "bta/include/bta_le_audio_api.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "osi/include/allocator.h"
 #include "osi/include/osi.h"    // ARRAY_SIZE
+#include "osi/include/properties.h"
 #include "stack/btm/btm_sec.h"  // BTM_
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
@@ -70,7 +72,18 @@ constexpr bool kBTA_HH_LE_RECONN = false;
 namespace {
 
 constexpr char kBtmLogTag[] = "LE HIDH";
-}
+
+/* Subrate factor requested once the input reports stopped for the idle
+ * timeout, the link is back at the base connection interval on the next input
+ * report. The policy is disabled when the factor is below 2. */
+constexpr char kIdleSubrateFactorProperty[] =
+    "bluetooth.hid.le.idle_subrate_factor";
+constexpr char kIdleTimeoutMsProperty[] = "bluetooth.hid.le.idle_timeout_ms";
+constexpr int32_t kIdleTimeoutMsDefault = 2000;
+
+uint16_t idle_subrate_factor = 0;
+uint64_t idle_timeout_ms = kIdleTimeoutMsDefault;
+}  // namespace
 
 static const uint16_t bta_hh_uuid_to_rtp_type[BTA_LE_HID_RTP_UUID_MAX][2] = {
     {GATT_UUID_HID_REPORT, BTA_HH_RPTT_INPUT},
@@ -85,7 +98,8 @@ static void bta_hh_process_cache_rpt(tBTA_HH_DEV_CB* p_cb,
                                      tBTA_HH_RPT_CACHE_ENTRY* p_rpt_cache,
                                      uint8_t num_rpt);
 static bool bta_hh_le_iso_data_callback(const RawAddress& addr,
-                                        uint16_t cis_conn_hdl, uint8_t* data,
+                                        uint16_t cis_conn_hdl,
+                                        const uint8_t* data,
                                         uint16_t size, uint32_t timestamp);
 
 static const char* bta_hh_le_rpt_name[4] = {"UNKNOWN", "INPUT", "OUTPUT",
@@ -182,6 +196,13 @@ void bta_hh_le_enable(void) {
 
   bta_hh_cb.gatt_if = BTA_GATTS_INVALID_IF;
 
+  int32_t subrate_factor = osi_property_get_int32(kIdleSubrateFactorProperty, 0);
+  idle_subrate_factor =
+      (subrate_factor >= 2 && subrate_factor <= 500) ? subrate_factor : 0;
+  int32_t timeout_ms =
+      osi_property_get_int32(kIdleTimeoutMsProperty, kIdleTimeoutMsDefault);
+  idle_timeout_ms = timeout_ms > 0 ? timeout_ms : kIdleTimeoutMsDefault;
+
   for (xx = 0; xx < ARRAY_SIZE(bta_hh_cb.le_cb_index); xx++)
     bta_hh_cb.le_cb_index[xx] = BTA_HH_IDX_INVALID;
 
@@ -1622,6 +1643,90 @@ static void bta_hh_le_srvc_search_cmpl(tBTA_GATTC_SEARCH_CMPL* p_data) {
   bta_hh_le_gatt_disc_cmpl(p_dev_cb, p_dev_cb->status);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_set_input_subrate
+ *
+ * Description      Request the active or the idle subrate of the link of a
+ *                  LE HID device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_set_input_subrate(tBTA_HH_DEV_CB* p_dev_cb,
+                                        bool active) {
+  uint16_t factor = active ? 1 : idle_subrate_factor;
+
+  log::verbose("device:{} subrate factor:{}", p_dev_cb->link_spec.addrt.bda,
+               factor);
+  if (!L2CA_SubrateRequest(p_dev_cb->link_spec.addrt.bda, factor, factor, 0, 0,
+                           BTM_BLE_CONN_TIMEOUT_DEF)) {
+    log::verbose("Subrate not changed for device:{}",
+                 p_dev_cb->link_spec.addrt.bda);
+  }
+  p_dev_cb->input_active = active;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_input_idle_timeout
+ *
+ * Description      Idle timer of the input reports: moves the link to the idle
+ *                  subrate, or waits for the rest of the timeout if reports
+ *                  came in meanwhile.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_input_idle_timeout(void* data) {
+  tBTA_HH_DEV_CB* p_dev_cb = (tBTA_HH_DEV_CB*)data;
+
+  if (!p_dev_cb->in_use || p_dev_cb->state != BTA_HH_CONN_ST ||
+      !p_dev_cb->input_active) {
+    return;
+  }
+
+  uint64_t idle_ms =
+      bluetooth::common::time_get_os_boottime_ms() - p_dev_cb->last_input_ms;
+  if (idle_ms < idle_timeout_ms) {
+    alarm_set_on_mloop(p_dev_cb->input_idle_timer, idle_timeout_ms - idle_ms,
+                       bta_hh_le_input_idle_timeout, p_dev_cb);
+    return;
+  }
+
+  bta_hh_le_set_input_subrate(p_dev_cb, false);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_input_activity
+ *
+ * Description      Keep the link of a LE HID device at the base connection
+ *                  interval while it sends input reports. Only the first
+ *                  report after an idle period requests the subrate and arms
+ *                  the idle timer, the others record their time.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_input_activity(tBTA_HH_DEV_CB* p_dev_cb) {
+  if (idle_subrate_factor == 0) {
+    return;
+  }
+
+  p_dev_cb->last_input_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (p_dev_cb->input_active) {
+    return;
+  }
+
+  if (p_dev_cb->input_idle_timer == NULL) {
+    p_dev_cb->input_idle_timer = alarm_new("bta_hh.input_idle_timer");
+  }
+  bta_hh_le_set_input_subrate(p_dev_cb, true);
+  alarm_set_on_mloop(p_dev_cb->input_idle_timer, idle_timeout_ms,
+                     bta_hh_le_input_idle_timeout, p_dev_cb);
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_le_input_rpt_notify
@@ -1633,6 +1738,7 @@ static void bta_hh_le_srvc_search_cmpl(tBTA_GATTC_SEARCH_CMPL* p_data) {
  ******************************************************************************/
 static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
   tBTA_HH_DEV_CB* p_dev_cb = bta_hh_le_find_dev_cb_by_conn_id(p_data->conn_id);
+  uint8_t rpt_buf[GATT_MAX_ATTR_LEN + 1];
   uint8_t* p_buf;
   tBTA_HH_LE_RPT* p_rpt;
 
@@ -1668,9 +1774,10 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
 
   log::verbose("report ID: {}", p_rpt->rpt_id);
 
-  /* need to append report ID to the head of data */
+  /* need to append report ID to the head of data, on the stack as input
+   * reports may come at a high rate */
   if (p_rpt->rpt_id != 0) {
-    p_buf = (uint8_t*)osi_malloc(p_data->len + 1);
+    p_buf = rpt_buf;
 
     p_buf[0] = p_rpt->rpt_id;
     memcpy(&p_buf[1], p_data->value, p_data->len);
@@ -1681,7 +1788,7 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
 
   bta_hh_co_data((uint8_t)p_dev_cb->hid_handle, p_buf, p_data->len);
 
-  if (p_buf != p_data->value) osi_free(p_buf);
+  bta_hh_le_input_activity(p_dev_cb);
 }
 
 /*******************************************************************************
@@ -1754,6 +1861,9 @@ void bta_hh_gatt_close(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
   /* deregister all notification */
   bta_hh_le_deregister_input_notif(p_cb);
 
+  alarm_cancel(p_cb->input_idle_timer);
+  p_cb->input_active = false;
+
   /* update total conn number */
   bta_hh_cb.cnt_num--;
 
@@ -2342,7 +2452,8 @@ static void bta_hh_process_cache_rpt(tBTA_HH_DEV_CB* p_cb,
 }
 
 static bool bta_hh_le_iso_data_callback(const RawAddress& addr,
-                                        uint16_t cis_conn_hdl, uint8_t* data,
+                                        uint16_t cis_conn_hdl,
+                                        const uint8_t* data,
                                         uint16_t size, uint32_t timestamp) {
   if (!com::android::bluetooth::flags::leaudio_dynamic_spatial_audio()) {
     log::warn("DSA not supported");
@@ -141,6 +141,8 @@ void bta_hh_clean_up_kdev(tBTA_HH_DEV_CB* p_cb) {
   /* Free buffer for report descriptor info */
   osi_free_and_reset((void**)&p_cb->dscp_info.descriptor.dsc_list);
 
+  alarm_free(p_cb->input_idle_timer);
+
   memset(p_cb, 0, sizeof(tBTA_HH_DEV_CB)); /* Reset control block */
 
   p_cb->index = index; /* Restore index for this control block */
@@ -317,6 +319,8 @@ void bta_hh_cleanup_disable(tBTA_HH_STATUS status) {
   for (xx = 0; xx < BTA_HH_MAX_DEVICE; xx++) {
     osi_free_and_reset(
         (void**)&bta_hh_cb.kdev[xx].dscp_info.descriptor.dsc_list);
+    alarm_free(bta_hh_cb.kdev[xx].input_idle_timer);
+    bta_hh_cb.kdev[xx].input_idle_timer = NULL;
   }
 
   if (bta_hh_cb.p_disc_db) {
@@ -376,6 +376,8 @@ typedef union {
 
 /* AV callback */
 typedef void(tBTA_AV_CBACK)(tBTA_AV_EVT event, tBTA_AV* p_data);
+/* AV sink data callback; the callback takes ownership of the media packet of
+ * a BTA_AV_SINK_MEDIA_DATA_EVT and must free it */
 typedef void(tBTA_AV_SINK_DATA_CBACK)(const RawAddress&, tBTA_AV_EVT event,
                                       tBTA_AV_MEDIA* p_data);
 
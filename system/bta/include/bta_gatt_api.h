@@ -873,6 +873,25 @@ void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu);
 void BTA_GATTC_ConfigureMTU(uint16_t conn_id, uint16_t mtu,
                             GATT_CONFIGURE_MTU_OP_CB callback, void* cb_data);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_SetThroughputProfile
+ *
+ * Description      Declare the throughput profile of the client on the
+ *                  connection. Declaring bulk transfers right after the
+ *                  connection negotiates the maximum data length, the 2M PHY
+ *                  and the maximum MTU at once; the low power profile restores
+ *                  the data length and PHY of the link.
+ *
+ * Parameters       conn_id: connection ID.
+ *                  profile: throughput profile of the client.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void BTA_GATTC_SetThroughputProfile(uint16_t conn_id,
+                                    tGATT_THROUGHPUT_PROFILE profile);
+
 /*******************************************************************************
  *  BTA GATT Server API
  ******************************************************************************/
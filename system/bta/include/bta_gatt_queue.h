@@ -71,9 +71,24 @@ class BtaGattQueue {
     /* write-specific fields */
     tGATT_WRITE_TYPE write_type;
     std::vector<uint8_t> value;
+
+    /* time at which the operation was queued */
+    uint64_t enqueue_time_us;
   };
 
  private:
+  /* Holds the queue statistics of a connection, logged when it is cleaned */
+  struct gatt_queue_stats {
+    uint32_t ops_executed;
+    size_t max_queue_depth;
+    uint64_t queue_wait_us;
+    uint64_t max_queue_wait_us;
+    uint64_t busy_us;
+    uint64_t first_op_us;
+    uint64_t executing_since_us;
+  };
+
+  static void enqueue_op(uint16_t conn_id, gatt_operation op);
   static void mark_as_not_executing(uint16_t conn_id);
   static void gatt_execute_next_op(uint16_t conn_id);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
@@ -92,4 +107,6 @@ class BtaGattQueue {
   static std::unordered_map<uint16_t, std::list<gatt_operation>> gatt_op_queue;
   // contain connection ids that currently execute operations
   static std::unordered_set<uint16_t> gatt_op_queue_executing;
+  // maps connection id to its queue statistics
+  static std::unordered_map<uint16_t, gatt_queue_stats> gatt_op_queue_stats;
 };
@@ -52,7 +52,7 @@ typedef struct {
  * Returns          void.
  *
  ******************************************************************************/
-void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len);
+void bta_hh_co_data(uint8_t dev_handle, const uint8_t* p_rpt, uint16_t len);
 
 /*******************************************************************************
  *
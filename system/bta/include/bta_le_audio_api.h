@@ -33,7 +33,8 @@ class LeAudioHalVerifier {
 };
 
 typedef bool(LeAudioIsoDataCallback)(const RawAddress& address,
-                                     uint16_t cis_conn_hdl, uint8_t* data,
+                                     uint16_t cis_conn_hdl,
+                                     const uint8_t* data,
                                      uint16_t size, uint32_t timestamp);
 /* Interface class */
 class LeAudioClient {
@@ -31,6 +31,7 @@
 #include "common/time_util.h"
 #include "gd/hal/link_clocker.h"
 #include "os/log.h"
+#include "osi/include/thread_scheduler.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/main_thread.h"
 
@@ -254,7 +255,8 @@ bool SourceImpl::InitAudioSinkThread() {
   }
 
   /* Schedule the rest of the operations */
-  if (!worker_thread_->EnableRealTimeScheduling()) {
+  if (!thread_scheduler_apply_policy(worker_thread_->GetLinuxTid(),
+                                     ThreadRole::LE_AUDIO_SOURCE)) {
 #if defined(__ANDROID__)
     log::fatal("Failed to increase media thread priority");
 #endif
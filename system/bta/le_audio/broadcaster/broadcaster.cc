@@ -19,6 +19,7 @@
 #include <bluetooth/log.h>
 #include <lc3.h>
 
+#include <chrono>
 #include <mutex>
 
 #include "bta/include/bta_le_audio_broadcaster_api.h"
@@ -916,6 +917,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       auto& broadcast = broadcast_pair.second;
       if (broadcast) stream << *broadcast;
     }
+    audio_receiver_.Dump(stream);
 
     dprintf(fd, "%s", stream.str().c_str());
   }
@@ -1140,6 +1142,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
       auto const& codec_id = subgroup_config.GetLeAudioCodecId();
       /* TODO: We should act smart and reuse current configurations */
+      sw_enc_channels_.clear();
       sw_enc_.clear();
       while (sw_enc_.size() != subgroup_config.GetNumChannelsTotal()) {
         auto codec =
@@ -1156,13 +1159,42 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         sw_enc_.emplace_back(std::move(codec));
       }
 
+      /* Each BIS channel is encoded into its own span of the encoded frame */
+      const size_t num_bis =
+          std::min<size_t>(subgroup_config.GetNumBis(), sw_enc_.size());
+      const auto bytes_per_sample = (subgroup_config.GetBitsPerSample() / 8);
+
+      size_t encoded_frame_size = 0;
+      for (uint8_t bis_idx = 0; bis_idx < num_bis; ++bis_idx) {
+        encoded_frame_size +=
+            subgroup_config.GetBisOctetsPerCodecFrame(bis_idx);
+      }
+      encoded_frame_.assign(encoded_frame_size, 0);
+
+      uint8_t* out = encoded_frame_.data();
+      for (uint8_t bis_idx = 0; bis_idx < num_bis; ++bis_idx) {
+        auto out_size = subgroup_config.GetBisOctetsPerCodecFrame(bis_idx);
+        sw_enc_channels_.push_back({
+            .codec = sw_enc_[bis_idx].get(),
+            .pcm_offset = size_t(bis_idx * bytes_per_sample),
+            .out = out,
+            .out_size = out_size,
+        });
+        out += out_size;
+      }
+
+      if (!batch_encoder_) {
+        batch_encoder_ =
+            std::make_unique<bluetooth::le_audio::CodecBatchEncoder>();
+      }
+
       broadcast_config_ = broadcast_config;
     }
 
     static void sendBroadcastData(
         const std::unique_ptr<BroadcastStateMachine>& broadcast,
-        std::vector<std::unique_ptr<bluetooth::le_audio::CodecInterface>>&
-            encoders) {
+        const std::vector<bluetooth::le_audio::CodecBatchEncoder::Channel>&
+            channels) {
       auto const& config = broadcast->GetBigConfig();
       if (config == std::nullopt) {
         log::error(
@@ -1172,16 +1204,15 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         return;
       }
 
-      if (config->connection_handles.size() < encoders.size()) {
+      if (config->connection_handles.size() < channels.size()) {
         log::error("Not enough BIS'es to broadcast all channels!");
         return;
       }
 
-      for (uint8_t chan = 0; chan < encoders.size(); ++chan) {
-        IsoManager::GetInstance()->SendIsoData(
-            config->connection_handles[chan],
-            (const uint8_t*)encoders[chan]->GetDecodedSamples().data(),
-            encoders[chan]->GetDecodedSamples().size() * 2);
+      for (uint8_t chan = 0; chan < channels.size(); ++chan) {
+        IsoManager::GetInstance()->SendIsoData(config->connection_handles[chan],
+                                               channels[chan].out,
+                                               channels[chan].out_size);
       }
     }
 
@@ -1202,17 +1233,12 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
        */
       auto const& subgroup_config = broadcast_config_->subgroups.at(0);
 
-      /* Constants for the channel data configuration */
-      const auto num_bis = subgroup_config.GetNumBis();
-      const auto bytes_per_sample = (subgroup_config.GetBitsPerSample() / 8);
-
-      /* Prepare encoded data for all channels */
-      for (uint8_t bis_idx = 0; bis_idx < num_bis; ++bis_idx) {
-        auto initial_channel_offset = bis_idx * bytes_per_sample;
-        sw_enc_[bis_idx]->Encode(
-            data.data() + initial_channel_offset, num_bis,
-            subgroup_config.GetBisOctetsPerCodecFrame(bis_idx));
-      }
+      /* Prepare encoded data for all channels, in one batch, which should
+       * take less than the SDU interval to keep up with the stream.
+       */
+      batch_encoder_->Encode(
+          data.data(), subgroup_config.GetNumBis(), sw_enc_channels_,
+          std::chrono::microseconds(broadcast_config_->GetSduIntervalUs()));
 
       /* Currently there is no way to broadcast multiple distinct streams.
        * We just receive all system sounds mixed into a one stream and each
@@ -1223,7 +1249,7 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         if ((broadcast->GetState() ==
              BroadcastStateMachine::State::STREAMING) &&
             !broadcast->IsMuted())
-          sendBroadcastData(broadcast, sw_enc_);
+          sendBroadcastData(broadcast, sw_enc_channels_);
       }
       log::verbose("All data sent.");
     }
@@ -1269,9 +1295,28 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       }
     }
 
+    void Dump(std::stringstream& stream) const {
+      if (!batch_encoder_) return;
+
+      auto stats = batch_encoder_->GetStats();
+      stream << "    Software encoder:\n"
+             << "      Encoded frames: " << stats.num_batches << "\n"
+             << "      Deadline misses: " << stats.num_deadline_misses << "\n"
+             << "      Encode time [us]: last " << stats.last_encode_time.count()
+             << ", avg "
+             << (stats.num_batches
+                     ? stats.total_encode_time.count() / stats.num_batches
+                     : 0)
+             << ", max " << stats.max_encode_time.count() << "\n";
+    }
+
    private:
     std::optional<BroadcastConfiguration> broadcast_config_;
     std::vector<std::unique_ptr<bluetooth::le_audio::CodecInterface>> sw_enc_;
+    std::unique_ptr<bluetooth::le_audio::CodecBatchEncoder> batch_encoder_;
+    std::vector<bluetooth::le_audio::CodecBatchEncoder::Channel>
+        sw_enc_channels_;
+    std::vector<uint8_t> encoded_frame_;
   } audio_receiver_;
 
   bluetooth::le_audio::LeAudioBroadcasterCallbacks* callbacks_;
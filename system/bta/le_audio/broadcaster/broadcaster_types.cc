@@ -162,8 +162,77 @@ static void EmitSubgroup(const BasicAudioAnnouncementSubgroup& subgroup_config,
   EmitBisConfigs(subgroup_config.bis_configs, data);
 }
 
-bool ToRawPacket(BasicAudioAnnouncementData const& in,
-                 std::vector<uint8_t>& data) {
+static bool IsSameLtvs(
+    const std::map<uint8_t, std::vector<uint8_t>>& lhs,
+    const std::optional<std::vector<uint8_t>>& lhs_vendor,
+    const std::map<uint8_t, std::vector<uint8_t>>& rhs,
+    const std::optional<std::vector<uint8_t>>& rhs_vendor) {
+  return lhs == rhs && lhs_vendor == rhs_vendor;
+}
+
+static bool IsSameSubgroup(const BasicAudioAnnouncementSubgroup& lhs,
+                           const BasicAudioAnnouncementSubgroup& rhs) {
+  if (lhs.codec_config.codec_id != rhs.codec_config.codec_id ||
+      lhs.codec_config.vendor_company_id !=
+          rhs.codec_config.vendor_company_id ||
+      lhs.codec_config.vendor_codec_id != rhs.codec_config.vendor_codec_id)
+    return false;
+
+  if (!IsSameLtvs(lhs.codec_config.codec_specific_params,
+                  lhs.codec_config.vendor_codec_specific_params,
+                  rhs.codec_config.codec_specific_params,
+                  rhs.codec_config.vendor_codec_specific_params))
+    return false;
+
+  if (lhs.metadata != rhs.metadata) return false;
+
+  if (lhs.bis_configs.size() != rhs.bis_configs.size()) return false;
+  for (auto i = 0lu; i < lhs.bis_configs.size(); ++i) {
+    auto& lhs_bis_config = lhs.bis_configs[i];
+    auto& rhs_bis_config = rhs.bis_configs[i];
+    if (lhs_bis_config.bis_index != rhs_bis_config.bis_index) return false;
+    if (!IsSameLtvs(lhs_bis_config.codec_specific_params,
+                    lhs_bis_config.vendor_codec_specific_params,
+                    rhs_bis_config.codec_specific_params,
+                    rhs_bis_config.vendor_codec_specific_params))
+      return false;
+  }
+  return true;
+}
+
+static void EmitSubgroups(
+    const std::vector<BasicAudioAnnouncementSubgroup>& subgroup_configs,
+    std::vector<uint8_t>& data, BasicAudioAnnouncementCache* cache) {
+  if (cache == nullptr) {
+    for (const auto& subgroup_config : subgroup_configs) {
+      // That's the level 2 and higher level data
+      EmitSubgroup(subgroup_config, data);
+    }
+    return;
+  }
+
+  std::vector<std::vector<uint8_t>> raw_subgroups;
+  raw_subgroups.reserve(subgroup_configs.size());
+  for (auto i = 0lu; i < subgroup_configs.size(); ++i) {
+    if (i < cache->subgroups.size() &&
+        IsSameSubgroup(subgroup_configs[i], cache->subgroups[i])) {
+      raw_subgroups.push_back(std::move(cache->raw_subgroups[i]));
+    } else {
+      std::vector<uint8_t> raw_subgroup;
+      EmitSubgroup(subgroup_configs[i], raw_subgroup);
+      raw_subgroups.push_back(std::move(raw_subgroup));
+    }
+    data.insert(data.end(), raw_subgroups.back().begin(),
+                raw_subgroups.back().end());
+  }
+
+  cache->subgroups = subgroup_configs;
+  cache->raw_subgroups = std::move(raw_subgroups);
+}
+
+static bool ToRawPacket(BasicAudioAnnouncementData const& in,
+                        std::vector<uint8_t>& data,
+                        BasicAudioAnnouncementCache* cache) {
   EmitHeader(in, data);
 
   // Set the cursor behind the old data and resize
@@ -174,14 +243,16 @@ bool ToRawPacket(BasicAudioAnnouncementData const& in,
   // Emit the subgroup size and each subgroup
   // That's the level 1 Num_Subgroups
   UINT8_TO_STREAM(p_value, in.subgroup_configs.size());
-  for (const auto& subgroup_config : in.subgroup_configs) {
-    // That's the level 2 and higher level data
-    EmitSubgroup(subgroup_config, data);
-  }
+  EmitSubgroups(in.subgroup_configs, data, cache);
 
   return true;
 }
 
+bool ToRawPacket(BasicAudioAnnouncementData const& in,
+                 std::vector<uint8_t>& data) {
+  return ToRawPacket(in, data, nullptr);
+}
+
 void PrepareAdvertisingData(
     bool is_public, const std::string& broadcast_name,
     bluetooth::le_audio::BroadcastId& broadcast_id,
@@ -219,8 +290,9 @@ void PrepareAdvertisingData(
   }
 }
 
-void PreparePeriodicData(const BasicAudioAnnouncementData& announcement,
-                         std::vector<uint8_t>& periodic_data) {
+static void PreparePeriodicData(const BasicAudioAnnouncementData& announcement,
+                                std::vector<uint8_t>& periodic_data,
+                                BasicAudioAnnouncementCache* cache) {
   /* Account for AD Type + Service UUID */
   periodic_data.resize(4);
   /* Skip the data length field until the full content is generated */
@@ -229,13 +301,24 @@ void PreparePeriodicData(const BasicAudioAnnouncementData& announcement,
   UINT16_TO_STREAM(data_ptr, kBasicAudioAnnouncementServiceUuid);
 
   /* Append the announcement */
-  ToRawPacket(announcement, periodic_data);
+  ToRawPacket(announcement, periodic_data, cache);
 
   /* Update the length field accordingly */
   data_ptr = periodic_data.data();
   UINT8_TO_STREAM(data_ptr, periodic_data.size() - 1);
 }
 
+void PreparePeriodicData(const BasicAudioAnnouncementData& announcement,
+                         std::vector<uint8_t>& periodic_data) {
+  PreparePeriodicData(announcement, periodic_data, nullptr);
+}
+
+void PreparePeriodicData(const BasicAudioAnnouncementData& announcement,
+                         std::vector<uint8_t>& periodic_data,
+                         BasicAudioAnnouncementCache& cache) {
+  PreparePeriodicData(announcement, periodic_data, &cache);
+}
+
 le_audio::LeAudioCodecConfiguration
 BroadcastConfiguration::GetAudioHalClientConfig() const {
   return {
@@ -52,6 +52,19 @@ void PreparePeriodicData(
     const bluetooth::le_audio::BasicAudioAnnouncementData& announcement,
     std::vector<uint8_t>& periodic_data);
 
+/* Encoded subgroups of the last prepared Basic Audio Announcement. The
+ * subgroups which did not change since the previous update are copied from
+ * the cache instead of being encoded again.
+ */
+struct BasicAudioAnnouncementCache {
+  std::vector<bluetooth::le_audio::BasicAudioAnnouncementSubgroup> subgroups;
+  std::vector<std::vector<uint8_t>> raw_subgroups;
+};
+
+void PreparePeriodicData(
+    const bluetooth::le_audio::BasicAudioAnnouncementData& announcement,
+    std::vector<uint8_t>& periodic_data, BasicAudioAnnouncementCache& cache);
+
 struct BroadcastSubgroupBisCodecConfig {
   BroadcastSubgroupBisCodecConfig(
       uint8_t num_bis, uint8_t bis_channel_cnt,
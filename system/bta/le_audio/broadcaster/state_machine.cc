@@ -213,9 +213,17 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   void UpdateBroadcastAnnouncement(
       bluetooth::le_audio::BasicAudioAnnouncementData announcement) override {
     std::vector<uint8_t> periodic_data;
-    PreparePeriodicData(announcement, periodic_data);
+    PreparePeriodicData(announcement, periodic_data, announcement_cache_);
 
     sm_config_.announcement = std::move(announcement);
+    /* Do not re-send the periodic advertising train data if the encoded
+     * announcement did not change.
+     */
+    if (periodic_data == periodic_data_) {
+      log::verbose("broadcast_id={}, announcement unchanged", GetBroadcastId());
+      return;
+    }
+    periodic_data_ = periodic_data;
     advertiser_if_->SetPeriodicAdvertisingData(advertising_sid_, periodic_data,
                                                base::DoNothing());
   }
@@ -243,6 +251,9 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
   std::optional<BigConfig> active_config_;
   BroadcastStateMachineConfig sm_config_;
   bool suspending_;
+  /* Last periodic advertising data, and its encoded subgroups */
+  std::vector<uint8_t> periodic_data_;
+  BasicAudioAnnouncementCache announcement_cache_;
 
   /* Message handlers for each possible state */
   typedef std::function<void(const void*)> msg_handler_t;
@@ -347,7 +358,8 @@ class BroadcastStateMachineImpl : public BroadcastStateMachine {
 
       PrepareAdvertisingData(is_public, broadcast_name, broadcast_id,
                              public_announcement, adv_data);
-      PreparePeriodicData(announcement, periodic_data);
+      PreparePeriodicData(announcement, periodic_data, announcement_cache_);
+      periodic_data_ = periodic_data;
 
       adv_params.min_interval = 0x00A0; /* 160 * 0,625 = 100ms */
       adv_params.max_interval = 0x0140; /* 320 * 0,625 = 200ms */
@@ -518,6 +518,40 @@ TEST_F(StateMachineTest, UpdateAnnouncement) {
             second_len);
 }
 
+TEST_F(StateMachineTest, UpdateAnnouncementUnchanged) {
+  EXPECT_CALL(*(sm_callbacks_.get()), OnStateMachineCreateStatus(_, true))
+      .Times(1);
+
+  auto broadcast_id = InstantiateStateMachine();
+  auto adv_sid = broadcasts_[broadcast_id]->GetAdvertisingSid();
+  std::vector<uint8_t> data;
+  EXPECT_CALL(*mock_ble_advertising_manager_,
+              SetPeriodicAdvertisingData(adv_sid, _, _))
+      .Times(2)
+      .WillRepeatedly(SaveArg<1>(&data));
+
+  std::map<uint8_t, std::vector<uint8_t>> metadata = {};
+  auto codec_config = lc3_mono_16_2;
+  broadcasts_[broadcast_id]->UpdateBroadcastAnnouncement(
+      prepareAnnouncement(codec_config, metadata));
+  auto first_data = data;
+
+  // The same announcement is not sent again
+  broadcasts_[broadcast_id]->UpdateBroadcastAnnouncement(
+      prepareAnnouncement(codec_config, metadata));
+
+  // A changed subgroup is still encoded and sent
+  metadata = {{0x01, {0x03}}};
+  broadcasts_[broadcast_id]->UpdateBroadcastAnnouncement(
+      prepareAnnouncement(codec_config, metadata));
+  ASSERT_NE(first_data, data);
+
+  std::vector<uint8_t> expected_data;
+  PreparePeriodicData(prepareAnnouncement(codec_config, metadata),
+                      expected_data);
+  ASSERT_EQ(expected_data, data);
+}
+
 TEST_F(StateMachineTest, ProcessMessageStartWhenConfigured) {
   EXPECT_CALL(*(sm_callbacks_.get()), OnStateMachineCreateStatus(_, true))
       .Times(1);
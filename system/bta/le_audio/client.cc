@@ -25,6 +25,7 @@
 #include <map>
 #include <mutex>
 #include <optional>
+#include <unordered_map>
 
 #include "audio_hal_client/audio_hal_client.h"
 #include "audio_hal_interface/le_audio_software.h"
@@ -53,8 +54,10 @@
 #include "main/shim/entry.h"
 #include "metrics_collector.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 #include "osi/include/osi.h"
 #include "osi/include/properties.h"
+#include "sink_jitter_buffer.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_types.h"
@@ -93,6 +96,7 @@ using bluetooth::le_audio::LeAudioHealthStatus;
 using bluetooth::le_audio::LeAudioRecommendationActionCb;
 using bluetooth::le_audio::LeAudioSinkAudioHalClient;
 using bluetooth::le_audio::LeAudioSourceAudioHalClient;
+using bluetooth::le_audio::SinkJitterBuffer;
 using bluetooth::le_audio::UnicastMonitorModeStatus;
 using bluetooth::le_audio::types::ase;
 using bluetooth::le_audio::types::AseState;
@@ -556,6 +560,9 @@ class LeAudioClientImpl : public LeAudioClient {
       /* All the configurations should be recalculated for the new conditions */
       group->InvalidateCachedConfigurations();
       group->InvalidateGroupStrategy();
+      if (osi_property_get_bool(kPrecomputeConfigurationsProp, false)) {
+        group->PrecomputeConfigurations();
+      }
       callbacks_->OnAudioConf(group->audio_directions_, group->group_id_,
                               group->snk_audio_locations_.to_ulong(),
                               group->src_audio_locations_.to_ulong(),
@@ -799,7 +806,9 @@ class LeAudioClientImpl : public LeAudioClient {
      * Ideally, we should send all the bits we have, but not all headsets like
      * it.
      */
-    if (osi_property_get_bool(kAllowMultipleContextsInMetadata, true)) {
+    static bluetooth::os::CachedSystemPropertyBool allow_multiple_contexts(
+        kAllowMultipleContextsInMetadata, true);
+    if (allow_multiple_contexts.Get()) {
       return metadata_context_type;
     }
 
@@ -1791,6 +1800,7 @@ class LeAudioClientImpl : public LeAudioClient {
     if (ase) {
       groupStateMachine_->ProcessGattNotifEvent(value, len, ase, leAudioDevice,
                                                 group);
+      InvalidateCisSourceRoutes();
 
       return;
     }
@@ -1970,6 +1980,7 @@ class LeAudioClientImpl : public LeAudioClient {
       }
     } else if (hdl == leAudioDevice->ctp_hdls_.val_hdl) {
       groupStateMachine_->ProcessGattCtpNotification(group, value, len);
+      InvalidateCisSourceRoutes();
     } else if (hdl == leAudioDevice->tmap_role_hdl_) {
       bluetooth::le_audio::client_parser::tmap::ParseTmapRole(
           leAudioDevice->tmap_role_, len, value);
@@ -2432,6 +2443,7 @@ class LeAudioClientImpl : public LeAudioClient {
     leAudioDevice->acl_phy_update_done_ = false;
 
     groupStateMachine_->ProcessHciNotifAclDisconnected(group, leAudioDevice);
+    InvalidateCisSourceRoutes();
 
     bluetooth::le_audio::MetricsCollector::Get()->OnConnectionStateChanged(
         leAudioDevice->group_id_, address, ConnectionState::DISCONNECTED,
@@ -3338,10 +3350,10 @@ class LeAudioClientImpl : public LeAudioClient {
     return true;
   }
 
-  // mix stero signal into mono
-  std::vector<uint8_t> mono_blend(const std::vector<uint8_t>& buf,
-                                  int bytes_per_sample, size_t frames) {
-    std::vector<uint8_t> mono_out;
+  // mix stero signal into mono, the returned buffer is reused by the next call
+  const std::vector<uint8_t>& mono_blend(const std::vector<uint8_t>& buf,
+                                         int bytes_per_sample, size_t frames) {
+    std::vector<uint8_t>& mono_out = mono_data_;
     mono_out.resize(frames * bytes_per_sample);
 
     if (bytes_per_sample == 2) {
@@ -3370,6 +3382,43 @@ class LeAudioClientImpl : public LeAudioClient {
     return mono_out;
   }
 
+  // Prepare the encoded frame of `num_channels` channels of `byte_count`
+  // bytes, encoded side by side, and return the channel spans to be filled.
+  std::vector<bluetooth::le_audio::CodecBatchEncoder::Channel>&
+  PrepareEncodedFrame(uint16_t num_channels, uint16_t byte_count) {
+    if (encoded_data.size() < size_t(num_channels) * byte_count) {
+      encoded_data.resize(num_channels * byte_count);
+    }
+    sw_enc_channels_.clear();
+    return sw_enc_channels_;
+  }
+
+  /* Output of a codec frame for an ISO handle, its SDU buffer when the ISO
+   * manager lets it be written in place, the fallback buffer otherwise.
+   */
+  uint8_t* AcquireSduOrFallback(uint16_t cis_handle, uint16_t byte_count,
+                                uint8_t* fallback, bool* in_place) {
+    uint8_t* sdu =
+        cis_handle
+            ? IsoManager::GetInstance()->AcquireIsoSdu(cis_handle, byte_count)
+            : nullptr;
+    *in_place = (sdu != nullptr);
+    return *in_place ? sdu : fallback;
+  }
+
+  void SendSdu(uint16_t cis_handle, const uint8_t* out, uint16_t byte_count,
+               bool in_place) {
+    if (!cis_handle) return;
+
+    if (in_place) {
+      IsoManager::GetInstance()->SendIsoSdu(cis_handle);
+      sdu_stats_.num_in_place++;
+    } else {
+      IsoManager::GetInstance()->SendIsoData(cis_handle, out, byte_count);
+      sdu_stats_.num_copied++;
+    }
+  }
+
   void PrepareAndSendToTwoCises(
       const std::vector<uint8_t>& data,
       const struct bluetooth::le_audio::stream_parameters& stream_params) {
@@ -3397,35 +3446,39 @@ class LeAudioClientImpl : public LeAudioClient {
 
     uint16_t byte_count = stream_params.octets_per_codec_frame;
     bool mix_to_mono = (left_cis_handle == 0) || (right_cis_handle == 0);
-    if (mix_to_mono) {
-      std::vector<uint8_t> mono = mono_blend(
-          data, bytes_per_sample, number_of_required_samples_per_channel);
-      if (left_cis_handle) {
-        sw_enc_left->Encode(mono.data(), 1, byte_count);
-      }
-
-      if (right_cis_handle) {
-        sw_enc_left->Encode(mono.data(), 1, byte_count);
-      }
-    } else {
-      sw_enc_left->Encode(data.data(), 2, byte_count);
-      sw_enc_right->Encode(data.data() + bytes_per_sample, 2, byte_count);
-    }
+    auto& channels = PrepareEncodedFrame(2, byte_count);
 
     log::debug("left_cis_handle: {} right_cis_handle: {}", left_cis_handle,
                right_cis_handle);
-    /* Send data to the controller */
-    if (left_cis_handle)
-      IsoManager::GetInstance()->SendIsoData(
-          left_cis_handle,
-          (const uint8_t*)sw_enc_left->GetDecodedSamples().data(),
-          sw_enc_left->GetDecodedSamples().size() * 2);
+    if (mix_to_mono) {
+      /* A single CIS is connected, it gets the mono frame */
+      uint16_t cis_handle = left_cis_handle ? left_cis_handle : right_cis_handle;
+      bool in_place;
+      uint8_t* out = AcquireSduOrFallback(cis_handle, byte_count,
+                                          encoded_data.data(), &in_place);
+      const auto& mono = mono_blend(data, bytes_per_sample,
+                                    number_of_required_samples_per_channel);
+      channels.push_back({sw_enc_left.get(), 0, out, byte_count});
+      sw_enc_batch_.Encode(mono.data(), 1, channels);
+      SendSdu(cis_handle, out, byte_count, in_place);
+      return;
+    }
+
+    /* Both channels are encoded straight into the SDUs of their CIS */
+    bool left_in_place, right_in_place;
+    uint8_t* left_out = AcquireSduOrFallback(
+        left_cis_handle, byte_count, encoded_data.data(), &left_in_place);
+    uint8_t* right_out =
+        AcquireSduOrFallback(right_cis_handle, byte_count,
+                             encoded_data.data() + byte_count, &right_in_place);
+    channels.push_back({sw_enc_left.get(), 0, left_out, byte_count});
+    channels.push_back(
+        {sw_enc_right.get(), bytes_per_sample, right_out, byte_count});
+    sw_enc_batch_.Encode(data.data(), 2, channels);
 
-    if (right_cis_handle)
-      IsoManager::GetInstance()->SendIsoData(
-          right_cis_handle,
-          (const uint8_t*)sw_enc_right->GetDecodedSamples().data(),
-          sw_enc_right->GetDecodedSamples().size() * 2);
+    /* Send data to the controller */
+    SendSdu(left_cis_handle, left_out, byte_count, left_in_place);
+    SendSdu(right_cis_handle, right_out, byte_count, right_in_place);
   }
 
   void PrepareAndSendToSingleCis(
@@ -3445,22 +3498,27 @@ class LeAudioClientImpl : public LeAudioClient {
 
     uint16_t byte_count = stream_params.octets_per_codec_frame;
     bool mix_to_mono = (num_channels == 1);
+    auto& channels = PrepareEncodedFrame(2, byte_count);
+    uint16_t sdu_len = (mix_to_mono ? 1 : 2) * byte_count;
+    bool in_place;
+    uint8_t* out = AcquireSduOrFallback(cis_handle, sdu_len,
+                                        encoded_data.data(), &in_place);
     if (mix_to_mono) {
       /* Since we always get two channels from framework, lets make it mono here
        */
-      std::vector<uint8_t> mono = mono_blend(
-          data, bytes_per_sample, number_of_required_samples_per_channel);
-      sw_enc_left->Encode(mono.data(), 1, byte_count);
+      const auto& mono = mono_blend(data, bytes_per_sample,
+                                    number_of_required_samples_per_channel);
+      channels.push_back({sw_enc_left.get(), 0, out, byte_count});
+      sw_enc_batch_.Encode(mono.data(), 1, channels);
     } else {
-      sw_enc_left->Encode((const uint8_t*)data.data(), 2, byte_count);
-      // Output to the left channel buffer with `byte_count` offset
-      sw_enc_right->Encode((const uint8_t*)data.data() + 2, 2, byte_count,
-                           &sw_enc_left->GetDecodedSamples(), byte_count);
+      // Both channels are encoded one after the other, in a single SDU
+      channels.push_back({sw_enc_left.get(), 0, out, byte_count});
+      channels.push_back(
+          {sw_enc_right.get(), bytes_per_sample, out + byte_count, byte_count});
+      sw_enc_batch_.Encode(data.data(), 2, channels);
     }
 
-    IsoManager::GetInstance()->SendIsoData(
-        cis_handle, (const uint8_t*)sw_enc_left->GetDecodedSamples().data(),
-        sw_enc_left->GetDecodedSamples().size() * 2);
+    SendSdu(cis_handle, out, sdu_len, in_place);
   }
 
   const struct bluetooth::le_audio::stream_configuration*
@@ -3487,7 +3545,7 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
-    auto stream_conf = group->stream_conf;
+    const auto& stream_conf = group->stream_conf;
     if ((stream_conf.stream_params.sink.num_of_devices > 2) ||
         (stream_conf.stream_params.sink.num_of_devices == 0) ||
         stream_conf.stream_params.sink.stream_locations.empty()) {
@@ -3505,26 +3563,57 @@ class LeAudioClientImpl : public LeAudioClient {
     }
   }
 
+  void SetupSinkJitterBuffer() {
+    int32_t min_ms = osi_property_get_int32(kSinkJitterBufferMinMsProp, 0);
+    if (min_ms <= 0) return;
+
+    int32_t max_ms = std::max(
+        min_ms, osi_property_get_int32(kSinkJitterBufferMaxMsProp,
+                                       kSinkJitterBufferDefaultMaxMs));
+    SinkJitterBuffer::Config config = {
+        .frame_interval_us = current_decoder_config_.data_interval_us,
+        .min_headroom_us = static_cast<uint32_t>(min_ms) * 1000,
+        .max_headroom_us = static_cast<uint32_t>(max_ms) * 1000,
+    };
+    log::info("Sink jitter buffer headroom: {} - {} ms", min_ms, max_ms);
+    sink_jitter_buffer_ = std::make_unique<SinkJitterBuffer>(config);
+  }
+
+  void ReleaseSinkJitterBuffer() {
+    if (!sink_jitter_buffer_) return;
+
+    const auto& stats = sink_jitter_buffer_->GetStats();
+    LeAudioLogHistory::Get()->AddLogHistory(
+        kLogIsoDataTag, active_group_id_, RawAddress::kEmpty,
+        kLogJitterBufferStatsOp,
+        "sdus: " + std::to_string(stats.num_sdus) +
+            ", lost: " + std::to_string(stats.num_lost) +
+            ", padded: " + std::to_string(stats.num_padded) +
+            ", dropped: " + std::to_string(stats.num_dropped) +
+            ", underruns: " + std::to_string(stats.num_underruns) +
+            ", jitter_us: " + std::to_string(stats.jitter_us) +
+            ", target_us: " + std::to_string(stats.target_headroom_us));
+    sink_jitter_buffer_.reset();
+  }
+
   void CleanCachedMicrophoneData() {
     cached_channel_timestamp_ = 0;
     cached_channel_ = nullptr;
+    InvalidateCisSourceRoutes();
   }
 
-  /* Handles audio data packets coming from the controller */
-  void HandleIncomingCisData(uint8_t* data, uint16_t size,
-                             uint16_t cis_conn_hdl, uint32_t timestamp) {
-    /* Get only one channel for MONO microphone */
-    /* Gather data for channel */
-    if ((active_group_id_ == bluetooth::groups::kGroupUnknown) ||
-        (audio_receiver_state_ != AudioState::STARTED))
-      return;
+  /* Where the SDUs received on a source CIS go */
+  struct CisSourceRoute {
+    bluetooth::le_audio::CodecInterface* decoder;
+    /* Whether there is no CIS for the other channel to wait for */
+    bool mono;
+  };
 
-    LeAudioDeviceGroup* group = aseGroups_.FindById(active_group_id_);
-    if (!group) {
-      log::error("There is no streaming group available");
-      return;
-    }
+  void InvalidateCisSourceRoutes() {
+    cis_source_routes_group_id_ = bluetooth::groups::kGroupUnknown;
+  }
 
+  void BuildCisSourceRoutes(LeAudioDeviceGroup* group) {
     uint16_t left_cis_handle = 0;
     uint16_t right_cis_handle = 0;
     for (auto [cis_handle, audio_location] :
@@ -3539,20 +3628,60 @@ class LeAudioClientImpl : public LeAudioClient {
       }
     }
 
-    auto decoder = sw_dec_left.get();
-    if (cis_conn_hdl == left_cis_handle) {
-      decoder = sw_dec_left.get();
-    } else if (cis_conn_hdl == right_cis_handle) {
-      decoder = sw_dec_right.get();
-    } else {
+    bool mono = !left_cis_handle || !right_cis_handle;
+    cis_source_routes_.clear();
+    if (left_cis_handle) {
+      cis_source_routes_.emplace(
+          left_cis_handle, CisSourceRoute{sw_dec_left.get(), mono});
+    }
+    if (right_cis_handle) {
+      cis_source_routes_.emplace(
+          right_cis_handle, CisSourceRoute{sw_dec_right.get(), mono});
+    }
+    cis_source_routes_group_id_ = group->group_id_;
+  }
+
+  const CisSourceRoute* FindCisSourceRoute(uint16_t cis_conn_hdl) {
+    if (cis_source_routes_group_id_ == active_group_id_) {
+      auto route = cis_source_routes_.find(cis_conn_hdl);
+      if (route != cis_source_routes_.end()) return &route->second;
+    }
+
+    /* Stale routes or a CIS not seen yet, look at the stream configuration */
+    LeAudioDeviceGroup* group = aseGroups_.FindById(active_group_id_);
+    if (!group) {
+      log::error("There is no streaming group available");
+      return nullptr;
+    }
+
+    BuildCisSourceRoutes(group);
+    auto route = cis_source_routes_.find(cis_conn_hdl);
+    if (route == cis_source_routes_.end()) {
       log::error("Received data for unknown handle: {:04x}", cis_conn_hdl);
-      return;
+      return nullptr;
     }
+    return &route->second;
+  }
+
+  /* Handles audio data packets coming from the controller */
+  void HandleIncomingCisData(const uint8_t* data, uint16_t size,
+                             uint16_t cis_conn_hdl, uint32_t timestamp) {
+    /* Get only one channel for MONO microphone */
+    /* Gather data for channel */
+    if ((active_group_id_ == bluetooth::groups::kGroupUnknown) ||
+        (audio_receiver_state_ != AudioState::STARTED))
+      return;
 
-    if (!left_cis_handle || !right_cis_handle) {
+    const CisSourceRoute* route = FindCisSourceRoute(cis_conn_hdl);
+    if (!route) return;
+
+    auto decoder = route->decoder;
+    if (route->mono) {
       /* mono or just one device connected */
+      auto action = OnSinkSdu(timestamp);
+      SendConcealedAudioDataToAF(decoder, nullptr, action.num_concealed);
       decoder->Decode(data, size);
-      SendAudioDataToAF(&decoder->GetDecodedSamples());
+      if (action.write_frame) SendAudioDataToAF(&decoder->GetDecodedSamples());
       return;
     }
     /* both devices are connected */
@@ -3572,10 +3701,16 @@ class LeAudioClientImpl : public LeAudioClient {
     if (cached_channel_ != decoder) {
       /* It's data for the 2nd channel */
       if (timestamp == cached_channel_timestamp_) {
-        /* Ready to mix data and send out to AF */
+        /* Ready to mix data and send out to AF. The cached channel is already
+         * decoded, so the concealed frames can only follow this one. */
         decoder->Decode(data, size);
-        SendAudioDataToAF(&sw_dec_left->GetDecodedSamples(),
-                          &sw_dec_right->GetDecodedSamples());
+        auto action = OnSinkSdu(timestamp);
+        if (action.write_frame) {
+          SendAudioDataToAF(&sw_dec_left->GetDecodedSamples(),
+                            &sw_dec_right->GetDecodedSamples());
+        }
+        SendConcealedAudioDataToAF(sw_dec_left.get(), sw_dec_right.get(),
+                                   action.num_concealed);
 
         CleanCachedMicrophoneData();
         return;
@@ -3584,7 +3719,9 @@ class LeAudioClientImpl : public LeAudioClient {
       /* 2nd Channel is in the future compared to the cached data.
        Send the cached data to AF, and keep the new channel data in cache.
        This should happen only during stream setup */
-      SendAudioDataToAF(&decoder->GetDecodedSamples());
+      auto action = OnSinkSdu(timestamp);
+      if (action.write_frame) SendAudioDataToAF(&decoder->GetDecodedSamples());
+      SendConcealedAudioDataToAF(decoder, nullptr, action.num_concealed);
 
       decoder->Decode(data, size);
       cached_channel_timestamp_ = timestamp;
@@ -3596,7 +3733,9 @@ class LeAudioClientImpl : public LeAudioClient {
      * data */
 
     /* Send the cached data out */
-    SendAudioDataToAF(&decoder->GetDecodedSamples());
+    auto action = OnSinkSdu(timestamp);
+    if (action.write_frame) SendAudioDataToAF(&decoder->GetDecodedSamples());
+    SendConcealedAudioDataToAF(decoder, nullptr, action.num_concealed);
 
     /* Cache the data in case 2nd channel connects */
     decoder->Decode(data, size);
@@ -3604,6 +3743,30 @@ class LeAudioClientImpl : public LeAudioClient {
     cached_channel_ = decoder;
   }
 
+  /* Accounts the SDU in the sink jitter buffer, if enabled */
+  SinkJitterBuffer::Action OnSinkSdu(uint32_t timestamp) {
+    if (!sink_jitter_buffer_) return {};
+    return sink_jitter_buffer_->OnSdu(
+        bluetooth::common::time_get_os_boottime_us(), timestamp);
+  }
+
+  /* Sends frames produced by the packet loss concealment of the decoders */
+  void SendConcealedAudioDataToAF(bluetooth::le_audio::CodecInterface* left,
+                                  bluetooth::le_audio::CodecInterface* right,
+                                  uint32_t num_frames) {
+    for (uint32_t i = 0; i < num_frames; i++) {
+      left->Decode(nullptr, 0);
+      if (right == nullptr) {
+        SendAudioDataToAF(&left->GetDecodedSamples());
+        continue;
+      }
+
+      right->Decode(nullptr, 0);
+      SendAudioDataToAF(&left->GetDecodedSamples(),
+                        &right->GetDecodedSamples());
+    }
+  }
+
   void SendAudioDataToAF(std::vector<int16_t>* left,
                          std::vector<int16_t>* right = nullptr) {
     uint16_t to_write = 0;
@@ -3810,6 +3973,8 @@ class LeAudioClientImpl : public LeAudioClient {
         groupStateMachine_->StopStream(group);
         return;
       }
+
+      SetupSinkJitterBuffer();
     }
     le_audio_sink_hal_client_->UpdateRemoteDelay(remote_delay_ms);
     ConfirmLocalAudioSinkStreamingRequest();
@@ -3837,6 +4002,7 @@ class LeAudioClientImpl : public LeAudioClient {
     if (sw_enc_right) sw_enc_right.reset();
     if (sw_dec_left) sw_dec_left.reset();
     if (sw_dec_right) sw_dec_right.reset();
+    ReleaseSinkJitterBuffer();
     CleanCachedMicrophoneData();
   }
 
@@ -4065,6 +4231,13 @@ class LeAudioClientImpl : public LeAudioClient {
         kLogAfSuspend + "LocalSource",
         "r_state: " + ToString(audio_receiver_state_) +
             ", s_state: " + ToString(audio_sender_state_));
+    if (sdu_stats_.num_in_place || sdu_stats_.num_copied) {
+      LeAudioLogHistory::Get()->AddLogHistory(
+          kLogIsoDataTag, active_group_id_, RawAddress::kEmpty, kLogSduStatsOp,
+          "in_place: " + std::to_string(sdu_stats_.num_in_place) +
+              ", copied: " + std::to_string(sdu_stats_.num_copied));
+      sdu_stats_ = {};
+    }
 
     /* Note: This callback is from audio hal driver.
      * Bluetooth peer is a Sink for Audio Framework.
@@ -5372,9 +5545,8 @@ class LeAudioClientImpl : public LeAudioClient {
           break;
         }
 
-        HandleIncomingCisData(event->p_msg->data + event->p_msg->offset,
-                              event->p_msg->len - event->p_msg->offset,
-                              event->cis_conn_hdl, event->ts);
+        HandleIncomingCisData(event->sdu, event->sdu_len, event->cis_conn_hdl,
+                              event->ts);
       } break;
       case bluetooth::hci::iso_manager::kIsoEventCisEstablishCmpl: {
         auto* event =
@@ -5425,6 +5597,7 @@ class LeAudioClientImpl : public LeAudioClient {
 
         groupStateMachine_->ProcessHciNotifCisDisconnected(group, leAudioDevice,
                                                            event);
+        InvalidateCisSourceRoutes();
       } break;
       default:
         log::info(", Not handeled ISO event");
@@ -5469,6 +5642,7 @@ class LeAudioClientImpl : public LeAudioClient {
 
     instance->groupStateMachine_->ProcessHciNotifRemoveIsoDataPath(
         group, leAudioDevice, status, conn_handle);
+    InvalidateCisSourceRoutes();
   }
 
   void IsoLinkQualityReadCb(
@@ -5624,6 +5798,7 @@ class LeAudioClientImpl : public LeAudioClient {
         bluetooth::common::ToString(audio_receiver_state_));
     LeAudioDeviceGroup* group = aseGroups_.FindById(group_id);
 
+    InvalidateCisSourceRoutes();
     notifyGroupStreamStatus(group_id, status);
 
     switch (status) {
@@ -5744,6 +5919,7 @@ class LeAudioClientImpl : public LeAudioClient {
         if (sw_enc_right) sw_enc_right.reset();
         if (sw_dec_left) sw_dec_left.reset();
         if (sw_dec_right) sw_dec_right.reset();
+        ReleaseSinkJitterBuffer();
         CleanCachedMicrophoneData();
 
         if (group) {
@@ -5837,6 +6013,7 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
     group->UpdateCisConfiguration(direction);
+    InvalidateCisSourceRoutes();
   }
 
  private:
@@ -5910,13 +6087,35 @@ class LeAudioClientImpl : public LeAudioClient {
   std::unique_ptr<bluetooth::le_audio::CodecInterface> sw_dec_left;
   std::unique_ptr<bluetooth::le_audio::CodecInterface> sw_dec_right;
 
+  /* Unicast streams have at most two channels encoded in turn, there is no
+   * need for workers.
+   */
+  bluetooth::le_audio::CodecBatchEncoder sw_enc_batch_{0};
+  std::vector<bluetooth::le_audio::CodecBatchEncoder::Channel> sw_enc_channels_;
+  /* SDUs encoded in place in the ISO buffers, and those copied there */
+  struct {
+    uint64_t num_in_place = 0;
+    uint64_t num_copied = 0;
+  } sdu_stats_;
   std::vector<uint8_t> encoded_data;
+  std::vector<uint8_t> mono_data_;
   std::unique_ptr<LeAudioSourceAudioHalClient> le_audio_source_hal_client_;
   std::unique_ptr<LeAudioSinkAudioHalClient> le_audio_sink_hal_client_;
   static constexpr uint64_t kAudioSuspentKeepIsoAliveTimeoutMs = 5000;
   static constexpr uint64_t kAudioDisableTimeoutMs = 3000;
   static constexpr char kAudioSuspentKeepIsoAliveTimeoutMsProp[] =
       "persist.bluetooth.leaudio.audio.suspend.timeoutms";
+  /* Match the configurations of all the available contexts up front */
+  static constexpr char kPrecomputeConfigurationsProp[] =
+      "bluetooth.leaudio.precompute_configurations.enabled";
+  /* Bounds of the sink jitter buffer headroom, disabled when the lower one is
+   * not set */
+  static constexpr char kSinkJitterBufferMinMsProp[] =
+      "bluetooth.leaudio.sink_jitter_buffer.min_ms";
+  static constexpr char kSinkJitterBufferMaxMsProp[] =
+      "bluetooth.leaudio.sink_jitter_buffer.max_ms";
+  static constexpr int32_t kSinkJitterBufferDefaultMaxMs = 60;
+  std::unique_ptr<SinkJitterBuffer> sink_jitter_buffer_;
   alarm_t* close_vbc_timeout_;
   alarm_t* suspend_timeout_;
   alarm_t* disable_timer_;
@@ -5925,6 +6124,14 @@ class LeAudioClientImpl : public LeAudioClient {
   uint32_t cached_channel_timestamp_ = 0;
   bluetooth::le_audio::CodecInterface* cached_channel_ = nullptr;
 
+  /* Decoder of each source CIS of the active group, so that the received SDUs
+   * are routed without going through the group stream configuration. Built
+   * from it on the first SDU after a CIS, stream status or decoder change.
+   */
+  std::unordered_map<uint16_t, CisSourceRoute> cis_source_routes_;
+  /* Group the routes were built for, kGroupUnknown once they are stale */
+  int cis_source_routes_group_id_ = bluetooth::groups::kGroupUnknown;
+
   base::WeakPtrFactory<LeAudioClientImpl> weak_factory_{this};
 
   std::map<int, GroupStreamStatus> lastNotifiedGroupStreamStatusMap_;
@@ -5993,19 +6200,12 @@ class LeAudioClientImpl : public LeAudioClient {
     }
 
     uint16_t cis_conn_hdl = event->cis_conn_hdl;
-    uint8_t* data = event->p_msg->data + event->p_msg->offset;
-    uint16_t size = event->p_msg->len - event->p_msg->offset;
+    const uint8_t* data = event->sdu;
+    uint16_t size = event->sdu_len;
     uint32_t timestamp = event->ts;
 
     // Find LE Audio device
-    LeAudioDevice* leAudioDevice = group->GetFirstDevice();
-    while (leAudioDevice != nullptr) {
-      if (leAudioDevice->GetDsaCisHandle() == cis_conn_hdl &&
-          leAudioDevice->GetDsaDataPathState() == DataPathState::CONFIGURED) {
-        break;
-      }
-      leAudioDevice = group->GetNextDevice(leAudioDevice);
-    }
+    LeAudioDevice* leAudioDevice = group->GetDeviceByDsaCisHandle(cis_conn_hdl);
     if (leAudioDevice == nullptr) {
       log::warn("No LE Audio device found for CIS handle: {}", cis_conn_hdl);
       return false;
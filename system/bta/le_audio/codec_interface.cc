@@ -21,10 +21,16 @@
 #include <bluetooth/log.h>
 #include <lc3.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "common/message_loop_thread.h"
 #include "os/log.h"
 
 namespace bluetooth::le_audio {
@@ -107,7 +113,7 @@ struct CodecInterface::Impl {
   }
 
   std::vector<int16_t>& GetDecodedSamples() { return output_channel_data_; }
-  CodecInterface::Status Decode(uint8_t* data, uint16_t size) {
+  CodecInterface::Status Decode(const uint8_t* data, uint16_t size) {
     if (!IsReady()) {
       log::error("decoder not ready");
       return Status::STATUS_ERR_CODEC_NOT_READY;
@@ -161,9 +167,31 @@ struct CodecInterface::Impl {
       adjustOutputBufferSizeIfNeeded(out_buffer);
 
       // Encode
-      auto err =
-          lc3_encode(lc3_.encoder_, lc3_.pcm_format_, data, stride, out_size,
-                     ((uint8_t*)out_buffer->data()) + out_offset);
+      return Encode(data, stride, ((uint8_t*)out_buffer->data()) + out_offset,
+                    out_size);
+    }
+
+    log::error("Invalid codec ID: [{}:{}:{}]", codec_id_.coding_format,
+               codec_id_.vendor_company_id, codec_id_.vendor_codec_id);
+    return Status::STATUS_ERR_INVALID_CODEC_ID;
+  }
+
+  CodecInterface::Status Encode(const uint8_t* data, int stride, uint8_t* out,
+                                uint16_t out_size) {
+    if (!IsReady()) {
+      log::error("decoder not ready");
+      return Status::STATUS_ERR_CODEC_NOT_READY;
+    }
+
+    if (out_size == 0) {
+      log::error("out_size cannot be 0");
+      return Status::STATUS_ERR_CODING_ERROR;
+    }
+
+    // For now only LC3 is supported
+    if (codec_id_.coding_format == types::kLeAudioCodingFormatLC3) {
+      auto err = lc3_encode(lc3_.encoder_, lc3_.pcm_format_, data, stride,
+                            out_size, out);
       if (err < 0) {
         log::error("bad encoding parameters: {}", static_cast<int>(err));
         return Status::STATUS_ERR_CODING_ERROR;
@@ -277,7 +305,8 @@ CodecInterface::Status CodecInterface::InitDecoder(
 std::vector<int16_t>& CodecInterface::GetDecodedSamples() {
   return impl->GetDecodedSamples();
 }
-CodecInterface::Status CodecInterface::Decode(uint8_t* data, uint16_t size) {
+CodecInterface::Status CodecInterface::Decode(const uint8_t* data,
+                                              uint16_t size) {
   return impl->Decode(data, size);
 }
 CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
@@ -286,6 +315,10 @@ CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
                                               uint16_t out_offset) {
   return impl->Encode(data, stride, out_size, out_buffer, out_offset);
 }
+CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
+                                              uint8_t* out, uint16_t out_size) {
+  return impl->Encode(data, stride, out, out_size);
+}
 void CodecInterface::Cleanup() { return impl->Cleanup(); }
 
 uint16_t CodecInterface::GetNumOfSamplesPerChannel() {
@@ -295,4 +328,142 @@ uint8_t CodecInterface::GetNumOfBytesPerSample() {
   return impl->GetNumOfBytesPerSample();
 };
 
+struct CodecBatchEncoder::Impl {
+  Impl(size_t max_workers) : max_workers_(max_workers) {}
+  ~Impl() {
+    for (auto& worker : workers_) worker->ShutDown();
+  }
+
+  CodecInterface::Status Encode(const uint8_t* data, int stride,
+                                const std::vector<Channel>& channels,
+                                std::chrono::microseconds deadline) {
+    auto start = std::chrono::steady_clock::now();
+
+    size_t num_workers = 0;
+    if (channels.size() >= kMinChannelsForWorkers) {
+      num_workers = StartWorkers(std::min(max_workers_, channels.size() - 1));
+    }
+
+    // The calling thread and the workers pick the channels one at a time,
+    // so that a late worker does not hold back the whole batch.
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      next_channel_ = 0;
+      pending_workers_ = num_workers;
+      status_ = CodecInterface::Status::STATUS_OK;
+    }
+
+    for (size_t worker = 0; worker < num_workers; ++worker) {
+      if (!workers_[worker]->DoInThread(
+              FROM_HERE, base::BindOnce(&Impl::EncodeWorkerChannels,
+                                        base::Unretained(this), data, stride,
+                                        &channels))) {
+        log::warn("Worker {} is not running", worker);
+        std::lock_guard<std::mutex> lock(mutex_);
+        --pending_workers_;
+      }
+    }
+
+    auto status = EncodeChannels(data, stride, channels);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto workers_done = [this] { return pending_workers_ == 0; };
+    bool deadline_missed = false;
+    if (deadline.count() > 0) {
+      deadline_missed =
+          !workers_done_.wait_until(lock, start + deadline, workers_done);
+    }
+
+    // The channel spans are in use until all the workers are done
+    workers_done_.wait(lock, workers_done);
+    if (status == CodecInterface::Status::STATUS_OK) status = status_;
+
+    auto encode_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    deadline_missed |= deadline.count() > 0 && encode_time > deadline;
+
+    stats_.num_batches++;
+    stats_.num_deadline_misses += deadline_missed;
+    stats_.last_encode_time = encode_time;
+    stats_.max_encode_time = std::max(stats_.max_encode_time, encode_time);
+    stats_.total_encode_time += encode_time;
+
+    if (deadline_missed) {
+      log::warn("Encoding of {} channels took {} us, over the {} us deadline",
+                channels.size(), encode_time.count(), deadline.count());
+    }
+    return status;
+  }
+
+  Stats GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+ private:
+  size_t StartWorkers(size_t num_workers) {
+    while (workers_.size() < num_workers) {
+      auto worker = std::make_unique<bluetooth::common::MessageLoopThread>(
+          "bt_le_audio_encoder_worker_" + std::to_string(workers_.size()));
+      worker->StartUp();
+      if (!worker->IsRunning()) {
+        log::error("Unable to start encoder worker {}", workers_.size());
+        break;
+      }
+      workers_.push_back(std::move(worker));
+    }
+    return std::min(num_workers, workers_.size());
+  }
+
+  CodecInterface::Status EncodeChannels(const uint8_t* data, int stride,
+                                        const std::vector<Channel>& channels) {
+    auto status = CodecInterface::Status::STATUS_OK;
+    for (;;) {
+      size_t i;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        i = next_channel_++;
+      }
+      if (i >= channels.size()) break;
+
+      auto const& channel = channels[i];
+      auto channel_status = channel.codec->Encode(
+          data + channel.pcm_offset, stride, channel.out, channel.out_size);
+      if (status == CodecInterface::Status::STATUS_OK) status = channel_status;
+    }
+    return status;
+  }
+
+  void EncodeWorkerChannels(const uint8_t* data, int stride,
+                            const std::vector<Channel>* channels) {
+    auto status = EncodeChannels(data, stride, *channels);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (status_ == CodecInterface::Status::STATUS_OK) status_ = status;
+    if (--pending_workers_ == 0) workers_done_.notify_one();
+  }
+
+  const size_t max_workers_;
+  std::vector<std::unique_ptr<bluetooth::common::MessageLoopThread>> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable workers_done_;
+  size_t next_channel_ = 0;
+  size_t pending_workers_ = 0;
+  CodecInterface::Status status_ = CodecInterface::Status::STATUS_OK;
+  Stats stats_;
+};
+
+CodecBatchEncoder::CodecBatchEncoder(size_t max_workers)
+    : impl(new Impl(max_workers)) {}
+CodecBatchEncoder::~CodecBatchEncoder() { delete impl; }
+CodecInterface::Status CodecBatchEncoder::Encode(
+    const uint8_t* data, int stride, const std::vector<Channel>& channels,
+    std::chrono::microseconds deadline) {
+  return impl->Encode(data, stride, channels, deadline);
+}
+CodecBatchEncoder::Stats CodecBatchEncoder::GetStats() {
+  return impl->GetStats();
+}
+
 }  // namespace bluetooth::le_audio
@@ -21,6 +21,7 @@
 #include <bluetooth/log.h>
 #include <stdint.h>
 
+#include <chrono>
 #include <vector>
 
 #include "audio_hal_client/audio_hal_client.h"
@@ -62,7 +63,12 @@ class CodecInterface {
   virtual CodecInterface::Status Encode(
       const uint8_t* data, int stride, uint16_t out_size,
       std::vector<int16_t>* out_buffer = nullptr, uint16_t out_offset = 0);
-  virtual CodecInterface::Status Decode(uint8_t* data, uint16_t size);
+  /* Encodes into the `out_size` bytes at `out`, owned by the caller. No output
+   * buffer is managed nor resized.
+   */
+  virtual CodecInterface::Status Encode(const uint8_t* data, int stride,
+                                        uint8_t* out, uint16_t out_size);
+  virtual CodecInterface::Status Decode(const uint8_t* data, uint16_t size);
   virtual void Cleanup();
   virtual bool IsReady();
   virtual uint16_t GetNumOfSamplesPerChannel();
@@ -74,6 +80,57 @@ class CodecInterface {
   Impl* impl;
 };
 
+/* CodecBatchEncoder encodes all the channels of an interleaved PCM frame in a
+ * single call, each channel with its own CodecInterface instance, into output
+ * spans preallocated by the caller. Batches of at least
+ * kMinChannelsForWorkers channels, as used by multi-BIS broadcasts, are fanned
+ * out to a small pool of worker threads, started on first use. The calling
+ * thread takes its part of the channels and returns once all the channels
+ * are encoded.
+ */
+class CodecBatchEncoder {
+ public:
+  static constexpr size_t kMinChannelsForWorkers = 4;
+  static constexpr size_t kMaxWorkers = 3;
+
+  struct Channel {
+    CodecInterface* codec;
+    /* Offset of the first sample of the channel in the interleaved frame */
+    size_t pcm_offset;
+    uint8_t* out;
+    uint16_t out_size;
+  };
+
+  /* Encode time of the batches, and batches which exceeded their deadline */
+  struct Stats {
+    uint64_t num_batches = 0;
+    uint64_t num_deadline_misses = 0;
+    std::chrono::microseconds last_encode_time{0};
+    std::chrono::microseconds max_encode_time{0};
+    std::chrono::microseconds total_encode_time{0};
+  };
+
+  CodecBatchEncoder(size_t max_workers = kMaxWorkers);
+  CodecBatchEncoder(const CodecBatchEncoder&) = delete;
+  CodecBatchEncoder& operator=(const CodecBatchEncoder&) = delete;
+  virtual ~CodecBatchEncoder();
+
+  /* Encodes the `channels` of the `data` frame, interleaved with `stride`
+   * channels. A batch still encoding when its non zero `deadline` expires is
+   * accounted as a deadline miss. Since the output spans are in use until
+   * then, the call still returns only when all the channels are encoded.
+   * Returns the first error status of the channel encodes, if any.
+   */
+  virtual CodecInterface::Status Encode(
+      const uint8_t* data, int stride, const std::vector<Channel>& channels,
+      std::chrono::microseconds deadline = std::chrono::microseconds::zero());
+  virtual Stats GetStats();
+
+ private:
+  struct Impl;
+  Impl* impl;
+};
+
 }  // namespace bluetooth::le_audio
 
 namespace fmt {
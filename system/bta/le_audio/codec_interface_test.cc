@@ -0,0 +1,148 @@
+/******************************************************************************
+ *
+ * Copyright (c) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "codec_interface.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "le_audio_types.h"
+
+namespace bluetooth::le_audio {
+
+namespace {
+
+constexpr uint16_t kOctetsPerCodecFrame = 100;
+
+const types::LeAudioCodecId kLc3CodecId = {
+    .coding_format = types::kLeAudioCodingFormatLC3,
+    .vendor_company_id = types::kLeAudioVendorCompanyIdUndefined,
+    .vendor_codec_id = types::kLeAudioVendorCodecIdUndefined,
+};
+
+const LeAudioCodecConfiguration kCodecConfig = {
+    .num_channels = LeAudioCodecConfiguration::kChannelNumberMono,
+    .sample_rate = LeAudioCodecConfiguration::kSampleRate48000,
+    .bits_per_sample = LeAudioCodecConfiguration::kBitsPerSample16,
+    .data_interval_us = LeAudioCodecConfiguration::kInterval10000Us,
+};
+
+class CodecBatchEncoderTest : public ::testing::TestWithParam<size_t> {
+ protected:
+  void SetUp() override {
+    num_channels_ = GetParam();
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      for (auto* codecs : {&batch_codecs_, &single_codecs_}) {
+        auto codec = CodecInterface::CreateInstance(kLc3CodecId);
+        ASSERT_EQ(codec->InitEncoder(kCodecConfig, kCodecConfig),
+                  CodecInterface::Status::STATUS_OK);
+        codecs->push_back(std::move(codec));
+      }
+    }
+
+    // A distinct tone for each interleaved channel
+    num_samples_ = batch_codecs_.front()->GetNumOfSamplesPerChannel();
+    pcm_.resize(num_samples_ * num_channels_);
+    for (size_t i = 0; i < num_samples_; ++i) {
+      for (size_t ch = 0; ch < num_channels_; ++ch) {
+        pcm_[i * num_channels_ + ch] = static_cast<int16_t>(
+            10000 * sin(2 * M_PI * (ch + 1) * 300 * i / 48000.));
+      }
+    }
+
+    encoded_.resize(num_channels_ * kOctetsPerCodecFrame);
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      channels_.push_back({
+          .codec = batch_codecs_[ch].get(),
+          .pcm_offset = ch * sizeof(int16_t),
+          .out = encoded_.data() + ch * kOctetsPerCodecFrame,
+          .out_size = kOctetsPerCodecFrame,
+      });
+    }
+  }
+
+  size_t num_channels_;
+  size_t num_samples_;
+  std::vector<std::unique_ptr<CodecInterface>> batch_codecs_;
+  std::vector<std::unique_ptr<CodecInterface>> single_codecs_;
+  std::vector<int16_t> pcm_;
+  std::vector<uint8_t> encoded_;
+  std::vector<CodecBatchEncoder::Channel> channels_;
+};
+
+TEST_P(CodecBatchEncoderTest, MatchesSingleChannelEncode) {
+  CodecBatchEncoder batch_encoder;
+
+  for (int frame = 0; frame < 20; ++frame) {
+    ASSERT_EQ(batch_encoder.Encode((const uint8_t*)pcm_.data(), num_channels_,
+                                   channels_),
+              CodecInterface::Status::STATUS_OK);
+
+    for (size_t ch = 0; ch < num_channels_; ++ch) {
+      ASSERT_EQ(single_codecs_[ch]->Encode(
+                    (const uint8_t*)(pcm_.data() + ch), num_channels_,
+                    kOctetsPerCodecFrame),
+                CodecInterface::Status::STATUS_OK);
+
+      auto& expected = single_codecs_[ch]->GetDecodedSamples();
+      ASSERT_EQ(0, memcmp(expected.data(), channels_[ch].out,
+                          kOctetsPerCodecFrame))
+          << "frame " << frame << " channel " << ch;
+    }
+  }
+}
+
+TEST_P(CodecBatchEncoderTest, ReportsChannelError) {
+  CodecBatchEncoder batch_encoder;
+
+  channels_.back().codec->Cleanup();
+  ASSERT_EQ(batch_encoder.Encode((const uint8_t*)pcm_.data(), num_channels_,
+                                 channels_),
+            CodecInterface::Status::STATUS_ERR_CODEC_NOT_READY);
+}
+
+TEST_P(CodecBatchEncoderTest, AccountsEncodeTime) {
+  CodecBatchEncoder batch_encoder;
+
+  constexpr int kNumFrames = 10;
+  for (int frame = 0; frame < kNumFrames; ++frame) {
+    ASSERT_EQ(batch_encoder.Encode((const uint8_t*)pcm_.data(), num_channels_,
+                                   channels_, std::chrono::seconds(1)),
+              CodecInterface::Status::STATUS_OK);
+  }
+
+  auto stats = batch_encoder.GetStats();
+  ASSERT_EQ(stats.num_batches, (uint64_t)kNumFrames);
+  ASSERT_EQ(stats.num_deadline_misses, 0u);
+  ASSERT_LE(stats.last_encode_time, stats.max_encode_time);
+  ASSERT_LE(stats.max_encode_time, stats.total_encode_time);
+  ASSERT_LE(stats.total_encode_time, kNumFrames * std::chrono::seconds(1));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CodecBatchEncoderTestChannels, CodecBatchEncoderTest,
+    ::testing::Values(1, 2, CodecBatchEncoder::kMinChannelsForWorkers, 6));
+
+}  // namespace
+
+}  // namespace bluetooth::le_audio
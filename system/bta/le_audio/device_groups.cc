@@ -55,6 +55,7 @@ void LeAudioDeviceGroup::AddNode(
     const std::shared_ptr<LeAudioDevice>& leAudioDevice) {
   leAudioDevice->group_id_ = group_id_;
   leAudioDevices_.push_back(std::weak_ptr<LeAudioDevice>(leAudioDevice));
+  RebuildDeviceIndex();
   MetricsCollector::Get()->OnGroupSizeUpdate(group_id_, leAudioDevices_.size());
 }
 
@@ -72,9 +73,32 @@ void LeAudioDeviceGroup::RemoveNode(
           leAudioDevices_.begin(), leAudioDevices_.end(),
           [&leAudioDevice](auto& d) { return d.lock() == leAudioDevice; }),
       leAudioDevices_.end());
+  RebuildDeviceIndex();
   MetricsCollector::Get()->OnGroupSizeUpdate(group_id_, leAudioDevices_.size());
 }
 
+void LeAudioDeviceGroup::RebuildDeviceIndex(void) {
+  device_index_.clear();
+  dsa_cis_handle_cache_.clear();
+  for (size_t i = 0; i < leAudioDevices_.size(); i++) {
+    auto device = leAudioDevices_[i].lock();
+    /* Keep the first position of a device added twice, like a scan would */
+    if (device) device_index_.emplace(device.get(), i);
+  }
+}
+
+std::vector<std::weak_ptr<LeAudioDevice>>::const_iterator
+LeAudioDeviceGroup::FindDevice(const LeAudioDevice* leAudioDevice) const {
+  auto index = device_index_.find(leAudioDevice);
+  if (index == device_index_.end()) return leAudioDevices_.end();
+
+  /* While the member is alive, no other device can be at its address */
+  auto iter = leAudioDevices_.begin() + index->second;
+  if (iter->expired()) return leAudioDevices_.end();
+
+  return iter;
+}
+
 bool LeAudioDeviceGroup::IsEmpty(void) const {
   return leAudioDevices_.size() == 0;
 }
@@ -194,6 +218,7 @@ void LeAudioDeviceGroup::Cleanup(void) {
    */
 
   leAudioDevices_.clear();
+  RebuildDeviceIndex();
   ClearAllCises();
 }
 
@@ -266,13 +291,7 @@ LeAudioDevice* LeAudioDeviceGroup::GetFirstDeviceWithAvailableContext(
 
 LeAudioDevice* LeAudioDeviceGroup::GetNextDevice(
     LeAudioDevice* leAudioDevice) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&leAudioDevice](auto& d) {
-                             if (d.expired())
-                               return false;
-                             else
-                               return (d.lock()).get() == leAudioDevice;
-                           });
+  auto iter = FindDevice(leAudioDevice);
 
   /* If reference device not found */
   if (iter == leAudioDevices_.end()) return nullptr;
@@ -288,13 +307,7 @@ LeAudioDevice* LeAudioDeviceGroup::GetNextDevice(
 
 LeAudioDevice* LeAudioDeviceGroup::GetNextDeviceWithAvailableContext(
     LeAudioDevice* leAudioDevice, LeAudioContextType context_type) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&leAudioDevice](auto& d) {
-                             if (d.expired())
-                               return false;
-                             else
-                               return (d.lock()).get() == leAudioDevice;
-                           });
+  auto iter = FindDevice(leAudioDevice);
 
   /* If reference device not found */
   if (iter == leAudioDevices_.end()) return nullptr;
@@ -316,17 +329,7 @@ LeAudioDevice* LeAudioDeviceGroup::GetNextDeviceWithAvailableContext(
 
 bool LeAudioDeviceGroup::IsDeviceInTheGroup(
     LeAudioDevice* leAudioDevice) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&leAudioDevice](auto& d) {
-                             if (d.expired())
-                               return false;
-                             else
-                               return (d.lock()).get() == leAudioDevice;
-                           });
-
-  if ((iter == leAudioDevices_.end()) || (iter->expired())) return false;
-
-  return true;
+  return FindDevice(leAudioDevice) != leAudioDevices_.end();
 }
 
 bool LeAudioDeviceGroup::IsGroupReadyToCreateStream(void) const {
@@ -394,13 +397,7 @@ LeAudioDevice* LeAudioDeviceGroup::GetFirstActiveDevice(void) const {
 
 LeAudioDevice* LeAudioDeviceGroup::GetNextActiveDevice(
     LeAudioDevice* leAudioDevice) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&leAudioDevice](auto& d) {
-                             if (d.expired())
-                               return false;
-                             else
-                               return (d.lock()).get() == leAudioDevice;
-                           });
+  auto iter = FindDevice(leAudioDevice);
 
   if (iter == leAudioDevices_.end() ||
       std::distance(iter, leAudioDevices_.end()) < 1)
@@ -440,14 +437,7 @@ LeAudioDevice* LeAudioDeviceGroup::GetFirstActiveDeviceByCisAndDataPathState(
 LeAudioDevice* LeAudioDeviceGroup::GetNextActiveDeviceByCisAndDataPathState(
     LeAudioDevice* leAudioDevice, CisState cis_state,
     DataPathState data_path_state) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&leAudioDevice](auto& d) {
-                             if (d.expired()) {
-                               return false;
-                             }
-
-                             return d.lock().get() == leAudioDevice;
-                           });
+  auto iter = FindDevice(leAudioDevice);
 
   if (std::distance(iter, leAudioDevices_.end()) < 1) {
     return nullptr;
@@ -471,6 +461,31 @@ LeAudioDevice* LeAudioDeviceGroup::GetNextActiveDeviceByCisAndDataPathState(
   return iter->lock().get();
 }
 
+LeAudioDevice* LeAudioDeviceGroup::GetDeviceByDsaCisHandle(
+    uint16_t cis_handle) const {
+  auto is_consuming = [cis_handle](LeAudioDevice* leAudioDevice) {
+    return leAudioDevice->GetDsaCisHandle() == cis_handle &&
+           leAudioDevice->GetDsaDataPathState() == DataPathState::CONFIGURED;
+  };
+
+  auto cached = dsa_cis_handle_cache_.find(cis_handle);
+  if (cached != dsa_cis_handle_cache_.end()) {
+    auto device = cached->second.lock();
+    if (device && is_consuming(device.get())) return device.get();
+    dsa_cis_handle_cache_.erase(cached);
+  }
+
+  for (auto& d : leAudioDevices_) {
+    auto device = d.lock();
+    if (device && is_consuming(device.get())) {
+      dsa_cis_handle_cache_.emplace(cis_handle, d);
+      return device.get();
+    }
+  }
+
+  return nullptr;
+}
+
 uint32_t LeAudioDeviceGroup::GetSduInterval(uint8_t direction) const {
   for (LeAudioDevice* leAudioDevice = GetFirstActiveDevice();
        leAudioDevice != nullptr;
@@ -915,6 +930,25 @@ void LeAudioDeviceGroup::InvalidateCachedConfigurations(void) {
   context_to_configuration_cache_map.clear();
 }
 
+/* Fills the configuration cache for all the available contexts, so that
+ * switching between them is a lookup rather than a configuration matching.
+ */
+void LeAudioDeviceGroup::PrecomputeConfigurations(void) const {
+  auto available_contexts = GetAvailableContexts();
+  log::debug("Group id: {}, contexts: {}", group_id_,
+             available_contexts.to_string());
+
+  for (auto ctx_type : types::kLeAudioContextAllTypesArray) {
+    if (!available_contexts.test(ctx_type)) continue;
+
+    auto it = context_to_configuration_cache_map.find(ctx_type);
+    if (it != context_to_configuration_cache_map.end() && it->second.first) {
+      continue;
+    }
+    UpdateAudioSetConfigurationCache(ctx_type);
+  }
+}
+
 types::BidirectionalPair<AudioContexts>
 LeAudioDeviceGroup::GetLatestAvailableContexts() const {
   types::BidirectionalPair<AudioContexts> contexts;
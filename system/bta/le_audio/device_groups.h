@@ -28,6 +28,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <utility>  // for std::pair
 #include <vector>
 
@@ -182,6 +183,7 @@ class LeAudioDeviceGroup {
   LeAudioDevice* GetNextActiveDeviceByCisAndDataPathState(
       LeAudioDevice* leAudioDevice, types::CisState cis_state,
       types::DataPathState data_path_state) const;
+  LeAudioDevice* GetDeviceByDsaCisHandle(uint16_t cis_handle) const;
   bool IsDeviceInTheGroup(LeAudioDevice* leAudioDevice) const;
   bool HaveAllActiveDevicesAsesTheSameState(types::AseState state) const;
   bool HaveAnyActiveDeviceInUnconfiguredState() const;
@@ -227,6 +229,7 @@ class LeAudioDeviceGroup {
   std::shared_ptr<const set_configurations::AudioSetConfiguration>
   GetCachedConfiguration(types::LeAudioContextType ctx_type) const;
   void InvalidateCachedConfigurations(void);
+  void PrecomputeConfigurations(void) const;
   void SetPendingConfiguration(void);
   void ClearPendingConfiguration(void);
   void AddToAllowListNotConnectedGroupMembers(int gatt_if);
@@ -445,6 +448,9 @@ class LeAudioDeviceGroup {
       const;
   uint32_t GetTransportLatencyUs(uint8_t direction) const;
   bool IsCisPartOfCurrentStream(uint16_t cis_conn_hdl) const;
+  void RebuildDeviceIndex(void);
+  std::vector<std::weak_ptr<LeAudioDevice>>::const_iterator FindDevice(
+      const LeAudioDevice* leAudioDevice) const;
 
   /* Current configuration and metadata context types */
   types::LeAudioContextType configuration_context_type_;
@@ -482,6 +488,19 @@ class LeAudioDeviceGroup {
   types::AseState current_state_;
   bool in_transition_;
   std::vector<std::weak_ptr<LeAudioDevice>> leAudioDevices_;
+
+  /* Position of each member in |leAudioDevices_|, rebuilt when members are
+   * added or removed, so that stepping through the group does not scan it for
+   * the reference device.
+   */
+  std::unordered_map<const LeAudioDevice*, size_t> device_index_;
+
+  /* Members last found consuming the DSA data of a CIS handle. CIS handles and
+   * data path states change outside of the group, so an entry is checked
+   * against its device before being used.
+   */
+  mutable std::unordered_map<uint16_t, std::weak_ptr<LeAudioDevice>>
+      dsa_cis_handle_cache_;
 };
 
 /* LeAudioDeviceGroup class represents a wraper helper over all device groups in
@@ -1228,6 +1228,7 @@ void LeAudioDevices::Add(const RawAddress& address, DeviceConnectState state,
 
   leAudioDevices_.emplace_back(
       std::make_shared<LeAudioDevice>(address, state, group_id));
+  address_index_.emplace(address, leAudioDevices_.back());
 }
 
 void LeAudioDevices::Remove(const RawAddress& address) {
@@ -1242,38 +1243,66 @@ void LeAudioDevices::Remove(const RawAddress& address) {
   }
 
   leAudioDevices_.erase(iter);
+  address_index_.erase(address);
+  ClearLookupCaches();
+}
+
+void LeAudioDevices::ClearLookupCaches(void) {
+  conn_id_cache_.clear();
+  cis_conn_hdl_cache_.clear();
 }
 
 LeAudioDevice* LeAudioDevices::FindByAddress(const RawAddress& address) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&address](auto const& leAudioDevice) {
-                             return leAudioDevice->address_ == address;
-                           });
+  auto iter = address_index_.find(address);
 
-  return (iter == leAudioDevices_.end()) ? nullptr : iter->get();
+  return (iter == address_index_.end()) ? nullptr : iter->second.get();
 }
 
 std::shared_ptr<LeAudioDevice> LeAudioDevices::GetByAddress(
     const RawAddress& address) const {
-  auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
-                           [&address](auto const& leAudioDevice) {
-                             return leAudioDevice->address_ == address;
-                           });
+  auto iter = address_index_.find(address);
 
-  return (iter == leAudioDevices_.end()) ? nullptr : *iter;
+  return (iter == address_index_.end()) ? nullptr : iter->second;
 }
 
 LeAudioDevice* LeAudioDevices::FindByConnId(uint16_t conn_id) const {
+  /* Disconnected devices share the invalid connection id, keep returning the
+   * first of them */
+  bool cacheable = (conn_id != GATT_INVALID_CONN_ID);
+  if (cacheable) {
+    auto cached = conn_id_cache_.find(conn_id);
+    if (cached != conn_id_cache_.end()) {
+      if (cached->second->conn_id_ == conn_id) return cached->second;
+      conn_id_cache_.erase(cached);
+    }
+  }
+
   auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
                            [&conn_id](auto const& leAudioDevice) {
                              return leAudioDevice->conn_id_ == conn_id;
                            });
 
-  return (iter == leAudioDevices_.end()) ? nullptr : iter->get();
+  if (iter == leAudioDevices_.end()) return nullptr;
+
+  if (cacheable) conn_id_cache_[conn_id] = iter->get();
+  return iter->get();
 }
 
 LeAudioDevice* LeAudioDevices::FindByCisConnHdl(uint8_t cig_id,
                                                 uint16_t conn_hdl) const {
+  /* Unassigned ASEs have a zero handle, do not cache lookups for it */
+  bool cacheable = (conn_hdl != 0);
+  uint32_t key = (static_cast<uint32_t>(cig_id) << 16) | conn_hdl;
+  if (cacheable) {
+    auto cached = cis_conn_hdl_cache_.find(key);
+    if (cached != cis_conn_hdl_cache_.end()) {
+      LeAudioDevice* dev = cached->second;
+      auto ases = dev->GetAsesByCisConnHdl(conn_hdl);
+      if (dev->group_id_ == cig_id && (ases.sink || ases.source)) return dev;
+      cis_conn_hdl_cache_.erase(cached);
+    }
+  }
+
   auto iter = std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(),
                            [&conn_hdl, &cig_id](auto& d) {
                              LeAudioDevice* dev;
@@ -1293,6 +1322,7 @@ LeAudioDevice* LeAudioDevices::FindByCisConnHdl(uint8_t cig_id,
 
   if (iter == leAudioDevices_.end()) return nullptr;
 
+  if (cacheable) cis_conn_hdl_cache_[key] = iter->get();
   return iter->get();
 }
 
@@ -1368,6 +1398,8 @@ void LeAudioDevices::Cleanup(tGATT_IF client_if) {
     }
   }
   leAudioDevices_.clear();
+  address_index_.clear();
+  ClearLookupCaches();
 }
 
 }  // namespace bluetooth::le_audio
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 #include <utility>  // for std::pair
 #include <vector>
 
@@ -283,7 +284,21 @@ class LeAudioDevices {
   void Cleanup(tGATT_IF client_if);
 
  private:
+  void ClearLookupCaches(void);
+
   std::vector<std::shared_ptr<LeAudioDevice>> leAudioDevices_;
+
+  /* Devices by address, maintained on Add() and Remove() */
+  std::unordered_map<RawAddress, std::shared_ptr<LeAudioDevice>>
+      address_index_;
+
+  /* Devices last found by connection id and by CIG and CIS connection handle.
+   * Both are assigned to the devices outside of this class, so an entry is
+   * checked against its device before being used. Only devices still in
+   * |leAudioDevices_| are cached.
+   */
+  mutable std::unordered_map<uint16_t, LeAudioDevice*> conn_id_cache_;
+  mutable std::unordered_map<uint32_t, LeAudioDevice*> cis_conn_hdl_cache_;
 };
 
 }  // namespace bluetooth::le_audio
@@ -209,6 +209,24 @@ TEST_F(LeAudioDevicesTest, test_find_by_conn_id_failed) {
   ASSERT_EQ(nullptr, devices_->FindByConnId(0x0006));
 }
 
+TEST_F(LeAudioDevicesTest, test_find_by_conn_id_after_reconnection) {
+  devices_->Add(GetTestAddress(0), DeviceConnectState::CONNECTING_BY_USER);
+  devices_->Add(GetTestAddress(1), DeviceConnectState::CONNECTING_BY_USER);
+  LeAudioDevice* device_0 = devices_->FindByAddress(GetTestAddress(0));
+  LeAudioDevice* device_1 = devices_->FindByAddress(GetTestAddress(1));
+  device_0->conn_id_ = 0x0005;
+  ASSERT_EQ(device_0, devices_->FindByConnId(0x0005));
+
+  // The connection id is reused by the other device
+  device_0->conn_id_ = GATT_INVALID_CONN_ID;
+  device_1->conn_id_ = 0x0005;
+  ASSERT_EQ(device_1, devices_->FindByConnId(0x0005));
+
+  devices_->Remove(GetTestAddress(1));
+  ASSERT_EQ(nullptr, devices_->FindByConnId(0x0005));
+  ASSERT_EQ(nullptr, devices_->FindByAddress(GetTestAddress(1)));
+}
+
 TEST_F(LeAudioDevicesTest, test_get_device_model_name_success) {
   RawAddress test_address_0 = GetTestAddress(0);
   devices_->Add(test_address_0, DeviceConnectState::CONNECTING_BY_USER);
@@ -1832,6 +1850,33 @@ TEST_P(LeAudioAseConfigurationTest,
       CodecManager::GetInstance()->CheckCodecConfigIsDualBiDirSwb(*config));
 }
 
+TEST_P(LeAudioAseConfigurationTest, test_precomputed_configurations) {
+  AddTestDevice(2, 2);
+  group_->UpdateAudioContextAvailability();
+  group_->PrecomputeConfigurations();
+
+  std::map<LeAudioContextType,
+           std::shared_ptr<const AudioSetConfiguration>>
+      precomputed;
+  for (auto context_type : kLeAudioContextAllTypesArray) {
+    precomputed[context_type] = group_->GetCachedConfiguration(context_type);
+  }
+  ASSERT_NE(nullptr, precomputed[LeAudioContextType::MEDIA]);
+
+  // Switching between the contexts with a precomputed configuration does not
+  // match the configurations again
+  EXPECT_CALL(*mock_codec_manager_, GetCodecConfig).Times(0);
+  for (auto const& [context_type, config] : precomputed) {
+    if (config == nullptr) continue;
+    ASSERT_EQ(config, group_->GetConfiguration(context_type));
+  }
+  testing::Mock::VerifyAndClearExpectations(mock_codec_manager_);
+
+  // Invalidating drops the precomputed configurations
+  group_->InvalidateCachedConfigurations();
+  ASSERT_EQ(nullptr, group_->GetCachedConfiguration(LeAudioContextType::MEDIA));
+}
+
 TEST_P(LeAudioAseConfigurationTest,
        test_banded_headset_ringtone_stereo_microphone_no_swb) {
   // Turn off the dual bidir SWB support
@@ -2328,6 +2373,45 @@ TEST_P(LeAudioAseConfigurationTest, test_num_of_connected) {
   ASSERT_EQ(0, group_->NumOfConnected());
 }
 
+TEST_P(LeAudioAseConfigurationTest, test_next_device_after_node_removal) {
+  auto device1 = AddTestDevice(1, 1);
+  auto device2 = AddTestDevice(1, 1);
+  auto device3 = AddTestDevice(1, 1);
+  ASSERT_EQ(device1, group_->GetFirstDevice());
+  ASSERT_EQ(device2, group_->GetNextDevice(device1));
+  ASSERT_EQ(device3, group_->GetNextDevice(device2));
+  ASSERT_EQ(nullptr, group_->GetNextDevice(device3));
+
+  group_->RemoveNode(devices_[1]);
+  ASSERT_FALSE(group_->IsDeviceInTheGroup(device2));
+  ASSERT_EQ(nullptr, group_->GetNextDevice(device2));
+  ASSERT_EQ(device3, group_->GetNextDevice(device1));
+  ASSERT_TRUE(group_->IsDeviceInTheGroup(device3));
+}
+
+TEST_P(LeAudioAseConfigurationTest, test_get_device_by_dsa_cis_handle) {
+  auto device1 = AddTestDevice(1, 1);
+  auto device2 = AddTestDevice(1, 1);
+  device1->SetDsaCisHandle(0x0010);
+  device1->SetDsaDataPathState(DataPathState::CONFIGURED);
+  device2->SetDsaCisHandle(0x0011);
+  device2->SetDsaDataPathState(DataPathState::CONFIGURED);
+
+  ASSERT_EQ(device1, group_->GetDeviceByDsaCisHandle(0x0010));
+  ASSERT_EQ(device2, group_->GetDeviceByDsaCisHandle(0x0011));
+  ASSERT_EQ(nullptr, group_->GetDeviceByDsaCisHandle(0x0012));
+
+  // Handles are moved without the group knowing
+  device1->SetDsaDataPathState(DataPathState::IDLE);
+  ASSERT_EQ(nullptr, group_->GetDeviceByDsaCisHandle(0x0010));
+  device2->SetDsaCisHandle(0x0010);
+  ASSERT_EQ(device2, group_->GetDeviceByDsaCisHandle(0x0010));
+  ASSERT_EQ(nullptr, group_->GetDeviceByDsaCisHandle(0x0011));
+
+  group_->RemoveNode(devices_[1]);
+  ASSERT_EQ(nullptr, group_->GetDeviceByDsaCisHandle(0x0010));
+}
+
 /*
  * Failure happens when there is no matching single device scenario for dual
  * device scanario. Stereo location for single earbud seems to be invalid but
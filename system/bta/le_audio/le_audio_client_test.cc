@@ -2766,22 +2766,20 @@ class UnicastTestNoInit : public Test {
 
   void InjectIncomingIsoData(uint16_t cig_id, uint16_t cis_con_hdl,
                              size_t payload_size) {
-    BT_HDR* bt_hdr = (BT_HDR*)malloc(sizeof(BT_HDR) + payload_size);
-
-    bt_hdr->offset = 0;
-    bt_hdr->len = payload_size;
+    std::vector<uint8_t> sdu(payload_size);
 
     bluetooth::hci::iso_manager::cis_data_evt cis_evt;
     cis_evt.cig_id = cig_id;
     cis_evt.cis_conn_hdl = cis_con_hdl;
     cis_evt.ts = 0;
     cis_evt.evt_lost = 0;
-    cis_evt.p_msg = bt_hdr;
+    cis_evt.p_msg = nullptr;
+    cis_evt.sdu = sdu.data();
+    cis_evt.sdu_len = payload_size;
 
     ASSERT_NE(cig_callbacks_, nullptr);
     cig_callbacks_->OnCisEvent(
         bluetooth::hci::iso_manager::kIsoEventCisDataAvailable, &cis_evt);
-    free(bt_hdr);
   }
 
   void InjectCisDisconnected(uint16_t cig_id, uint16_t cis_con_hdl,
@@ -29,6 +29,7 @@ static std::string kLogAseStateNotif("ASE_NOTIF");
 static std::string kLogHciEvent("HCI_EVENT");
 static std::string kLogAfCallBt("AF --> ");
 static std::string kLogBtCallAf("AF <-- ");
+static std::string kLogIsoDataTag("ISO_DATA");
 
 /* Operations on SM and ASEs */
 static std::string kLogStateChangedOp("STATE CHANGED");
@@ -64,6 +65,10 @@ static std::string kLogAfCancel("REQUEST_CANCELED: ");
 static std::string kLogAfReconfigComplete("RECONFIG_COMPLETE_EVT: ");
 static std::string kLogAfSuspendForReconfig("SUSPEND_FOR_RECONFIG_EVT: ");
 
+/* Audio data path */
+static std::string kLogSduStatsOp("SDU_STATS: ");
+static std::string kLogJitterBufferStatsOp("JITTER_BUFFER_STATS: ");
+
 class LeAudioLogHistory {
  public:
   virtual ~LeAudioLogHistory(void) = default;
@@ -16,6 +16,10 @@
  */
 
 #include <bluetooth/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <mutex>
 #include <string>
@@ -43,50 +47,139 @@ using bluetooth::le_audio::types::LeAudioContextType;
 
 namespace bluetooth::le_audio {
 
+/* Precompiled binary flatbuffer content, with its JSON source and schema to
+ * fall back to */
+struct ContentFiles {
+  const char* schema;
+  const char* binary;
+  const char* json;
+};
+
 #ifdef __ANDROID__
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetConfigs = {
-        {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
-         "audio_set_configurations.bfbs",
-         "/apex/com.android.btservices/etc/bluetooth/le_audio/"
-         "audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetScenarios = {{"/apex/com.android.btservices/etc/bluetooth/"
-                             "le_audio/audio_set_scenarios.bfbs",
-                             "/apex/com.android.btservices/etc/bluetooth/"
-                             "le_audio/audio_set_scenarios.json"}};
+static const std::vector<ContentFiles> kLeAudioSetConfigs = {
+    {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_configurations.bfbs",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_configurations.bin",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_configurations.json"}};
+static const std::vector<ContentFiles> kLeAudioSetScenarios = {
+    {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_scenarios.bfbs",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_scenarios.bin",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_scenarios.json"}};
 #elif defined(TARGET_FLOSS)
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetConfigs = {
-        {"/etc/bluetooth/le_audio/audio_set_configurations.bfbs",
-         "/etc/bluetooth/le_audio/audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetScenarios = {
-        {"/etc/bluetooth/le_audio/audio_set_scenarios.bfbs",
-         "/etc/bluetooth/le_audio/audio_set_scenarios.json"}};
+static const std::vector<ContentFiles> kLeAudioSetConfigs = {
+    {"/etc/bluetooth/le_audio/audio_set_configurations.bfbs",
+     "/etc/bluetooth/le_audio/audio_set_configurations.bin",
+     "/etc/bluetooth/le_audio/audio_set_configurations.json"}};
+static const std::vector<ContentFiles> kLeAudioSetScenarios = {
+    {"/etc/bluetooth/le_audio/audio_set_scenarios.bfbs",
+     "/etc/bluetooth/le_audio/audio_set_scenarios.bin",
+     "/etc/bluetooth/le_audio/audio_set_scenarios.json"}};
 #else
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetConfigs = {
-        {"audio_set_configurations.bfbs", "audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetScenarios = {
-        {"audio_set_scenarios.bfbs", "audio_set_scenarios.json"}};
+static const std::vector<ContentFiles> kLeAudioSetConfigs = {
+    {"audio_set_configurations.bfbs", "audio_set_configurations.bin",
+     "audio_set_configurations.json"}};
+static const std::vector<ContentFiles> kLeAudioSetScenarios = {
+    {"audio_set_scenarios.bfbs", "audio_set_scenarios.bin",
+     "audio_set_scenarios.json"}};
 #endif
 
+/* Flatbuffer content, either mapped read-only from the precompiled binary file
+ * or built from the JSON source */
+class FlatBufferContent {
+ public:
+  static std::unique_ptr<FlatBufferContent> FromBinaryFile(const char* file) {
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    void* mapped = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapped == MAP_FAILED) {
+      log::warn("Unable to map {}", file);
+      return nullptr;
+    }
+
+    auto content = std::unique_ptr<FlatBufferContent>(new FlatBufferContent());
+    content->mapped_ = mapped;
+    content->mapped_size_ = st.st_size;
+    return content;
+  }
+
+  static std::unique_ptr<FlatBufferContent> FromJsonFile(
+      const char* schema_file, const char* json_file) {
+    flatbuffers::Parser parser;
+    std::string schema_binary_content;
+    if (!flatbuffers::LoadFile(schema_file, true, &schema_binary_content)) {
+      return nullptr;
+    }
+
+    /* Load the binary schema */
+    if (!parser.Deserialize((uint8_t*)schema_binary_content.c_str(),
+                            schema_binary_content.length())) {
+      return nullptr;
+    }
+
+    /* Load the content from JSON */
+    std::string json_content;
+    if (!flatbuffers::LoadFile(json_file, false, &json_content)) {
+      return nullptr;
+    }
+
+    /* Parse */
+    if (!parser.Parse(json_content.c_str())) return nullptr;
+
+    auto content = std::unique_ptr<FlatBufferContent>(new FlatBufferContent());
+    content->built_ = parser.builder_.Release();
+    return content;
+  }
+
+  ~FlatBufferContent() {
+    if (mapped_ != nullptr) munmap(mapped_, mapped_size_);
+  }
+
+  const uint8_t* data() const {
+    return mapped_ ? static_cast<const uint8_t*>(mapped_) : built_.data();
+  }
+  size_t size() const { return mapped_ ? mapped_size_ : built_.size(); }
+
+ private:
+  FlatBufferContent() = default;
+
+  void* mapped_ = nullptr;
+  size_t mapped_size_ = 0;
+  flatbuffers::DetachedBuffer built_;
+};
+
+/* Uses the precompiled binary content if valid, the JSON content otherwise */
+template <typename VerifyFn>
+static std::unique_ptr<FlatBufferContent> LoadFlatBufferContent(
+    const ContentFiles& files, VerifyFn verify) {
+  auto content = FlatBufferContent::FromBinaryFile(files.binary);
+  if (content) {
+    flatbuffers::Verifier verifier(content->data(), content->size());
+    if (verify(verifier)) return content;
+    log::warn("Invalid content in {}, using {}", files.binary, files.json);
+  }
+
+  return FlatBufferContent::FromJsonFile(files.schema, files.json);
+}
+
 /** Provides a set configurations for the given context type */
 struct AudioSetConfigurationProviderJson {
   static constexpr auto kDefaultScenario = "Media";
 
-  AudioSetConfigurationProviderJson(types::CodecLocation location) {
-    log::assert_that(
-        LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios, location),
-        ": Unable to load le audio set configuration files.");
+  AudioSetConfigurationProviderJson(types::CodecLocation location)
+      : location_(location) {
+    log::assert_that(LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios),
+                     ": Unable to load le audio set configuration files.");
   }
 
   /* Use the same scenario configurations for different contexts to avoid
@@ -145,29 +238,67 @@ struct AudioSetConfigurationProviderJson {
     }
   }
 
+  /* The configurations of a context are materialized from the flatbuffer
+   * content on the first request */
   const AudioSetConfigurations* GetConfigurationsByContextType(
-      LeAudioContextType context_type) const {
-    if (context_configurations_.count(context_type))
-      return &context_configurations_.at(context_type);
-
-    log::warn(": No predefined scenario for the context {} was found.",
-              (int)context_type);
+      LeAudioContextType context_type) {
+    std::scoped_lock<std::mutex> lock(mutex_);
+
+    if (context_scenarios_.count(context_type) == 0) {
+      log::warn(": No predefined scenario for the context {} was found.",
+                (int)context_type);
+
+      auto [it_begin, it_end] = ScenarioToContextTypes(kDefaultScenario);
+      if ((it_begin == it_end) ||
+          (context_scenarios_.count(it_begin->second) == 0)) {
+        log::error(
+            ": No valid configuration for the default '{}' scenario, or no "
+            "audio set configurations loaded at all.",
+            kDefaultScenario);
+        return nullptr;
+      }
 
-    auto [it_begin, it_end] = ScenarioToContextTypes(kDefaultScenario);
-    if (it_begin != it_end) {
       log::warn(": Using '{}' scenario by default.", kDefaultScenario);
-      return &context_configurations_.at(it_begin->second);
+      context_type = it_begin->second;
     }
 
-    log::error(
-        ": No valid configuration for the default '{}' scenario, or no audio "
-        "set configurations loaded at all.",
-        kDefaultScenario);
-    return nullptr;
+    auto it = context_configurations_.find(context_type);
+    if (it == context_configurations_.end()) {
+      it = context_configurations_
+               .emplace(context_type,
+                        AudioSetConfigurationsFromFlatScenario(
+                            context_scenarios_.at(context_type)))
+               .first;
+    }
+    return &it->second;
   };
 
  private:
-  /* Codec configurations */
+  /* Flatbuffer content of a configurations file, with its codec and QoS
+   * settings that the configurations refer to */
+  struct FlatConfigurationsContent {
+    std::unique_ptr<FlatBufferContent> content;
+    std::vector<const fbs::le_audio::QosConfiguration*> qos_cfgs;
+    std::vector<const fbs::le_audio::CodecConfiguration*> codec_cfgs;
+  };
+
+  const types::CodecLocation location_;
+  std::mutex mutex_;
+
+  /* Loaded flatbuffer content, referenced by the maps below */
+  std::vector<std::unique_ptr<FlatConfigurationsContent>>
+      configurations_content_;
+  std::vector<std::unique_ptr<FlatBufferContent>> scenarios_content_;
+
+  /* Flat configurations by name, and flat scenarios by context type */
+  std::map<std::string_view,
+           std::pair<const fbs::le_audio::AudioSetConfiguration*,
+                     FlatConfigurationsContent*>>
+      flat_configurations_;
+  std::map<LeAudioContextType, const fbs::le_audio::AudioSetScenario*>
+      context_scenarios_;
+
+  /* Codec configurations materialized so far */
   std::map<std::string, const AudioSetConfiguration> configurations_;
 
   /* Maps of context types to a set of configuration structs */
@@ -390,34 +521,14 @@ struct AudioSetConfigurationProviderJson {
     }
   }
 
-  bool LoadConfigurationsFromFiles(const char* schema_file,
-                                   const char* content_file,
-                                   types::CodecLocation location) {
-    flatbuffers::Parser configurations_parser_;
-    std::string configurations_schema_binary_content;
-    bool ok = flatbuffers::LoadFile(schema_file, true,
-                                    &configurations_schema_binary_content);
-    if (!ok) return ok;
-
-    /* Load the binary schema */
-    ok = configurations_parser_.Deserialize(
-        (uint8_t*)configurations_schema_binary_content.c_str(),
-        configurations_schema_binary_content.length());
-    if (!ok) return ok;
-
-    /* Load the content from JSON */
-    std::string configurations_json_content;
-    ok = flatbuffers::LoadFile(content_file, false,
-                               &configurations_json_content);
-    if (!ok) return ok;
-
-    /* Parse */
-    ok = configurations_parser_.Parse(configurations_json_content.c_str());
-    if (!ok) return ok;
+  bool LoadConfigurationsFromFiles(const ContentFiles& files) {
+    auto flat_content = std::make_unique<FlatConfigurationsContent>();
+    flat_content->content = LoadFlatBufferContent(
+        files, fbs::le_audio::VerifyAudioSetConfigurationsBuffer);
+    if (!flat_content->content) return false;
 
-    /* Import from flatbuffers */
     auto configurations_root = fbs::le_audio::GetAudioSetConfigurations(
-        configurations_parser_.builder_.GetBufferPointer());
+        flat_content->content->data());
     if (!configurations_root) return false;
 
     auto flat_qos_configs = configurations_root->qos_configurations();
@@ -425,9 +536,8 @@ struct AudioSetConfigurationProviderJson {
       return false;
 
     log::debug(": Updating {} qos config entries.", flat_qos_configs->size());
-    std::vector<const fbs::le_audio::QosConfiguration*> qos_cfgs;
     for (auto const& flat_qos_cfg : *flat_qos_configs) {
-      qos_cfgs.push_back(flat_qos_cfg);
+      flat_content->qos_cfgs.push_back(flat_qos_cfg);
     }
 
     auto flat_codec_configs = configurations_root->codec_configurations();
@@ -436,105 +546,93 @@ struct AudioSetConfigurationProviderJson {
 
     log::debug(": Updating {} codec config entries.",
                flat_codec_configs->size());
-    std::vector<const fbs::le_audio::CodecConfiguration*> codec_cfgs;
     for (auto const& flat_codec_cfg : *flat_codec_configs) {
-      codec_cfgs.push_back(flat_codec_cfg);
+      flat_content->codec_cfgs.push_back(flat_codec_cfg);
     }
 
     auto flat_configs = configurations_root->configurations();
     if ((flat_configs == nullptr) || (flat_configs->size() == 0)) return false;
 
-    log::debug(": Updating {} config entries.", flat_configs->size());
+    log::debug(": Indexing {} config entries.", flat_configs->size());
     for (auto const& flat_cfg : *flat_configs) {
-      auto configuration = AudioSetConfigurationFromFlat(flat_cfg, &codec_cfgs,
-                                                         &qos_cfgs, location);
-      if (!configuration.confs.sink.empty() ||
-          !configuration.confs.source.empty()) {
-        configurations_.insert({flat_cfg->name()->str(), configuration});
-      }
+      auto name = flat_cfg->name();
+      flat_configurations_.emplace(
+          std::string_view(name->c_str(), name->size()),
+          std::make_pair(flat_cfg, flat_content.get()));
     }
 
+    configurations_content_.push_back(std::move(flat_content));
     return true;
   }
 
+  const AudioSetConfiguration* MaterializeConfiguration(
+      const std::string& name) {
+    auto it = configurations_.find(name);
+    if (it != configurations_.end()) return &it->second;
+
+    auto flat_it = flat_configurations_.find(name);
+    if (flat_it == flat_configurations_.end()) return nullptr;
+
+    auto [flat_cfg, flat_content] = flat_it->second;
+    auto configuration =
+        AudioSetConfigurationFromFlat(flat_cfg, &flat_content->codec_cfgs,
+                                      &flat_content->qos_cfgs, location_);
+    if (configuration.confs.sink.empty() && configuration.confs.source.empty())
+      return nullptr;
+
+    return &configurations_.emplace(name, configuration).first->second;
+  }
+
   AudioSetConfigurations AudioSetConfigurationsFromFlatScenario(
       const fbs::le_audio::AudioSetScenario* const flat_scenario) {
     AudioSetConfigurations items;
     if (!flat_scenario->configurations()) return items;
 
+    log::debug("Scenario {} configs:", flat_scenario->name()->c_str());
     for (auto config_name : *flat_scenario->configurations()) {
-      if (configurations_.count(config_name->str()) == 0) continue;
+      auto cfg = MaterializeConfiguration(config_name->str());
+      if (cfg == nullptr) continue;
 
-      auto& cfg = configurations_.at(config_name->str());
-      items.push_back(&cfg);
+      log::debug("\t\t Audio set config: {}", cfg->name);
+      items.push_back(cfg);
     }
 
     return items;
   }
 
-  bool LoadScenariosFromFiles(const char* schema_file,
-                              const char* content_file) {
-    flatbuffers::Parser scenarios_parser_;
-    std::string scenarios_schema_binary_content;
-    bool ok = flatbuffers::LoadFile(schema_file, true,
-                                    &scenarios_schema_binary_content);
-    if (!ok) return ok;
-
-    /* Load the binary schema */
-    ok = scenarios_parser_.Deserialize(
-        (uint8_t*)scenarios_schema_binary_content.c_str(),
-        scenarios_schema_binary_content.length());
-    if (!ok) return ok;
-
-    /* Load the content from JSON */
-    std::string scenarios_json_content;
-    ok = flatbuffers::LoadFile(content_file, false, &scenarios_json_content);
-    if (!ok) return ok;
-
-    /* Parse */
-    ok = scenarios_parser_.Parse(scenarios_json_content.c_str());
-    if (!ok) return ok;
+  bool LoadScenariosFromFiles(const ContentFiles& files) {
+    auto content = LoadFlatBufferContent(
+        files, fbs::le_audio::VerifyAudioSetScenariosBuffer);
+    if (!content) return false;
 
-    /* Import from flatbuffers */
-    auto scenarios_root = fbs::le_audio::GetAudioSetScenarios(
-        scenarios_parser_.builder_.GetBufferPointer());
+    auto scenarios_root = fbs::le_audio::GetAudioSetScenarios(content->data());
     if (!scenarios_root) return false;
 
     auto flat_scenarios = scenarios_root->scenarios();
     if ((flat_scenarios == nullptr) || (flat_scenarios->size() == 0))
       return false;
 
-    log::debug(": Updating {} scenarios.", flat_scenarios->size());
+    log::debug(": Indexing {} scenarios.", flat_scenarios->size());
     for (auto const& scenario : *flat_scenarios) {
-      log::debug("Scenario {} configs:", scenario->name()->c_str());
-      auto configs = AudioSetConfigurationsFromFlatScenario(scenario);
-      for (auto& config : configs) {
-        log::debug("\t\t Audio set config: {}", config->name);
-      }
-
       auto [it_begin, it_end] =
           ScenarioToContextTypes(scenario->name()->c_str());
       for (auto it = it_begin; it != it_end; ++it) {
-        context_configurations_.insert_or_assign(
-            it->second, AudioSetConfigurationsFromFlatScenario(scenario));
+        context_scenarios_.insert_or_assign(it->second, scenario);
       }
     }
 
+    scenarios_content_.push_back(std::move(content));
     return true;
   }
 
-  bool LoadContent(
-      std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
-          config_files,
-      std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
-          scenario_files,
-      types::CodecLocation location) {
-    for (auto [schema, content] : config_files) {
-      if (!LoadConfigurationsFromFiles(schema, content, location)) return false;
+  bool LoadContent(const std::vector<ContentFiles>& config_files,
+                   const std::vector<ContentFiles>& scenario_files) {
+    for (auto const& files : config_files) {
+      if (!LoadConfigurationsFromFiles(files)) return false;
     }
 
-    for (auto [schema, content] : scenario_files) {
-      if (!LoadScenariosFromFiles(schema, content)) return false;
+    for (auto const& files : scenario_files) {
+      if (!LoadScenariosFromFiles(files)) return false;
     }
     return true;
   }
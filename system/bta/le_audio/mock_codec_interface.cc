@@ -47,7 +47,8 @@ CodecInterface::Status CodecInterface::InitDecoder(
 std::vector<int16_t>& CodecInterface::GetDecodedSamples() {
   return impl->GetDecodedSamples();
 }
-CodecInterface::Status CodecInterface::Decode(uint8_t* data, uint16_t size) {
+CodecInterface::Status CodecInterface::Decode(const uint8_t* data,
+                                              uint16_t size) {
   return impl->Decode(data, size);
 }
 CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
@@ -56,6 +57,10 @@ CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
                                               uint16_t out_offset) {
   return impl->Encode(data, stride, out_size, out_buffer, out_offset);
 }
+CodecInterface::Status CodecInterface::Encode(const uint8_t* data, int stride,
+                                              uint8_t* out, uint16_t out_size) {
+  return impl->Encode(data, stride, out, out_size);
+}
 void CodecInterface::Cleanup() { return impl->Cleanup(); }
 
 uint16_t CodecInterface::GetNumOfSamplesPerChannel() {
@@ -64,4 +69,21 @@ uint16_t CodecInterface::GetNumOfSamplesPerChannel() {
 uint8_t CodecInterface::GetNumOfBytesPerSample() {
   return impl->GetNumOfBytesPerSample();
 };
+
+// Encodes the channels in turn, on the calling thread.
+struct CodecBatchEncoder::Impl {};
+CodecBatchEncoder::CodecBatchEncoder(size_t max_workers) : impl(nullptr) {}
+CodecBatchEncoder::~CodecBatchEncoder() = default;
+CodecInterface::Status CodecBatchEncoder::Encode(
+    const uint8_t* data, int stride, const std::vector<Channel>& channels,
+    std::chrono::microseconds deadline) {
+  auto status = CodecInterface::Status::STATUS_OK;
+  for (auto const& channel : channels) {
+    auto channel_status = channel.codec->Encode(
+        data + channel.pcm_offset, stride, channel.out, channel.out_size);
+    if (status == CodecInterface::Status::STATUS_OK) status = channel_status;
+  }
+  return status;
+}
+CodecBatchEncoder::Stats CodecBatchEncoder::GetStats() { return {}; }
 }  // namespace bluetooth::le_audio
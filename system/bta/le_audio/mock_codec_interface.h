@@ -41,8 +41,11 @@ class MockCodecInterface {
   MOCK_METHOD(bluetooth::le_audio::CodecInterface::Status, Encode,
               (const uint8_t* data, int stride, uint16_t out_size,
                std::vector<int16_t>* out_buffer, uint16_t out_offset));
+  MOCK_METHOD(bluetooth::le_audio::CodecInterface::Status, Encode,
+              (const uint8_t* data, int stride, uint8_t* out,
+               uint16_t out_size));
   MOCK_METHOD(bluetooth::le_audio::CodecInterface::Status, Decode,
-              (uint8_t * data, uint16_t size));
+              (const uint8_t* data, uint16_t size));
   MOCK_METHOD((void), Cleanup, ());
   MOCK_METHOD((bool), IsReady, ());
   MOCK_METHOD((uint16_t), GetNumOfSamplesPerChannel, ());
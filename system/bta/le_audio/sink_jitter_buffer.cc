@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sink_jitter_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace bluetooth::le_audio {
+
+namespace {
+/* The target headroom covers this many times the mean jitter */
+constexpr int64_t kJitterTargetFactor = 3;
+}  // namespace
+
+SinkJitterBuffer::SinkJitterBuffer(const Config& config) : config_(config) {
+  config_.frame_interval_us = std::max<uint32_t>(config_.frame_interval_us, 1);
+  config_.max_headroom_us =
+      std::max(config_.max_headroom_us, config_.min_headroom_us);
+  Reset();
+}
+
+void SinkJitterBuffer::Reset() {
+  stats_ = {};
+  started_ = false;
+  jitter_x16_us_ = 0;
+  target_headroom_us_ = config_.min_headroom_us;
+  stats_.target_headroom_us = target_headroom_us_;
+  frames_written_ = 0;
+  window_sdus_ = 0;
+}
+
+uint32_t SinkJitterBuffer::FramesForTarget() const {
+  return (target_headroom_us_ + config_.frame_interval_us - 1) /
+         config_.frame_interval_us;
+}
+
+void SinkJitterBuffer::UpdateJitter(int64_t transit_delta_us) {
+  /* RFC 3550, 6.4.1: J += (|D| - J) / 16 */
+  jitter_x16_us_ += std::abs(transit_delta_us) - ((jitter_x16_us_ + 8) >> 4);
+  stats_.jitter_us = static_cast<uint32_t>(jitter_x16_us_ >> 4);
+
+  int64_t target = kJitterTargetFactor * stats_.jitter_us;
+  target_headroom_us_ = static_cast<uint32_t>(
+      std::clamp<int64_t>(target, config_.min_headroom_us,
+                          config_.max_headroom_us));
+  stats_.target_headroom_us = target_headroom_us_;
+}
+
+SinkJitterBuffer::Action SinkJitterBuffer::OnSdu(uint64_t arrival_us,
+                                                 uint32_t sdu_ts_us) {
+  const uint32_t interval = config_.frame_interval_us;
+  Action action;
+
+  stats_.num_sdus++;
+
+  if (!started_) {
+    started_ = true;
+    last_arrival_us_ = arrival_us;
+    last_ts_us_ = sdu_ts_us;
+    playout_start_us_ = arrival_us;
+
+    action.num_concealed = FramesForTarget();
+    stats_.num_padded += action.num_concealed;
+    frames_written_ = action.num_concealed + 1;
+    window_sdus_ = 0;
+    return action;
+  }
+
+  /* Controllers not providing the timestamps leave them equal, assume no loss
+   * then. The timestamps wrap around every ~71 minutes. */
+  uint32_t ts_delta_us = sdu_ts_us - last_ts_us_;
+  if (ts_delta_us == 0) ts_delta_us = interval;
+  uint32_t num_intervals = (ts_delta_us + interval / 2) / interval;
+
+  if (num_intervals > 1) {
+    uint32_t num_lost = std::min(num_intervals - 1, kMaxConcealedFrames);
+    action.num_concealed += num_lost;
+    stats_.num_lost += num_lost;
+  }
+
+  UpdateJitter(static_cast<int64_t>(arrival_us - last_arrival_us_) -
+               static_cast<int64_t>(ts_delta_us));
+  last_arrival_us_ = arrival_us;
+  last_ts_us_ = sdu_ts_us;
+
+  /* Headroom left right before writing the frame of this SDU, the lost frames
+   * accounted as if they were written on time */
+  int64_t headroom_us =
+      static_cast<int64_t>((frames_written_ + action.num_concealed) *
+                           interval) -
+      static_cast<int64_t>(arrival_us - playout_start_us_);
+
+  if (headroom_us < 0) {
+    /* The buffer ran dry, the framework got silence meanwhile. Restart the
+     * model and build the headroom up again. */
+    stats_.num_underruns++;
+    playout_start_us_ = arrival_us;
+    frames_written_ = 0;
+    action.num_concealed = FramesForTarget();
+    stats_.num_padded += action.num_concealed;
+    window_sdus_ = 0;
+  } else if (headroom_us < target_headroom_us_) {
+    /* Running low, grow by a single frame to keep the correction smooth */
+    action.num_concealed++;
+    stats_.num_padded++;
+    window_sdus_ = 0;
+  } else {
+    if (window_sdus_ == 0 || headroom_us < window_min_headroom_us_) {
+      window_min_headroom_us_ = headroom_us;
+    }
+
+    if (++window_sdus_ >= kDropWindowSdus) {
+      if (window_min_headroom_us_ >= target_headroom_us_ + interval) {
+        /* Steadily more than a frame above the target */
+        action.write_frame = false;
+        stats_.num_dropped++;
+      }
+      window_sdus_ = 0;
+    }
+  }
+
+  frames_written_ += action.num_concealed + (action.write_frame ? 1 : 0);
+  return action;
+}
+
+}  // namespace bluetooth::le_audio
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace bluetooth::le_audio {
+
+/* Adaptive jitter buffer of the LE Audio sink path, the audio received from
+ * the remote microphones.
+ *
+ * The audio framework pulls the decoded audio at its own pace from the buffer
+ * the HAL client writes into. This class models the fill level (headroom) of
+ * that buffer from the local arrival time and the controller timestamp of each
+ * SDU, and tells the caller how many frames to write for it:
+ *  - at stream start, enough concealed frames to build up the target headroom,
+ *  - one concealed frame for each SDU missing from the timestamp sequence,
+ *  - one more concealed frame when the headroom runs below the target, due to
+ *    late SDUs or to the remote clock running slower than the local one,
+ *  - no frame at all when the headroom stays above the target for a while,
+ *    which also absorbs the remote clock running faster than the local one.
+ * The target headroom follows the SDU arrival jitter, within the configured
+ * bounds. The concealed frames are meant to be produced by the codec PLC.
+ */
+class SinkJitterBuffer {
+ public:
+  struct Config {
+    uint32_t frame_interval_us;
+    uint32_t min_headroom_us;
+    uint32_t max_headroom_us;
+  };
+
+  struct Stats {
+    uint64_t num_sdus = 0;
+    /* SDUs missing from the timestamp sequence */
+    uint64_t num_lost = 0;
+    /* Concealed frames written to build up the headroom */
+    uint64_t num_padded = 0;
+    /* Frames dropped to reduce the headroom */
+    uint64_t num_dropped = 0;
+    /* Times the modelled buffer ran dry and the headroom was rebuilt */
+    uint64_t num_underruns = 0;
+    uint32_t jitter_us = 0;
+    uint32_t target_headroom_us = 0;
+  };
+
+  /* What to write to the audio framework for a received SDU */
+  struct Action {
+    /* Concealed frames to write before the frame of the SDU */
+    uint32_t num_concealed = 0;
+    /* Whether to write the frame of the SDU */
+    bool write_frame = true;
+  };
+
+  /* Upper bound of the concealed frames for a single SDU */
+  static constexpr uint32_t kMaxConcealedFrames = 16;
+  /* Number of SDUs over which the headroom must stay above the target before a
+   * frame is dropped */
+  static constexpr uint32_t kDropWindowSdus = 100;
+
+  explicit SinkJitterBuffer(const Config& config);
+
+  /* Restarts the buffer model, on a new stream */
+  void Reset();
+
+  /* Accounts a SDU received at the local `arrival_us` time, with the controller
+   * `sdu_ts_us` timestamp, and returns the frames to write for it */
+  Action OnSdu(uint64_t arrival_us, uint32_t sdu_ts_us);
+
+  const Stats& GetStats() const { return stats_; }
+
+ private:
+  uint32_t FramesForTarget() const;
+  void UpdateJitter(int64_t transit_delta_us);
+
+  Config config_;
+  Stats stats_;
+
+  bool started_ = false;
+  uint64_t last_arrival_us_ = 0;
+  uint32_t last_ts_us_ = 0;
+  /* Jitter estimate, scaled by 16 as in RFC 3550 */
+  int64_t jitter_x16_us_ = 0;
+  uint32_t target_headroom_us_ = 0;
+
+  /* Playout model: the framework consumes one frame per interval since
+   * `playout_start_us_` */
+  uint64_t playout_start_us_ = 0;
+  uint64_t frames_written_ = 0;
+
+  uint32_t window_sdus_ = 0;
+  int64_t window_min_headroom_us_ = 0;
+};
+
+}  // namespace bluetooth::le_audio
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sink_jitter_buffer.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::le_audio {
+
+namespace {
+constexpr uint32_t kIntervalUs = 10000;
+constexpr uint32_t kMinHeadroomUs = 20000;
+constexpr uint32_t kMaxHeadroomUs = 80000;
+constexpr uint64_t kStartUs = 1000000;
+}  // namespace
+
+class SinkJitterBufferTest : public ::testing::Test {
+ protected:
+  SinkJitterBuffer buffer_{{.frame_interval_us = kIntervalUs,
+                            .min_headroom_us = kMinHeadroomUs,
+                            .max_headroom_us = kMaxHeadroomUs}};
+};
+
+TEST_F(SinkJitterBufferTest, PrimesTheHeadroomOnFirstSdu) {
+  auto action = buffer_.OnSdu(kStartUs, 0);
+  ASSERT_EQ(action.num_concealed, kMinHeadroomUs / kIntervalUs);
+  ASSERT_TRUE(action.write_frame);
+  ASSERT_EQ(buffer_.GetStats().num_padded, kMinHeadroomUs / kIntervalUs);
+}
+
+TEST_F(SinkJitterBufferTest, SteadyStreamPassesThrough) {
+  buffer_.OnSdu(kStartUs, 0);
+  for (uint32_t i = 1; i < 1000; i++) {
+    auto action = buffer_.OnSdu(kStartUs + i * kIntervalUs, i * kIntervalUs);
+    ASSERT_EQ(action.num_concealed, 0u);
+    ASSERT_TRUE(action.write_frame);
+  }
+
+  auto stats = buffer_.GetStats();
+  ASSERT_EQ(stats.num_sdus, 1000u);
+  ASSERT_EQ(stats.num_lost, 0u);
+  ASSERT_EQ(stats.num_dropped, 0u);
+  ASSERT_EQ(stats.num_underruns, 0u);
+  ASSERT_EQ(stats.jitter_us, 0u);
+}
+
+TEST_F(SinkJitterBufferTest, ConcealsLostSdus) {
+  buffer_.OnSdu(kStartUs, 0);
+  buffer_.OnSdu(kStartUs + kIntervalUs, kIntervalUs);
+
+  /* Two SDUs missing */
+  auto action = buffer_.OnSdu(kStartUs + 4 * kIntervalUs, 4 * kIntervalUs);
+  ASSERT_EQ(action.num_concealed, 2u);
+  ASSERT_TRUE(action.write_frame);
+  ASSERT_EQ(buffer_.GetStats().num_lost, 2u);
+}
+
+TEST_F(SinkJitterBufferTest, HandlesTimestampWrapAround) {
+  uint32_t ts = UINT32_MAX - kIntervalUs / 2;
+  buffer_.OnSdu(kStartUs, ts);
+  auto action = buffer_.OnSdu(kStartUs + kIntervalUs, ts + kIntervalUs);
+  ASSERT_EQ(action.num_concealed, 0u);
+  ASSERT_EQ(buffer_.GetStats().num_lost, 0u);
+}
+
+TEST_F(SinkJitterBufferTest, PadsWhenRemoteClockIsSlower) {
+  /* The remote sends a frame every 10.1 ms of local time */
+  constexpr uint32_t kRemoteIntervalUs = kIntervalUs + 100;
+  buffer_.OnSdu(kStartUs, 0);
+  for (uint32_t i = 1; i < 1000; i++) {
+    buffer_.OnSdu(kStartUs + i * kRemoteIntervalUs, i * kIntervalUs);
+  }
+
+  /* 100 ms of drift over 1000 frames needs about 10 more frames, with no
+   * underrun */
+  auto stats = buffer_.GetStats();
+  ASSERT_EQ(stats.num_underruns, 0u);
+  ASSERT_GE(stats.num_padded, kMinHeadroomUs / kIntervalUs + 9);
+  ASSERT_LE(stats.num_padded, kMinHeadroomUs / kIntervalUs + 11);
+  ASSERT_EQ(stats.num_dropped, 0u);
+}
+
+TEST_F(SinkJitterBufferTest, DropsWhenRemoteClockIsFaster) {
+  /* The remote sends a frame every 9.9 ms of local time */
+  constexpr uint32_t kRemoteIntervalUs = kIntervalUs - 100;
+  buffer_.OnSdu(kStartUs, 0);
+  for (uint32_t i = 1; i < 10000; i++) {
+    buffer_.OnSdu(kStartUs + i * kRemoteIntervalUs, i * kIntervalUs);
+  }
+
+  /* 1 s of drift over 10000 frames, dropped one frame at a time at most once
+   * per window */
+  auto stats = buffer_.GetStats();
+  ASSERT_EQ(stats.num_underruns, 0u);
+  ASSERT_GE(stats.num_dropped, 90u);
+  ASSERT_LE(stats.num_dropped, 100u);
+}
+
+TEST_F(SinkJitterBufferTest, TargetFollowsJitter) {
+  buffer_.OnSdu(kStartUs, 0);
+  for (uint32_t i = 1; i < 200; i++) {
+    /* Every other SDU is 8 ms late */
+    uint64_t late_us = (i % 2) ? 8000 : 0;
+    buffer_.OnSdu(kStartUs + i * kIntervalUs + late_us, i * kIntervalUs);
+  }
+
+  auto stats = buffer_.GetStats();
+  ASSERT_NEAR(stats.jitter_us, 8000u, 500u);
+  ASSERT_EQ(stats.target_headroom_us, 3 * stats.jitter_us);
+  ASSERT_EQ(stats.num_underruns, 0u);
+}
+
+TEST_F(SinkJitterBufferTest, TargetIsBounded) {
+  buffer_.OnSdu(kStartUs, 0);
+  for (uint32_t i = 1; i < 200; i++) {
+    uint64_t late_us = (i % 2) ? 50000 : 0;
+    buffer_.OnSdu(kStartUs + i * kIntervalUs + late_us, i * kIntervalUs);
+  }
+
+  ASSERT_EQ(buffer_.GetStats().target_headroom_us, kMaxHeadroomUs);
+}
+
+TEST_F(SinkJitterBufferTest, RebuildsHeadroomAfterUnderrun) {
+  buffer_.OnSdu(kStartUs, 0);
+
+  /* Nothing received for 100 ms, the timestamps not telling about it */
+  auto action = buffer_.OnSdu(kStartUs + 10 * kIntervalUs, kIntervalUs);
+  ASSERT_EQ(buffer_.GetStats().num_underruns, 1u);
+  ASSERT_GE(action.num_concealed, kMinHeadroomUs / kIntervalUs);
+  ASSERT_TRUE(action.write_frame);
+}
+
+TEST_F(SinkJitterBufferTest, Reset) {
+  buffer_.OnSdu(kStartUs, 0);
+  buffer_.OnSdu(kStartUs + 4 * kIntervalUs, 4 * kIntervalUs);
+  buffer_.Reset();
+
+  ASSERT_EQ(buffer_.GetStats().num_sdus, 0u);
+  ASSERT_EQ(buffer_.GetStats().num_lost, 0u);
+
+  auto action = buffer_.OnSdu(2 * kStartUs, 0);
+  ASSERT_EQ(action.num_concealed, kMinHeadroomUs / kIntervalUs);
+}
+
+}  // namespace bluetooth::le_audio
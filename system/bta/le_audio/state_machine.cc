@@ -1316,6 +1316,8 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
   static constexpr uint64_t kStateTransitionTimeoutMs = 3500;
   static constexpr char kStateTransitionTimeoutMsProp[] =
       "persist.bluetooth.leaudio.device.set.state.timeoutms";
+  static constexpr char kPipelinedGroupStartProp[] =
+      "bluetooth.leaudio.pipelined_group_start.enabled";
   Callbacks* state_machine_callbacks_;
   alarm_t* watchdog_;
   LeAudioLogHistory* log_history_;
@@ -2364,6 +2366,17 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return;
         }
 
+        if (group->GetTargetState() ==
+                AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING &&
+            osi_property_get_bool(kPipelinedGroupStartProp, false)) {
+          /* Enable the device without waiting for the rest of the group. The
+           * CISes are still created for the whole group at once, when all
+           * the devices are ready to create the stream.
+           */
+          PrepareAndSendEnable(leAudioDevice);
+          return;
+        }
+
         if (!group->HaveAllActiveDevicesAsesTheSameState(
                 AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED)) {
           log::debug("Waiting for all the devices to be in QoS state");
@@ -65,7 +65,7 @@ std::string nap_service_name;  /* Service name for NAP role */
  ******************************************************************************/
 void BTA_PanEnable(tBTA_PAN_CBACK p_cback) {
   tBTA_PAN_API_ENABLE* p_buf =
-      (tBTA_PAN_API_ENABLE*)osi_malloc(sizeof(tBTA_PAN_API_ENABLE));
+      (tBTA_PAN_API_ENABLE*)bta_sys_msg_alloc(sizeof(tBTA_PAN_API_ENABLE));
 
   /* register with BTA system manager */
   bta_sys_register(BTA_ID_PAN, &bta_pan_reg);
@@ -87,7 +87,7 @@ void BTA_PanEnable(tBTA_PAN_CBACK p_cback) {
  *
  ******************************************************************************/
 void BTA_PanDisable(void) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   bta_sys_deregister(BTA_ID_PAN);
   p_buf->event = BTA_PAN_API_DISABLE_EVT;
@@ -153,7 +153,7 @@ void BTA_PanSetRole(tBTA_PAN_ROLE role, const tBTA_PAN_ROLE_INFO user_info,
 void BTA_PanOpen(const RawAddress& bd_addr, tBTA_PAN_ROLE local_role,
                  tBTA_PAN_ROLE peer_role) {
   tBTA_PAN_API_OPEN* p_buf =
-      (tBTA_PAN_API_OPEN*)osi_malloc(sizeof(tBTA_PAN_API_OPEN));
+      (tBTA_PAN_API_OPEN*)bta_sys_msg_alloc(sizeof(tBTA_PAN_API_OPEN));
 
   p_buf->hdr.event = BTA_PAN_API_OPEN_EVT;
   p_buf->local_role = local_role;
@@ -174,7 +174,7 @@ void BTA_PanOpen(const RawAddress& bd_addr, tBTA_PAN_ROLE local_role,
  *
  ******************************************************************************/
 void BTA_PanClose(uint16_t handle) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = BTA_PAN_API_CLOSE_EVT;
   p_buf->layer_specific = handle;
@@ -231,11 +231,13 @@ void bta_sys_init(void);
 void bta_sys_register(uint8_t id, const tBTA_SYS_REG* p_reg);
 void bta_sys_deregister(uint8_t id);
 bool bta_sys_is_register(uint8_t id);
+void* bta_sys_msg_alloc(size_t size);
 void bta_sys_sendmsg(void* p_msg);
 void bta_sys_sendmsg_delayed(void* p_msg, std::chrono::microseconds delay);
 void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms, uint16_t event,
                          uint16_t layer_specific);
 void bta_sys_disable();
+void bta_sys_debug_dump(int fd);
 
 void bta_sys_rm_register(tBTA_SYS_CONN_CBACK* p_cback);
 void bta_sys_pm_register(tBTA_SYS_CONN_CBACK* p_cback);
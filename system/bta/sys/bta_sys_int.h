@@ -66,6 +66,8 @@ typedef struct {
   /* VS event handler */
   tBTA_SYS_VS_EVT_HDLR* p_vs_evt_hdlr;
 
+  uint64_t msg_count[BTA_ID_MAX]; /* messages handled per subsystem */
+
 } tBTA_SYS_CB;
 
 /*****************************************************************************
@@ -27,6 +27,7 @@
 #include <base/functional/bind.h>
 #include <bluetooth/log.h>
 
+#include <cstdio>
 #include <cstring>
 
 #include "bta/sys/bta_sys.h"
@@ -36,6 +37,7 @@
 #include "os/log.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_pool.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/main_thread.h"
 
@@ -78,6 +80,7 @@ static void bta_sys_event(BT_HDR_RIGID* p_msg) {
 
   /* verify id and call subsystem event handler */
   if ((id < BTA_ID_MAX) && (bta_sys_cb.reg[id] != NULL)) {
+    bta_sys_cb.msg_count[id]++;
     freebuf = (*bta_sys_cb.reg[id]->evt_hdlr)(p_msg);
   } else {
     log::info("Ignoring receipt of unregistered event id:{}[{}]",
@@ -131,6 +134,24 @@ void bta_sys_deregister(uint8_t id) { bta_sys_cb.is_reg[id] = false; }
  ******************************************************************************/
 bool bta_sys_is_register(uint8_t id) { return bta_sys_cb.is_reg[id]; }
 
+/*******************************************************************************
+ *
+ * Function         bta_sys_msg_alloc
+ *
+ * Description      Allocate a zeroed message for bta_sys_sendmsg. Messages
+ *                  come from the buffer pool so that the steady state BTA
+ *                  messaging does not go through the heap allocator. They are
+ *                  released with osi_free like any other message.
+ *
+ * Returns          pointer to the message
+ *
+ ******************************************************************************/
+void* bta_sys_msg_alloc(size_t size) {
+  void* p_msg = buffer_pool_alloc(size);
+  memset(p_msg, 0, size);
+  return p_msg;
+}
+
 /*******************************************************************************
  *
  * Function         bta_sys_sendmsg
@@ -176,7 +197,7 @@ void bta_sys_sendmsg_delayed(void* p_msg, std::chrono::microseconds delay) {
  ******************************************************************************/
 void bta_sys_start_timer(alarm_t* alarm, uint64_t interval_ms, uint16_t event,
                          uint16_t layer_specific) {
-  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)osi_malloc(sizeof(BT_HDR_RIGID));
+  BT_HDR_RIGID* p_buf = (BT_HDR_RIGID*)bta_sys_msg_alloc(sizeof(BT_HDR_RIGID));
 
   p_buf->event = event;
   p_buf->layer_specific = layer_specific;
@@ -206,3 +227,22 @@ void bta_sys_disable() {
     }
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_sys_debug_dump
+ *
+ * Description      Dump the number of messages handled by each subsystem.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_sys_debug_dump(int fd) {
+  dprintf(fd, "\nBTA System Messages:\n");
+  for (int id = 0; id < BTA_ID_MAX; id++) {
+    if (bta_sys_cb.msg_count[id] == 0) continue;
+    dprintf(fd, "  %-24s: %llu\n",
+            BtaIdSysText(static_cast<tBTA_SYS_ID>(id)).c_str(),
+            (unsigned long long)bta_sys_cb.msg_count[id]);
+  }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+
+#include "bta/ag/bta_ag_at.h"
+
+using ::benchmark::State;
+
+namespace {
+
+/* Commands of the HFP AG table in the same order, the parser only looks at
+ * the strings and the argument types */
+constexpr tBTA_AG_AT_CMD kHfpCmds[] = {
+    {"A", 0, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"D", 1, BTA_AG_AT_NONE | BTA_AG_AT_FREE, BTA_AG_AT_STR, 0, 0},
+    {"+VGS", 2, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
+    {"+VGM", 3, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
+    {"+CCWA", 4, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+CHLD", 5, BTA_AG_AT_SET | BTA_AG_AT_TEST, BTA_AG_AT_STR, 0, 4},
+    {"+CHUP", 6, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+CIND", 7, BTA_AG_AT_READ | BTA_AG_AT_TEST, BTA_AG_AT_STR, 0, 0},
+    {"+CLIP", 8, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+CMER", 9, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+VTS", 10, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+BINP", 11, BTA_AG_AT_SET, BTA_AG_AT_INT, 1, 1},
+    {"+BLDN", 12, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+BVRA", 13, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+BRSF", 14, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 32767},
+    {"+NREC", 15, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 0},
+    {"+CNUM", 16, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+BTRH", 17, BTA_AG_AT_READ | BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 2},
+    {"+CLCC", 18, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+COPS", 19, BTA_AG_AT_READ | BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+CMEE", 20, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+BIA", 21, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 20},
+    {"+CBC", 22, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 100},
+    {"+BCC", 23, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+BCS", 24, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 32767},
+    {"+BIND", 25, BTA_AG_AT_SET | BTA_AG_AT_READ | BTA_AG_AT_TEST,
+     BTA_AG_AT_STR, 0, 0},
+    {"+BIEV", 26, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+BAC", 27, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+%QAC", 28, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+%QCS", 29, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 32767},
+    {"", 0, 0, 0, 0, 0}};
+
+constexpr tBTA_AG_AT_INDEX kHfpIndex = bta_ag_at_make_index(kHfpCmds);
+
+uint32_t num_commands;
+
+void CmdCback(tBTA_AG_SCB* /* p_user */, uint16_t /* command_id */,
+              uint8_t /* arg_type */, char* /* p_arg */, char* /* p_end */,
+              int16_t /* int_arg */) {
+  num_commands++;
+}
+
+void ErrCback(tBTA_AG_SCB* /* p_user */, bool /* unknown */,
+              const char* /* p_arg */) {}
+
+/* Exchanges of a carkit polling the calls and reporting its battery level
+ * during a call */
+void ParseCallSession(State& state, const tBTA_AG_AT_INDEX* p_at_idx) {
+  std::string commands =
+      "AT+CLCC\rAT+CIND?\rAT+CBC=80\rAT+VGS=11\rAT+BIEV=2,80\rAT+CHLD=1\r"
+      "AT+COPS?\rAT+CLCC\r";
+  tBTA_AG_AT_CB at_cb = {
+      .p_at_tbl = kHfpCmds,
+      .p_at_idx = p_at_idx,
+      .p_cmd_cback = CmdCback,
+      .p_err_cback = ErrCback,
+      .p_user = nullptr,
+      .cmd_max_len = 512,
+  };
+  bta_ag_at_init(&at_cb);
+  for (auto _ : state) {
+    bta_ag_at_parse(&at_cb, commands.data(), commands.size());
+  }
+  bta_ag_at_reinit(&at_cb);
+  benchmark::DoNotOptimize(num_commands);
+  state.SetItemsProcessed(state.iterations() * 8);
+}
+
+void BM_TableScan(State& state) { ParseCallSession(state, nullptr); }
+
+void BM_HashIndex(State& state) { ParseCallSession(state, &kHfpIndex); }
+
+}  // namespace
+
+BENCHMARK(BM_TableScan);
+BENCHMARK(BM_HashIndex);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "bta/ag/bta_ag_int.h"
 #include "bta/include/bta_ag_swb_aptx.h"
@@ -364,6 +365,34 @@ TEST_F_WITH_FLAGS(BtaAgCmdTest,
   ASSERT_TRUE(enable_aptx_voice_property(false));
 }
 
+TEST_F(BtaAgCmdTest, indicator_updates_are_merged) {
+  tBTA_AG_SCB* p_scb = &bta_ag_cb.scb[0];
+  p_scb->conn_service = BTA_AG_HFP;
+  p_scb->cmer_enabled = true;
+  p_scb->ind_timer = alarm_new("bta_ag.scb_ind_timer");
+
+  tBTA_AG_DATA data = {.api_result = {.result = BTA_AG_IND_RES}};
+  data.api_result.data.ind = {.id = BTA_AG_IND_SERVICE, .value = 1};
+  bta_ag_result(p_scb, data);
+  data.api_result.data.ind = {.id = BTA_AG_IND_SIGNAL, .value = 4};
+  bta_ag_result(p_scb, data);
+  // Status indicators wait for the end of the coalescing window
+  ASSERT_EQ(0, get_func_call_count("PORT_WriteData"));
+  ASSERT_EQ(p_scb->ind_pending,
+            (1u << BTA_AG_IND_SERVICE) | (1u << BTA_AG_IND_SIGNAL));
+
+  // Both call indicators change and go out with the pending ones
+  p_scb->callsetup_ind = BTA_AG_CALLSETUP_OUTGOING;
+  bta_ag_send_call_inds(p_scb, BTA_AG_OUT_CALL_CONN_RES);
+  ASSERT_EQ(1, get_func_call_count("PORT_WriteData"));
+  ASSERT_EQ(p_scb->ind_pending, 0u);
+  ASSERT_EQ(p_scb->call_ind, BTA_AG_CALL_ACTIVE);
+  ASSERT_EQ(p_scb->callsetup_ind, BTA_AG_CALLSETUP_NONE);
+
+  alarm_free(p_scb->ind_timer);
+  *p_scb = {};
+}
+
 class BtaAgScoTest : public BtaAgTest {
  protected:
   void SetUp() override {
@@ -442,3 +471,57 @@ TEST_F_WITH_FLAGS(BtaAgScoTest, codec_negotiate__aptx_disabled,
   ASSERT_EQ(0, get_func_call_count("alarm_set_on_mloop"));
   ASSERT_FALSE(p_scb->codec_updated);
 }
+
+namespace {
+
+std::vector<uint16_t> at_command_ids;
+
+void at_cmd_cback(tBTA_AG_SCB* /* p_user */, uint16_t command_id,
+                  uint8_t /* arg_type */, char* /* p_arg */, char* /* p_end */,
+                  int16_t /* int_arg */) {
+  at_command_ids.push_back(command_id);
+}
+
+void at_err_cback(tBTA_AG_SCB* /* p_user */, bool /* unknown */,
+                  const char* /* p_arg */) {
+  at_command_ids.push_back(UINT16_MAX);
+}
+
+// Returns the ids of the commands parsed in |commands|, UINT16_MAX for the
+// ones rejected
+std::vector<uint16_t> ParseHfpAtCommands(const tBTA_AG_AT_INDEX* p_at_idx,
+                                         std::string commands) {
+  tBTA_AG_AT_CB at_cb = {
+      .p_at_tbl = bta_ag_at_tbl[BTA_AG_HFP],
+      .p_at_idx = p_at_idx,
+      .p_cmd_cback = at_cmd_cback,
+      .p_err_cback = at_err_cback,
+      .p_user = nullptr,
+      .cmd_max_len = 512,
+  };
+  bta_ag_at_init(&at_cb);
+  at_command_ids.clear();
+  bta_ag_at_parse(&at_cb, commands.data(), commands.size());
+  bta_ag_at_reinit(&at_cb);
+  return at_command_ids;
+}
+
+}  // namespace
+
+TEST(BtaAgAtTest, indexed_lookup_matches_table_scan) {
+  std::string commands;
+  for (const tBTA_AG_AT_CMD* p_cmd = bta_ag_at_tbl[BTA_AG_HFP];
+       p_cmd->p_cmd[0] != 0; p_cmd++) {
+    for (const char* arg : {"", "?", "=?", "=1"}) {
+      commands += std::string("AT") + p_cmd->p_cmd + arg + "\r";
+    }
+  }
+  commands += "at+clcc\rATD5551234;\rAT+XAPL=ABCD-1234-0100,10\rAT+C\r";
+
+  auto ids = ParseHfpAtCommands(bta_ag_at_idx[BTA_AG_HFP], commands);
+  ASSERT_EQ(ids, ParseHfpAtCommands(nullptr, commands));
+
+  ids = ParseHfpAtCommands(bta_ag_at_idx[BTA_AG_HFP], "AT+CLCC\rAT+CMEE=1\r");
+  ASSERT_EQ(ids, std::vector<uint16_t>(
+                     {BTA_AG_AT_CLCC_EVT, BTA_AG_LOCAL_EVT_CMEE}));
+}
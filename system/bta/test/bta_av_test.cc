@@ -18,10 +18,15 @@
 #include <base/location.h>
 #include <gtest/gtest.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "bta/av/bta_av_int.h"
 #include "bta/hf_client/bta_hf_client_int.h"
 #include "common/init_flags.h"
 #include "test/common/mock_functions.h"
+#include "test/mock/mock_btif_config.h"
 #include "test/mock/mock_osi_alarm.h"
 #include "test/mock/mock_stack_acl.h"
 
@@ -72,3 +77,120 @@ TEST_F(BtaAvTest, bta_av_rc_opened) {
   };
   bta_av_rc_opened(&cb, &data);
 }
+
+class BtaAvSepCacheTest : public BtaAvTest {
+ protected:
+  void SetUp() override {
+    BtaAvTest::SetUp();
+    test::mock::btif_config::btif_config_get_bin_length.body =
+        [this](const std::string& section, const std::string& key) {
+          auto it = storage_.find(section + "/" + key);
+          return it == storage_.end() ? 0 : it->second.size();
+        };
+    test::mock::btif_config::btif_config_get_bin.body =
+        [this](const std::string& section, const std::string& key,
+               uint8_t* value, size_t* length) {
+          auto it = storage_.find(section + "/" + key);
+          if (it == storage_.end() || *length < it->second.size()) {
+            return false;
+          }
+          std::copy(it->second.begin(), it->second.end(), value);
+          *length = it->second.size();
+          return true;
+        };
+    test::mock::btif_config::btif_config_set_bin.body =
+        [this](const std::string& section, const std::string& key,
+               const uint8_t* value, size_t length) {
+          storage_[section + "/" + key].assign(value, value + length);
+          return true;
+        };
+    test::mock::btif_config::btif_config_remove.body =
+        [this](const std::string& section, const std::string& key) {
+          return storage_.erase(section + "/" + key) != 0;
+        };
+  }
+  void TearDown() override {
+    test::mock::btif_config::btif_config_get_bin_length = {};
+    test::mock::btif_config::btif_config_get_bin = {};
+    test::mock::btif_config::btif_config_set_bin = {};
+    test::mock::btif_config::btif_config_remove = {};
+    BtaAvTest::TearDown();
+  }
+
+  std::map<std::string, std::vector<uint8_t>> storage_;
+};
+
+TEST_F(BtaAvSepCacheTest, discover_req_without_stored_seps) {
+  tBTA_AV_SCB scb{};
+  scb.OnConnected(kRawAddress);
+  scb.state = BTA_AV_OPENING_SST;
+
+  bta_av_discover_req(&scb, nullptr);
+  ASSERT_EQ(1, get_func_call_count("AVDT_DiscoverReq"));
+  ASSERT_FALSE(scb.sep_cache_used);
+  ASSERT_TRUE(scb.sep_cache_changed);
+}
+
+TEST_F(BtaAvSepCacheTest, discover_req_with_stored_seps) {
+  tBTA_AV_SCB discovered{};
+  discovered.OnConnected(kRawAddress);
+  discovered.num_seps = 2;
+  discovered.sep_info[0] = {.in_use = true,
+                            .seid = 1,
+                            .media_type = AVDT_MEDIA_TYPE_AUDIO,
+                            .tsep = AVDT_TSEP_SNK};
+  discovered.sep_info[1] = {.in_use = false,
+                            .seid = 2,
+                            .media_type = AVDT_MEDIA_TYPE_AUDIO,
+                            .tsep = AVDT_TSEP_SNK};
+  discovered.peer_caps[1].codec_info[0] = 6;
+  discovered.peer_caps[1].num_codec = 1;
+  discovered.peer_caps[1].psc_mask = AVDT_PSC_DELAY_RPT;
+  discovered.peer_caps_mask = 1u << 1;
+  bta_av_sep_cache_store(&discovered);
+
+  tBTA_AV_SCB scb{};
+  scb.OnConnected(kRawAddress);
+  scb.state = BTA_AV_OPENING_SST;
+  bta_av_discover_req(&scb, nullptr);
+
+  // The stored stream endpoints are used without asking the peer
+  ASSERT_EQ(0, get_func_call_count("AVDT_DiscoverReq"));
+  ASSERT_TRUE(scb.sep_cache_used);
+  ASSERT_FALSE(scb.sep_cache_changed);
+  ASSERT_EQ(2, scb.num_seps);
+  ASSERT_FALSE(scb.sep_info[0].in_use);
+  ASSERT_EQ(1, scb.sep_info[0].seid);
+  ASSERT_EQ(2, scb.sep_info[1].seid);
+  ASSERT_EQ(AVDT_TSEP_SNK, scb.sep_info[1].tsep);
+  ASSERT_EQ(1u << 1, scb.peer_caps_mask);
+  ASSERT_EQ(6, scb.peer_caps[1].codec_info[0]);
+  ASSERT_EQ(1, scb.peer_caps[1].num_codec);
+  ASSERT_EQ(AVDT_PSC_DELAY_RPT, scb.peer_caps[1].psc_mask);
+
+  // A rejected configuration clears them and discovers the peer again
+  tBTA_AV_DATA data = {.str_msg = {}};
+  bta_av_sep_cache_rej(&scb, &data);
+  ASSERT_EQ(1, get_func_call_count("AVDT_DiscoverReq"));
+  ASSERT_FALSE(scb.sep_cache_used);
+  ASSERT_FALSE(bta_av_sep_cache_load(&scb));
+}
+
+TEST_F(BtaAvSepCacheTest, stored_seps_not_used_when_accepting) {
+  tBTA_AV_SCB discovered{};
+  discovered.OnConnected(kRawAddress);
+  discovered.num_seps = 1;
+  discovered.sep_info[0] = {.in_use = false,
+                            .seid = 1,
+                            .media_type = AVDT_MEDIA_TYPE_AUDIO,
+                            .tsep = AVDT_TSEP_SNK};
+  discovered.peer_caps_mask = 1u << 0;
+  bta_av_sep_cache_store(&discovered);
+
+  tBTA_AV_SCB scb{};
+  scb.OnConnected(kRawAddress);
+  scb.state = BTA_AV_INCOMING_SST;
+  bta_av_discover_req(&scb, nullptr);
+  ASSERT_EQ(1, get_func_call_count("AVDT_DiscoverReq"));
+  ASSERT_FALSE(scb.sep_cache_used);
+}
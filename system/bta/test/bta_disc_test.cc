@@ -34,6 +34,8 @@
 #include "stack/btm/neighbor_inquiry.h"
 #include "stack/include/gatt_api.h"
 #include "test/common/main_handler.h"
+#include "test/mock/mock_osi_alarm.h"
+#include "test/mock/mock_osi_properties.h"
 #include "types/bt_transport.h"
 
 #define TEST_BT com::android::bluetooth::flags
@@ -42,6 +44,7 @@ using namespace bluetooth;
 
 namespace {
 const RawAddress kRawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kRawAddress2({0x12, 0x22, 0x33, 0x44, 0x55, 0x66});
 }
 
 // Test hooks
@@ -385,6 +388,81 @@ TEST_F_WITH_FLAGS(BtaInitializedTest, bta_dm_disc_both_transports_flag_enabled,
   bta_dm_disc_override_gatt_performer_for_testing({});
 }
 
+// must be global, as capturing lambda can't be treated as function
+std::vector<std::pair<RawAddress, tBTA_STATUS>> service_cb_timeout_results;
+
+TEST_F_WITH_FLAGS(BtaInitializedTest,
+                  bta_dm_disc_start_service_discovery__timeout,
+                  REQUIRES_FLAGS_ENABLED(ACONFIG_FLAG(
+                      TEST_BT, separate_service_and_device_discovery))) {
+  auto saved_property_body =
+      test::mock::osi_properties::osi_property_get_int32.body;
+  test::mock::osi_properties::osi_property_get_int32.body =
+      [](const char* key, int32_t default_value) {
+        return std::string(key) ==
+                       "bluetooth.bta.dm.service_discovery_timeout_ms"
+                   ? 1000
+                   : default_value;
+      };
+  auto saved_alarm_body = test::mock::osi_alarm::alarm_set_on_mloop.body;
+  alarm_callback_t timer_cb = nullptr;
+  uint64_t timer_interval_ms = 0;
+  test::mock::osi_alarm::alarm_set_on_mloop.body =
+      [&](alarm_t*, uint64_t interval_ms, alarm_callback_t cb, void*) {
+        timer_interval_ms = interval_ms;
+        timer_cb = cb;
+      };
+  bta_dm_disc_start(true);
+
+  // The SDP discovery of the first device never completes.
+  std::promise<void> second_sdp_triggered;
+  std::vector<RawAddress> sdp_addresses;
+  base::RepeatingCallback<void(tBTA_DM_SDP_STATE*)> sdp_performer =
+      base::BindLambdaForTesting([&](tBTA_DM_SDP_STATE* sdp_state) {
+        sdp_addresses.push_back(sdp_state->bd_addr);
+        if (sdp_addresses.size() == 2) {
+          second_sdp_triggered.set_value();
+        }
+      });
+  bta_dm_disc_override_sdp_performer_for_testing(sdp_performer);
+  service_cb_timeout_results.clear();
+
+  service_discovery_callbacks cbacks = {
+      nullptr, nullptr, nullptr,
+      [](RawAddress addr, const std::vector<bluetooth::Uuid>&,
+         tBTA_STATUS result) {
+        service_cb_timeout_results.emplace_back(addr, result);
+      }};
+  bta_dm_disc_start_service_discovery(cbacks, kRawAddress, BT_TRANSPORT_BR_EDR);
+  bta_dm_disc_start_service_discovery(cbacks, kRawAddress2,
+                                      BT_TRANSPORT_BR_EDR);
+  ASSERT_EQ(1u, sdp_addresses.size());
+  ASSERT_NE(nullptr, timer_cb);
+  ASSERT_EQ(1000u, timer_interval_ms);
+
+  // The timeout fails the first discovery and starts the queued one.
+  timer_cb(nullptr);
+  ASSERT_EQ(1u, service_cb_timeout_results.size());
+  ASSERT_EQ(kRawAddress, service_cb_timeout_results[0].first);
+  ASSERT_EQ(BTA_FAILURE, service_cb_timeout_results[0].second);
+  EXPECT_EQ(
+      std::future_status::ready,
+      second_sdp_triggered.get_future().wait_for(std::chrono::seconds(1)));
+  ASSERT_EQ(kRawAddress2, sdp_addresses[1]);
+
+  // The late SDP result of the first device is ignored.
+  bta_dm_sdp_callback(kRawAddress, SDP_SUCCESS);
+  bta_dm_sdp_finished(kRawAddress2, BTA_SUCCESS, {}, {});
+  ASSERT_EQ(2u, service_cb_timeout_results.size());
+  ASSERT_EQ(kRawAddress2, service_cb_timeout_results[1].first);
+  ASSERT_EQ(BTA_SUCCESS, service_cb_timeout_results[1].second);
+
+  bta_dm_disc_override_sdp_performer_for_testing({});
+  test::mock::osi_alarm::alarm_set_on_mloop.body = saved_alarm_body;
+  test::mock::osi_properties::osi_property_get_int32.body =
+      saved_property_body;
+}
+
 TEST_F(BtaInitializedTest, init_bta_dm_search_cb__conn_id) {
   // Set the global search block target field to some non-reset value
   tBTA_DM_SEARCH_CB& search_cb =
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/dm/bta_dm_pm_policy.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using bluetooth::bta::dm::PowerModePolicy;
+
+namespace {
+
+const RawAddress kPeer1({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kPeer2({0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+
+// 500ms, 250ms, 125ms and 22.5ms
+const std::vector<uint16_t> kSniffIntervals = {800, 400, 200, 36};
+
+class BtaDmPmPolicyTest : public ::testing::Test {
+ protected:
+  // Reports a burst of traffic followed by |gap| of silence
+  void Burst(const RawAddress& peer_addr, std::chrono::milliseconds gap) {
+    policy_.OnLinkBusy(peer_addr, now_);
+    now_ += 10ms;
+    policy_.OnLinkIdle(peer_addr, now_);
+    now_ += gap;
+  }
+
+  void Bursts(const RawAddress& peer_addr, std::chrono::milliseconds gap,
+              size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      Burst(peer_addr, gap);
+    }
+    // Close the last gap
+    policy_.OnLinkBusy(peer_addr, now_);
+  }
+
+  PowerModePolicy policy_{kSniffIntervals};
+  PowerModePolicy::Clock::time_point now_{PowerModePolicy::Clock::now()};
+};
+
+TEST_F(BtaDmPmPolicyTest, no_prediction_before_min_samples) {
+  Bursts(kPeer1, 8000ms, PowerModePolicy::kMinGapSamples - 1);
+  ASSERT_FALSE(policy_.PredictedSniffIndex(kPeer1).has_value());
+  ASSERT_FALSE(policy_.LatencyBudget(kPeer1).has_value());
+  ASSERT_FALSE(policy_.PredictedSniffIndex(kPeer2).has_value());
+}
+
+TEST_F(BtaDmPmPolicyTest, sparse_traffic_selects_longest_interval) {
+  Bursts(kPeer1, 8000ms, PowerModePolicy::kMinGapSamples);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 0);
+  // 8s / 4 in slots
+  ASSERT_EQ(policy_.LatencyBudget(kPeer1), 3200);
+}
+
+TEST_F(BtaDmPmPolicyTest, frequent_traffic_selects_short_interval) {
+  Bursts(kPeer1, 1600ms, PowerModePolicy::kMinGapSamples);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 1);
+
+  Bursts(kPeer2, 50ms, PowerModePolicy::kMinGapSamples);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer2), 3);
+}
+
+TEST_F(BtaDmPmPolicyTest, hysteresis) {
+  Bursts(kPeer1, 1600ms, PowerModePolicy::kMinGapSamples);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 1);
+
+  // A single long gap pulls the average over the next entry
+  Bursts(kPeer1, 8000ms, 1);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 1);
+
+  // but the following gaps do not confirm it
+  Bursts(kPeer1, 1600ms, 5);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 1);
+
+  // A sustained change of pattern is followed
+  Bursts(kPeer1, 100ms, 10);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 3);
+}
+
+TEST_F(BtaDmPmPolicyTest, long_silence_is_clamped) {
+  Bursts(kPeer1, 60s, PowerModePolicy::kMinGapSamples);
+  auto stats = policy_.GetLinkStats();
+  ASSERT_EQ(stats.size(), 1u);
+  ASSERT_EQ(stats[0].second.average_gap, PowerModePolicy::kMaxGap);
+
+  // The link adapts to a busier pattern
+  Bursts(kPeer1, 100ms, 20);
+  ASSERT_EQ(policy_.PredictedSniffIndex(kPeer1), 3);
+}
+
+TEST_F(BtaDmPmPolicyTest, mode_transitions) {
+  ASSERT_EQ(policy_.OnActiveMode(kPeer1, now_), 0us);
+
+  policy_.OnSniffMode(kPeer1, 800, now_);
+  // Subrating reported while in sniff mode
+  policy_.OnSniffMode(kPeer1, 800, now_ + 100ms);
+  ASSERT_EQ(policy_.OnActiveMode(kPeer1, now_ + 2s), 250ms);
+
+  policy_.OnSniffMode(kPeer1, 36, now_ + 3s);
+  ASSERT_EQ(policy_.OnActiveMode(kPeer1, now_ + 4s), 11250us);
+  ASSERT_EQ(policy_.OnActiveMode(kPeer1, now_ + 5s), 0us);
+
+  auto stats = policy_.GetLinkStats();
+  ASSERT_EQ(stats.size(), 1u);
+  ASSERT_EQ(stats[0].second.sniff_entries, 2u);
+  ASSERT_EQ(stats[0].second.sniff_exits, 2u);
+  ASSERT_EQ(stats[0].second.time_in_sniff, 3s);
+  ASSERT_EQ(stats[0].second.exit_latency_cost, 261250us);
+}
+
+TEST_F(BtaDmPmPolicyTest, remove_link) {
+  Bursts(kPeer1, 8000ms, PowerModePolicy::kMinGapSamples);
+  policy_.RemoveLink(kPeer1);
+  ASSERT_FALSE(policy_.PredictedSniffIndex(kPeer1).has_value());
+  ASSERT_TRUE(policy_.GetLinkStats().empty());
+}
+
+}  // namespace
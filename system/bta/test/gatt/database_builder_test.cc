@@ -23,6 +23,7 @@
 #include <iterator>
 #include <utility>
 
+#include "stack/include/gattdefs.h"
 #include "types/bluetooth/uuid.h"
 
 using bluetooth::Uuid;
@@ -177,4 +178,46 @@ TEST(DatabaseBuilderTest, SecondaryServiceOutOfOrderTest) {
   ASSERT_EQ(service, result.Services().end());
 }
 
+
+/* Verify that the descriptor ranges of consecutive characteristics are merged
+ * up to the given size, and that the characteristic declarations and values
+ * found in a merged range are not added as descriptors */
+TEST(DatabaseBuilderTest, MergedDescriptorRangeTest) {
+  DatabaseBuilder builder;
+
+  builder.AddService(0x0001, 0x0020, SERVICE_1_UUID, true);
+  EXPECT_TRUE(builder.StartNextServiceExploration());
+  builder.AddCharacteristic(0x0002, 0x0003, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0005, 0x0006, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x0007, 0x0008, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddCharacteristic(0x000b, 0x000c, SERVICE_1_CHAR_1_UUID, 0x02);
+
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(8),
+            make_pair_u16(0x0004, 0x000a));
+  builder.AddDescriptor(0x0004, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x0005, Uuid::From16Bit(GATT_UUID_CHAR_DECLARE));
+  builder.AddDescriptor(0x0006, SERVICE_1_CHAR_1_UUID);
+  builder.AddDescriptor(0x0007, Uuid::From16Bit(GATT_UUID_CHAR_DECLARE));
+  builder.AddDescriptor(0x0008, SERVICE_1_CHAR_1_UUID);
+  builder.AddDescriptor(0x0009, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddDescriptor(0x000a, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  // The last range is larger than 8 handles, it is not merged.
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(8),
+            make_pair_u16(0x000d, 0x0020));
+  ASSERT_EQ(builder.NextDescriptorRangeToExplore(8),
+            DatabaseBuilder::EXPLORE_END);
+
+  Database result = builder.Build();
+  const auto& characteristics = result.Services().front().characteristics;
+  ASSERT_EQ(characteristics.size(), (size_t)4);
+  ASSERT_EQ(characteristics[0].descriptors.size(), (size_t)1);
+  ASSERT_EQ(characteristics[0].descriptors[0].handle, 0x0004);
+  ASSERT_EQ(characteristics[1].descriptors.size(), (size_t)0);
+  ASSERT_EQ(characteristics[2].descriptors.size(), (size_t)2);
+  ASSERT_EQ(characteristics[2].descriptors[0].handle, 0x0009);
+  ASSERT_EQ(characteristics[2].descriptors[1].handle, 0x000a);
+  ASSERT_EQ(characteristics[3].descriptors.size(), (size_t)0);
+}
+
 }  // namespace gatt
@@ -98,6 +98,43 @@ TEST(GattDatabaseTest, serialize_deserialize_binary_test) {
   EXPECT_EQ(serialized[5].value.characteristic_extended_properties, 0x0001);
 }
 
+/* This test makes sure that the characteristics and descriptors are found by
+ * handle in built, copied and deserialized databases */
+TEST(GattDatabaseTest, find_by_handle_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+  builder.AddCharacteristic(0x0011, 0x0012, SERVICE_1_CHAR_1_UUID, 0x10);
+  builder.AddDescriptor(0x0013, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database built = builder.Build();
+  Database copied = built;
+  bool success = false;
+  Database deserialized = Database::Deserialize(built.Serialize(), &success);
+  ASSERT_TRUE(success);
+
+  for (const Database* db : {&built, &copied, &deserialized}) {
+    const Characteristic* charac = db->FindCharacteristic(0x0012);
+    ASSERT_NE(charac, nullptr);
+    EXPECT_EQ(charac->declaration_handle, 0x0011);
+    EXPECT_EQ(charac, &db->Services().back().characteristics[0]);
+    EXPECT_EQ(db->FindCharacteristic(0x0013), nullptr);
+    EXPECT_EQ(db->FindCharacteristic(0x0003), nullptr);
+
+    const Descriptor* desc = db->FindDescriptor(0x0005);
+    ASSERT_NE(desc, nullptr);
+    EXPECT_EQ(desc->uuid, SERVICE_1_CHAR_1_DESC_1_UUID);
+    EXPECT_EQ(db->FindDescriptor(0x0004), nullptr);
+    EXPECT_EQ(db->FindOwningCharacteristic(0x0013)->value_handle, 0x0012);
+    EXPECT_EQ(db->FindOwningCharacteristic(0x0012), nullptr);
+  }
+
+  built.Clear();
+  EXPECT_EQ(built.FindCharacteristic(0x0012), nullptr);
+}
+
 /* This test makes sure that Service represented in StoredAttribute have proper
  * binary format. */
 TEST(GattCacheTest, stored_attribute_to_binary_service_test) {
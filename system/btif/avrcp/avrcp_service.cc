@@ -21,6 +21,7 @@
 #include <base/threading/thread.h>
 #include <bluetooth/log.h>
 
+#include <cinttypes>
 #include <mutex>
 #include <sstream>
 
@@ -173,56 +174,131 @@ class SdpInterfaceImpl : public SdpInterface {
 // switching/synchronization so the devices don't have to worry about it.
 class MediaInterfaceWrapper : public MediaInterface {
  public:
-  MediaInterfaceWrapper(MediaInterface* cb) : wrapped_(cb){};
+  MediaInterfaceWrapper(MediaInterface* cb,
+                        std::shared_ptr<MediaInfoCache> cache)
+      : wrapped_(cb), cache_(std::move(cache)){};
 
   void SendKeyEvent(uint8_t key, KeyState state) override {
     do_in_jni_thread(base::Bind(&MediaInterface::SendKeyEvent,
                                 base::Unretained(wrapped_), key, state));
   }
 
+  // The media information below is answered from the cache when the media
+  // layer did not report a change since it was last fetched. The responses of
+  // the media layer fill the cache on the main thread, before being passed on.
+
   void GetSongInfo(SongInfoCallback info_cb) override {
+    auto song_info = cache_->GetSongInfo();
+    if (song_info.has_value()) {
+      do_in_main_thread(FROM_HERE,
+                        base::BindOnce(info_cb, std::move(*song_info)));
+      return;
+    }
+
+    auto cache_lambda = [](std::shared_ptr<MediaInfoCache> cache,
+                           MediaInfoCache::Generation generation,
+                           SongInfoCallback cb, SongInfo data) {
+      cache->SetSongInfo(generation, data);
+      cb.Run(std::move(data));
+    };
+
     auto cb_lambda = [](SongInfoCallback cb, SongInfo data) {
       do_in_main_thread(FROM_HERE, base::BindOnce(cb, data));
     };
 
-    auto bound_cb = base::Bind(cb_lambda, info_cb);
+    auto bound_cb = base::Bind(
+        cb_lambda,
+        base::Bind(cache_lambda, cache_, cache_->GetGeneration(), info_cb));
 
     do_in_jni_thread(base::Bind(&MediaInterface::GetSongInfo,
                                 base::Unretained(wrapped_), bound_cb));
   }
 
   void GetPlayStatus(PlayStatusCallback status_cb) override {
+    auto play_status = cache_->GetPlayStatus(MediaInfoCache::Clock::now());
+    if (play_status.has_value()) {
+      do_in_main_thread(FROM_HERE, base::BindOnce(status_cb, *play_status));
+      return;
+    }
+
+    auto cache_lambda = [](std::shared_ptr<MediaInfoCache> cache,
+                           MediaInfoCache::Generation generation,
+                           PlayStatusCallback cb, PlayStatus status) {
+      cache->SetPlayStatus(generation, status, MediaInfoCache::Clock::now());
+      cb.Run(status);
+    };
+
     auto cb_lambda = [](PlayStatusCallback cb, PlayStatus status) {
       do_in_main_thread(FROM_HERE, base::BindOnce(cb, status));
     };
 
-    auto bound_cb = base::Bind(cb_lambda, status_cb);
+    auto bound_cb = base::Bind(
+        cb_lambda,
+        base::Bind(cache_lambda, cache_, cache_->GetGeneration(), status_cb));
 
     do_in_jni_thread(base::Bind(&MediaInterface::GetPlayStatus,
                                 base::Unretained(wrapped_), bound_cb));
   }
 
   void GetNowPlayingList(NowPlayingCallback now_playing_cb) override {
+    auto now_playing = cache_->GetNowPlayingList();
+    if (now_playing.has_value()) {
+      do_in_main_thread(
+          FROM_HERE,
+          base::BindOnce(now_playing_cb, std::move(now_playing->curr_media_id),
+                         std::move(now_playing->song_list)));
+      return;
+    }
+
+    auto cache_lambda = [](std::shared_ptr<MediaInfoCache> cache,
+                           MediaInfoCache::Generation generation,
+                           NowPlayingCallback cb, std::string curr_media_id,
+                           std::vector<SongInfo> song_list) {
+      cache->SetNowPlayingList(generation, {curr_media_id, song_list});
+      cb.Run(std::move(curr_media_id), std::move(song_list));
+    };
+
     auto cb_lambda = [](NowPlayingCallback cb, std::string curr_media_id,
                         std::vector<SongInfo> song_list) {
       do_in_main_thread(
           FROM_HERE, base::BindOnce(cb, curr_media_id, std::move(song_list)));
     };
 
-    auto bound_cb = base::Bind(cb_lambda, now_playing_cb);
+    auto bound_cb =
+        base::Bind(cb_lambda, base::Bind(cache_lambda, cache_,
+                                         cache_->GetGeneration(),
+                                         now_playing_cb));
 
     do_in_jni_thread(base::Bind(&MediaInterface::GetNowPlayingList,
                                 base::Unretained(wrapped_), bound_cb));
   }
 
   void GetMediaPlayerList(MediaListCallback list_cb) override {
+    auto player_list = cache_->GetMediaPlayerList();
+    if (player_list.has_value()) {
+      do_in_main_thread(FROM_HERE,
+                        base::BindOnce(list_cb, player_list->curr_player,
+                                       std::move(player_list->player_list)));
+      return;
+    }
+
+    auto cache_lambda = [](std::shared_ptr<MediaInfoCache> cache,
+                           MediaInfoCache::Generation generation,
+                           MediaListCallback cb, uint16_t curr_player,
+                           std::vector<MediaPlayerInfo> player_list) {
+      cache->SetMediaPlayerList(generation, {curr_player, player_list});
+      cb.Run(curr_player, std::move(player_list));
+    };
+
     auto cb_lambda = [](MediaListCallback cb, uint16_t curr_player,
                         std::vector<MediaPlayerInfo> player_list) {
       do_in_main_thread(
           FROM_HERE, base::BindOnce(cb, curr_player, std::move(player_list)));
     };
 
-    auto bound_cb = base::Bind(cb_lambda, list_cb);
+    auto bound_cb = base::Bind(
+        cb_lambda,
+        base::Bind(cache_lambda, cache_, cache_->GetGeneration(), list_cb));
 
     do_in_jni_thread(base::Bind(&MediaInterface::GetMediaPlayerList,
                                 base::Unretained(wrapped_), bound_cb));
@@ -230,12 +306,30 @@ class MediaInterfaceWrapper : public MediaInterface {
 
   void GetFolderItems(uint16_t player_id, std::string media_id,
                       FolderItemsCallback folder_cb) override {
+    auto items = cache_->GetFolderItems(player_id, media_id);
+    if (items.has_value()) {
+      do_in_main_thread(FROM_HERE,
+                        base::BindOnce(folder_cb, std::move(*items)));
+      return;
+    }
+
+    auto cache_lambda = [](std::shared_ptr<MediaInfoCache> cache,
+                           MediaInfoCache::Generation generation,
+                           uint16_t player_id, std::string media_id,
+                           FolderItemsCallback cb,
+                           std::vector<ListItem> item_list) {
+      cache->SetFolderItems(generation, player_id, media_id, item_list);
+      cb.Run(std::move(item_list));
+    };
+
     auto cb_lambda = [](FolderItemsCallback cb,
                         std::vector<ListItem> item_list) {
       do_in_main_thread(FROM_HERE, base::BindOnce(cb, std::move(item_list)));
     };
 
-    auto bound_cb = base::Bind(cb_lambda, folder_cb);
+    auto bound_cb = base::Bind(
+        cb_lambda, base::Bind(cache_lambda, cache_, cache_->GetGeneration(),
+                              player_id, media_id, folder_cb));
 
     do_in_jni_thread(base::Bind(&MediaInterface::GetFolderItems,
                                 base::Unretained(wrapped_), player_id, media_id,
@@ -279,6 +373,7 @@ class MediaInterfaceWrapper : public MediaInterface {
 
  private:
   MediaInterface* wrapped_;
+  std::shared_ptr<MediaInfoCache> cache_;
 };
 
 // A wrapper class for the media callbacks that handles thread
@@ -414,7 +509,9 @@ void AvrcpService::Init(MediaInterface* media_interface,
                              avrcp_interface_.GetAvrcpControlVersion(), 0);
   bta_sys_add_uuid(UUID_SERVCLASS_AV_REMOTE_CONTROL);
 
-  media_interface_ = new MediaInterfaceWrapper(media_interface);
+  media_info_cache_ = std::make_shared<MediaInfoCache>();
+  media_interface_ =
+      new MediaInterfaceWrapper(media_interface, media_info_cache_);
   media_interface->RegisterUpdateCallback(instance_);
 
   VolumeInterfaceWrapper* wrapped_volume_interface = nullptr;
@@ -534,7 +631,16 @@ void AvrcpService::SendMediaUpdate(bool track_changed, bool play_state,
             play_state, queue);
 
   // This function may be called on any thread, we need to make sure that the
-  // device update happens on the main thread.
+  // device update happens on the main thread. The stale media information is
+  // dropped first so that the devices fetch the new one.
+  do_in_main_thread(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::shared_ptr<MediaInfoCache> cache, bool track_changed,
+             bool play_state, bool queue) {
+            cache->OnMediaUpdate(track_changed, play_state, queue);
+          },
+          instance_->media_info_cache_, track_changed, play_state, queue));
   for (const auto& device :
        instance_->connection_handler_->GetListOfDevices()) {
     do_in_main_thread(
@@ -549,6 +655,15 @@ void AvrcpService::SendFolderUpdate(bool available_players,
             available_players, addressed_players, uids);
 
   // Ensure that the update is posted to the correct thread
+  do_in_main_thread(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::shared_ptr<MediaInfoCache> cache, bool available_players,
+             bool addressed_players, bool uids) {
+            cache->OnFolderUpdate(available_players, addressed_players, uids);
+          },
+          instance_->media_info_cache_, available_players, addressed_players,
+          uids));
   for (const auto& device :
        instance_->connection_handler_->GetListOfDevices()) {
     do_in_main_thread(
@@ -586,6 +701,15 @@ void AvrcpService::SendPlayerSettingsChanged(
   log::info("{}", ss.str());
 
   // Ensure that the update is posted to the correct thread
+  do_in_main_thread(
+      FROM_HERE,
+      base::BindOnce(
+          [](std::shared_ptr<MediaInfoCache> cache, bool available_players,
+             bool addressed_players, bool uids) {
+            cache->OnFolderUpdate(available_players, addressed_players, uids);
+          },
+          instance_->media_info_cache_, available_players, addressed_players,
+          uids));
   for (const auto& device :
        instance_->connection_handler_->GetListOfDevices()) {
     do_in_main_thread(FROM_HERE,
@@ -725,6 +849,15 @@ void AvrcpService::DebugDump(int fd) {
   }
 
   dprintf(fd, "%s", stream.str().c_str());
+
+  // Read off the main thread, the counters may be slightly behind
+  if (instance_->media_info_cache_ != nullptr) {
+    const auto& stats = instance_->media_info_cache_->GetStats();
+    dprintf(fd,
+            "  Media info cache: hits=%" PRIu64 " misses=%" PRIu64
+            " stale_responses=%" PRIu64 "\n",
+            stats.hits, stats.misses, stats.stale_responses);
+  }
 }
 
 /** when a2dp connected, btif will start register vol changed, so we need a
@@ -23,6 +23,7 @@
 #include "hardware/avrcp/avrcp.h"
 #include "osi/include/properties.h"
 #include "profile/avrcp/connection_handler.h"
+#include "profile/avrcp/media_info_cache.h"
 #include "raw_address.h"
 
 namespace bluetooth {
@@ -113,6 +114,8 @@ class AvrcpService : public MediaCallbacks {
   uint16_t profile_version = -1;
 
   MediaInterface* media_interface_ = nullptr;
+  // Shared with the pending media requests, which may complete after Cleanup
+  std::shared_ptr<MediaInfoCache> media_info_cache_;
   VolumeInterface* volume_interface_ = nullptr;
   PlayerSettingsInterface* player_settings_interface_ = nullptr;
 
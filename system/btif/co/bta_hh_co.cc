@@ -23,6 +23,7 @@
 #include <linux/uhid.h>
 #include <poll.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
@@ -124,23 +125,28 @@ static bool uhid_set_report_req_handler(btif_hh_uhid_t* p_uhid,
 }
 #endif  // ENABLE_UHID_SET_REPORT
 
-/*Internal function to perform UHID write and error checking*/
-static int uhid_write(int fd, const struct uhid_event* ev) {
+/*Internal function to perform UHID write and error checking. The UHID driver
+ * zeroes the part of the event which is not written.*/
+static int uhid_write_size(int fd, const struct uhid_event* ev, size_t size) {
   ssize_t ret;
-  OSI_NO_INTR(ret = write(fd, ev, sizeof(*ev)));
+  OSI_NO_INTR(ret = write(fd, ev, size));
 
   if (ret < 0) {
     int rtn = -errno;
     log::error("Cannot write to uhid:{}", strerror(errno));
     return rtn;
-  } else if (ret != (ssize_t)sizeof(*ev)) {
-    log::error("Wrong size written to uhid: {} != {}", ret, sizeof(*ev));
+  } else if (ret != (ssize_t)size) {
+    log::error("Wrong size written to uhid: {} != {}", ret, size);
     return -EFAULT;
   }
 
   return 0;
 }
 
+static int uhid_write(int fd, const struct uhid_event* ev) {
+  return uhid_write_size(fd, ev, sizeof(*ev));
+}
+
 /* Internal function to parse the events received from UHID driver*/
 static int uhid_read_event(btif_hh_uhid_t* p_uhid) {
   log::assert_that(p_uhid != nullptr, "assert failed: p_uhid != nullptr");
@@ -402,20 +408,22 @@ static void* btif_hh_poll_event_thread(void* arg) {
   return 0;
 }
 
-int bta_hh_co_write(int fd, uint8_t* rpt, uint16_t len) {
+int bta_hh_co_write(int fd, const uint8_t* rpt, uint16_t len) {
   log::verbose("UHID write {}", len);
 
+  // Only the report is written: input reports come at up to 1 kHz and the
+  // event is over 4 kB.
   struct uhid_event ev;
-  memset(&ev, 0, sizeof(ev));
-  ev.type = UHID_INPUT;
-  ev.u.input.size = len;
-  if (len > sizeof(ev.u.input.data)) {
+  ev.type = UHID_INPUT2;
+  ev.u.input2.size = len;
+  if (len > sizeof(ev.u.input2.data)) {
     log::warn("Report size greater than allowed size");
     return -1;
   }
-  memcpy(ev.u.input.data, rpt, len);
+  memcpy(ev.u.input2.data, rpt, len);
 
-  return uhid_write(fd, &ev);
+  return uhid_write_size(fd, &ev,
+                         offsetof(struct uhid_event, u.input2.data) + len);
 }
 
 /*******************************************************************************
@@ -536,7 +544,7 @@ void bta_hh_co_close(btif_hh_device_t* p_dev) {
  *
  * Returns          void
  ******************************************************************************/
-void bta_hh_co_data(uint8_t dev_handle, uint8_t* p_rpt, uint16_t len) {
+void bta_hh_co_data(uint8_t dev_handle, const uint8_t* p_rpt, uint16_t len) {
   btif_hh_device_t* p_dev;
 
   log::verbose("dev_handle = {}", dev_handle);
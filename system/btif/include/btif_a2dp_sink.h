@@ -122,7 +122,8 @@ void btif_a2dp_sink_set_rx_flush(bool enable);
 // Enqueue a buffer to the A2DP Sink queue. If the queue has reached its
 // maximum size |MAX_INPUT_A2DP_FRAME_QUEUE_SZ|, the oldest buffer is
 // removed from the queue.
-// |p_buf| is the buffer to enqueue.
+// |p_buf| is the buffer to enqueue, the Sink module takes ownership of it and
+// decodes it in place.
 // Returns the number of buffers in the Sink queue after the enqueing.
 uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_buf);
 
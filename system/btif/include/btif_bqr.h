@@ -118,6 +118,9 @@ static constexpr uint32_t kReportIntervalMultipleNoLimit = 0;
 static constexpr uint32_t kReportIntervalMultipleMax = 0xFFFFFFFF;
 // The maximum count of Log Dump related event can be written in the log file.
 static constexpr uint16_t kLogDumpEventPerFile = 0x00FF;
+// The maximum count of Log Dump related events waiting to be written to the
+// log files. Further events are dropped until the writer catches up.
+static constexpr size_t kTraceLogWriterCapacity = 512;
 // Total length of all parameters of the link Quality related event except
 // Vendor Specific Parameters.
 static constexpr uint8_t kLinkQualityParamTotalLen = 48;
@@ -174,6 +177,8 @@ static constexpr const char* kpBtSchedulingTraceLastLogPath =
 static constexpr const char* kpPropertyChoppyThreshold =
     "persist.bluetooth.bqr.choppy_threshold";
 
+// The trace log file descriptors and counters are only accessed from the trace
+// log writer thread.
 // File Descriptor of LMP/LL message trace log
 static int LmpLlMessageTraceLogFd = INVALID_FD;
 // File Descriptor of Bluetooth Multi-profile/Coex scheduling trace log
@@ -359,14 +364,16 @@ class BqrVseSubEvt {
   // @param length Total length of all parameters contained in the sub-event.
   // @param p_param_buf A pointer to the parameters contained in the sub-event.
   void ParseBqrLinkQualityEvt(uint8_t length, const uint8_t* p_param_buf);
-  // Write the LMP/LL message trace to the log file.
+  // Write the LMP/LL message trace, stamped with |tm_timestamp_|, to the log
+  // file in a single write.
   //
   // @param fd The File Descriptor of the log file.
   // @param length Total length of all parameters contained in the sub-event.
   // @param p_param_buf A pointer to the parameters contained in the sub-event.
   void WriteLmpLlTraceLogFile(int fd, uint8_t length,
                               const uint8_t* p_param_buf);
-  // Write the Bluetooth Multi-profile/Coex scheduling trace to the log file.
+  // Write the Bluetooth Multi-profile/Coex scheduling trace, stamped with
+  // |tm_timestamp_|, to the log file in a single write.
   //
   // @param fd The File Descriptor of the log file.
   // @param length Total length of all parameters contained in the sub-event.
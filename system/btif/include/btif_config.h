@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "main/shim/config.h"
 #include "osi/include/config.h"
 #include "types/ble_address_with_type.h"
 #include "types/raw_address.h"
@@ -56,6 +57,10 @@ size_t btif_config_get_bin_length(const std::string& section,
                                   const std::string& key);
 
 std::vector<RawAddress> btif_config_get_paired_devices();
+// Read the properties of all the paired devices at once, rather than section
+// by section, for the passes over all the bonds
+std::vector<bluetooth::shim::DeviceProperties>
+btif_config_get_paired_device_properties();
 
 bool btif_config_clear(void);
 bool btif_get_device_clockoffset(const RawAddress& bda, int* p_clock_offset);
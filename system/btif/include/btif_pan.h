@@ -32,5 +32,6 @@
 btpan_interface_t* btif_pan_interface();
 void btif_pan_init();
 void btif_pan_cleanup();
+void btif_debug_pan_dump(int fd);
 
 #endif
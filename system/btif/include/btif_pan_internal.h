@@ -38,6 +38,7 @@
 #define PANU_SERVICE_NAME "Android Network User"
 #define TAP_IF_NAME "bt-pan"
 #define TAP_MAX_PKT_WRITE_LEN 2000
+#define TAP_MAX_PKT_READ_LEN 1600 /* max ethernet packet size */
 
 #define PAN_STATE_OPEN 1
 #define PAN_STATE_CLOSE 2
@@ -73,8 +74,15 @@ typedef struct {
   int open_count;
   int flow;  // 1: outbound data flow on; 0: outbound data flow off
   btpan_conn_t conns[MAX_PAN_CONNS];
-  int congest_packet_size;
-  unsigned char congest_packet[1600];  // max ethernet packet size
+  // Data path counters, updated on the main thread
+  uint64_t tap_rx_batches;    // batches of frames read from the TAP interface
+  uint64_t tap_rx_frames;     // frames forwarded to BNEP
+  uint64_t tap_rx_bytes;      // bytes of the frames forwarded to BNEP
+  uint64_t tap_rx_drops;      // frames not forwarded, e.g. unknown protocol
+  uint64_t tap_rx_congested;  // retries of a frame blocked by a full BNEP queue
+  uint64_t tap_tx_frames;     // frames written to the TAP interface
+  uint64_t tap_tx_bytes;      // bytes written to the TAP interface
+  uint64_t tap_tx_errors;     // frames not written to the TAP interface
 } btpan_cb_t;
 
 /*******************************************************************************
@@ -161,6 +161,21 @@ bt_status_t btif_storage_add_bonded_device(RawAddress* remote_bd_addr,
                                            LinkKey link_key, uint8_t key_type,
                                            uint8_t pin_length);
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_invalidate_remote_device_properties
+ *
+ * Description      BTIF storage API - Drops the cached properties of the
+ *                  remote device, or of all the remote devices when
+ *                  remote_bd_addr is NULL, after their config was changed
+ *                  without going through btif_storage
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btif_storage_invalidate_remote_device_properties(
+    const RawAddress* remote_bd_addr);
+
 /*******************************************************************************
  *
  * Function         btif_storage_remove_bonded_device
@@ -49,6 +49,10 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bta/hh/bta_hh_int.h"  // for HID HACK profile methods
 #include "bta/include/bta_api.h"
@@ -60,6 +64,7 @@
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
 #include "bta/include/bta_vc_api.h"
+#include "bta/sys/bta_sys.h"
 #include "btif/avrcp/avrcp_service.h"
 #include "btif/include/btif_sock.h"
 #include "btif/include/btif_sock_logging.h"
@@ -96,7 +101,9 @@
 #include "os/parameter_provider.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_pool.h"
 #include "osi/include/stack_power_telemetry.h"
+#include "osi/include/thread_scheduler.h"
 #include "osi/include/wakelock.h"
 #include "stack/btm/btm_sco_hfp_hal.h"
 #include "stack/gatt/connection_manager.h"
@@ -820,10 +827,15 @@ static void dump(int fd, const char** arguments) {
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   gatt_tcb_dump(fd);
   bta_gatt_client_dump(fd);
+  bta_sys_debug_dump(fd);
   device_debug_iot_config_dump(fd);
   BTA_HfClientDumpStatistics(fd);
   wakelock_debug_dump(fd);
   alarm_debug_dump(fd);
+  buffer_pool_debug_dump(fd);
+  osi_alloc_accounting_dump(fd);
+  get_main_thread()->DumpTaskStats(fd);
+  thread_scheduler_dump(fd);
   bluetooth::csis::CsisClient::DebugDump(fd);
   ::bluetooth::le_audio::has::HasClient::DebugDump(fd);
   HearingAid::DebugDump(fd);
@@ -832,6 +844,7 @@ static void dump(int fd, const char** arguments) {
   VolumeControl::DebugDump(fd);
   connection_manager::dump(fd);
   bluetooth::bqr::DebugDump(fd);
+  btif_debug_pan_dump(fd);
   PAN_Dumpsys(fd);
   DumpsysHid(fd);
   DumpsysBtaDm(fd);
@@ -1017,6 +1030,7 @@ static int config_clear(void) {
     log::error("Failed to clear btif config");
     ret = BT_STATUS_FAIL;
   }
+  btif_storage_invalidate_remote_device_properties(NULL);
 
   if (!device_iot_config_clear()) {
     log::error("Failed to clear device iot config");
@@ -1280,20 +1294,91 @@ void invoke_adapter_properties_cb(bt_status_t status, int num_properties,
       property_deep_copy_array(num_properties, properties)));
 }
 
+// Remote device properties waiting for the JNI thread. The names, UUIDs and
+// class of a device are often reported separately during discovery: the
+// updates of a device queued before the JNI thread gets to them are merged,
+// the latest value of each property winning, and delivered in one callback.
+// No update is held back by a timer, so the coalescing only absorbs the
+// updates the JNI thread is late on.
+namespace {
+struct PendingRemoteProperties {
+  bt_status_t status;
+  RawAddress bd_addr;
+  std::vector<std::pair<bt_property_type_t, std::vector<uint8_t>>> properties;
+};
+}  // namespace
+
+static std::mutex pending_remote_properties_mutex;
+static std::vector<PendingRemoteProperties> pending_remote_properties;
+
+static void merge_remote_device_properties(PendingRemoteProperties& pending,
+                                           int num_properties,
+                                           bt_property_t* properties) {
+  for (int i = 0; i < num_properties; i++) {
+    std::vector<uint8_t> value;
+    if (properties[i].len > 0) {
+      auto val = static_cast<const uint8_t*>(properties[i].val);
+      value.assign(val, val + properties[i].len);
+    }
+    auto it = std::find_if(pending.properties.begin(),
+                           pending.properties.end(), [&](const auto& property) {
+                             return property.first == properties[i].type;
+                           });
+    if (it != pending.properties.end()) {
+      it->second = std::move(value);
+    } else {
+      pending.properties.emplace_back(properties[i].type, std::move(value));
+    }
+  }
+}
+
+static void deliver_remote_device_properties() {
+  std::vector<PendingRemoteProperties> pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_remote_properties_mutex);
+    pending.swap(pending_remote_properties);
+  }
+  std::vector<bt_property_t> properties;
+  for (auto& update : pending) {
+    properties.clear();
+    for (auto& [type, value] : update.properties) {
+      properties.push_back(
+          {type, static_cast<int>(value.size()),
+           value.empty() ? nullptr : static_cast<void*>(value.data())});
+    }
+    HAL_CBACK(bt_hal_cbacks, remote_device_properties_cb, update.status,
+              &update.bd_addr, static_cast<int>(properties.size()),
+              properties.empty() ? nullptr : properties.data());
+  }
+}
+
 void invoke_remote_device_properties_cb(bt_status_t status, RawAddress bd_addr,
                                         int num_properties,
                                         bt_property_t* properties) {
-  do_in_jni_thread(base::BindOnce(
-      [](bt_status_t status, RawAddress bd_addr, int num_properties,
-         bt_property_t* properties) {
-        HAL_CBACK(bt_hal_cbacks, remote_device_properties_cb, status, &bd_addr,
-                  num_properties, properties);
-        if (properties) {
-          osi_free(properties);
-        }
-      },
-      status, bd_addr, num_properties,
-      property_deep_copy_array(num_properties, properties)));
+  std::lock_guard<std::mutex> lock(pending_remote_properties_mutex);
+  // A delivery is already scheduled while updates are pending
+  bool schedule_delivery = pending_remote_properties.empty();
+  // Only merge with the latest update of the device, to keep the updates of a
+  // device in order
+  auto it = std::find_if(pending_remote_properties.rbegin(),
+                         pending_remote_properties.rend(),
+                         [&](const PendingRemoteProperties& pending) {
+                           return pending.bd_addr == bd_addr;
+                         });
+  if (status == BT_STATUS_SUCCESS && it != pending_remote_properties.rend() &&
+      it->status == BT_STATUS_SUCCESS) {
+    merge_remote_device_properties(*it, num_properties, properties);
+  } else {
+    pending_remote_properties.push_back({status, bd_addr, {}});
+    merge_remote_device_properties(pending_remote_properties.back(),
+                                   num_properties, properties);
+  }
+  if (schedule_delivery &&
+      do_in_jni_thread(base::BindOnce(deliver_remote_device_properties)) !=
+          BT_STATUS_SUCCESS) {
+    // Nothing would deliver the update, drop it as the JNI thread is gone
+    pending_remote_properties.clear();
+  }
 }
 
 void invoke_device_found_cb(int num_properties, bt_property_t* properties) {
@@ -18,6 +18,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "a2dp"
 
 #include "btif/include/btif_a2dp_sink.h"
 
@@ -25,7 +26,11 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
 #include <mutex>
 #include <string>
 
@@ -34,10 +39,12 @@
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "os/log.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/thread_scheduler.h"
 #include "stack/include/bt_hdr.h"
 #include "types/raw_address.h"
 
@@ -82,6 +89,37 @@ typedef struct {
   btif_a2dp_sink_focus_state_t focus_state;
 } tBTIF_MEDIA_SINK_FOCUS_UPDATE;
 
+/* Receive queue (jitter buffer) statistics */
+class BtifA2dpSinkStats {
+ public:
+  BtifA2dpSinkStats() { Reset(); }
+  void Reset() {
+    session_start_us = 0;
+    rx_packets = 0;
+    rx_bytes = 0;
+    rx_overflow_dropped = 0;
+    rx_underruns = 0;
+    total_queue_depth = 0;
+    max_queue_depth = 0;
+    latency_count = 0;
+    total_latency_us = 0;
+    max_latency_us = 0;
+  }
+
+  uint64_t session_start_us;
+  size_t rx_packets;
+  size_t rx_bytes;
+  size_t rx_overflow_dropped; /* Oldest packets dropped on a full queue */
+  size_t rx_underruns;        /* Decode ticks which found the queue empty */
+  // Depth of the queue once a packet is enqueued
+  uint64_t total_queue_depth;
+  size_t max_queue_depth;
+  // Time spent by the packets in the queue until they are decoded
+  size_t latency_count;
+  uint64_t total_latency_us;
+  uint64_t max_latency_us;
+};
+
 /* BTIF A2DP Sink control block */
 class BtifA2dpSinkControlBlock {
  public:
@@ -111,6 +149,7 @@ class BtifA2dpSinkControlBlock {
     sample_rate = 0;
     channel_count = 0;
     decoder_interface = nullptr;
+    stats.Reset();
   }
 
   MessageLoopThread worker_thread;
@@ -123,6 +162,7 @@ class BtifA2dpSinkControlBlock {
   btif_a2dp_sink_focus_state_t rx_focus_state; /* audio focus state */
   void* audio_track;
   const tA2DP_DECODER_INTERFACE* decoder_interface;
+  BtifA2dpSinkStats stats;
 };
 
 // Mutex for below data structures.
@@ -147,6 +187,7 @@ static void btif_a2dp_sink_avk_handle_timer();
 static void btif_a2dp_sink_audio_rx_flush_req();
 /* Handle incoming media packets A2DP SINK streaming */
 static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg);
+static void btif_a2dp_sink_record_latency(BT_HDR* p_pkt);
 static void btif_a2dp_sink_decoder_update_event(
     tBTIF_MEDIA_SINK_DECODER_UPDATE* p_buf);
 static void btif_a2dp_sink_clear_track_event();
@@ -194,7 +235,9 @@ bool btif_a2dp_sink_init() {
   btif_a2dp_sink_cb.rx_audio_queue = fixed_queue_new(SIZE_MAX);
 
   /* Schedule the rest of the operations */
-  if (!btif_a2dp_sink_cb.worker_thread.EnableRealTimeScheduling()) {
+  if (!thread_scheduler_apply_policy(
+          btif_a2dp_sink_cb.worker_thread.GetLinuxTid(),
+          ThreadRole::A2DP_SINK)) {
 #if defined(__ANDROID__)
     log::fatal("Failed to increase A2DP decoder thread priority");
 #endif
@@ -241,7 +284,9 @@ static void btif_a2dp_sink_start_session_delayed(
   log::info("");
   LockGuard lock(g_mutex);
   peer_ready_promise.set_value();
-  // Nothing to do
+  btif_a2dp_sink_cb.stats.Reset();
+  btif_a2dp_sink_cb.stats.session_start_us =
+      bluetooth::common::time_get_os_boottime_us();
 }
 
 bool btif_a2dp_sink_restart_session(const RawAddress& old_peer_address,
@@ -551,6 +596,7 @@ static void btif_a2dp_sink_avk_handle_timer() {
   BT_HDR* p_msg;
   if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
     log::verbose("empty queue");
+    btif_a2dp_sink_cb.stats.rx_underruns++;
     return;
   }
 
@@ -574,6 +620,8 @@ static void btif_a2dp_sink_avk_handle_timer() {
     log::verbose("number of packets in queue {}",
                  fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue));
 
+    btif_a2dp_sink_record_latency(p_msg);
+
     /* Queue packet has less frames */
     btif_a2dp_sink_handle_inc_media(p_msg);
     osi_free(p_msg);
@@ -665,23 +713,50 @@ static void btif_a2dp_sink_decoder_update_event(
   }
 }
 
+// The receive time of a queued packet is kept in the headroom left in front
+// of its payload by the headers parsed by the lower layers.
+static void btif_a2dp_sink_stamp_packet(BT_HDR* p_pkt, uint64_t now_us) {
+  if (p_pkt->offset < sizeof(now_us)) return;
+  memcpy(p_pkt->data, &now_us, sizeof(now_us));
+}
+
+static void btif_a2dp_sink_record_latency(BT_HDR* p_pkt) {
+  uint64_t received_us = 0;
+  if (p_pkt->offset < sizeof(received_us)) return;
+  memcpy(&received_us, p_pkt->data, sizeof(received_us));
+  if (received_us == 0) return;
+
+  BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+  uint64_t latency_us =
+      bluetooth::common::time_get_os_boottime_us() - received_us;
+  stats.latency_count++;
+  stats.total_latency_us += latency_us;
+  stats.max_latency_us = std::max(stats.max_latency_us, latency_us);
+}
+
 uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   LockGuard lock(g_mutex);
-  if (btif_a2dp_sink_cb.rx_flush) /* Flush enabled, do not enqueue */
+  if (btif_a2dp_sink_cb.rx_flush) { /* Flush enabled, do not enqueue */
+    osi_free(p_pkt);
     return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+  }
 
   log::verbose("+");
-  /* Allocate and queue this buffer */
-  BT_HDR* p_msg =
-      reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
-  memcpy(p_msg, p_pkt, sizeof(*p_msg));
-  p_msg->offset = 0;
-  memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
-  fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
-
-  if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
-      MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
+  /* Queue this buffer, the decoder reads it in place */
+  BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+  btif_a2dp_sink_stamp_packet(p_pkt,
+                              bluetooth::common::time_get_os_boottime_us());
+  stats.rx_packets++;
+  stats.rx_bytes += p_pkt->len;
+  fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_pkt);
+
+  size_t queue_depth = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
+  stats.total_queue_depth += queue_depth;
+  stats.max_queue_depth = std::max(stats.max_queue_depth, queue_depth);
+
+  if (queue_depth == MAX_INPUT_A2DP_FRAME_QUEUE_SZ) {
     osi_free(fixed_queue_try_dequeue(btif_a2dp_sink_cb.rx_audio_queue));
+    stats.rx_overflow_dropped++;
     uint8_t ret = fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
     return ret;
   }
@@ -714,8 +789,38 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(int /* fd */) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  const BtifA2dpSinkStats& stats = btif_a2dp_sink_cb.stats;
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+  dprintf(fd, "\nA2DP Sink State: %d\n", btif_a2dp_sink_state.load());
+  if (stats.session_start_us != 0) {
+    dprintf(fd, "  Session duration (ms): %" PRIu64 "\n",
+            (now_us - stats.session_start_us) / 1000);
+  }
+  dprintf(fd, "  Received packets (count/bytes): %zu / %zu\n",
+          stats.rx_packets, stats.rx_bytes);
+  dprintf(fd,
+          "  Receive queue depth (current/average/max): %zu / %" PRIu64
+          " / %zu\n",
+          btif_a2dp_sink_cb.rx_audio_queue != nullptr
+              ? fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue)
+              : 0,
+          stats.rx_packets != 0 ? stats.total_queue_depth / stats.rx_packets
+                                : 0,
+          stats.max_queue_depth);
+  dprintf(fd,
+          "  Receive queue latency in ms (average/max): %" PRIu64 " / %" PRIu64
+          "\n",
+          stats.latency_count != 0
+              ? stats.total_latency_us / stats.latency_count / 1000
+              : 0,
+          stats.max_latency_us / 1000);
+  dprintf(fd, "  Packets dropped on a full receive queue: %zu\n",
+          stats.rx_overflow_dropped);
+  dprintf(fd, "  Decoding ticks with an empty receive queue: %zu\n",
+          stats.rx_underruns);
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
@@ -20,6 +20,7 @@
 #define LOG_TAG "bluetooth-a2dp"
 #define ATRACE_TAG ATRACE_TAG_AUDIO
 
+#include <android_bluetooth_sysprop.h>
 #include <base/run_loop.h>
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
@@ -31,6 +32,8 @@
 #include <string.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <future>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
@@ -46,8 +49,10 @@
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
 #include "os/log.h"
+#include "os/trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/thread_scheduler.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
@@ -69,6 +74,24 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * Upper bound of the number of encoder intervals covered by one media tick,
+ * set by the encoder pipeline or reached by the adaptive media tick.
+ */
+#define MAX_ENCODER_INTERVALS_PER_MEDIA_TICK 8
+
+/**
+ * The adaptive media tick is stretched by one encoder interval after this
+ * many consecutive media ticks found the transmit queue empty.
+ */
+#define ADAPTIVE_MEDIA_TICK_SLACK_TICKS 50
+
+/**
+ * Transmit queue length reported to the encoder, for its bit rate adaptation,
+ * after the link reported new failed contacts.
+ */
+#define ENCODER_LINK_CONGESTED_QUEUE_LENGTH 2
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -116,6 +139,45 @@ class SchedulingStats {
   uint64_t total_scheduling_time_us;
 };
 
+// Distribution of a sampled value. Bucket 0 counts the zero samples, bucket
+// i counts the samples in [2^(i-1), 2^i) and the last bucket also counts all
+// the larger ones.
+class HistogramStats {
+ public:
+  static constexpr size_t kNumBuckets = 16;
+
+  HistogramStats() { Reset(); }
+  void Reset() {
+    total_samples = 0;
+    total_value = 0;
+    max_value = 0;
+    buckets.fill(0);
+  }
+
+  void Add(uint64_t value) {
+    size_t bucket = 0;
+    while (bucket < kNumBuckets - 1 && value >= (uint64_t{1} << bucket)) {
+      bucket++;
+    }
+    buckets[bucket]++;
+    total_samples++;
+    total_value += value;
+    max_value = std::max(max_value, value);
+  }
+
+  // Counter for total samples
+  size_t total_samples;
+
+  // Accumulated sample values
+  uint64_t total_value;
+
+  // Max. sample value
+  uint64_t max_value;
+
+  // Counters for the samples of each bucket
+  std::array<size_t, kNumBuckets> buckets;
+};
+
 class BtifMediaStats {
  public:
   BtifMediaStats() { Reset(); }
@@ -124,6 +186,11 @@ class BtifMediaStats {
     session_end_us = 0;
     tx_queue_enqueue_stats.Reset();
     tx_queue_dequeue_stats.Reset();
+    encoder_pipeline_stats.Reset();
+    encoder_pipeline_queue_depth.Reset();
+    encoder_pipeline_latency_us.Reset();
+    encoder_pipeline_late_count = 0;
+    media_tick_adjustments = 0;
     tx_queue_total_frames = 0;
     tx_queue_max_frames_per_packet = 0;
     tx_queue_total_queueing_time_us = 0;
@@ -148,6 +215,18 @@ class BtifMediaStats {
   SchedulingStats tx_queue_enqueue_stats;
   SchedulingStats tx_queue_dequeue_stats;
 
+  // Encoder pipeline: scheduling of the encoder jobs, number of packets
+  // encoded ahead at each media tick, time from a media tick to the end of
+  // its encoder job, and media ticks whose previous encoder job was still
+  // running.
+  SchedulingStats encoder_pipeline_stats;
+  HistogramStats encoder_pipeline_queue_depth;
+  HistogramStats encoder_pipeline_latency_us;
+  size_t encoder_pipeline_late_count;
+
+  // Changes of the media tick interval by the adaptive media tick
+  size_t media_tick_adjustments;
+
   size_t tx_queue_total_frames;
   size_t tx_queue_max_frames_per_packet;
 
@@ -183,6 +262,20 @@ class BtifA2dpSource {
 
   BtifA2dpSource()
       : tx_audio_queue(nullptr),
+        encoded_audio_queue(nullptr),
+        encoder_ticks_per_wakeup(1),
+        initial_ticks_per_wakeup(1),
+        max_ticks_per_wakeup(1),
+        adaptive_tick_slack_count(0),
+        adaptive_tick_underflow_count(0),
+        adaptive_tick_dropouts(0),
+        adaptive_tick_link_checked(false),
+        failed_contact_counter_pending(false),
+        link_congested(false),
+        encoder_link_congested(false),
+        failed_contact_counter(0),
+        failed_contact_counter_valid(false),
+        encoder_job_pending(false),
         tx_flush(false),
         sw_audio_is_encoding(false),
         encoder_interface(nullptr),
@@ -192,6 +285,12 @@ class BtifA2dpSource {
   void Reset() {
     fixed_queue_free(tx_audio_queue, nullptr);
     tx_audio_queue = nullptr;
+    fixed_queue_free(encoded_audio_queue, osi_free);
+    encoded_audio_queue = nullptr;
+    encoder_ticks_per_wakeup = 1;
+    initial_ticks_per_wakeup = 1;
+    max_ticks_per_wakeup = 1;
+    encoder_job_pending = false;
     tx_flush = false;
     media_alarm.CancelAndWait();
     wakelock_release();
@@ -219,6 +318,27 @@ class BtifA2dpSource {
   void SetState(BtifA2dpSource::RunState state) { state_ = state; }
 
   fixed_queue_t* tx_audio_queue;
+  // Packets encoded ahead by the encoder thread, handed over to
+  // |tx_audio_queue| at the next media tick. Only set when the encoder
+  // pipeline is enabled.
+  fixed_queue_t* encoded_audio_queue;
+  size_t encoder_ticks_per_wakeup; /* Encoder intervals per media tick */
+  size_t initial_ticks_per_wakeup; /* When the stream starts */
+  size_t max_ticks_per_wakeup;     /* Above initial for an adaptive tick */
+  // Adaptive media tick: consecutive ticks with an empty transmit queue and
+  // the underflow and drop-out counters at the previous tick.
+  size_t adaptive_tick_slack_count;
+  size_t adaptive_tick_underflow_count;
+  size_t adaptive_tick_dropouts;
+  bool adaptive_tick_link_checked;
+  // Failed Contact Counter feedback, written by
+  // btm_read_failed_contact_counter_cb().
+  std::atomic<bool> failed_contact_counter_pending;
+  std::atomic<bool> link_congested; /* The counter went up */
+  std::atomic<bool> encoder_link_congested; /* Same, for the encoder */
+  uint16_t failed_contact_counter;
+  bool failed_contact_counter_valid;
+  std::atomic<bool> encoder_job_pending;
   bool tx_flush; /* Discards any outgoing data when true */
   bool sw_audio_is_encoding;
   RepeatingTimer media_alarm;
@@ -233,6 +353,10 @@ class BtifA2dpSource {
 
 static bluetooth::common::MessageLoopThread btif_a2dp_source_thread(
     "bt_a2dp_source_worker_thread");
+// Reads and encodes the audio when the encoder pipeline is enabled, so that
+// the media ticks on |btif_a2dp_source_thread| only hand over packets.
+static bluetooth::common::MessageLoopThread btif_a2dp_source_encoder_thread(
+    "bt_a2dp_source_encoder_thread");
 static BtifA2dpSource btif_a2dp_source_cb;
 
 static uint8_t btif_a2dp_source_dynamic_audio_buffer_size =
@@ -265,6 +389,23 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static uint64_t btif_a2dp_source_media_tick_ms(void);
+static void btif_a2dp_source_schedule_media_tick(void);
+static void btif_a2dp_source_reschedule_media_tick(void);
+static void btif_a2dp_source_adapt_media_tick(size_t transmit_queue_length);
+static size_t btif_a2dp_source_encoder_queue_length(
+    size_t transmit_queue_length);
+static bool btif_a2dp_source_link_has_slack(void);
+static void btif_a2dp_source_send_frames(
+    const tA2DP_ENCODER_INTERFACE* encoder_interface, uint64_t timestamp_us,
+    size_t intervals);
+static size_t btif_a2dp_source_encoder_pipeline_tick(
+    uint64_t timestamp_us, uint64_t stats_timestamp_us);
+static void btif_a2dp_source_encoder_pipeline_encode(
+    uint64_t timestamp_us, uint64_t stats_timestamp_us,
+    size_t transmit_queue_length, size_t intervals);
+static void btif_a2dp_source_encoder_pipeline_drain(void);
+static void btif_a2dp_source_flush_tx_queues(uint64_t now_us);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
@@ -298,6 +439,16 @@ void btif_a2dp_source_accumulate_scheduling_stats(SchedulingStats* src,
   dst->total_scheduling_time_us += src->total_scheduling_time_us;
 }
 
+void btif_a2dp_source_accumulate_histogram_stats(HistogramStats* src,
+                                                 HistogramStats* dst) {
+  dst->total_samples += src->total_samples;
+  dst->total_value += src->total_value;
+  dst->max_value = std::max(dst->max_value, src->max_value);
+  for (size_t i = 0; i < HistogramStats::kNumBuckets; i++) {
+    dst->buckets[i] += src->buckets[i];
+  }
+}
+
 void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
                                        BtifMediaStats* dst) {
   dst->tx_queue_total_frames += src->tx_queue_total_frames;
@@ -325,6 +476,14 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
                                                &dst->tx_queue_enqueue_stats);
   btif_a2dp_source_accumulate_scheduling_stats(&src->tx_queue_dequeue_stats,
                                                &dst->tx_queue_dequeue_stats);
+  btif_a2dp_source_accumulate_scheduling_stats(&src->encoder_pipeline_stats,
+                                               &dst->encoder_pipeline_stats);
+  btif_a2dp_source_accumulate_histogram_stats(
+      &src->encoder_pipeline_queue_depth, &dst->encoder_pipeline_queue_depth);
+  btif_a2dp_source_accumulate_histogram_stats(
+      &src->encoder_pipeline_latency_us, &dst->encoder_pipeline_latency_us);
+  dst->encoder_pipeline_late_count += src->encoder_pipeline_late_count;
+  dst->media_tick_adjustments += src->media_tick_adjustments;
   src->Reset();
 }
 
@@ -361,6 +520,37 @@ bool btif_a2dp_source_startup(void) {
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateStartingUp);
   btif_a2dp_source_cb.tx_audio_queue = fixed_queue_new(SIZE_MAX);
 
+  // The encoder pipeline reads and encodes one media tick ahead on its own
+  // thread, into a ring of at most |depth| packets.
+  int pipeline_depth = GET_SYSPROP(A2dp, src_encoder_pipeline_depth, 0);
+  if (pipeline_depth > 0) {
+    int ticks_per_wakeup =
+        GET_SYSPROP(A2dp, src_encoder_pipeline_ticks_per_wakeup, 1);
+    btif_a2dp_source_cb.encoded_audio_queue = fixed_queue_new(pipeline_depth);
+    btif_a2dp_source_cb.initial_ticks_per_wakeup =
+        std::clamp(ticks_per_wakeup, 1, MAX_ENCODER_INTERVALS_PER_MEDIA_TICK);
+    log::info("encoder pipeline depth={} ticks_per_wakeup={}", pipeline_depth,
+              btif_a2dp_source_cb.initial_ticks_per_wakeup);
+    btif_a2dp_source_encoder_thread.StartUp();
+  }
+
+  // The adaptive media tick stretches the tick up to |max_intervals| encoder
+  // intervals while the link keeps up.
+  int max_intervals = GET_SYSPROP(A2dp, src_adaptive_tick_max_intervals, 0);
+  btif_a2dp_source_cb.max_ticks_per_wakeup =
+      std::clamp(static_cast<size_t>(std::max(max_intervals, 1)),
+                 btif_a2dp_source_cb.initial_ticks_per_wakeup,
+                 static_cast<size_t>(MAX_ENCODER_INTERVALS_PER_MEDIA_TICK));
+  if (pipeline_depth > 0) {
+    // Each encoder interval yields about one packet for the ready queue.
+    btif_a2dp_source_cb.max_ticks_per_wakeup = std::max(
+        std::min(btif_a2dp_source_cb.max_ticks_per_wakeup,
+                 static_cast<size_t>(pipeline_depth)),
+        btif_a2dp_source_cb.initial_ticks_per_wakeup);
+  }
+  btif_a2dp_source_cb.encoder_ticks_per_wakeup =
+      btif_a2dp_source_cb.initial_ticks_per_wakeup;
+
   // Schedule the rest of the operations
   btif_a2dp_source_thread.DoInThread(
       FROM_HERE, base::BindOnce(&btif_a2dp_source_startup_delayed));
@@ -370,9 +560,18 @@ bool btif_a2dp_source_startup(void) {
 
 static void btif_a2dp_source_startup_delayed() {
   log::info("state={}", btif_a2dp_source_cb.StateStr());
-  if (!btif_a2dp_source_thread.EnableRealTimeScheduling()) {
+  if (!thread_scheduler_apply_policy(btif_a2dp_source_thread.GetLinuxTid(),
+                                     ThreadRole::A2DP_SOURCE)) {
 #if defined(__ANDROID__)
     log::fatal("unable to enable real time scheduling");
+#endif
+  }
+  if (btif_a2dp_source_encoder_thread.IsRunning() &&
+      !thread_scheduler_apply_policy(
+          btif_a2dp_source_encoder_thread.GetLinuxTid(),
+          ThreadRole::A2DP_SOURCE_ENCODER)) {
+#if defined(__ANDROID__)
+    log::fatal("unable to enable real time scheduling of the encoder");
 #endif
   }
   if (!bluetooth::audio::a2dp::init(&btif_a2dp_source_thread)) {
@@ -507,6 +706,7 @@ static void btif_a2dp_source_shutdown_delayed(
 
   // Stop the timer
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
+  btif_a2dp_source_encoder_pipeline_drain();
   wakelock_release();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
@@ -516,6 +716,8 @@ static void btif_a2dp_source_shutdown_delayed(
   }
   fixed_queue_free(btif_a2dp_source_cb.tx_audio_queue, nullptr);
   btif_a2dp_source_cb.tx_audio_queue = nullptr;
+  fixed_queue_free(btif_a2dp_source_cb.encoded_audio_queue, osi_free);
+  btif_a2dp_source_cb.encoded_audio_queue = nullptr;
 
   btif_a2dp_source_cb.SetState(BtifA2dpSource::kStateOff);
 
@@ -534,6 +736,7 @@ void btif_a2dp_source_cleanup(void) {
 
   // Exit the thread
   btif_a2dp_source_thread.ShutDown();
+  btif_a2dp_source_encoder_thread.ShutDown();
 }
 
 static void btif_a2dp_source_cleanup_delayed(void) {
@@ -573,6 +776,8 @@ static void btif_a2dp_source_setup_codec_delayed(
   log::info("peer_address={} state={}", peer_address,
             btif_a2dp_source_cb.StateStr());
 
+  btif_a2dp_source_encoder_pipeline_drain();
+
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
   bta_av_co_get_peer_params(peer_address, &peer_params);
   if (com::android::bluetooth::flags::a2dp_concurrent_source_sink()) {
@@ -623,6 +828,7 @@ static void btif_a2dp_source_cleanup_codec() {
 
 static void btif_a2dp_source_cleanup_codec_delayed() {
   log::info("state={}", btif_a2dp_source_cb.StateStr());
+  btif_a2dp_source_encoder_pipeline_drain();
   if (btif_a2dp_source_cb.encoder_interface != nullptr) {
     btif_a2dp_source_cb.encoder_interface->encoder_cleanup();
     btif_a2dp_source_cb.encoder_interface = nullptr;
@@ -666,6 +872,7 @@ static void btif_a2dp_source_encoder_user_config_update_event(
     std::promise<void> peer_ready_promise) {
   bool restart_output = false;
   bool success = false;
+  btif_a2dp_source_encoder_pipeline_drain();
   for (auto codec_user_config : codec_user_preferences) {
     success = bta_av_co_set_codec_user_config(peer_address, codec_user_config,
                                               &restart_output);
@@ -708,6 +915,7 @@ void btif_a2dp_source_feeding_update_req(
 static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config) {
   log::info("state={}", btif_a2dp_source_cb.StateStr());
+  btif_a2dp_source_encoder_pipeline_drain();
   if (!bta_av_co_set_codec_audio_config(codec_audio_config)) {
     log::error("cannot update codec audio feeding parameters");
   }
@@ -807,19 +1015,20 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
       "assert failed: btif_a2dp_source_cb.encoder_interface != nullptr");
   btif_a2dp_source_cb.encoder_interface->feeding_reset();
 
-  log::verbose(
-      "starting timer {} ms",
-      btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms());
+  btif_a2dp_source_cb.encoder_ticks_per_wakeup =
+      btif_a2dp_source_cb.initial_ticks_per_wakeup;
+  btif_a2dp_source_cb.adaptive_tick_slack_count = 0;
+  btif_a2dp_source_cb.adaptive_tick_link_checked = false;
+  btif_a2dp_source_cb.link_congested = false;
+  btif_a2dp_source_cb.encoder_link_congested = false;
+
+  log::verbose("starting timer {} ms", btif_a2dp_source_media_tick_ms());
 
   /* audio engine starting, reset tx suspended flag */
   btif_a2dp_source_cb.tx_flush = false;
 
   wakelock_acquire();
-  btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
-      btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
-      base::BindRepeating(&btif_a2dp_source_audio_handle_timer),
-      std::chrono::milliseconds(
-          btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+  btif_a2dp_source_schedule_media_tick();
   btif_a2dp_source_cb.sw_audio_is_encoding = true;
 
   btif_a2dp_source_cb.stats.Reset();
@@ -864,6 +1073,10 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
   /* Stop the timer first */
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
+  btif_a2dp_source_encoder_pipeline_drain();
+  if (btif_a2dp_source_cb.encoded_audio_queue != nullptr) {
+    fixed_queue_flush(btif_a2dp_source_cb.encoded_audio_queue, osi_free);
+  }
   wakelock_release();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
@@ -897,6 +1110,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
 static void btif_a2dp_source_audio_handle_timer(void) {
   if (btif_av_is_a2dp_offload_running()) return;
+  BT_TRACE_SCOPE("A2DP source media tick");
 
   uint64_t timestamp_us = bluetooth::common::time_get_audio_server_tick_us();
   uint64_t stats_timestamp_us = bluetooth::common::time_get_os_boottime_us();
@@ -910,21 +1124,240 @@ static void btif_a2dp_source_audio_handle_timer(void) {
   log::assert_that(
       btif_a2dp_source_cb.encoder_interface != nullptr,
       "assert failed: btif_a2dp_source_cb.encoder_interface != nullptr");
+  // The scheduling stats expect the interval the tick was scheduled with.
+  uint64_t media_tick_us = btif_a2dp_source_media_tick_ms() * 1000;
+  size_t transmit_queue_length;
+  if (btif_a2dp_source_cb.encoded_audio_queue != nullptr) {
+    transmit_queue_length = btif_a2dp_source_encoder_pipeline_tick(
+        timestamp_us, stats_timestamp_us);
+  } else {
+    transmit_queue_length =
+        fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+#ifdef __ANDROID__
+    ATRACE_INT("btif TX queue", transmit_queue_length);
+#endif
+    if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
+        nullptr) {
+      btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
+          btif_a2dp_source_encoder_queue_length(transmit_queue_length));
+    }
+    btif_a2dp_source_send_frames(btif_a2dp_source_cb.encoder_interface,
+                                 timestamp_us,
+                                 btif_a2dp_source_cb.encoder_ticks_per_wakeup);
+  }
+  bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
+  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
+                          stats_timestamp_us, media_tick_us);
+  btif_a2dp_source_adapt_media_tick(transmit_queue_length);
+}
+
+static uint64_t btif_a2dp_source_media_tick_ms(void) {
+  return btif_a2dp_source_cb.encoder_interval_ms *
+         btif_a2dp_source_cb.encoder_ticks_per_wakeup;
+}
+
+static void btif_a2dp_source_schedule_media_tick(void) {
+  btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
+      btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
+      base::BindRepeating(&btif_a2dp_source_audio_handle_timer),
+      std::chrono::milliseconds(btif_a2dp_source_media_tick_ms()));
+}
+
+// The encoders cap the number of frames of a single call, so a media tick
+// spanning several encoder intervals sends them one by one.
+static void btif_a2dp_source_send_frames(
+    const tA2DP_ENCODER_INTERFACE* encoder_interface, uint64_t timestamp_us,
+    size_t intervals) {
+  uint64_t interval_us = btif_a2dp_source_cb.encoder_interval_ms * 1000;
+  for (size_t i = intervals; i > 0; i--) {
+    encoder_interface->send_frames(timestamp_us - (i - 1) * interval_us);
+  }
+}
+
+// Adaptive media tick: stretched by one encoder interval after
+// ADAPTIVE_MEDIA_TICK_SLACK_TICKS ticks that found the transmit queue empty,
+// provided the link reports no new failed contacts, and halved as soon as
+// packets pile up in the transmit queue, the media read underflows, packets
+// are dropped or the link reports new failed contacts.
+static void btif_a2dp_source_adapt_media_tick(size_t transmit_queue_length) {
+  BtifMediaStats& stats = btif_a2dp_source_cb.stats;
+  if (btif_a2dp_source_cb.max_ticks_per_wakeup <=
+      btif_a2dp_source_cb.initial_ticks_per_wakeup) {
+    return;
+  }
+
+  bool congested =
+      transmit_queue_length > 1 || btif_a2dp_source_cb.link_congested ||
+      stats.media_read_total_underflow_count !=
+          btif_a2dp_source_cb.adaptive_tick_underflow_count ||
+      stats.tx_queue_dropouts != btif_a2dp_source_cb.adaptive_tick_dropouts;
+  btif_a2dp_source_cb.adaptive_tick_underflow_count =
+      stats.media_read_total_underflow_count;
+  btif_a2dp_source_cb.adaptive_tick_dropouts = stats.tx_queue_dropouts;
+
+  size_t ticks = btif_a2dp_source_cb.encoder_ticks_per_wakeup;
+  size_t new_ticks = ticks;
+  if (congested) {
+    btif_a2dp_source_cb.link_congested = false;
+    btif_a2dp_source_cb.adaptive_tick_slack_count = 0;
+    btif_a2dp_source_cb.adaptive_tick_link_checked = false;
+    new_ticks =
+        std::max(ticks / 2, btif_a2dp_source_cb.initial_ticks_per_wakeup);
+  } else if (transmit_queue_length != 0 ||
+             ticks >= btif_a2dp_source_cb.max_ticks_per_wakeup) {
+    btif_a2dp_source_cb.adaptive_tick_slack_count = 0;
+  } else if (++btif_a2dp_source_cb.adaptive_tick_slack_count >=
+                 ADAPTIVE_MEDIA_TICK_SLACK_TICKS &&
+             btif_a2dp_source_link_has_slack()) {
+    btif_a2dp_source_cb.adaptive_tick_slack_count = 0;
+    new_ticks = ticks + 1;
+  }
+  if (new_ticks == ticks) return;
+
+  log::info("media tick {} -> {} encoder intervals, transmit queue length {}",
+            ticks, new_ticks, transmit_queue_length);
+  btif_a2dp_source_cb.encoder_ticks_per_wakeup = new_ticks;
+  stats.media_tick_adjustments++;
+  // The timer cannot be rescheduled from its own task.
+  btif_a2dp_source_thread.DoInThread(
+      FROM_HERE, base::BindOnce(&btif_a2dp_source_reschedule_media_tick));
+}
+
+// The transmit queue length reported to the encoders which adapt their bit
+// rate to it: new failed contacts on the link count as packets piling up, so
+// that the bit rate is lowered before the transmit queue overflows.
+static size_t btif_a2dp_source_encoder_queue_length(
+    size_t transmit_queue_length) {
+  if (btif_a2dp_source_cb.encoder_link_congested.exchange(false)) {
+    return std::max<size_t>(transmit_queue_length,
+                            ENCODER_LINK_CONGESTED_QUEUE_LENGTH);
+  }
+  return transmit_queue_length;
+}
+
+static void btif_a2dp_source_reschedule_media_tick(void) {
+  if (!btif_a2dp_source_is_streaming()) return;
+  btif_a2dp_source_schedule_media_tick();
+}
+
+// Returns true once a Failed Contact Counter read issued after the transmit
+// queue had slack found no new failed contacts on the link.
+static bool btif_a2dp_source_link_has_slack(void) {
+#ifdef TARGET_FLOSS
+  // See btif_a2dp_source_enqueue_callback().
+  return true;
+#else
+  if (btif_a2dp_source_cb.failed_contact_counter_pending) return false;
+  if (btif_a2dp_source_cb.adaptive_tick_link_checked) {
+    btif_a2dp_source_cb.adaptive_tick_link_checked = false;
+    return !btif_a2dp_source_cb.link_congested;
+  }
+
+  btif_a2dp_source_cb.failed_contact_counter_pending = true;
+  tBTM_STATUS status = BTM_ReadFailedContactCounter(
+      btif_av_source_active_peer(), btm_read_failed_contact_counter_cb);
+  if (status != BTM_CMD_STARTED) {
+    // Rely on the transmit queue alone.
+    log::warn("Cannot read Failed Contact Counter: status {}", status);
+    btif_a2dp_source_cb.failed_contact_counter_pending = false;
+    return true;
+  }
+  btif_a2dp_source_cb.adaptive_tick_link_checked = true;
+  return false;
+#endif
+}
+
+// Hands the packets encoded since the previous media tick over for
+// transmission, and starts encoding the audio of the next one. Returns the
+// length of the transmit queue.
+static size_t btif_a2dp_source_encoder_pipeline_tick(
+    uint64_t timestamp_us, uint64_t stats_timestamp_us) {
+  size_t ready_n = fixed_queue_length(btif_a2dp_source_cb.encoded_audio_queue);
+  btif_a2dp_source_cb.stats.encoder_pipeline_queue_depth.Add(ready_n);
+  while (ready_n-- > 0) {
+    void* p_buf =
+        fixed_queue_try_dequeue(btif_a2dp_source_cb.encoded_audio_queue);
+    if (p_buf == nullptr) break;
+    fixed_queue_enqueue(btif_a2dp_source_cb.tx_audio_queue, p_buf);
+  }
+
   size_t transmit_queue_length =
       fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
 #ifdef __ANDROID__
   ATRACE_INT("btif TX queue", transmit_queue_length);
 #endif
-  if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
-      nullptr) {
-    btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
-        transmit_queue_length);
+
+  if (btif_a2dp_source_cb.encoder_job_pending) {
+    // The next job catches up with the audio of this tick.
+    log::warn("encoder is late by one media tick");
+    btif_a2dp_source_cb.stats.encoder_pipeline_late_count++;
+    return transmit_queue_length;
+  }
+  btif_a2dp_source_cb.encoder_job_pending = true;
+  if (!btif_a2dp_source_encoder_thread.DoInThread(
+          FROM_HERE,
+          base::BindOnce(&btif_a2dp_source_encoder_pipeline_encode,
+                         timestamp_us, stats_timestamp_us,
+                         btif_a2dp_source_encoder_queue_length(
+                             transmit_queue_length),
+                         btif_a2dp_source_cb.encoder_ticks_per_wakeup))) {
+    log::error("cannot post to the encoder thread");
+    btif_a2dp_source_cb.encoder_job_pending = false;
+  }
+  return transmit_queue_length;
+}
+
+// This runs on the encoder thread
+static void btif_a2dp_source_encoder_pipeline_encode(
+    uint64_t timestamp_us, uint64_t stats_timestamp_us,
+    size_t transmit_queue_length, size_t intervals) {
+  BT_TRACE_SCOPE("A2DP source encode");
+  const tA2DP_ENCODER_INTERFACE* encoder_interface =
+      btif_a2dp_source_cb.encoder_interface;
+  if (encoder_interface != nullptr) {
+    if (encoder_interface->set_transmit_queue_length != nullptr) {
+      encoder_interface->set_transmit_queue_length(transmit_queue_length);
+    }
+    btif_a2dp_source_send_frames(encoder_interface, timestamp_us, intervals);
+  }
+
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  btif_a2dp_source_cb.stats.encoder_pipeline_latency_us.Add(
+      now_us - stats_timestamp_us);
+  update_scheduling_stats(
+      &btif_a2dp_source_cb.stats.encoder_pipeline_stats, now_us,
+      btif_a2dp_source_cb.encoder_interval_ms * 1000 * intervals);
+  btif_a2dp_source_cb.encoder_job_pending = false;
+}
+
+// Waits for the encoder job in flight, if any. Called on the media thread
+// before it uses or reconfigures the encoder, which the encoder thread only
+// accesses from the jobs posted by the media ticks.
+static void btif_a2dp_source_encoder_pipeline_drain(void) {
+  if (!btif_a2dp_source_encoder_thread.IsRunning()) return;
+
+  std::promise<void> drained_promise;
+  std::future<void> drained_future = drained_promise.get_future();
+  if (btif_a2dp_source_encoder_thread.DoInThread(
+          FROM_HERE, base::BindOnce(
+                         [](std::promise<void> promise) { promise.set_value(); },
+                         std::move(drained_promise)))) {
+    drained_future.wait();
+  }
+}
+
+// Discards the packets waiting for transmission and the packets encoded
+// ahead.
+static void btif_a2dp_source_flush_tx_queues(uint64_t now_us) {
+  btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
+      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+  btif_a2dp_source_cb.stats.tx_queue_last_flushed_us = now_us;
+  fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
+  if (btif_a2dp_source_cb.encoded_audio_queue != nullptr) {
+    btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
+        fixed_queue_length(btif_a2dp_source_cb.encoded_audio_queue);
+    fixed_queue_flush(btif_a2dp_source_cb.encoded_audio_queue, osi_free);
   }
-  btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
-  bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
-  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
-                          stats_timestamp_us,
-                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
 }
 
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
@@ -966,10 +1399,7 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
   if (btif_a2dp_source_cb.tx_flush) {
     log::verbose("tx suspended, discarded frame");
 
-    btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-        fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
-    btif_a2dp_source_cb.stats.tx_queue_last_flushed_us = now_us;
-    fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
+    btif_a2dp_source_flush_tx_queues(now_us);
 
     osi_free(p_buf);
     return false;
@@ -1043,6 +1473,18 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
       btif_a2dp_source_cb.encoder_interface != nullptr,
       "assert failed: btif_a2dp_source_cb.encoder_interface != nullptr");
 
+  if (btif_a2dp_source_cb.encoded_audio_queue != nullptr) {
+    // Encoder pipeline: the next media tick hands the packet over.
+    if (!fixed_queue_try_enqueue(btif_a2dp_source_cb.encoded_audio_queue,
+                                 p_buf)) {
+      log::warn("encoder pipeline full, discarded packet");
+      btif_a2dp_source_cb.stats.tx_queue_total_dropped_messages++;
+      osi_free(p_buf);
+      return false;
+    }
+    return true;
+  }
+
   fixed_queue_enqueue(btif_a2dp_source_cb.tx_audio_queue, p_buf);
 
   return true;
@@ -1053,14 +1495,12 @@ static void btif_a2dp_source_audio_tx_flush_event(void) {
   log::info("state={}", btif_a2dp_source_cb.StateStr());
   if (btif_av_is_a2dp_offload_running()) return;
 
+  btif_a2dp_source_encoder_pipeline_drain();
   if (btif_a2dp_source_cb.encoder_interface != nullptr)
     btif_a2dp_source_cb.encoder_interface->feeding_flush();
 
-  btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
-  btif_a2dp_source_cb.stats.tx_queue_last_flushed_us =
-      bluetooth::common::time_get_os_boottime_us();
-  fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
+  btif_a2dp_source_flush_tx_queues(
+      bluetooth::common::time_get_os_boottime_us());
 
   if (!bluetooth::audio::a2dp::is_hal_enabled() && a2dp_uipc != nullptr) {
     UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_REQ_RX_FLUSH, nullptr);
@@ -1227,6 +1667,30 @@ void btif_a2dp_source_debug_dump(int fd) {
                     1000
               : 0);
 
+  //
+  // Media tick stats
+  //
+  size_t counted_ticks = enqueue_stats->overdue_scheduling_count +
+                         enqueue_stats->premature_scheduling_count +
+                         enqueue_stats->exact_scheduling_count;
+  unsigned long long wakeups_per_sec_x100 = 0;
+  if (enqueue_stats->total_scheduling_time_us != 0) {
+    wakeups_per_sec_x100 = (unsigned long long)counted_ticks * 100000000 /
+                           enqueue_stats->total_scheduling_time_us;
+  }
+  dprintf(fd,
+          "  Media tick wakeups per sec / underruns                  : "
+          "%llu.%02llu / %zu\n",
+          wakeups_per_sec_x100 / 100, wakeups_per_sec_x100 % 100,
+          accumulated_stats->media_read_total_underflow_count);
+
+  dprintf(fd,
+          "  Media tick in encoder intervals (now/max/adjustments)   : %zu / "
+          "%zu / %zu\n",
+          btif_a2dp_source_cb.encoder_ticks_per_wakeup,
+          btif_a2dp_source_cb.max_ticks_per_wakeup,
+          accumulated_stats->media_tick_adjustments);
+
   //
   // TxQueue enqueue stats
   //
@@ -1302,6 +1766,54 @@ void btif_a2dp_source_debug_dump(int fd) {
       (unsigned long long)dequeue_stats->max_premature_scheduling_delta_us /
           1000,
       (unsigned long long)ave_time_us / 1000);
+
+  //
+  // Encoder pipeline stats
+  //
+  if (btif_a2dp_source_cb.encoded_audio_queue == nullptr) return;
+
+  SchedulingStats* encoder_stats = &accumulated_stats->encoder_pipeline_stats;
+  dprintf(fd,
+          "  Encoder pipeline (depth/ticks per wakeup)               : %zu / "
+          "%zu\n",
+          fixed_queue_capacity(btif_a2dp_source_cb.encoded_audio_queue),
+          btif_a2dp_source_cb.encoder_ticks_per_wakeup);
+
+  dprintf(fd,
+          "  Encoder counts (jobs/late ticks/overdue/premature)      : %zu / "
+          "%zu / %zu / %zu\n",
+          encoder_stats->total_updates,
+          accumulated_stats->encoder_pipeline_late_count,
+          encoder_stats->overdue_scheduling_count,
+          encoder_stats->premature_scheduling_count);
+
+  HistogramStats* depth_stats = &accumulated_stats->encoder_pipeline_queue_depth;
+  HistogramStats* latency_stats =
+      &accumulated_stats->encoder_pipeline_latency_us;
+  dprintf(fd,
+          "  Encoder queue depth in packets (max/ave)                : %llu / "
+          "%llu\n",
+          (unsigned long long)depth_stats->max_value,
+          (unsigned long long)(depth_stats->total_samples != 0
+                                   ? depth_stats->total_value /
+                                         depth_stats->total_samples
+                                   : 0));
+  dprintf(fd,
+          "  Encoder latency in us (max/ave)                         : %llu / "
+          "%llu\n",
+          (unsigned long long)latency_stats->max_value,
+          (unsigned long long)(latency_stats->total_samples != 0
+                                   ? latency_stats->total_value /
+                                         latency_stats->total_samples
+                                   : 0));
+
+  // Bucket i > 0 holds the samples below 2^i
+  dprintf(fd, "  Encoder queue depth histogram (0/<2/<4/...)             :");
+  for (size_t count : depth_stats->buckets) dprintf(fd, " %zu", count);
+  dprintf(fd, "\n");
+  dprintf(fd, "  Encoder latency histogram in us (0/<2/<4/...)           :");
+  for (size_t count : latency_stats->buckets) dprintf(fd, " %zu", count);
+  dprintf(fd, "\n");
 }
 
 static void btif_a2dp_source_update_metrics(void) {
@@ -1386,6 +1898,7 @@ static void btm_read_rssi_cb(void* data) {
 }
 
 static void btm_read_failed_contact_counter_cb(void* data) {
+  btif_a2dp_source_cb.failed_contact_counter_pending = false;
   if (data == nullptr) {
     log::error("Read Failed Contact Counter request timed out");
     return;
@@ -1398,6 +1911,15 @@ static void btm_read_failed_contact_counter_cb(void* data) {
                result->status);
     return;
   }
+  // Feedback for the adaptive media tick and the encoder bit rate
+  if (btif_a2dp_source_cb.failed_contact_counter_valid &&
+      result->failed_contact_counter >
+          btif_a2dp_source_cb.failed_contact_counter) {
+    btif_a2dp_source_cb.link_congested = true;
+    btif_a2dp_source_cb.encoder_link_congested = true;
+  }
+  btif_a2dp_source_cb.failed_contact_counter = result->failed_contact_counter;
+  btif_a2dp_source_cb.failed_contact_counter_valid = true;
   log_read_failed_contact_counter_result(
       result->rem_bda, bluetooth::common::kUnknownConnectionHandle,
       result->hci_status, result->failed_contact_counter);
@@ -17,6 +17,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "bta_av"
 
 #include "btif/include/btif_av.h"
 
@@ -3455,8 +3456,10 @@ static void bta_av_sink_media_callback(const RawAddress& peer_address,
             (state == BtifAvStateMachine::kStateOpened)) {
           uint8_t queue_len = btif_a2dp_sink_enqueue_buf((BT_HDR*)p_data);
           log::verbose("Packets in Sink queue {}", queue_len);
+          break;
         }
       }
+      osi_free(p_data);
       break;
     }
     case BTA_AV_SINK_MEDIA_CFG_EVT: {
@@ -23,12 +23,14 @@
 
 #include <cerrno>
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 #include "btif/include/stack_manager_t.h"
 #include "btif_bqr.h"
 #include "btif_common.h"
 #include "btif_storage.h"
-#include "common/leaky_bonded_queue.h"
+#include "common/leaky_ring_queue.h"
 #include "common/postable_context.h"
 #include "common/time_util.h"
 #include "core_callbacks.h"
@@ -36,6 +38,7 @@
 #include "hci/hci_packets.h"
 #include "internal_include/bt_trace.h"
 #include "main/shim/entry.h"
+#include "os/metrics_writer.h"
 #include "osi/include/properties.h"
 #include "packet/raw_builder.h"
 #include "raw_address.h"
@@ -47,11 +50,11 @@
 namespace bluetooth {
 namespace bqr {
 
-using bluetooth::common::LeakyBondedQueue;
+using bluetooth::common::LeakyRingQueue;
 using std::chrono::system_clock;
 
 // The instance of BQR event queue
-static LeakyBondedQueue<BqrVseSubEvt> kpBqrEventQueue{kBqrEventQueueSize};
+static LeakyRingQueue<BqrVseSubEvt> kpBqrEventQueue{kBqrEventQueueSize};
 
 static uint16_t vendor_cap_supported_version;
 
@@ -60,7 +63,15 @@ std::unique_ptr<BluetoothQualityReportInterface> bluetoothQualityReportInstance;
 
 namespace {
 common::PostableContext* to_bind_ = nullptr;
+
+// Return the writer of the LMP/LL message and scheduling trace log files. The
+// trace log file descriptors and counters are only accessed from its thread.
+os::MetricsWriter& GetTraceLogWriter() {
+  static auto writer =
+      new os::MetricsWriter(kTraceLogWriterCapacity, "bt_bqr_trace_writer");
+  return *writer;
 }
+}  // namespace
 
 void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length,
                                           const uint8_t* p_param_buf) {
@@ -155,9 +166,6 @@ void BqrVseSubEvt::ParseBqrLinkQualityEvt(uint8_t length,
 
 void BqrVseSubEvt::WriteLmpLlTraceLogFile(int fd, uint8_t length,
                                           const uint8_t* p_param_buf) {
-  const auto now = system_clock::to_time_t(system_clock::now());
-  localtime_r(&now, &tm_timestamp_);
-
   STREAM_TO_UINT8(bqr_log_dump_event_.quality_report_id, p_param_buf);
   STREAM_TO_UINT16(bqr_log_dump_event_.connection_handle, p_param_buf);
   length -= kLogDumpParamTotalLen;
@@ -168,18 +176,15 @@ void BqrVseSubEvt::WriteLmpLlTraceLogFile(int fd, uint8_t length,
          << std::put_time(&tm_timestamp_, "%m-%d %H:%M:%S ")
          << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
          << " VSP: ";
+  ss_log.write(reinterpret_cast<const char*>(p_param_buf), length);
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
-  TEMP_FAILURE_RETRY(
-      write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
+  const std::string record = ss_log.str();
+  TEMP_FAILURE_RETRY(write(fd, record.c_str(), record.size()));
   LmpLlMessageTraceCounter++;
 }
 
 void BqrVseSubEvt::WriteBtSchedulingTraceLogFile(int fd, uint8_t length,
                                                  const uint8_t* p_param_buf) {
-  const auto now = system_clock::to_time_t(system_clock::now());
-  localtime_r(&now, &tm_timestamp_);
-
   STREAM_TO_UINT8(bqr_log_dump_event_.quality_report_id, p_param_buf);
   STREAM_TO_UINT16(bqr_log_dump_event_.connection_handle, p_param_buf);
   length -= kLogDumpParamTotalLen;
@@ -190,10 +195,10 @@ void BqrVseSubEvt::WriteBtSchedulingTraceLogFile(int fd, uint8_t length,
          << std::put_time(&tm_timestamp_, "%m-%d %H:%M:%S ")
          << "Handle: " << loghex(bqr_log_dump_event_.connection_handle)
          << " VSP: ";
+  ss_log.write(reinterpret_cast<const char*>(p_param_buf), length);
 
-  TEMP_FAILURE_RETRY(write(fd, ss_log.str().c_str(), ss_log.str().size()));
-  TEMP_FAILURE_RETRY(
-      write(fd, bqr_log_dump_event_.vendor_specific_parameter, length));
+  const std::string record = ss_log.str();
+  TEMP_FAILURE_RETRY(write(fd, record.c_str(), record.size()));
   BtSchedulingTraceCounter++;
 }
 
@@ -584,17 +589,22 @@ static void ConfigureBqrCmpl(uint32_t current_evt_mask) {
     ConfigBqrA2dpScoThreshold();
   }
 
-  if (LmpLlMessageTraceLogFd != INVALID_FD &&
-      (current_evt_mask & kQualityEventMaskLmpMessageTrace) == 0) {
-    log::info("Closing LMP/LL log file.");
-    close(LmpLlMessageTraceLogFd);
-    LmpLlMessageTraceLogFd = INVALID_FD;
-  }
-  if (BtSchedulingTraceLogFd != INVALID_FD &&
-      (current_evt_mask & kQualityEventMaskBtSchedulingTrace) == 0) {
-    log::info("Closing Scheduling log file.");
-    close(BtSchedulingTraceLogFd);
-    BtSchedulingTraceLogFd = INVALID_FD;
+  // Close the files after the trace records already queued have been written.
+  while (!GetTraceLogWriter().Post([current_evt_mask]() {
+    if (LmpLlMessageTraceLogFd != INVALID_FD &&
+        (current_evt_mask & kQualityEventMaskLmpMessageTrace) == 0) {
+      log::info("Closing LMP/LL log file.");
+      close(LmpLlMessageTraceLogFd);
+      LmpLlMessageTraceLogFd = INVALID_FD;
+    }
+    if (BtSchedulingTraceLogFd != INVALID_FD &&
+        (current_evt_mask & kQualityEventMaskBtSchedulingTrace) == 0) {
+      log::info("Closing Scheduling log file.");
+      close(BtSchedulingTraceLogFd);
+      BtSchedulingTraceLogFd = INVALID_FD;
+    }
+  })) {
+    std::this_thread::yield();
   }
 }
 
@@ -730,16 +740,25 @@ static int OpenLmpLlTraceLogFile();
 // @param p_lmp_ll_message_event A pointer to the LMP/LL message trace event.
 static void DumpLmpLlMessage(uint8_t length,
                              const uint8_t* p_lmp_ll_message_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
-
-  if (LmpLlMessageTraceLogFd == INVALID_FD ||
-      LmpLlMessageTraceCounter >= kLogDumpEventPerFile) {
-    LmpLlMessageTraceLogFd = OpenLmpLlTraceLogFile();
-  }
-  if (LmpLlMessageTraceLogFd != INVALID_FD) {
-    p_bqr_event->WriteLmpLlTraceLogFile(LmpLlMessageTraceLogFd, length,
-                                        p_lmp_ll_message_event);
-  }
+  auto p_bqr_event = std::make_shared<BqrVseSubEvt>();
+  const auto now = system_clock::to_time_t(system_clock::now());
+  localtime_r(&now, &p_bqr_event->tm_timestamp_);
+
+  // The file is written from the trace log writer thread, the event is dropped
+  // if too many trace events are already waiting to be written.
+  GetTraceLogWriter().Post(
+      [p_bqr_event,
+       event = std::vector<uint8_t>(p_lmp_ll_message_event,
+                                    p_lmp_ll_message_event + length)]() {
+        if (LmpLlMessageTraceLogFd == INVALID_FD ||
+            LmpLlMessageTraceCounter >= kLogDumpEventPerFile) {
+          LmpLlMessageTraceLogFd = OpenLmpLlTraceLogFile();
+        }
+        if (LmpLlMessageTraceLogFd != INVALID_FD) {
+          p_bqr_event->WriteLmpLlTraceLogFile(
+              LmpLlMessageTraceLogFd, event.size(), event.data());
+        }
+      });
 }
 
 // Open the LMP/LL message trace log file.
@@ -776,16 +795,23 @@ static int OpenBtSchedulingTraceLogFile();
 //   scheduling trace event.
 static void DumpBtScheduling(uint8_t length,
                              const uint8_t* p_bt_scheduling_event) {
-  std::unique_ptr<BqrVseSubEvt> p_bqr_event = std::make_unique<BqrVseSubEvt>();
-
-  if (BtSchedulingTraceLogFd == INVALID_FD ||
-      BtSchedulingTraceCounter == kLogDumpEventPerFile) {
-    BtSchedulingTraceLogFd = OpenBtSchedulingTraceLogFile();
-  }
-  if (BtSchedulingTraceLogFd != INVALID_FD) {
-    p_bqr_event->WriteBtSchedulingTraceLogFile(BtSchedulingTraceLogFd, length,
-                                               p_bt_scheduling_event);
-  }
+  auto p_bqr_event = std::make_shared<BqrVseSubEvt>();
+  const auto now = system_clock::to_time_t(system_clock::now());
+  localtime_r(&now, &p_bqr_event->tm_timestamp_);
+
+  GetTraceLogWriter().Post(
+      [p_bqr_event,
+       event = std::vector<uint8_t>(p_bt_scheduling_event,
+                                    p_bt_scheduling_event + length)]() {
+        if (BtSchedulingTraceLogFd == INVALID_FD ||
+            BtSchedulingTraceCounter == kLogDumpEventPerFile) {
+          BtSchedulingTraceLogFd = OpenBtSchedulingTraceLogFile();
+        }
+        if (BtSchedulingTraceLogFd != INVALID_FD) {
+          p_bqr_event->WriteBtSchedulingTraceLogFile(
+              BtSchedulingTraceLogFd, event.size(), event.data());
+        }
+      });
 }
 
 // Open the Bluetooth Multi-profile/Coex scheduling trace log file.
@@ -816,6 +842,18 @@ static int OpenBtSchedulingTraceLogFile() {
 void DebugDump(int fd) {
   dprintf(fd, "\nBT Quality Report Events: \n");
 
+  uint64_t dropped_trace_count = GetTraceLogWriter().GetDroppedCount();
+  if (dropped_trace_count > 0) {
+    dprintf(fd, "Trace log events dropped: %llu\n",
+            static_cast<unsigned long long>(dropped_trace_count));
+  }
+
+  uint64_t dropped_event_count = kpBqrEventQueue.GetDroppedCount();
+  if (dropped_event_count > 0) {
+    dprintf(fd, "Oldest events dropped: %llu\n",
+            static_cast<unsigned long long>(dropped_event_count));
+  }
+
   if (kpBqrEventQueue.Empty()) {
     dprintf(fd, "Event queue is empty.\n");
     return;
@@ -990,7 +1028,11 @@ void unregister_vse() {
 }
 
 namespace testing {
-void set_lmp_trace_log_fd(int fd) { LmpLlMessageTraceLogFd = fd; }
+void set_lmp_trace_log_fd(int fd) {
+  GetTraceLogWriter().Post([fd]() { LmpLlMessageTraceLogFd = fd; });
+}
+
+void flush_trace_log() { GetTraceLogWriter().Flush(); }
 }  // namespace testing
 
 }  // namespace bqr
@@ -330,6 +330,20 @@ void btif_config_remove_device(const std::string& section) {
   bluetooth::shim::BtifConfigInterface::RemoveSection(section);
 }
 
+std::vector<bluetooth::shim::DeviceProperties>
+btif_config_get_paired_device_properties() {
+  log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
+                   "assert failed: bluetooth::shim::is_gd_stack_started_up()");
+  auto devices =
+      bluetooth::shim::BtifConfigInterface::GetPersistentDeviceProperties();
+  // Only keep the sections named after a device address, as
+  // btif_config_get_paired_devices() does
+  std::erase_if(devices, [](const bluetooth::shim::DeviceProperties& device) {
+    return !RawAddress::IsValidAddress(device.section);
+  });
+  return devices;
+}
+
 bool btif_config_clear(void) {
   log::assert_that(bluetooth::shim::is_gd_stack_started_up(),
                    "assert failed: bluetooth::shim::is_gd_stack_started_up()");
@@ -347,51 +347,48 @@ bt_status_t btif_in_execute_service_request(tBTA_SERVICE_ID service_id,
 /**
  * Helper method to get asha advertising service data
  * @param inq_res {@code tBTA_DM_INQ_RES} inquiry result
+ * @param eir index of the EIR fields of the inquiry result
  * @param asha_capability value will be updated as non-negative if found,
  * otherwise return -1
  * @param asha_truncated_hi_sync_id value will be updated if found, otherwise no
  * change
  */
 static void get_asha_service_data(const tBTA_DM_INQ_RES& inq_res,
+                                  const AdvertiseDataIndex& eir,
                                   int16_t& asha_capability,
                                   uint32_t& asha_truncated_hi_sync_id) {
   asha_capability = -1;
-  if (inq_res.p_eir) {
-    const RawAddress& bdaddr = inq_res.bd_addr;
-
-    // iterate through advertisement service data
-    const uint8_t* p_service_data = inq_res.p_eir;
-    uint8_t service_data_len = 0;
-    while ((p_service_data = AdvertiseDataParser::GetFieldByType(
-                p_service_data + service_data_len,
-                inq_res.eir_len - (p_service_data - inq_res.p_eir) -
-                    service_data_len,
-                BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE, &service_data_len))) {
-      if (service_data_len < 2) {
-        continue;
-      }
-      uint16_t uuid;
-      const uint8_t* p_uuid = p_service_data;
-      STREAM_TO_UINT16(uuid, p_uuid);
+  const RawAddress& bdaddr = inq_res.bd_addr;
+
+  // iterate through advertisement service data
+  eir.ForEachField(
+      BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE,
+      [&](std::span<const uint8_t> service_data) {
+        if (service_data.size() < 2) {
+          return true;
+        }
+        uint16_t uuid;
+        const uint8_t* p_uuid = service_data.data();
+        STREAM_TO_UINT16(uuid, p_uuid);
 
-      if (uuid == 0xfdf0 /* ASHA service*/) {
+        if (uuid != 0xfdf0 /* ASHA service*/) {
+          return true;
+        }
         log::info("ASHA found in {}", bdaddr);
 
         // ASHA advertisement service data length should be at least 8
-        if (service_data_len < 8) {
+        if (service_data.size() < 8) {
           log::warn("ASHA device service_data_len too short");
         } else {
           // It is intended to save ASHA capability byte to int16_t
-          asha_capability = p_service_data[3];
+          asha_capability = service_data[3];
           log::info("asha_capability: {}", asha_capability);
 
-          const uint8_t* p_truncated_hisyncid = &(p_service_data[4]);
+          const uint8_t* p_truncated_hisyncid = &(service_data[4]);
           STREAM_TO_UINT32(asha_truncated_hi_sync_id, p_truncated_hisyncid);
         }
-        break;
-      }
-    }
-  }
+        return false;
+      });
 }
 
 /*******************************************************************************
@@ -404,34 +401,30 @@ static void get_asha_service_data(const tBTA_DM_INQ_RES& inq_res,
  *                  Populate p_remote_name, if provided and remote name found
  *
  ******************************************************************************/
-static bool check_eir_remote_name(tBTA_DM_SEARCH* p_search_data,
+static bool check_eir_remote_name(const AdvertiseDataIndex& eir,
                                   uint8_t* p_remote_name,
                                   uint8_t* p_remote_name_len) {
   const uint8_t* p_eir_remote_name = NULL;
   uint8_t remote_name_len = 0;
 
   /* Check EIR for remote name and services */
-  if (p_search_data->inq_res.p_eir) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
-        HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
-    if (!p_eir_remote_name) {
-      p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-          p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
-          HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
-    }
-
-    if (p_eir_remote_name) {
-      if (remote_name_len > BD_NAME_LEN) remote_name_len = BD_NAME_LEN;
+  p_eir_remote_name =
+      eir.GetFieldByType(HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
+  if (!p_eir_remote_name) {
+    p_eir_remote_name =
+        eir.GetFieldByType(HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
+  }
 
-      if (p_remote_name && p_remote_name_len) {
-        memcpy(p_remote_name, p_eir_remote_name, remote_name_len);
-        *(p_remote_name + remote_name_len) = 0;
-        *p_remote_name_len = remote_name_len;
-      }
+  if (p_eir_remote_name) {
+    if (remote_name_len > BD_NAME_LEN) remote_name_len = BD_NAME_LEN;
 
-      return true;
+    if (p_remote_name && p_remote_name_len) {
+      memcpy(p_remote_name, p_eir_remote_name, remote_name_len);
+      *(p_remote_name + remote_name_len) = 0;
+      *p_remote_name_len = remote_name_len;
     }
+
+    return true;
   }
 
   return false;
@@ -447,24 +440,21 @@ static bool check_eir_remote_name(tBTA_DM_SEARCH* p_search_data,
  *                  Populate p_appearance, if provided and appearance found
  *
  ******************************************************************************/
-static bool check_eir_appearance(tBTA_DM_SEARCH* p_search_data,
+static bool check_eir_appearance(const AdvertiseDataIndex& eir,
                                  uint16_t* p_appearance) {
   const uint8_t* p_eir_appearance = NULL;
   uint8_t appearance_len = 0;
 
   /* Check EIR for remote name and services */
-  if (p_search_data->inq_res.p_eir) {
-    p_eir_appearance = AdvertiseDataParser::GetFieldByType(
-        p_search_data->inq_res.p_eir, p_search_data->inq_res.eir_len,
-        HCI_EIR_APPEARANCE_TYPE, &appearance_len);
-
-    if (p_eir_appearance && appearance_len >= 2) {
-      if (p_appearance) {
-        *p_appearance = *((uint16_t*)p_eir_appearance);
-      }
+  p_eir_appearance =
+      eir.GetFieldByType(HCI_EIR_APPEARANCE_TYPE, &appearance_len);
 
-      return true;
+  if (p_eir_appearance && appearance_len >= 2) {
+    if (p_appearance) {
+      *p_appearance = *((uint16_t*)p_eir_appearance);
     }
+
+    return true;
   }
 
   return false;
@@ -606,6 +596,7 @@ static void bond_state_changed(bt_status_t status, const RawAddress& bd_addr,
     if (com::android::bluetooth::flags::
             bond_transport_after_bond_cancel_fix()) {
       btif_config_remove_device(bd_addr.ToString());
+      btif_storage_invalidate_remote_device_properties(&bd_addr);
     }
 
     if (bluetooth::common::init_flags::
@@ -832,6 +823,7 @@ static void btif_dm_cb_create_bond(const RawAddress bd_addr,
   if (transport == BT_TRANSPORT_LE) {
     if (!btif_config_get_int(bdstr, BTIF_STORAGE_KEY_DEV_TYPE, &device_type)) {
       btif_config_set_int(bdstr, BTIF_STORAGE_KEY_DEV_TYPE, BT_DEVICE_TYPE_BLE);
+      btif_storage_invalidate_remote_device_properties(&bd_addr);
     }
     if (btif_storage_get_remote_addr_type(&bd_addr, &addr_type) !=
         BT_STATUS_SUCCESS) {
@@ -1416,17 +1408,23 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
       uint8_t num_uuids = 0, max_num_uuid = 32;
       uint8_t uuid_list[32 * Uuid::kNumBytes16];
 
-      if (p_search_data->inq_res.inq_result_type != BT_DEVICE_TYPE_BLE) {
-        p_search_data->inq_res.remt_name_not_required =
-            check_eir_remote_name(p_search_data, NULL, NULL);
-      }
+      /* Index the EIR fields once for all the lookups below */
+      AdvertiseDataIndex eir(
+          p_search_data->inq_res.p_eir,
+          p_search_data->inq_res.p_eir ? p_search_data->inq_res.eir_len : 0);
+
       RawAddress& bdaddr = p_search_data->inq_res.bd_addr;
 
       log::verbose("addr:{} device_type=0x{:x}", bdaddr,
                    p_search_data->inq_res.device_type);
       bdname.name[0] = 0;
 
-      if (!check_eir_remote_name(p_search_data, bdname.name, &remote_name_len))
+      bool eir_has_name =
+          check_eir_remote_name(eir, bdname.name, &remote_name_len);
+      if (p_search_data->inq_res.inq_result_type != BT_DEVICE_TYPE_BLE) {
+        p_search_data->inq_res.remt_name_not_required = eir_has_name;
+      }
+      if (!eir_has_name)
         get_cached_remote_name(p_search_data->inq_res.bd_addr, bdname.name,
                                  &remote_name_len);
 
@@ -1526,7 +1524,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
         // contains ASHA truncated HiSyncId if asha_capability is non-negative
         uint32_t asha_truncated_hi_sync_id = 0;
 
-        get_asha_service_data(p_search_data->inq_res, asha_capability,
+        get_asha_service_data(p_search_data->inq_res, eir, asha_capability,
                               asha_truncated_hi_sync_id);
 
         bt_properties.push_back(
@@ -1580,7 +1578,7 @@ static void btif_dm_search_devices_evt(tBTA_DM_SEARCH_EVT event,
 
         // Floss needs appearance for metrics purposes
         uint16_t appearance = 0;
-        if (check_eir_appearance(p_search_data, &appearance)) {
+        if (check_eir_appearance(eir, &appearance)) {
           bt_properties.push_back(bt_property_t{
               BT_PROPERTY_APPEARANCE, sizeof(appearance), &appearance});
         }
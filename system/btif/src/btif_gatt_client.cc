@@ -142,25 +142,6 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
       break;
     }
 
-    case BTA_GATTC_NOTIF_EVT: {
-      btgatt_notify_params_t data;
-
-      data.bda = p_data->notify.bda;
-      memcpy(data.value, p_data->notify.value, p_data->notify.len);
-
-      data.handle = p_data->notify.handle;
-      data.is_notify = p_data->notify.is_notify;
-      data.len = p_data->notify.len;
-
-      HAL_CBACK(bt_gatt_callbacks, client->notify_cb, p_data->notify.conn_id,
-                data);
-
-      if (!p_data->notify.is_notify)
-        BTA_GATTC_SendIndConfirm(p_data->notify.conn_id, p_data->notify.cid);
-
-      break;
-    }
-
     case BTA_GATTC_OPEN_EVT: {
       log::debug("BTA_GATTC_OPEN_EVT {}", p_data->open.remote_bda);
       HAL_CBACK(bt_gatt_callbacks, client->open_cb, p_data->open.conn_id,
@@ -235,9 +216,38 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
   }
 }
 
+static void btif_gattc_notify_evt(uint16_t conn_id, uint16_t cid,
+                                  btgatt_notify_params_t* p_data) {
+  HAL_CBACK(bt_gatt_callbacks, client->notify_cb, conn_id, *p_data);
+
+  if (!p_data->is_notify) BTA_GATTC_SendIndConfirm(conn_id, cid);
+}
+
+/* Notifications bypass the generic context switch, which copies the whole
+ * tBTA_GATTC union: only the received bytes are copied, once, into the
+ * parameters handed to the upper layer. */
+static void btif_gattc_post_notify(const tBTA_GATTC_NOTIFY& notify) {
+  btgatt_notify_params_t* p_data = new btgatt_notify_params_t;
+
+  p_data->bda = notify.bda;
+  memcpy(p_data->value, notify.value, notify.len);
+  p_data->handle = notify.handle;
+  p_data->is_notify = notify.is_notify;
+  p_data->len = notify.len;
+
+  bt_status_t status = do_in_jni_thread(base::BindOnce(
+      &btif_gattc_notify_evt, notify.conn_id, notify.cid, Owned(p_data)));
+  ASSERTC(status == BT_STATUS_SUCCESS, "Context transfer failed!", status);
+}
+
 static void bta_gattc_cback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
   log::debug("gatt client callback event:{} [{}]",
              gatt_client_event_text(event), event);
+  if (event == BTA_GATTC_NOTIF_EVT) {
+    btif_gattc_post_notify(p_data->notify);
+    return;
+  }
+
   bt_status_t status =
       btif_transfer_context(btif_gattc_upstreams_evt, (uint16_t)event,
                             (char*)p_data, sizeof(tBTA_GATTC), NULL);
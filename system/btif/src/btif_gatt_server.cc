@@ -80,17 +80,7 @@ extern const btgatt_callbacks_t* bt_gatt_callbacks;
  *  Static functions
  ******************************************************************************/
 
-static void btapp_gatts_copy_req_data(uint16_t event, char* p_dest,
-                                      const char* p_src) {
-  tBTA_GATTS* p_dest_data = (tBTA_GATTS*)p_dest;
-  const tBTA_GATTS* p_src_data = (const tBTA_GATTS*)p_src;
-
-  if (!p_src_data || !p_dest_data) return;
-
-  // Copy basic structure first
-  maybe_non_aligned_memcpy(p_dest_data, p_src_data, sizeof(*p_src_data));
-
-  // Allocate buffer for request data if necessary
+static bool btapp_gatts_has_req_data(uint16_t event) {
   switch (event) {
     case BTA_GATTS_READ_CHARACTERISTIC_EVT:
     case BTA_GATTS_READ_DESCRIPTOR_EVT:
@@ -98,30 +88,29 @@ static void btapp_gatts_copy_req_data(uint16_t event, char* p_dest,
     case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
     case BTA_GATTS_EXEC_WRITE_EVT:
     case BTA_GATTS_MTU_EVT:
-      p_dest_data->req_data.p_data =
-          (tGATTS_DATA*)osi_malloc(sizeof(tGATTS_DATA));
-      memcpy(p_dest_data->req_data.p_data, p_src_data->req_data.p_data,
-             sizeof(tGATTS_DATA));
-      break;
+      return true;
 
     default:
-      break;
+      return false;
   }
 }
 
-static void btapp_gatts_free_req_data(uint16_t event, tBTA_GATTS* p_data) {
-  switch (event) {
-    case BTA_GATTS_READ_CHARACTERISTIC_EVT:
-    case BTA_GATTS_READ_DESCRIPTOR_EVT:
-    case BTA_GATTS_WRITE_CHARACTERISTIC_EVT:
-    case BTA_GATTS_WRITE_DESCRIPTOR_EVT:
-    case BTA_GATTS_EXEC_WRITE_EVT:
-    case BTA_GATTS_MTU_EVT:
-      if (p_data != NULL) osi_free_and_reset((void**)&p_data->req_data.p_data);
-      break;
+/* The request data is copied right after the event, in the same message, so
+ * that the message is freed at once once handled */
+static void btapp_gatts_copy_req_data(uint16_t event, char* p_dest,
+                                      const char* p_src) {
+  tBTA_GATTS* p_dest_data = (tBTA_GATTS*)p_dest;
+  const tBTA_GATTS* p_src_data = (const tBTA_GATTS*)p_src;
 
-    default:
-      break;
+  if (!p_src_data || !p_dest_data) return;
+
+  // Copy basic structure first
+  maybe_non_aligned_memcpy(p_dest_data, p_src_data, sizeof(*p_src_data));
+
+  if (btapp_gatts_has_req_data(event)) {
+    p_dest_data->req_data.p_data = (tGATTS_DATA*)(p_dest + sizeof(tBTA_GATTS));
+    memcpy(p_dest_data->req_data.p_data, p_src_data->req_data.p_data,
+           sizeof(tGATTS_DATA));
   }
 }
 
@@ -258,14 +247,14 @@ static void btapp_gatts_handle_cback(uint16_t event, char* p_param) {
       log::error("Unhandled event ({})!", event);
       break;
   }
-
-  btapp_gatts_free_req_data(event, p_data);
 }
 
 static void btapp_gatts_cback(tBTA_GATTS_EVT event, tBTA_GATTS* p_data) {
   bt_status_t status;
+  int param_len = sizeof(tBTA_GATTS);
+  if (btapp_gatts_has_req_data(event)) param_len += sizeof(tGATTS_DATA);
   status = btif_transfer_context(btapp_gatts_handle_cback, (uint16_t)event,
-                                 (char*)p_data, sizeof(tBTA_GATTS),
+                                 (char*)p_data, param_len,
                                  btapp_gatts_copy_req_data);
   ASSERTC(status == BT_STATUS_SUCCESS, "Context transfer failed!", status);
 }
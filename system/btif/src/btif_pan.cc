@@ -36,10 +36,17 @@
 #include <linux/if_ether.h>
 #include <linux/if_tun.h>
 #include <net/if.h>
-#include <poll.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <deque>
+#include <utility>
+#include <vector>
+
 #include "bta/include/bta_pan_api.h"
 #include "btif/include/btif_common.h"
 #include "btif/include/btif_pan_internal.h"
@@ -66,13 +73,15 @@
 #define FORWARD_FAILURE (-1)
 #define FORWARD_CONGEST (-2)
 
+/* Maximum number of frames read from the TAP interface per wakeup of the TAP
+ * reader thread, all handed over to the main thread in a single task */
+#define BTPAN_TAP_READ_BATCH 32
+
 #define asrt(s)                                                   \
   do {                                                            \
     if (!(s)) log::error("btif_pan: ## assert {} failed ##", #s); \
   } while (0)
 
-#define MIN(x, y) (((x) < (y)) ? (x) : (y))
-
 using namespace bluetooth;
 
 btpan_cb_t btpan_cb;
@@ -92,7 +101,17 @@ static void btpan_tap_fd_signaled(int fd, int type, int flags,
                                   uint32_t user_id);
 static void btpan_cleanup_conn(btpan_conn_t* conn);
 static void bta_pan_callback(tBTA_PAN_EVT event, tBTA_PAN* p_data);
-static void btu_exec_tap_fd_read(const int fd);
+
+/* Ethernet frames read from the TAP interface, oldest first */
+typedef std::vector<std::vector<uint8_t>> btpan_tap_frames_t;
+static void btu_exec_tap_frames(const int fd, btpan_tap_frames_t frames);
+
+/* Frames read from the TAP interface and not forwarded yet, because of a full
+ * BNEP queue or of the flow control. Main thread only. */
+static std::deque<std::vector<uint8_t>> tap_rx_pending;
+/* Set while tap_rx_pending is not empty: the TAP reader thread then has the
+ * main thread retry them rather than reading more frames */
+static std::atomic<bool> tap_rx_blocked;
 
 static btpan_interface_t pan_if = {
     sizeof(pan_if), btpan_jni_init,   nullptr,          btpan_get_local_role,
@@ -251,6 +270,8 @@ static bt_status_t btpan_disconnect(const RawAddress* bd_addr) {
 
 static int pan_pth = -1;
 void create_tap_read_thread(int tap_fd) {
+  tap_rx_pending.clear();
+  tap_rx_blocked = false;
   if (pan_pth < 0) pan_pth = btsock_thread_create(btpan_tap_fd_signaled, NULL);
   if (pan_pth >= 0)
     btsock_thread_add_fd(pan_pth, tap_fd, 0, SOCK_THREAD_FD_RD, 0);
@@ -352,7 +373,8 @@ void btpan_set_flow_control(bool enable) {
   if (enable) {
     btsock_thread_add_fd(pan_pth, btpan_cb.tap_fd, 0, SOCK_THREAD_FD_RD, 0);
     do_in_main_thread(FROM_HERE,
-                      base::BindOnce(btu_exec_tap_fd_read, btpan_cb.tap_fd));
+                      base::BindOnce(btu_exec_tap_frames, btpan_cb.tap_fd,
+                                     btpan_tap_frames_t()));
   }
 }
 
@@ -401,18 +423,25 @@ int btpan_tap_send(int tap_fd, const RawAddress& src, const RawAddress& dst,
     eth_hdr.h_dest = dst;
     eth_hdr.h_src = src;
     eth_hdr.h_proto = htons(proto);
-    char packet[TAP_MAX_PKT_WRITE_LEN + sizeof(tETH_HDR)];
-    memcpy(packet, &eth_hdr, sizeof(tETH_HDR));
     if (len > TAP_MAX_PKT_WRITE_LEN) {
       log::error("btpan_tap_send eth packet size:{} is exceeded limit!", len);
+      btpan_cb.tap_tx_errors++;
       return -1;
     }
-    memcpy(packet + sizeof(tETH_HDR), buf, len);
 
-    /* Send data to network interface */
+    /* Send data to network interface, the TAP driver makes a single frame of
+     * the header and the payload */
+    struct iovec iov[2] = {{&eth_hdr, sizeof(tETH_HDR)},
+                           {const_cast<char*>(buf), len}};
     ssize_t ret;
-    OSI_NO_INTR(ret = write(tap_fd, packet, len + sizeof(tETH_HDR)));
+    OSI_NO_INTR(ret = writev(tap_fd, iov, 2));
     log::verbose("ret:{}", ret);
+    if (ret < 0) {
+      btpan_cb.tap_tx_errors++;
+    } else {
+      btpan_cb.tap_tx_frames++;
+      btpan_cb.tap_tx_bytes += ret;
+    }
     return (int)ret;
   }
   return -1;
@@ -532,7 +561,7 @@ static inline bool should_forward(tETH_HDR* hdr) {
   return false;
 }
 
-static int forward_bnep(tETH_HDR* eth_hdr, BT_HDR* hdr) {
+static int forward_bnep(tETH_HDR* eth_hdr, uint8_t* data, uint16_t len) {
   int broadcast = eth_hdr->h_dest.address[0] & 1;
 
   // Find the right connection to send this frame over.
@@ -541,8 +570,10 @@ static int forward_bnep(tETH_HDR* eth_hdr, BT_HDR* hdr) {
     if (handle != (uint16_t)-1 &&
         (broadcast || btpan_cb.conns[i].eth_addr == eth_hdr->h_dest ||
          btpan_cb.conns[i].peer == eth_hdr->h_dest)) {
-      int result = PAN_WriteBuf(handle, eth_hdr->h_dest, eth_hdr->h_src,
-                                ntohs(eth_hdr->h_proto), hdr, 0);
+      // PAN_Write copies the data, which is left intact to be sent again
+      // when the BNEP queue is full
+      int result = PAN_Write(handle, eth_hdr->h_dest, eth_hdr->h_src,
+                             ntohs(eth_hdr->h_proto), data, len, 0);
       switch (result) {
         case PAN_Q_SIZE_EXCEEDED:
           return FORWARD_CONGEST;
@@ -553,7 +584,6 @@ static int forward_bnep(tETH_HDR* eth_hdr, BT_HDR* hdr) {
       }
     }
   }
-  osi_free(hdr);
   return FORWARD_IGNORE;
 }
 
@@ -643,82 +673,38 @@ static void bta_pan_callback(tBTA_PAN_EVT event, tBTA_PAN* p_data) {
                         sizeof(tBTA_PAN), NULL);
 }
 
-#define IS_EXCEPTION(e) ((e) & (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL))
-static void btu_exec_tap_fd_read(int fd) {
-  struct pollfd ufd;
-
+/* Runs on the main thread: forwards the frames read by the TAP reader thread
+ * to BNEP, after the ones left over from the previous batches */
+static void btu_exec_tap_frames(int fd, btpan_tap_frames_t frames) {
   if (fd == INVALID_FD || fd != btpan_cb.tap_fd) return;
 
-  // Don't occupy BTU context too long, avoid buffer overruns and
-  // give other profiles a chance to run by limiting the amount of memory
-  // PAN can use.
-  for (int i = 0; i < PAN_BUF_MAX && btif_is_enabled() && btpan_cb.flow; i++) {
-    BT_HDR* buffer = (BT_HDR*)osi_malloc(PAN_BUF_SIZE);
-    buffer->offset = PAN_MINIMUM_OFFSET;
-    buffer->len = PAN_BUF_SIZE - sizeof(BT_HDR) - buffer->offset;
-
-    uint8_t* packet = (uint8_t*)buffer + sizeof(BT_HDR) + buffer->offset;
-
-    // If we don't have an undelivered packet left over, pull one from the TAP
-    // driver.
-    // We save it in the congest_packet right away in case we can't deliver it
-    // in this
-    // attempt.
-    if (!btpan_cb.congest_packet_size) {
-      ssize_t ret;
-      OSI_NO_INTR(ret = read(fd, btpan_cb.congest_packet,
-                             sizeof(btpan_cb.congest_packet)));
-      switch (ret) {
-        case -1:
-          log::error("unable to read from driver: {}", strerror(errno));
-          osi_free(buffer);
-          // add fd back to monitor thread to try it again later
-          btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
-          return;
-        case 0:
-          log::warn("end of file reached.");
-          osi_free(buffer);
-          // add fd back to monitor thread to process the exception
-          btsock_thread_add_fd(pan_pth, fd, 0, SOCK_THREAD_FD_RD, 0);
-          return;
-        default:
-          btpan_cb.congest_packet_size = ret;
-          break;
-      }
-    }
+  if (!frames.empty()) btpan_cb.tap_rx_batches++;
+  for (auto& frame : frames) tap_rx_pending.push_back(std::move(frame));
 
-    memcpy(packet, btpan_cb.congest_packet,
-           MIN(btpan_cb.congest_packet_size, buffer->len));
-    buffer->len = MIN(btpan_cb.congest_packet_size, buffer->len);
+  while (!tap_rx_pending.empty() && btif_is_enabled() && btpan_cb.flow) {
+    std::vector<uint8_t>& frame = tap_rx_pending.front();
 
-    if (buffer->len > sizeof(tETH_HDR) && should_forward((tETH_HDR*)packet)) {
-      // Extract the ethernet header from the buffer since the PAN_WriteBuf
-      // inside
-      // forward_bnep can't handle two pointers that point inside the same GKI
-      // buffer.
+    if (frame.size() > sizeof(tETH_HDR) &&
+        should_forward((tETH_HDR*)frame.data())) {
+      // Extract the ethernet header, the frame data may not be aligned for it.
       tETH_HDR hdr;
-      memcpy(&hdr, packet, sizeof(tETH_HDR));
+      memcpy(&hdr, frame.data(), sizeof(tETH_HDR));
 
       // Skip the ethernet header.
-      buffer->len -= sizeof(tETH_HDR);
-      buffer->offset += sizeof(tETH_HDR);
-      if (forward_bnep(&hdr, buffer) != FORWARD_CONGEST)
-        btpan_cb.congest_packet_size = 0;
+      if (forward_bnep(&hdr, frame.data() + sizeof(tETH_HDR),
+                       frame.size() - sizeof(tETH_HDR)) == FORWARD_CONGEST) {
+        btpan_cb.tap_rx_congested++;
+        break;
+      }
+      btpan_cb.tap_rx_frames++;
+      btpan_cb.tap_rx_bytes += frame.size();
     } else {
-      log::warn("dropping packet of length {}", buffer->len);
-      btpan_cb.congest_packet_size = 0;
-      osi_free(buffer);
+      log::warn("dropping packet of length {}", frame.size());
+      btpan_cb.tap_rx_drops++;
     }
-
-    // Bail out of the loop if reading from the TAP fd would block.
-    ufd.fd = fd;
-    ufd.events = POLLIN;
-    ufd.revents = 0;
-
-    int ret;
-    OSI_NO_INTR(ret = poll(&ufd, 1, 0));
-    if (ret <= 0 || IS_EXCEPTION(ufd.revents)) break;
+    tap_rx_pending.pop_front();
   }
+  tap_rx_blocked = !tap_rx_pending.empty();
 
   if (btpan_cb.flow) {
     // add fd back to monitor thread when the flow is on
@@ -726,6 +712,53 @@ static void btu_exec_tap_fd_read(int fd) {
   }
 }
 
+/* Runs on the TAP reader thread when the TAP fd is readable: reads all the
+ * available frames, up to BTPAN_TAP_READ_BATCH, and hands them over to the
+ * main thread. The fd is monitored again once the main thread took them. */
+static void btpan_tap_read_frames(int fd) {
+  btpan_tap_frames_t frames;
+
+  // Frames blocked by the BNEP queue are retried before reading new ones.
+  while (!tap_rx_blocked && frames.size() < BTPAN_TAP_READ_BATCH) {
+    std::vector<uint8_t> frame(TAP_MAX_PKT_READ_LEN);
+    ssize_t ret;
+    OSI_NO_INTR(ret = read(fd, frame.data(), frame.size()));
+    if (ret == 0) {
+      log::warn("end of file reached.");
+      break;
+    }
+    if (ret < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        log::error("unable to read from driver: {}", strerror(errno));
+      }
+      break;
+    }
+    frame.resize(ret);
+    frames.push_back(std::move(frame));
+  }
+
+  do_in_main_thread(FROM_HERE,
+                    base::BindOnce(btu_exec_tap_frames, fd, std::move(frames)));
+}
+
+void btif_debug_pan_dump(int fd) {
+  dprintf(fd, "\nPAN data path:\n");
+  dprintf(fd, "  TAP interface open: %s connections: %d flow: %s\n",
+          btpan_cb.tap_fd != INVALID_FD ? "true" : "false",
+          btpan_cb.open_count, btpan_cb.flow ? "on" : "off");
+  dprintf(fd,
+          "  To BNEP: batches: %" PRIu64 " frames: %" PRIu64 " bytes: %" PRIu64
+          " drops: %" PRIu64 " congested: %" PRIu64 "\n",
+          btpan_cb.tap_rx_batches, btpan_cb.tap_rx_frames,
+          btpan_cb.tap_rx_bytes, btpan_cb.tap_rx_drops,
+          btpan_cb.tap_rx_congested);
+  dprintf(fd,
+          "  To TAP: frames: %" PRIu64 " bytes: %" PRIu64 " errors: %" PRIu64
+          "\n",
+          btpan_cb.tap_tx_frames, btpan_cb.tap_tx_bytes,
+          btpan_cb.tap_tx_errors);
+}
+
 static void btif_pan_close_all_conns() {
   if (!stack_initialized) return;
 
@@ -750,6 +783,6 @@ static void btpan_tap_fd_signaled(int fd, int type, int flags,
     btpan_tap_close(fd);
     btif_pan_close_all_conns();
   } else if (flags & SOCK_THREAD_FD_RD) {
-    do_in_main_thread(FROM_HERE, base::BindOnce(btu_exec_tap_fd_read, fd));
+    btpan_tap_read_frames(fd);
   }
 }
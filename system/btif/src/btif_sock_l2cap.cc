@@ -82,6 +82,10 @@ typedef struct l2cap_socket {
   Uuid conn_uuid;       // The connection uuid
 } l2cap_socket;
 
+// Maximum number of messages exchanged with the app in a single
+// sendmmsg/recvmmsg.
+#define MAX_L2CAP_SOCK_BATCH 8
+
 static void btsock_l2cap_server_listen(l2cap_socket* sock);
 
 static std::mutex state_lock;
@@ -918,26 +922,45 @@ bt_status_t btsock_l2cap_connect(const RawAddress* bd_addr, int channel,
  * (for example: unrecoverable error or no data)
  */
 static bool flush_incoming_que_on_wr_signal_l(l2cap_socket* sock) {
-  uint8_t* buf;
-  uint32_t len;
+  /* The socket is created with SOCK_SEQPACKET, so each queued packet is sent
+   * as its own message, but several of them are handed to a single
+   * sendmmsg. */
+  struct mmsghdr msgs[MAX_L2CAP_SOCK_BATCH];
+  struct iovec iov[MAX_L2CAP_SOCK_BATCH];
+
+  while (sock->first_packet) {
+    unsigned int batch = 0;
+    for (struct packet* p = sock->first_packet;
+         p && batch < MAX_L2CAP_SOCK_BATCH; p = p->next) {
+      iov[batch].iov_base = p->data;
+      iov[batch].iov_len = p->len;
+      memset(&msgs[batch], 0, sizeof(msgs[batch]));
+      msgs[batch].msg_hdr.msg_iov = &iov[batch];
+      msgs[batch].msg_hdr.msg_iovlen = 1;
+      batch++;
+    }
 
-  while (packet_get_head_l(sock, &buf, &len)) {
-    ssize_t sent;
-    OSI_NO_INTR(sent = send(sock->our_fd, buf, len, MSG_DONTWAIT));
-    int saved_errno = errno;
+    int sent;
+    OSI_NO_INTR(sent = sendmmsg(sock->our_fd, msgs, batch, MSG_DONTWAIT));
+    if (sent < 0) return errno == EWOULDBLOCK || errno == EAGAIN;
+    if (!sent) /* special case if other end not keeping up */
+      return true;
 
-    if (sent == (signed)len)
-      osi_free(buf);
-    else if (sent >= 0) {
-      packet_put_head_l(sock, buf + sent, len - sent);
-      osi_free(buf);
-      if (!sent) /* special case if other end not keeping up */
+    for (int i = 0; i < sent; i++) {
+      uint8_t* buf;
+      uint32_t len;
+      packet_get_head_l(sock, &buf, &len);
+      if (msgs[i].msg_len < len) {
+        packet_put_head_l(sock, buf + msgs[i].msg_len,
+                          len - msgs[i].msg_len);
+        osi_free(buf);
         return true;
-    } else {
-      packet_put_head_l(sock, buf, len);
+      }
       osi_free(buf);
-      return saved_errno == EWOULDBLOCK || saved_errno == EAGAIN;
     }
+
+    /* The app socket is full, wait for the next write signal */
+    if ((unsigned int)sent < batch) return true;
   }
 
   return false;
@@ -977,29 +1000,56 @@ void btsock_l2cap_signaled(int fd, int flags, uint32_t user_id) {
            BluetoothSocket.write(...) guarantees that any packet send to this
            socket is broken into pieces no bigger than MTU bytes (as requested
            by BT spec). */
-        size = std::min(size, (int)sock->tx_mtu);
-
-        BT_HDR* buffer = malloc_l2cap_buf(size);
-        /* The socket is created with SOCK_SEQPACKET, hence we read one message
-         * at the time. */
-        ssize_t count;
-        OSI_NO_INTR(count = recv(fd, get_l2cap_sdu_start_ptr(buffer), size,
-                                 MSG_NOSIGNAL | MSG_DONTWAIT | MSG_TRUNC));
-        if (count > sock->tx_mtu) {
-          /* This can't happen thanks to check in BluetoothSocket.java but leave
-           * this in case this socket is ever used anywhere else*/
-          log::error("recv more than MTU. Data will be lost: {}", count);
-          count = sock->tx_mtu;
+        int len = std::min(size, (int)sock->tx_mtu);
+
+        /* The socket is created with SOCK_SEQPACKET, hence each buffer holds
+           one message. Read as many messages as the awaiting bytes may hold
+           at the MTU, up to MAX_L2CAP_SOCK_BATCH, with a single recvmmsg. */
+        unsigned int batch = 1;
+        if (len > 0)
+          batch = std::min((unsigned int)MAX_L2CAP_SOCK_BATCH,
+                           (unsigned int)((size + len - 1) / len));
+
+        BT_HDR* buffers[MAX_L2CAP_SOCK_BATCH];
+        struct mmsghdr msgs[MAX_L2CAP_SOCK_BATCH];
+        struct iovec iov[MAX_L2CAP_SOCK_BATCH];
+        for (unsigned int i = 0; i < batch; i++) {
+          buffers[i] = malloc_l2cap_buf(len);
+          iov[i].iov_base = get_l2cap_sdu_start_ptr(buffers[i]);
+          iov[i].iov_len = len;
+          memset(&msgs[i], 0, sizeof(msgs[i]));
+          msgs[i].msg_hdr.msg_iov = &iov[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
         }
 
-        /* When multiple packets smaller than MTU are flushed to the socket, the
-           size of the single packet read could be smaller than the ioctl
-           reported total size of awaiting packets. Hence, we adjust the buffer
-           length. */
-        buffer->len = count;
-
-        // will take care of freeing buffer
-        BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffer), buffer, user_id);
+        int received;
+        OSI_NO_INTR(received = recvmmsg(fd, msgs, batch,
+                                        MSG_NOSIGNAL | MSG_DONTWAIT, NULL));
+        if (received < 0) received = 0;
+
+        for (unsigned int i = 0; i < batch; i++) {
+          if (i >= (unsigned int)received) {
+            osi_free(buffers[i]);
+            continue;
+          }
+
+          if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            /* This can't happen thanks to check in BluetoothSocket.java but
+             * leave this in case this socket is ever used anywhere else*/
+            log::error("recv more than MTU. Data will be lost: {}",
+                       msgs[i].msg_len);
+          }
+
+          /* When multiple packets smaller than MTU are flushed to the socket,
+             the size of the single packet read could be smaller than the
+             ioctl reported total size of awaiting packets. Hence, we adjust
+             the buffer length. */
+          buffers[i]->len = std::min(msgs[i].msg_len, (unsigned int)len);
+
+          // will take care of freeing buffer
+          BTA_JvL2capWrite(sock->handle, PTR_TO_UINT(buffers[i]), buffers[i],
+                           user_id);
+        }
       }
     } else
       drop_it = true;
@@ -26,6 +26,7 @@
 #include "btif/include/btif_metrics_logging.h"
 #include "btif/include/btif_sock.h"
 #include "os/log.h"
+#include "stack/include/port_api.h"
 #include "types/raw_address.h"
 
 #define SOCK_LOGGER_SIZE_MAX 16
@@ -96,6 +97,8 @@ void btif_sock_dump(int fd) {
     index %= SOCK_LOGGER_SIZE_MAX;
   } while (index != head);
   dprintf(fd, "\n");
+
+  PORT_Dumpsys(fd);
 }
 
 void SockConnectionEvent::dump(const int fd) {
@@ -55,6 +55,9 @@ using namespace bluetooth;
 // Maximum number of devices we can have an RFCOMM connection with.
 #define MAX_RFC_SESSION 7
 
+// Maximum number of queued buffers written to the app in a single sendmsg.
+#define MAX_RFC_WRITE_BATCH 16
+
 typedef struct {
   int outgoing_congest : 1;
   int pending_sdp_request : 1;
@@ -915,10 +918,56 @@ static sent_status_t send_data_to_app(int fd, BT_HDR* p_buf) {
   return SENT_PARTIAL;
 }
 
+// Writes the buffers at the front of |queue| to the app with a single
+// sendmsg, removing those sent completely. The socket is a stream, so the
+// buffers do not need to be written separately.
+static sent_status_t send_queued_data_to_app(int fd, list_t* queue) {
+  struct iovec iov[MAX_RFC_WRITE_BATCH];
+  size_t count = 0;
+  size_t total = 0;
+
+  for (const list_node_t* node = list_begin(queue);
+       node != list_end(queue) && count < MAX_RFC_WRITE_BATCH;
+       node = list_next(node)) {
+    BT_HDR* p_buf = (BT_HDR*)list_node(node);
+    iov[count].iov_base = p_buf->data + p_buf->offset;
+    iov[count].iov_len = p_buf->len;
+    total += p_buf->len;
+    count++;
+  }
+
+  ssize_t sent = 0;
+  if (total != 0) {
+    struct msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    OSI_NO_INTR(sent = sendmsg(fd, &msg, MSG_DONTWAIT));
+
+    if (sent == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return SENT_NONE;
+      log::error("error writing RFCOMM data back to app: {}", strerror(errno));
+      return SENT_FAILED;
+    }
+
+    if (sent == 0) return SENT_FAILED;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    BT_HDR* p_buf = (BT_HDR*)list_front(queue);
+    if ((size_t)sent < p_buf->len) {
+      p_buf->offset += sent;
+      p_buf->len -= sent;
+      return SENT_PARTIAL;
+    }
+    sent -= p_buf->len;
+    list_remove(queue, p_buf);
+  }
+  return SENT_ALL;
+}
+
 static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
   while (!list_is_empty(slot->incoming_queue)) {
-    BT_HDR* p_buf = (BT_HDR*)list_front(slot->incoming_queue);
-    switch (send_data_to_app(slot->fd, p_buf)) {
+    switch (send_queued_data_to_app(slot->fd, slot->incoming_queue)) {
       case SENT_NONE:
       case SENT_PARTIAL:
         // monitor the fd to get callback when app is ready to receive data
@@ -927,11 +976,10 @@ static bool flush_incoming_que_on_wr_signal(rfc_slot_t* slot) {
         return true;
 
       case SENT_ALL:
-        list_remove(slot->incoming_queue, p_buf);
         break;
 
       case SENT_FAILED:
-        list_remove(slot->incoming_queue, p_buf);
+        list_remove(slot->incoming_queue, list_front(slot->incoming_queue));
         return false;
     }
   }
@@ -38,6 +38,9 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
 #include <unordered_set>
 #include <vector>
 
@@ -47,6 +50,7 @@
 #include "btif_storage.h"
 #include "btif_util.h"
 #include "common/init_flags.h"
+#include "common/lru.h"
 #include "core_callbacks.h"
 #include "hci/controller_interface.h"
 #include "internal_include/bt_target.h"
@@ -62,6 +66,11 @@
 /* This is a local property to add a device found */
 #define BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP 0xFF
 
+/* Number of remote devices whose properties are cached */
+#ifndef BTIF_STORAGE_PROPERTY_CACHE_SIZE
+#define BTIF_STORAGE_PROPERTY_CACHE_SIZE 256
+#endif
+
 using base::Bind;
 using bluetooth::Uuid;
 using namespace bluetooth;
@@ -108,10 +117,163 @@ void btif_gatts_add_bonded_dev_from_nv(const RawAddress& bda);
 
 static bool btif_has_ble_keys(const std::string& bdstr);
 
+/*******************************************************************************
+ *  Static variables
+ ******************************************************************************/
+
+/* Typed copy of the remote device properties read on most discovery and
+ * bonding callbacks, so that these reads do not parse the config strings
+ * again. The cache is written through: prop2cfg() updates it along with the
+ * config, and cfg2prop() fills it from the config on a miss. Properties
+ * missing from the config are not cached. */
+typedef struct {
+  std::optional<std::string> name;
+  std::optional<std::string> alias;
+  std::optional<int> dev_class;
+  std::optional<int> dev_type;
+  std::optional<std::vector<Uuid>> uuids;
+} btif_storage_cached_properties_t;
+
+/* Held across the config access so that the cache follows the config */
+static std::mutex remote_properties_mutex;
+static bluetooth::common::LegacyLruCache<RawAddress,
+                                         btif_storage_cached_properties_t>
+    remote_properties_cache(BTIF_STORAGE_PROPERTY_CACHE_SIZE,
+                            "btif_storage");
+
 /*******************************************************************************
  *  Static functions
  ******************************************************************************/
 
+static bool is_cached_property(bt_property_type_t type) {
+  switch (type) {
+    case BT_PROPERTY_BDNAME:
+    case BT_PROPERTY_REMOTE_FRIENDLY_NAME:
+    case BT_PROPERTY_CLASS_OF_DEVICE:
+    case BT_PROPERTY_TYPE_OF_DEVICE:
+    case BT_PROPERTY_UUIDS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/* Returns the cache entry of |bd_addr|, creating it if needed. The pointer is
+ * valid while remote_properties_mutex is held. */
+static btif_storage_cached_properties_t* get_cached_properties(
+    const RawAddress& bd_addr) {
+  btif_storage_cached_properties_t* cached =
+      remote_properties_cache.Find(bd_addr);
+  if (cached == nullptr) {
+    remote_properties_cache.Put(bd_addr, {});
+    cached = remote_properties_cache.Find(bd_addr);
+  }
+  return cached;
+}
+
+/* Stores the value of |prop| written to the config in the cache entry of
+ * |bd_addr|, trimmed as the config trims it. */
+static void cache_prop(const RawAddress& bd_addr, const bt_property_t* prop,
+                       const char* value) {
+  btif_storage_cached_properties_t* cached = get_cached_properties(bd_addr);
+  switch (prop->type) {
+    case BT_PROPERTY_BDNAME:
+    case BT_PROPERTY_REMOTE_FRIENDLY_NAME: {
+      std::string str(value);
+      str.erase(std::min(str.find('\n'), str.size()));
+      if (prop->type == BT_PROPERTY_BDNAME) {
+        cached->name = std::move(str);
+      } else {
+        cached->alias = std::move(str);
+      }
+    } break;
+    case BT_PROPERTY_CLASS_OF_DEVICE:
+      cached->dev_class = *(int*)prop->val;
+      break;
+    case BT_PROPERTY_TYPE_OF_DEVICE:
+      cached->dev_type = *(int*)prop->val;
+      break;
+    case BT_PROPERTY_UUIDS: {
+      size_t cnt = std::min((size_t)prop->len / sizeof(Uuid),
+                            (size_t)BT_MAX_NUM_UUIDS);
+      const Uuid* uuids = reinterpret_cast<const Uuid*>(prop->val);
+      cached->uuids.emplace(uuids, uuids + cnt);
+    } break;
+    default:
+      break;
+  }
+}
+
+/* Fills |prop| from the cache entry of |bd_addr|, reading the config on a
+ * miss. Returns false if the property is not stored. */
+static bool cached_cfg2prop(const RawAddress& bd_addr, bt_property_t* prop) {
+  std::string bdstr = bd_addr.ToString();
+  btif_storage_cached_properties_t* cached = get_cached_properties(bd_addr);
+  switch (prop->type) {
+    case BT_PROPERTY_BDNAME:
+    case BT_PROPERTY_REMOTE_FRIENDLY_NAME: {
+      bool is_name = prop->type == BT_PROPERTY_BDNAME;
+      std::optional<std::string>& str = is_name ? cached->name : cached->alias;
+      if (!str) {
+        char value[1024];
+        int size = sizeof(value);
+        if (!btif_config_get_str(
+                bdstr, is_name ? BTIF_STORAGE_KEY_NAME : BTIF_STORAGE_KEY_ALIAS,
+                value, &size)) {
+          prop->len = 0;
+          return false;
+        }
+        str = value;
+      }
+      size_t len = std::min(str->size(), (size_t)prop->len - 1);
+      memcpy(prop->val, str->data(), len);
+      ((char*)prop->val)[len] = '\0';
+      prop->len = len;
+      return true;
+    }
+    case BT_PROPERTY_CLASS_OF_DEVICE:
+    case BT_PROPERTY_TYPE_OF_DEVICE: {
+      if (prop->len < (int)sizeof(int)) return false;
+      bool is_class = prop->type == BT_PROPERTY_CLASS_OF_DEVICE;
+      std::optional<int>& val = is_class ? cached->dev_class : cached->dev_type;
+      if (!val) {
+        int value;
+        if (!btif_config_get_int(bdstr,
+                                 is_class ? BTIF_STORAGE_KEY_DEV_CLASS
+                                          : BTIF_STORAGE_KEY_DEV_TYPE,
+                                 &value)) {
+          return false;
+        }
+        val = value;
+      }
+      *(int*)prop->val = *val;
+      return true;
+    }
+    case BT_PROPERTY_UUIDS: {
+      if (!cached->uuids) {
+        char value[1280];
+        int size = sizeof(value);
+        if (!btif_config_get_str(bdstr, BTIF_STORAGE_KEY_REMOTE_SERVICE, value,
+                                 &size)) {
+          prop->val = NULL;
+          prop->len = 0;
+          return false;
+        }
+        Uuid uuids[BT_MAX_NUM_UUIDS];
+        size_t num_uuids =
+            btif_split_uuids_string(value, uuids, BT_MAX_NUM_UUIDS);
+        cached->uuids.emplace(uuids, uuids + num_uuids);
+      }
+      std::copy(cached->uuids->begin(), cached->uuids->end(),
+                reinterpret_cast<Uuid*>(prop->val));
+      prop->len = cached->uuids->size() * sizeof(Uuid);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
 static void btif_storage_set_mode(RawAddress* remote_bd_addr) {
   std::string bdstr = remote_bd_addr->ToString();
   if (GetInterfaceToProfiles()->config->isRestrictedMode()) {
@@ -134,6 +296,11 @@ static bool prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
         prop->type, prop->len);
     return false;
   }
+
+  std::unique_lock<std::mutex> lock(remote_properties_mutex, std::defer_lock);
+  if (remote_bd_addr && is_cached_property(prop->type)) {
+    lock.lock();
+  }
   switch (prop->type) {
     case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
       btif_config_set_int(bdstr, BTIF_STORAGE_KEY_TIMESTAMP, (int)time(NULL));
@@ -222,6 +389,9 @@ static bool prop2cfg(const RawAddress* remote_bd_addr, bt_property_t* prop) {
       return false;
   }
 
+  if (lock.owns_lock()) {
+    cache_prop(*remote_bd_addr, prop, value);
+  }
   return true;
 }
 
@@ -235,6 +405,10 @@ static bool cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
               prop->type, prop->len);
     return false;
   }
+  if (remote_bd_addr && is_cached_property(prop->type)) {
+    std::lock_guard<std::mutex> lock(remote_properties_mutex);
+    return cached_cfg2prop(*remote_bd_addr, prop);
+  }
   bool ret = false;
   switch (prop->type) {
     case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
@@ -440,12 +614,81 @@ bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr) {
   return BT_STATUS_SUCCESS;
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_in_fetch_bonded_ble_device_properties
+ *
+ * Description      Internal helper function to fetch the LE keys of a bonded
+ *                  device from its properties read with the other devices
+ *
+ * Returns          BT_STATUS_SUCCESS if a LE key was found, BT_STATUS_FAIL or
+ *                  BT_STATUS_DEVICE_NOT_FOUND otherwise
+ *
+ ******************************************************************************/
+static bt_status_t btif_in_fetch_bonded_ble_device_properties(
+    const bluetooth::shim::DeviceProperties& device, const RawAddress& bd_addr,
+    int add, btif_bonded_devices_t* p_bonded_devices) {
+  int device_type;
+  bool device_added = false;
+  bool key_found = false;
+
+  if (!device.GetInt(BTIF_STORAGE_KEY_DEV_TYPE, &device_type))
+    return BT_STATUS_FAIL;
+
+  if ((device_type & BT_DEVICE_TYPE_BLE) != BT_DEVICE_TYPE_BLE &&
+      !device.HasProperty(BTIF_STORAGE_KEY_LE_KEY_PENC))
+    return BT_STATUS_DEVICE_NOT_FOUND;
+
+  log::verbose("Found a LE device: {}", bd_addr);
+
+  int val;
+  tBLE_ADDR_TYPE addr_type = BLE_ADDR_PUBLIC;
+  if (device.GetInt(BTIF_STORAGE_KEY_ADDR_TYPE, &val)) {
+    addr_type = static_cast<tBLE_ADDR_TYPE>(val);
+  } else {
+    btif_storage_set_remote_addr_type(&bd_addr, BLE_ADDR_PUBLIC);
+  }
+
+  for (size_t i = 0; i < std::size(BTIF_STORAGE_LE_KEYS); i++) {
+    auto le_key = BTIF_STORAGE_LE_KEYS[i];
+    tBTA_LE_KEY_VALUE key;
+    memset(&key, 0, sizeof(key));
+    size_t length = le_key.size;
+    if (!device.GetBin(le_key.name, (uint8_t*)&key, &length)) continue;
+
+    if (add) {
+      if (!device_added) {
+        BTA_DmAddBleDevice(bd_addr, addr_type, BT_DEVICE_TYPE_BLE);
+        device_added = true;
+      }
+
+      log::verbose("Adding key type {} for {}", le_key.type, bd_addr);
+      BTA_DmAddBleKey(bd_addr, &key, le_key.type);
+    }
+    key_found = true;
+  }
+
+  // Fill in the bonded devices
+  if (device_added) {
+    if (p_bonded_devices->num_devices < BTM_SEC_MAX_DEVICE_RECORDS) {
+      p_bonded_devices->devices[p_bonded_devices->num_devices++] = bd_addr;
+    } else {
+      log::warn("Exceed the max number of bonded devices");
+    }
+    btif_gatts_add_bonded_dev_from_nv(bd_addr);
+  }
+
+  return key_found ? BT_STATUS_SUCCESS : BT_STATUS_DEVICE_NOT_FOUND;
+}
+
 /*******************************************************************************
  *
  * Function         btif_in_fetch_bonded_devices
  *
  * Description      Internal helper function to fetch the bonded devices
- *                  from NVRAM
+ *                  from NVRAM. The properties of all the devices are read in
+ *                  a single pass over the config, rather than one config
+ *                  lookup per key of each device.
  *
  * Returns          BT_STATUS_SUCCESS if successful, BT_STATUS_FAIL otherwise
  *
@@ -457,29 +700,27 @@ static bt_status_t btif_in_fetch_bonded_devices(
   bool bt_linkkey_file_found = false;
   int device_type;
 
-  for (const auto& bd_addr : btif_config_get_paired_devices()) {
-    auto name = bd_addr.ToString();
+  for (const auto& device : btif_config_get_paired_device_properties()) {
+    RawAddress bd_addr;
+    RawAddress::FromString(device.section, bd_addr);
 
     log::verbose("Remote device:{}", bd_addr);
     LinkKey link_key;
     size_t size = sizeof(link_key);
-    if (btif_config_get_bin(name, BTIF_STORAGE_KEY_LINK_KEY, link_key.data(),
-                            &size)) {
+    if (device.GetBin(BTIF_STORAGE_KEY_LINK_KEY, link_key.data(), &size)) {
       int linkkey_type;
-      if (btif_config_get_int(name, BTIF_STORAGE_KEY_LINK_KEY_TYPE,
-                              &linkkey_type)) {
+      if (device.GetInt(BTIF_STORAGE_KEY_LINK_KEY_TYPE, &linkkey_type)) {
         if (add) {
           DEV_CLASS dev_class = {0, 0, 0};
           int cod;
           int pin_length = 0;
-          if (btif_config_get_int(name, BTIF_STORAGE_KEY_DEV_CLASS, &cod))
+          if (device.GetInt(BTIF_STORAGE_KEY_DEV_CLASS, &cod))
             dev_class = uint2devclass((uint32_t)cod);
-          btif_config_get_int(name, BTIF_STORAGE_KEY_PIN_LENGTH, &pin_length);
+          device.GetInt(BTIF_STORAGE_KEY_PIN_LENGTH, &pin_length);
           BTA_DmAddDevice(bd_addr, dev_class, link_key, (uint8_t)linkkey_type,
                           pin_length);
 
-          if (btif_config_get_int(name, BTIF_STORAGE_KEY_DEV_TYPE,
-                                  &device_type) &&
+          if (device.GetInt(BTIF_STORAGE_KEY_DEV_TYPE, &device_type) &&
               (device_type == BT_DEVICE_TYPE_DUMO)) {
             btif_gatts_add_bonded_dev_from_nv(bd_addr);
           }
@@ -494,7 +735,8 @@ static bt_status_t btif_in_fetch_bonded_devices(
         bt_linkkey_file_found = false;
       }
     }
-    if (!btif_in_fetch_bonded_ble_device(name, add, p_bonded_devices) &&
+    if (!btif_in_fetch_bonded_ble_device_properties(device, bd_addr, add,
+                                                    p_bonded_devices) &&
         !bt_linkkey_file_found) {
       log::verbose("No link key or ble key found for device:{}", bd_addr);
     }
@@ -756,6 +998,28 @@ bt_status_t btif_storage_set_remote_device_property(
                                             : BT_STATUS_FAIL;
 }
 
+/*******************************************************************************
+ *
+ * Function         btif_storage_invalidate_remote_device_properties
+ *
+ * Description      BTIF storage API - Drops the cached properties of the
+ *                  remote device, or of all the remote devices when
+ *                  remote_bd_addr is NULL, after their config was changed
+ *                  without going through btif_storage
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btif_storage_invalidate_remote_device_properties(
+    const RawAddress* remote_bd_addr) {
+  std::lock_guard<std::mutex> lock(remote_properties_mutex);
+  if (remote_bd_addr) {
+    remote_properties_cache.Remove(*remote_bd_addr);
+  } else {
+    remote_properties_cache.Clear();
+  }
+}
+
 /*******************************************************************************
  *
  * Function         btif_storage_add_remote_device
@@ -842,6 +1106,7 @@ bt_status_t btif_storage_remove_bonded_device(
   log::info("Removing bonded device addr={}", *remote_bd_addr);
 
   btif_config_remove_device(bdstr);
+  btif_storage_invalidate_remote_device_properties(remote_bd_addr);
 
   /* Check the length of the paired devices, and if 0 then reset IRK */
   auto paired_devices = btif_config_get_paired_devices();
@@ -862,16 +1127,15 @@ bt_status_t btif_storage_remove_bonded_device(
  */
 static void remove_devices_with_sample_ltk() {
   std::vector<RawAddress> bad_ltk;
-  for (const auto& bd_addr : btif_config_get_paired_devices()) {
-    auto name = bd_addr.ToString();
-
+  for (const auto& device : btif_config_get_paired_device_properties()) {
     tBTA_LE_KEY_VALUE key;
     memset(&key, 0, sizeof(key));
 
-    if (btif_storage_get_ble_bonding_key(
-            bd_addr, BTM_LE_KEY_PENC, (uint8_t*)&key,
-            sizeof(tBTM_LE_PENC_KEYS)) == BT_STATUS_SUCCESS) {
+    size_t length = sizeof(tBTM_LE_PENC_KEYS);
+    if (device.GetBin(BTIF_STORAGE_KEY_LE_KEY_PENC, (uint8_t*)&key, &length)) {
       if (is_sample_ltk(key.penc_key.ltk)) {
+        RawAddress bd_addr;
+        RawAddress::FromString(device.section, bd_addr);
         bad_ltk.push_back(bd_addr);
       }
     }
@@ -35,6 +35,7 @@
 #include "core_callbacks.h"
 #include "main/shim/shim.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack/include/main_thread.h"
@@ -236,6 +237,12 @@ static void init_stack_internal(bluetooth::core::CoreInterface* interface) {
 
   module_management_start();
 
+  uint32_t slow_task_threshold_ms = bluetooth::os::GetSystemPropertyUint32(
+      bluetooth::common::TaskStats::kSlowTaskThresholdProperty, 0);
+  if (slow_task_threshold_ms != 0) {
+    get_main_thread()->EnableTaskStats(
+        std::chrono::milliseconds(slow_task_threshold_ms));
+  }
   main_thread_start_up();
 
   module_init(get_local_module(DEVICE_IOT_CONFIG_MODULE));
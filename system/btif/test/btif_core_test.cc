@@ -1031,6 +1031,7 @@ TEST_F(BtifCoreVseWithSocketTest, debug_dump_empty) {
 
 namespace bluetooth::bqr::testing {
 void set_lmp_trace_log_fd(int fd);
+void flush_trace_log();
 }
 
 TEST_F(BtifCoreVseWithSocketTest, send_lmp_ll_msg) {
@@ -1055,6 +1056,7 @@ TEST_F(BtifCoreVseWithSocketTest, send_lmp_ll_msg) {
                         [](std::unique_ptr<std::promise<void>> done_promise) {
                           char line_buf[1024] = "";
                           std::string line;
+                          bluetooth::bqr::testing::flush_trace_log();
                           int bytes_read = read(read_fd, line_buf, 1024);
                           EXPECT_GT(bytes_read, 0);
                           line = std::string(line_buf);
@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include <cstddef>
 #include <mutex>
 #include <string>
 
+#include "common/lru.h"
 #include "hci/octets.h"
 #include "raw_address.h"
 
@@ -31,6 +33,15 @@ class AddressObfuscator {
  public:
   static constexpr unsigned int kOctet32Length = hci::kOctet32Length;
   using Octet32 = hci::Octet32;
+  // Number of obfuscated addresses kept, enough for the devices a metric is
+  // usually logged for at a time
+  static constexpr size_t kCacheCapacity = 64;
+
+  struct CacheStats {
+    size_t hits;
+    size_t misses;
+  };
+
   static AddressObfuscator* GetInstance() {
     static auto instance = new AddressObfuscator();
     return instance;
@@ -49,6 +60,9 @@ class AddressObfuscator {
   /**
    * Initialize this obfuscator with necessary parameters
    *
+   * Clears the obfuscated addresses cached for the previous salt if it
+   * differs from the new one
+   *
    * @param salt_256bit a 256 bit salt used to hash the fixed length address
    */
   void Initialize(const Octet32& salt_256bit);
@@ -62,13 +76,25 @@ class AddressObfuscator {
    * Obfuscate Bluetooth MAC address into an anonymous ID string
    *
    * @param address Bluetooth MAC address to be obfuscated
+   * The last kCacheCapacity obfuscated addresses are cached, as metrics for
+   * the same devices are logged over and over
+   *
    * @return the obfuscated MAC address in 256 bit
    */
   std::string Obfuscate(const RawAddress& address);
 
+  /**
+   * Return the number of Obfuscate() calls served from the cache, and of
+   * those which had to hash the address, since this obfuscator was created
+   */
+  CacheStats GetCacheStats();
+
  private:
-  AddressObfuscator() : salt_256bit_({0}) {}
+  AddressObfuscator()
+      : salt_256bit_({0}), cache_(kCacheCapacity, "AddressObfuscator") {}
   Octet32 salt_256bit_;
+  LegacyLruCache<RawAddress, std::string> cache_;
+  CacheStats cache_stats_ = {};
   std::recursive_mutex instance_mutex_;
 };
 
@@ -120,3 +120,31 @@ TEST(AddressObfuscatorTest, test_obfuscate_address_key2_max_address) {
   EXPECT_EQ(result.size(), AddressObfuscator::kOctet32Length);
   EXPECT_EQ(result, kTestResult2_3);
 }
+
+TEST(AddressObfuscatorTest, test_obfuscate_address_cached) {
+  AddressObfuscator::GetInstance()->Initialize(kTestKey1);
+  AddressObfuscator::CacheStats before =
+      AddressObfuscator::GetInstance()->GetCacheStats();
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            kTestResult1);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            kTestResult1);
+  AddressObfuscator::CacheStats after =
+      AddressObfuscator::GetInstance()->GetCacheStats();
+  EXPECT_EQ(after.hits + after.misses, before.hits + before.misses + 2);
+  EXPECT_GE(after.hits, before.hits + 1);
+}
+
+TEST(AddressObfuscatorTest, test_obfuscate_address_salt_change) {
+  AddressObfuscator::GetInstance()->Initialize(kTestKey1);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_1),
+            AddressObfuscator::GetInstance()->Obfuscate(kTestData2_1));
+  AddressObfuscator::GetInstance()->Initialize(kTestKey2);
+  AddressObfuscator::CacheStats before =
+      AddressObfuscator::GetInstance()->GetCacheStats();
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_1),
+            kTestResult2_1);
+  AddressObfuscator::CacheStats after =
+      AddressObfuscator::GetInstance()->GetCacheStats();
+  EXPECT_EQ(after.misses, before.misses + 1);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compares LeakyBondedQueue and LeakyRingQueue, when the items are enqueued
+// then dequeued by |state.range(0)|, and when the queue overflows so that
+// each item enqueued leaks the oldest one.
+
+#include <benchmark/benchmark.h>
+
+#include "common/leaky_bonded_queue.h"
+#include "common/leaky_ring_queue.h"
+
+using ::benchmark::State;
+using bluetooth::common::LeakyBondedQueue;
+using bluetooth::common::LeakyRingQueue;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 64;
+
+struct Item {
+  int value;
+};
+
+template <class Queue>
+void BM_EnqueueDequeue(State& state) {
+  Queue queue(kQueueCapacity);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+      queue.Enqueue(new Item{static_cast<int>(i)});
+    }
+    for (int64_t i = 0; i < state.range(0); i++) {
+      Item* item = queue.Dequeue();
+      benchmark::DoNotOptimize(item);
+      delete item;
+    }
+  }
+}
+
+template <class Queue>
+void BM_EnqueueOverflow(State& state) {
+  Queue queue(kQueueCapacity);
+  for (size_t i = 0; i < kQueueCapacity; i++) {
+    queue.Enqueue(new Item{0});
+  }
+  for (auto _ : state) {
+    Item* item = queue.EnqueueWithPop(new Item{1});
+    benchmark::DoNotOptimize(item);
+    delete item;
+  }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_EnqueueDequeue, LeakyBondedQueue<Item>)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32);
+BENCHMARK_TEMPLATE(BM_EnqueueDequeue, LeakyRingQueue<Item>)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32);
+BENCHMARK_TEMPLATE(BM_EnqueueOverflow, LeakyBondedQueue<Item>);
+BENCHMARK_TEMPLATE(BM_EnqueueOverflow, LeakyRingQueue<Item>);
@@ -0,0 +1,196 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#pragma once
+
+#include <bluetooth/log.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace bluetooth {
+
+namespace common {
+
+/*
+ *   LeakyRingQueue<T>
+ *
+ * - LeakyRingQueue<T> is a lock-free alternative to LeakyBondedQueue<T>,
+ *   with the same semantics: a fixed size queue that leaks its oldest item
+ *   when reaching its capacity, and owns the items it holds.
+ * - The items are kept in a ring of |capacity| slots allocated once, so that
+ *   neither Enqueue() nor Dequeue() allocate or take a lock.
+ * - Enqueue() and EnqueueWithPop() must be called from a single producer
+ *   thread. Dequeue() and Clear() are consumer calls: each item is claimed
+ *   atomically by either the consumer or the producer leaking it, so the
+ *   consumer calls are safe against the producer, and against each other.
+ * - Length() and Empty() are a snapshot, which may be stale by the time they
+ *   return when the queue is used concurrently.
+ *
+ */
+template <class T>
+class LeakyRingQueue {
+ public:
+  LeakyRingQueue(size_t capacity);
+  /* Default destructor
+   *
+   * Call Clear() and free the queue structure itself
+   */
+  ~LeakyRingQueue();
+  /*
+   * Add item NEW_ITEM to the queue. If the queue is full, free the oldest
+   * item
+   */
+  void Enqueue(T* new_item);
+  /*
+   * Add item NEW_ITEM to the queue. If the queue is full, dequeue the oldest
+   * item and returns it to the caller. Return nullptr otherwise.
+   */
+  T* EnqueueWithPop(T* new_item);
+  /*
+   * Dequeues the oldest item from the queue. Return nullptr if queue is empty
+   */
+  T* Dequeue();
+  /*
+   * Returns the length of queue
+   */
+  size_t Length() const;
+  /*
+   * Returns the defined capacity of the queue
+   */
+  size_t Capacity() const;
+  /*
+   * Returns whether the queue is empty
+   */
+  bool Empty() const;
+  /*
+   * Frees all items of the queue
+   */
+  void Clear();
+  /*
+   * Returns the number of items leaked because the queue was full
+   */
+  uint64_t GetDroppedCount() const;
+
+ private:
+  // Claim the item at |head| if it is still the oldest item, and return
+  // whether it was claimed
+  bool Claim(uint64_t head, T** item);
+
+  const size_t capacity_;
+  std::unique_ptr<std::atomic<T*>[]> slots_;
+  // Positions of the oldest item and of the next item to enqueue, which only
+  // increase so that they never wrap around in practice. Kept on separate
+  // cache lines as they are written by different threads.
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+/*
+ * Definitions must be in the header for template classes
+ */
+
+template <class T>
+LeakyRingQueue<T>::LeakyRingQueue(size_t capacity)
+    : capacity_(capacity), slots_(new std::atomic<T*>[capacity]) {
+  log::assert_that(capacity > 0, "assert failed: capacity > 0");
+}
+
+template <class T>
+LeakyRingQueue<T>::~LeakyRingQueue() {
+  Clear();
+}
+
+template <class T>
+bool LeakyRingQueue<T>::Claim(uint64_t head, T** item) {
+  // The slot is read before the head is advanced: once advanced, the slot
+  // may be reused by the producer
+  *item = slots_[head % capacity_].load(std::memory_order_relaxed);
+  return head_.compare_exchange_strong(head, head + 1,
+                                       std::memory_order_acq_rel);
+}
+
+template <class T>
+void LeakyRingQueue<T>::Enqueue(T* new_item) {
+  delete EnqueueWithPop(new_item);
+}
+
+template <class T>
+T* LeakyRingQueue<T>::EnqueueWithPop(T* new_item) {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  T* old_item = nullptr;
+  while (true) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (tail - head < capacity_) break;
+    // Full, leak the oldest item unless the consumer just dequeued it
+    if (Claim(head, &old_item)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+    old_item = nullptr;
+  }
+  slots_[tail % capacity_].store(new_item, std::memory_order_relaxed);
+  tail_.store(tail + 1, std::memory_order_release);
+  return old_item;
+}
+
+template <class T>
+T* LeakyRingQueue<T>::Dequeue() {
+  T* item = nullptr;
+  while (true) {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == tail_.load(std::memory_order_acquire)) return nullptr;
+    if (Claim(head, &item)) return item;
+  }
+}
+
+template <class T>
+void LeakyRingQueue<T>::Clear() {
+  while (!Empty()) {
+    delete Dequeue();
+  }
+}
+
+template <class T>
+size_t LeakyRingQueue<T>::Length() const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t tail = tail_.load(std::memory_order_acquire);
+  // The head may be read before the producer leaks an item and advances the
+  // tail past a full queue
+  return tail - head > capacity_ ? capacity_ : tail - head;
+}
+
+template <class T>
+size_t LeakyRingQueue<T>::Capacity() const {
+  return capacity_;
+}
+
+template <class T>
+bool LeakyRingQueue<T>::Empty() const {
+  return Length() == 0;
+}
+
+template <class T>
+uint64_t LeakyRingQueue<T>::GetDroppedCount() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+}  // namespace common
+
+}  // namespace bluetooth
@@ -0,0 +1,166 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "common/leaky_ring_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace testing {
+
+using bluetooth::common::LeakyRingQueue;
+
+#define ITEM_EQ(a, b)                  \
+  do {                                 \
+    EXPECT_EQ(a, b);                   \
+    EXPECT_EQ((a)->index, (b)->index); \
+  } while (0)
+
+class Item {
+ public:
+  Item(int i) { index = i; }
+  virtual ~Item() {}
+  int index;
+};
+
+class MockItem : public Item {
+ public:
+  MockItem(int i) : Item(i) {}
+  ~MockItem() override { Destruct(); }
+  MOCK_METHOD0(Destruct, void());
+};
+
+TEST(LeakyRingQueueTest, TestEnqueueDequeue) {
+  MockItem* item1 = new MockItem(1);
+  MockItem* item2 = new MockItem(2);
+  MockItem* item3 = new MockItem(3);
+  MockItem* item4 = new MockItem(4);
+  LeakyRingQueue<MockItem>* queue = new LeakyRingQueue<MockItem>(3);
+  EXPECT_EQ(queue->Capacity(), static_cast<size_t>(3));
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(0));
+  EXPECT_THAT(queue->Dequeue(), IsNull());
+  queue->Enqueue(item1);
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(1));
+  queue->Enqueue(item2);
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(2));
+  queue->Enqueue(item3);
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(3));
+  EXPECT_CALL(*item1, Destruct()).Times(1);
+  queue->Enqueue(item4);
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(3));
+  EXPECT_EQ(queue->GetDroppedCount(), static_cast<uint64_t>(1));
+  MockItem* item2_2 = queue->Dequeue();
+  MockItem* item3_3 = queue->Dequeue();
+  MockItem* item4_4 = queue->Dequeue();
+  EXPECT_THAT(item2_2, NotNull());
+  ITEM_EQ(item2_2, item2);
+  EXPECT_THAT(item3_3, NotNull());
+  ITEM_EQ(item3_3, item3);
+  EXPECT_THAT(item4_4, NotNull());
+  ITEM_EQ(item4_4, item4);
+  EXPECT_TRUE(queue->Empty());
+  EXPECT_CALL(*item2_2, Destruct()).Times(1);
+  delete item2_2;
+  EXPECT_CALL(*item3_3, Destruct()).Times(1);
+  delete item3_3;
+  EXPECT_CALL(*item4_4, Destruct()).Times(1);
+  delete item4_4;
+  delete queue;
+}
+
+TEST(LeakyRingQueueTest, TestEnqueuePop) {
+  MockItem* item1 = new MockItem(1);
+  MockItem* item2 = new MockItem(2);
+  MockItem* item3 = new MockItem(3);
+  LeakyRingQueue<MockItem>* queue = new LeakyRingQueue<MockItem>(2);
+  EXPECT_THAT(queue->EnqueueWithPop(item1), IsNull());
+  EXPECT_THAT(queue->EnqueueWithPop(item2), IsNull());
+  MockItem* item1_1 = queue->EnqueueWithPop(item3);
+  EXPECT_THAT(item1_1, NotNull());
+  ITEM_EQ(item1_1, item1);
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(2));
+  EXPECT_EQ(queue->GetDroppedCount(), static_cast<uint64_t>(1));
+  EXPECT_CALL(*item1, Destruct()).Times(1);
+  delete item1_1;
+  MockItem* item2_2 = queue->Dequeue();
+  ITEM_EQ(item2_2, item2);
+  EXPECT_CALL(*item2, Destruct()).Times(1);
+  delete item2_2;
+  EXPECT_CALL(*item3, Destruct()).Times(1);
+  delete queue;
+}
+
+TEST(LeakyRingQueueTest, TestQueueClear) {
+  MockItem* item1 = new MockItem(1);
+  MockItem* item2 = new MockItem(2);
+  MockItem* item3 = new MockItem(3);
+  LeakyRingQueue<MockItem>* queue = new LeakyRingQueue<MockItem>(2);
+  queue->Enqueue(item1);
+  queue->Enqueue(item2);
+  EXPECT_CALL(*item1, Destruct()).Times(1);
+  queue->Enqueue(item3);
+  EXPECT_CALL(*item2, Destruct()).Times(1);
+  EXPECT_CALL(*item3, Destruct()).Times(1);
+  queue->Clear();
+  EXPECT_TRUE(queue->Empty());
+  delete queue;
+}
+
+TEST(LeakyRingQueueTest, TestPushNullOverflowQueue) {
+  LeakyRingQueue<MockItem>* queue = new LeakyRingQueue<MockItem>(1);
+  queue->Enqueue(nullptr);
+  queue->Enqueue(nullptr);
+  EXPECT_EQ(queue->Length(), static_cast<size_t>(1));
+  EXPECT_THAT(queue->Dequeue(), IsNull());
+  EXPECT_TRUE(queue->Empty());
+  delete queue;
+}
+
+TEST(LeakyRingQueueTest, TestConcurrentProducerConsumer) {
+  constexpr int kItems = 100000;
+  LeakyRingQueue<Item> queue(16);
+
+  std::thread producer([&queue]() {
+    for (int i = 0; i < kItems; i++) {
+      queue.Enqueue(new Item(i));
+    }
+  });
+
+  // Every item is either dequeued, in order, or dropped
+  int dequeued = 0;
+  int last_index = -1;
+  while (true) {
+    Item* item = queue.Dequeue();
+    if (item == nullptr) {
+      if (last_index == kItems - 1) break;
+      std::this_thread::yield();
+      continue;
+    }
+    EXPECT_GT(item->index, last_index);
+    last_index = item->index;
+    dequeued++;
+    delete item;
+  }
+  producer.join();
+
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(static_cast<uint64_t>(kItems - dequeued), queue.GetDroppedCount());
+}
+
+}  // namespace testing
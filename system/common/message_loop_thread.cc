@@ -36,6 +36,22 @@ namespace common {
 
 static constexpr int kRealTimeFifoSchedulingPriority = 1;
 
+// Runs |task| and records its statistics. |scheduled_time| is when the task
+// was due to run, so that its delay does not count as queue latency.
+static void RunWithTaskStats(TaskStats* task_stats, TaskStats::Location location,
+                             std::chrono::steady_clock::time_point scheduled_time,
+                             base::OnceClosure task) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::move(task).Run();
+  auto end_time = std::chrono::steady_clock::now();
+  task_stats->Record(
+      location,
+      std::chrono::duration_cast<std::chrono::microseconds>(start_time -
+                                                            scheduled_time),
+      std::chrono::duration_cast<std::chrono::microseconds>(end_time -
+                                                            start_time));
+}
+
 static base::TimeDelta timeDeltaFromMicroseconds(std::chrono::microseconds t) {
 #if BASE_VER < 931007
   return base::TimeDelta::FromMicroseconds(t.count());
@@ -88,6 +104,13 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                from_here.ToString());
     return false;
   }
+  if (task_stats_ != nullptr) {
+    task = base::BindOnce(
+        &RunWithTaskStats, base::Unretained(task_stats_.get()),
+        TaskStats::Location{from_here.function_name(), from_here.file_name(),
+                            from_here.line_number()},
+        std::chrono::steady_clock::now() + delay, std::move(task));
+  }
   if (!message_loop_->task_runner()->PostDelayedTask(
           from_here, std::move(task), timeDeltaFromMicroseconds(delay))) {
     log::error("failed to post task to message loop for thread {}, from {}",
@@ -132,6 +155,11 @@ base::PlatformThreadId MessageLoopThread::GetThreadId() const {
   return thread_id_;
 }
 
+pid_t MessageLoopThread::GetLinuxTid() const {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  return linux_tid_;
+}
+
 std::string MessageLoopThread::GetName() const { return thread_name_; }
 
 std::string MessageLoopThread::ToString() const {
@@ -177,6 +205,23 @@ bool MessageLoopThread::EnableRealTimeScheduling() {
   return true;
 }
 
+void MessageLoopThread::EnableTaskStats(
+    std::chrono::milliseconds slow_task_threshold) {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  if (task_stats_ != nullptr) {
+    log::warn("task statistics of thread {} are already enabled", *this);
+    return;
+  }
+  task_stats_ = std::make_unique<TaskStats>(thread_name_, slow_task_threshold);
+}
+
+void MessageLoopThread::DumpTaskStats(int fd) const {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  if (task_stats_ != nullptr) {
+    task_stats_->Dump(fd);
+  }
+}
+
 base::WeakPtr<MessageLoopThread> MessageLoopThread::GetWeakPtr() {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return weak_ptr_factory_.GetWeakPtr();
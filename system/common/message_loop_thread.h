@@ -23,12 +23,15 @@
 #include <bluetooth/log.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <future>
+#include <memory>
 #include <string>
 #include <thread>
 
 #include "abstract_message_loop.h"
 #include "common/postable_context.h"
+#include "common/task_stats.h"
 
 namespace bluetooth {
 
@@ -97,6 +100,14 @@ class MessageLoopThread final : public PostableContext {
    */
   base::PlatformThreadId GetThreadId() const;
 
+  /**
+   * Get the Linux thread ID of this thread, as returned by gettid(), to
+   * change its scheduling from another thread
+   *
+   * @return this thread's Linux thread ID, -1 if it is not running
+   */
+  pid_t GetLinuxTid() const;
+
   /**
    * Get this thread's name set in constructor
    *
@@ -125,6 +136,23 @@ class MessageLoopThread final : public PostableContext {
    */
   bool EnableRealTimeScheduling();
 
+  /**
+   * Start collecting the queue latency and run duration of the tasks posted
+   * from now on, logging the ones running for |slow_task_threshold| or more.
+   * The statistics are kept for the lifetime of this object, repeated calls
+   * are ignored.
+   *
+   * @param slow_task_threshold run duration from which a task is logged
+   */
+  void EnableTaskStats(std::chrono::milliseconds slow_task_threshold);
+
+  /**
+   * Dump the task statistics of this thread, if enabled
+   *
+   * @param fd file descriptor to write to
+   */
+  void DumpTaskStats(int fd) const;
+
   /**
    * Return the weak pointer to this object. This can be useful when posting
    * delayed tasks to this MessageLoopThread using Timer.
@@ -209,6 +237,7 @@ class MessageLoopThread final : public PostableContext {
   pid_t linux_tid_;
   base::WeakPtrFactory<MessageLoopThread> weak_ptr_factory_;
   bool shutting_down_;
+  std::unique_ptr<TaskStats> task_stats_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "worker_pool.h"
+
+#include <base/threading/platform_thread.h>
+#include <bluetooth/log.h>
+
+#include <string>
+#include <utility>
+
+namespace bluetooth {
+namespace common {
+
+WorkerPool::WorkerPool(const std::string& name, size_t num_threads)
+    : name_(name), num_threads_(num_threads) {}
+
+WorkerPool::~WorkerPool() { ShutDown(); }
+
+void WorkerPool::StartUp() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!threads_.empty()) {
+    log::warn("worker pool {} is already started", name_);
+    return;
+  }
+  shutting_down_ = false;
+  for (size_t i = 0; i < num_threads_; i++) {
+    threads_.emplace_back(&WorkerPool::Run, this, i);
+  }
+}
+
+void WorkerPool::ShutDown() {
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threads_.empty()) {
+      log::info("worker pool {} is already stopped", name_);
+      return;
+    }
+    for (const auto& thread : threads_) {
+      log::assert_that(thread.get_id() != std::this_thread::get_id(),
+                       "should not be called from a worker thread. "
+                       "Otherwise, deadlock may happen.");
+    }
+    shutting_down_ = true;
+    threads.swap(threads_);
+  }
+  task_available_.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+bool WorkerPool::IsRunning() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !threads_.empty();
+}
+
+bool WorkerPool::DoInWorker(const base::Location& from_here,
+                            base::OnceClosure task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threads_.empty()) {
+      log::error("worker pool {} is not running, from {}", name_,
+                 from_here.ToString());
+      return false;
+    }
+    tasks_.push_back(std::move(task));
+  }
+  task_available_.notify_one();
+  return true;
+}
+
+void WorkerPool::Run(size_t index) {
+  base::PlatformThread::SetName(name_ + "_" + std::to_string(index));
+  while (true) {
+    base::OnceClosure task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_available_.wait(lock,
+                           [this] { return shutting_down_ || !tasks_.empty(); });
+      // The pending tasks are run before the pool stops
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    std::move(task).Run();
+  }
+}
+
+}  // namespace common
+}  // namespace bluetooth
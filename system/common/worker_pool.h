@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <base/functional/callback.h>
+#include <base/location.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bluetooth {
+
+namespace common {
+
+/**
+ * A pool of worker threads sharing a queue of tasks. Tasks are run by the
+ * first available worker, with no ordering between them: only post work which
+ * does not depend on other tasks, and does not access state owned by another
+ * thread.
+ */
+class WorkerPool final {
+ public:
+  /**
+   * Create a worker pool. Threads won't be running until StartUp is called.
+   *
+   * @param name name of the pool, its threads are named <name>_<index>
+   * @param num_threads number of worker threads
+   */
+  WorkerPool(const std::string& name, size_t num_threads);
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * Shuts the pool down automatically when it goes out of scope
+   */
+  ~WorkerPool();
+
+  /**
+   * Start the worker threads. Repeated calls only start them once.
+   */
+  void StartUp();
+
+  /**
+   * Run the pending tasks, then stop the worker threads. Blocks until they
+   * are joined. The pool can be started again using StartUp().
+   *
+   * NOTE: Should never be called from a worker thread
+   */
+  void ShutDown();
+
+  /**
+   * Check if the worker threads are running
+   *
+   * @return true iff tasks can be posted to this pool
+   */
+  bool IsRunning() const;
+
+  /**
+   * Post a task to run on one of the worker threads
+   *
+   * @param from_here location where this task is originated
+   * @param task task created through base::Bind()
+   * @return true if task is successfully scheduled, false if the pool is not
+   * running
+   */
+  bool DoInWorker(const base::Location& from_here, base::OnceClosure task);
+
+ private:
+  void Run(size_t index);
+
+  const std::string name_;
+  const size_t num_threads_;
+  mutable std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::deque<base::OnceClosure> tasks_;
+  std::vector<std::thread> threads_;
+  bool shutting_down_ = false;
+};
+
+}  // namespace common
+
+}  // namespace bluetooth
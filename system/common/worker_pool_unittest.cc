@@ -0,0 +1,117 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "worker_pool.h"
+
+#include <base/functional/bind.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+using bluetooth::common::WorkerPool;
+
+TEST(WorkerPoolTest, not_running_before_start_up) {
+  WorkerPool pool("test_pool", 2);
+  ASSERT_FALSE(pool.IsRunning());
+  ASSERT_FALSE(pool.DoInWorker(FROM_HERE, base::BindOnce([] {})));
+}
+
+TEST(WorkerPoolTest, runs_tasks_off_the_calling_thread) {
+  WorkerPool pool("test_pool", 2);
+  pool.StartUp();
+  ASSERT_TRUE(pool.IsRunning());
+
+  std::promise<std::thread::id> thread_id_promise;
+  auto thread_id_future = thread_id_promise.get_future();
+  ASSERT_TRUE(pool.DoInWorker(
+      FROM_HERE, base::BindOnce(
+                     [](std::promise<std::thread::id> promise) {
+                       promise.set_value(std::this_thread::get_id());
+                     },
+                     std::move(thread_id_promise))));
+  ASSERT_NE(std::this_thread::get_id(), thread_id_future.get());
+}
+
+TEST(WorkerPoolTest, runs_tasks_concurrently) {
+  WorkerPool pool("test_pool", 2);
+  pool.StartUp();
+
+  // Each task waits for the other one, which only completes if both run at
+  // the same time
+  std::promise<void> first_started;
+  std::promise<void> second_started;
+  auto first_future = first_started.get_future().share();
+  auto second_future = second_started.get_future().share();
+  std::promise<void> first_done;
+  std::promise<void> second_done;
+  auto first_done_future = first_done.get_future();
+  auto second_done_future = second_done.get_future();
+  auto task = [](std::promise<void> started,
+                 std::shared_future<void> other_started,
+                 std::promise<void> done) {
+    started.set_value();
+    other_started.wait();
+    done.set_value();
+  };
+  pool.DoInWorker(FROM_HERE,
+                  base::BindOnce(task, std::move(first_started), second_future,
+                                 std::move(first_done)));
+  pool.DoInWorker(FROM_HERE,
+                  base::BindOnce(task, std::move(second_started), first_future,
+                                 std::move(second_done)));
+  ASSERT_EQ(std::future_status::ready,
+            first_done_future.wait_for(std::chrono::seconds(5)));
+  ASSERT_EQ(std::future_status::ready,
+            second_done_future.wait_for(std::chrono::seconds(5)));
+}
+
+TEST(WorkerPoolTest, shut_down_runs_pending_tasks) {
+  WorkerPool pool("test_pool", 1);
+  pool.StartUp();
+
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 100; i++) {
+    pool.DoInWorker(FROM_HERE, base::BindOnce(
+                                   [](std::atomic<int>* counter) {
+                                     std::this_thread::sleep_for(
+                                         std::chrono::microseconds(100));
+                                     (*counter)++;
+                                   },
+                                   &counter));
+  }
+  pool.ShutDown();
+  ASSERT_FALSE(pool.IsRunning());
+  ASSERT_EQ(100, counter.load());
+  ASSERT_FALSE(pool.DoInWorker(FROM_HERE, base::BindOnce([] {})));
+}
+
+TEST(WorkerPoolTest, restart) {
+  WorkerPool pool("test_pool", 2);
+  pool.StartUp();
+  pool.ShutDown();
+  pool.StartUp();
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  ASSERT_TRUE(pool.DoInWorker(
+      FROM_HERE, base::BindOnce([](std::promise<void> promise) { promise.set_value(); },
+                                std::move(promise))));
+  ASSERT_EQ(std::future_status::ready,
+            future.wait_for(std::chrono::seconds(5)));
+}
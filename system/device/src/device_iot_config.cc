@@ -47,6 +47,18 @@ std::mutex config_lock;  // protects operations on |config|.
 std::unique_ptr<config_t> config;
 alarm_t* config_timer;
 
+// The following are protected by |config_lock|.
+// Set when |config| has changes that are not saved to the file yet.
+bool device_iot_config_dirty = false;
+// Time by which the pending changes must be saved, 0 when none is pending.
+uint64_t device_iot_config_save_deadline_ms = 0;
+// Number of changes that were saved along with an earlier pending change.
+uint64_t device_iot_config_coalesced_changes = 0;
+// Saves and bytes written to the file since the start of the current period.
+uint64_t device_iot_config_period_start_ms = 0;
+uint64_t device_iot_config_period_saves = 0;
+uint64_t device_iot_config_period_bytes_written = 0;
+
 using namespace bluetooth;
 
 bool device_iot_config_has_section(const std::string& section) {
@@ -322,7 +334,10 @@ bool device_iot_config_remove(const std::string& section,
   log::assert_that(config != NULL, "assert failed: config != NULL");
 
   std::unique_lock<std::mutex> lock(config_lock);
-  return config_remove_key(config.get(), section, key);
+  if (!config_remove_key(config.get(), section, key)) return false;
+
+  device_iot_config_dirty = true;
+  return true;
 }
 
 void device_iot_config_flush(void) {
@@ -357,6 +372,8 @@ bool device_iot_config_clear(void) {
 
   bool ret = config_save(*config, IOT_CONFIG_FILE_PATH);
   device_iot_config_source = RESET;
+  device_iot_config_dirty = false;
+  device_iot_config_save_deadline_ms = 0;
   return ret;
 }
 
@@ -386,4 +403,13 @@ void device_debug_iot_config_dump(int fd) {
 
   dprintf(fd, "  Devices loaded: %d\n", device_iot_config_devices_loaded);
   dprintf(fd, "  File created/tagged: %s\n", device_iot_config_time_created);
+
+  std::unique_lock<std::mutex> lock(config_lock);
+  dprintf(fd, "  Save pending: %s\n",
+          device_iot_config_dirty ? "true" : "false");
+  dprintf(fd, "  Changes coalesced into a save: %llu\n",
+          (unsigned long long)device_iot_config_coalesced_changes);
+  dprintf(fd, "  Saves in the current day: %llu, bytes written: %llu\n",
+          (unsigned long long)device_iot_config_period_saves,
+          (unsigned long long)device_iot_config_period_bytes_written);
 }
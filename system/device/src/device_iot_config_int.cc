@@ -23,9 +23,11 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <mutex>
 #include <string>
 
@@ -48,8 +50,46 @@ extern std::mutex config_lock;  // protects operations on |config|.
 extern std::unique_ptr<config_t> config;
 extern alarm_t* config_timer;
 
+extern bool device_iot_config_dirty;
+extern uint64_t device_iot_config_save_deadline_ms;
+extern uint64_t device_iot_config_coalesced_changes;
+extern uint64_t device_iot_config_period_start_ms;
+extern uint64_t device_iot_config_period_saves;
+extern uint64_t device_iot_config_period_bytes_written;
+
 using namespace bluetooth;
 
+static uint64_t device_iot_config_now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Account a save of the config file, and log the bytes written over the
+// previous period once it ends.
+static void device_iot_config_record_save() {
+  struct stat file_stat {};
+  uint64_t bytes_written = 0;
+  if (stat(IOT_CONFIG_FILE_PATH, &file_stat) == 0) {
+    bytes_written = file_stat.st_size;
+  }
+
+  uint64_t now_ms = device_iot_config_now_ms();
+  if (now_ms - device_iot_config_period_start_ms >=
+      CONFIG_WRITE_STATS_PERIOD_MS) {
+    if (device_iot_config_period_saves > 0) {
+      log::info("Saved {} times, {} bytes written over the last day",
+                device_iot_config_period_saves,
+                device_iot_config_period_bytes_written);
+    }
+    device_iot_config_period_start_ms = now_ms;
+    device_iot_config_period_saves = 0;
+    device_iot_config_period_bytes_written = 0;
+  }
+  device_iot_config_period_saves++;
+  device_iot_config_period_bytes_written += bytes_written;
+}
+
 static void cleanup() {
   alarm_free(config_timer);
   config_timer = NULL;
@@ -73,6 +113,7 @@ future_t* device_iot_config_module_init(void) {
 
   config = config_new(IOT_CONFIG_FILE_PATH);
   device_iot_config_source = ORIGINAL;
+  device_iot_config_save_deadline_ms = 0;
   if (!config) {
     log::warn("Unable to load config file: {}; using backup.",
               IOT_CONFIG_FILE_PATH);
@@ -92,6 +133,9 @@ future_t* device_iot_config_module_init(void) {
     return future_new_immediate(FUTURE_FAIL);
   }
 
+  // A config not read from the original file is saved on the next flush.
+  device_iot_config_dirty = device_iot_config_source != ORIGINAL;
+
   int version;
   if (device_iot_config_source == NEW_FILE) {
     version = DEVICE_IOT_INFO_CURRENT_VERSION;
@@ -101,6 +145,7 @@ future_t* device_iot_config_module_init(void) {
     if (version == -1) {
       version = DEVICE_IOT_INFO_FIRST_VERSION;
       config_set_int(config.get(), INFO_SECTION, VERSION_KEY, version);
+      device_iot_config_dirty = true;
     }
   }
 
@@ -119,6 +164,7 @@ future_t* device_iot_config_module_init(void) {
     config_set_int(config.get(), INFO_SECTION, VERSION_KEY,
                    DEVICE_IOT_INFO_CURRENT_VERSION);
     device_iot_config_source = NEW_FILE;
+    device_iot_config_dirty = true;
   }
 
   device_iot_config_devices_loaded = device_iot_config_get_device_num(*config);
@@ -139,6 +185,7 @@ future_t* device_iot_config_module_init(void) {
                TIME_STRING_FORMAT, time_created);
       config_set_string(config.get(), INFO_SECTION, FILE_CREATED_TIMESTAMP,
                         std::string(device_iot_config_time_created));
+      device_iot_config_dirty = true;
     }
   }
 
@@ -195,6 +242,10 @@ void device_iot_config_write(uint16_t event, UNUSED_ATTR char* p_param) {
 
   log::info("evt={}", event);
   std::unique_lock<std::mutex> lock(config_lock);
+  if (event == IOT_CONFIG_FLUSH_EVT && !device_iot_config_dirty) {
+    log::info("No change to save");
+    return;
+  }
   if (event == IOT_CONFIG_SAVE_TIMER_FIRED_EVT) {
     device_iot_config_set_modified_time();
   }
@@ -203,7 +254,11 @@ void device_iot_config_write(uint16_t event, UNUSED_ATTR char* p_param) {
   device_iot_config_restrict_device_num(*config);
   device_iot_config_sections_sort_by_entry_key(*config,
                                                device_iot_config_compare_key);
-  config_save(*config, IOT_CONFIG_FILE_PATH);
+  device_iot_config_dirty = false;
+  device_iot_config_save_deadline_ms = 0;
+  if (config_save(*config, IOT_CONFIG_FILE_PATH)) {
+    device_iot_config_record_save();
+  }
 }
 
 void device_iot_config_sections_sort_by_entry_key(config_t& config,
@@ -232,9 +287,26 @@ void device_iot_config_save_async(void) {
   log::assert_that(config != NULL, "assert failed: config != NULL");
   log::assert_that(config_timer != NULL, "assert failed: config_timer != NULL");
 
-  log::verbose("");
-  alarm_set(config_timer, CONFIG_SETTLE_PERIOD_MS,
-            device_iot_config_timer_save_cb, NULL);
+  uint64_t now_ms = device_iot_config_now_ms();
+  if (device_iot_config_save_deadline_ms == 0) {
+    device_iot_config_save_deadline_ms = now_ms + CONFIG_MAX_SAVE_DELAY_MS;
+  } else {
+    device_iot_config_coalesced_changes++;
+  }
+  device_iot_config_dirty = true;
+
+  // Wait for the changes to settle, but not past the deadline set by the first
+  // pending change, so that devices reporting events continuously do not hold
+  // back the save.
+  uint64_t delay_ms = CONFIG_SETTLE_PERIOD_MS;
+  if (device_iot_config_save_deadline_ms < now_ms + delay_ms) {
+    delay_ms = device_iot_config_save_deadline_ms > now_ms
+                   ? device_iot_config_save_deadline_ms - now_ms
+                   : 0;
+  }
+
+  log::verbose("delay_ms={}", delay_ms);
+  alarm_set(config_timer, delay_ms, device_iot_config_timer_save_cb, NULL);
 }
 
 int device_iot_config_get_device_num(const config_t& conf) {
@@ -271,7 +343,7 @@ void device_iot_config_restrict_device_num(config_t& config) {
       continue;
     }
 
-    i = config.sections.erase(i);
+    i = config.section_index.Erase(config.sections, i);
     if (++removed_devices >= need_remove_devices_num) {
       break;
     }
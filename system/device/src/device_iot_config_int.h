@@ -58,6 +58,11 @@ static const char* IOT_CONFIG_FILE_PATH = "bt_remote_dev_info.conf";
 static const char* IOT_CONFIG_BACKUP_PATH = "bt_remote_dev_info.bak";
 #endif  // __ANDROID__
 static const uint64_t CONFIG_SETTLE_PERIOD_MS = 12000;
+// A series of changes postpones the save by CONFIG_SETTLE_PERIOD_MS after each
+// of them, but never past CONFIG_MAX_SAVE_DELAY_MS after the first one.
+static const uint64_t CONFIG_MAX_SAVE_DELAY_MS = 60000;
+// Period over which the config file writes are accounted.
+static const uint64_t CONFIG_WRITE_STATS_PERIOD_MS = 24 * 60 * 60 * 1000;
 
 enum ConfigSource { NOT_LOADED, ORIGINAL, BACKUP, NEW_FILE, RESET };
 
@@ -34,7 +34,9 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "btcore/include/module.h"
 #include "btif/include/btif_storage.h"
@@ -185,6 +187,84 @@ typedef struct {
 
 } interop_db_entry_t;
 
+// Trie over the bytes of the address or name prefixes listed for a feature.
+// Checking a device against all the prefixes walks the bytes of its address
+// or name once, whatever the number of prefixes.
+class interop_prefix_trie_t {
+ public:
+  explicit interop_prefix_trie_t(bool fold_case) : fold_case_(fold_case) {}
+
+  // Adds |entry| under |key|. Only the first entry added under a key is kept.
+  void Insert(const uint8_t* key, size_t length, interop_db_entry_t* entry) {
+    if (nodes_.empty()) nodes_.emplace_back();
+    uint32_t node = 0;
+    for (size_t i = 0; i < length; i++) {
+      uint8_t byte = Fold(key[i]);
+      uint32_t child = Child(node, byte);
+      if (child == 0) {
+        child = nodes_.size();
+        nodes_[node].children.emplace_back(byte, child);
+        nodes_.emplace_back();
+      }
+      node = child;
+    }
+    if (nodes_[node].entry == NULL) nodes_[node].entry = entry;
+  }
+
+  // Returns an entry added under a prefix of |key|, or NULL if there is none.
+  interop_db_entry_t* Match(const uint8_t* key, size_t length) const {
+    if (nodes_.empty()) return NULL;
+    uint32_t node = 0;
+    for (size_t i = 0; nodes_[node].entry == NULL; i++) {
+      if (i == length) return NULL;
+      // The root is never a child, 0 means there is no child for the byte
+      node = Child(node, Fold(key[i]));
+      if (node == 0) return NULL;
+    }
+    return nodes_[node].entry;
+  }
+
+ private:
+  typedef struct {
+    // Byte and node index of the children, a handful at most in practice
+    std::vector<std::pair<uint8_t, uint32_t>> children;
+    interop_db_entry_t* entry = NULL;
+  } node_t;
+
+  uint8_t Fold(uint8_t byte) const {
+    return fold_case_ ? tolower(byte) : byte;
+  }
+
+  uint32_t Child(uint32_t node, uint8_t byte) const {
+    for (const auto& [child_byte, child] : nodes_[node].children) {
+      if (child_byte == byte) return child;
+    }
+    return 0;
+  }
+
+  bool fold_case_;
+  // nodes_[0] is the root
+  std::vector<node_t> nodes_;
+};
+
+// Lookup structures compiled from |interop_list|, so that the checks against
+// both the static and dynamic entries do not walk the whole list. Entries
+// appended to the list are added to the index as well, while removing entries
+// invalidates it until the next check rebuilds it. Protected by
+// |interop_list_lock|.
+typedef struct {
+  bool valid;
+  // Address and name prefixes, by feature
+  std::unordered_map<int, interop_prefix_trie_t> addr_tries;
+  std::unordered_map<int, interop_prefix_trie_t> name_tries;
+  // Address ranges, by feature
+  std::unordered_map<int, std::vector<interop_db_entry_t*>> addr_ranges;
+  // Entries matched on a value, by |interop_index_key|
+  std::unordered_map<uint64_t, interop_db_entry_t*> value_entries;
+} interop_index_t;
+
+static interop_index_t interop_index;
+
 namespace fmt {
 template <>
 struct formatter<interop_bl_type> : enum_formatter<interop_bl_type> {};
@@ -193,6 +273,7 @@ struct formatter<interop_bl_type> : enum_formatter<interop_bl_type> {};
 static const char* interop_feature_string_(const interop_feature_t feature);
 static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
+static void interop_index_clear();
 
 // Config related functions
 static void interop_config_cleanup(void);
@@ -311,6 +392,7 @@ static future_t* interop_clean_up(void) {
   pthread_mutex_lock(&interop_list_lock);
   list_free(interop_list);
   interop_list = NULL;
+  interop_index_clear();
   interop_is_initialized = false;
   pthread_mutex_unlock(&interop_list_lock);
   pthread_mutex_destroy(&interop_list_lock);
@@ -624,6 +706,135 @@ static bool interop_config_add_or_remove(interop_db_entry_t* db_entry,
   return status;
 }
 
+// Returns the feature and value |entry| is matched on, for the entries that
+// are neither matched on an address prefix, a name prefix nor a range.
+static uint64_t interop_index_key(const interop_db_entry_t* entry) {
+  uint64_t feature;
+  uint64_t value;
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_MANUFACTURE:
+      feature = entry->entry_type.mnfr_entry.feature;
+      value = entry->entry_type.mnfr_entry.manufacturer;
+      break;
+    case INTEROP_BL_TYPE_VNDR_PRDT:
+      feature = entry->entry_type.vnr_pdt_entry.feature;
+      value = ((uint64_t)entry->entry_type.vnr_pdt_entry.vendor_id << 16) |
+              entry->entry_type.vnr_pdt_entry.product_id;
+      break;
+    case INTEROP_BL_TYPE_SSR_MAX_LAT: {
+      const uint8_t* addr = entry->entry_type.ssr_max_lat_entry.addr.address;
+      feature = entry->entry_type.ssr_max_lat_entry.feature;
+      value = (addr[0] << 16) | (addr[1] << 8) | addr[2];
+      break;
+    }
+    case INTEROP_BL_TYPE_VERSION:
+      feature = entry->entry_type.version_entry.feature;
+      value = entry->entry_type.version_entry.version;
+      break;
+    case INTEROP_BL_TYPE_LMP_VERSION: {
+      const uint8_t* addr = entry->entry_type.lmp_version_entry.addr.address;
+      feature = entry->entry_type.lmp_version_entry.feature;
+      value = (addr[0] << 16) | (addr[1] << 8) | addr[2];
+      break;
+    }
+    default:
+      log::error("bl_type: {} not handled", entry->bl_type);
+      return 0;
+  }
+  return ((uint64_t)entry->bl_type << 56) | (feature << 32) | value;
+}
+
+static void interop_index_add(interop_db_entry_t* db_entry) {
+  switch (db_entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR: {
+      interop_addr_entry_t* cur = &db_entry->entry_type.addr_entry;
+      interop_index.addr_tries.try_emplace(cur->feature, false)
+          .first->second.Insert(cur->addr.address, cur->length, db_entry);
+      break;
+    }
+    case INTEROP_BL_TYPE_NAME: {
+      interop_name_entry_t* cur = &db_entry->entry_type.name_entry;
+      interop_index.name_tries.try_emplace(cur->feature, true)
+          .first->second.Insert((const uint8_t*)cur->name, strlen(cur->name),
+                                db_entry);
+      break;
+    }
+    case INTEROP_BL_TYPE_ADDR_RANGE:
+      interop_index
+          .addr_ranges[db_entry->entry_type.addr_range_entry.feature]
+          .push_back(db_entry);
+      break;
+    default:
+      interop_index.value_entries.emplace(interop_index_key(db_entry),
+                                          db_entry);
+      break;
+  }
+}
+
+static void interop_index_clear() {
+  interop_index.valid = false;
+  interop_index.addr_tries.clear();
+  interop_index.name_tries.clear();
+  interop_index.addr_ranges.clear();
+  interop_index.value_entries.clear();
+}
+
+static void interop_index_build() {
+  interop_index_clear();
+  for (const list_node_t* node = list_begin(interop_list);
+       node != list_end(interop_list); node = list_next(node)) {
+    interop_index_add((interop_db_entry_t*)list_node(node));
+  }
+  interop_index.valid = true;
+}
+
+// Same as the walk of |interop_list| in |interop_database_match|, for the
+// checks against both the static and dynamic entries, and for address ranges.
+static interop_db_entry_t* interop_index_match(interop_db_entry_t* entry,
+                                               interop_entry_type entry_type) {
+  if (!interop_index.valid) interop_index_build();
+
+  switch (entry->bl_type) {
+    case INTEROP_BL_TYPE_ADDR: {
+      interop_addr_entry_t* src = &entry->entry_type.addr_entry;
+      auto trie = interop_index.addr_tries.find(src->feature);
+      if (trie == interop_index.addr_tries.end()) return NULL;
+      interop_db_entry_t* db_entry =
+          trie->second.Match(src->addr.address, sizeof(RawAddress));
+      /* cur len is used to remove src entry from config file, when
+       * interop_database_remove_addr is called. */
+      if (db_entry) src->length = db_entry->entry_type.addr_entry.length;
+      return db_entry;
+    }
+    case INTEROP_BL_TYPE_NAME: {
+      interop_name_entry_t* src = &entry->entry_type.name_entry;
+      auto trie = interop_index.name_tries.find(src->feature);
+      if (trie == interop_index.name_tries.end()) return NULL;
+      return trie->second.Match((const uint8_t*)src->name, strlen(src->name));
+    }
+    case INTEROP_BL_TYPE_ADDR_RANGE: {
+      interop_addr_range_entry_t* src = &entry->entry_type.addr_range_entry;
+      auto ranges = interop_index.addr_ranges.find(src->feature);
+      if (ranges == interop_index.addr_ranges.end()) return NULL;
+      for (interop_db_entry_t* db_entry : ranges->second) {
+        interop_addr_range_entry_t* cur =
+            &db_entry->entry_type.addr_range_entry;
+        if ((db_entry->bl_entry_type & entry_type) &&
+            (src->addr_start >= cur->addr_start) &&
+            (src->addr_start <= cur->addr_end)) {
+          return db_entry;
+        }
+      }
+      return NULL;
+    }
+    default: {
+      auto it = interop_index.value_entries.find(interop_index_key(entry));
+      if (it == interop_index.value_entries.end()) return NULL;
+      return it->second;
+    }
+  }
+}
+
 static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
   interop_db_entry_t* ret_entry = NULL;
   bool match_found =
@@ -641,6 +852,7 @@ static void interop_database_add_(interop_db_entry_t* db_entry, bool persist) {
 
   if (interop_list) {
     list_append(interop_list, db_entry);
+    if (interop_index.valid) interop_index_add(db_entry);
   }
 
   pthread_mutex_unlock(&interop_list_lock);
@@ -664,6 +876,14 @@ static bool interop_database_match(interop_db_entry_t* entry,
     return false;
   }
 
+  if (entry_type == (INTEROP_ENTRY_TYPE_STATIC | INTEROP_ENTRY_TYPE_DYNAMIC) ||
+      entry->bl_type == INTEROP_BL_TYPE_ADDR_RANGE) {
+    interop_db_entry_t* db_entry = interop_index_match(entry, entry_type);
+    if (db_entry && ret_entry) *ret_entry = db_entry;
+    pthread_mutex_unlock(&interop_list_lock);
+    return db_entry != NULL;
+  }
+
   const list_node_t* node = list_begin(interop_list);
 
   while (node != list_end(interop_list)) {
@@ -799,6 +1019,7 @@ static bool interop_database_remove_(interop_db_entry_t* entry) {
   // first remove it from linked list
   pthread_mutex_lock(&interop_list_lock);
   list_remove(interop_list, (void*)ret_entry);
+  interop_index.valid = false;
   pthread_mutex_unlock(&interop_list_lock);
 
   return interop_config_add_or_remove(entry, false);
@@ -1589,6 +1810,7 @@ bool interop_database_remove_feature(const interop_feature_t feature) {
     if (entry_match) {
       pthread_mutex_lock(&interop_list_lock);
       list_remove(interop_list, (void*)entry);
+      interop_index.valid = false;
       pthread_mutex_unlock(&interop_list_lock);
     }
   }
@@ -3036,6 +3036,64 @@ TEST_F_WITH_FLAGS(
   test::mock::osi_alarm::alarm_is_scheduled.body = {};
 }
 
+TEST_F_WITH_FLAGS(
+    DeviceIotConfigTest, test_device_iot_config_flush_without_change,
+    REQUIRES_FLAGS_ENABLED(ACONFIG_FLAG(TEST_BT, device_iot_config_logging))) {
+  test::mock::osi_config::config_save.body =
+      [&](const config_t& config, const std::string& filename) -> bool {
+    return true;
+  };
+
+  // Save the changes made when loading the config
+  device_iot_config_flush();
+
+  {
+    reset_mock_function_count_map();
+
+    device_iot_config_flush();
+
+    EXPECT_EQ(get_func_call_count("alarm_cancel"), 1);
+    EXPECT_EQ(get_func_call_count("config_save"), 0);
+  }
+
+  {
+    reset_mock_function_count_map();
+
+    device_iot_config_save_async();
+    device_iot_config_flush();
+
+    EXPECT_EQ(get_func_call_count("alarm_set"), 1);
+    EXPECT_EQ(get_func_call_count("config_save"), 1);
+  }
+
+  test::mock::osi_config::config_save.body = {};
+}
+
+TEST_F_WITH_FLAGS(
+    DeviceIotConfigTest, test_device_iot_config_save_async_delay,
+    REQUIRES_FLAGS_ENABLED(ACONFIG_FLAG(TEST_BT, device_iot_config_logging))) {
+  uint64_t delay_ms = 0;
+  test::mock::osi_alarm::alarm_set.body =
+      [&](alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
+          void* data) { delay_ms = interval_ms; };
+
+  device_iot_config_flush();
+
+  {
+    reset_mock_function_count_map();
+
+    device_iot_config_save_async();
+    EXPECT_EQ(delay_ms, CONFIG_SETTLE_PERIOD_MS);
+
+    device_iot_config_save_async();
+    EXPECT_LE(delay_ms, CONFIG_SETTLE_PERIOD_MS);
+
+    EXPECT_EQ(get_func_call_count("alarm_set"), 2);
+  }
+
+  test::mock::osi_alarm::alarm_set.body = {};
+}
+
 TEST_F_WITH_FLAGS(
     DeviceIotConfigTest, test_device_iot_config_clear,
     REQUIRES_FLAGS_ENABLED(ACONFIG_FLAG(TEST_BT, device_iot_config_logging))) {
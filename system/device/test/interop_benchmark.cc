@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+// Measures the interop quirk checks done on connection and profile paths
+// against the full interop database shipped with the stack.
+
+#include <benchmark/benchmark.h>
+
+#include "btcore/include/module.h"
+#include "device/include/interop.h"
+#include "types/raw_address.h"
+
+#ifndef __ANDROID__
+#include <filesystem>
+
+// The database is installed next to the benchmark, and copied to where the
+// stack loads it from on host.
+static bool install_interop_database() {
+  std::error_code ec;
+  std::filesystem::path self = std::filesystem::read_symlink("/proc/self/exe");
+  return std::filesystem::copy_file(
+      self.parent_path() / "interop_database.conf",
+      std::filesystem::temp_directory_path() / "interop_database.conf",
+      std::filesystem::copy_options::overwrite_existing, ec);
+}
+#endif
+
+extern const module_t interop_module;
+
+using ::benchmark::State;
+
+namespace {
+
+class InteropDatabase {
+ public:
+  InteropDatabase() {
+#ifndef __ANDROID__
+    install_interop_database();
+#endif
+    module_init(&interop_module);
+  }
+  ~InteropDatabase() { module_clean_up(&interop_module); }
+};
+
+void BM_MatchAddrHit(State& state) {
+  InteropDatabase database;
+  RawAddress address;
+  RawAddress::FromString("e0:75:0a:12:34:56", address);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_addr(INTEROP_DISABLE_AUTO_PAIRING, &address));
+  }
+}
+
+void BM_MatchAddrMiss(State& state) {
+  InteropDatabase database;
+  RawAddress address;
+  RawAddress::FromString("11:22:33:44:55:66", address);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_addr(INTEROP_DISABLE_AUTO_PAIRING, &address));
+  }
+}
+
+void BM_MatchNameHit(State& state) {
+  InteropDatabase database;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "NISSAN CONNECT"));
+  }
+}
+
+void BM_MatchNameMiss(State& state) {
+  InteropDatabase database;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "Pixel Buds Pro"));
+  }
+}
+
+void BM_MatchManufacturerMiss(State& state) {
+  InteropDatabase database;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        interop_match_manufacturer(INTEROP_DISABLE_SNIFF_DURING_SCO, 0x00e0));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_MatchAddrHit);
+BENCHMARK(BM_MatchAddrMiss);
+BENCHMARK(BM_MatchNameHit);
+BENCHMARK(BM_MatchNameMiss);
+BENCHMARK(BM_MatchManufacturerMiss);
+BENCHMARK_MAIN();
@@ -467,6 +467,17 @@ TEST_F(InteropTest, test_name_hit) {
   module_clean_up(&interop_module);
 }
 
+TEST_F(InteropTest, test_name_prefix_ignores_case) {
+  module_init(&interop_module);
+
+  EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "bmw 5 series"));
+  EXPECT_TRUE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "AUDI A4"));
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "BM"));
+  EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "My BMW"));
+
+  module_clean_up(&interop_module);
+}
+
 TEST_F(InteropTest, test_name_miss) {
   module_init(&interop_module);
 
@@ -686,6 +697,30 @@ TEST_F(InteropTest, test_dynamic_addr) {
   module_clean_up(&interop_module);
 }
 
+TEST_F(InteropTest, test_dynamic_addr_removal_keeps_static_entries) {
+  module_init(&interop_module);
+
+  RawAddress static_address;
+  RawAddress dynamic_address;
+
+  RawAddress::FromString("34:c7:31:12:34:56", static_address);
+  RawAddress::FromString("11:22:33:44:55:66", dynamic_address);
+  EXPECT_TRUE(
+      interop_match_addr(INTEROP_DISABLE_AUTO_PAIRING, &static_address));
+
+  interop_database_add_addr(INTEROP_DISABLE_AUTO_PAIRING, &dynamic_address, 3);
+  EXPECT_TRUE(
+      interop_match_addr(INTEROP_DISABLE_AUTO_PAIRING, &dynamic_address));
+
+  interop_database_remove_addr(INTEROP_DISABLE_AUTO_PAIRING, &dynamic_address);
+  EXPECT_FALSE(
+      interop_match_addr(INTEROP_DISABLE_AUTO_PAIRING, &dynamic_address));
+  EXPECT_TRUE(
+      interop_match_addr(INTEROP_DISABLE_AUTO_PAIRING, &static_address));
+
+  module_clean_up(&interop_module);
+}
+
 TEST_F(InteropTest, test_dynamic_name) {
   module_init(&interop_module);
 
@@ -31,6 +31,12 @@
 #include "g722_typedefs.h"
 #include "g722_enc_dec.h"
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #if !defined(FALSE)
 #define FALSE 0
 #endif
@@ -41,6 +47,10 @@
 #define PACKED_OUTPUT   (0)
 #define BITS_PER_SAMPLE (8)
 
+/* Taps of the transmit QMF, and input samples staged after its history */
+#define QMF_TAPS        (24)
+#define QMF_CHUNK       (256)
+
 #ifndef BUILD_FEATURE_G722_USE_INTRINSIC_SAT
 static __inline int16_t saturate(int32_t amp)
 {
@@ -258,15 +268,65 @@ static int16_t qm2[4] =
 {
     -7408,  -1616,   7408,   1616
 };
-static int16_t qmf_coeffs[12] =
+/* The QMF coefficients
+       3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11
+   applied to the even samples of the delay line, and reversed to the odd
+   ones. They are interleaved in the order of the samples, so the sum and the
+   difference of the two filters are plain 24 tap dot products. */
+static const int16_t qmf_sum[QMF_TAPS] =
+{
+       3,  -11,  -11,   53,   12, -156,   32,  362, -210, -805,  951, 3876,
+    3876,  951, -805, -210,  362,   32, -156,   12,   53,  -11,  -11,    3,
+};
+static const int16_t qmf_diff[QMF_TAPS] =
 {
-       3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
+      -3,  -11,   11,   53,  -12, -156,  -32,  362,  210, -805, -951, 3876,
+   -3876,  951,  805, -210, -362,   32,  156,   12,  -53,  -11,   11,    3,
 };
 static int16_t ihn[3] = {0, 1, 0};
 static int16_t ihp[3] = {0, 3, 2};
 static int16_t wh[3] = {0, -214, 798};
 static int16_t rh2[4] = {2, 1, 2, 1};
 
+static __inline int qmf_dot(const int16_t x[], const int16_t h[])
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    int32x4_t acc;
+    int32x2_t sum;
+
+    acc = vmull_s16(vld1_s16(x), vld1_s16(h));
+    acc = vmlal_s16(acc, vld1_s16(x + 4), vld1_s16(h + 4));
+    acc = vmlal_s16(acc, vld1_s16(x + 8), vld1_s16(h + 8));
+    acc = vmlal_s16(acc, vld1_s16(x + 12), vld1_s16(h + 12));
+    acc = vmlal_s16(acc, vld1_s16(x + 16), vld1_s16(h + 16));
+    acc = vmlal_s16(acc, vld1_s16(x + 20), vld1_s16(h + 20));
+    sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    sum = vpadd_s32(sum, sum);
+    return vget_lane_s32(sum, 0);
+#elif defined(__SSE2__)
+    __m128i acc;
+
+    acc = _mm_madd_epi16(_mm_loadu_si128((const __m128i *) x),
+                         _mm_loadu_si128((const __m128i *) h));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (x + 8)),
+                                            _mm_loadu_si128((const __m128i *) (h + 8))));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) (x + 16)),
+                                            _mm_loadu_si128((const __m128i *) (h + 16))));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#else
+    int sum;
+    int i;
+
+    sum = 0;
+    for (i = 0;  i < QMF_TAPS;  i++)
+        sum += x[i]*h[i];
+    return sum;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
 int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
                        const int16_t amp[], int len)
 {
@@ -288,15 +348,23 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     int xlow;
     int xhigh;
     int g722_bytes;
-    /* Even and odd tap accumulators */
-    int sumeven;
-    int sumodd;
     int ihigh;
     int ilow;
     int code;
+    /* QMF delay line: the history of s->x, then the staged input samples.
+       Sliding a window over it saves shuffling s->x down for each pair of
+       samples. */
+    int16_t x[QMF_TAPS - 2 + QMF_CHUNK];
+    int xpos;
+    int xend;
+    int n;
 
     g722_bytes = 0;
     xhigh = 0;
+    for (i = 0;  i < QMF_TAPS - 2;  i++)
+        x[i] = (int16_t) s->x[i + 2];
+    xpos = 0;
+    xend = QMF_TAPS - 2;
     for (j = 0;  j < len;  )
     {
         if (s->itu_test_mode)
@@ -308,26 +376,29 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
         {
             {
                 /* Apply the transmit QMF */
-                /* Shuffle the buffer down */
-                for (i = 0;  i < 22;  i++)
-                    s->x[i] = s->x[i + 2];
-                //TODO: if len is odd, then this can be a buffer overrun
-                s->x[22] = amp[j++];
-                s->x[23] = amp[j++];
-    
-                /* Discard every other QMF output */
-                sumeven = 0;
-                sumodd = 0;
-                for (i = 0;  i < 12;  i++)
+                if (xpos + QMF_TAPS > xend)
                 {
-                    sumodd += s->x[2*i]*qmf_coeffs[i];
-                    sumeven += s->x[2*i + 1]*qmf_coeffs[11 - i];
+                    /* Keep the history, and stage the next input samples */
+                    memmove(x, &x[xpos], (QMF_TAPS - 2)*sizeof(x[0]));
+                    n = len - j;
+                    if (n > QMF_CHUNK)
+                        n = QMF_CHUNK;
+                    memcpy(&x[QMF_TAPS - 2], &amp[j], n*sizeof(x[0]));
+                    /* An odd trailing sample is paired with silence */
+                    if (n & 1)
+                        x[QMF_TAPS - 2 + n++] = 0;
+                    xpos = 0;
+                    xend = QMF_TAPS - 2 + n;
                 }
+                j += 2;
+
+                /* Discard every other QMF output */
                 /* We shift by 12 to allow for the QMF filters (DC gain = 4096), plus 1
                    to allow for us summing two filters, plus 1 to allow for the 15 bit
                    input to the G.722 algorithm. */
-                xlow = (sumeven + sumodd) >> 14;
-                xhigh = (sumeven - sumodd) >> 14;
+                xlow = qmf_dot(&x[xpos], qmf_sum) >> 14;
+                xhigh = qmf_dot(&x[xpos], qmf_diff) >> 14;
+                xpos += 2;
 
 #ifdef RUN_LIKE_REFERENCE_G722
                 /* The following lines are only used to verify bit-exactness
@@ -345,12 +416,17 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
         /* Block 1L, QUANTL */
         wd = (el >= 0)  ?  el  :  -(el + 1);
 
-        for (i = 1;  i < 30;  i++)
+        /* The levels grow with i: bisect them for the last one not above
+           wd rather than scanning them. i is the level after it, 30 if none
+           is above wd. */
+        i = 0;
+        for (wd2 = 16;  wd2 > 0;  wd2 >>= 1)
         {
-            wd1 = (q6[i]*s->band[0].det) >> 12;
-            if (wd < wd1)
-                break;
+            wd3 = i + wd2;
+            if (wd3 < 30  &&  wd >= ((q6[wd3]*s->band[0].det) >> 12))
+                i = wd3;
         }
+        i++;
         ilow = (el < 0)  ?  iln[i]  :  ilp[i];
 
         /* Block 2L, INVQAL */
@@ -431,6 +507,12 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
             g722_data[g722_bytes++] = (uint8_t) code;
 #endif
     }
+    if (xpos >= 2)
+    {
+        /* Save the delay line of the last QMF output */
+        for (i = 0;  i < QMF_TAPS;  i++)
+            s->x[i] = x[xpos - 2 + i];
+    }
     return g722_bytes;
 }
 /*- End of function --------------------------------------------------------*/
@@ -305,6 +305,15 @@ OI_STATUS OI_CODEC_SBC_DecoderLimit(OI_CODEC_SBC_DECODER_CONTEXT* context,
 OI_STATUS OI_CODEC_SBC_DecoderConfigureMSbc(
     OI_CODEC_SBC_DECODER_CONTEXT* context);
 
+/**
+ * This function selects whether the 8-subband synthesis filterbank may use
+ * the SIMD windowing supported by the CPU. It is enabled by default and applies
+ * to all decoder contexts. Both paths produce identical PCM output.
+ *
+ * @param useSimd   If false, the portable C windowing is always used.
+ */
+void OI_CODEC_SBC_UseSimd(OI_BOOL useSimd);
+
 /**
  * This function sets the decoder parameters for a raw decode where the decoder
  * parameters are not available in the sbc data stream.
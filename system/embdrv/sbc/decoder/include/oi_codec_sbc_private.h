@@ -183,6 +183,15 @@ PRIVATE void cosineModulateSynth4(SBC_BUFFER_T* RESTRICT out,
 PRIVATE void SynthWindow40_int32_int32_symmetry_with_sum(
     int16_t* pcm, SBC_BUFFER_T buffer[80], OI_UINT strideShift);
 
+typedef void (*SYNTH_WINDOW)(int16_t* pcm, SBC_BUFFER_T const* RESTRICT buffer,
+                             OI_UINT strideShift);
+PRIVATE void SynthWindow80_generated(int16_t* pcm,
+                                     SBC_BUFFER_T const* RESTRICT buffer,
+                                     OI_UINT strideShift);
+/* Returns a SIMD implementation of SynthWindow80_generated supported by the
+ * CPU, or NULL if there is none. */
+PRIVATE SYNTH_WINDOW OI_SBC_GetSynthWindow80Simd(void);
+
 INLINE void dct3_4(int32_t* RESTRICT out, int32_t const* RESTRICT in);
 PRIVATE void analyze4_generated(SBC_BUFFER_T analysisBuffer[RESTRICT 40],
                                 int16_t* pcm, OI_UINT strideShift,
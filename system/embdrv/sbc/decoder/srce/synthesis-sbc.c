@@ -243,9 +243,6 @@ INLINE int32_t default_mul_16s_32s_hi(int16_t u, int32_t v) {
 
 #define LONG_MULT_DCT(K, sample) (MUL_16S_32S_HI(K, sample) << 2)
 
-PRIVATE void SynthWindow80_generated(int16_t* pcm,
-                                     SBC_BUFFER_T const* RESTRICT buffer,
-                                     OI_UINT strideShift);
 PRIVATE void SynthWindow112_generated(int16_t* pcm,
                                       SBC_BUFFER_T const* RESTRICT buffer,
                                       OI_UINT strideShift);
@@ -265,9 +262,19 @@ typedef void (*SYNTH_FRAME)(OI_CODEC_SBC_DECODER_CONTEXT* context, int16_t* pcm,
 #define DCT2_8(dst, src) dct2_8(dst, src)
 #endif
 
-#ifndef SYNTH80
-#define SYNTH80 SynthWindow80_generated
+static OI_BOOL useSimd = TRUE;
+
+void OI_CODEC_SBC_UseSimd(OI_BOOL enable) { useSimd = enable; }
+
+/* A platform specific SYNTH80 takes precedence over the SIMD windows. */
+static SYNTH_WINDOW SelectSynthWindow80(void) {
+#ifdef SYNTH80
+  return SYNTH80;
+#else
+  SYNTH_WINDOW simd = useSimd ? OI_SBC_GetSynthWindow80Simd() : NULL;
+  return simd != NULL ? simd : SynthWindow80_generated;
 #endif
+}
 
 #ifndef SYNTH112
 #define SYNTH112 SynthWindow112_generated
@@ -283,6 +290,7 @@ PRIVATE void OI_SBC_SynthFrame_80(OI_CODEC_SBC_DECODER_CONTEXT* context,
   OI_UINT offset = context->common.filterBufferOffset;
   int32_t* s = context->common.subdata + 8 * nrof_channels * blkstart;
   OI_UINT blkstop = blkstart + blkcount;
+  SYNTH_WINDOW synth80 = SelectSynthWindow80();
 
   for (blk = blkstart; blk < blkstop; blk++) {
     if (offset == 0) {
@@ -303,7 +311,7 @@ PRIVATE void OI_SBC_SynthFrame_80(OI_CODEC_SBC_DECODER_CONTEXT* context,
 
     for (ch = 0; ch < nrof_channels; ch++) {
       DCT2_8(context->common.filterBuffer[ch] + offset, s);
-      SYNTH80(pcm + ch, context->common.filterBuffer[ch] + offset,
+      synth80(pcm + ch, context->common.filterBuffer[ch] + offset,
               pcmStrideShift);
       s += 8;
     }
@@ -0,0 +1,216 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/** @file
+
+SIMD versions of SynthWindow80_generated.
+
+Output sample j of SynthWindow80_generated is a sum of products
+(coefficient * buffer[i]) << shift or >> shift, divided by 32768 and
+clipped. Within each group of 16 buffer entries, the terms used by the 8
+outputs are buffer[16 * m + 4 + j] and buffer[16 * m + 12 - j], so the
+window loads two contiguous vectors per group, the second one reversed, and
+multiplies, shifts and accumulates all 8 outputs at once. The tables below
+hold the coefficients and shifts of SynthWindow80_generated in that layout,
+with a zero coefficient where an output has no term.
+
+Every product and shift is computed on 32 bits with the same truncation as
+the C code, and integer addition is order independent, so the output is
+identical to SynthWindow80_generated.
+
+@ingroup codec_internal
+*/
+
+/**
+@addtogroup codec_internal
+@{
+*/
+
+#include "oi_codec_sbc_private.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SYNTH_WINDOW_NEON
+#elif (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SYNTH_WINDOW_AVX2
+#endif
+
+#if defined(SYNTH_WINDOW_NEON) || defined(SYNTH_WINDOW_AVX2)
+
+/* [m][0][j]: term buffer[16 * m + 4 + j], [m][1][j]: term
+ * buffer[16 * m + 12 - j] of output sample j. */
+static const int16_t synth80_coef[5][2][8] = {
+    {{0, -3263, -10385, -16457, 10445, -8443, -10337, -6087},
+     {8235, 29293, 24995, 19083, 0, 16913, 11167, 9293}},
+    {{-23167, -5229, -309, -23641, -5297, -301, -30605, -2893},
+     {26479, 30835, 9161, -29015, 0, 3687, 1917, 1247}},
+    {{-17397, -27021, -23063, -12889, 22299, 10255, 9553, 18055},
+     {9399, 31633, 27561, 6145, 0, 15447, 8317, 23671}},
+    {{17397, 17319, 2309, 24211, 10603, 9405, 16383, 1747},
+     {26479, 26663, 12705, 23469, 0, -18233, 22117, 11537}},
+    {{23167, 4555, 6239, 21223, 9539, 26189, 8603, 8721},
+     {8235, 12419, 9251, 26913, 0, 1499, 7543, 685}},
+};
+
+/* Shifts applied to the products above, positive to the left. */
+static const int32_t synth80_shift[5][2][8] = {
+    {{0, -5, -6, -6, -4, -7, -4, -2},
+     {-3, -5, -5, -5, 0, -5, -4, -3}},
+    {{-3, 0, 4, -2, 1, 5, -1, 3},
+     {-2, -3, -3, -4, 0, 1, 2, 3}},
+    {{1, 1, 1, 2, 2, 2, 2, 1},
+     {3, 1, 1, 3, 0, 2, 3, 2}},
+    {{1, 1, 3, -1, 0, -1, -2, 1},
+     {-2, -2, -1, -2, 0, -3, -4, -1}},
+    {{-3, -1, -3, -8, -4, -7, -6, -7},
+     {-3, -4, -4, -6, 0, -1, -3, 1}},
+};
+
+#endif
+
+#ifdef SYNTH_WINDOW_NEON
+
+/* x / 32768 as computed by C: negative values get a bias of 32767. */
+static inline int32x4_t div32768_neon(int32x4_t x) {
+  int32x4_t bias = vreinterpretq_s32_u32(
+      vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(x, 31)), 17));
+  return vshrq_n_s32(vaddq_s32(x, bias), 15);
+}
+
+static void SynthWindow80_neon(int16_t* pcm,
+                               SBC_BUFFER_T const* RESTRICT buffer,
+                               OI_UINT strideShift) {
+  int32x4_t lo = vdupq_n_s32(0);
+  int32x4_t hi = vdupq_n_s32(0);
+  int16x4_t out[2];
+  OI_UINT i;
+  OI_UINT m;
+
+  for (m = 0; m < 5; m++) {
+    int16x8_t fwd = vld1q_s16(buffer + 16 * m + 4);
+    int16x8_t rev = vld1q_s16(buffer + 16 * m + 5);
+    int16x8_t c;
+
+    rev = vrev64q_s16(rev);
+    rev = vcombine_s16(vget_high_s16(rev), vget_low_s16(rev));
+
+    c = vld1q_s16(synth80_coef[m][0]);
+    lo = vaddq_s32(lo, vshlq_s32(vmull_s16(vget_low_s16(fwd), vget_low_s16(c)),
+                                 vld1q_s32(synth80_shift[m][0])));
+    hi = vaddq_s32(hi,
+                   vshlq_s32(vmull_s16(vget_high_s16(fwd), vget_high_s16(c)),
+                             vld1q_s32(synth80_shift[m][0] + 4)));
+    c = vld1q_s16(synth80_coef[m][1]);
+    lo = vaddq_s32(lo, vshlq_s32(vmull_s16(vget_low_s16(rev), vget_low_s16(c)),
+                                 vld1q_s32(synth80_shift[m][1])));
+    hi = vaddq_s32(hi,
+                   vshlq_s32(vmull_s16(vget_high_s16(rev), vget_high_s16(c)),
+                             vld1q_s32(synth80_shift[m][1] + 4)));
+  }
+
+  /* Division by 32768 rounding towards zero, then saturation to 16 bits. */
+  out[0] = vqmovn_s32(div32768_neon(lo));
+  out[1] = vqmovn_s32(div32768_neon(hi));
+
+  if (strideShift == 0) {
+    vst1_s16(pcm, out[0]);
+    vst1_s16(pcm + 4, out[1]);
+  } else {
+    int16_t samples[8];
+    vst1_s16(samples, out[0]);
+    vst1_s16(samples + 4, out[1]);
+    for (i = 0; i < 8; i++) {
+      pcm[i << strideShift] = samples[i];
+    }
+  }
+}
+
+#endif /* SYNTH_WINDOW_NEON */
+
+#ifdef SYNTH_WINDOW_AVX2
+
+__attribute__((target("avx2"))) static void SynthWindow80_avx2(
+    int16_t* pcm, SBC_BUFFER_T const* RESTRICT buffer, OI_UINT strideShift) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m128i reverse = _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4,
+                                        5, 2, 3, 0, 1);
+  __m256i acc = zero;
+  __m128i out;
+  int16_t samples[8];
+  OI_UINT i;
+  OI_UINT m;
+
+  for (m = 0; m < 5; m++) {
+    OI_UINT r;
+    __m128i x[2];
+
+    x[0] = _mm_loadu_si128((const __m128i*)(buffer + 16 * m + 4));
+    x[1] = _mm_shuffle_epi8(
+        _mm_loadu_si128((const __m128i*)(buffer + 16 * m + 5)), reverse);
+
+    for (r = 0; r < 2; r++) {
+      __m256i c = _mm256_cvtepi16_epi32(
+          _mm_loadu_si128((const __m128i*)synth80_coef[m][r]));
+      __m256i shift =
+          _mm256_loadu_si256((const __m256i*)synth80_shift[m][r]);
+      __m256i left = _mm256_max_epi32(shift, zero);
+      __m256i right = _mm256_sub_epi32(left, shift);
+      __m256i p = _mm256_mullo_epi32(_mm256_cvtepi16_epi32(x[r]), c);
+      p = _mm256_srav_epi32(_mm256_sllv_epi32(p, left), right);
+      acc = _mm256_add_epi32(acc, p);
+    }
+  }
+
+  /* Division by 32768 rounding towards zero, then saturation to 16 bits. */
+  acc = _mm256_add_epi32(acc, _mm256_and_si256(_mm256_srai_epi32(acc, 31),
+                                                _mm256_set1_epi32(32767)));
+  acc = _mm256_srai_epi32(acc, 15);
+  out = _mm_packs_epi32(_mm256_castsi256_si128(acc),
+                        _mm256_extracti128_si256(acc, 1));
+
+  if (strideShift == 0) {
+    _mm_storeu_si128((__m128i*)pcm, out);
+    return;
+  }
+  _mm_storeu_si128((__m128i*)samples, out);
+  for (i = 0; i < 8; i++) {
+    pcm[i << strideShift] = samples[i];
+  }
+}
+
+#endif /* SYNTH_WINDOW_AVX2 */
+
+PRIVATE SYNTH_WINDOW OI_SBC_GetSynthWindow80Simd(void) {
+#if defined(SYNTH_WINDOW_NEON)
+  return SynthWindow80_neon;
+#elif defined(SYNTH_WINDOW_AVX2)
+  /* Per element variable shifts need AVX2. */
+  if (__builtin_cpu_supports("avx2")) {
+    return SynthWindow80_avx2;
+  }
+  return NULL;
+#else
+  return NULL;
+#endif
+}
+
+/**
+@}
+*/
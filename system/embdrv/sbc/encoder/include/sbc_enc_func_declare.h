@@ -35,6 +35,18 @@ extern const int32_t gas32CoeffFor4SBs[];
 extern const int32_t gas32CoeffFor8SBs[];
 #endif
 
+#if (SBC_SIMD_WINDOW_ACCU == TRUE) && (SBC_IPAQ_OPT == TRUE) && \
+    (SBC_ARM_ASM_OPT == FALSE) && (SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE)
+#define SBC_SIMD_WINDOW_ACCU_ENABLED TRUE
+/* Windowing coefficients laid out as 5 rows of 4 or 8 * 2 lanes: output i of
+ * the windowing is the sum over row j of lane i times s16X[ChOffset + i + j *
+ * 2 * subbands]. */
+extern const int16_t gas16WindowCoeffs4[];
+extern const int16_t gas16WindowCoeffs8[];
+#else
+#define SBC_SIMD_WINDOW_ACCU_ENABLED FALSE
+#endif
+
 /* Global functions*/
 
 void sbc_enc_bit_alloc_mono(SBC_ENC_PARAMS* CodecParams);
@@ -45,6 +57,17 @@ void SbcAnalysisInit(void);
 void SbcAnalysisFilter4(SBC_ENC_PARAMS* strEncParams, int16_t* input);
 void SbcAnalysisFilter8(SBC_ENC_PARAMS* strEncParams, int16_t* input);
 
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+/* Computes the windowing of SbcAnalysisFilter4/8 for one channel: ps16X
+ * points at s16X + ChOffset and the sums are written to ps32DCTY. */
+typedef void (*SBC_WINDOW_ACCU_FUNC)(const int16_t* ps16X, int32_t* ps32DCTY);
+
+/* Return the fastest SIMD windowing supported by the CPU, or NULL if there
+ * is none and the scalar windowing must be used. */
+SBC_WINDOW_ACCU_FUNC SbcGetSimdWindowAccu4(void);
+SBC_WINDOW_ACCU_FUNC SbcGetSimdWindowAccu8(void);
+#endif
+
 void SBC_FastIDCT8(int32_t* pInVect, int32_t* pOutVect);
 void SBC_FastIDCT4(int32_t* x0, int32_t* pOutVect);
 
@@ -117,6 +117,14 @@
 #define SBC_IS_64_MULT_IN_WINDOW_ACCU FALSE
 #endif /*SBC_IS_64_MULT_IN_WINDOW_ACCU */
 
+/* Set SBC_SIMD_WINDOW_ACCU to FALSE to always use the scalar windowing. The
+ * SIMD kernels compute the same 32 bit sums as the SBC_IPAQ_OPT windowing
+ * with 16 bit coefficients, so they are only used in that configuration.
+ */
+#ifndef SBC_SIMD_WINDOW_ACCU
+#define SBC_SIMD_WINDOW_ACCU TRUE
+#endif /* SBC_SIMD_WINDOW_ACCU */
+
 /* Set SBC_IS_64_MULT_IN_IDCT to TRUE to use 64 bits multiplication in the DCT
  * of Matrixing
  */
@@ -201,6 +209,11 @@ uint32_t SBC_Encode(SBC_ENC_PARAMS* strEncParams, int16_t* input,
                     uint8_t* output);
 void SBC_Encoder_Init(SBC_ENC_PARAMS* strEncParams);
 
+/* Selects whether the analysis filter may use the SIMD windowing kernels
+ * supported by the CPU. Enabled by default, takes effect on the next call to
+ * SBC_Encoder_Init. Both paths produce the same bitstream. */
+void SBC_Encoder_UseSimd(bool use_simd);
+
 #ifdef __cplusplus
 }
 #endif
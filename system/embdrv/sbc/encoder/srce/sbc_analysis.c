@@ -197,6 +197,146 @@
 #define WIND_8_SUBBANDS_8_2 (int16_t)0x12CF /* 40 = 0x12CF6C75 */
 #endif
 
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+/* The windowing of WINDOW_PARTIAL_4 and WINDOW_PARTIAL_8 expanded into one
+ * coefficient per sample, for the SIMD kernels of sbc_analysis_simd.c. */
+const int16_t gas16WindowCoeffs4[5 * 8] = {
+    /* s16X[ChOffset + 0 + i] */
+    0,
+    WIND_4_SUBBANDS_1_0,
+    WIND_4_SUBBANDS_2_0,
+    WIND_4_SUBBANDS_3_0,
+    WIND_4_SUBBANDS_4_0,
+    WIND_4_SUBBANDS_3_4,
+    WIND_4_SUBBANDS_2_4,
+    WIND_4_SUBBANDS_1_4,
+    /* s16X[ChOffset + 8 + i] */
+    WIND_4_SUBBANDS_0_1,
+    WIND_4_SUBBANDS_1_1,
+    WIND_4_SUBBANDS_2_1,
+    WIND_4_SUBBANDS_3_1,
+    WIND_4_SUBBANDS_4_1,
+    WIND_4_SUBBANDS_3_3,
+    WIND_4_SUBBANDS_2_3,
+    WIND_4_SUBBANDS_1_3,
+    /* s16X[ChOffset + 16 + i] */
+    WIND_4_SUBBANDS_0_2,
+    WIND_4_SUBBANDS_1_2,
+    WIND_4_SUBBANDS_2_2,
+    WIND_4_SUBBANDS_3_2,
+    WIND_4_SUBBANDS_4_2,
+    WIND_4_SUBBANDS_3_2,
+    WIND_4_SUBBANDS_2_2,
+    WIND_4_SUBBANDS_1_2,
+    /* s16X[ChOffset + 24 + i] */
+    (int16_t)-WIND_4_SUBBANDS_0_2,
+    WIND_4_SUBBANDS_1_3,
+    WIND_4_SUBBANDS_2_3,
+    WIND_4_SUBBANDS_3_3,
+    WIND_4_SUBBANDS_4_1,
+    WIND_4_SUBBANDS_3_1,
+    WIND_4_SUBBANDS_2_1,
+    WIND_4_SUBBANDS_1_1,
+    /* s16X[ChOffset + 32 + i] */
+    (int16_t)-WIND_4_SUBBANDS_0_1,
+    WIND_4_SUBBANDS_1_4,
+    WIND_4_SUBBANDS_2_4,
+    WIND_4_SUBBANDS_3_4,
+    WIND_4_SUBBANDS_4_0,
+    WIND_4_SUBBANDS_3_0,
+    WIND_4_SUBBANDS_2_0,
+    WIND_4_SUBBANDS_1_0,
+};
+
+const int16_t gas16WindowCoeffs8[5 * 16] = {
+    /* s16X[ChOffset + 0 + i] */
+    0,
+    WIND_8_SUBBANDS_1_0,
+    WIND_8_SUBBANDS_2_0,
+    WIND_8_SUBBANDS_3_0,
+    WIND_8_SUBBANDS_4_0,
+    WIND_8_SUBBANDS_5_0,
+    WIND_8_SUBBANDS_6_0,
+    WIND_8_SUBBANDS_7_0,
+    WIND_8_SUBBANDS_8_0,
+    WIND_8_SUBBANDS_7_4,
+    WIND_8_SUBBANDS_6_4,
+    WIND_8_SUBBANDS_5_4,
+    WIND_8_SUBBANDS_4_4,
+    WIND_8_SUBBANDS_3_4,
+    WIND_8_SUBBANDS_2_4,
+    WIND_8_SUBBANDS_1_4,
+    /* s16X[ChOffset + 16 + i] */
+    WIND_8_SUBBANDS_0_1,
+    WIND_8_SUBBANDS_1_1,
+    WIND_8_SUBBANDS_2_1,
+    WIND_8_SUBBANDS_3_1,
+    WIND_8_SUBBANDS_4_1,
+    WIND_8_SUBBANDS_5_1,
+    WIND_8_SUBBANDS_6_1,
+    WIND_8_SUBBANDS_7_1,
+    WIND_8_SUBBANDS_8_1,
+    WIND_8_SUBBANDS_7_3,
+    WIND_8_SUBBANDS_6_3,
+    WIND_8_SUBBANDS_5_3,
+    WIND_8_SUBBANDS_4_3,
+    WIND_8_SUBBANDS_3_3,
+    WIND_8_SUBBANDS_2_3,
+    WIND_8_SUBBANDS_1_3,
+    /* s16X[ChOffset + 32 + i] */
+    WIND_8_SUBBANDS_0_2,
+    WIND_8_SUBBANDS_1_2,
+    WIND_8_SUBBANDS_2_2,
+    WIND_8_SUBBANDS_3_2,
+    WIND_8_SUBBANDS_4_2,
+    WIND_8_SUBBANDS_5_2,
+    WIND_8_SUBBANDS_6_2,
+    WIND_8_SUBBANDS_7_2,
+    WIND_8_SUBBANDS_8_2,
+    WIND_8_SUBBANDS_7_2,
+    WIND_8_SUBBANDS_6_2,
+    WIND_8_SUBBANDS_5_2,
+    WIND_8_SUBBANDS_4_2,
+    WIND_8_SUBBANDS_3_2,
+    WIND_8_SUBBANDS_2_2,
+    WIND_8_SUBBANDS_1_2,
+    /* s16X[ChOffset + 48 + i] */
+    (int16_t)-WIND_8_SUBBANDS_0_2,
+    WIND_8_SUBBANDS_1_3,
+    WIND_8_SUBBANDS_2_3,
+    WIND_8_SUBBANDS_3_3,
+    WIND_8_SUBBANDS_4_3,
+    WIND_8_SUBBANDS_5_3,
+    WIND_8_SUBBANDS_6_3,
+    WIND_8_SUBBANDS_7_3,
+    WIND_8_SUBBANDS_8_1,
+    WIND_8_SUBBANDS_7_1,
+    WIND_8_SUBBANDS_6_1,
+    WIND_8_SUBBANDS_5_1,
+    WIND_8_SUBBANDS_4_1,
+    WIND_8_SUBBANDS_3_1,
+    WIND_8_SUBBANDS_2_1,
+    WIND_8_SUBBANDS_1_1,
+    /* s16X[ChOffset + 64 + i] */
+    (int16_t)-WIND_8_SUBBANDS_0_1,
+    WIND_8_SUBBANDS_1_4,
+    WIND_8_SUBBANDS_2_4,
+    WIND_8_SUBBANDS_3_4,
+    WIND_8_SUBBANDS_4_4,
+    WIND_8_SUBBANDS_5_4,
+    WIND_8_SUBBANDS_6_4,
+    WIND_8_SUBBANDS_7_4,
+    WIND_8_SUBBANDS_8_0,
+    WIND_8_SUBBANDS_7_0,
+    WIND_8_SUBBANDS_6_0,
+    WIND_8_SUBBANDS_5_0,
+    WIND_8_SUBBANDS_4_0,
+    WIND_8_SUBBANDS_3_0,
+    WIND_8_SUBBANDS_2_0,
+    WIND_8_SUBBANDS_1_0,
+};
+#endif
+
 #if (SBC_USE_ARM_PRAGMA == TRUE)
 #pragma arm section zidata = "sbc_s32_analysis_section"
 #endif
@@ -1187,6 +1327,12 @@ static int16_t* s16X =
 
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
+
+static bool bUseSimd = true;
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+static SBC_WINDOW_ACCU_FUNC pfWindowAccu4 = NULL;
+static SBC_WINDOW_ACCU_FUNC pfWindowAccu8 = NULL;
+#endif
 /****************************************************************************
 * SbcAnalysisFilter - performs Analysis of the input audio stream
 *
@@ -1257,7 +1403,12 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_4
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+      if (pfWindowAccu4 != NULL) {
+        pfWindowAccu4(s16X + ChOffset, s32DCTY);
+      } else
+#endif
+        WINDOW_PARTIAL_4
 
       SBC_FastIDCT4(s32DCTY, ps32SbBuf);
 
@@ -1370,7 +1521,12 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_8
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+      if (pfWindowAccu8 != NULL) {
+        pfWindowAccu8(s16X + ChOffset, s32DCTY);
+      } else
+#endif
+        WINDOW_PARTIAL_8
 
       SBC_FastIDCT8(s32DCTY, ps32SbBuf);
 
@@ -1397,4 +1553,10 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
 void SbcAnalysisInit(void) {
   memset(s16X, 0, ENC_VX_BUFFER_SIZE * sizeof(int16_t));
   ShiftCounter = 0;
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+  pfWindowAccu4 = bUseSimd ? SbcGetSimdWindowAccu4() : NULL;
+  pfWindowAccu8 = bUseSimd ? SbcGetSimdWindowAccu8() : NULL;
+#endif
 }
+
+void SBC_Encoder_UseSimd(bool use_simd) { bUseSimd = use_simd; }
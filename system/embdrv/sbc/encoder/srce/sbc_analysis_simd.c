@@ -0,0 +1,190 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  SIMD versions of the windowing of the analysis filter.
+ *
+ *  Every windowing output is the sum of 5 products of a 16 bit coefficient
+ *  and a 16 bit sample. None of the sums can overflow 32 bits, so the kernels
+ *  below compute exactly the values of WINDOW_PARTIAL_4 and WINDOW_PARTIAL_8.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "sbc_enc_func_declare.h"
+#include "sbc_encoder.h"
+
+#if (SBC_SIMD_WINDOW_ACCU_ENABLED == TRUE)
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SBC_WINDOW_ACCU_NEON TRUE
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SBC_WINDOW_ACCU_SSE2 TRUE
+#if defined(__GNUC__) || defined(__clang__)
+#include <immintrin.h>
+#define SBC_WINDOW_ACCU_AVX2 TRUE
+#endif
+#endif
+
+#if (SBC_WINDOW_ACCU_NEON == TRUE)
+/* Computes the 8 outputs starting at lane |s32Lane| of rows |s32Stride|
+ * samples apart. */
+static inline void WindowAccuLanes8Neon(const int16_t* ps16X,
+                                        const int16_t* ps16Coeffs,
+                                        int32_t s32Stride, int32_t s32Lane,
+                                        int32_t* ps32DCTY) {
+  int32x4_t s32x4Lo = vdupq_n_s32(0);
+  int32x4_t s32x4Hi = vdupq_n_s32(0);
+  int32_t s32Row;
+
+  for (s32Row = 0; s32Row < 5; s32Row++) {
+    int16x8_t s16x8X = vld1q_s16(ps16X + s32Row * s32Stride + s32Lane);
+    int16x8_t s16x8C = vld1q_s16(ps16Coeffs + s32Row * s32Stride + s32Lane);
+    s32x4Lo = vmlal_s16(s32x4Lo, vget_low_s16(s16x8X), vget_low_s16(s16x8C));
+    s32x4Hi =
+        vmlal_s16(s32x4Hi, vget_high_s16(s16x8X), vget_high_s16(s16x8C));
+  }
+  vst1q_s32(ps32DCTY + s32Lane, s32x4Lo);
+  vst1q_s32(ps32DCTY + s32Lane + 4, s32x4Hi);
+}
+
+static void WindowAccu4Neon(const int16_t* ps16X, int32_t* ps32DCTY) {
+  WindowAccuLanes8Neon(ps16X, gas16WindowCoeffs4, 8, 0, ps32DCTY);
+}
+
+static void WindowAccu8Neon(const int16_t* ps16X, int32_t* ps32DCTY) {
+  WindowAccuLanes8Neon(ps16X, gas16WindowCoeffs8, 16, 0, ps32DCTY);
+  WindowAccuLanes8Neon(ps16X, gas16WindowCoeffs8, 16, 8, ps32DCTY);
+}
+#endif
+
+#if (SBC_WINDOW_ACCU_SSE2 == TRUE)
+/* Computes the 8 outputs starting at lane |s32Lane| of rows |s32Stride|
+ * samples apart. Rows are interleaved in pairs so that each _mm_madd_epi16
+ * adds two products per output. */
+static inline void WindowAccuLanes8Sse2(const int16_t* ps16X,
+                                        const int16_t* ps16Coeffs,
+                                        int32_t s32Stride, int32_t s32Lane,
+                                        int32_t* ps32DCTY) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i x[5], c[5], lo, hi;
+  int32_t s32Row;
+
+  for (s32Row = 0; s32Row < 5; s32Row++) {
+    x[s32Row] = _mm_loadu_si128(
+        (const __m128i*)(ps16X + s32Row * s32Stride + s32Lane));
+    c[s32Row] = _mm_loadu_si128(
+        (const __m128i*)(ps16Coeffs + s32Row * s32Stride + s32Lane));
+  }
+
+  lo = _mm_madd_epi16(_mm_unpacklo_epi16(x[0], x[1]),
+                      _mm_unpacklo_epi16(c[0], c[1]));
+  hi = _mm_madd_epi16(_mm_unpackhi_epi16(x[0], x[1]),
+                      _mm_unpackhi_epi16(c[0], c[1]));
+  lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x[2], x[3]),
+                                        _mm_unpacklo_epi16(c[2], c[3])));
+  hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x[2], x[3]),
+                                        _mm_unpackhi_epi16(c[2], c[3])));
+  lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x[4], zero),
+                                        _mm_unpacklo_epi16(c[4], zero)));
+  hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x[4], zero),
+                                        _mm_unpackhi_epi16(c[4], zero)));
+
+  _mm_storeu_si128((__m128i*)(ps32DCTY + s32Lane), lo);
+  _mm_storeu_si128((__m128i*)(ps32DCTY + s32Lane + 4), hi);
+}
+
+static void WindowAccu4Sse2(const int16_t* ps16X, int32_t* ps32DCTY) {
+  WindowAccuLanes8Sse2(ps16X, gas16WindowCoeffs4, 8, 0, ps32DCTY);
+}
+
+static void WindowAccu8Sse2(const int16_t* ps16X, int32_t* ps32DCTY) {
+  WindowAccuLanes8Sse2(ps16X, gas16WindowCoeffs8, 16, 0, ps32DCTY);
+  WindowAccuLanes8Sse2(ps16X, gas16WindowCoeffs8, 16, 8, ps32DCTY);
+}
+#endif
+
+#if (SBC_WINDOW_ACCU_AVX2 == TRUE)
+/* Same as WindowAccu8Sse2 with all 16 outputs in flight. The 256 bit unpacks
+ * work within 128 bit halves, so the products come out as outputs {0-3, 8-11}
+ * and {4-7, 12-15} and are permuted back before the store. */
+__attribute__((target("avx2"))) static void WindowAccu8Avx2(
+    const int16_t* ps16X, int32_t* ps32DCTY) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i x[5], c[5], lo, hi;
+  int32_t s32Row;
+
+  for (s32Row = 0; s32Row < 5; s32Row++) {
+    x[s32Row] = _mm256_loadu_si256((const __m256i*)(ps16X + s32Row * 16));
+    c[s32Row] =
+        _mm256_loadu_si256((const __m256i*)(gas16WindowCoeffs8 + s32Row * 16));
+  }
+
+  lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(x[0], x[1]),
+                         _mm256_unpacklo_epi16(c[0], c[1]));
+  hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(x[0], x[1]),
+                         _mm256_unpackhi_epi16(c[0], c[1]));
+  lo = _mm256_add_epi32(lo,
+                        _mm256_madd_epi16(_mm256_unpacklo_epi16(x[2], x[3]),
+                                          _mm256_unpacklo_epi16(c[2], c[3])));
+  hi = _mm256_add_epi32(hi,
+                        _mm256_madd_epi16(_mm256_unpackhi_epi16(x[2], x[3]),
+                                          _mm256_unpackhi_epi16(c[2], c[3])));
+  lo = _mm256_add_epi32(lo,
+                        _mm256_madd_epi16(_mm256_unpacklo_epi16(x[4], zero),
+                                          _mm256_unpacklo_epi16(c[4], zero)));
+  hi = _mm256_add_epi32(hi,
+                        _mm256_madd_epi16(_mm256_unpackhi_epi16(x[4], zero),
+                                          _mm256_unpackhi_epi16(c[4], zero)));
+
+  _mm256_storeu_si256((__m256i*)ps32DCTY,
+                      _mm256_permute2x128_si256(lo, hi, 0x20));
+  _mm256_storeu_si256((__m256i*)(ps32DCTY + 8),
+                      _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+#endif
+
+SBC_WINDOW_ACCU_FUNC SbcGetSimdWindowAccu4(void) {
+#if (SBC_WINDOW_ACCU_NEON == TRUE)
+  return WindowAccu4Neon;
+#elif (SBC_WINDOW_ACCU_SSE2 == TRUE)
+  /* Half of a 256 bit register holds all 8 outputs, AVX2 does not help. */
+  return WindowAccu4Sse2;
+#else
+  return NULL;
+#endif
+}
+
+SBC_WINDOW_ACCU_FUNC SbcGetSimdWindowAccu8(void) {
+#if (SBC_WINDOW_ACCU_NEON == TRUE)
+  return WindowAccu8Neon;
+#elif (SBC_WINDOW_ACCU_SSE2 == TRUE)
+#if (SBC_WINDOW_ACCU_AVX2 == TRUE)
+  if (__builtin_cpu_supports("avx2")) return WindowAccu8Avx2;
+#endif
+  return WindowAccu8Sse2;
+#else
+  return NULL;
+#endif
+}
+
+#endif /* SBC_SIMD_WINDOW_ACCU_ENABLED */
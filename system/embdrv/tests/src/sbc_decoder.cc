@@ -0,0 +1,156 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "sbc_test_util.h"
+
+extern "C" {
+#include "oi_codec_sbc_private.h"
+}
+
+#define NUM_FRAMES 200
+
+namespace {
+
+// Decodes the concatenated SBC frames of |stream| into interleaved PCM.
+std::vector<int16_t> decode(const std::vector<uint8_t>& stream, bool use_simd) {
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  // The decoder does not clear the synthesis buffers it allocates here.
+  uint32_t context_data[CODEC_DATA_WORDS(2, SBC_CODEC_FAST_FILTER_BUFFERS)] =
+      {};
+  OI_STATUS status =
+      OI_CODEC_SBC_DecoderReset(&context, context_data, sizeof(context_data),
+                                2 /* maxChannels */, 2 /* pcmStride */,
+                                FALSE /* enhanced */);
+  EXPECT_EQ(status, OI_OK);
+
+  OI_CODEC_SBC_UseSimd(use_simd ? TRUE : FALSE);
+  std::vector<int16_t> output;
+  const OI_BYTE* data = stream.data();
+  uint32_t remaining = stream.size();
+  int16_t pcm[SBC_MAX_SAMPLES_PER_FRAME * SBC_MAX_CHANNELS];
+  while (remaining > 0) {
+    // Mono frames leave every other sample of the stride 2 output untouched.
+    memset(pcm, 0, sizeof(pcm));
+    uint32_t pcm_bytes = sizeof(pcm);
+    status = OI_CODEC_SBC_DecodeFrame(&context, &data, &remaining, pcm,
+                                      &pcm_bytes);
+    if (status != OI_OK) {
+      ADD_FAILURE() << "OI_CODEC_SBC_DecodeFrame failed: " << status;
+      break;
+    }
+    output.insert(output.end(), pcm, pcm + pcm_bytes / sizeof(int16_t));
+  }
+  OI_CODEC_SBC_UseSimd(TRUE);
+  return output;
+}
+
+struct sbc_golden {
+  sbc_test::sbc_config config;
+  // FNV-1a hash of the PCM decoded by the scalar synthesis filter from the
+  // NUM_FRAMES frames encoded from the test signal.
+  uint32_t hash;
+};
+
+const sbc_golden kGoldens[] = {
+    {{SUB_BANDS_4, SBC_MONO, 128}, 1186442049u},
+    {{SUB_BANDS_4, SBC_DUAL, 256}, 737611064u},
+    {{SUB_BANDS_4, SBC_STEREO, 256}, 2008126142u},
+    {{SUB_BANDS_4, SBC_JOINT_STEREO, 256}, 2954094026u},
+    {{SUB_BANDS_8, SBC_MONO, 198}, 1763901397u},
+    {{SUB_BANDS_8, SBC_DUAL, 345}, 3945917767u},
+    {{SUB_BANDS_8, SBC_STEREO, 328}, 2079279464u},
+    {{SUB_BANDS_8, SBC_JOINT_STEREO, 328}, 3722016808u},
+};
+
+uint32_t pcm_hash(const std::vector<int16_t>& pcm) {
+  return sbc_test::fnv1a(reinterpret_cast<const uint8_t*>(pcm.data()),
+                         pcm.size() * sizeof(int16_t));
+}
+
+class LibSbcDecTest : public ::testing::TestWithParam<sbc_golden> {};
+
+TEST_P(LibSbcDecTest, scalar_matches_golden) {
+  const sbc_golden& golden = GetParam();
+  std::vector<uint8_t> stream =
+      sbc_test::encode(golden.config, NUM_FRAMES, false);
+  std::vector<int16_t> scalar = decode(stream, false);
+  ASSERT_EQ(scalar.size(), NUM_FRAMES * 16 * golden.config.subbands * 2u);
+  EXPECT_EQ(pcm_hash(scalar), golden.hash);
+}
+
+TEST_P(LibSbcDecTest, simd_matches_scalar) {
+  const sbc_golden& golden = GetParam();
+  std::vector<uint8_t> stream =
+      sbc_test::encode(golden.config, NUM_FRAMES, false);
+  std::vector<int16_t> scalar = decode(stream, false);
+  std::vector<int16_t> simd = decode(stream, true);
+  ASSERT_EQ(scalar.size(), simd.size());
+  EXPECT_TRUE(scalar == simd);
+  EXPECT_EQ(pcm_hash(simd), golden.hash);
+}
+
+INSTANTIATE_TEST_SUITE_P(LibSbcDecTestAllModes, LibSbcDecTest,
+                         ::testing::ValuesIn(kGoldens));
+
+// Compares the SIMD window with SynthWindow80_generated on buffers that the
+// decoder would only produce for corrupt streams, including full scale values
+// of both signs in every position.
+TEST(LibSbcDecSynthWindowTest, simd_window_matches_generated) {
+  SYNTH_WINDOW simd = OI_SBC_GetSynthWindow80Simd();
+  if (simd == NULL) GTEST_SKIP() << "No SIMD synthesis window on this CPU";
+
+  uint32_t lcg = 1;
+  for (int iteration = 0; iteration < 4000; iteration++) {
+    SBC_BUFFER_T buffer[80];
+    for (int i = 0; i < 80; i++) {
+      lcg = lcg * 1103515245 + 12345;
+      switch (iteration % 4) {
+        case 0:
+          buffer[i] = static_cast<int16_t>(lcg >> 16);
+          break;
+        case 1:
+          buffer[i] = (lcg >> 31) ? INT16_MAX : INT16_MIN;
+          break;
+        case 2:
+          buffer[i] = static_cast<int16_t>(lcg >> 16) / 64;
+          break;
+        default:
+          buffer[i] = (i == iteration / 4 % 80) ? INT16_MIN : 0;
+          break;
+      }
+    }
+    for (OI_UINT stride_shift = 0; stride_shift <= 1; stride_shift++) {
+      int16_t expected[16] = {};
+      int16_t actual[16] = {};
+      SynthWindow80_generated(expected, buffer, stride_shift);
+      simd(actual, buffer, stride_shift);
+      for (int i = 0; i < 16; i++) {
+        ASSERT_EQ(expected[i], actual[i])
+            << "iteration " << iteration << " stride_shift " << stride_shift
+            << " sample " << i;
+      }
+    }
+  }
+}
+
+}  // namespace
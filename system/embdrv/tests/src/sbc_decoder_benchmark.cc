@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Decoding throughput of the OI SBC decoder with the scalar and the SIMD
+// synthesis window. The 4 subband configurations only exercise the scalar
+// window and serve as a reference for the rest of the decoder.
+
+#include <benchmark/benchmark.h>
+
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "oi_codec_sbc.h"
+#include "sbc_test_util.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kNumFrames = 500;
+
+const sbc_test::sbc_config kConfigs[] = {
+    {SUB_BANDS_4, SBC_MONO, 128},   {SUB_BANDS_4, SBC_JOINT_STEREO, 256},
+    {SUB_BANDS_8, SBC_MONO, 198},   {SUB_BANDS_8, SBC_DUAL, 345},
+    {SUB_BANDS_8, SBC_STEREO, 328}, {SUB_BANDS_8, SBC_JOINT_STEREO, 328},
+};
+
+// state.range(0) indexes |kConfigs|, state.range(1) enables the SIMD window.
+void BM_SbcDecode(State& state) {
+  const sbc_test::sbc_config& config = kConfigs[state.range(0)];
+  std::vector<uint8_t> stream = sbc_test::encode(config, kNumFrames, false);
+
+  OI_CODEC_SBC_DECODER_CONTEXT context;
+  static uint32_t context_data[CODEC_DATA_WORDS(
+      2, SBC_CODEC_FAST_FILTER_BUFFERS)];
+  OI_CODEC_SBC_DecoderReset(&context, context_data, sizeof(context_data), 2, 2,
+                            FALSE);
+  OI_CODEC_SBC_UseSimd(state.range(1) ? TRUE : FALSE);
+
+  int16_t pcm[SBC_MAX_SAMPLES_PER_FRAME * SBC_MAX_CHANNELS];
+  size_t frames = 0;
+  for (auto _ : state) {
+    const OI_BYTE* data = stream.data();
+    uint32_t remaining = stream.size();
+    while (remaining > 0) {
+      uint32_t pcm_bytes = sizeof(pcm);
+      if (OI_CODEC_SBC_DecodeFrame(&context, &data, &remaining, pcm,
+                                   &pcm_bytes) != OI_OK) {
+        state.SkipWithError("OI_CODEC_SBC_DecodeFrame failed");
+        break;
+      }
+      frames++;
+    }
+    benchmark::DoNotOptimize(pcm);
+  }
+  OI_CODEC_SBC_UseSimd(TRUE);
+
+  state.counters["frames"] =
+      benchmark::Counter(frames, benchmark::Counter::kIsRate);
+  state.SetLabel(std::string(config.subbands == SUB_BANDS_8 ? "8" : "4") +
+                 " subbands, mode " + std::to_string(config.channel_mode) +
+                 (state.range(1) ? ", simd" : ", scalar"));
+}
+
+BENCHMARK(BM_SbcDecode)
+    ->ArgsProduct({benchmark::CreateDenseRange(
+                       0, std::size(kConfigs) - 1, 1),
+                   {0, 1}});
+
+}  // namespace
+
+BENCHMARK_MAIN();
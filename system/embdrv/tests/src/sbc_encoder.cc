@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sbc_encoder.h"
+
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "sbc_test_util.h"
+
+#define NUM_FRAMES 200
+
+struct sbc_golden {
+  sbc_test::sbc_config config;
+  // FNV-1a hash of the NUM_FRAMES frames encoded by the scalar analysis
+  // filter from the test signal.
+  uint32_t hash;
+};
+
+static const sbc_golden kGoldens[] = {
+    {{SUB_BANDS_4, SBC_MONO, 128}, 3788775788u},
+    {{SUB_BANDS_4, SBC_DUAL, 256}, 4291659471u},
+    {{SUB_BANDS_4, SBC_STEREO, 256}, 2518139098u},
+    {{SUB_BANDS_4, SBC_JOINT_STEREO, 256}, 938761586u},
+    {{SUB_BANDS_8, SBC_MONO, 198}, 3195633405u},
+    {{SUB_BANDS_8, SBC_DUAL, 345}, 1494121273u},
+    {{SUB_BANDS_8, SBC_STEREO, 328}, 3401325456u},
+    {{SUB_BANDS_8, SBC_JOINT_STEREO, 328}, 2859148158u},
+};
+
+class LibSbcEncTest : public ::testing::TestWithParam<sbc_golden> {};
+
+TEST_P(LibSbcEncTest, scalar_matches_golden) {
+  const sbc_golden& golden = GetParam();
+  std::vector<uint8_t> scalar =
+      sbc_test::encode(golden.config, NUM_FRAMES, false);
+  ASSERT_FALSE(scalar.empty());
+  EXPECT_EQ(sbc_test::fnv1a(scalar.data(), scalar.size()), golden.hash);
+}
+
+TEST_P(LibSbcEncTest, simd_matches_scalar) {
+  const sbc_golden& golden = GetParam();
+  std::vector<uint8_t> scalar =
+      sbc_test::encode(golden.config, NUM_FRAMES, false);
+  std::vector<uint8_t> simd = sbc_test::encode(golden.config, NUM_FRAMES, true);
+  ASSERT_EQ(scalar.size(), simd.size());
+  EXPECT_TRUE(scalar == simd);
+  EXPECT_EQ(sbc_test::fnv1a(simd.data(), simd.size()), golden.hash);
+}
+
+INSTANTIATE_TEST_SUITE_P(LibSbcEncTestAllModes, LibSbcEncTest,
+                         ::testing::ValuesIn(kGoldens));
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "sbc_encoder.h"
+
+namespace sbc_test {
+
+struct sbc_config {
+  int16_t subbands;
+  int16_t channel_mode;
+  uint16_t bit_rate;
+};
+
+inline int32_t triangle(size_t i, size_t period, int32_t amplitude) {
+  int32_t phase = static_cast<int32_t>(i % period);
+  int32_t half = static_cast<int32_t>(period / 2);
+  int32_t ramp = phase < half ? phase : static_cast<int32_t>(period) - phase;
+  return amplitude * (2 * ramp - half) / (half > 0 ? half : 1);
+}
+
+// Two triangle waves and pseudo random noise, clipped at full scale so that
+// the filterbanks see the extreme sample values. Integer only, so that golden
+// hashes do not depend on the math library.
+inline std::vector<int16_t> make_signal(size_t samples, size_t channels) {
+  std::vector<int16_t> pcm(samples * channels);
+  uint32_t lcg = 12345;
+  for (size_t i = 0; i < samples; i++) {
+    for (size_t ch = 0; ch < channels; ch++) {
+      lcg = lcg * 1103515245 + 12345;
+      int32_t v = triangle(i, 100 + 37 * ch, 20000) + triangle(i, 7, 12000) +
+                  static_cast<int16_t>(lcg >> 16) / 4;
+      if (v > INT16_MAX) v = INT16_MAX;
+      if (v < INT16_MIN) v = INT16_MIN;
+      pcm[i * channels + ch] = static_cast<int16_t>(v);
+    }
+  }
+  return pcm;
+}
+
+inline size_t num_channels(const sbc_config& config) {
+  return config.channel_mode == SBC_MONO ? 1 : 2;
+}
+
+// Encodes |num_frames| frames of 16 blocks of the test signal at 44.1 kHz and
+// returns the concatenated frames.
+inline std::vector<uint8_t> encode(const sbc_config& config, size_t num_frames,
+                                   bool use_simd) {
+  SBC_ENC_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.s16SamplingFreq = SBC_sf44100;
+  params.s16ChannelMode = config.channel_mode;
+  params.s16NumOfSubBands = config.subbands;
+  params.s16NumOfChannels = num_channels(config);
+  params.s16NumOfBlocks = 16;
+  params.s16AllocationMethod = SBC_LOUDNESS;
+  params.u16BitRate = config.bit_rate;
+  params.Format = SBC_FORMAT_GENERAL;
+
+  SBC_Encoder_UseSimd(use_simd);
+  SBC_Encoder_Init(&params);
+
+  size_t frame_samples = params.s16NumOfBlocks * params.s16NumOfSubBands;
+  std::vector<int16_t> pcm =
+      make_signal(num_frames * frame_samples, params.s16NumOfChannels);
+  std::vector<uint8_t> output;
+  uint8_t frame[1024];
+  for (size_t i = 0; i < num_frames; i++) {
+    uint32_t length = SBC_Encode(
+        &params, &pcm[i * frame_samples * params.s16NumOfChannels], frame);
+    output.insert(output.end(), frame, frame + length);
+  }
+  SBC_Encoder_UseSimd(true);
+  return output;
+}
+
+inline uint32_t fnv1a(const uint8_t* data, size_t size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 16777619u;
+  return hash;
+}
+
+}  // namespace sbc_test
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <bluetooth/log.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// Statistics of the tasks run by a thread: how long they waited in the queue,
+// how long they ran, and where the slowest ones were posted from.
+//
+// Record() is called by the thread running the tasks, the other methods can be
+// called from any thread. A task running longer than the slow task threshold
+// is logged as soon as it returns.
+class TaskStats {
+ public:
+  // System property enabling the statistics of the stack threads: the run
+  // duration in milliseconds from which a task is logged as slow. The
+  // statistics are disabled when it is zero or unset.
+  static constexpr char kSlowTaskThresholdProperty[] = "bluetooth.os.task_stats.slow_task_threshold_ms";
+
+  // Where a task was posted from. The strings must outlive the statistics,
+  // e.g. the ones of base::Location.
+  struct Location {
+    const char* function_name = nullptr;
+    const char* file_name = nullptr;
+    int line_number = 0;
+
+    bool operator==(const Location& other) const {
+      return function_name == other.function_name && file_name == other.file_name &&
+             line_number == other.line_number;
+    }
+  };
+
+  // Durations in power of two buckets of microseconds: [0, 1us), [1us, 2us),
+  // [2us, 4us)... the last one also takes all the longer durations.
+  struct Histogram {
+    static constexpr size_t kNumBuckets = 24;
+
+    std::array<uint32_t, kNumBuckets> buckets = {};
+    uint64_t count = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+
+    void Add(uint64_t duration_us) {
+      size_t bucket = 0;
+      for (uint64_t value = duration_us; value != 0 && bucket < kNumBuckets - 1; value >>= 1) {
+        bucket++;
+      }
+      buckets[bucket]++;
+      count++;
+      total_us += duration_us;
+      max_us = std::max(max_us, duration_us);
+    }
+
+    // Upper bound of the bucket holding the given percentile
+    uint64_t Percentile(unsigned percent) const {
+      uint64_t rank = (count * percent + 99) / 100;
+      uint64_t seen = 0;
+      for (size_t i = 0; i < kNumBuckets; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+          return std::min(uint64_t{1} << i, max_us);
+        }
+      }
+      return max_us;
+    }
+  };
+
+  struct SlowTask {
+    Location location;
+    uint64_t max_run_us = 0;
+    uint64_t count = 0;
+  };
+
+  static constexpr size_t kMaxSlowestLocations = 10;
+
+  TaskStats(const std::string& name, std::chrono::milliseconds slow_task_threshold)
+      : name_(name), slow_task_threshold_us_(std::chrono::microseconds(slow_task_threshold).count()) {}
+  TaskStats(const TaskStats&) = delete;
+  TaskStats& operator=(const TaskStats&) = delete;
+
+  // Records a task which waited |queue_latency| past its scheduled time, then
+  // ran for |run_duration|
+  void Record(
+      const Location& location,
+      std::chrono::microseconds queue_latency,
+      std::chrono::microseconds run_duration) {
+    uint64_t queue_latency_us = std::max<int64_t>(queue_latency.count(), 0);
+    uint64_t run_us = std::max<int64_t>(run_duration.count(), 0);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_latency_.Add(queue_latency_us);
+      run_duration_.Add(run_us);
+      RecordSlowest(location, run_us);
+    }
+
+    if (run_us >= slow_task_threshold_us_) {
+      log::warn(
+          "{}: task posted from {}({}:{}) ran for {} ms, waited {} ms",
+          name_,
+          location.function_name != nullptr ? location.function_name : "unknown",
+          location.file_name != nullptr ? location.file_name : "unknown",
+          location.line_number,
+          run_us / 1000,
+          queue_latency_us / 1000);
+    }
+  }
+
+  Histogram GetQueueLatency() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_latency_;
+  }
+
+  Histogram GetRunDuration() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return run_duration_;
+  }
+
+  // The locations of the slowest tasks, slowest first
+  std::vector<SlowTask> GetSlowestLocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SlowTask> slowest(slowest_.begin(), slowest_.end());
+    std::sort(slowest.begin(), slowest.end(), [](const SlowTask& a, const SlowTask& b) {
+      return a.max_run_us > b.max_run_us;
+    });
+    return slowest;
+  }
+
+  void Dump(int fd) const {
+    Histogram queue_latency = GetQueueLatency();
+    Histogram run_duration = GetRunDuration();
+    dprintf(fd, "  %s tasks: %" PRIu64 "\n", name_.c_str(), run_duration.count);
+    DumpHistogram(fd, "Queue latency", queue_latency);
+    DumpHistogram(fd, "Run duration", run_duration);
+    dprintf(fd, "    Slowest tasks:\n");
+    for (const auto& slow_task : GetSlowestLocations()) {
+      dprintf(
+          fd,
+          "      %8" PRIu64 " us x%" PRIu64 " %s(%s:%d)\n",
+          slow_task.max_run_us,
+          slow_task.count,
+          slow_task.location.function_name != nullptr ? slow_task.location.function_name : "unknown",
+          slow_task.location.file_name != nullptr ? slow_task.location.file_name : "unknown",
+          slow_task.location.line_number);
+    }
+  }
+
+ private:
+  // Keeps the slowest run of the slowest locations, |count| being the number
+  // of their runs which made it into the list
+  void RecordSlowest(const Location& location, uint64_t run_us) {
+    if (slowest_.size() == kMaxSlowestLocations && run_us <= fastest_of_slowest_us_) {
+      return;
+    }
+
+    auto slow_task = std::find_if(slowest_.begin(), slowest_.end(), [&location](const SlowTask& task) {
+      return task.location == location;
+    });
+    if (slow_task != slowest_.end()) {
+      slow_task->max_run_us = std::max(slow_task->max_run_us, run_us);
+      slow_task->count++;
+    } else if (slowest_.size() < kMaxSlowestLocations) {
+      slowest_.push_back({location, run_us, 1});
+    } else {
+      auto fastest = std::min_element(slowest_.begin(), slowest_.end(), [](const SlowTask& a, const SlowTask& b) {
+        return a.max_run_us < b.max_run_us;
+      });
+      *fastest = {location, run_us, 1};
+    }
+
+    if (slowest_.size() == kMaxSlowestLocations) {
+      fastest_of_slowest_us_ =
+          std::min_element(slowest_.begin(), slowest_.end(), [](const SlowTask& a, const SlowTask& b) {
+            return a.max_run_us < b.max_run_us;
+          })->max_run_us;
+    }
+  }
+
+  static void DumpHistogram(int fd, const char* label, const Histogram& histogram) {
+    uint64_t mean_us = histogram.count != 0 ? histogram.total_us / histogram.count : 0;
+    dprintf(
+        fd,
+        "    %s: mean %" PRIu64 " us, p50 < %" PRIu64 " us, p90 < %" PRIu64 " us, p99 < %" PRIu64
+        " us, max %" PRIu64 " us\n",
+        label,
+        mean_us,
+        histogram.Percentile(50),
+        histogram.Percentile(90),
+        histogram.Percentile(99),
+        histogram.max_us);
+  }
+
+  const std::string name_;
+  const uint64_t slow_task_threshold_us_;
+  mutable std::mutex mutex_;
+  Histogram queue_latency_;
+  Histogram run_duration_;
+  std::vector<SlowTask> slowest_;
+  uint64_t fastest_of_slowest_us_ = 0;
+};
+
+}  // namespace common
+}  // namespace bluetooth
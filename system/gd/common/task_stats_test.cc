@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/task_stats.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace testing {
+
+using bluetooth::common::TaskStats;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+TEST(TaskStatsTest, histograms) {
+  TaskStats stats("test", milliseconds(100));
+  TaskStats::Location location{"function", "file.cc", 1};
+
+  stats.Record(location, microseconds(0), microseconds(3));
+  stats.Record(location, microseconds(10), microseconds(100));
+  stats.Record(location, microseconds(-5), microseconds(1000));
+
+  auto queue_latency = stats.GetQueueLatency();
+  ASSERT_EQ(3u, queue_latency.count);
+  ASSERT_EQ(10u, queue_latency.max_us);
+  ASSERT_EQ(2u, queue_latency.buckets[0]);
+  ASSERT_EQ(1u, queue_latency.buckets[4]);
+
+  auto run_duration = stats.GetRunDuration();
+  ASSERT_EQ(3u, run_duration.count);
+  ASSERT_EQ(1103u, run_duration.total_us);
+  ASSERT_EQ(1000u, run_duration.max_us);
+  ASSERT_EQ(1u, run_duration.buckets[2]);
+  ASSERT_EQ(1u, run_duration.buckets[7]);
+  ASSERT_EQ(1u, run_duration.buckets[10]);
+  ASSERT_EQ(4u, run_duration.Percentile(30));
+  ASSERT_EQ(1000u, run_duration.Percentile(99));
+}
+
+TEST(TaskStatsTest, long_duration_in_last_bucket) {
+  TaskStats stats("test", milliseconds(100));
+
+  stats.Record({}, microseconds(0), std::chrono::hours(1));
+
+  auto run_duration = stats.GetRunDuration();
+  ASSERT_EQ(1u, run_duration.buckets[TaskStats::Histogram::kNumBuckets - 1]);
+}
+
+TEST(TaskStatsTest, slowest_locations) {
+  TaskStats stats("test", milliseconds(100));
+  const char* file = "file.cc";
+
+  for (int line = 0; line < 20; line++) {
+    stats.Record({"function", file, line}, microseconds(0), microseconds(line * 10));
+  }
+  stats.Record({"function", file, 15}, microseconds(0), microseconds(1000));
+  stats.Record({"function", file, 0}, microseconds(0), microseconds(5));
+
+  auto slowest = stats.GetSlowestLocations();
+  ASSERT_EQ(TaskStats::kMaxSlowestLocations, slowest.size());
+  ASSERT_EQ(15, slowest[0].location.line_number);
+  ASSERT_EQ(1000u, slowest[0].max_run_us);
+  ASSERT_EQ(2u, slowest[0].count);
+  ASSERT_EQ(19, slowest[1].location.line_number);
+  ASSERT_EQ(10, slowest.back().location.line_number);
+}
+
+}  // namespace testing
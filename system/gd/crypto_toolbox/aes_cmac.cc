@@ -28,6 +28,7 @@
 #include <cstdint>
 
 #include "aes.h"
+#include "aes_hw.h"
 #include "crypto_toolbox.h"
 #include "hci/octets.h"
 
@@ -60,23 +61,46 @@ static void xor_128(Octet16* a, const Octet16& b) {
     aa[i] = aa[i] ^ bb[i];
   }
 }
-}  // namespace
 
-/* This function computes AES_128(key, message) */
-Octet16 aes_128(const Octet16& key, const Octet16& message) {
-  Octet16 key_reversed;
-  Octet16 message_reversed;
-  Octet16 output;
+/* AES-128 with an expanded key, using the AES instructions of the CPU when
+ * it has them. Keys and blocks are in little endian order. */
+class Aes128 {
+ public:
+  explicit Aes128(const Octet16& key) : use_hw_(aes_hw_is_supported()) {
+    Octet16 key_reversed;
+    std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
+    if (use_hw_) {
+      aes_hw_set_key(key_reversed.data(), &hw_ctx_);
+    } else {
+      aes_set_key(key_reversed.data(), key_reversed.size(), &ctx_);
+    }
+  }
 
-  std::reverse_copy(key.begin(), key.end(), key_reversed.begin());
-  std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
+  Octet16 Encrypt(const Octet16& message) const {
+    Octet16 message_reversed;
+    Octet16 output;
+    std::reverse_copy(message.begin(), message.end(), message_reversed.begin());
+    if (use_hw_) {
+      aes_hw_encrypt(message_reversed.data(), output.data(), hw_ctx_);
+    } else {
+      aes_encrypt(message_reversed.data(), output.data(), &ctx_);
+    }
+    std::reverse(output.begin(), output.end());
+    return output;
+  }
 
-  aes_context ctx;
-  aes_set_key(key_reversed.data(), key_reversed.size(), &ctx);
-  aes_encrypt(message_reversed.data(), output.data(), &ctx);
+ private:
+  bool use_hw_;
+  union {
+    aes_context ctx_;
+    aes_hw_context hw_ctx_;
+  };
+};
+}  // namespace
 
-  std::reverse(output.begin(), output.end());
-  return output;
+/* This function computes AES_128(key, message) */
+Octet16 aes_128(const Octet16& key, const Octet16& message) {
+  return Aes128(key).Encrypt(message);
 }
 
 /** utility function to padding the given text to be a 128 bits data. The
@@ -101,7 +125,7 @@ static void leftshift_onebit(uint8_t* input, uint8_t* output) {
 }
 
 /** This function is the calculation of block cipher using AES-128. */
-static Octet16 cmac_aes_k_calculate(const Octet16& key) {
+static Octet16 cmac_aes_k_calculate(const Aes128& aes) {
   Octet16 output;
   Octet16 x{0};  // zero initialized
 
@@ -110,7 +134,7 @@ static Octet16 cmac_aes_k_calculate(const Octet16& key) {
     /* Mi' := Mi (+) X  */
     xor_128((Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length], x);
 
-    output = aes_128(key, *(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length]);
+    output = aes.Encrypt(*(Octet16*)&cmac_cb.text[(cmac_cb.round - i) * kOctet16Length]);
     x = output;
     i++;
   }
@@ -139,11 +163,11 @@ static void cmac_prepare_last_block(const Octet16& k1, const Octet16& k2) {
 }
 
 /** This is the function to generate the two subkeys.
- * |key| is CMAC key, expect SRK when used by SMP.
+ * |aes| is keyed with the CMAC key, expect SRK when used by SMP.
  */
-static void cmac_generate_subkey(const Octet16& key) {
+static void cmac_generate_subkey(const Aes128& aes) {
   Octet16 zero{};
-  Octet16 p = aes_128(key, zero);
+  Octet16 p = aes.Encrypt(zero);
 
   Octet16 k1, k2;
   uint8_t* pp = p.data();
@@ -196,10 +220,13 @@ Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
     cmac_cb.len = 0;
   }
 
+  /* the key is expanded once for all the blocks */
+  Aes128 aes(key);
+
   /* prepare calculation for subkey s and last block of data */
-  cmac_generate_subkey(key);
+  cmac_generate_subkey(aes);
   /* start calculation */
-  Octet16 signature = cmac_aes_k_calculate(key);
+  Octet16 signature = cmac_aes_k_calculate(aes);
 
   /* clean up */
   memset(&cmac_cb, 0, sizeof(tCMAC_CB));
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "crypto_toolbox/aes_hw.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AES_HW_X86 1
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__linux__)
+#define AES_HW_ARM64 1
+#include <arm_neon.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace crypto_toolbox {
+
+#if defined(AES_HW_X86)
+
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+
+bool aes_hw_is_supported() {
+  static const bool supported = __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+  return supported;
+}
+
+// One step of the key expansion, |assist| is aeskeygenassist of the previous round key.
+AES_HW_TARGET static __m128i expand_round_key(__m128i key, __m128i assist) {
+  assist = _mm_shuffle_epi32(assist, 0xff);
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+
+AES_HW_TARGET void aes_hw_set_key(const uint8_t key[16], aes_hw_context* ctx) {
+  __m128i* round_keys = reinterpret_cast<__m128i*>(ctx->round_keys);
+  __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+  round_keys[0] = k;
+  // The round constant is an immediate operand of aeskeygenassist.
+  round_keys[1] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x01));
+  round_keys[2] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x02));
+  round_keys[3] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x04));
+  round_keys[4] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x08));
+  round_keys[5] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x10));
+  round_keys[6] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x20));
+  round_keys[7] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x40));
+  round_keys[8] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x80));
+  round_keys[9] = k = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x1b));
+  round_keys[10] = expand_round_key(k, _mm_aeskeygenassist_si128(k, 0x36));
+}
+
+AES_HW_TARGET void aes_hw_encrypt(const uint8_t in[16], uint8_t out[16], const aes_hw_context& ctx) {
+  const __m128i* round_keys = reinterpret_cast<const __m128i*>(ctx.round_keys);
+  __m128i state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  state = _mm_xor_si128(state, round_keys[0]);
+  for (int round = 1; round < kAesHwRounds; round++) {
+    state = _mm_aesenc_si128(state, round_keys[round]);
+  }
+  state = _mm_aesenclast_si128(state, round_keys[kAesHwRounds]);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), state);
+}
+
+#elif defined(AES_HW_ARM64)
+
+#if defined(__clang__)
+#define AES_HW_TARGET __attribute__((target("aes")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
+bool aes_hw_is_supported() {
+  static const bool supported = (getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+  return supported;
+}
+
+// SubWord of the key expansion. AESE with a zero round key applies ShiftRows and SubBytes, ShiftRows
+// has no effect when the four columns of the state are the same word.
+AES_HW_TARGET static uint32_t sub_word(uint32_t word) {
+  uint8x16_t state = vreinterpretq_u8_u32(vdupq_n_u32(word));
+  state = vaeseq_u8(state, vdupq_n_u8(0));
+  return vgetq_lane_u32(vreinterpretq_u32_u8(state), 0);
+}
+
+AES_HW_TARGET void aes_hw_set_key(const uint8_t key[16], aes_hw_context* ctx) {
+  static constexpr uint8_t kRoundConstants[kAesHwRounds] = {0x01, 0x02, 0x04, 0x08, 0x10,
+                                                            0x20, 0x40, 0x80, 0x1b, 0x36};
+  uint32_t words[4 * (kAesHwRounds + 1)];
+  for (int i = 0; i < 4; i++) {
+    words[i] = key[4 * i] | (key[4 * i + 1] << 8) | (key[4 * i + 2] << 16) |
+               (static_cast<uint32_t>(key[4 * i + 3]) << 24);
+  }
+  for (int i = 4; i < 4 * (kAesHwRounds + 1); i++) {
+    uint32_t temp = words[i - 1];
+    if (i % 4 == 0) {
+      // RotWord on the little endian words is a rotation to the right.
+      temp = sub_word((temp >> 8) | (temp << 24)) ^ kRoundConstants[i / 4 - 1];
+    }
+    words[i] = words[i - 4] ^ temp;
+  }
+  for (int round = 0; round <= kAesHwRounds; round++) {
+    vst1q_u8(ctx->round_keys[round], vreinterpretq_u8_u32(vld1q_u32(&words[4 * round])));
+  }
+}
+
+AES_HW_TARGET void aes_hw_encrypt(const uint8_t in[16], uint8_t out[16], const aes_hw_context& ctx) {
+  uint8x16_t state = vld1q_u8(in);
+  for (int round = 0; round < kAesHwRounds - 1; round++) {
+    state = vaesmcq_u8(vaeseq_u8(state, vld1q_u8(ctx.round_keys[round])));
+  }
+  state = vaeseq_u8(state, vld1q_u8(ctx.round_keys[kAesHwRounds - 1]));
+  state = veorq_u8(state, vld1q_u8(ctx.round_keys[kAesHwRounds]));
+  vst1q_u8(out, state);
+}
+
+#else
+
+bool aes_hw_is_supported() {
+  return false;
+}
+
+void aes_hw_set_key(const uint8_t* /* key */, aes_hw_context* /* ctx */) {}
+
+void aes_hw_encrypt(const uint8_t* /* in */, uint8_t* /* out */, const aes_hw_context& /* ctx */) {}
+
+#endif
+
+}  // namespace crypto_toolbox
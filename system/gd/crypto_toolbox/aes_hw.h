@@ -0,0 +1,41 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace crypto_toolbox {
+
+// AES-128 encryption with the AES instructions of the CPU, AES-NI on x86 and the ARMv8 Cryptographic
+// Extension on arm64. Unlike the table based implementation in aes.cc, it runs in constant time.
+//
+// Keys and blocks are in the byte order of FIPS-197, as for aes_set_key() and aes_encrypt().
+
+constexpr int kAesHwRounds = 10;
+
+struct aes_hw_context {
+  alignas(16) uint8_t round_keys[kAesHwRounds + 1][16];
+};
+
+// Returns true if the CPU has the AES instructions, the other functions must not be called otherwise.
+bool aes_hw_is_supported();
+
+void aes_hw_set_key(const uint8_t key[16], aes_hw_context* ctx);
+
+void aes_hw_encrypt(const uint8_t in[16], uint8_t out[16], const aes_hw_context& ctx);
+
+}  // namespace crypto_toolbox
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "crypto_toolbox/aes.h"
+#include "crypto_toolbox/aes_hw.h"
 #include "hci/octets.h"
 
 namespace crypto_toolbox {
@@ -52,6 +53,34 @@ TEST(CryptoToolboxTest, bt_spec_test_d_1_test) {
   // log::info("output {}", base::HexEncode(output, OCTET16_LEN));
 }
 
+// The AES instructions must give the same results as the software implementation
+TEST(CryptoToolboxTest, aes_hw_matches_aes_test) {
+  if (!aes_hw_is_supported()) {
+    GTEST_SKIP() << "No AES instructions on this CPU";
+  }
+
+  uint8_t k[] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  uint8_t m[16] = {0};
+  for (int i = 0; i < 64; i++) {
+    aes_context ctx;
+    aes_hw_context hw_ctx;
+    aes_set_key(k, sizeof(k), &ctx);
+    aes_hw_set_key(k, &hw_ctx);
+
+    uint8_t output[16];
+    uint8_t hw_output[16];
+    aes_encrypt(m, output, &ctx);
+    aes_hw_encrypt(m, hw_output, hw_ctx);
+    ASSERT_EQ(0, memcmp(output, hw_output, sizeof(output)));
+
+    // Chain the outputs into the next key and message
+    for (size_t j = 0; j < sizeof(k); j++) {
+      k[j] ^= output[j];
+      m[j] = output[(j + i) % sizeof(output)];
+    }
+  }
+}
+
 // BT Spec 5.0 | Vol 3, Part H D.1.1
 TEST(CryptoToolboxTest, bt_spec_example_d_1_1_test) {
   Octet16 k{0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
@@ -20,14 +20,99 @@
 #include <android/binder_manager.h>
 #include <bluetooth/log.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+
 #include "common/stop_watch.h"
 #include "hal/hci_backend.h"
 
 namespace bluetooth::hal {
 
+// Counts the binder transactions with the HAL, one per packet, and logs
+// their rate per packet type at most every |kReportInterval|.
+class AidlTransactionCounters {
+ public:
+  enum Type : size_t {
+    COMMAND,
+    EVENT,
+    ACL_OUT,
+    ACL_IN,
+    SCO_OUT,
+    SCO_IN,
+    ISO_OUT,
+    ISO_IN,
+    NUM_TYPES,
+  };
+
+  AidlTransactionCounters() : last_report_ms_(NowMs()) {}
+
+  ~AidlTransactionCounters() {
+    Report(NowMs() - last_report_ms_.load(std::memory_order_relaxed));
+  }
+
+  // Called from the binder threads for the received packets, and from the
+  // HCI thread for the sent packets.
+  void Count(Type type) {
+    counts_[type].fetch_add(1, std::memory_order_relaxed);
+
+    int64_t now_ms = NowMs();
+    int64_t last_report_ms = last_report_ms_.load(std::memory_order_relaxed);
+    if (now_ms - last_report_ms < kReportInterval.count()) {
+      return;
+    }
+    // Only the thread moving the report time forward reports.
+    if (last_report_ms_.compare_exchange_strong(
+            last_report_ms, now_ms, std::memory_order_relaxed)) {
+      Report(now_ms - last_report_ms);
+    }
+  }
+
+ private:
+  static constexpr std::chrono::milliseconds kReportInterval = std::chrono::seconds(30);
+
+  static int64_t NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void Report(int64_t elapsed_ms) {
+    std::array<uint64_t, NUM_TYPES> counts;
+    uint64_t total = 0;
+    for (size_t type = 0; type < NUM_TYPES; type++) {
+      counts[type] = counts_[type].exchange(0, std::memory_order_relaxed);
+      total += counts[type];
+    }
+    if (total == 0 || elapsed_ms <= 0) {
+      return;
+    }
+    auto rate = [elapsed_ms](uint64_t count) { return count * 1000 / elapsed_ms; };
+    log::info(
+        "HAL transactions/s over {} ms: total {}, cmd {}, evt {}, acl out {} in {}, sco out {} in "
+        "{}, iso out {} in {}",
+        elapsed_ms,
+        rate(total),
+        rate(counts[COMMAND]),
+        rate(counts[EVENT]),
+        rate(counts[ACL_OUT]),
+        rate(counts[ACL_IN]),
+        rate(counts[SCO_OUT]),
+        rate(counts[SCO_IN]),
+        rate(counts[ISO_OUT]),
+        rate(counts[ISO_IN]));
+  }
+
+  std::array<std::atomic<uint64_t>, NUM_TYPES> counts_{};
+  std::atomic<int64_t> last_report_ms_;
+};
+
 class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoothHciCallbacks {
  public:
-  AidlHciCallbacks(std::shared_ptr<HciBackendCallbacks> callbacks) : callbacks_(callbacks) {}
+  AidlHciCallbacks(
+      std::shared_ptr<HciBackendCallbacks> callbacks,
+      std::shared_ptr<AidlTransactionCounters> counters)
+      : callbacks_(callbacks), counters_(counters) {}
 
   using AidlStatus = ::aidl::android::hardware::bluetooth::Status;
   ::ndk::ScopedAStatus initializationComplete(AidlStatus status) override {
@@ -37,27 +122,32 @@ class AidlHciCallbacks : public ::aidl::android::hardware::bluetooth::BnBluetoot
   }
 
   ::ndk::ScopedAStatus hciEventReceived(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::EVENT);
     callbacks_->hciEventReceived(packet);
     return ::ndk::ScopedAStatus::ok();
   }
 
   ::ndk::ScopedAStatus aclDataReceived(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::ACL_IN);
     callbacks_->aclDataReceived(packet);
     return ::ndk::ScopedAStatus::ok();
   }
 
   ::ndk::ScopedAStatus scoDataReceived(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::SCO_IN);
     callbacks_->scoDataReceived(packet);
     return ::ndk::ScopedAStatus::ok();
   }
 
   ::ndk::ScopedAStatus isoDataReceived(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::ISO_IN);
     callbacks_->isoDataReceived(packet);
     return ::ndk::ScopedAStatus::ok();
   }
 
  private:
   std::shared_ptr<HciBackendCallbacks> callbacks_;
+  std::shared_ptr<AidlTransactionCounters> counters_;
 };
 
 class AidlHci : public HciBackend {
@@ -94,23 +184,27 @@ class AidlHci : public HciBackend {
   }
 
   void initialize(std::shared_ptr<HciBackendCallbacks> callbacks) {
-    hci_callbacks_ = ::ndk::SharedRefBase::make<AidlHciCallbacks>(callbacks);
+    hci_callbacks_ = ::ndk::SharedRefBase::make<AidlHciCallbacks>(callbacks, counters_);
     hci_->initialize(hci_callbacks_);
   }
 
   void sendHciCommand(const std::vector<uint8_t>& command) override {
+    counters_->Count(AidlTransactionCounters::COMMAND);
     hci_->sendHciCommand(command);
   }
 
   void sendAclData(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::ACL_OUT);
     hci_->sendAclData(packet);
   }
 
   void sendScoData(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::SCO_OUT);
     hci_->sendScoData(packet);
   }
 
   void sendIsoData(const std::vector<uint8_t>& packet) override {
+    counters_->Count(AidlTransactionCounters::ISO_OUT);
     hci_->sendIsoData(packet);
   }
 
@@ -118,6 +212,8 @@ class AidlHci : public HciBackend {
   ::ndk::ScopedAIBinder_DeathRecipient death_recipient_;
   std::shared_ptr<aidl::android::hardware::bluetooth::IBluetoothHci> hci_;
   std::shared_ptr<AidlHciCallbacks> hci_callbacks_;
+  std::shared_ptr<AidlTransactionCounters> counters_ =
+      std::make_shared<AidlTransactionCounters>();
 };
 
 std::shared_ptr<HciBackend> HciBackend::CreateAidl() {
@@ -22,8 +22,11 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <csignal>
 #include <mutex>
@@ -37,6 +40,7 @@
 #include "metrics/counter_metrics.h"
 #include "os/log.h"
 #include "os/reactor.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 
 namespace {
@@ -55,6 +59,10 @@ constexpr uint8_t kHciEvtHeaderSize = 2;
 constexpr uint8_t kHciIsoHeaderSize = 4;
 constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
 
+// Maximum number of packets moved per sendmmsg()/recvmmsg() in batched mode.
+constexpr size_t kMaxBatchSize = 16;
+constexpr char kBatchedTransportProperty[] = "bluetooth.hci.batched_transport.enabled";
+
 constexpr uint8_t BTPROTO_HCI = 1;
 constexpr uint16_t HCI_CHANNEL_USER = 1;
 constexpr uint16_t HCI_CHANNEL_CONTROL = 3;
@@ -313,7 +321,8 @@ class HciHalHost : public HciHal {
     hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_ONLY);
     link_clocker_ = GetDependency<LinkClocker>();
     btsnoop_logger_ = GetDependency<SnoopLogger>();
-    log::info("HAL opened successfully");
+    batched_transport_ = os::GetSystemPropertyBool(kBatchedTransportProperty, false);
+    log::info("HAL opened successfully, batched transport {}", batched_transport_);
   }
 
   void Stop() override {
@@ -353,6 +362,10 @@ class HciHalHost : public HciHal {
   std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
   SnoopLogger* btsnoop_logger_ = nullptr;
   LinkClocker* link_clocker_ = nullptr;
+  bool batched_transport_ = false;
+  // Receive buffers reused across recvmmsg() calls in batched mode.
+  std::array<uint8_t, kMaxBatchSize> rx_h4_types_ = {};
+  std::array<HciPacket, kMaxBatchSize> rx_packets_;
 
   void write_to_fd(HciPacket packet) {
     // TODO: replace this with new queue when it's ready
@@ -365,17 +378,49 @@ class HciHalHost : public HciHal {
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(api_mutex_);
     if (hci_outgoing_queue_.empty()) return;
-    auto packet_to_send = hci_outgoing_queue_.front();
-    auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
-    hci_outgoing_queue_.pop();
-    if (bytes_written == -1) {
-      abort();
+    if (batched_transport_) {
+      send_packet_batch();
+    } else {
+      auto packet_to_send = hci_outgoing_queue_.front();
+      auto bytes_written = write(sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
+      hci_outgoing_queue_.pop();
+      if (bytes_written == -1) {
+        abort();
+      }
     }
     if (hci_outgoing_queue_.empty()) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(reactable_, os::Reactor::REACT_ON_READ_ONLY);
     }
   }
 
+  // The HCI user channel is datagram oriented: every message must carry
+  // exactly one H4 packet, so queued packets are batched with sendmmsg()
+  // rather than concatenated with writev().
+  void send_packet_batch() {
+    size_t count = std::min(hci_outgoing_queue_.size(), kMaxBatchSize);
+    std::array<struct iovec, kMaxBatchSize> iov;
+    std::array<struct mmsghdr, kMaxBatchSize> msgs = {};
+    std::vector<HciPacket> batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      batch.push_back(std::move(hci_outgoing_queue_.front()));
+      hci_outgoing_queue_.pop();
+      iov[i] = {batch[i].data(), batch[i].size()};
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent = 0;
+    while (sent < count) {
+      int result;
+      RUN_NO_INTR(result = sendmmsg(sock_fd_, msgs.data() + sent, count - sent, 0));
+      if (result == -1) {
+        abort();
+      }
+      sent += result;
+    }
+  }
+
   void incoming_packet_received() {
     {
       std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -384,17 +429,70 @@ class HciHalHost : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
+    if (batched_transport_) {
+      receive_packet_batch();
+      return;
+    }
+
+    // Scatter the H4 type byte and the HCI packet into separate buffers so that
+    // the packet can be handed to the callbacks without copying it again.
+    uint8_t h4_type = 0;
+    HciPacket receivedHciPacket(kBufSize - kH4HeaderSize);
+    struct iovec iov[2] = {
+        {&h4_type, kH4HeaderSize},
+        {receivedHciPacket.data(), receivedHciPacket.size()},
+    };
 
     ssize_t received_size;
-    RUN_NO_INTR(received_size = read(sock_fd_, buf, kBufSize));
+    RUN_NO_INTR(received_size = readv(sock_fd_, iov, 2));
+
+    if (!check_received_size(received_size)) {
+      return;
+    }
+    process_incoming_packet(h4_type, std::move(receivedHciPacket), received_size);
+  }
 
+  void receive_packet_batch() {
+    std::array<struct iovec, 2 * kMaxBatchSize> iov;
+    std::array<struct mmsghdr, kMaxBatchSize> msgs = {};
+    for (size_t i = 0; i < kMaxBatchSize; i++) {
+      // Buffers handed upwards by the previous batch were moved from.
+      rx_packets_[i].resize(kBufSize - kH4HeaderSize);
+      iov[2 * i] = {&rx_h4_types_[i], kH4HeaderSize};
+      iov[2 * i + 1] = {rx_packets_[i].data(), rx_packets_[i].size()};
+      msgs[i].msg_hdr.msg_iov = &iov[2 * i];
+      msgs[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    // The reactor only reports the socket readable, so grab whatever is
+    // already queued without blocking for a full batch.
+    int received;
+    RUN_NO_INTR(received = recvmmsg(sock_fd_, msgs.data(), kMaxBatchSize, MSG_DONTWAIT, nullptr));
+    if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (!check_received_size(received)) {
+      return;
+    }
+
+    for (int i = 0; i < received; i++) {
+      ssize_t received_size = msgs[i].msg_len;
+      if (!check_received_size(received_size)) {
+        return;
+      }
+      process_incoming_packet(rx_h4_types_[i], std::move(rx_packets_[i]), received_size);
+    }
+  }
+
+  // Returns false, after shutting down the transport, if the socket failed
+  // or reached EOF.
+  bool check_received_size(ssize_t received_size) {
     // we don't want crash when the chipset is broken.
     if (received_size == -1) {
       log::error("Can't receive from socket: {}", strerror(errno));
       close(sock_fd_);
       raise(SIGINT);
-      return;
+      return false;
     }
 
     if (received_size == 0) {
@@ -402,15 +500,21 @@ class HciHalHost : public HciHal {
       // First close sock fd before raising sigint
       close(sock_fd_);
       raise(SIGINT);
-      return;
+      return false;
     }
+    return true;
+  }
+
+  // |received_size| includes the H4 header.
+  void process_incoming_packet(uint8_t h4_type, HciPacket receivedHciPacket, ssize_t received_size) {
+    const uint8_t* buf = receivedHciPacket.data();
 
-    if (buf[0] == kH4Event) {
+    if (h4_type == kH4Event) {
       log::assert_that(
           received_size >= kH4HeaderSize + kHciEvtHeaderSize,
           "Received bad HCI_EVT packet size: {}",
           received_size);
-      uint8_t hci_evt_parameter_total_length = buf[2];
+      uint8_t hci_evt_parameter_total_length = buf[1];
       ssize_t payload_size = received_size - (kH4HeaderSize + kHciEvtHeaderSize);
       log::assert_that(
           payload_size == hci_evt_parameter_total_length,
@@ -418,8 +522,7 @@ class HciHalHost : public HciHal {
           payload_size,
           hci_evt_parameter_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + payload_size);
+      receivedHciPacket.resize(kHciEvtHeaderSize + payload_size);
       link_clocker_->OnHciEvent(receivedHciPacket);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
       {
@@ -428,17 +531,17 @@ class HciHalHost : public HciHal {
           log::info("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventReceived(std::move(receivedHciPacket));
       }
     }
 
-    if (buf[0] == kH4Acl) {
+    if (h4_type == kH4Acl) {
       log::assert_that(
           received_size >= kH4HeaderSize + kHciAclHeaderSize,
           "Received bad HCI_ACL packet size: {}",
           received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciAclHeaderSize);
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
+      uint16_t hci_acl_data_total_length = (buf[3] << 8) + buf[2];
       log::assert_that(
           payload_size == hci_acl_data_total_length,
           "malformed ACL length received: {} != {}",
@@ -448,9 +551,7 @@ class HciHalHost : public HciHal {
           hci_acl_data_total_length <= kBufSize - kH4HeaderSize - kHciAclHeaderSize,
           "packet too long");
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(
-          buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + payload_size);
+      receivedHciPacket.resize(kHciAclHeaderSize + payload_size);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -458,25 +559,24 @@ class HciHalHost : public HciHal {
           log::info("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataReceived(std::move(receivedHciPacket));
       }
     }
 
-    if (buf[0] == kH4Sco) {
+    if (h4_type == kH4Sco) {
       log::assert_that(
           received_size >= kH4HeaderSize + kHciScoHeaderSize,
           "Received bad HCI_SCO packet size: {}",
           received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciScoHeaderSize);
-      uint8_t hci_sco_data_total_length = buf[3];
+      uint8_t hci_sco_data_total_length = buf[2];
       log::assert_that(
           payload_size == hci_sco_data_total_length,
           "malformed SCO length received: {} != {}",
           payload_size,
           hci_sco_data_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + payload_size);
+      receivedHciPacket.resize(kHciScoHeaderSize + payload_size);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -484,25 +584,24 @@ class HciHalHost : public HciHal {
           log::info("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataReceived(std::move(receivedHciPacket));
       }
     }
 
-    if (buf[0] == kH4Iso) {
+    if (h4_type == kH4Iso) {
       log::assert_that(
           received_size >= kH4HeaderSize + kHciIsoHeaderSize,
           "Received bad HCI_ISO packet size: {}",
           received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciIsoHeaderSize);
-      uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
+      uint16_t hci_iso_data_total_length = ((buf[3] & 0x3f) << 8) + buf[2];
       log::assert_that(
           payload_size == hci_iso_data_total_length,
           "malformed ISO length received: {} != {}",
           payload_size,
           hci_iso_data_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + payload_size);
+      receivedHciPacket.resize(kHciIsoHeaderSize + payload_size);
       btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
@@ -510,10 +609,9 @@ class HciHalHost : public HciHal {
           log::info("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataReceived(std::move(receivedHciPacket));
       }
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
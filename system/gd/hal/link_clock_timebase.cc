@@ -0,0 +1,122 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/link_clock_timebase.h"
+
+#include <cmath>
+#include <limits>
+
+namespace bluetooth::hal {
+
+namespace {
+
+// The BT clock is reported at 51.2 KHz, that is 625 / 32 us per tick.
+int64_t BtClockToUs(int32_t ticks) {
+  return int64_t(ticks) * 625 / 32;
+}
+
+int32_t UsToBtClock(int64_t us) {
+  return int32_t(us * 32 / 625);
+}
+
+// Weight of a new drift measurement in the smoothed drift
+constexpr double kDriftSmoothing = 1.0 / 8;
+
+}  // namespace
+
+__attribute__((no_sanitize("integer"))) void LinkClockTimebase::OnEvent(uint32_t timestamp_us, uint32_t bt_clock) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!has_reference_) {
+    // The first measurement is only used to start the first window, its deviation is not known yet
+    has_reference_ = true;
+    ref_local_us_ = timestamp_us;
+    ref_bt_clock_ = bt_clock;
+    window_start_us_ = timestamp_us;
+    window_min_offset_us_ = std::numeric_limits<int64_t>::max();
+    completed_windows_ = 0;
+  }
+
+  // Deviation of the local time from the BT clock, since the reference
+  int64_t offset_us =
+      int64_t(int32_t(timestamp_us - ref_local_us_)) - BtClockToUs(int32_t(bt_clock - ref_bt_clock_));
+  if (offset_us < window_min_offset_us_) {
+    window_min_offset_us_ = offset_us;
+    window_min_local_us_ = timestamp_us;
+    window_min_bt_clock_ = bt_clock;
+  }
+
+  if (timestamp_us - window_start_us_ < kWindowUs) {
+    return;
+  }
+
+  // The deviations of the least delayed measurements of two consecutive windows give the drift over the window
+  int64_t elapsed_us = BtClockToUs(int32_t(window_min_bt_clock_ - ref_bt_clock_));
+  if (completed_windows_ > 0 && elapsed_us > 0) {
+    double drift = double(window_min_offset_us_) / double(elapsed_us);
+    drift_ = locked_ ? drift_ + (drift - drift_) * kDriftSmoothing : drift;
+    locked_ = true;
+  }
+  completed_windows_++;
+
+  ref_local_us_ = window_min_local_us_;
+  ref_bt_clock_ = window_min_bt_clock_;
+  window_start_us_ = timestamp_us;
+  window_min_offset_us_ = std::numeric_limits<int64_t>::max();
+}
+
+__attribute__((no_sanitize("integer"))) std::optional<uint32_t> LinkClockTimebase::BtClockToLocalTime(
+    uint32_t bt_clock) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!locked_) {
+    return std::nullopt;
+  }
+  double bt_dt_us = BtClockToUs(int32_t(bt_clock - ref_bt_clock_));
+  return ref_local_us_ + uint32_t(std::llround(bt_dt_us * (1 + drift_)));
+}
+
+__attribute__((no_sanitize("integer"))) std::optional<uint32_t> LinkClockTimebase::LocalTimeToBtClock(
+    uint32_t timestamp_us) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!locked_) {
+    return std::nullopt;
+  }
+  double local_dt_us = int32_t(timestamp_us - ref_local_us_);
+  return ref_bt_clock_ + uint32_t(UsToBtClock(std::llround(local_dt_us / (1 + drift_))));
+}
+
+std::optional<double> LinkClockTimebase::GetDriftPpm() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!locked_) {
+    return std::nullopt;
+  }
+  return drift_ * 1e6;
+}
+
+bool LinkClockTimebase::IsLocked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return locked_;
+}
+
+void LinkClockTimebase::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  has_reference_ = false;
+  locked_ = false;
+  drift_ = 0;
+  completed_windows_ = 0;
+}
+
+}  // namespace bluetooth::hal
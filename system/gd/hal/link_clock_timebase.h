@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include "hal/link_clocker.h"
+
+namespace bluetooth::hal {
+
+/// Maps the local time, as measured by the audio server tick, to the local BT clock of the controller and back, from
+/// the Read Clock measurements reported by the LinkClocker.
+///
+/// The measurements are taken when the Read Clock completion is received, so they are delayed by the HCI transport.
+/// The smallest deviation in each window of `kWindowUs` is kept, as it is the least delayed, and the drift between
+/// the two clocks is deduced from the deviations of consecutive windows, then smoothed. The timebase is locked once a
+/// drift is estimated, which requires the clock to be read for two windows.
+class LinkClockTimebase : public ReadClockHandler {
+ public:
+  static constexpr uint32_t kWindowUs = 1000 * 1000;
+
+  /// Return the local time in microseconds at which the BT clock, in the unit of `ReadClockHandler::OnEvent`, reaches
+  /// `bt_clock`, or nullopt while the timebase is not locked.
+  std::optional<uint32_t> BtClockToLocalTime(uint32_t bt_clock) const;
+
+  /// Return the BT clock at the local time `timestamp_us`, or nullopt while the timebase is not locked.
+  std::optional<uint32_t> LocalTimeToBtClock(uint32_t timestamp_us) const;
+
+  /// Return the drift of the local time relative to the BT clock in parts per million, positive when the local time
+  /// runs faster, or nullopt while the timebase is not locked.
+  std::optional<double> GetDriftPpm() const;
+
+  bool IsLocked() const;
+
+  /// Forget the measurements, when the controller is restarted
+  void Reset();
+
+  void OnEvent(uint32_t timestamp_us, uint32_t bt_clock) override;
+
+ private:
+  mutable std::mutex mutex_;
+
+  bool has_reference_ = false;
+  bool locked_ = false;
+  int completed_windows_ = 0;
+
+  // Least delayed measurement of the last completed window
+  uint32_t ref_local_us_ = 0;
+  uint32_t ref_bt_clock_ = 0;
+
+  // Smoothed drift, in local microseconds per BT clock microsecond
+  double drift_ = 0;
+
+  // Current window, started at `window_start_us_`
+  uint32_t window_start_us_ = 0;
+  int64_t window_min_offset_us_ = 0;
+  uint32_t window_min_local_us_ = 0;
+  uint32_t window_min_bt_clock_ = 0;
+};
+
+}  // namespace bluetooth::hal
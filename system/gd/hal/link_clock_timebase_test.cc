@@ -0,0 +1,97 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/link_clock_timebase.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+namespace bluetooth::hal {
+namespace {
+
+// BT clock ticks, at 51.2 KHz, per 100 ms read clock period
+constexpr uint32_t kTicksPerPeriod = 5120;
+constexpr uint32_t kPeriodUs = 100 * 1000;
+
+class LinkClockTimebaseTest : public ::testing::Test {
+ protected:
+  // Feed the timebase with `count` measurements, the local time running `drift_ppm` faster than the BT clock, and
+  // every other measurement delayed by `jitter_us`
+  void Feed(int count, double drift_ppm, uint32_t jitter_us = 0) {
+    for (int i = 0; i < count; i++) {
+      uint32_t timestamp_us = local_start_us_ + uint32_t(std::llround(elapsed_us_ * (1 + drift_ppm * 1e-6)));
+      timebase_.OnEvent(timestamp_us + (i % 2 ? jitter_us : 0), bt_clock_);
+      bt_clock_ += kTicksPerPeriod;
+      elapsed_us_ += kPeriodUs;
+    }
+  }
+
+  LinkClockTimebase timebase_;
+  uint32_t local_start_us_ = 0xfff00000;  // Wraps around while measured
+  uint32_t bt_clock_ = 0x12345670;
+  double elapsed_us_ = 0;
+};
+
+TEST_F(LinkClockTimebaseTest, not_locked_before_two_windows) {
+  ASSERT_FALSE(timebase_.IsLocked());
+  ASSERT_FALSE(timebase_.BtClockToLocalTime(0).has_value());
+  ASSERT_FALSE(timebase_.LocalTimeToBtClock(0).has_value());
+  ASSERT_FALSE(timebase_.GetDriftPpm().has_value());
+
+  Feed(15, 0);
+  ASSERT_FALSE(timebase_.IsLocked());
+
+  Feed(10, 0);
+  ASSERT_TRUE(timebase_.IsLocked());
+}
+
+TEST_F(LinkClockTimebaseTest, drift_estimated) {
+  Feed(200, 40);
+  ASSERT_TRUE(timebase_.GetDriftPpm().has_value());
+  ASSERT_NEAR(40, timebase_.GetDriftPpm().value(), 2);
+}
+
+TEST_F(LinkClockTimebaseTest, delayed_measurements_ignored) {
+  Feed(200, -20, 3000);
+  ASSERT_NEAR(-20, timebase_.GetDriftPpm().value(), 2);
+}
+
+TEST_F(LinkClockTimebaseTest, conversions) {
+  Feed(200, 50);
+
+  // One second after the last measurement
+  uint32_t bt_clock = bt_clock_ + 10 * kTicksPerPeriod;
+  uint32_t expected_local_us = local_start_us_ + uint32_t(std::llround((elapsed_us_ + 1e6) * (1 + 50e-6)));
+
+  auto local_us = timebase_.BtClockToLocalTime(bt_clock);
+  ASSERT_TRUE(local_us.has_value());
+  ASSERT_NEAR(0, int32_t(local_us.value() - expected_local_us), 20);
+
+  auto converted_bt_clock = timebase_.LocalTimeToBtClock(local_us.value());
+  ASSERT_TRUE(converted_bt_clock.has_value());
+  ASSERT_NEAR(0, int32_t(converted_bt_clock.value() - bt_clock), 2);
+}
+
+TEST_F(LinkClockTimebaseTest, reset) {
+  Feed(30, 0);
+  ASSERT_TRUE(timebase_.IsLocked());
+  timebase_.Reset();
+  ASSERT_FALSE(timebase_.IsLocked());
+}
+
+}  // namespace
+}  // namespace bluetooth::hal
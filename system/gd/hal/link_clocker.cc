@@ -19,23 +19,38 @@
 #include <bluetooth/log.h>
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "common/time_util.h"
+#include "hal/link_clock_timebase.h"
 
 namespace bluetooth::hal {
 
-static class : public ReadClockHandler {
-  void OnEvent(uint32_t, uint32_t) override {}
-} g_empty_handler;
+static LinkClockTimebase g_timebase;
 
-static std::atomic<ReadClockHandler*> g_read_clock_handler = &g_empty_handler;
+// Held while the handlers are called, so that a handler is not called anymore once unregistered
+static std::mutex g_read_clock_handlers_mutex;
+static std::vector<ReadClockHandler*> g_read_clock_handlers = {&g_timebase};
 
 void LinkClocker::Register(ReadClockHandler* handler) {
-  g_read_clock_handler = handler;
+  std::lock_guard<std::mutex> lock(g_read_clock_handlers_mutex);
+  g_read_clock_handlers.push_back(handler);
 }
 
-void LinkClocker::Unregister() {
-  g_read_clock_handler = &g_empty_handler;
+void LinkClocker::Unregister(ReadClockHandler* handler) {
+  std::lock_guard<std::mutex> lock(g_read_clock_handlers_mutex);
+  g_read_clock_handlers.erase(
+      std::remove(g_read_clock_handlers.begin(), g_read_clock_handlers.end(), handler), g_read_clock_handlers.end());
+}
+
+const LinkClockTimebase& LinkClocker::GetTimebase() {
+  return g_timebase;
+}
+
+void LinkClocker::Start() {
+  // The BT clock restarts with the controller
+  g_timebase.Reset();
 }
 
 void LinkClocker::OnHciEvent(const HciPacket& packet) {
@@ -91,7 +106,10 @@ void LinkClocker::OnHciEvent(const HciPacket& packet) {
 
   unsigned timestamp_us = bluetooth::common::time_get_audio_server_tick_us();
 
-  (*g_read_clock_handler).OnEvent(timestamp_us, bt_clock << 4);
+  std::lock_guard<std::mutex> lock(g_read_clock_handlers_mutex);
+  for (auto handler : g_read_clock_handlers) {
+    handler->OnEvent(timestamp_us, bt_clock << 4);
+  }
 }
 
 const ModuleFactory LinkClocker::Factory = ModuleFactory([]() { return new LinkClocker(); });
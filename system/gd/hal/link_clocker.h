@@ -21,6 +21,8 @@
 
 namespace bluetooth::hal {
 
+class LinkClockTimebase;
+
 class ReadClockHandler {
  public:
   virtual ~ReadClockHandler() = default;
@@ -38,14 +40,22 @@ class LinkClocker : public ::bluetooth::Module {
 
   void OnHciEvent(const HciPacket& packet);
 
+  /// Register a handler of the BT clock measurements. Several handlers can be
+  /// registered, and are called in the order of their registration.
   static void Register(ReadClockHandler*);
-  static void Unregister();
+  /// Unregister a handler, which is no longer called once this returns.
+  static void Unregister(ReadClockHandler*);
+
+  /// Return the timebase fed with all the BT clock measurements, which
+  /// converts the local time to the BT clock and back for any client, such as
+  /// the audio paths pacing their data on the controller clock.
+  static const LinkClockTimebase& GetTimebase();
 
  protected:
   LinkClocker() = default;
 
   void ListDependencies(ModuleList*) const override {}
-  void Start() override {}
+  void Start() override;
   void Stop() override {}
 
   std::string ToString() const override {
@@ -21,11 +21,12 @@
 #include <sys/stat.h>
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <chrono>
-#include <sstream>
+#include <cstddef>
+#include <cstring>
 
-#include "common/circular_buffer.h"
 #include "common/init_flags.h"
 #include "common/strings.h"
 #include "hal/snoop_logger_common.h"
@@ -263,8 +264,6 @@ auto GetBoundaryFlag = [](auto handle) { return (((handle) >> 12) & 0x0003); };
 // ProfilesFilter consts
 constexpr size_t ACL_HEADER_LENGTH = 4;
 constexpr size_t BASIC_L2CAP_HEADER_LENGTH = 4;
-constexpr uint8_t EXTRA_BUF_SIZE = 0x40;
-constexpr uint16_t DEFAULT_PACKET_SIZE = 0x800;
 
 constexpr uint8_t PROFILE_SCN_PBAP = 19;
 constexpr uint8_t PROFILE_SCN_MAP = 26;
@@ -291,6 +290,14 @@ uint64_t htonll(uint64_t ll) {
 // the relevant system property
 constexpr size_t kDefaultBtSnoopMaxPacketsPerFile = 0xffff;
 
+// Size of the ring buffered between Capture() and the background snoop log writer, when enabled.
+// Packets are dropped while it is full, 1 MB covers well over a flush interval of saturated traffic.
+constexpr size_t kBtSnoopAsyncRingBufferSize = 1024 * 1024;
+
+// Suffixes of the compressed snoop log and of its index, see SnoopLoggerCompressedFile
+constexpr char kBtSnoopCompressedSuffix[] = ".gz";
+constexpr char kBtSnoopIndexSuffix[] = ".idx";
+
 // We restrict the maximum packet size to 150 bytes
 constexpr size_t kDefaultBtSnoozMaxBytesPerPacket = 150;
 constexpr size_t kDefaultBtSnoozMaxPayloadBytesPerPacket =
@@ -304,8 +311,15 @@ std::mutex filter_tracker_list_mutex;
 std::unordered_map<uint16_t, FilterTracker> filter_tracker_list;
 std::unordered_map<uint16_t, uint16_t> local_cid_to_acl;
 
+// A2DP media channels, keyed by connection handle and local cid, and the
+// keys of their remote cids, so that each captured packet is looked up in O(1)
 std::mutex a2dpMediaChannels_mutex;
-std::vector<SnoopLogger::A2dpMediaChannel> a2dpMediaChannels;
+std::unordered_map<uint32_t, SnoopLogger::A2dpMediaChannel> a2dpMediaChannels;
+std::unordered_set<uint32_t> a2dpMediaRemoteChannels;
+
+uint32_t a2dp_media_channel_key(uint16_t conn_handle, uint16_t cid) {
+  return (static_cast<uint32_t>(conn_handle) << 16) | cid;
+}
 
 std::mutex snoop_log_filters_mutex;
 
@@ -348,6 +362,12 @@ void delete_btsnoop_files(const std::string& log_path) {
   }
 }
 
+void delete_compressed_btsnoop_files(const std::string& log_path) {
+  std::string compressed_log_path = log_path + kBtSnoopCompressedSuffix;
+  delete_btsnoop_files(compressed_log_path);
+  delete_btsnoop_files(compressed_log_path + kBtSnoopIndexSuffix);
+}
+
 void delete_old_btsnooz_files(const std::string& log_path, const std::chrono::milliseconds log_life_time) {
   auto opt_created_ts = os::FileCreatedTime(log_path);
   if (!opt_created_ts) return;
@@ -431,6 +451,13 @@ size_t get_btsnooz_packet_length_to_write(
 
 // system properties
 const std::string SnoopLogger::kBtSnoopMaxPacketsPerFileProperty = "persist.bluetooth.btsnoopsize";
+// Writes the snoop log from a background thread, flushing it at this interval in milliseconds
+const std::string SnoopLogger::kBtSnoopAsyncFlushIntervalProperty =
+    "persist.bluetooth.btsnoopasyncflushms";
+// Compresses the snoop log written from the background thread
+const std::string SnoopLogger::kBtSnoopCompressionProperty = "persist.bluetooth.btsnoopcompression";
+// Rotates the snoop log written from the background thread past this size in bytes
+const std::string SnoopLogger::kBtSnoopMaxBytesPerFileProperty = "persist.bluetooth.btsnoopmaxfilebytes";
 const std::string SnoopLogger::kIsDebuggableProperty = "ro.debuggable";
 const std::string SnoopLogger::kBtSnoopLogModeProperty = "persist.bluetooth.btsnooplogmode";
 const std::string SnoopLogger::kBtSnoopDefaultLogModeProperty = "persist.bluetooth.btsnoopdefaultmode";
@@ -484,22 +511,36 @@ SnoopLogger::SnoopLogger(
     bool qualcomm_debug_log_enabled,
     const std::chrono::milliseconds snooz_log_life_time,
     const std::chrono::milliseconds snooz_log_delete_alarm_interval,
-    bool snoop_log_persists)
+    bool snoop_log_persists,
+    const std::chrono::milliseconds async_flush_interval,
+    bool compression_enabled,
+    size_t max_bytes_per_file)
     : snoop_log_path_(std::move(snoop_log_path)),
       snooz_log_path_(std::move(snooz_log_path)),
       max_packets_per_file_(max_packets_per_file),
-      btsnooz_buffer_(max_packets_per_buffer),
+      btsnooz_ring_(max_packets_per_buffer * kDefaultBtSnoozMaxBytesPerPacket),
       qualcomm_debug_log_enabled_(qualcomm_debug_log_enabled),
       snooz_log_life_time_(snooz_log_life_time),
       snooz_log_delete_alarm_interval_(snooz_log_delete_alarm_interval),
-      snoop_log_persists(snoop_log_persists) {
+      snoop_log_persists(snoop_log_persists),
+      async_flush_interval_(async_flush_interval),
+      max_bytes_per_file_(max_bytes_per_file) {
   btsnoop_mode_ = btsnoop_mode;
 
+  // Compression and size based rotation are done by the background writer
+  bool async_writer_enabled = async_flush_interval_ > std::chrono::milliseconds::zero();
+  if (!async_writer_enabled && (compression_enabled || max_bytes_per_file_ != 0)) {
+    log::warn("btsnoop compression and size based rotation need the background writer");
+    max_bytes_per_file_ = 0;
+  }
+  compression_enabled_ = compression_enabled && async_writer_enabled;
+
   if (btsnoop_mode_ == kBtSnoopLogModeFiltered) {
     log::info("Snoop Logs filtered mode enabled");
     EnableFilters();
     // delete unfiltered logs
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
+    delete_compressed_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
     // delete snooz logs
     delete_btsnoop_files(snooz_log_path_);
   } else if (btsnoop_mode_ == kBtSnoopLogModeFull) {
@@ -507,6 +548,7 @@ SnoopLogger::SnoopLogger(
     if (!snoop_log_persists) {
       // delete filtered logs
       delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
+      delete_compressed_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
       // delete snooz logs
       delete_btsnoop_files(snooz_log_path_);
     }
@@ -515,26 +557,56 @@ SnoopLogger::SnoopLogger(
     // delete both filtered and unfiltered logs
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
     delete_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
+    delete_compressed_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, true));
+    delete_compressed_btsnoop_files(get_btsnoop_log_path(snoop_log_path_, false));
   }
 
   snoop_logger_socket_thread_ = nullptr;
   socket_ = nullptr;
   // Add ".filtered" extension if necessary
   snoop_log_path_ = get_btsnoop_log_path(snoop_log_path_, btsnoop_mode_ == kBtSnoopLogModeFiltered);
+
+  if (btsnoop_mode_ != kBtSnoopLogModeDisabled && !snoop_log_persists) {
+    // delete the logs left in the other format
+    if (compression_enabled_) {
+      delete_btsnoop_files(snoop_log_path_);
+    } else {
+      delete_compressed_btsnoop_files(snoop_log_path_);
+    }
+  }
+  if (compression_enabled_) {
+    snoop_log_path_.append(kBtSnoopCompressedSuffix);
+  }
 }
 
 void SnoopLogger::CloseCurrentSnoopLogFile() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
-  if (btsnoop_ostream_.is_open()) {
-    btsnoop_ostream_.flush();
-    btsnoop_ostream_.close();
-  }
+  CloseSnoopLogStream();
   packet_counter_ = 0;
 }
 
 void SnoopLogger::OpenNextSnoopLogFile() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   CloseCurrentSnoopLogFile();
+  OpenSnoopLogStream();
+}
+
+void SnoopLogger::CloseSnoopLogStream() {
+  if (compression_enabled_) {
+    btsnoop_compressed_file_.Close();
+    return;
+  }
+  if (btsnoop_ostream_.is_open()) {
+    btsnoop_ostream_.flush();
+    btsnoop_ostream_.close();
+  }
+}
+
+void SnoopLogger::OpenSnoopLogStream() {
+  if (compression_enabled_) {
+    OpenCompressedSnoopLogStream();
+    return;
+  }
 
   auto last_file_path = get_last_log_path(snoop_log_path_);
 
@@ -569,6 +641,31 @@ void SnoopLogger::OpenNextSnoopLogFile() {
   if (!btsnoop_ostream_.flush()) {
     log::error("Failed to flush, error: \"{}\"", strerror(errno));
   }
+  btsnoop_file_size_ = sizeof(SnoopLoggerCommon::FileHeaderType);
+}
+
+void SnoopLogger::OpenCompressedSnoopLogStream() {
+  auto index_path = snoop_log_path_ + kBtSnoopIndexSuffix;
+  for (const auto& path : {snoop_log_path_, index_path}) {
+    if (os::FileExists(path) && !os::RenameFile(path, get_last_log_path(path))) {
+      log::error("Unabled to rename existing snoop log from \"{}\"", path);
+    }
+  }
+
+  mode_t prevmask = umask(0);
+  bool opened = btsnoop_compressed_file_.Open(
+      snoop_log_path_,
+      index_path,
+      &SnoopLoggerCommon::kBtSnoopFileHeader,
+      sizeof(SnoopLoggerCommon::FileHeaderType));
+#ifdef USE_FAKE_TIMERS
+  file_creation_time = fake_timerfd_get_clock();
+#endif
+  umask(prevmask);
+  if (!opened) {
+    log::fatal(
+        "Unable to open snoop log at \"{}\", error: \"{}\"", snoop_log_path_, strerror(errno));
+  }
 }
 
 void SnoopLogger::EnableFilters() {
@@ -592,6 +689,28 @@ void SnoopLogger::EnableFilters() {
     }
     log::info("{}: {}", itr->first, itr->second);
   }
+
+  uint8_t active_filters = 0;
+  if (kBtSnoopLogFilterState[kBtSnoopLogFilterHeadersProperty]) {
+    active_filters |= kActiveFilterHeaders;
+  }
+  if (kBtSnoopLogFilterState[kBtSnoopLogFilterProfileA2dpProperty]) {
+    active_filters |= kActiveFilterA2dp;
+  }
+  if (kBtSnoopLogFilterState[kBtSnoopLogFilterProfileRfcommProperty]) {
+    active_filters |= kActiveFilterRfcomm;
+  }
+  ProfileFilterMode pbap_filter_mode =
+      ParseProfileFilterMode(kBtSnoopLogFilterMode[kBtSnoopLogFilterProfilePbapModeProperty]);
+  ProfileFilterMode map_filter_mode =
+      ParseProfileFilterMode(kBtSnoopLogFilterMode[kBtSnoopLogFilterProfileMapModeProperty]);
+  if (pbap_filter_mode != ProfileFilterMode::kDisabled ||
+      map_filter_mode != ProfileFilterMode::kDisabled) {
+    active_filters |= kActiveFilterProfiles;
+  }
+  pbap_filter_mode_ = pbap_filter_mode;
+  map_filter_mode_ = map_filter_mode;
+  active_filters_ = active_filters;
 }
 
 void SnoopLogger::DisableFilters() {
@@ -604,6 +723,21 @@ void SnoopLogger::DisableFilters() {
     itr->second = SnoopLogger::kBtSnoopLogFilterProfileModeDisabled;
     log::info("{}, {}", itr->first, itr->second);
   }
+  active_filters_ = 0;
+  pbap_filter_mode_ = ProfileFilterMode::kDisabled;
+  map_filter_mode_ = ProfileFilterMode::kDisabled;
+}
+
+SnoopLogger::ProfileFilterMode SnoopLogger::ParseProfileFilterMode(const std::string& mode) {
+  if (mode == kBtSnoopLogFilterProfileModeFullfillter) {
+    return ProfileFilterMode::kFullfilter;
+  } else if (mode == kBtSnoopLogFilterProfileModeHeader) {
+    return ProfileFilterMode::kHeader;
+  } else if (mode == kBtSnoopLogFilterProfileModeMagic) {
+    return ProfileFilterMode::kMagic;
+  }
+  // Unknown modes leave the packets unchanged, as the disabled mode does
+  return ProfileFilterMode::kDisabled;
 }
 
 bool SnoopLogger::IsFilterEnabled(std::string filter_name) {
@@ -678,31 +812,28 @@ void SnoopLogger::CalculateAclPacketLength(
 uint32_t SnoopLogger::PayloadStrip(
     profile_type_t current_profile, uint8_t* packet, uint32_t hdr_len, uint32_t pl_len) {
   uint32_t len = 0;
-  std::string profile_filter_mode = "";
+  ProfileFilterMode profile_filter_mode = ProfileFilterMode::kDisabled;
   log::debug(
       "current_profile={}, hdr len={}, total len={}",
       ProfilesFilter::ProfileToString(current_profile),
       hdr_len,
       pl_len);
-  std::lock_guard<std::mutex> lock(snoop_log_filters_mutex);
   switch (current_profile) {
     case FILTER_PROFILE_PBAP:
     case FILTER_PROFILE_HFP_HF:
     case FILTER_PROFILE_HFP_HS:
-      profile_filter_mode =
-          kBtSnoopLogFilterMode[SnoopLogger::kBtSnoopLogFilterProfilePbapModeProperty];
+      profile_filter_mode = pbap_filter_mode_;
       break;
     case FILTER_PROFILE_MAP:
-      profile_filter_mode =
-          kBtSnoopLogFilterMode[SnoopLogger::kBtSnoopLogFilterProfileMapModeProperty];
+      profile_filter_mode = map_filter_mode_;
       break;
     default:
-      profile_filter_mode = kBtSnoopLogFilterProfileModeDisabled;
+      break;
   }
 
-  if (profile_filter_mode == SnoopLogger::kBtSnoopLogFilterProfileModeFullfillter) {
+  if (profile_filter_mode == ProfileFilterMode::kFullfilter) {
     return 0;
-  } else if (profile_filter_mode == SnoopLogger::kBtSnoopLogFilterProfileModeHeader) {
+  } else if (profile_filter_mode == ProfileFilterMode::kHeader) {
     len = hdr_len;
 
     packet[ACL_LENGTH_OFFSET] = static_cast<uint8_t>(hdr_len - BASIC_L2CAP_HEADER_LENGTH);
@@ -714,7 +845,7 @@ uint32_t SnoopLogger::PayloadStrip(
     packet[L2CAP_PDU_LENGTH_OFFSET + 1] =
         static_cast<uint8_t>((hdr_len - (ACL_HEADER_LENGTH + BASIC_L2CAP_HEADER_LENGTH)) >> 8);
 
-  } else if (profile_filter_mode == SnoopLogger::kBtSnoopLogFilterProfileModeMagic) {
+  } else if (profile_filter_mode == ProfileFilterMode::kMagic) {
     strcpy(reinterpret_cast<char*>(&packet[hdr_len]), payload_fill_magic);
 
     packet[ACL_LENGTH_OFFSET] =
@@ -939,24 +1070,16 @@ void SnoopLogger::ClearL2capAcceptlist(
 }
 
 bool SnoopLogger::IsA2dpMediaChannel(uint16_t conn_handle, uint16_t cid, bool is_local_cid) {
-  if (btsnoop_mode_ != kBtSnoopLogModeFiltered ||
-      !IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
+  if (btsnoop_mode_ != kBtSnoopLogModeFiltered || !IsActiveFilter(kActiveFilterA2dp)) {
     return false;
   }
 
+  uint32_t key = a2dp_media_channel_key(conn_handle, cid);
   std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-  auto iter = std::find_if(
-      a2dpMediaChannels.begin(),
-      a2dpMediaChannels.end(),
-      [conn_handle, cid, is_local_cid](auto& el) {
-        if (el.conn_handle != conn_handle) return false;
-
-        if (is_local_cid) return el.local_cid == cid;
-
-        return el.remote_cid == cid;
-      });
-
-  return iter != a2dpMediaChannels.end();
+  if (is_local_cid) {
+    return a2dpMediaChannels.find(key) != a2dpMediaChannels.end();
+  }
+  return a2dpMediaRemoteChannels.find(key) != a2dpMediaRemoteChannels.end();
 }
 
 bool SnoopLogger::IsA2dpMediaPacket(bool is_received, uint8_t* packet) {
@@ -985,7 +1108,9 @@ void SnoopLogger::AddA2dpMediaChannel(
         local_cid,
         remote_cid);
     std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-    a2dpMediaChannels.push_back({conn_handle, local_cid, remote_cid});
+    a2dpMediaChannels.insert(
+        {a2dp_media_channel_key(conn_handle, local_cid), {conn_handle, local_cid, remote_cid}});
+    a2dpMediaRemoteChannels.insert(a2dp_media_channel_key(conn_handle, remote_cid));
   }
 }
 
@@ -996,14 +1121,12 @@ void SnoopLogger::RemoveA2dpMediaChannel(uint16_t conn_handle, uint16_t local_ci
   }
 
   std::lock_guard<std::mutex> lock(a2dpMediaChannels_mutex);
-  a2dpMediaChannels.erase(
-      std::remove_if(
-          a2dpMediaChannels.begin(),
-          a2dpMediaChannels.end(),
-          [conn_handle, local_cid](auto& el) {
-            return (el.conn_handle == conn_handle && el.local_cid == local_cid);
-          }),
-      a2dpMediaChannels.end());
+  auto iter = a2dpMediaChannels.find(a2dp_media_channel_key(conn_handle, local_cid));
+  if (iter == a2dpMediaChannels.end()) {
+    return;
+  }
+  a2dpMediaRemoteChannels.erase(a2dp_media_channel_key(conn_handle, iter->second.remote_cid));
+  a2dpMediaChannels.erase(iter);
 }
 
 void SnoopLogger::SetRfcommPortOpen(
@@ -1143,7 +1266,7 @@ void SnoopLogger::SetL2capChannelClose(uint16_t handle, uint16_t local_cid, uint
 }
 
 void SnoopLogger::FilterCapturedPacket(
-    HciPacket& packet,
+    uint8_t* packet,
     Direction direction,
     PacketType type,
     uint32_t& length,
@@ -1152,35 +1275,29 @@ void SnoopLogger::FilterCapturedPacket(
     return;
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileA2dpProperty)) {
-    if (IsA2dpMediaPacket(direction == Direction::INCOMING, (uint8_t*)packet.data())) {
+  if (IsActiveFilter(kActiveFilterA2dp)) {
+    if (IsA2dpMediaPacket(direction == Direction::INCOMING, packet)) {
       length = 0;
       return;
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterHeadersProperty)) {
-    CalculateAclPacketLength(length, (uint8_t*)packet.data(), direction == Direction::INCOMING);
+  if (IsActiveFilter(kActiveFilterHeaders)) {
+    CalculateAclPacketLength(length, packet, direction == Direction::INCOMING);
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfilePbapModeProperty) ||
-      IsFilterEnabled(kBtSnoopLogFilterProfileMapModeProperty)) {
+  if (IsActiveFilter(kActiveFilterProfiles)) {
     // If HeadersFiltered applied, do not use ProfilesFiltered
     if (length == ntohl(header.length_original)) {
-      if (packet.size() + EXTRA_BUF_SIZE > DEFAULT_PACKET_SIZE) {
-        // Add additional bytes for magic string in case
-        // payload length is less than the length of magic string.
-        packet.resize((size_t)(packet.size() + EXTRA_BUF_SIZE));
-      }
-
-      length = FilterProfiles(direction == Direction::INCOMING, (uint8_t*)packet.data());
+      // The magic string may run past the end of a short payload, into the
+      // zeroed end of |packet|
+      length = FilterProfiles(direction == Direction::INCOMING, packet);
       if (length == 0) return;
     }
   }
 
-  if (IsFilterEnabled(kBtSnoopLogFilterProfileRfcommProperty)) {
-    bool shouldFilter =
-        SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, (uint8_t*)packet.data());
+  if (IsActiveFilter(kActiveFilterRfcomm)) {
+    bool shouldFilter = SnoopLogger::ShouldFilterLog(direction == Direction::INCOMING, packet);
     if (shouldFilter) {
       length = L2CAP_HEADER_SIZE + PACKET_TYPE_LENGTH;
     }
@@ -1188,10 +1305,6 @@ void SnoopLogger::FilterCapturedPacket(
 }
 
 void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction, PacketType type) {
-  //// TODO(b/335520123) update FilterCapture to stop modifying packets ////
-  HciPacket mutable_packet(immutable_packet);
-  HciPacket& packet = mutable_packet;
-  //////////////////////////////////////////////////////////////////////////
   uint64_t timestamp_us =
       std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
           .count();
@@ -1212,7 +1325,7 @@ void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction
       flags.set(1, true);
       break;
   }
-  uint32_t length = packet.size() + /* type byte */ PACKET_TYPE_LENGTH;
+  uint32_t length = immutable_packet.size() + /* type byte */ PACKET_TYPE_LENGTH;
   PacketHeaderType header = {.length_original = htonl(length),
                              .length_captured = htonl(length),
                              .flags = htonl(static_cast<uint32_t>(flags.to_ulong())),
@@ -1223,25 +1336,50 @@ void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction
     std::lock_guard<std::recursive_mutex> lock(file_mutex_);
     if (btsnoop_mode_ == kBtSnoopLogModeDisabled) {
       // btsnoop disabled, log in-memory btsnooz log only
-      std::stringstream ss;
-      size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
+      size_t included_length =
+          get_btsnooz_packet_length_to_write(immutable_packet, type, qualcomm_debug_log_enabled_);
       header.length_captured = htonl(included_length + /* type byte */ PACKET_TYPE_LENGTH);
-      if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-        log::error("Failed to write packet header for btsnooz, error: \"{}\"", strerror(errno));
+      PushToBtsnoozRing(header, immutable_packet.data(), included_length);
+      return;
+    }
+
+    CapturedPayload payload = {
+        .head = immutable_packet.data(),
+        .head_length = immutable_packet.size(),
+        .tail = nullptr,
+        .tail_length = 0};
+    // Only the beginning of a filtered packet is copied, zero padded for the
+    // magic string, and its truncation is applied by writing fewer bytes
+    std::array<uint8_t, FILTERED_PREFIX_SIZE> prefix;
+    if (btsnoop_mode_ == kBtSnoopLogModeFiltered && type == PacketType::ACL) {
+      size_t prefix_length = std::min(immutable_packet.size(), prefix.size());
+      std::copy_n(immutable_packet.begin(), prefix_length, prefix.begin());
+      std::fill(prefix.begin() + prefix_length, prefix.end(), 0);
+      FilterCapturedPacket(prefix.data(), direction, type, length, header);
+      if (length == 0) {
+        return;
       }
-      if (!ss.write(reinterpret_cast<const char*>(packet.data()), included_length)) {
-        log::error("Failed to write packet payload for btsnooz, error: \"{}\"", strerror(errno));
+
+      // Filters only shorten the packet, or extend a short one with the magic
+      // string written in the zero padding of the prefix
+      size_t payload_length = length - PACKET_TYPE_LENGTH;
+      payload.head = prefix.data();
+      payload.head_length = std::min(payload_length, prefix.size());
+      if (payload_length > prefix.size() && immutable_packet.size() > prefix.size()) {
+        payload.tail = immutable_packet.data() + prefix.size();
+        payload.tail_length = std::min(payload_length, immutable_packet.size()) - prefix.size();
       }
-      btsnooz_buffer_.Push(ss.str());
-      return;
+      length = payload.head_length + payload.tail_length + PACKET_TYPE_LENGTH;
     }
 
-    FilterCapturedPacket(packet, direction, type, length, header);
+    if (length != ntohl(header.length_original)) {
+      header.length_captured = htonl(length);
+    }
 
-    if (length == 0) {
+    if (async_ring_ != nullptr) {
+      PushToAsyncRing(header, payload);
+      WriteToSocket(header, payload);
       return;
-    } else if (length != ntohl(header.length_original)) {
-      header.length_captured = htonl(length);
     }
 
     packet_counter_++;
@@ -1251,14 +1389,13 @@ void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction
     if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
       log::error("Failed to write packet header for btsnoop, error: \"{}\"", strerror(errno));
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), length - 1)) {
+    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(payload.head), payload.head_length) ||
+        (payload.tail_length != 0 &&
+         !btsnoop_ostream_.write(reinterpret_cast<const char*>(payload.tail), payload.tail_length))) {
       log::error("Failed to write packet payload for btsnoop, error: \"{}\"", strerror(errno));
     }
 
-    if (socket_ != nullptr) {
-      socket_->Write(&header, sizeof(PacketHeaderType));
-      socket_->Write(packet.data(), (size_t)(length - 1));
-    }
+    WriteToSocket(header, payload);
 
     // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
     // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
@@ -1270,7 +1407,177 @@ void SnoopLogger::Capture(const HciPacket& immutable_packet, Direction direction
   }
 }
 
-void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
+void SnoopLogger::WriteToSocket(const PacketHeaderType& header, const CapturedPayload& payload) {
+  if (socket_ == nullptr) {
+    return;
+  }
+  socket_->Write(&header, sizeof(PacketHeaderType));
+  socket_->Write(payload.head, payload.head_length);
+  if (payload.tail_length != 0) {
+    socket_->Write(payload.tail, payload.tail_length);
+  }
+}
+
+void SnoopLogger::PushToAsyncRing(PacketHeaderType& header, const CapturedPayload& payload) {
+  if (packet_counter_ >= max_packets_per_file_ && async_ring_->Push(nullptr, 0)) {
+    // An empty record tells the writer thread to move to the next file
+    packet_counter_ = 0;
+  }
+
+  // Cumulative drops, as defined by the btsnoop format
+  header.dropped_packets = htonl(static_cast<uint32_t>(async_ring_->GetDroppedCount()));
+  if (async_ring_->Push(
+          &header,
+          sizeof(PacketHeaderType),
+          payload.head,
+          payload.head_length,
+          payload.tail,
+          payload.tail_length)) {
+    packet_counter_++;
+  }
+
+  if (async_ring_->Size() >= async_ring_->Capacity() / 2) {
+    async_writer_cv_.notify_one();
+  }
+}
+
+void SnoopLogger::StartAsyncWriter() {
+  log::info("Writing btsnoop log in background, flush interval {}ms", async_flush_interval_.count());
+  async_ring_ = std::make_unique<SnoopLoggerRingBuffer>(kBtSnoopAsyncRingBufferSize);
+  async_reported_drops_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(async_writer_mutex_);
+    async_writer_running_ = true;
+  }
+  async_writer_thread_ = std::thread(&SnoopLogger::RunAsyncWriter, this);
+}
+
+void SnoopLogger::StopAsyncWriter() {
+  if (async_ring_ == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(async_writer_mutex_);
+    async_writer_running_ = false;
+  }
+  async_writer_cv_.notify_one();
+  if (async_writer_thread_.joinable()) {
+    async_writer_thread_.join();
+  }
+  if (async_ring_->GetDroppedCount() != 0) {
+    log::warn("btsnoop log dropped {} packets in total", async_ring_->GetDroppedCount());
+  }
+  async_ring_.reset();
+}
+
+void SnoopLogger::RunAsyncWriter() {
+  std::vector<uint8_t> record;
+  std::unique_lock<std::mutex> lock(async_writer_mutex_);
+  while (true) {
+    async_writer_cv_.wait_for(lock, async_flush_interval_, [this] {
+      return !async_writer_running_ || async_ring_->Size() >= async_ring_->Capacity() / 2;
+    });
+    bool running = async_writer_running_;
+    lock.unlock();
+    // Drain once more after being stopped, nothing is pushed anymore then
+    DrainAsyncRing(record);
+    lock.lock();
+    if (!running) {
+      break;
+    }
+  }
+}
+
+void SnoopLogger::DrainAsyncRing(std::vector<uint8_t>& record) {
+  bool written = false;
+  while (async_ring_->Pop(record)) {
+    if (record.empty()) {
+      CloseSnoopLogStream();
+      OpenSnoopLogStream();
+      continue;
+    }
+    WriteAsyncRecord(record);
+    written = true;
+  }
+  if (written) {
+    if (compression_enabled_) {
+      btsnoop_compressed_file_.Flush();
+    } else if (!btsnoop_ostream_.flush()) {
+      log::error("Failed to flush, error: \"{}\"", strerror(errno));
+    }
+  }
+
+  uint64_t dropped = async_ring_->GetDroppedCount();
+  if (dropped != async_reported_drops_) {
+    log::warn("btsnoop log dropped {} packets, writer falling behind", dropped - async_reported_drops_);
+    async_reported_drops_ = dropped;
+  }
+}
+
+void SnoopLogger::WriteAsyncRecord(const std::vector<uint8_t>& record) {
+  if (compression_enabled_) {
+    uint64_t timestamp;
+    std::memcpy(&timestamp, record.data() + offsetof(PacketHeaderType, timestamp), sizeof(timestamp));
+    btsnoop_compressed_file_.Write(record.data(), record.size(), timestamp);
+  } else {
+    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(record.data()), record.size())) {
+      log::error("Failed to write packet for btsnoop, error: \"{}\"", strerror(errno));
+    }
+    btsnoop_file_size_ += record.size();
+  }
+
+  if (max_bytes_per_file_ != 0) {
+    uint64_t file_size = compression_enabled_ ? btsnoop_compressed_file_.GetSize() : btsnoop_file_size_;
+    if (file_size >= max_bytes_per_file_) {
+      CloseSnoopLogStream();
+      OpenSnoopLogStream();
+    }
+  }
+}
+
+uint64_t SnoopLogger::GetAsyncDroppedPacketCount() const {
+  std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+  return async_ring_ != nullptr ? async_ring_->GetDroppedCount() : 0;
+}
+
+void SnoopLogger::CopyFromBtsnoozRing(uint64_t position, void* data, size_t length) const {
+  size_t offset = position % btsnooz_ring_.size();
+  size_t first_part = std::min(length, btsnooz_ring_.size() - offset);
+  std::memcpy(data, btsnooz_ring_.data() + offset, first_part);
+  std::memcpy(static_cast<uint8_t*>(data) + first_part, btsnooz_ring_.data(), length - first_part);
+}
+
+size_t SnoopLogger::BtsnoozRecordSizeAt(uint64_t position) const {
+  PacketHeaderType header;
+  CopyFromBtsnoozRing(position, &header, sizeof(PacketHeaderType));
+  return sizeof(PacketHeaderType) + ntohl(header.length_captured) - /* type byte */ PACKET_TYPE_LENGTH;
+}
+
+void SnoopLogger::PushToBtsnoozRing(
+    const PacketHeaderType& header, const uint8_t* payload, size_t length) {
+  size_t record_size = sizeof(PacketHeaderType) + length;
+  if (record_size > btsnooz_ring_.size()) {
+    return;
+  }
+
+  // Evict the oldest records until the new one fits
+  while (btsnooz_ring_.size() - (btsnooz_head_ - btsnooz_tail_) < record_size) {
+    btsnooz_tail_ += BtsnoozRecordSizeAt(btsnooz_tail_);
+  }
+
+  auto copy_in = [this](const void* data, size_t data_length) {
+    size_t offset = btsnooz_head_ % btsnooz_ring_.size();
+    size_t first_part = std::min(data_length, btsnooz_ring_.size() - offset);
+    std::memcpy(btsnooz_ring_.data() + offset, data, first_part);
+    std::memcpy(
+        btsnooz_ring_.data(), static_cast<const uint8_t*>(data) + first_part, data_length - first_part);
+    btsnooz_head_ += data_length;
+  };
+  copy_in(&header, sizeof(PacketHeaderType));
+  copy_in(payload, length);
+}
+
+void SnoopLogger::DumpSnoozLogToFile() const {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
     log::debug("btsnoop log is enabled, skip dumping btsnooz log");
@@ -1305,8 +1612,13 @@ void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const
     log::fatal(
         "Unable to write file header to \"{}\", error: \"{}\"", snooz_log_path_, strerror(errno));
   }
-  for (const auto& packet : data) {
-    if (!btsnooz_ostream.write(packet.data(), packet.size())) {
+  // The records are stored back to back, at most two writes stream them all
+  size_t used = btsnooz_head_ - btsnooz_tail_;
+  if (used != 0) {
+    size_t offset = btsnooz_tail_ % btsnooz_ring_.size();
+    size_t first_part = std::min(used, btsnooz_ring_.size() - offset);
+    if (!btsnooz_ostream.write(reinterpret_cast<const char*>(btsnooz_ring_.data() + offset), first_part) ||
+        !btsnooz_ostream.write(reinterpret_cast<const char*>(btsnooz_ring_.data()), used - first_part)) {
       log::error("Failed to write packet payload for btsnooz, error: \"{}\"", strerror(errno));
     }
   }
@@ -1323,6 +1635,9 @@ void SnoopLogger::Start() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (btsnoop_mode_ != kBtSnoopLogModeDisabled) {
     OpenNextSnoopLogFile();
+    if (async_flush_interval_ > std::chrono::milliseconds::zero()) {
+      StartAsyncWriter();
+    }
 
     if (btsnoop_mode_ == kBtSnoopLogModeFiltered) {
       EnableFilters();
@@ -1349,6 +1664,7 @@ void SnoopLogger::Start() {
 void SnoopLogger::Stop() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   log::debug("Closing btsnoop log data at {}", snoop_log_path_);
+  StopAsyncWriter();
   CloseCurrentSnoopLogFile();
 
   if (snoop_logger_socket_thread_ != nullptr) {
@@ -1373,7 +1689,7 @@ void SnoopLogger::Stop() {
 
 DumpsysDataFinisher SnoopLogger::GetDumpsysData(
     flatbuffers::FlatBufferBuilder* /* builder */) const {
-  DumpSnoozLogToFile(btsnooz_buffer_.Pull());
+  DumpSnoozLogToFile();
   return EmptyDumpsysDataFinisher;
 }
 
@@ -1392,6 +1708,32 @@ size_t SnoopLogger::GetMaxPacketsPerFile() {
   return max_packets_per_file;
 }
 
+std::chrono::milliseconds SnoopLogger::GetAsyncFlushInterval() {
+  auto flush_interval_prop = os::GetSystemProperty(kBtSnoopAsyncFlushIntervalProperty);
+  if (flush_interval_prop) {
+    auto flush_interval_ms = common::Uint64FromString(flush_interval_prop.value());
+    if (flush_interval_ms) {
+      return std::chrono::milliseconds(flush_interval_ms.value());
+    }
+  }
+  return std::chrono::milliseconds::zero();
+}
+
+bool SnoopLogger::IsBtSnoopCompressionEnabled() {
+  return os::GetSystemPropertyBool(kBtSnoopCompressionProperty, false);
+}
+
+size_t SnoopLogger::GetMaxBytesPerFile() {
+  auto max_bytes_per_file_prop = os::GetSystemProperty(kBtSnoopMaxBytesPerFileProperty);
+  if (max_bytes_per_file_prop) {
+    auto max_bytes_per_file = common::Uint64FromString(max_bytes_per_file_prop.value());
+    if (max_bytes_per_file) {
+      return max_bytes_per_file.value();
+    }
+  }
+  return 0;
+}
+
 size_t SnoopLogger::GetMaxPacketsPerBuffer() {
   // We want to use at most 256 KB memory for btsnooz log for release builds
   // and 512 KB memory for userdebug/eng builds
@@ -1468,7 +1810,10 @@ const ModuleFactory SnoopLogger::Factory = ModuleFactory([]() {
       IsQualcommDebugLogEnabled(),
       kBtSnoozLogLifeTime,
       kBtSnoozLogDeleteRepeatingAlarmInterval,
-      IsBtSnoopLogPersisted());
+      IsBtSnoopLogPersisted(),
+      GetAsyncFlushInterval(),
+      IsBtSnoopCompressionEnabled(),
+      GetMaxBytesPerFile());
 });
 
 }  // namespace hal
@@ -18,14 +18,21 @@
 
 #include <bluetooth/log.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
-#include "common/circular_buffer.h"
 #include "hal/hci_hal.h"
+#include "hal/snoop_logger_compressed_file.h"
+#include "hal/snoop_logger_ring_buffer.h"
 #include "hal/snoop_logger_socket_interface.h"
 #include "hal/snoop_logger_socket_thread.h"
 #include "hal/syscall_wrapper_impl.h"
@@ -144,6 +151,9 @@ class SnoopLogger : public ::bluetooth::Module {
   static const ModuleFactory Factory;
 
   static const std::string kBtSnoopMaxPacketsPerFileProperty;
+  static const std::string kBtSnoopAsyncFlushIntervalProperty;
+  static const std::string kBtSnoopCompressionProperty;
+  static const std::string kBtSnoopMaxBytesPerFileProperty;
   static const std::string kIsDebuggableProperty;
   static const std::string kBtSnoopLogModeProperty;
   static const std::string kBtSnoopLogPersists;
@@ -198,6 +208,20 @@ class SnoopLogger : public ::bluetooth::Module {
 
   static size_t GetMaxPacketsPerBuffer();
 
+  // Returns the flush interval of the background snoop log writer, zero when
+  // packets are written synchronously as they are captured
+  // Changes to this value is only effective after restarting Bluetooth
+  static std::chrono::milliseconds GetAsyncFlushInterval();
+
+  // Returns whether the background snoop log writer compresses the log
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsBtSnoopCompressionEnabled();
+
+  // Returns the size in bytes past which the background snoop log writer
+  // rotates to the next file, zero when only rotating by packet count
+  // Changes to this value is only effective after restarting Bluetooth
+  static size_t GetMaxBytesPerFile();
+
   // Get snoop logger mode based on current system setup
   // Changes to this values is only effective after restarting Bluetooth
   static std::string GetBtSnoopMode();
@@ -272,6 +296,9 @@ class SnoopLogger : public ::bluetooth::Module {
   static const uint32_t L2CAP_HEADER_SIZE;
   // Max packet data size when headersfiltered option enabled
   static const size_t MAX_HCI_ACL_LEN;
+  // Bytes at the beginning of an ACL packet the filters may rewrite: its
+  // headers and the magic string replacing the payload right after them
+  static constexpr size_t FILTERED_PREFIX_SIZE = 64;
 
   void ListDependencies(ModuleList* list) const override;
   void Start() override;
@@ -290,10 +317,15 @@ class SnoopLogger : public ::bluetooth::Module {
       bool qualcomm_debug_log_enabled,
       const std::chrono::milliseconds snooz_log_life_time,
       const std::chrono::milliseconds snooz_log_delete_alarm_interval,
-      bool snoop_log_persists);
+      bool snoop_log_persists,
+      const std::chrono::milliseconds async_flush_interval = std::chrono::milliseconds::zero(),
+      bool compression_enabled = false,
+      size_t max_bytes_per_file = 0);
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
-  void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
+  // Number of packets the background writer could not keep up with
+  uint64_t GetAsyncDroppedPacketCount() const;
+  void DumpSnoozLogToFile() const;
   // Enable filters according to their sysprops
   void EnableFilters();
   // Disable all filters
@@ -326,8 +358,10 @@ class SnoopLogger : public ::bluetooth::Module {
       uint16_t l2cap_channel,
       uint32_t& offset,
       uint32_t total_length);
+  // Filters a copy of the first FILTERED_PREFIX_SIZE bytes of an ACL packet,
+  // rewritten in place. The rest of the packet is never modified.
   void FilterCapturedPacket(
-      HciPacket& packet,
+      uint8_t* packet,
       Direction direction,
       PacketType type,
       uint32_t& length,
@@ -336,12 +370,59 @@ class SnoopLogger : public ::bluetooth::Module {
   std::unique_ptr<SnoopLoggerSocketThread> snoop_logger_socket_thread_;
 
  private:
+  // Filters in effect, compiled by EnableFilters() and DisableFilters() out of
+  // kBtSnoopLogFilterState and kBtSnoopLogFilterMode for the capture path
+  enum ActiveFilter : uint8_t {
+    kActiveFilterHeaders = 1 << 0,
+    kActiveFilterA2dp = 1 << 1,
+    kActiveFilterRfcomm = 1 << 2,
+    kActiveFilterProfiles = 1 << 3,
+  };
+  enum class ProfileFilterMode : uint8_t { kDisabled, kFullfilter, kHeader, kMagic };
+
+  // Payload of a captured packet as written to the log: the |head| bytes, then
+  // the |tail| bytes. Filtered packets have their head rewritten in a copy of
+  // the beginning of the packet, and their tail taken from the packet itself.
+  struct CapturedPayload {
+    const uint8_t* head;
+    size_t head_length;
+    const uint8_t* tail;
+    size_t tail_length;
+  };
+
+  bool IsActiveFilter(ActiveFilter filter) const {
+    return (active_filters_.load(std::memory_order_relaxed) & filter) != 0;
+  }
+  static ProfileFilterMode ParseProfileFilterMode(const std::string& mode);
+
+  // File operations only, without touching the packet counter
+  void CloseSnoopLogStream();
+  void OpenSnoopLogStream();
+  void OpenCompressedSnoopLogStream();
+  // Background writer: Capture() appends the records to |async_ring_| and the
+  // writer thread owns |btsnoop_ostream_| until it is stopped
+  void StartAsyncWriter();
+  void StopAsyncWriter();
+  void RunAsyncWriter();
+  void DrainAsyncRing(std::vector<uint8_t>& record);
+  void WriteAsyncRecord(const std::vector<uint8_t>& record);
+  void PushToAsyncRing(PacketHeaderType& header, const CapturedPayload& payload);
+  void WriteToSocket(const PacketHeaderType& header, const CapturedPayload& payload);
+  // In-memory btsnooz log, with file_mutex_ held
+  void PushToBtsnoozRing(const PacketHeaderType& header, const uint8_t* payload, size_t length);
+  void CopyFromBtsnoozRing(uint64_t position, void* data, size_t length) const;
+  size_t BtsnoozRecordSizeAt(uint64_t position) const;
+
   static std::string btsnoop_mode_;
   std::string snoop_log_path_;
   std::string snooz_log_path_;
   std::ofstream btsnoop_ostream_;
   size_t max_packets_per_file_;
-  common::CircularBuffer<std::string> btsnooz_buffer_;
+  // btsnooz records of the last packets, stored back to back in place of the
+  // oldest ones. |btsnooz_head_| and |btsnooz_tail_| are monotonic positions.
+  std::vector<uint8_t> btsnooz_ring_;
+  uint64_t btsnooz_head_ = 0;
+  uint64_t btsnooz_tail_ = 0;
   bool qualcomm_debug_log_enabled_ = false;
   size_t packet_counter_ = 0;
   mutable std::recursive_mutex file_mutex_;
@@ -351,6 +432,21 @@ class SnoopLogger : public ::bluetooth::Module {
   SnoopLoggerSocketInterface* socket_;
   SyscallWrapperImpl syscall_if;
   bool snoop_log_persists = false;
+  std::atomic<uint8_t> active_filters_ = 0;
+  std::atomic<ProfileFilterMode> pbap_filter_mode_ = ProfileFilterMode::kDisabled;
+  std::atomic<ProfileFilterMode> map_filter_mode_ = ProfileFilterMode::kDisabled;
+  std::chrono::milliseconds async_flush_interval_;
+  std::unique_ptr<SnoopLoggerRingBuffer> async_ring_;
+  std::thread async_writer_thread_;
+  std::mutex async_writer_mutex_;
+  std::condition_variable async_writer_cv_;
+  bool async_writer_running_ = false;
+  uint64_t async_reported_drops_ = 0;
+  // Compression and size based rotation, by the background writer only
+  bool compression_enabled_ = false;
+  size_t max_bytes_per_file_ = 0;
+  SnoopLoggerCompressedFile btsnoop_compressed_file_;
+  uint64_t btsnoop_file_size_ = 0;
 };
 
 }  // namespace hal
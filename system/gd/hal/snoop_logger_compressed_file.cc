@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_compressed_file.h"
+
+#include <bluetooth/log.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+// gzip wrapper around the deflate stream, readable with standard tools
+constexpr int kGzipWindowBits = 15 + 16;
+
+// Favor the speed, the log is compressed on the fly
+constexpr int kCompressionLevel = Z_BEST_SPEED;
+
+void StoreBigEndian(uint8_t* data, uint64_t value) {
+  for (int i = 7; i >= 0; i--) {
+    data[i] = static_cast<uint8_t>(value);
+    value >>= 8;
+  }
+}
+
+}  // namespace
+
+SnoopLoggerCompressedFile::~SnoopLoggerCompressedFile() {
+  Close();
+}
+
+bool SnoopLoggerCompressedFile::Open(
+    const std::string& path, const std::string& index_path, const void* header, size_t header_length) {
+  Close();
+
+  stream_ = {};
+  if (deflateInit2(&stream_, kCompressionLevel, Z_DEFLATED, kGzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    log::error("Unable to initialize the compression of \"{}\"", path);
+    return false;
+  }
+  open_ = true;
+  compressed_size_ = 0;
+  uncompressed_size_ = 0;
+  at_sync_point_ = false;
+
+  // do not use std::ios::app as we want override the existing files
+  file_.open(path, std::ios::binary | std::ios::out);
+  index_.open(index_path, std::ios::binary | std::ios::out);
+  if (!file_.good() || !index_.good() || !index_.write(kIndexMagic, sizeof(kIndexMagic))) {
+    log::error("Unable to open compressed snoop log at \"{}\"", path);
+    Close();
+    return false;
+  }
+
+  // The first sync point comes right after the file header
+  if (!Write(header, header_length, 0) || !Flush()) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool SnoopLoggerCompressedFile::Deflate(int flush) {
+  do {
+    stream_.next_out = output_buffer_.data();
+    stream_.avail_out = output_buffer_.size();
+    int ret = deflate(&stream_, flush);
+    if (ret == Z_STREAM_ERROR) {
+      log::error("Failed to compress the snoop log");
+      return false;
+    }
+    size_t produced = output_buffer_.size() - stream_.avail_out;
+    if (produced != 0 && !file_.write(reinterpret_cast<const char*>(output_buffer_.data()), produced)) {
+      log::error("Failed to write the compressed snoop log, error: \"{}\"", strerror(errno));
+      return false;
+    }
+    compressed_size_ += produced;
+  } while (stream_.avail_out == 0);
+  return true;
+}
+
+bool SnoopLoggerCompressedFile::Write(const void* record, size_t length, uint64_t timestamp) {
+  if (!open_) {
+    return false;
+  }
+
+  if (at_sync_point_) {
+    uint8_t entry[3 * sizeof(uint64_t)];
+    // The timestamp is stored as is, it is big endian already
+    std::memcpy(entry, &timestamp, sizeof(timestamp));
+    StoreBigEndian(entry + sizeof(uint64_t), compressed_size_);
+    StoreBigEndian(entry + 2 * sizeof(uint64_t), uncompressed_size_);
+    if (!index_.write(reinterpret_cast<const char*>(entry), sizeof(entry))) {
+      log::error("Failed to write the snoop log index, error: \"{}\"", strerror(errno));
+    }
+    at_sync_point_ = false;
+  }
+
+  stream_.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(record));
+  stream_.avail_in = length;
+  bool written = Deflate(Z_NO_FLUSH);
+  stream_.avail_in = 0;
+  uncompressed_size_ += length;
+  return written;
+}
+
+bool SnoopLoggerCompressedFile::Flush() {
+  if (!open_) {
+    return false;
+  }
+  if (at_sync_point_) {
+    // Nothing written since the last sync point
+    return true;
+  }
+
+  bool flushed = Deflate(Z_FULL_FLUSH);
+  if (!file_.flush() || !index_.flush()) {
+    log::error("Failed to flush, error: \"{}\"", strerror(errno));
+    flushed = false;
+  }
+  at_sync_point_ = true;
+  return flushed;
+}
+
+void SnoopLoggerCompressedFile::Close() {
+  if (!open_) {
+    return;
+  }
+  Deflate(Z_FINISH);
+  deflateEnd(&stream_);
+  file_.close();
+  index_.close();
+  open_ = false;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <zlib.h>
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace bluetooth {
+namespace hal {
+
+// gzip compressed btsnoop log, with a sidecar index of its sync points.
+//
+// Each Flush() ends a deflate block with a full flush, from where the data can
+// be inflated without the preceding bytes. The index file starts with
+// kIndexMagic and holds one entry per sync point, made of three big endian
+// 64 bit values:
+//  - the btsnoop timestamp of the first record after the sync point,
+//  - the offset of the sync point in the compressed file,
+//  - the offset of that record in the decompressed btsnoop log.
+// system/tools/scripts/btsnoop_decompress.py decompresses the log, optionally
+// from a given time using the index.
+class SnoopLoggerCompressedFile {
+ public:
+  static constexpr char kIndexMagic[8] = {'B', 'T', 'S', 'N', 'P', 'I', 'D', 'X'};
+
+  SnoopLoggerCompressedFile() = default;
+  SnoopLoggerCompressedFile(const SnoopLoggerCompressedFile&) = delete;
+  SnoopLoggerCompressedFile& operator=(const SnoopLoggerCompressedFile&) = delete;
+  ~SnoopLoggerCompressedFile();
+
+  // Creates |path| and |index_path|, overwriting them, and writes |header| as
+  // the beginning of the decompressed log
+  bool Open(
+      const std::string& path, const std::string& index_path, const void* header, size_t header_length);
+  bool IsOpen() const {
+    return open_;
+  }
+
+  // Appends a btsnoop record. |timestamp| is the timestamp field of its
+  // header, as stored in the record.
+  bool Write(const void* record, size_t length, uint64_t timestamp);
+
+  // Pushes everything written so far to the file and starts a new sync point
+  bool Flush();
+
+  // Ends the gzip stream and closes both files
+  void Close();
+
+  // Number of compressed bytes written to the file
+  uint64_t GetSize() const {
+    return compressed_size_;
+  }
+
+ private:
+  bool Deflate(int flush);
+
+  z_stream stream_{};
+  bool open_ = false;
+  std::ofstream file_;
+  std::ofstream index_;
+  uint64_t compressed_size_ = 0;
+  uint64_t uncompressed_size_ = 0;
+  bool at_sync_point_ = false;
+  std::array<uint8_t, 16 * 1024> output_buffer_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
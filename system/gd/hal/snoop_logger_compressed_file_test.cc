@@ -0,0 +1,166 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_compressed_file.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::hal::SnoopLoggerCompressedFile;
+
+namespace {
+
+constexpr size_t kIndexEntrySize = 3 * sizeof(uint64_t);
+
+std::vector<uint8_t> ReadFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+uint64_t LoadBigEndian(const uint8_t* data) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; i++) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+// Inflates |data| from |offset|, with the gzip header at offset 0 or raw deflate data otherwise
+std::vector<uint8_t> Inflate(const std::vector<uint8_t>& data, size_t offset) {
+  z_stream stream{};
+  EXPECT_EQ(inflateInit2(&stream, offset == 0 ? 15 + 16 : -15), Z_OK);
+  std::vector<uint8_t> output;
+  std::vector<uint8_t> buffer(4096);
+  stream.next_in = const_cast<Bytef*>(data.data() + offset);
+  stream.avail_in = data.size() - offset;
+  int ret;
+  do {
+    stream.next_out = buffer.data();
+    stream.avail_out = buffer.size();
+    ret = inflate(&stream, Z_NO_FLUSH);
+    output.insert(output.end(), buffer.begin(), buffer.end() - stream.avail_out);
+  } while (ret == Z_OK && stream.avail_out == 0);
+  inflateEnd(&stream);
+  return output;
+}
+
+}  // namespace
+
+class SnoopLoggerCompressedFileTest : public Test {
+ protected:
+  void SetUp() override {
+    const auto* test_info = UnitTest::GetInstance()->current_test_info();
+    path_ = std::filesystem::temp_directory_path() / (std::string(test_info->name()) + "_btsnoop_hci.log.gz");
+    index_path_ = path_.string() + ".idx";
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+    std::filesystem::remove(index_path_);
+  }
+
+  std::vector<uint8_t> MakeRecord(uint32_t number) {
+    std::vector<uint8_t> record(40, static_cast<uint8_t>(number));
+    std::memcpy(record.data(), &number, sizeof(number));
+    return record;
+  }
+
+  std::filesystem::path path_;
+  std::filesystem::path index_path_;
+  const std::vector<uint8_t> header_ = {'b', 't', 's', 'n', 'o', 'o', 'p', 0};
+};
+
+TEST_F(SnoopLoggerCompressedFileTest, decompresses_to_written_data_test) {
+  SnoopLoggerCompressedFile file;
+  ASSERT_TRUE(file.Open(path_.string(), index_path_.string(), header_.data(), header_.size()));
+
+  std::vector<uint8_t> expected = header_;
+  for (uint32_t i = 0; i < 1000; i++) {
+    auto record = MakeRecord(i);
+    ASSERT_TRUE(file.Write(record.data(), record.size(), i));
+    expected.insert(expected.end(), record.begin(), record.end());
+  }
+  file.Close();
+
+  auto compressed = ReadFile(path_);
+  ASSERT_LT(compressed.size(), expected.size());
+  ASSERT_EQ(Inflate(compressed, 0), expected);
+}
+
+TEST_F(SnoopLoggerCompressedFileTest, flushed_data_readable_before_close_test) {
+  SnoopLoggerCompressedFile file;
+  ASSERT_TRUE(file.Open(path_.string(), index_path_.string(), header_.data(), header_.size()));
+  auto record = MakeRecord(1);
+  ASSERT_TRUE(file.Write(record.data(), record.size(), 1));
+  ASSERT_TRUE(file.Flush());
+
+  auto compressed = ReadFile(path_);
+  ASSERT_EQ(compressed.size(), file.GetSize());
+  std::vector<uint8_t> expected = header_;
+  expected.insert(expected.end(), record.begin(), record.end());
+  ASSERT_EQ(Inflate(compressed, 0), expected);
+}
+
+TEST_F(SnoopLoggerCompressedFileTest, index_points_at_sync_points_test) {
+  SnoopLoggerCompressedFile file;
+  ASSERT_TRUE(file.Open(path_.string(), index_path_.string(), header_.data(), header_.size()));
+
+  std::vector<uint8_t> uncompressed = header_;
+  for (uint32_t block = 0; block < 5; block++) {
+    for (uint32_t i = 0; i < 10; i++) {
+      uint32_t number = block * 10 + i;
+      auto record = MakeRecord(number);
+      uint64_t timestamp = 0;
+      std::memcpy(&timestamp, record.data(), sizeof(number));
+      ASSERT_TRUE(file.Write(record.data(), record.size(), timestamp));
+      uncompressed.insert(uncompressed.end(), record.begin(), record.end());
+    }
+    ASSERT_TRUE(file.Flush());
+  }
+  file.Close();
+
+  auto compressed = ReadFile(path_);
+  auto index = ReadFile(index_path_);
+  ASSERT_EQ(index.size(), sizeof(SnoopLoggerCompressedFile::kIndexMagic) + 5 * kIndexEntrySize);
+  ASSERT_EQ(
+      std::memcmp(index.data(), SnoopLoggerCompressedFile::kIndexMagic, sizeof(SnoopLoggerCompressedFile::kIndexMagic)),
+      0);
+
+  for (uint32_t block = 0; block < 5; block++) {
+    const uint8_t* entry = index.data() + sizeof(SnoopLoggerCompressedFile::kIndexMagic) + block * kIndexEntrySize;
+    uint32_t first_number;
+    std::memcpy(&first_number, entry, sizeof(first_number));
+    ASSERT_EQ(first_number, block * 10);
+
+    // Each sync point inflates on its own to the rest of the log
+    uint64_t compressed_offset = LoadBigEndian(entry + sizeof(uint64_t));
+    uint64_t uncompressed_offset = LoadBigEndian(entry + 2 * sizeof(uint64_t));
+    ASSERT_NE(compressed_offset, 0u);
+    ASSERT_EQ(
+        Inflate(compressed, compressed_offset),
+        std::vector<uint8_t>(uncompressed.begin() + uncompressed_offset, uncompressed.end()));
+  }
+}
+
+}  // namespace testing
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+using RecordLengthType = uint32_t;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = sizeof(RecordLengthType);
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace
+
+SnoopLoggerRingBuffer::SnoopLoggerRingBuffer(size_t capacity)
+    : storage_(RoundUpToPowerOfTwo(capacity)), mask_(storage_.size() - 1) {}
+
+void SnoopLoggerRingBuffer::CopyIn(uint64_t position, const void* data, size_t length) {
+  size_t offset = position & mask_;
+  size_t first_part = std::min(length, storage_.size() - offset);
+  std::memcpy(storage_.data() + offset, data, first_part);
+  std::memcpy(storage_.data(), static_cast<const uint8_t*>(data) + first_part, length - first_part);
+}
+
+void SnoopLoggerRingBuffer::CopyOut(uint64_t position, void* data, size_t length) const {
+  size_t offset = position & mask_;
+  size_t first_part = std::min(length, storage_.size() - offset);
+  std::memcpy(data, storage_.data() + offset, first_part);
+  std::memcpy(static_cast<uint8_t*>(data) + first_part, storage_.data(), length - first_part);
+}
+
+bool SnoopLoggerRingBuffer::Push(
+    const void* first,
+    size_t first_length,
+    const void* second,
+    size_t second_length,
+    const void* third,
+    size_t third_length) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  uint64_t tail = tail_.load(std::memory_order_acquire);
+  size_t record_length = first_length + second_length + third_length;
+
+  if (sizeof(RecordLengthType) + record_length > storage_.size() - (head - tail)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  RecordLengthType length = static_cast<RecordLengthType>(record_length);
+  CopyIn(head, &length, sizeof(length));
+  head += sizeof(length);
+  if (first_length != 0) {
+    CopyIn(head, first, first_length);
+    head += first_length;
+  }
+  if (second_length != 0) {
+    CopyIn(head, second, second_length);
+    head += second_length;
+  }
+  if (third_length != 0) {
+    CopyIn(head, third, third_length);
+    head += third_length;
+  }
+
+  // Publish the record bytes before its position
+  head_.store(head, std::memory_order_release);
+  return true;
+}
+
+bool SnoopLoggerRingBuffer::Pop(std::vector<uint8_t>& record) {
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  uint64_t head = head_.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+
+  RecordLengthType length;
+  CopyOut(tail, &length, sizeof(length));
+  tail += sizeof(length);
+  record.resize(length);
+  CopyOut(tail, record.data(), length);
+  tail += length;
+
+  // Release the room only once the record bytes are copied out
+  tail_.store(tail, std::memory_order_release);
+  return true;
+}
+
+size_t SnoopLoggerRingBuffer::Size() const {
+  // Load the tail first, the head read afterwards cannot be behind it
+  uint64_t tail = tail_.load(std::memory_order_acquire);
+  return head_.load(std::memory_order_acquire) - tail;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
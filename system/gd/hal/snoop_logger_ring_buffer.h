@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+
+// Preallocated byte ring carrying snoop log records from a single producer to a
+// single consumer without locking. Each record is stored as a 32 bit length
+// followed by its bytes, possibly wrapping around the end of the storage.
+// A record that does not fit is dropped and counted instead of waiting for the
+// consumer. Empty records are valid and can be used as markers.
+class SnoopLoggerRingBuffer {
+ public:
+  // |capacity| is rounded up to the next power of two
+  explicit SnoopLoggerRingBuffer(size_t capacity);
+  SnoopLoggerRingBuffer(const SnoopLoggerRingBuffer&) = delete;
+  SnoopLoggerRingBuffer& operator=(const SnoopLoggerRingBuffer&) = delete;
+
+  // Producer side. Appends the concatenation of |first|, |second| and |third| as
+  // a single record. Returns false if the record was dropped for lack of room.
+  bool Push(
+      const void* first,
+      size_t first_length,
+      const void* second = nullptr,
+      size_t second_length = 0,
+      const void* third = nullptr,
+      size_t third_length = 0);
+
+  // Consumer side. Moves the oldest record into |record|, returns false if the
+  // ring is empty.
+  bool Pop(std::vector<uint8_t>& record);
+
+  // Number of bytes currently used, records and their lengths included
+  size_t Size() const;
+  size_t Capacity() const {
+    return storage_.size();
+  }
+  // Number of records dropped since construction
+  uint64_t GetDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void CopyIn(uint64_t position, const void* data, size_t length);
+  void CopyOut(uint64_t position, void* data, size_t length) const;
+
+  std::vector<uint8_t> storage_;
+  const uint64_t mask_;
+  // Monotonic byte positions, written by the producer and the consumer respectively
+  std::atomic<uint64_t> head_ = 0;
+  std::atomic<uint64_t> tail_ = 0;
+  std::atomic<uint64_t> dropped_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
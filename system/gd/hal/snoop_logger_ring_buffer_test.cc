@@ -0,0 +1,121 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_logger_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <thread>
+
+namespace testing {
+
+using bluetooth::hal::SnoopLoggerRingBuffer;
+
+TEST(SnoopLoggerRingBufferTest, capacity_is_power_of_two) {
+  SnoopLoggerRingBuffer ring(100);
+  ASSERT_EQ(ring.Capacity(), 128u);
+  ASSERT_EQ(ring.Size(), 0u);
+}
+
+TEST(SnoopLoggerRingBufferTest, push_and_pop_test) {
+  SnoopLoggerRingBuffer ring(64);
+  std::vector<uint8_t> header = {0x01, 0x02};
+  std::vector<uint8_t> payload = {0x03, 0x04, 0x05};
+  std::vector<uint8_t> record;
+
+  ASSERT_FALSE(ring.Pop(record));
+  ASSERT_TRUE(ring.Push(header.data(), header.size(), payload.data(), payload.size()));
+  ASSERT_TRUE(ring.Push(nullptr, 0));
+
+  ASSERT_TRUE(ring.Pop(record));
+  ASSERT_EQ(record, std::vector<uint8_t>({0x01, 0x02, 0x03, 0x04, 0x05}));
+  ASSERT_TRUE(ring.Pop(record));
+  ASSERT_TRUE(record.empty());
+  ASSERT_FALSE(ring.Pop(record));
+  ASSERT_EQ(ring.Size(), 0u);
+}
+
+TEST(SnoopLoggerRingBufferTest, push_three_parts_test) {
+  SnoopLoggerRingBuffer ring(64);
+  std::vector<uint8_t> header = {0x01};
+  std::vector<uint8_t> head = {0x02, 0x03};
+  std::vector<uint8_t> tail = {0x04};
+  std::vector<uint8_t> record;
+
+  ASSERT_TRUE(ring.Push(header.data(), header.size(), head.data(), head.size(), tail.data(), tail.size()));
+  ASSERT_TRUE(ring.Pop(record));
+  ASSERT_EQ(record, std::vector<uint8_t>({0x01, 0x02, 0x03, 0x04}));
+}
+
+TEST(SnoopLoggerRingBufferTest, records_wrap_around_test) {
+  SnoopLoggerRingBuffer ring(32);
+  std::vector<uint8_t> record;
+
+  for (uint8_t i = 0; i < 100; i++) {
+    std::vector<uint8_t> data(11, i);
+    ASSERT_TRUE(ring.Push(data.data(), data.size()));
+    ASSERT_TRUE(ring.Pop(record));
+    ASSERT_EQ(record, data);
+  }
+  ASSERT_EQ(ring.GetDroppedCount(), 0u);
+}
+
+TEST(SnoopLoggerRingBufferTest, drops_when_full_test) {
+  SnoopLoggerRingBuffer ring(32);
+  std::vector<uint8_t> data(12, 0xab);
+  std::vector<uint8_t> record;
+
+  // Each record takes 16 bytes with its length
+  ASSERT_TRUE(ring.Push(data.data(), data.size()));
+  ASSERT_TRUE(ring.Push(data.data(), data.size()));
+  ASSERT_FALSE(ring.Push(data.data(), data.size()));
+  ASSERT_FALSE(ring.Push(nullptr, 0, data.data(), data.size()));
+  ASSERT_EQ(ring.GetDroppedCount(), 2u);
+
+  ASSERT_TRUE(ring.Pop(record));
+  ASSERT_TRUE(ring.Push(data.data(), data.size()));
+  ASSERT_EQ(ring.GetDroppedCount(), 2u);
+}
+
+TEST(SnoopLoggerRingBufferTest, concurrent_producer_consumer_test) {
+  SnoopLoggerRingBuffer ring(256);
+  constexpr uint32_t kNumRecords = 100000;
+
+  std::thread producer([&ring]() {
+    for (uint32_t i = 0; i < kNumRecords; i++) {
+      while (!ring.Push(&i, sizeof(i))) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<uint8_t> record;
+  uint32_t expected = 0;
+  while (expected < kNumRecords) {
+    if (!ring.Pop(record)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(record.size(), sizeof(uint32_t));
+    uint32_t value;
+    std::memcpy(&value, record.data(), sizeof(value));
+    ASSERT_EQ(value, expected++);
+  }
+  producer.join();
+}
+
+}  // namespace testing
@@ -21,8 +21,13 @@
 #include <gtest/gtest.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <zlib.h>
 
+#include <cstring>
+#include <fstream>
 #include <future>
+#include <iterator>
+#include <thread>
 #include <unordered_map>
 
 #include "common/init_flags.h"
@@ -124,7 +129,10 @@ class TestSnoopLoggerModule : public SnoopLogger {
       size_t max_packets_per_file,
       const std::string& btsnoop_mode,
       bool qualcomm_debug_log_enabled,
-      bool snoop_log_persists)
+      bool snoop_log_persists,
+      std::chrono::milliseconds async_flush_interval = 0ms,
+      bool compression_enabled = false,
+      size_t max_bytes_per_file = 0)
       : SnoopLogger(
             std::move(snoop_log_path),
             std::move(snooz_log_path),
@@ -134,7 +142,10 @@ class TestSnoopLoggerModule : public SnoopLogger {
             qualcomm_debug_log_enabled,
             20ms,
             5ms,
-            snoop_log_persists) {}
+            snoop_log_persists,
+            async_flush_interval,
+            compression_enabled,
+            max_bytes_per_file) {}
 
   std::string ToString() const override {
     return std::string("TestSnoopLoggerModule");
@@ -148,6 +159,10 @@ class TestSnoopLoggerModule : public SnoopLogger {
     return snoop_logger_socket_thread_.get();
   }
 
+  uint64_t CallGetAsyncDroppedPacketCount() const {
+    return GetAsyncDroppedPacketCount();
+  }
+
   static uint32_t GetL2capHeaderSize() {
     return L2CAP_HEADER_SIZE;
   }
@@ -321,6 +336,48 @@ TEST_F(SnoopLoggerModuleTest, capture_hci_cmd_btsnooz_test) {
   ASSERT_FALSE(std::filesystem::exists(temp_snooz_log_));
 }
 
+TEST_F(SnoopLoggerModuleTest, btsnooz_overwrites_oldest_packets_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeDisabled,
+      false,
+      false);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  // Commands numbered in their parameters, more than the btsnooz log can hold
+  const uint32_t num_packets = SnoopLogger::GetMaxPacketsPerBuffer() * 10;
+  for (uint32_t i = 0; i < num_packets; i++) {
+    bluetooth::hal::HciPacket packet = {0x01, 0x10, 0x04};
+    packet.insert(packet.end(), reinterpret_cast<uint8_t*>(&i), reinterpret_cast<uint8_t*>(&i) + sizeof(i));
+    snoop_logger->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+  snoop_logger->CallGetDumpsysData(builder_);
+
+  // The dump holds whole records, the newest ones in order
+  const size_t record_size = sizeof(SnoopLogger::PacketHeaderType) + 3 + sizeof(uint32_t);
+  ASSERT_TRUE(std::filesystem::exists(temp_snooz_log_));
+  size_t records_size = std::filesystem::file_size(temp_snooz_log_) - sizeof(SnoopLoggerCommon::FileHeaderType);
+  ASSERT_EQ(records_size % record_size, 0u);
+  size_t num_records = records_size / record_size;
+  ASSERT_GT(num_records, 0u);
+  ASSERT_LT(num_records, num_packets);
+
+  std::ifstream snooz_file(temp_snooz_log_, std::ios::binary);
+  snooz_file.seekg(sizeof(SnoopLoggerCommon::FileHeaderType));
+  std::vector<uint8_t> record(record_size);
+  for (uint32_t expected = num_packets - num_records; expected < num_packets; expected++) {
+    ASSERT_TRUE(snooz_file.read(reinterpret_cast<char*>(record.data()), record_size));
+    uint32_t number;
+    std::memcpy(&number, record.data() + record_size - sizeof(number), sizeof(number));
+    ASSERT_EQ(number, expected);
+  }
+
+  test_registry->StopAll();
+}
+
 TEST_F(SnoopLoggerModuleTest, capture_l2cap_signal_packet_btsnooz_test) {
   // Actual test
   auto* snoop_logger = new TestSnoopLoggerModule(
@@ -544,6 +601,139 @@ TEST_F(SnoopLoggerModuleTest, rotate_file_after_full_test) {
           (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
 }
 
+TEST_F(SnoopLoggerModuleTest, async_writer_rotate_file_after_full_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      10ms);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 25; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+  ASSERT_EQ(snoop_logger->CallGetAsyncDroppedPacketCount(), 0u);
+
+  // Stopping drains the packets not written yet
+  test_registry->StopAll();
+
+  // Verify states after test
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_last_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 5);
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_last_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
+}
+
+TEST_F(SnoopLoggerModuleTest, async_writer_flushes_periodically_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      5ms);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+
+  auto expected_size = sizeof(SnoopLoggerCommon::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType) +
+                       kInformationRequest.size();
+  for (int i = 0; i < 200 && std::filesystem::file_size(temp_snoop_log_) != expected_size; i++) {
+    std::this_thread::sleep_for(5ms);
+  }
+  ASSERT_EQ(std::filesystem::file_size(temp_snoop_log_), expected_size);
+
+  test_registry->StopAll();
+}
+
+TEST_F(SnoopLoggerModuleTest, async_writer_compressed_log_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      100,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      10ms,
+      true);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 25; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  test_registry->StopAll();
+
+  // Verify states after test
+  const std::filesystem::path compressed_log = temp_snoop_log_.string() + ".gz";
+  ASSERT_FALSE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(compressed_log));
+  ASSERT_TRUE(std::filesystem::exists(compressed_log.string() + ".idx"));
+
+  std::ifstream compressed_file(compressed_log, std::ios::binary);
+  std::vector<uint8_t> compressed(
+      (std::istreambuf_iterator<char>(compressed_file)), std::istreambuf_iterator<char>());
+  std::vector<uint8_t> decompressed(64 * 1024);
+  z_stream stream{};
+  ASSERT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+  stream.next_in = compressed.data();
+  stream.avail_in = compressed.size();
+  stream.next_out = decompressed.data();
+  stream.avail_out = decompressed.size();
+  ASSERT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+  inflateEnd(&stream);
+  ASSERT_EQ(
+      stream.total_out,
+      sizeof(SnoopLoggerCommon::FileHeaderType) +
+          (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 25);
+
+  std::filesystem::remove(compressed_log);
+  std::filesystem::remove(compressed_log.string() + ".idx");
+}
+
+TEST_F(SnoopLoggerModuleTest, async_writer_rotate_file_by_size_test) {
+  const size_t packet_size = sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size();
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      100,
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      10ms,
+      false,
+      sizeof(SnoopLoggerCommon::FileHeaderType) + packet_size * 4);
+  test_registry->InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 10; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  test_registry->StopAll();
+
+  // Verify states after test
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) + packet_size * 2);
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_last_),
+      sizeof(SnoopLoggerCommon::FileHeaderType) + packet_size * 4);
+}
+
 TEST_F(SnoopLoggerModuleTest, qualcomm_debug_log_test) {
   auto* snoop_logger = new TestSnoopLoggerModule(
       temp_snoop_log_.string(),
@@ -790,6 +980,41 @@ TEST_F(SnoopLoggerModuleTest, headers_filtered_test) {
   ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_filtered));
 }
 
+TEST_F(SnoopLoggerModuleTest, filtered_long_packet_unchanged_test) {
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      10,
+      SnoopLogger::kBtSnoopLogModeFiltered,
+      false,
+      false);
+
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  // Longer than the part of the packet the filters work on
+  std::vector<uint8_t> kAclPacket = {0x0b, 0x20, 0xfc, 0x00, 0xf8, 0x00, 0x44, 0x00};
+  for (int i = 0; i < 0xf8; i++) {
+    kAclPacket.push_back(static_cast<uint8_t>(i));
+  }
+
+  snoop_logger->Capture(kAclPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
+
+  test_registry.StopAll();
+
+  // No filter enabled, the packet is written as is
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_filtered));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_filtered),
+      sizeof(SnoopLoggerCommon::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType) + kAclPacket.size());
+  std::ifstream snoop_file(temp_snoop_log_filtered, std::ios::binary);
+  snoop_file.seekg(sizeof(SnoopLoggerCommon::FileHeaderType) + sizeof(SnoopLogger::PacketHeaderType));
+  std::vector<uint8_t> payload(kAclPacket.size());
+  ASSERT_TRUE(snoop_file.read(reinterpret_cast<char*>(payload.data()), payload.size()));
+  ASSERT_EQ(payload, kAclPacket);
+  ASSERT_TRUE(std::filesystem::remove(temp_snoop_log_filtered));
+}
+
 TEST_F(SnoopLoggerModuleTest, rfcomm_channel_filtered_sabme_ua_test) {
   // Actual test
   uint16_t conn_handle = 0x000b;
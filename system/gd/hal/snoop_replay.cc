@@ -0,0 +1,224 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_replay.h"
+
+#include <bluetooth/log.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "hal/snoop_logger_common.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+// Length, captured length, flags, dropped packets and timestamp of a btsnoop record
+constexpr size_t kRecordHeaderSize = 24;
+// Flag of the records sent by the controller
+constexpr uint32_t kIncomingFlag = 0x01;
+
+// How long the replay waits for a command before checking whether it is stopped
+constexpr auto kCommandPollInterval = std::chrono::milliseconds(10);
+
+uint64_t ReadBigEndian(const uint8_t* data, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; i++) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+// The opcode of the command answered by a Command Complete or Command Status event, nullopt for the other events
+std::optional<hci::OpCode> GetAnsweredOpCode(const HciPacket& event) {
+  // Event code, parameter length, number of command packets, opcode
+  if (event.size() >= 5 && event[0] == static_cast<uint8_t>(hci::EventCode::COMMAND_COMPLETE)) {
+    return static_cast<hci::OpCode>(event[3] | (event[4] << 8));
+  }
+  // Event code, parameter length, status, number of command packets, opcode
+  if (event.size() >= 6 && event[0] == static_cast<uint8_t>(hci::EventCode::COMMAND_STATUS)) {
+    return static_cast<hci::OpCode>(event[4] | (event[5] << 8));
+  }
+  return std::nullopt;
+}
+
+}  // namespace
+
+std::optional<std::vector<SnoopRecord>> ReadSnoopFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    log::error("Unable to open {}", path);
+    return std::nullopt;
+  }
+  std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  const auto& file_header = SnoopLoggerCommon::kBtSnoopFileHeader;
+  if (content.size() < sizeof(file_header) || std::memcmp(content.data(), &file_header, sizeof(file_header)) != 0) {
+    log::error("{} is not a btsnoop file of H4 packets", path);
+    return std::nullopt;
+  }
+
+  std::vector<SnoopRecord> records;
+  std::optional<uint64_t> first_timestamp;
+  size_t offset = sizeof(file_header);
+  while (offset < content.size()) {
+    if (content.size() - offset < kRecordHeaderSize) {
+      log::error("{} ends with a truncated record", path);
+      return std::nullopt;
+    }
+    const uint8_t* header = content.data() + offset;
+    uint32_t original_length = ReadBigEndian(header, 4);
+    uint32_t captured_length = ReadBigEndian(header + 4, 4);
+    uint32_t flags = ReadBigEndian(header + 8, 4);
+    uint64_t timestamp = ReadBigEndian(header + 16, 8);
+    offset += kRecordHeaderSize;
+    if (captured_length == 0 || content.size() - offset < captured_length) {
+      log::error("{} ends with a truncated record", path);
+      return std::nullopt;
+    }
+
+    // Packets stripped by the snoop log filters cannot be replayed
+    if (captured_length == original_length) {
+      if (!first_timestamp.has_value()) {
+        first_timestamp = timestamp;
+      }
+      records.push_back(SnoopRecord{
+          .type = static_cast<SnoopLogger::PacketType>(content[offset]),
+          .incoming = (flags & kIncomingFlag) != 0,
+          .timestamp = std::chrono::microseconds(timestamp - *first_timestamp),
+          .packet = HciPacket(content.begin() + offset + 1, content.begin() + offset + captured_length),
+      });
+    }
+    offset += captured_length;
+  }
+  return records;
+}
+
+SnoopReplay::SnoopReplay(TestHciHal* hal, const std::vector<SnoopRecord>& records, double speed)
+    : hal_(hal), speed_(speed) {
+  for (const auto& record : records) {
+    if (!record.incoming) {
+      continue;
+    }
+    std::optional<hci::OpCode> op_code;
+    if (record.type == SnoopLogger::PacketType::EVT) {
+      op_code = GetAnsweredOpCode(record.packet);
+    }
+    // Command Complete events with no opcode only return command credits, and are replayed as they came
+    if (op_code.has_value() && *op_code != hci::OpCode::NONE) {
+      answers_[*op_code].events.push_back(record.packet);
+    } else {
+      packets_.push_back(record);
+    }
+  }
+}
+
+SnoopReplay::~SnoopReplay() {
+  Stop();
+}
+
+void SnoopReplay::StartAnsweringCommands() {
+  log::assert_that(!answering_thread_.joinable(), "assert failed: !answering_thread_.joinable()");
+  answering_ = true;
+  answering_thread_ = std::thread(&SnoopReplay::AnswerCommands, this);
+}
+
+void SnoopReplay::Stop() {
+  answering_ = false;
+  if (answering_thread_.joinable()) {
+    answering_thread_.join();
+  }
+}
+
+void SnoopReplay::AnswerCommands() {
+  while (answering_) {
+    auto command = hal_->GetSentCommand(kCommandPollInterval);
+    if (command.has_value()) {
+      Answer(*command);
+    }
+    // The capture holds the Number Of Completed Packets events of the controller, the data sent by the stack is
+    // dropped
+    while (hal_->GetSentAcl(std::chrono::milliseconds(0)).has_value()) {
+    }
+  }
+}
+
+void SnoopReplay::Answer(hci::CommandView command) {
+  hci::OpCode op_code = command.GetOpCode();
+  auto answers = answers_.find(op_code);
+  if (answers == answers_.end()) {
+    log::warn("No answer to {} in the capture", hci::OpCodeText(op_code));
+    unanswered_commands_++;
+    hal_->InjectEvent(hci::CommandStatusBuilder::Create(
+        hci::ErrorCode::UNKNOWN_HCI_COMMAND, 1, op_code, std::make_unique<packet::RawBuilder>()));
+    return;
+  }
+
+  auto& events = answers->second.events;
+  size_t index = std::min(answers->second.next, events.size() - 1);
+  answers->second.next++;
+  answered_commands_++;
+  hal_->callbacks->hciEventReceived(events[index]);
+}
+
+void SnoopReplay::Replay() {
+  log::assert_that(hal_->callbacks != nullptr, "assert failed: hal_->callbacks != nullptr");
+  auto start = std::chrono::steady_clock::now();
+  auto first_timestamp = packets_.empty() ? std::chrono::microseconds(0) : packets_.front().timestamp;
+  for (const auto& record : packets_) {
+    if (speed_ > 0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<std::chrono::microseconds>((record.timestamp - first_timestamp) / speed_));
+    }
+    switch (record.type) {
+      case SnoopLogger::PacketType::EVT:
+        hal_->callbacks->hciEventReceived(record.packet);
+        break;
+      case SnoopLogger::PacketType::ACL:
+        hal_->callbacks->aclDataReceived(record.packet);
+        break;
+      case SnoopLogger::PacketType::SCO:
+        hal_->callbacks->scoDataReceived(record.packet);
+        break;
+      case SnoopLogger::PacketType::ISO:
+        hal_->callbacks->isoDataReceived(record.packet);
+        break;
+      default:
+        continue;
+    }
+    replayed_packets_++;
+  }
+}
+
+size_t SnoopReplay::GetAnsweredCommandCount() const {
+  return answered_commands_;
+}
+
+size_t SnoopReplay::GetUnansweredCommandCount() const {
+  return unanswered_commands_;
+}
+
+size_t SnoopReplay::GetReplayedPacketCount() const {
+  return replayed_packets_;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hal/hci_hal.h"
+#include "hal/hci_hal_fake.h"
+#include "hal/snoop_logger.h"
+#include "hci/hci_packets.h"
+
+namespace bluetooth {
+namespace hal {
+
+// A packet of a btsnoop capture
+struct SnoopRecord {
+  SnoopLogger::PacketType type;
+  // Whether the packet was sent by the controller to the host
+  bool incoming;
+  // Time elapsed since the first packet of the capture
+  std::chrono::microseconds timestamp;
+  // The packet, without its H4 type byte
+  HciPacket packet;
+};
+
+// Read the packets of the btsnoop file at |path|, nullopt if it is not a complete btsnoop file with H4 packets
+std::optional<std::vector<SnoopRecord>> ReadSnoopFile(const std::string& path);
+
+// Replays the controller side of a btsnoop capture through a TestHciHal.
+//
+// The commands sent by the stack are answered with the Command Complete or Command Status events the controller sent
+// for the same opcode in the capture, in order, the last one being repeated once they are used up. The other packets
+// sent by the controller are fed to the stack by Replay(), at the recorded pace scaled by |speed|. The packets sent by
+// the host in the capture are ignored: the stack sends its own.
+class SnoopReplay {
+ public:
+  // |speed| of 2 replays the capture twice as fast as recorded, 0 replays it as fast as possible
+  SnoopReplay(TestHciHal* hal, const std::vector<SnoopRecord>& records, double speed);
+  SnoopReplay(const SnoopReplay&) = delete;
+  SnoopReplay& operator=(const SnoopReplay&) = delete;
+  ~SnoopReplay();
+
+  // Answer the commands sent by the stack from a thread of the replay, until Stop(). Must be called before the stack
+  // is started, as the controller is read on start.
+  void StartAnsweringCommands();
+
+  // Feed the packets sent by the controller in the capture, other than the command answers, and return once they
+  // were all fed. The stack must be started.
+  void Replay();
+
+  // Stop answering the commands, before the stack is stopped
+  void Stop();
+
+  size_t GetAnsweredCommandCount() const;
+  // Commands sent by the stack without an answer in the capture, which were rejected as unknown
+  size_t GetUnansweredCommandCount() const;
+  size_t GetReplayedPacketCount() const;
+
+ private:
+  struct Answers {
+    std::vector<HciPacket> events;
+    size_t next = 0;
+  };
+
+  void AnswerCommands();
+  void Answer(hci::CommandView command);
+
+  TestHciHal* const hal_;
+  const double speed_;
+  std::map<hci::OpCode, Answers> answers_;
+  std::vector<SnoopRecord> packets_;
+  std::thread answering_thread_;
+  std::atomic<bool> answering_{false};
+  std::atomic<size_t> answered_commands_{0};
+  std::atomic<size_t> unanswered_commands_{0};
+  std::atomic<size_t> replayed_packets_{0};
+};
+
+}  // namespace hal
+}  // namespace bluetooth
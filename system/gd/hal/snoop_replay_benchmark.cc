@@ -0,0 +1,294 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays a btsnoop capture against the HCI layer, the controller, the ACL manager and the LE scanning manager,
+// through a TestHciHal answering the commands of the stack from the capture. Each run reports:
+// - the CPU time of the stack thread, which runs all the modules, and of the whole process,
+// - the queue latency of the handler of each module, probed every millisecond,
+// - the allocations per replayed packet, counted over the whole process.
+//
+// Usage: bluetooth_benchmark_snoop_replay --snoop_file=<btsnoop_hci.log> [--replay_speed=<factor>]
+// The capture is replayed at its recorded pace by default, --replay_speed=0 replays it as fast as possible.
+
+#include <benchmark/benchmark.h>
+#include <bluetooth/log.h>
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bind.h"
+#include "common/task_stats.h"
+#include "hal/hci_hal.h"
+#include "hal/hci_hal_fake.h"
+#include "hal/snoop_replay.h"
+#include "hci/acl_manager.h"
+#include "hci/controller.h"
+#include "hci/hci_layer.h"
+#include "hci/le_scanning_manager.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/parameter_provider.h"
+
+using ::benchmark::State;
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+
+}  // namespace
+
+// Every allocation of the process is counted, including the ones of the stack threads and of the replay
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t /* size */) noexcept {
+  free(ptr);
+}
+
+namespace bluetooth {
+namespace hal {
+
+namespace {
+
+constexpr auto kProbeInterval = std::chrono::milliseconds(1);
+constexpr auto kTimeout = std::chrono::seconds(10);
+
+struct ProbedModule {
+  const char* name;
+  const ModuleFactory* factory;
+};
+
+const ProbedModule kProbedModules[] = {
+    {"HciLayer", &hci::HciLayer::Factory},
+    {"Controller", &hci::Controller::Factory},
+    {"AclManager", &hci::AclManager::Factory},
+    {"LeScanningManager", &hci::LeScanningManager::Factory},
+};
+
+double CpuTimeMs(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// The stack started on a TestHciHal, with the commands answered from the capture
+class ReplayedStack {
+ public:
+  ReplayedStack(const std::vector<SnoopRecord>& records, double speed) {
+    os::ParameterProvider::OverrideConfigFilePath(
+        (std::filesystem::temp_directory_path() / "snoop_replay_bt_config.conf").string());
+    hal_ = new TestHciHal;  // Ownership is transferred to registry
+    registry_.InjectTestModule(&HciHal::Factory, hal_);
+    replay_ = std::make_unique<SnoopReplay>(hal_, records, speed);
+    replay_->StartAnsweringCommands();
+
+    ModuleList modules;
+    modules.add<hci::AclManager>();
+    modules.add<hci::LeScanningManager>();
+    registry_.Start(&modules, &registry_.GetTestThread());
+  }
+
+  ReplayedStack(const ReplayedStack&) = delete;
+  ReplayedStack& operator=(const ReplayedStack&) = delete;
+
+  ~ReplayedStack() {
+    replay_->Stop();
+    registry_.StopAll();
+    os::ParameterProvider::OverrideConfigFilePath("");
+  }
+
+  SnoopReplay* GetReplay() {
+    return replay_.get();
+  }
+
+  os::Handler* GetHandler(const ModuleFactory* factory) const {
+    return registry_.GetTestModuleHandler(factory);
+  }
+
+  // CPU time of the stack thread, read from a task run by the thread
+  double GetStackCpuTimeMs() const {
+    std::promise<double> promise;
+    auto future = promise.get_future();
+    GetHandler(&hci::HciLayer::Factory)->Post(common::BindOnce(
+        [](std::promise<double>* promise) { promise->set_value(CpuTimeMs(CLOCK_THREAD_CPUTIME_ID)); },
+        common::Unretained(&promise)));
+    log::assert_that(future.wait_for(kTimeout) == std::future_status::ready, "The stack thread is stuck");
+    return future.get();
+  }
+
+  // Wait for the stack to handle the packets it was fed
+  void Synchronize() const {
+    for (const auto& module : kProbedModules) {
+      log::assert_that(registry_.SynchronizeModuleHandler(module.factory, kTimeout), "{} is stuck", module.name);
+    }
+  }
+
+ private:
+  TestModuleRegistry registry_;
+  TestHciHal* hal_ = nullptr;
+  std::unique_ptr<SnoopReplay> replay_;
+};
+
+// Posts a task to the handler of each module every kProbeInterval, and records how long it waited to run
+class HandlerLatencyProbe {
+ public:
+  explicit HandlerLatencyProbe(const ReplayedStack& stack) : latencies_(std::size(kProbedModules)) {
+    for (const auto& module : kProbedModules) {
+      handlers_.push_back(stack.GetHandler(module.factory));
+    }
+    thread_ = std::thread(&HandlerLatencyProbe::Run, this);
+  }
+
+  HandlerLatencyProbe(const HandlerLatencyProbe&) = delete;
+  HandlerLatencyProbe& operator=(const HandlerLatencyProbe&) = delete;
+
+  // The probes still queued hold a pointer to the probe, the handlers must be synchronized before it is destroyed
+  ~HandlerLatencyProbe() {
+    Stop();
+  }
+
+  void Stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  void Report(State& state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < latencies_.size(); i++) {
+      std::string name = kProbedModules[i].name;
+      state.counters[name + "_queue_p50_us"] = latencies_[i].Percentile(50);
+      state.counters[name + "_queue_p99_us"] = latencies_[i].Percentile(99);
+      state.counters[name + "_queue_max_us"] = latencies_[i].max_us;
+    }
+  }
+
+ private:
+  void Run() {
+    while (running_) {
+      for (size_t i = 0; i < handlers_.size(); i++) {
+        handlers_[i]->Post(common::BindOnce(
+            &HandlerLatencyProbe::Record, common::Unretained(this), i, std::chrono::steady_clock::now()));
+      }
+      std::this_thread::sleep_for(kProbeInterval);
+    }
+  }
+
+  void Record(size_t module, std::chrono::steady_clock::time_point posted) {
+    auto latency = std::chrono::steady_clock::now() - posted;
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_[module].Add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+  }
+
+  std::vector<os::Handler*> handlers_;
+  std::mutex mutex_;
+  std::vector<common::TaskStats::Histogram> latencies_;
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+}  // namespace
+
+static void BM_SnoopReplay(State& state, const std::vector<SnoopRecord>& records, double speed) {
+  for (auto _ : state) {
+    ReplayedStack stack(records, speed);
+    SnoopReplay* replay = stack.GetReplay();
+    HandlerLatencyProbe probe(stack);
+
+    uint64_t allocations = allocation_count.load();
+    double stack_cpu_ms = stack.GetStackCpuTimeMs();
+    double process_cpu_ms = CpuTimeMs(CLOCK_PROCESS_CPUTIME_ID);
+    auto start = std::chrono::steady_clock::now();
+
+    replay->Replay();
+    probe.Stop();
+    stack.Synchronize();
+
+    state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    state.counters["stack_cpu_ms"] = stack.GetStackCpuTimeMs() - stack_cpu_ms;
+    state.counters["process_cpu_ms"] = CpuTimeMs(CLOCK_PROCESS_CPUTIME_ID) - process_cpu_ms;
+    allocations = allocation_count.load() - allocations;
+
+    size_t packets = replay->GetReplayedPacketCount();
+    state.SetItemsProcessed(packets);
+    if (packets != 0) {
+      state.counters["allocs_per_packet"] = static_cast<double>(allocations) / packets;
+    }
+    state.counters["commands_answered"] = replay->GetAnsweredCommandCount();
+    state.counters["commands_unanswered"] = replay->GetUnansweredCommandCount();
+    probe.Report(state);
+  }
+}
+
+}  // namespace hal
+}  // namespace bluetooth
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+
+  std::string snoop_file;
+  double speed = 1;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.rfind("--snoop_file=", 0) == 0) {
+      snoop_file = arg.substr(std::strlen("--snoop_file="));
+    } else if (arg.rfind("--replay_speed=", 0) == 0) {
+      speed = std::atof(arg.substr(std::strlen("--replay_speed=")).c_str());
+    } else {
+      fprintf(stderr, "Unrecognized argument %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (snoop_file.empty()) {
+    fprintf(stderr, "Usage: %s --snoop_file=<btsnoop_hci.log> [--replay_speed=<factor>]\n", argv[0]);
+    return 1;
+  }
+
+  auto records = bluetooth::hal::ReadSnoopFile(snoop_file);
+  if (!records.has_value()) {
+    return 1;
+  }
+  ::benchmark::RegisterBenchmark(
+      "BM_SnoopReplay",
+      [&records, speed](State& state) { bluetooth::hal::BM_SnoopReplay(state, *records, speed); })
+      ->UseManualTime()
+      ->Unit(::benchmark::kMillisecond)
+      ->Iterations(1);
+  ::benchmark::RunSpecifiedBenchmarks();
+}
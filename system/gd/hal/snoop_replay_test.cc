@@ -0,0 +1,201 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_replay.h"
+
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include "hal/snoop_logger_common.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr uint32_t kCommandFlags = 0x02;
+constexpr uint32_t kEventFlags = 0x03;
+constexpr uint32_t kIncomingDataFlags = 0x01;
+
+// HCI Reset, and its Command Complete event
+const HciPacket kReset = {0x03, 0x0c, 0x00};
+const HciPacket kResetComplete = {0x0e, 0x04, 0x01, 0x03, 0x0c, 0x00};
+// Disconnection Complete event
+const HciPacket kDisconnectionComplete = {0x05, 0x04, 0x00, 0x40, 0x00, 0x13};
+// ACL packet with a 2 bytes payload
+const HciPacket kAcl = {0x40, 0x20, 0x02, 0x00, 0xaa, 0xbb};
+
+void WriteBigEndian(std::ofstream& file, uint64_t value, size_t size) {
+  for (size_t i = size; i > 0; i--) {
+    file.put(static_cast<char>(value >> (8 * (i - 1))));
+  }
+}
+
+class FakeHalCallbacks : public HciHalCallbacks {
+ public:
+  void hciEventReceived(HciPacket event) override {
+    Add(&events_, std::move(event));
+  }
+
+  void aclDataReceived(HciPacket data) override {
+    Add(&acl_, std::move(data));
+  }
+
+  void scoDataReceived(HciPacket /* data */) override {}
+
+  void isoDataReceived(HciPacket /* data */) override {}
+
+  std::vector<HciPacket> WaitForEvents(size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    received_.wait_for(lock, std::chrono::seconds(1), [this, count] { return events_.size() >= count; });
+    return events_;
+  }
+
+  std::vector<HciPacket> GetAcl() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return acl_;
+  }
+
+ private:
+  void Add(std::vector<HciPacket>* packets, HciPacket packet) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    packets->push_back(std::move(packet));
+    received_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable received_;
+  std::vector<HciPacket> events_;
+  std::vector<HciPacket> acl_;
+};
+
+class SnoopReplayTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    path_ = std::filesystem::temp_directory_path() / (std::string(test_info->name()) + "_btsnoop_hci.log");
+    hal_.registerIncomingPacketCallback(&callbacks_);
+  }
+
+  void TearDown() override {
+    hal_.unregisterIncomingPacketCallback();
+    std::filesystem::remove(path_);
+  }
+
+  // Writes a capture of a reset, followed by a disconnection and an ACL packet
+  void WriteCapture() {
+    std::ofstream file(path_, std::ios::binary);
+    file.write(
+        reinterpret_cast<const char*>(&SnoopLoggerCommon::kBtSnoopFileHeader),
+        sizeof(SnoopLoggerCommon::kBtSnoopFileHeader));
+    WriteRecord(file, SnoopLogger::PacketType::CMD, kCommandFlags, 1000, kReset);
+    WriteRecord(file, SnoopLogger::PacketType::EVT, kEventFlags, 1500, kResetComplete);
+    WriteRecord(file, SnoopLogger::PacketType::EVT, kEventFlags, 2000, kDisconnectionComplete);
+    WriteRecord(file, SnoopLogger::PacketType::ACL, kIncomingDataFlags, 2500, kAcl);
+  }
+
+  static void WriteRecord(
+      std::ofstream& file, SnoopLogger::PacketType type, uint32_t flags, uint64_t timestamp, const HciPacket& packet) {
+    WriteBigEndian(file, packet.size() + 1, 4);
+    WriteBigEndian(file, packet.size() + 1, 4);
+    WriteBigEndian(file, flags, 4);
+    WriteBigEndian(file, 0, 4);
+    WriteBigEndian(file, timestamp, 8);
+    file.put(static_cast<char>(type));
+    file.write(reinterpret_cast<const char*>(packet.data()), packet.size());
+  }
+
+  std::filesystem::path path_;
+  TestHciHal hal_;
+  FakeHalCallbacks callbacks_;
+};
+
+TEST_F(SnoopReplayTest, read_snoop_file) {
+  WriteCapture();
+  auto records = ReadSnoopFile(path_.string());
+  ASSERT_TRUE(records.has_value());
+  ASSERT_EQ(4u, records->size());
+
+  ASSERT_EQ(SnoopLogger::PacketType::CMD, (*records)[0].type);
+  ASSERT_FALSE((*records)[0].incoming);
+  ASSERT_EQ(std::chrono::microseconds(0), (*records)[0].timestamp);
+  ASSERT_EQ(kReset, (*records)[0].packet);
+
+  ASSERT_EQ(SnoopLogger::PacketType::ACL, (*records)[3].type);
+  ASSERT_TRUE((*records)[3].incoming);
+  ASSERT_EQ(std::chrono::microseconds(1500), (*records)[3].timestamp);
+  ASSERT_EQ(kAcl, (*records)[3].packet);
+}
+
+TEST_F(SnoopReplayTest, invalid_snoop_file_rejected) {
+  std::ofstream(path_, std::ios::binary) << "not a btsnoop file";
+  ASSERT_FALSE(ReadSnoopFile(path_.string()).has_value());
+}
+
+TEST_F(SnoopReplayTest, truncated_snoop_file_rejected) {
+  WriteCapture();
+  std::filesystem::resize_file(path_, std::filesystem::file_size(path_) - 1);
+  ASSERT_FALSE(ReadSnoopFile(path_.string()).has_value());
+}
+
+TEST_F(SnoopReplayTest, commands_answered_from_capture) {
+  WriteCapture();
+  SnoopReplay replay(&hal_, *ReadSnoopFile(path_.string()), 0);
+  replay.StartAnsweringCommands();
+
+  hal_.sendHciCommand(kReset);
+  ASSERT_EQ(std::vector<HciPacket>{kResetComplete}, callbacks_.WaitForEvents(1));
+
+  // The last answer is repeated once the answers of the capture are used up
+  hal_.sendHciCommand(kReset);
+  ASSERT_EQ(kResetComplete, callbacks_.WaitForEvents(2).back());
+  replay.Stop();
+
+  ASSERT_EQ(2u, replay.GetAnsweredCommandCount());
+  ASSERT_EQ(0u, replay.GetUnansweredCommandCount());
+}
+
+TEST_F(SnoopReplayTest, command_missing_from_capture_rejected) {
+  WriteCapture();
+  SnoopReplay replay(&hal_, *ReadSnoopFile(path_.string()), 0);
+  replay.StartAnsweringCommands();
+
+  // HCI Read Local Version Information, answered with an Unknown HCI Command status
+  hal_.sendHciCommand({0x01, 0x10, 0x00});
+  HciPacket expected = {0x0f, 0x04, 0x01, 0x01, 0x01, 0x10};
+  ASSERT_EQ(std::vector<HciPacket>{expected}, callbacks_.WaitForEvents(1));
+  replay.Stop();
+
+  ASSERT_EQ(1u, replay.GetUnansweredCommandCount());
+}
+
+TEST_F(SnoopReplayTest, controller_packets_replayed) {
+  WriteCapture();
+  SnoopReplay replay(&hal_, *ReadSnoopFile(path_.string()), 0);
+  replay.Replay();
+
+  // The command answers are only sent for the commands of the stack
+  ASSERT_EQ(std::vector<HciPacket>{kDisconnectionComplete}, callbacks_.WaitForEvents(1));
+  ASSERT_EQ(std::vector<HciPacket>{kAcl}, callbacks_.GetAcl());
+  ASSERT_EQ(2u, replay.GetReplayedPacketCount());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
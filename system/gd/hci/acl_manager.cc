@@ -84,7 +84,13 @@ struct AclManager::impl {
           crash_on_unknown_handle,
           acl_scheduler_,
           remote_name_request_module_);
-      le_impl_ = new le_impl(hci_layer_, controller_, handler_, round_robin_scheduler_, crash_on_unknown_handle);
+      le_impl_ = new le_impl(
+          hci_layer_,
+          controller_,
+          handler_,
+          round_robin_scheduler_,
+          crash_on_unknown_handle,
+          acl_manager_.GetDependency<storage::StorageModule>());
     }
 
     hci_queue_end_ = hci_layer_->GetAclQueueEnd();
@@ -332,6 +338,10 @@ void AclManager::CancelLeConnect(AddressWithType address_with_type) {
   CallOn(pimpl_->le_impl_, &le_impl::cancel_connect, address_with_type);
 }
 
+void AclManager::CancelLeConnects(std::vector<AddressWithType> address_with_types) {
+  CallOn(pimpl_->le_impl_, &le_impl::cancel_connects, std::move(address_with_types));
+}
+
 void AclManager::RemoveFromBackgroundList(AddressWithType address_with_type) {
   CallOn(pimpl_->le_impl_, &le_impl::remove_device_from_background_connection_list, address_with_type);
 }
@@ -422,6 +432,10 @@ void AclManager::HACK_SetAclTxPriority(uint8_t handle, bool high_priority) {
   CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkPriority, handle, high_priority);
 }
 
+void AclManager::SetAclTxWeight(uint16_t handle, uint16_t weight) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkWeight, handle, weight);
+}
+
 void AclManager::ListDependencies(ModuleList* list) const {
   list->add<HciLayer>();
   list->add<Controller>();
@@ -466,12 +480,80 @@ void AclManager::impl::Dump(
   }
   auto vecofstrings = fb_builder->CreateVector(strings, accept_list.size());
 
+  std::vector<flatbuffers::Offset<AclLinkSchedulingData>> link_scheduling;
+  if (round_robin_scheduler_ != nullptr) {
+    for (const auto& usage : round_robin_scheduler_->GetLinkUsage()) {
+      AclLinkSchedulingDataBuilder link_builder(*fb_builder);
+      link_builder.add_handle(usage.handle);
+      link_builder.add_is_le(usage.connection_type == RoundRobinScheduler::ConnectionType::LE);
+      link_builder.add_high_priority(usage.high_priority);
+      link_builder.add_weight(usage.weight);
+      link_builder.add_deficit(usage.deficit);
+      link_builder.add_outstanding_fragments(usage.outstanding_fragments);
+      link_builder.add_max_outstanding_fragments(usage.max_outstanding_fragments);
+      link_builder.add_total_sent_fragments(usage.total_sent_fragments);
+      link_scheduling.push_back(link_builder.Finish());
+    }
+  }
+  auto link_scheduling_vector = fb_builder->CreateVector(link_scheduling);
+
+  using acl_manager::LeConnectionTimeline;
+  std::vector<flatbuffers::Offset<LeConnectionAttemptsData>> le_connection_attempts;
+  if (le_impl_ != nullptr) {
+    for (size_t kind = 0; kind < LeConnectionTimeline::kNumKinds; kind++) {
+      const auto kind_enum = static_cast<LeConnectionTimeline::Kind>(kind);
+      const auto& stats = le_impl_->connection_timeline_.GetStats(kind_enum);
+      std::vector<flatbuffers::Offset<LeConnectionLatencyData>> latency;
+      for (size_t phase = 0; phase < LeConnectionTimeline::kNumPhases; phase++) {
+        const auto& histogram = stats.phases[phase];
+        auto phase_name =
+            fb_builder->CreateString(LeConnectionTimeline::PhaseText(static_cast<LeConnectionTimeline::Phase>(phase)));
+        auto buckets = fb_builder->CreateVector(histogram.buckets.data(), histogram.buckets.size());
+        LeConnectionLatencyDataBuilder latency_builder(*fb_builder);
+        latency_builder.add_phase(phase_name);
+        latency_builder.add_count(histogram.count);
+        latency_builder.add_total_ms(histogram.total_ms);
+        latency_builder.add_max_ms(histogram.max_ms);
+        latency_builder.add_buckets(buckets);
+        latency.push_back(latency_builder.Finish());
+      }
+      auto kind_name = fb_builder->CreateString(LeConnectionTimeline::KindText(kind_enum));
+      auto latency_vector = fb_builder->CreateVector(latency);
+      LeConnectionAttemptsDataBuilder attempts_builder(*fb_builder);
+      attempts_builder.add_kind(kind_name);
+      attempts_builder.add_succeeded(stats.succeeded);
+      attempts_builder.add_failed(stats.failed);
+      attempts_builder.add_cancelled(stats.cancelled);
+      attempts_builder.add_latency(latency_vector);
+      le_connection_attempts.push_back(attempts_builder.Finish());
+    }
+  }
+  auto le_connection_attempts_vector = fb_builder->CreateVector(le_connection_attempts);
+
+  flatbuffers::Offset<ClassicPageData> classic_pages;
+  if (classic_impl_ != nullptr) {
+    const auto& stats = classic_impl_->page_history_.GetStats();
+    ClassicPageDataBuilder pages_builder(*fb_builder);
+    pages_builder.add_succeeded(stats.succeeded);
+    pages_builder.add_page_timeouts(stats.page_timeouts);
+    pages_builder.add_other_failures(stats.other_failures);
+    pages_builder.add_shortened(stats.shortened);
+    pages_builder.add_total_ms(stats.total_ms);
+    pages_builder.add_max_ms(stats.max_ms);
+    classic_pages = pages_builder.Finish();
+  }
+
   AclManagerDataBuilder builder(*fb_builder);
   builder.add_title(title);
   builder.add_le_filter_accept_list_count(accept_list.size());
   builder.add_le_filter_accept_list(vecofstrings);
   builder.add_le_connectability_state(le_connectability_state);
   builder.add_le_create_connection_timeout_alarms_count(le_create_connection_timeout_alarms_count);
+  builder.add_link_scheduling(link_scheduling_vector);
+  builder.add_le_connection_attempts(le_connection_attempts_vector);
+  if (classic_impl_ != nullptr) {
+    builder.add_classic_pages(classic_pages);
+  }
 
   flatbuffers::Offset<AclManagerData> dumpsys_data = builder.Finish();
   promise.set_value(dumpsys_data);
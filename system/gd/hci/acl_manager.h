@@ -19,6 +19,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <vector>
 
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
@@ -117,6 +118,10 @@ class AclManager : public Module {
 
   virtual void CancelLeConnect(AddressWithType address_with_type);
 
+  // Same as CancelLeConnect for each device, the filter accept list is updated
+  // with a single pause of the LE address manager clients
+  virtual void CancelLeConnects(std::vector<AddressWithType> address_with_types);
+
   virtual void ClearFilterAcceptList();
 
   virtual void AddDeviceToResolvingList(
@@ -146,6 +151,10 @@ class AclManager : public Module {
   virtual void OnLeSuspendInitiatedDisconnect(uint16_t handle, ErrorCode reason);
   virtual void SetSystemSuspendState(bool suspended);
 
+  // Set the share of controller buffers given to |handle| relative to the
+  // other normal priority links when several links have data to send.
+  virtual void SetAclTxWeight(uint16_t handle, uint16_t weight);
+
   static const ModuleFactory Factory;
 
  protected:
@@ -16,20 +16,41 @@
 
 #include "hci/acl_manager/acl_fragmenter.h"
 
-#include "packet/fragmenting_inserter.h"
+#include <algorithm>
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+AclFragment::AclFragment(std::shared_ptr<const std::vector<uint8_t>> bytes, size_t offset, size_t length)
+    : bytes_(std::move(bytes)), offset_(offset), length_(length) {}
+
+size_t AclFragment::size() const {
+  return length_;
+}
+
+void AclFragment::Serialize(packet::BitInserter& it) const {
+  auto begin = bytes_->begin() + offset_;
+  std::for_each(begin, begin + length_, [&it](uint8_t byte) { it.insert_byte(byte); });
+}
+
 AclFragmenter::AclFragmenter(size_t mtu, std::unique_ptr<packet::BasePacketBuilder> packet)
     : mtu_(mtu), packet_(std::move(packet)) {}
 
-std::vector<std::unique_ptr<packet::RawBuilder>> AclFragmenter::GetFragments() {
-  std::vector<std::unique_ptr<packet::RawBuilder>> to_return;
-  packet::FragmentingInserter fragmenting_inserter(mtu_, std::back_insert_iterator(to_return));
-  packet_->Serialize(fragmenting_inserter);
-  fragmenting_inserter.finalize();
+std::vector<std::unique_ptr<AclFragment>> AclFragmenter::GetFragments() {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(packet_->size());
+  packet::BitInserter it(*bytes);
+  packet_->Serialize(it);
+
+  std::vector<std::unique_ptr<AclFragment>> to_return;
+  if (mtu_ == 0) {
+    return to_return;
+  }
+  to_return.reserve((bytes->size() + mtu_ - 1) / mtu_);
+  for (size_t offset = 0; offset < bytes->size(); offset += mtu_) {
+    to_return.push_back(std::make_unique<AclFragment>(bytes, offset, std::min(mtu_, bytes->size() - offset)));
+  }
   return to_return;
 }
 
@@ -16,22 +16,39 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "packet/base_packet_builder.h"
-#include "packet/raw_builder.h"
 
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+// A fragment of a serialized packet, which references the bytes shared by all the fragments of the packet
+// instead of holding its own copy.
+class AclFragment : public packet::BasePacketBuilder {
+ public:
+  AclFragment(std::shared_ptr<const std::vector<uint8_t>> bytes, size_t offset, size_t length);
+
+  size_t size() const override;
+
+  void Serialize(packet::BitInserter& it) const override;
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> bytes_;
+  size_t offset_;
+  size_t length_;
+};
+
 class AclFragmenter {
  public:
   AclFragmenter(size_t mtu, std::unique_ptr<packet::BasePacketBuilder> input);
   virtual ~AclFragmenter() = default;
 
-  std::vector<std::unique_ptr<packet::RawBuilder>> GetFragments();
+  // Serializes the packet once and returns the fragments of at most |mtu| bytes, in order.
+  std::vector<std::unique_ptr<AclFragment>> GetFragments();
 
  private:
   size_t mtu_;
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_fragmenter.h"
+
+#include <gtest/gtest.h>
+
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+std::vector<uint8_t> GetPayload(size_t size) {
+  std::vector<uint8_t> payload;
+  for (size_t i = 0; i < size; i++) {
+    payload.push_back(static_cast<uint8_t>(i));
+  }
+  return payload;
+}
+
+std::vector<uint8_t> Serialize(const packet::BasePacketBuilder& fragment) {
+  std::vector<uint8_t> bytes;
+  packet::BitInserter it(bytes);
+  fragment.Serialize(it);
+  return bytes;
+}
+
+TEST(AclFragmenterTest, fragments_reassemble_to_packet) {
+  auto payload = GetPayload(25);
+  auto fragments = AclFragmenter(10, std::make_unique<packet::RawBuilder>(payload)).GetFragments();
+  ASSERT_EQ(3u, fragments.size());
+  ASSERT_EQ(10u, fragments[0]->size());
+  ASSERT_EQ(10u, fragments[1]->size());
+  ASSERT_EQ(5u, fragments[2]->size());
+
+  std::vector<uint8_t> reassembled;
+  for (const auto& fragment : fragments) {
+    auto bytes = Serialize(*fragment);
+    ASSERT_EQ(fragment->size(), bytes.size());
+    reassembled.insert(reassembled.end(), bytes.begin(), bytes.end());
+  }
+  ASSERT_EQ(payload, reassembled);
+}
+
+TEST(AclFragmenterTest, packet_size_multiple_of_mtu) {
+  auto payload = GetPayload(20);
+  auto fragments = AclFragmenter(10, std::make_unique<packet::RawBuilder>(payload)).GetFragments();
+  ASSERT_EQ(2u, fragments.size());
+  ASSERT_EQ(std::vector<uint8_t>(payload.begin() + 10, payload.end()), Serialize(*fragments[1]));
+}
+
+TEST(AclFragmenterTest, fragments_outlive_fragmenter) {
+  auto payload = GetPayload(15);
+  std::vector<std::unique_ptr<AclFragment>> fragments;
+  {
+    AclFragmenter fragmenter(8, std::make_unique<packet::RawBuilder>(payload));
+    fragments = fragmenter.GetFragments();
+  }
+  fragments.erase(fragments.begin());
+  ASSERT_EQ(std::vector<uint8_t>(payload.begin() + 8, payload.end()), Serialize(*fragments[0]));
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
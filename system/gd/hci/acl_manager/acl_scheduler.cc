@@ -18,6 +18,7 @@
 
 #include <bluetooth/log.h>
 
+#include <iterator>
 #include <optional>
 #include <unordered_set>
 #include <variant>
@@ -30,19 +31,31 @@ namespace acl_manager {
 struct AclCreateConnectionQueueEntry {
   Address address;
   common::ContextualOnceCallback<void()> callback;
+  uint8_t rank;
 };
 
 struct RemoteNameRequestQueueEntry {
   Address address;
   common::ContextualOnceCallback<void()> callback;
   common::ContextualOnceCallback<void()> callback_when_cancelled;
+  bool prioritized;
 };
 
 using QueueEntry = std::variant<AclCreateConnectionQueueEntry, RemoteNameRequestQueueEntry>;
 
 struct AclScheduler::impl {
-  void EnqueueOutgoingAclConnection(Address address, common::ContextualOnceCallback<void()> start_connection) {
-    pending_outgoing_operations_.push_back(AclCreateConnectionQueueEntry{address, std::move(start_connection)});
+  void EnqueueOutgoingAclConnection(
+      Address address, common::ContextualOnceCallback<void()> start_connection, uint8_t rank) {
+    // Skip past the trailing queued connections of a lower rank, stopping at any Remote Name Request
+    auto it = pending_outgoing_operations_.end();
+    while (it != pending_outgoing_operations_.begin()) {
+      auto entry_ptr = std::get_if<AclCreateConnectionQueueEntry>(&*std::prev(it));
+      if (entry_ptr == nullptr || entry_ptr->rank >= rank) {
+        break;
+      }
+      it--;
+    }
+    pending_outgoing_operations_.insert(it, AclCreateConnectionQueueEntry{address, std::move(start_connection), rank});
     try_dequeue_next_operation();
   }
 
@@ -110,9 +123,23 @@ struct AclScheduler::impl {
   void EnqueueRemoteNameRequest(
       Address address,
       common::ContextualOnceCallback<void()> start_request,
-      common::ContextualOnceCallback<void()> cancel_request_completed) {
-    pending_outgoing_operations_.push_back(
-        RemoteNameRequestQueueEntry{address, std::move(start_request), std::move(cancel_request_completed)});
+      common::ContextualOnceCallback<void()> cancel_request_completed,
+      bool prioritized) {
+    auto it = pending_outgoing_operations_.end();
+    if (prioritized) {
+      // Skip past the trailing queued requests that are not prioritized, stopping at any ACL connection
+      while (it != pending_outgoing_operations_.begin()) {
+        auto entry_ptr = std::get_if<RemoteNameRequestQueueEntry>(&*std::prev(it));
+        if (entry_ptr == nullptr || entry_ptr->prioritized) {
+          break;
+        }
+        it--;
+      }
+    }
+    pending_outgoing_operations_.insert(
+        it,
+        RemoteNameRequestQueueEntry{
+            address, std::move(start_request), std::move(cancel_request_completed), prioritized});
     try_dequeue_next_operation();
   }
 
@@ -210,9 +237,13 @@ AclScheduler::AclScheduler() : pimpl_(std::make_unique<impl>()){};
 AclScheduler::~AclScheduler() = default;
 
 void AclScheduler::EnqueueOutgoingAclConnection(
-    Address address, common::ContextualOnceCallback<void()> start_connection) {
+    Address address, common::ContextualOnceCallback<void()> start_connection, uint8_t rank) {
   GetHandler()->Call(
-      &impl::EnqueueOutgoingAclConnection, common::Unretained(pimpl_.get()), address, std::move(start_connection));
+      &impl::EnqueueOutgoingAclConnection,
+      common::Unretained(pimpl_.get()),
+      address,
+      std::move(start_connection),
+      rank);
 }
 
 void AclScheduler::RegisterPendingIncomingConnection(Address address) {
@@ -252,13 +283,15 @@ void AclScheduler::CancelAclConnection(
 void AclScheduler::EnqueueRemoteNameRequest(
     Address address,
     common::ContextualOnceCallback<void()> start_request,
-    common::ContextualOnceCallback<void()> cancel_request_completed) {
+    common::ContextualOnceCallback<void()> cancel_request_completed,
+    bool prioritized) {
   GetHandler()->Call(
       &impl::EnqueueRemoteNameRequest,
       common::Unretained(pimpl_.get()),
       address,
       std::move(start_request),
-      std::move(cancel_request_completed));
+      std::move(cancel_request_completed),
+      prioritized);
 }
 
 void AclScheduler::ReportRemoteNameRequestCompletion(Address address) {
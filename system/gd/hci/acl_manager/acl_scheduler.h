@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -36,8 +37,10 @@ namespace acl_manager {
 // at the appropriate time.
 class AclScheduler : public bluetooth::Module {
  public:
-  // Schedule an ACL Create Connection request
-  void EnqueueOutgoingAclConnection(Address address, common::ContextualOnceCallback<void()> start_connection);
+  // Schedule an ACL Create Connection request. It is queued ahead of the queued ACL connections of a lower rank, such
+  // as the ones less likely to succeed, but never ahead of queued Remote Name Requests.
+  void EnqueueOutgoingAclConnection(
+      Address address, common::ContextualOnceCallback<void()> start_connection, uint8_t rank = 0);
 
   // Inform the scheduler that we are handling an incoming connection. This will block all future outgoing ACL
   // connection events until the incoming connection is deregistered.
@@ -63,11 +66,13 @@ class AclScheduler : public bluetooth::Module {
       common::ContextualOnceCallback<void()> cancel_connection_completed);
 
   // Schedule a Remote Name Request. When the request is started, start_request will be invoked. If the request is
-  // cancelled before it is dequeued, cancel_request_completed will be invoked.
+  // cancelled before it is dequeued, cancel_request_completed will be invoked. A prioritized request is queued ahead
+  // of the queued Remote Name Requests that are not, but never ahead of queued ACL connections.
   void EnqueueRemoteNameRequest(
       Address address,
       common::ContextualOnceCallback<void()> start_request,
-      common::ContextualOnceCallback<void()> cancel_request_completed);
+      common::ContextualOnceCallback<void()> cancel_request_completed,
+      bool prioritized = false);
 
   // Report that a Remote Name Request connection has completed, so we can resume popping from the queue.
   void ReportRemoteNameRequestCompletion(Address address);
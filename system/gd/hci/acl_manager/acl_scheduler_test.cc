@@ -136,6 +136,43 @@ TEST_F(AclSchedulerTest, ThreeConnectionsQueue) {
   EXPECT_THAT(future2, IsSet());
 }
 
+TEST_F(AclSchedulerTest, HigherRankConnectionQueuedFirst) {
+  auto promise1 = std::promise<void>{};
+  auto future1 = promise1.get_future();
+  auto promise2 = std::promise<void>{};
+  auto future2 = promise2.get_future();
+
+  // start first connection, which immediately runs
+  acl_scheduler_->EnqueueOutgoingAclConnection(address1, emptyCallback());
+  // queue a connection of a low rank, then one of a higher rank
+  acl_scheduler_->EnqueueOutgoingAclConnection(address2, promiseCallback(std::move(promise1)), 0);
+  acl_scheduler_->EnqueueOutgoingAclConnection(address3, promiseCallback(std::move(promise2)), 2);
+
+  // first connection fails, so the higher rank one should start
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future2, IsSet());
+  EXPECT_THAT(future1.wait_for(timeout), std::future_status::timeout);
+
+  // it fails too, so the low rank one should start
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future1, IsSet());
+}
+
+TEST_F(AclSchedulerTest, HigherRankConnectionNotQueuedAheadOfRemoteNameRequest) {
+  auto promise = std::promise<void>{};
+  auto future = promise.get_future();
+
+  // start first connection, which immediately runs
+  acl_scheduler_->EnqueueOutgoingAclConnection(address1, emptyCallback());
+  // queue a remote name request, then a connection of a high rank
+  acl_scheduler_->EnqueueRemoteNameRequest(address2, promiseCallback(std::move(promise)), impossibleCallback());
+  acl_scheduler_->EnqueueOutgoingAclConnection(address3, impossibleCallback(), 2);
+
+  // first connection fails, so the remote name request should start
+  acl_scheduler_->ReportOutgoingAclConnectionFailure();
+  EXPECT_THAT(future, IsSet());
+}
+
 TEST_F(AclSchedulerTest, SingleConnectionCompletionCallback) {
   auto promise = std::promise<void>{};
   auto future = promise.get_future();
@@ -471,6 +508,52 @@ TEST_F(AclSchedulerTest, RemoteNameRequestCancellationShouldDequeueNext) {
   EXPECT_THAT(future, IsSet());
 }
 
+TEST_F(AclSchedulerTest, PrioritizedRemoteNameRequestQueuedAheadOfOtherRequests) {
+  auto promise = std::promise<void>{};
+  auto future = promise.get_future();
+  auto prioritized_promise = std::promise<void>{};
+  auto prioritized_future = prioritized_promise.get_future();
+
+  // start an outgoing request
+  acl_scheduler_->EnqueueRemoteNameRequest(address1, emptyCallback(), impossibleCallback());
+  // enqueue a second one
+  acl_scheduler_->EnqueueRemoteNameRequest(address2, promiseCallback(std::move(promise)), impossibleCallback());
+  // enqueue a prioritized one
+  acl_scheduler_->EnqueueRemoteNameRequest(
+      address3, promiseCallback(std::move(prioritized_promise)), impossibleCallback(), true);
+
+  // the first request completes
+  acl_scheduler_->ReportRemoteNameRequestCompletion(address1);
+
+  // so the prioritized request should have started before the second one
+  EXPECT_THAT(prioritized_future, IsSet());
+  EXPECT_THAT(future.wait_for(timeout), std::future_status::timeout);
+
+  // the prioritized request completes
+  acl_scheduler_->ReportRemoteNameRequestCompletion(address3);
+
+  // so the second request should now have started
+  EXPECT_THAT(future, IsSet());
+}
+
+TEST_F(AclSchedulerTest, PrioritizedRemoteNameRequestNotQueuedAheadOfConnection) {
+  auto promise = std::promise<void>{};
+  auto future = promise.get_future();
+
+  // start an outgoing request
+  acl_scheduler_->EnqueueRemoteNameRequest(address1, emptyCallback(), impossibleCallback());
+  // enqueue a connection
+  acl_scheduler_->EnqueueOutgoingAclConnection(address2, promiseCallback(std::move(promise)));
+  // enqueue a prioritized request
+  acl_scheduler_->EnqueueRemoteNameRequest(address3, impossibleCallback(), emptyCallback(), true);
+
+  // the first request completes
+  acl_scheduler_->ReportRemoteNameRequestCompletion(address1);
+
+  // so the connection should start first
+  EXPECT_THAT(future, IsSet());
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
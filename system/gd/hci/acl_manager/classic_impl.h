@@ -18,6 +18,7 @@
 
 #include <bluetooth/log.h>
 
+#include <chrono>
 #include <memory>
 
 #include "common/bind.h"
@@ -26,6 +27,8 @@
 #include "hci/acl_manager/assembler.h"
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/connection_management_callbacks.h"
+#include "hci/acl_manager/connection_table.h"
+#include "hci/acl_manager/page_history.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
 #include "hci/class_of_device.h"
 #include "hci/controller.h"
@@ -33,6 +36,7 @@
 #include "hci/hci_layer.h"
 #include "hci/remote_name_request.h"
 #include "os/metrics.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace hci {
@@ -69,6 +73,9 @@ struct classic_impl {
     handler_ = handler;
     connections.crash_on_unknown_handle_ = crash_on_unknown_handle;
     should_accept_connection_ = common::Bind([](Address, ClassOfDevice) { return true; });
+    default_page_timeout_ = static_cast<uint16_t>(
+        os::GetSystemPropertyUint32(kPropertyPageTimeout, kDefaultPageTimeout));
+    current_page_timeout_ = default_page_timeout_;
     acl_connection_interface_ = hci_layer_->GetAclConnectionInterface(
         handler_->BindOn(this, &classic_impl::on_classic_event),
         handler_->BindOn(this, &classic_impl::on_classic_disconnect),
@@ -138,25 +145,22 @@ struct classic_impl {
   static constexpr uint16_t kIllegalConnectionHandle = 0xffff;
   struct {
    private:
-    std::map<uint16_t, acl_connection> acl_connections_;
+    ConnectionTable<acl_connection> acl_connections_;
     mutable std::mutex acl_connections_guard_;
     ConnectionManagementCallbacks* find_callbacks(uint16_t handle) {
       auto connection = acl_connections_.find(handle);
-      if (connection == acl_connections_.end()) return nullptr;
-      return connection->second.connection_management_callbacks_;
+      if (connection == nullptr) return nullptr;
+      return connection->connection_management_callbacks_;
     }
     ConnectionManagementCallbacks* find_callbacks(const Address& address) {
-      for (auto& connection_pair : acl_connections_) {
-        if (connection_pair.second.address_with_type_.GetAddress() == address) {
-          return connection_pair.second.connection_management_callbacks_;
-        }
-      }
-      return nullptr;
+      auto connection = acl_connections_.find(address);
+      if (connection == nullptr) return nullptr;
+      return connection->connection_management_callbacks_;
     }
     void remove(uint16_t handle) {
       auto connection = acl_connections_.find(handle);
-      if (connection != acl_connections_.end()) {
-        connection->second.connection_management_callbacks_ = nullptr;
+      if (connection != nullptr) {
+        connection->connection_management_callbacks_ = nullptr;
         acl_connections_.erase(handle);
       }
     }
@@ -196,8 +200,8 @@ struct classic_impl {
     bool send_packet_upward(uint16_t handle, std::function<void(struct acl_manager::assembler* assembler)> cb) {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
       auto connection = acl_connections_.find(handle);
-      if (connection != acl_connections_.end()) cb(connection->second.assembler_);
-      return connection != acl_connections_.end();
+      if (connection != nullptr) cb(connection->assembler_);
+      return connection != nullptr;
     }
     void add(
         uint16_t handle,
@@ -206,40 +210,28 @@ struct classic_impl {
         os::Handler* handler,
         ConnectionManagementCallbacks* connection_management_callbacks) {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
-      auto emplace_pair = acl_connections_.emplace(
-          std::piecewise_construct,
-          std::forward_as_tuple(handle),
-          std::forward_as_tuple(remote_address, queue_end, handler));
+      auto connection =
+          acl_connections_.emplace(handle, remote_address.GetAddress(), remote_address, queue_end, handler);
       log::assert_that(
-          emplace_pair.second,
-          "assert failed: emplace_pair.second");  // Make sure the connection is unique
-      emplace_pair.first->second.connection_management_callbacks_ = connection_management_callbacks;
+          connection != nullptr,
+          "assert failed: connection != nullptr");  // Make sure the connection is unique
+      connection->connection_management_callbacks_ = connection_management_callbacks;
     }
     uint16_t HACK_get_handle(const Address& address) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
-      for (auto it = acl_connections_.begin(); it != acl_connections_.end(); it++) {
-        if (it->second.address_with_type_.GetAddress() == address) {
-          return it->first;
-        }
-      }
-      return kIllegalConnectionHandle;
+      return acl_connections_.find_handle(address, kIllegalConnectionHandle);
     }
     Address get_address(uint16_t handle) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
       auto connection = acl_connections_.find(handle);
-      if (connection == acl_connections_.end()) {
+      if (connection == nullptr) {
         return Address::kEmpty;
       }
-      return connection->second.address_with_type_.GetAddress();
+      return connection->address_with_type_.GetAddress();
     }
     bool is_classic_link_already_connected(const Address& address) const {
       std::unique_lock<std::mutex> lock(acl_connections_guard_);
-      for (const auto& connection : acl_connections_) {
-        if (connection.second.address_with_type_.GetAddress() == address) {
-          return true;
-        }
-      }
-      return false;
+      return acl_connections_.find(address) != nullptr;
     }
   } connections;
 
@@ -288,7 +280,9 @@ struct classic_impl {
         address, packet_type, page_scan_repetition_mode, clock_offset, clock_offset_valid, allow_role_switch);
 
     acl_scheduler_->EnqueueOutgoingAclConnection(
-        address, handler_->BindOnceOn(this, &classic_impl::actually_create_connection, address, std::move(packet)));
+        address,
+        handler_->BindOnceOn(this, &classic_impl::actually_create_connection, address, std::move(packet)),
+        static_cast<uint8_t>(page_history_.GetLikelihood(address)));
   }
 
   void actually_create_connection(Address address, std::unique_ptr<CreateConnectionBuilder> packet) {
@@ -297,6 +291,14 @@ struct classic_impl {
       acl_scheduler_->ReportOutgoingAclConnectionFailure();
       return;
     }
+    uint16_t page_timeout = page_history_.GetPageTimeout(address, default_page_timeout_);
+    log::info(
+        "Paging {} likelihood:{} page_timeout:{}",
+        address,
+        PageHistory::LikelihoodText(page_history_.GetLikelihood(address)),
+        page_timeout);
+    set_page_timeout(page_timeout);
+    page_history_.OnPageStart(address, page_timeout, default_page_timeout_);
     acl_connection_interface_->EnqueueCommand(
         std::move(packet), handler_->BindOnceOn(this, &classic_impl::on_create_connection_status, address));
   }
@@ -309,6 +311,7 @@ struct classic_impl {
     if (status.GetStatus() != hci::ErrorCode::SUCCESS /* = pending */) {
       // something went wrong, but unblock queue and report to caller
       log::error("Failed to create connection, reporting failure and continuing");
+      on_page_complete(address, status.GetStatus());
       log::assert_that(client_callbacks_ != nullptr, "assert failed: client_callbacks_ != nullptr");
       client_handler_->Post(common::BindOnce(
           &ConnectionCallbacks::OnConnectFail,
@@ -377,6 +380,9 @@ struct classic_impl {
     auto status = connection_complete.GetStatus();
     auto address = connection_complete.GetBdAddr();
 
+    // Restore the page timeout before the scheduler starts the next operation
+    on_page_complete(address, status);
+
     acl_scheduler_->ReportAclConnectionCompletion(
         address,
         handler_->BindOnceOn(
@@ -421,6 +427,31 @@ struct classic_impl {
             true /* locally initiated */));
   }
 
+  // Write the page timeout used for the next page, unless the controller already uses it
+  void set_page_timeout(uint16_t page_timeout) {
+    if (page_timeout == current_page_timeout_) {
+      return;
+    }
+    current_page_timeout_ = page_timeout;
+    hci_layer_->EnqueueCommand(
+        WritePageTimeoutBuilder::Create(page_timeout),
+        handler_->BindOnce(check_complete<WritePageTimeoutCompleteView>));
+  }
+
+  void on_page_complete(Address address, ErrorCode status) {
+    auto duration = page_history_.OnPageComplete(address, status);
+    if (!duration.has_value()) {
+      return;
+    }
+    log::info(
+        "Page to {} completed after {} ms status:{}",
+        address,
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count(),
+        ErrorCodeText(status));
+    // The remote name requests page with the default page timeout
+    set_page_timeout(default_page_timeout_);
+  }
+
   void actually_cancel_connect(Address address) {
     std::unique_ptr<CreateConnectionCancelBuilder> packet = CreateConnectionCancelBuilder::Create(address);
     acl_connection_interface_->EnqueueCommand(
@@ -757,6 +788,13 @@ struct classic_impl {
 
   common::Callback<bool(Address, ClassOfDevice)> should_accept_connection_;
   std::unique_ptr<RoleChangeView> delayed_role_change_ = nullptr;
+
+  // Same property and default as the page timeout written when the stack is enabled
+  static constexpr char kPropertyPageTimeout[] = "bluetooth.core.classic.page_timeout";
+  static constexpr uint16_t kDefaultPageTimeout = 0x2000;
+  PageHistory page_history_;
+  uint16_t default_page_timeout_;
+  uint16_t current_page_timeout_;
 };
 
 }  // namespace acl_manager
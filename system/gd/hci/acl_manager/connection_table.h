@@ -0,0 +1,163 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Table of the ACL connections, indexed by connection handle and by remote address.
+//
+// Connection handles are 12 bits, the connections are stored in a dense vector indexed by handle
+// which only grows up to the highest handle in use, so that the lookup of every incoming ACL packet
+// is a bounds check and an indirection. The remote addresses are indexed in a hash map.
+//
+// Not thread safe, the callers hold their own lock.
+template <class Connection>
+class ConnectionTable {
+ public:
+  // Highest valid connection handle, the handles 0x0F00 to 0x0FFF are reserved.
+  static constexpr uint16_t kMaxHandle = 0x0EFF;
+
+  // Constructs the connection for |handle| in place. Returns nullptr if the handle is invalid or
+  // is already in use.
+  template <class... Args>
+  Connection* emplace(uint16_t handle, const Address& address, Args&&... args) {
+    if (handle > kMaxHandle) {
+      return nullptr;
+    }
+    if (handle >= connections_.size()) {
+      connections_.resize(handle + 1);
+    }
+    auto& entry = connections_[handle];
+    if (entry.connection != nullptr) {
+      return nullptr;
+    }
+    entry.address = address;
+    entry.connection = std::make_unique<Connection>(std::forward<Args>(args)...);
+    addresses_.emplace(address, handle);
+    size_++;
+    return entry.connection.get();
+  }
+
+  Connection* find(uint16_t handle) const {
+    return handle < connections_.size() ? connections_[handle].connection.get() : nullptr;
+  }
+
+  // Returns one of the connections to |address|.
+  Connection* find(const Address& address) const {
+    auto it = addresses_.find(address);
+    return it == addresses_.end() ? nullptr : connections_[it->second].connection.get();
+  }
+
+  // Returns one of the connection handles of |address|, or |not_found|.
+  uint16_t find_handle(const Address& address, uint16_t not_found) const {
+    auto it = addresses_.find(address);
+    return it == addresses_.end() ? not_found : it->second;
+  }
+
+  // Calls |callback| with the handle and the connection of each connection to |address|.
+  template <class Callback>
+  void for_each(const Address& address, Callback callback) const {
+    auto range = addresses_.equal_range(address);
+    for (auto it = range.first; it != range.second; it++) {
+      callback(it->second, *connections_[it->second].connection);
+    }
+  }
+
+  // Calls |callback| with the handle and the connection of each connection, in handle order.
+  template <class Callback>
+  void for_each(Callback callback) const {
+    for (size_t handle = 0; handle < connections_.size(); handle++) {
+      if (connections_[handle].connection != nullptr) {
+        callback(static_cast<uint16_t>(handle), *connections_[handle].connection);
+      }
+    }
+  }
+
+  // Removes the connection and returns it, so that the caller controls when it is destroyed.
+  std::unique_ptr<Connection> extract(uint16_t handle) {
+    if (handle >= connections_.size() || connections_[handle].connection == nullptr) {
+      return nullptr;
+    }
+    auto range = addresses_.equal_range(connections_[handle].address);
+    for (auto it = range.first; it != range.second; it++) {
+      if (it->second == handle) {
+        addresses_.erase(it);
+        break;
+      }
+    }
+    size_--;
+    auto connection = std::move(connections_[handle].connection);
+    while (!connections_.empty() && connections_.back().connection == nullptr) {
+      connections_.pop_back();
+    }
+    return connection;
+  }
+
+  bool erase(uint16_t handle) {
+    return extract(handle) != nullptr;
+  }
+
+  // Removes all the connections and returns them in handle order.
+  std::vector<std::unique_ptr<Connection>> extract_all() {
+    std::vector<std::unique_ptr<Connection>> connections;
+    for (auto& entry : connections_) {
+      if (entry.connection != nullptr) {
+        connections.push_back(std::move(entry.connection));
+      }
+    }
+    connections_.clear();
+    addresses_.clear();
+    size_ = 0;
+    return connections;
+  }
+
+  void clear() {
+    extract_all();
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  struct Entry {
+    Address address;
+    std::unique_ptr<Connection> connection;
+  };
+
+  std::vector<Entry> connections_;
+  std::unordered_multimap<Address, uint16_t> addresses_;
+  size_t size_{0};
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
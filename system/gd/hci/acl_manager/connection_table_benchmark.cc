@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+
+#include "benchmark/benchmark.h"
+#include "hci/acl_manager/connection_table.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+struct BenchmarkConnection {
+  explicit BenchmarkConnection(uint16_t handle) : handle(handle) {}
+  uint16_t handle;
+};
+
+// Handles as allocated by the controllers, with a few connections.
+static std::vector<uint16_t> GetHandles(int64_t count) {
+  std::vector<uint16_t> handles;
+  for (int64_t i = 0; i < count; i++) {
+    handles.push_back(static_cast<uint16_t>(0x0040 + i * 3));
+  }
+  return handles;
+}
+
+static Address GetAddress(int64_t i) {
+  return Address({static_cast<uint8_t>(i), 0x11, 0x22, 0x33, 0x44, 0x55});
+}
+
+// Per packet lookup with the previous map based table.
+static void BM_MapLookupByHandle(State& state) {
+  auto handles = GetHandles(state.range(0));
+  std::map<uint16_t, BenchmarkConnection> connections;
+  for (auto handle : handles) {
+    connections.emplace(handle, BenchmarkConnection(handle));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto it = connections.find(handles[i++ % handles.size()]);
+    benchmark::DoNotOptimize(it->second.handle);
+  }
+}
+BENCHMARK(BM_MapLookupByHandle)->Arg(2)->Arg(8)->Arg(32);
+
+static void BM_ConnectionTableLookupByHandle(State& state) {
+  auto handles = GetHandles(state.range(0));
+  ConnectionTable<BenchmarkConnection> connections;
+  for (size_t i = 0; i < handles.size(); i++) {
+    connections.emplace(handles[i], GetAddress(i), handles[i]);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto connection = connections.find(handles[i++ % handles.size()]);
+    benchmark::DoNotOptimize(connection->handle);
+  }
+}
+BENCHMARK(BM_ConnectionTableLookupByHandle)->Arg(2)->Arg(8)->Arg(32);
+
+// Lookup by address with the previous linear search.
+static void BM_MapLookupByAddress(State& state) {
+  auto handles = GetHandles(state.range(0));
+  std::map<uint16_t, std::pair<Address, BenchmarkConnection>> connections;
+  for (size_t i = 0; i < handles.size(); i++) {
+    connections.emplace(handles[i], std::make_pair(GetAddress(i), BenchmarkConnection(handles[i])));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto address = GetAddress(i++ % handles.size());
+    for (auto& [handle, connection] : connections) {
+      if (connection.first == address) {
+        benchmark::DoNotOptimize(connection.second.handle);
+        break;
+      }
+    }
+  }
+}
+BENCHMARK(BM_MapLookupByAddress)->Arg(2)->Arg(8)->Arg(32);
+
+static void BM_ConnectionTableLookupByAddress(State& state) {
+  auto handles = GetHandles(state.range(0));
+  ConnectionTable<BenchmarkConnection> connections;
+  for (size_t i = 0; i < handles.size(); i++) {
+    connections.emplace(handles[i], GetAddress(i), handles[i]);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    auto connection = connections.find(GetAddress(i++ % handles.size()));
+    benchmark::DoNotOptimize(connection->handle);
+  }
+}
+BENCHMARK(BM_ConnectionTableLookupByAddress)->Arg(2)->Arg(8)->Arg(32);
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
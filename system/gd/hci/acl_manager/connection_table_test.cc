@@ -0,0 +1,106 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/connection_table.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+const Address kAddress1 = Address({0, 1, 2, 3, 4, 5});
+const Address kAddress2 = Address({0, 1, 2, 3, 4, 6});
+constexpr uint16_t kNotFound = 0xffff;
+
+struct TestConnection {
+  explicit TestConnection(int value) : value(value) {}
+  int value;
+};
+
+TEST(ConnectionTableTest, find_by_handle_and_address) {
+  ConnectionTable<TestConnection> table;
+  ASSERT_TRUE(table.empty());
+  ASSERT_NE(nullptr, table.emplace(0x0040, kAddress1, 1));
+  ASSERT_NE(nullptr, table.emplace(0x0002, kAddress2, 2));
+  ASSERT_EQ(2u, table.size());
+
+  ASSERT_EQ(1, table.find(0x0040)->value);
+  ASSERT_EQ(2, table.find(0x0002)->value);
+  ASSERT_EQ(nullptr, table.find(0x0003));
+  ASSERT_EQ(nullptr, table.find(0x0EFF));
+
+  ASSERT_EQ(1, table.find(kAddress1)->value);
+  ASSERT_EQ(0x0002, table.find_handle(kAddress2, kNotFound));
+  ASSERT_EQ(kNotFound, table.find_handle(Address::kEmpty, kNotFound));
+}
+
+TEST(ConnectionTableTest, reject_duplicate_and_invalid_handles) {
+  ConnectionTable<TestConnection> table;
+  ASSERT_NE(nullptr, table.emplace(0x0001, kAddress1, 1));
+  ASSERT_EQ(nullptr, table.emplace(0x0001, kAddress2, 2));
+  ASSERT_EQ(nullptr, table.emplace(0x0F00, kAddress2, 2));
+  ASSERT_EQ(1u, table.size());
+  ASSERT_EQ(nullptr, table.find(kAddress2));
+}
+
+TEST(ConnectionTableTest, erase) {
+  ConnectionTable<TestConnection> table;
+  table.emplace(0x0001, kAddress1, 1);
+  table.emplace(0x0002, kAddress1, 2);
+
+  auto connection = table.extract(0x0002);
+  ASSERT_NE(nullptr, connection);
+  ASSERT_EQ(2, connection->value);
+  ASSERT_EQ(nullptr, table.find(0x0002));
+  ASSERT_EQ(0x0001, table.find_handle(kAddress1, kNotFound));
+
+  ASSERT_FALSE(table.erase(0x0002));
+  ASSERT_TRUE(table.erase(0x0001));
+  ASSERT_TRUE(table.empty());
+  ASSERT_EQ(nullptr, table.find(kAddress1));
+
+  // The handle can be reused.
+  ASSERT_NE(nullptr, table.emplace(0x0001, kAddress2, 3));
+  ASSERT_EQ(3, table.find(kAddress2)->value);
+}
+
+TEST(ConnectionTableTest, for_each) {
+  ConnectionTable<TestConnection> table;
+  table.emplace(0x0003, kAddress1, 3);
+  table.emplace(0x0001, kAddress2, 1);
+  table.emplace(0x0002, kAddress1, 2);
+
+  std::vector<uint16_t> handles;
+  table.for_each([&](uint16_t handle, const TestConnection&) { handles.push_back(handle); });
+  ASSERT_EQ((std::vector<uint16_t>{0x0001, 0x0002, 0x0003}), handles);
+
+  int sum = 0;
+  table.for_each(kAddress1, [&](uint16_t, const TestConnection& connection) { sum += connection.value; });
+  ASSERT_EQ(5, sum);
+
+  auto connections = table.extract_all();
+  ASSERT_EQ(3u, connections.size());
+  ASSERT_TRUE(table.empty());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
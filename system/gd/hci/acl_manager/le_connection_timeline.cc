@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_connection_timeline.h"
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+void LeConnectionTimeline::OnRequest(
+    const AddressWithType& address_with_type, bool is_direct, Clock::time_point now) {
+  auto it = attempts_.find(address_with_type);
+  if (it != attempts_.end()) {
+    if (is_direct) {
+      it->second.kind = Kind::DIRECT;
+    }
+    return;
+  }
+  attempts_.emplace(address_with_type, Attempt{.kind = is_direct ? Kind::DIRECT : Kind::BACKGROUND, .request = now});
+}
+
+void LeConnectionTimeline::OnAcceptListAdd(const AddressWithType& address_with_type, Clock::time_point now) {
+  auto it = attempts_.find(address_with_type);
+  if (it != attempts_.end() && !it->second.accept_list_add.has_value()) {
+    it->second.accept_list_add = now;
+  }
+}
+
+void LeConnectionTimeline::OnCreateConnection(Clock::time_point now) {
+  for (auto& [address_with_type, attempt] : attempts_) {
+    if (!attempt.create_connection.has_value()) {
+      attempt.create_connection = now;
+    }
+  }
+}
+
+void LeConnectionTimeline::OnConnectionComplete(
+    const AddressWithType& address_with_type, bool success, Clock::time_point now) {
+  auto it = attempts_.find(address_with_type);
+  if (it == attempts_.end()) {
+    return;
+  }
+  const Attempt attempt = it->second;
+  attempts_.erase(it);
+
+  auto& stats = stats_[static_cast<size_t>(attempt.kind)];
+  if (!success) {
+    stats.failed++;
+    return;
+  }
+  stats.succeeded++;
+
+  auto& phases = stats.phases;
+  auto accept_list_add = attempt.accept_list_add.value_or(attempt.request);
+  auto create_connection = attempt.create_connection.value_or(accept_list_add);
+  if (attempt.accept_list_add.has_value()) {
+    Record(phases[static_cast<size_t>(Phase::ACCEPT_LIST)], accept_list_add - attempt.request);
+  }
+  if (attempt.create_connection.has_value()) {
+    Record(phases[static_cast<size_t>(Phase::CREATE_CONNECTION)], create_connection - accept_list_add);
+  }
+  Record(phases[static_cast<size_t>(Phase::CONNECTION)], now - create_connection);
+  Record(phases[static_cast<size_t>(Phase::TOTAL)], now - attempt.request);
+}
+
+void LeConnectionTimeline::OnCancel(const AddressWithType& address_with_type) {
+  auto it = attempts_.find(address_with_type);
+  if (it == attempts_.end()) {
+    return;
+  }
+  stats_[static_cast<size_t>(it->second.kind)].cancelled++;
+  attempts_.erase(it);
+}
+
+void LeConnectionTimeline::Record(Histogram& histogram, Clock::duration duration) {
+  uint32_t duration_ms = std::max<int64_t>(
+      0, std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+  auto bucket = std::lower_bound(kBucketBoundsMs.begin(), kBucketBoundsMs.end(), duration_ms);
+  histogram.buckets[bucket - kBucketBoundsMs.begin()]++;
+  histogram.count++;
+  histogram.total_ms += duration_ms;
+  histogram.max_ms = std::max(histogram.max_ms, duration_ms);
+}
+
+std::string LeConnectionTimeline::KindText(Kind kind) {
+  switch (kind) {
+    case Kind::DIRECT:
+      return "DIRECT";
+    case Kind::BACKGROUND:
+      return "BACKGROUND";
+  }
+  return "UNKNOWN";
+}
+
+std::string LeConnectionTimeline::PhaseText(Phase phase) {
+  switch (phase) {
+    case Phase::ACCEPT_LIST:
+      return "ACCEPT_LIST";
+    case Phase::CREATE_CONNECTION:
+      return "CREATE_CONNECTION";
+    case Phase::CONNECTION:
+      return "CONNECTION";
+    case Phase::TOTAL:
+      return "TOTAL";
+  }
+  return "UNKNOWN";
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "hci/address_with_type.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Timeline of the locally initiated LE connection attempts: the time spent between the connection
+// request, the filter accept list update, the first create connection command and the connection
+// complete event. The completed attempts are aggregated into latency histograms, per kind of
+// connection attempt.
+class LeConnectionTimeline {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Kind : uint8_t { DIRECT = 0, BACKGROUND = 1 };
+  static constexpr size_t kNumKinds = 2;
+
+  enum class Phase : uint8_t {
+    // Connection request to filter accept list update.
+    ACCEPT_LIST = 0,
+    // Filter accept list update to the first create connection command.
+    CREATE_CONNECTION = 1,
+    // First create connection command to connection complete.
+    CONNECTION = 2,
+    // Connection request to connection complete.
+    TOTAL = 3,
+  };
+  static constexpr size_t kNumPhases = 4;
+
+  // Upper bounds of the histogram buckets in milliseconds, the last bucket is unbounded.
+  static constexpr std::array<uint32_t, 8> kBucketBoundsMs = {50, 100, 250, 500, 1000, 2500, 5000, 10000};
+
+  struct Histogram {
+    std::array<uint32_t, kBucketBoundsMs.size() + 1> buckets{};
+    uint32_t count{0};
+    uint64_t total_ms{0};
+    uint32_t max_ms{0};
+  };
+
+  struct Stats {
+    uint32_t succeeded{0};
+    uint32_t failed{0};
+    uint32_t cancelled{0};
+    std::array<Histogram, kNumPhases> phases{};
+  };
+
+  // Starts an attempt, unless one is already pending for the device. A pending background attempt
+  // becomes direct when a direct connection is requested.
+  void OnRequest(const AddressWithType& address_with_type, bool is_direct, Clock::time_point now = Clock::now());
+  void OnAcceptListAdd(const AddressWithType& address_with_type, Clock::time_point now = Clock::now());
+  // The create connection command initiates the connection to all the pending attempts.
+  void OnCreateConnection(Clock::time_point now = Clock::now());
+  void OnConnectionComplete(
+      const AddressWithType& address_with_type, bool success, Clock::time_point now = Clock::now());
+  void OnCancel(const AddressWithType& address_with_type);
+
+  size_t GetPendingCount() const {
+    return attempts_.size();
+  }
+
+  const Stats& GetStats(Kind kind) const {
+    return stats_[static_cast<size_t>(kind)];
+  }
+
+  static std::string KindText(Kind kind);
+  static std::string PhaseText(Phase phase);
+
+ private:
+  struct Attempt {
+    Kind kind;
+    Clock::time_point request;
+    std::optional<Clock::time_point> accept_list_add;
+    std::optional<Clock::time_point> create_connection;
+  };
+
+  static void Record(Histogram& histogram, Clock::duration duration);
+
+  std::unordered_map<AddressWithType, Attempt> attempts_;
+  std::array<Stats, kNumKinds> stats_{};
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
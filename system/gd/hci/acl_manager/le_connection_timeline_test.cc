@@ -0,0 +1,108 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/le_connection_timeline.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+const AddressWithType kAddress1 = AddressWithType(Address({0, 1, 2, 3, 4, 5}), AddressType::PUBLIC_DEVICE_ADDRESS);
+const AddressWithType kAddress2 = AddressWithType(Address({0, 1, 2, 3, 4, 6}), AddressType::RANDOM_DEVICE_ADDRESS);
+
+using Kind = LeConnectionTimeline::Kind;
+using Phase = LeConnectionTimeline::Phase;
+
+class LeConnectionTimelineTest : public ::testing::Test {
+ protected:
+  const LeConnectionTimeline::Histogram& GetHistogram(Kind kind, Phase phase) {
+    return timeline_.GetStats(kind).phases[static_cast<size_t>(phase)];
+  }
+
+  LeConnectionTimeline timeline_;
+  LeConnectionTimeline::Clock::time_point start_{LeConnectionTimeline::Clock::now()};
+};
+
+TEST_F(LeConnectionTimelineTest, direct_connection_phases) {
+  timeline_.OnRequest(kAddress1, true, start_);
+  timeline_.OnAcceptListAdd(kAddress1, start_ + 10ms);
+  timeline_.OnCreateConnection(start_ + 60ms);
+  // Only the first create connection command is recorded.
+  timeline_.OnCreateConnection(start_ + 100ms);
+  timeline_.OnConnectionComplete(kAddress1, true, start_ + 860ms);
+
+  ASSERT_EQ(0u, timeline_.GetPendingCount());
+  ASSERT_EQ(1u, timeline_.GetStats(Kind::DIRECT).succeeded);
+  ASSERT_EQ(0u, timeline_.GetStats(Kind::BACKGROUND).succeeded);
+
+  ASSERT_EQ(10u, GetHistogram(Kind::DIRECT, Phase::ACCEPT_LIST).total_ms);
+  ASSERT_EQ(50u, GetHistogram(Kind::DIRECT, Phase::CREATE_CONNECTION).total_ms);
+  ASSERT_EQ(800u, GetHistogram(Kind::DIRECT, Phase::CONNECTION).total_ms);
+  ASSERT_EQ(860u, GetHistogram(Kind::DIRECT, Phase::TOTAL).max_ms);
+
+  // Buckets are bounded by 50, 100, 250, 500, 1000... ms.
+  ASSERT_EQ(1u, GetHistogram(Kind::DIRECT, Phase::ACCEPT_LIST).buckets[0]);
+  ASSERT_EQ(1u, GetHistogram(Kind::DIRECT, Phase::CREATE_CONNECTION).buckets[0]);
+  ASSERT_EQ(1u, GetHistogram(Kind::DIRECT, Phase::CONNECTION).buckets[4]);
+}
+
+TEST_F(LeConnectionTimelineTest, device_already_in_accept_list) {
+  timeline_.OnRequest(kAddress1, false, start_);
+  timeline_.OnCreateConnection(start_ + 20ms);
+  timeline_.OnConnectionComplete(kAddress1, true, start_ + 120ms);
+
+  ASSERT_EQ(0u, GetHistogram(Kind::BACKGROUND, Phase::ACCEPT_LIST).count);
+  ASSERT_EQ(20u, GetHistogram(Kind::BACKGROUND, Phase::CREATE_CONNECTION).total_ms);
+  ASSERT_EQ(100u, GetHistogram(Kind::BACKGROUND, Phase::CONNECTION).total_ms);
+  ASSERT_EQ(120u, GetHistogram(Kind::BACKGROUND, Phase::TOTAL).total_ms);
+}
+
+TEST_F(LeConnectionTimelineTest, direct_request_upgrades_background_attempt) {
+  timeline_.OnRequest(kAddress1, false, start_);
+  timeline_.OnRequest(kAddress1, true, start_ + 1s);
+  timeline_.OnConnectionComplete(kAddress1, true, start_ + 2s);
+
+  ASSERT_EQ(1u, timeline_.GetStats(Kind::DIRECT).succeeded);
+  // The attempt started with the first request.
+  ASSERT_EQ(2000u, GetHistogram(Kind::DIRECT, Phase::TOTAL).total_ms);
+}
+
+TEST_F(LeConnectionTimelineTest, failed_and_cancelled_attempts) {
+  timeline_.OnRequest(kAddress1, true, start_);
+  timeline_.OnRequest(kAddress2, true, start_);
+  ASSERT_EQ(2u, timeline_.GetPendingCount());
+
+  timeline_.OnConnectionComplete(kAddress1, false, start_ + 30s);
+  timeline_.OnCancel(kAddress2);
+  // Connections without an attempt are ignored.
+  timeline_.OnConnectionComplete(kAddress2, true, start_ + 30s);
+
+  ASSERT_EQ(0u, timeline_.GetPendingCount());
+  ASSERT_EQ(0u, timeline_.GetStats(Kind::DIRECT).succeeded);
+  ASSERT_EQ(1u, timeline_.GetStats(Kind::DIRECT).failed);
+  ASSERT_EQ(1u, timeline_.GetStats(Kind::DIRECT).cancelled);
+  ASSERT_EQ(0u, GetHistogram(Kind::DIRECT, Phase::TOTAL).count);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -21,6 +21,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -28,8 +29,10 @@
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "hci/acl_manager/assembler.h"
+#include "hci/acl_manager/connection_table.h"
 #include "hci/acl_manager/le_acceptlist_callbacks.h"
 #include "hci/acl_manager/le_acl_connection.h"
+#include "hci/acl_manager/le_connection_timeline.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
 #include "hci/acl_manager/le_connection_management_callbacks.h"
 #include "hci/acl_manager/round_robin_scheduler.h"
@@ -41,6 +44,8 @@
 #include "os/alarm.h"
 #include "os/handler.h"
 #include "os/system_properties.h"
+#include "storage/config_keys.h"
+#include "storage/storage_module.h"
 
 namespace bluetooth {
 namespace hci {
@@ -67,6 +72,8 @@ constexpr uint8_t PHY_LE_2M = 0x02;
 constexpr uint8_t PHY_LE_CODED = 0x04;
 constexpr bool kEnableBlePrivacy = true;
 constexpr bool kEnableBleOnlyInit1mPhy = false;
+constexpr bool kEnableFastReconnect = false;
+constexpr uint32_t kFastReconnectScanDurationMs = 5 * 1000;
 
 static const std::string kPropertyMinConnInterval = "bluetooth.core.le.min_connection_interval";
 static const std::string kPropertyMaxConnInterval = "bluetooth.core.le.max_connection_interval";
@@ -85,6 +92,8 @@ static const std::string kPropertyConnScanWindowSystemSuspend =
     "bluetooth.core.le.connection_scan_window_system_suspend";
 static const std::string kPropertyEnableBlePrivacy = "bluetooth.core.gap.le.privacy.enabled";
 static const std::string kPropertyEnableBleOnlyInit1mPhy = "bluetooth.core.gap.le.conn.only_init_1m_phy.enabled";
+static const std::string kPropertyEnableFastReconnect = "bluetooth.core.le.fast_reconnect.enabled";
+static const std::string kPropertyFastReconnectScanDuration = "bluetooth.core.le.fast_reconnect_scan_duration";
 
 enum class ConnectabilityState {
   DISARMED = 0,
@@ -126,8 +135,12 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       Controller* controller,
       os::Handler* handler,
       RoundRobinScheduler* round_robin_scheduler,
-      bool crash_on_unknown_handle)
-      : hci_layer_(hci_layer), controller_(controller), round_robin_scheduler_(round_robin_scheduler) {
+      bool crash_on_unknown_handle,
+      storage::StorageModule* storage_module = nullptr)
+      : hci_layer_(hci_layer),
+        controller_(controller),
+        round_robin_scheduler_(round_robin_scheduler),
+        storage_module_(storage_module) {
     hci_layer_ = hci_layer;
     controller_ = controller;
     handler_ = handler;
@@ -184,17 +197,17 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   static constexpr uint16_t kIllegalConnectionHandle = 0xffff;
   struct {
    private:
-    std::map<uint16_t, le_acl_connection> le_acl_connections_;
+    ConnectionTable<le_acl_connection> le_acl_connections_;
     mutable std::mutex le_acl_connections_guard_;
     LeConnectionManagementCallbacks* find_callbacks(uint16_t handle) {
       auto connection = le_acl_connections_.find(handle);
-      if (connection == le_acl_connections_.end()) return nullptr;
-      return connection->second.le_connection_management_callbacks_;
+      if (connection == nullptr) return nullptr;
+      return connection->le_connection_management_callbacks_;
     }
     void remove(uint16_t handle) {
       auto connection = le_acl_connections_.find(handle);
-      if (connection != le_acl_connections_.end()) {
-        connection->second.le_connection_management_callbacks_ = nullptr;
+      if (connection != nullptr) {
+        connection->le_connection_management_callbacks_ = nullptr;
         le_acl_connections_.erase(handle);
       }
     }
@@ -206,10 +219,10 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return le_acl_connections_.empty();
     }
     void reset() {
-      std::map<uint16_t, le_acl_connection> le_acl_connections{};
+      std::vector<std::unique_ptr<le_acl_connection>> le_acl_connections{};
       {
         std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-        le_acl_connections = std::move(le_acl_connections_);
+        le_acl_connections = le_acl_connections_.extract_all();
       }
       le_acl_connections.clear();
     }
@@ -233,8 +246,8 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     bool send_packet_upward(uint16_t handle, std::function<void(struct acl_manager::assembler* assembler)> cb) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
       auto connection = le_acl_connections_.find(handle);
-      if (connection != le_acl_connections_.end()) cb(connection->second.assembler_);
-      return connection != le_acl_connections_.end();
+      if (connection != nullptr) cb(connection->assembler_);
+      return connection != nullptr;
     }
     void add(
         uint16_t handle,
@@ -244,23 +257,21 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         os::Handler* handler,
         LeConnectionManagementCallbacks* le_connection_management_callbacks) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-      auto emplace_pair = le_acl_connections_.emplace(
-          std::piecewise_construct,
-          std::forward_as_tuple(handle),
-          std::forward_as_tuple(remote_address, std::move(pending_connection), queue_end, handler));
+      auto connection = le_acl_connections_.emplace(
+          handle, remote_address.GetAddress(), remote_address, std::move(pending_connection), queue_end, handler);
       log::assert_that(
-          emplace_pair.second,
-          "assert failed: emplace_pair.second");  // Make sure the connection is unique
-      emplace_pair.first->second.le_connection_management_callbacks_ = le_connection_management_callbacks;
+          connection != nullptr,
+          "assert failed: connection != nullptr");  // Make sure the connection is unique
+      connection->le_connection_management_callbacks_ = le_connection_management_callbacks;
     }
 
     std::unique_ptr<LeAclConnection> record_peripheral_data_and_extract_pending_connection(
         uint16_t handle, DataAsPeripheral data) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
       auto connection = le_acl_connections_.find(handle);
-      if (connection != le_acl_connections_.end() && connection->second.pending_connection_.get()) {
-        connection->second.pending_connection_->UpdateRoleSpecificData(data);
-        return std::move(connection->second.pending_connection_);
+      if (connection != nullptr && connection->pending_connection_.get()) {
+        connection->pending_connection_->UpdateRoleSpecificData(data);
+        return std::move(connection->pending_connection_);
       } else {
         return nullptr;
       }
@@ -268,31 +279,26 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
     uint16_t HACK_get_handle(Address address) const {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-      for (auto it = le_acl_connections_.begin(); it != le_acl_connections_.end(); it++) {
-        if (it->second.remote_address_.GetAddress() == address) {
-          return it->first;
-        }
-      }
-      return kIllegalConnectionHandle;
+      return le_acl_connections_.find_handle(address, kIllegalConnectionHandle);
     }
 
     AddressWithType getAddressWithType(uint16_t handle) {
       std::unique_lock<std::mutex> lock(le_acl_connections_guard_);
-      auto it = le_acl_connections_.find(handle);
-      if (it != le_acl_connections_.end()) {
-        return it->second.remote_address_;
+      auto connection = le_acl_connections_.find(handle);
+      if (connection != nullptr) {
+        return connection->remote_address_;
       }
       AddressWithType empty(Address::kEmpty, AddressType::RANDOM_DEVICE_ADDRESS);
       return empty;
     }
 
     bool alreadyConnected(AddressWithType address_with_type) {
-      for (auto it = le_acl_connections_.begin(); it != le_acl_connections_.end(); it++) {
-        if (it->second.remote_address_ == address_with_type) {
-          return true;
-        }
-      }
-      return false;
+      bool connected = false;
+      le_acl_connections_.for_each(
+          address_with_type.GetAddress(), [&](uint16_t /* handle */, const le_acl_connection& connection) {
+            connected |= connection.remote_address_ == address_with_type;
+          });
+      return connected;
     }
 
   } connections;
@@ -410,6 +416,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         create_le_connection(remote_address, false, false);
         return;
       }
+      connection_timeline_.OnConnectionComplete(remote_address, status == ErrorCode::SUCCESS);
 
       arm_on_resume_ = false;
       ready_to_unregister = true;
@@ -446,6 +453,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       if (in_filter_accept_list) {
         log::info(
             "Received incoming connection of device in filter accept_list, {}", remote_address);
+        connection_timeline_.OnCancel(remote_address);
         direct_connect_remove(remote_address);
         remove_device_from_accept_list(remote_address);
       }
@@ -455,6 +463,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       log::error("Receive connection complete with invalid connection parameters");
       return;
     }
+    store_connection_parameters(remote_address, conn_interval, conn_latency, supervision_timeout);
     auto role_specific_data = initialize_role_specific_data(role);
     auto queue = std::make_shared<AclConnection::Queue>(10);
     auto queue_down_end = queue->GetDownEnd();
@@ -562,6 +571,13 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
     auto handle = complete_view.GetConnectionHandle();
+    if (complete_view.GetStatus() == ErrorCode::SUCCESS) {
+      store_connection_parameters(
+          connections.getAddressWithType(handle),
+          complete_view.GetConnInterval(),
+          complete_view.GetConnLatency(),
+          complete_view.GetSupervisionTimeout());
+    }
     connections.execute(handle, [=](LeConnectionManagementCallbacks* callbacks) {
       callbacks->OnConnectionUpdate(
           complete_view.GetStatus(),
@@ -699,6 +715,116 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       create_connection_timeout_alarms_.erase(it);
     }
     direct_connections_.erase(address_with_type);
+    fast_reconnect_expired_.erase(address_with_type);
+    if (fast_reconnect_address_ == address_with_type) {
+      fast_reconnect_alarm_->Cancel();
+      fast_reconnect_address_.reset();
+    }
+  }
+
+  // Connection parameters of a bonded device, from its last connection.
+  struct StoredConnectionParameters {
+    uint16_t conn_interval;
+    uint16_t conn_latency;
+    uint16_t supervision_timeout;
+  };
+
+  bool is_bonded(const std::string& section) const {
+    return storage_module_->HasProperty(section, BTIF_STORAGE_KEY_LE_KEY_PENC) ||
+           storage_module_->HasProperty(section, BTIF_STORAGE_KEY_LE_KEY_PID);
+  }
+
+  std::optional<StoredConnectionParameters> load_connection_parameters(AddressWithType address_with_type) {
+    if (storage_module_ == nullptr) {
+      return std::nullopt;
+    }
+    auto section = address_with_type.GetAddress().ToString();
+    if (!is_bonded(section)) {
+      return std::nullopt;
+    }
+    auto value = storage_module_->GetBin(section, BTIF_STORAGE_KEY_LE_CONN_PARAMS);
+    if (!value.has_value() || value->size() != 6) {
+      return std::nullopt;
+    }
+    auto& bytes = value.value();
+    StoredConnectionParameters parameters{
+        .conn_interval = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8)),
+        .conn_latency = static_cast<uint16_t>(bytes[2] | (bytes[3] << 8)),
+        .supervision_timeout = static_cast<uint16_t>(bytes[4] | (bytes[5] << 8)),
+    };
+    if (!check_connection_parameters(
+            parameters.conn_interval,
+            parameters.conn_interval,
+            parameters.conn_latency,
+            parameters.supervision_timeout)) {
+      return std::nullopt;
+    }
+    return parameters;
+  }
+
+  void store_connection_parameters(
+      AddressWithType address_with_type, uint16_t conn_interval, uint16_t conn_latency, uint16_t supervision_timeout) {
+    if (storage_module_ == nullptr || address_with_type.GetAddress() == Address::kEmpty ||
+        !os::GetSystemPropertyBool(kPropertyEnableFastReconnect, kEnableFastReconnect)) {
+      return;
+    }
+    auto section = address_with_type.GetAddress().ToString();
+    if (!is_bonded(section)) {
+      return;
+    }
+    std::vector<uint8_t> value = {
+        static_cast<uint8_t>(conn_interval),
+        static_cast<uint8_t>(conn_interval >> 8),
+        static_cast<uint8_t>(conn_latency),
+        static_cast<uint8_t>(conn_latency >> 8),
+        static_cast<uint8_t>(supervision_timeout),
+        static_cast<uint8_t>(supervision_timeout >> 8),
+    };
+    if (storage_module_->GetBin(section, BTIF_STORAGE_KEY_LE_CONN_PARAMS) != value) {
+      storage_module_->SetBin(section, BTIF_STORAGE_KEY_LE_CONN_PARAMS, value);
+    }
+  }
+
+  // Returns the stored connection parameters to reconnect the only direct connection with, and
+  // starts the fast reconnect period. The fast reconnect ends once the period expired, until the
+  // direct connection is removed.
+  std::optional<StoredConnectionParameters> start_fast_reconnect() {
+    if (!os::GetSystemPropertyBool(kPropertyEnableFastReconnect, kEnableFastReconnect) || system_suspend_ ||
+        direct_connections_.size() != 1) {
+      return std::nullopt;
+    }
+    auto address_with_type = *direct_connections_.begin();
+    if (fast_reconnect_expired_.find(address_with_type) != fast_reconnect_expired_.end()) {
+      return std::nullopt;
+    }
+    auto parameters = load_connection_parameters(address_with_type);
+    if (!parameters.has_value()) {
+      return std::nullopt;
+    }
+    if (fast_reconnect_address_ != address_with_type) {
+      if (fast_reconnect_alarm_ == nullptr) {
+        fast_reconnect_alarm_ = std::make_unique<os::Alarm>(handler_);
+      }
+      fast_reconnect_address_ = address_with_type;
+      fast_reconnect_alarm_->Schedule(
+          common::BindOnce(&le_impl::on_fast_reconnect_timeout, common::Unretained(this), address_with_type),
+          std::chrono::milliseconds(
+              os::GetSystemPropertyUint32(kPropertyFastReconnectScanDuration, kFastReconnectScanDurationMs)));
+      log::info("Fast reconnect to {}", address_with_type);
+    }
+    return parameters;
+  }
+
+  void on_fast_reconnect_timeout(AddressWithType address_with_type) {
+    log::info("Fast reconnect period to {} expired", address_with_type);
+    fast_reconnect_address_.reset();
+    fast_reconnect_expired_.insert(address_with_type);
+    // Re-arm with the default parameters.
+    if (!pause_connection &&
+        (connectability_state_ == ConnectabilityState::ARMED || connectability_state_ == ConnectabilityState::ARMING)) {
+      arm_on_disarm_ = true;
+      disarm_connectability();
+    }
   }
 
   void add_device_to_accept_list(AddressWithType address_with_type) {
@@ -713,6 +839,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     }
 
     accept_list.insert(address_with_type);
+    connection_timeline_.OnAcceptListAdd(address_with_type);
     register_with_address_manager();
     le_address_manager_->AddDeviceToFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
@@ -847,6 +974,19 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     uint16_t conn_interval_max = os::GetSystemPropertyUint32(kPropertyMaxConnInterval, kConnIntervalMax);
     uint16_t conn_latency = os::GetSystemPropertyUint32(kPropertyConnLatency, kConnLatency);
     uint16_t supervision_timeout = os::GetSystemPropertyUint32(kPropertyConnSupervisionTimeout, kSupervisionTimeout);
+    // Reconnect a bonded device with a high duty scan and its last connection parameters, which
+    // avoids the connection parameter update after the connection.
+    auto fast_reconnect_parameters = start_fast_reconnect();
+    if (fast_reconnect_parameters.has_value()) {
+      le_scan_interval = os::GetSystemPropertyUint32(kPropertyConnScanIntervalFast, kScanIntervalFast);
+      le_scan_window = le_scan_interval;
+      le_scan_window_2m = le_scan_interval;
+      le_scan_window_coded = le_scan_interval;
+      conn_interval_min = fast_reconnect_parameters->conn_interval;
+      conn_interval_max = fast_reconnect_parameters->conn_interval;
+      conn_latency = fast_reconnect_parameters->conn_latency;
+      supervision_timeout = fast_reconnect_parameters->supervision_timeout;
+    }
     log::assert_that(
         check_connection_parameters(
             conn_interval_min, conn_interval_max, conn_latency, supervision_timeout),
@@ -858,6 +998,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       address_with_type = AddressWithType();
     }
 
+    connection_timeline_.OnCreateConnection();
     if (controller_->IsSupported(OpCode::LE_EXTENDED_CREATE_CONNECTION)) {
       bool only_init_1m_phy = os::GetSystemPropertyBool(kPropertyEnableBleOnlyInit1mPhy, kEnableBleOnlyInit1mPhy);
 
@@ -967,6 +1108,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     bool already_in_accept_list = accept_list.find(address_with_type) != accept_list.end();
     // TODO: Configure default LE connection parameters?
     if (add_to_accept_list) {
+      connection_timeline_.OnRequest(address_with_type, is_direct);
       if (!already_in_accept_list) {
         add_device_to_accept_list(address_with_type);
       }
@@ -1021,6 +1163,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
 
   void on_create_connection_timeout(AddressWithType address_with_type) {
     log::info("on_create_connection_timeout, address: {}", address_with_type);
+    connection_timeline_.OnConnectionComplete(address_with_type, false);
     direct_connect_remove(address_with_type);
 
     if (background_connections_.find(address_with_type) != background_connections_.end()) {
@@ -1036,11 +1179,33 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   }
 
   void cancel_connect(AddressWithType address_with_type) {
+    connection_timeline_.OnCancel(address_with_type);
     direct_connect_remove(address_with_type);
     // the connection will be canceled by LeAddressManager.OnPause()
     remove_device_from_accept_list(address_with_type);
   }
 
+  void cancel_connects(std::vector<AddressWithType> address_with_types) {
+    LeAddressManager::ListUpdate update;
+    for (const auto& address_with_type : address_with_types) {
+      connection_timeline_.OnCancel(address_with_type);
+      direct_connect_remove(address_with_type);
+      if (accept_list.erase(address_with_type) == 0) {
+        log::warn("Device not in acceptlist and cannot be removed: {}", address_with_type);
+        continue;
+      }
+      connecting_le_.erase(address_with_type);
+      update.RemoveDeviceFromFilterAcceptList(
+          address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    }
+    if (update.IsEmpty()) {
+      return;
+    }
+    // the connections will be canceled by LeAddressManager.OnPause(), a single pause covers all the removals
+    register_with_address_manager();
+    le_address_manager_->ApplyListUpdate(std::move(update));
+  }
+
   void set_le_suggested_default_data_parameters(uint16_t length, uint16_t time) {
     auto packet = LeWriteSuggestedDefaultDataLengthBuilder::Create(length, time);
     le_acl_connection_interface_->EnqueueCommand(
@@ -1249,6 +1414,11 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   bool system_suspend_ = false;
   ConnectabilityState connectability_state_{ConnectabilityState::DISARMED};
   std::map<AddressWithType, os::Alarm> create_connection_timeout_alarms_{};
+  LeConnectionTimeline connection_timeline_;
+  storage::StorageModule* storage_module_ = nullptr;
+  std::optional<AddressWithType> fast_reconnect_address_;
+  std::unordered_set<AddressWithType> fast_reconnect_expired_;
+  std::unique_ptr<os::Alarm> fast_reconnect_alarm_;
 };
 
 }  // namespace acl_manager
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/page_history.h"
+
+#include <algorithm>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+constexpr uint64_t kMicrosecondsPerSlot = 625;
+}  // namespace
+
+const PageHistory::Device* PageHistory::FindDevice(const Address& address) const {
+  auto it = devices_.find(address);
+  return it == devices_.end() ? nullptr : &it->second;
+}
+
+PageHistory::Likelihood PageHistory::GetLikelihood(const Address& address) const {
+  const Device* device = FindDevice(address);
+  if (device == nullptr) {
+    return Likelihood::UNKNOWN;
+  }
+  if (device->consecutive_page_timeouts >= kPageTimeoutsBeforeUnlikely) {
+    return Likelihood::UNLIKELY;
+  }
+  if (device->consecutive_page_timeouts == 0 && device->successes > 0) {
+    return Likelihood::LIKELY;
+  }
+  return Likelihood::UNKNOWN;
+}
+
+uint16_t PageHistory::GetPageTimeout(const Address& address, uint16_t default_page_timeout) const {
+  const uint16_t min_page_timeout = std::min(kMinPageTimeout, default_page_timeout);
+  const Device* device = FindDevice(address);
+  switch (GetLikelihood(address)) {
+    case Likelihood::UNLIKELY:
+      // Still page the device, in case it came back, but give up early
+      return min_page_timeout;
+    case Likelihood::LIKELY: {
+      // Leave twice the time of the slow recent pages, in case the device is busier this time
+      auto slots = 2 * std::chrono::duration_cast<std::chrono::microseconds>(device->page_duration).count() /
+                   kMicrosecondsPerSlot;
+      return static_cast<uint16_t>(std::clamp<uint64_t>(slots, min_page_timeout, default_page_timeout));
+    }
+    case Likelihood::UNKNOWN:
+      // Retry with the whole page timeout after a first page timeout
+      return default_page_timeout;
+  }
+  return default_page_timeout;
+}
+
+void PageHistory::OnPageStart(
+    const Address& address, uint16_t page_timeout, uint16_t default_page_timeout, Clock::time_point now) {
+  attempt_ = Attempt{.address = address, .page_timeout = page_timeout, .start = now};
+  if (page_timeout < default_page_timeout) {
+    stats_.shortened++;
+  }
+}
+
+std::optional<PageHistory::Clock::duration> PageHistory::OnPageComplete(
+    const Address& address, ErrorCode status, Clock::time_point now) {
+  if (!IsPaging(address)) {
+    return std::nullopt;
+  }
+  const auto duration = now - attempt_->start;
+  attempt_.reset();
+
+  const auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+  stats_.total_ms += duration_ms;
+  stats_.max_ms = std::max<uint32_t>(stats_.max_ms, duration_ms);
+
+  const Device* known_device = FindDevice(address);
+  Device device = known_device == nullptr ? Device{} : *known_device;
+  switch (status) {
+    case ErrorCode::SUCCESS:
+      stats_.succeeded++;
+      device.successes++;
+      device.consecutive_page_timeouts = 0;
+      // Forget a slow page progressively, but follow the slower ones immediately
+      device.page_duration = std::max(duration, (device.page_duration + duration) / 2);
+      break;
+    case ErrorCode::PAGE_TIMEOUT:
+      stats_.page_timeouts++;
+      device.consecutive_page_timeouts++;
+      break;
+    default:
+      // Cancelled, or failed for a reason unrelated to the presence of the device
+      stats_.other_failures++;
+      break;
+  }
+  devices_.insert_or_assign(address, device);
+  return duration;
+}
+
+std::string PageHistory::LikelihoodText(Likelihood likelihood) {
+  switch (likelihood) {
+    case Likelihood::UNLIKELY:
+      return "unlikely";
+    case Likelihood::UNKNOWN:
+      return "unknown";
+    case Likelihood::LIKELY:
+      return "likely";
+  }
+  return "unknown";
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "common/lru_cache.h"
+#include "hci/address.h"
+#include "hci/hci_packets.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// History of the pages of the locally initiated classic connections, per device. It ranks the
+// queued connections by how likely they are to succeed, and shortens the page timeout for the
+// devices that answer quickly, or that did not answer the last pages, so that an absent device
+// does not hold the other connections for the whole page timeout.
+class PageHistory {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Likelihood : uint8_t {
+    // The last pages to the device timed out
+    UNLIKELY = 0,
+    // No recent page to the device, or the last one timed out after earlier successes
+    UNKNOWN = 1,
+    // The last page to the device succeeded
+    LIKELY = 2,
+  };
+
+  static constexpr size_t kMaxDevices = 64;
+  // Page timeouts are in slots of 0.625 ms. A device in page scan answers a page within 2.56 s in
+  // page scan repetition modes R0 and R1.
+  static constexpr uint16_t kMinPageTimeout = 0x1000;
+  // Consecutive page timeouts after which a device is assumed to be absent
+  static constexpr uint32_t kPageTimeoutsBeforeUnlikely = 2;
+
+  struct Stats {
+    uint32_t succeeded{0};
+    uint32_t page_timeouts{0};
+    uint32_t other_failures{0};
+    // Attempts started with a page timeout shorter than the default one
+    uint32_t shortened{0};
+    uint64_t total_ms{0};
+    uint32_t max_ms{0};
+  };
+
+  Likelihood GetLikelihood(const Address& address) const;
+
+  // Return the page timeout to use for the next page to the device, which is never longer than
+  // |default_page_timeout|
+  uint16_t GetPageTimeout(const Address& address, uint16_t default_page_timeout) const;
+
+  void OnPageStart(
+      const Address& address,
+      uint16_t page_timeout,
+      uint16_t default_page_timeout,
+      Clock::time_point now = Clock::now());
+
+  // Return the duration of the page, or nullopt if no page to the device was started
+  std::optional<Clock::duration> OnPageComplete(
+      const Address& address, ErrorCode status, Clock::time_point now = Clock::now());
+
+  bool IsPaging(const Address& address) const {
+    return attempt_.has_value() && attempt_->address == address;
+  }
+
+  const Stats& GetStats() const {
+    return stats_;
+  }
+
+  static std::string LikelihoodText(Likelihood likelihood);
+
+ private:
+  struct Device {
+    uint32_t successes{0};
+    uint32_t consecutive_page_timeouts{0};
+    // Duration of the slow pages that succeeded recently
+    Clock::duration page_duration{0};
+  };
+
+  struct Attempt {
+    Address address;
+    uint16_t page_timeout;
+    Clock::time_point start;
+  };
+
+  const Device* FindDevice(const Address& address) const;
+
+  // Only one page is outgoing at a time, as the ACL scheduler serializes the connections
+  std::optional<Attempt> attempt_;
+  common::LruCache<Address, Device> devices_{kMaxDevices};
+  Stats stats_;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/page_history.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+const Address kAddress1 = Address({0, 1, 2, 3, 4, 5});
+const Address kAddress2 = Address({0, 1, 2, 3, 4, 6});
+
+constexpr uint16_t kDefaultPageTimeout = 0x2000;
+
+using Likelihood = PageHistory::Likelihood;
+
+class PageHistoryTest : public ::testing::Test {
+ protected:
+  void Page(const Address& address, ErrorCode status, PageHistory::Clock::duration duration) {
+    uint16_t page_timeout = history_.GetPageTimeout(address, kDefaultPageTimeout);
+    history_.OnPageStart(address, page_timeout, kDefaultPageTimeout, now_);
+    now_ += duration;
+    history_.OnPageComplete(address, status, now_);
+  }
+
+  PageHistory history_;
+  PageHistory::Clock::time_point now_{PageHistory::Clock::now()};
+};
+
+TEST_F(PageHistoryTest, unknown_device_uses_default_page_timeout) {
+  ASSERT_EQ(Likelihood::UNKNOWN, history_.GetLikelihood(kAddress1));
+  ASSERT_EQ(kDefaultPageTimeout, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+}
+
+TEST_F(PageHistoryTest, page_duration_recorded) {
+  history_.OnPageStart(kAddress1, kDefaultPageTimeout, kDefaultPageTimeout, now_);
+  ASSERT_TRUE(history_.IsPaging(kAddress1));
+  ASSERT_FALSE(history_.IsPaging(kAddress2));
+
+  // A completion for another device is not the completion of the page
+  ASSERT_FALSE(history_.OnPageComplete(kAddress2, ErrorCode::SUCCESS, now_ + 100ms).has_value());
+  auto duration = history_.OnPageComplete(kAddress1, ErrorCode::SUCCESS, now_ + 600ms);
+  ASSERT_TRUE(duration.has_value());
+  ASSERT_EQ(600ms, duration.value());
+  ASSERT_FALSE(history_.IsPaging(kAddress1));
+
+  ASSERT_EQ(1u, history_.GetStats().succeeded);
+  ASSERT_EQ(600u, history_.GetStats().total_ms);
+  ASSERT_EQ(600u, history_.GetStats().max_ms);
+}
+
+TEST_F(PageHistoryTest, device_answering_quickly_gets_shorter_page_timeout) {
+  Page(kAddress1, ErrorCode::SUCCESS, 1000ms);
+  ASSERT_EQ(Likelihood::LIKELY, history_.GetLikelihood(kAddress1));
+  // Twice the page duration, which is 2 s or 3200 slots, but no less than the minimum
+  ASSERT_EQ(PageHistory::kMinPageTimeout, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+
+  Page(kAddress1, ErrorCode::SUCCESS, 2000ms);
+  // Twice the page duration, which is 4 s or 6400 slots
+  ASSERT_EQ(6400, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+
+  // A slow page is forgotten progressively
+  Page(kAddress1, ErrorCode::SUCCESS, 1000ms);
+  ASSERT_EQ(4800, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+  // The first page, to an unknown device, used the default page timeout
+  ASSERT_EQ(2u, history_.GetStats().shortened);
+}
+
+TEST_F(PageHistoryTest, page_timeout_never_longer_than_default) {
+  Page(kAddress1, ErrorCode::SUCCESS, 4000ms);
+  ASSERT_EQ(kDefaultPageTimeout, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+  ASSERT_EQ(0x0800, history_.GetPageTimeout(kAddress1, 0x0800));
+}
+
+TEST_F(PageHistoryTest, absent_device_gets_short_page_timeout) {
+  Page(kAddress1, ErrorCode::PAGE_TIMEOUT, 5120ms);
+  // A single page timeout is retried with the whole page timeout
+  ASSERT_EQ(Likelihood::UNKNOWN, history_.GetLikelihood(kAddress1));
+  ASSERT_EQ(kDefaultPageTimeout, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+
+  Page(kAddress1, ErrorCode::PAGE_TIMEOUT, 5120ms);
+  ASSERT_EQ(Likelihood::UNLIKELY, history_.GetLikelihood(kAddress1));
+  ASSERT_EQ(PageHistory::kMinPageTimeout, history_.GetPageTimeout(kAddress1, kDefaultPageTimeout));
+  ASSERT_EQ(2u, history_.GetStats().page_timeouts);
+
+  // The device is likely again once it answers
+  Page(kAddress1, ErrorCode::SUCCESS, 500ms);
+  ASSERT_EQ(Likelihood::LIKELY, history_.GetLikelihood(kAddress1));
+}
+
+TEST_F(PageHistoryTest, other_failures_do_not_change_likelihood) {
+  Page(kAddress1, ErrorCode::SUCCESS, 500ms);
+  Page(kAddress1, ErrorCode::UNKNOWN_CONNECTION, 100ms);
+  ASSERT_EQ(Likelihood::LIKELY, history_.GetLikelihood(kAddress1));
+  ASSERT_EQ(1u, history_.GetStats().other_failures);
+}
+
+TEST_F(PageHistoryTest, likelihood_orders_ranks) {
+  ASSERT_LT(static_cast<uint8_t>(Likelihood::UNLIKELY), static_cast<uint8_t>(Likelihood::UNKNOWN));
+  ASSERT_LT(static_cast<uint8_t>(Likelihood::UNKNOWN), static_cast<uint8_t>(Likelihood::LIKELY));
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -18,14 +18,36 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
 #include "hci/acl_manager/acl_fragmenter.h"
+#include "os/trace.h"
+
 namespace bluetooth {
 namespace hci {
 namespace acl_manager {
 
+namespace {
+
+// Counter track of the controller buffers, with a slice over the time the
+// buffers are full and the links wait for credits
+void trace_acl_credits(
+    RoundRobinScheduler::ConnectionType connection_type, uint16_t previous_credits, uint16_t credits) {
+  bool classic = connection_type == RoundRobinScheduler::ConnectionType::CLASSIC;
+  BT_TRACE_COUNTER(classic ? "ACL credits" : "LE ACL credits", credits);
+  if (previous_credits != 0 && credits == 0) {
+    BT_TRACE_ASYNC_BEGIN(classic ? "ACL credits wait" : "LE ACL credits wait", 0);
+  } else if (previous_credits == 0 && credits != 0) {
+    BT_TRACE_ASYNC_END(classic ? "ACL credits wait" : "LE ACL credits wait", 0);
+  }
+}
+
+}  // namespace
+
 RoundRobinScheduler::RoundRobinScheduler(
     os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end)
     : handler_(handler), controller_(controller), hci_queue_end_(hci_queue_end) {
+  current_turn_ = acl_queue_handlers_.end();
   max_acl_packet_credits_ = controller_->GetNumAclPacketBuffers();
   acl_packet_credits_ = max_acl_packet_credits_;
   hci_mtu_ = controller_->GetAclPacketLength();
@@ -47,7 +69,10 @@ void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t hand
       acl_queue_handlers_.count(handle) == 0,
       "assert failed: acl_queue_handlers_.count(handle) == 0");
   acl_queue_handler acl_queue_handler = {connection_type, std::move(queue), false, 0};
-  acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
+  {
+    std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+    acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
+  }
   if (fragments_to_send_.size() == 0) {
     start_round_robin();
   }
@@ -60,9 +85,13 @@ void RoundRobinScheduler::Unregister(uint16_t handle) {
   auto acl_queue_handler = acl_queue_handlers_.find(handle)->second;
   // Reclaim outstanding packets
   if (acl_queue_handler.connection_type_ == ConnectionType::CLASSIC) {
+    uint16_t previous_credits = acl_packet_credits_;
     acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
+    trace_acl_credits(ConnectionType::CLASSIC, previous_credits, acl_packet_credits_);
   } else {
+    uint16_t previous_credits = le_acl_packet_credits_;
     le_acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
+    trace_acl_credits(ConnectionType::LE, previous_credits, le_acl_packet_credits_);
   }
   acl_queue_handler.number_of_sent_packets_ = 0;
 
@@ -70,8 +99,12 @@ void RoundRobinScheduler::Unregister(uint16_t handle) {
     acl_queue_handler.dequeue_is_registered_ = false;
     acl_queue_handler.queue_->GetDownEnd()->UnregisterDequeue();
   }
-  acl_queue_handlers_.erase(handle);
+  {
+    std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+    acl_queue_handlers_.erase(handle);
+  }
   starting_point_ = acl_queue_handlers_.begin();
+  current_turn_ = acl_queue_handlers_.end();
 }
 
 void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
@@ -80,9 +113,43 @@ void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
     log::warn("handle {} is invalid", handle);
     return;
   }
+  std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
   acl_queue_handler->second.high_priority_ = high_priority;
 }
 
+void RoundRobinScheduler::SetLinkWeight(uint16_t handle, uint16_t weight) {
+  auto acl_queue_handler = acl_queue_handlers_.find(handle);
+  if (acl_queue_handler == acl_queue_handlers_.end()) {
+    log::warn("handle {} is invalid", handle);
+    return;
+  }
+  if (weight == 0) {
+    log::warn("weight of handle {} must be positive, using {}", handle, kDefaultLinkWeight);
+    weight = kDefaultLinkWeight;
+  }
+  std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+  acl_queue_handler->second.weight_ = weight;
+}
+
+std::vector<RoundRobinScheduler::LinkUsage> RoundRobinScheduler::GetLinkUsage() const {
+  std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+  std::vector<LinkUsage> usage;
+  usage.reserve(acl_queue_handlers_.size());
+  for (const auto& [handle, link] : acl_queue_handlers_) {
+    usage.push_back(LinkUsage{
+        handle,
+        link.connection_type_,
+        link.high_priority_,
+        link.weight_,
+        link.deficit_,
+        link.number_of_sent_packets_,
+        link.max_outstanding_fragments_,
+        link.total_sent_fragments_,
+    });
+  }
+  return usage;
+}
+
 uint16_t RoundRobinScheduler::GetCredits() {
   return acl_packet_credits_;
 }
@@ -137,18 +204,84 @@ void RoundRobinScheduler::start_round_robin() {
   starting_point_ = std::next(starting_point_);
 }
 
+bool RoundRobinScheduler::has_credits(ConnectionType connection_type) const {
+  return connection_type == ConnectionType::CLASSIC ? acl_packet_credits_ > 0 : le_acl_packet_credits_ > 0;
+}
+
+size_t RoundRobinScheduler::fragment_count(ConnectionType connection_type, size_t packet_size) const {
+  size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
+  if (mtu == 0 || packet_size <= mtu) {
+    return 1;
+  }
+  return (packet_size + mtu - 1) / mtu;
+}
+
+std::unique_ptr<packet::BasePacketBuilder> RoundRobinScheduler::dequeue_next_packet(
+    std::map<uint16_t, acl_queue_handler>::iterator* selected) {
+  // Links in the high priority class are always served first.
+  for (auto it = acl_queue_handlers_.begin(); it != acl_queue_handlers_.end(); it++) {
+    if (!it->second.high_priority_ || !has_credits(it->second.connection_type_)) {
+      continue;
+    }
+    auto packet = it->second.queue_->GetDownEnd()->TryDequeue();
+    if (packet != nullptr) {
+      *selected = it;
+      return packet;
+    }
+  }
+
+  // Deficit round robin over the other links. A link earns |weight_| credits
+  // when its turn starts, keeps the turn while its deficit is positive, and
+  // pays one credit per fragment, so a large packet leaves it in debt for
+  // the following rounds. Idle links do not bank credits.
+  std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+  if (current_turn_ == acl_queue_handlers_.end()) {
+    current_turn_ = acl_queue_handlers_.begin();
+    current_turn_->second.deficit_ += current_turn_->second.weight_;
+  }
+
+  bool in_debt = true;
+  while (in_debt) {
+    in_debt = false;
+    for (size_t count = acl_queue_handlers_.size(); count > 0; count--) {
+      auto& link = current_turn_->second;
+      if (!link.high_priority_ && has_credits(link.connection_type_)) {
+        if (link.deficit_ > 0) {
+          auto packet = link.queue_->GetDownEnd()->TryDequeue();
+          if (packet != nullptr) {
+            link.deficit_ -= static_cast<int32_t>(fragment_count(link.connection_type_, packet->size()));
+            *selected = current_turn_;
+            return packet;
+          }
+          link.deficit_ = 0;
+        } else {
+          in_debt = true;
+        }
+      }
+      current_turn_ = std::next(current_turn_);
+      if (current_turn_ == acl_queue_handlers_.end()) {
+        current_turn_ = acl_queue_handlers_.begin();
+      }
+      current_turn_->second.deficit_ += current_turn_->second.weight_;
+    }
+  }
+  return nullptr;
+}
+
 void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
   BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
-  auto acl_queue_handler = acl_queue_handlers_.find(acl_handle);
-  if( acl_queue_handler == acl_queue_handlers_.end()) {
+  if (acl_queue_handlers_.find(acl_handle) == acl_queue_handlers_.end()) {
     log::error("Ignore since ACL connection vanished with handle: 0x{:X}", acl_handle);
     return;
   }
 
+  // The link that became ready is not necessarily the one whose turn it is
+  std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler;
+  auto packet = dequeue_next_packet(&acl_queue_handler);
+  log::assert_that(packet != nullptr, "assert failed: packet != nullptr");
+
   // Wrap packet and enqueue it
   uint16_t handle = acl_queue_handler->first;
-  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
-  log::assert_that(packet != nullptr, "assert failed: packet != nullptr");
 
   ConnectionType connection_type = acl_queue_handler->second.connection_type_;
   size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
@@ -176,7 +309,13 @@ void RoundRobinScheduler::buffer_packet(uint16_t acl_handle) {
   log::assert_that(fragments_to_send_.size() > 0, "assert failed: fragments_to_send_.size() > 0");
   unregister_all_connections();
 
-  acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
+  {
+    std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+    auto& link = acl_queue_handler->second;
+    link.number_of_sent_packets_ += fragments_to_send_.size();
+    link.total_sent_fragments_ += fragments_to_send_.size();
+    link.max_outstanding_fragments_ = std::max(link.max_outstanding_fragments_, link.number_of_sent_packets_);
+  }
   send_next_fragment();
 }
 
@@ -203,9 +342,11 @@ std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment()
   if (connection_type == ConnectionType::CLASSIC) {
     log::assert_that(acl_packet_credits_ > 0, "assert failed: acl_packet_credits_ > 0");
     acl_packet_credits_ -= 1;
+    trace_acl_credits(connection_type, acl_packet_credits_ + 1, acl_packet_credits_);
   } else {
     log::assert_that(le_acl_packet_credits_ > 0, "assert failed: le_acl_packet_credits_ > 0");
     le_acl_packet_credits_ -= 1;
+    trace_acl_credits(connection_type, le_acl_packet_credits_ + 1, le_acl_packet_credits_);
   }
 
   auto raw_pointer = fragments_to_send_.front().second.release();
@@ -232,15 +373,19 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
     return;
   }
 
-  if (acl_queue_handler->second.number_of_sent_packets_ >= credits) {
-    acl_queue_handler->second.number_of_sent_packets_ -= credits;
-  } else {
-    log::warn("receive more credits than we sent");
-    acl_queue_handler->second.number_of_sent_packets_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(acl_queue_handlers_mutex_);
+    if (acl_queue_handler->second.number_of_sent_packets_ >= credits) {
+      acl_queue_handler->second.number_of_sent_packets_ -= credits;
+    } else {
+      log::warn("receive more credits than we sent");
+      acl_queue_handler->second.number_of_sent_packets_ = 0;
+    }
   }
 
   bool credit_was_zero = false;
   if (acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC) {
+    uint16_t previous_credits = acl_packet_credits_;
     if (acl_packet_credits_ == 0) {
       credit_was_zero = true;
     }
@@ -249,7 +394,9 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       acl_packet_credits_ = max_acl_packet_credits_;
       log::warn("acl packet credits overflow due to receive {} credits", credits);
     }
+    trace_acl_credits(ConnectionType::CLASSIC, previous_credits, acl_packet_credits_);
   } else {
+    uint16_t previous_credits = le_acl_packet_credits_;
     if (le_acl_packet_credits_ == 0) {
       credit_was_zero = true;
     }
@@ -258,6 +405,7 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       le_acl_packet_credits_ = le_max_acl_packet_credits_;
       log::warn("le acl packet credits overflow due to receive {} credits", credits);
     }
+    trace_acl_credits(ConnectionType::LE, previous_credits, le_acl_packet_credits_);
   }
   if (credit_was_zero) {
     start_round_robin();
@@ -19,6 +19,9 @@
 #include <bluetooth/log.h>
 #include <stdint.h>
 
+#include <mutex>
+#include <vector>
+
 #include "common/bidi_queue.h"
 #include "common/multi_priority_queue.h"
 #include "hci/acl_manager/acl_connection.h"
@@ -38,24 +41,53 @@ class RoundRobinScheduler {
 
   enum ConnectionType { CLASSIC, LE };
 
+  // Number of controller credits a link earns per scheduling round.
+  static constexpr uint16_t kDefaultLinkWeight = 1;
+
   struct acl_queue_handler {
     ConnectionType connection_type_;
     std::shared_ptr<acl_manager::AclConnection::Queue> queue_;
     bool dequeue_is_registered_ = false;
     uint16_t number_of_sent_packets_ = 0;  // Track credits
     bool high_priority_ = false;           // For A2dp use
+    uint16_t weight_ = kDefaultLinkWeight;
+    int32_t deficit_ = 0;
+    uint64_t total_sent_fragments_ = 0;
+    uint16_t max_outstanding_fragments_ = 0;
+  };
+
+  struct LinkUsage {
+    uint16_t handle;
+    ConnectionType connection_type;
+    bool high_priority;
+    uint16_t weight;
+    int32_t deficit;
+    uint16_t outstanding_fragments;
+    uint16_t max_outstanding_fragments;
+    uint64_t total_sent_fragments;
   };
 
   void Register(ConnectionType connection_type, uint16_t handle,
                 std::shared_ptr<acl_manager::AclConnection::Queue> queue);
   void Unregister(uint16_t handle);
+  // High priority links are served before any other link, regardless of
+  // weights.
   void SetLinkPriority(uint16_t handle, bool high_priority);
+  // Links of the normal priority class share the controller credits in
+  // proportion to their weight (deficit round robin).
+  void SetLinkWeight(uint16_t handle, uint16_t weight);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
+  // Thread safe, may be called from outside of the scheduler handler.
+  std::vector<LinkUsage> GetLinkUsage() const;
 
  private:
   void start_round_robin();
   void buffer_packet(uint16_t acl_handle);
+  std::unique_ptr<packet::BasePacketBuilder> dequeue_next_packet(
+      std::map<uint16_t, acl_queue_handler>::iterator* selected);
+  size_t fragment_count(ConnectionType connection_type, size_t packet_size) const;
+  bool has_credits(ConnectionType connection_type) const;
   void unregister_all_connections();
   void send_next_fragment();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
@@ -63,6 +95,9 @@ class RoundRobinScheduler {
 
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
+  // Guards the structure of |acl_queue_handlers_| and the usage counters so
+  // that they can be read by GetLinkUsage() from the dumpsys thread.
+  mutable std::mutex acl_queue_handlers_mutex_;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
   common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
   uint16_t max_acl_packet_credits_ = 0;
@@ -75,6 +110,8 @@ class RoundRobinScheduler {
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
   // first register queue end for the Round-robin schedule
   std::map<uint16_t, acl_queue_handler>::iterator starting_point_;
+  // Link whose deficit round robin turn is in progress
+  std::map<uint16_t, acl_queue_handler>::iterator current_turn_;
 };
 
 }  // namespace acl_manager
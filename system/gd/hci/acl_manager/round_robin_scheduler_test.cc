@@ -413,6 +413,120 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, weighted_links_share_credits) {
+  uint16_t handle1 = 0x01;
+  uint16_t handle2 = 0x02;
+  uint16_t filler_handle = 0x03;
+  auto connection_queue1 = std::make_shared<AclConnection::Queue>(10);
+  auto connection_queue2 = std::make_shared<AclConnection::Queue>(10);
+  auto filler_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, filler_handle, filler_queue);
+
+  // Use up all classic credits so that the next packets are scheduled together
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_));
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    EnqueueAclUpEnd(filler_queue->GetUpEnd(), {0x03, i});
+  }
+  packet_future_->wait();
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    VerifyPacket(filler_handle, {0x03, i});
+  }
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 0);
+
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle1, connection_queue1);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle2, connection_queue2);
+  round_robin_scheduler_->SetLinkWeight(handle1, 3);
+  for (uint8_t i = 0; i < 4; i++) {
+    EnqueueAclUpEnd(connection_queue1->GetUpEnd(), {0x01, i});
+    EnqueueAclUpEnd(connection_queue2->GetUpEnd(), {0x02, i});
+  }
+  enqueue_future_->wait();
+  sync_handler();
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(8));
+  controller_->SendCompletedAclPacketsCallback(filler_handle, 8);
+  packet_future_->wait();
+
+  // handle1 gets three credits per round, handle2 one
+  VerifyPacket(handle1, {0x01, 0});
+  VerifyPacket(handle1, {0x01, 1});
+  VerifyPacket(handle1, {0x01, 2});
+  VerifyPacket(handle2, {0x02, 0});
+  VerifyPacket(handle1, {0x01, 3});
+  VerifyPacket(handle2, {0x02, 1});
+  VerifyPacket(handle2, {0x02, 2});
+  VerifyPacket(handle2, {0x02, 3});
+
+  round_robin_scheduler_->Unregister(handle1);
+  round_robin_scheduler_->Unregister(handle2);
+  round_robin_scheduler_->Unregister(filler_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, high_priority_link_is_served_first) {
+  uint16_t handle = 0x01;
+  uint16_t high_priority_handle = 0x02;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(20);
+  auto high_priority_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(
+      RoundRobinScheduler::ConnectionType::CLASSIC, high_priority_handle, high_priority_queue);
+  round_robin_scheduler_->SetLinkPriority(high_priority_handle, true);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(controller_->max_acl_packet_credits_));
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_ + 2; i++) {
+    EnqueueAclUpEnd(connection_queue->GetUpEnd(), {0x01, i});
+  }
+  packet_future_->wait();
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    VerifyPacket(handle, {0x01, i});
+  }
+
+  EnqueueAclUpEnd(high_priority_queue->GetUpEnd(), {0x02, 0});
+  EnqueueAclUpEnd(high_priority_queue->GetUpEnd(), {0x02, 1});
+  enqueue_future_->wait();
+  sync_handler();
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(4));
+  controller_->SendCompletedAclPacketsCallback(handle, 4);
+  packet_future_->wait();
+  VerifyPacket(high_priority_handle, {0x02, 0});
+  VerifyPacket(high_priority_handle, {0x02, 1});
+  VerifyPacket(handle, {0x01, static_cast<uint8_t>(controller_->max_acl_packet_credits_)});
+  VerifyPacket(handle, {0x01, static_cast<uint8_t>(controller_->max_acl_packet_credits_ + 1)});
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(high_priority_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, link_usage_counts_fragments) {
+  uint16_t handle = 0x01;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->SetLinkWeight(handle, 2);
+
+  ASSERT_NO_FATAL_FAILURE(SetPacketFuture(3));
+  std::vector<uint8_t> packet(controller_->hci_mtu_ + 1, 0xaa);
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), {0x01});
+  packet_future_->wait();
+  sync_handler();
+
+  auto usage = round_robin_scheduler_->GetLinkUsage();
+  ASSERT_EQ(usage.size(), 1u);
+  ASSERT_EQ(usage[0].handle, handle);
+  ASSERT_EQ(usage[0].weight, 2);
+  ASSERT_EQ(usage[0].total_sent_fragments, 3u);
+  ASSERT_EQ(usage[0].outstanding_fragments, 3);
+
+  controller_->SendCompletedAclPacketsCallback(handle, 3);
+  sync_handler();
+  usage = round_robin_scheduler_->GetLinkUsage();
+  ASSERT_EQ(usage[0].outstanding_fragments, 0);
+  ASSERT_EQ(usage[0].max_outstanding_fragments, 3);
+
+  round_robin_scheduler_->Unregister(handle);
+}
+
 }  // namespace
 }  // namespace acl_manager
 }  // namespace hci
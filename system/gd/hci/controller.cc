@@ -20,6 +20,7 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
 #include <future>
 #include <memory>
 #include <string>
@@ -27,12 +28,14 @@
 
 #include "common/init_flags.h"
 #include "dumpsys_data_generated.h"
+#include "hci/controller_capability_cache.h"
 #include "hci/controller_interface.h"
 #include "hci/event_checkers.h"
 #include "hci/hci_layer.h"
 #include "hci_controller_generated.h"
 #include "os/log.h"
 #include "os/metrics.h"
+#include "os/parameter_provider.h"
 #include "os/system_properties.h"
 #if TARGET_FLOSS
 #include "sysprops/sysprops_module.h"
@@ -48,6 +51,21 @@ static const std::string kPropertyVendorCapabilitiesEnabled =
     "bluetooth.core.le.vendor_capabilities.enabled";
 static const char kPropertyDisabledCommands[] =
     "bluetooth.hci.disabled_commands";
+// Maximum number of HCI commands waiting for their response, for the
+// controllers of the command pipelining allowlist.
+static const char kPropertyMaxOutstandingCommands[] =
+    "bluetooth.hci.max_outstanding_commands";
+// Save the capabilities read from the controller, and answer the reads from
+// the saved capabilities on the next starts with the same controller firmware.
+static const char kPropertyCapabilityCacheEnabled[] =
+    "bluetooth.core.controller_capability_cache.enabled";
+static const char kCapabilityCacheFileName[] = "bt_controller_capabilities.conf";
+
+// Manufacturers of the controllers known to handle several outstanding HCI
+// commands, within their command credits.
+static constexpr uint16_t kCommandPipeliningAllowlist[] = {
+    0x00E0,  // Google (Root Canal and emulated controllers)
+};
 
 using os::Handler;
 
@@ -66,14 +84,20 @@ struct Controller::impl {
                          handler->BindOnceOn(this, &Controller::impl::read_local_name_complete_handler));
     hci_->EnqueueCommand(ReadLocalVersionInformationBuilder::Create(),
                          handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
-    hci_->EnqueueCommand(ReadLocalSupportedCommandsBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
 
-    hci_->EnqueueCommand(
+    if (os::GetSystemPropertyBool(kPropertyCapabilityCacheEnabled, false)) {
+      load_capability_cache();
+    }
+
+    enqueue_capability_read(
+        ReadLocalSupportedCommandsBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
+
+    enqueue_capability_read(
         LeReadLocalSupportedFeaturesBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::le_read_local_supported_features_handler));
 
-    hci_->EnqueueCommand(
+    enqueue_capability_read(
         LeReadSupportedStatesBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::le_read_supported_states_handler));
 
@@ -81,9 +105,10 @@ struct Controller::impl {
     std::promise<void> features_promise;
     auto features_future = features_promise.get_future();
 
-    hci_->EnqueueCommand(ReadLocalExtendedFeaturesBuilder::Create(0x00),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                             std::move(features_promise)));
+    enqueue_capability_read(
+        ReadLocalExtendedFeaturesBuilder::Create(0x00),
+        handler->BindOnceOn(
+            this, &Controller::impl::read_local_extended_features_complete_handler, std::move(features_promise)));
     features_future.wait();
 
     if (com::android::bluetooth::flags::channel_sounding_in_stack() &&
@@ -95,8 +120,9 @@ struct Controller::impl {
           MaskLeEventMask(local_version_information_.hci_version_, kDefaultLeEventMask));
     }
 
-    hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
+    enqueue_capability_read(
+        ReadBufferSizeBuilder::Create(),
+        handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
 
     if (common::init_flags::set_min_encryption_is_enabled() && is_supported(OpCode::SET_MIN_ENCRYPTION_KEY_SIZE)) {
       hci_->EnqueueCommand(
@@ -105,27 +131,27 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_BUFFER_SIZE_V2)) {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeReadBufferSizeV2Builder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_v2_handler));
     } else {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeReadBufferSizeV1Builder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_handler));
     }
 
     if (is_supported(OpCode::READ_LOCAL_SUPPORTED_CODECS_V1)) {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           ReadLocalSupportedCodecsV1Builder::Create(),
           handler->BindOnceOn(this, &Controller::impl::read_local_supported_codecs_v1_handler));
     }
 
-    hci_->EnqueueCommand(
+    enqueue_capability_read(
         LeReadFilterAcceptListSizeBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::le_read_accept_list_size_handler));
 
     if (is_supported(OpCode::LE_READ_RESOLVING_LIST_SIZE) && module_.SupportsBlePrivacy()) {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeReadResolvingListSizeBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_resolving_list_size_handler));
     } else {
@@ -134,8 +160,9 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
-      hci_->EnqueueCommand(LeReadMaximumDataLengthBuilder::Create(),
-                           handler->BindOnceOn(this, &Controller::impl::le_read_maximum_data_length_handler));
+      enqueue_capability_read(
+          LeReadMaximumDataLengthBuilder::Create(),
+          handler->BindOnceOn(this, &Controller::impl::le_read_maximum_data_length_handler));
     } else {
       log::info("LE_READ_MAXIMUM_DATA_LENGTH not supported, defaulting to 0");
       le_maximum_data_length_.supported_max_rx_octets_ = 0;
@@ -162,7 +189,7 @@ struct Controller::impl {
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH) && module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeReadMaximumAdvertisingDataLengthBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_maximum_advertising_data_length_handler));
     } else {
@@ -172,7 +199,7 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS) &&
         module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeReadNumberOfSupportedAdvertisingSetsBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_number_of_supported_advertising_sets_handler));
     } else {
@@ -182,7 +209,7 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_PERIODIC_ADVERTISER_LIST_SIZE) &&
         module_.SupportsBlePeriodicAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeReadPeriodicAdvertiserListSizeBuilder::Create(),
           handler->BindOnceOn(this, &Controller::impl::le_read_periodic_advertiser_list_size_handler));
     } else {
@@ -224,7 +251,7 @@ struct Controller::impl {
       // More commands can be enqueued from le_get_vendor_capabilities_handler
       std::promise<void> vendor_promise;
       auto vendor_future = vendor_promise.get_future();
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           LeGetVendorCapabilitiesBuilder::Create(),
           handler->BindOnceOn(
               this,
@@ -242,6 +269,87 @@ struct Controller::impl {
         ReadBdAddrBuilder::Create(),
         handler->BindOnceOn(this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
     future.wait();
+
+    if (capability_cache_ != nullptr) {
+      // The completions of the reads sent to the controller are posted again once recorded, wait for them
+      std::promise<void> recorded_promise;
+      auto recorded_future = recorded_promise.get_future();
+      handler->Post(common::BindOnce(
+          [](std::promise<void> promise) { promise.set_value(); }, std::move(recorded_promise)));
+      recorded_future.wait();
+
+      log::info(
+          "Controller capabilities: {} read from the cache, {} from the controller",
+          capability_cache_->GetHitCount(),
+          capability_cache_->GetMissCount());
+      capability_cache_->Save();
+      capability_cache_.reset();
+    }
+  }
+
+  // Read the address of the controller, which with its version identifies the capabilities saved by a previous start
+  void load_capability_cache() {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    hci_->EnqueueCommand(
+        ReadBdAddrBuilder::Create(),
+        module_.GetHandler()->BindOnceOn(
+            this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
+    future.wait();
+
+    std::string path = os::ParameterProvider::ConfigFilePath();
+    path = path.substr(0, path.find_last_of('/') + 1) + kCapabilityCacheFileName;
+    capability_cache_ = std::make_unique<ControllerCapabilityCache>(path);
+    std::string key = fmt::format(
+        "{} {:04x} {:02x} {:04x} {:02x} {:04x}",
+        mac_address_.ToString(),
+        local_version_information_.manufacturer_name_,
+        static_cast<uint8_t>(local_version_information_.lmp_version_),
+        local_version_information_.lmp_subversion_,
+        static_cast<uint8_t>(local_version_information_.hci_version_),
+        local_version_information_.hci_revision_);
+    if (capability_cache_->Load(key)) {
+      log::info("Reading the controller capabilities from {}", path);
+    }
+  }
+
+  // Send a command reading a capability of the controller, or answer it with the Command Complete saved for the
+  // same controller firmware. Commands changing the state of the controller must not be sent this way.
+  void enqueue_capability_read(
+      std::unique_ptr<CommandBuilder> command, common::ContextualOnceCallback<void(CommandCompleteView)> on_complete) {
+    if (capability_cache_ == nullptr) {
+      hci_->EnqueueCommand(std::move(command), std::move(on_complete));
+      return;
+    }
+
+    std::vector<uint8_t> command_bytes;
+    command_bytes.reserve(command->size());
+    packet::BitInserter inserter(command_bytes);
+    command->Serialize(inserter);
+
+    if (auto event_bytes = capability_cache_->Find(command_bytes)) {
+      auto event = EventView::Create(
+          packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::move(*event_bytes))));
+      auto view = CommandCompleteView::Create(event);
+      if (view.IsValid()) {
+        on_complete(std::move(view));
+        return;
+      }
+    }
+    hci_->EnqueueCommand(
+        std::move(command),
+        module_.GetHandler()->BindOnceOn(
+            this, &Controller::impl::capability_read_complete, std::move(command_bytes), std::move(on_complete)));
+  }
+
+  void capability_read_complete(
+      std::vector<uint8_t> command,
+      common::ContextualOnceCallback<void(CommandCompleteView)> on_complete,
+      CommandCompleteView view) {
+    std::vector<uint8_t> event(view.size());
+    view.CopyTo(event.data());
+    capability_cache_->Record(std::move(command), std::move(event));
+    on_complete(std::move(view));
   }
 
   void Stop() {
@@ -327,6 +435,21 @@ struct Controller::impl {
         local_version_information_.lmp_subversion_,
         static_cast<uint8_t>(local_version_information_.hci_version_),
         local_version_information_.hci_revision_);
+
+    uint32_t max_outstanding_commands =
+        os::GetSystemPropertyUint32(kPropertyMaxOutstandingCommands, 1);
+    if (max_outstanding_commands > 1) {
+      if (std::find(
+              std::begin(kCommandPipeliningAllowlist),
+              std::end(kCommandPipeliningAllowlist),
+              local_version_information_.manufacturer_name_) != std::end(kCommandPipeliningAllowlist)) {
+        hci_->SetMaxOutstandingCommands(std::min<uint32_t>(max_outstanding_commands, UINT8_MAX));
+      } else {
+        log::info(
+            "Command pipelining not allowed for manufacturer 0x{:04x}",
+            local_version_information_.manufacturer_name_);
+      }
+    }
   }
 
   void read_local_supported_commands_complete_handler(CommandCompleteView view) {
@@ -357,7 +480,7 @@ struct Controller::impl {
     // Query all extended features
     if (page_number < complete_view.GetMaximumPageNumber()) {
       page_number++;
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           ReadLocalExtendedFeaturesBuilder::Create(page_number),
           module_.GetHandler()->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
                                            std::move(promise)));
@@ -678,7 +801,7 @@ struct Controller::impl {
       }
 
       if (vendor_capabilities_.dynamic_audio_buffer_support_) {
-        hci_->EnqueueCommand(
+        enqueue_capability_read(
             DabGetAudioBufferTimeCapabilityBuilder::Create(),
             module_.GetHandler()->BindOnceOn(
                 this,
@@ -693,7 +816,7 @@ struct Controller::impl {
         vendor_promise.set_value();
         return;
       }
-      hci_->EnqueueCommand(
+      enqueue_capability_read(
           DabGetAudioBufferTimeCapabilityBuilder::Create(),
           module_.GetHandler()->BindOnceOn(
               this,
@@ -1221,6 +1344,9 @@ struct Controller::impl {
 
   HciLayer* hci_;
 
+  // Capabilities saved by a previous start, only while starting
+  std::unique_ptr<ControllerCapabilityCache> capability_cache_;
+
   CompletedAclPacketsCallback acl_credits_callback_{};
   CompletedAclPacketsCallback acl_monitor_credits_callback_{};
   LocalVersionInformation local_version_information_{};
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/controller_capability_cache.h"
+
+#include <bluetooth/log.h>
+
+#include <sstream>
+
+#include "os/files.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+
+// The snapshot is saved as text: the key on the first line, then a line per command, with the command and its
+// Command Complete event in hexadecimal, separated by a space.
+
+std::string ToHex(const std::vector<uint8_t>& bytes) {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(2 * bytes.size());
+  for (uint8_t byte : bytes) {
+    hex.push_back(kDigits[byte >> 4]);
+    hex.push_back(kDigits[byte & 0xf]);
+  }
+  return hex;
+}
+
+std::optional<std::vector<uint8_t>> FromHex(const std::string& hex) {
+  if (hex.empty() || hex.size() % 2 != 0) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> bytes;
+  bytes.reserve(hex.size() / 2);
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    uint8_t byte = 0;
+    for (char c : {hex[i], hex[i + 1]}) {
+      if (c >= '0' && c <= '9') {
+        byte = (byte << 4) | (c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        byte = (byte << 4) | (c - 'a' + 10);
+      } else {
+        return std::nullopt;
+      }
+    }
+    bytes.push_back(byte);
+  }
+  return bytes;
+}
+
+}  // namespace
+
+ControllerCapabilityCache::ControllerCapabilityCache(std::string path) : path_(std::move(path)) {}
+
+bool ControllerCapabilityCache::Load(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  key_ = key;
+  events_.clear();
+  modified_ = false;
+
+  auto content = os::ReadSmallFile(path_);
+  if (!content.has_value()) {
+    return false;
+  }
+  std::istringstream stream(*content);
+  std::string line;
+  if (!std::getline(stream, line) || line != key) {
+    log::info("Controller capabilities saved for another controller or firmware, reading them again");
+    return false;
+  }
+
+  std::map<std::vector<uint8_t>, std::vector<uint8_t>> events;
+  while (std::getline(stream, line)) {
+    auto separator = line.find(' ');
+    auto command = FromHex(line.substr(0, separator));
+    auto event = separator == std::string::npos ? std::nullopt : FromHex(line.substr(separator + 1));
+    if (!command.has_value() || !event.has_value()) {
+      log::warn("Invalid controller capabilities file, reading them again");
+      return false;
+    }
+    events.insert_or_assign(std::move(*command), std::move(*event));
+  }
+  events_ = std::move(events);
+  return true;
+}
+
+std::optional<std::vector<uint8_t>> ControllerCapabilityCache::Find(const std::vector<uint8_t>& command) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = events_.find(command);
+  if (it == events_.end()) {
+    misses_++;
+    return std::nullopt;
+  }
+  hits_++;
+  return it->second;
+}
+
+void ControllerCapabilityCache::Record(std::vector<uint8_t> command, std::vector<uint8_t> event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.insert_or_assign(std::move(command), std::move(event));
+  modified_ = true;
+}
+
+bool ControllerCapabilityCache::Save() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!modified_) {
+    return true;
+  }
+  std::string content = key_ + "\n";
+  for (const auto& [command, event] : events_) {
+    content += ToHex(command) + " " + ToHex(event) + "\n";
+  }
+  if (!os::WriteToFile(path_, content)) {
+    log::warn("Unable to save the controller capabilities to {}", path_);
+    return false;
+  }
+  modified_ = false;
+  return true;
+}
+
+size_t ControllerCapabilityCache::GetHitCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+size_t ControllerCapabilityCache::GetMissCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+}  // namespace hci
+}  // namespace bluetooth
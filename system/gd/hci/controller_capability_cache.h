@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+
+/// Snapshot of the Command Complete events answering the commands that read the capabilities of the controller,
+/// saved to a file so that they are not read again when the same controller, running the same firmware, is started.
+///
+/// The snapshot is identified by a key naming the controller and its firmware, which the caller reads from the
+/// controller on each start. A snapshot saved with another key is discarded.
+class ControllerCapabilityCache {
+ public:
+  explicit ControllerCapabilityCache(std::string path);
+
+  /// Load the snapshot saved for `key`, and return whether one was found
+  bool Load(const std::string& key);
+
+  /// Return the Command Complete event saved for the serialized `command`, or nullopt if the command is not in the
+  /// snapshot and must be sent to the controller
+  std::optional<std::vector<uint8_t>> Find(const std::vector<uint8_t>& command);
+
+  /// Add the Command Complete `event` received for the serialized `command` to the snapshot
+  void Record(std::vector<uint8_t> command, std::vector<uint8_t> event);
+
+  /// Save the snapshot if commands were recorded since it was loaded, and return false if it could not be written
+  bool Save();
+
+  size_t GetHitCount() const;
+  size_t GetMissCount() const;
+
+ private:
+  const std::string path_;
+  mutable std::mutex mutex_;
+  std::string key_;
+  std::map<std::vector<uint8_t>, std::vector<uint8_t>> events_;
+  bool modified_ = false;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/controller_capability_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+const std::vector<uint8_t> kCommand1 = {0x02, 0x10, 0x00};
+const std::vector<uint8_t> kEvent1 = {0x0e, 0x04, 0x01, 0x02, 0x10, 0x00};
+const std::vector<uint8_t> kCommand2 = {0x04, 0x10, 0x01, 0x01};
+const std::vector<uint8_t> kEvent2 = {0x0e, 0x05, 0x01, 0x04, 0x10, 0x00, 0xff};
+
+constexpr char kKey[] = "00:11:22:33:44:55 1d 0c 1234 0c 5678";
+
+class ControllerCapabilityCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const auto* test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    path_ = std::filesystem::temp_directory_path() / (std::string(test_info->name()) + "_controller.conf");
+    std::filesystem::remove(path_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+  }
+
+  std::filesystem::path path_;
+};
+
+TEST_F(ControllerCapabilityCacheTest, nothing_cached_without_file) {
+  ControllerCapabilityCache cache(path_.string());
+  ASSERT_FALSE(cache.Load(kKey));
+  ASSERT_FALSE(cache.Find(kCommand1).has_value());
+  ASSERT_EQ(1u, cache.GetMissCount());
+}
+
+TEST_F(ControllerCapabilityCacheTest, recorded_events_saved_and_loaded) {
+  {
+    ControllerCapabilityCache cache(path_.string());
+    cache.Load(kKey);
+    cache.Record(kCommand1, kEvent1);
+    cache.Record(kCommand2, kEvent2);
+    ASSERT_TRUE(cache.Save());
+  }
+
+  ControllerCapabilityCache cache(path_.string());
+  ASSERT_TRUE(cache.Load(kKey));
+  ASSERT_EQ(kEvent1, cache.Find(kCommand1));
+  ASSERT_EQ(kEvent2, cache.Find(kCommand2));
+  ASSERT_EQ(2u, cache.GetHitCount());
+  ASSERT_EQ(0u, cache.GetMissCount());
+}
+
+TEST_F(ControllerCapabilityCacheTest, snapshot_of_other_firmware_discarded) {
+  {
+    ControllerCapabilityCache cache(path_.string());
+    cache.Load(kKey);
+    cache.Record(kCommand1, kEvent1);
+    ASSERT_TRUE(cache.Save());
+  }
+
+  ControllerCapabilityCache cache(path_.string());
+  ASSERT_FALSE(cache.Load("00:11:22:33:44:55 1d 0c 1235 0c 5678"));
+  ASSERT_FALSE(cache.Find(kCommand1).has_value());
+}
+
+TEST_F(ControllerCapabilityCacheTest, invalid_file_discarded) {
+  ASSERT_TRUE(os::WriteToFile(path_.string(), std::string(kKey) + "\n021000 0e04zz\n"));
+
+  ControllerCapabilityCache cache(path_.string());
+  ASSERT_FALSE(cache.Load(kKey));
+  ASSERT_FALSE(cache.Find(kCommand1).has_value());
+}
+
+TEST_F(ControllerCapabilityCacheTest, unchanged_snapshot_not_saved) {
+  ControllerCapabilityCache cache(path_.string());
+  cache.Load(kKey);
+  ASSERT_TRUE(cache.Save());
+  ASSERT_FALSE(std::filesystem::exists(path_));
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -22,7 +22,9 @@
 #include <unistd.h>
 
 #include <chrono>
+#include <filesystem>
 #include <future>
+#include <map>
 #include <memory>
 #include <sstream>
 
@@ -31,6 +33,8 @@
 #include "hci/address.h"
 #include "hci/hci_layer_fake.h"
 #include "module_dumper.h"
+#include "os/parameter_provider.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -88,6 +92,7 @@ class HciLayerFakeForController : public HciLayerFake {
     auto packet_view = packet::PacketView<packet::kLittleEndian>(bytes);
     CommandView command = CommandView::Create(packet_view);
     ASSERT_TRUE(command.IsValid());
+    command_count_[command.GetOpCode()]++;
 
     uint8_t num_packets = 1;
     std::unique_ptr<packet::BasePacketBuilder> event_builder;
@@ -270,7 +275,12 @@ class HciLayerFakeForController : public HciLayerFake {
     IncomingEvent(NumberOfCompletedPacketsBuilder::Create(completed_packets));
   }
 
+  int GetCommandCount(OpCode op_code) {
+    return command_count_[op_code];
+  }
+
   std::unique_ptr<EventBuilder> vendor_capabilities_ = nullptr;
+  std::map<OpCode, int> command_count_;
   constexpr static uint16_t acl_data_packet_length = 1024;
   constexpr static uint8_t synchronous_data_packet_length = 60;
   constexpr static uint16_t total_num_acl_data_packets = 10;
@@ -643,6 +653,62 @@ TEST_F(ControllerTest, leRandTest) {
   ASSERT_EQ(kRandomNumber, le_rand_set_future.get());
 }
 
+class ControllerCapabilityCacheTest : public ControllerTest {
+ protected:
+  void SetUp() override {
+    auto temp_dir = std::filesystem::temp_directory_path();
+    cache_path_ = temp_dir / "bt_controller_capabilities.conf";
+    std::filesystem::remove(cache_path_);
+    os::ParameterProvider::OverrideConfigFilePath((temp_dir / "bt_config.conf").string());
+    os::SetSystemProperty("bluetooth.core.controller_capability_cache.enabled", "true");
+    ControllerTest::SetUp();
+  }
+
+  void TearDown() override {
+    ControllerTest::TearDown();
+    os::ClearSystemPropertiesForHost();
+    os::ParameterProvider::OverrideConfigFilePath("");
+    std::filesystem::remove(cache_path_);
+  }
+
+  void Restart() {
+    fake_registry_.StopAll();
+    test_hci_layer_ = new HciLayerFakeForController;
+    fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
+    client_handler_ = fake_registry_.GetTestModuleHandler(&HciLayer::Factory);
+    fake_registry_.Start<Controller>(&thread_);
+    controller_ = static_cast<Controller*>(fake_registry_.GetModuleUnderTest(&Controller::Factory));
+  }
+
+  std::filesystem::path cache_path_;
+};
+
+TEST_F(ControllerCapabilityCacheTest, capabilities_read_from_cache_on_restart) {
+  ASSERT_TRUE(std::filesystem::exists(cache_path_));
+  ASSERT_EQ(1, test_hci_layer_->GetCommandCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS));
+  ASSERT_EQ(3, test_hci_layer_->GetCommandCount(OpCode::READ_LOCAL_EXTENDED_FEATURES));
+  uint64_t local_features = controller_->GetLocalFeatures(2);
+
+  Restart();
+
+  // The capabilities are answered from the cache
+  ASSERT_EQ(0, test_hci_layer_->GetCommandCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS));
+  ASSERT_EQ(0, test_hci_layer_->GetCommandCount(OpCode::READ_LOCAL_EXTENDED_FEATURES));
+  ASSERT_EQ(0, test_hci_layer_->GetCommandCount(OpCode::READ_BUFFER_SIZE));
+  ASSERT_EQ(0, test_hci_layer_->GetCommandCount(OpCode::LE_GET_VENDOR_CAPABILITIES));
+  ASSERT_EQ(local_features, controller_->GetLocalFeatures(2));
+  ASSERT_EQ(controller_->GetAclPacketLength(), test_hci_layer_->acl_data_packet_length);
+  ASSERT_EQ(controller_->GetLeSupportedStates(), 0x001f123456789abeUL);
+  ASSERT_EQ(controller_->GetLeMaximumAdvertisingDataLength(), 0x0672);
+  ASSERT_TRUE(controller_->IsSupported(OpCode::LE_READ_BUFFER_SIZE_V1));
+
+  // The identity of the controller and the commands configuring it are still sent
+  ASSERT_EQ(1, test_hci_layer_->GetCommandCount(OpCode::READ_LOCAL_VERSION_INFORMATION));
+  ASSERT_EQ(1, test_hci_layer_->GetCommandCount(OpCode::READ_LOCAL_NAME));
+  ASSERT_EQ(1, test_hci_layer_->GetCommandCount(OpCode::SET_EVENT_MASK));
+  ASSERT_EQ(1, test_hci_layer_->GetCommandCount(OpCode::LE_SET_EVENT_MASK));
+}
+
 TEST_F(ControllerTest, Dumpsys) {
   ModuleDumper dumper(STDOUT_FILENO, fake_registry_, title);
 
@@ -19,6 +19,8 @@
 #include <com_android_bluetooth_flags.h>
 #include <math.h>
 
+#include <algorithm>
+#include <chrono>
 #include <complex>
 #include <unordered_map>
 
@@ -29,7 +31,9 @@
 #include "hci/distance_measurement_interface.h"
 #include "hci/event_checkers.h"
 #include "hci/hci_layer.h"
+#include "hci/link_quality_scheduler.h"
 #include "module.h"
+#include "os/alarm.h"
 #include "os/handler.h"
 #include "os/log.h"
 #include "os/repeating_alarm.h"
@@ -102,6 +106,17 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       }
       ranging_header_.pct_format_ = PctFormat::IQ;
     }
+    // Reserve the step data for |num_tone_steps| mode-2 steps, so the procedure
+    // does not grow its buffers step by step
+    void ReserveToneSteps(size_t num_tone_steps) {
+      step_channel.reserve(num_tone_steps);
+      for (uint8_t i = 0; i < tone_pct_initiator.size(); i++) {
+        tone_pct_initiator[i].reserve(num_tone_steps);
+        tone_pct_reflector[i].reserve(num_tone_steps);
+        tone_quality_indicator_initiator[i].reserve(num_tone_steps);
+        tone_quality_indicator_reflector[i].reserve(num_tone_steps);
+      }
+    }
     // Procedure counter
     uint16_t counter;
     // Number of antenna paths (1 to 4) reported in the procedure
@@ -208,6 +223,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     ranging_hal_ = ranging_hal;
     hci_layer_ = hci_layer;
     acl_manager_ = acl_manager;
+    rssi_alarm_ = std::make_unique<os::Alarm>(handler_);
     hci_layer_->RegisterLeEventHandler(
         hci::SubeventCode::TRANSMIT_POWER_REPORTING,
         handler_->BindOn(this, &impl::on_transmit_power_reporting));
@@ -227,6 +243,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
 
   void stop() {
     hci_layer_->UnregisterLeEventHandler(hci::SubeventCode::TRANSMIT_POWER_REPORTING);
+    rssi_alarm_.reset();
   }
 
   void register_distance_measurement_callbacks(DistanceMeasurementCallbacks* callbacks) {
@@ -258,7 +275,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
           rssi_trackers[address].interval_ms = interval;
           rssi_trackers[address].remote_tx_power = kTxPowerNotAvailable;
           rssi_trackers[address].started = false;
-          rssi_trackers[address].repeating_alarm = std::make_unique<os::RepeatingAlarm>(handler_);
           hci_layer_->EnqueueCommand(
               LeReadRemoteTransmitPowerLevelBuilder::Create(
                   acl_manager_->HACK_GetLeHandle(address), 0x01),
@@ -266,6 +282,13 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
                   this, &impl::on_read_remote_transmit_power_level_status, address));
         } else {
           rssi_trackers[address].interval_ms = interval;
+          if (rssi_trackers[address].started) {
+            rssi_scheduler_.AddLink(
+                rssi_trackers[address].handle,
+                std::chrono::milliseconds(interval),
+                LinkQualityScheduler::Clock::now());
+            schedule_rssi_alarm();
+          }
         }
       } break;
       case METHOD_CS: {
@@ -340,8 +363,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
               LeSetTransmitPowerReportingEnableBuilder::Create(
                   rssi_trackers[address].handle, 0x00, 0x00),
               handler_->BindOnce(check_complete<LeSetTransmitPowerReportingEnableCompleteView>));
-          rssi_trackers[address].repeating_alarm->Cancel();
-          rssi_trackers[address].repeating_alarm.reset();
+          rssi_scheduler_.RemoveLink(rssi_trackers[address].handle);
+          schedule_rssi_alarm();
           rssi_trackers.erase(address);
         }
       } break;
@@ -433,8 +456,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       if (rssi_trackers.find(address) != rssi_trackers.end()) {
         distance_measurement_callbacks_->OnDistanceMeasurementStopped(
             address, REASON_NO_LE_CONNECTION, METHOD_RSSI);
-        rssi_trackers[address].repeating_alarm->Cancel();
-        rssi_trackers[address].repeating_alarm.reset();
+        rssi_scheduler_.RemoveLink(rssi_trackers[address].handle);
+        schedule_rssi_alarm();
         rssi_trackers.erase(address);
       }
       return;
@@ -445,6 +468,37 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         handler_->BindOnceOn(this, &impl::on_read_rssi_complete, address));
   }
 
+  // Reads the RSSI of all the links due, the tracked links share one alarm
+  void on_rssi_alarm() {
+    for (uint16_t handle : rssi_scheduler_.TakeDueLinks(LinkQualityScheduler::Clock::now())) {
+      auto tracker =
+          std::find_if(rssi_trackers.begin(), rssi_trackers.end(), [handle](const auto& it) {
+            return it.second.handle == handle && it.second.started;
+          });
+      if (tracker == rssi_trackers.end()) {
+        rssi_scheduler_.RemoveLink(handle);
+        continue;
+      }
+      send_read_rssi(tracker->first);
+    }
+    schedule_rssi_alarm();
+  }
+
+  void schedule_rssi_alarm() {
+    if (rssi_alarm_ == nullptr) {
+      return;
+    }
+    rssi_alarm_->Cancel();
+    if (rssi_scheduler_.IsEmpty()) {
+      return;
+    }
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        rssi_scheduler_.NextDeadline() - LinkQualityScheduler::Clock::now());
+    rssi_alarm_->Schedule(
+        common::BindOnce(&impl::on_rssi_alarm, common::Unretained(this)),
+        std::max(delay, std::chrono::milliseconds(0)));
+  }
+
   void handle_event(LeMetaEventView event) {
     if (!event.IsValid()) {
       log::error("Received invalid LeMetaEventView");
@@ -991,6 +1045,11 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     CsRole role = cs_trackers_[connection_handle].role == CsRole::INITIATOR ? CsRole::REFLECTOR
                                                                             : CsRole::INITIATOR;
 
+    // Mode-2 step data is parsed with the number of tone data in front
+    uint8_t num_tone_data = num_antenna_paths + 1;
+    PacketView<kLittleEndian> packet_view_for_num_tone_data(
+        std::make_shared<std::vector<uint8_t>>(1, num_tone_data));
+
     auto parse_index = segment_data.begin();
     uint16_t remaining_data_size = std::distance(parse_index, segment_data.end());
 
@@ -1043,7 +1102,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
             parse_index = after;
           } break;
           case 2: {
-            uint8_t num_tone_data = num_antenna_paths + 1;
             uint8_t data_len = 1 + (4 * num_tone_data);
             remaining_data_size = std::distance(parse_index, segment_data.end());
             if (remaining_data_size < data_len) {
@@ -1053,9 +1111,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
                   remaining_data_size);
               return;
             }
-            std::vector<uint8_t> vector_for_num_tone_data = {num_tone_data};
-            PacketView<kLittleEndian> packet_view_for_num_tone_data(
-                std::make_shared<std::vector<uint8_t>>(vector_for_num_tone_data));
             PacketViewForRecombination packet_bytes_view =
                 PacketViewForRecombination(packet_view_for_num_tone_data);
             auto subview_begin = std::distance(segment_data.begin(), parse_index);
@@ -1129,6 +1184,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
         num_antenna_paths,
         cs_trackers_[connection_handle].config_id,
         cs_trackers_[connection_handle].selected_tx_power);
+    data_list.back().ReserveToneSteps(cs_trackers_[connection_handle].last_num_tone_steps);
 
     // Append ranging header raw data
     std::vector<uint8_t> ranging_header_raw = {};
@@ -1195,6 +1251,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
           (uint16_t)procedure_data->step_channel.size(),
           (uint16_t)cs_trackers_[connection_handle].main_mode_type,
           (uint16_t)cs_trackers_[connection_handle].sub_mode_type);
+      cs_trackers_[connection_handle].last_num_tone_steps =
+          procedure_data->tone_pct_initiator[0].size();
 
       if (ranging_hal_->IsBound()) {
         // Use algorithm in the HAL
@@ -1225,12 +1283,14 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   }
 
   void parse_cs_result_data(
-      std::vector<LeCsResultDataStructure> result_data_structures,
+      const std::vector<LeCsResultDataStructure>& result_data_structures,
       CsProcedureData& procedure_data,
       CsRole role) {
     uint8_t num_antenna_paths = procedure_data.num_antenna_paths;
     auto& ras_data = procedure_data.ras_subevent_data_;
-    for (auto result_data_structure : result_data_structures) {
+    // Step data to parse, reused by all the steps of the subevent
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    for (const auto& result_data_structure : result_data_structures) {
       uint16_t mode = result_data_structure.step_mode_;
       uint16_t step_channel = result_data_structure.step_channel_;
       uint16_t data_length = result_data_structure.step_data_.size();
@@ -1247,7 +1307,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       append_vector(ras_data, result_data_structure.step_data_);
 
       // Parse data into structs from an iterator
-      auto bytes = std::make_shared<std::vector<uint8_t>>();
+      bytes->clear();
       if (mode == 0x02 || mode == 0x03) {
         // Add one byte for the length of Tone_PCT[k], Tone_Quality_Indicator[k]
         bytes->emplace_back(num_antenna_paths + 1);
@@ -1293,7 +1353,7 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
           if (role == CsRole::INITIATOR) {
             procedure_data.step_channel.push_back(step_channel);
           }
-          auto tone_data = tone_data_view.tone_data_;
+          const auto& tone_data = tone_data_view.tone_data_;
           uint8_t permutation_index = tone_data_view.antenna_permutation_index_;
           // Parse in ascending order of antenna position with tone extension data at the end
           uint16_t num_tone_data = num_antenna_paths + 1;
@@ -1454,9 +1514,11 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
       log::info("Track rssi for address {}", address);
       rssi_trackers[address].started = true;
       distance_measurement_callbacks_->OnDistanceMeasurementStarted(address, METHOD_RSSI);
-      rssi_trackers[address].repeating_alarm->Schedule(
-          common::Bind(&impl::send_read_rssi, common::Unretained(this), address),
-          std::chrono::milliseconds(rssi_trackers[address].interval_ms));
+      rssi_scheduler_.AddLink(
+          rssi_trackers[address].handle,
+          std::chrono::milliseconds(rssi_trackers[address].interval_ms),
+          LinkQualityScheduler::Clock::now());
+      schedule_rssi_alarm();
     }
   }
 
@@ -1493,7 +1555,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   }
 
   void append_vector(std::vector<uint8_t>& v1, const std::vector<uint8_t>& v2) {
-    v1.reserve(v2.size());
     v1.insert(v1.end(), v2.begin(), v2.end());
   }
 
@@ -1502,7 +1563,6 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     uint16_t interval_ms;
     uint8_t remote_tx_power;
     bool started;
-    std::unique_ptr<os::RepeatingAlarm> repeating_alarm;
   };
 
   struct CsTracker {
@@ -1520,6 +1580,8 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
     uint8_t config_id = 0;
     uint8_t selected_tx_power = 0;
     std::vector<CsProcedureData> procedure_data_list;
+    // Number of mode-2 steps of the last complete procedure
+    size_t last_num_tone_steps = 0;
     uint16_t interval_ms;
     bool waiting_for_start_callback = false;
     std::unique_ptr<os::RepeatingAlarm> repeating_alarm;
@@ -1534,6 +1596,9 @@ struct DistanceMeasurementManager::impl : bluetooth::hal::RangingHalCallback {
   hci::AclManager* acl_manager_;
   hci::DistanceMeasurementInterface* distance_measurement_interface_;
   std::unordered_map<Address, RSSITracker> rssi_trackers;
+  // The RSSI of the started trackers is read from one alarm
+  LinkQualityScheduler rssi_scheduler_;
+  std::unique_ptr<os::Alarm> rssi_alarm_;
   std::unordered_map<uint16_t, CsTracker> cs_trackers_;
   DistanceMeasurementCallbacks* distance_measurement_callbacks_;
   CsOptionalSubfeaturesSupported cs_subfeature_supported_;
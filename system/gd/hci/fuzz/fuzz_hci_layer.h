@@ -72,6 +72,8 @@ class FuzzHciLayer : public HciLayer {
     }
   }
 
+  void SetMaxOutstandingCommands(uint8_t /* max_outstanding_commands */) override {}
+
   common::BidiQueueEnd<hci::AclBuilder, hci::AclView>* GetAclQueueEnd() override {
     return acl_queue_.GetUpEnd();
   }
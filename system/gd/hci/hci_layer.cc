@@ -21,18 +21,23 @@
 #endif
 #include <bluetooth/log.h>
 
+#include <algorithm>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "common/stop_watch.h"
+#include "dumpsys_data_generated.h"
 #include "hal/hci_hal.h"
 #include "hci/class_of_device.h"
 #include "hci/hci_metrics_logging.h"
+#include "hci_layer_generated.h"
 #include "os/alarm.h"
 #include "os/metrics.h"
 #include "os/queue.h"
+#include "os/trace.h"
 #include "osi/include/stack_power_telemetry.h"
 #include "packet/raw_builder.h"
 #include "storage/storage_module.h"
@@ -88,6 +93,7 @@ class CommandQueueEntry {
 
   unique_ptr<CommandBuilder> command;
   unique_ptr<CommandView> command_view;
+  std::chrono::steady_clock::time_point sent_time;
 
   bool waiting_for_status_;
   ContextualOnceCallback<void(CommandStatusView)> on_status;
@@ -112,6 +118,7 @@ class CommandQueueEntry {
 struct HciLayer::impl {
   impl(hal::HciHal* hal, HciLayer& module) : hal_(hal), module_(module) {
     hci_timeout_alarm_ = new Alarm(module.GetHandler());
+    startup_commands_.reserve(kMaxStartupCommands);
   }
 
   ~impl() {
@@ -133,26 +140,20 @@ struct HciLayer::impl {
 
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendAclData(bytes);
+    packet->SerializeTo(outgoing_acl_bytes_);
+    hal_->sendAclData(outgoing_acl_bytes_);
   }
 
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendScoData(bytes);
+    packet->SerializeTo(outgoing_sco_bytes_);
+    hal_->sendScoData(outgoing_sco_bytes_);
   }
 
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendIsoData(bytes);
+    packet->SerializeTo(outgoing_iso_bytes_);
+    hal_->sendIsoData(outgoing_iso_bytes_);
   }
 
   template <typename TResponse>
@@ -196,20 +197,30 @@ struct HciLayer::impl {
         "Unexpected {} event with OpCode {}",
         logging_id,
         OpCodeText(op_code));
-    if (waiting_command_ == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
+    OpCode waiting_command = get_waiting_command();
+    if (waiting_command == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
       log::error("Discarding event that came after timeout {}", OpCodeText(op_code));
       common::StopWatch::DumpStopWatchLog();
       return;
     }
+    // Responses are matched by opcode with the outstanding commands, which
+    // never share the same opcode.
+    auto command = find_outstanding_command(op_code);
     log::assert_that(
-        waiting_command_ == op_code,
+        command != command_queue_.end(),
         "Waiting for {}, got {}",
-        OpCodeText(waiting_command_),
+        OpCodeText(waiting_command),
         OpCodeText(op_code));
+    if (BT_TRACE_ENABLED()) {
+      BT_TRACE_ASYNC_END(OpCodeText(op_code).c_str(), op_code);
+    }
+    if (startup_commands_.size() < kMaxStartupCommands) {
+      record_startup_command(op_code, command->sent_time);
+    }
 
     bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
     CommandStatusView status_view = CommandStatusView::Create(event);
-    if (is_vendor_specific && (is_status && !command_queue_.front().waiting_for_status_) &&
+    if (is_vendor_specific && (is_status && !command->waiting_for_status_) &&
         (status_view.IsValid() && status_view.GetStatus() == ErrorCode::UNKNOWN_HCI_COMMAND)) {
       // If this is a command status of a vendor specific command, and command complete is expected,
       // we can't treat this as hard failure since we have no way of probing this lack of support at
@@ -228,15 +239,15 @@ struct HciLayer::impl {
           CommandCompleteView::Create(EventView::Create(PacketView<kLittleEndian>(complete)));
       log::assert_that(
           command_complete_view.IsValid(), "assert failed: command_complete_view.IsValid()");
-      (*command_queue_.front().GetCallback<CommandCompleteView>())(command_complete_view);
+      (*command->GetCallback<CommandCompleteView>())(command_complete_view);
     } else {
-      if (command_queue_.front().waiting_for_status_ == is_status) {
-        (*command_queue_.front().GetCallback<TResponse>())(std::move(response_view));
+      if (command->waiting_for_status_ == is_status) {
+        (*command->GetCallback<TResponse>())(std::move(response_view));
       } else {
         CommandCompleteView command_complete_view = CommandCompleteView::Create(
             EventView::Create(PacketView<kLittleEndian>(
                 std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-        (*command_queue_.front().GetCallback<CommandCompleteView>())(
+        (*command->GetCallback<CommandCompleteView>())(
             std::move(command_complete_view));
       }
     }
@@ -249,7 +260,7 @@ struct HciLayer::impl {
     // would return UNKNOWN_CONNECTION in some cases.
     if (op_code == OpCode::LE_READ_REMOTE_FEATURES && is_status && status_view.IsValid() &&
         status_view.GetStatus() == ErrorCode::UNKNOWN_CONNECTION) {
-      auto& command_view = *command_queue_.front().command_view;
+      auto& command_view = *command->command_view;
       auto le_read_features_view = bluetooth::hci::LeReadRemoteFeaturesView::Create(
           LeConnectionManagementCommandView::Create(AclCommandView::Create(command_view)));
       if (le_read_features_view.IsValid()) {
@@ -259,14 +270,54 @@ struct HciLayer::impl {
     }
 #endif
 
-    command_queue_.pop_front();
-    waiting_command_ = OpCode::NONE;
+    bool is_oldest_command = command == command_queue_.begin();
+    command_queue_.erase(command);
+    outstanding_commands_--;
     if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Cancel();
+      // The timeout follows the oldest outstanding command.
+      if (is_oldest_command) {
+        hci_timeout_alarm_->Cancel();
+        if (outstanding_commands_ > 0) {
+          schedule_hci_timeout(command_queue_.front().command_view->GetOpCode());
+        }
+      }
       send_next_command();
     }
   }
 
+  /// Opcode of the oldest outstanding command, OpCode::NONE if none.
+  OpCode get_waiting_command() const {
+    return outstanding_commands_ > 0 ? command_queue_.front().command_view->GetOpCode() : OpCode::NONE;
+  }
+
+  /// The outstanding commands are the first entries of the command queue.
+  std::list<CommandQueueEntry>::iterator find_outstanding_command(OpCode op_code) {
+    auto command = command_queue_.begin();
+    for (size_t i = 0; i < outstanding_commands_; i++, command++) {
+      if (command->command_view->GetOpCode() == op_code) {
+        return command;
+      }
+    }
+    return command_queue_.end();
+  }
+
+  /// Commands which have to be the only outstanding command: the reset
+  /// flushes the controller state, and the debug information is only
+  /// requested after a timeout.
+  static bool is_exclusive_command(OpCode op_code) {
+    return op_code == OpCode::RESET || op_code == OpCode::CONTROLLER_DEBUG_INFO;
+  }
+
+  void schedule_hci_timeout(OpCode op_code) {
+    hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
+  }
+
+  void set_max_outstanding_commands(uint8_t max_outstanding_commands) {
+    log::info("Allowing {} outstanding HCI commands", max_outstanding_commands);
+    max_outstanding_commands_ = std::max<uint8_t>(max_outstanding_commands, 1);
+    send_next_command();
+  }
+
   void on_hci_timeout(OpCode op_code) {
     common::StopWatch::DumpStopWatchLog();
     log::error("Timed out waiting for {}", OpCodeText(op_code));
@@ -277,7 +328,8 @@ struct HciLayer::impl {
     // Clear any waiting commands (there is an abort coming anyway)
     command_queue_.clear();
     command_credits_ = 1;
-    waiting_command_ = OpCode::NONE;
+    outstanding_commands_ = 0;
+    max_outstanding_commands_ = 1;
     // Ignore the response, since we don't know what might come back.
     enqueue_command(ControllerDebugInfoBuilder::Create(), module_.GetHandler()->BindOnce([](CommandCompleteView) {}));
     // Don't time out for this one;
@@ -294,35 +346,76 @@ struct HciLayer::impl {
     }
   }
 
+  /// Send the queued commands while the controller has command credits, up to
+  /// max_outstanding_commands_ commands waiting for their response.
   void send_next_command() {
-    if (command_credits_ == 0) {
-      return;
-    }
-    if (waiting_command_ != OpCode::NONE) {
-      return;
-    }
-    if (command_queue_.size() == 0) {
-      return;
+    while (command_credits_ > 0 && outstanding_commands_ < max_outstanding_commands_ &&
+           outstanding_commands_ < command_queue_.size()) {
+      if (outstanding_commands_ > 0 && is_exclusive_command(get_waiting_command())) {
+        return;
+      }
+
+      auto command = std::next(command_queue_.begin(), outstanding_commands_);
+      // The bytes are kept by the command view, they can't be reused for the next command.
+      std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
+      command->command->SerializeTo(*bytes);
+
+      auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
+      log::assert_that(cmd_view.IsValid(), "assert failed: cmd_view.IsValid()");
+      OpCode op_code = cmd_view.GetOpCode();
+      // Keep the commands in order when the response could not be matched
+      // to a single outstanding command.
+      if (outstanding_commands_ > 0 &&
+          (is_exclusive_command(op_code) || find_outstanding_command(op_code) != command_queue_.end())) {
+        return;
+      }
+
+      hal_->sendHciCommand(*bytes);
+      command->sent_time = std::chrono::steady_clock::now();
+      // One slice per outstanding command, which never share the same opcode
+      if (BT_TRACE_ENABLED()) {
+        BT_TRACE_ASYNC_BEGIN(OpCodeText(op_code).c_str(), op_code);
+      }
+      power_telemetry::GetInstance().LogHciCmdDetail();
+      command->command_view = std::make_unique<CommandView>(std::move(cmd_view));
+      log_link_layer_connection_command(command->command_view);
+      log_classic_pairing_command_status(command->command_view, ErrorCode::STATUS_UNKNOWN);
+      command_credits_--;
+      if (outstanding_commands_++ > 0) {
+        continue;
+      }
+      if (hci_timeout_alarm_ != nullptr) {
+        schedule_hci_timeout(op_code);
+      } else {
+        log::warn("{} sent without an hci-timeout timer", OpCodeText(op_code));
+      }
     }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
-    hal_->sendHciCommand(*bytes);
-
-    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
-    log::assert_that(cmd_view.IsValid(), "assert failed: cmd_view.IsValid()");
-    OpCode op_code = cmd_view.GetOpCode();
-    power_telemetry::GetInstance().LogHciCmdDetail();
-    command_queue_.front().command_view = std::make_unique<CommandView>(std::move(cmd_view));
-    log_link_layer_connection_command(command_queue_.front().command_view);
-    log_classic_pairing_command_status(command_queue_.front().command_view, ErrorCode::STATUS_UNKNOWN);
-    waiting_command_ = op_code;
-    command_credits_ = 0;  // Only allow one outstanding command
-    if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
-    } else {
-      log::warn("{} sent without an hci-timeout timer", OpCodeText(op_code));
+  }
+
+  void record_startup_command(OpCode op_code, std::chrono::steady_clock::time_point sent_time) {
+    auto round_trip = std::chrono::steady_clock::now() - sent_time;
+    startup_commands_.push_back(
+        {op_code,
+         std::chrono::duration_cast<std::chrono::microseconds>(sent_time - start_time_),
+         std::chrono::duration_cast<std::chrono::microseconds>(round_trip)});
+  }
+
+  flatbuffers::Offset<HciLayerData> dump(flatbuffers::FlatBufferBuilder* fb_builder) const {
+    auto title = fb_builder->CreateString("----- Hci Layer Dumpsys -----");
+    std::vector<flatbuffers::Offset<HciCommandTimeData>> startup_commands;
+    for (const auto& command : startup_commands_) {
+      startup_commands.push_back(CreateHciCommandTimeData(
+          *fb_builder,
+          fb_builder->CreateString(OpCodeText(command.op_code)),
+          command.sent_offset.count(),
+          command.round_trip.count()));
     }
+    auto startup_commands_offset = fb_builder->CreateVector(startup_commands);
+
+    HciLayerDataBuilder builder(*fb_builder);
+    builder.add_title(title);
+    builder.add_startup_commands(startup_commands_offset);
+    return builder.Finish();
   }
 
   void register_event(EventCode event, ContextualCallback<void(EventView)> handler) {
@@ -395,6 +488,7 @@ struct HciLayer::impl {
   }
 
   void on_hci_event(EventView event) {
+    BT_TRACE_SCOPE("HciLayer::on_hci_event");
     log::assert_that(event.IsValid(), "assert failed: event.IsValid()");
     if (command_queue_.empty()) {
       auto event_code = event.GetEventCode();
@@ -509,12 +603,27 @@ struct HciLayer::impl {
   // Command Handling
   std::list<CommandQueueEntry> command_queue_;
 
+  // Round trip time of the first commands sent after the start, to follow
+  // the controller initialization.
+  struct StartupCommand {
+    OpCode op_code;
+    std::chrono::microseconds sent_offset;
+    std::chrono::microseconds round_trip;
+  };
+  static constexpr size_t kMaxStartupCommands = 128;
+  std::chrono::steady_clock::time_point start_time_{std::chrono::steady_clock::now()};
+  std::vector<StartupCommand> startup_commands_;
+
   std::map<EventCode, ContextualCallback<void(EventView)>> event_handlers_;
   std::map<SubeventCode, ContextualCallback<void(LeMetaEventView)>> le_event_handlers_;
   std::map<VseSubeventCode, ContextualCallback<void(VendorSpecificEventView)>> vs_event_handlers_;
 
-  OpCode waiting_command_{OpCode::NONE};
   uint8_t command_credits_{1};  // Send reset first
+  // Number of commands sent to the controller and waiting for their response,
+  // at the front of command_queue_.
+  size_t outstanding_commands_{0};
+  // One outstanding command unless the controller is known to handle more.
+  uint8_t max_outstanding_commands_{1};
   Alarm* hci_timeout_alarm_{nullptr};
   Alarm* hci_abort_alarm_{nullptr};
 
@@ -529,6 +638,11 @@ struct HciLayer::impl {
   // ISO packets
   BidiQueue<IsoView, IsoBuilder> iso_queue_{3 /* TODO: Set queue depth */};
   os::EnqueueBuffer<IsoView> incoming_iso_buffer_{iso_queue_.GetDownEnd()};
+
+  // Serialization buffers reused for every outgoing data packet.
+  std::vector<uint8_t> outgoing_acl_bytes_;
+  std::vector<uint8_t> outgoing_sco_bytes_;
+  std::vector<uint8_t> outgoing_iso_bytes_;
 };
 
 // All functions here are running on the HAL thread
@@ -536,7 +650,8 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   hal_callbacks(HciLayer& module) : module_(module) {}
 
   void hciEventReceived(hal::HciPacket event_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(event_bytes));
+    auto packet = packet::PacketView<packet::kLittleEndian>(
+        std::make_shared<std::vector<uint8_t>>(std::move(event_bytes)));
     EventView event = EventView::Create(packet);
     module_.CallOn(module_.impl_, &impl::on_hci_event, std::move(event));
   }
@@ -596,6 +711,10 @@ void HciLayer::EnqueueCommand(
       impl_, &impl::enqueue_command<CommandStatusView>, std::move(command), std::move(on_status));
 }
 
+void HciLayer::SetMaxOutstandingCommands(uint8_t max_outstanding_commands) {
+  CallOn(impl_, &impl::set_max_outstanding_commands, max_outstanding_commands);
+}
+
 void HciLayer::RegisterEventHandler(EventCode event, ContextualCallback<void(EventView)> handler) {
   CallOn(impl_, &impl::register_event, event, handler);
 }
@@ -839,6 +958,16 @@ void HciLayer::StartWithNoHalDependencies(Handler* handler) {
       EventCode::CONNECTION_REQUEST, handler->BindOn(this, &HciLayer::on_connection_request));
 }
 
+DumpsysDataFinisher HciLayer::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  if (impl_ == nullptr) {
+    return EmptyDumpsysDataFinisher;
+  }
+  auto dumpsys_data = impl_->dump(fb_builder);
+  return [dumpsys_data](DumpsysDataBuilder* dumpsys_builder) {
+    dumpsys_builder->add_hci_layer_dumpsys_data(dumpsys_data);
+  };
+}
+
 void HciLayer::Stop() {
   auto hal = GetDependency<hal::HciHal>();
   hal->unregisterIncomingPacketCallback();
@@ -58,6 +58,11 @@ class HciLayer : public Module, public HciInterface {
       std::unique_ptr<CommandBuilder> command,
       common::ContextualOnceCallback<void(CommandStatusView)> on_status) override;
 
+  /// Allow more than one command to wait for its response, for the
+  /// controllers known to handle several outstanding commands. The commands
+  /// are still limited by the controller command credits.
+  virtual void SetMaxOutstandingCommands(uint8_t max_outstanding_commands);
+
   virtual common::BidiQueueEnd<AclBuilder, AclView>* GetAclQueueEnd();
 
   virtual common::BidiQueueEnd<ScoBuilder, ScoView>* GetScoQueueEnd();
@@ -133,6 +138,8 @@ class HciLayer : public Module, public HciInterface {
 
   void Stop() override;
 
+  DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const override;
+
   virtual void Disconnect(uint16_t handle, ErrorCode reason);
   virtual void ReadRemoteVersion(
       hci::ErrorCode hci_status,
@@ -148,7 +155,7 @@ class HciLayer : public Module, public HciInterface {
  private:
   struct impl;
   struct hal_callbacks;
-  impl* impl_;
+  impl* impl_{nullptr};
   hal_callbacks* hal_callbacks_;
 
   std::mutex callback_handlers_guard_;
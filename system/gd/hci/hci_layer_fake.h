@@ -41,6 +41,8 @@ class HciLayerFake : public HciLayer {
       std::unique_ptr<CommandBuilder> command,
       common::ContextualOnceCallback<void(CommandCompleteView)> on_complete) override;
 
+  void SetMaxOutstandingCommands(uint8_t /* max_outstanding_commands */) override {}
+
   CommandView GetCommand();
 
   CommandView GetCommand(OpCode op_code);
@@ -436,6 +436,75 @@ TEST_F(HciLayerTest, our_command_status_callback_is_invoked) {
   hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 1));
 }
 
+TEST_F(HciLayerTest, one_outstanding_command_by_default) {
+  FailIfResetNotSent();
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(
+      ReadClockOffsetBuilder::Create(0x001), hci_handler_->BindOnce([](CommandStatusView) {}));
+  hci_->EnqueueCommand(
+      ReadRemoteVersionInformationBuilder::Create(0x001),
+      hci_handler_->BindOnce([](CommandStatusView) {}));
+
+  ASSERT_TRUE(hal_->GetSentCommand().has_value());
+  ASSERT_FALSE(hal_->GetSentCommand(std::chrono::milliseconds(100)).has_value());
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 2));
+  ASSERT_TRUE(hal_->GetSentCommand().has_value());
+  hal_->InjectEvent(ReadRemoteVersionInformationStatusBuilder::Create(ErrorCode::SUCCESS, 2));
+}
+
+TEST_F(HciLayerTest, outstanding_commands_matched_by_opcode) {
+  std::promise<void> clock_offset_promise;
+  auto clock_offset_future = clock_offset_promise.get_future();
+  std::promise<void> remote_version_promise;
+  auto remote_version_future = remote_version_promise.get_future();
+  FailIfResetNotSent();
+  hci_->SetMaxOutstandingCommands(2);
+  hal_->InjectEvent(ResetCompleteBuilder::Create(2, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(
+      ReadClockOffsetBuilder::Create(0x001),
+      hci_handler_->BindOnce(
+          [](std::promise<void> promise, CommandStatusView view) {
+            ASSERT_EQ(OpCode::READ_CLOCK_OFFSET, view.GetCommandOpCode());
+            promise.set_value();
+          },
+          std::move(clock_offset_promise)));
+  hci_->EnqueueCommand(
+      ReadRemoteVersionInformationBuilder::Create(0x001),
+      hci_handler_->BindOnce(
+          [](std::promise<void> promise, CommandStatusView view) {
+            ASSERT_EQ(OpCode::READ_REMOTE_VERSION_INFORMATION, view.GetCommandOpCode());
+            promise.set_value();
+          },
+          std::move(remote_version_promise)));
+
+  // Both commands are sent before the first response.
+  ASSERT_TRUE(hal_->GetSentCommand().has_value());
+  ASSERT_TRUE(hal_->GetSentCommand().has_value());
+
+  // The responses can be received out of order.
+  hal_->InjectEvent(ReadRemoteVersionInformationStatusBuilder::Create(ErrorCode::SUCCESS, 2));
+  ASSERT_EQ(std::future_status::ready, remote_version_future.wait_for(std::chrono::seconds(1)));
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 2));
+  ASSERT_EQ(std::future_status::ready, clock_offset_future.wait_for(std::chrono::seconds(1)));
+}
+
+TEST_F(HciLayerTest, outstanding_commands_limited_by_credits) {
+  FailIfResetNotSent();
+  hci_->SetMaxOutstandingCommands(2);
+  hal_->InjectEvent(ResetCompleteBuilder::Create(1, ErrorCode::SUCCESS));
+  hci_->EnqueueCommand(
+      ReadClockOffsetBuilder::Create(0x001), hci_handler_->BindOnce([](CommandStatusView) {}));
+  hci_->EnqueueCommand(
+      ReadRemoteVersionInformationBuilder::Create(0x001),
+      hci_handler_->BindOnce([](CommandStatusView) {}));
+
+  ASSERT_TRUE(hal_->GetSentCommand().has_value());
+  ASSERT_FALSE(hal_->GetSentCommand(std::chrono::milliseconds(100)).has_value());
+  hal_->InjectEvent(ReadClockOffsetStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+  ASSERT_TRUE(hal_->GetSentCommand().has_value());
+  hal_->InjectEvent(ReadRemoteVersionInformationStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+}
+
 TEST_F(HciLayerTest, vendor_specific_status_instead_of_complete) {
   std::promise<OpCode> callback_promise;
   auto callback_future = callback_promise.get_future();
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/hci_packets.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+// Read Remote Version Information Complete for handle 0x0040.
+static std::shared_ptr<std::vector<uint8_t>> GetEventBytes() {
+  return std::make_shared<std::vector<uint8_t>>(
+      std::vector<uint8_t>{0x0c, 0x08, 0x00, 0x40, 0x00, 0x0b, 0x0f, 0x00, 0x34, 0x12});
+}
+
+// ACL header for handle 0x0040 followed by a 4 byte payload.
+static std::shared_ptr<std::vector<uint8_t>> GetAclBytes() {
+  return std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>{0x40, 0x20, 0x04, 0x00, 0x01, 0x02, 0x03, 0x04});
+}
+
+// Each getter walks the packet with its own iterator.
+static void BM_EventViewGetters(State& state) {
+  auto bytes = GetEventBytes();
+  for (auto _ : state) {
+    auto view = ReadRemoteVersionInformationCompleteView::Create(EventView::Create(PacketView<kLittleEndian>(bytes)));
+    if (!view.IsValid()) {
+      state.SkipWithError("Invalid event");
+      break;
+    }
+    benchmark::DoNotOptimize(view.GetStatus());
+    benchmark::DoNotOptimize(view.GetConnectionHandle());
+    benchmark::DoNotOptimize(view.GetVersion());
+    benchmark::DoNotOptimize(view.GetManufacturerName());
+    benchmark::DoNotOptimize(view.GetSubVersion());
+  }
+}
+BENCHMARK(BM_EventViewGetters);
+
+// All the fields are decoded from a single copy of the event.
+static void BM_EventFixedLayout(State& state) {
+  auto bytes = GetEventBytes();
+  for (auto _ : state) {
+    auto fields = ReadRemoteVersionInformationCompleteFields::Parse(
+        ReadRemoteVersionInformationCompleteView::Create(EventView::Create(PacketView<kLittleEndian>(bytes))));
+    if (!fields.has_value()) {
+      state.SkipWithError("Invalid event");
+      break;
+    }
+    benchmark::DoNotOptimize(fields->status_);
+    benchmark::DoNotOptimize(fields->connection_handle_);
+    benchmark::DoNotOptimize(fields->version_);
+    benchmark::DoNotOptimize(fields->manufacturer_name_);
+    benchmark::DoNotOptimize(fields->sub_version_);
+  }
+}
+BENCHMARK(BM_EventFixedLayout);
+
+static void BM_AclViewGetters(State& state) {
+  auto bytes = GetAclBytes();
+  for (auto _ : state) {
+    auto view = AclView::Create(PacketView<kLittleEndian>(bytes));
+    if (!view.IsValid()) {
+      state.SkipWithError("Invalid ACL packet");
+      break;
+    }
+    benchmark::DoNotOptimize(view.GetHandle());
+    benchmark::DoNotOptimize(view.GetPacketBoundaryFlag());
+    benchmark::DoNotOptimize(view.GetBroadcastFlag());
+  }
+}
+BENCHMARK(BM_AclViewGetters);
+
+static void BM_AclFixedLayout(State& state) {
+  auto bytes = GetAclBytes();
+  for (auto _ : state) {
+    auto fields = AclFields::Parse(AclView::Create(PacketView<kLittleEndian>(bytes)));
+    if (!fields.has_value()) {
+      state.SkipWithError("Invalid ACL packet");
+      break;
+    }
+    benchmark::DoNotOptimize(fields->handle_);
+    benchmark::DoNotOptimize(fields->packet_boundary_flag_);
+    benchmark::DoNotOptimize(fields->broadcast_flag_);
+  }
+}
+BENCHMARK(BM_AclFixedLayout);
+
+}  // namespace hci
+}  // namespace bluetooth
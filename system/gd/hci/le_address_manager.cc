@@ -524,8 +524,17 @@ void LeAddressManager::handle_next_command() {
       command.contents);
 }
 
+void LeAddressManager::run_cached_commands() {
+  if (registered_clients_.empty()) {
+    handle_next_command();
+  } else {
+    pause_registered_clients();
+  }
+}
+
 void LeAddressManager::AddDeviceToFilterAcceptList(
     FilterAcceptListAddressType accept_list_address_type, bluetooth::hci::Address address) {
+  accept_list_.emplace(accept_list_address_type, address);
   auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(accept_list_address_type, address);
   Command command = {CommandType::ADD_DEVICE_TO_ACCEPT_LIST, HCICommand{std::move(packet_builder)}};
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command))();
@@ -545,6 +554,7 @@ void LeAddressManager::AddDeviceToResolvingList(
   Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
   cached_commands_.push(std::move(disable));
 
+  resolving_list_[{peer_identity_address_type, peer_identity_address}] = {peer_irk, local_irk};
   auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
       peer_identity_address_type, peer_identity_address, peer_irk, local_irk);
   Command command = {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
@@ -562,15 +572,12 @@ void LeAddressManager::AddDeviceToResolvingList(
   Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
   cached_commands_.push(std::move(enable));
 
-  if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command)();
-  } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients)();
-  }
+  handler_->BindOnceOn(this, &LeAddressManager::run_cached_commands)();
 }
 
 void LeAddressManager::RemoveDeviceFromFilterAcceptList(
     FilterAcceptListAddressType accept_list_address_type, bluetooth::hci::Address address) {
+  accept_list_.erase({accept_list_address_type, address});
   auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(accept_list_address_type, address);
   Command command = {CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST, HCICommand{std::move(packet_builder)}};
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command))();
@@ -587,6 +594,7 @@ void LeAddressManager::RemoveDeviceFromResolvingList(
   Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
   cached_commands_.push(std::move(disable));
 
+  resolving_list_.erase({peer_identity_address_type, peer_identity_address});
   auto packet_builder =
       hci::LeRemoveDeviceFromResolvingListBuilder::Create(peer_identity_address_type, peer_identity_address);
   Command command = {CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
@@ -597,14 +605,11 @@ void LeAddressManager::RemoveDeviceFromResolvingList(
   Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
   cached_commands_.push(std::move(enable));
 
-  if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command)();
-  } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients)();
-  }
+  handler_->BindOnceOn(this, &LeAddressManager::run_cached_commands)();
 }
 
 void LeAddressManager::ClearFilterAcceptList() {
+  accept_list_.clear();
   auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
   Command command = {CommandType::CLEAR_ACCEPT_LIST, HCICommand{std::move(packet_builder)}};
   handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command))();
@@ -620,6 +625,7 @@ void LeAddressManager::ClearResolvingList() {
   Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
   cached_commands_.push(std::move(disable));
 
+  resolving_list_.clear();
   auto packet_builder = hci::LeClearResolvingListBuilder::Create();
   Command command = {CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
   cached_commands_.push(std::move(command));
@@ -632,6 +638,106 @@ void LeAddressManager::ClearResolvingList() {
   handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients)();
 }
 
+void LeAddressManager::ListUpdate::AddDeviceToFilterAcceptList(
+    FilterAcceptListAddressType accept_list_address_type, Address address) {
+  accept_list_[{accept_list_address_type, address}] = true;
+}
+
+void LeAddressManager::ListUpdate::RemoveDeviceFromFilterAcceptList(
+    FilterAcceptListAddressType accept_list_address_type, Address address) {
+  accept_list_[{accept_list_address_type, address}] = false;
+}
+
+void LeAddressManager::ListUpdate::AddDeviceToResolvingList(
+    PeerAddressType peer_identity_address_type,
+    Address peer_identity_address,
+    const std::array<uint8_t, 16>& peer_irk,
+    const std::array<uint8_t, 16>& local_irk) {
+  resolving_list_[{peer_identity_address_type, peer_identity_address}] = ResolvingListKeys{peer_irk, local_irk};
+}
+
+void LeAddressManager::ListUpdate::RemoveDeviceFromResolvingList(
+    PeerAddressType peer_identity_address_type, Address peer_identity_address) {
+  resolving_list_[{peer_identity_address_type, peer_identity_address}] = std::nullopt;
+}
+
+void LeAddressManager::ApplyListUpdate(ListUpdate update) {
+  size_t num_cached_commands = cached_commands_.size();
+
+  // Removals are sent first to make room for the additions.
+  std::vector<std::pair<FilterAcceptListAddressType, Address>> accept_list_additions;
+  for (auto& [entry, add] : update.accept_list_) {
+    bool present = accept_list_.find(entry) != accept_list_.end();
+    if (add && !present) {
+      accept_list_additions.push_back(entry);
+    } else if (!add && present) {
+      accept_list_.erase(entry);
+      auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(entry.first, entry.second);
+      cached_commands_.push({CommandType::REMOVE_DEVICE_FROM_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+    }
+  }
+
+  if (supports_ble_privacy_) {
+    std::vector<std::pair<PeerAddressType, Address>> resolving_list_removals;
+    std::vector<std::pair<std::pair<PeerAddressType, Address>, ResolvingListKeys>> resolving_list_additions;
+    for (auto& [entry, keys] : update.resolving_list_) {
+      auto it = resolving_list_.find(entry);
+      if (it != resolving_list_.end()) {
+        if (keys == it->second) {
+          continue;
+        }
+        // The keys of an entry can't be changed, the entry is added again.
+        resolving_list_.erase(it);
+        resolving_list_removals.push_back(entry);
+      }
+      if (keys.has_value()) {
+        resolving_list_additions.emplace_back(entry, *keys);
+      }
+    }
+
+    if (!resolving_list_removals.empty() || !resolving_list_additions.empty()) {
+      auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
+      cached_commands_.push({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}});
+      for (auto& [type, address] : resolving_list_removals) {
+        auto packet_builder = hci::LeRemoveDeviceFromResolvingListBuilder::Create(type, address);
+        cached_commands_.push({CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+      }
+      for (auto& [entry, keys] : resolving_list_additions) {
+        if (resolving_list_.size() >= resolving_list_size_) {
+          log::warn("Resolving list is full, {} is not added", entry.second);
+          continue;
+        }
+        resolving_list_.emplace(entry, keys);
+        auto packet_builder =
+            hci::LeAddDeviceToResolvingListBuilder::Create(entry.first, entry.second, keys.peer_irk, keys.local_irk);
+        cached_commands_.push({CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+        auto privacy_mode_builder = hci::LeSetPrivacyModeBuilder::Create(entry.first, entry.second, PrivacyMode::DEVICE);
+        cached_commands_.push({CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(privacy_mode_builder)}});
+      }
+      auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
+      cached_commands_.push({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}});
+    }
+  }
+
+  for (auto& [type, address] : accept_list_additions) {
+    if (accept_list_.size() >= accept_list_size_) {
+      log::warn("Filter accept list is full, {} is not added", address);
+      continue;
+    }
+    accept_list_.emplace(type, address);
+    auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(type, address);
+    cached_commands_.push({CommandType::ADD_DEVICE_TO_ACCEPT_LIST, HCICommand{std::move(packet_builder)}});
+  }
+
+  size_t num_commands = cached_commands_.size() - num_cached_commands;
+  if (num_commands == 0) {
+    log::verbose("Filter accept list and resolving list are up to date");
+    return;
+  }
+  log::info("Applying filter accept list and resolving list update with {} commands", num_commands);
+  handler_->BindOnceOn(this, &LeAddressManager::run_cached_commands)();
+}
+
 template <class View>
 void LeAddressManager::on_command_complete(CommandCompleteView view) {
   auto op_code = view.GetCommandOpCode();
@@ -18,6 +18,8 @@
 #include <bluetooth/log.h>
 
 #include <map>
+#include <optional>
+#include <set>
 #include <variant>
 
 #include "common/callback.h"
@@ -96,6 +98,43 @@ class LeAddressManager {
   void RemoveDeviceFromResolvingList(PeerAddressType peer_identity_address_type, Address peer_identity_address);
   void ClearFilterAcceptList();
   void ClearResolvingList();
+
+  struct ResolvingListKeys {
+    std::array<uint8_t, 16> peer_irk;
+    std::array<uint8_t, 16> local_irk;
+    bool operator==(const ResolvingListKeys& other) const = default;
+  };
+
+  /// Collects filter accept list and resolving list changes to be applied
+  /// together by ApplyListUpdate(). Only the last change of each entry is
+  /// kept.
+  class ListUpdate {
+   public:
+    void AddDeviceToFilterAcceptList(FilterAcceptListAddressType accept_list_address_type, Address address);
+    void RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType accept_list_address_type, Address address);
+    void AddDeviceToResolvingList(
+        PeerAddressType peer_identity_address_type,
+        Address peer_identity_address,
+        const std::array<uint8_t, 16>& peer_irk,
+        const std::array<uint8_t, 16>& local_irk);
+    void RemoveDeviceFromResolvingList(PeerAddressType peer_identity_address_type, Address peer_identity_address);
+    bool IsEmpty() const {
+      return accept_list_.empty() && resolving_list_.empty();
+    }
+
+   private:
+    friend class LeAddressManager;
+    // True if the entry is to be added, false if it is to be removed.
+    std::map<std::pair<FilterAcceptListAddressType, Address>, bool> accept_list_;
+    // The keys of the entry to be added, std::nullopt if it is to be removed.
+    std::map<std::pair<PeerAddressType, Address>, std::optional<ResolvingListKeys>> resolving_list_;
+  };
+
+  /// Applies the difference between the update and the current lists of the
+  /// controller. The registered clients are paused once for all the
+  /// commands, and address resolution is disabled once for all the resolving
+  /// list changes. Nothing is sent when the update does not change the lists.
+  void ApplyListUpdate(ListUpdate update);
   void OnCommandComplete(CommandCompleteView view);
   std::chrono::milliseconds GetNextPrivateAddressIntervalMs();
 
@@ -159,6 +198,7 @@ class LeAddressManager {
   hci::Address generate_rpa();
   hci::Address generate_nrpa();
   void handle_next_command();
+  void run_cached_commands();
   void check_cached_commands();
   template <class View>
   void on_command_complete(CommandCompleteView view);
@@ -176,6 +216,10 @@ class LeAddressManager {
   uint8_t resolving_list_size_;
   std::queue<Command> cached_commands_;
   bool supports_ble_privacy_{false};
+
+  // Lists of the controller, including the changes not completed yet.
+  std::set<std::pair<FilterAcceptListAddressType, Address>> accept_list_;
+  std::map<std::pair<PeerAddressType, Address>, ResolvingListKeys> resolving_list_;
 };
 
 }  // namespace hci
@@ -43,6 +43,7 @@ class RotatorClient : public LeAddressManagerCallback {
 
   void OnPause() {
     paused = true;
+    pause_count++;
     le_address_manager_->AckPause(this);
   }
 
@@ -66,6 +67,7 @@ class RotatorClient : public LeAddressManagerCallback {
   }
 
   bool paused{false};
+  size_t pause_count{0};
   LeAddressManager* le_address_manager_;
   size_t id_;
   std::unique_ptr<std::promise<void>> resume_promise_;
@@ -466,6 +468,75 @@ TEST_F(LeAddressManagerWithSingleClientTest, DISABLED_clear_resolving_list) {
   clients[0].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, apply_list_update_in_single_pause) {
+  size_t pause_count = clients[0]->pause_count;
+  Address address1, address2, address3;
+  Address::FromString("01:02:03:04:05:06", address1);
+  Address::FromString("01:02:03:04:05:07", address2);
+  Address::FromString("01:02:03:04:05:08", address3);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address1);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  hci_layer_->IncomingEvent(
+      LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+
+  LeAddressManager::ListUpdate update;
+  update.AddDeviceToFilterAcceptList(FilterAcceptListAddressType::PUBLIC, address2);
+  update.AddDeviceToFilterAcceptList(FilterAcceptListAddressType::PUBLIC, address3);
+  update.RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::RANDOM, address1);
+  le_address_manager_->ApplyListUpdate(std::move(update));
+
+  // The removal is sent before the additions.
+  {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST);
+    auto packet_view = LeRemoveDeviceFromFilterAcceptListView::Create(
+        LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(address1, packet_view.GetAddress());
+    hci_layer_->IncomingEvent(
+        LeRemoveDeviceFromFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  for (auto& address : {address2, address3}) {
+    auto packet = hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+    auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+        LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+    ASSERT_TRUE(packet_view.IsValid());
+    ASSERT_EQ(FilterAcceptListAddressType::PUBLIC, packet_view.GetAddressType());
+    ASSERT_EQ(address, packet_view.GetAddress());
+    hci_layer_->IncomingEvent(
+        LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  }
+  clients[0].get()->WaitForResume();
+  ASSERT_EQ(pause_count + 2, clients[0]->pause_count);
+}
+
+TEST_F(LeAddressManagerWithSingleClientTest, apply_list_update_without_changes) {
+  Address address;
+  Address::FromString("01:02:03:04:05:06", address);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  hci_layer_->IncomingEvent(
+      LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+  size_t pause_count = clients[0]->pause_count;
+
+  LeAddressManager::ListUpdate update;
+  // Already in the list.
+  update.AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address);
+  // Added and removed again.
+  update.AddDeviceToFilterAcceptList(FilterAcceptListAddressType::PUBLIC, address);
+  update.RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::PUBLIC, address);
+  // Never added, and no privacy support.
+  update.RemoveDeviceFromResolvingList(PeerAddressType::PUBLIC_DEVICE_OR_IDENTITY_ADDRESS, address);
+  ASSERT_FALSE(update.IsEmpty());
+  le_address_manager_->ApplyListUpdate(std::move(update));
+  sync_handler(handler_);
+
+  hci_layer_->AssertNoQueuedCommand();
+  ASSERT_EQ(pause_count, clients[0]->pause_count);
+  ASSERT_EQ(0u, le_address_manager_->NumberCachedCommands());
+}
+
 TEST_F(LeAddressManagerWithSingleClientTest, register_during_command_complete) {
   Address address;
   Address::FromString("01:02:03:04:05:06", address);
@@ -18,9 +18,11 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <chrono>
 #include <iterator>
 #include <memory>
 #include <mutex>
+#include <optional>
 
 #include "common/init_flags.h"
 #include "common/strings.h"
@@ -35,6 +37,7 @@
 #include "os/handler.h"
 #include "os/log.h"
 #include "os/system_properties.h"
+#include "packet/bit_inserter.h"
 #include "packet/fragmenting_inserter.h"
 
 namespace bluetooth {
@@ -48,8 +51,15 @@ constexpr int64_t kLeAdvertisingTxPowerMax = 20;
 constexpr int64_t kLeTxPathLossCompMin = -128;
 constexpr int64_t kLeTxPathLossCompMax = 127;
 
+// Sets whose address rotation is due within this delay are rotated together.
+constexpr std::chrono::seconds kAddressRotationAlignment = std::chrono::seconds(30);
+
 // system properties
 const std::string kLeTxPathLossCompProperty = "bluetooth.hardware.radio.le_tx_path_loss_comp_db";
+// Advertising data updates of a set closer than this window are coalesced,
+// only the last one is sent to the controller. 0 sends every update.
+const std::string kLeAdvertisingDataCoalescingWindowProperty =
+    "bluetooth.le.advertising_data_coalescing_window_ms";
 
 enum class AdvertisingApiType {
   LEGACY = 1,
@@ -85,6 +95,15 @@ struct Advertiser {
   bool in_use = false;
   bool is_periodic = false;
   std::unique_ptr<os::Alarm> address_rotation_alarm;
+  std::chrono::steady_clock::time_point address_rotation_time;
+  // Coalesced advertising data updates, sent when data_update_alarm fires
+  std::chrono::steady_clock::time_point last_data_update_time;
+  std::optional<std::vector<GapData>> pending_data;
+  std::optional<std::vector<GapData>> pending_scan_response_data;
+  std::unique_ptr<os::Alarm> data_update_alarm;
+  bool data_update_scheduled = false;
+  // Serialized periodic advertising data last sent to the controller
+  std::optional<std::vector<uint8_t>> periodic_data;
 };
 
 /**
@@ -188,6 +207,8 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       enabled_sets_[i].advertising_handle_ = kInvalidHandle;
     }
     le_tx_path_loss_comp_ = get_tx_path_loss_compensation();
+    data_update_window_ = std::chrono::milliseconds(
+        os::GetSystemPropertyUint32(kLeAdvertisingDataCoalescingWindowProperty, 0));
   }
 
   int8_t get_tx_path_loss_compensation() {
@@ -355,10 +376,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
         log::info("Reenable advertising");
         if (was_rotating_address) {
           advertising_sets_[advertiser_id].address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
-          advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
-              common::BindOnce(
-                  &impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
-              le_address_manager_->GetNextPrivateAddressIntervalMs());
+          schedule_address_rotation(advertiser_id);
         }
         enable_advertiser(advertiser_id, true, 0, 0);
       }
@@ -644,10 +662,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
           !leaudio_requested_nrpa) {
         // start timer for random address
         advertising_sets_[id].address_rotation_alarm = std::make_unique<os::Alarm>(module_handler_);
-        advertising_sets_[id].address_rotation_alarm->Schedule(
-            common::BindOnce(
-                &impl::set_advertising_set_random_address_on_timer, common::Unretained(this), id),
-            le_address_manager_->GetNextPrivateAddressIntervalMs());
+        schedule_address_rotation(id);
       }
     }
     if (config.advertising_type == AdvertisingType::ADV_IND ||
@@ -734,6 +749,14 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
+  void schedule_address_rotation(AdvertiserId advertiser_id) {
+    auto interval = le_address_manager_->GetNextPrivateAddressIntervalMs();
+    advertising_sets_[advertiser_id].address_rotation_time = std::chrono::steady_clock::now() + interval;
+    advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
+        common::BindOnce(&impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
+        interval);
+  }
+
   void set_advertising_set_random_address_on_timer(AdvertiserId advertiser_id) {
     // This function should only be trigger by enabled advertising set or IRK rotation
     if (enabled_sets_[advertiser_id].advertising_handle_ == kInvalidHandle) {
@@ -744,35 +767,55 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       return;
     }
 
+    // The other enabled sets due for rotation soon are rotated now as well, so that the
+    // connectable sets are disabled and enabled again with a single command.
+    std::vector<AdvertiserId> rotated_sets = {advertiser_id};
+    auto rotation_deadline = std::chrono::steady_clock::now() + kAddressRotationAlignment;
+    for (auto& [id, advertiser] : advertising_sets_) {
+      if (id != advertiser_id && advertiser.address_rotation_alarm != nullptr &&
+          enabled_sets_[id].advertising_handle_ != kInvalidHandle &&
+          advertiser.address_rotation_time <= rotation_deadline) {
+        advertiser.address_rotation_alarm->Cancel();
+        rotated_sets.push_back(id);
+      }
+    }
+
     // TODO handle duration and max_extended_advertising_events_
-    EnabledSet curr_set;
-    curr_set.advertising_handle_ = advertiser_id;
-    curr_set.duration_ = advertising_sets_[advertiser_id].duration;
-    curr_set.max_extended_advertising_events_ = advertising_sets_[advertiser_id].max_extended_advertising_events;
-    std::vector<EnabledSet> enabled_sets = {curr_set};
+    std::vector<EnabledSet> enabled_sets;
+    for (auto id : rotated_sets) {
+      // For connectable advertising, we should disable it first
+      if (advertising_sets_[id].connectable) {
+        EnabledSet curr_set;
+        curr_set.advertising_handle_ = id;
+        curr_set.duration_ = advertising_sets_[id].duration;
+        curr_set.max_extended_advertising_events_ = advertising_sets_[id].max_extended_advertising_events;
+        enabled_sets.push_back(curr_set);
+      }
+    }
 
-    // For connectable advertising, we should disable it first
-    if (advertising_sets_[advertiser_id].connectable) {
+    if (!enabled_sets.empty()) {
       le_advertising_interface_->EnqueueCommand(
           hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::DISABLED, enabled_sets),
           module_handler_->BindOnce(check_complete<LeSetExtendedAdvertisingEnableCompleteView>));
     }
 
-    rotate_advertiser_address(advertiser_id);
+    for (auto id : rotated_sets) {
+      rotate_advertiser_address(id);
+    }
 
     // If we are paused, we will be enabled in OnResume(), so don't resume now.
     // Note that OnResume() can never re-enable us while we are changing our address, since the
     // DISABLED and ENABLED commands are enqueued synchronously, so OnResume() doesn't need an
     // analogous check.
-    if (advertising_sets_[advertiser_id].connectable && !paused) {
+    if (!enabled_sets.empty() && !paused) {
       le_advertising_interface_->EnqueueCommand(
           hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, enabled_sets),
           module_handler_->BindOnce(check_complete<LeSetExtendedAdvertisingEnableCompleteView>));
     }
 
-    advertising_sets_[advertiser_id].address_rotation_alarm->Schedule(
-        common::BindOnce(&impl::set_advertising_set_random_address_on_timer, common::Unretained(this), advertiser_id),
-        le_address_manager_->GetNextPrivateAddressIntervalMs());
+    for (auto id : rotated_sets) {
+      schedule_address_rotation(id);
+    }
   }
 
   void register_advertiser(
@@ -984,6 +1027,75 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     return true;
   };
 
+  void set_data_coalesced(AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data) {
+    auto advertising_iter = advertising_sets_.find(advertiser_id);
+    if (data_update_window_.count() == 0 || advertising_iter == advertising_sets_.end()) {
+      set_data(advertiser_id, set_scan_rsp, std::move(data));
+      return;
+    }
+
+    // The first update after a quiet window is sent right away.
+    auto& advertiser = advertising_iter->second;
+    auto now = std::chrono::steady_clock::now();
+    if (!advertiser.data_update_scheduled && now - advertiser.last_data_update_time >= data_update_window_) {
+      advertiser.last_data_update_time = now;
+      set_data(advertiser_id, set_scan_rsp, std::move(data));
+      return;
+    }
+
+    auto& pending_data = set_scan_rsp ? advertiser.pending_scan_response_data : advertiser.pending_data;
+    if (pending_data.has_value()) {
+      on_data_update_superseded(advertiser_id, set_scan_rsp);
+    }
+    pending_data = std::move(data);
+
+    if (!advertiser.data_update_scheduled) {
+      if (advertiser.data_update_alarm == nullptr) {
+        advertiser.data_update_alarm = std::make_unique<os::Alarm>(module_handler_);
+      }
+      advertiser.data_update_scheduled = true;
+      advertiser.data_update_alarm->Schedule(
+          common::BindOnce(&impl::send_coalesced_data, common::Unretained(this), advertiser_id),
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              advertiser.last_data_update_time + data_update_window_ - now));
+    }
+  }
+
+  void send_coalesced_data(AdvertiserId advertiser_id) {
+    auto advertising_iter = advertising_sets_.find(advertiser_id);
+    if (advertising_iter == advertising_sets_.end()) {
+      return;
+    }
+    auto& advertiser = advertising_iter->second;
+    advertiser.data_update_scheduled = false;
+    advertiser.last_data_update_time = std::chrono::steady_clock::now();
+    if (advertiser.pending_data.has_value()) {
+      auto data = std::move(*advertiser.pending_data);
+      advertiser.pending_data.reset();
+      set_data(advertiser_id, false, std::move(data));
+    }
+    if (advertiser.pending_scan_response_data.has_value()) {
+      auto data = std::move(*advertiser.pending_scan_response_data);
+      advertiser.pending_scan_response_data.reset();
+      set_data(advertiser_id, true, std::move(data));
+    }
+  }
+
+  // A coalesced update replaced by a newer one is reported as set.
+  void on_data_update_superseded(AdvertiserId advertiser_id, bool set_scan_rsp) {
+    if (advertising_callbacks_ == nullptr || !advertising_sets_[advertiser_id].started ||
+        id_map_[advertiser_id] == kIdLocal) {
+      return;
+    }
+    if (set_scan_rsp) {
+      advertising_callbacks_->OnScanResponseDataSet(
+          advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS);
+    } else {
+      advertising_callbacks_->OnAdvertisingDataSet(
+          advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS);
+    }
+  }
+
   void set_data(AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data) {
     // The Flags data type shall be included when any of the Flag bits are non-zero and the
     // advertising packet is connectable and discoverable.
@@ -1341,6 +1453,23 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
       return;
     }
 
+    // The controller keeps the periodic advertising data of the set, skip the update when the
+    // data is unchanged. The fragments can not be updated individually: a new first fragment
+    // discards the data previously set.
+    std::vector<uint8_t> serialized_data;
+    serialized_data.reserve(data_len);
+    packet::BitInserter inserter(serialized_data);
+    for (auto& gap_data : data) {
+      gap_data.Serialize(inserter);
+    }
+    auto& periodic_data = advertising_sets_[advertiser_id].periodic_data;
+    if (periodic_data == serialized_data) {
+      log::verbose("Periodic advertising data unchanged for advertiser {}", advertiser_id);
+      on_periodic_data_unchanged(advertiser_id);
+      return;
+    }
+    periodic_data = std::move(serialized_data);
+
     uint16_t data_fragment_limit =
         divide_gap_flag ? kLeMaximumPeriodicDataFragmentLength : kLeMaximumFragmentLength;
     if (data_len <= data_fragment_limit) {
@@ -1382,6 +1511,15 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
+  void on_periodic_data_unchanged(AdvertiserId advertiser_id) {
+    if (advertising_callbacks_ == nullptr || !advertising_sets_[advertiser_id].started ||
+        id_map_[advertiser_id] == kIdLocal) {
+      return;
+    }
+    advertising_callbacks_->OnPeriodicAdvertisingDataSet(
+        advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS);
+  }
+
   void send_periodic_data_fragment(AdvertiserId advertiser_id, std::vector<GapData> data, Operation operation) {
     if (com::android::bluetooth::flags::divide_long_single_gap_data()) {
       // For first and intermediate fragment, do not trigger advertising_callbacks_.
@@ -1576,6 +1714,7 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
   int8_t le_tx_path_loss_comp_ = 0;
   hci::LeAdvertisingInterface* le_advertising_interface_;
   std::map<AdvertiserId, Advertiser> advertising_sets_;
+  std::chrono::milliseconds data_update_window_{0};
   hci::LeAddressManager* le_address_manager_;
   hci::AclManager* acl_manager_;
   bool address_manager_registered = false;
@@ -1764,6 +1903,13 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     if (status_view.GetStatus() != ErrorCode::SUCCESS) {
       log::info("Got a command complete with status {}", ErrorCodeText(status_view.GetStatus()));
       advertising_status = AdvertisingCallback::AdvertisingStatus::INTERNAL_ERROR;
+      // The periodic advertising data held by the controller is unknown, do not skip the next update
+      if (view.GetCommandOpCode() == OpCode::LE_SET_PERIODIC_ADVERTISING_DATA) {
+        auto advertising_iter = advertising_sets_.find(id);
+        if (advertising_iter != advertising_sets_.end()) {
+          advertising_iter->second.periodic_data.reset();
+        }
+      }
     }
 
     // Do not trigger callback if the advertiser not stated yet, or the advertiser is not register
@@ -1987,7 +2133,7 @@ void LeAdvertisingManager::SetParameters(AdvertiserId advertiser_id, Advertising
 }
 
 void LeAdvertisingManager::SetData(AdvertiserId advertiser_id, bool set_scan_rsp, std::vector<GapData> data) {
-  CallOn(pimpl_.get(), &impl::set_data, advertiser_id, set_scan_rsp, data);
+  CallOn(pimpl_.get(), &impl::set_data_coalesced, advertiser_id, set_scan_rsp, data);
 }
 
 void LeAdvertisingManager::EnableAdvertiser(
@@ -33,6 +33,7 @@
 #include "hci/address.h"
 #include "hci/controller.h"
 #include "hci/hci_layer_fake.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -508,6 +509,26 @@ class LeExtendedAdvertisingAPITest : public LeExtendedAdvertisingManagerTest {
   AdvertiserId advertiser_id_;
 };
 
+class LeExtendedAdvertisingDataCoalescingTest : public LeExtendedAdvertisingAPITest {
+ protected:
+  void SetUp() override {
+    os::SetSystemProperty("bluetooth.le.advertising_data_coalescing_window_ms", "100");
+    LeExtendedAdvertisingAPITest::SetUp();
+  }
+
+  void TearDown() override {
+    LeExtendedAdvertisingAPITest::TearDown();
+    os::ClearSystemPropertiesForHost();
+  }
+
+  static std::vector<GapData> ServiceData(uint8_t value) {
+    GapData data_item{};
+    data_item.data_type_ = GapDataType::SERVICE_DATA_16_BIT_UUIDS;
+    data_item.data_ = {0x0d, 0x18, value};
+    return {data_item};
+  }
+};
+
 TEST_F(LeAdvertisingManagerTest, startup_teardown) {}
 
 TEST_F(LeAndroidHciAdvertisingManagerTest, startup_teardown) {}
@@ -1157,6 +1178,34 @@ TEST_F(LeExtendedAdvertisingAPITest, set_data_test) {
   test_hci_layer_->IncomingEvent(LeSetExtendedScanResponseDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
 }
 
+TEST_F(LeExtendedAdvertisingDataCoalescingTest, coalesce_data_updates) {
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS))
+      .Times(3);
+
+  // The first update is sent right away.
+  le_advertising_manager_->SetData(advertiser_id_, false, ServiceData(0x1));
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(
+      LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // The following updates in the window are coalesced, only the last one is sent.
+  le_advertising_manager_->SetData(advertiser_id_, false, ServiceData(0x2));
+  le_advertising_manager_->SetData(advertiser_id_, false, ServiceData(0x3));
+  auto command = test_hci_layer_->GetCommand();
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, command.GetOpCode());
+  auto data_view =
+      LeSetExtendedAdvertisingDataView::Create(LeAdvertisingCommandView::Create(command));
+  ASSERT_TRUE(data_view.IsValid());
+  auto advertising_data = data_view.GetAdvertisingData();
+  ASSERT_EQ(1u, advertising_data.size());
+  ASSERT_EQ(ServiceData(0x3)[0].data_, advertising_data[0].data_);
+  test_hci_layer_->IncomingEvent(
+      LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  sync_client_handler();
+}
+
 TEST_F(LeAndroidHciAdvertisingAPITest, set_data_test) {
   // Set advertising data
   std::vector<GapData> advertising_data{};
@@ -1556,6 +1605,34 @@ TEST_F(LeExtendedAdvertisingAPITest, set_periodic_data_test) {
   sync_client_handler();
 }
 
+TEST_F(LeExtendedAdvertisingAPITest, set_periodic_data_unchanged_test) {
+  std::vector<GapData> advertising_data{};
+  GapData data_item{};
+  data_item.data_type_ = GapDataType::TX_POWER_LEVEL;
+  data_item.data_ = {0x00};
+  advertising_data.push_back(data_item);
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnPeriodicAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS))
+      .Times(3);
+
+  le_advertising_manager_->SetPeriodicData(advertiser_id_, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_PERIODIC_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetPeriodicAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  // The same data is not sent again
+  le_advertising_manager_->SetPeriodicData(advertiser_id_, advertising_data);
+  sync_client_handler();
+  test_hci_layer_->AssertNoQueuedCommand();
+
+  // Changed data is sent
+  advertising_data[0].data_ = {0x01};
+  le_advertising_manager_->SetPeriodicData(advertiser_id_, advertising_data);
+  ASSERT_EQ(OpCode::LE_SET_PERIODIC_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeSetPeriodicAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  sync_client_handler();
+}
+
 TEST_F(LeExtendedAdvertisingAPITest, set_periodic_data_fragments_test) {
   // Set advertising data
   std::vector<GapData> advertising_data{};
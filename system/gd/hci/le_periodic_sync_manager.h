@@ -117,6 +117,7 @@ class PeriodicSyncManager {
 
   void StopSync(uint16_t handle) {
     log::debug("[PSync]: handle = {}", handle);
+    scanning_reassembler_.RemovePeriodicFragment(handle);
     auto periodic_sync = GetEstablishedSyncFromHandle(handle);
     if (periodic_sync == periodic_syncs_.end()) {
       log::error("[PSync]: invalid index for handle {}", handle);
@@ -404,6 +405,7 @@ class PeriodicSyncManager {
     uint16_t sync_handle = event_view.GetSyncHandle();
     log::debug("[PSync]: sync_handle = {}", sync_handle);
     callbacks_->OnPeriodicSyncLost(sync_handle);
+    scanning_reassembler_.RemovePeriodicFragment(sync_handle);
     auto periodic_sync = GetEstablishedSyncFromHandle(sync_handle);
     if (periodic_sync == periodic_syncs_.end()) {
       log::error("[PSync]: index not found for handle {}", sync_handle);
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/le_scanning_duplicate_filter.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace bluetooth::hci {
+
+LeScanningDuplicateFilter::LeScanningDuplicateFilter(size_t capacity)
+    : table_(std::bit_ceil(std::max(capacity, kMaxProbes)), Entry{}), mask_(table_.size() - 1) {}
+
+uint64_t LeScanningDuplicateFilter::MakeKey(
+    uint8_t address_type, const Address& address, uint8_t advertising_sid) {
+  uint64_t key = 0;
+  for (uint8_t byte : address.address) {
+    key = (key << 8) | byte;
+  }
+  // Bit 63 keeps the key of a valid advertiser different from an empty slot.
+  return key | ((uint64_t)address_type << 48) | ((uint64_t)advertising_sid << 56) |
+         (1ULL << 63);
+}
+
+uint64_t LeScanningDuplicateFilter::HashData(
+    uint16_t event_type, const std::vector<uint8_t>& advertising_data) {
+  // 64-bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto mix = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 0x100000001b3ULL;
+  };
+  mix(event_type & 0xff);
+  mix(event_type >> 8);
+  for (uint8_t byte : advertising_data) {
+    mix(byte);
+  }
+  return hash;
+}
+
+bool LeScanningDuplicateFilter::Accept(
+    Clock::time_point now,
+    uint16_t event_type,
+    uint8_t address_type,
+    Address address,
+    uint8_t advertising_sid,
+    const std::vector<uint8_t>& advertising_data) {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  const uint64_t key = MakeKey(address_type, address, advertising_sid);
+  const uint64_t data_hash = HashData(event_type, advertising_data);
+
+  // Mix the key bits down before indexing, addresses often share their
+  // most or least significant bytes.
+  uint64_t index = key * 0x9e3779b97f4a7c15ULL;
+  index ^= index >> 32;
+
+  Entry* free_entry = nullptr;
+  Entry* oldest_entry = nullptr;
+  for (size_t probe = 0; probe < kMaxProbes; probe++) {
+    Entry& entry = table_[(index + probe) & mask_];
+    if (entry.key == key) {
+      if (entry.data_hash == data_hash && now - entry.delivered < window_) {
+        return false;
+      }
+      entry.data_hash = data_hash;
+      entry.delivered = now;
+      return true;
+    }
+    if (entry.key == 0 || now - entry.delivered >= window_) {
+      if (free_entry == nullptr) {
+        free_entry = &entry;
+      }
+    } else if (oldest_entry == nullptr || entry.delivered < oldest_entry->delivered) {
+      oldest_entry = &entry;
+    }
+  }
+
+  Entry* entry = free_entry != nullptr ? free_entry : oldest_entry;
+  *entry = {.key = key, .data_hash = data_hash, .delivered = now};
+  return true;
+}
+
+void LeScanningDuplicateFilter::Clear() {
+  std::fill(table_.begin(), table_.end(), Entry{});
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth::hci {
+
+/// The LE Scanning duplicate filter drops the advertising reports repeating
+/// the last report delivered for the same advertiser, within a configurable
+/// time window, so that dense environments do not flood the upper layers
+/// with identical reports.
+///
+/// Advertisers are identified by their address, address type and SID, and
+/// the reports compared by a hash of their event type and data; RSSI changes
+/// alone do not make a report new. The advertisers are tracked in a fixed
+/// size open addressing table: when the table is full the oldest advertiser
+/// in the probed slots is forgotten, hence its next report is delivered.
+class LeScanningDuplicateFilter {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit LeScanningDuplicateFilter(size_t capacity = kDefaultCapacity);
+
+  LeScanningDuplicateFilter(const LeScanningDuplicateFilter&) = delete;
+
+  LeScanningDuplicateFilter& operator=(const LeScanningDuplicateFilter&) = delete;
+
+  /// Configure the time window in which repeated reports are dropped.
+  /// A zero window disables the filter.
+  void SetWindow(std::chrono::milliseconds window) {
+    window_ = window;
+  }
+
+  bool IsEnabled() const {
+    return window_.count() > 0;
+  }
+
+  /// Returns true if the complete advertising report should be delivered,
+  /// false if it repeats the last report delivered for the same advertiser
+  /// less than the configured window ago.
+  bool Accept(
+      Clock::time_point now,
+      uint16_t event_type,
+      uint8_t address_type,
+      Address address,
+      uint8_t advertising_sid,
+      const std::vector<uint8_t>& advertising_data);
+
+  /// Forget all the advertisers, e.g. when a new scan is started.
+  void Clear();
+
+ private:
+  static constexpr size_t kDefaultCapacity = 1024;
+  /// Number of slots probed from the hash of an advertiser.
+  static constexpr size_t kMaxProbes = 8;
+
+  struct Entry {
+    /// Advertiser address, address type and SID, 0 for an empty slot.
+    uint64_t key;
+    uint64_t data_hash;
+    Clock::time_point delivered;
+  };
+
+  static uint64_t MakeKey(uint8_t address_type, const Address& address, uint8_t advertising_sid);
+  static uint64_t HashData(uint16_t event_type, const std::vector<uint8_t>& advertising_data);
+
+  std::vector<Entry> table_;
+  size_t mask_;
+  std::chrono::milliseconds window_{0};
+};
+
+}  // namespace bluetooth::hci
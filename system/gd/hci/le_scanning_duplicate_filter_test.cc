@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_duplicate_filter.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+// Event type fields.
+static constexpr uint16_t kConnectable = 0x1;
+static constexpr uint16_t kLegacy = 0x10;
+
+// Defaults for other fields.
+static constexpr uint8_t kPublicAddress = 0x0;
+static constexpr uint8_t kRandomAddress = 0x1;
+static constexpr uint8_t kSidNotPresent = 0xff;
+
+// Test addresses.
+static const Address kTestAddress1 = Address({0, 1, 2, 3, 4, 5});
+static const Address kTestAddress2 = Address({0, 1, 2, 3, 4, 6});
+
+class LeScanningDuplicateFilterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    filter_.SetWindow(1000ms);
+  }
+
+  bool Accept(
+      std::chrono::milliseconds time,
+      const Address& address,
+      const std::vector<uint8_t>& data,
+      uint8_t address_type = kPublicAddress,
+      uint8_t sid = kSidNotPresent) {
+    return filter_.Accept(start_ + time, kConnectable | kLegacy, address_type, address, sid, data);
+  }
+
+  LeScanningDuplicateFilter filter_;
+  LeScanningDuplicateFilter::Clock::time_point start_{LeScanningDuplicateFilter::Clock::now()};
+};
+
+TEST_F(LeScanningDuplicateFilterTest, disabled) {
+  filter_.SetWindow(0ms);
+  ASSERT_FALSE(filter_.IsEnabled());
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}));
+}
+
+TEST_F(LeScanningDuplicateFilterTest, drop_repeated_report_in_window) {
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_FALSE(Accept(10ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_FALSE(Accept(999ms, kTestAddress1, {0x1, 0x2}));
+  // The window starts at the last delivered report.
+  ASSERT_TRUE(Accept(1000ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_FALSE(Accept(1500ms, kTestAddress1, {0x1, 0x2}));
+}
+
+TEST_F(LeScanningDuplicateFilterTest, deliver_changed_data) {
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_TRUE(Accept(10ms, kTestAddress1, {0x1, 0x3}));
+  ASSERT_FALSE(Accept(20ms, kTestAddress1, {0x1, 0x3}));
+  ASSERT_TRUE(Accept(30ms, kTestAddress1, {0x1, 0x2}));
+}
+
+TEST_F(LeScanningDuplicateFilterTest, advertisers_are_independent) {
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_TRUE(Accept(0ms, kTestAddress2, {0x1, 0x2}));
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}, kRandomAddress));
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}, kPublicAddress, 0x1));
+  ASSERT_FALSE(Accept(10ms, kTestAddress1, {0x1, 0x2}));
+  ASSERT_FALSE(Accept(10ms, kTestAddress2, {0x1, 0x2}));
+  ASSERT_FALSE(Accept(10ms, kTestAddress1, {0x1, 0x2}, kRandomAddress));
+  ASSERT_FALSE(Accept(10ms, kTestAddress1, {0x1, 0x2}, kPublicAddress, 0x1));
+}
+
+TEST_F(LeScanningDuplicateFilterTest, clear) {
+  ASSERT_TRUE(Accept(0ms, kTestAddress1, {0x1, 0x2}));
+  filter_.Clear();
+  ASSERT_TRUE(Accept(10ms, kTestAddress1, {0x1, 0x2}));
+}
+
+TEST_F(LeScanningDuplicateFilterTest, more_advertisers_than_capacity) {
+  LeScanningDuplicateFilter filter(16);
+  filter.SetWindow(1000ms);
+  auto address = [](uint8_t i) { return Address({i, 0, 0, 0, 0, 0}); };
+
+  // Every new advertiser is delivered, even when the table is full.
+  for (uint8_t i = 0; i < 64; i++) {
+    ASSERT_TRUE(
+        filter.Accept(start_, kConnectable, kPublicAddress, address(i), kSidNotPresent, {}));
+  }
+  // The last advertiser is still tracked.
+  ASSERT_FALSE(
+      filter.Accept(start_ + 1ms, kConnectable, kPublicAddress, address(63), kSidNotPresent, {}));
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,419 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/le_scanning_host_filter.h"
+
+#include <bluetooth/log.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace bluetooth::hci {
+
+namespace {
+// GAP AD types matched by the filters.
+constexpr uint8_t kIncomplete16BitUuids = 0x02;
+constexpr uint8_t kComplete16BitUuids = 0x03;
+constexpr uint8_t kIncomplete32BitUuids = 0x04;
+constexpr uint8_t kComplete32BitUuids = 0x05;
+constexpr uint8_t kIncomplete128BitUuids = 0x06;
+constexpr uint8_t kComplete128BitUuids = 0x07;
+constexpr uint8_t kShortenedLocalName = 0x08;
+constexpr uint8_t kCompleteLocalName = 0x09;
+constexpr uint8_t kSolicitation16BitUuids = 0x14;
+constexpr uint8_t kSolicitation128BitUuids = 0x15;
+constexpr uint8_t kServiceData16BitUuid = 0x16;
+constexpr uint8_t kSolicitation32BitUuids = 0x1f;
+constexpr uint8_t kServiceData32BitUuid = 0x20;
+constexpr uint8_t kServiceData128BitUuid = 0x21;
+constexpr uint8_t kManufacturerSpecificData = 0xff;
+
+constexpr uint8_t kFilterLogicOr = 0x00;
+
+bool MatchPattern(
+    const std::vector<uint8_t>& pattern,
+    const std::vector<uint8_t>& mask,
+    const uint8_t* data,
+    size_t length) {
+  if (length < pattern.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < pattern.size(); i++) {
+    if ((data[i] & mask[i]) != (pattern[i] & mask[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Full mask of the pattern if none was configured.
+std::vector<uint8_t> GetMask(const std::vector<uint8_t>& data, const std::vector<uint8_t>& mask) {
+  return mask.size() == data.size() ? mask : std::vector<uint8_t>(data.size(), 0xff);
+}
+}  // namespace
+
+size_t LeScanningHostFilter::UuidHash::operator()(const Uuid::UUID128Bit& uuid) const {
+  // The short UUIDs only differ by bytes 12 to 15 of the little endian form.
+  uint64_t low;
+  uint64_t high;
+  std::memcpy(&low, uuid.data(), sizeof(low));
+  std::memcpy(&high, uuid.data() + sizeof(low), sizeof(high));
+  return std::hash<uint64_t>{}(high ^ (low * 0x9e3779b97f4a7c15ULL));
+}
+
+bool LeScanningHostFilter::AddParameters(
+    uint8_t filter_index, const AdvertisingFilterParameter& parameter) {
+  auto filter = filters_.find(filter_index);
+  if (filter == filters_.end() && filters_.size() >= kMaxFilters) {
+    log::warn("Too many host filters, ignoring filter index {}", filter_index);
+    return false;
+  }
+
+  Filter& entry = filters_[filter_index];
+  entry.has_parameter = true;
+  entry.parameter = parameter;
+  Compile();
+  return true;
+}
+
+void LeScanningHostFilter::DeleteParameters(uint8_t filter_index) {
+  if (filters_.erase(filter_index) > 0) {
+    Compile();
+  }
+}
+
+void LeScanningHostFilter::ClearParameters() {
+  filters_.clear();
+  Compile();
+}
+
+void LeScanningHostFilter::AddConditions(
+    uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& conditions) {
+  auto filter = filters_.find(filter_index);
+  if (filter == filters_.end() && filters_.size() >= kMaxFilters) {
+    log::warn("Too many host filters, ignoring filter index {}", filter_index);
+    return;
+  }
+
+  Filter& entry = filters_[filter_index];
+  entry.conditions.insert(entry.conditions.end(), conditions.begin(), conditions.end());
+  if (entry.has_parameter) {
+    Compile();
+  }
+}
+
+LeScanningHostFilter::Condition LeScanningHostFilter::AddCondition(
+    uint8_t slot, ApcfFilterType filter_type) {
+  uint8_t feature = static_cast<uint8_t>(filter_type);
+  slots_[slot].conditions[feature]++;
+  return Condition{.id = num_conditions_++, .slot = slot, .feature = feature};
+}
+
+void LeScanningHostFilter::CompileUuid(
+    uint8_t slot, const AdvertisingPacketContentFilterCommand& command) {
+  Condition condition = AddCondition(slot, command.filter_type);
+  Uuid::UUID128Bit uuid = command.uuid.To128BitLE();
+
+  if (command.uuid_mask.IsEmpty()) {
+    UuidTable& table = command.filter_type == ApcfFilterType::SERVICE_UUID ? service_uuids_
+                                                                            : solicitation_uuids_;
+    table[uuid].push_back(condition);
+    return;
+  }
+
+  // The mask applies to the shortest representation of the UUID, the
+  // remaining bytes of the base UUID always have to match.
+  Uuid::UUID128Bit mask;
+  mask.fill(0xff);
+  Uuid::UUID128Bit uuid_mask = command.uuid_mask.To128BitLE();
+  size_t uuid_len = command.uuid.GetShortestRepresentationSize();
+  if (uuid_len == Uuid::kNumBytes128) {
+    mask = uuid_mask;
+  } else {
+    // 16 and 32-bit masks are expanded from the base UUID as well.
+    std::copy(uuid_mask.begin() + 12, uuid_mask.begin() + 12 + uuid_len, mask.begin() + 12);
+  }
+  masked_uuids_.push_back({.condition = condition, .uuid = uuid, .mask = mask});
+}
+
+/// Rebuild all the lookup tables. This only happens when the filters are
+/// configured, usually when a scan is started.
+void LeScanningHostFilter::Compile() {
+  slots_.clear();
+  num_conditions_ = 0;
+  addresses_.clear();
+  service_uuids_.clear();
+  solicitation_uuids_.clear();
+  masked_uuids_.clear();
+  local_names_.clear();
+  manufacturer_data_.clear();
+  masked_manufacturer_data_.clear();
+  service_data_.clear();
+  masked_service_data_.clear();
+  ad_types_.clear();
+
+  for (const auto& [filter_index, filter] : filters_) {
+    if (!filter.has_parameter) {
+      continue;
+    }
+
+    uint8_t slot = slots_.size();
+    slots_.push_back(Slot{
+        .feature_selection = filter.parameter.feature_selection,
+        .list_logic_type = filter.parameter.list_logic_type,
+        .filter_logic_type = filter.parameter.filter_logic_type,
+        .rssi_threshold = static_cast<int8_t>(filter.parameter.rssi_high_thresh),
+        .conditions = {},
+    });
+
+    for (const AdvertisingPacketContentFilterCommand& command : filter.conditions) {
+      switch (command.filter_type) {
+        case ApcfFilterType::BROADCASTER_ADDRESS:
+          addresses_[command.address].push_back(AddCondition(slot, command.filter_type));
+          break;
+        case ApcfFilterType::SERVICE_UUID:
+        case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+          CompileUuid(slot, command);
+          break;
+        case ApcfFilterType::LOCAL_NAME:
+          local_names_.push_back(
+              {.condition = AddCondition(slot, command.filter_type),
+               .data = command.name,
+               .mask = std::vector<uint8_t>(command.name.size(), 0xff)});
+          break;
+        case ApcfFilterType::MANUFACTURER_DATA: {
+          DataCondition data{
+              .condition = AddCondition(slot, command.filter_type),
+              .data = command.data,
+              .mask = GetMask(command.data, command.data_mask)};
+          if (command.company_mask == 0 || command.company_mask == 0xffff) {
+            manufacturer_data_[command.company].push_back(std::move(data));
+          } else {
+            masked_manufacturer_data_.push_back(
+                {.data = std::move(data), .company = command.company, .mask = command.company_mask});
+          }
+          break;
+        }
+        case ApcfFilterType::SERVICE_DATA: {
+          // The service data pattern starts with the service UUID.
+          DataCondition data{
+              .condition = AddCondition(slot, command.filter_type),
+              .data = command.data,
+              .mask = GetMask(command.data, command.data_mask)};
+          if (data.data.size() >= Uuid::kNumBytes16 && data.mask[0] == 0xff && data.mask[1] == 0xff) {
+            uint16_t uuid = data.data[0] | (data.data[1] << 8);
+            service_data_[uuid].push_back(std::move(data));
+          } else {
+            masked_service_data_.push_back(std::move(data));
+          }
+          break;
+        }
+        case ApcfFilterType::AD_TYPE:
+          ad_types_[command.ad_type].push_back(
+              {.condition = AddCondition(slot, command.filter_type),
+               .data = command.data,
+               .mask = GetMask(command.data, command.data_mask)});
+          break;
+        default:
+          // Not required for the filter index to match.
+          log::warn(
+              "Filter type {} is not emulated, ignoring the condition of filter index {}",
+              (uint16_t)command.filter_type,
+              filter_index);
+          break;
+      }
+    }
+  }
+
+  matched_.assign(num_conditions_, false);
+  matched_counts_.assign(slots_.size(), {});
+}
+
+void LeScanningHostFilter::Match(const Condition& condition) {
+  if (!matched_[condition.id]) {
+    matched_[condition.id] = true;
+    matched_counts_[condition.slot][condition.feature]++;
+  }
+}
+
+void LeScanningHostFilter::MatchData(
+    const std::vector<DataCondition>& conditions, const uint8_t* data, size_t length) {
+  for (const DataCondition& condition : conditions) {
+    if (MatchPattern(condition.data, condition.mask, data, length)) {
+      Match(condition.condition);
+    }
+  }
+}
+
+void LeScanningHostFilter::MatchUuid(ApcfFilterType filter_type, const Uuid::UUID128Bit& uuid) {
+  const UuidTable& table =
+      filter_type == ApcfFilterType::SERVICE_UUID ? service_uuids_ : solicitation_uuids_;
+  auto conditions = table.find(uuid);
+  if (conditions != table.end()) {
+    for (const Condition& condition : conditions->second) {
+      Match(condition);
+    }
+  }
+
+  for (const MaskedUuidCondition& condition : masked_uuids_) {
+    if (condition.condition.feature != static_cast<uint8_t>(filter_type)) {
+      continue;
+    }
+    bool match = true;
+    for (size_t i = 0; i < Uuid::kNumBytes128 && match; i++) {
+      match = (uuid[i] & condition.mask[i]) == (condition.uuid[i] & condition.mask[i]);
+    }
+    if (match) {
+      Match(condition.condition);
+    }
+  }
+}
+
+bool LeScanningHostFilter::Accept(
+    const Address& address, int8_t rssi, const std::vector<uint8_t>& advertising_data) {
+  if (!IsEnabled()) {
+    return true;
+  }
+
+  std::fill(matched_.begin(), matched_.end(), false);
+  std::fill(matched_counts_.begin(), matched_counts_.end(), std::array<uint8_t, kNumFeatures>{});
+
+  auto address_conditions = addresses_.find(address);
+  if (address_conditions != addresses_.end()) {
+    for (const Condition& condition : address_conditions->second) {
+      Match(condition);
+    }
+  }
+
+  // Walk the GAP Data entries once, matching each against the lookup tables.
+  for (size_t offset = 0; offset + 1 < advertising_data.size();) {
+    uint8_t entry_size = advertising_data[offset];
+    if (entry_size == 0 || offset + 1 + entry_size > advertising_data.size()) {
+      break;
+    }
+
+    uint8_t ad_type = advertising_data[offset + 1];
+    const uint8_t* data = advertising_data.data() + offset + 2;
+    size_t length = entry_size - 1;
+    offset += entry_size + 1;
+
+    switch (ad_type) {
+      case kIncomplete16BitUuids:
+      case kComplete16BitUuids:
+      case kSolicitation16BitUuids:
+        for (size_t i = 0; i + Uuid::kNumBytes16 <= length; i += Uuid::kNumBytes16) {
+          MatchUuid(
+              ad_type == kSolicitation16BitUuids ? ApcfFilterType::SERVICE_SOLICITATION_UUID
+                                                 : ApcfFilterType::SERVICE_UUID,
+              Uuid::From16Bit(data[i] | (data[i + 1] << 8)).To128BitLE());
+        }
+        break;
+      case kIncomplete32BitUuids:
+      case kComplete32BitUuids:
+      case kSolicitation32BitUuids:
+        for (size_t i = 0; i + Uuid::kNumBytes32 <= length; i += Uuid::kNumBytes32) {
+          uint32_t uuid = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) |
+                          ((uint32_t)data[i + 3] << 24);
+          MatchUuid(
+              ad_type == kSolicitation32BitUuids ? ApcfFilterType::SERVICE_SOLICITATION_UUID
+                                                 : ApcfFilterType::SERVICE_UUID,
+              Uuid::From32Bit(uuid).To128BitLE());
+        }
+        break;
+      case kIncomplete128BitUuids:
+      case kComplete128BitUuids:
+      case kSolicitation128BitUuids:
+        for (size_t i = 0; i + Uuid::kNumBytes128 <= length; i += Uuid::kNumBytes128) {
+          MatchUuid(
+              ad_type == kSolicitation128BitUuids ? ApcfFilterType::SERVICE_SOLICITATION_UUID
+                                                  : ApcfFilterType::SERVICE_UUID,
+              Uuid::From128BitLE(data + i).To128BitLE());
+        }
+        break;
+      case kShortenedLocalName:
+      case kCompleteLocalName:
+        MatchData(local_names_, data, length);
+        break;
+      case kManufacturerSpecificData:
+        if (length >= 2) {
+          uint16_t company = data[0] | (data[1] << 8);
+          auto conditions = manufacturer_data_.find(company);
+          if (conditions != manufacturer_data_.end()) {
+            MatchData(conditions->second, data + 2, length - 2);
+          }
+          for (const MaskedCompanyCondition& condition : masked_manufacturer_data_) {
+            if ((company & condition.mask) == (condition.company & condition.mask) &&
+                MatchPattern(condition.data.data, condition.data.mask, data + 2, length - 2)) {
+              Match(condition.data.condition);
+            }
+          }
+        }
+        break;
+      case kServiceData16BitUuid:
+        if (length >= 2) {
+          auto conditions = service_data_.find(data[0] | (data[1] << 8));
+          if (conditions != service_data_.end()) {
+            MatchData(conditions->second, data, length);
+          }
+        }
+        MatchData(masked_service_data_, data, length);
+        break;
+      case kServiceData32BitUuid:
+      case kServiceData128BitUuid:
+        MatchData(masked_service_data_, data, length);
+        break;
+      default:
+        break;
+    }
+
+    auto ad_type_conditions = ad_types_.find(ad_type);
+    if (ad_type_conditions != ad_types_.end()) {
+      MatchData(ad_type_conditions->second, data, length);
+    }
+  }
+
+  for (size_t slot = 0; slot < slots_.size(); slot++) {
+    const Slot& filter = slots_[slot];
+    if (rssi < filter.rssi_threshold) {
+      continue;
+    }
+
+    bool any_selected = false;
+    bool any_match = false;
+    bool all_match = true;
+    for (size_t feature = 0; feature < kNumFeatures; feature++) {
+      if (!(filter.feature_selection & (1 << feature)) || filter.conditions[feature] == 0) {
+        continue;
+      }
+      // The list logic tells if any or all the conditions of the feature
+      // have to match.
+      bool match = (filter.list_logic_type & (1 << feature))
+                       ? matched_counts_[slot][feature] == filter.conditions[feature]
+                       : matched_counts_[slot][feature] > 0;
+      any_selected = true;
+      any_match |= match;
+      all_match &= match;
+    }
+
+    // A filter without selected conditions accepts all the reports.
+    if (!any_selected ||
+        (filter.filter_logic_type == kFilterLogicOr ? any_match : all_match)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/le_scanning_callback.h"
+#include "hci/uuid.h"
+
+namespace bluetooth::hci {
+
+/// The LE Scanning host filter emulates the advertising packet content
+/// filters (APCF) on the host, for the controllers which do not support the
+/// vendor specific APCF commands.
+///
+/// The filters are configured with the same parameters and conditions as the
+/// controller filters, and compiled into lookup tables shared by all the
+/// filter indices whenever they change: broadcaster addresses, UUIDs,
+/// manufacturer company identifiers, 16-bit service data UUIDs and AD types
+/// are looked up by key, only the masked conditions are compared one by one.
+/// A complete advertising report is then parsed once and matched against all
+/// the filters.
+///
+/// A report is accepted when it matches any of the configured filter
+/// indices. The delivery mode and the found / lost tracking are not
+/// emulated: all the matching reports are delivered immediately.
+class LeScanningHostFilter {
+ public:
+  /// Maximum number of filter indices.
+  static constexpr size_t kMaxFilters = 64;
+
+  LeScanningHostFilter() = default;
+
+  LeScanningHostFilter(const LeScanningHostFilter&) = delete;
+
+  LeScanningHostFilter& operator=(const LeScanningHostFilter&) = delete;
+
+  void SetEnabled(bool enable) {
+    enabled_ = enable;
+  }
+
+  /// Returns true when the reports have to be matched against the filters.
+  /// The host filter is transparent while no filter is configured.
+  bool IsEnabled() const {
+    return enabled_ && !slots_.empty();
+  }
+
+  /// Equivalent of the APCF filtering parameters commands. A filter index is
+  /// applied once its parameters are added, the conditions can be added
+  /// before or after. Deleting the parameters also deletes the conditions.
+  /// Returns false if the filter index could not be added.
+  bool AddParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameter);
+  void DeleteParameters(uint8_t filter_index);
+  void ClearParameters();
+
+  /// Equivalent of the APCF condition commands with the ADD action.
+  void AddConditions(
+      uint8_t filter_index, const std::vector<AdvertisingPacketContentFilterCommand>& conditions);
+
+  /// Returns true if the complete advertising report matches any filter.
+  bool Accept(const Address& address, int8_t rssi, const std::vector<uint8_t>& advertising_data);
+
+ private:
+  /// APCF features, in the order of the feature selection bits.
+  static constexpr size_t kNumFeatures = 9;
+
+  struct Filter {
+    bool has_parameter{false};
+    AdvertisingFilterParameter parameter;
+    std::vector<AdvertisingPacketContentFilterCommand> conditions;
+  };
+
+  /// Reference from a lookup table to a compiled condition.
+  struct Condition {
+    uint16_t id;
+    uint8_t slot;
+    uint8_t feature;
+  };
+
+  /// Compiled condition comparing a masked pattern with the beginning of
+  /// some advertising data.
+  struct DataCondition {
+    Condition condition;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> mask;
+  };
+
+  struct MaskedUuidCondition {
+    Condition condition;
+    Uuid::UUID128Bit uuid;
+    Uuid::UUID128Bit mask;
+  };
+
+  struct MaskedCompanyCondition {
+    DataCondition data;
+    uint16_t company;
+    uint16_t mask;
+  };
+
+  /// Filter index state, in compiled slot order.
+  struct Slot {
+    uint16_t feature_selection;
+    uint16_t list_logic_type;
+    uint8_t filter_logic_type;
+    int8_t rssi_threshold;
+    /// Number of compiled conditions of each selected feature.
+    std::array<uint8_t, kNumFeatures> conditions;
+  };
+
+  struct UuidHash {
+    size_t operator()(const Uuid::UUID128Bit& uuid) const;
+  };
+
+  using UuidTable = std::unordered_map<Uuid::UUID128Bit, std::vector<Condition>, UuidHash>;
+
+  /// Rebuild the lookup tables from the filters.
+  void Compile();
+  Condition AddCondition(uint8_t slot, ApcfFilterType filter_type);
+  void CompileUuid(uint8_t slot, const AdvertisingPacketContentFilterCommand& command);
+
+  void MatchUuid(ApcfFilterType filter_type, const Uuid::UUID128Bit& uuid);
+  void MatchData(const std::vector<DataCondition>& conditions, const uint8_t* data, size_t length);
+  void Match(const Condition& condition);
+
+  bool enabled_{false};
+  std::map<uint8_t, Filter> filters_;
+
+  /// Compiled filters.
+  std::vector<Slot> slots_;
+  uint16_t num_conditions_{0};
+  std::unordered_map<Address, std::vector<Condition>> addresses_;
+  UuidTable service_uuids_;
+  UuidTable solicitation_uuids_;
+  std::vector<MaskedUuidCondition> masked_uuids_;
+  std::vector<DataCondition> local_names_;
+  std::unordered_map<uint16_t, std::vector<DataCondition>> manufacturer_data_;
+  std::vector<MaskedCompanyCondition> masked_manufacturer_data_;
+  std::unordered_map<uint16_t, std::vector<DataCondition>> service_data_;
+  std::vector<DataCondition> masked_service_data_;
+  std::unordered_map<uint8_t, std::vector<DataCondition>> ad_types_;
+
+  /// Per report match state, kept to avoid reallocating.
+  std::vector<bool> matched_;
+  std::vector<std::array<uint8_t, kNumFeatures>> matched_counts_;
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_scanning_host_filter.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth::hci {
+
+// Feature selection bits.
+static constexpr uint16_t kAddressFeature = 1 << 0;
+static constexpr uint16_t kServiceUuidFeature = 1 << 2;
+static constexpr uint16_t kLocalNameFeature = 1 << 4;
+static constexpr uint16_t kManufacturerDataFeature = 1 << 5;
+static constexpr uint16_t kServiceDataFeature = 1 << 6;
+static constexpr uint16_t kAdTypeFeature = 1 << 8;
+
+static constexpr uint8_t kFilterLogicOr = 0x00;
+static constexpr uint8_t kFilterLogicAnd = 0x01;
+static constexpr uint8_t kLowestRssiValue = 129;
+
+// Test addresses.
+static const Address kTestAddress1 = Address({0, 1, 2, 3, 4, 5});
+static const Address kTestAddress2 = Address({0, 1, 2, 3, 4, 6});
+
+// Test advertising data.
+static const std::vector<uint8_t> kNameData = {0x5, 0x09, 't', 'e', 's', 't'};
+static const std::vector<uint8_t> kUuidData = {0x3, 0x03, 0x0d, 0x18};
+static const std::vector<uint8_t> kManufacturerData = {0x5, 0xff, 0xe0, 0x00, 0x1, 0x2};
+static const std::vector<uint8_t> kServiceData = {0x5, 0x16, 0x0d, 0x18, 0x3, 0x4};
+
+class LeScanningHostFilterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    filter_.SetEnabled(true);
+  }
+
+  void AddFilter(
+      uint8_t filter_index,
+      uint16_t feature_selection,
+      std::vector<AdvertisingPacketContentFilterCommand> conditions,
+      uint8_t filter_logic_type = kFilterLogicAnd,
+      uint16_t list_logic_type = 0,
+      uint8_t rssi_threshold = kLowestRssiValue) {
+    AdvertisingFilterParameter parameter{};
+    parameter.feature_selection = feature_selection;
+    parameter.list_logic_type = list_logic_type;
+    parameter.filter_logic_type = filter_logic_type;
+    parameter.rssi_high_thresh = rssi_threshold;
+    parameter.delivery_mode = DeliveryMode::IMMEDIATE;
+    filter_.AddConditions(filter_index, conditions);
+    ASSERT_TRUE(filter_.AddParameters(filter_index, parameter));
+  }
+
+  static AdvertisingPacketContentFilterCommand Condition(ApcfFilterType filter_type) {
+    AdvertisingPacketContentFilterCommand command{};
+    command.filter_type = filter_type;
+    return command;
+  }
+
+  static std::vector<uint8_t> Concat(std::vector<std::vector<uint8_t>> entries) {
+    std::vector<uint8_t> data;
+    for (auto& entry : entries) {
+      data.insert(data.end(), entry.begin(), entry.end());
+    }
+    return data;
+  }
+
+  LeScanningHostFilter filter_;
+};
+
+TEST_F(LeScanningHostFilterTest, transparent_without_filters) {
+  ASSERT_FALSE(filter_.IsEnabled());
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kNameData));
+
+  auto condition = Condition(ApcfFilterType::LOCAL_NAME);
+  condition.name = {'n', 'o', 'n', 'e'};
+  AddFilter(0, kLocalNameFeature, {condition});
+  filter_.SetEnabled(false);
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kNameData));
+}
+
+TEST_F(LeScanningHostFilterTest, all_pass_filter) {
+  AddFilter(0, 0, {});
+  ASSERT_TRUE(filter_.IsEnabled());
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, {}));
+}
+
+TEST_F(LeScanningHostFilterTest, address) {
+  auto condition = Condition(ApcfFilterType::BROADCASTER_ADDRESS);
+  condition.address = kTestAddress1;
+  AddFilter(0, kAddressFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, {}));
+  ASSERT_FALSE(filter_.Accept(kTestAddress2, -50, {}));
+}
+
+TEST_F(LeScanningHostFilterTest, service_uuid) {
+  auto condition = Condition(ApcfFilterType::SERVICE_UUID);
+  condition.uuid = Uuid::From16Bit(0x180d);
+  AddFilter(0, kServiceUuidFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, Concat({kNameData, kUuidData})));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x3, 0x03, 0x0f, 0x18}));
+  // Solicitation UUIDs are a different feature.
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x3, 0x14, 0x0d, 0x18}));
+}
+
+TEST_F(LeScanningHostFilterTest, masked_service_uuid) {
+  auto condition = Condition(ApcfFilterType::SERVICE_UUID);
+  condition.uuid = Uuid::From16Bit(0x1800);
+  condition.uuid_mask = Uuid::From16Bit(0xff00);
+  AddFilter(0, kServiceUuidFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kUuidData));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x3, 0x03, 0x0d, 0x19}));
+}
+
+TEST_F(LeScanningHostFilterTest, local_name) {
+  auto condition = Condition(ApcfFilterType::LOCAL_NAME);
+  condition.name = {'t', 'e'};
+  AddFilter(0, kLocalNameFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kNameData));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x3, 0x09, 't', 'a'}));
+}
+
+TEST_F(LeScanningHostFilterTest, manufacturer_data) {
+  auto condition = Condition(ApcfFilterType::MANUFACTURER_DATA);
+  condition.company = 0x00e0;
+  condition.data = {0x1, 0x0};
+  condition.data_mask = {0xff, 0x0};
+  AddFilter(0, kManufacturerDataFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kManufacturerData));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x5, 0xff, 0xe1, 0x00, 0x1, 0x2}));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x5, 0xff, 0xe0, 0x00, 0x2, 0x2}));
+  // The advertised data is shorter than the pattern.
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x4, 0xff, 0xe0, 0x00, 0x1}));
+}
+
+TEST_F(LeScanningHostFilterTest, service_data) {
+  auto condition = Condition(ApcfFilterType::SERVICE_DATA);
+  condition.data = {0x0d, 0x18, 0x3};
+  AddFilter(0, kServiceDataFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kServiceData));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, {0x5, 0x16, 0x0d, 0x18, 0x4, 0x4}));
+}
+
+TEST_F(LeScanningHostFilterTest, ad_type) {
+  auto condition = Condition(ApcfFilterType::AD_TYPE);
+  condition.ad_type = 0x2e;
+  AddFilter(0, kAdTypeFeature, {condition});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, Concat({kNameData, {0x2, 0x2e, 0x1}})));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, kNameData));
+}
+
+TEST_F(LeScanningHostFilterTest, filter_logic) {
+  auto name = Condition(ApcfFilterType::LOCAL_NAME);
+  name.name = {'t', 'e', 's', 't'};
+  auto uuid = Condition(ApcfFilterType::SERVICE_UUID);
+  uuid.uuid = Uuid::From16Bit(0x180d);
+
+  AddFilter(0, kLocalNameFeature | kServiceUuidFeature, {name, uuid}, kFilterLogicAnd);
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, Concat({kNameData, kUuidData})));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, kNameData));
+
+  filter_.ClearParameters();
+  AddFilter(0, kLocalNameFeature | kServiceUuidFeature, {name, uuid}, kFilterLogicOr);
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kNameData));
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kUuidData));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, kManufacturerData));
+}
+
+TEST_F(LeScanningHostFilterTest, list_logic) {
+  auto uuid1 = Condition(ApcfFilterType::SERVICE_UUID);
+  uuid1.uuid = Uuid::From16Bit(0x180d);
+  auto uuid2 = Condition(ApcfFilterType::SERVICE_UUID);
+  uuid2.uuid = Uuid::From16Bit(0x180f);
+  std::vector<uint8_t> both_uuids = {0x5, 0x03, 0x0d, 0x18, 0x0f, 0x18};
+
+  // Any of the UUIDs.
+  AddFilter(0, kServiceUuidFeature, {uuid1, uuid2});
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, kUuidData));
+
+  // All the UUIDs.
+  filter_.DeleteParameters(0);
+  AddFilter(0, kServiceUuidFeature, {uuid1, uuid2}, kFilterLogicAnd, kServiceUuidFeature);
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -50, kUuidData));
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, both_uuids));
+}
+
+TEST_F(LeScanningHostFilterTest, rssi_threshold) {
+  AddFilter(0, 0, {}, kFilterLogicAnd, 0, static_cast<uint8_t>(-60));
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, {}));
+  ASSERT_FALSE(filter_.Accept(kTestAddress1, -70, {}));
+}
+
+TEST_F(LeScanningHostFilterTest, any_filter_index) {
+  auto address = Condition(ApcfFilterType::BROADCASTER_ADDRESS);
+  address.address = kTestAddress1;
+  auto name = Condition(ApcfFilterType::LOCAL_NAME);
+  name.name = {'t', 'e', 's', 't'};
+  AddFilter(1, kAddressFeature, {address});
+  AddFilter(2, kLocalNameFeature, {name});
+
+  ASSERT_TRUE(filter_.Accept(kTestAddress1, -50, {}));
+  ASSERT_TRUE(filter_.Accept(kTestAddress2, -50, kNameData));
+  ASSERT_FALSE(filter_.Accept(kTestAddress2, -50, kUuidData));
+
+  filter_.DeleteParameters(2);
+  ASSERT_FALSE(filter_.Accept(kTestAddress2, -50, kNameData));
+}
+
+}  // namespace bluetooth::hci
@@ -27,6 +27,8 @@
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
 #include "hci/le_periodic_sync_manager.h"
+#include "hci/le_scanning_duplicate_filter.h"
+#include "hci/le_scanning_host_filter.h"
 #include "hci/le_scanning_interface.h"
 #include "hci/le_scanning_reassembler.h"
 #include "module.h"
@@ -61,6 +63,12 @@ constexpr uint8_t kDataStatusBits = 5;
 // system properties
 const std::string kLeRxPathLossCompProperty = "bluetooth.hardware.radio.le_rx_path_loss_comp_db";
 const std::string kPropertyDisableApcfExtendedFeatures = "bluetooth.le.disable_apcf_extended_features";
+// Window in which the reports repeating the last one of an advertiser are
+// dropped before reaching the upper layers, 0 to deliver all the reports.
+const std::string kPropertyScanDuplicateFilterWindowMs = "bluetooth.le.scan_duplicate_filter_window_ms";
+// Emulate the advertising packet content filters on the host when the
+// controller does not support them.
+const std::string kPropertyHostFilterEmulation = "bluetooth.le.host_filter_emulation";
 bool kDisableApcfExtendedFeatures = false;
 
 const ModuleFactory LeScanningManager::Factory = ModuleFactory([]() { return new LeScanningManager(); });
@@ -219,6 +227,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       api_type_ = ScanApiType::LEGACY;
     }
     is_filter_supported_ = controller_->IsSupported(OpCode::LE_ADV_FILTER);
+    is_host_filter_emulated_ =
+        !is_filter_supported_ && os::GetSystemPropertyBool(kPropertyHostFilterEmulation, false);
     if (os::GetSystemProperty(kPropertyDisableApcfExtendedFeatures) == "1")
       kDisableApcfExtendedFeatures = true;
     if (is_filter_supported_ && !kDisableApcfExtendedFeatures) {
@@ -246,6 +256,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
     batch_scan_config_.ref_value = kInvalidScannerId;
     le_rx_path_loss_comp_ = get_rx_path_loss_compensation();
+    duplicate_filter_.SetWindow(std::chrono::milliseconds(
+        os::GetSystemPropertyUint32(kPropertyScanDuplicateFilterWindowMs, 0)));
   }
 
   void stop() {
@@ -355,13 +367,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       log::info("Dropping invalid advertising event");
       return;
     }
-    std::vector<LeAdvertisingResponseRaw> reports = event_view.GetResponses();
-    if (reports.empty()) {
+    event_view.GetResponses(advertising_reports_);
+    if (advertising_reports_.empty()) {
       log::info("Zero results in advertising event");
       return;
     }
 
-    for (LeAdvertisingResponseRaw report : reports) {
+    for (const LeAdvertisingResponseRaw& report : advertising_reports_) {
       uint16_t extended_event_type = 0;
       switch (report.event_type_) {
         case AdvertisingEventType::ADV_IND:
@@ -419,13 +431,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       return;
     }
 
-    std::vector<LeExtendedAdvertisingResponseRaw> reports = event_view.GetResponses();
-    if (reports.empty()) {
+    event_view.GetResponses(extended_advertising_reports_);
+    if (extended_advertising_reports_.empty()) {
       log::info("Zero results in advertising event");
       return;
     }
 
-    for (LeExtendedAdvertisingResponseRaw& report : reports) {
+    for (const LeExtendedAdvertisingResponseRaw& report : extended_advertising_reports_) {
       uint16_t event_type = report.connectable_ | (report.scannable_ << kScannableBit) |
                             (report.directed_ << kDirectedBit) | (report.scan_response_ << kScanResponseBit) |
                             (report.legacy_ << kLegacyBit) | ((uint16_t)report.data_status_ << kDataStatusBits);
@@ -469,6 +481,22 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
         scanning_reassembler_.ProcessAdvertisingReport(
             event_type, address_type, address, advertising_sid, advertising_data);
 
+    if (processed_report.has_value() && duplicate_filter_.IsEnabled() &&
+        !duplicate_filter_.Accept(
+            LeScanningDuplicateFilter::Clock::now(),
+            processed_report->extended_event_type,
+            address_type,
+            address,
+            advertising_sid,
+            processed_report->data)) {
+      return;
+    }
+
+    if (processed_report.has_value() && host_filter_.IsEnabled() &&
+        !host_filter_.Accept(address, get_rssi_after_calibration(rssi), processed_report->data)) {
+      return;
+    }
+
     if (processed_report.has_value()) {
       switch (address_type) {
         case (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS:
@@ -607,6 +635,8 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
       return;
     }
     is_scanning_ = true;
+    // Deliver the first report of every advertiser for each new scan
+    duplicate_filter_.Clear();
     if (!address_manager_registered_) {
       le_address_manager_->Register(this);
       address_manager_registered_ = true;
@@ -710,6 +740,10 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   }
 
   void scan_filter_enable(bool enable) {
+    if (is_host_filter_emulated_) {
+      host_filter_.SetEnabled(enable);
+      return;
+    }
     if (!is_filter_supported_) {
       log::warn("Advertising filter is not supported");
       return;
@@ -734,6 +768,23 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
 
   void scan_filter_parameter_setup(
       ApcfAction action, uint8_t filter_index, AdvertisingFilterParameter advertising_filter_parameter) {
+    if (is_host_filter_emulated_) {
+      switch (action) {
+        case ApcfAction::ADD:
+          host_filter_.AddParameters(filter_index, advertising_filter_parameter);
+          break;
+        case ApcfAction::DELETE:
+          host_filter_.DeleteParameters(filter_index);
+          break;
+        case ApcfAction::CLEAR:
+          host_filter_.ClearParameters();
+          break;
+        default:
+          log::error("Unknown action type: {}", (uint16_t)action);
+          break;
+      }
+      return;
+    }
     if (!is_filter_supported_) {
       log::warn("Advertising filter is not supported");
       return;
@@ -797,6 +848,10 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   }
 
   void scan_filter_add(uint8_t filter_index, std::vector<AdvertisingPacketContentFilterCommand> filters) {
+    if (is_host_filter_emulated_) {
+      host_filter_.AddConditions(filter_index, filters);
+      return;
+    }
     if (!is_filter_supported_) {
       log::warn("Advertising filter is not supported");
       return;
@@ -1717,7 +1772,13 @@ struct LeScanningManager::impl : public LeAddressManagerCallback {
   bool scan_on_resume_ = false;
   bool paused_ = false;
   LeScanningReassembler scanning_reassembler_;
+  LeScanningDuplicateFilter duplicate_filter_;
+  LeScanningHostFilter host_filter_;
+  // Reused for the reports of every advertising event, to keep their capacity
+  std::vector<LeAdvertisingResponseRaw> advertising_reports_;
+  std::vector<LeExtendedAdvertisingResponseRaw> extended_advertising_reports_;
   bool is_filter_supported_ = false;
+  bool is_host_filter_emulated_ = false;
   bool is_ad_type_filter_supported_ = false;
   bool is_batch_scan_supported_ = false;
   bool is_periodic_advertising_sync_transfer_sender_supported_ = false;
@@ -33,6 +33,16 @@
 
 namespace bluetooth::hci {
 
+LeScanningReassembler::LeScanningReassembler() {
+  for (AdvertisingFragment& fragment : cache_) {
+    fragment.data.reserve(kMaximumAdvertisingDataLength);
+  }
+  for (PeriodicAdvertisingFragment& fragment : periodic_cache_) {
+    fragment.data.reserve(kMaximumAdvertisingDataLength);
+  }
+  index_.fill(kEmptyIndex);
+}
+
 std::optional<LeScanningReassembler::CompleteAdvertisingData>
 LeScanningReassembler::ProcessAdvertisingReport(
     uint16_t event_type,
@@ -68,12 +78,11 @@ LeScanningReassembler::ProcessAdvertisingReport(
   }
 
   // Concatenate the data with existing fragments.
-  std::list<AdvertisingFragment>::iterator advertising_fragment =
-      AppendFragment(key, event_type, advertising_data);
+  AdvertisingFragment* advertising_fragment = AppendFragment(key, event_type, advertising_data);
 
   // Trim the advertising data when the complete payload is received.
   if (data_status != DataStatus::CONTINUING) {
-    advertising_fragment->data = TrimAdvertisingData(advertising_fragment->data);
+    TrimAdvertisingDataInPlace(advertising_fragment->data);
   }
 
   // TODO(b/272120114) waiting for a scan response here is prone to failure as the
@@ -91,18 +100,28 @@ LeScanningReassembler::ProcessAdvertisingReport(
 
   // Otherwise the full advertising report has been reassembled,
   // removed the cache entry and return the complete advertising data.
+  // The data is copied out to keep the slot storage.
   CompleteAdvertisingData result{
       .extended_event_type = advertising_fragment->extended_event_type,
-      .data = std::move(advertising_fragment->data)};
-  cache_.erase(advertising_fragment);
+      .data = advertising_fragment->data};
+  ReleaseFragment(advertising_fragment);
   return result;
 }
 
 std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessPeriodicAdvertisingReport(
     uint16_t sync_handle, DataStatus data_status, const std::vector<uint8_t>& advertising_data) {
+  PeriodicAdvertisingFragment* advertising_fragment = FindPeriodicFragment(sync_handle);
+
+  // Most periodic advertising data fits in a single report, and is
+  // returned without going through the cache.
+  if (advertising_fragment == nullptr && data_status != DataStatus::CONTINUING) {
+    std::vector<uint8_t> result = advertising_data;
+    TrimAdvertisingDataInPlace(result);
+    return result;
+  }
+
   // Concatenate the data with existing fragments.
-  std::list<PeriodicAdvertisingFragment>::iterator advertising_fragment =
-      AppendPeriodicFragment(sync_handle, advertising_data);
+  advertising_fragment = AppendPeriodicFragment(sync_handle, advertising_data);
 
   // Return and wait for additional fragments if the data is marked as
   // incomplete.
@@ -111,12 +130,23 @@ std::optional<std::vector<uint8_t>> LeScanningReassembler::ProcessPeriodicAdvert
   }
 
   // The complete payload has been received; trim the advertising data,
-  // remove the cache entry and return the complete advertising data.
-  std::vector<uint8_t> result = TrimAdvertisingData(advertising_fragment->data);
-  periodic_cache_.erase(advertising_fragment);
+  // release the cache entry and return the complete advertising data.
+  // The data is copied out to keep the slot storage.
+  TrimAdvertisingDataInPlace(advertising_fragment->data);
+  std::vector<uint8_t> result = advertising_fragment->data;
+  advertising_fragment->in_use = false;
+  advertising_fragment->data.clear();
   return result;
 }
 
+void LeScanningReassembler::RemovePeriodicFragment(uint16_t sync_handle) {
+  PeriodicAdvertisingFragment* fragment = FindPeriodicFragment(sync_handle);
+  if (fragment != nullptr) {
+    fragment->in_use = false;
+    fragment->data.clear();
+  }
+}
+
 /// Trim the advertising data by removing empty or overflowing
 /// GAP Data entries.
 std::vector<uint8_t> LeScanningReassembler::TrimAdvertisingData(
@@ -141,6 +171,28 @@ std::vector<uint8_t> LeScanningReassembler::TrimAdvertisingData(
   return significant_advertising_data;
 }
 
+void LeScanningReassembler::TrimAdvertisingDataInPlace(std::vector<uint8_t>& advertising_data) {
+  // The significant entries are moved to the front, the write offset never
+  // overtakes the read offset.
+  size_t write_offset = 0;
+  for (size_t offset = 0; offset < advertising_data.size();) {
+    size_t remaining_size = advertising_data.size() - offset;
+    uint8_t entry_size = advertising_data[offset];
+
+    if (entry_size != 0 && entry_size < remaining_size) {
+      std::copy(
+          advertising_data.begin() + offset,
+          advertising_data.begin() + offset + 1 + entry_size,
+          advertising_data.begin() + write_offset);
+      write_offset += entry_size + 1;
+    }
+
+    offset += entry_size + 1;
+  }
+
+  advertising_data.resize(write_offset);
+}
+
 LeScanningReassembler::AdvertisingKey::AdvertisingKey(
     Address address, DirectAdvertisingAddressType address_type, uint8_t sid)
     : address(), sid() {
@@ -159,84 +211,169 @@ bool LeScanningReassembler::AdvertisingKey::operator==(const AdvertisingKey& oth
   return address == other.address && sid == other.sid;
 }
 
+size_t LeScanningReassembler::AdvertisingKey::Hash() const {
+  uint64_t hash = 0;
+  if (address.has_value()) {
+    for (uint8_t byte : address->GetAddress().address) {
+      hash = (hash << 8) | byte;
+    }
+    hash |= (uint64_t)address->GetAddressType() << 48;
+    hash |= 1ULL << 56;
+  }
+  if (sid.has_value()) {
+    hash |= (uint64_t)sid.value() << 57;
+    hash |= 1ULL << 63;
+  }
+  // Mix the bits down, only the least significant bits index the table.
+  hash *= 0x9e3779b97f4a7c15ULL;
+  return hash ^ (hash >> 32);
+}
+
 /// Append to the current advertising data of the selected advertiser.
 /// If the advertiser is unknown a new entry is added, optionally by
 /// dropping the oldest advertiser.
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator
-LeScanningReassembler::AppendFragment(
+LeScanningReassembler::AdvertisingFragment* LeScanningReassembler::AppendFragment(
     const AdvertisingKey& key, uint16_t extended_event_type, const std::vector<uint8_t>& data) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
+  AdvertisingFragment* fragment = FindFragment(key);
+  if (fragment != nullptr) {
     // Legacy scan responses don't contain a 'connectable' bit, so this adds the
     // 'connectable' bit from the initial report.
     if ((extended_event_type & (1 << kLegacyBit)) &&
         (extended_event_type & (1 << kScanResponseBit))) {
-      it->extended_event_type =
-          extended_event_type | (it->extended_event_type & (1 << kConnectableBit));
+      fragment->extended_event_type =
+          extended_event_type | (fragment->extended_event_type & (1 << kConnectableBit));
     } else {
-      it->extended_event_type = extended_event_type;
+      fragment->extended_event_type = extended_event_type;
     }
-    it->data.insert(it->data.end(), data.cbegin(), data.cend());
-    return it;
+    fragment->data.insert(fragment->data.end(), data.cbegin(), data.cend());
+    return fragment;
   }
 
-  if (cache_.size() > kMaximumCacheSize) {
-    cache_.pop_back();
+  // Pick a free slot, or drop the oldest advertiser.
+  AdvertisingFragment* oldest = &cache_[0];
+  for (AdvertisingFragment& slot : cache_) {
+    if (!slot.in_use) {
+      fragment = &slot;
+      break;
+    }
+    if (slot.age < oldest->age) {
+      oldest = &slot;
+    }
+  }
+  if (fragment == nullptr) {
+    ReleaseFragment(oldest);
+    fragment = oldest;
   }
 
-  cache_.emplace_front(key, extended_event_type, data);
-  return cache_.begin();
+  fragment->in_use = true;
+  fragment->key = key;
+  fragment->key_hash = key.Hash();
+  fragment->age = next_age_++;
+  fragment->extended_event_type = extended_event_type;
+  fragment->data.assign(data.cbegin(), data.cend());
+
+  size_t position = fragment->key_hash % kIndexSize;
+  while (index_[position] != kEmptyIndex) {
+    position = (position + 1) % kIndexSize;
+  }
+  index_[position] = fragment - cache_.data();
+  return fragment;
 }
 
 void LeScanningReassembler::RemoveFragment(const AdvertisingKey& key) {
-  auto it = FindFragment(key);
-  if (it != cache_.end()) {
-    cache_.erase(it);
+  AdvertisingFragment* fragment = FindFragment(key);
+  if (fragment != nullptr) {
+    ReleaseFragment(fragment);
+  }
+}
+
+/// Release a used cache slot, keeping its data storage, and remove it from
+/// the index.
+void LeScanningReassembler::ReleaseFragment(AdvertisingFragment* fragment) {
+  size_t position = FindIndex(fragment->key, fragment->key_hash);
+  fragment->in_use = false;
+  fragment->data.clear();
+  if (position == kIndexSize) {
+    return;
+  }
+
+  // Shift back the following entries of the probe sequence that would not
+  // be found anymore past the removed entry.
+  index_[position] = kEmptyIndex;
+  for (size_t next = (position + 1) % kIndexSize; index_[next] != kEmptyIndex;
+       next = (next + 1) % kIndexSize) {
+    size_t home = cache_[index_[next]].key_hash % kIndexSize;
+    if ((next + kIndexSize - home) % kIndexSize >= (next + kIndexSize - position) % kIndexSize) {
+      index_[position] = index_[next];
+      index_[next] = kEmptyIndex;
+      position = next;
+    }
   }
 }
 
 bool LeScanningReassembler::ContainsFragment(const AdvertisingKey& key) {
-  return FindFragment(key) != cache_.end();
+  return FindFragment(key) != nullptr;
 }
 
-std::list<LeScanningReassembler::AdvertisingFragment>::iterator LeScanningReassembler::FindFragment(
+LeScanningReassembler::AdvertisingFragment* LeScanningReassembler::FindFragment(
     const AdvertisingKey& key) {
-  for (auto it = cache_.begin(); it != cache_.end(); it++) {
-    if (it->key == key) {
-      return it;
+  size_t position = FindIndex(key, key.Hash());
+  return position == kIndexSize ? nullptr : &cache_[index_[position]];
+}
+
+size_t LeScanningReassembler::FindIndex(const AdvertisingKey& key, size_t key_hash) {
+  for (size_t position = key_hash % kIndexSize, probe = 0;
+       index_[position] != kEmptyIndex && probe < kIndexSize;
+       position = (position + 1) % kIndexSize, probe++) {
+    AdvertisingFragment& fragment = cache_[index_[position]];
+    if (fragment.key_hash == key_hash && fragment.key == key) {
+      return position;
     }
   }
-  return cache_.end();
+  return kIndexSize;
 }
 
 /// Append to the current advertising data of the selected periodic advertiser.
 /// If the advertiser is unknown a new entry is added, optionally by
 /// dropping the oldest advertiser.
-std::list<LeScanningReassembler::PeriodicAdvertisingFragment>::iterator
-LeScanningReassembler::AppendPeriodicFragment(
+LeScanningReassembler::PeriodicAdvertisingFragment* LeScanningReassembler::AppendPeriodicFragment(
     uint16_t sync_handle, const std::vector<uint8_t>& data) {
-  auto it = FindPeriodicFragment(sync_handle);
-  if (it != periodic_cache_.end()) {
-    it->data.insert(it->data.end(), data.cbegin(), data.cend());
-    return it;
+  PeriodicAdvertisingFragment* fragment = FindPeriodicFragment(sync_handle);
+  if (fragment != nullptr) {
+    fragment->data.insert(fragment->data.end(), data.cbegin(), data.cend());
+    return fragment;
   }
 
-  if (periodic_cache_.size() > kMaximumPeriodicCacheSize) {
-    periodic_cache_.pop_back();
+  // Pick a free slot, or drop the oldest advertiser.
+  PeriodicAdvertisingFragment* oldest = &periodic_cache_[0];
+  for (PeriodicAdvertisingFragment& slot : periodic_cache_) {
+    if (!slot.in_use) {
+      fragment = &slot;
+      break;
+    }
+    if (slot.age < oldest->age) {
+      oldest = &slot;
+    }
+  }
+  if (fragment == nullptr) {
+    fragment = oldest;
   }
 
-  periodic_cache_.emplace_front(sync_handle, data);
-  return periodic_cache_.begin();
+  fragment->in_use = true;
+  fragment->sync_handle = sync_handle;
+  fragment->age = next_periodic_age_++;
+  fragment->data.assign(data.cbegin(), data.cend());
+  return fragment;
 }
 
-std::list<LeScanningReassembler::PeriodicAdvertisingFragment>::iterator
-LeScanningReassembler::FindPeriodicFragment(uint16_t sync_handle) {
-  for (auto it = periodic_cache_.begin(); it != periodic_cache_.end(); it++) {
-    if (it->sync_handle == sync_handle) {
-      return it;
+LeScanningReassembler::PeriodicAdvertisingFragment* LeScanningReassembler::FindPeriodicFragment(
+    uint16_t sync_handle) {
+  for (PeriodicAdvertisingFragment& fragment : periodic_cache_) {
+    if (fragment.in_use && fragment.sync_handle == sync_handle) {
+      return &fragment;
     }
   }
-  return periodic_cache_.end();
+  return nullptr;
 }
 
 }  // namespace bluetooth::hci
@@ -17,8 +17,8 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <array>
 #include <cstdint>
-#include <list>
 #include <optional>
 #include <vector>
 
@@ -40,7 +40,7 @@ class LeScanningReassembler {
     std::vector<uint8_t> data;
   };
 
-  LeScanningReassembler(){};
+  LeScanningReassembler();
 
   LeScanningReassembler(const LeScanningReassembler&) = delete;
 
@@ -65,6 +65,10 @@ class LeScanningReassembler {
   std::optional<std::vector<uint8_t>> ProcessPeriodicAdvertisingReport(
       uint16_t sync_handle, DataStatus status, const std::vector<uint8_t>& advertising_data);
 
+  /// Drop the incomplete periodic advertising data of a sync that was
+  /// terminated or lost.
+  void RemovePeriodicFragment(uint16_t sync_handle);
+
   /// Configure the scan response filter.
   /// If true all scan responses are ignored.
   void SetIgnoreScanResponses(bool ignore_scan_responses) {
@@ -97,28 +101,33 @@ class LeScanningReassembler {
     std::optional<AddressWithType> address;
     std::optional<uint8_t> sid;
 
+    AdvertisingKey() = default;
     AdvertisingKey(Address address, DirectAdvertisingAddressType address_type, uint8_t sid);
     bool operator==(const AdvertisingKey& other);
+    size_t Hash() const;
   };
 
-  /// Packs incomplete advertising data.
+  /// Packs incomplete advertising data, in a slot of the advertising cache.
+  /// The slot data is preallocated and kept when the slot is released.
   struct AdvertisingFragment {
+    bool in_use{false};
     AdvertisingKey key;
-    uint16_t extended_event_type;
+    size_t key_hash{0};
+    /// Insertion order, to drop the oldest advertiser when the cache is full.
+    uint64_t age{0};
+    uint16_t extended_event_type{0};
     std::vector<uint8_t> data;
-
-    AdvertisingFragment(
-        const AdvertisingKey& key, uint16_t extended_event_type, const std::vector<uint8_t>& data)
-        : key(key), extended_event_type(extended_event_type), data(data.begin(), data.end()) {}
   };
 
-  /// Packs incomplete periodic advertising data.
+  /// Packs incomplete periodic advertising data, in a slot of the periodic
+  /// advertising cache.
+  /// The slot data is preallocated and kept when the slot is released.
   struct PeriodicAdvertisingFragment {
-    std::optional<uint16_t> sync_handle;
+    bool in_use{false};
+    uint16_t sync_handle{0};
+    /// Insertion order, to drop the oldest advertiser when the cache is full.
+    uint64_t age{0};
     std::vector<uint8_t> data;
-
-    PeriodicAdvertisingFragment(uint16_t sync_handle, const std::vector<uint8_t>& data)
-        : sync_handle(sync_handle), data(data.begin(), data.end()) {}
   };
 
   /// Advertising cache for de-fragmenting extended advertising reports,
@@ -126,32 +135,57 @@ class LeScanningReassembler {
   /// applicable.
   /// The cached advertising data is removed as soon as the complete
   /// advertisement is got (including the scan response).
+  /// The cache is a fixed set of slots with preallocated data, indexed by an
+  /// open addressing table of the slot numbers, to avoid allocating and
+  /// searching linearly for every report when scanning many advertisers.
   static constexpr size_t kMaximumCacheSize = 16;
-  std::list<AdvertisingFragment> cache_;
+  /// Maximum length of the advertising data of an extended advertising set.
+  static constexpr size_t kMaximumAdvertisingDataLength = 1650;
+  std::array<AdvertisingFragment, kMaximumCacheSize> cache_;
+  uint64_t next_age_{0};
+
+  /// Index of the used cache slots, kEmptyIndex for unused entries.
+  static constexpr size_t kIndexSize = 2 * kMaximumCacheSize;
+  static constexpr uint8_t kEmptyIndex = 0xff;
+  std::array<uint8_t, kIndexSize> index_;
 
   /// Advertising cache management methods.
-  std::list<AdvertisingFragment>::iterator AppendFragment(
+  AdvertisingFragment* AppendFragment(
       const AdvertisingKey& key, uint16_t extended_event_type, const std::vector<uint8_t>& data);
 
   void RemoveFragment(const AdvertisingKey& key);
 
+  void ReleaseFragment(AdvertisingFragment* fragment);
+
   bool ContainsFragment(const AdvertisingKey& key);
 
-  std::list<AdvertisingFragment>::iterator FindFragment(const AdvertisingKey& key);
+  AdvertisingFragment* FindFragment(const AdvertisingKey& key);
+
+  /// Position of the index entry of the advertiser, kIndexSize if unknown.
+  size_t FindIndex(const AdvertisingKey& key, size_t key_hash);
 
   /// Advertising cache for de-fragmenting periodic advertising reports.
+  /// The cache is a fixed set of slots with preallocated data, so that
+  /// reassembling the reports of many periodic advertising trains does not
+  /// allocate. There are few concurrent syncs, the slots are searched
+  /// linearly.
   static constexpr size_t kMaximumPeriodicCacheSize = 16;
-  std::list<PeriodicAdvertisingFragment> periodic_cache_;
+  std::array<PeriodicAdvertisingFragment, kMaximumPeriodicCacheSize> periodic_cache_;
+  uint64_t next_periodic_age_{0};
 
-  std::list<PeriodicAdvertisingFragment>::iterator AppendPeriodicFragment(
+  /// Periodic advertising cache management methods.
+  PeriodicAdvertisingFragment* AppendPeriodicFragment(
       uint16_t sync_handle, const std::vector<uint8_t>& data);
 
-  std::list<PeriodicAdvertisingFragment>::iterator FindPeriodicFragment(uint16_t sync_handle);
+  PeriodicAdvertisingFragment* FindPeriodicFragment(uint16_t sync_handle);
 
   /// Trim the advertising data by removing empty or overflowing
   /// GAP Data entries.
   static std::vector<uint8_t> TrimAdvertisingData(const std::vector<uint8_t>& advertising_data);
 
+  /// Same as TrimAdvertisingData, in place.
+  static void TrimAdvertisingDataInPlace(std::vector<uint8_t>& advertising_data);
+
   FRIEND_TEST(LeScanningReassemblerTest, trim_advertising_data);
 };
 
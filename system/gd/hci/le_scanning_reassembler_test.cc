@@ -66,6 +66,11 @@ TEST_F(LeScanningReassemblerTest, trim_advertising_data) {
   ASSERT_EQ(
       LeScanningReassembler::TrimAdvertisingData({0x1, 0x2, 0x3, 0x4, 0x5}),
       std::vector<uint8_t>({0x1, 0x2}));
+
+  // TrimAdvertisingDataInPlace should give the same results.
+  std::vector<uint8_t> advertising_data({0x1, 0x2, 0x0, 0x0, 0x3, 0x4, 0x5, 0x6, 0x0, 0x3, 0x7});
+  LeScanningReassembler::TrimAdvertisingDataInPlace(advertising_data);
+  ASSERT_EQ(advertising_data, std::vector<uint8_t>({0x1, 0x2, 0x3, 0x4, 0x5, 0x6}));
 }
 
 TEST_F(LeScanningReassemblerTest, non_scannable_legacy_advertising) {
@@ -387,6 +392,51 @@ TEST_F(LeScanningReassemblerTest, interleaved_advertising) {
       std::vector<uint8_t>({0x2, 0x3, 0x3}));
 }
 
+TEST_F(LeScanningReassemblerTest, many_interleaved_advertisers) {
+  // The cache keeps the fragments of the most recent advertisers when more
+  // advertisers than the cache size are interleaved.
+  auto address = [](uint8_t i) { return Address({i, 1, 2, 3, 4, 5}); };
+  for (uint8_t i = 0; i < 24; i++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessAdvertisingReport(
+                         kContinuation,
+                         (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                         address(i),
+                         kSidNotPresent,
+                         {0x2, i})
+                     .has_value());
+  }
+
+  // Complete the advertisements in reverse order, the cache entries are
+  // still found after the removal of the others.
+  for (uint8_t i = 23; i >= 8; i--) {
+    ASSERT_EQ(
+        reassembler_
+            .ProcessAdvertisingReport(
+                kComplete,
+                (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+                address(i),
+                kSidNotPresent,
+                {i})
+            .value()
+            .data,
+        std::vector<uint8_t>({0x2, i, i}));
+  }
+
+  // The oldest advertisers were dropped.
+  ASSERT_EQ(
+      reassembler_
+          .ProcessAdvertisingReport(
+              kComplete,
+              (uint8_t)AddressType::PUBLIC_DEVICE_ADDRESS,
+              address(0),
+              kSidNotPresent,
+              {0x1, 0x2})
+          .value()
+          .data,
+      std::vector<uint8_t>({0x1, 0x2}));
+}
+
 TEST_F(LeScanningReassemblerTest, periodic_advertising) {
   // Test periodic advertising.
   ASSERT_FALSE(
@@ -431,4 +481,38 @@ TEST_F(LeScanningReassemblerTest, interleaved_periodic_advertising) {
       std::vector<uint8_t>({0x2, 0x1, 0x1}));
 }
 
+TEST_F(LeScanningReassemblerTest, periodic_advertising_removed_fragment) {
+  // Fragments of a lost sync must not be joined with the reports of a new
+  // sync reusing the same handle.
+  ASSERT_FALSE(
+      reassembler_
+          .ProcessPeriodicAdvertisingReport(kTestSyncHandle1, DataStatus::CONTINUING, {0x1, 0x2})
+          .has_value());
+
+  reassembler_.RemovePeriodicFragment(kTestSyncHandle1);
+
+  ASSERT_EQ(
+      reassembler_
+          .ProcessPeriodicAdvertisingReport(kTestSyncHandle1, DataStatus::COMPLETE, {0x1, 0x3})
+          .value(),
+      std::vector<uint8_t>({0x1, 0x3}));
+}
+
+TEST_F(LeScanningReassemblerTest, periodic_advertising_cache_full) {
+  // The oldest periodic advertiser is dropped when the cache is full.
+  for (uint16_t sync_handle = 0; sync_handle <= 16; sync_handle++) {
+    ASSERT_FALSE(reassembler_
+                     .ProcessPeriodicAdvertisingReport(
+                         sync_handle, DataStatus::CONTINUING, {0x2, (uint8_t)sync_handle})
+                     .has_value());
+  }
+
+  ASSERT_EQ(
+      reassembler_.ProcessPeriodicAdvertisingReport(0, DataStatus::COMPLETE, {0x1, 0x0}).value(),
+      std::vector<uint8_t>({0x1, 0x0}));
+  ASSERT_EQ(
+      reassembler_.ProcessPeriodicAdvertisingReport(16, DataStatus::COMPLETE, {0x10}).value(),
+      std::vector<uint8_t>({0x2, 0x10, 0x10}));
+}
+
 }  // namespace bluetooth::hci
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hci/link_quality_scheduler.h"
+
+#include <algorithm>
+
+namespace bluetooth::hci {
+
+LinkQualityScheduler::LinkQualityScheduler(std::chrono::milliseconds coalescing_window)
+    : coalescing_window_(coalescing_window) {}
+
+void LinkQualityScheduler::AddLink(
+    uint16_t connection_handle, std::chrono::milliseconds interval, Clock::time_point now) {
+  // A null interval would sample the link at every wake-up
+  interval = std::max(interval, std::chrono::milliseconds(1));
+  links_[connection_handle] = Link{interval, now + interval};
+}
+
+void LinkQualityScheduler::RemoveLink(uint16_t connection_handle) {
+  links_.erase(connection_handle);
+}
+
+LinkQualityScheduler::Clock::time_point LinkQualityScheduler::NextDeadline() const {
+  Clock::time_point next{};
+  for (const auto& [connection_handle, link] : links_) {
+    if (next == Clock::time_point{} || link.deadline < next) {
+      next = link.deadline;
+    }
+  }
+  return next;
+}
+
+std::vector<uint16_t> LinkQualityScheduler::TakeDueLinks(Clock::time_point now) {
+  std::vector<uint16_t> due_links;
+  for (auto& [connection_handle, link] : links_) {
+    if (link.deadline > now + coalescing_window_) {
+      continue;
+    }
+    due_links.push_back(connection_handle);
+    link.deadline += link.interval;
+    // Skip the samplings missed while the timer was late
+    if (link.deadline <= now) {
+      link.deadline = now + link.interval;
+    }
+  }
+  return due_links;
+}
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace bluetooth::hci {
+
+/// The link quality scheduler plans the periodic reads of a link metric
+/// (RSSI, transmit power...) of several connections from a single timer.
+///
+/// Each link is sampled at its own interval. When the timer fires, the links
+/// due at that time are sampled together with the links due within the
+/// coalescing window, so that links with close deadlines share one wake-up
+/// and their read commands are sent back to back. The next sampling of a link
+/// is planned from its deadline rather than from the time it was sampled, so
+/// sampling a link early does not change its average rate.
+class LinkQualityScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit LinkQualityScheduler(
+      std::chrono::milliseconds coalescing_window = kDefaultCoalescingWindow);
+
+  LinkQualityScheduler(const LinkQualityScheduler&) = delete;
+
+  LinkQualityScheduler& operator=(const LinkQualityScheduler&) = delete;
+
+  /// Sample the link every |interval|, the first time one interval after
+  /// |now|. Replaces the schedule of a link already sampled.
+  void AddLink(uint16_t connection_handle, std::chrono::milliseconds interval, Clock::time_point now);
+
+  void RemoveLink(uint16_t connection_handle);
+
+  bool HasLink(uint16_t connection_handle) const {
+    return links_.find(connection_handle) != links_.end();
+  }
+
+  bool IsEmpty() const {
+    return links_.empty();
+  }
+
+  /// Time of the next deadline, the time point of the epoch when no link is
+  /// sampled.
+  Clock::time_point NextDeadline() const;
+
+  /// Returns the links to sample at |now|, in connection handle order, and
+  /// plans their next sampling.
+  std::vector<uint16_t> TakeDueLinks(Clock::time_point now);
+
+ private:
+  static constexpr std::chrono::milliseconds kDefaultCoalescingWindow{50};
+
+  struct Link {
+    std::chrono::milliseconds interval;
+    Clock::time_point deadline;
+  };
+
+  std::map<uint16_t, Link> links_;
+  std::chrono::milliseconds coalescing_window_;
+};
+
+}  // namespace bluetooth::hci
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/link_quality_scheduler.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+namespace bluetooth::hci {
+
+static constexpr uint16_t kHandle1 = 0x0001;
+static constexpr uint16_t kHandle2 = 0x0002;
+static constexpr uint16_t kHandle3 = 0x0040;
+
+class LinkQualitySchedulerTest : public ::testing::Test {
+ protected:
+  void AddLink(uint16_t connection_handle, std::chrono::milliseconds interval, std::chrono::milliseconds time) {
+    scheduler_.AddLink(connection_handle, interval, start_ + time);
+  }
+
+  std::vector<uint16_t> TakeDueLinks(std::chrono::milliseconds time) {
+    return scheduler_.TakeDueLinks(start_ + time);
+  }
+
+  LinkQualityScheduler scheduler_{50ms};
+  LinkQualityScheduler::Clock::time_point start_{LinkQualityScheduler::Clock::now()};
+};
+
+TEST_F(LinkQualitySchedulerTest, empty) {
+  ASSERT_TRUE(scheduler_.IsEmpty());
+  ASSERT_EQ(scheduler_.NextDeadline(), LinkQualityScheduler::Clock::time_point{});
+  ASSERT_TRUE(TakeDueLinks(1000ms).empty());
+}
+
+TEST_F(LinkQualitySchedulerTest, periodic) {
+  AddLink(kHandle1, 200ms, 0ms);
+  ASSERT_TRUE(scheduler_.HasLink(kHandle1));
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 200ms);
+
+  ASSERT_TRUE(TakeDueLinks(100ms).empty());
+  ASSERT_EQ(TakeDueLinks(200ms), std::vector<uint16_t>({kHandle1}));
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 400ms);
+  ASSERT_TRUE(TakeDueLinks(300ms).empty());
+  ASSERT_EQ(TakeDueLinks(400ms), std::vector<uint16_t>({kHandle1}));
+}
+
+TEST_F(LinkQualitySchedulerTest, coalesce_close_deadlines) {
+  AddLink(kHandle1, 200ms, 0ms);
+  AddLink(kHandle2, 230ms, 0ms);
+  AddLink(kHandle3, 300ms, 0ms);
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 200ms);
+
+  // The second link is due within the window, the third is not
+  ASSERT_EQ(TakeDueLinks(200ms), std::vector<uint16_t>({kHandle1, kHandle2}));
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 300ms);
+  ASSERT_EQ(TakeDueLinks(300ms), std::vector<uint16_t>({kHandle3}));
+}
+
+TEST_F(LinkQualitySchedulerTest, early_sampling_keeps_rate) {
+  AddLink(kHandle1, 200ms, 0ms);
+  AddLink(kHandle2, 230ms, 0ms);
+
+  // Sampled 30ms early, the next deadline is still planned from the first one
+  ASSERT_EQ(TakeDueLinks(200ms), std::vector<uint16_t>({kHandle1, kHandle2}));
+  ASSERT_EQ(TakeDueLinks(400ms), std::vector<uint16_t>({kHandle1}));
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 460ms);
+}
+
+TEST_F(LinkQualitySchedulerTest, late_timer_skips_missed_samplings) {
+  AddLink(kHandle1, 100ms, 0ms);
+
+  ASSERT_EQ(TakeDueLinks(1000ms), std::vector<uint16_t>({kHandle1}));
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 1100ms);
+  ASSERT_TRUE(TakeDueLinks(1000ms).empty());
+}
+
+TEST_F(LinkQualitySchedulerTest, add_replaces_schedule) {
+  AddLink(kHandle1, 200ms, 0ms);
+  AddLink(kHandle1, 500ms, 100ms);
+
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 600ms);
+  ASSERT_TRUE(TakeDueLinks(200ms).empty());
+}
+
+TEST_F(LinkQualitySchedulerTest, remove) {
+  AddLink(kHandle1, 200ms, 0ms);
+  AddLink(kHandle2, 300ms, 0ms);
+  scheduler_.RemoveLink(kHandle1);
+
+  ASSERT_FALSE(scheduler_.HasLink(kHandle1));
+  ASSERT_EQ(scheduler_.NextDeadline(), start_ + 300ms);
+  ASSERT_EQ(TakeDueLinks(300ms), std::vector<uint16_t>({kHandle2}));
+
+  scheduler_.RemoveLink(kHandle2);
+  ASSERT_TRUE(scheduler_.IsEmpty());
+}
+
+}  // namespace bluetooth::hci
@@ -19,6 +19,13 @@
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "common/lru_cache.h"
 #include "hci/acl_manager/acl_scheduler.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
@@ -46,7 +53,14 @@ struct RemoteNameRequestModule::impl {
   }
 
   void Stop() {
-    log::info("Stopping RemoteNameRequestModule");
+    log::info(
+        "Stopping RemoteNameRequestModule started:{} joined:{} answered_from_cache:{} "
+        "average_wait_ms:{} max_wait_ms:{}",
+        started_count_,
+        joined_count_,
+        cache_hit_count_,
+        started_count_ == 0 ? 0 : total_wait_.count() / started_count_,
+        max_wait_.count());
     hci_layer_->UnregisterEventHandler(EventCode::REMOTE_HOST_SUPPORTED_FEATURES_NOTIFICATION);
     hci_layer_->UnregisterEventHandler(EventCode::REMOTE_NAME_REQUEST_COMPLETE);
   }
@@ -56,34 +70,51 @@ struct RemoteNameRequestModule::impl {
       std::unique_ptr<RemoteNameRequestBuilder> request,
       CompletionCallback on_completion,
       RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification,
-      RemoteNameCallback on_remote_name_complete) {
-    log::info("Enqueuing remote name request to {}", address.ToRedactedStringForLogging());
+      RemoteNameCallback on_remote_name_complete,
+      Priority priority) {
+    if (answer_from_cache(
+            address,
+            on_completion,
+            on_remote_host_supported_features_notification,
+            on_remote_name_complete)) {
+      return;
+    }
 
-    // This callback needs to be shared between the *start* callback and the *cancel_completed*
-    // callback, so we refcount it for safety. But since the scheduler guarantees that exactly one
-    // of these callbacks will be invokes, this is safe.
-    auto on_remote_name_complete_ptr =
-        std::make_shared<RemoteNameCallback>(std::move(on_remote_name_complete));
+    auto it = requests_.find(address);
+    if (it != requests_.end()) {
+      log::info(
+          "Joining the remote name request to {} already {}",
+          address.ToRedactedStringForLogging(),
+          it->second == outgoing_ ? "outgoing" : "queued");
+      joined_count_++;
+      it->second->join(
+          std::move(on_completion),
+          std::move(on_remote_host_supported_features_notification),
+          std::move(on_remote_name_complete));
+      return;
+    }
+
+    log::info(
+        "Enqueuing remote name request to {} priority:{}",
+        address.ToRedactedStringForLogging(),
+        priority == Priority::HIGH ? "high" : "normal");
+    auto pending_request = std::make_shared<PendingRequest>(address);
+    pending_request->join(
+        std::move(on_completion),
+        std::move(on_remote_host_supported_features_notification),
+        std::move(on_remote_name_complete));
+    requests_[address] = pending_request;
 
+    // The scheduler guarantees that exactly one of these callbacks will be invoked
     acl_scheduler_->EnqueueRemoteNameRequest(
         address,
         handler_->BindOnceOn(
             this,
             &impl::actually_start_remote_name_request,
-            address,
-            std::move(request),
-            std::move(on_completion),
-            std::move(on_remote_host_supported_features_notification),
-            on_remote_name_complete_ptr),
-        handler_->BindOnce(
-            [&](Address address, std::shared_ptr<RemoteNameCallback> on_remote_name_complete_ptr) {
-              log::info(
-                  "Dequeued remote name request to {} since it was cancelled",
-                  address.ToRedactedStringForLogging());
-              (*on_remote_name_complete_ptr)(ErrorCode::PAGE_TIMEOUT, {});
-            },
-            address,
-            on_remote_name_complete_ptr));
+            pending_request,
+            std::move(request)),
+        handler_->BindOnceOn(this, &impl::dequeued_remote_name_request, pending_request),
+        priority == Priority::HIGH);
   }
 
   void CancelRemoteNameRequest(Address address) {
@@ -94,12 +125,12 @@ struct RemoteNameRequestModule::impl {
   }
 
   void ReportRemoteNameRequestCancellation(Address address) {
-    if (pending_) {
+    if (outgoing_) {
       log::info(
           "Received CONNECTION_COMPLETE (corresponding INCORRECTLY to an RNR cancellation) from {}",
           address.ToRedactedStringForLogging());
-      pending_ = false;
-      on_remote_name_complete_(ErrorCode::UNKNOWN_CONNECTION, {});
+      auto outgoing = finish_outgoing();
+      outgoing->notify_name(ErrorCode::UNKNOWN_CONNECTION, {});
       acl_scheduler_->ReportRemoteNameRequestCompletion(address);
     } else {
       log::error(
@@ -109,32 +140,134 @@ struct RemoteNameRequestModule::impl {
   }
 
  private:
-  void actually_start_remote_name_request(
+  // A queued or outgoing request, with the callbacks of all the callers that asked for the name of
+  // its address in the meantime
+  struct PendingRequest {
+    explicit PendingRequest(Address address)
+        : address(address), enqueued_time(std::chrono::steady_clock::now()) {}
+
+    void join(
+        CompletionCallback on_completion,
+        RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification,
+        RemoteNameCallback on_remote_name_complete) {
+      // Catch up on what was already reported to the callers that joined earlier
+      if (start_status.has_value()) {
+        on_completion(start_status.value());
+      } else {
+        completion_callbacks.push_back(std::move(on_completion));
+      }
+      if (host_supported_features.has_value()) {
+        on_remote_host_supported_features_notification(host_supported_features.value());
+      } else {
+        features_callbacks.push_back(std::move(on_remote_host_supported_features_notification));
+      }
+      name_callbacks.push_back(std::move(on_remote_name_complete));
+    }
+
+    void notify_started(ErrorCode status) {
+      start_status = status;
+      for (auto& callback : completion_callbacks) {
+        callback(status);
+      }
+      completion_callbacks.clear();
+    }
+
+    void notify_host_supported_features(uint64_t features) {
+      host_supported_features = features;
+      for (auto& callback : features_callbacks) {
+        callback(features);
+      }
+      features_callbacks.clear();
+    }
+
+    void notify_name(ErrorCode status, std::array<uint8_t, 248> name) {
+      for (auto& callback : name_callbacks) {
+        callback(status, name);
+      }
+      name_callbacks.clear();
+    }
+
+    const Address address;
+    const std::chrono::steady_clock::time_point enqueued_time;
+    std::optional<ErrorCode> start_status;
+    std::optional<uint64_t> host_supported_features;
+    std::vector<CompletionCallback> completion_callbacks;
+    std::vector<RemoteHostSupportedFeaturesCallback> features_callbacks;
+    std::vector<RemoteNameCallback> name_callbacks;
+  };
+
+  struct CachedName {
+    std::array<uint8_t, 248> name;
+    uint64_t host_supported_features;
+    std::chrono::steady_clock::time_point time;
+  };
+
+  bool answer_from_cache(
       Address address,
-      std::unique_ptr<RemoteNameRequestBuilder> request,
-      CompletionCallback on_completion,
-      RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification,
-      std::shared_ptr<RemoteNameCallback> on_remote_name_complete_ptr) {
-    log::info("Starting remote name request to {}", address.ToRedactedStringForLogging());
-    log::assert_that(pending_ == false, "assert failed: pending_ == false");
-    pending_ = true;
-    on_remote_host_supported_features_notification_ =
-        std::move(on_remote_host_supported_features_notification);
-    on_remote_name_complete_ = std::move(*on_remote_name_complete_ptr.get());
+      CompletionCallback& on_completion,
+      RemoteHostSupportedFeaturesCallback& on_remote_host_supported_features_notification,
+      RemoteNameCallback& on_remote_name_complete) {
+    auto it = name_cache_.find(address);
+    if (it == name_cache_.end()) {
+      return false;
+    }
+    if (std::chrono::steady_clock::now() - it->second.time > kRemoteNameCacheTimeout) {
+      name_cache_.erase(it);
+      return false;
+    }
+    log::info(
+        "Answering remote name request to {} from the cache", address.ToRedactedStringForLogging());
+    cache_hit_count_++;
+    // Report the events in the order the controller would have sent them
+    on_completion(ErrorCode::SUCCESS);
+    on_remote_host_supported_features_notification(it->second.host_supported_features);
+    on_remote_name_complete(ErrorCode::SUCCESS, it->second.name);
+    return true;
+  }
+
+  void actually_start_remote_name_request(
+      std::shared_ptr<PendingRequest> pending_request,
+      std::unique_ptr<RemoteNameRequestBuilder> request) {
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - pending_request->enqueued_time);
+    log::info(
+        "Starting remote name request to {} after waiting {} ms in the queue",
+        pending_request->address.ToRedactedStringForLogging(),
+        wait.count());
+    log::assert_that(outgoing_ == nullptr, "assert failed: outgoing_ == nullptr");
+    started_count_++;
+    total_wait_ += wait;
+    max_wait_ = std::max(max_wait_, wait);
+    outgoing_ = pending_request;
     hci_layer_->EnqueueCommand(
         std::move(request),
         handler_->BindOnceOn(
-            this, &impl::on_start_remote_name_request_status, address, std::move(on_completion)));
+            this, &impl::on_start_remote_name_request_status, pending_request->address));
+  }
+
+  void dequeued_remote_name_request(std::shared_ptr<PendingRequest> pending_request) {
+    log::info(
+        "Dequeued remote name request to {} since it was cancelled",
+        pending_request->address.ToRedactedStringForLogging());
+    requests_.erase(pending_request->address);
+    pending_request->notify_name(ErrorCode::PAGE_TIMEOUT, {});
+  }
+
+  // Clear the outgoing request, so that a request made by one of its callers starts a new one
+  std::shared_ptr<PendingRequest> finish_outgoing() {
+    auto outgoing = std::move(outgoing_);
+    outgoing_ = nullptr;
+    requests_.erase(outgoing->address);
+    return outgoing;
   }
 
-  void on_start_remote_name_request_status(
-      Address address, CompletionCallback on_completion, CommandStatusView status) {
+  void on_start_remote_name_request_status(Address address, CommandStatusView status) {
     // TODO(b/294961421): Remove the ifdef when firmware fix in place. Realtek controllers
     // unexpectedly sent a Remote Name Req Complete HCI event without the corresponding HCI command.
 #ifndef TARGET_FLOSS
-    log::assert_that(pending_ == true, "assert failed: pending_ == true");
+    log::assert_that(outgoing_ != nullptr, "assert failed: outgoing_ != nullptr");
 #else
-    if (pending_ != true) {
+    if (outgoing_ == nullptr) {
       log::warn("Unexpected remote name response with no request pending");
       return;
     }
@@ -146,15 +279,16 @@ struct RemoteNameRequestModule::impl {
         "Started remote name request peer:{} status:{}",
         address.ToRedactedStringForLogging(),
         ErrorCodeText(status.GetStatus()));
-    on_completion(status.GetStatus());
     if (status.GetStatus() != ErrorCode::SUCCESS /* pending */) {
-      pending_ = false;
+      finish_outgoing()->notify_started(status.GetStatus());
       acl_scheduler_->ReportRemoteNameRequestCompletion(address);
+    } else {
+      outgoing_->notify_started(status.GetStatus());
     }
   }
 
   void actually_cancel_remote_name_request(Address address) {
-    if (pending_) {
+    if (outgoing_) {
       log::info("Cancelling remote name request to {}", address.ToRedactedStringForLogging());
       hci_layer_->EnqueueCommand(
           RemoteNameRequestCancelBuilder::Create(address),
@@ -169,18 +303,16 @@ struct RemoteNameRequestModule::impl {
   void on_remote_host_supported_features_notification(EventView view) {
     auto packet = RemoteHostSupportedFeaturesNotificationView::Create(view);
     log::assert_that(packet.IsValid(), "assert failed: packet.IsValid()");
-    if (pending_ && on_remote_host_supported_features_notification_) {
+    if (outgoing_ && !outgoing_->host_supported_features.has_value()) {
       log::info(
           "Received REMOTE_HOST_SUPPORTED_FEATURES_NOTIFICATION from {}",
           packet.GetBdAddr().ToRedactedStringForLogging());
-      on_remote_host_supported_features_notification_(packet.GetHostSupportedFeatures());
-      // Remove the callback so that we won't call it again.
-      on_remote_host_supported_features_notification_ = RemoteHostSupportedFeaturesCallback();
-    } else if (!pending_) {
+      outgoing_->notify_host_supported_features(packet.GetHostSupportedFeatures());
+    } else if (!outgoing_) {
       log::error(
           "Received unexpected REMOTE_HOST_SUPPORTED_FEATURES_NOTIFICATION when no Remote Name "
           "Request is outstanding");
-    } else {  // callback is not set, which indicates we have processed the feature notification.
+    } else {  // features are already set, which indicates we have processed the notification.
       log::error(
           "Received more than one REMOTE_HOST_SUPPORTED_FEATURES_NOTIFICATION during Remote Name "
           "Request");
@@ -188,13 +320,20 @@ struct RemoteNameRequestModule::impl {
   }
 
   void completed(ErrorCode status, std::array<uint8_t, 248> name, Address address) {
-    if (pending_) {
+    if (outgoing_) {
       log::info(
           "Received REMOTE_NAME_REQUEST_COMPLETE from {} with status {}",
           address.ToRedactedStringForLogging(),
           ErrorCodeText(status));
-      pending_ = false;
-      on_remote_name_complete_(status, name);
+      auto outgoing = finish_outgoing();
+      // Only cache complete answers, since the callers rely on the host supported features too
+      if (status == ErrorCode::SUCCESS && outgoing->host_supported_features.has_value()) {
+        name_cache_.insert_or_assign(
+            outgoing->address,
+            CachedName{
+                name, outgoing->host_supported_features.value(), std::chrono::steady_clock::now()});
+      }
+      outgoing->notify_name(status, name);
       acl_scheduler_->ReportRemoteNameRequestCompletion(address);
     } else {
       log::error(
@@ -227,9 +366,16 @@ struct RemoteNameRequestModule::impl {
   acl_manager::AclScheduler* acl_scheduler_;
   os::Handler* handler_;
 
-  bool pending_ = false;
-  RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification_;
-  RemoteNameCallback on_remote_name_complete_;
+  // The queued and outgoing requests, by address
+  std::unordered_map<Address, std::shared_ptr<PendingRequest>> requests_;
+  std::shared_ptr<PendingRequest> outgoing_;
+  common::LruCache<Address, CachedName> name_cache_{kRemoteNameCacheSize};
+
+  uint64_t started_count_ = 0;
+  uint64_t joined_count_ = 0;
+  uint64_t cache_hit_count_ = 0;
+  std::chrono::milliseconds total_wait_{0};
+  std::chrono::milliseconds max_wait_{0};
 };
 
 const ModuleFactory RemoteNameRequestModule::Factory =
@@ -243,7 +389,8 @@ void RemoteNameRequestModule::StartRemoteNameRequest(
     std::unique_ptr<RemoteNameRequestBuilder> request,
     CompletionCallback on_completion,
     RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification,
-    RemoteNameCallback on_remote_name_complete) {
+    RemoteNameCallback on_remote_name_complete,
+    Priority priority) {
   CallOn(
       pimpl_.get(),
       &impl::StartRemoteNameRequest,
@@ -251,7 +398,8 @@ void RemoteNameRequestModule::StartRemoteNameRequest(
       std::move(request),
       std::move(on_completion),
       std::move(on_remote_host_supported_features_notification),
-      std::move(on_remote_name_complete));
+      std::move(on_remote_name_complete),
+      priority);
 }
 
 void RemoteNameRequestModule::CancelRemoteNameRequest(Address address) {
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -35,19 +36,32 @@ using RemoteHostSupportedFeaturesCallback = common::ContextualOnceCallback<void(
 using RemoteNameCallback =
     common::ContextualOnceCallback<void(ErrorCode, std::array<uint8_t, 248>)>;
 
-// Historical note: This class is intended to provide a shim at the *HCI* layer, so legacy Remote
-// Name Requests can interoperate with the GD ACL scheduler. Thus, we intentionally do not merge
-// identical requests, cache responses, or handle request timeouts - we leave this to our callers.
-// When GD clients start to use this module, richer functionality should be added.
+// Requests are scheduled with the ACL connections by the GD ACL scheduler. A request to an address
+// that already has one queued or outgoing joins it rather than paging the device again, and all
+// the callers are then notified of its outcome. Successfully read names are kept for
+// kRemoteNameCacheTimeout, so that a request made shortly after is answered without paging the
+// device. Request timeouts are left to our callers.
 class RemoteNameRequestModule : public bluetooth::Module {
  public:
+  enum class Priority {
+    // Requests made for discovery or on behalf of applications
+    NORMAL,
+    // Requests made while bonding with or connecting to the device, which are queued ahead of the
+    // normal ones
+    HIGH,
+  };
+
+  static constexpr std::chrono::milliseconds kRemoteNameCacheTimeout = std::chrono::seconds(30);
+  static constexpr size_t kRemoteNameCacheSize = 32;
+
   // Dispatch a Remote Name Request
   void StartRemoteNameRequest(
       Address address,
       std::unique_ptr<RemoteNameRequestBuilder> request,
       CompletionCallback on_completion,
       RemoteHostSupportedFeaturesCallback on_remote_host_supported_features_notification,
-      RemoteNameCallback on_remote_name_complete);
+      RemoteNameCallback on_remote_name_complete,
+      Priority priority = Priority::NORMAL);
 
   // Cancel a Remote Name Request
   void CancelRemoteNameRequest(Address address);
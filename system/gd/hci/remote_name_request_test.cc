@@ -697,6 +697,183 @@ TEST_F(RemoteNameRequestModuleTest, CancelJustWhenRNREventReturns) {
   future2.wait();
 }
 
+TEST_F(RemoteNameRequestModuleTest, SecondRequestToSameAddressJoinsFirst) {
+  auto features_promise1 = std::promise<uint64_t>{};
+  auto features_future1 = features_promise1.get_future();
+  auto features_promise2 = std::promise<uint64_t>{};
+  auto features_future2 = features_promise2.get_future();
+  auto promise1 = std::promise<std::tuple<ErrorCode, std::array<uint8_t, 248>>>{};
+  auto future1 = promise1.get_future();
+  auto promise2 = std::promise<std::tuple<ErrorCode, std::array<uint8_t, 248>>>{};
+  auto future2 = promise2.get_future();
+
+  // start a remote name request
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      emptyCallback<ErrorCode>(),
+      capturingPromiseCallback<uint64_t>(std::move(features_promise1)),
+      capturingPromiseCallback<ErrorCode, std::array<uint8_t, 248>>(std::move(promise1)));
+  test_hci_layer_->GetCommand();
+  test_hci_layer_->IncomingEvent(RemoteNameRequestStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+
+  // request the name of the same address while the first request is outgoing
+  auto completion_promise2 = std::promise<ErrorCode>{};
+  auto completion_future2 = completion_promise2.get_future();
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      capturingPromiseCallback<ErrorCode>(std::move(completion_promise2)),
+      capturingPromiseCallback<uint64_t>(std::move(features_promise2)),
+      capturingPromiseCallback<ErrorCode, std::array<uint8_t, 248>>(std::move(promise2)));
+
+  // the second request is told that the first one has started
+  EXPECT_THAT(completion_future2, IsSetWithValue(Eq(ErrorCode::SUCCESS)));
+
+  // report host supported events and remote name
+  test_hci_layer_->IncomingEvent(
+      RemoteHostSupportedFeaturesNotificationBuilder::Create(address1, 1234));
+  test_hci_layer_->IncomingEvent(
+      RemoteNameRequestCompleteBuilder::Create(ErrorCode::SUCCESS, address1, remote_name1));
+
+  // verify that both requests were answered
+  EXPECT_THAT(features_future1, IsSetWithValue(Eq((uint64_t)1234)));
+  EXPECT_THAT(features_future2, IsSetWithValue(Eq((uint64_t)1234)));
+  EXPECT_THAT(future1, IsSetWithValue(Eq(std::make_tuple(ErrorCode::SUCCESS, remote_name1))));
+  EXPECT_THAT(future2, IsSetWithValue(Eq(std::make_tuple(ErrorCode::SUCCESS, remote_name1))));
+
+  // without sending the request twice
+  fake_registry_.SynchronizeModuleHandler(&RemoteNameRequestModule::Factory, timeout);
+  test_hci_layer_->AssertNoQueuedCommand();
+}
+
+TEST_F(RemoteNameRequestModuleTest, CompletedRemoteNameAnsweredFromCache) {
+  auto promise1 = std::promise<void>{};
+  auto future1 = promise1.get_future();
+
+  // complete a remote name request
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      emptyCallback<ErrorCode>(),
+      emptyCallback<uint64_t>(),
+      promiseCallback<ErrorCode, std::array<uint8_t, 248>>(std::move(promise1)));
+  test_hci_layer_->GetCommand();
+  test_hci_layer_->IncomingEvent(RemoteNameRequestStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+  test_hci_layer_->IncomingEvent(
+      RemoteHostSupportedFeaturesNotificationBuilder::Create(address1, 1234));
+  test_hci_layer_->IncomingEvent(
+      RemoteNameRequestCompleteBuilder::Create(ErrorCode::SUCCESS, address1, remote_name1));
+  EXPECT_THAT(future1, IsSet());
+
+  // request the name again
+  auto completion_promise = std::promise<ErrorCode>{};
+  auto completion_future = completion_promise.get_future();
+  auto features_promise = std::promise<uint64_t>{};
+  auto features_future = features_promise.get_future();
+  auto promise2 = std::promise<std::tuple<ErrorCode, std::array<uint8_t, 248>>>{};
+  auto future2 = promise2.get_future();
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      capturingPromiseCallback<ErrorCode>(std::move(completion_promise)),
+      capturingPromiseCallback<uint64_t>(std::move(features_promise)),
+      capturingPromiseCallback<ErrorCode, std::array<uint8_t, 248>>(std::move(promise2)));
+
+  // verify that it was answered without sending the request
+  EXPECT_THAT(completion_future, IsSetWithValue(Eq(ErrorCode::SUCCESS)));
+  EXPECT_THAT(features_future, IsSetWithValue(Eq((uint64_t)1234)));
+  EXPECT_THAT(future2, IsSetWithValue(Eq(std::make_tuple(ErrorCode::SUCCESS, remote_name1))));
+  fake_registry_.SynchronizeModuleHandler(&RemoteNameRequestModule::Factory, timeout);
+  test_hci_layer_->AssertNoQueuedCommand();
+}
+
+TEST_F(RemoteNameRequestModuleTest, FailedRemoteNameNotCached) {
+  auto promise = std::promise<void>{};
+  auto future = promise.get_future();
+
+  // fail a remote name request
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      emptyCallback<ErrorCode>(),
+      emptyCallback<uint64_t>(),
+      promiseCallback<ErrorCode, std::array<uint8_t, 248>>(std::move(promise)));
+  test_hci_layer_->GetCommand();
+  test_hci_layer_->IncomingEvent(RemoteNameRequestStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+  test_hci_layer_->IncomingEvent(
+      RemoteNameRequestCompleteBuilder::Create(ErrorCode::PAGE_TIMEOUT, address1, remote_name1));
+  EXPECT_THAT(future, IsSet());
+
+  // request the name again
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      emptyCallback<ErrorCode>(),
+      emptyCallback<uint64_t>(),
+      emptyCallback<ErrorCode, std::array<uint8_t, 248>>());
+
+  // verify that the request is sent again
+  auto command = test_hci_layer_->GetCommand();
+  auto discovery_command = DiscoveryCommandView::Create(command);
+  ASSERT_TRUE(discovery_command.IsValid());
+  auto rnr_command = RemoteNameRequestView::Create(DiscoveryCommandView::Create(discovery_command));
+  ASSERT_TRUE(rnr_command.IsValid());
+  EXPECT_EQ(rnr_command.GetBdAddr(), address1);
+}
+
+TEST_F(RemoteNameRequestModuleTest, HighPriorityRemoteNameRequestStartsFirst) {
+  auto promise1 = std::promise<void>{};
+  auto future1 = promise1.get_future();
+
+  // start a remote name request
+  remote_name_request_module_->StartRemoteNameRequest(
+      address1,
+      RemoteNameRequestBuilder::Create(
+          address1, PageScanRepetitionMode::R0, 3, ClockOffsetValid::INVALID),
+      emptyCallback<ErrorCode>(),
+      impossibleCallback<uint64_t>(),
+      promiseCallback<ErrorCode, std::array<uint8_t, 248>>(std::move(promise1)));
+
+  // enqueue a normal one, then a high priority one
+  remote_name_request_module_->StartRemoteNameRequest(
+      address2,
+      RemoteNameRequestBuilder::Create(
+          address2, PageScanRepetitionMode::R1, 4, ClockOffsetValid::VALID),
+      emptyCallback<ErrorCode>(),
+      impossibleCallback<uint64_t>(),
+      emptyCallback<ErrorCode, std::array<uint8_t, 248>>());
+  remote_name_request_module_->StartRemoteNameRequest(
+      address3,
+      RemoteNameRequestBuilder::Create(
+          address3, PageScanRepetitionMode::R1, 4, ClockOffsetValid::VALID),
+      emptyCallback<ErrorCode>(),
+      impossibleCallback<uint64_t>(),
+      emptyCallback<ErrorCode, std::array<uint8_t, 248>>(),
+      RemoteNameRequestModule::Priority::HIGH);
+
+  // complete the first one
+  test_hci_layer_->GetCommand();
+  test_hci_layer_->IncomingEvent(RemoteNameRequestStatusBuilder::Create(ErrorCode::SUCCESS, 1));
+  test_hci_layer_->IncomingEvent(
+      RemoteNameRequestCompleteBuilder::Create(ErrorCode::STATUS_UNKNOWN, address1, remote_name1));
+  EXPECT_THAT(future1, IsSet());
+
+  // verify that the high priority request started next
+  auto command = test_hci_layer_->GetCommand();
+  auto discovery_command = DiscoveryCommandView::Create(command);
+  ASSERT_TRUE(discovery_command.IsValid());
+  auto rnr_command = RemoteNameRequestView::Create(DiscoveryCommandView::Create(discovery_command));
+  ASSERT_TRUE(rnr_command.IsValid());
+  EXPECT_EQ(rnr_command.GetBdAddr(), address3);
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
@@ -18,6 +18,8 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/le/internal/link.h"
 #include "packet/fragmenting_inserter.h"
@@ -33,6 +35,24 @@ LeCreditBasedDataController::LeCreditBasedDataController(ILink* link, Cid cid, C
     : cid_(cid), remote_cid_(remote_cid), enqueue_buffer_(channel_queue_end), handler_(handler), scheduler_(scheduler),
       link_(link) {}
 
+LeCreditBasedDataController::~LeCreditBasedDataController() {
+  auto duration =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time_);
+  log::info(
+      "cid 0x{:04x} tx {} bytes in {} PDUs, rx {} bytes in {} PDUs over {} ms, credit window {}, tx stalls {}, rx "
+      "stalls {}, rx backlogs {}",
+      cid_,
+      stats_.tx_bytes,
+      stats_.tx_pdus,
+      stats_.rx_bytes,
+      stats_.rx_pdus,
+      duration.count(),
+      credit_window_,
+      stats_.tx_credit_stalls,
+      stats_.rx_credit_stalls,
+      stats_.rx_backlogs);
+}
+
 void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilder> sdu) {
   auto sdu_size = sdu->size();
   if (sdu_size == 0) {
@@ -61,12 +81,22 @@ void LeCreditBasedDataController::OnSdu(std::unique_ptr<packet::BasePacketBuilde
     scheduler_->OnPacketsReady(cid_, credits_);
     pending_frames_count_ += (segments.size() - credits_);
     credits_ = 0;
+    stats_.tx_credit_stalls++;
   } else {
     pending_frames_count_ += segments.size();
+    stats_.tx_credit_stalls++;
   }
 }
 
 void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
+  // The upper layer is only behind if SDUs received before this PDU are still waiting for room in the channel queue
+  bool upper_layer_backlogged = enqueue_buffer_.Size() > 0;
+  if (local_credits_ > 0) {
+    local_credits_--;
+  }
+  stats_.rx_pdus++;
+  stats_.rx_bytes += pdu.size();
+
   auto basic_frame_view = BasicFrameView::Create(pdu);
   if (!basic_frame_view.IsValid()) {
     log::warn("Received invalid frame");
@@ -102,14 +132,15 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
     remaining_sdu_continuation_packet_size_ = 0;
     link_->SendDisconnectionRequest(cid_, remote_cid_);
   }
-  // TODO: Improve the logic by sending credit only after user dequeued the SDU
-  link_->SendLeCredit(cid_, 1);
+  send_credits(upper_layer_backlogged);
 }
 
 std::unique_ptr<packet::BasePacketBuilder> LeCreditBasedDataController::GetNextPacket() {
   log::assert_that(!pdu_queue_.empty(), "assert failed: !pdu_queue_.empty()");
   auto next = std::move(pdu_queue_.front());
   pdu_queue_.pop();
+  stats_.tx_pdus++;
+  stats_.tx_bytes += next->size();
   return next;
 }
 
@@ -122,6 +153,7 @@ void LeCreditBasedDataController::SetMps(uint16_t mps) {
 }
 
 void LeCreditBasedDataController::OnCredit(uint16_t credits) {
+  stats_.credits_received += credits;
   int total_credits = credits_ + credits;
   if (total_credits > 0xffff) {
     link_->SendDisconnectionRequest(cid_, remote_cid_);
@@ -129,8 +161,8 @@ void LeCreditBasedDataController::OnCredit(uint16_t credits) {
   credits_ = total_credits;
   if (pending_frames_count_ > 0 && credits_ >= pending_frames_count_) {
     scheduler_->OnPacketsReady(cid_, pending_frames_count_);
-    pending_frames_count_ = 0;
     credits_ -= pending_frames_count_;
+    pending_frames_count_ = 0;
   } else if (pending_frames_count_ > 0) {
     scheduler_->OnPacketsReady(cid_, credits_);
     pending_frames_count_ -= credits_;
@@ -138,6 +170,43 @@ void LeCreditBasedDataController::OnCredit(uint16_t credits) {
   }
 }
 
+void LeCreditBasedDataController::SetLocalCredits(uint16_t initial_credits, uint16_t max_credits) {
+  local_credits_ = initial_credits;
+  initial_credit_window_ = std::max<uint16_t>(initial_credits, 1);
+  credit_window_ = initial_credit_window_;
+  max_credit_window_ = std::max(max_credits, credit_window_);
+}
+
+void LeCreditBasedDataController::send_credits(bool upper_layer_backlogged) {
+  if (upper_layer_backlogged) {
+    if (!waiting_for_upper_layer_) {
+      waiting_for_upper_layer_ = true;
+      stats_.rx_backlogs++;
+      credit_window_ = std::max<uint16_t>(credit_window_ / 2, initial_credit_window_);
+      enqueue_buffer_.NotifyOnEmpty(
+          common::BindOnce(&LeCreditBasedDataController::on_upper_layer_drained, common::Unretained(this)));
+    }
+    return;
+  }
+  if (waiting_for_upper_layer_ || local_credits_ > credit_window_ / 2) {
+    return;
+  }
+  if (local_credits_ == 0) {
+    stats_.rx_credit_stalls++;
+  }
+  // The peer used half of its credits and the upper layer kept up
+  credit_window_ = std::min<uint32_t>(2 * credit_window_, max_credit_window_);
+  uint16_t credits = credit_window_ - local_credits_;
+  local_credits_ = credit_window_;
+  stats_.credits_granted += credits;
+  link_->SendLeCredit(cid_, credits);
+}
+
+void LeCreditBasedDataController::on_upper_layer_drained() {
+  waiting_for_upper_layer_ = false;
+  send_credits(false);
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
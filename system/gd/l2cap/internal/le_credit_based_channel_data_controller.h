@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -44,6 +46,7 @@ class LeCreditBasedDataController : public DataController {
   using UpperQueueDownEnd = common::BidiQueueEnd<UpperEnqueue, UpperDequeue>;
   LeCreditBasedDataController(ILink* link, Cid cid, Cid remote_cid, UpperQueueDownEnd* channel_queue_end,
                               os::Handler* handler, Scheduler* scheduler);
+  ~LeCreditBasedDataController() override;
 
   void OnSdu(std::unique_ptr<packet::BasePacketBuilder> sdu) override;
   void OnPdu(packet::PacketView<true> pdu) override;
@@ -59,7 +62,36 @@ class LeCreditBasedDataController : public DataController {
   // TODO: Handle credits
   void OnCredit(uint16_t credits);
 
+  // Credits granted to the peer when the channel was opened, and the most the channel may grant. Credits are given
+  // back in batches once the peer used half of them, and the window doubles each time as long as the upper layer keeps
+  // up. When it falls behind the window halves, and credits are held back until it drained the SDUs already received.
+  void SetLocalCredits(uint16_t initial_credits, uint16_t max_credits);
+
+  struct Stats {
+    uint64_t tx_bytes = 0;
+    uint64_t rx_bytes = 0;
+    uint32_t tx_pdus = 0;
+    uint32_t rx_pdus = 0;
+    uint32_t credits_received = 0;
+    uint32_t credits_granted = 0;
+    // Times an SDU had to wait for credits from the peer
+    uint32_t tx_credit_stalls = 0;
+    // Times the peer used all the credits granted to it
+    uint32_t rx_credit_stalls = 0;
+    // Times credits were held back because the upper layer fell behind
+    uint32_t rx_backlogs = 0;
+  };
+  const Stats& GetStats() const {
+    return stats_;
+  }
+  uint16_t GetCreditWindow() const {
+    return credit_window_;
+  }
+
  private:
+  void send_credits(bool upper_layer_backlogged);
+  void on_upper_layer_drained();
+
   Cid cid_;
   Cid remote_cid_;
   os::EnqueueBuffer<UpperEnqueue> enqueue_buffer_;
@@ -71,6 +103,15 @@ class LeCreditBasedDataController : public DataController {
   uint16_t mps_ = 251;
   uint16_t credits_ = 0;
   uint16_t pending_frames_count_ = 0;
+  // Credits held by the peer, and the number of credits the peer should hold. The defaults give back one credit per
+  // PDU until SetLocalCredits() is called
+  uint16_t local_credits_ = 1;
+  uint16_t initial_credit_window_ = 1;
+  uint16_t credit_window_ = 1;
+  uint16_t max_credit_window_ = 1;
+  bool waiting_for_upper_layer_ = false;
+  Stats stats_;
+  std::chrono::steady_clock::time_point start_time_ = std::chrono::steady_clock::now();
 
   class PacketViewForReassembly : public packet::PacketView<kLittleEndian> {
    public:
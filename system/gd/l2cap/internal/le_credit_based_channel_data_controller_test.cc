@@ -179,6 +179,74 @@ TEST_F(LeCreditBasedDataControllerTest, receive_segmented_with_wrong_sdu_length)
   EXPECT_EQ(payload, nullptr);
 }
 
+std::unique_ptr<BasicFrameBuilder> CreateUnsegmentedPdu(std::vector<uint8_t> payload) {
+  auto sdu_size = payload.size();
+  return FirstLeInformationFrameBuilder::Create(0x41, sdu_size, CreateSdu(std::move(payload)));
+}
+
+TEST_F(LeCreditBasedDataControllerTest, credits_are_returned_in_batches) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetLocalCredits(4, 16);
+
+  controller.OnPdu(GetPacketView(CreateUnsegmentedPdu({'a'})));
+  sync_handler(queue_handler_);
+  // Half of the credits are used, the window grows and the peer gets back to 8 credits
+  EXPECT_CALL(link, SendLeCredit(0x41, 6));
+  controller.OnPdu(GetPacketView(CreateUnsegmentedPdu({'b'})));
+  sync_handler(queue_handler_);
+  EXPECT_EQ(controller.GetCreditWindow(), 8);
+  EXPECT_EQ(controller.GetStats().credits_granted, 6u);
+  EXPECT_EQ(controller.GetStats().rx_pdus, 2u);
+}
+
+TEST_F(LeCreditBasedDataControllerTest, credits_are_held_back_while_upper_layer_is_behind) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{1};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetLocalCredits(4, 16);
+
+  // The first SDU fills the channel queue, the second one waits for room
+  controller.OnPdu(GetPacketView(CreateUnsegmentedPdu({'a'})));
+  sync_handler(queue_handler_);
+  EXPECT_CALL(link, SendLeCredit(0x41, 6));
+  controller.OnPdu(GetPacketView(CreateUnsegmentedPdu({'b'})));
+  sync_handler(queue_handler_);
+
+  controller.OnPdu(GetPacketView(CreateUnsegmentedPdu({'c'})));
+  sync_handler(queue_handler_);
+  EXPECT_EQ(controller.GetStats().rx_backlogs, 1u);
+  EXPECT_EQ(controller.GetCreditWindow(), 4);
+
+  for (auto expected : {"a", "b", "c"}) {
+    std::unique_ptr<Scheduler::UpperEnqueue> payload;
+    for (int i = 0; i < 10 && payload == nullptr; i++) {
+      payload = channel_queue.GetUpEnd()->TryDequeue();
+      sync_handler(queue_handler_);
+    }
+    ASSERT_NE(payload, nullptr);
+    EXPECT_EQ(std::string(payload->begin(), payload->end()), expected);
+  }
+}
+
+TEST_F(LeCreditBasedDataControllerTest, window_does_not_exceed_max_credits) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetLocalCredits(2, 3);
+
+  EXPECT_CALL(link, SendLeCredit(0x41, 2));
+  controller.OnPdu(GetPacketView(CreateUnsegmentedPdu({'a'})));
+  sync_handler(queue_handler_);
+  EXPECT_EQ(controller.GetCreditWindow(), 3);
+  while (channel_queue.GetUpEnd()->TryDequeue() != nullptr) {
+  }
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
@@ -42,6 +42,10 @@ class ParameterProvider {
   virtual uint16_t GetLeInitialCredit() {
     return 100;
   }
+  // Upper bound of the credits an LE credit based channel grants to its peer as its window grows
+  virtual uint16_t GetLeMaxCredit() {
+    return 1024;
+  }
 };
 
 }  // namespace internal
@@ -163,6 +163,8 @@ class Link : public l2cap::internal::ILink,
 
   virtual uint16_t GetInitialCredit() const;
 
+  virtual uint16_t GetMaxCredit() const;
+
   void SendLeCredit(Cid local_cid, uint16_t credit) override;
 
   LinkOptions* GetLinkOptions() {
@@ -0,0 +1,600 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// End to end benchmarks of the LE data path: ACL packets go through the real
+// AclManager and L2capLeModule, between a fake HCI layer and an ATT fixed
+// channel drained or fed from a client thread. Each benchmark reports the
+// packets per second, the latency percentiles and the allocations per packet
+// of every thread of the stack.
+
+#include <bluetooth/log.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <future>
+#include <map>
+#include <mutex>
+#include <new>
+#include <set>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/bidi_queue.h"
+#include "common/bind.h"
+#include "hci/acl_manager.h"
+#include "hci/address_with_type.h"
+#include "hci/controller.h"
+#include "hci/controller_mock.h"
+#include "hci/hci_layer.h"
+#include "hci/hci_packets.h"
+#include "l2cap/cid.h"
+#include "l2cap/le/fixed_channel.h"
+#include "l2cap/le/fixed_channel_manager.h"
+#include "l2cap/le/fixed_channel_service.h"
+#include "l2cap/le/l2cap_le_module.h"
+#include "module.h"
+#include "os/handler.h"
+#include "os/queue.h"
+#include "os/thread.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+
+}  // namespace
+
+// Every allocation of the process is counted, including the ones of the stack
+// threads, to report the allocations per packet
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t /* size */) noexcept {
+  free(ptr);
+}
+
+namespace bluetooth {
+namespace l2cap {
+namespace le {
+
+namespace {
+
+constexpr uint16_t kHandle = 0x0040;
+constexpr uint16_t kNumAclBuffers = 16;
+constexpr uint16_t kLeAclPacketLength = 251;
+constexpr size_t kPayloadSize = 200;
+constexpr auto kTimeout = std::chrono::seconds(5);
+
+// Latency samples kept per benchmark, allocated before the measurements
+constexpr size_t kMaxLatencySamples = 1 << 20;
+
+packet::PacketView<packet::kLittleEndian> Serialize(std::unique_ptr<packet::BasePacketBuilder> builder) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  bytes->reserve(builder->size());
+  packet::BitInserter inserter(*bytes);
+  builder->Serialize(inserter);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+class BenchmarkController : public hci::testing::MockController {
+ public:
+  void RegisterCompletedAclPacketsCallback(
+      common::ContextualCallback<void(uint16_t /* handle */, uint16_t /* packets */)> cb) override {
+    acl_credits_callback_ = cb;
+  }
+
+  void UnregisterCompletedAclPacketsCallback() override {
+    acl_credits_callback_ = {};
+  }
+
+  uint16_t GetAclPacketLength() const override {
+    return 1021;
+  }
+
+  uint16_t GetNumAclPacketBuffers() const override {
+    return kNumAclBuffers;
+  }
+
+  bool IsSupported(hci::OpCode /* op_code */) const override {
+    return false;
+  }
+
+  hci::LeBufferSize GetLeBufferSize() const override {
+    hci::LeBufferSize le_buffer_size;
+    le_buffer_size.total_num_le_packets_ = kNumAclBuffers;
+    le_buffer_size.le_data_packet_length_ = kLeAclPacketLength;
+    return le_buffer_size;
+  }
+
+  void CompletePackets(uint16_t handle, uint16_t packets) {
+    acl_credits_callback_(handle, packets);
+  }
+
+ protected:
+  void Start() override {}
+  void Stop() override {}
+  void ListDependencies(ModuleList* /* list */) const override {}
+
+ private:
+  common::ContextualCallback<void(uint16_t /* handle */, uint16_t /* packets */)> acl_credits_callback_;
+};
+
+// HCI layer answering every command with a success, standing in for the HAL
+// and the controller
+class BenchmarkHciLayer : public hci::HciLayer {
+ public:
+  void EnqueueCommand(
+      std::unique_ptr<hci::CommandBuilder> command,
+      common::ContextualOnceCallback<void(hci::CommandStatusView)> on_status) override {
+    hci::OpCode op_code = RecordCommand(std::move(command));
+    auto status = hci::CommandStatusView::Create(hci::EventView::Create(Serialize(hci::CommandStatusBuilder::Create(
+        hci::ErrorCode::SUCCESS, 1, op_code, std::make_unique<packet::RawBuilder>()))));
+    std::move(on_status)(status);
+  }
+
+  void EnqueueCommand(
+      std::unique_ptr<hci::CommandBuilder> command,
+      common::ContextualOnceCallback<void(hci::CommandCompleteView)> on_complete) override {
+    hci::OpCode op_code = RecordCommand(std::move(command));
+    auto return_parameters =
+        std::make_unique<packet::RawBuilder>(std::vector<uint8_t>{static_cast<uint8_t>(hci::ErrorCode::SUCCESS)});
+    auto complete = hci::CommandCompleteView::Create(
+        hci::EventView::Create(Serialize(hci::CommandCompleteBuilder::Create(1, op_code, std::move(return_parameters)))));
+    std::move(on_complete)(complete);
+  }
+
+  void SetMaxOutstandingCommands(uint8_t /* max_outstanding_commands */) override {}
+
+  void RegisterEventHandler(
+      hci::EventCode event_code, common::ContextualCallback<void(hci::EventView)> event_handler) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_handlers_[event_code] = event_handler;
+  }
+
+  void UnregisterEventHandler(hci::EventCode event_code) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_handlers_.erase(event_code);
+  }
+
+  void RegisterLeEventHandler(
+      hci::SubeventCode subevent_code,
+      common::ContextualCallback<void(hci::LeMetaEventView)> event_handler) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    le_event_handlers_[subevent_code] = event_handler;
+  }
+
+  void UnregisterLeEventHandler(hci::SubeventCode subevent_code) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    le_event_handlers_.erase(subevent_code);
+  }
+
+  void RegisterVendorSpecificEventHandler(
+      hci::VseSubeventCode /* subevent_code */,
+      common::ContextualCallback<void(hci::VendorSpecificEventView)> /* event_handler */) override {}
+
+  void UnregisterVendorSpecificEventHandler(hci::VseSubeventCode /* subevent_code */) override {}
+
+  common::BidiQueueEnd<hci::AclBuilder, hci::AclView>* GetAclQueueEnd() override {
+    return acl_queue_.GetUpEnd();
+  }
+
+  // The controller side of the ACL queue
+  common::BidiQueueEnd<hci::AclView, hci::AclBuilder>* GetAclQueueDownEnd() {
+    return acl_queue_.GetDownEnd();
+  }
+
+  void WaitForCommand(hci::OpCode op_code) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool sent = command_sent_.wait_for(
+        lock, kTimeout, [this, op_code] { return sent_commands_.count(op_code) != 0; });
+    log::assert_that(sent, "{} was not sent", hci::OpCodeText(op_code));
+  }
+
+  void InjectEvent(std::unique_ptr<hci::EventBuilder> event) {
+    auto view = hci::EventView::Create(Serialize(std::move(event)));
+    log::assert_that(view.IsValid(), "assert failed: view.IsValid()");
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_handlers_.at(view.GetEventCode())(view);
+  }
+
+  void InjectLeMetaEvent(std::unique_ptr<hci::LeMetaEventBuilder> event) {
+    auto view = hci::LeMetaEventView::Create(hci::EventView::Create(Serialize(std::move(event))));
+    log::assert_that(view.IsValid(), "assert failed: view.IsValid()");
+    std::lock_guard<std::mutex> lock(mutex_);
+    le_event_handlers_.at(view.GetSubeventCode())(view);
+  }
+
+  // Hands a received ACL packet to the stack, as the HCI layer does
+  void InjectAcl(std::unique_ptr<hci::AclView> acl) {
+    incoming_acl_buffer_.Enqueue(std::move(acl), GetHandler());
+  }
+
+ protected:
+  void ListDependencies(ModuleList* /* list */) const override {}
+
+  void Start() override {
+    StartWithNoHalDependencies(GetHandler());
+  }
+
+  void Stop() override {
+    incoming_acl_buffer_.Clear();
+  }
+
+ private:
+  hci::OpCode RecordCommand(std::unique_ptr<hci::CommandBuilder> command) {
+    auto view = hci::CommandView::Create(Serialize(std::move(command)));
+    log::assert_that(view.IsValid(), "assert failed: view.IsValid()");
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_commands_.insert(view.GetOpCode());
+    command_sent_.notify_all();
+    return view.GetOpCode();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable command_sent_;
+  std::set<hci::OpCode> sent_commands_;
+  std::map<hci::EventCode, common::ContextualCallback<void(hci::EventView)>> event_handlers_;
+  std::map<hci::SubeventCode, common::ContextualCallback<void(hci::LeMetaEventView)>> le_event_handlers_;
+
+  common::BidiQueue<hci::AclView, hci::AclBuilder> acl_queue_{kNumAclBuffers};
+  os::EnqueueBuffer<hci::AclView> incoming_acl_buffer_{acl_queue_.GetDownEnd()};
+};
+
+// Latencies of the packets of a batch, from the time they are handed to one
+// end of the data path to the time they come out of the other
+class LatencyRecorder {
+ public:
+  LatencyRecorder() {
+    samples_us_.resize(kMaxLatencySamples);
+  }
+
+  void Add(std::chrono::steady_clock::time_point sent) {
+    auto latency = std::chrono::steady_clock::now() - sent;
+    samples_us_[count_++ % kMaxLatencySamples] =
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  }
+
+  void Report(State& state) {
+    size_t count = std::min(count_, kMaxLatencySamples);
+    if (count == 0) {
+      return;
+    }
+    std::sort(samples_us_.begin(), samples_us_.begin() + count);
+    state.counters["p50_us"] = samples_us_[count / 2];
+    state.counters["p99_us"] = samples_us_[std::min(count - 1, count * 99 / 100)];
+    state.counters["max_us"] = samples_us_[count - 1];
+  }
+
+ private:
+  std::vector<int64_t> samples_us_;
+  size_t count_ = 0;
+};
+
+// A LE link with its ATT fixed channel acquired by a client thread
+class LeDataPath {
+ public:
+  LeDataPath() {
+    hci_layer_ = new BenchmarkHciLayer;                            // Ownership is transferred to registry
+    controller_ = new ::testing::NiceMock<BenchmarkController>;  // Ownership is transferred to registry
+    registry_.InjectTestModule(&hci::HciLayer::Factory, hci_layer_);
+    registry_.InjectTestModule(&hci::Controller::Factory, controller_);
+    registry_.Start<L2capLeModule>(&registry_.GetTestThread());
+    hci_handler_ = registry_.GetTestModuleHandler(&hci::HciLayer::Factory);
+
+    hci::Address local_address;
+    hci::Address::FromString("D0:05:04:03:02:01", local_address);
+    registry_.GetModuleUnderTest<hci::AclManager>()->SetPrivacyPolicyForInitiatorAddress(
+        hci::LeAddressManager::AddressPolicy::USE_STATIC_ADDRESS,
+        hci::AddressWithType(local_address, hci::AddressType::RANDOM_DEVICE_ADDRESS),
+        std::chrono::minutes(7),
+        std::chrono::minutes(15));
+
+    fixed_channel_manager_ = registry_.GetModuleUnderTest<L2capLeModule>()->GetFixedChannelManager();
+    fixed_channel_manager_->RegisterService(
+        kLeAttributeCid,
+        common::BindOnce(&LeDataPath::on_registration_complete, common::Unretained(this)),
+        common::Bind(&LeDataPath::on_connection_open, common::Unretained(this)),
+        client_handler_);
+    log::assert_that(
+        registered_.get_future().wait_for(kTimeout) == std::future_status::ready, "ATT service not registered");
+
+    Connect();
+  }
+
+  LeDataPath(const LeDataPath&) = delete;
+  LeDataPath& operator=(const LeDataPath&) = delete;
+
+  ~LeDataPath() {
+    channel_->Release();
+    channel_.reset();
+    service_.reset();
+    fixed_channel_manager_.reset();
+    registry_.SynchronizeModuleHandler(&L2capLeModule::Factory, std::chrono::milliseconds(100));
+    registry_.StopAll();
+    client_handler_->Clear();
+    delete client_handler_;
+  }
+
+  // Injects |count| ACL packets and waits for the client to dequeue them all
+  void Receive(size_t count, LatencyRecorder* latencies) {
+    StartBatch(count, latencies);
+    for (size_t i = 0; i < count; i++) {
+      send_times_[i] = std::chrono::steady_clock::now();
+      std::vector<uint8_t> bytes(4 + 4 + kPayloadSize);
+      // ACL header: handle with a first automatically flushable fragment
+      // flag, then the length
+      bytes[0] = kHandle & 0xff;
+      bytes[1] = ((kHandle >> 8) & 0x0f) | 0x20;
+      bytes[2] = (4 + kPayloadSize) & 0xff;
+      bytes[3] = (4 + kPayloadSize) >> 8;
+      // L2CAP basic frame header, followed by the index of the packet
+      bytes[4] = kPayloadSize & 0xff;
+      bytes[5] = kPayloadSize >> 8;
+      bytes[6] = kLeAttributeCid & 0xff;
+      bytes[7] = kLeAttributeCid >> 8;
+      StoreIndex(bytes.data() + 8, i);
+      auto view = hci::AclView::Create(
+          packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::move(bytes))));
+      hci_layer_->InjectAcl(std::make_unique<hci::AclView>(view));
+    }
+    WaitForBatch();
+  }
+
+  // Enqueues |count| packets on the channel from the client thread and waits
+  // for them to be sent to the controller
+  void Send(size_t count, LatencyRecorder* latencies) {
+    StartBatch(count, latencies);
+    channel_->GetQueueUpEnd()->RegisterEnqueue(
+        client_handler_, common::Bind(&LeDataPath::on_channel_ready_to_send, common::Unretained(this)));
+    WaitForBatch();
+  }
+
+  void StartReceiving() {
+    channel_->GetQueueUpEnd()->RegisterDequeue(
+        client_handler_, common::Bind(&LeDataPath::on_channel_data_ready, common::Unretained(this)));
+  }
+
+  void StopReceiving() {
+    channel_->GetQueueUpEnd()->UnregisterDequeue();
+  }
+
+  void StartSending() {
+    hci_layer_->GetAclQueueDownEnd()->RegisterDequeue(
+        hci_handler_, common::Bind(&LeDataPath::on_controller_data_ready, common::Unretained(this)));
+  }
+
+  void StopSending() {
+    hci_layer_->GetAclQueueDownEnd()->UnregisterDequeue();
+  }
+
+ private:
+  void Connect() {
+    hci::Address remote_address;
+    hci::Address::FromString("A1:A2:A3:A4:A5:A6", remote_address);
+    fixed_channel_manager_->ConnectServices(
+        hci::AddressWithType(remote_address, hci::AddressType::PUBLIC_DEVICE_ADDRESS),
+        common::BindOnce(&LeDataPath::on_connection_fail),
+        client_handler_);
+
+    hci_layer_->WaitForCommand(hci::OpCode::LE_CREATE_CONNECTION);
+    hci_layer_->InjectLeMetaEvent(hci::LeConnectionCompleteBuilder::Create(
+        hci::ErrorCode::SUCCESS,
+        kHandle,
+        hci::Role::CENTRAL,
+        hci::AddressType::PUBLIC_DEVICE_ADDRESS,
+        remote_address,
+        0x0018,
+        0x0000,
+        0x01f4,
+        hci::ClockAccuracy::PPM_30));
+
+    // The fixed channels are opened once the remote version is known
+    hci_layer_->WaitForCommand(hci::OpCode::READ_REMOTE_VERSION_INFORMATION);
+    hci_layer_->InjectEvent(hci::ReadRemoteVersionInformationCompleteBuilder::Create(
+        hci::ErrorCode::SUCCESS, kHandle, 0x0c, 0x00e0, 0x0000));
+
+    auto channel_opened = channel_opened_.get_future();
+    log::assert_that(channel_opened.wait_for(kTimeout) == std::future_status::ready, "ATT channel not opened");
+    channel_->Acquire();
+  }
+
+  void on_registration_complete(
+      FixedChannelManager::RegistrationResult result, std::unique_ptr<FixedChannelService> service) {
+    log::assert_that(
+        result == FixedChannelManager::RegistrationResult::SUCCESS,
+        "assert failed: result == FixedChannelManager::RegistrationResult::SUCCESS");
+    service_ = std::move(service);
+    registered_.set_value();
+  }
+
+  void on_connection_open(std::unique_ptr<FixedChannel> channel) {
+    channel_ = std::move(channel);
+    channel_opened_.set_value();
+  }
+
+  static void on_connection_fail(FixedChannelManager::ConnectionResult result) {
+    log::fatal("LE connection failed: {}", static_cast<int>(result.connection_result_code));
+  }
+
+  void StartBatch(size_t count, LatencyRecorder* latencies) {
+    if (send_times_.size() < count) {
+      send_times_.resize(count);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_size_ = count;
+    produced_ = 0;
+    completed_ = 0;
+    latencies_ = latencies;
+  }
+
+  void WaitForBatch() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool done = batch_done_.wait_for(lock, kTimeout, [this] { return completed_ == batch_size_; });
+    log::assert_that(done, "only {} out of {} packets went through", completed_, batch_size_);
+  }
+
+  void Complete(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_->Add(send_times_[index]);
+    if (++completed_ == batch_size_) {
+      batch_done_.notify_one();
+    }
+  }
+
+  static void StoreIndex(uint8_t* data, size_t index) {
+    for (size_t i = 0; i < 4; i++) {
+      data[i] = static_cast<uint8_t>(index >> (8 * i));
+    }
+  }
+
+  template <typename Iterator>
+  static size_t LoadIndex(Iterator it) {
+    size_t index = 0;
+    for (size_t i = 0; i < 4; i++) {
+      index |= static_cast<size_t>(*(it + i)) << (8 * i);
+    }
+    return index;
+  }
+
+  // Client side of the received packets
+  void on_channel_data_ready() {
+    auto packet = channel_->GetQueueUpEnd()->TryDequeue();
+    if (packet == nullptr) {
+      return;
+    }
+    Complete(LoadIndex(packet->begin()));
+  }
+
+  // Client side of the sent packets
+  std::unique_ptr<packet::BasePacketBuilder> on_channel_ready_to_send() {
+    size_t index = produced_++;
+    if (produced_ == batch_size_) {
+      channel_->GetQueueUpEnd()->UnregisterEnqueue();
+    }
+    std::vector<uint8_t> payload(kPayloadSize);
+    StoreIndex(payload.data(), index);
+    send_times_[index] = std::chrono::steady_clock::now();
+    return std::make_unique<packet::RawBuilder>(std::move(payload));
+  }
+
+  // Controller side of the sent packets, which hands the buffer back right away
+  void on_controller_data_ready() {
+    auto acl = hci_layer_->GetAclQueueDownEnd()->TryDequeue();
+    if (acl == nullptr) {
+      return;
+    }
+    auto view = hci::AclView::Create(Serialize(std::move(acl)));
+    // Skip the ACL and L2CAP headers
+    Complete(LoadIndex(view.begin() + 8));
+    controller_->CompletePackets(kHandle, 1);
+  }
+
+  TestModuleRegistry registry_;
+  BenchmarkHciLayer* hci_layer_ = nullptr;
+  BenchmarkController* controller_ = nullptr;
+  os::Handler* hci_handler_ = nullptr;
+  os::Thread client_thread_{"benchmark_client", os::Thread::Priority::NORMAL};
+  os::Handler* client_handler_ = new os::Handler(&client_thread_);
+
+  std::unique_ptr<FixedChannelManager> fixed_channel_manager_;
+  std::unique_ptr<FixedChannelService> service_;
+  std::unique_ptr<FixedChannel> channel_;
+  std::promise<void> registered_;
+  std::promise<void> channel_opened_;
+
+  std::vector<std::chrono::steady_clock::time_point> send_times_;
+  std::mutex mutex_;
+  std::condition_variable batch_done_;
+  size_t batch_size_ = 0;
+  size_t produced_ = 0;
+  size_t completed_ = 0;
+  LatencyRecorder* latencies_ = nullptr;
+};
+
+void ReportAllocations(State& state, uint64_t allocations, size_t packets) {
+  if (packets != 0) {
+    state.counters["allocs_per_packet"] = static_cast<double>(allocations) / packets;
+  }
+}
+
+}  // namespace
+
+// Controller to client, in batches of range(0) packets. A batch of 1 gives
+// the unloaded latency, larger ones the throughput with queues filled up.
+static void BM_LeFixedChannelReceive(State& state) {
+  LeDataPath data_path;
+  LatencyRecorder latencies;
+  const size_t batch_size = state.range(0);
+  data_path.StartReceiving();
+
+  uint64_t allocations = allocation_count.load();
+  for (auto _ : state) {
+    data_path.Receive(batch_size, &latencies);
+  }
+  allocations = allocation_count.load() - allocations;
+
+  data_path.StopReceiving();
+  size_t packets = state.iterations() * batch_size;
+  state.SetItemsProcessed(packets);
+  state.SetBytesProcessed(packets * kPayloadSize);
+  latencies.Report(state);
+  ReportAllocations(state, allocations, packets);
+}
+BENCHMARK(BM_LeFixedChannelReceive)->Arg(1)->Arg(16)->Arg(128)->UseRealTime();
+
+// Client to controller, in batches of range(0) packets, the controller
+// returning each buffer as soon as it gets the packet
+static void BM_LeFixedChannelSend(State& state) {
+  LeDataPath data_path;
+  LatencyRecorder latencies;
+  const size_t batch_size = state.range(0);
+  data_path.StartSending();
+
+  uint64_t allocations = allocation_count.load();
+  for (auto _ : state) {
+    data_path.Send(batch_size, &latencies);
+  }
+  allocations = allocation_count.load() - allocations;
+
+  data_path.StopSending();
+  size_t packets = state.iterations() * batch_size;
+  state.SetItemsProcessed(packets);
+  state.SetBytesProcessed(packets * kPayloadSize);
+  latencies.Report(state);
+  ReportAllocations(state, allocations, packets);
+}
+BENCHMARK(BM_LeFixedChannelSend)->Arg(1)->Arg(16)->Arg(128)->UseRealTime();
+
+}  // namespace le
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -17,6 +17,7 @@
 #include <memory>
 
 #include "hci/acl_manager.h"
+#include "hci/controller.h"
 #include "l2cap/internal/parameter_provider.h"
 #include "l2cap/le/internal/dynamic_channel_service_manager_impl.h"
 #include "l2cap/le/internal/fixed_channel_service_manager_impl.h"
@@ -52,14 +53,42 @@ class SecurityEnforcementRejectAllImpl : public SecurityEnforcementInterface {
 };
 static SecurityEnforcementRejectAllImpl default_security_module_impl_;
 
+/**
+ * Parameters matched to the LE ACL buffers of the controller
+ */
+class LeParameterProvider : public l2cap::internal::ParameterProvider {
+ public:
+  explicit LeParameterProvider(hci::LeBufferSize le_buffer_size) : le_buffer_size_(le_buffer_size) {}
+
+  // Largest MPS, up to the default one, for which a full basic frame fills a whole number of LE ACL data packets.
+  // Falls back to the default when the controller packets are larger than a default frame
+  uint16_t GetLeMps() override {
+    constexpr uint16_t kBasicFrameHeaderSize = 4;
+    constexpr uint16_t kMinLeMps = 23;
+    uint16_t mps = ParameterProvider::GetLeMps();
+    uint16_t packet_length = le_buffer_size_.le_data_packet_length_;
+    if (packet_length == 0) {
+      return mps;
+    }
+    uint16_t frame_size = (mps + kBasicFrameHeaderSize) / packet_length * packet_length;
+    if (frame_size < kBasicFrameHeaderSize + kMinLeMps) {
+      return mps;
+    }
+    return frame_size - kBasicFrameHeaderSize;
+  }
+
+ private:
+  hci::LeBufferSize le_buffer_size_;
+};
+
 struct L2capLeModule::impl {
-  impl(os::Handler* l2cap_handler, hci::AclManager* acl_manager)
-      : l2cap_handler_(l2cap_handler), acl_manager_(acl_manager) {
+  impl(os::Handler* l2cap_handler, hci::AclManager* acl_manager, hci::Controller* controller)
+      : l2cap_handler_(l2cap_handler), acl_manager_(acl_manager), parameter_provider_(controller->GetLeBufferSize()) {
     dynamic_channel_service_manager_impl_.SetSecurityEnforcementInterface(&default_security_module_impl_);
   }
   os::Handler* l2cap_handler_;
   hci::AclManager* acl_manager_;
-  l2cap::internal::ParameterProvider parameter_provider_;
+  LeParameterProvider parameter_provider_;
   internal::FixedChannelServiceManagerImpl fixed_channel_service_manager_impl_{l2cap_handler_};
   internal::DynamicChannelServiceManagerImpl dynamic_channel_service_manager_impl_{l2cap_handler_};
   internal::LinkManager link_manager_{l2cap_handler_,
@@ -74,10 +103,11 @@ L2capLeModule::~L2capLeModule() {}
 
 void L2capLeModule::ListDependencies(ModuleList* list) const {
   list->add<hci::AclManager>();
+  list->add<hci::Controller>();
 }
 
 void L2capLeModule::Start() {
-  pimpl_ = std::make_unique<impl>(GetHandler(), GetDependency<hci::AclManager>());
+  pimpl_ = std::make_unique<impl>(GetHandler(), GetDependency<hci::AclManager>(), GetDependency<hci::Controller>());
 }
 
 void L2capLeModule::Stop() {
@@ -19,6 +19,9 @@
 
 #include <bluetooth/log.h>
 
+#include <climits>
+#include <limits>
+
 #include "common/bind.h"
 #include "os/log.h"
 #include "os/metrics.h"
@@ -28,6 +31,37 @@ namespace metrics {
 
 const int COUNTER_METRICS_PERDIOD_MINUTES = 360; // Drain counters every 6 hours
 
+namespace {
+
+// Marks the free slots of the shards, not a counter key in use
+constexpr int32_t kFreeKey = std::numeric_limits<int32_t>::min();
+
+size_t CurrentShardIndex() {
+  static std::atomic<size_t> next_shard_index{0};
+  thread_local const size_t shard_index =
+      next_shard_index.fetch_add(1, std::memory_order_relaxed) % CounterMetrics::kNumShards;
+  return shard_index;
+}
+
+// Adds |count| to |total|, saturating it. Returns false if it saturated.
+bool AddSaturated(int64_t& total, int64_t count) {
+  if (LLONG_MAX - total < count) {
+    total = LLONG_MAX;
+    return false;
+  }
+  total += count;
+  return true;
+}
+
+}  // namespace
+
+CounterMetrics::CounterShard::CounterShard() {
+  for (size_t i = 0; i < kNumKeysPerShard; i++) {
+    keys[i].store(kFreeKey, std::memory_order_relaxed);
+    values[i].store(0, std::memory_order_relaxed);
+  }
+}
+
 const ModuleFactory CounterMetrics::Factory = ModuleFactory([]() { return new CounterMetrics(); });
 
 void CounterMetrics::ListDependencies(ModuleList* /* list */) const {}
@@ -50,6 +84,26 @@ void CounterMetrics::Stop() {
   log::info("Counter metrics canceled");
 }
 
+std::atomic<int64_t>* CounterMetrics::FindShardCounter(CounterShard& shard, int32_t key) {
+  if (key == kFreeKey) {
+    return nullptr;
+  }
+  size_t start = static_cast<uint32_t>(key) % kNumKeysPerShard;
+  for (size_t probe = 0; probe < kNumKeysPerShard; probe++) {
+    size_t slot = (start + probe) % kNumKeysPerShard;
+    int32_t slot_key = shard.keys[slot].load(std::memory_order_acquire);
+    // On failure, slot_key is updated to the key which claimed the slot first
+    if (slot_key == kFreeKey &&
+        shard.keys[slot].compare_exchange_strong(slot_key, key, std::memory_order_acq_rel)) {
+      return &shard.values[slot];
+    }
+    if (slot_key == key) {
+      return &shard.values[slot];
+    }
+  }
+  return nullptr;
+}
+
 bool CounterMetrics::CacheCount(int32_t key, int64_t count) {
   if (!IsInitialized()) {
     log::warn("Counter metrics isn't initialized");
@@ -59,17 +113,32 @@ bool CounterMetrics::CacheCount(int32_t key, int64_t count) {
     log::warn("count is not larger than 0. count: {}, key: {}", count, key);
     return false;
   }
-  int64_t total = 0;
-  std::lock_guard<std::mutex> lock(mutex_);
-  if (counters_.find(key) != counters_.end()) {
-    total = counters_[key];
+
+  std::atomic<int64_t>* counter = FindShardCounter(shards_[CurrentShardIndex()], key);
+  if (counter == nullptr) {
+    return CacheCountLocked(key, count);
   }
-  if (LLONG_MAX - total < count) {
+  int64_t total = counter->load(std::memory_order_relaxed);
+  int64_t new_total;
+  bool added;
+  do {
+    new_total = total;
+    added = AddSaturated(new_total, count);
+  } while (!counter->compare_exchange_weak(total, new_total, std::memory_order_relaxed));
+  if (!added) {
     log::warn("Counter metric overflows. count {} current total: {} key: {}", count, total, key);
-    counters_[key] = LLONG_MAX;
+  }
+  return added;
+}
+
+bool CounterMetrics::CacheCountLocked(int32_t key, int64_t count) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t& total = counters_[key];
+  int64_t previous_total = total;
+  if (!AddSaturated(total, count)) {
+    log::warn("Counter metric overflows. count {} current total: {} key: {}", count, previous_total, key);
     return false;
   }
-  counters_[key] = total + count;
   return true;
 }
 
@@ -93,6 +162,18 @@ void CounterMetrics::DrainBufferedCounters() {
   }
   std::lock_guard<std::mutex> lock(mutex_);
   log::info("Draining buffered counters");
+  for (auto& shard : shards_) {
+    for (size_t slot = 0; slot < kNumKeysPerShard; slot++) {
+      int32_t key = shard.keys[slot].load(std::memory_order_acquire);
+      if (key == kFreeKey) {
+        continue;
+      }
+      int64_t count = shard.values[slot].exchange(0, std::memory_order_relaxed);
+      if (count != 0 && !AddSaturated(counters_[key], count)) {
+        log::warn("Counter metric overflows while draining. key: {}", key);
+      }
+    }
+  }
   for (auto const& pair : counters_) {
     Count(pair.first, pair.second);
   }
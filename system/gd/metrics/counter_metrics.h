@@ -15,6 +15,10 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <unordered_map>
 
 #include "module.h"
@@ -23,8 +27,15 @@
 namespace bluetooth {
 namespace metrics {
 
+// Counters are cached in shards, each thread updating the shard it was
+// assigned with atomic operations only, and merged when they are drained.
 class CounterMetrics : public bluetooth::Module {
  public:
+  static constexpr size_t kNumShards = 8;
+  static constexpr size_t kNumKeysPerShard = 128;
+
+  // Adds |value| to the cached counter |key|. Returns false if the counter is
+  // not cached or saturated.
   bool CacheCount(int32_t key, int64_t value);
   virtual bool Count(int32_t key, int64_t count);
   void Stop() override;
@@ -42,6 +53,19 @@ class CounterMetrics : public bluetooth::Module {
   }
 
  private:
+  // Open addressing table of the counters updated through the shard. Keys are
+  // only ever added, the set of counter keys being small and fixed.
+  struct alignas(64) CounterShard {
+    CounterShard();
+    std::array<std::atomic<int32_t>, kNumKeysPerShard> keys;
+    std::array<std::atomic<int64_t>, kNumKeysPerShard> values;
+  };
+
+  std::atomic<int64_t>* FindShardCounter(CounterShard& shard, int32_t key);
+  bool CacheCountLocked(int32_t key, int64_t count);
+
+  std::array<CounterShard, kNumShards> shards_;
+  // Counters merged from the shards, and the ones which did not fit in them
   std::unordered_map<int32_t, int64_t> counters_;
   mutable std::mutex mutex_;
   std::unique_ptr<os::RepeatingAlarm> alarm_;
@@ -16,7 +16,9 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -87,6 +89,38 @@ TEST_F(CounterMetricsTest, non_positive) {
   ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 5);
 }
 
+TEST_F(CounterMetricsTest, more_keys_than_shard_slots) {
+  const int32_t num_keys = CounterMetrics::kNumKeysPerShard + 10;
+  for (int32_t key = 0; key < num_keys; key++) {
+    ASSERT_TRUE(testable_counter_metrics_.CacheCount(key, key + 1));
+    ASSERT_TRUE(testable_counter_metrics_.CacheCount(key, 1));
+  }
+  testable_counter_metrics_.DrainBuffer();
+  for (int32_t key = 0; key < num_keys; key++) {
+    ASSERT_EQ(testable_counter_metrics_.test_counters_[key], key + 2);
+  }
+}
+
+TEST_F(CounterMetricsTest, multiple_threads) {
+  const int num_threads = CounterMetrics::kNumShards + 2;
+  const int num_counts = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([this]() {
+      for (int j = 0; j < num_counts; j++) {
+        testable_counter_metrics_.CacheCount(1, 1);
+        testable_counter_metrics_.CacheCount(2, 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[1], num_threads * num_counts);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[2], 2 * num_threads * num_counts);
+}
+
 }  // namespace
 }  // namespace metrics
 }  // namespace bluetooth
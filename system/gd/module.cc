@@ -19,6 +19,9 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "common/init_flags.h"
 
 using ::bluetooth::os::Handler;
@@ -97,13 +100,98 @@ Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
   log::info("Finished starting dependencies and calling Start() of {}", instance->ToString());
 
   last_instance_ = "starting " + instance->ToString();
+  auto start_time = std::chrono::steady_clock::now();
+  if (start_times_.empty()) {
+    first_start_time_ = start_time;
+  }
   instance->Start();
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start_time);
   start_order_.push_back(module);
   started_modules_[module] = instance;
-  log::info("Started {}", instance->ToString());
+  start_times_.push_back(
+      {instance->ToString(),
+       std::chrono::duration_cast<std::chrono::microseconds>(start_time - first_start_time_),
+       duration});
+  log::info("Started {} in {} us", instance->ToString(), duration.count());
   return instance;
 }
 
+void ModuleRegistry::StartInParallel(ModuleList* modules, Thread* thread) {
+  // Construct all the modules to be started, and collect their dependencies.
+  std::vector<std::pair<const ModuleFactory*, Module*>> pending;
+  std::vector<const ModuleFactory*> to_construct(modules->list_.begin(), modules->list_.end());
+  for (size_t i = 0; i < to_construct.size(); i++) {
+    const ModuleFactory* module = to_construct[i];
+    if (IsStarted(module) ||
+        std::any_of(pending.begin(), pending.end(), [module](auto& entry) { return entry.first == module; })) {
+      continue;
+    }
+    Module* instance = module->ctor_();
+    set_registry_and_handler(instance, thread);
+    instance->ListDependencies(&instance->dependencies_);
+    to_construct.insert(
+        to_construct.end(), instance->dependencies_.list_.begin(), instance->dependencies_.list_.end());
+    pending.emplace_back(module, instance);
+  }
+
+  if (start_times_.empty()) {
+    first_start_time_ = std::chrono::steady_clock::now();
+  }
+
+  while (!pending.empty()) {
+    std::vector<std::pair<const ModuleFactory*, Module*>> wave;
+    for (auto& entry : pending) {
+      auto& dependencies = entry.second->dependencies_.list_;
+      if (std::all_of(dependencies.begin(), dependencies.end(), [this](auto* dependency) {
+            return IsStarted(dependency);
+          })) {
+        wave.push_back(entry);
+      }
+    }
+    log::assert_that(!wave.empty(), "Circular dependency between the modules to be started");
+
+    last_instance_ = "starting";
+    for (auto& [module, instance] : wave) {
+      last_instance_ += " " + instance->ToString();
+    }
+    log::info("Starting {} modules in parallel", wave.size());
+
+    // The registry is only read while the modules of the wave are starting.
+    std::vector<ModuleStartTime> start_times(wave.size());
+    auto start = [this, &wave, &start_times](size_t i) {
+      Module* instance = wave[i].second;
+      auto start_time = std::chrono::steady_clock::now();
+      instance->Start();
+      start_times[i] = {
+          instance->ToString(),
+          std::chrono::duration_cast<std::chrono::microseconds>(start_time - first_start_time_),
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time)};
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < wave.size(); i++) {
+      threads.emplace_back(start, i);
+    }
+    start(0);
+    for (auto& start_thread : threads) {
+      start_thread.join();
+    }
+
+    for (size_t i = 0; i < wave.size(); i++) {
+      start_order_.push_back(wave[i].first);
+      started_modules_[wave[i].first] = wave[i].second;
+      start_times_.push_back(start_times[i]);
+      log::info("Started {} in {} us", start_times[i].name, start_times[i].duration.count());
+    }
+    pending.erase(
+        std::remove_if(
+            pending.begin(),
+            pending.end(),
+            [this](auto& entry) { return IsStarted(entry.first); }),
+        pending.end());
+  }
+}
+
 void ModuleRegistry::StopAll() {
   // Since modules were brought up in dependency order, it is safe to tear down by going in reverse order.
   for (auto it = start_order_.rbegin(); it != start_order_.rend(); it++) {
@@ -130,6 +218,7 @@ void ModuleRegistry::StopAll() {
 
   log::assert_that(started_modules_.empty(), "assert failed: started_modules_.empty()");
   start_order_.clear();
+  start_times_.clear();
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
@@ -156,9 +156,28 @@ class ModuleRegistry {
 
   Module* Start(const ModuleFactory* id, ::bluetooth::os::Thread* thread);
 
+  // Start all the modules on this list and their dependencies in waves:
+  // the modules of a wave have all their dependencies started, and are
+  // started concurrently. A module can only rely on its listed dependencies
+  // being started, not on the other modules started before it in the list.
+  void StartInParallel(ModuleList* modules, ::bluetooth::os::Thread* thread);
+
   // Stop all running modules in reverse order of start
   void StopAll();
 
+  struct ModuleStartTime {
+    std::string name;
+    // Time elapsed since the first module started
+    std::chrono::microseconds start_offset;
+    // Duration of the module Start(), excluding the start of its dependencies
+    std::chrono::microseconds duration;
+  };
+
+  // Start time of the modules in start order, kept until StopAll()
+  const std::vector<ModuleStartTime>& GetStartTimes() const {
+    return start_times_;
+  }
+
  protected:
   Module* Get(const ModuleFactory* module) const;
 
@@ -169,6 +188,8 @@ class ModuleRegistry {
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
   std::string last_instance_;
+  std::chrono::steady_clock::time_point first_start_time_;
+  std::vector<ModuleStartTime> start_times_;
 };
 
 class TestModuleRegistry : public ModuleRegistry {
@@ -17,6 +17,8 @@
 
 #include "module_dumper.h"
 
+#include <chrono>
+#include <cstdio>
 #include <sstream>
 
 #include "common/init_flags.h"
@@ -28,25 +30,54 @@ using ::bluetooth::os::WakelockManager;
 
 namespace bluetooth {
 
-void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) const {
-  log::assert_that(output != nullptr, "assert failed: output != nullptr");
-
-  flatbuffers::FlatBufferBuilder builder(1024);
-  auto title = builder.CreateString(title_);
+DumpsysDataFinisher ModuleDumper::GetCommonDumpsysData(flatbuffers::FlatBufferBuilder* builder) const {
+  auto title = builder->CreateString(title_);
 
-  common::InitFlagsDataBuilder init_flags_builder(builder);
-  init_flags_builder.add_title(builder.CreateString("----- Init Flags -----"));
+  common::InitFlagsDataBuilder init_flags_builder(*builder);
+  init_flags_builder.add_title(builder->CreateString("----- Init Flags -----"));
   std::vector<flatbuffers::Offset<common::InitFlagValue>> flags;
   for (const auto& flag : common::init_flags::dump()) {
     flags.push_back(common::CreateInitFlagValue(
-        builder,
-        builder.CreateString(std::string(flag.flag)),
-        builder.CreateString(std::string(flag.value))));
+        *builder,
+        builder->CreateString(std::string(flag.flag)),
+        builder->CreateString(std::string(flag.value))));
   }
-  init_flags_builder.add_values(builder.CreateVector(flags));
+  init_flags_builder.add_values(builder->CreateVector(flags));
   auto init_flags_offset = init_flags_builder.Finish();
 
-  auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
+  auto wakelock_offset = WakelockManager::Get().GetDumpsysData(builder);
+
+  auto startup_trace_title = builder->CreateString("----- Startup Trace -----");
+  std::vector<flatbuffers::Offset<ModuleStartTimeData>> start_times;
+  uint64_t total_duration_us = 0;
+  for (const auto& start_time : module_registry_.GetStartTimes()) {
+    start_times.push_back(CreateModuleStartTimeData(
+        *builder,
+        builder->CreateString(start_time.name),
+        start_time.start_offset.count(),
+        start_time.duration.count()));
+    total_duration_us = (start_time.start_offset + start_time.duration).count();
+  }
+  auto start_times_offset = builder->CreateVector(start_times);
+  StartupTraceDataBuilder startup_trace_builder(*builder);
+  startup_trace_builder.add_title(startup_trace_title);
+  startup_trace_builder.add_total_duration_us(total_duration_us);
+  startup_trace_builder.add_modules(start_times_offset);
+  auto startup_trace_offset = startup_trace_builder.Finish();
+
+  return [title, init_flags_offset, wakelock_offset, startup_trace_offset](DumpsysDataBuilder* data_builder) {
+    data_builder->add_title(title);
+    data_builder->add_init_flags(init_flags_offset);
+    data_builder->add_wakelock_manager_data(wakelock_offset);
+    data_builder->add_startup_trace_data(startup_trace_offset);
+  };
+}
+
+void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) const {
+  log::assert_that(output != nullptr, "assert failed: output != nullptr");
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto common_data = GetCommonDumpsysData(&builder);
 
   std::queue<DumpsysDataFinisher> queue;
   for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend();
@@ -61,9 +92,7 @@ void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) c
   }
 
   DumpsysDataBuilder data_builder(builder);
-  data_builder.add_title(title);
-  data_builder.add_init_flags(init_flags_offset);
-  data_builder.add_wakelock_manager_data(wakelock_offset);
+  common_data(&data_builder);
 
   while (!queue.empty()) {
     queue.front()(&data_builder);
@@ -74,4 +103,54 @@ void ModuleDumper::DumpState(std::string* output, std::ostringstream& /*oss*/) c
   *output = std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
 }
 
+void ModuleDumper::DumpStateBySection(
+    const DumpsysSectionWriter& writer, std::chrono::milliseconds module_time_budget) const {
+  auto write_section = [&writer](flatbuffers::FlatBufferBuilder* builder, const DumpsysDataFinisher& finisher) {
+    DumpsysDataBuilder data_builder(*builder);
+    finisher(&data_builder);
+    builder->Finish(data_builder.Finish());
+    std::string section(builder->GetBufferPointer(), builder->GetBufferPointer() + builder->GetSize());
+    writer(&section);
+  };
+
+  {
+    flatbuffers::FlatBufferBuilder builder(1024);
+    write_section(&builder, GetCommonDumpsysData(&builder));
+  }
+
+  for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend();
+       it++) {
+    auto instance = module_registry_.started_modules_.find(*it);
+    log::assert_that(
+        instance != module_registry_.started_modules_.end(),
+        "assert failed: instance != module_registry_.started_modules_.end()");
+    log::verbose("Starting dumpsys module:{}", instance->second->ToString());
+
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto start_time = std::chrono::steady_clock::now();
+    auto finisher = instance->second->GetDumpsysData(&builder);
+    auto duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    // Modules without dumpsys data do not build anything
+    if (builder.GetSize() != 0) {
+      write_section(&builder, finisher);
+    }
+
+    if (duration > module_time_budget) {
+      log::warn(
+          "Dumpsys of module:{} took {} ms, over its {} ms budget",
+          instance->second->ToString(),
+          duration.count(),
+          module_time_budget.count());
+      dprintf(
+          fd_,
+          "Dumpsys of module:%s took %lld ms, over its %lld ms budget\n",
+          instance->second->ToString().c_str(),
+          static_cast<long long>(duration.count()),
+          static_cast<long long>(module_time_budget.count()));
+    }
+    log::verbose("Finished dumpsys module:{}", instance->second->ToString());
+  }
+}
+
 }  // namespace bluetooth
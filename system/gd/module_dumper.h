@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <sstream>
 #include <string>
 
@@ -25,13 +27,29 @@ namespace bluetooth {
 
 class ModuleRegistry;
 
+// Receives a section of the dumpsys: a finished DumpsysData flatbuffer holding
+// part of the state. The section is released once the writer returns.
+using DumpsysSectionWriter = std::function<void(std::string* section)>;
+
 class ModuleDumper {
  public:
-  ModuleDumper(int /*fd*/, const ModuleRegistry& module_registry, const char* title)
-      : module_registry_(module_registry), title_(title) {}
+  ModuleDumper(int fd, const ModuleRegistry& module_registry, const char* title)
+      : fd_(fd), module_registry_(module_registry), title_(title) {}
+
+  // Builds the whole state in a single DumpsysData flatbuffer
   void DumpState(std::string* output, std::ostringstream& oss) const;
 
+  // Builds the state one section at a time, so that only one is held in
+  // memory: the title, init flags, wakelocks and startup trace first, then one
+  // section per module with dumpsys data, in reverse start order. The modules
+  // taking longer than |module_time_budget| to dump are reported to the fd.
+  void DumpStateBySection(
+      const DumpsysSectionWriter& writer, std::chrono::milliseconds module_time_budget) const;
+
  private:
+  DumpsysDataFinisher GetCommonDumpsysData(flatbuffers::FlatBufferBuilder* builder) const;
+
+  const int fd_;
   const ModuleRegistry& module_registry_;
   const std::string title_;
 };
@@ -21,6 +21,7 @@
 #include <functional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "dumpsys_data_generated.h"
 #include "gtest/gtest.h"
@@ -275,6 +276,49 @@ TEST_F(ModuleTest, two_dependencies) {
   EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
 }
 
+TEST_F(ModuleTest, two_dependencies_in_parallel) {
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->StartInParallel(&list, thread_);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleTwoDependencies>());
+
+  // The independent modules are started in the first wave.
+  auto& start_times = registry_->GetStartTimes();
+  ASSERT_EQ(4u, start_times.size());
+  EXPECT_EQ("TestModuleOneDependency", start_times[2].name);
+  EXPECT_EQ("TestModuleTwoDependencies", start_times[3].name);
+
+  registry_->StopAll();
+
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
+}
+
+TEST_F(ModuleTest, start_times) {
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->Start(&list, thread_);
+
+  // Modules are listed in start order.
+  auto& start_times = registry_->GetStartTimes();
+  ASSERT_EQ(4u, start_times.size());
+  EXPECT_EQ("TestModuleNoDependency", start_times[0].name);
+  EXPECT_EQ(std::chrono::microseconds(0), start_times[0].start_offset);
+  EXPECT_EQ("TestModuleTwoDependencies", start_times[3].name);
+  for (size_t i = 1; i < start_times.size(); i++) {
+    EXPECT_LE(start_times[i - 1].start_offset + start_times[i - 1].duration, start_times[i].start_offset);
+  }
+
+  registry_->StopAll();
+  EXPECT_TRUE(registry_->GetStartTimes().empty());
+}
+
 void post_to_module_one_handler() {
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
   test_module_one_dependency_handler->Post(common::BindOnce([] { FAIL(); }));
@@ -306,6 +350,10 @@ TEST_F(ModuleTest, dump_state) {
   auto test_data = data->module_unittest_data();
   EXPECT_STREQ("Initial Test String", test_data->title()->c_str());
 
+  auto startup_trace_data = data->startup_trace_data();
+  ASSERT_EQ(1u, startup_trace_data->modules()->size());
+  EXPECT_STREQ("TestModuleDumpState", startup_trace_data->modules()->Get(0)->name()->c_str());
+
   TestModuleDumpState* test_module =
       static_cast<TestModuleDumpState*>(registry_->Start(&TestModuleDumpState::Factory, nullptr));
   test_module->test_string_ = "A Second Test String";
@@ -321,5 +369,32 @@ TEST_F(ModuleTest, dump_state) {
   registry_->StopAll();
 }
 
+TEST_F(ModuleTest, dump_state_by_section) {
+  static const char* title = "Test Dump Title";
+  ModuleList list;
+  list.add<TestModuleDumpState>();
+  registry_->Start(&list, thread_);
+
+  ModuleDumper dumper(STDOUT_FILENO, *registry_, title);
+
+  std::vector<std::string> sections;
+  dumper.DumpStateBySection(
+      [&sections](std::string* section) { sections.push_back(*section); }, std::chrono::milliseconds(100));
+
+  // TestModuleNoDependency, started as a dependency, has no dumpsys data
+  ASSERT_EQ(2u, sections.size());
+
+  auto data = flatbuffers::GetRoot<DumpsysData>(sections[0].data());
+  EXPECT_STREQ(title, data->title()->c_str());
+  EXPECT_EQ(nullptr, data->module_unittest_data());
+  ASSERT_EQ(1u, data->startup_trace_data()->modules()->size());
+
+  data = flatbuffers::GetRoot<DumpsysData>(sections[1].data());
+  EXPECT_EQ(nullptr, data->title());
+  EXPECT_STREQ("Initial Test String", data->module_unittest_data()->title()->c_str());
+
+  registry_->StopAll();
+}
+
 }  // namespace
 }  // namespace bluetooth
@@ -23,12 +23,16 @@
 #include <bluetooth/log.h>
 #include <statslog_bt.h>
 
+#include <optional>
+#include <string>
+
 #include "common/audit_log.h"
 #include "common/metric_id_manager.h"
 #include "common/strings.h"
 #include "hci/hci_packets.h"
 #include "metrics/metrics_state.h"
 #include "os/log.h"
+#include "os/metrics_writer.h"
 
 namespace fmt {
 template <>
@@ -72,58 +76,67 @@ void LogMetricLinkLayerConnectionEvent(
     uint16_t cmd_status,
     uint16_t reason_code) {
   int metric_id = 0;
+  std::optional<Address> remote_address;
   if (address != nullptr) {
     metric_id = MetricIdManager::GetInstance().AllocateId(*address);
+    remote_address = *address;
   }
-  int ret = stats_write(
-      BLUETOOTH_LINK_LAYER_CONNECTION_EVENT,
-      byteField,
-      connection_handle,
-      direction,
-      link_type,
-      hci_cmd,
-      hci_event,
-      hci_ble_event,
-      cmd_status,
-      reason_code,
-      metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed to log status {} , reason {}, from cmd {}, event {},  ble_event {}, for {}, handle "
-        "{}, type {}, error {}",
-        common::ToHexString(cmd_status),
-        common::ToHexString(reason_code),
-        common::ToHexString(hci_cmd),
-        common::ToHexString(hci_event),
-        common::ToHexString(hci_ble_event),
-        address ? ADDRESS_TO_LOGGABLE_CSTR(*address) : "(NULL)",
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_LINK_LAYER_CONNECTION_EVENT,
+        byteField,
         connection_handle,
-        common::ToHexString(link_type),
-        ret);
-  }
+        direction,
+        link_type,
+        hci_cmd,
+        hci_event,
+        hci_ble_event,
+        cmd_status,
+        reason_code,
+        metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed to log status {} , reason {}, from cmd {}, event {},  ble_event {}, for {}, handle "
+          "{}, type {}, error {}",
+          common::ToHexString(cmd_status),
+          common::ToHexString(reason_code),
+          common::ToHexString(hci_cmd),
+          common::ToHexString(hci_event),
+          common::ToHexString(hci_ble_event),
+          remote_address ? ADDRESS_TO_LOGGABLE_CSTR(*remote_address) : "(NULL)",
+          connection_handle,
+          common::ToHexString(link_type),
+          ret);
+    }
+  });
 }
 
 void LogMetricHciTimeoutEvent(uint32_t hci_cmd) {
-  int ret = stats_write(BLUETOOTH_HCI_TIMEOUT_REPORTED, static_cast<int64_t>(hci_cmd));
-  if (ret < 0) {
-    log::warn("Failed for opcode {}, error {}", common::ToHexString(hci_cmd), ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(BLUETOOTH_HCI_TIMEOUT_REPORTED, static_cast<int64_t>(hci_cmd));
+    if (ret < 0) {
+      log::warn("Failed for opcode {}, error {}", common::ToHexString(hci_cmd), ret);
+    }
+  });
 }
 
 void LogMetricRemoteVersionInfo(
     uint16_t handle, uint8_t status, uint8_t version, uint16_t manufacturer_name, uint16_t subversion) {
-  int ret = stats_write(BLUETOOTH_REMOTE_VERSION_INFO_REPORTED, handle, status, version, manufacturer_name, subversion);
-  if (ret < 0) {
-    log::warn(
-        "Failed for handle {}, status {}, version {}, manufacturer_name {}, subversion {}, error "
-        "{}",
-        handle,
-        common::ToHexString(status),
-        common::ToHexString(version),
-        common::ToHexString(manufacturer_name),
-        common::ToHexString(subversion),
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret =
+        stats_write(BLUETOOTH_REMOTE_VERSION_INFO_REPORTED, handle, status, version, manufacturer_name, subversion);
+    if (ret < 0) {
+      log::warn(
+          "Failed for handle {}, status {}, version {}, manufacturer_name {}, subversion {}, error "
+          "{}",
+          handle,
+          common::ToHexString(status),
+          common::ToHexString(version),
+          common::ToHexString(manufacturer_name),
+          common::ToHexString(subversion),
+          ret);
+    }
+  });
 }
 
 void LogMetricA2dpAudioUnderrunEvent(
@@ -133,16 +146,18 @@ void LogMetricA2dpAudioUnderrunEvent(
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
   int64_t encoding_interval_nanos = encoding_interval_millis * 1000000;
-  int ret = stats_write(
-      BLUETOOTH_A2DP_AUDIO_UNDERRUN_REPORTED, byteField, encoding_interval_nanos, num_missing_pcm_bytes, metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, encoding_interval_nanos {}, num_missing_pcm_bytes {}, error {}",
-        address,
-        encoding_interval_nanos,
-        num_missing_pcm_bytes,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_A2DP_AUDIO_UNDERRUN_REPORTED, byteField, encoding_interval_nanos, num_missing_pcm_bytes, metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, encoding_interval_nanos {}, num_missing_pcm_bytes {}, error {}",
+          address,
+          encoding_interval_nanos,
+          num_missing_pcm_bytes,
+          ret);
+    }
+  });
 }
 
 void LogMetricA2dpAudioOverrunEvent(
@@ -157,25 +172,27 @@ void LogMetricA2dpAudioOverrunEvent(
   }
 
   int64_t encoding_interval_nanos = encoding_interval_millis * 1000000;
-  int ret = stats_write(
-      BLUETOOTH_A2DP_AUDIO_OVERRUN_REPORTED,
-      byteField,
-      encoding_interval_nanos,
-      num_dropped_buffers,
-      num_dropped_encoded_frames,
-      num_dropped_encoded_bytes,
-      metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed to log for {}, encoding_interval_nanos {}, num_dropped_buffers {}, "
-        "num_dropped_encoded_frames {}, num_dropped_encoded_bytes {}, error {}",
-        address,
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_A2DP_AUDIO_OVERRUN_REPORTED,
+        byteField,
         encoding_interval_nanos,
         num_dropped_buffers,
         num_dropped_encoded_frames,
         num_dropped_encoded_bytes,
-        ret);
-  }
+        metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed to log for {}, encoding_interval_nanos {}, num_dropped_buffers {}, "
+          "num_dropped_encoded_frames {}, num_dropped_encoded_bytes {}, error {}",
+          address,
+          encoding_interval_nanos,
+          num_dropped_buffers,
+          num_dropped_encoded_frames,
+          num_dropped_encoded_bytes,
+          ret);
+    }
+  });
 }
 
 void LogMetricA2dpPlaybackEvent(const Address& address, int playback_state, int audio_coding_mode) {
@@ -184,15 +201,18 @@ void LogMetricA2dpPlaybackEvent(const Address& address, int playback_state, int
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
 
-  int ret = stats_write(BLUETOOTH_A2DP_PLAYBACK_STATE_CHANGED, byteField, playback_state, audio_coding_mode, metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed to log for {}, playback_state {}, audio_coding_mode {},error {}",
-        address,
-        playback_state,
-        audio_coding_mode,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret =
+        stats_write(BLUETOOTH_A2DP_PLAYBACK_STATE_CHANGED, byteField, playback_state, audio_coding_mode, metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed to log for {}, playback_state {}, audio_coding_mode {},error {}",
+          address,
+          playback_state,
+          audio_coding_mode,
+          ret);
+    }
+  });
 }
 
 void LogMetricA2dpSessionMetricsEvent(
@@ -226,16 +246,18 @@ void LogMetricReadRssiResult(const Address& address, uint16_t handle, uint32_t c
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(BLUETOOTH_DEVICE_RSSI_REPORTED, byteField, handle, cmd_status, rssi, metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, handle {}, status {}, rssi {} dBm, error {}",
-        address,
-        handle,
-        common::ToHexString(cmd_status),
-        rssi,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(BLUETOOTH_DEVICE_RSSI_REPORTED, byteField, handle, cmd_status, rssi, metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, handle {}, status {}, rssi {} dBm, error {}",
+          address,
+          handle,
+          common::ToHexString(cmd_status),
+          rssi,
+          ret);
+    }
+  });
 }
 
 void LogMetricReadFailedContactCounterResult(
@@ -244,22 +266,24 @@ void LogMetricReadFailedContactCounterResult(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(
-      BLUETOOTH_DEVICE_FAILED_CONTACT_COUNTER_REPORTED,
-      byteField,
-      handle,
-      cmd_status,
-      failed_contact_counter,
-      metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, handle {}, status {}, failed_contact_counter {} packets, error {}",
-        address,
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_DEVICE_FAILED_CONTACT_COUNTER_REPORTED,
+        byteField,
         handle,
-        common::ToHexString(cmd_status),
+        cmd_status,
         failed_contact_counter,
-        ret);
-  }
+        metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, handle {}, status {}, failed_contact_counter {} packets, error {}",
+          address,
+          handle,
+          common::ToHexString(cmd_status),
+          failed_contact_counter,
+          ret);
+    }
+  });
 }
 
 void LogMetricReadTxPowerLevelResult(
@@ -268,17 +292,19 @@ void LogMetricReadTxPowerLevelResult(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(
-      BLUETOOTH_DEVICE_TX_POWER_LEVEL_REPORTED, byteField, handle, cmd_status, transmit_power_level, metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, handle {}, status {}, transmit_power_level {} packets, error {}",
-        address,
-        handle,
-        common::ToHexString(cmd_status),
-        transmit_power_level,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_DEVICE_TX_POWER_LEVEL_REPORTED, byteField, handle, cmd_status, transmit_power_level, metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, handle {}, status {}, transmit_power_level {} packets, error {}",
+          address,
+          handle,
+          common::ToHexString(cmd_status),
+          transmit_power_level,
+          ret);
+    }
+  });
 }
 
 void LogMetricSmpPairingEvent(
@@ -287,17 +313,19 @@ void LogMetricSmpPairingEvent(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret =
-      stats_write(BLUETOOTH_SMP_PAIRING_EVENT_REPORTED, byteField, smp_cmd, direction, smp_fail_reason, metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, smp_cmd {}, direction {}, smp_fail_reason {}, error {}",
-        address,
-        common::ToHexString(smp_cmd),
-        direction,
-        common::ToHexString(smp_fail_reason),
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret =
+        stats_write(BLUETOOTH_SMP_PAIRING_EVENT_REPORTED, byteField, smp_cmd, direction, smp_fail_reason, metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, smp_cmd {}, direction {}, smp_fail_reason {}, error {}",
+          address,
+          common::ToHexString(smp_cmd),
+          direction,
+          common::ToHexString(smp_fail_reason),
+          ret);
+    }
+  });
 }
 
 void LogMetricClassicPairingEvent(
@@ -312,29 +340,31 @@ void LogMetricClassicPairingEvent(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(
-      BLUETOOTH_CLASSIC_PAIRING_EVENT_REPORTED,
-      byteField,
-      handle,
-      hci_cmd,
-      hci_event,
-      cmd_status,
-      reason_code,
-      event_value,
-      metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, handle {}, hci_cmd {}, hci_event {}, cmd_status {}, reason {}, event_value "
-        "{}, error {}",
-        address,
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_CLASSIC_PAIRING_EVENT_REPORTED,
+        byteField,
         handle,
-        common::ToHexString(hci_cmd),
-        common::ToHexString(hci_event),
-        common::ToHexString(cmd_status),
-        common::ToHexString(reason_code),
+        hci_cmd,
+        hci_event,
+        cmd_status,
+        reason_code,
         event_value,
-        ret);
-  }
+        metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, handle {}, hci_cmd {}, hci_event {}, cmd_status {}, reason {}, event_value "
+          "{}, error {}",
+          address,
+          handle,
+          common::ToHexString(hci_cmd),
+          common::ToHexString(hci_event),
+          common::ToHexString(cmd_status),
+          common::ToHexString(reason_code),
+          event_value,
+          ret);
+    }
+  });
 
   if (static_cast<EventCode>(hci_event) == EventCode::SIMPLE_PAIRING_COMPLETE) {
     common::LogConnectionAdminAuditEvent("Pairing", address, static_cast<ErrorCode>(cmd_status));
@@ -351,17 +381,21 @@ void LogMetricSdpAttribute(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  BytesField attribute_field(attribute_value, attribute_size);
-  int ret =
-      stats_write(BLUETOOTH_SDP_ATTRIBUTE_REPORTED, byteField, protocol_uuid, attribute_id, attribute_field, metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, protocol_uuid {}, attribute_id {}, error {}",
-        address,
-        common::ToHexString(protocol_uuid),
-        common::ToHexString(attribute_id),
-        ret);
-  }
+  // |attribute_value| is only valid until this returns
+  std::string attribute(attribute_value, attribute_size);
+  MetricsWriter::GetInstance().Post([=]() {
+    BytesField attribute_field(attribute.data(), attribute.size());
+    int ret = stats_write(
+        BLUETOOTH_SDP_ATTRIBUTE_REPORTED, byteField, protocol_uuid, attribute_id, attribute_field, metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, protocol_uuid {}, attribute_id {}, error {}",
+          address,
+          common::ToHexString(protocol_uuid),
+          common::ToHexString(attribute_id),
+          ret);
+    }
+  });
 }
 
 void LogMetricSocketConnectionState(
@@ -378,23 +412,10 @@ void LogMetricSocketConnectionState(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(
-      BLUETOOTH_SOCKET_CONNECTION_STATE_CHANGED,
-      byteField,
-      port,
-      type,
-      connection_state,
-      tx_bytes,
-      rx_bytes,
-      uid,
-      server_port,
-      socket_role,
-      metric_id);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, port {}, type {}, state {}, tx_bytes {}, rx_bytes {}, uid {}, server_port "
-        "{}, socket_role {}, error {}",
-        address,
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_SOCKET_CONNECTION_STATE_CHANGED,
+        byteField,
         port,
         type,
         connection_state,
@@ -403,8 +424,23 @@ void LogMetricSocketConnectionState(
         uid,
         server_port,
         socket_role,
-        ret);
-  }
+        metric_id);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, port {}, type {}, state {}, tx_bytes {}, rx_bytes {}, uid {}, server_port "
+          "{}, socket_role {}, error {}",
+          address,
+          port,
+          type,
+          connection_state,
+          tx_bytes,
+          rx_bytes,
+          uid,
+          server_port,
+          socket_role,
+          ret);
+    }
+  });
 }
 
 void LogMetricManufacturerInfo(
@@ -420,66 +456,72 @@ void LogMetricManufacturerInfo(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(
-      BLUETOOTH_DEVICE_INFO_REPORTED,
-      byteField,
-      source_type,
-      source_name.c_str(),
-      manufacturer.c_str(),
-      model.c_str(),
-      hardware_version.c_str(),
-      software_version.c_str(),
-      metric_id,
-      address_type,
-      address.address[5],
-      address.address[4],
-      address.address[3]);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, source_type {}, source_name {}, manufacturer {}, model {}, "
-        "hardware_version {}, software_version {}, MAC address type {} MAC address prefix {} {} "
-        "{}, error {}",
-        address,
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_DEVICE_INFO_REPORTED,
+        byteField,
         source_type,
-        source_name,
-        manufacturer,
-        model,
-        hardware_version,
-        software_version,
+        source_name.c_str(),
+        manufacturer.c_str(),
+        model.c_str(),
+        hardware_version.c_str(),
+        software_version.c_str(),
+        metric_id,
         address_type,
         address.address[5],
         address.address[4],
-        address.address[3],
-        ret);
-  }
+        address.address[3]);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, source_type {}, source_name {}, manufacturer {}, model {}, "
+          "hardware_version {}, software_version {}, MAC address type {} MAC address prefix {} {} "
+          "{}, error {}",
+          address,
+          source_type,
+          source_name,
+          manufacturer,
+          model,
+          hardware_version,
+          software_version,
+          address_type,
+          address.address[5],
+          address.address[4],
+          address.address[3],
+          ret);
+    }
+  });
 }
 
 void LogMetricBluetoothHalCrashReason(
     const Address& address,
     uint32_t error_code,
     uint32_t vendor_error_code) {
-  int ret =
-      stats_write(BLUETOOTH_HAL_CRASH_REASON_REPORTED, 0 /* metric_id */, byteField, error_code, vendor_error_code);
-  if (ret < 0) {
-    log::warn(
-        "Failed for {}, error_code {}, vendor_error_code {}, error {}",
-        address,
-        common::ToHexString(error_code),
-        common::ToHexString(vendor_error_code),
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret =
+        stats_write(BLUETOOTH_HAL_CRASH_REASON_REPORTED, 0 /* metric_id */, byteField, error_code, vendor_error_code);
+    if (ret < 0) {
+      log::warn(
+          "Failed for {}, error_code {}, vendor_error_code {}, error {}",
+          address,
+          common::ToHexString(error_code),
+          common::ToHexString(vendor_error_code),
+          ret);
+    }
+  });
 }
 
 void LogMetricBluetoothLocalSupportedFeatures(uint32_t page_num, uint64_t features) {
-  int ret = stats_write(
-      BLUETOOTH_LOCAL_SUPPORTED_FEATURES_REPORTED, page_num, static_cast<int64_t>(features));
-  if (ret < 0) {
-    log::warn(
-        "Failed for LogMetricBluetoothLocalSupportedFeatures, page_num {}, features {}, error {}",
-        page_num,
-        features,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_LOCAL_SUPPORTED_FEATURES_REPORTED, page_num, static_cast<int64_t>(features));
+    if (ret < 0) {
+      log::warn(
+          "Failed for LogMetricBluetoothLocalSupportedFeatures, page_num {}, features {}, error {}",
+          page_num,
+          features,
+          ret);
+    }
+  });
 }
 
 void LogMetricBluetoothLocalVersions(
@@ -488,24 +530,26 @@ void LogMetricBluetoothLocalVersions(
     uint32_t lmp_subversion,
     uint8_t hci_version,
     uint32_t hci_revision) {
-  int ret = stats_write(
-      BLUETOOTH_LOCAL_VERSIONS_REPORTED,
-      static_cast<int32_t>(lmp_manufacturer_name),
-      static_cast<int32_t>(lmp_version),
-      static_cast<int32_t>(lmp_subversion),
-      static_cast<int32_t>(hci_version),
-      static_cast<int32_t>(hci_revision));
-  if (ret < 0) {
-    log::warn(
-        "Failed for LogMetricBluetoothLocalVersions, lmp_manufacturer_name {}, lmp_version {}, "
-        "lmp_subversion {}, hci_version {}, hci_revision {}, error {}",
-        lmp_manufacturer_name,
-        lmp_version,
-        lmp_subversion,
-        hci_version,
-        hci_revision,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_LOCAL_VERSIONS_REPORTED,
+        static_cast<int32_t>(lmp_manufacturer_name),
+        static_cast<int32_t>(lmp_version),
+        static_cast<int32_t>(lmp_subversion),
+        static_cast<int32_t>(hci_version),
+        static_cast<int32_t>(hci_revision));
+    if (ret < 0) {
+      log::warn(
+          "Failed for LogMetricBluetoothLocalVersions, lmp_manufacturer_name {}, lmp_version {}, "
+          "lmp_subversion {}, hci_version {}, hci_revision {}, error {}",
+          lmp_manufacturer_name,
+          lmp_version,
+          lmp_subversion,
+          hci_version,
+          hci_revision,
+          ret);
+    }
+  });
 }
 
 void LogMetricBluetoothDisconnectionReasonReported(
@@ -514,16 +558,18 @@ void LogMetricBluetoothDisconnectionReasonReported(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(BLUETOOTH_DISCONNECTION_REASON_REPORTED, reason, metric_id, connection_handle);
-  if (ret < 0) {
-    log::warn(
-        "Failed for LogMetricBluetoothDisconnectionReasonReported, reason {}, metric_id {}, "
-        "connection_handle {}, error {}",
-        reason,
-        metric_id,
-        connection_handle,
-        ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(BLUETOOTH_DISCONNECTION_REASON_REPORTED, reason, metric_id, connection_handle);
+    if (ret < 0) {
+      log::warn(
+          "Failed for LogMetricBluetoothDisconnectionReasonReported, reason {}, metric_id {}, "
+          "connection_handle {}, error {}",
+          reason,
+          metric_id,
+          connection_handle,
+          ret);
+    }
+  });
 }
 
 void LogMetricBluetoothRemoteSupportedFeatures(
@@ -532,29 +578,33 @@ void LogMetricBluetoothRemoteSupportedFeatures(
   if (!address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(address);
   }
-  int ret = stats_write(
-      BLUETOOTH_REMOTE_SUPPORTED_FEATURES_REPORTED,
-      metric_id,
-      page,
-      static_cast<int64_t>(features),
-      connection_handle);
-  if (ret < 0) {
-    log::warn(
-        "Failed for LogMetricBluetoothRemoteSupportedFeatures, metric_id {}, page {}, features {}, "
-        "connection_handle {}, error {}",
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_REMOTE_SUPPORTED_FEATURES_REPORTED,
         metric_id,
         page,
-        features,
-        connection_handle,
-        ret);
-  }
+        static_cast<int64_t>(features),
+        connection_handle);
+    if (ret < 0) {
+      log::warn(
+          "Failed for LogMetricBluetoothRemoteSupportedFeatures, metric_id {}, page {}, features {}, "
+          "connection_handle {}, error {}",
+          metric_id,
+          page,
+          features,
+          connection_handle,
+          ret);
+    }
+  });
 }
 
 void LogMetricBluetoothCodePathCounterMetrics(int32_t key, int64_t count) {
-  int ret = stats_write(BLUETOOTH_CODE_PATH_COUNTER, key, count);
-  if (ret < 0) {
-    log::warn("Failed counter metrics for {}, count {}, error {}", key, count, ret);
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(BLUETOOTH_CODE_PATH_COUNTER, key, count);
+    if (ret < 0) {
+      log::warn("Failed counter metrics for {}, count {}, error {}", key, count, ret);
+    }
+  });
 }
 
 void LogMetricBluetoothLEConnectionMetricEvent(
@@ -572,27 +622,29 @@ void LogMetricBluetoothLEConnection(os::LEConnectionSessionOptions session_optio
   if (!session_options.remote_address.IsEmpty()) {
     metric_id = MetricIdManager::GetInstance().AllocateId(session_options.remote_address);
   }
-  int ret = stats_write(
-      BLUETOOTH_LE_SESSION_CONNECTED,
-      session_options.acl_connection_state,
-      session_options.origin_type,
-      session_options.transaction_type,
-      session_options.transaction_state,
-      session_options.latency,
-      metric_id,
-      session_options.app_uid,
-      session_options.acl_latency,
-      session_options.status,
-      session_options.is_cancelled);
-
-  if (ret < 0) {
-    log::warn(
-        "Failed BluetoothLeSessionConnected - Address: {}, ACL Connection State: {}, Origin Type:  "
-        "{}",
-        session_options.remote_address,
-        common::ToHexString(session_options.acl_connection_state),
-        common::ToHexString(session_options.origin_type));
-  }
+  MetricsWriter::GetInstance().Post([=]() {
+    int ret = stats_write(
+        BLUETOOTH_LE_SESSION_CONNECTED,
+        session_options.acl_connection_state,
+        session_options.origin_type,
+        session_options.transaction_type,
+        session_options.transaction_state,
+        session_options.latency,
+        metric_id,
+        session_options.app_uid,
+        session_options.acl_latency,
+        session_options.status,
+        session_options.is_cancelled);
+
+    if (ret < 0) {
+      log::warn(
+          "Failed BluetoothLeSessionConnected - Address: {}, ACL Connection State: {}, Origin Type:  "
+          "{}",
+          session_options.remote_address,
+          common::ToHexString(session_options.acl_connection_state),
+          common::ToHexString(session_options.origin_type));
+    }
+  });
 }
 
 }  // namespace os
@@ -18,6 +18,7 @@
 
 #include <bluetooth/log.h>
 #include <cutils/properties.h>
+#include <sys/system_properties.h>
 
 #include <array>
 #include <cctype>
@@ -53,6 +54,26 @@ bool SetSystemProperty(const std::string& property, const std::string& value) {
   return true;
 }
 
+uint64_t SystemPropertyWatch::GetSerial() {
+  auto prop_info = static_cast<const ::prop_info*>(handle_.load(std::memory_order_acquire));
+  if (prop_info == nullptr) {
+    // Creating a property changes the serial of the property area, only look the property up again then
+    uint32_t area_serial = __system_property_area_serial();
+    if (area_serial == missing_serial_.load(std::memory_order_relaxed)) {
+      return area_serial;
+    }
+    prop_info = __system_property_find(property_.c_str());
+    if (prop_info == nullptr) {
+      missing_serial_.store(area_serial, std::memory_order_relaxed);
+      return area_serial;
+    }
+    // Property infos are never freed
+    handle_.store(prop_info, std::memory_order_release);
+  }
+  // Kept apart from the area serials of a missing property
+  return (uint64_t{1} << 32) | __system_property_serial(prop_info);
+}
+
 bool IsRootCanalEnabled() {
   auto value = GetSystemProperty("ro.vendor.build.fingerprint");
   if (value.has_value()) {
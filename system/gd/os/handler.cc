@@ -18,19 +18,47 @@
 
 #include <bluetooth/log.h>
 
+#include <chrono>
+
 #include "common/bind.h"
 #include "common/callback.h"
 #include "os/log.h"
 #include "os/reactor.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace os {
 using common::OnceClosure;
 
-Handler::Handler(Thread* thread) : tasks_(new std::queue<OnceClosure>()), thread_(thread) {
+namespace {
+constexpr char kBatchDrainProperty[] = "bluetooth.os.handler.batch_drain.enabled";
+
+// Handler closures do not carry the location they were posted from
+void RunWithTaskStats(
+    common::TaskStats* task_stats, std::chrono::steady_clock::time_point post_time, OnceClosure closure) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::move(closure).Run();
+  auto end_time = std::chrono::steady_clock::now();
+  task_stats->Record(
+      common::TaskStats::Location{},
+      std::chrono::duration_cast<std::chrono::microseconds>(start_time - post_time),
+      std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time));
+}
+}  // namespace
+
+Handler::Handler(Thread* thread) : Handler(thread, GetSystemPropertyBool(kBatchDrainProperty, false)) {}
+
+Handler::Handler(Thread* thread, bool batch_drain)
+    : tasks_(new std::queue<OnceClosure>()),
+      thread_(thread),
+      task_stats_(thread->GetTaskStats()),
+      batch_drain_(batch_drain) {
   event_ = thread_->GetReactor()->NewEvent();
   reactable_ = thread_->GetReactor()->Register(
-      event_->Id(), common::Bind(&Handler::handle_next_event, common::Unretained(this)), common::Closure());
+      event_->Id(),
+      batch_drain_ ? common::Bind(&Handler::handle_pending_events, common::Unretained(this))
+                   : common::Bind(&Handler::handle_next_event, common::Unretained(this)),
+      common::Closure());
 }
 
 Handler::~Handler() {
@@ -42,6 +70,10 @@ Handler::~Handler() {
 }
 
 void Handler::Post(OnceClosure closure) {
+  if (task_stats_ != nullptr) {
+    closure = common::BindOnce(
+        &RunWithTaskStats, common::Unretained(task_stats_), std::chrono::steady_clock::now(), std::move(closure));
+  }
   {
     std::lock_guard<std::mutex> lock(mutex_);
     if (was_cleared()) {
@@ -49,6 +81,12 @@ void Handler::Post(OnceClosure closure) {
       return;
     }
     tasks_->emplace(std::move(closure));
+    if (batch_drain_) {
+      if (notify_pending_) {
+        return;
+      }
+      notify_pending_ = true;
+    }
   }
   event_->Notify();
 }
@@ -92,5 +130,47 @@ void Handler::handle_next_event() {
   std::move(closure).Run();
 }
 
+void Handler::handle_pending_events() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool has_data = event_->Read();
+
+    if (was_cleared()) {
+      return;
+    }
+    log::assert_that(has_data, "Notified for work but no work available");
+  }
+
+  // Closures are popped one at a time so that a closure calling Clear() still
+  // discards everything posted after it.
+  for (size_t i = 0; i < kMaxClosuresPerWakeup; i++) {
+    common::OnceClosure closure;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (was_cleared()) {
+        return;
+      }
+      if (tasks_->empty()) {
+        notify_pending_ = false;
+        return;
+      }
+      closure = std::move(tasks_->front());
+      tasks_->pop();
+    }
+    std::move(closure).Run();
+  }
+
+  // Budget exhausted: yield to the other reactables of this thread and come back.
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (was_cleared()) {
+    return;
+  }
+  if (tasks_->empty()) {
+    notify_pending_ = false;
+    return;
+  }
+  event_->Notify();
+}
+
 }  // namespace os
 }  // namespace bluetooth
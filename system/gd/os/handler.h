@@ -33,9 +33,16 @@ namespace os {
 // from the thread.
 class Handler : public common::PostableContext {
  public:
-  // Create and register a handler on given thread
+  // Create and register a handler on given thread. Its closures are recorded in the task statistics of the thread,
+  // if enabled. Batch draining follows the
+  // "bluetooth.os.handler.batch_drain.enabled" system property.
   explicit Handler(Thread* thread);
 
+  // Create and register a handler on given thread. When |batch_drain| is set, the thread
+  // is only notified when the queue goes from empty to non-empty, and each wakeup runs
+  // up to |kMaxClosuresPerWakeup| pending closures instead of one.
+  Handler(Thread* thread, bool batch_drain);
+
   Handler(const Handler&) = delete;
   Handler& operator=(const Handler&) = delete;
 
@@ -68,16 +75,23 @@ class Handler : public common::PostableContext {
 
   friend class RepeatingAlarm;
 
+  static constexpr size_t kMaxClosuresPerWakeup = 32;
+
  private:
   inline bool was_cleared() const {
     return tasks_ == nullptr;
   };
   std::queue<common::OnceClosure>* tasks_;
   Thread* thread_;
+  common::TaskStats* const task_stats_;
   std::unique_ptr<Reactor::Event> event_;
   Reactor::Reactable* reactable_;
   mutable std::mutex mutex_;
+  const bool batch_drain_;
+  // Set while the event holds a notification that has not been consumed by a drain yet.
+  bool notify_pending_ = false;
   void handle_next_event();
+  void handle_pending_events();
 };
 
 }  // namespace os
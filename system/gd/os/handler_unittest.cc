@@ -18,6 +18,7 @@
 
 #include <future>
 #include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -116,6 +117,79 @@ TEST_F(HandlerTest, callback_with_promise) {
   handler_->Clear();
 }
 
+class BatchDrainHandlerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_, true);
+  }
+  void TearDown() override {
+    delete handler_;
+    delete thread_;
+  }
+
+  Handler* handler_;
+  Thread* thread_;
+};
+
+TEST_F(BatchDrainHandlerTest, tasks_run_in_order_beyond_budget) {
+  constexpr int kNumTasks = Handler::kMaxClosuresPerWakeup * 3 + 1;
+  std::vector<int> order;
+  std::promise<void> done;
+  auto future = done.get_future();
+  for (int i = 0; i < kNumTasks; i++) {
+    handler_->Post(common::BindOnce([](std::vector<int>* order, int i) { order->push_back(i); },
+                                    common::Unretained(&order), i));
+  }
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&done)));
+  future.wait();
+  ASSERT_EQ(order.size(), (size_t)kNumTasks);
+  for (int i = 0; i < kNumTasks; i++) {
+    ASSERT_EQ(order[i], i);
+  }
+  handler_->Clear();
+}
+
+TEST_F(BatchDrainHandlerTest, post_after_drain_is_invoked) {
+  for (int round = 0; round < 3; round++) {
+    std::promise<void> done;
+    auto future = done.get_future();
+    handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&done)));
+    future.wait();
+  }
+  handler_->Clear();
+}
+
+TEST_F(BatchDrainHandlerTest, clear_from_task_discards_rest_of_batch) {
+  std::promise<void> blocked;
+  auto blocked_future = blocked.get_future();
+  std::promise<void> can_continue;
+  auto can_continue_future = can_continue.get_future();
+  handler_->Post(common::BindOnce(
+      [](std::promise<void> blocked, std::future<void> can_continue_future) {
+        blocked.set_value();
+        can_continue_future.wait();
+      },
+      std::move(blocked),
+      std::move(can_continue_future)));
+  blocked_future.wait();
+
+  // Both land in the same batch as the handler is still busy with the first task.
+  std::promise<void> cleared;
+  auto cleared_future = cleared.get_future();
+  handler_->Post(common::BindOnce(
+      [](Handler* handler, std::promise<void> cleared) {
+        handler->Clear();
+        cleared.set_value();
+      },
+      common::Unretained(handler_),
+      std::move(cleared)));
+  handler_->Post(common::BindOnce([]() { ASSERT_TRUE(false); }));
+  can_continue.set_value();
+  cleared_future.wait();
+  handler_->WaitUntilStopped(std::chrono::milliseconds(2000));
+}
+
 // For Death tests, all the threading needs to be done in the ASSERT_DEATH call
 class HandlerDeathTest : public ::testing::Test {
  protected:
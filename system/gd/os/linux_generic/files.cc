@@ -134,7 +134,8 @@ bool WriteToFile(const std::string& path, const std::string& data) {
     return false;
   }
 
-  if (std::fprintf(fp, "%s", data.c_str()) < 0) {
+  // Written as is, |data| may hold binary content
+  if (std::fwrite(data.data(), 1, data.size(), fp) != data.size()) {
     log::error("unable to write to file '{}', error: {}", temp_path, strerror(errno));
     HandleError(temp_path, &dir_fd, &fp);
     return false;
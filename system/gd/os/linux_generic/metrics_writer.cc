@@ -0,0 +1,165 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/metrics_writer.h"
+
+#include <bluetooth/log.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "common/bind.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+size_t RoundUpToPowerOfTwo(size_t capacity) {
+  size_t num_slots = 1;
+  while (num_slots < capacity) {
+    num_slots <<= 1;
+  }
+  return num_slots;
+}
+}  // namespace
+
+MetricsWriter& MetricsWriter::GetInstance() {
+  static auto instance = new MetricsWriter();
+  return *instance;
+}
+
+MetricsWriter::MetricsWriter(size_t capacity, const std::string& name)
+    : mask_(RoundUpToPowerOfTwo(capacity) - 1), slots_(new Slot[mask_ + 1]), thread_(name, Thread::Priority::LOW) {
+  for (size_t i = 0; i <= mask_; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  reactable_ = thread_.GetReactor()->Register(
+      ready_.GetFd(), common::Bind(&MetricsWriter::OnWriteReady, common::Unretained(this)), common::Closure());
+}
+
+MetricsWriter::~MetricsWriter() {
+  thread_.GetReactor()->Unregister(reactable_);
+  thread_.GetReactor()->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  thread_.Stop();
+
+  Write write;
+  while (TryPop(&write)) {
+    written_count_.fetch_add(1, std::memory_order_relaxed);
+    write();
+  }
+}
+
+bool MetricsWriter::Post(Write write) {
+  // Claim a position whose slot has been released by the writer thread
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &slots_[pos & mask_];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->write = std::move(write);
+  slot->sequence.store(pos + 1, std::memory_order_release);
+
+  // Only wake up the writer thread if it is waiting for a write. Pairs with the fence of |OnWriteReady|: either the
+  // writer thread sees this write when checking the ring again, or this sees the writer thread waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (writer_waiting_.load(std::memory_order_relaxed) && writer_waiting_.exchange(false, std::memory_order_relaxed)) {
+    ready_.Increase();
+  }
+  return true;
+}
+
+void MetricsWriter::Flush() {
+  log::assert_that(!thread_.IsSameThread(), "assert failed: !thread_.IsSameThread()");
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  while (!Post([promise]() { promise->set_value(); })) {
+    std::this_thread::yield();
+  }
+  future.wait();
+}
+
+uint64_t MetricsWriter::GetWrittenCount() const {
+  return written_count_.load(std::memory_order_relaxed);
+}
+
+uint64_t MetricsWriter::GetDroppedCount() const {
+  return dropped_count_.load(std::memory_order_relaxed);
+}
+
+bool MetricsWriter::Empty() const {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  return slots_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
+bool MetricsWriter::TryPop(Write* write) {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  Slot* slot = &slots_[pos & mask_];
+  if (slot->sequence.load(std::memory_order_acquire) != pos + 1) {
+    return false;
+  }
+  *write = std::move(slot->write);
+  slot->write = nullptr;
+  slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+  dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+  return true;
+}
+
+void MetricsWriter::OnWriteReady() {
+  ready_.Decrease();
+
+  Write write;
+  for (;;) {
+    while (TryPop(&write)) {
+      written_count_.fetch_add(1, std::memory_order_relaxed);
+      write();
+    }
+
+    writer_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (Empty()) {
+      break;
+    }
+    // A write was published in the meantime. Keep running the writes, unless the thread that posted it already
+    // claimed the wakeup, which will bring us back here.
+    if (!writer_waiting_.exchange(false, std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  uint64_t dropped_count = dropped_count_.load(std::memory_order_relaxed);
+  if (dropped_count != reported_dropped_count_) {
+    log::warn(
+        "{} dropped {} writes as the queue was full", thread_.GetThreadName(), dropped_count - reported_dropped_count_);
+    reported_dropped_count_ = dropped_count;
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
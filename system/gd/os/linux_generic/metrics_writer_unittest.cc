@@ -0,0 +1,114 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/metrics_writer.h"
+
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+constexpr size_t kCapacity = 16;
+
+TEST(MetricsWriterTest, writes_run_on_writer_thread) {
+  MetricsWriter writer(kCapacity);
+  std::thread::id caller_thread = std::this_thread::get_id();
+  std::thread::id writer_thread = caller_thread;
+  EXPECT_TRUE(writer.Post([&writer_thread]() { writer_thread = std::this_thread::get_id(); }));
+  writer.Flush();
+  EXPECT_NE(writer_thread, caller_thread);
+  EXPECT_EQ(writer.GetWrittenCount(), 2u);
+  EXPECT_EQ(writer.GetDroppedCount(), 0u);
+}
+
+TEST(MetricsWriterTest, writes_dropped_when_full) {
+  MetricsWriter writer(kCapacity);
+  std::promise<void> blocked;
+  std::promise<void> release;
+  auto release_future = release.get_future().share();
+  EXPECT_TRUE(writer.Post([&blocked, release_future]() {
+    blocked.set_value();
+    release_future.wait();
+  }));
+  blocked.get_future().wait();
+
+  int written = 0;
+  for (size_t i = 0; i < kCapacity; i++) {
+    EXPECT_TRUE(writer.Post([&written]() { written++; }));
+  }
+  EXPECT_FALSE(writer.Post([&written]() { written++; }));
+  EXPECT_EQ(writer.GetDroppedCount(), 1u);
+
+  release.set_value();
+  writer.Flush();
+  EXPECT_EQ(written, static_cast<int>(kCapacity));
+}
+
+TEST(MetricsWriterTest, writes_queued_on_destruction_are_run) {
+  int written = 0;
+  {
+    MetricsWriter writer(kCapacity);
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+    EXPECT_TRUE(writer.Post([release_future]() { release_future.wait(); }));
+    EXPECT_TRUE(writer.Post([&written]() { written++; }));
+    release.set_value();
+  }
+  EXPECT_EQ(written, 1);
+}
+
+TEST(MetricsWriterTest, writes_from_several_threads_keep_their_order) {
+  constexpr int kNumPosters = 4;
+  constexpr int kWritesPerPoster = 10000;
+  MetricsWriter writer(kCapacity);
+  // Only accessed from the writer thread
+  std::vector<int> next_write(kNumPosters, 0);
+  int out_of_order = 0;
+
+  std::vector<std::thread> posters;
+  for (int poster = 0; poster < kNumPosters; poster++) {
+    posters.emplace_back([&, poster]() {
+      for (int i = 0; i < kWritesPerPoster; i++) {
+        while (!writer.Post([&, poster, i]() {
+          if (next_write[poster]++ != i) {
+            out_of_order++;
+          }
+        })) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& poster : posters) {
+    poster.join();
+  }
+  writer.Flush();
+
+  EXPECT_EQ(out_of_order, 0);
+  for (int poster = 0; poster < kNumPosters; poster++) {
+    EXPECT_EQ(next_write[poster], kWritesPerPoster);
+  }
+  EXPECT_EQ(writer.GetWrittenCount(), static_cast<uint64_t>(kNumPosters * kWritesPerPoster + 1));
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
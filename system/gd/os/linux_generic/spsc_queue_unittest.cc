@@ -0,0 +1,216 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/spsc_queue.h"
+
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include "common/bind.h"
+#include "gtest/gtest.h"
+#include "os/handler.h"
+#include "os/thread.h"
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+constexpr int kQueueSize = 10;
+constexpr int kDoubleOfQueueSize = kQueueSize * 2;
+
+class SpscQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    enqueue_thread_ = new Thread("enqueue_thread", Thread::Priority::NORMAL);
+    enqueue_handler_ = new Handler(enqueue_thread_);
+    dequeue_thread_ = new Thread("dequeue_thread", Thread::Priority::NORMAL);
+    dequeue_handler_ = new Handler(dequeue_thread_);
+  }
+  void TearDown() override {
+    enqueue_handler_->Clear();
+    delete enqueue_handler_;
+    delete enqueue_thread_;
+    dequeue_handler_->Clear();
+    delete dequeue_handler_;
+    delete dequeue_thread_;
+  }
+
+  void sync_enqueue_handler() {
+    log::assert_that(
+        enqueue_thread_->GetReactor()->WaitForIdle(2s),
+        "assert failed: enqueue_thread_->GetReactor()->WaitForIdle(2s)");
+  }
+
+  Thread* enqueue_thread_;
+  Handler* enqueue_handler_;
+  Thread* dequeue_thread_;
+  Handler* dequeue_handler_;
+};
+
+// Produces |total| increasing integers, unregistering once all of them are handed over.
+class Producer {
+ public:
+  Producer(SpscQueue<int>* queue, int total) : queue_(queue), total_(total) {}
+
+  std::unique_ptr<int> Produce() {
+    auto data = std::make_unique<int>(next_++);
+    if (next_ == total_) {
+      queue_->UnregisterEnqueue();
+    }
+    return data;
+  }
+
+  int next_ = 0;
+
+ private:
+  SpscQueue<int>* queue_;
+  int total_;
+};
+
+// Collects |total| items and fulfills |promise| when done.
+class Consumer {
+ public:
+  Consumer(SpscQueue<int>* queue, int total, std::promise<void>* promise)
+      : queue_(queue), total_(total), promise_(promise) {}
+
+  void Consume() {
+    std::unique_ptr<int> data = queue_->TryDequeue();
+    ASSERT_NE(data, nullptr);
+    received_.push_back(*data);
+    if (received_.size() == (size_t)total_) {
+      queue_->UnregisterDequeue();
+      promise_->set_value();
+    }
+  }
+
+  std::vector<int> received_;
+
+ private:
+  SpscQueue<int>* queue_;
+  int total_;
+  std::promise<void>* promise_;
+};
+
+TEST_F(SpscQueueTest, try_dequeue_empty_queue) {
+  SpscQueue<int> queue(kQueueSize);
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
+TEST_F(SpscQueueTest, enqueue_stops_when_full) {
+  SpscQueue<int> queue(kQueueSize);
+  int produced = 0;
+  queue.RegisterEnqueue(
+      enqueue_handler_,
+      common::Bind([](int* produced) { return std::make_unique<int>((*produced)++); }, common::Unretained(&produced)));
+  sync_enqueue_handler();
+  queue.UnregisterEnqueue();
+  EXPECT_EQ(produced, kQueueSize);
+
+  for (int i = 0; i < kQueueSize; i++) {
+    auto data = queue.TryDequeue();
+    ASSERT_NE(data, nullptr);
+    EXPECT_EQ(*data, i);
+  }
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
+TEST_F(SpscQueueTest, enqueue_resumes_when_non_full) {
+  SpscQueue<int> queue(kQueueSize);
+  Producer producer(&queue, kDoubleOfQueueSize);
+  queue.RegisterEnqueue(enqueue_handler_, common::Bind(&Producer::Produce, common::Unretained(&producer)));
+  sync_enqueue_handler();
+  EXPECT_EQ(producer.next_, kQueueSize);
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  Consumer consumer(&queue, kDoubleOfQueueSize, &promise);
+  dequeue_handler_->Post(common::BindOnce(
+      [](SpscQueue<int>* queue, Handler* handler, Consumer* consumer) {
+        queue->RegisterDequeue(handler, common::Bind(&Consumer::Consume, common::Unretained(consumer)));
+      },
+      common::Unretained(&queue),
+      common::Unretained(dequeue_handler_),
+      common::Unretained(&consumer)));
+  ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+  EXPECT_EQ(producer.next_, kDoubleOfQueueSize);
+}
+
+TEST_F(SpscQueueTest, preserves_order_across_threads) {
+  constexpr int kTotal = 10000;
+  SpscQueue<int> queue(kQueueSize);
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  Consumer consumer(&queue, kTotal, &promise);
+  dequeue_handler_->Post(common::BindOnce(
+      [](SpscQueue<int>* queue, Handler* handler, Consumer* consumer) {
+        queue->RegisterDequeue(handler, common::Bind(&Consumer::Consume, common::Unretained(consumer)));
+      },
+      common::Unretained(&queue),
+      common::Unretained(dequeue_handler_),
+      common::Unretained(&consumer)));
+
+  Producer producer(&queue, kTotal);
+  enqueue_handler_->Post(common::BindOnce(
+      [](SpscQueue<int>* queue, Handler* handler, Producer* producer) {
+        queue->RegisterEnqueue(handler, common::Bind(&Producer::Produce, common::Unretained(producer)));
+      },
+      common::Unretained(&queue),
+      common::Unretained(enqueue_handler_),
+      common::Unretained(&producer)));
+
+  ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+  ASSERT_EQ(consumer.received_.size(), (size_t)kTotal);
+  for (int i = 0; i < kTotal; i++) {
+    ASSERT_EQ(consumer.received_[i], i);
+  }
+}
+
+TEST_F(SpscQueueTest, dequeue_registered_after_data_available) {
+  SpscQueue<int> queue(kQueueSize);
+  Producer producer(&queue, kQueueSize);
+  queue.RegisterEnqueue(enqueue_handler_, common::Bind(&Producer::Produce, common::Unretained(&producer)));
+  sync_enqueue_handler();
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  Consumer consumer(&queue, kQueueSize, &promise);
+  queue.RegisterDequeue(dequeue_handler_, common::Bind(&Consumer::Consume, common::Unretained(&consumer)));
+  ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+  EXPECT_EQ(queue.TryDequeue(), nullptr);
+}
+
+class SpscQueueDeathTest : public ::testing::Test {
+ public:
+  void RegisterEnqueueAndDelete() {
+    Thread* enqueue_thread = new Thread("enqueue_thread", Thread::Priority::NORMAL);
+    Handler* enqueue_handler = new Handler(enqueue_thread);
+    SpscQueue<int>* queue = new SpscQueue<int>(kQueueSize);
+    queue->RegisterEnqueue(enqueue_handler, common::Bind([]() { return std::make_unique<int>(0); }));
+    delete queue;
+  }
+};
+
+TEST_F(SpscQueueDeathTest, die_if_enqueue_not_unregistered) {
+  EXPECT_DEATH(RegisterEnqueueAndDelete(), "nqueue");
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
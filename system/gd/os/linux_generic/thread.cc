@@ -18,6 +18,7 @@
 
 #include <bluetooth/log.h>
 #include <fcntl.h>
+#include <sys/resource.h>
 #include <sys/syscall.h>
 #include <unistd.h>
 
@@ -25,26 +26,40 @@
 #include <cstring>
 
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace os {
 
 namespace {
 constexpr int kRealTimeFifoSchedulingPriority = 1;
+constexpr int kLowPriorityNiceValue = 10;
+
+std::unique_ptr<common::TaskStats> NewTaskStats(const std::string& name) {
+  uint32_t slow_task_threshold_ms = GetSystemPropertyUint32(common::TaskStats::kSlowTaskThresholdProperty, 0);
+  if (slow_task_threshold_ms == 0) {
+    return nullptr;
+  }
+  return std::make_unique<common::TaskStats>(name, std::chrono::milliseconds(slow_task_threshold_ms));
 }
+}  // namespace
 
 Thread::Thread(const std::string& name, const Priority priority)
-    : name_(name), reactor_(), running_thread_(&Thread::run, this, priority) {}
+    : name_(name), task_stats_(NewTaskStats(name)), reactor_(), running_thread_(&Thread::run, this, priority) {}
 
 void Thread::run(Priority priority) {
+  auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
   if (priority == Priority::REAL_TIME) {
     struct sched_param rt_params = {.sched_priority = kRealTimeFifoSchedulingPriority};
-    auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
     int rc;
     RUN_NO_INTR(rc = sched_setscheduler(linux_tid, SCHED_FIFO, &rt_params));
     if (rc != 0) {
       log::error("unable to set SCHED_FIFO priority: {}", strerror(errno));
     }
+  } else if (priority == Priority::LOW) {
+    if (setpriority(PRIO_PROCESS, linux_tid, kLowPriorityNiceValue) != 0) {
+      log::error("unable to set low priority: {}", strerror(errno));
+    }
   }
   reactor_.Run();
 }
@@ -75,6 +90,10 @@ Reactor* Thread::GetReactor() const {
   return &reactor_;
 }
 
+common::TaskStats* Thread::GetTaskStats() const {
+  return task_stats_.get();
+}
+
 std::string Thread::GetThreadName() const {
   return name_;
 }
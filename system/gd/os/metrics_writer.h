@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "os/linux_generic/reactive_semaphore.h"
+#include "os/reactor.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace os {
+
+// Writes metrics to their backend from a low priority thread, so that logging a metric from the stack threads only
+// queues it, and never waits on the backend.
+//
+// Writes are queued in a bounded lock-free ring that any thread may post to. The writer thread is woken up when the
+// ring goes from empty to non-empty, and then runs all the writes queued in one batch. A write posted while the ring
+// is full is dropped and counted rather than blocking its caller.
+//
+// Other low priority writes of the stack, such as the BQR trace logs, use their own instance of this writer.
+class MetricsWriter {
+ public:
+  using Write = std::function<void()>;
+
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  // Return the writer of the metrics logged by the stack
+  static MetricsWriter& GetInstance();
+
+  // |capacity| is rounded up to a power of two. |name| is the name of the writer thread.
+  explicit MetricsWriter(size_t capacity = kDefaultCapacity, const std::string& name = "bt_metrics_writer");
+
+  MetricsWriter(const MetricsWriter&) = delete;
+  MetricsWriter& operator=(const MetricsWriter&) = delete;
+
+  // Stop the writer thread, and run the writes still queued on the calling thread
+  ~MetricsWriter();
+
+  // Queue |write| to be run on the writer thread, from any thread. Return false, and count |write| as dropped, if
+  // the queue is full.
+  bool Post(Write write);
+
+  // Block until the writes posted before this call have been run. Must not be called from the writer thread.
+  void Flush();
+
+  // Return the number of writes run, and dropped because the queue was full, since this writer was created
+  uint64_t GetWrittenCount() const;
+  uint64_t GetDroppedCount() const;
+
+ private:
+  struct Slot {
+    // Position of the write held plus one once it is published, or position of the next write to store while the
+    // slot is free
+    std::atomic<size_t> sequence;
+    Write write;
+  };
+
+  bool Empty() const;
+  bool TryPop(Write* write);
+  void OnWriteReady();
+
+  const size_t mask_;
+  const std::unique_ptr<Slot[]> slots_;
+  // Position of the next write to post, shared by the posting threads
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  // Position of the next write to run, only written by the writer thread
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+  // Set while the writer thread waits for a write, cleared by the first post after that, which signals |ready_|
+  alignas(64) std::atomic_bool writer_waiting_{true};
+  std::atomic<uint64_t> written_count_{0};
+  std::atomic<uint64_t> dropped_count_{0};
+  // Only accessed from the writer thread
+  uint64_t reported_dropped_count_{0};
+
+  ReactiveSemaphore ready_{0};
+  Thread thread_;
+  Reactor::Reactable* reactable_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,269 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <bluetooth/log.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/bind.h"
+#include "common/callback.h"
+#include "os/handler.h"
+#include "os/linux_generic/reactive_semaphore.h"
+#include "os/queue.h"
+
+namespace bluetooth {
+namespace os {
+
+// A bounded single producer / single consumer variant of |Queue|.
+//
+// Data moves through a lock-free ring instead of a mutex guarded std::queue, and
+// each end only signals the other one on a transition: the dequeue end is woken
+// when the ring goes from empty to non-empty, and the enqueue end when it goes
+// from full to non-full. Once woken, an end keeps invoking its callback until the
+// ring is empty (resp. full), so an eventfd write is paid per burst instead of
+// per item.
+//
+// The callback contract is the same as |Queue|. In addition, at most one handler
+// may be registered on each end at a time, and |TryDequeue| must only be called
+// from the thread the dequeue end is registered on.
+template <typename T>
+class SpscQueue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
+ public:
+  using EnqueueCallback = common::Callback<std::unique_ptr<T>()>;
+  using DequeueCallback = common::Callback<void()>;
+  // Create a queue with |capacity| is the maximum number of messages a queue can contain
+  explicit SpscQueue(size_t capacity);
+  ~SpscQueue();
+  // Register |callback| that will be called on |handler| while the queue is able to enqueue data.
+  // This will cause a crash if handler or callback has already been registered before.
+  void RegisterEnqueue(Handler* handler, EnqueueCallback callback) override;
+  // Unregister current EnqueueCallback from this queue, this will cause a crash if not registered yet.
+  void UnregisterEnqueue() override;
+  // Register |callback| that will be called on |handler| while the queue has data ready for dequeue.
+  // This will cause a crash if handler or callback has already been registered before.
+  void RegisterDequeue(Handler* handler, DequeueCallback callback) override;
+  // Unregister current DequeueCallback from this queue, this will cause a crash if not registered yet.
+  void UnregisterDequeue() override;
+
+  // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
+  std::unique_ptr<T> TryDequeue() override;
+
+ private:
+  // Upper bound on callbacks run per reactor wakeup, so that a busy queue does not
+  // starve the other reactables of the thread.
+  static constexpr int kMaxCallbacksPerWakeup = 64;
+
+  class QueueEndpoint {
+   public:
+    explicit QueueEndpoint(unsigned int initial_value)
+        : reactive_semaphore_(initial_value), signaled_(initial_value != 0) {}
+    // Holds at most one count; readable while |signaled_| is set.
+    ReactiveSemaphore reactive_semaphore_;
+    std::atomic_bool signaled_;
+    // Bumped on every registration change so that an internal callback can tell when
+    // the callback it is running has been unregistered from within itself.
+    std::atomic<uint64_t> generation_{0};
+    Handler* handler_{nullptr};
+    Reactor::Reactable* reactable_{nullptr};
+  };
+
+  bool empty() const;
+  bool full() const;
+  void Signal(QueueEndpoint* endpoint);
+  void Unregister(QueueEndpoint* endpoint);
+  void EnqueueCallbackInternal(uint64_t generation, EnqueueCallback callback);
+  void DequeueCallbackInternal(uint64_t generation, DequeueCallback callback);
+
+  const size_t capacity_;
+  std::vector<std::unique_ptr<T>> ring_;
+  // Only written by the dequeue end.
+  alignas(64) std::atomic<size_t> head_{0};
+  // Only written by the enqueue end.
+  alignas(64) std::atomic<size_t> tail_{0};
+  // Guards registration only; never taken on the data path.
+  std::mutex mutex_;
+
+  QueueEndpoint enqueue_;
+  QueueEndpoint dequeue_;
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity)
+    : capacity_(capacity), ring_(capacity), enqueue_(1), dequeue_(0) {
+  log::assert_that(capacity > 0, "assert failed: capacity > 0");
+}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue() {
+  log::assert_that(enqueue_.handler_ == nullptr, "Enqueue is not unregistered");
+  log::assert_that(dequeue_.handler_ == nullptr, "Dequeue is not unregistered");
+}
+
+template <typename T>
+void SpscQueue<T>::RegisterEnqueue(Handler* handler, EnqueueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  log::assert_that(enqueue_.handler_ == nullptr, "assert failed: enqueue_.handler_ == nullptr");
+  log::assert_that(enqueue_.reactable_ == nullptr, "assert failed: enqueue_.reactable_ == nullptr");
+  uint64_t generation = enqueue_.generation_.fetch_add(1) + 1;
+  enqueue_.handler_ = handler;
+  enqueue_.reactable_ = enqueue_.handler_->thread_->GetReactor()->Register(
+      enqueue_.reactive_semaphore_.GetFd(),
+      base::Bind(
+          &SpscQueue<T>::EnqueueCallbackInternal, base::Unretained(this), generation, std::move(callback)),
+      base::Closure());
+}
+
+template <typename T>
+void SpscQueue<T>::UnregisterEnqueue() {
+  Unregister(&enqueue_);
+}
+
+template <typename T>
+void SpscQueue<T>::RegisterDequeue(Handler* handler, DequeueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  log::assert_that(dequeue_.handler_ == nullptr, "assert failed: dequeue_.handler_ == nullptr");
+  log::assert_that(dequeue_.reactable_ == nullptr, "assert failed: dequeue_.reactable_ == nullptr");
+  uint64_t generation = dequeue_.generation_.fetch_add(1) + 1;
+  dequeue_.handler_ = handler;
+  dequeue_.reactable_ = dequeue_.handler_->thread_->GetReactor()->Register(
+      dequeue_.reactive_semaphore_.GetFd(),
+      base::Bind(
+          &SpscQueue<T>::DequeueCallbackInternal, base::Unretained(this), generation, std::move(callback)),
+      base::Closure());
+}
+
+template <typename T>
+void SpscQueue<T>::UnregisterDequeue() {
+  Unregister(&dequeue_);
+}
+
+template <typename T>
+void SpscQueue<T>::Unregister(QueueEndpoint* endpoint) {
+  Reactor* reactor = nullptr;
+  Reactor::Reactable* to_unregister = nullptr;
+  bool wait_for_unregister = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    log::assert_that(
+        endpoint->reactable_ != nullptr, "assert failed: endpoint->reactable_ != nullptr");
+    reactor = endpoint->handler_->thread_->GetReactor();
+    wait_for_unregister = (!endpoint->handler_->thread_->IsSameThread());
+    to_unregister = endpoint->reactable_;
+    endpoint->reactable_ = nullptr;
+    endpoint->handler_ = nullptr;
+    endpoint->generation_.fetch_add(1);
+  }
+  reactor->Unregister(to_unregister);
+  if (wait_for_unregister) {
+    reactor->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  }
+}
+
+template <typename T>
+bool SpscQueue<T>::empty() const {
+  return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+bool SpscQueue<T>::full() const {
+  return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire) == capacity_;
+}
+
+// Must be preceded by a seq_cst fence that orders the ring update before the flag
+// check, pairing with the fence in the clearing path of the other end.
+template <typename T>
+void SpscQueue<T>::Signal(QueueEndpoint* endpoint) {
+  if (endpoint->signaled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (!endpoint->signaled_.exchange(true)) {
+    endpoint->reactive_semaphore_.Increase();
+  }
+}
+
+template <typename T>
+std::unique_ptr<T> SpscQueue<T>::TryDequeue() {
+  size_t head = head_.load(std::memory_order_relaxed);
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  std::unique_ptr<T> data = std::move(ring_[head % capacity_]);
+  head_.store(head + 1, std::memory_order_release);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  Signal(&enqueue_);
+  return data;
+}
+
+template <typename T>
+void SpscQueue<T>::EnqueueCallbackInternal(uint64_t generation, EnqueueCallback callback) {
+  for (int i = 0; i < kMaxCallbacksPerWakeup && !full(); i++) {
+    if (enqueue_.generation_.load(std::memory_order_relaxed) != generation) {
+      return;
+    }
+    std::unique_ptr<T> data = callback.Run();
+    log::assert_that(data != nullptr, "assert failed: data != nullptr");
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    ring_[tail % capacity_] = std::move(data);
+    tail_.store(tail + 1, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Signal(&dequeue_);
+  }
+
+  if (full()) {
+    // Going to sleep until the dequeue end frees a slot. Re-check after clearing the
+    // flag in case the slot was freed while the flag was still set.
+    enqueue_.reactive_semaphore_.Decrease();
+    enqueue_.signaled_.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!full()) {
+      Signal(&enqueue_);
+    }
+  }
+}
+
+template <typename T>
+void SpscQueue<T>::DequeueCallbackInternal(uint64_t generation, DequeueCallback callback) {
+  for (int i = 0; i < kMaxCallbacksPerWakeup && !empty(); i++) {
+    if (dequeue_.generation_.load(std::memory_order_relaxed) != generation) {
+      return;
+    }
+    callback.Run();
+  }
+
+  if (empty()) {
+    // Going to sleep until the enqueue end publishes data. Re-check after clearing
+    // the flag in case data was published while the flag was still set.
+    dequeue_.reactive_semaphore_.Decrease();
+    dequeue_.signaled_.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!empty()) {
+      Signal(&dequeue_);
+    }
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <utility>
 
 #define DEBUGGABLE_SYS_PROP_NAME "ro.debuggable"
 
@@ -55,6 +57,60 @@ bool SetSystemProperty(const std::string& property, const std::string& value);
 // Clear system properties for host only return true on success
 bool ClearSystemPropertiesForHost();
 
+// Watch |property| for changes without reading its value
+class SystemPropertyWatch {
+ public:
+  explicit SystemPropertyWatch(std::string property) : property_(std::move(property)) {}
+
+  SystemPropertyWatch(const SystemPropertyWatch&) = delete;
+  SystemPropertyWatch& operator=(const SystemPropertyWatch&) = delete;
+
+  const std::string& GetProperty() const {
+    return property_;
+  }
+
+  // Return a number that changes whenever the property is created or set, from any thread
+  uint64_t GetSerial();
+
+ private:
+  const std::string property_;
+  // Platform state of the property lookup, only used on Android
+  std::atomic<const void*> handle_{nullptr};
+  std::atomic<uint64_t> missing_serial_{UINT64_MAX};
+};
+
+// Value of |property| read with |Read| when the property changed, and from memory otherwise, for properties
+// checked on frequent paths. Get can be called from any thread, and does not lock.
+template <typename T, T (*Read)(const std::string&, T)>
+class CachedSystemProperty {
+ public:
+  CachedSystemProperty(std::string property, T default_value)
+      : watch_(std::move(property)), default_value_(default_value), value_(default_value) {}
+
+  CachedSystemProperty(const CachedSystemProperty&) = delete;
+  CachedSystemProperty& operator=(const CachedSystemProperty&) = delete;
+
+  T Get() {
+    uint64_t serial = watch_.GetSerial();
+    if (serial != serial_.load(std::memory_order_acquire)) {
+      // The value is read after the serial, so that the cached value is never older than the cached serial
+      value_.store(Read(watch_.GetProperty(), default_value_), std::memory_order_relaxed);
+      serial_.store(serial, std::memory_order_release);
+    }
+    return value_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  SystemPropertyWatch watch_;
+  const T default_value_;
+  std::atomic<T> value_;
+  // Never returned by GetSerial, so that the first Get reads the property
+  std::atomic<uint64_t> serial_{UINT64_MAX};
+};
+
+using CachedSystemPropertyBool = CachedSystemProperty<bool, GetSystemPropertyBool>;
+using CachedSystemPropertyUint32 = CachedSystemProperty<uint32_t, GetSystemPropertyUint32>;
+
 // Check if the vendor image is using root canal simulated Bluetooth stack
 bool IsRootCanalEnabled();
 
@@ -60,4 +60,21 @@ TEST(SystemPropertiesTest, getUint32BaseHex) {
   ASSERT_EQ(bluetooth::os::GetSystemPropertyUint32Base(property, 1, 10), 0u);  // if parsed as a dec
 }
 
+TEST(SystemPropertiesTest, cachedPropertyFollowsChanges) {
+  std::string property("SystemPropertiesTest_cachedPropertyFollowsChanges");
+  bluetooth::os::CachedSystemPropertyUint32 cached(property, 1);
+  ASSERT_TRUE(SetSystemProperty(property, "42"));
+  ASSERT_EQ(cached.Get(), 42u);
+  ASSERT_EQ(cached.Get(), 42u);
+  ASSERT_TRUE(SetSystemProperty(property, "43"));
+  ASSERT_EQ(cached.Get(), 43u);
+}
+
+TEST(SystemPropertiesTest, cachedPropertyDefaultValue) {
+  bluetooth::os::CachedSystemPropertyBool cached(
+      "SystemPropertiesTest_cachedPropertyDefaultValue_do_not_exist", true);
+  ASSERT_TRUE(cached.Get());
+  ASSERT_TRUE(cached.Get());
+}
+
 }  // namespace testing
\ No newline at end of file
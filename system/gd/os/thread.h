@@ -16,10 +16,12 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "common/task_stats.h"
 #include "os/reactor.h"
 #include "os/utils.h"
 
@@ -33,14 +35,16 @@ class Thread {
  public:
   // Used by thread constructor. Suggest the priority to the kernel scheduler. Use REAL_TIME if we need (soft) real-time
   // scheduling guarantee for this thread; use NORMAL if no real-time guarantee is needed to save CPU time slice for
-  // other threads
+  // other threads; use LOW for background work that should yield to the other threads of the stack
   enum class Priority {
     REAL_TIME,
     NORMAL,
+    LOW,
   };
 
   // name: thread name for POSIX systems
   // priority: priority for kernel scheduler
+  // The task statistics follow the common::TaskStats::kSlowTaskThresholdProperty system property.
   Thread(const std::string& name, Priority priority);
 
   Thread(const Thread&) = delete;
@@ -64,10 +68,15 @@ class Thread {
   // Return the pointer of underlying reactor. The ownership is NOT transferred.
   Reactor* GetReactor() const;
 
+  // Return the statistics of the tasks run by the handlers of this thread, nullptr if they are disabled. The
+  // ownership is NOT transferred.
+  common::TaskStats* GetTaskStats() const;
+
  private:
   void run(Priority priority);
   mutable std::mutex mutex_;
   const std::string name_;
+  const std::unique_ptr<common::TaskStats> task_stats_;
   mutable Reactor reactor_;
   std::thread running_thread_;
 };
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Trace points of the hot paths of the stack, recorded in the "bluetooth"
+// atrace category. Perfetto collects them along with the audio and scheduler
+// tracks, e.g. with atrace_categories: "bluetooth" in its ftrace config.
+//
+//  - BT_TRACE_SCOPE(name): slice covering the rest of the enclosing scope
+//  - BT_TRACE_ASYNC_BEGIN(name, cookie) / BT_TRACE_ASYNC_END(name, cookie):
+//    slice across threads or callbacks, matched by name and 32 bit cookie
+//  - BT_TRACE_COUNTER(name, value): value of a counter track
+//
+// Names are C strings, only read while the trace point is recorded. Guard the
+// computation of a name with BT_TRACE_ENABLED() when it has a cost.
+//
+// Only Android builds are instrumented, the macros compile to nothing
+// elsewhere and their arguments are not evaluated. When the category is not
+// traced, a trace point costs a check of the enabled categories.
+
+#if defined(__ANDROID__)
+
+#include <cutils/trace.h>
+
+namespace bluetooth {
+namespace os {
+
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(const char* name) : enabled_(atrace_is_tag_enabled(ATRACE_TAG_BLUETOOTH)) {
+    if (enabled_) {
+      atrace_begin(ATRACE_TAG_BLUETOOTH, name);
+    }
+  }
+  ScopedTrace(const ScopedTrace&) = delete;
+  ScopedTrace& operator=(const ScopedTrace&) = delete;
+  ~ScopedTrace() {
+    if (enabled_) {
+      atrace_end(ATRACE_TAG_BLUETOOTH);
+    }
+  }
+
+ private:
+  // The slice is closed even if tracing stops within the scope
+  const bool enabled_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
+
+#define BT_TRACE_CONCAT_(a, b) a##b
+#define BT_TRACE_CONCAT(a, b) BT_TRACE_CONCAT_(a, b)
+
+#define BT_TRACE_ENABLED() (atrace_is_tag_enabled(ATRACE_TAG_BLUETOOTH) != 0)
+#define BT_TRACE_SCOPE(name) \
+  ::bluetooth::os::ScopedTrace BT_TRACE_CONCAT(bt_trace_scope_, __LINE__)(name)
+#define BT_TRACE_ASYNC_BEGIN(name, cookie) \
+  atrace_async_begin(ATRACE_TAG_BLUETOOTH, name, static_cast<int32_t>(cookie))
+#define BT_TRACE_ASYNC_END(name, cookie) \
+  atrace_async_end(ATRACE_TAG_BLUETOOTH, name, static_cast<int32_t>(cookie))
+#define BT_TRACE_COUNTER(name, value) \
+  atrace_int64(ATRACE_TAG_BLUETOOTH, name, static_cast<int64_t>(value))
+
+#else
+
+// sizeof() keeps the arguments used without evaluating them
+#define BT_TRACE_ENABLED() false
+#define BT_TRACE_SCOPE(name) static_cast<void>(sizeof(name))
+#define BT_TRACE_ASYNC_BEGIN(name, cookie) static_cast<void>(sizeof(name) + sizeof(cookie))
+#define BT_TRACE_ASYNC_END(name, cookie) static_cast<void>(sizeof(name) + sizeof(cookie))
+#define BT_TRACE_COUNTER(name, value) static_cast<void>(sizeof(name) + sizeof(value))
+
+#endif
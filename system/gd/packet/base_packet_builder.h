@@ -38,6 +38,15 @@ class BasePacketBuilder {
   // Write to the vector with the given iterator.
   virtual void Serialize(BitInserter& it) const = 0;
 
+  // Replace the content of |buffer| with the serialized packet. The capacity of |buffer| is kept, so a
+  // buffer reused across packets stops allocating once it fits the largest packet.
+  void SerializeTo(std::vector<uint8_t>& buffer) const {
+    buffer.clear();
+    buffer.reserve(size());
+    BitInserter it(buffer);
+    Serialize(it);
+  }
+
   void SetFlushable(bool is_flushable) {
     is_flushable_ = is_flushable;
   }
@@ -31,6 +31,7 @@ Iterator<little_endian>::Iterator(const std::forward_list<View>& data, size_t of
   for (auto& view : data) {
     end_ += view.size();
   }
+  SetContiguousData();
 }
 
 template <bool little_endian>
@@ -39,6 +40,15 @@ Iterator<little_endian>::Iterator(std::shared_ptr<std::vector<uint8_t>> data) {
   index_ = 0;
   begin_ = 0;
   end_ = data_.front().size();
+  SetContiguousData();
+}
+
+template <bool little_endian>
+void Iterator<little_endian>::SetContiguousData() {
+  if (!data_.empty() && std::next(data_.begin()) == data_.end()) {
+    contiguous_data_ = data_.front().data();
+    contiguous_size_ = data_.front().size();
+  }
 }
 
 template <bool little_endian>
@@ -96,6 +106,8 @@ Iterator<little_endian>& Iterator<little_endian>::operator=(const Iterator<littl
   this->begin_ = itr.begin_;
   this->end_ = itr.end_;
   this->index_ = itr.index_;
+  this->contiguous_data_ = itr.contiguous_data_;
+  this->contiguous_size_ = itr.contiguous_size_;
   return *this;
 }
 
@@ -132,6 +144,9 @@ bool Iterator<little_endian>::operator>=(const Iterator<little_endian>& itr) con
 template <bool little_endian>
 uint8_t Iterator<little_endian>::operator*() const {
   assert(NumBytesRemaining() > 0);
+  if (index_ < contiguous_size_) {
+    return contiguous_data_[index_];
+  }
   size_t index = index_;
 
   for (auto view : data_) {
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <forward_list>
 #include <memory>
 #include <type_traits>
@@ -84,6 +86,10 @@ class Iterator : public IteratorTraits {
     T extracted_value{};
     uint8_t* value_ptr = (uint8_t*)&extracted_value;
 
+    if (IsContiguous(sizeof(T))) {
+      ExtractContiguous(value_ptr, sizeof(T));
+      return extracted_value;
+    }
     for (size_t i = 0; i < sizeof(T); i++) {
       size_t index = (little_endian ? i : sizeof(T) - i - 1);
       value_ptr[index] = this->operator*();
@@ -95,6 +101,10 @@ class Iterator : public IteratorTraits {
   template <typename T, typename std::enable_if<std::is_base_of_v<CustomFieldFixedSizeInterface<T>, T>, int>::type = 0>
   T extract() {
     T extracted_value{};
+    if (IsContiguous(CustomFieldFixedSizeInterface<T>::length())) {
+      ExtractContiguous(extracted_value.data(), CustomFieldFixedSizeInterface<T>::length());
+      return extracted_value;
+    }
     for (size_t i = 0; i < CustomFieldFixedSizeInterface<T>::length(); i++) {
       size_t index = (little_endian ? i : CustomFieldFixedSizeInterface<T>::length() - i - 1);
       extracted_value.data()[index] = this->operator*();
@@ -104,10 +114,30 @@ class Iterator : public IteratorTraits {
   }
 
  private:
+  // True if the next |length| bytes are in the contiguous data.
+  bool IsContiguous(size_t length) const {
+    return length <= contiguous_size_ && index_ <= contiguous_size_ - length;
+  }
+
+  // Copy |length| bytes at the current position with the endianness of the packet, and advance.
+  void ExtractContiguous(uint8_t* value_ptr, size_t length) {
+    std::memcpy(value_ptr, contiguous_data_ + index_, length);
+    if (!little_endian) {
+      std::reverse(value_ptr, value_ptr + length);
+    }
+    index_ += length;
+  }
+
+  void SetContiguousData();
+
   std::forward_list<View> data_;
   size_t index_;
   size_t begin_;
   size_t end_;
+  // Nearly all packets are received in a single fragment, which is then read through this pointer
+  // instead of walking the fragments for each byte. |contiguous_size_| is 0 for fragmented packets.
+  const uint8_t* contiguous_data_{nullptr};
+  size_t contiguous_size_{0};
 };
 
 }  // namespace packet
@@ -96,6 +96,18 @@ TEST(PacketBuilderEndianTest, insertTest) {
   ASSERT_EQ(*big.FinalPacket(), *little.FinalPacket());
 }
 
+TEST(PacketBuilderEndianTest, serializeToReusedBuffer) {
+  EndianBuilder<true> little(0x04, 0x0605, 0x0a090807, 0x1211100f0e0d0c0b);
+  std::vector<uint8_t> buffer(64, 0xff);
+  little.SerializeTo(buffer);
+  ASSERT_EQ(*little.FinalPacket(), buffer);
+
+  const uint8_t* data = buffer.data();
+  little.SerializeTo(buffer);
+  ASSERT_EQ(*little.FinalPacket(), buffer);
+  ASSERT_EQ(data, buffer.data());
+}
+
 template <typename T>
 class VectorBuilder : public PacketBuilder<true> {
  public:
@@ -19,6 +19,8 @@
 #undef NDEBUG
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <iterator>
 
 namespace bluetooth {
 namespace packet {
@@ -69,6 +71,22 @@ size_t PacketView<little_endian>::size() const {
   return length_;
 }
 
+template <bool little_endian>
+void PacketView<little_endian>::CopyTo(uint8_t* dest) const {
+  for (const auto& fragment : fragments_) {
+    std::memcpy(dest, fragment.data(), fragment.size());
+    dest += fragment.size();
+  }
+}
+
+template <bool little_endian>
+const uint8_t* PacketView<little_endian>::ContiguousData() const {
+  if (fragments_.empty() || std::next(fragments_.begin()) != fragments_.end()) {
+    return nullptr;
+  }
+  return fragments_.front().data();
+}
+
 template <bool little_endian>
 std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin, size_t end) const {
   assert(begin <= end);
@@ -48,6 +48,14 @@ class PacketView {
 
   size_t size() const;
 
+  // Copy all bytes of the view into |dest|, which must hold at least size()
+  // bytes. Each fragment is copied in one block.
+  void CopyTo(uint8_t* dest) const;
+
+  // The bytes of the view when they are held in a single fragment, nullptr
+  // otherwise. Valid as long as the view, or a copy of it, is alive.
+  const uint8_t* ContiguousData() const;
+
   PacketView<true> GetLittleEndianSubview(size_t begin, size_t end) const;
   PacketView<false> GetBigEndianSubview(size_t begin, size_t end) const;
 
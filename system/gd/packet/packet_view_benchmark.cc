@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <forward_list>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace packet {
+
+// An LE advertising report sized packet.
+static std::vector<uint8_t> GetBytes() {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i < 64; i++) {
+    bytes.push_back(static_cast<uint8_t>(i));
+  }
+  return bytes;
+}
+
+// Reads the packet as a sequence of 16 bit and 32 bit fields, like the generated accessors.
+static void ExtractFields(const PacketView<kLittleEndian>& packet) {
+  auto it = packet.begin();
+  while (it.NumBytesRemaining() >= sizeof(uint16_t) + sizeof(uint32_t)) {
+    benchmark::DoNotOptimize(it.extract<uint16_t>());
+    benchmark::DoNotOptimize(it.extract<uint32_t>());
+  }
+}
+
+static void BM_ExtractSingleFragment(State& state) {
+  PacketView<kLittleEndian> packet(std::make_shared<const std::vector<uint8_t>>(GetBytes()));
+  for (auto _ : state) {
+    ExtractFields(packet);
+  }
+}
+BENCHMARK(BM_ExtractSingleFragment);
+
+static void BM_ExtractTwoFragments(State& state) {
+  auto bytes = std::make_shared<const std::vector<uint8_t>>(GetBytes());
+  PacketView<kLittleEndian> packet(std::forward_list<View>{View(bytes, 0, 32), View(bytes, 32, bytes->size())});
+  for (auto _ : state) {
+    ExtractFields(packet);
+  }
+}
+BENCHMARK(BM_ExtractTwoFragments);
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -18,6 +18,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <forward_list>
 #include <memory>
 
@@ -556,6 +557,18 @@ TEST_F(PacketViewMultiViewTest, dereferenceTestBigEndian) {
   ASSERT_DEATH(*multi_itr, "");
 }
 
+TEST_F(PacketViewMultiViewTest, extractTest) {
+  // The single view is read through the contiguous data, the fields of the multi view span the fragments.
+  auto single_itr = single_view.begin();
+  auto multi_itr = multi_view.begin();
+  ASSERT_EQ(single_itr.extract<uint16_t>(), multi_itr.extract<uint16_t>());
+  ASSERT_EQ(single_itr.extract<uint32_t>(), multi_itr.extract<uint32_t>());
+  ASSERT_EQ(single_itr.extract<uint64_t>(), multi_itr.extract<uint64_t>());
+  ASSERT_EQ(single_itr.extract<Address>(), multi_itr.extract<Address>());
+  ASSERT_EQ(single_itr.NumBytesRemaining(), multi_itr.NumBytesRemaining());
+  ASSERT_EQ(*single_itr, *multi_itr);
+}
+
 TEST_F(PacketViewMultiViewTest, arrayOperatorTest) {
   for (size_t i = 0; i < single_view.size(); i++) {
     ASSERT_EQ(single_view[i], multi_view[i]);
@@ -563,6 +576,30 @@ TEST_F(PacketViewMultiViewTest, arrayOperatorTest) {
   ASSERT_DEATH(multi_view[single_view.size()], "");
 }
 
+TEST_F(PacketViewMultiViewTest, copyToTest) {
+  vector<uint8_t> single_copy(single_view.size());
+  vector<uint8_t> multi_copy(multi_view.size());
+  single_view.CopyTo(single_copy.data());
+  multi_view.CopyTo(multi_copy.data());
+  ASSERT_EQ(count_all, single_copy);
+  ASSERT_EQ(count_all, multi_copy);
+}
+
+TEST_F(PacketViewMultiViewTest, copyToSubviewTest) {
+  auto subview = multi_view.GetLittleEndianSubview(2, 20);
+  vector<uint8_t> copy(subview.size());
+  subview.CopyTo(copy.data());
+  ASSERT_EQ(vector<uint8_t>(count_all.begin() + 2, count_all.begin() + 20), copy);
+}
+
+TEST_F(PacketViewMultiViewTest, contiguousDataTest) {
+  ASSERT_EQ(0, std::memcmp(count_all.data(), single_view.ContiguousData(), count_all.size()));
+  ASSERT_EQ(nullptr, multi_view.ContiguousData());
+  auto subview = multi_view.GetLittleEndianSubview(1, 2);
+  ASSERT_NE(nullptr, subview.ContiguousData());
+  ASSERT_EQ(count_all[1], *subview.ContiguousData());
+}
+
 TEST_F(PacketViewMultiViewAppendTest, sizeTestAppend) {
   ASSERT_EQ(single_view.size(), multi_view.size());
 }
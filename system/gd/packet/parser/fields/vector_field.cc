@@ -152,7 +152,12 @@ std::string VectorField::GetGetterFunctionName() const {
 }
 
 void VectorField::GenGetter(std::ostream& s, Size start_offset, Size end_offset) const {
-  s << GetDataType() << " " << GetGetterFunctionName() << "() const {";
+  GenGetter(s, start_offset, end_offset, GetGetterFunctionName());
+}
+
+void VectorField::GenGetter(
+    std::ostream& s, Size start_offset, Size end_offset, const std::string& function_name) const {
+  s << GetDataType() << " " << function_name << "() const {";
   s << "ASSERT(was_validated_);";
   s << "size_t end_index = size();";
   s << "auto to_bound = begin();";
@@ -166,6 +171,19 @@ void VectorField::GenGetter(std::ostream& s, Size start_offset, Size end_offset)
   s << "}\n";
 }
 
+void VectorField::GenGetterInto(std::ostream& s, Size start_offset, Size end_offset) const {
+  s << "void " << GetGetterFunctionName() << "(" << GetDataType() << "& " << GetName() << "_value) const {";
+  s << "ASSERT(was_validated_);";
+  s << "size_t end_index = size();";
+  s << "auto to_bound = begin();";
+
+  int num_leading_bits = GenBounds(s, start_offset, end_offset, GetSize());
+  s << GetName() << "_value.clear();";
+  s << GetDataType() << "* " << GetName() << "_ptr = &" << GetName() << "_value;";
+  GenExtractor(s, num_leading_bits, false);
+  s << "}\n";
+}
+
 std::string VectorField::GetBuilderParameterType() const {
   std::stringstream ss;
   if (element_field_->BuilderParameterMustBeMoved()) {
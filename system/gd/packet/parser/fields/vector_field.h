@@ -45,6 +45,13 @@ class VectorField : public PacketField {
 
   virtual void GenGetter(std::ostream& s, Size start_offset, Size end_offset) const override;
 
+  // Generates the getter under |function_name| instead of the field getter name.
+  void GenGetter(std::ostream& s, Size start_offset, Size end_offset, const std::string& function_name) const;
+
+  // Generates a getter overload filling a vector owned by the caller, which
+  // keeps its capacity when it is reused for the next packets.
+  void GenGetterInto(std::ostream& s, Size start_offset, Size end_offset) const;
+
   virtual std::string GetBuilderParameterType() const override;
 
   virtual bool BuilderParameterMustBeMoved() const override;
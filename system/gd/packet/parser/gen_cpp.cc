@@ -54,6 +54,9 @@ bool generate_cpp_headers_one_file(
     const Declarations& decls,
     bool generate_fuzzing,
     bool generate_tests,
+    bool generate_fixed_layout,
+    bool cache_views,
+    bool vector_out_params,
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
@@ -115,6 +118,14 @@ bool generate_cpp_headers_one_file(
 #endif // __has_include(<bluetooth/log.h>)
 )";
 
+  if (generate_fixed_layout) {
+    out_file <<
+        R"(
+#include <algorithm>
+#include <array>
+)";
+  }
+
   if (generate_fuzzing || generate_tests) {
     out_file <<
         R"(
@@ -221,10 +232,20 @@ using ::bluetooth::packet::RawBuilder;
   }
 
   for (const auto& packet_def : decls.packet_defs_queue_) {
-    packet_def.second->GenParserDefinition(out_file, generate_fuzzing, generate_tests);
+    packet_def.second->GenParserDefinition(
+        out_file, generate_fuzzing, generate_tests, cache_views, vector_out_params);
     out_file << "\n\n";
   }
 
+  if (generate_fixed_layout) {
+    for (const auto& packet_def : decls.packet_defs_queue_) {
+      if (packet_def.second->HasFixedLayout()) {
+        packet_def.second->GenFixedLayoutDefinition(out_file);
+        out_file << "\n\n";
+      }
+    }
+  }
+
   for (const auto& packet_def : decls.packet_defs_queue_) {
     packet_def.second->GenBuilderDefinition(out_file, generate_fuzzing, generate_tests);
     out_file << "\n\n";
@@ -41,6 +41,9 @@ bool generate_cpp_headers_one_file(
     const Declarations& decls,
     bool generate_fuzzing,
     bool generate_tests,
+    bool generate_fixed_layout,
+    bool cache_views,
+    bool vector_out_params,
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
@@ -107,6 +110,15 @@ void usage(const char* prog) {
 
   ofs << std::setw(24) << "--source_root= ";
   ofs << "Root path to the source directory. Find input files relative to this." << std::endl;
+
+  ofs << std::setw(24) << "--fixed_layout ";
+  ofs << "Generate single copy parsers for the packets whose fields are all at fixed offsets." << std::endl;
+
+  ofs << std::setw(24) << "--cache_views ";
+  ofs << "Skip validating parent views again and parse vector fields once per view." << std::endl;
+
+  ofs << std::setw(24) << "--vector_out_params ";
+  ofs << "Generate vector getter overloads filling a vector owned by the caller." << std::endl;
 }
 
 int main(int argc, const char** argv) {
@@ -117,6 +129,9 @@ int main(int argc, const char** argv) {
   std::string root_namespace = "bluetooth";
   bool generate_fuzzing = false;
   bool generate_tests = false;
+  bool generate_fixed_layout = false;
+  bool cache_views = false;
+  bool vector_out_params = false;
   std::queue<std::filesystem::path> input_files;
 
   const std::string arg_out = "--out=";
@@ -124,6 +139,9 @@ int main(int argc, const char** argv) {
   const std::string arg_namespace = "--root_namespace=";
   const std::string arg_fuzzing = "--fuzzing";
   const std::string arg_testing = "--testing";
+  const std::string arg_fixed_layout = "--fixed_layout";
+  const std::string arg_cache_views = "--cache_views";
+  const std::string arg_vector_out_params = "--vector_out_params";
   const std::string arg_source_root = "--source_root=";
 
   // Parse the source root first (if it exists) since it will be used for other
@@ -147,6 +165,12 @@ int main(int argc, const char** argv) {
       generate_fuzzing = true;
     } else if (arg.find(arg_testing) == 0) {
       generate_tests = true;
+    } else if (arg.find(arg_fixed_layout) == 0) {
+      generate_fixed_layout = true;
+    } else if (arg.find(arg_cache_views) == 0) {
+      cache_views = true;
+    } else if (arg.find(arg_vector_out_params) == 0) {
+      vector_out_params = true;
     } else if (arg.find(arg_source_root) == 0) {
       // Do nothing (just don't treat it as input_files)
     } else {
@@ -172,6 +196,9 @@ int main(int argc, const char** argv) {
             declarations,
             generate_fuzzing,
             generate_tests,
+            generate_fixed_layout,
+            cache_views,
+            vector_out_params,
             input_files.front(),
             include_dir,
             out_dir,
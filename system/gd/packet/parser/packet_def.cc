@@ -16,9 +16,11 @@
 
 #include "packet_def.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <list>
 #include <set>
+#include <vector>
 
 #include "fields/all_fields.h"
 #include "packet_dependency.h"
@@ -31,7 +33,8 @@ PacketField* PacketDef::GetNewField(const std::string&, ParseLocation) const {
   return nullptr;  // Packets can't be fields
 }
 
-void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const {
+void PacketDef::GenParserDefinition(
+    std::ostream& s, bool generate_fuzzing, bool generate_tests, bool cache_views, bool vector_out_params) const {
   s << "class " << name_ << "View";
   if (parent_ != nullptr) {
     s << " : public " << parent_->name_ << "View {";
@@ -75,10 +78,17 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
   const auto& public_fields = fields_.GetFieldsWithoutTypes(fixed_types);
   bool has_fixed_fields = public_fields.size() != fields_.size();
   for (const auto& field : public_fields) {
-    GenParserFieldGetter(s, field);
+    if (cache_views && field->GetFieldType() == VectorField::kFieldType) {
+      GenParserCachedVectorGetter(s, field);
+    } else {
+      GenParserFieldGetter(s, field);
+    }
+    if (vector_out_params && field->GetFieldType() == VectorField::kFieldType) {
+      GenParserVectorGetterInto(s, field);
+    }
     s << "\n";
   }
-  GenValidator(s);
+  GenValidator(s, cache_views);
   s << "\n";
 
   s << " public:";
@@ -89,7 +99,12 @@ void PacketDef::GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool
   // Constructor from a View
   if (parent_ != nullptr) {
     s << "explicit " << name_ << "View(" << parent_->name_ << "View parent)";
-    s << " : " << parent_->name_ << "View(std::move(parent)) { was_validated_ = false; }";
+    s << " : " << parent_->name_ << "View(std::move(parent)) {";
+    if (cache_views) {
+      // The parent views already validated are not validated again.
+      s << "if (was_validated_) { validated_depth_ = " << GetDepth() - 1 << "; }";
+    }
+    s << "was_validated_ = false; }";
   } else {
     s << "explicit " << name_ << "View(PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian> packet) ";
     s << " : PacketView<" << (is_little_endian_ ? "" : "!") << "kLittleEndian>(packet) { was_validated_ = false;}";
@@ -179,11 +194,52 @@ void PacketDef::GenParserFieldGetter(std::ostream& s, const PacketField* field)
   field->GenGetter(s, start_field_offset, end_field_offset);
 }
 
+void PacketDef::GenParserCachedVectorGetter(std::ostream& s, const PacketField* field) const {
+  auto start_field_offset = GetOffsetForField(field->GetName(), false);
+  auto end_field_offset = GetOffsetForField(field->GetName(), true);
+
+  if (start_field_offset.empty() && end_field_offset.empty()) {
+    ERROR(field) << "Field location for " << field->GetName() << " is ambiguous, "
+                 << "no method exists to determine field location from begin() or end().\n";
+  }
+
+  auto parse_function_name = "Parse" + util::UnderscoreToCamelCase(field->GetName());
+  auto cache_name = field->GetName() + "_cache_";
+  s << " private:";
+  static_cast<const VectorField*>(field)->GenGetter(s, start_field_offset, end_field_offset, parse_function_name);
+  s << "mutable std::optional<" << field->GetDataType() << "> " << cache_name << ";";
+  s << " public:";
+  s << field->GetDataType() << " " << field->GetGetterFunctionName() << "() const {";
+  s << "if (!" << cache_name << ".has_value()) { " << cache_name << " = " << parse_function_name << "(); }";
+  s << "return *" << cache_name << ";";
+  s << "}\n";
+}
+
+void PacketDef::GenParserVectorGetterInto(std::ostream& s, const PacketField* field) const {
+  auto start_field_offset = GetOffsetForField(field->GetName(), false);
+  auto end_field_offset = GetOffsetForField(field->GetName(), true);
+
+  if (start_field_offset.empty() && end_field_offset.empty()) {
+    ERROR(field) << "Field location for " << field->GetName() << " is ambiguous, "
+                 << "no method exists to determine field location from begin() or end().\n";
+  }
+
+  static_cast<const VectorField*>(field)->GenGetterInto(s, start_field_offset, end_field_offset);
+}
+
+size_t PacketDef::GetDepth() const {
+  size_t depth = 0;
+  for (const ParentDef* def = this; def != nullptr; def = def->parent_) {
+    depth++;
+  }
+  return depth;
+}
+
 TypeDef::Type PacketDef::GetDefinitionType() const {
   return TypeDef::Type::PACKET;
 }
 
-void PacketDef::GenValidator(std::ostream& s) const {
+void PacketDef::GenValidator(std::ostream& s, bool cache_views) const {
   // Get the static offset for all of our fields.
   int bits_size = 0;
   for (const auto& field : fields_) {
@@ -212,7 +268,12 @@ void PacketDef::GenValidator(std::ostream& s) const {
     s << "virtual bool Validate() const {" << std::endl;
   } else {
     s << "bool Validate() const override {" << std::endl;
-    s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
+    if (cache_views) {
+      s << "  if (validated_depth_ < " << GetDepth() - 1 << " && !" << parent_->name_ << "View::Validate()) {"
+        << std::endl;
+    } else {
+      s << "  if (!" << parent_->name_ << "View::Validate()) {" << std::endl;
+    }
     s << "    return false;" << std::endl;
     s << "  }" << std::endl;
   }
@@ -343,6 +404,10 @@ void PacketDef::GenValidator(std::ostream& s) const {
   s << "}\n";
   if (parent_ == nullptr) {
     s << "bool was_validated_{false};\n";
+    if (cache_views) {
+      // Number of parent views, from the root, known to be valid.
+      s << "size_t validated_depth_{0};\n";
+    }
   }
 }
 
@@ -375,6 +440,115 @@ void PacketDef::GenParserToString(std::ostream& s) const {
   s << "}\n";
 }
 
+bool PacketDef::HasFixedLayout() const {
+  if (!is_little_endian_) {
+    return false;
+  }
+
+  for (const ParentDef* def = this; def != nullptr; def = def->parent_) {
+    for (const auto& field : def->fields_) {
+      const auto& field_type = field->GetFieldType();
+      // The payload of a parent holds the fields of its child.
+      if (field_type == PayloadField::kFieldType || field_type == BodyField::kFieldType) {
+        continue;
+      }
+      if (field_type != ScalarField::kFieldType && field_type != EnumField::kFieldType &&
+          field_type != CustomFieldFixedSize::kFieldType && field_type != FixedScalarField::kFieldType &&
+          field_type != FixedEnumField::kFieldType && field_type != ReservedField::kFieldType &&
+          field_type != SizeField::kFieldType && field_type != CountField::kFieldType) {
+        return false;
+      }
+
+      auto size = field->GetSize();
+      auto offset = def->GetOffsetForField(field->GetName(), false);
+      if (size.empty() || size.has_dynamic() || offset.empty() || offset.has_dynamic()) {
+        return false;
+      }
+      if (field_type == CustomFieldFixedSize::kFieldType) {
+        if (offset.bits() % 8 != 0) {
+          return false;
+        }
+      } else if (offset.bits() % 8 + size.bits() > 64) {
+        // Scalars are extracted from a single 64 bit word.
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void PacketDef::GenFixedLayoutDefinition(std::ostream& s) const {
+  std::vector<const ParentDef*> chain;
+  for (const ParentDef* def = this; def != nullptr; def = def->parent_) {
+    chain.insert(chain.begin(), def);
+  }
+
+  int size_bits = 0;
+  for (const auto* def : chain) {
+    for (const auto& field : def->fields_) {
+      if (field->GetFieldType() == PayloadField::kFieldType || field->GetFieldType() == BodyField::kFieldType) {
+        continue;
+      }
+      auto end = def->GetOffsetForField(field->GetName(), false).bits() + field->GetSize().bits();
+      size_bits = std::max(size_bits, end);
+    }
+  }
+
+  std::set<std::string> public_types = {
+      ScalarField::kFieldType,
+      EnumField::kFieldType,
+      CustomFieldFixedSize::kFieldType,
+  };
+
+  s << "struct " << name_ << "Fields {";
+  s << "static constexpr size_t kSize = " << (size_bits + 7) / 8 << ";";
+  for (const auto* def : chain) {
+    for (const auto& field : def->fields_) {
+      if (public_types.count(field->GetFieldType()) != 0) {
+        s << field->GetDataType() << " " << field->GetName() << "_{};";
+      }
+    }
+  }
+  s << "\n";
+
+  s << "static std::optional<" << name_ << "Fields> Parse(" << name_ << "View view) {";
+  s << "if (!view.IsValid()) { return std::nullopt; }";
+  s << "std::array<uint8_t, kSize> bytes;";
+  s << "if (view.size() == kSize) { view.CopyTo(bytes.data()); }";
+  s << "else { view.GetLittleEndianSubview(0, kSize).CopyTo(bytes.data()); }";
+  s << name_ << "Fields fields;";
+  for (const auto* def : chain) {
+    for (const auto& field : def->fields_) {
+      if (public_types.count(field->GetFieldType()) == 0) {
+        continue;
+      }
+      int offset = def->GetOffsetForField(field->GetName(), false).bits();
+      int bits = field->GetSize().bits();
+      if (field->GetFieldType() == CustomFieldFixedSize::kFieldType) {
+        s << "std::copy_n(bytes.data() + " << offset / 8 << ", CustomFieldFixedSizeInterface<" << field->GetDataType()
+          << ">::length(), fields." << field->GetName() << "_.data());";
+        continue;
+      }
+      // Little endian bytes covering the field, shifted and masked down to it.
+      int first_byte = offset / 8;
+      int last_byte = (offset + bits - 1) / 8;
+      s << "fields." << field->GetName() << "_ = static_cast<" << field->GetDataType() << ">(((";
+      s << "uint64_t{bytes[" << first_byte << "]}";
+      for (int byte = first_byte + 1; byte <= last_byte; byte++) {
+        s << " | (uint64_t{bytes[" << byte << "]} << " << (byte - first_byte) * 8 << ")";
+      }
+      s << ") >> " << offset % 8 << ")";
+      if (bits < 64) {
+        s << " & 0x" << std::hex << ((uint64_t{1} << bits) - 1) << std::dec;
+      }
+      s << ");";
+    }
+  }
+  s << "return fields;";
+  s << "}\n";
+  s << "};\n";
+}
+
 void PacketDef::GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const {
   s << "class " << name_ << "Builder";
   if (parent_ != nullptr) {
@@ -31,7 +31,8 @@ class PacketDef : public ParentDef {
 
   PacketField* GetNewField(const std::string& name, ParseLocation loc) const;
 
-  void GenParserDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const;
+  void GenParserDefinition(
+      std::ostream& s, bool generate_fuzzing, bool generate_tests, bool cache_views, bool vector_out_params) const;
 
   void GenTestingParserFromBytes(std::ostream& s) const;
 
@@ -39,10 +40,29 @@ class PacketDef : public ParentDef {
 
   void GenParserFieldGetter(std::ostream& s, const PacketField* field) const;
 
-  void GenValidator(std::ostream& s) const;
+  // Generates a getter that parses the vector field once per view and returns
+  // the saved copy afterwards.
+  void GenParserCachedVectorGetter(std::ostream& s, const PacketField* field) const;
+
+  // Generates a getter overload that parses the vector field into a vector
+  // owned by the caller.
+  void GenParserVectorGetterInto(std::ostream& s, const PacketField* field) const;
+
+  void GenValidator(std::ostream& s, bool cache_views) const;
+
+  // Number of views in the inheritance chain up to and including this one.
+  size_t GetDepth() const;
 
   void GenParserToString(std::ostream& s) const;
 
+  // True when every field of the packet and of its parents, up to its own
+  // payload or body, is at a fixed offset from the start of the packet.
+  bool HasFixedLayout() const;
+
+  // Generates <Name>Fields, which decodes all the fields of a view with a
+  // fixed layout from a single copy of its header.
+  void GenFixedLayoutDefinition(std::ostream& s) const;
+
   TypeDef::Type GetDefinitionType() const;
 
   void GenBuilderDefinition(std::ostream& s, bool generate_fuzzing, bool generate_tests) const;
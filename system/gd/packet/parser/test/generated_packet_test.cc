@@ -168,6 +168,31 @@ TEST(GeneratedPacketTest, testValidateTooBig) {
   ASSERT_TRUE(lenient.IsValid());
 }
 
+TEST(GeneratedPacketTest, testChildWithSixBytesFixedLayout) {
+  std::vector<uint8_t> too_big_bytes = {0x34, 0x12, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                        0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x20};
+  auto too_big = std::make_shared<std::vector<uint8_t>>(too_big_bytes.begin(), too_big_bytes.end());
+
+  auto fields = ChildWithSixBytesFields::Parse(
+      ChildWithSixBytesView::Create(ParentWithSixBytesView::Create(PacketView<kLittleEndian>(too_big))));
+  ASSERT_TRUE(fields.has_value());
+  ASSERT_EQ(ChildWithSixBytesFields::kSize, 14u);
+  ASSERT_EQ(0x1234, fields->two_bytes_);
+  ASSERT_EQ((SixBytes{{0x01, 0x02, 0x03, 0x04, 0x05, 0x06}}), fields->six_bytes_);
+  ASSERT_EQ((SixBytes{{0x11, 0x12, 0x13, 0x14, 0x15, 0x16}}), fields->child_six_bytes_);
+
+  // The same checks as the view: too short, or not matching the constraint
+  too_big->resize(ChildWithSixBytesFields::kSize - 1);
+  ASSERT_FALSE(ChildWithSixBytesFields::Parse(
+                   ChildWithSixBytesView::Create(ParentWithSixBytesView::Create(PacketView<kLittleEndian>(too_big))))
+                   .has_value());
+  too_big->resize(ChildWithSixBytesFields::kSize);
+  too_big->at(0) = 0x35;
+  ASSERT_FALSE(ChildWithSixBytesFields::Parse(
+                   ChildWithSixBytesView::Create(ParentWithSixBytesView::Create(PacketView<kLittleEndian>(too_big))))
+                   .has_value());
+}
+
 TEST(GeneratedPacketTest, testValidateDeath) {
   auto packet = ChildTwoTwoThreeBuilder::Create();
 
@@ -252,6 +277,18 @@ TEST(GeneratedPacketTest, testMiddleFourBitsPacket) {
   ASSERT_EQ(high_two, view.GetHighTwo());
 }
 
+TEST(GeneratedPacketTest, testMiddleFourBitsFixedLayout) {
+  auto packet_bytes = std::make_shared<std::vector<uint8_t>>(middle_four_bits.begin(), middle_four_bits.end());
+  auto fields = MiddleFourBitsFields::Parse(MiddleFourBitsView::Create(PacketView<kLittleEndian>(packet_bytes)));
+  ASSERT_TRUE(fields.has_value());
+  ASSERT_EQ(MiddleFourBitsFields::kSize, middle_four_bits.size());
+  ASSERT_EQ(TwoBits::ONE, fields->low_two_);
+  ASSERT_EQ(FourBits::FIVE, fields->next_four_);
+  ASSERT_EQ(FourBits::TEN, fields->straddle_);
+  ASSERT_EQ(FourBits::TWO, fields->four_more_);
+  ASSERT_EQ(TwoBits::TWO, fields->high_two_);
+}
+
 TEST(GeneratedPacketTest, testChildWithSixBytes) {
   SixBytes six_bytes_a{{0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6}};
   SixBytes six_bytes_b{{0xb1, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6}};
@@ -1254,6 +1291,41 @@ TEST(GeneratedPacketTest, testBitFieldGroupAfterUnsizedArrayPacket) {
   ASSERT_EQ(five_bits, view.GetFiveBits());
 }
 
+TEST(GeneratedPacketTest, testCachedViews) {
+  auto packet_bytes = std::make_shared<std::vector<uint8_t>>(
+      bit_field_group_after_unsized_array_packet.begin(), bit_field_group_after_unsized_array_packet.end());
+
+  // A child of a validated view only validates its own fields
+  auto payload_view = BitFieldGroupAfterPayloadPacketView::Create(PacketView<kLittleEndian>(packet_bytes));
+  ASSERT_TRUE(payload_view.IsValid());
+  auto view = BitFieldGroupAfterUnsizedArrayPacketView::Create(payload_view);
+  ASSERT_TRUE(view.IsValid());
+
+  auto array = view.GetArray();
+  ASSERT_EQ(4u, array.size());
+  ASSERT_EQ(array, view.GetArray());
+
+  // A child of a view that was not validated validates the whole chain
+  packet_bytes->resize(1);
+  auto short_view = BitFieldGroupAfterUnsizedArrayPacketView::Create(
+      BitFieldGroupAfterPayloadPacketView::Create(PacketView<kLittleEndian>(packet_bytes)));
+  ASSERT_FALSE(short_view.IsValid());
+}
+
+TEST(GeneratedPacketTest, testVectorGetterInto) {
+  auto packet_bytes = std::make_shared<std::vector<uint8_t>>(
+      bit_field_group_after_unsized_array_packet.begin(), bit_field_group_after_unsized_array_packet.end());
+  auto view = BitFieldGroupAfterUnsizedArrayPacketView::Create(
+      BitFieldGroupAfterPayloadPacketView::Create(PacketView<kLittleEndian>(packet_bytes)));
+  ASSERT_TRUE(view.IsValid());
+
+  // The previous contents are replaced and the capacity is kept
+  std::vector<uint8_t> array(16, 0xff);
+  view.GetArray(array);
+  ASSERT_EQ(view.GetArray(), array);
+  ASSERT_GE(array.capacity(), 16u);
+}
+
 vector<uint8_t> bit_field_after_unsized_array_packet{
     0x01, 0x02, 0x03, 0x04,  // byte array
     // seven_bits_ = 0x77, straddle_ = 0x5, five_bits_ = 0x15
@@ -21,7 +21,9 @@
 #include <com_android_bluetooth_flags.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <future>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -43,6 +45,8 @@ static const std::string kReadOnlyDebuggableProperty = "ro.debuggable";
 namespace {
 constexpr char kModuleName[] = "shim::Dumpsys";
 constexpr char kDumpsysTitle[] = "----- Gd Dumpsys ------";
+// Time a module may take to dump its state on the stack thread
+constexpr std::chrono::milliseconds kModuleDumpsysTimeBudget(50);
 }  // namespace
 
 struct Dumpsys::impl {
@@ -55,7 +59,10 @@ struct Dumpsys::impl {
 
  protected:
   void FilterSchema(std::string* dumpsys_data) const;
-  std::string PrintAsJson(std::string* dumpsys_data) const;
+  // Returns the parser printing the dumpsys data as JSON, nullptr after
+  // writing the error to |fd|
+  std::unique_ptr<flatbuffers::Parser> GetJsonParser(int fd) const;
+  std::string PrintAsJson(const flatbuffers::Parser& parser, std::string* dumpsys_data) const;
 
   bool IsDebuggable() const;
 
@@ -85,15 +92,14 @@ void Dumpsys::impl::FilterSchema(std::string* dumpsys_data) const {
   dumpsys::FilterSchema(reflection_schema_, dumpsys_data);
 }
 
-std::string Dumpsys::impl::PrintAsJson(std::string* dumpsys_data) const {
-  log::assert_that(dumpsys_data != nullptr, "assert failed: dumpsys_data != nullptr");
-
+std::unique_ptr<flatbuffers::Parser> Dumpsys::impl::GetJsonParser(int fd) const {
   const std::string root_name = reflection_schema_.GetRootName();
   if (root_name.empty()) {
     char buf[255];
     snprintf(buf, sizeof(buf), "ERROR: Unable to find root name in prebundled reflection schema\n");
     log::warn("{}", buf);
-    return std::string(buf);
+    dprintf(fd, "%s", buf);
+    return nullptr;
   }
 
   const reflection::Schema* schema = reflection_schema_.FindInReflectionSchema(root_name);
@@ -101,18 +107,25 @@ std::string Dumpsys::impl::PrintAsJson(std::string* dumpsys_data) const {
     char buf[255];
     snprintf(buf, sizeof(buf), "ERROR: Unable to find schema root name:%s\n", root_name.c_str());
     log::warn("{}", buf);
-    return std::string(buf);
+    dprintf(fd, "%s", buf);
+    return nullptr;
   }
 
   flatbuffers::IDLOptions options{};
   options.output_default_scalars_in_json = true;
-  flatbuffers::Parser parser{options};
-  if (!parser.Deserialize(schema)) {
+  auto parser = std::make_unique<flatbuffers::Parser>(options);
+  if (!parser->Deserialize(schema)) {
     char buf[255];
     snprintf(buf, sizeof(buf), "ERROR: Unable to deserialize bundle root name:%s\n", root_name.c_str());
     log::warn("{}", buf);
-    return std::string(buf);
+    dprintf(fd, "%s", buf);
+    return nullptr;
   }
+  return parser;
+}
+
+std::string Dumpsys::impl::PrintAsJson(const flatbuffers::Parser& parser, std::string* dumpsys_data) const {
+  log::assert_that(dumpsys_data != nullptr, "assert failed: dumpsys_data != nullptr");
 
   std::string jsongen;
   // GenerateText was renamed to GenText in 23.5.26 because the return behavior was changed.
@@ -135,15 +148,21 @@ void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) const {
   ParsedDumpsysArgs parsed_dumpsys_args(args);
   const auto registry = dumpsys_module_.GetModuleRegistry();
 
-  ModuleDumper dumper(fd, *registry, kDumpsysTitle);
-  std::string dumpsys_data;
-  std::ostringstream oss;
-  dumper.DumpState(&dumpsys_data, oss);
-
   dprintf(fd, " ----- Filtering as Developer -----\n");
-  FilterSchema(&dumpsys_data);
+  auto parser = GetJsonParser(fd);
+  if (parser == nullptr) {
+    return;
+  }
 
-  dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
+  // Each section is filtered and written as soon as it is built, instead of
+  // building the state of all the modules first
+  ModuleDumper dumper(fd, *registry, kDumpsysTitle);
+  dumper.DumpStateBySection(
+      [this, fd, &parser](std::string* section) {
+        FilterSchema(section);
+        dprintf(fd, "%s", PrintAsJson(*parser, section).c_str());
+      },
+      kModuleDumpsysTimeBudget);
 }
 
 void Dumpsys::impl::DumpWithArgsSync(int fd, const char** args, std::promise<void> promise) {
@@ -36,6 +36,9 @@ using ::bluetooth::os::WakelockManager;
 
 namespace bluetooth {
 
+// Start the modules whose dependencies are started concurrently.
+static constexpr char kPropertyParallelModuleStart[] = "bluetooth.gd.parallel_module_start";
+
 void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
   management_thread_ = new Thread("management_thread", Thread::Priority::NORMAL);
   handler_ = new Handler(management_thread_);
@@ -63,7 +66,17 @@ void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
 }
 
 void StackManager::handle_start_up(ModuleList* modules, Thread* stack_thread, std::promise<void> promise) {
-  registry_.Start(modules, stack_thread);
+  auto start_time = std::chrono::steady_clock::now();
+  if (os::GetSystemPropertyBool(kPropertyParallelModuleStart, /* default_value = */ false)) {
+    registry_.StartInParallel(modules, stack_thread);
+  } else {
+    registry_.Start(modules, stack_thread);
+  }
+  log::info(
+      "Started {} modules in {} ms",
+      registry_.GetStartTimes().size(),
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time)
+          .count());
   promise.set_value();
 }
 
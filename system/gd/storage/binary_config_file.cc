@@ -0,0 +1,382 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/binary_config_file.h"
+
+#include <bluetooth/log.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "os/files.h"
+#include "os/log.h"
+#include "storage/device.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+// File layout, integers are little endian:
+//
+//   header:   magic[8] version:u32 snapshot_size:u32 snapshot_crc:u32 reserved:u32
+//   snapshot: record*, snapshot_size bytes
+//   journal:  record*
+//
+//   record:   payload_size:u32 payload_crc:u32 payload
+//   payload:  kSectionRecord string:section properties:u32 (string:property string:value)*
+//           | kRemoveSectionRecord string:section
+//   string:   size:u32 bytes
+constexpr char kMagic[8] = {'B', 'T', 'C', 'O', 'N', 'F', 'I', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + 4 * sizeof(uint32_t);
+// Journals smaller than this are not worth a new snapshot, even after a small one
+constexpr size_t kMinCompactedJournalSize = 16 * 1024;
+
+constexpr uint8_t kSectionRecord = 1;
+constexpr uint8_t kRemoveSectionRecord = 2;
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+  static const std::array<uint32_t, 256> kTable = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < table.size(); i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+      }
+      table[i] = crc;
+    }
+    return table;
+  }();
+
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; i++) {
+    crc = kTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+void AppendUint32(std::string& out, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+void AppendString(std::string& out, const std::string& value) {
+  AppendUint32(out, value.size());
+  out.append(value);
+}
+
+void AppendRecord(std::string& out, const std::string& payload) {
+  AppendUint32(out, payload.size());
+  AppendUint32(out, Crc32(reinterpret_cast<const uint8_t*>(payload.data()), payload.size()));
+  out.append(payload);
+}
+
+void AppendSectionRecord(
+    std::string& out, const std::string& section, const common::ListMap<std::string, std::string>& properties) {
+  std::string payload(1, static_cast<char>(kSectionRecord));
+  AppendString(payload, section);
+  AppendUint32(payload, properties.size());
+  for (const auto& property : properties) {
+    AppendString(payload, property.first);
+    AppendString(payload, property.second);
+  }
+  AppendRecord(out, payload);
+}
+
+void AppendRemoveSectionRecord(std::string& out, const std::string& section) {
+  std::string payload(1, static_cast<char>(kRemoveSectionRecord));
+  AppendString(payload, section);
+  AppendRecord(out, payload);
+}
+
+// Bounds checked reader over the mapped file
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  size_t remaining() const {
+    return size_ - pos_;
+  }
+
+  bool ReadUint32(uint32_t& value) {
+    if (remaining() < sizeof(uint32_t)) {
+      return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+      value |= static_cast<uint32_t>(data_[pos_++]) << (8 * i);
+    }
+    return true;
+  }
+
+  bool ReadBytes(size_t size, const uint8_t*& bytes) {
+    if (remaining() < size) {
+      return false;
+    }
+    bytes = data_ + pos_;
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadString(std::string_view& value) {
+    uint32_t size;
+    const uint8_t* bytes;
+    if (!ReadUint32(size) || !ReadBytes(size, bytes)) {
+      return false;
+    }
+    value = std::string_view(reinterpret_cast<const char*>(bytes), size);
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+// Read the next record from |reader|, return false if it is incomplete or corrupt
+bool ReadRecord(Reader& reader, Reader& payload) {
+  uint32_t payload_size, payload_crc;
+  const uint8_t* bytes;
+  if (!reader.ReadUint32(payload_size) || !reader.ReadUint32(payload_crc) || !reader.ReadBytes(payload_size, bytes)) {
+    return false;
+  }
+  if (Crc32(bytes, payload_size) != payload_crc) {
+    return false;
+  }
+  payload = Reader(bytes, payload_size);
+  return true;
+}
+
+// Replay the record |payload| into |cache|, return false if it is malformed
+bool ApplyRecord(Reader& payload, ConfigCache& cache) {
+  const uint8_t* type;
+  std::string_view section;
+  if (!payload.ReadBytes(1, type) || !payload.ReadString(section) || section.empty()) {
+    return false;
+  }
+
+  // Records hold the whole content of the section
+  cache.RemoveSection(std::string(section));
+  if (*type == kRemoveSectionRecord) {
+    return payload.remaining() == 0;
+  }
+  if (*type != kSectionRecord) {
+    return false;
+  }
+
+  uint32_t num_properties;
+  if (!payload.ReadUint32(num_properties)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < num_properties; i++) {
+    std::string_view property, value;
+    if (!payload.ReadString(property) || !payload.ReadString(value) || property.empty()) {
+      return false;
+    }
+    cache.SetProperty(std::string(section), std::string(property), std::string(value));
+  }
+  return payload.remaining() == 0;
+}
+
+}  // namespace
+
+BinaryConfigFile::BinaryConfigFile(std::string path) : path_(std::move(path)) {
+  log::assert_that(!path_.empty(), "assert failed: !path_.empty()");
+}
+
+std::optional<ConfigCache> BinaryConfigFile::Read(size_t temp_devices_capacity) {
+  snapshot_size_ = 0;
+  valid_size_ = 0;
+
+  int fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    log::error("unable to open file '{}', error: {}", path_, strerror(errno));
+    return std::nullopt;
+  }
+  struct stat file_stat {};
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < kHeaderSize) {
+    log::warn("config file '{}' is too short", path_);
+    close(fd);
+    return std::nullopt;
+  }
+  size_t file_size = file_stat.st_size;
+  void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    log::error("unable to map file '{}', error: {}", path_, strerror(errno));
+    return std::nullopt;
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(mapping);
+
+  std::optional<ConfigCache> cache;
+  Reader reader(data, file_size);
+  const uint8_t* magic;
+  uint32_t version, snapshot_size, snapshot_crc, reserved;
+  reader.ReadBytes(sizeof(kMagic), magic);
+  reader.ReadUint32(version);
+  reader.ReadUint32(snapshot_size);
+  reader.ReadUint32(snapshot_crc);
+  reader.ReadUint32(reserved);
+  if (memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kVersion) {
+    log::warn("config file '{}' has no valid header", path_);
+  } else if (snapshot_size > reader.remaining() || Crc32(data + kHeaderSize, snapshot_size) != snapshot_crc) {
+    log::warn("config file '{}' has a corrupt snapshot", path_);
+  } else {
+    cache.emplace(temp_devices_capacity, Device::kLinkKeyProperties);
+
+    Reader snapshot(data + kHeaderSize, snapshot_size);
+    Reader payload(nullptr, 0);
+    while (cache && snapshot.remaining() > 0) {
+      if (!ReadRecord(snapshot, payload) || !ApplyRecord(payload, *cache)) {
+        log::warn("config file '{}' has a malformed snapshot", path_);
+        cache.reset();
+      }
+    }
+
+    Reader journal(data + kHeaderSize + snapshot_size, file_size - kHeaderSize - snapshot_size);
+    size_t journal_size = 0;
+    while (cache && journal.remaining() > 0) {
+      if (!ReadRecord(journal, payload)) {
+        // Left by an interrupted append, the following records are overwritten by the next one
+        log::warn("Dropping {} bytes of incomplete journal in '{}'", journal.remaining(), path_);
+        break;
+      }
+      if (!ApplyRecord(payload, *cache)) {
+        log::warn("config file '{}' has a malformed journal record", path_);
+        cache.reset();
+        break;
+      }
+      journal_size = file_size - kHeaderSize - snapshot_size - journal.remaining();
+    }
+
+    if (cache) {
+      snapshot_size_ = snapshot_size;
+      valid_size_ = kHeaderSize + snapshot_size + journal_size;
+    }
+  }
+
+  munmap(mapping, file_size);
+  return cache;
+}
+
+bool BinaryConfigFile::Write(const ConfigCache& cache) {
+  std::string snapshot;
+  cache.ForEachSerializedSection(
+      [&snapshot](const std::string& section, const common::ListMap<std::string, std::string>& properties) {
+        AppendSectionRecord(snapshot, section, properties);
+      });
+
+  std::string file;
+  file.reserve(kHeaderSize + snapshot.size());
+  file.append(kMagic, sizeof(kMagic));
+  AppendUint32(file, kVersion);
+  AppendUint32(file, snapshot.size());
+  AppendUint32(file, Crc32(reinterpret_cast<const uint8_t*>(snapshot.data()), snapshot.size()));
+  AppendUint32(file, 0);
+  file.append(snapshot);
+
+  // Written to a new file which is then renamed over the current one
+  if (!os::WriteToFile(path_, file)) {
+    snapshot_size_ = 0;
+    valid_size_ = 0;
+    return false;
+  }
+  snapshot_size_ = snapshot.size();
+  valid_size_ = file.size();
+  return true;
+}
+
+bool BinaryConfigFile::Append(const ConfigCache& cache, const std::vector<std::string>& sections) {
+  if (valid_size_ == 0) {
+    return false;
+  }
+
+  std::string journal;
+  for (const auto& section : sections) {
+    bool serialized = cache.VisitSerializedSection(
+        section, [&journal](const std::string& section, const common::ListMap<std::string, std::string>& properties) {
+          AppendSectionRecord(journal, section, properties);
+        });
+    if (!serialized) {
+      AppendRemoveSectionRecord(journal, section);
+    }
+  }
+  if (journal.empty()) {
+    return true;
+  }
+
+  int fd = open(path_.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    log::error("unable to open file '{}', error: {}", path_, strerror(errno));
+    valid_size_ = 0;
+    return false;
+  }
+  // Overwrite what an interrupted append may have left after the last valid record
+  bool written = ftruncate(fd, valid_size_) == 0;
+  for (size_t offset = 0; written && offset < journal.size();) {
+    ssize_t size = pwrite(fd, journal.data() + offset, journal.size() - offset, valid_size_ + offset);
+    if (size < 0 && errno == EINTR) {
+      continue;
+    }
+    written = size > 0;
+    offset += written ? size : 0;
+  }
+  if (!written) {
+    log::error("unable to append to file '{}', error: {}", path_, strerror(errno));
+  } else if (fdatasync(fd) != 0) {
+    log::warn("unable to sync file '{}', error: {}", path_, strerror(errno));
+  }
+  close(fd);
+
+  if (!written) {
+    valid_size_ = 0;
+    return false;
+  }
+  valid_size_ += journal.size();
+  return true;
+}
+
+bool BinaryConfigFile::ShouldCompact() const {
+  if (valid_size_ == 0) {
+    return true;
+  }
+  size_t journal_size = valid_size_ - kHeaderSize - snapshot_size_;
+  return journal_size > std::max(snapshot_size_, kMinCompactedJournalSize);
+}
+
+bool BinaryConfigFile::Delete() {
+  snapshot_size_ = 0;
+  valid_size_ = 0;
+  if (!os::FileExists(path_)) {
+    log::warn("Config file at \"{}\" does not exist", path_);
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
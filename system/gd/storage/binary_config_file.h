@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/config_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Binary counterpart of LegacyConfigFile, faster to load and to update
+//
+// The file holds a snapshot of the sections written to disk, protected by a checksum, followed by a journal of
+// section records appended by the following saves, each with its own checksum. Loading maps the file and replays the
+// snapshot and then the journal, stopping at the first incomplete journal record left by an interrupted append.
+// Snapshots are written to a new file swapped in atomically, once the journal becomes larger than the snapshot it
+// follows.
+//
+// Unlike LegacyConfigFile, an instance keeps track of the file it read or wrote, to append to it.
+class BinaryConfigFile {
+ public:
+  explicit BinaryConfigFile(std::string path);
+
+  // Read the snapshot and journal, return std::nullopt if the file is missing or its snapshot is corrupt
+  std::optional<ConfigCache> Read(size_t temp_devices_capacity);
+  // Replace the file with a snapshot of |cache|
+  bool Write(const ConfigCache& cache);
+  // Append the current content of |sections| in |cache| to the journal, including their removal. Return false if
+  // there is no valid file to append to, in which case a snapshot should be written instead
+  bool Append(const ConfigCache& cache, const std::vector<std::string>& sections);
+  // Return true when the journal got larger than the snapshot and a new snapshot should be written instead
+  bool ShouldCompact() const;
+  bool Delete();
+  // Size of the file up to the last valid record, 0 when unknown
+  size_t Size() const {
+    return valid_size_;
+  }
+
+ private:
+  std::string path_;
+  // Size of the snapshot, and of the snapshot and journal up to the last valid record, 0 when unknown
+  size_t snapshot_size_ = 0;
+  size_t valid_size_ = 0;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
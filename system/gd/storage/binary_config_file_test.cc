@@ -0,0 +1,166 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/binary_config_file.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "storage/config_keys.h"
+#include "storage/device.h"
+
+namespace testing {
+
+using bluetooth::storage::BinaryConfigFile;
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::Device;
+
+class BinaryConfigFileTest : public Test {
+ protected:
+  void SetUp() override {
+    temp_config_ = std::filesystem::temp_directory_path() / "temp_config.bin";
+    std::filesystem::remove(temp_config_);
+
+    config_.SetProperty("Info", "TimeCreated", "2020-05-20 01:20:56");
+    config_.SetProperty("Adapter", "Address", "01:02:03:ab:cd:ef");
+    config_.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "hello world");
+    config_.SetProperty("CC:DD:EE:FF:00:11", "Name", "hello");
+    config_.SetProperty("CC:DD:EE:FF:00:11", BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE");
+    config_.TakeChangedPersistentSections();
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(temp_config_);
+  }
+
+  std::filesystem::path temp_config_;
+  ConfigCache config_{100, Device::kLinkKeyProperties};
+};
+
+TEST_F(BinaryConfigFileTest, write_and_read_loop_back_test) {
+  EXPECT_TRUE(BinaryConfigFile(temp_config_.string()).Write(config_));
+  auto config_read = BinaryConfigFile(temp_config_.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  // Unpaired devices do not exist in persistent config file
+  config_.RemoveSection("AA:BB:CC:DD:EE:FF");
+  EXPECT_EQ(config_, *config_read);
+  EXPECT_THAT(config_read->GetPersistentSections(), ElementsAre("CC:DD:EE:FF:00:11"));
+  EXPECT_THAT(config_read->GetProperty("Adapter", "Address"), Optional(StrEq("01:02:03:ab:cd:ef")));
+  EXPECT_THAT(config_read->GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("hello")));
+}
+
+TEST_F(BinaryConfigFileTest, append_changed_sections_test) {
+  BinaryConfigFile config_file(temp_config_.string());
+  EXPECT_TRUE(config_file.Write(config_));
+
+  config_.SetProperty("CC:DD:EE:FF:00:11", "Name", "hello again");
+  config_.SetProperty("11:22:33:44:55:66", BTIF_STORAGE_KEY_LINK_KEY, "CCDDEE");
+  auto changed = config_.TakeChangedPersistentSections();
+  ASSERT_TRUE(changed);
+  EXPECT_THAT(*changed, UnorderedElementsAre("CC:DD:EE:FF:00:11", "11:22:33:44:55:66"));
+  EXPECT_FALSE(config_file.ShouldCompact());
+  EXPECT_TRUE(config_file.Append(config_, *changed));
+
+  config_.RemoveSection("11:22:33:44:55:66");
+  changed = config_.TakeChangedPersistentSections();
+  ASSERT_TRUE(changed);
+  EXPECT_TRUE(config_file.Append(config_, *changed));
+
+  auto config_read = BinaryConfigFile(temp_config_.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  config_.RemoveSection("AA:BB:CC:DD:EE:FF");
+  EXPECT_EQ(config_, *config_read);
+  EXPECT_THAT(config_read->GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("hello again")));
+  EXPECT_FALSE(config_read->HasSection("11:22:33:44:55:66"));
+}
+
+TEST_F(BinaryConfigFileTest, append_requires_read_or_write_test) {
+  EXPECT_TRUE(BinaryConfigFile(temp_config_.string()).Write(config_));
+
+  BinaryConfigFile config_file(temp_config_.string());
+  EXPECT_TRUE(config_file.ShouldCompact());
+  EXPECT_FALSE(config_file.Append(config_, {"CC:DD:EE:FF:00:11"}));
+  ASSERT_TRUE(config_file.Read(100));
+  EXPECT_FALSE(config_file.ShouldCompact());
+  EXPECT_TRUE(config_file.Append(config_, {"CC:DD:EE:FF:00:11"}));
+}
+
+TEST_F(BinaryConfigFileTest, incomplete_journal_is_dropped_test) {
+  BinaryConfigFile config_file(temp_config_.string());
+  EXPECT_TRUE(config_file.Write(config_));
+  config_.SetProperty("CC:DD:EE:FF:00:11", "Name", "hello again");
+  EXPECT_TRUE(config_file.Append(config_, {"CC:DD:EE:FF:00:11"}));
+  auto complete_size = std::filesystem::file_size(temp_config_);
+
+  // Interrupted append
+  config_.SetProperty("CC:DD:EE:FF:00:11", "Name", "lost");
+  EXPECT_TRUE(config_file.Append(config_, {"CC:DD:EE:FF:00:11"}));
+  std::filesystem::resize_file(temp_config_, std::filesystem::file_size(temp_config_) - 2);
+
+  BinaryConfigFile config_file_read(temp_config_.string());
+  auto config_read = config_file_read.Read(100);
+  ASSERT_TRUE(config_read);
+  EXPECT_THAT(config_read->GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("hello again")));
+
+  // The next append replaces the incomplete record
+  config_read->SetProperty("CC:DD:EE:FF:00:11", "Name", "hello there");
+  EXPECT_TRUE(config_file_read.Append(*config_read, {"CC:DD:EE:FF:00:11"}));
+  EXPECT_GT(std::filesystem::file_size(temp_config_), complete_size);
+  config_read = BinaryConfigFile(temp_config_.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  EXPECT_THAT(config_read->GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("hello there")));
+}
+
+TEST_F(BinaryConfigFileTest, corrupt_snapshot_test) {
+  EXPECT_TRUE(BinaryConfigFile(temp_config_.string()).Write(config_));
+  {
+    std::fstream file(temp_config_, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\xff');
+  }
+  EXPECT_FALSE(BinaryConfigFile(temp_config_.string()).Read(100));
+}
+
+TEST_F(BinaryConfigFileTest, missing_file_test) {
+  BinaryConfigFile config_file(temp_config_.string());
+  EXPECT_FALSE(config_file.Read(100));
+  EXPECT_FALSE(config_file.Delete());
+  EXPECT_TRUE(config_file.Write(config_));
+  EXPECT_TRUE(config_file.Delete());
+  EXPECT_FALSE(std::filesystem::exists(temp_config_));
+}
+
+TEST_F(BinaryConfigFileTest, compact_large_journal_test) {
+  BinaryConfigFile config_file(temp_config_.string());
+  EXPECT_TRUE(config_file.Write(config_));
+  std::string name(1024, 'a');
+  for (int i = 0; i < 32 && !config_file.ShouldCompact(); i++) {
+    config_.SetProperty("CC:DD:EE:FF:00:11", "Name", name + std::to_string(i));
+    EXPECT_TRUE(config_file.Append(config_, {"CC:DD:EE:FF:00:11"}));
+  }
+  EXPECT_TRUE(config_file.ShouldCompact());
+
+  EXPECT_TRUE(config_file.Write(config_));
+  EXPECT_FALSE(config_file.ShouldCompact());
+  auto config_read = BinaryConfigFile(temp_config_.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  EXPECT_EQ(config_read->GetProperty("CC:DD:EE:FF:00:11", "Name"), config_.GetProperty("CC:DD:EE:FF:00:11", "Name"));
+}
+
+}  // namespace testing
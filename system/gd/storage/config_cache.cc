@@ -67,7 +67,7 @@ ConfigCache::ConfigCache(size_t temp_device_capacity, std::unordered_set<std::st
       temporary_devices_(temp_device_capacity) {}
 
 void ConfigCache::SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   persistent_config_changed_callback_ = std::move(persistent_config_changed_callback);
 }
 
@@ -76,7 +76,10 @@ ConfigCache::ConfigCache(ConfigCache&& other) noexcept
       persistent_property_names_(std::move(other.persistent_property_names_)),
       information_sections_(std::move(other.information_sections_)),
       persistent_devices_(std::move(other.persistent_devices_)),
-      temporary_devices_(std::move(other.temporary_devices_)) {
+      temporary_devices_(std::move(other.temporary_devices_)),
+      changed_persistent_sections_(std::move(other.changed_persistent_sections_)),
+      all_persistent_sections_changed_(other.all_persistent_sections_changed_),
+      parsed_values_(std::move(other.parsed_values_)) {
   log::assert_that(
       other.persistent_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
@@ -86,8 +89,7 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   if (&other == this) {
     return *this;
   }
-  std::lock_guard<std::recursive_mutex> my_lock(mutex_);
-  std::lock_guard<std::recursive_mutex> others_lock(other.mutex_);
+  std::scoped_lock lock(mutex_, other.mutex_);
   log::assert_that(
       other.persistent_config_changed_callback_ == nullptr,
       "Can't assign after setting the callback");
@@ -96,12 +98,18 @@ ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
   temporary_devices_ = std::move(other.temporary_devices_);
+  changed_persistent_sections_ = std::move(other.changed_persistent_sections_);
+  all_persistent_sections_changed_ = other.all_persistent_sections_changed_;
+  parsed_values_ = std::move(other.parsed_values_);
   return *this;
 }
 
 bool ConfigCache::operator==(const ConfigCache& rhs) const {
-  std::lock_guard<std::recursive_mutex> my_lock(mutex_);
-  std::lock_guard<std::recursive_mutex> others_lock(rhs.mutex_);
+  if (&rhs == this) {
+    return true;
+  }
+  std::shared_lock<std::shared_mutex> my_lock(mutex_);
+  std::shared_lock<std::shared_mutex> others_lock(rhs.mutex_);
   return persistent_property_names_ == rhs.persistent_property_names_ &&
          information_sections_ == rhs.information_sections_ && persistent_devices_ == rhs.persistent_devices_ &&
          temporary_devices_ == rhs.temporary_devices_;
@@ -112,14 +120,15 @@ bool ConfigCache::operator!=(const ConfigCache& rhs) const {
 }
 
 void ConfigCache::Clear() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  parsed_values_.clear();
   if (information_sections_.size() > 0) {
     information_sections_.clear();
-    PersistentConfigChangedCallback();
+    AllPersistentSectionsChanged();
   }
   if (persistent_devices_.size() > 0) {
     persistent_devices_.clear();
-    PersistentConfigChangedCallback();
+    AllPersistentSectionsChanged();
   }
   if (temporary_devices_.size() > 0) {
     temporary_devices_.clear();
@@ -127,13 +136,21 @@ void ConfigCache::Clear() {
 }
 
 bool ConfigCache::HasSection(const std::string& section) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> shared_lock(mutex_, std::defer_lock);
+  std::unique_lock<std::shared_mutex> unique_lock(mutex_, std::defer_lock);
+  LockForSection(section, shared_lock, unique_lock);
+  return HasSectionLocked(section);
+}
+
+bool ConfigCache::HasSectionLocked(const std::string& section) const {
   return information_sections_.contains(section) || persistent_devices_.contains(section) ||
          temporary_devices_.contains(section);
 }
 
 bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> shared_lock(mutex_, std::defer_lock);
+  std::unique_lock<std::shared_mutex> unique_lock(mutex_, std::defer_lock);
+  LockForSection(section, shared_lock, unique_lock);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     return section_iter->second.find(property) != section_iter->second.end();
@@ -150,7 +167,15 @@ bool ConfigCache::HasProperty(const std::string& section, const std::string& pro
 }
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> shared_lock(mutex_, std::defer_lock);
+  std::unique_lock<std::shared_mutex> unique_lock(mutex_, std::defer_lock);
+  LockForSection(section, shared_lock, unique_lock);
+  bool from_keystore = false;
+  return GetPropertyLocked(section, property, &from_keystore);
+}
+
+std::optional<std::string> ConfigCache::GetPropertyLocked(
+    const std::string& section, const std::string& property, bool* from_keystore) const {
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto property_iter = section_iter->second.find(property);
@@ -164,6 +189,7 @@ std::optional<std::string> ConfigCache::GetProperty(const std::string& section,
     if (property_iter != section_iter->second.end()) {
       std::string value = property_iter->second;
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && value == kEncryptedStr) {
+        *from_keystore = true;
         return os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + property);
       }
       return value;
@@ -180,19 +206,24 @@ std::optional<std::string> ConfigCache::GetProperty(const std::string& section,
 }
 
 void ConfigCache::SetProperty(std::string section, std::string property, std::string value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  SetPropertyLocked(std::move(section), std::move(property), std::move(value));
+}
+
+void ConfigCache::SetPropertyLocked(std::string section, std::string property, std::string value) {
   TrimAfterNewLine(section);
   TrimAfterNewLine(property);
   TrimAfterNewLine(value);
   log::assert_that(!section.empty(), "Empty section name not allowed");
   log::assert_that(!property.empty(), "Empty property name not allowed");
+  parsed_values_.erase(section);
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
       section_iter = information_sections_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
     }
     section_iter->second.insert_or_assign(property, std::move(value));
-    PersistentConfigChangedCallback();
+    PersistentSectionChanged(section);
     return;
   }
   auto section_iter = persistent_devices_.find(section);
@@ -215,22 +246,30 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
       }
     }
     section_iter->second.insert_or_assign(property, std::move(value));
-    PersistentConfigChangedCallback();
+    PersistentSectionChanged(section);
     return;
   }
   section_iter = temporary_devices_.find(section);
   if (section_iter == temporary_devices_.end()) {
     auto triple = temporary_devices_.try_emplace(section, common::ListMap<std::string, std::string>{});
     section_iter = std::get<0>(triple);
+    if (std::get<2>(triple)) {
+      parsed_values_.erase(std::get<2>(triple)->first);
+    }
   }
   section_iter->second.insert_or_assign(property, std::move(value));
 }
 
 bool ConfigCache::RemoveSection(const std::string& section) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return RemoveSectionLocked(section);
+}
+
+bool ConfigCache::RemoveSectionLocked(const std::string& section) {
+  parsed_values_.erase(section);
   // sections are unique among all three maps, hence removing from one of them is enough
   if (information_sections_.extract(section) || persistent_devices_.extract(section)) {
-    PersistentConfigChangedCallback();
+    PersistentSectionChanged(section);
     return true;
   } else {
     return temporary_devices_.extract(section).has_value();
@@ -238,7 +277,12 @@ bool ConfigCache::RemoveSection(const std::string& section) {
 }
 
 bool ConfigCache::RemoveProperty(const std::string& section, const std::string& property) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return RemovePropertyLocked(section, property);
+}
+
+bool ConfigCache::RemovePropertyLocked(const std::string& section, const std::string& property) {
+  parsed_values_.erase(section);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto value = section_iter->second.extract(property);
@@ -247,7 +291,7 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       information_sections_.erase(section_iter);
     }
     if (value.has_value()) {
-      PersistentConfigChangedCallback();
+      PersistentSectionChanged(section);
       return true;
     } else {
       return false;
@@ -262,10 +306,13 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
     } else if (value && IsPersistentProperty(property)) {
       // move unpaired device
       auto section_properties = persistent_devices_.extract(section);
-      temporary_devices_.insert_or_assign(section, std::move(section_properties->second));
+      auto evicted = temporary_devices_.insert_or_assign(section, std::move(section_properties->second));
+      if (evicted) {
+        parsed_values_.erase(evicted->first);
+      }
     }
     if (value.has_value()) {
-      PersistentConfigChangedCallback();
+      PersistentSectionChanged(section);
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && os::ParameterProvider::IsCommonCriteriaMode() &&
           InEncryptKeyNameList(property)) {
         os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(section + "-" + property, "");
@@ -287,9 +334,12 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
 }
 
 void ConfigCache::ConvertEncryptOrDecryptKeyIfNeeded() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   log::info("");
-  auto persistent_sections = GetPersistentSections();
+  std::vector<std::string> persistent_sections;
+  for (const auto& elem : persistent_devices_) {
+    persistent_sections.emplace_back(elem.first);
+  }
   for (const auto& section : persistent_sections) {
     auto section_iter = persistent_devices_.find(section);
     for (const auto& property : kEncryptKeyNameList) {
@@ -300,14 +350,14 @@ void ConfigCache::ConvertEncryptOrDecryptKeyIfNeeded() {
             os::ParameterProvider::IsCommonCriteriaMode() && !is_encrypted) {
           if (os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
                   section + "-" + std::string(property), property_iter->second)) {
-            SetProperty(section, std::string(property), kEncryptedStr);
+            SetPropertyLocked(section, std::string(property), kEncryptedStr);
           }
         }
         if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && is_encrypted) {
           std::string value_str =
               os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + std::string(property));
           if (!os::ParameterProvider::IsCommonCriteriaMode()) {
-            SetProperty(section, std::string(property), value_str);
+            SetPropertyLocked(section, std::string(property), value_str);
           }
         }
       }
@@ -324,14 +374,15 @@ bool ConfigCache::IsPersistentProperty(const std::string& property) const {
 }
 
 void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  size_t num_persistent_removed = 0;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  parsed_values_.clear();
+  std::vector<std::string> persistent_removed;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto it = config_section->begin(); it != config_section->end();) {
       if (it->second.contains(property)) {
         log::info("Removing persistent section {} with property {}", it->first, property);
+        persistent_removed.push_back(it->first);
         it = config_section->erase(it);
-        num_persistent_removed++;
         continue;
       }
       it++;
@@ -345,13 +396,13 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
     }
     it++;
   }
-  if (num_persistent_removed > 0) {
-    PersistentConfigChangedCallback();
+  for (const auto& section : persistent_removed) {
+    PersistentSectionChanged(section);
   }
 }
 
 std::vector<std::string> ConfigCache::GetPersistentSections() const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   std::vector<std::string> paired_devices;
   paired_devices.reserve(persistent_devices_.size());
   for (const auto& elem : persistent_devices_) {
@@ -360,20 +411,40 @@ std::vector<std::string> ConfigCache::GetPersistentSections() const {
   return paired_devices;
 }
 
+std::vector<std::pair<std::string, ConfigCache::PropertyList>>
+ConfigCache::GetPersistentSectionProperties() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto keystore = os::ParameterProvider::GetBtKeystoreInterface();
+  std::vector<std::pair<std::string, PropertyList>> paired_devices;
+  paired_devices.reserve(persistent_devices_.size());
+  for (const auto& [section, properties] : persistent_devices_) {
+    auto& device_properties = paired_devices.emplace_back(section, PropertyList{}).second;
+    device_properties.reserve(properties.size());
+    for (const auto& [property, value] : properties) {
+      if (keystore != nullptr && value == kEncryptedStr) {
+        device_properties.emplace_back(property, keystore->get_key(section + "-" + property));
+      } else {
+        device_properties.emplace_back(property, value);
+      }
+    }
+  }
+  return paired_devices;
+}
+
 void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   while (!mutation_entries.empty()) {
     auto entry = std::move(mutation_entries.front());
     mutation_entries.pop();
     switch (entry.entry_type) {
       case MutationEntry::EntryType::SET:
-        SetProperty(std::move(entry.section), std::move(entry.property), std::move(entry.value));
+        SetPropertyLocked(std::move(entry.section), std::move(entry.property), std::move(entry.value));
         break;
       case MutationEntry::EntryType::REMOVE_PROPERTY:
-        RemoveProperty(entry.section, entry.property);
+        RemovePropertyLocked(entry.section, entry.property);
         break;
       case MutationEntry::EntryType::REMOVE_SECTION:
-        RemoveSection(entry.section);
+        RemoveSectionLocked(entry.section);
         break;
         // do not write a default case so that when a new enum is defined, compilation would fail automatically
     }
@@ -381,7 +452,7 @@ void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
 }
 
 std::string ConfigCache::SerializeToLegacyFormat() const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   std::stringstream serialized;
   for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (const auto& section : *config_section) {
@@ -395,9 +466,67 @@ std::string ConfigCache::SerializeToLegacyFormat() const {
   return serialized.str();
 }
 
+void ConfigCache::ForEachSerializedSection(const SectionVisitor& visitor) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
+    for (const auto& section : *config_section) {
+      visitor(section.first, section.second);
+    }
+  }
+}
+
+bool ConfigCache::VisitSerializedSection(const std::string& section, const SectionVisitor& visitor) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
+    auto section_iter = config_section->find(section);
+    if (section_iter != config_section->end()) {
+      visitor(section_iter->first, section_iter->second);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<std::vector<std::string>> ConfigCache::TakeChangedPersistentSections() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::optional<std::vector<std::string>> changed;
+  if (!all_persistent_sections_changed_) {
+    changed.emplace(changed_persistent_sections_.begin(), changed_persistent_sections_.end());
+  }
+  changed_persistent_sections_.clear();
+  all_persistent_sections_changed_ = false;
+  return changed;
+}
+
+void ConfigCache::LockForSection(
+    const std::string& section,
+    std::shared_lock<std::shared_mutex>& shared_lock,
+    std::unique_lock<std::shared_mutex>& unique_lock) const {
+  shared_lock.lock();
+  if (information_sections_.contains(section) || persistent_devices_.contains(section)) {
+    return;
+  }
+  // The section may be a temporary device, that the lookup warms up
+  shared_lock.unlock();
+  unique_lock.lock();
+}
+
+void ConfigCache::PersistentSectionChanged(const std::string& section) {
+  if (!all_persistent_sections_changed_) {
+    changed_persistent_sections_.insert(section);
+  }
+  PersistentConfigChangedCallback();
+}
+
+void ConfigCache::AllPersistentSectionsChanged() {
+  all_persistent_sections_changed_ = true;
+  changed_persistent_sections_.clear();
+  PersistentConfigChangedCallback();
+}
+
 std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWithProperty(
     const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   std::vector<SectionAndPropertyValue> result;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (const auto& elem : *config_section) {
@@ -419,7 +548,9 @@ std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWi
 }
 
 std::vector<std::string> ConfigCache::GetPropertyNames(const std::string& section) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> shared_lock(mutex_, std::defer_lock);
+  std::unique_lock<std::shared_mutex> unique_lock(mutex_, std::defer_lock);
+  LockForSection(section, shared_lock, unique_lock);
 
   std::vector<std::string> property_names;
   auto ProcessSections = [&](const auto& sections) {
@@ -496,7 +627,8 @@ bool FixDeviceTypeInconsistencyInSection(
 }  // namespace
 
 bool ConfigCache::FixDeviceTypeInconsistencies() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  parsed_values_.clear();
   bool persistent_device_changed = false;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto& elem : *config_section) {
@@ -512,14 +644,16 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
     }
   }
   if (persistent_device_changed) {
-    PersistentConfigChangedCallback();
+    AllPersistentSectionsChanged();
   }
   return persistent_device_changed || temp_device_changed;
 }
 
 bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
     const std::string& section, const std::unordered_set<std::string_view>& property_names) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> shared_lock(mutex_, std::defer_lock);
+  std::unique_lock<std::shared_mutex> unique_lock(mutex_, std::defer_lock);
+  LockForSection(section, shared_lock, unique_lock);
   const common::ListMap<std::string, std::string>* section_ptr;
   if (!IsDeviceSection(section)) {
     auto section_iter = information_sections_.find(section);
@@ -546,7 +680,7 @@ bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
 }
 
 bool ConfigCache::IsPersistentSection(const std::string& section) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return persistent_devices_.contains(section);
 }
 
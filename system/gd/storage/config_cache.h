@@ -15,13 +15,16 @@
  */
 #pragma once
 
+#include <any>
 #include <functional>
 #include <list>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -48,7 +51,9 @@ class Mutation;
 // The definition of persistent sections is up to the user and is defined through the |persistent_property_names|
 // argument. When these properties are link key properties, then persistent sections is equal to bonded devices
 //
-// This class is thread safe
+// This class is thread safe. Readers of the information sections and persistent devices share the lock, while
+// writers and readers of temporary devices, which are warmed up in their LRU, hold it exclusively. The persistent
+// config changed callback is called with the lock held and must not call back into the config cache.
 class ConfigCache {
  public:
   ConfigCache(size_t temp_device_capacity, std::unordered_set<std::string_view> persistent_property_names);
@@ -73,8 +78,20 @@ class ConfigCache {
   virtual bool HasProperty(const std::string& section, const std::string& property) const;
   // Get property, return std::nullopt if section or property does not exist
   virtual std::optional<std::string> GetProperty(const std::string& section, const std::string& property) const;
+  // Get property converted by |parse|, return std::nullopt if section or property does not exist or can't be parsed.
+  // The result is cached until |section| is modified or evicted, so that reading it again does not parse the string
+  // value. Values stored in the keystore are not cached.
+  template <typename T>
+  std::optional<T> GetParsedProperty(
+      const std::string& section,
+      const std::string& property,
+      std::optional<T> (*parse)(const std::string& value)) const;
   // Returns a copy of persistent device MAC addresses
   virtual std::vector<std::string> GetPersistentSections() const;
+  // Returns a copy of persistent device sections and their properties, read in a single pass,
+  // with the encrypted values resolved as in GetProperty()
+  using PropertyList = std::vector<std::pair<std::string, std::string>>;
+  virtual std::vector<std::pair<std::string, PropertyList>> GetPersistentSectionProperties() const;
   // Return true if a section is persistent
   virtual bool IsPersistentSection(const std::string& section) const;
   // Return true if a section has one of the properties in |property_names|
@@ -84,6 +101,16 @@ class ConfigCache {
   virtual bool IsPersistentProperty(const std::string& property) const;
   // Serialize to legacy config format
   virtual std::string SerializeToLegacyFormat() const;
+  // Visit the sections written to disk and their properties, as serialized, in the order of
+  // SerializeToLegacyFormat()
+  using SectionVisitor =
+      std::function<void(const std::string& section, const common::ListMap<std::string, std::string>& properties)>;
+  virtual void ForEachSerializedSection(const SectionVisitor& visitor) const;
+  // Visit |section| as serialized, return false if |section| is not written to disk
+  virtual bool VisitSerializedSection(const std::string& section, const SectionVisitor& visitor) const;
+  // Returns the sections whose persistent content changed since the last call, or std::nullopt when the
+  // whole persistent config changed
+  virtual std::optional<std::vector<std::string>> TakeChangedPersistentSections();
   // Return a copy of pair<section_name, property_value> with property
   struct SectionAndPropertyValue {
     std::string section;
@@ -127,7 +154,7 @@ class ConfigCache {
   static const std::string kDefaultSectionName;
 
  private:
-  mutable std::recursive_mutex mutex_;
+  mutable std::shared_mutex mutex_;
   // A callback to notify interested party that a persistent config change has just happened, empty by default
   std::function<void()> persistent_config_changed_callback_;
   // A set of property names that if set would make a section persistent and if non of these properties are set, a
@@ -141,13 +168,71 @@ class ConfigCache {
   // if capacity exceeds given value during initialization
   common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
 
+  // Persistent sections changed since the last TakeChangedPersistentSections(), unless all of them did
+  std::unordered_set<std::string> changed_persistent_sections_;
+  bool all_persistent_sections_changed_ = false;
+
+  // Properties converted by GetParsedProperty(), per section and property, each a std::optional of the converted
+  // type. Modifiers hold |mutex_| exclusively and may access it directly, readers sharing |mutex_| must also hold
+  // |parsed_values_mutex_|.
+  mutable std::mutex parsed_values_mutex_;
+  mutable std::unordered_map<std::string, std::unordered_map<std::string, std::any>> parsed_values_;
+
   // Convenience method to check if the callback is valid before calling it
   inline void PersistentConfigChangedCallback() const {
     if (persistent_config_changed_callback_) {
       persistent_config_changed_callback_();
     }
   }
+  // Record a change of the persistent |section|, or of all of them, and notify it
+  void PersistentSectionChanged(const std::string& section);
+  void AllPersistentSectionsChanged();
+
+  // Lock |mutex_| to read |section|, shared unless |section| may be a temporary device
+  void LockForSection(
+      const std::string& section,
+      std::shared_lock<std::shared_mutex>& shared_lock,
+      std::unique_lock<std::shared_mutex>& unique_lock) const;
+  // Observers, called with |mutex_| held. |from_keystore| is set when the value is stored in the keystore
+  bool HasSectionLocked(const std::string& section) const;
+  std::optional<std::string> GetPropertyLocked(
+      const std::string& section, const std::string& property, bool* from_keystore) const;
+  // Modifiers, called with |mutex_| held
+  void SetPropertyLocked(std::string section, std::string property, std::string value);
+  bool RemoveSectionLocked(const std::string& section);
+  bool RemovePropertyLocked(const std::string& section, const std::string& property);
 };
 
+template <typename T>
+std::optional<T> ConfigCache::GetParsedProperty(
+    const std::string& section,
+    const std::string& property,
+    std::optional<T> (*parse)(const std::string& value)) const {
+  std::shared_lock<std::shared_mutex> shared_lock(mutex_, std::defer_lock);
+  std::unique_lock<std::shared_mutex> unique_lock(mutex_, std::defer_lock);
+  LockForSection(section, shared_lock, unique_lock);
+  std::lock_guard<std::mutex> parsed_values_lock(parsed_values_mutex_);
+  auto section_iter = parsed_values_.find(section);
+  if (section_iter != parsed_values_.end()) {
+    auto property_iter = section_iter->second.find(property);
+    if (property_iter != section_iter->second.end()) {
+      if (const auto* value = std::any_cast<std::optional<T>>(&property_iter->second)) {
+        return *value;
+      }
+    }
+  }
+  bool from_keystore = false;
+  auto value_str = GetPropertyLocked(section, property, &from_keystore);
+  std::optional<T> value;
+  if (value_str) {
+    value = parse(*value_str);
+  }
+  // Don't keep entries for sections that don't exist, a missing property is cached until it is set
+  if (!from_keystore && (value_str || HasSectionLocked(section))) {
+    parsed_values_[section].insert_or_assign(property, value);
+  }
+  return value;
+}
+
 }  // namespace storage
 }  // namespace bluetooth
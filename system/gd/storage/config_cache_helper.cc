@@ -59,10 +59,6 @@ void ConfigCacheHelper::SetUint32(const std::string& section, const std::string&
 }
 
 std::optional<uint32_t> ConfigCacheHelper::GetUint32(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
   auto large_value = GetUint64(section, property);
   if (!large_value) {
     return std::nullopt;
@@ -90,10 +86,6 @@ void ConfigCacheHelper::SetInt(const std::string& section, const std::string& pr
 }
 
 std::optional<int> ConfigCacheHelper::GetInt(const std::string& section, const std::string& property) const {
-  auto value_str = config_cache_.GetProperty(section, property);
-  if (!value_str) {
-    return std::nullopt;
-  }
   auto large_value = GetInt64(section, property);
   if (!large_value) {
     return std::nullopt;
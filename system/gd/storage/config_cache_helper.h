@@ -35,6 +35,7 @@ namespace storage {
 //
 // - all SetX methods accept value as copy and std::move() in encouraged
 // - all GetX methods return std::optional<X> and std::nullopt if not exist. std::optional<> can be treated as bool
+// - GetCached<X> returns the same as Get<X>, but keeps the converted value in the config cache for the next reads
 class ConfigCacheHelper {
  public:
   static ConfigCacheHelper FromConfigCache(ConfigCache& config_cache) {
@@ -84,6 +85,11 @@ class ConfigCacheHelper {
     return config_cache_.GetProperty(section, property);
   }
 
+  template <typename T>
+  std::optional<T> GetCached(const std::string& section, const std::string& property) {
+    return config_cache_.GetParsedProperty<T>(section, property, &Parse<T>);
+  }
+
   template <typename T, typename std::enable_if<std::is_same_v<T, std::vector<uint8_t>>, int>::type = 0>
   std::optional<T> Get(const std::string& section, const std::string& property) {
     return GetBin(section, property);
@@ -100,7 +106,7 @@ class ConfigCacheHelper {
     if (!value) {
       return std::nullopt;
     }
-    return T::FromLegacyConfigString(*value);
+    return Parse<T>(*value);
   }
 
   template <typename T, typename std::enable_if<std::is_enum_v<T>, int>::type = 0>
@@ -109,7 +115,7 @@ class ConfigCacheHelper {
     if (!value) {
       return std::nullopt;
     }
-    return bluetooth::FromLegacyConfigString<T>(*value);
+    return Parse<T>(*value);
   }
 
   template <
@@ -123,7 +129,51 @@ class ConfigCacheHelper {
     if (!value) {
       return std::nullopt;
     }
-    auto values = common::StringSplit(*value, " ");
+    return Parse<T>(*value);
+  }
+
+  // Convert the string |value| of a property, as Get<T>() does
+  template <typename T, typename std::enable_if<std::is_signed_v<T> && std::is_integral_v<T>, int>::type = 0>
+  static std::optional<T> Parse(const std::string& value) {
+    auto large_value = common::Int64FromString(value);
+    if (!large_value || !common::IsNumberInNumericLimits<T>(*large_value)) {
+      return std::nullopt;
+    }
+    return static_cast<T>(*large_value);
+  }
+
+  template <typename T, typename std::enable_if<std::is_unsigned_v<T> && std::is_integral_v<T>, int>::type = 0>
+  static std::optional<T> Parse(const std::string& value) {
+    auto large_value = common::Uint64FromString(value);
+    if (!large_value || !common::IsNumberInNumericLimits<T>(*large_value)) {
+      return std::nullopt;
+    }
+    return static_cast<T>(*large_value);
+  }
+
+  template <typename T, typename std::enable_if<std::is_same_v<T, std::string>, int>::type = 0>
+  static std::optional<T> Parse(const std::string& value) {
+    return value;
+  }
+
+  template <typename T, typename std::enable_if<std::is_base_of_v<Serializable<T>, T>, int>::type = 0>
+  static std::optional<T> Parse(const std::string& value) {
+    return T::FromLegacyConfigString(value);
+  }
+
+  template <typename T, typename std::enable_if<std::is_enum_v<T>, int>::type = 0>
+  static std::optional<T> Parse(const std::string& value) {
+    return bluetooth::FromLegacyConfigString<T>(value);
+  }
+
+  template <
+      typename T,
+      typename std::enable_if<
+          bluetooth::common::is_specialization_of<T, std::vector>::value &&
+              std::is_base_of_v<Serializable<typename T::value_type>, typename T::value_type>,
+          int>::type = 0>
+  static std::optional<T> Parse(const std::string& value) {
+    auto values = common::StringSplit(value, " ");
     T result;
     result.reserve(values.size());
     for (const auto& str : values) {
@@ -20,6 +20,8 @@
 #include <gtest/gtest.h>
 
 #include <cstdio>
+#include <thread>
+#include <vector>
 
 #include "hci/enum_helper.h"
 #include "storage/config_keys.h"
@@ -34,6 +36,12 @@ std::string GetTestAddress(int i) {
   std::snprintf(res.data(), res.capacity(), "AA:BB:CC:DD:EE:%02d", i);
   return res;
 }
+
+int num_parsed = 0;
+std::optional<int> ParseCountedInt(const std::string& value) {
+  num_parsed++;
+  return std::stoi(value);
+}
 }  // namespace
 
 using bluetooth::storage::ConfigCache;
@@ -218,6 +226,20 @@ TEST(ConfigCacheTest, get_persistent_devices_test) {
   ASSERT_THAT(config.GetPersistentSections(), ElementsAre("AA:BB:CC:DD:EE:FF"));
 }
 
+TEST(ConfigCacheTest, get_persistent_section_properties_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE");
+  config.SetProperty("CC:DD:EE:FF:00:11", "C", "D");
+  using Properties = ConfigCache::PropertyList;
+  ASSERT_THAT(
+      config.GetPersistentSectionProperties(),
+      ElementsAre(Pair(
+          "CC:DD:EE:FF:00:11",
+          Properties{{BTIF_STORAGE_KEY_LINK_KEY, "AABBAABBCCDDEE"}, {"C", "D"}})));
+}
+
 TEST(ConfigCacheTest, appoaching_temporary_config_limit_test) {
   ConfigCache config(2, Device::kLinkKeyProperties);
   for (int i = 0; i < 10; ++i) {
@@ -454,4 +476,71 @@ TEST(ConfigCacheTest, test_get_section_property_names) {
   ASSERT_THAT(config.GetPropertyNames("D"), ElementsAre());
 }
 
+TEST(ConfigCacheTest, concurrent_reads_and_writes_test) {
+  ConfigCache config(4, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty(GetTestAddress(0), BTIF_STORAGE_KEY_LINK_KEY, "Key");
+
+  // Readers of persistent sections share the lock with each other, those of temporary devices do not
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&config, i] {
+      for (int j = 0; j < 1000; ++j) {
+        ASSERT_THAT(config.GetProperty("A", "B"), Optional(StrEq("C")));
+        ASSERT_TRUE(config.HasProperty(GetTestAddress(0), BTIF_STORAGE_KEY_LINK_KEY));
+        config.HasSection(GetTestAddress(i + 1));
+        config.GetPropertyNames(GetTestAddress(i + 1));
+      }
+    });
+  }
+  threads.emplace_back([&config] {
+    for (int j = 0; j < 1000; ++j) {
+      config.SetProperty(GetTestAddress(j % 8 + 1), BTIF_STORAGE_KEY_NAME, std::to_string(j));
+      config.SetProperty(GetTestAddress(0), BTIF_STORAGE_KEY_NAME, std::to_string(j));
+    }
+  });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_THAT(config.GetProperty(GetTestAddress(0), BTIF_STORAGE_KEY_NAME), Optional(StrEq("999")));
+  ASSERT_THAT(config.GetPersistentSections(), ElementsAre(GetTestAddress(0)));
+}
+
+
+TEST(ConfigCacheTest, parsed_property_cached_until_changed_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty(GetTestAddress(0), "Property", "1");
+  num_parsed = 0;
+
+  ASSERT_THAT(config.GetParsedProperty<int>(GetTestAddress(0), "Property", &ParseCountedInt), Optional(1));
+  ASSERT_THAT(config.GetParsedProperty<int>(GetTestAddress(0), "Property", &ParseCountedInt), Optional(1));
+  ASSERT_EQ(num_parsed, 1);
+
+  config.SetProperty(GetTestAddress(0), "Property", "2");
+  ASSERT_THAT(config.GetParsedProperty<int>(GetTestAddress(0), "Property", &ParseCountedInt), Optional(2));
+  ASSERT_EQ(num_parsed, 2);
+
+  // A missing property is cached as well, until it is set
+  ASSERT_EQ(config.GetParsedProperty<int>(GetTestAddress(0), "Other", &ParseCountedInt), std::nullopt);
+  config.SetProperty(GetTestAddress(0), "Other", "3");
+  ASSERT_THAT(config.GetParsedProperty<int>(GetTestAddress(0), "Other", &ParseCountedInt), Optional(3));
+
+  config.RemoveProperty(GetTestAddress(0), "Property");
+  ASSERT_EQ(config.GetParsedProperty<int>(GetTestAddress(0), "Property", &ParseCountedInt), std::nullopt);
+  config.RemoveSection(GetTestAddress(0));
+  ASSERT_EQ(config.GetParsedProperty<int>(GetTestAddress(0), "Other", &ParseCountedInt), std::nullopt);
+}
+
+TEST(ConfigCacheTest, parsed_property_of_evicted_device_test) {
+  ConfigCache config(2, Device::kLinkKeyProperties);
+  config.SetProperty(GetTestAddress(0), "Property", "1");
+  ASSERT_THAT(config.GetParsedProperty<int>(GetTestAddress(0), "Property", &ParseCountedInt), Optional(1));
+
+  config.SetProperty(GetTestAddress(1), "Property", "2");
+  config.SetProperty(GetTestAddress(2), "Property", "3");
+  ASSERT_FALSE(config.HasSection(GetTestAddress(0)));
+  ASSERT_EQ(config.GetParsedProperty<int>(GetTestAddress(0), "Property", &ParseCountedInt), std::nullopt);
+}
+
 }  // namespace testing
@@ -25,6 +25,7 @@
 #define BTIF_STORAGE_KEY_ALIAS "Aliase"
 #define BTIF_STORAGE_KEY_APPEARANCE "Appearance"
 #define BTIF_STORAGE_KEY_AV_REM_CTRL_FEATURES "AvrcpPeerFeatures"
+#define BTIF_STORAGE_KEY_AVDTP_SEP_CACHE "AvdtpSepCache"
 #define BTIF_STORAGE_KEY_AVDTP_VERSION "AvdtpVersion"
 #define BTIF_STORAGE_KEY_AVRCP_CONTROLLER_VERSION "AvrcpControllerVersion"
 #define BTIF_STORAGE_KEY_CLOCK_OFFSET "ClockOffset"
@@ -76,6 +77,7 @@
 #define BTIF_STORAGE_KEY_HOGP_SUB_CLASS "HogpSubClass"
 #define BTIF_STORAGE_KEY_HOGP_VENDOR_ID "HogpVendorId"
 #define BTIF_STORAGE_KEY_HOGP_VERSION "HogpVersion"
+#define BTIF_STORAGE_KEY_LE_CONN_PARAMS "LeConnParams"
 #define BTIF_STORAGE_KEY_LE_KEY_LCSRK "LE_KEY_LCSRK"
 #define BTIF_STORAGE_KEY_LE_KEY_LENC "LE_KEY_LENC"
 #define BTIF_STORAGE_KEY_LE_KEY_LID "LE_KEY_LID"
@@ -115,6 +117,7 @@
 #define BTIF_STORAGE_KEY_REMOTE_VER_VER "LmpVer"
 #define BTIF_STORAGE_KEY_RESTRICTED "Restricted"
 #define BTIF_STORAGE_KEY_SCANMODE "ScanMode"
+#define BTIF_STORAGE_KEY_SDP_CACHE "SdpCache"
 #define BTIF_STORAGE_KEY_SDP_DI_HW_VERSION "SdpDiHardwareVersion"
 #define BTIF_STORAGE_KEY_SDP_DI_MANUFACTURER "SdpDiManufacturer"
 #define BTIF_STORAGE_KEY_SDP_DI_MODEL "SdpDiModel"
@@ -48,7 +48,7 @@ static_assert(false, "GENERATE_PROPERTY_GETTER_SETTER_REMOVER() must be uniquely
 #define GENERATE_PROPERTY_GETTER_SETTER_REMOVER(NAME, RETURN_TYPE, PROPERTY_KEY)                                \
  public:                                                                                                        \
   std::optional<RETURN_TYPE> Get##NAME() const {                                                                \
-    return ConfigCacheHelper(*config_).Get<RETURN_TYPE>(section_, PROPERTY_KEY);                                \
+    return ConfigCacheHelper(*config_).GetCached<RETURN_TYPE>(section_, PROPERTY_KEY);                          \
   }                                                                                                             \
   MutationEntry Set##NAME(const RETURN_TYPE& value) {                                                           \
     return MutationEntry::Set<RETURN_TYPE>(MutationEntry::PropertyType::NORMAL, section_, PROPERTY_KEY, value); \
@@ -68,7 +68,7 @@ static_assert(
 #define GENERATE_PROPERTY_GETTER_SETTER_REMOVER_WITH_CUSTOM_SETTER(NAME, RETURN_TYPE, PROPERTY_KEY, FUNC)           \
  public:                                                                                                            \
   std::optional<RETURN_TYPE> Get##NAME() const {                                                                    \
-    return ConfigCacheHelper(*config_).Get<RETURN_TYPE>(section_, PROPERTY_KEY);                                    \
+    return ConfigCacheHelper(*config_).GetCached<RETURN_TYPE>(section_, PROPERTY_KEY);                              \
   }                                                                                                                 \
   MutationEntry Set##NAME(const RETURN_TYPE& value) {                                                               \
     auto new_value = [this](const RETURN_TYPE& value) -> RETURN_TYPE FUNC(value);                                   \
@@ -89,7 +89,7 @@ static_assert(false, "GENERATE_TEMP_PROPERTY_GETTER_SETTER_REMOVER() must be uni
 #define GENERATE_TEMP_PROPERTY_GETTER_SETTER_REMOVER(NAME, RETURN_TYPE, PROPERTY_KEY)                                \
  public:                                                                                                             \
   std::optional<RETURN_TYPE> GetTemp##NAME() const {                                                                 \
-    return ConfigCacheHelper(*memory_only_config_).Get<RETURN_TYPE>(section_, PROPERTY_KEY);                         \
+    return ConfigCacheHelper(*memory_only_config_).GetCached<RETURN_TYPE>(section_, PROPERTY_KEY);                   \
   }                                                                                                                  \
   MutationEntry SetTemp##NAME(const RETURN_TYPE& value) {                                                            \
     return MutationEntry::Set<RETURN_TYPE>(MutationEntry::PropertyType::MEMORY_ONLY, section_, PROPERTY_KEY, value); \
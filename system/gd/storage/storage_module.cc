@@ -17,11 +17,16 @@
 #include "storage/storage_module.h"
 
 #include <bluetooth/log.h>
+#include <sys/stat.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <ctime>
 #include <iomanip>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <utility>
 
 #include "common/bind.h"
@@ -31,6 +36,7 @@
 #include "os/handler.h"
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
+#include "storage/binary_config_file.h"
 #include "storage/config_cache.h"
 #include "storage/config_keys.h"
 #include "storage/legacy_config_file.h"
@@ -43,6 +49,9 @@ using os::Alarm;
 using os::Handler;
 
 static const std::string kFactoryResetProperty = "persist.bluetooth.factoryreset";
+// Keep the config in a binary file next to the legacy one, which is then only updated as an export
+static const std::string kBinaryConfigProperty = "persist.bluetooth.storage.binary_config";
+static const std::string kBinaryConfigFileSuffix = ".bin";
 
 static const size_t kDefaultTempDeviceCapacity = 10000;
 // Save config whenever there is a change, but delay it by this value so that burst config change won't overwhelm disk
@@ -50,6 +59,8 @@ static const std::chrono::milliseconds kDefaultConfigSaveDelay = std::chrono::mi
 // Writing a config to disk takes a minimum 10 ms on a decent x86_64 machine
 // The config saving delay must be bigger than this value to avoid overwhelming the disk
 static const std::chrono::milliseconds kMinConfigSaveDelay = std::chrono::milliseconds(20);
+// A series of config changes postpones the save, but never by more than this factor of the delay since its first change
+static const int kMaxConfigSaveDelayFactor = 3;
 
 const int kConfigFileComparePass = 1;
 const std::string kConfigFilePrefix = "bt_config-origin";
@@ -81,10 +92,19 @@ StorageModule::StorageModule(
 };
 
 StorageModule::~StorageModule() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   pimpl_.reset();
 }
 
+// Size of the file at |path|, 0 if it does not exist
+static size_t GetFileSize(const std::string& path) {
+  struct stat file_stat {};
+  if (stat(path.c_str(), &file_stat) != 0) {
+    return 0;
+  }
+  return file_stat.st_size;
+}
+
 const ModuleFactory StorageModule::Factory = ModuleFactory([]() {
   return new StorageModule(
       os::ParameterProvider::ConfigFilePath(), kDefaultConfigSaveDelay, kDefaultTempDeviceCapacity, false, false);
@@ -92,34 +112,113 @@ const ModuleFactory StorageModule::Factory = ModuleFactory([]() {
 
 struct StorageModule::impl {
   explicit impl(Handler* handler, ConfigCache cache, size_t in_memory_cache_size_limit)
-      : config_save_alarm_(handler), cache_(std::move(cache)), memory_only_cache_(in_memory_cache_size_limit, {}) {}
+      : config_save_alarm_(handler),
+        config_save_deadline_alarm_(handler),
+        cache_(std::move(cache)),
+        memory_only_cache_(in_memory_cache_size_limit, {}) {}
+
+  // Append the changed sections to the binary config, or write a new snapshot of it along with the legacy export.
+  // Return the number of bytes written
+  size_t SaveBinaryConfig(const std::string& legacy_config_file_path) {
+    auto changed_sections = cache_.TakeChangedPersistentSections();
+    size_t binary_config_size = binary_config_file_->Size();
+    if (changed_sections && !binary_config_file_->ShouldCompact() &&
+        binary_config_file_->Append(cache_, *changed_sections)) {
+      has_pending_legacy_export_ = true;
+      return binary_config_file_->Size() - binary_config_size;
+    }
+    if (!binary_config_file_->Write(cache_)) {
+      log::error("Unable to write binary config file to disk");
+    }
+    return binary_config_file_->Size() + ExportLegacyConfig(legacy_config_file_path);
+  }
+
+  // Return the number of bytes written
+  size_t ExportLegacyConfig(const std::string& legacy_config_file_path) {
+    has_pending_legacy_export_ = false;
+    if (!LegacyConfigFile::FromPath(legacy_config_file_path).Write(cache_)) {
+      log::error("Unable to export legacy config file to disk");
+      return 0;
+    }
+    return GetFileSize(legacy_config_file_path);
+  }
+
+  void RecordWrite(size_t bytes_written, std::chrono::steady_clock::time_point start_time) {
+    auto write_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+    num_writes_++;
+    num_bytes_written_ += bytes_written;
+    total_write_time_ += write_time;
+    max_write_time_ = std::max(max_write_time_, write_time);
+  }
+
+  // Fires |config_save_delay_| after the last change
   Alarm config_save_alarm_;
+  // Fires |kMaxConfigSaveDelayFactor| times |config_save_delay_| after the first change, so that a continuous series
+  // of changes is still saved
+  Alarm config_save_deadline_alarm_;
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
+
+  // Guards the state of the config saves below, held while saving
+  std::mutex save_mutex_;
   bool has_pending_config_save_ = false;
+
+  // Statistics of the config writes, for dumpsys
+  uint64_t num_writes_ = 0;
+  uint64_t num_coalesced_changes_ = 0;
+  uint64_t num_bytes_written_ = 0;
+  std::chrono::microseconds total_write_time_ = std::chrono::microseconds::zero();
+  std::chrono::microseconds max_write_time_ = std::chrono::microseconds::zero();
+  // Set when the config is stored in binary format, the legacy config file is then an export
+  std::unique_ptr<BinaryConfigFile> binary_config_file_;
+  bool has_pending_legacy_export_ = false;
 };
 
 Mutation StorageModule::Modify() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return Mutation(&pimpl_->cache_, &pimpl_->memory_only_cache_);
 }
 
 void StorageModule::SaveDelayed() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  ScheduleSave();
+}
+
+void StorageModule::ScheduleSave() {
+  std::lock_guard<std::mutex> save_lock(pimpl_->save_mutex_);
   if (pimpl_->has_pending_config_save_) {
-    return;
+    pimpl_->num_coalesced_changes_++;
+  } else {
+    pimpl_->config_save_deadline_alarm_.Schedule(
+        common::BindOnce(&StorageModule::SaveImmediately, common::Unretained(this)),
+        config_save_delay_ * kMaxConfigSaveDelayFactor);
+    pimpl_->has_pending_config_save_ = true;
   }
+  // Postpone the save until the changes settle, so that a burst of them is written at once
   pimpl_->config_save_alarm_.Schedule(
       common::BindOnce(&StorageModule::SaveImmediately, common::Unretained(this)), config_save_delay_);
-  pimpl_->has_pending_config_save_ = true;
 }
 
 void StorageModule::SaveImmediately() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  Save();
+}
+
+void StorageModule::Save() {
+  // Readers only wait on the config cache while it is serialized, not while it is written to disk
+  std::lock_guard<std::mutex> save_lock(pimpl_->save_mutex_);
   if (pimpl_->has_pending_config_save_) {
     pimpl_->config_save_alarm_.Cancel();
+    pimpl_->config_save_deadline_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
+  auto start_time = std::chrono::steady_clock::now();
+  if (pimpl_->binary_config_file_) {
+    pimpl_->RecordWrite(pimpl_->SaveBinaryConfig(config_file_path_), start_time);
+    return;
+  }
+  pimpl_->cache_.TakeChangedPersistentSections();
 #ifndef TARGET_FLOSS
   log::assert_that(
       LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_),
@@ -129,6 +228,7 @@ void StorageModule::SaveImmediately() {
     log::error("Unable to write config file to disk");
   }
 #endif
+  pimpl_->RecordWrite(GetFileSize(config_file_path_), start_time);
   // save checksum if it is running in common criteria mode
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
       bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
@@ -138,7 +238,7 @@ void StorageModule::SaveImmediately() {
 }
 
 void StorageModule::Clear() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   pimpl_->cache_.Clear();
 }
 
@@ -147,16 +247,40 @@ void StorageModule::ListDependencies(ModuleList* list) const {
 }
 
 void StorageModule::Start() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  const std::string binary_config_file_path = config_file_path_ + kBinaryConfigFileSuffix;
+  // The common criteria checksum only covers the legacy config file
+  const bool use_binary_config = os::GetSystemProperty(kBinaryConfigProperty) == "true" &&
+                                 !bluetooth::os::ParameterProvider::IsCommonCriteriaMode();
   if (os::GetSystemProperty(kFactoryResetProperty) == "true") {
     log::info("{} is true, delete config files", kFactoryResetProperty);
     LegacyConfigFile::FromPath(config_file_path_).Delete();
+    if (os::FileExists(binary_config_file_path)) {
+      BinaryConfigFile(binary_config_file_path).Delete();
+    }
     os::SetSystemProperty(kFactoryResetProperty, "false");
   }
   if (!is_config_checksum_pass(kConfigFileComparePass)) {
     LegacyConfigFile::FromPath(config_file_path_).Delete();
   }
-  auto config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+  if (!use_binary_config && os::FileExists(binary_config_file_path)) {
+    // The legacy config file is the one kept up to date from now on
+    log::info("{} is disabled, delete {}", kBinaryConfigProperty, binary_config_file_path);
+    BinaryConfigFile(binary_config_file_path).Delete();
+  }
+
+  std::unique_ptr<BinaryConfigFile> binary_config_file;
+  std::optional<ConfigCache> config;
+  if (use_binary_config) {
+    binary_config_file = std::make_unique<BinaryConfigFile>(binary_config_file_path);
+    if (os::FileExists(binary_config_file_path)) {
+      config = binary_config_file->Read(temp_devices_capacity_);
+    }
+  }
+  if (!config) {
+    // Also migrates the legacy config file, the binary config file is written on the first save
+    config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+  }
   bool save_needed = false;
   if (!config || !config->HasSection(kAdapterSection)) {
     log::warn("Failed to load config at {}; creating new empty ones", config_file_path_);
@@ -171,6 +295,8 @@ void StorageModule::Start() {
     save_needed = true;
   }
   pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_);
+  pimpl_->binary_config_file_ = std::move(binary_config_file);
+  pimpl_->cache_.TakeChangedPersistentSections();
   pimpl_->cache_.SetPersistentConfigChangedCallback(
       [this] { this->CallOn(this, &StorageModule::SaveDelayed); });
 
@@ -185,15 +311,19 @@ void StorageModule::Start() {
   }
 
   if (save_needed) {
-    SaveDelayed();
+    ScheduleSave();
   }
 }
 
 void StorageModule::Stop() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   if (pimpl_->has_pending_config_save_) {
     // Save pending changes before stopping the module.
-    SaveImmediately();
+    Save();
+  }
+  if (pimpl_->has_pending_legacy_export_) {
+    auto start_time = std::chrono::steady_clock::now();
+    pimpl_->RecordWrite(pimpl_->ExportLegacyConfig(config_file_path_), start_time);
   }
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->clear_map();
@@ -205,8 +335,27 @@ std::string StorageModule::ToString() const {
   return "Storage Module";
 }
 
+void StorageModule::Dump(int fd) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (!pimpl_) {
+    return;
+  }
+  std::lock_guard<std::mutex> save_lock(pimpl_->save_mutex_);
+  dprintf(fd, "\nBluetooth Storage:\n");
+  dprintf(fd, "  Config format                  : %s\n", pimpl_->binary_config_file_ ? "binary" : "legacy");
+  dprintf(fd, "  Config save pending            : %s\n", pimpl_->has_pending_config_save_ ? "true" : "false");
+  dprintf(fd, "  Config writes                  : %llu\n", (unsigned long long)pimpl_->num_writes_);
+  dprintf(fd, "  Changes coalesced into a write : %llu\n", (unsigned long long)pimpl_->num_coalesced_changes_);
+  dprintf(fd, "  Bytes written                  : %llu\n", (unsigned long long)pimpl_->num_bytes_written_);
+  dprintf(
+      fd,
+      "  Write time (us)                : total %lld, max %lld\n",
+      (long long)pimpl_->total_write_time_.count(),
+      (long long)pimpl_->max_write_time_.count());
+}
+
 Device StorageModule::GetDeviceByLegacyKey(hci::Address legacy_key_address) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return Device(
       &pimpl_->cache_,
       &pimpl_->memory_only_cache_,
@@ -215,7 +364,7 @@ Device StorageModule::GetDeviceByLegacyKey(hci::Address legacy_key_address) {
 }
 
 Device StorageModule::GetDeviceByClassicMacAddress(hci::Address classic_address) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return Device(
       &pimpl_->cache_,
       &pimpl_->memory_only_cache_,
@@ -224,7 +373,7 @@ Device StorageModule::GetDeviceByClassicMacAddress(hci::Address classic_address)
 }
 
 Device StorageModule::GetDeviceByLeIdentityAddress(hci::Address le_identity_address) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return Device(
       &pimpl_->cache_,
       &pimpl_->memory_only_cache_,
@@ -233,7 +382,7 @@ Device StorageModule::GetDeviceByLeIdentityAddress(hci::Address le_identity_addr
 }
 
 std::vector<Device> StorageModule::GetBondedDevices() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   auto persistent_sections = pimpl_->cache_.GetPersistentSections();
   std::vector<Device> result;
   result.reserve(persistent_sections.size());
@@ -248,116 +397,122 @@ bool StorageModule::is_config_checksum_pass(int check_bit) {
 }
 
 bool StorageModule::HasSection(const std::string& section) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return pimpl_->cache_.HasSection(section);
 }
 
 bool StorageModule::HasProperty(const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return pimpl_->cache_.HasProperty(section, property);
 }
 
 std::optional<std::string> StorageModule::GetProperty(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return pimpl_->cache_.GetProperty(section, property);
 }
 
 void StorageModule::SetProperty(std::string section, std::string property, std::string value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   pimpl_->cache_.SetProperty(section, property, value);
 }
 
 std::vector<std::string> StorageModule::GetPersistentSections() const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return pimpl_->cache_.GetPersistentSections();
 }
 
+std::vector<std::pair<std::string, ConfigCache::PropertyList>>
+StorageModule::GetPersistentSectionProperties() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return pimpl_->cache_.GetPersistentSectionProperties();
+}
+
 void StorageModule::RemoveSection(const std::string& section) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   pimpl_->cache_.RemoveSection(section);
 }
 
 bool StorageModule::RemoveProperty(const std::string& section, const std::string& property) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return pimpl_->cache_.RemoveProperty(section, property);
 }
 
 void StorageModule::ConvertEncryptOrDecryptKeyIfNeeded() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   pimpl_->cache_.ConvertEncryptOrDecryptKeyIfNeeded();
 }
 
 void StorageModule::RemoveSectionWithProperty(const std::string& property) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return pimpl_->cache_.RemoveSectionWithProperty(property);
 }
 
 void StorageModule::SetBool(const std::string& section, const std::string& property, bool value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   ConfigCacheHelper::FromConfigCache(pimpl_->cache_).SetBool(section, property, value);
 }
 
 std::optional<bool> StorageModule::GetBool(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return ConfigCacheHelper::FromConfigCache(pimpl_->cache_).GetBool(section, property);
 }
 
 void StorageModule::SetUint64(
     const std::string& section, const std::string& property, uint64_t value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   ConfigCacheHelper::FromConfigCache(pimpl_->cache_).SetUint64(section, property, value);
 }
 
 std::optional<uint64_t> StorageModule::GetUint64(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return ConfigCacheHelper::FromConfigCache(pimpl_->cache_).GetUint64(section, property);
 }
 
 void StorageModule::SetUint32(
     const std::string& section, const std::string& property, uint32_t value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   ConfigCacheHelper::FromConfigCache(pimpl_->cache_).SetUint32(section, property, value);
 }
 
 std::optional<uint32_t> StorageModule::GetUint32(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return ConfigCacheHelper::FromConfigCache(pimpl_->cache_).GetUint32(section, property);
 }
 void StorageModule::SetInt64(
     const std::string& section, const std::string& property, int64_t value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   ConfigCacheHelper::FromConfigCache(pimpl_->cache_).SetInt64(section, property, value);
 }
 std::optional<int64_t> StorageModule::GetInt64(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return ConfigCacheHelper::FromConfigCache(pimpl_->cache_).GetInt64(section, property);
 }
 
 void StorageModule::SetInt(const std::string& section, const std::string& property, int value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   ConfigCacheHelper::FromConfigCache(pimpl_->cache_).SetInt(section, property, value);
 }
 
 std::optional<int> StorageModule::GetInt(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return ConfigCacheHelper::FromConfigCache(pimpl_->cache_).GetInt(section, property);
 }
 
 void StorageModule::SetBin(
     const std::string& section, const std::string& property, const std::vector<uint8_t>& value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   ConfigCacheHelper::FromConfigCache(pimpl_->cache_).SetBin(section, property, value);
 }
 
 std::optional<std::vector<uint8_t>> StorageModule::GetBin(
     const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return ConfigCacheHelper::FromConfigCache(pimpl_->cache_).GetBin(section, property);
 }
 
@@ -21,6 +21,7 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -113,6 +114,9 @@ class StorageModule : public bluetooth::Module {
   // Commit() is called. User should never touch ConfigCache() directly.
   Mutation Modify();
 
+  // Dump the config saving statistics to |fd|
+  void Dump(int fd) const;
+
  protected:
   void ListDependencies(ModuleList* list) const override;
   void Start() override;
@@ -124,7 +128,8 @@ class StorageModule : public bluetooth::Module {
   friend security::internal::SecurityManagerImpl;
   // For unit test only
   ConfigCache* GetMemoryOnlyConfigCache();
-  // Normally, underlying config will be saved at most 3 seconds after the first config change in a series of changes
+  // Normally, underlying config will be saved 3 seconds after the last config change in a series of changes, and at
+  // most |kMaxConfigSaveDelayFactor| times that after the first one
   // This method triggers the delayed saving automatically, the delay is equal to |config_save_delay_|
   void SaveDelayed();
   // In some cases, one may want to save the config immediately to disk. Call this method with caution as it runs
@@ -155,6 +160,7 @@ class StorageModule : public bluetooth::Module {
   void SetProperty(std::string section, std::string property, std::string value);
 
   std::vector<std::string> GetPersistentSections() const;
+  std::vector<std::pair<std::string, ConfigCache::PropertyList>> GetPersistentSectionProperties() const;
 
   void RemoveSection(const std::string& section);
   bool RemoveProperty(const std::string& section, const std::string& property);
@@ -179,7 +185,8 @@ class StorageModule : public bluetooth::Module {
 
  private:
   struct impl;
-  mutable std::recursive_mutex mutex_;
+  // Held exclusively while the module starts and stops, and shared otherwise as the config cache is thread safe
+  mutable std::shared_mutex mutex_;
   std::unique_ptr<impl> pimpl_;
   std::string config_file_path_;
   std::string config_backup_path_;
@@ -188,6 +195,9 @@ class StorageModule : public bluetooth::Module {
   bool is_restricted_mode_;
   bool is_single_user_mode_;
   static bool is_config_checksum_pass(int check_bit);
+  // Schedule or perform a config save, called with |mutex_| held
+  void ScheduleSave();
+  void Save();
 };
 
 }  // namespace storage
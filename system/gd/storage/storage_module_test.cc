@@ -128,6 +128,16 @@ class StorageModuleTest : public Test {
     handler->Post(bluetooth::common::BindOnce(fake_timerfd_advance, time.count()));
   }
 
+  std::string Dump(const StorageModule* storage) {
+    FILE* dump_file = tmpfile();
+    storage->Dump(fileno(dump_file));
+    rewind(dump_file);
+    std::string dump(4096, '\0');
+    dump.resize(fread(dump.data(), 1, dump.size(), dump_file));
+    fclose(dump_file);
+    return dump;
+  }
+
   bool WaitForReactorIdle(std::chrono::milliseconds time) {
     bool stopped =
         test_registry_.GetTestThread().GetReactor()->WaitForIdle(std::chrono::seconds(2));
@@ -316,6 +326,56 @@ TEST_F(StorageModuleTest, changed_config_causes_a_write) {
   ASSERT_TRUE(std::filesystem::exists(temp_config_));
 }
 
+TEST_F(StorageModuleTest, burst_of_changes_causes_a_single_write) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "foo");
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "bar");
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "baz");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay));
+
+  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(kTestTempDevicesCapacity);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(
+      config->GetProperty("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME), Optional(StrEq("baz")));
+  auto dump = Dump(storage);
+  ASSERT_THAT(dump, HasSubstr("Config writes                  : 1\n"));
+  ASSERT_THAT(dump, HasSubstr("Changes coalesced into a write : 2\n"));
+
+  // Tear down
+  test_registry_.StopAll();
+}
+
+TEST_F(StorageModuleTest, continuous_changes_are_written_by_the_deadline) {
+  // Prepare config file
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
+  test_registry_.InjectTestModule(&StorageModule::Factory, storage);
+
+  // Remove the file after it was read, so we can check if it was written with exists()
+  DeleteConfigFiles();
+
+  // Each change postpones the save, up to three times the save delay after the first one
+  for (int i = 0; i < 5; i++) {
+    storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, std::to_string(i));
+    ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay / 2));
+    ASSERT_FALSE(std::filesystem::exists(temp_config_));
+  }
+  storage->SetPropertyPublic("01:02:03:ab:cd:ea", BTIF_STORAGE_KEY_NAME, "5");
+  ASSERT_TRUE(WaitForReactorIdle(kTestConfigSaveDelay / 2));
+  ASSERT_TRUE(std::filesystem::exists(temp_config_));
+
+  // Tear down
+  test_registry_.StopAll();
+}
+
 TEST_F(StorageModuleTest, no_config_causes_a_write) {
   // Set up
   auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, false, false);
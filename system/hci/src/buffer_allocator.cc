@@ -22,11 +22,12 @@
 
 #include "internal_include/bt_target.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_pool.h"
 
 static void* buffer_alloc(size_t size) {
   bluetooth::log::assert_that(size <= BT_DEFAULT_BUFFER_SIZE,
                               "assert failed: size <= BT_DEFAULT_BUFFER_SIZE");
-  return osi_malloc(size);
+  return buffer_pool_alloc(size);
 }
 
 static const allocator_t interface = {buffer_alloc, osi_free};
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <set>
+#include <utility>
 
 #include <base/sys_byteorder.h>
 
@@ -223,6 +224,7 @@ struct MediaPlayerItem {
   }
 
   MediaPlayerItem(const MediaPlayerItem&) = default;
+  MediaPlayerItem(MediaPlayerItem&&) = default;
 
   static constexpr size_t kHeaderSize() {
     size_t ret = 0;
@@ -259,6 +261,7 @@ struct FolderItem {
   }
 
   FolderItem(const FolderItem&) = default;
+  FolderItem(FolderItem&&) = default;
 
   static constexpr size_t kHeaderSize() {
     size_t ret = 0;
@@ -297,6 +300,7 @@ struct MediaElementItem {
   }
 
   MediaElementItem(const MediaElementItem&) = default;
+  MediaElementItem(MediaElementItem&&) = default;
 
   size_t size() const {
     size_t ret = 0;
@@ -325,11 +329,13 @@ struct MediaListItem {
     MediaElementItem song_;
   };
 
-  MediaListItem(MediaPlayerItem item) : type_(PLAYER), player_(item) {}
+  MediaListItem(MediaPlayerItem item)
+      : type_(PLAYER), player_(std::move(item)) {}
 
-  MediaListItem(FolderItem item) : type_(FOLDER), folder_(item) {}
+  MediaListItem(FolderItem item) : type_(FOLDER), folder_(std::move(item)) {}
 
-  MediaListItem(MediaElementItem item) : type_(SONG), song_(item) {}
+  MediaListItem(MediaElementItem item)
+      : type_(SONG), song_(std::move(item)) {}
 
   MediaListItem(const MediaListItem& item) {
     type_ = item.type_;
@@ -346,6 +352,21 @@ struct MediaListItem {
     }
   }
 
+  MediaListItem(MediaListItem&& item) noexcept {
+    type_ = item.type_;
+    switch (item.type_) {
+      case PLAYER:
+        new (&player_) MediaPlayerItem(std::move(item.player_));
+        return;
+      case FOLDER:
+        new (&folder_) FolderItem(std::move(item.folder_));
+        return;
+      case SONG:
+        new (&song_) MediaElementItem(std::move(item.song_));
+        return;
+    }
+  }
+
   ~MediaListItem() {
     switch (type_) {
       case PLAYER:
@@ -75,6 +75,28 @@ class AdvertisingTrackInfo {
   std::vector<uint8_t> scan_response;
 };
 
+/** Scan results delivered together, sharing a single advertising data buffer
+ */
+struct ScanResultBatch {
+  struct ScanResult {
+    uint16_t event_type;
+    uint8_t addr_type;
+    RawAddress bda;
+    uint8_t primary_phy;
+    uint8_t secondary_phy;
+    uint8_t advertising_sid;
+    int8_t tx_power;
+    int8_t rssi;
+    uint16_t periodic_adv_int;
+    /* Location of the advertising data of the result in |adv_data| */
+    uint32_t adv_data_offset;
+    uint16_t adv_data_len;
+  };
+
+  std::vector<ScanResult> results;
+  std::vector<uint8_t> adv_data;
+};
+
 /**
  * LE Scanning related callbacks invoked from from the Bluetooth native stack
  * All callbacks are invoked on the JNI thread
@@ -92,6 +114,19 @@ class ScanningCallbacks {
                             int8_t tx_power, int8_t rssi,
                             uint16_t periodic_adv_int,
                             std::vector<uint8_t> adv_data) = 0;
+  /** Scan results accumulated when the scan result batching is enabled, in
+   * reception order. Defaults to one OnScanResult per result. */
+  virtual void OnScanResultBatch(ScanResultBatch batch) {
+    for (const ScanResultBatch::ScanResult& result : batch.results) {
+      auto adv_data = batch.adv_data.cbegin() + result.adv_data_offset;
+      OnScanResult(result.event_type, result.addr_type, result.bda,
+                   result.primary_phy, result.secondary_phy,
+                   result.advertising_sid, result.tx_power, result.rssi,
+                   result.periodic_adv_int,
+                   std::vector<uint8_t>(adv_data,
+                                        adv_data + result.adv_data_len));
+    }
+  }
   virtual void OnTrackAdvFoundLost(
       AdvertisingTrackInfo advertising_track_info) = 0;
   virtual void OnBatchScanReports(int client_if, int status, int report_format,
@@ -535,6 +535,17 @@
 #define PORT_RX_BUF_CRITICAL_WM 15
 #endif
 
+/* The maximum number of credits granted to the peer when the credit window is
+ * scaled up for an application draining its data fast enough, in number of
+ * buffers and in bytes. */
+#ifndef PORT_RX_BUF_MAX_CREDIT_WM
+#define PORT_RX_BUF_MAX_CREDIT_WM 64
+#endif
+
+#ifndef PORT_RX_MAX_CREDIT_WM
+#define PORT_RX_MAX_CREDIT_WM (BTA_RFC_MTU_SIZE * PORT_RX_BUF_MAX_CREDIT_WM)
+#endif
+
 /* The port transmit queue high watermark level, in bytes. */
 #ifndef PORT_TX_HIGH_WM
 #define PORT_TX_HIGH_WM (BTA_RFC_MTU_SIZE * PORT_TX_BUF_HIGH_WM)
@@ -21,7 +21,9 @@
 #include <bluetooth/log.h>
 #include <time.h>
 
+#include <atomic>
 #include <chrono>
+#include <cinttypes>
 #include <cstdint>
 #include <functional>
 #include <future>
@@ -30,6 +32,7 @@
 #include <optional>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/interfaces/ILoggable.h"
@@ -389,6 +392,33 @@ void ValidateAclInterface(const shim::legacy::acl_interface_t& acl_interface) {
 
 constexpr HciHandle kInvalidHciHandle = 0xffff;
 
+// Upper bound on the packets converted per dequeue wakeup, so that a busy link
+// does not hold the handler away from the other connections
+constexpr size_t kMaxPacketsPerWakeup = 16;
+
+// Conversions of received ACL packets from the gd queues to legacy buffers,
+// summed over all the connections
+struct AclRxStats {
+  std::atomic<uint64_t> wakeups{0};
+  std::atomic<uint64_t> packets{0};
+  std::atomic<uint64_t> bytes{0};
+  const std::chrono::steady_clock::time_point start{
+      std::chrono::steady_clock::now()};
+
+  void OnWakeup(size_t num_packets, size_t num_bytes) {
+    wakeups++;
+    packets += num_packets;
+    bytes += num_bytes;
+  }
+};
+
+AclRxStats acl_rx_stats;
+
+void send_buffers_upwards(SendDataUpwards send_data_upwards,
+                          std::vector<BT_HDR*> buffers) {
+  for (BT_HDR* p_buf : buffers) send_data_upwards(p_buf);
+}
+
 class ShimAclConnection {
  public:
   ShimAclConnection(const HciHandle handle, SendDataUpwards send_data_upwards,
@@ -431,25 +461,36 @@ class ShimAclConnection {
     return packet;
   }
 
+  // Drains the packets available on the connection queue, up to
+  // kMaxPacketsPerWakeup, and hands them to the main thread in a single post
   void data_ready_callback() {
-    auto packet = queue_up_end_->TryDequeue();
-    uint16_t length = packet->size();
-    std::vector<uint8_t> preamble;
-    preamble.push_back(LowByte(handle_));
-    preamble.push_back(HighByte(handle_));
-    preamble.push_back(LowByte(length));
-    preamble.push_back(HighByte(length));
-    BT_HDR* p_buf = MakeLegacyBtHdrPacket(std::move(packet), preamble);
-    log::assert_that(p_buf != nullptr,
-                     "Unable to allocate BT_HDR legacy packet handle:{:04x}",
-                     handle_);
+    std::vector<BT_HDR*> buffers;
+    size_t bytes = 0;
+    while (buffers.size() < kMaxPacketsPerWakeup) {
+      auto packet = queue_up_end_->TryDequeue();
+      if (packet == nullptr) break;
+      uint16_t length = packet->size();
+      const std::array<uint8_t, HCI_DATA_PREAMBLE_SIZE> preamble = {
+          LowByte(handle_), HighByte(handle_), LowByte(length),
+          HighByte(length)};
+      BT_HDR* p_buf = MakeLegacyBtHdrPacket(std::move(packet), preamble);
+      log::assert_that(p_buf != nullptr,
+                       "Unable to allocate BT_HDR legacy packet handle:{:04x}",
+                       handle_);
+      bytes += p_buf->len;
+      buffers.push_back(p_buf);
+    }
+    if (buffers.empty()) return;
+    acl_rx_stats.OnWakeup(buffers.size(), bytes);
+
     if (send_data_upwards_ == nullptr) {
       log::warn("Dropping ACL data with no callback");
-      osi_free(p_buf);
-    } else if (do_in_main_thread(FROM_HERE,
-                                 base::BindOnce(send_data_upwards_, p_buf)) !=
+      for (BT_HDR* p_buf : buffers) osi_free(p_buf);
+    } else if (do_in_main_thread(
+                   FROM_HERE, base::BindOnce(&send_buffers_upwards,
+                                             send_data_upwards_, buffers)) !=
                BT_STATUS_SUCCESS) {
-      osi_free(p_buf);
+      for (BT_HDR* p_buf : buffers) osi_free(p_buf);
     }
   }
 
@@ -1174,6 +1215,18 @@ struct shim::legacy::Acl::impl {
                    "Ignore connection from", "Le");
   }
 
+  void ignore_le_connections_from(
+      std::vector<hci::AddressWithType> address_with_types) {
+    for (const auto& address_with_type : address_with_types) {
+      shadow_acceptlist_.Remove(address_with_type);
+      BTM_LogHistory(kBtmLogTag, ToLegacyAddressWithType(address_with_type),
+                     "Ignore connection from", "Le");
+    }
+    log::debug("Ignore Le connection from {} remotes",
+               address_with_types.size());
+    GetAclManager()->CancelLeConnects(std::move(address_with_types));
+  }
+
   void clear_acceptlist() {
     auto shadow_acceptlist = shadow_acceptlist_.GetCopy();
     size_t count = shadow_acceptlist.size();
@@ -1251,6 +1304,21 @@ struct shim::legacy::Acl::impl {
       }
     }
 
+    const uint64_t wakeups = acl_rx_stats.wakeups;
+    const uint64_t packets = acl_rx_stats.packets;
+    const uint64_t bytes = acl_rx_stats.bytes;
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                      acl_rx_stats.start)
+            .count();
+    LOG_DUMPSYS(fd,
+                "Received packets:%" PRIu64 " bytes:%" PRIu64
+                " wakeups:%" PRIu64 " packets/s:%.1f bytes/s:%.1f "
+                "packets/wakeup:%.2f",
+                packets, bytes, wakeups, seconds > 0 ? packets / seconds : 0.0,
+                seconds > 0 ? bytes / seconds : 0.0,
+                wakeups > 0 ? static_cast<double>(packets) / wakeups : 0.0);
+
     auto acceptlist = shadow_acceptlist_.GetCopy();
     LOG_DUMPSYS(fd,
                 "Shadow le accept list              size:%-3zu "
@@ -1532,6 +1600,13 @@ void shim::legacy::Acl::IgnoreLeConnectionFrom(
                    address_with_type);
 }
 
+void shim::legacy::Acl::IgnoreLeConnectionsFrom(
+    const std::vector<hci::AddressWithType>& address_with_types) {
+  log::debug("IgnoreLeConnectionsFrom {} remotes", address_with_types.size());
+  handler_->CallOn(pimpl_.get(), &Acl::impl::ignore_le_connections_from,
+                   address_with_types);
+}
+
 void shim::legacy::Acl::OnClassicLinkDisconnected(HciHandle handle,
                                                   hci::ErrorCode reason) {
   hci::Address remote_address =
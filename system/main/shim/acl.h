@@ -18,6 +18,7 @@
 
 #include <future>
 #include <memory>
+#include <vector>
 
 #include "hci/acl_manager/connection_callbacks.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
@@ -85,6 +86,9 @@ class Acl : public hci::acl_manager::ConnectionCallbacks,
                                   uint16_t conn_timeout, uint16_t min_ce_len,
                                   uint16_t max_ce_len) override;
 
+  void IgnoreLeConnectionsFrom(
+      const std::vector<hci::AddressWithType>& address_with_types);
+
   // Address Resolution List
   void AddToAddressResolution(const hci::AddressWithType& address_with_type,
                               const std::array<uint8_t, 16>& peer_irk,
@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <future>
 #include <optional>
+#include <vector>
 
 #include "hci/acl_manager.h"
 #include "hci/remote_name_request.h"
@@ -72,6 +73,17 @@ void bluetooth::shim::ACL_IgnoreLeConnectionFrom(
       ToAddressWithTypeFromLegacy(legacy_address_with_type));
 }
 
+void bluetooth::shim::ACL_IgnoreLeConnectionsFrom(
+    const std::vector<tBLE_BD_ADDR>& legacy_address_with_types) {
+  std::vector<hci::AddressWithType> address_with_types;
+  address_with_types.reserve(legacy_address_with_types.size());
+  for (const auto& legacy_address_with_type : legacy_address_with_types) {
+    address_with_types.push_back(
+        ToAddressWithTypeFromLegacy(legacy_address_with_type));
+  }
+  Stack::GetInstance()->GetAcl()->IgnoreLeConnectionsFrom(address_with_types);
+}
+
 void bluetooth::shim::ACL_WriteData(uint16_t handle, BT_HDR* p_buf) {
   std::unique_ptr<bluetooth::packet::RawBuilder> packet = MakeUniquePacket(
       p_buf->data + p_buf->offset + HCI_DATA_PREAMBLE_SIZE,
@@ -215,7 +227,8 @@ void bluetooth::shim::ACL_LeSubrateRequest(
 void bluetooth::shim::ACL_RemoteNameRequest(const RawAddress& addr,
                                             uint8_t page_scan_rep_mode,
                                             uint8_t /* page_scan_mode */,
-                                            uint16_t clock_offset) {
+                                            uint16_t clock_offset,
+                                            bool prioritized) {
   bluetooth::shim::GetRemoteNameRequest()->StartRemoteNameRequest(
       ToGdAddress(addr),
       hci::RemoteNameRequestBuilder::Create(
@@ -267,7 +280,9 @@ void bluetooth::shim::ACL_RemoteNameRequest(const RawAddress& addr,
                     },
                     addr, status, name));
           },
-          addr));
+          addr),
+      prioritized ? hci::RemoteNameRequestModule::Priority::HIGH
+                  : hci::RemoteNameRequestModule::Priority::NORMAL);
 }
 
 void bluetooth::shim::ACL_CancelRemoteNameRequest(const RawAddress& addr) {
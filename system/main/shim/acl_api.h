@@ -17,6 +17,7 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_octets.h"
@@ -32,6 +33,8 @@ void ACL_CancelClassicConnection(const RawAddress& raw_address);
 bool ACL_AcceptLeConnectionFrom(const tBLE_BD_ADDR& legacy_address_with_type,
                                 bool is_direct);
 void ACL_IgnoreLeConnectionFrom(const tBLE_BD_ADDR& legacy_address_with_type);
+void ACL_IgnoreLeConnectionsFrom(
+    const std::vector<tBLE_BD_ADDR>& legacy_address_with_types);
 
 void ACL_Disconnect(uint16_t handle, bool is_classic, tHCI_STATUS reason,
                     std::string comment);
@@ -68,9 +71,11 @@ void ACL_LeSubrateRequest(uint16_t hci_handle, uint16_t subrate_min,
                           uint16_t subrate_max, uint16_t max_latency,
                           uint16_t cont_num, uint16_t sup_tout);
 
+// |prioritized| requests, made while bonding with or connecting to the device,
+// are queued ahead of the ones made for discovery.
 void ACL_RemoteNameRequest(const RawAddress& bd_addr,
                            uint8_t page_scan_rep_mode, uint8_t page_scan_mode,
-                           uint16_t clock_offset);
+                           uint16_t clock_offset, bool prioritized);
 void ACL_CancelRemoteNameRequest(const RawAddress& addr);
 
 }  // namespace shim
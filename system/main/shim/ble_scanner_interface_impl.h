@@ -19,6 +19,8 @@
  */
 #pragma once
 
+#include <chrono>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <vector>
@@ -153,6 +155,29 @@ class BleScannerInterfaceImpl : public ::BleScannerInterface,
       ApcfCommand apcf_command);
   void handle_remote_properties(RawAddress bd_addr, tBLE_ADDR_TYPE addr_type,
                                 std::vector<uint8_t> advertising_data);
+  void queue_scan_result(uint16_t event_type, uint8_t address_type,
+                         const RawAddress& raw_address,
+                         tBLE_ADDR_TYPE ble_addr_type, uint8_t primary_phy,
+                         uint8_t secondary_phy, uint8_t advertising_sid,
+                         int8_t tx_power, int8_t rssi,
+                         uint16_t periodic_advertising_interval,
+                         const std::vector<uint8_t>& advertising_data);
+  void flush_scan_results();
+  void flush_scan_results_locked();
+  void handle_scan_result_batch(ScanResultBatch batch,
+                                std::vector<tBLE_ADDR_TYPE> ble_addr_types);
+
+  // Scan results batching: the results are accumulated and delivered to the
+  // jni thread in a single task, after |scan_result_batch_window_| or when
+  // |scan_result_batch_max_results_| are pending. Disabled for a null window.
+  std::chrono::milliseconds scan_result_batch_window_{0};
+  size_t scan_result_batch_max_results_{0};
+  // Guards the pending batch, filled on the gd stack thread and flushed on
+  // the main thread at the end of the window.
+  std::mutex scan_result_batch_mutex_;
+  ScanResultBatch scan_result_batch_;
+  std::vector<tBLE_ADDR_TYPE> scan_result_batch_ble_addr_types_;
+  bool scan_result_batch_flush_scheduled_{false};
 
   class AddressCache {
    public:
@@ -22,6 +22,8 @@
 #include <cstdint>
 #include <cstring>
 
+#include "common/numbers.h"
+#include "common/strings.h"
 #include "main/shim/entry.h"
 #include "os/log.h"
 #include "storage/storage_module.h"
@@ -32,6 +34,51 @@ using ::bluetooth::storage::ConfigCacheHelper;
 namespace bluetooth {
 namespace shim {
 
+const std::string* DeviceProperties::Find(const std::string& property) const {
+  for (const auto& [name, value] : properties) {
+    if (name == property) {
+      return &value;
+    }
+  }
+  return nullptr;
+}
+
+bool DeviceProperties::HasProperty(const std::string& property) const {
+  return Find(property) != nullptr;
+}
+
+bool DeviceProperties::GetInt(const std::string& property, int* value) const {
+  log::assert_that(value != nullptr, "assert failed: value != nullptr");
+  const std::string* value_str = Find(property);
+  if (value_str == nullptr) {
+    return false;
+  }
+  auto large_value = common::Int64FromString(*value_str);
+  if (!large_value || !common::IsNumberInNumericLimits<int>(*large_value)) {
+    return false;
+  }
+  *value = static_cast<int>(*large_value);
+  return true;
+}
+
+bool DeviceProperties::GetBin(const std::string& property, uint8_t* value,
+                              size_t* length) const {
+  log::assert_that(value != nullptr, "assert failed: value != nullptr");
+  log::assert_that(length != nullptr, "assert failed: length != nullptr");
+  const std::string* value_str = Find(property);
+  if (value_str == nullptr) {
+    return false;
+  }
+  auto value_vec = common::FromHexString(*value_str);
+  if (!value_vec) {
+    log::warn("value_str cannot be parsed to std::vector<uint8_t>");
+    return false;
+  }
+  *length = std::min(value_vec->size(), *length);
+  std::memcpy(value, value_vec->data(), *length);
+  return true;
+}
+
 bool BtifConfigInterface::HasSection(const std::string& section) {
   return GetStorage()->HasSection(section);
 }
@@ -151,6 +198,17 @@ std::vector<std::string> BtifConfigInterface::GetPersistentDevices() {
   return GetStorage()->GetPersistentSections();
 }
 
+std::vector<DeviceProperties>
+BtifConfigInterface::GetPersistentDeviceProperties() {
+  auto sections = GetStorage()->GetPersistentSectionProperties();
+  std::vector<DeviceProperties> devices;
+  devices.reserve(sections.size());
+  for (auto& [section, properties] : sections) {
+    devices.push_back({std::move(section), std::move(properties)});
+  }
+  return devices;
+}
+
 void BtifConfigInterface::ConvertEncryptOrDecryptKeyIfNeeded() {
   GetStorage()->ConvertEncryptOrDecryptKeyIfNeeded();
 }
@@ -19,11 +19,28 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace bluetooth {
 namespace shim {
 
+// A persistent device section and its properties, as read by
+// BtifConfigInterface::GetPersistentDeviceProperties(). The values are decoded
+// as the BtifConfigInterface getters of the same name decode them.
+struct DeviceProperties {
+  std::string section;
+  std::vector<std::pair<std::string, std::string>> properties;
+
+  bool HasProperty(const std::string& property) const;
+  bool GetInt(const std::string& property, int* value) const;
+  bool GetBin(const std::string& property, uint8_t* value,
+              size_t* length) const;
+
+ private:
+  const std::string* Find(const std::string& property) const;
+};
+
 class BtifConfigInterface {
  public:
   ~BtifConfigInterface() = default;
@@ -54,6 +71,8 @@ class BtifConfigInterface {
                              const std::string& key);
   static void RemoveSection(const std::string& section);
   static std::vector<std::string> GetPersistentDevices();
+  // Read all the persistent device sections in a single pass over the config
+  static std::vector<DeviceProperties> GetPersistentDeviceProperties();
   static void ConvertEncryptOrDecryptKeyIfNeeded();
   static void Clear();
 };
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 
 #include "common/bidi_queue.h"
 #include "common/init_flags.h"
@@ -31,7 +32,9 @@
 #include "hci/include/packet_fragmenter.h"
 #include "main/shim/entry.h"
 #include "osi/include/allocator.h"
+#include "packet/packet_builder.h"
 #include "packet/raw_builder.h"
+#include "stack/btm/btm_iso_sdu_pool.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/btm_iso_api.h"
@@ -128,6 +131,35 @@ static std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
   return payload;
 }
 
+// ISO SDU payload serialized straight from the BT_HDR buffer of the SDU, which
+// is returned to the ISO SDU pool once the packet is sent or dropped.
+class IsoSduPayloadBuilder : public bluetooth::packet::PacketBuilder<true> {
+ public:
+  IsoSduPayloadBuilder(uint16_t handle, BT_HDR* sdu, const uint8_t* data,
+                       size_t len)
+      : handle_(handle), sdu_(sdu), data_(data), len_(len) {}
+  IsoSduPayloadBuilder(const IsoSduPayloadBuilder&) = delete;
+  IsoSduPayloadBuilder& operator=(const IsoSduPayloadBuilder&) = delete;
+  ~IsoSduPayloadBuilder() override {
+    bluetooth::hci::iso_manager::IsoSduPool::GetInstance().Release(handle_,
+                                                                   sdu_);
+  }
+
+  size_t size() const override { return len_; }
+
+  void Serialize(bluetooth::packet::BitInserter& it) const override {
+    for (size_t i = 0; i < len_; i++) {
+      insert(data_[i], it);
+    }
+  }
+
+ private:
+  uint16_t handle_;
+  BT_HDR* sdu_;
+  const uint8_t* data_;
+  size_t len_;
+};
+
 static BT_HDR* WrapPacketAndCopy(
     uint16_t event,
     bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>* data) {
@@ -137,7 +169,7 @@ static BT_HDR* WrapPacketAndCopy(
   packet->len = data->size();
   packet->layer_specific = 0;
   packet->event = event;
-  std::copy(data->begin(), data->end(), packet->data);
+  data->CopyTo(packet->data);
   return packet;
 }
 
@@ -217,7 +249,10 @@ static void transmit_command(const BT_HDR* command,
   }
 }
 
-static void transmit_iso_fragment(const uint8_t* stream, size_t length) {
+// Sends the fragment from |stream|. When |sdu| is set, the fragment is the last
+// one of this pooled SDU buffer, which is then handed over without a copy.
+static void transmit_iso_fragment(const uint8_t* stream, size_t length,
+                                  BT_HDR* sdu = nullptr) {
   uint16_t handle_with_flags;
   STREAM_TO_UINT16(handle_with_flags, stream);
   auto pb_flag = static_cast<bluetooth::hci::IsoPacketBoundaryFlag>(
@@ -232,7 +267,13 @@ static void transmit_iso_fragment(const uint8_t* stream, size_t length) {
   // skip data total length
   stream += 2;
   length -= 2;
-  auto payload = MakeUniquePacket(stream, length);
+  std::unique_ptr<bluetooth::packet::BasePacketBuilder> payload;
+  if (sdu != nullptr) {
+    payload =
+        std::make_unique<IsoSduPayloadBuilder>(handle, sdu, stream, length);
+  } else {
+    payload = MakeUniquePacket(stream, length);
+  }
   auto iso_packet = bluetooth::hci::IsoBuilder::Create(handle, pb_flag, ts_flag,
                                                        std::move(payload));
 
@@ -265,6 +306,22 @@ static void iso_data_callback() {
   if (!send_data_upwards) {
     return;
   }
+  // A complete SDU held in a single buffer is read in place by the IsoManager,
+  // the fragments are copied and reassembled. Both are handled in order on the
+  // main thread.
+  if (packet->GetPbFlag() ==
+          bluetooth::hci::IsoPacketBoundaryFlag::COMPLETE_SDU &&
+      packet->ContiguousData() != nullptr) {
+    do_in_main_thread(
+        FROM_HERE,
+        base::BindOnce(
+            [](std::unique_ptr<bluetooth::hci::IsoView> packet) {
+              bluetooth::hci::IsoManager::GetInstance()->HandleIsoSdu(
+                  packet->ContiguousData(), packet->size());
+            },
+            std::move(packet)));
+    return;
+  }
   auto data = WrapPacketAndCopy(MSG_HC_TO_STACK_HCI_ISO, packet.get());
   packet_fragmenter->reassemble_and_dispatch(data);
 }
@@ -332,6 +389,11 @@ static void transmit_fragment(BT_HDR* packet, bool send_transmit_finished) {
   if (event == MSG_STACK_TO_HC_HCI_ISO) {
     const uint8_t* stream = packet->data + packet->offset;
     size_t length = packet->len;
+    if (free_after_transmit &&
+        (packet->layer_specific & BT_ISO_HDR_FROM_SDU_POOL)) {
+      cpp::transmit_iso_fragment(stream, length, packet);
+      return;
+    }
     cpp::transmit_iso_fragment(stream, length);
   }
 
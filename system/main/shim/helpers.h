@@ -17,6 +17,7 @@
 
 #include <bluetooth/log.h>
 
+#include <array>
 #include <vector>
 
 #include "common/init_flags.h"
@@ -123,14 +124,18 @@ inline std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
 inline BT_HDR* MakeLegacyBtHdrPacket(
     std::unique_ptr<bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>>
         packet,
-    const std::vector<uint8_t>& preamble) {
-  std::vector<uint8_t> packet_vector(packet->begin(), packet->end());
+    const std::array<uint8_t, HCI_DATA_PREAMBLE_SIZE>& preamble) {
+  // Copied straight from the packet view into the legacy buffer, the header
+  // fields are the only part that needs to be zeroed
+  const size_t packet_size = packet->size();
   BT_HDR* buffer = static_cast<BT_HDR*>(
-      osi_calloc(packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
+      osi_malloc(packet_size + preamble.size() + sizeof(BT_HDR)));
+  buffer->event = 0;
+  buffer->offset = 0;
+  buffer->layer_specific = 0;
   std::copy(preamble.begin(), preamble.end(), buffer->data);
-  std::copy(packet_vector.begin(), packet_vector.end(),
-            buffer->data + preamble.size());
-  buffer->len = preamble.size() + packet_vector.size();
+  std::copy(packet->begin(), packet->end(), buffer->data + preamble.size());
+  buffer->len = preamble.size() + packet_size;
   return buffer;
 }
 
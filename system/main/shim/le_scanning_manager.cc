@@ -23,6 +23,8 @@
 #include <bluetooth/log.h>
 #include <hardware/bluetooth.h>
 
+#include <algorithm>
+
 #include "btif/include/btif_common.h"
 #include "hci/address.h"
 #include "hci/le_scanning_manager.h"
@@ -36,10 +38,12 @@
 #include "main/shim/le_scanning_manager.h"
 #include "main/shim/shim.h"
 #include "os/log.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/advertise_data_parser.h"
 #include "stack/include/bt_dev_class.h"
 #include "stack/include/btm_log_history.h"
+#include "stack/include/main_thread.h"
 #include "storage/device.h"
 #include "storage/le_device.h"
 #include "storage/storage_module.h"
@@ -63,6 +67,15 @@ constexpr uint8_t kFilterLogicAnd = 0x01;
 constexpr uint8_t kLowestRssiValue = 129;
 constexpr uint16_t kAllowAllFilter = 0x00;
 constexpr uint16_t kListLogicOr = 0x01;
+// Window in which the scan results are accumulated before being delivered
+// to the jni thread together, 0 to deliver every result on its own.
+constexpr char kPropertyScanResultBatchWindowMs[] =
+    "bluetooth.le.scan_result_batch_window_ms";
+// Number of accumulated scan results delivered without waiting for the end
+// of the window.
+constexpr char kPropertyScanResultBatchMaxResults[] =
+    "bluetooth.le.scan_result_batch_max_results";
+constexpr int kDefaultScanResultBatchMaxResults = 32;
 
 class DefaultScanningCallback : public ::ScanningCallbacks {
   void OnScannerRegistered(const bluetooth::Uuid /* app_uuid */,
@@ -145,12 +158,26 @@ void btm_ble_process_adv_addr(RawAddress& raw_address,
                               tBLE_ADDR_TYPE* address_type);
 
 extern DEV_CLASS btm_ble_get_appearance_as_cod(
-    std::vector<uint8_t> const& data);
+    const AdvertiseDataIndex& data);
 
 using bluetooth::shim::BleScannerInterfaceImpl;
 
 void BleScannerInterfaceImpl::Init() {
   log::info("init BleScannerInterfaceImpl");
+
+  // Configured before the scan results are received
+  int batch_window_ms =
+      osi_property_get_int32(kPropertyScanResultBatchWindowMs, 0);
+  int batch_max_results = osi_property_get_int32(
+      kPropertyScanResultBatchMaxResults, kDefaultScanResultBatchMaxResults);
+  scan_result_batch_window_ =
+      std::chrono::milliseconds(std::max(batch_window_ms, 0));
+  scan_result_batch_max_results_ = std::max(batch_max_results, 1);
+  if (batch_window_ms > 0) {
+    log::info("Scan results batched for {}ms or {} results", batch_window_ms,
+              batch_max_results);
+  }
+
   bluetooth::shim::GetScanning()->RegisterScanningCallback(this);
 
 #if TARGET_FLOSS
@@ -178,6 +205,10 @@ void BleScannerInterfaceImpl::Unregister(int scanner_id) {
 void BleScannerInterfaceImpl::Scan(bool start) {
   log::info("in shim layer {}", (start) ? "started" : "stopped");
   bluetooth::shim::GetScanning()->Scan(start);
+  if (!start) {
+    // Deliver the results received before the scan was stopped
+    flush_scan_results();
+  }
   if (start && !btm_cb.ble_ctr_cb.is_ble_observe_active()) {
     btm_cb.neighbor.le_scan = {
         .start_time_ms = timestamper_in_milliseconds.GetTimestamp(),
@@ -528,15 +559,21 @@ void BleScannerInterfaceImpl::OnScanResult(
     btm_ble_process_adv_addr(raw_address, &ble_addr_type);
   }
 
-  do_in_jni_thread(base::BindOnce(
-      &BleScannerInterfaceImpl::handle_remote_properties,
-      base::Unretained(this), raw_address, ble_addr_type, advertising_data));
-
-  do_in_jni_thread(base::BindOnce(
-      &ScanningCallbacks::OnScanResult, base::Unretained(scanning_callbacks_),
-      event_type, static_cast<uint8_t>(address_type), raw_address, primary_phy,
-      secondary_phy, advertising_sid, tx_power, rssi,
-      periodic_advertising_interval, advertising_data));
+  if (scan_result_batch_window_.count() > 0) {
+    queue_scan_result(event_type, address_type, raw_address, ble_addr_type,
+                      primary_phy, secondary_phy, advertising_sid, tx_power,
+                      rssi, periodic_advertising_interval, advertising_data);
+  } else {
+    do_in_jni_thread(base::BindOnce(
+        &BleScannerInterfaceImpl::handle_remote_properties,
+        base::Unretained(this), raw_address, ble_addr_type, advertising_data));
+
+    do_in_jni_thread(base::BindOnce(
+        &ScanningCallbacks::OnScanResult, base::Unretained(scanning_callbacks_),
+        event_type, static_cast<uint8_t>(address_type), raw_address,
+        primary_phy, secondary_phy, advertising_sid, tx_power, rssi,
+        periodic_advertising_interval, advertising_data));
+  }
 
   // TODO: Remove when StartInquiry in GD part implemented
   btm_ble_process_adv_pkt_cont_for_inquiry(
@@ -545,6 +582,79 @@ void BleScannerInterfaceImpl::OnScanResult(
       advertising_data);
 }
 
+void BleScannerInterfaceImpl::queue_scan_result(
+    uint16_t event_type, uint8_t address_type, const RawAddress& raw_address,
+    tBLE_ADDR_TYPE ble_addr_type, uint8_t primary_phy, uint8_t secondary_phy,
+    uint8_t advertising_sid, int8_t tx_power, int8_t rssi,
+    uint16_t periodic_advertising_interval,
+    const std::vector<uint8_t>& advertising_data) {
+  std::lock_guard<std::mutex> lock(scan_result_batch_mutex_);
+  scan_result_batch_.results.push_back({
+      .event_type = event_type,
+      .addr_type = address_type,
+      .bda = raw_address,
+      .primary_phy = primary_phy,
+      .secondary_phy = secondary_phy,
+      .advertising_sid = advertising_sid,
+      .tx_power = tx_power,
+      .rssi = rssi,
+      .periodic_adv_int = periodic_advertising_interval,
+      .adv_data_offset =
+          static_cast<uint32_t>(scan_result_batch_.adv_data.size()),
+      .adv_data_len = static_cast<uint16_t>(advertising_data.size()),
+  });
+  scan_result_batch_.adv_data.insert(scan_result_batch_.adv_data.end(),
+                                     advertising_data.begin(),
+                                     advertising_data.end());
+  scan_result_batch_ble_addr_types_.push_back(ble_addr_type);
+
+  if (scan_result_batch_.results.size() >= scan_result_batch_max_results_) {
+    flush_scan_results_locked();
+  } else if (!scan_result_batch_flush_scheduled_) {
+    // The window starts with the first pending result
+    scan_result_batch_flush_scheduled_ = true;
+    do_in_main_thread_delayed(
+        FROM_HERE,
+        base::BindOnce(&BleScannerInterfaceImpl::flush_scan_results,
+                       base::Unretained(this)),
+        scan_result_batch_window_);
+  }
+}
+
+void BleScannerInterfaceImpl::flush_scan_results() {
+  std::lock_guard<std::mutex> lock(scan_result_batch_mutex_);
+  scan_result_batch_flush_scheduled_ = false;
+  flush_scan_results_locked();
+}
+
+/* Hands the pending scan results over to the jni thread in a single task.
+ * A flush scheduled for a batch already delivered because full only ends the
+ * window of the next batch early. */
+void BleScannerInterfaceImpl::flush_scan_results_locked() {
+  if (scan_result_batch_.results.empty()) {
+    return;
+  }
+
+  do_in_jni_thread(
+      base::BindOnce(&BleScannerInterfaceImpl::handle_scan_result_batch,
+                     base::Unretained(this), std::move(scan_result_batch_),
+                     std::move(scan_result_batch_ble_addr_types_)));
+  scan_result_batch_ = {};
+  scan_result_batch_ble_addr_types_ = {};
+}
+
+void BleScannerInterfaceImpl::handle_scan_result_batch(
+    ScanResultBatch batch, std::vector<tBLE_ADDR_TYPE> ble_addr_types) {
+  for (size_t i = 0; i < batch.results.size(); i++) {
+    const ScanResultBatch::ScanResult& result = batch.results[i];
+    auto adv_data = batch.adv_data.cbegin() + result.adv_data_offset;
+    handle_remote_properties(
+        result.bda, ble_addr_types[i],
+        std::vector<uint8_t>(adv_data, adv_data + result.adv_data_len));
+  }
+  scanning_callbacks_->OnScanResultBatch(std::move(batch));
+}
+
 void BleScannerInterfaceImpl::OnTrackAdvFoundLost(
     bluetooth::hci::AdvertisingFilterOnFoundOnLostInfo on_found_on_lost_info) {
   AdvertisingTrackInfo track_info = {};
@@ -751,10 +861,12 @@ void BleScannerInterfaceImpl::handle_remote_properties(
     return;
   }
 
+  // Index the fields once for all the lookups below
+  AdvertiseDataIndex ad(advertising_data);
+
   auto device_type = bluetooth::hci::DeviceType::LE;
   uint8_t flag_len;
-  const uint8_t* p_flag = AdvertiseDataParser::GetFieldByType(
-      advertising_data, BTM_BLE_AD_TYPE_FLAG, &flag_len);
+  const uint8_t* p_flag = ad.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &flag_len);
 
   if (p_flag != NULL && flag_len != 0) {
     if ((BTM_BLE_BREDR_NOT_SPT & *p_flag) == 0) {
@@ -763,12 +875,12 @@ void BleScannerInterfaceImpl::handle_remote_properties(
   }
 
   uint8_t remote_name_len;
-  const uint8_t* p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-      advertising_data, HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
+  const uint8_t* p_eir_remote_name =
+      ad.GetFieldByType(HCI_EIR_COMPLETE_LOCAL_NAME_TYPE, &remote_name_len);
 
   if (p_eir_remote_name == NULL) {
-    p_eir_remote_name = AdvertiseDataParser::GetFieldByType(
-        advertising_data, HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
+    p_eir_remote_name =
+        ad.GetFieldByType(HCI_EIR_SHORTENED_LOCAL_NAME_TYPE, &remote_name_len);
   }
 
   bt_bdname_t bdname = {0};
@@ -794,7 +906,7 @@ void BleScannerInterfaceImpl::handle_remote_properties(
     }
   }
 
-  DEV_CLASS dev_class = btm_ble_get_appearance_as_cod(advertising_data);
+  DEV_CLASS dev_class = btm_ble_get_appearance_as_cod(ad);
   if (dev_class != kDevClassUnclassified) {
     btif_dm_update_ble_remote_properties(bd_addr, bdname.name, dev_class,
                                          device_type);
@@ -42,6 +42,7 @@
 #include "main/shim/acl.h"
 #include "main/shim/acl_legacy_interface.h"
 #include "main/shim/distance_measurement_manager.h"
+#include "main/shim/dumpsys.h"
 #include "main/shim/entry.h"
 #include "main/shim/hci_layer.h"
 #include "main/shim/le_advertising_manager.h"
@@ -62,6 +63,8 @@ using ::bluetooth::common::StringFormat;
 
 struct Stack::impl {
   legacy::Acl* acl_ = nullptr;
+  // Registered for dumpsys when the whole stack is started
+  storage::StorageModule* storage_ = nullptr;
 };
 
 Stack::Stack() { pimpl_ = std::make_shared<Stack::impl>(); }
@@ -106,6 +109,16 @@ void Stack::StartEverything() {
   log::assert_that(
       stack_manager_.GetInstance<shim::Dumpsys>() != nullptr,
       "assert failed: stack_manager_.GetInstance<shim::Dumpsys>() != nullptr");
+  pimpl_->storage_ = stack_manager_.GetInstance<storage::StorageModule>();
+  shim::RegisterDumpsysFunction(
+      pimpl_->storage_,
+      [storage = pimpl_->storage_](int fd) { storage->Dump(fd); });
+  if (stack_thread_->GetTaskStats() != nullptr) {
+    shim::RegisterDumpsysFunction(
+        stack_thread_, [task_stats = stack_thread_->GetTaskStats()](int fd) {
+          task_stats->Dump(fd);
+        });
+  }
   if (stack_manager_.IsStarted<hci::Controller>()) {
     pimpl_->acl_ = new legacy::Acl(stack_handler_, legacy::GetAclInterface(),
                                    GetController()->GetLeFilterAcceptListSize(),
@@ -161,6 +174,14 @@ void Stack::Stop() {
   log::assert_that(is_running_, "Gd stack not running");
   is_running_ = false;
 
+  if (pimpl_->storage_ != nullptr) {
+    shim::UnregisterDumpsysFunction(pimpl_->storage_);
+    pimpl_->storage_ = nullptr;
+  }
+  if (stack_thread_->GetTaskStats() != nullptr) {
+    shim::UnregisterDumpsysFunction(stack_thread_);
+  }
+
   stack_handler_->Clear();
 
   stack_manager_.ShutDown();
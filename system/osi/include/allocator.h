@@ -47,6 +47,47 @@ void osi_free(void* ptr);
 // |p_ptr| cannot be NULL.
 void osi_free_and_reset(void** p_ptr);
 
+// Allocation accounting.
+//
+// When enabled with the bluetooth.osi.alloc_accounting.enabled property, the
+// buffers allocated with |osi_malloc| and |osi_calloc| and not freed yet are
+// counted per tag, along with the high water mark of their size, so that the
+// memory held by each subsystem shows in dumpsys. A buffer is charged to the
+// tag of the code allocating it, not of the code holding it.
+//
+// The allocations of a source file are tagged by defining OSI_ALLOC_TAG
+// before its first include, as done for LOG_TAG:
+//   #define OSI_ALLOC_TAG "gatt"
+// The allocations of the other files are counted as "untagged".
+void* osi_malloc_tagged(size_t size, const char* tag);
+void* osi_calloc_tagged(size_t size, const char* tag);
+
+#ifdef OSI_ALLOC_TAG
+#define osi_malloc(size) osi_malloc_tagged(size, OSI_ALLOC_TAG)
+#define osi_calloc(size) osi_calloc_tagged(size, OSI_ALLOC_TAG)
+#endif
+
+typedef struct {
+  size_t live_bytes;
+  size_t live_buffers;
+  size_t high_water_bytes;
+  uint64_t allocations;
+} osi_alloc_tag_stats_t;
+
+// Enables or disables the accounting, overriding the property. The counters
+// are reset when it is disabled.
+void osi_alloc_accounting_set_enabled(bool enabled);
+
+// Copies the counters of |tag| into |stats|.
+// Returns false if the accounting is disabled or nothing was allocated with
+// |tag| since it was enabled.
+bool osi_alloc_accounting_get_stats(const char* tag,
+                                    osi_alloc_tag_stats_t* stats);
+
+// Dump the allocation counters of each tag to the |fd| file descriptor.
+// The caller is responsible for closing the |fd|.
+void osi_alloc_accounting_dump(int fd);
+
 class OsiObject {
  public:
   OsiObject(void* ptr);
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "osi/include/allocator.h"
+
+// Size-class slab pool for short lived packet buffers (BT_HDR and friends).
+//
+// Blocks are carved out of a single reserved arena, one region per size
+// class. Each class keeps a lock-free global free list, and every thread
+// keeps a small cache of recently freed blocks per class so that the common
+// alloc/free cycle on a single data path thread never touches shared state.
+// Requests larger than the biggest class, or made while a class is
+// exhausted, fall back to |osi_malloc|.
+//
+// Blocks handed out by the pool may be released with |osi_free|.
+
+// allocator_t abstraction for |buffer_pool_alloc| and |osi_free|.
+extern const allocator_t allocator_buffer_pool;
+
+// Allocates |size| bytes, from the pool when a size class fits.
+// Never returns NULL.
+void* buffer_pool_alloc(size_t size);
+
+// Releases a block returned by |buffer_pool_alloc|. |ptr| may be NULL.
+void buffer_pool_free(void* ptr);
+
+// Returns true if |ptr| lies inside the pool arena.
+bool buffer_pool_owns(const void* ptr);
+
+typedef struct {
+  size_t block_size;
+  size_t capacity;
+  uint64_t hits;
+  uint64_t misses;
+  size_t in_use;
+  size_t high_water;
+} buffer_pool_class_stats_t;
+
+// Number of size classes managed by the pool.
+size_t buffer_pool_class_count(void);
+
+// Copies the counters of size class |index| into |stats|.
+// Returns false if |index| is out of range.
+bool buffer_pool_get_class_stats(size_t index,
+                                 buffer_pool_class_stats_t* stats);
+
+// Dump buffer pool counters to the |fd| file descriptor.
+// The caller is responsible for closing the |fd|.
+void buffer_pool_debug_dump(int fd);
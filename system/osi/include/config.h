@@ -20,6 +20,8 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 // The default section name to use if a key/value pair is not defined within
 // a section.
@@ -30,9 +32,67 @@ struct entry_t {
   std::string value;
 };
 
+// Index by name of the entries of a section or of the sections of a config,
+// kept in sync by the functions of this module. A copied index, or the index
+// of a list filled directly, is rebuilt on its next lookup. Elements must not
+// be renamed or removed from the list directly once the index is in use.
+template <typename T>
+class config_index_t {
+ public:
+  using iterator = typename std::list<T>::iterator;
+
+  config_index_t() = default;
+  // A copy belongs to another list, which it is built from when used.
+  config_index_t(const config_index_t&) {}
+  config_index_t& operator=(const config_index_t&) {
+    map_.clear();
+    valid_ = false;
+    return *this;
+  }
+
+  // Returns the first element of |list| named |name|, or |list.end()|.
+  iterator Find(std::list<T>& list, std::string_view name) const {
+    if (!valid_) Rebuild(list);
+    auto it = map_.find(name);
+    return it == map_.end() ? list.end() : it->second;
+  }
+
+  // Adds |element| at the end of |list|. |list| must not have an element of
+  // the same name.
+  iterator Append(std::list<T>& list, T element) {
+    if (!valid_) Rebuild(list);
+    list.push_back(std::move(element));
+    auto it = std::prev(list.end());
+    map_.emplace(GetName(*it), it);
+    return it;
+  }
+
+  // Removes |it| from |list|, returns the following element.
+  iterator Erase(std::list<T>& list, iterator it) {
+    auto entry = map_.find(GetName(*it));
+    if (entry != map_.end() && entry->second == it) map_.erase(entry);
+    return list.erase(it);
+  }
+
+ private:
+  static std::string_view GetName(const T& element);
+
+  void Rebuild(std::list<T>& list) const {
+    map_.clear();
+    for (auto it = list.begin(); it != list.end(); ++it) {
+      map_.emplace(GetName(*it), it);
+    }
+    valid_ = true;
+  }
+
+  mutable std::unordered_map<std::string_view, iterator> map_;
+  mutable bool valid_ = false;
+};
+
 struct section_t {
   std::string name;
   std::list<entry_t> entries;
+  config_index_t<entry_t> entry_index;
   void Set(std::string key, std::string value);
   std::list<entry_t>::iterator Find(const std::string& key);
   bool Has(const std::string& key);
@@ -40,10 +100,22 @@ struct section_t {
 
 struct config_t {
   std::list<section_t> sections;
+  config_index_t<section_t> section_index;
   std::list<section_t>::iterator Find(const std::string& section);
   bool Has(const std::string& section);
 };
 
+template <>
+inline std::string_view config_index_t<entry_t>::GetName(const entry_t& entry) {
+  return entry.key;
+}
+
+template <>
+inline std::string_view config_index_t<section_t>::GetName(
+    const section_t& section) {
+  return section.name;
+}
+
 // Creates a new config object with no entries (i.e. not backed by a file).
 // This function returns a unique pointer to config object.
 std::unique_ptr<config_t> config_new_empty(void);
@@ -0,0 +1,92 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bounded multi-producer, single-consumer queue.
+//
+// A lock free variant of |fixed_queue_t| for the packet queues filled from
+// several threads and drained by one: enqueuing and dequeuing take no lock
+// and make no system call, except for the first enqueue after the consumer
+// found the queue empty, which signals the consumer's reactor. Unlike
+// |fixed_queue_t|, enqueuing never blocks and fails when the queue is full.
+//
+// Any thread may enqueue. Dequeuing, peeking and flushing must be done from
+// a single consumer thread at a time, usually the thread of the reactor the
+// queue is registered with.
+
+struct mpsc_queue_t;
+typedef struct mpsc_queue_t mpsc_queue_t;
+typedef struct reactor_t reactor_t;
+
+typedef void (*mpsc_queue_free_cb)(void* data);
+typedef void (*mpsc_queue_cb)(mpsc_queue_t* queue, void* context);
+
+// Creates a new queue holding up to |capacity| elements. Returns NULL on
+// failure. The caller must free the returned queue with |mpsc_queue_free|.
+mpsc_queue_t* mpsc_queue_new(size_t capacity);
+
+// Frees a queue and, if |free_cb| is not NULL, calls it on each element left
+// in the queue. No other thread may be using the queue. |queue| may be NULL.
+void mpsc_queue_free(mpsc_queue_t* queue, mpsc_queue_free_cb free_cb);
+
+// Dequeues all the elements of |queue| and, if |free_cb| is not NULL, calls
+// it on each of them. Must be called from the consumer thread.
+void mpsc_queue_flush(mpsc_queue_t* queue, mpsc_queue_free_cb free_cb);
+
+// Returns true if there is no element to dequeue from |queue|. If |queue| is
+// NULL, the return value is true.
+bool mpsc_queue_is_empty(mpsc_queue_t* queue);
+
+// Returns the number of elements in |queue|. The value is a snapshot that
+// may be outdated as soon as it is returned when producers are running. If
+// |queue| is NULL, the return value is 0.
+size_t mpsc_queue_length(mpsc_queue_t* queue);
+
+// Returns the maximum number of elements |queue| may hold. |queue| may not
+// be NULL.
+size_t mpsc_queue_capacity(mpsc_queue_t* queue);
+
+// Tries to enqueue |data| into |queue| from any thread. This function never
+// blocks the caller, it returns false if |queue| is full. Neither |queue| nor
+// |data| may be NULL.
+bool mpsc_queue_try_enqueue(mpsc_queue_t* queue, void* data);
+
+// Dequeues the next element of |queue|. Returns NULL if |queue| is empty or
+// NULL. Must be called from the consumer thread.
+void* mpsc_queue_try_dequeue(mpsc_queue_t* queue);
+
+// Returns the next element of |queue| without dequeuing it, or NULL if
+// |queue| is empty or NULL. Must be called from the consumer thread.
+void* mpsc_queue_try_peek_first(mpsc_queue_t* queue);
+
+// Registers |queue| with |reactor| for dequeue operations, like
+// |fixed_queue_register_dequeue|: |ready_cb| is called on the reactor thread
+// while there are elements in the queue, and is expected to dequeue one
+// element or more on each call. The |context| parameter is passed, untouched,
+// to the callback routine. Neither |queue|, nor |reactor|, nor |ready_cb| may
+// be NULL. |context| may be NULL.
+void mpsc_queue_register_dequeue(mpsc_queue_t* queue, reactor_t* reactor,
+                                 mpsc_queue_cb ready_cb, void* context);
+
+// Unregisters the dequeue ready callback for |queue| from whichever reactor
+// it is registered with, if any. This function is idempotent.
+void mpsc_queue_unregister_dequeue(mpsc_queue_t* queue);
@@ -23,6 +23,12 @@
 
 typedef struct ringbuffer_t ringbuffer_t;
 
+// A contiguous region of the memory of a ringbuffer
+typedef struct {
+  uint8_t* data;
+  size_t length;
+} ringbuffer_span_t;
+
 // NOTE:
 // None of the functions below are thread safe when it comes to accessing the
 // *rb pointer. It is *NOT* possible to insert and pop/delete at the same time.
@@ -33,6 +39,13 @@ typedef struct ringbuffer_t ringbuffer_t;
 // using |ringbuffer_free|.
 ringbuffer_t* ringbuffer_init(const size_t size);
 
+// Create a ringbuffer with the specified size rounded up to the next power of
+// two, so that positions in the buffer wrap around with a mask. A ringbuffer
+// created by |ringbuffer_init| with a power of two size does the same.
+// Returns NULL if memory allocation failed. Resulting pointer must be freed
+// using |ringbuffer_free|.
+ringbuffer_t* ringbuffer_init_pow2(const size_t size);
+
 // Frees the ringbuffer structure and buffer
 // Save to call with NULL.
 void ringbuffer_free(ringbuffer_t* rb);
@@ -61,3 +74,23 @@ size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length);
 // Deletes |length| bytes from the ringbuffer starting from the head
 // Return actual number of bytes deleted.
 size_t ringbuffer_delete(ringbuffer_t* rb, size_t length);
+
+// Sets |spans| to the regions holding the data of the buffer, in order from
+// the head, without copying it. The second region is empty unless the data
+// wraps around the end of the buffer. The data can be processed in place,
+// and is released with |ringbuffer_delete|.
+// Returns the size of data in buffer, which is the total length of |spans|.
+size_t ringbuffer_read_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]);
+
+// Sets |spans| to the free regions of the buffer, in order from the tail, so
+// that data can be produced directly into the buffer. The second region is
+// empty unless the free space wraps around the end of the buffer. The data
+// written is added to the buffer by |ringbuffer_commit|.
+// Returns remaining buffer size, which is the total length of |spans|.
+size_t ringbuffer_write_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]);
+
+// Adds the |length| bytes written in the regions returned by
+// |ringbuffer_write_spans| to the data of the buffer, advancing its tail.
+// Return actual number of bytes added. Can be less than |length| if buffer
+// is full.
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length);
@@ -16,5 +16,33 @@
 
 #pragma once
 
+#include <sys/types.h>
+
+// Roles of the audio critical threads, each with its own scheduling policy.
+// The policy of a role is read from the system properties:
+//  - bluetooth.scheduler.<role>.priority: SCHED_FIFO priority of the thread,
+//    or 0 for SCHED_OTHER. Defaults to 1.
+//  - bluetooth.scheduler.<role>.cpus: comma separated list of the CPUs the
+//    thread may run on. Defaults to all of them.
+// where <role> is the name returned by thread_role_text().
+enum class ThreadRole {
+  A2DP_SOURCE,
+  A2DP_SOURCE_ENCODER,
+  A2DP_SINK,
+  LE_AUDIO_SOURCE,
+};
+
+const char* thread_role_text(ThreadRole role);
+
 bool thread_scheduler_enable_real_time(pid_t pid);
 bool thread_scheduler_get_priority_range(int& min, int& max);
+
+// Applies the scheduling policy of |role| to the thread |linux_tid|, and
+// remembers it as the thread of |role| for thread_scheduler_dump(). Returns
+// false if the scheduling policy could not be set; failing to set the CPU
+// affinity is only logged.
+bool thread_scheduler_apply_policy(pid_t linux_tid, ThreadRole role);
+
+// Dumps the policy configured for each role next to the actual policy of its
+// thread, and the context switch counts of the thread.
+void thread_scheduler_dump(int fd);
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchical timer wheel with millisecond resolution.
+//
+// Entries are bucketed by the most significant 6-bit digit in which their
+// deadline differs from the wheel's current time, so that every level covers
+// 64 times the span of the level below it. Insertion and removal are O(1);
+// finding the earliest entry inspects one occupancy word per level and the
+// entries of a single slot. Deadlines too far out for the top level are kept
+// on an overflow list.
+//
+// The wheel does not own its entries: callers embed a |timer_wheel_node_t| in
+// their own structure. The wheel is not thread safe.
+
+typedef struct timer_wheel_node_t {
+  struct timer_wheel_node_t* prev;
+  struct timer_wheel_node_t* next;
+  uint64_t deadline_ms;
+  // Position in the wheel. Only meaningful while |linked| is set.
+  uint8_t level;
+  uint8_t slot;
+  bool linked;
+} timer_wheel_node_t;
+
+struct timer_wheel_t;
+typedef struct timer_wheel_t timer_wheel_t;
+
+// Iterator callback prototype used for |timer_wheel_foreach|.
+// Callback must return true to continue iterating or false to stop iterating.
+// The callback may not modify the wheel.
+typedef bool (*timer_wheel_iter_cb)(timer_wheel_node_t* node, void* context);
+
+// Returns a new, empty wheel whose current time is |now_ms|. The returned
+// wheel must be freed with |timer_wheel_free|.
+timer_wheel_t* timer_wheel_new(uint64_t now_ms);
+
+// Frees the wheel. Linked nodes are left untouched and become unlinked from
+// the wheel's point of view only. |wheel| may be NULL.
+void timer_wheel_free(timer_wheel_t* wheel);
+
+// Initializes |node| so that it can be passed to |timer_wheel_remove| before
+// it has ever been inserted. |node| may not be NULL.
+void timer_wheel_node_init(timer_wheel_node_t* node);
+
+// Inserts |node| with the given |deadline_ms|. Deadlines in the past are
+// treated as due now. |node| must not already be linked.
+void timer_wheel_insert(timer_wheel_t* wheel, timer_wheel_node_t* node,
+                        uint64_t deadline_ms);
+
+// Removes |node| from the wheel. This is a no-op if |node| is not linked.
+void timer_wheel_remove(timer_wheel_t* wheel, timer_wheel_node_t* node);
+
+// Returns true if |wheel| has no entries.
+bool timer_wheel_is_empty(const timer_wheel_t* wheel);
+
+// Returns the number of entries in |wheel|.
+size_t timer_wheel_size(const timer_wheel_t* wheel);
+
+// Returns the entry with the earliest deadline, or NULL if |wheel| is empty.
+// Entries sharing a deadline are returned in insertion order.
+timer_wheel_node_t* timer_wheel_earliest(const timer_wheel_t* wheel);
+
+// Moves the wheel's current time forward to |now_ms| and re-buckets the
+// entries that became closer. Entries that are due stay in the wheel; callers
+// remove them after fetching them with |timer_wheel_earliest|. Moving the
+// time backwards is a no-op.
+void timer_wheel_advance(timer_wheel_t* wheel, uint64_t now_ms);
+
+// Iterates over all entries in no particular order.
+void timer_wheel_foreach(const timer_wheel_t* wheel,
+                         timer_wheel_iter_cb callback, void* context);
@@ -20,6 +20,7 @@
 
 #include <hardware/bluetooth.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Set the Bluetooth OS callouts to |callouts|.
 // This function should be called when native kernel wakelocks are not used
@@ -27,12 +28,16 @@
 // kernel wakelocks will be used.
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts);
 
-// Acquire the Bluetooth wakelock.
+// Acquire the Bluetooth wakelock. The wakelock is not reference counted:
+// acquiring it while it is held, or during its release delay, does not reach
+// the OS.
 // The function is thread safe.
 // Return true on success, otherwise false.
 bool wakelock_acquire(void);
 
-// Release the Bluetooth wakelock.
+// Release the Bluetooth wakelock. The OS wakelock is released after the delay
+// set by the "bluetooth.wakelock.release_delay_ms" property, right away by
+// default.
 // The function is thread safe.
 // Return true on success, otherwise false.
 bool wakelock_release(void);
@@ -49,6 +54,11 @@ void wakelock_cleanup(void);
 // If |lock_path| or |unlock_path| are NULL, that path is not changed.
 void wakelock_set_paths(const char* lock_path, const char* unlock_path);
 
+// This function should not need to be called normally.
+// Overrides the release delay of the "bluetooth.wakelock.release_delay_ms"
+// property until wakelock_cleanup() is called.
+void wakelock_set_release_delay(int64_t delay_ms);
+
 // Dump wakelock-related debug info to the |fd| file descriptor.
 // The caller is responsible for closing the |fd|.
 void wakelock_debug_dump(int fd);
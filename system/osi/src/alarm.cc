@@ -30,13 +30,17 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
 #include <mutex>
+#include <vector>
 
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/list.h"
+#include "osi/include/properties.h"
 #include "osi/include/thread.h"
+#include "osi/include/timer_wheel.h"
 #include "osi/include/wakelock.h"
 #include "osi/semaphore.h"
 #include "stack/include/main_thread.h"
@@ -78,6 +82,13 @@ struct CancelableClosureInStruct {
   }
 };
 
+// Links an alarm into the timer wheel. |node| must stay the first member so
+// that a |timer_wheel_node_t*| can be converted back to the entry.
+struct alarm_wheel_entry_t {
+  timer_wheel_node_t node;
+  alarm_t* alarm;
+};
+
 struct alarm_t {
   // The mutex is held while the callback for this alarm is being executed.
   // It allows us to release the coarse-grained monitor lock while a
@@ -98,6 +109,8 @@ struct alarm_t {
 
   bool for_msg_loop;  // True, if the alarm should be processed on message loop
   CancelableClosureInStruct closure;  // posted to message loop for processing
+
+  alarm_wheel_entry_t wheel_entry;  // Used by the timer wheel backend only
 };
 
 // If the next wakeup time is less than this threshold, we should acquire
@@ -112,6 +125,14 @@ static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 // also protects the |alarms| list.
 static std::mutex alarms_mutex;
 static list_t* alarms;
+// Pending alarms are kept in |alarm_wheel| when the timer wheel backend is
+// enabled, and in the deadline sorted |alarms| list otherwise. |alarms| is
+// allocated in both cases and tells whether the module is initialized.
+static timer_wheel_t* alarm_wheel;
+static const char* TIMER_WHEEL_PROPERTY =
+    "bluetooth.osi.alarm.timer_wheel.enabled";
+// The deadline the root timers are currently armed for, or 0 if disarmed.
+static uint64_t armed_deadline_ms;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
@@ -135,6 +156,10 @@ static void alarm_cancel_internal(alarm_t* alarm);
 static void remove_pending_alarm(alarm_t* alarm);
 static void schedule_next_instance(alarm_t* alarm);
 static void reschedule_root_alarm(void);
+static void reschedule_root_alarm_if_needed(void);
+static alarm_t* pending_alarms_front(void);
+static void pending_alarms_add(alarm_t* alarm);
+static void pending_alarms_remove(alarm_t* alarm);
 static void alarm_queue_ready(fixed_queue_t* queue, void* context);
 static void timer_callback(void* data);
 static void callback_dispatch(void* context);
@@ -177,6 +202,9 @@ static alarm_t* alarm_new_internal(const char* name, bool is_periodic) {
   // placement new
   new (&ret->closure) CancelableClosureInStruct();
 
+  timer_wheel_node_init(&ret->wheel_entry.node);
+  ret->wheel_entry.alarm = ret;
+
   // NOTE: The stats were reset by osi_calloc() above
 
   return ret;
@@ -255,9 +283,6 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
-
   remove_pending_alarm(alarm);
 
   alarm->deadline_ms = 0;
@@ -267,7 +292,7 @@ static void alarm_cancel_internal(alarm_t* alarm) {
   alarm->stats.canceled_count++;
   alarm->queue = NULL;
 
-  if (needs_reschedule) reschedule_root_alarm();
+  reschedule_root_alarm_if_needed();
 }
 
 bool alarm_is_scheduled(const alarm_t* alarm) {
@@ -296,6 +321,10 @@ void alarm_cleanup(void) {
   semaphore_free(alarm_expired);
   alarm_expired = NULL;
 
+  timer_wheel_free(alarm_wheel);
+  alarm_wheel = NULL;
+  armed_deadline_ms = 0;
+
   list_free(alarms);
   alarms = NULL;
 }
@@ -316,6 +345,10 @@ static bool lazy_initialize(void) {
     goto error;
   }
 
+  if (osi_property_get_bool(TIMER_WHEEL_PROPERTY, false)) {
+    alarm_wheel = timer_wheel_new(now_ms());
+  }
+
   if (!timer_create_internal(CLOCK_ID, &timer)) goto error;
   timer_initialized = true;
 
@@ -375,6 +408,9 @@ error:
 
   if (timer_initialized) timer_delete(timer);
 
+  timer_wheel_free(alarm_wheel);
+  alarm_wheel = NULL;
+
   list_free(alarms);
   alarms = NULL;
 
@@ -396,7 +432,7 @@ static uint64_t now_ms(void) {
 // Remove alarm from internal alarm list and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  pending_alarms_remove(alarm);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -411,10 +447,6 @@ static void remove_pending_alarm(alarm_t* alarm) {
 
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
-  // If the alarm is currently set and it's at the start of the list,
-  // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -425,6 +457,32 @@ static void schedule_next_instance(alarm_t* alarm) {
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
   alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
 
+  pending_alarms_add(alarm);
+
+  // Removing or adding the alarm may have moved the earliest deadline.
+  reschedule_root_alarm_if_needed();
+}
+
+// Returns the pending alarm with the earliest deadline, or NULL.
+// NOTE: must be called with |alarms_mutex| held
+static alarm_t* pending_alarms_front(void) {
+  if (alarm_wheel) {
+    timer_wheel_node_t* node = timer_wheel_earliest(alarm_wheel);
+    if (node == NULL) return NULL;
+    return reinterpret_cast<alarm_wheel_entry_t*>(node)->alarm;
+  }
+  if (list_is_empty(alarms)) return NULL;
+  return static_cast<alarm_t*>(list_front(alarms));
+}
+
+// NOTE: must be called with |alarms_mutex| held
+static void pending_alarms_add(alarm_t* alarm) {
+  if (alarm_wheel) {
+    timer_wheel_insert(alarm_wheel, &alarm->wheel_entry.node,
+                       alarm->deadline_ms);
+    return;
+  }
+
   // Add it into the timer list sorted by deadline (earliest deadline first).
   if (list_is_empty(alarms) ||
       ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
@@ -440,13 +498,54 @@ static void schedule_next_instance(alarm_t* alarm) {
       }
     }
   }
+}
 
-  // If the new alarm has the earliest deadline, we need to re-evaluate our
-  // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
-    reschedule_root_alarm();
+// NOTE: must be called with |alarms_mutex| held
+static void pending_alarms_remove(alarm_t* alarm) {
+  if (alarm_wheel) {
+    timer_wheel_remove(alarm_wheel, &alarm->wheel_entry.node);
+    return;
   }
+  list_remove(alarms, alarm);
+}
+
+static bool collect_wheel_alarm(timer_wheel_node_t* node, void* context) {
+  static_cast<std::vector<alarm_t*>*>(context)->push_back(
+      reinterpret_cast<alarm_wheel_entry_t*>(node)->alarm);
+  return true;
+}
+
+// Returns the pending alarms sorted by deadline.
+// NOTE: must be called with |alarms_mutex| held
+static std::vector<alarm_t*> pending_alarms_snapshot(void) {
+  std::vector<alarm_t*> snapshot;
+  if (alarm_wheel) {
+    snapshot.reserve(timer_wheel_size(alarm_wheel));
+    timer_wheel_foreach(alarm_wheel, collect_wheel_alarm, &snapshot);
+    std::stable_sort(snapshot.begin(), snapshot.end(),
+                     [](const alarm_t* a, const alarm_t* b) {
+                       return a->deadline_ms < b->deadline_ms;
+                     });
+    return snapshot;
+  }
+
+  snapshot.reserve(list_length(alarms));
+  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
+       node = list_next(node)) {
+    snapshot.push_back(static_cast<alarm_t*>(list_node(node)));
+  }
+  return snapshot;
+}
+
+// Re-arms the root timer only when the earliest deadline differs from the
+// one it is currently armed for, which saves the timer syscalls for the
+// common case of setting or canceling an alarm that is not the next one due.
+// NOTE: must be called with |alarms_mutex| held
+static void reschedule_root_alarm_if_needed(void) {
+  alarm_t* next = pending_alarms_front();
+  uint64_t next_deadline_ms = next ? next->deadline_ms : 0;
+  if (next_deadline_ms == armed_deadline_ms) return;
+  reschedule_root_alarm();
 }
 
 // NOTE: must be called with |alarms_mutex| held
@@ -454,16 +553,17 @@ static void reschedule_root_alarm(void) {
   log::assert_that(alarms != NULL, "assert failed: alarms != NULL");
 
   const bool timer_was_set = timer_set;
-  alarm_t* next;
+  alarm_t* next = pending_alarms_front();
   int64_t next_expiration;
 
   // If used in a zeroed state, disarms the timer.
   struct itimerspec timer_time;
   memset(&timer_time, 0, sizeof(timer_time));
 
-  if (list_is_empty(alarms)) goto done;
+  armed_deadline_ms = 0;
+  if (next == NULL) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
+  armed_deadline_ms = next->deadline_ms;
   next_expiration = next->deadline_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
@@ -613,19 +713,19 @@ static void callback_dispatch(void* /* context */) {
     if (!dispatcher_thread_active) break;
 
     std::lock_guard<std::mutex> lock(alarms_mutex);
-    alarm_t* alarm;
+    uint64_t just_now_ms = now_ms();
+    if (alarm_wheel) timer_wheel_advance(alarm_wheel, just_now_ms);
 
     // Take into account that the alarm may get cancelled before we get to it.
     // We're done here if there are no alarms or the alarm at the front is in
     // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
+    alarm_t* alarm = pending_alarms_front();
+    if (alarm == NULL || alarm->deadline_ms > just_now_ms) {
       reschedule_root_alarm();
       continue;
     }
 
-    list_remove(alarms, alarm);
+    pending_alarms_remove(alarm);
 
     if (alarm->is_periodic) {
       alarm->prev_deadline_ms = alarm->deadline_ms;
@@ -723,12 +823,12 @@ void alarm_debug_dump(int fd) {
 
   uint64_t just_now_ms = now_ms();
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  std::vector<alarm_t*> pending = pending_alarms_snapshot();
+  dprintf(fd, "  Timer backend: %s\n", alarm_wheel ? "wheel" : "list");
+  dprintf(fd, "  Total Alarms: %zu\n\n", pending.size());
 
   // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
+  for (alarm_t* alarm : pending) {
     alarm_stats_t* stats = &alarm->stats;
 
     dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
@@ -18,11 +18,185 @@
 #include "osi/include/allocator.h"
 
 #include <bluetooth/log.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "osi/include/buffer_pool.h"
+#include "osi/include/properties.h"
+
 using namespace bluetooth;
 
+namespace {
+
+constexpr char kAccountingProperty[] = "bluetooth.osi.alloc_accounting.enabled";
+constexpr char kUntaggedTag[] = "untagged";
+constexpr char kOtherTags[] = "other";
+
+// The tags are kept in an open addressed table, the last slot collects the
+// allocations of the tags past its capacity.
+constexpr size_t kMaxTags = 128;
+// The live buffers are spread over shards, each with its own lock, to keep the
+// threads allocating concurrently from contending.
+constexpr size_t kNumShards = 16;
+
+struct TagCounters {
+  std::atomic<const char*> tag{nullptr};
+  std::atomic<size_t> live_bytes{0};
+  std::atomic<size_t> live_buffers{0};
+  std::atomic<size_t> high_water_bytes{0};
+  std::atomic<uint64_t> allocations{0};
+};
+
+struct LiveBuffer {
+  TagCounters* counters;
+  size_t size;
+};
+
+struct Shard {
+  std::mutex mutex;
+  std::unordered_map<const void*, LiveBuffer> buffers;
+};
+
+class Accounting {
+ public:
+  void Add(const void* ptr, size_t size, const char* tag) {
+    TagCounters* counters = Find(tag, true);
+    Shard& shard = ShardOf(ptr);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.buffers[ptr] = {counters, size};
+    }
+
+    counters->allocations.fetch_add(1, std::memory_order_relaxed);
+    counters->live_buffers.fetch_add(1, std::memory_order_relaxed);
+    size_t live =
+        counters->live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t high_water =
+        counters->high_water_bytes.load(std::memory_order_relaxed);
+    while (live > high_water &&
+           !counters->high_water_bytes.compare_exchange_weak(
+               high_water, live, std::memory_order_relaxed)) {
+    }
+  }
+
+  // Buffers allocated before the accounting was enabled are not found
+  void Remove(const void* ptr) {
+    LiveBuffer buffer;
+    Shard& shard = ShardOf(ptr);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.buffers.find(ptr);
+      if (it == shard.buffers.end()) return;
+      buffer = it->second;
+      shard.buffers.erase(it);
+    }
+    buffer.counters->live_buffers.fetch_sub(1, std::memory_order_relaxed);
+    buffer.counters->live_bytes.fetch_sub(buffer.size,
+                                          std::memory_order_relaxed);
+  }
+
+  // Returns the counters of |tag|, nullptr if it was never seen and |insert|
+  // is false
+  TagCounters* Find(const char* tag, bool insert) {
+    size_t index = Hash(tag) % (kMaxTags - 1);
+    for (size_t probe = 0; probe < kMaxTags - 1; probe++) {
+      TagCounters& counters = tags_[(index + probe) % (kMaxTags - 1)];
+      const char* slot_tag = counters.tag.load(std::memory_order_acquire);
+      if (slot_tag == nullptr) {
+        if (!insert) return nullptr;
+        if (counters.tag.compare_exchange_strong(slot_tag, tag,
+                                                 std::memory_order_acq_rel)) {
+          return &counters;
+        }
+      }
+      // The same tag may be a different literal in each source file
+      if (slot_tag == tag || strcmp(slot_tag, tag) == 0) return &counters;
+    }
+    if (!insert && strcmp(tag, kOtherTags) != 0) return nullptr;
+    tags_[kMaxTags - 1].tag.store(kOtherTags, std::memory_order_relaxed);
+    return &tags_[kMaxTags - 1];
+  }
+
+  std::vector<TagCounters*> GetTags() {
+    std::vector<TagCounters*> tags;
+    for (auto& counters : tags_) {
+      if (counters.tag.load(std::memory_order_acquire) != nullptr) {
+        tags.push_back(&counters);
+      }
+    }
+    return tags;
+  }
+
+  // Forget the live buffers and the counters, the tags stay allocated
+  void Reset() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.buffers.clear();
+    }
+    for (auto& counters : tags_) {
+      counters.live_bytes = 0;
+      counters.live_buffers = 0;
+      counters.high_water_bytes = 0;
+      counters.allocations = 0;
+    }
+  }
+
+ private:
+  static size_t Hash(const char* tag) {
+    size_t hash = 5381;
+    for (const char* c = tag; *c != '\0'; c++) {
+      hash = hash * 33 + static_cast<unsigned char>(*c);
+    }
+    return hash;
+  }
+
+  Shard& ShardOf(const void* ptr) {
+    // The low bits are the same for every buffer, given the malloc alignment
+    return shards_[(reinterpret_cast<uintptr_t>(ptr) >> 4) % kNumShards];
+  }
+
+  TagCounters tags_[kMaxTags];
+  Shard shards_[kNumShards];
+};
+
+enum AccountingState : int {
+  kAccountingUnknown = -1,
+  kAccountingDisabled = 0,
+  kAccountingEnabled = 1,
+};
+
+std::atomic<int> accounting_state{kAccountingUnknown};
+
+// The property is read on the first allocation
+bool AccountingEnabled() {
+  int state = accounting_state.load(std::memory_order_relaxed);
+  if (state == kAccountingUnknown) {
+    int enabled = osi_property_get_bool(kAccountingProperty, false)
+                      ? kAccountingEnabled
+                      : kAccountingDisabled;
+    if (accounting_state.compare_exchange_strong(state, enabled,
+                                                 std::memory_order_relaxed)) {
+      state = enabled;
+    }
+  }
+  return state == kAccountingEnabled;
+}
+
+Accounting& GetAccounting() {
+  // Never destroyed, buffers may still be freed while the process exits
+  static Accounting* accounting = new Accounting();
+  return *accounting;
+}
+
+}  // namespace
+
 char* osi_strdup(const char* str) {
   size_t size = strlen(str) + 1;  // + 1 for the null terminator
   char* new_string = (char*)malloc(size);
@@ -50,23 +224,36 @@ char* osi_strndup(const char* str, size_t len) {
   return new_string;
 }
 
-void* osi_malloc(size_t size) {
+void* osi_malloc(size_t size) { return osi_malloc_tagged(size, kUntaggedTag); }
+
+void* osi_calloc(size_t size) { return osi_calloc_tagged(size, kUntaggedTag); }
+
+void* osi_malloc_tagged(size_t size, const char* tag) {
   log::assert_that(static_cast<ssize_t>(size) >= 0,
                    "assert failed: static_cast<ssize_t>(size) >= 0");
   void* ptr = malloc(size);
   log::assert_that(ptr != nullptr, "assert failed: ptr != nullptr");
+  if (AccountingEnabled()) GetAccounting().Add(ptr, size, tag);
   return ptr;
 }
 
-void* osi_calloc(size_t size) {
+void* osi_calloc_tagged(size_t size, const char* tag) {
   log::assert_that(static_cast<ssize_t>(size) >= 0,
                    "assert failed: static_cast<ssize_t>(size) >= 0");
   void* ptr = calloc(1, size);
   log::assert_that(ptr != nullptr, "assert failed: ptr != nullptr");
+  if (AccountingEnabled()) GetAccounting().Add(ptr, size, tag);
   return ptr;
 }
 
-void osi_free(void* ptr) { free(ptr); }
+void osi_free(void* ptr) {
+  if (buffer_pool_owns(ptr)) {
+    buffer_pool_free(ptr);
+    return;
+  }
+  if (ptr != nullptr && AccountingEnabled()) GetAccounting().Remove(ptr);
+  free(ptr);
+}
 
 void osi_free_and_reset(void** p_ptr) {
   log::assert_that(p_ptr != NULL, "assert failed: p_ptr != NULL");
@@ -74,6 +261,52 @@ void osi_free_and_reset(void** p_ptr) {
   *p_ptr = NULL;
 }
 
+void osi_alloc_accounting_set_enabled(bool enabled) {
+  if (!enabled) GetAccounting().Reset();
+  accounting_state.store(enabled ? kAccountingEnabled : kAccountingDisabled,
+                         std::memory_order_relaxed);
+}
+
+bool osi_alloc_accounting_get_stats(const char* tag,
+                                    osi_alloc_tag_stats_t* stats) {
+  log::assert_that(stats != nullptr, "assert failed: stats != nullptr");
+  if (!AccountingEnabled()) return false;
+  TagCounters* counters = GetAccounting().Find(tag, false);
+  if (counters == nullptr) return false;
+
+  stats->live_bytes = counters->live_bytes.load(std::memory_order_relaxed);
+  stats->live_buffers = counters->live_buffers.load(std::memory_order_relaxed);
+  stats->high_water_bytes =
+      counters->high_water_bytes.load(std::memory_order_relaxed);
+  stats->allocations = counters->allocations.load(std::memory_order_relaxed);
+  return true;
+}
+
+void osi_alloc_accounting_dump(int fd) {
+  dprintf(fd, "\nBluetooth Allocation Accounting:\n");
+  bool enabled = AccountingEnabled();
+  dprintf(fd, "  Accounting enabled             : %s\n",
+          enabled ? "true" : "false");
+  if (!enabled) return;
+
+  std::vector<TagCounters*> tags = GetAccounting().GetTags();
+  std::sort(tags.begin(), tags.end(), [](TagCounters* a, TagCounters* b) {
+    return a->live_bytes.load(std::memory_order_relaxed) >
+           b->live_bytes.load(std::memory_order_relaxed);
+  });
+  dprintf(fd, "  %-20s %12s %12s %12s %12s\n", "tag", "live_bytes",
+          "live_buffers", "high_water", "allocations");
+  for (TagCounters* counters : tags) {
+    dprintf(fd, "  %-20s %12zu %12zu %12zu %12llu\n",
+            counters->tag.load(std::memory_order_relaxed),
+            counters->live_bytes.load(std::memory_order_relaxed),
+            counters->live_buffers.load(std::memory_order_relaxed),
+            counters->high_water_bytes.load(std::memory_order_relaxed),
+            (unsigned long long)counters->allocations.load(
+                std::memory_order_relaxed));
+  }
+}
+
 const allocator_t allocator_calloc = {osi_calloc, osi_free};
 
 const allocator_t allocator_malloc = {osi_malloc, osi_free};
@@ -0,0 +1,302 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_buffer_pool"
+
+#include "osi/include/buffer_pool.h"
+
+#include <bluetooth/log.h>
+#include <stdio.h>
+#include <sys/mman.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+using namespace bluetooth;
+
+namespace {
+
+struct SizeClass {
+  size_t block_size;
+  uint32_t capacity;
+};
+
+// The largest class covers BT_DEFAULT_BUFFER_SIZE (4096 + 16) plus the
+// BT_HDR header and the offsets reserved by the lower layers.
+constexpr std::array<SizeClass, 6> kSizeClasses = {{
+    {128, 512},
+    {256, 512},
+    {512, 256},
+    {1024, 256},
+    {2048, 128},
+    {4608, 256},
+}};
+constexpr size_t kNumClasses = kSizeClasses.size();
+
+// Number of blocks a thread keeps per class before it gives half of them
+// back to the global free list.
+constexpr size_t kThreadCacheSize = 32;
+
+constexpr uint32_t kEmpty = UINT32_MAX;
+
+// Global per class state. The free list head packs a generation tag in the
+// upper 32 bits and a block index in the lower 32 bits to avoid ABA.
+struct ClassState {
+  uint8_t* base{nullptr};
+  std::unique_ptr<std::atomic<uint32_t>[]> next;
+  std::atomic<uint64_t> free_head{kEmpty};
+  std::atomic<uint32_t> carved{0};
+
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<size_t> in_use{0};
+  std::atomic<size_t> high_water{0};
+};
+
+class Arena {
+ public:
+  Arena() {
+    size_t total = 0;
+    for (const auto& size_class : kSizeClasses) {
+      total += size_class.block_size * size_class.capacity;
+    }
+
+    // Pages are only committed once a block is first handed out.
+    void* mem = mmap(nullptr, total, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) {
+      log::error("unable to reserve {} bytes, pool disabled", total);
+      return;
+    }
+
+    begin_ = static_cast<uint8_t*>(mem);
+    end_ = begin_ + total;
+
+    uint8_t* region = begin_;
+    for (size_t i = 0; i < kNumClasses; i++) {
+      classes_[i].base = region;
+      classes_[i].next =
+          std::make_unique<std::atomic<uint32_t>[]>(kSizeClasses[i].capacity);
+      region += kSizeClasses[i].block_size * kSizeClasses[i].capacity;
+    }
+  }
+
+  bool Owns(const void* ptr) const {
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    return p >= begin_ && p < end_;
+  }
+
+  size_t ClassOf(const void* ptr) const {
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    size_t index = kNumClasses - 1;
+    while (index > 0 && p < classes_[index].base) index--;
+    return index;
+  }
+
+  uint32_t IndexOf(size_t cls, const void* ptr) const {
+    return static_cast<uint32_t>(
+        (static_cast<const uint8_t*>(ptr) - classes_[cls].base) /
+        kSizeClasses[cls].block_size);
+  }
+
+  void* BlockAt(size_t cls, uint32_t index) const {
+    return classes_[cls].base + size_t{index} * kSizeClasses[cls].block_size;
+  }
+
+  // Takes a block index from the global free list, or carves a fresh one.
+  uint32_t Pop(size_t cls) {
+    ClassState& state = classes_[cls];
+    uint64_t head = state.free_head.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(head) != kEmpty) {
+      uint32_t index = static_cast<uint32_t>(head);
+      uint64_t next = state.next[index].load(std::memory_order_relaxed);
+      uint64_t desired = (((head >> 32) + 1) << 32) | next;
+      if (state.free_head.compare_exchange_weak(head, desired,
+                                                std::memory_order_acquire,
+                                                std::memory_order_acquire)) {
+        return index;
+      }
+    }
+
+    if (state.carved.load(std::memory_order_relaxed) >=
+        kSizeClasses[cls].capacity) {
+      return kEmpty;
+    }
+    uint32_t index = state.carved.fetch_add(1, std::memory_order_relaxed);
+    if (index >= kSizeClasses[cls].capacity) {
+      return kEmpty;
+    }
+    return index;
+  }
+
+  void Push(size_t cls, uint32_t index) {
+    ClassState& state = classes_[cls];
+    uint64_t head = state.free_head.load(std::memory_order_relaxed);
+    uint64_t desired;
+    do {
+      state.next[index].store(static_cast<uint32_t>(head),
+                              std::memory_order_relaxed);
+      desired = (((head >> 32) + 1) << 32) | index;
+    } while (!state.free_head.compare_exchange_weak(
+        head, desired, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  bool enabled() const { return begin_ != nullptr; }
+
+  ClassState& state(size_t cls) { return classes_[cls]; }
+
+ private:
+  uint8_t* begin_{nullptr};
+  uint8_t* end_{nullptr};
+  std::array<ClassState, kNumClasses> classes_;
+};
+
+// Created on the first pool allocation so that processes that only ever go
+// through |osi_free| do not pay for the reservation. Intentionally leaked:
+// blocks may still be released by threads that outlive static destruction.
+std::atomic<Arena*> arena_instance{nullptr};
+
+Arena& GetArena() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    arena_instance.store(new Arena(), std::memory_order_release);
+  });
+  return *arena_instance.load(std::memory_order_relaxed);
+}
+
+struct ThreadCache {
+  std::array<std::array<uint32_t, kThreadCacheSize>, kNumClasses> blocks;
+  std::array<size_t, kNumClasses> count{};
+
+  ~ThreadCache() {
+    Arena* arena = arena_instance.load(std::memory_order_acquire);
+    if (arena == nullptr) return;
+    for (size_t cls = 0; cls < kNumClasses; cls++) {
+      while (count[cls] > 0) arena->Push(cls, blocks[cls][--count[cls]]);
+    }
+  }
+};
+
+thread_local ThreadCache thread_cache;
+
+size_t ClassForSize(size_t size) {
+  for (size_t i = 0; i < kNumClasses; i++) {
+    if (size <= kSizeClasses[i].block_size) return i;
+  }
+  return kNumClasses;
+}
+
+void UpdateHighWater(ClassState& state, size_t in_use) {
+  size_t current = state.high_water.load(std::memory_order_relaxed);
+  while (in_use > current &&
+         !state.high_water.compare_exchange_weak(current, in_use,
+                                                 std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+void* buffer_pool_alloc(size_t size) {
+  Arena& arena = GetArena();
+  size_t cls = ClassForSize(size);
+  if (cls == kNumClasses || !arena.enabled()) {
+    return osi_malloc(size);
+  }
+
+  ClassState& state = arena.state(cls);
+  uint32_t index;
+  if (thread_cache.count[cls] > 0) {
+    index = thread_cache.blocks[cls][--thread_cache.count[cls]];
+  } else {
+    index = arena.Pop(cls);
+  }
+
+  if (index == kEmpty) {
+    state.misses.fetch_add(1, std::memory_order_relaxed);
+    return osi_malloc(size);
+  }
+
+  state.hits.fetch_add(1, std::memory_order_relaxed);
+  UpdateHighWater(state,
+                  state.in_use.fetch_add(1, std::memory_order_relaxed) + 1);
+  return arena.BlockAt(cls, index);
+}
+
+void buffer_pool_free(void* ptr) {
+  if (ptr == nullptr) return;
+
+  Arena* arena_ptr = arena_instance.load(std::memory_order_acquire);
+  if (arena_ptr == nullptr || !arena_ptr->Owns(ptr)) {
+    osi_free(ptr);
+    return;
+  }
+
+  Arena& arena = *arena_ptr;
+
+  size_t cls = arena.ClassOf(ptr);
+  uint32_t index = arena.IndexOf(cls, ptr);
+  arena.state(cls).in_use.fetch_sub(1, std::memory_order_relaxed);
+
+  auto& blocks = thread_cache.blocks[cls];
+  size_t& count = thread_cache.count[cls];
+  if (count == kThreadCacheSize) {
+    while (count > kThreadCacheSize / 2) arena.Push(cls, blocks[--count]);
+  }
+  blocks[count++] = index;
+}
+
+bool buffer_pool_owns(const void* ptr) {
+  Arena* arena = arena_instance.load(std::memory_order_acquire);
+  return ptr != nullptr && arena != nullptr && arena->Owns(ptr);
+}
+
+size_t buffer_pool_class_count(void) { return kNumClasses; }
+
+bool buffer_pool_get_class_stats(size_t index,
+                                 buffer_pool_class_stats_t* stats) {
+  log::assert_that(stats != nullptr, "assert failed: stats != nullptr");
+  if (index >= kNumClasses) return false;
+
+  ClassState& state = GetArena().state(index);
+  stats->block_size = kSizeClasses[index].block_size;
+  stats->capacity = kSizeClasses[index].capacity;
+  stats->hits = state.hits.load(std::memory_order_relaxed);
+  stats->misses = state.misses.load(std::memory_order_relaxed);
+  stats->in_use = state.in_use.load(std::memory_order_relaxed);
+  stats->high_water = state.high_water.load(std::memory_order_relaxed);
+  return true;
+}
+
+void buffer_pool_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Buffer Pool Statistics:\n");
+  dprintf(fd, "  Pool enabled                   : %s\n",
+          GetArena().enabled() ? "true" : "false");
+  dprintf(fd, "  %10s %8s %12s %12s %8s %10s\n", "block_size", "capacity",
+          "hits", "misses", "in_use", "high_water");
+  for (size_t i = 0; i < kNumClasses; i++) {
+    buffer_pool_class_stats_t stats;
+    buffer_pool_get_class_stats(i, &stats);
+    dprintf(fd, "  %10zu %8zu %12llu %12llu %8zu %10zu\n", stats.block_size,
+            stats.capacity, (unsigned long long)stats.hits,
+            (unsigned long long)stats.misses, stats.in_use, stats.high_water);
+  }
+}
+
+const allocator_t allocator_buffer_pool = {buffer_pool_alloc, osi_free};
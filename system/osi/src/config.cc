@@ -30,26 +30,23 @@
 
 #include <cerrno>
 #include <sstream>
-#include <type_traits>
+#include <string_view>
 
 using namespace bluetooth;
 
 void section_t::Set(std::string key, std::string value) {
-  for (entry_t& entry : entries) {
-    if (entry.key == key) {
-      entry.value = value;
-      return;
-    }
+  auto entry = entry_index.Find(entries, key);
+  if (entry != entries.end()) {
+    entry->value = std::move(value);
+    return;
   }
   // add a new key to the section
-  entries.emplace_back(
-      entry_t{.key = std::move(key), .value = std::move(value)});
+  entry_index.Append(
+      entries, entry_t{.key = std::move(key), .value = std::move(value)});
 }
 
 std::list<entry_t>::iterator section_t::Find(const std::string& key) {
-  return std::find_if(
-      entries.begin(), entries.end(),
-      [&key](const entry_t& entry) { return entry.key == key; });
+  return entry_index.Find(entries, key);
 }
 
 bool section_t::Has(const std::string& key) {
@@ -57,9 +54,7 @@ bool section_t::Has(const std::string& key) {
 }
 
 std::list<section_t>::iterator config_t::Find(const std::string& section) {
-  return std::find_if(
-      sections.begin(), sections.end(),
-      [&section](const section_t& sec) { return sec.name == section; });
+  return section_index.Find(sections, section);
 }
 
 bool config_t::Has(const std::string& key) {
@@ -68,26 +63,33 @@ bool config_t::Has(const std::string& key) {
 
 static bool config_parse(FILE* fp, config_t* config);
 
-template <typename T,
-          class = typename std::enable_if<std::is_same<
-              config_t, typename std::remove_const<T>::type>::value>>
-static auto section_find(T& config, const std::string& section) {
-  return std::find_if(
-      config.sections.begin(), config.sections.end(),
-      [&section](const section_t& sec) { return sec.name == section; });
+// The lookups of the const accessors may rebuild the indexes, which are
+// mutable, but never change the lists.
+static section_t* section_find(const config_t& config,
+                               std::string_view section) {
+  auto& sections = const_cast<std::list<section_t>&>(config.sections);
+  auto sec = config.section_index.Find(sections, section);
+  return sec == sections.end() ? nullptr : &*sec;
+}
+
+static section_t* section_find_or_add(config_t* config,
+                                      std::string_view section) {
+  auto sec = config->section_index.Find(config->sections, section);
+  if (sec == config->sections.end()) {
+    sec = config->section_index.Append(config->sections,
+                                       section_t{.name = std::string(section)});
+  }
+  return &*sec;
 }
 
 static const entry_t* entry_find(const config_t& config,
                                  const std::string& section,
                                  const std::string& key) {
-  auto sec = section_find(config, section);
-  if (sec == config.sections.end()) return nullptr;
-
-  for (const entry_t& entry : sec->entries) {
-    if (entry.key == key) return &entry;
-  }
+  section_t* sec = section_find(config, section);
+  if (sec == nullptr) return nullptr;
 
-  return nullptr;
+  auto entry = sec->entry_index.Find(sec->entries, key);
+  return entry == sec->entries.end() ? nullptr : &*entry;
 }
 
 std::unique_ptr<config_t> config_new_empty(void) {
@@ -139,7 +141,7 @@ std::unique_ptr<config_t> config_new_clone(const config_t& src) {
 }
 
 bool config_has_section(const config_t& config, const std::string& section) {
-  return (section_find(config, section) != config.sections.end());
+  return section_find(config, section) != nullptr;
 }
 
 bool config_has_key(const config_t& config, const std::string& section,
@@ -207,55 +209,32 @@ void config_set_string(config_t* config, const std::string& section,
                        const std::string& key, const std::string& value) {
   log::assert_that(config != nullptr, "assert failed: config != nullptr");
 
-  auto sec = section_find(*config, section);
-  if (sec == config->sections.end()) {
-    config->sections.emplace_back(section_t{.name = section});
-    sec = std::prev(config->sections.end());
-  }
-
-  std::string value_no_newline;
   size_t newline_position = value.find('\n');
-  if (newline_position != std::string::npos) {
-    value_no_newline = value.substr(0, newline_position);
-  } else {
-    value_no_newline = value;
-  }
-
-  for (entry_t& entry : sec->entries) {
-    if (entry.key == key) {
-      entry.value = value_no_newline;
-      return;
-    }
-  }
-
-  sec->entries.emplace_back(entry_t{.key = key, .value = value_no_newline});
+  section_find_or_add(config, section)
+      ->Set(key, value.substr(0, newline_position));
 }
 
 bool config_remove_section(config_t* config, const std::string& section) {
   log::assert_that(config != nullptr, "assert failed: config != nullptr");
 
-  auto sec = section_find(*config, section);
+  auto sec = config->Find(section);
   if (sec == config->sections.end()) return false;
 
-  config->sections.erase(sec);
+  config->section_index.Erase(config->sections, sec);
   return true;
 }
 
 bool config_remove_key(config_t* config, const std::string& section,
                        const std::string& key) {
   log::assert_that(config != nullptr, "assert failed: config != nullptr");
-  auto sec = section_find(*config, section);
+  auto sec = config->Find(section);
   if (sec == config->sections.end()) return false;
 
-  for (auto entry = sec->entries.begin(); entry != sec->entries.end();
-       ++entry) {
-    if (entry->key == key) {
-      sec->entries.erase(entry);
-      return true;
-    }
-  }
+  auto entry = sec->Find(key);
+  if (entry == sec->entries.end()) return false;
 
-  return false;
+  sec->entry_index.Erase(sec->entries, entry);
+  return true;
 }
 
 bool config_save(const config_t& config, const std::string& filename) {
@@ -462,15 +441,11 @@ error2:
   return false;
 }
 
-static char* trim(char* str) {
-  while (isspace(*str)) ++str;
-
-  if (!*str) return str;
-
-  char* end_str = str + strlen(str) - 1;
-  while (end_str > str && isspace(*end_str)) --end_str;
-
-  end_str[1] = '\0';
+static std::string_view trim(std::string_view str) {
+  while (!str.empty() && isspace(static_cast<unsigned char>(str.front())))
+    str.remove_prefix(1);
+  while (!str.empty() && isspace(static_cast<unsigned char>(str.back())))
+    str.remove_suffix(1);
   return str;
 }
 
@@ -478,35 +453,57 @@ static bool config_parse(FILE* fp, config_t* config) {
   log::assert_that(fp != nullptr, "assert failed: fp != nullptr");
   log::assert_that(config != nullptr, "assert failed: config != nullptr");
 
-  int line_num = 0;
-  char line[4096];
-  char section[4096];
-  strcpy(section, CONFIG_DEFAULT_SECTION);
+  // Read the whole file at once, lines are then split without copies.
+  std::string content;
+  struct stat st;
+  if (fstat(fileno(fp), &st) == 0 && st.st_size > 0) {
+    content.reserve(st.st_size);
+  }
+  char buffer[4096];
+  size_t read_len;
+  while ((read_len = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+    content.append(buffer, read_len);
+  }
 
-  while (fgets(line, sizeof(line), fp)) {
-    char* line_ptr = trim(line);
+  int line_num = 0;
+  std::string_view section_name = CONFIG_DEFAULT_SECTION;
+  // Created with its first key, empty sections are not kept.
+  section_t* section = nullptr;
+
+  std::string_view remaining = content;
+  while (!remaining.empty()) {
+    size_t line_end = remaining.find('\n');
+    std::string_view line = remaining.substr(0, line_end);
+    remaining.remove_prefix(line_end == std::string_view::npos
+                                ? remaining.size()
+                                : line_end + 1);
     ++line_num;
 
+    // As with C strings, a line ends at its first null character.
+    line = trim(line.substr(0, line.find('\0')));
+
     // Skip blank and comment lines.
-    if (*line_ptr == '\0' || *line_ptr == '#') continue;
+    if (line.empty() || line.front() == '#') continue;
 
-    if (*line_ptr == '[') {
-      size_t len = strlen(line_ptr);
-      if (line_ptr[len - 1] != ']') {
+    if (line.front() == '[') {
+      if (line.size() < 2 || line.back() != ']') {
         log::verbose("unterminated section name on line {}", line_num);
         return false;
       }
-      strncpy(section, line_ptr + 1, len - 2);  // NOLINT (len < 4096)
-      section[len - 2] = '\0';
+      section_name = line.substr(1, line.size() - 2);
+      section = nullptr;
     } else {
-      char* split = strchr(line_ptr, '=');
-      if (!split) {
+      size_t split = line.find('=');
+      if (split == std::string_view::npos) {
         log::verbose("no key/value separator found on line {}", line_num);
         return false;
       }
 
-      *split = '\0';
-      config_set_string(config, section, trim(line_ptr), trim(split + 1));
+      if (section == nullptr) {
+        section = section_find_or_add(config, section_name);
+      }
+      section->Set(std::string(trim(line.substr(0, split))),
+                   std::string(trim(line.substr(split + 1))));
     }
   }
   return true;
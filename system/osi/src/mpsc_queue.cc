@@ -0,0 +1,254 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_osi_mpsc_queue"
+
+#include "osi/include/mpsc_queue.h"
+
+#include <bluetooth/log.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "osi/include/osi.h"
+#include "osi/include/reactor.h"
+
+using namespace bluetooth;
+
+// Elements handed to the ready callback before the reactor gets to serve its
+// other objects again.
+static const size_t MAX_DEQUEUES_PER_WAKEUP = 16;
+
+// Slot of the ring. |sequence| is the position of the element the slot holds
+// plus one once it has been published, or the position of the next element
+// to be stored in it while it is free.
+typedef struct {
+  std::atomic<size_t> sequence;
+  void* data;
+} mpsc_queue_slot_t;
+
+struct mpsc_queue_t {
+  mpsc_queue_slot_t* slots;
+  size_t mask;
+  size_t capacity;
+
+  // Position of the next element to enqueue, shared by the producers.
+  alignas(64) std::atomic<size_t> enqueue_pos;
+  // Position of the next element to dequeue, only written by the consumer.
+  alignas(64) std::atomic<size_t> dequeue_pos;
+  // Set by the consumer when it found the queue empty, cleared by the first
+  // producer publishing an element after that, which signals |ready_fd|.
+  alignas(64) std::atomic<bool> consumer_waiting;
+
+  // Readable when the queue went from empty to non-empty.
+  int ready_fd;
+  reactor_object_t* dequeue_object;
+  mpsc_queue_cb dequeue_ready;
+  void* dequeue_context;
+};
+
+static void internal_dequeue_ready(void* context);
+
+// Marks the consumer as waiting for an element. Returns false, and clears
+// the mark, if an element was published in the meantime.
+static bool consumer_wait(mpsc_queue_t* queue) {
+  queue->consumer_waiting.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (mpsc_queue_is_empty(queue)) return true;
+  queue->consumer_waiting.store(false, std::memory_order_relaxed);
+  return false;
+}
+
+static void signal_ready(mpsc_queue_t* queue) {
+  if (eventfd_write(queue->ready_fd, 1ULL) == -1)
+    log::error("unable to signal queue: {}", strerror(errno));
+}
+
+mpsc_queue_t* mpsc_queue_new(size_t capacity) {
+  size_t num_slots = 1;
+  while (num_slots < capacity) num_slots <<= 1;
+
+  mpsc_queue_t* ret = new mpsc_queue_t();
+  ret->slots = new mpsc_queue_slot_t[num_slots];
+  ret->mask = num_slots - 1;
+  ret->capacity = capacity;
+  ret->consumer_waiting.store(true, std::memory_order_relaxed);
+  for (size_t i = 0; i < num_slots; i++) {
+    ret->slots[i].sequence.store(i, std::memory_order_relaxed);
+    ret->slots[i].data = NULL;
+  }
+
+  ret->ready_fd = eventfd(0, EFD_NONBLOCK);
+  if (ret->ready_fd == INVALID_FD) {
+    log::error("unable to allocate queue eventfd: {}", strerror(errno));
+    delete[] ret->slots;
+    delete ret;
+    return NULL;
+  }
+  return ret;
+}
+
+void mpsc_queue_free(mpsc_queue_t* queue, mpsc_queue_free_cb free_cb) {
+  if (!queue) return;
+
+  mpsc_queue_unregister_dequeue(queue);
+  mpsc_queue_flush(queue, free_cb);
+
+  close(queue->ready_fd);
+  delete[] queue->slots;
+  delete queue;
+}
+
+void mpsc_queue_flush(mpsc_queue_t* queue, mpsc_queue_free_cb free_cb) {
+  if (!queue) return;
+
+  void* data;
+  while ((data = mpsc_queue_try_dequeue(queue)) != NULL) {
+    if (free_cb != NULL) free_cb(data);
+  }
+}
+
+bool mpsc_queue_is_empty(mpsc_queue_t* queue) {
+  return mpsc_queue_try_peek_first(queue) == NULL;
+}
+
+size_t mpsc_queue_length(mpsc_queue_t* queue) {
+  if (queue == NULL) return 0;
+
+  // Counts the elements being enqueued, not yet visible to the consumer.
+  size_t dequeue_pos = queue->dequeue_pos.load(std::memory_order_acquire);
+  return queue->enqueue_pos.load(std::memory_order_acquire) - dequeue_pos;
+}
+
+size_t mpsc_queue_capacity(mpsc_queue_t* queue) {
+  log::assert_that(queue != NULL, "assert failed: queue != NULL");
+
+  return queue->capacity;
+}
+
+bool mpsc_queue_try_enqueue(mpsc_queue_t* queue, void* data) {
+  log::assert_that(queue != NULL, "assert failed: queue != NULL");
+  log::assert_that(data != NULL, "assert failed: data != NULL");
+
+  // Claim a position whose slot has been released by the consumer.
+  size_t pos = queue->enqueue_pos.load(std::memory_order_relaxed);
+  mpsc_queue_slot_t* slot;
+  for (;;) {
+    slot = &queue->slots[pos & queue->mask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    intptr_t diff =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (pos - queue->dequeue_pos.load(std::memory_order_acquire) >=
+          queue->capacity)
+        return false;
+      if (queue->enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                   std::memory_order_relaxed))
+        break;
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = queue->enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->data = data;
+  slot->sequence.store(pos + 1, std::memory_order_release);
+
+  // Only wake up the consumer if it is waiting for an element. Pairs with
+  // the fence of |consumer_wait|: either the consumer sees this element when
+  // checking the queue again, or this sees the consumer waiting.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (queue->consumer_waiting.load(std::memory_order_relaxed) &&
+      queue->consumer_waiting.exchange(false, std::memory_order_relaxed))
+    signal_ready(queue);
+  return true;
+}
+
+void* mpsc_queue_try_dequeue(mpsc_queue_t* queue) {
+  if (queue == NULL) return NULL;
+
+  size_t pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+  mpsc_queue_slot_t* slot = &queue->slots[pos & queue->mask];
+  if (slot->sequence.load(std::memory_order_acquire) != pos + 1) return NULL;
+
+  void* data = slot->data;
+  slot->data = NULL;
+  slot->sequence.store(pos + queue->mask + 1, std::memory_order_release);
+  queue->dequeue_pos.store(pos + 1, std::memory_order_release);
+  return data;
+}
+
+void* mpsc_queue_try_peek_first(mpsc_queue_t* queue) {
+  if (queue == NULL) return NULL;
+
+  size_t pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+  mpsc_queue_slot_t* slot = &queue->slots[pos & queue->mask];
+  if (slot->sequence.load(std::memory_order_acquire) != pos + 1) return NULL;
+  return slot->data;
+}
+
+void mpsc_queue_register_dequeue(mpsc_queue_t* queue, reactor_t* reactor,
+                                 mpsc_queue_cb ready_cb, void* context) {
+  log::assert_that(queue != NULL, "assert failed: queue != NULL");
+  log::assert_that(reactor != NULL, "assert failed: reactor != NULL");
+  log::assert_that(ready_cb != NULL, "assert failed: ready_cb != NULL");
+
+  // Make sure we're not already registered
+  mpsc_queue_unregister_dequeue(queue);
+
+  queue->dequeue_ready = ready_cb;
+  queue->dequeue_context = context;
+  queue->dequeue_object = reactor_register(reactor, queue->ready_fd, queue,
+                                           internal_dequeue_ready, NULL);
+}
+
+void mpsc_queue_unregister_dequeue(mpsc_queue_t* queue) {
+  log::assert_that(queue != NULL, "assert failed: queue != NULL");
+
+  if (queue->dequeue_object) {
+    reactor_unregister(queue->dequeue_object);
+    queue->dequeue_object = NULL;
+  }
+}
+
+static void internal_dequeue_ready(void* context) {
+  log::assert_that(context != NULL, "assert failed: context != NULL");
+
+  mpsc_queue_t* queue = static_cast<mpsc_queue_t*>(context);
+
+  eventfd_t value;
+  eventfd_read(queue->ready_fd, &value);
+
+  for (size_t i = 0;
+       i < MAX_DEQUEUES_PER_WAKEUP && !mpsc_queue_is_empty(queue); i++) {
+    size_t pos = queue->dequeue_pos.load(std::memory_order_relaxed);
+    queue->dequeue_ready(queue, queue->dequeue_context);
+    if (queue->dequeue_pos.load(std::memory_order_relaxed) == pos) break;
+  }
+
+  if (mpsc_queue_is_empty(queue) && consumer_wait(queue)) return;
+
+  // Let the reactor serve its other objects before the rest of the queue. As
+  // with |fixed_queue_t|, the callback is called again while the queue is not
+  // empty, even if it did not dequeue anything.
+  signal_ready(queue);
+}
@@ -20,6 +20,7 @@
 
 #include <bluetooth/log.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "osi/include/allocator.h"
 
@@ -28,11 +29,22 @@ using namespace bluetooth;
 struct ringbuffer_t {
   size_t total;
   size_t available;
+  // |total| - 1 when |total| is a power of two, 0 otherwise
+  size_t mask;
   uint8_t* base;
   uint8_t* head;
   uint8_t* tail;
 };
 
+// Returns the position in the buffer |length| bytes past |position|, which is
+// at most |total|.
+static uint8_t* ringbuffer_advance(const ringbuffer_t* rb, uint8_t* position,
+                                   size_t length) {
+  size_t index = position - rb->base + length;
+  if (rb->mask != 0) return rb->base + (index & rb->mask);
+  return rb->base + (index >= rb->total ? index - rb->total : index);
+}
+
 ringbuffer_t* ringbuffer_init(const size_t size) {
   ringbuffer_t* p =
       static_cast<ringbuffer_t*>(osi_calloc(sizeof(ringbuffer_t)));
@@ -40,10 +52,17 @@ ringbuffer_t* ringbuffer_init(const size_t size) {
   p->base = static_cast<uint8_t*>(osi_calloc(size));
   p->head = p->tail = p->base;
   p->total = p->available = size;
+  if (size > 1 && (size & (size - 1)) == 0) p->mask = size - 1;
 
   return p;
 }
 
+ringbuffer_t* ringbuffer_init_pow2(const size_t size) {
+  size_t total = 1;
+  while (total < size) total <<= 1;
+  return ringbuffer_init(total);
+}
+
 void ringbuffer_free(ringbuffer_t* rb) {
   if (rb != NULL) osi_free(rb->base);
   osi_free(rb);
@@ -65,10 +84,12 @@ size_t ringbuffer_insert(ringbuffer_t* rb, const uint8_t* p, size_t length) {
 
   if (length > ringbuffer_available(rb)) length = ringbuffer_available(rb);
 
-  for (size_t i = 0; i != length; ++i) {
-    *rb->tail++ = *p++;
-    if (rb->tail >= (rb->base + rb->total)) rb->tail = rb->base;
-  }
+  // Copy up to the end of the buffer, then the rest from its start
+  size_t first = rb->base + rb->total - rb->tail;
+  if (first > length) first = length;
+  memcpy(rb->tail, p, first);
+  memcpy(rb->base, p + first, length - first);
+  rb->tail = ringbuffer_advance(rb, rb->tail, length);
 
   rb->available -= length;
   return length;
@@ -79,8 +100,7 @@ size_t ringbuffer_delete(ringbuffer_t* rb, size_t length) {
 
   if (length > ringbuffer_size(rb)) length = ringbuffer_size(rb);
 
-  rb->head += length;
-  if (rb->head >= (rb->base + rb->total)) rb->head -= rb->total;
+  rb->head = ringbuffer_advance(rb, rb->head, length);
 
   rb->available += length;
   return length;
@@ -94,15 +114,15 @@ size_t ringbuffer_peek(const ringbuffer_t* rb, off_t offset, uint8_t* p,
   log::assert_that((size_t)offset <= ringbuffer_size(rb),
                    "assert failed: (size_t)offset <= ringbuffer_size(rb)");
 
-  uint8_t* b = ((rb->head - rb->base + offset) % rb->total) + rb->base;
+  const uint8_t* b = ringbuffer_advance(rb, rb->head, offset);
   const size_t bytes_to_copy = (offset + length > ringbuffer_size(rb))
                                    ? ringbuffer_size(rb) - offset
                                    : length;
 
-  for (size_t copied = 0; copied < bytes_to_copy; ++copied) {
-    *p++ = *b++;
-    if (b >= (rb->base + rb->total)) b = rb->base;
-  }
+  size_t first = rb->base + rb->total - b;
+  if (first > bytes_to_copy) first = bytes_to_copy;
+  memcpy(p, b, first);
+  memcpy(p + first, rb->base, bytes_to_copy - first);
 
   return bytes_to_copy;
 }
@@ -112,9 +132,45 @@ size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length) {
   log::assert_that(p != nullptr, "assert failed: p != nullptr");
 
   const size_t copied = ringbuffer_peek(rb, 0, p, length);
-  rb->head += copied;
-  if (rb->head >= (rb->base + rb->total)) rb->head -= rb->total;
+  rb->head = ringbuffer_advance(rb, rb->head, copied);
 
   rb->available += copied;
   return copied;
 }
+
+// Sets |spans| to the |length| bytes starting at |position|, split at the end
+// of the buffer.
+static void ringbuffer_spans(const ringbuffer_t* rb, uint8_t* position,
+                             size_t length, ringbuffer_span_t spans[2]) {
+  size_t first = rb->base + rb->total - position;
+  if (first > length) first = length;
+  spans[0] = {.data = position, .length = first};
+  spans[1] = {.data = rb->base, .length = length - first};
+}
+
+size_t ringbuffer_read_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+  log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
+  log::assert_that(spans != nullptr, "assert failed: spans != nullptr");
+
+  const size_t size = ringbuffer_size(rb);
+  ringbuffer_spans(rb, rb->head, size, spans);
+  return size;
+}
+
+size_t ringbuffer_write_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+  log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
+  log::assert_that(spans != nullptr, "assert failed: spans != nullptr");
+
+  ringbuffer_spans(rb, rb->tail, rb->available, spans);
+  return rb->available;
+}
+
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  log::assert_that(rb != nullptr, "assert failed: rb != nullptr");
+
+  if (length > ringbuffer_available(rb)) length = ringbuffer_available(rb);
+
+  rb->tail = ringbuffer_advance(rb, rb->tail, length);
+  rb->available -= length;
+  return length;
+}
@@ -14,13 +14,103 @@
  * limitations under the License.
  */
 
+#include "osi/include/thread_scheduler.h"
+
+#include <bluetooth/log.h>
 #include <sched.h>
+#include <stdio.h>
 #include <sys/types.h>
 
+#include <array>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "osi/include/properties.h"
+
+using namespace bluetooth;
+
 namespace {
 constexpr int kRealTimeFifoSchedulingPriority = 1;
+
+constexpr size_t kNumThreadRoles =
+    static_cast<size_t>(ThreadRole::LE_AUDIO_SOURCE) + 1;
+
+struct ThreadPolicy {
+  int priority;
+  std::vector<uint32_t> cpus;
+};
+
+ThreadPolicy get_thread_policy(ThreadRole role) {
+  std::string prefix =
+      std::string("bluetooth.scheduler.") + thread_role_text(role);
+  return ThreadPolicy{
+      .priority = osi_property_get_int32((prefix + ".priority").c_str(),
+                                         kRealTimeFifoSchedulingPriority),
+      .cpus = osi_property_get_uintlist((prefix + ".cpus").c_str(), {}),
+  };
+}
+
+std::string cpu_list_text(const cpu_set_t& cpus) {
+  std::string text;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &cpus)) {
+      text += (text.empty() ? "" : ",") + std::to_string(cpu);
+    }
+  }
+  return text;
+}
+
+// Voluntary and involuntary context switch counts of the thread, from its
+// status file
+bool get_context_switches(pid_t linux_tid, uint64_t& voluntary,
+                          uint64_t& involuntary) {
+  std::ifstream status("/proc/self/task/" + std::to_string(linux_tid) +
+                       "/status");
+  bool found_voluntary = false;
+  bool found_involuntary = false;
+  std::string line;
+  while (std::getline(status, line)) {
+    if (sscanf(line.c_str(), "voluntary_ctxt_switches: %" SCNu64,
+               &voluntary) == 1) {
+      found_voluntary = true;
+    } else if (sscanf(line.c_str(), "nonvoluntary_ctxt_switches: %" SCNu64,
+                      &involuntary) == 1) {
+      found_involuntary = true;
+    }
+  }
+  return found_voluntary && found_involuntary;
+}
+
+std::mutex thread_roles_mutex;
+// Thread of each role, -1 if none was assigned yet
+std::array<pid_t, kNumThreadRoles> thread_role_tids = [] {
+  std::array<pid_t, kNumThreadRoles> tids;
+  tids.fill(-1);
+  return tids;
+}();
+
 }  // namespace
 
+const char* thread_role_text(ThreadRole role) {
+  switch (role) {
+    case ThreadRole::A2DP_SOURCE:
+      return "a2dp_source";
+    case ThreadRole::A2DP_SOURCE_ENCODER:
+      return "a2dp_source_encoder";
+    case ThreadRole::A2DP_SINK:
+      return "a2dp_sink";
+    case ThreadRole::LE_AUDIO_SOURCE:
+      return "le_audio_source";
+  }
+  return "unknown";
+}
+
 bool thread_scheduler_enable_real_time(pid_t linux_tid) {
   struct sched_param rt_params = {.sched_priority =
                                       kRealTimeFifoSchedulingPriority};
@@ -32,3 +122,90 @@ bool thread_scheduler_get_priority_range(int& min, int& max) {
   max = sched_get_priority_max(SCHED_FIFO);
   return (min != -1 && max != -1) ? true : false;
 }
+
+bool thread_scheduler_apply_policy(pid_t linux_tid, ThreadRole role) {
+  if (linux_tid <= 0) {
+    log::error("no thread to apply the {} policy to", thread_role_text(role));
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(thread_roles_mutex);
+    thread_role_tids[static_cast<size_t>(role)] = linux_tid;
+  }
+
+  ThreadPolicy policy = get_thread_policy(role);
+  bool success = true;
+  struct sched_param params = {
+      .sched_priority = policy.priority > 0 ? policy.priority : 0};
+  int scheduler = policy.priority > 0 ? SCHED_FIFO : SCHED_OTHER;
+  if (sched_setscheduler(linux_tid, scheduler, &params) != 0) {
+    log::error("unable to set the {} priority {} of linux_tid {}, error: {}",
+               thread_role_text(role), policy.priority, linux_tid,
+               strerror(errno));
+    success = false;
+  }
+
+  if (!policy.cpus.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (uint32_t cpu : policy.cpus) {
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &cpus);
+      }
+    }
+    if (sched_setaffinity(linux_tid, sizeof(cpus), &cpus) != 0) {
+      log::error("unable to set the {} cpus {} of linux_tid {}, error: {}",
+                 thread_role_text(role), cpu_list_text(cpus), linux_tid,
+                 strerror(errno));
+    }
+  }
+  return success;
+}
+
+void thread_scheduler_dump(int fd) {
+  std::array<pid_t, kNumThreadRoles> tids;
+  {
+    std::lock_guard<std::mutex> lock(thread_roles_mutex);
+    tids = thread_role_tids;
+  }
+
+  dprintf(fd, "\nThread scheduling:\n");
+  for (size_t i = 0; i < kNumThreadRoles; i++) {
+    ThreadRole role = static_cast<ThreadRole>(i);
+    ThreadPolicy policy = get_thread_policy(role);
+    std::string configured_cpus;
+    for (uint32_t cpu : policy.cpus) {
+      configured_cpus +=
+          (configured_cpus.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    dprintf(fd, "  %s: configured priority %d, cpus %s\n",
+            thread_role_text(role), policy.priority,
+            configured_cpus.empty() ? "all" : configured_cpus.c_str());
+
+    pid_t linux_tid = tids[i];
+    struct sched_param params = {};
+    int scheduler = linux_tid > 0 ? sched_getscheduler(linux_tid) : -1;
+    if (scheduler == -1 || sched_getparam(linux_tid, &params) != 0) {
+      dprintf(fd, "    not running\n");
+      continue;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    sched_getaffinity(linux_tid, sizeof(cpus), &cpus);
+    dprintf(fd, "    linux_tid %d: policy %s, priority %d, cpus %s\n",
+            linux_tid,
+            scheduler == SCHED_FIFO    ? "SCHED_FIFO"
+            : scheduler == SCHED_OTHER ? "SCHED_OTHER"
+                                       : std::to_string(scheduler).c_str(),
+            params.sched_priority, cpu_list_text(cpus).c_str());
+
+    uint64_t voluntary = 0;
+    uint64_t involuntary = 0;
+    if (get_context_switches(linux_tid, voluntary, involuntary)) {
+      dprintf(fd,
+              "    context switches: %" PRIu64 " voluntary, %" PRIu64
+              " involuntary\n",
+              voluntary, involuntary);
+    }
+  }
+}
@@ -0,0 +1,235 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "osi/include/timer_wheel.h"
+
+#include <bluetooth/log.h>
+
+#include "osi/include/allocator.h"
+
+using namespace bluetooth;
+
+namespace {
+
+constexpr unsigned kLevelBits = 6;
+constexpr unsigned kSlotsPerLevel = 1u << kLevelBits;
+constexpr unsigned kSlotMask = kSlotsPerLevel - 1;
+// 6 levels of 64 slots cover 2^36 ms (a bit over two years).
+constexpr unsigned kLevels = 6;
+// Entries beyond the top level are kept unsorted on this pseudo level.
+constexpr unsigned kOverflowLevel = kLevels;
+
+}  // namespace
+
+struct timer_wheel_t {
+  uint64_t now_ms;
+  size_t size;
+  uint64_t occupied[kLevels];
+  timer_wheel_node_t* slots[kLevels + 1][kSlotsPerLevel];
+};
+
+static uint64_t position_of(const timer_wheel_t* wheel, uint64_t deadline_ms) {
+  return deadline_ms < wheel->now_ms ? wheel->now_ms : deadline_ms;
+}
+
+static void link_node(timer_wheel_t* wheel, timer_wheel_node_t* node) {
+  uint64_t position = position_of(wheel, node->deadline_ms);
+  uint64_t diff = position ^ wheel->now_ms;
+  unsigned level = diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / kLevelBits;
+  unsigned slot = 0;
+  if (level >= kLevels) {
+    level = kOverflowLevel;
+  } else {
+    slot = (position >> (level * kLevelBits)) & kSlotMask;
+    wheel->occupied[level] |= 1ull << slot;
+  }
+
+  timer_wheel_node_t** head = &wheel->slots[level][slot];
+  node->level = level;
+  node->slot = slot;
+  node->prev = NULL;
+  node->next = *head;
+  if (*head) (*head)->prev = node;
+  *head = node;
+  node->linked = true;
+}
+
+static void unlink_node(timer_wheel_t* wheel, timer_wheel_node_t* node) {
+  timer_wheel_node_t** head = &wheel->slots[node->level][node->slot];
+  if (node->prev) {
+    node->prev->next = node->next;
+  } else {
+    *head = node->next;
+  }
+  if (node->next) node->next->prev = node->prev;
+
+  if (*head == NULL && node->level != kOverflowLevel) {
+    wheel->occupied[node->level] &= ~(1ull << node->slot);
+  }
+  node->prev = NULL;
+  node->next = NULL;
+  node->linked = false;
+}
+
+// Detaches every entry of |wheel->slots[level][slot]| and prepends them to
+// |*chain|, linked through |next|.
+static void detach_slot(timer_wheel_t* wheel, unsigned level, unsigned slot,
+                        timer_wheel_node_t** chain) {
+  timer_wheel_node_t* node = wheel->slots[level][slot];
+  while (node) {
+    timer_wheel_node_t* next = node->next;
+    node->next = *chain;
+    *chain = node;
+    node = next;
+  }
+  wheel->slots[level][slot] = NULL;
+  if (level != kOverflowLevel) wheel->occupied[level] &= ~(1ull << slot);
+}
+
+timer_wheel_t* timer_wheel_new(uint64_t now_ms) {
+  timer_wheel_t* wheel =
+      static_cast<timer_wheel_t*>(osi_calloc(sizeof(timer_wheel_t)));
+  wheel->now_ms = now_ms;
+  return wheel;
+}
+
+void timer_wheel_free(timer_wheel_t* wheel) { osi_free(wheel); }
+
+void timer_wheel_node_init(timer_wheel_node_t* node) {
+  log::assert_that(node != NULL, "assert failed: node != NULL");
+  node->prev = NULL;
+  node->next = NULL;
+  node->deadline_ms = 0;
+  node->level = 0;
+  node->slot = 0;
+  node->linked = false;
+}
+
+void timer_wheel_insert(timer_wheel_t* wheel, timer_wheel_node_t* node,
+                        uint64_t deadline_ms) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  log::assert_that(node != NULL, "assert failed: node != NULL");
+  log::assert_that(!node->linked, "assert failed: !node->linked");
+
+  node->deadline_ms = deadline_ms;
+  link_node(wheel, node);
+  wheel->size++;
+}
+
+void timer_wheel_remove(timer_wheel_t* wheel, timer_wheel_node_t* node) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  log::assert_that(node != NULL, "assert failed: node != NULL");
+  if (!node->linked) return;
+
+  unlink_node(wheel, node);
+  wheel->size--;
+}
+
+bool timer_wheel_is_empty(const timer_wheel_t* wheel) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  return wheel->size == 0;
+}
+
+size_t timer_wheel_size(const timer_wheel_t* wheel) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  return wheel->size;
+}
+
+// Slots are filled by prepending, and re-bucketing keeps the relative order
+// of entries sharing a deadline, so the last entry with the smallest deadline
+// is the one inserted first.
+static timer_wheel_node_t* earliest_in_slot(timer_wheel_node_t* node) {
+  timer_wheel_node_t* earliest = node;
+  for (; node != NULL; node = node->next) {
+    if (node->deadline_ms <= earliest->deadline_ms) earliest = node;
+  }
+  return earliest;
+}
+
+timer_wheel_node_t* timer_wheel_earliest(const timer_wheel_t* wheel) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+
+  // Every entry of a level is due before any entry of the levels above it,
+  // and within a level the slot index grows with the deadline.
+  for (unsigned level = 0; level < kLevels; level++) {
+    if (wheel->occupied[level] == 0) continue;
+    unsigned slot = __builtin_ctzll(wheel->occupied[level]);
+    return earliest_in_slot(wheel->slots[level][slot]);
+  }
+
+  timer_wheel_node_t* overflow = wheel->slots[kOverflowLevel][0];
+  return overflow ? earliest_in_slot(overflow) : NULL;
+}
+
+void timer_wheel_advance(timer_wheel_t* wheel, uint64_t now_ms) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  if (now_ms <= wheel->now_ms) return;
+
+  uint64_t old_ms = wheel->now_ms;
+  timer_wheel_node_t* chain = NULL;
+
+  for (unsigned level = 0; level < kLevels; level++) {
+    if (wheel->occupied[level] == 0) continue;
+
+    unsigned shift = (level + 1) * kLevelBits;
+    uint64_t mask;
+    if ((old_ms >> shift) != (now_ms >> shift)) {
+      // The new time is in a later block of the level above: the whole level
+      // is due.
+      mask = ~0ull;
+    } else {
+      // Only the slots up to the new time's digit moved closer.
+      unsigned digit = (now_ms >> (level * kLevelBits)) & kSlotMask;
+      mask = digit == kSlotMask ? ~0ull : (1ull << (digit + 1)) - 1;
+    }
+
+    uint64_t slots = wheel->occupied[level] & mask;
+    while (slots) {
+      unsigned slot = __builtin_ctzll(slots);
+      slots &= slots - 1;
+      detach_slot(wheel, level, slot, &chain);
+    }
+  }
+
+  if (wheel->slots[kOverflowLevel][0] != NULL &&
+      (old_ms >> (kLevels * kLevelBits)) != (now_ms >> (kLevels * kLevelBits))) {
+    detach_slot(wheel, kOverflowLevel, 0, &chain);
+  }
+
+  wheel->now_ms = now_ms;
+  while (chain) {
+    timer_wheel_node_t* next = chain->next;
+    link_node(wheel, chain);
+    chain = next;
+  }
+}
+
+void timer_wheel_foreach(const timer_wheel_t* wheel,
+                         timer_wheel_iter_cb callback, void* context) {
+  log::assert_that(wheel != NULL, "assert failed: wheel != NULL");
+  log::assert_that(callback != NULL, "assert failed: callback != NULL");
+
+  for (unsigned level = 0; level <= kOverflowLevel; level++) {
+    for (unsigned slot = 0; slot < kSlotsPerLevel; slot++) {
+      for (timer_wheel_node_t* node = wheel->slots[level][slot]; node != NULL;
+           node = node->next) {
+        if (!callback(node, context)) return;
+      }
+    }
+  }
+}
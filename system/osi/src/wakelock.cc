@@ -30,12 +30,16 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "common/metrics.h"
 #include "os/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 
 using bluetooth::common::BluetoothMetricsLogger;
 using namespace bluetooth;
@@ -54,6 +58,25 @@ static pthread_once_t initialized = PTHREAD_ONCE_INIT;
 static int wake_lock_fd = INVALID_FD;
 static int wake_unlock_fd = INVALID_FD;
 
+// How long the wakelock is kept after being released, so that the bursts of
+// alarms and audio ticks do not take and drop it over and over. 0 releases it
+// right away.
+static const char* RELEASE_DELAY_PROPERTY =
+    "bluetooth.wakelock.release_delay_ms";
+static int64_t release_delay_ms = -1;
+
+// State of the wakelock as seen by the OS. Acquiring a wakelock already held,
+// or releasing one that is not, does not reach the OS. A release is deferred
+// by |release_delay_ms| to |release_deadline|, and canceled by an acquire
+// happening before. Protected by |wakelock_mutex|.
+static std::mutex wakelock_mutex;
+static std::condition_variable release_cv;
+static bool os_wakelock_held = false;
+static bool release_pending = false;
+static std::chrono::steady_clock::time_point release_deadline;
+static std::thread release_thread;
+static bool release_thread_exit = false;
+
 // Wakelock statistics for the "bluetooth_timer"
 typedef struct {
   bool is_acquired;
@@ -70,6 +93,10 @@ typedef struct {
   uint64_t last_reset_timestamp_ms;
   int last_acquired_error;
   int last_released_error;
+  size_t acquire_requests;
+  size_t release_requests;
+  size_t os_acquire_calls;
+  size_t os_release_calls;
 } wakelock_stats_t;
 
 static wakelock_stats_t wakelock_stats;
@@ -82,11 +109,14 @@ static bt_status_t wakelock_acquire_callout(void);
 static bt_status_t wakelock_acquire_native(void);
 static bt_status_t wakelock_release_callout(void);
 static bt_status_t wakelock_release_native(void);
+static bt_status_t wakelock_release_os(void);
+static void wakelock_release_thread_run(void);
 static void wakelock_initialize(void);
 static void wakelock_initialize_native(void);
 static void reset_wakelock_stats(void);
 static void update_wakelock_acquired_stats(bt_status_t acquired_status);
 static void update_wakelock_released_stats(bt_status_t released_status);
+static void update_wakelock_request_stats(bool is_acquire);
 
 void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
   wakelock_os_callouts = callouts;
@@ -97,6 +127,13 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 bool wakelock_acquire(void) {
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  update_wakelock_request_stats(true);
+
+  // A pending release is canceled, the wakelock was never dropped
+  release_pending = false;
+  if (os_wakelock_held) return true;
+
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -105,6 +142,7 @@ bool wakelock_acquire(void) {
     status = wakelock_acquire_callout();
 
   update_wakelock_acquired_stats(status);
+  os_wakelock_held = (status == BT_STATUS_SUCCESS);
 
   if (status != BT_STATUS_SUCCESS)
     log::error("unable to acquire wake lock: {}", status);
@@ -143,6 +181,28 @@ static bt_status_t wakelock_acquire_native(void) {
 bool wakelock_release(void) {
   pthread_once(&initialized, wakelock_initialize);
 
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  update_wakelock_request_stats(false);
+
+  if (!os_wakelock_held || release_pending) return true;
+
+  if (release_delay_ms <= 0) {
+    return (wakelock_release_os() == BT_STATUS_SUCCESS);
+  }
+
+  release_pending = true;
+  release_deadline = std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(release_delay_ms);
+  if (!release_thread.joinable()) {
+    release_thread_exit = false;
+    release_thread = std::thread(wakelock_release_thread_run);
+  }
+  release_cv.notify_one();
+  return true;
+}
+
+// NOTE: must be called with |wakelock_mutex| held
+static bt_status_t wakelock_release_os(void) {
   bt_status_t status = BT_STATUS_FAIL;
 
   if (is_native)
@@ -151,8 +211,28 @@ bool wakelock_release(void) {
     status = wakelock_release_callout();
 
   update_wakelock_released_stats(status);
+  os_wakelock_held = false;
+  release_pending = false;
 
-  return (status == BT_STATUS_SUCCESS);
+  return status;
+}
+
+// Releases the wakelock once the deadline of a pending release is reached.
+// The steady clock does not need to account for suspend: the system cannot
+// suspend while the wakelock is held.
+static void wakelock_release_thread_run(void) {
+  std::unique_lock<std::mutex> lock(wakelock_mutex);
+  while (!release_thread_exit) {
+    if (!release_pending) {
+      release_cv.wait(lock);
+      continue;
+    }
+    release_cv.wait_until(lock, release_deadline);
+    if (release_pending && !release_thread_exit &&
+        std::chrono::steady_clock::now() >= release_deadline) {
+      wakelock_release_os();
+    }
+  }
 }
 
 static bt_status_t wakelock_release_callout(void) {
@@ -178,6 +258,11 @@ static bt_status_t wakelock_release_native(void) {
 static void wakelock_initialize(void) {
   reset_wakelock_stats();
 
+  if (release_delay_ms < 0) {
+    release_delay_ms = osi_property_get_int32(RELEASE_DELAY_PROPERTY, 0);
+  }
+  log::info("wakelock release delay: {} ms", release_delay_ms);
+
   if (is_native) wakelock_initialize_native();
 }
 
@@ -201,12 +286,29 @@ static void wakelock_initialize_native(void) {
 }
 
 void wakelock_cleanup(void) {
-  if (wakelock_stats.is_acquired) {
-    log::error("releasing wake lock as part of cleanup");
-    wakelock_release();
+  std::thread thread;
+  {
+    std::lock_guard<std::mutex> lock(wakelock_mutex);
+    release_thread_exit = true;
+    release_cv.notify_one();
+    thread = std::move(release_thread);
+  }
+  if (thread.joinable()) thread.join();
+
+  {
+    std::lock_guard<std::mutex> lock(wakelock_mutex);
+    if (os_wakelock_held) {
+      if (release_pending) {
+        log::info("releasing wake lock ahead of its release delay");
+      } else {
+        log::error("releasing wake lock as part of cleanup");
+      }
+      wakelock_release_os();
+    }
   }
   wake_lock_path.clear();
   wake_unlock_path.clear();
+  release_delay_ms = -1;
   initialized = PTHREAD_ONCE_INIT;
 }
 
@@ -216,6 +318,11 @@ void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   if (unlock_path) wake_unlock_path = unlock_path;
 }
 
+void wakelock_set_release_delay(int64_t delay_ms) {
+  std::lock_guard<std::mutex> lock(wakelock_mutex);
+  release_delay_ms = delay_ms;
+}
+
 static uint64_t now_ms(void) {
   struct timespec ts;
   if (clock_gettime(CLOCK_ID, &ts) == -1) {
@@ -243,6 +350,25 @@ static void reset_wakelock_stats(void) {
   wakelock_stats.last_acquired_timestamp_ms = 0;
   wakelock_stats.last_released_timestamp_ms = 0;
   wakelock_stats.last_reset_timestamp_ms = now_ms();
+  wakelock_stats.acquire_requests = 0;
+  wakelock_stats.release_requests = 0;
+  wakelock_stats.os_acquire_calls = 0;
+  wakelock_stats.os_release_calls = 0;
+}
+
+//
+// Update the count of acquire or release requests, whether they reach the OS
+// or not.
+// This function is thread-safe.
+//
+static void update_wakelock_request_stats(bool is_acquire) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+
+  if (is_acquire) {
+    wakelock_stats.acquire_requests++;
+  } else {
+    wakelock_stats.release_requests++;
+  }
 }
 
 //
@@ -258,6 +384,7 @@ static void update_wakelock_acquired_stats(bt_status_t acquired_status) {
 
   std::lock_guard<std::mutex> lock(stats_mutex);
 
+  wakelock_stats.os_acquire_calls++;
   if (acquired_status != BT_STATUS_SUCCESS) {
     wakelock_stats.acquired_errors++;
     wakelock_stats.last_acquired_error = acquired_status;
@@ -288,6 +415,7 @@ static void update_wakelock_released_stats(bt_status_t released_status) {
 
   std::lock_guard<std::mutex> lock(stats_mutex);
 
+  wakelock_stats.os_release_calls++;
   if (released_status != BT_STATUS_SUCCESS) {
     wakelock_stats.released_errors++;
     wakelock_stats.last_released_error = released_status;
@@ -341,6 +469,11 @@ void wakelock_debug_dump(int fd) {
   if (wakelock_stats.acquired_count > 0)
     avg_interval_ms = total_interval_ms / wakelock_stats.acquired_count;
 
+  const size_t requests =
+      wakelock_stats.acquire_requests + wakelock_stats.release_requests;
+  const size_t os_calls =
+      wakelock_stats.os_acquire_calls + wakelock_stats.os_release_calls;
+
   dprintf(fd, "\nBluetooth Wakelock Statistics:\n");
   dprintf(fd, "  Is acquired                    : %s\n",
           wakelock_stats.is_acquired ? "true" : "false");
@@ -362,4 +495,12 @@ void wakelock_debug_dump(int fd) {
   dprintf(fd, "  Total run time (ms)            : %llu\n",
           (unsigned long long)(just_now_ms -
                                wakelock_stats.last_reset_timestamp_ms));
+  dprintf(fd, "  Release delay (ms)             : %lld\n",
+          (long long)release_delay_ms);
+  dprintf(fd, "  Acquire/release requests       : %zu / %zu\n",
+          wakelock_stats.acquire_requests, wakelock_stats.release_requests);
+  dprintf(fd, "  OS acquire/release calls       : %zu / %zu\n",
+          wakelock_stats.os_acquire_calls, wakelock_stats.os_release_calls);
+  dprintf(fd, "  OS calls saved                 : %zu\n",
+          requests > os_calls ? requests - os_calls : 0);
 }
@@ -48,3 +48,70 @@ TEST_F(AllocatorTest, test_osi_strndup) {
   EXPECT_EQ(0, strcmp(str, copy_str));
   osi_free(copy_str);
 }
+
+class AllocatorAccountingTest : public ::testing::Test {
+ protected:
+  void SetUp() override { osi_alloc_accounting_set_enabled(true); }
+  void TearDown() override { osi_alloc_accounting_set_enabled(false); }
+};
+
+TEST_F(AllocatorAccountingTest, live_buffers_counted_per_tag) {
+  void* first = osi_malloc_tagged(100, "accounting_test");
+  void* second = osi_calloc_tagged(50, "accounting_test");
+  void* other = osi_malloc_tagged(10, "accounting_test_other");
+
+  osi_alloc_tag_stats_t stats;
+  ASSERT_TRUE(osi_alloc_accounting_get_stats("accounting_test", &stats));
+  EXPECT_EQ(150u, stats.live_bytes);
+  EXPECT_EQ(2u, stats.live_buffers);
+  EXPECT_EQ(150u, stats.high_water_bytes);
+  EXPECT_EQ(2u, stats.allocations);
+
+  osi_free(first);
+  ASSERT_TRUE(osi_alloc_accounting_get_stats("accounting_test", &stats));
+  EXPECT_EQ(50u, stats.live_bytes);
+  EXPECT_EQ(1u, stats.live_buffers);
+  EXPECT_EQ(150u, stats.high_water_bytes);
+
+  ASSERT_TRUE(osi_alloc_accounting_get_stats("accounting_test_other", &stats));
+  EXPECT_EQ(10u, stats.live_bytes);
+
+  osi_free(second);
+  osi_free(other);
+}
+
+TEST_F(AllocatorAccountingTest, same_tag_merged_across_literals) {
+  char tag[] = "accounting_test";
+  void* ptr = osi_malloc_tagged(10, tag);
+  void* ptr2 = osi_malloc_tagged(20, "accounting_test");
+
+  osi_alloc_tag_stats_t stats;
+  ASSERT_TRUE(osi_alloc_accounting_get_stats("accounting_test", &stats));
+  EXPECT_EQ(30u, stats.live_bytes);
+
+  osi_free(ptr);
+  osi_free(ptr2);
+}
+
+TEST_F(AllocatorAccountingTest, untagged_allocations_counted) {
+  void* ptr = osi_malloc(64);
+
+  osi_alloc_tag_stats_t stats;
+  ASSERT_TRUE(osi_alloc_accounting_get_stats("untagged", &stats));
+  EXPECT_EQ(64u, stats.live_bytes);
+
+  osi_free(ptr);
+  ASSERT_TRUE(osi_alloc_accounting_get_stats("untagged", &stats));
+  EXPECT_EQ(0u, stats.live_bytes);
+}
+
+TEST_F(AllocatorAccountingTest, buffers_allocated_while_disabled_ignored) {
+  osi_alloc_accounting_set_enabled(false);
+  void* ptr = osi_malloc_tagged(10, "accounting_test");
+  osi_alloc_tag_stats_t stats;
+  ASSERT_FALSE(osi_alloc_accounting_get_stats("accounting_test", &stats));
+
+  osi_alloc_accounting_set_enabled(true);
+  osi_free(ptr);
+  ASSERT_FALSE(osi_alloc_accounting_get_stats("unknown_tag", &stats));
+}
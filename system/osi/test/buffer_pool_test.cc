@@ -0,0 +1,151 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "osi/include/buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+size_t find_class(size_t size) {
+  for (size_t i = 0; i < buffer_pool_class_count(); i++) {
+    buffer_pool_class_stats_t stats;
+    buffer_pool_get_class_stats(i, &stats);
+    if (size <= stats.block_size) return i;
+  }
+  return buffer_pool_class_count();
+}
+
+}  // namespace
+
+class BufferPoolTest : public ::testing::Test {};
+
+TEST_F(BufferPoolTest, small_allocation_is_pooled) {
+  void* ptr = buffer_pool_alloc(100);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_TRUE(buffer_pool_owns(ptr));
+  memset(ptr, 0xa5, 100);
+  osi_free(ptr);
+}
+
+TEST_F(BufferPoolTest, large_allocation_falls_back) {
+  void* ptr = buffer_pool_alloc(64 * 1024);
+  ASSERT_NE(nullptr, ptr);
+  EXPECT_FALSE(buffer_pool_owns(ptr));
+  osi_free(ptr);
+}
+
+TEST_F(BufferPoolTest, osi_malloc_is_not_pooled) {
+  void* ptr = osi_malloc(100);
+  EXPECT_FALSE(buffer_pool_owns(ptr));
+  buffer_pool_free(ptr);
+}
+
+TEST_F(BufferPoolTest, freed_block_is_reused_by_same_thread) {
+  void* first = buffer_pool_alloc(200);
+  osi_free(first);
+  void* second = buffer_pool_alloc(200);
+  EXPECT_EQ(first, second);
+  osi_free(second);
+}
+
+TEST_F(BufferPoolTest, outstanding_blocks_are_distinct) {
+  std::set<void*> blocks;
+  for (int i = 0; i < 64; i++) {
+    void* ptr = buffer_pool_alloc(1000);
+    EXPECT_TRUE(blocks.insert(ptr).second);
+  }
+  for (void* ptr : blocks) osi_free(ptr);
+}
+
+TEST_F(BufferPoolTest, counters_track_usage) {
+  size_t cls = find_class(500);
+  ASSERT_LT(cls, buffer_pool_class_count());
+
+  buffer_pool_class_stats_t before;
+  ASSERT_TRUE(buffer_pool_get_class_stats(cls, &before));
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 10; i++) blocks.push_back(buffer_pool_alloc(500));
+
+  buffer_pool_class_stats_t during;
+  ASSERT_TRUE(buffer_pool_get_class_stats(cls, &during));
+  EXPECT_EQ(before.hits + 10, during.hits);
+  EXPECT_EQ(before.in_use + 10, during.in_use);
+  EXPECT_GE(during.high_water, during.in_use);
+
+  for (void* ptr : blocks) osi_free(ptr);
+
+  buffer_pool_class_stats_t after;
+  ASSERT_TRUE(buffer_pool_get_class_stats(cls, &after));
+  EXPECT_EQ(before.in_use, after.in_use);
+}
+
+TEST_F(BufferPoolTest, exhausted_class_counts_misses) {
+  size_t cls = find_class(2000);
+  buffer_pool_class_stats_t before;
+  ASSERT_TRUE(buffer_pool_get_class_stats(cls, &before));
+
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < before.capacity + 4; i++) {
+    blocks.push_back(buffer_pool_alloc(2000));
+  }
+
+  buffer_pool_class_stats_t during;
+  ASSERT_TRUE(buffer_pool_get_class_stats(cls, &during));
+  EXPECT_GE(during.misses, before.misses + 4);
+  EXPECT_EQ(during.capacity, during.high_water);
+
+  for (void* ptr : blocks) osi_free(ptr);
+}
+
+TEST_F(BufferPoolTest, blocks_can_cross_threads) {
+  std::vector<void*> blocks;
+  std::thread producer([&blocks] {
+    for (int i = 0; i < 100; i++) blocks.push_back(buffer_pool_alloc(128));
+  });
+  producer.join();
+
+  for (void* ptr : blocks) {
+    EXPECT_TRUE(buffer_pool_owns(ptr));
+    osi_free(ptr);
+  }
+}
+
+TEST_F(BufferPoolTest, concurrent_alloc_free) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < 2000; i++) {
+        uint8_t* ptr = static_cast<uint8_t*>(buffer_pool_alloc(64 + t * 300));
+        ptr[0] = static_cast<uint8_t>(i);
+        osi_free(ptr);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+TEST_F(BufferPoolTest, stats_out_of_range) {
+  buffer_pool_class_stats_t stats;
+  EXPECT_FALSE(buffer_pool_get_class_stats(buffer_pool_class_count(), &stats));
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+// Loads and queries a config file of |state.range(0)| sections laid out like
+// the per device sections of the interop database and IoT config files.
+
+#include <benchmark/benchmark.h>
+#include <stdio.h>
+
+#include <filesystem>
+#include <string>
+
+#include "osi/include/config.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr int kKeysPerSection = 16;
+
+std::string SectionName(int section) {
+  char name[18];
+  snprintf(name, sizeof(name), "aa:bb:cc:%02x:%02x:%02x", (section >> 16) & 0xff,
+           (section >> 8) & 0xff, section & 0xff);
+  return name;
+}
+
+std::filesystem::path WriteConfigFile(int num_sections) {
+  auto path = std::filesystem::temp_directory_path() / "config_benchmark.conf";
+  FILE* fp = fopen(path.c_str(), "wt");
+  fprintf(fp, "# Generated by config_benchmark\n");
+  for (int section = 0; section < num_sections; section++) {
+    fprintf(fp, "[%s]\n", SectionName(section).c_str());
+    for (int key = 0; key < kKeysPerSection; key++) {
+      fprintf(fp, "Key%d = %d\n", key, section * key);
+    }
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+  return path;
+}
+
+void BM_ConfigNew(State& state) {
+  auto path = WriteConfigFile(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(config_new(path.c_str()));
+  }
+  std::filesystem::remove(path);
+}
+
+void BM_ConfigGetInt(State& state) {
+  auto path = WriteConfigFile(state.range(0));
+  auto config = config_new(path.c_str());
+  std::string last_section = SectionName(state.range(0) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        config_get_int(*config, last_section, "Key15", 0));
+  }
+  std::filesystem::remove(path);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ConfigNew)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_ConfigGetInt)->Arg(10)->Arg(100)->Arg(1000);
@@ -240,6 +240,38 @@ TEST_F(ConfigTest, config_remove_key_missing) {
   EXPECT_EQ(config_get_int(*config, "DID", "productId", 999), 999);
 }
 
+TEST_F(ConfigTest, config_remove_and_add_keep_order) {
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  EXPECT_TRUE(config_remove_key(config.get(), "DID", "productId"));
+  config_set_string(config.get(), "DID", "productId", "0x1300");
+  EXPECT_TRUE(config_remove_section(config.get(), CONFIG_DEFAULT_SECTION));
+  config_set_string(config.get(), CONFIG_DEFAULT_SECTION, "first_key", "v");
+
+  // Sections and keys added back are moved to the end
+  auto section_iter = config->sections.begin();
+  EXPECT_EQ(section_iter->name, "DID");
+  EXPECT_EQ(section_iter->entries.back().key, "productId");
+  EXPECT_EQ(section_iter->Find("productId")->value, "0x1300");
+  EXPECT_EQ(std::next(section_iter)->name, CONFIG_DEFAULT_SECTION);
+  EXPECT_EQ(config->Find(CONFIG_DEFAULT_SECTION), std::next(section_iter));
+}
+
+TEST_F(ConfigTest, config_index_of_copies) {
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  section_t section = *config->Find("DID");
+  section.name = "DID2";
+
+  // The copy of the section has its own index
+  config_t copy;
+  copy.sections.push_back(section);
+  auto section_iter = copy.Find("DID2");
+  ASSERT_NE(section_iter, copy.sections.end());
+  section_iter->Set("version", "0x1500");
+  EXPECT_EQ(config_get_int(copy, "DID2", "version", 0), 0x1500);
+  EXPECT_EQ(config_get_int(*config, "DID", "version", 0), 0x1436);
+  EXPECT_EQ(section_iter->entries.size(), config->Find("DID")->entries.size());
+}
+
 TEST_F(ConfigTest, config_save_basic) {
   std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
   EXPECT_TRUE(config_save(*config, CONFIG_FILE));
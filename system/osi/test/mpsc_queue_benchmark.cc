@@ -0,0 +1,65 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+// Compares the cost of passing |state.range(0)| packets through a
+// fixed_queue_t and through an mpsc_queue_t, as a producer filling a
+// transmit queue and the consumer draining it do.
+
+#include <benchmark/benchmark.h>
+
+#include "osi/include/fixed_queue.h"
+#include "osi/include/mpsc_queue.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr size_t kQueueCapacity = 64;
+
+void BM_FixedQueue(State& state) {
+  fixed_queue_t* queue = fixed_queue_new(kQueueCapacity);
+  int packet;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+      fixed_queue_try_enqueue(queue, &packet);
+    }
+    for (int64_t i = 0; i < state.range(0); i++) {
+      benchmark::DoNotOptimize(fixed_queue_try_dequeue(queue));
+    }
+  }
+  fixed_queue_free(queue, NULL);
+}
+
+void BM_MpscQueue(State& state) {
+  mpsc_queue_t* queue = mpsc_queue_new(kQueueCapacity);
+  int packet;
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+      mpsc_queue_try_enqueue(queue, &packet);
+    }
+    for (int64_t i = 0; i < state.range(0); i++) {
+      benchmark::DoNotOptimize(mpsc_queue_try_dequeue(queue));
+    }
+  }
+  mpsc_queue_free(queue, NULL);
+}
+
+}  // namespace
+
+BENCHMARK(BM_FixedQueue)->Arg(1)->Arg(8)->Arg(32);
+BENCHMARK(BM_MpscQueue)->Arg(1)->Arg(8)->Arg(32);
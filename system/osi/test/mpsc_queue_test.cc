@@ -0,0 +1,142 @@
+#include "osi/include/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "osi/include/future.h"
+#include "osi/include/thread.h"
+
+static const size_t TEST_QUEUE_SIZE = 10;
+static const char* DUMMY_DATA_STRING = "Dummy data string";
+static const char* DUMMY_DATA_STRING1 = "Dummy data string1";
+
+static int test_queue_entry_free_counter = 0;
+
+static void test_queue_entry_free_cb(void* /* data */) {
+  test_queue_entry_free_counter++;
+}
+
+class MpscQueueTest : public ::testing::Test {};
+
+TEST_F(MpscQueueTest, test_mpsc_queue_enqueue_dequeue) {
+  mpsc_queue_t* queue = mpsc_queue_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_EQ(TEST_QUEUE_SIZE, mpsc_queue_capacity(queue));
+  EXPECT_TRUE(mpsc_queue_is_empty(queue));
+  EXPECT_EQ(NULL, mpsc_queue_try_dequeue(queue));
+
+  EXPECT_TRUE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+  EXPECT_TRUE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING1));
+  EXPECT_FALSE(mpsc_queue_is_empty(queue));
+  EXPECT_EQ(2u, mpsc_queue_length(queue));
+  EXPECT_EQ(DUMMY_DATA_STRING, mpsc_queue_try_peek_first(queue));
+
+  EXPECT_EQ(DUMMY_DATA_STRING, mpsc_queue_try_dequeue(queue));
+  EXPECT_EQ(DUMMY_DATA_STRING1, mpsc_queue_try_dequeue(queue));
+  EXPECT_EQ(NULL, mpsc_queue_try_dequeue(queue));
+  EXPECT_TRUE(mpsc_queue_is_empty(queue));
+  EXPECT_EQ(0u, mpsc_queue_length(queue));
+
+  mpsc_queue_free(queue, NULL);
+}
+
+TEST_F(MpscQueueTest, test_mpsc_queue_full) {
+  mpsc_queue_t* queue = mpsc_queue_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  // The ring holds more slots than the capacity, which is still enforced
+  for (size_t i = 0; i < TEST_QUEUE_SIZE; i++) {
+    EXPECT_TRUE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+  }
+  EXPECT_FALSE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+
+  EXPECT_EQ(DUMMY_DATA_STRING, mpsc_queue_try_dequeue(queue));
+  EXPECT_TRUE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING1));
+
+  test_queue_entry_free_counter = 0;
+  mpsc_queue_flush(queue, test_queue_entry_free_cb);
+  EXPECT_EQ((int)TEST_QUEUE_SIZE, test_queue_entry_free_counter);
+  EXPECT_TRUE(mpsc_queue_is_empty(queue));
+
+  // Corner case: queue of size 0
+  mpsc_queue_free(queue, NULL);
+  queue = mpsc_queue_new(0);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_FALSE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+  mpsc_queue_free(queue, NULL);
+}
+
+TEST_F(MpscQueueTest, test_mpsc_queue_free) {
+  mpsc_queue_t* queue = mpsc_queue_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  EXPECT_TRUE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING));
+  EXPECT_TRUE(mpsc_queue_try_enqueue(queue, (void*)DUMMY_DATA_STRING1));
+
+  test_queue_entry_free_counter = 0;
+  mpsc_queue_free(queue, test_queue_entry_free_cb);
+  EXPECT_EQ(2, test_queue_entry_free_counter);
+}
+
+static const uintptr_t NUM_PRODUCERS = 4;
+static const uintptr_t ELEMENTS_PER_PRODUCER = 10000;
+
+// Elements are encoded as 1 + producer index + NUM_PRODUCERS * sequence, to
+// check their order per producer.
+struct consumer_t {
+  uintptr_t next_sequence[NUM_PRODUCERS];
+  size_t received;
+  future_t* done;
+};
+
+// Dequeues one element per call, like the fixed_queue_t callbacks do.
+static void mpsc_queue_ready(mpsc_queue_t* queue, void* context) {
+  consumer_t* consumer = static_cast<consumer_t*>(context);
+  uintptr_t value = reinterpret_cast<uintptr_t>(mpsc_queue_try_dequeue(queue));
+  ASSERT_NE(0u, value);
+  uintptr_t producer = (value - 1) % NUM_PRODUCERS;
+  EXPECT_EQ(consumer->next_sequence[producer], (value - 1) / NUM_PRODUCERS);
+  consumer->next_sequence[producer]++;
+  if (++consumer->received == NUM_PRODUCERS * ELEMENTS_PER_PRODUCER) {
+    future_ready(consumer->done, FUTURE_SUCCESS);
+  }
+}
+
+TEST_F(MpscQueueTest, test_mpsc_queue_register_dequeue_producers) {
+  mpsc_queue_t* queue = mpsc_queue_new(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  consumer_t consumer = {};
+  consumer.done = future_new();
+  ASSERT_TRUE(consumer.done != NULL);
+
+  thread_t* worker_thread = thread_new("test_mpsc_queue_worker_thread");
+  ASSERT_TRUE(worker_thread != NULL);
+  mpsc_queue_register_dequeue(queue, thread_get_reactor(worker_thread),
+                              mpsc_queue_ready, &consumer);
+
+  // Producers spin when the queue is full, and no element is lost or
+  // reordered whether the consumer finds the queue empty or not
+  std::vector<std::thread> producers;
+  for (uintptr_t producer = 0; producer < NUM_PRODUCERS; producer++) {
+    producers.emplace_back([queue, producer]() {
+      for (uintptr_t i = 0; i < ELEMENTS_PER_PRODUCER; i++) {
+        void* data =
+            reinterpret_cast<void*>(1 + producer + NUM_PRODUCERS * i);
+        while (!mpsc_queue_try_enqueue(queue, data)) std::this_thread::yield();
+      }
+    });
+  }
+  for (auto& producer : producers) producer.join();
+
+  EXPECT_EQ(FUTURE_SUCCESS, future_await(consumer.done));
+  EXPECT_TRUE(mpsc_queue_is_empty(queue));
+
+  mpsc_queue_unregister_dequeue(queue);
+  thread_free(worker_thread);
+  mpsc_queue_free(queue, NULL);
+}
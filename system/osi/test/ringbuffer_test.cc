@@ -137,3 +137,110 @@ TEST(RingbufferTest, test_multi_insert_delete) {
 
   ringbuffer_free(rb);
 }
+
+TEST(RingbufferTest, test_init_pow2) {
+  ringbuffer_t* rb = ringbuffer_init_pow2(100);
+  ASSERT_TRUE(rb != NULL);
+  EXPECT_EQ((size_t)128, ringbuffer_available(rb));
+  ringbuffer_free(rb);
+
+  rb = ringbuffer_init_pow2(64);
+  EXPECT_EQ((size_t)64, ringbuffer_available(rb));
+  ringbuffer_free(rb);
+}
+
+TEST(RingbufferTest, test_pow2_wrap) {
+  ringbuffer_t* rb = ringbuffer_init_pow2(8);
+
+  uint8_t aa[] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+  uint8_t bb[] = {0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
+  uint8_t peek[8] = {0};
+
+  ringbuffer_insert(rb, aa, sizeof(aa));
+  ringbuffer_delete(rb, 4);
+  EXPECT_EQ((size_t)5, ringbuffer_insert(rb, bb, sizeof(bb)));
+  EXPECT_EQ((size_t)7, ringbuffer_size(rb));
+
+  uint8_t content[] = {0xAA, 0xAA, 0xBB, 0xBB, 0xBB, 0xBB, 0xBB};
+  EXPECT_EQ((size_t)7, ringbuffer_peek(rb, 0, peek, 8));
+  ASSERT_TRUE(0 == memcmp(content, peek, sizeof(content)));
+  EXPECT_EQ((size_t)4, ringbuffer_peek(rb, 3, peek, 8));
+  ASSERT_TRUE(0 == memcmp(content + 3, peek, 4));
+
+  ringbuffer_free(rb);
+}
+
+TEST(RingbufferTest, test_read_spans) {
+  ringbuffer_t* rb = ringbuffer_init(10);
+  ringbuffer_span_t spans[2];
+
+  EXPECT_EQ((size_t)0, ringbuffer_read_spans(rb, spans));
+  EXPECT_EQ((size_t)0, spans[0].length);
+  EXPECT_EQ((size_t)0, spans[1].length);
+
+  // Contiguous data
+
+  uint8_t aa[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+  ringbuffer_insert(rb, aa, sizeof(aa));
+  EXPECT_EQ((size_t)7, ringbuffer_read_spans(rb, spans));
+  EXPECT_EQ((size_t)7, spans[0].length);
+  EXPECT_EQ((size_t)0, spans[1].length);
+  ASSERT_TRUE(0 == memcmp(aa, spans[0].data, 7));
+
+  // Data wrapping around the end of the buffer
+
+  ringbuffer_delete(rb, 5);
+  uint8_t bb[] = {0x08, 0x09, 0x0A, 0x0B, 0x0C};
+  ringbuffer_insert(rb, bb, sizeof(bb));
+  EXPECT_EQ((size_t)7, ringbuffer_read_spans(rb, spans));
+  EXPECT_EQ((size_t)5, spans[0].length);
+  EXPECT_EQ((size_t)2, spans[1].length);
+  uint8_t content[] = {0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C};
+  ASSERT_TRUE(0 == memcmp(content, spans[0].data, 5));
+  ASSERT_TRUE(0 == memcmp(content + 5, spans[1].data, 2));
+
+  // Consume in place
+
+  spans[0].data[0] = 0x60;
+  EXPECT_EQ((size_t)7, ringbuffer_delete(rb, 7));
+  EXPECT_EQ((size_t)10, ringbuffer_available(rb));
+
+  ringbuffer_free(rb);
+}
+
+TEST(RingbufferTest, test_write_spans_commit) {
+  ringbuffer_t* rb = ringbuffer_init_pow2(8);
+  ringbuffer_span_t spans[2];
+
+  uint8_t aa[] = {0xAA, 0xAA, 0xAA, 0xAA, 0xAA, 0xAA};
+  ringbuffer_insert(rb, aa, sizeof(aa));
+  ringbuffer_delete(rb, 5);
+
+  // Free space wraps around the end of the buffer
+
+  EXPECT_EQ((size_t)7, ringbuffer_write_spans(rb, spans));
+  EXPECT_EQ((size_t)2, spans[0].length);
+  EXPECT_EQ((size_t)5, spans[1].length);
+  memset(spans[0].data, 0xBB, spans[0].length);
+  memset(spans[1].data, 0xCC, 3);
+
+  // Nothing is added before the commit
+
+  EXPECT_EQ((size_t)1, ringbuffer_size(rb));
+  EXPECT_EQ((size_t)5, ringbuffer_commit(rb, 5));
+  EXPECT_EQ((size_t)6, ringbuffer_size(rb));
+
+  uint8_t content[] = {0xAA, 0xBB, 0xBB, 0xCC, 0xCC, 0xCC};
+  uint8_t peek[8] = {0};
+  EXPECT_EQ((size_t)6, ringbuffer_pop(rb, peek, 8));
+  ASSERT_TRUE(0 == memcmp(content, peek, sizeof(content)));
+
+  // Commit is bounded by the free space
+
+  EXPECT_EQ((size_t)8, ringbuffer_commit(rb, 10));
+  EXPECT_EQ((size_t)0, ringbuffer_available(rb));
+  EXPECT_EQ((size_t)0, ringbuffer_write_spans(rb, spans));
+  EXPECT_EQ((size_t)0, spans[0].length + spans[1].length);
+
+  ringbuffer_free(rb);
+}
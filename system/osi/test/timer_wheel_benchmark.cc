@@ -0,0 +1,125 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+// Compares the two pending alarm containers of osi/src/alarm.cc: the
+// deadline sorted list and the hierarchical timer wheel. Each iteration
+// re-arms one of |state.range(0)| pending timers, which is what L2CAP, RFCOMM
+// and GATT timers do on every packet.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "osi/include/list.h"
+#include "osi/include/timer_wheel.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr uint64_t kStartMs = 1000000;
+constexpr uint64_t kMaxTimeoutMs = 30000;
+
+struct sorted_timer_t {
+  uint64_t deadline_ms;
+};
+
+// Same insertion as the list backend of alarm.cc.
+void sorted_list_insert(list_t* list, sorted_timer_t* timer) {
+  if (list_is_empty(list) ||
+      static_cast<sorted_timer_t*>(list_front(list))->deadline_ms >
+          timer->deadline_ms) {
+    list_prepend(list, timer);
+    return;
+  }
+  for (list_node_t* node = list_begin(list); node != list_end(list);
+       node = list_next(node)) {
+    list_node_t* next = list_next(node);
+    if (next == list_end(list) ||
+        static_cast<sorted_timer_t*>(list_node(next))->deadline_ms >
+            timer->deadline_ms) {
+      list_insert_after(list, node, timer);
+      return;
+    }
+  }
+}
+
+std::vector<uint64_t> make_timeouts(size_t count) {
+  std::mt19937_64 rng(count);
+  std::vector<uint64_t> timeouts(count * 4);
+  for (auto& timeout : timeouts) timeout = 1 + rng() % kMaxTimeoutMs;
+  return timeouts;
+}
+
+void BM_SortedListRearm(State& state) {
+  const size_t count = state.range(0);
+  std::vector<uint64_t> timeouts = make_timeouts(count);
+  std::vector<sorted_timer_t> timers(count);
+  list_t* list = list_new(NULL);
+  for (size_t i = 0; i < count; i++) {
+    timers[i].deadline_ms = kStartMs + timeouts[i];
+    sorted_list_insert(list, &timers[i]);
+  }
+
+  uint64_t now = kStartMs;
+  size_t next = 0;
+  for (auto _ : state) {
+    sorted_timer_t* timer = &timers[next % count];
+    list_remove(list, timer);
+    timer->deadline_ms = ++now + timeouts[next % timeouts.size()];
+    sorted_list_insert(list, timer);
+    benchmark::DoNotOptimize(list_front(list));
+    next++;
+  }
+
+  list_free(list);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_TimerWheelRearm(State& state) {
+  const size_t count = state.range(0);
+  std::vector<uint64_t> timeouts = make_timeouts(count);
+  std::vector<timer_wheel_node_t> timers(count);
+  timer_wheel_t* wheel = timer_wheel_new(kStartMs);
+  for (size_t i = 0; i < count; i++) {
+    timer_wheel_node_init(&timers[i]);
+    timer_wheel_insert(wheel, &timers[i], kStartMs + timeouts[i]);
+  }
+
+  uint64_t now = kStartMs;
+  size_t next = 0;
+  for (auto _ : state) {
+    timer_wheel_node_t* timer = &timers[next % count];
+    timer_wheel_remove(wheel, timer);
+    timer_wheel_advance(wheel, ++now);
+    timer_wheel_insert(wheel, timer, now + timeouts[next % timeouts.size()]);
+    benchmark::DoNotOptimize(timer_wheel_earliest(wheel));
+    next++;
+  }
+
+  timer_wheel_free(wheel);
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(BM_SortedListRearm)->Arg(10)->Arg(100)->Arg(500)->Arg(2000);
+BENCHMARK(BM_TimerWheelRearm)->Arg(10)->Arg(100)->Arg(500)->Arg(2000);
+
+BENCHMARK_MAIN();
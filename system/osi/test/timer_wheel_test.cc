@@ -0,0 +1,187 @@
+/******************************************************************************
+ *
+ *  Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "osi/include/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kStartMs = 1000000;
+
+bool count_cb(timer_wheel_node_t* /* node */, void* context) {
+  (*static_cast<size_t*>(context))++;
+  return true;
+}
+
+}  // namespace
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  void SetUp() override { wheel_ = timer_wheel_new(kStartMs); }
+  void TearDown() override { timer_wheel_free(wheel_); }
+
+  timer_wheel_t* wheel_;
+};
+
+TEST_F(TimerWheelTest, empty) {
+  EXPECT_TRUE(timer_wheel_is_empty(wheel_));
+  EXPECT_EQ(0u, timer_wheel_size(wheel_));
+  EXPECT_EQ(nullptr, timer_wheel_earliest(wheel_));
+}
+
+TEST_F(TimerWheelTest, insert_and_remove) {
+  timer_wheel_node_t node;
+  timer_wheel_node_init(&node);
+  timer_wheel_insert(wheel_, &node, kStartMs + 100);
+  EXPECT_FALSE(timer_wheel_is_empty(wheel_));
+  EXPECT_EQ(&node, timer_wheel_earliest(wheel_));
+
+  timer_wheel_remove(wheel_, &node);
+  EXPECT_TRUE(timer_wheel_is_empty(wheel_));
+  EXPECT_EQ(nullptr, timer_wheel_earliest(wheel_));
+
+  // Removing an unlinked node is a no-op.
+  timer_wheel_remove(wheel_, &node);
+  EXPECT_TRUE(timer_wheel_is_empty(wheel_));
+}
+
+TEST_F(TimerWheelTest, earliest_across_levels) {
+  const uint64_t deadlines[] = {kStartMs + 5000000, kStartMs + 70000,
+                                kStartMs + 3,       kStartMs + 300,
+                                kStartMs + 40,      kStartMs + 5000};
+  timer_wheel_node_t nodes[6];
+  for (size_t i = 0; i < 6; i++) {
+    timer_wheel_node_init(&nodes[i]);
+    timer_wheel_insert(wheel_, &nodes[i], deadlines[i]);
+  }
+
+  std::vector<uint64_t> sorted(std::begin(deadlines), std::end(deadlines));
+  std::sort(sorted.begin(), sorted.end());
+  for (uint64_t expected : sorted) {
+    timer_wheel_node_t* earliest = timer_wheel_earliest(wheel_);
+    ASSERT_NE(nullptr, earliest);
+    EXPECT_EQ(expected, earliest->deadline_ms);
+    timer_wheel_remove(wheel_, earliest);
+  }
+  EXPECT_TRUE(timer_wheel_is_empty(wheel_));
+}
+
+TEST_F(TimerWheelTest, ties_in_insertion_order) {
+  timer_wheel_node_t nodes[10];
+  for (auto& node : nodes) {
+    timer_wheel_node_init(&node);
+    timer_wheel_insert(wheel_, &node, kStartMs + 100000);
+  }
+  timer_wheel_advance(wheel_, kStartMs + 50000);
+  timer_wheel_advance(wheel_, kStartMs + 100000);
+  for (auto& node : nodes) {
+    EXPECT_EQ(&node, timer_wheel_earliest(wheel_));
+    timer_wheel_remove(wheel_, &node);
+  }
+}
+
+TEST_F(TimerWheelTest, past_deadline_is_earliest) {
+  timer_wheel_node_t late;
+  timer_wheel_node_t overdue;
+  timer_wheel_node_init(&late);
+  timer_wheel_node_init(&overdue);
+  timer_wheel_insert(wheel_, &late, kStartMs);
+  timer_wheel_insert(wheel_, &overdue, kStartMs - 10);
+  EXPECT_EQ(&overdue, timer_wheel_earliest(wheel_));
+  timer_wheel_remove(wheel_, &overdue);
+  timer_wheel_remove(wheel_, &late);
+}
+
+TEST_F(TimerWheelTest, advance_keeps_entries) {
+  timer_wheel_node_t near;
+  timer_wheel_node_t far;
+  timer_wheel_node_init(&near);
+  timer_wheel_node_init(&far);
+  timer_wheel_insert(wheel_, &near, kStartMs + 100);
+  timer_wheel_insert(wheel_, &far, kStartMs + 100000);
+
+  timer_wheel_advance(wheel_, kStartMs + 200);
+  EXPECT_EQ(2u, timer_wheel_size(wheel_));
+  EXPECT_EQ(&near, timer_wheel_earliest(wheel_));
+  timer_wheel_remove(wheel_, &near);
+
+  timer_wheel_advance(wheel_, kStartMs + 99999);
+  EXPECT_EQ(&far, timer_wheel_earliest(wheel_));
+  timer_wheel_remove(wheel_, &far);
+}
+
+TEST_F(TimerWheelTest, foreach_visits_all) {
+  timer_wheel_node_t nodes[100];
+  for (size_t i = 0; i < 100; i++) {
+    timer_wheel_node_init(&nodes[i]);
+    timer_wheel_insert(wheel_, &nodes[i], kStartMs + i * i * i);
+  }
+  size_t count = 0;
+  timer_wheel_foreach(wheel_, count_cb, &count);
+  EXPECT_EQ(100u, count);
+  for (auto& node : nodes) timer_wheel_remove(wheel_, &node);
+}
+
+TEST_F(TimerWheelTest, matches_sorted_reference) {
+  constexpr size_t kNodes = 256;
+  std::vector<timer_wheel_node_t> nodes(kNodes);
+  for (auto& node : nodes) timer_wheel_node_init(&node);
+
+  std::mt19937_64 rng(42);
+  uint64_t now = kStartMs;
+  for (int step = 0; step < 20000; step++) {
+    timer_wheel_node_t* node = &nodes[rng() % kNodes];
+    switch (rng() % 4) {
+      case 0:
+      case 1:
+        if (!node->linked) {
+          // Mix of short, medium and very long timeouts.
+          uint64_t ranges[] = {100, 10000, 10000000, 1ull << 40};
+          timer_wheel_insert(wheel_, node, now + rng() % ranges[rng() % 4]);
+        }
+        break;
+      case 2:
+        timer_wheel_remove(wheel_, node);
+        break;
+      case 3:
+        now += rng() % 5000;
+        timer_wheel_advance(wheel_, now);
+        break;
+    }
+
+    uint64_t expected = UINT64_MAX;
+    size_t linked = 0;
+    for (const auto& n : nodes) {
+      if (!n.linked) continue;
+      linked++;
+      expected = std::min(expected, n.deadline_ms);
+    }
+    ASSERT_EQ(linked, timer_wheel_size(wheel_));
+    timer_wheel_node_t* earliest = timer_wheel_earliest(wheel_);
+    if (linked == 0) {
+      ASSERT_EQ(nullptr, earliest);
+    } else {
+      ASSERT_NE(nullptr, earliest);
+      ASSERT_EQ(expected, earliest->deadline_ms) << "step " << step;
+    }
+  }
+}
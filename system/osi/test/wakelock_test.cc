@@ -24,15 +24,23 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
-static bool is_wake_lock_acquired = false;
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<bool> is_wake_lock_acquired = false;
+static std::atomic<int> acquire_wake_lock_count = 0;
+static std::atomic<int> release_wake_lock_count = 0;
 
 static int acquire_wake_lock_cb(const char* lock_name) {
   is_wake_lock_acquired = true;
+  acquire_wake_lock_count++;
   return BT_STATUS_SUCCESS;
 }
 
 static int release_wake_lock_cb(const char* lock_name) {
   is_wake_lock_acquired = false;
+  release_wake_lock_count++;
   return BT_STATUS_SUCCESS;
 }
 
@@ -64,8 +72,10 @@ class WakelockTest : public ::testing::Test {
   int unlock_path_fd{-1};
 
   void TearDown() override {
-    is_wake_lock_acquired = false;
     wakelock_cleanup();
+    is_wake_lock_acquired = false;
+    acquire_wake_lock_count = 0;
+    release_wake_lock_count = 0;
     wakelock_set_os_callouts(NULL);
 
     // Clean up the temp wake lock directory
@@ -150,3 +160,57 @@ TEST_F(WakelockTest, test_set_paths) {
     ASSERT_FALSE(IsFileWakeLockAcquired());
   }
 }
+
+TEST_F(WakelockTest, test_repeated_acquire_and_release_are_coalesced) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+
+  wakelock_acquire();
+  wakelock_acquire();
+  ASSERT_TRUE(is_wake_lock_acquired);
+  ASSERT_EQ(acquire_wake_lock_count, 1);
+
+  wakelock_release();
+  wakelock_release();
+  ASSERT_FALSE(is_wake_lock_acquired);
+  ASSERT_EQ(release_wake_lock_count, 1);
+}
+
+TEST_F(WakelockTest, test_release_delay) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+  wakelock_set_release_delay(50);
+
+  wakelock_acquire();
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  // Acquiring again within the delay keeps the wakelock held
+  for (size_t i = 0; i < 10; i++) {
+    wakelock_release();
+    ASSERT_TRUE(is_wake_lock_acquired);
+    wakelock_acquire();
+  }
+  ASSERT_EQ(acquire_wake_lock_count, 1);
+  ASSERT_EQ(release_wake_lock_count, 0);
+
+  wakelock_release();
+  ASSERT_TRUE(is_wake_lock_acquired);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (is_wake_lock_acquired &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_FALSE(is_wake_lock_acquired);
+  ASSERT_EQ(release_wake_lock_count, 1);
+}
+
+TEST_F(WakelockTest, test_cleanup_releases_pending_release) {
+  wakelock_set_os_callouts(&bt_wakelock_callouts);
+  wakelock_set_release_delay(60 * 1000);
+
+  wakelock_acquire();
+  wakelock_release();
+  ASSERT_TRUE(is_wake_lock_acquired);
+
+  wakelock_cleanup();
+  ASSERT_FALSE(is_wake_lock_acquired);
+  ASSERT_EQ(release_wake_lock_count, 1);
+}
@@ -63,9 +63,7 @@ size_t GetFolderItemsResponseBuilder::size() const {
 
   len += 2;  // UID Counter
   len += 2;  // Number of Items;
-  for (const auto& item : items_) {
-    len += item.size();
-  }
+  len += items_size_;
 
   return len;
 }
@@ -99,10 +97,7 @@ bool GetFolderItemsResponseBuilder::AddMediaPlayer(MediaPlayerItem item) {
   log::assert_that(scope_ == Scope::MEDIA_PLAYER_LIST,
                    "assert failed: scope_ == Scope::MEDIA_PLAYER_LIST");
 
-  if (size() + item.size() > mtu_) return false;
-
-  items_.push_back(MediaListItem(item));
-  return true;
+  return AddItem(MediaListItem(std::move(item)));
 }
 
 bool GetFolderItemsResponseBuilder::AddSong(MediaElementItem item) {
@@ -110,18 +105,21 @@ bool GetFolderItemsResponseBuilder::AddSong(MediaElementItem item) {
       scope_ == Scope::VFS || scope_ == Scope::NOW_PLAYING,
       "assert failed: scope_ == Scope::VFS || scope_ == Scope::NOW_PLAYING");
 
-  if (size() + item.size() > mtu_) return false;
-
-  items_.push_back(MediaListItem(item));
-  return true;
+  return AddItem(MediaListItem(std::move(item)));
 }
 
 bool GetFolderItemsResponseBuilder::AddFolder(FolderItem item) {
   log::assert_that(scope_ == Scope::VFS, "assert failed: scope_ == Scope::VFS");
 
-  if (size() + item.size() > mtu_) return false;
+  return AddItem(MediaListItem(std::move(item)));
+}
+
+bool GetFolderItemsResponseBuilder::AddItem(MediaListItem item) {
+  size_t item_size = item.size();
+  if (size() + item_size > mtu_) return false;
 
-  items_.push_back(MediaListItem(item));
+  items_.push_back(std::move(item));
+  items_size_ += item_size;
   return true;
 }
 
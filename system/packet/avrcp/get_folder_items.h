@@ -43,6 +43,8 @@ class GetFolderItemsResponseBuilder : public BrowsePacketBuilder {
  protected:
   Scope scope_;
   std::vector<MediaListItem> items_;
+  // Sum of the sizes of items_, so that adding an item does not walk the list
+  size_t items_size_ = 0;
   Status status_;
   uint16_t uid_counter_;
   size_t mtu_;
@@ -56,6 +58,7 @@ class GetFolderItemsResponseBuilder : public BrowsePacketBuilder {
         mtu_(mtu){};
 
  private:
+  bool AddItem(MediaListItem item);
   void PushMediaListItem(const std::shared_ptr<::bluetooth::Packet>& pkt,
                          const MediaListItem& item);
   void PushMediaPlayerItem(const std::shared_ptr<::bluetooth::Packet>& pkt,
@@ -1450,7 +1450,7 @@ void Device::GetMediaPlayerListResponse(
        i <= pkt->GetEndItem() && i < players.size(); i++) {
     MediaPlayerItem item(players[i].id, players[i].name,
                          players[i].browsing_supported);
-    builder->AddMediaPlayer(item);
+    builder->AddMediaPlayer(std::move(item));
   }
 
   send_message(label, true, std::move(builder));
@@ -1496,13 +1496,14 @@ void Device::GetVFSListResponse(uint8_t label,
   for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size();
        i++) {
     if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+      const auto& folder = items[i].folder;
       // right now we always use folders of mixed type
       FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00,
                              folder.is_playable, folder.name);
-      if (!builder->AddFolder(folder_item)) break;
+      if (!builder->AddFolder(std::move(folder_item))) break;
     } else if (items[i].type == ListItem::SONG) {
-      auto song = items[i].song;
+      // items is owned by this response, the song can be moved from
+      auto& song = items[i].song;
 
       // Filter out DEFAULT_COVER_ART handle if this device has no client
       if (!HasBipClient()) {
@@ -1525,7 +1526,7 @@ void Device::GetVFSListResponse(uint8_t label,
 
       // If we fail to add a song, don't accidentally add one later that might
       // fit.
-      if (!builder->AddSong(song_item)) break;
+      if (!builder->AddSong(std::move(song_item))) break;
     }
   }
 
@@ -1546,7 +1547,8 @@ void Device::GetNowPlayingListResponse(
 
   for (size_t i = pkt->GetStartItem();
        i <= pkt->GetEndItem() && i < song_list.size(); i++) {
-    auto song = song_list[i];
+    // song_list is owned by this response, the song can be moved from
+    auto& song = song_list[i];
 
     // Filter out DEFAULT_COVER_ART handle if this device has no client
     if (!HasBipClient()) {
@@ -1567,7 +1569,7 @@ void Device::GetNowPlayingListResponse(
 
     // If we fail to add a song, don't accidentally add one later that might
     // fit.
-    if (!builder->AddSong(item)) break;
+    if (!builder->AddSong(std::move(item))) break;
   }
 
   send_message(label, true, std::move(builder));
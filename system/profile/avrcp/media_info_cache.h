@@ -0,0 +1,221 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hardware/avrcp/avrcp.h"
+
+namespace bluetooth {
+namespace avrcp {
+
+// A cache of the media information last returned by the AVRCP Media Interface
+// layer for the addressed player, so that controllers polling the current
+// track and play status are answered without a round trip to the JNI thread.
+//
+// Entries are dropped when the media layer reports a change through
+// SendMediaUpdate or SendFolderUpdate. Every change also moves the cache to a
+// new generation: a response to a request started in an earlier generation is
+// still forwarded to the device but does not fill the cache, as it may
+// describe the state from before the change.
+//
+// Not thread safe, only used on the main thread.
+class MediaInfoCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Generation = uint32_t;
+
+  // The play status is fetched again from the media layer after this time,
+  // in between the position of a playing track is extrapolated
+  static constexpr std::chrono::milliseconds kPlayStatusMaxAge{5000};
+  // Number of browsed folders kept
+  static constexpr size_t kMaxFolders = 8;
+
+  struct NowPlayingList {
+    std::string curr_media_id;
+    std::vector<SongInfo> song_list;
+  };
+
+  struct MediaPlayerList {
+    uint16_t curr_player;
+    std::vector<MediaPlayerInfo> player_list;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stale_responses = 0;
+  };
+
+  // Generation to pass back with the response of a request started now
+  Generation GetGeneration() const { return generation_; }
+
+  std::optional<SongInfo> GetSongInfo() { return Lookup(song_info_); }
+
+  void SetSongInfo(Generation generation, SongInfo song_info) {
+    Store(generation, song_info_, std::move(song_info));
+  }
+
+  std::optional<PlayStatus> GetPlayStatus(Clock::time_point now) {
+    if (play_status_.has_value() &&
+        now - play_status_time_ > kPlayStatusMaxAge) {
+      play_status_.reset();
+    }
+    auto play_status = Lookup(play_status_);
+    if (play_status.has_value() && play_status->state == PlayState::PLAYING) {
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+          now - play_status_time_);
+      uint64_t position = play_status->position + elapsed.count();
+      // A duration of 0 is reported when the track length is unknown
+      if (play_status->duration != 0) {
+        position = std::min<uint64_t>(position, play_status->duration);
+      }
+      play_status->position =
+          static_cast<uint32_t>(std::min<uint64_t>(position, UINT32_MAX));
+    }
+    return play_status;
+  }
+
+  void SetPlayStatus(Generation generation, PlayStatus play_status,
+                     Clock::time_point now) {
+    if (Store(generation, play_status_, play_status)) {
+      play_status_time_ = now;
+    }
+  }
+
+  std::optional<NowPlayingList> GetNowPlayingList() {
+    return Lookup(now_playing_list_);
+  }
+
+  void SetNowPlayingList(Generation generation, NowPlayingList list) {
+    Store(generation, now_playing_list_, std::move(list));
+  }
+
+  std::optional<MediaPlayerList> GetMediaPlayerList() {
+    return Lookup(media_player_list_);
+  }
+
+  void SetMediaPlayerList(Generation generation, MediaPlayerList list) {
+    Store(generation, media_player_list_, std::move(list));
+  }
+
+  std::optional<std::vector<ListItem>> GetFolderItems(
+      uint16_t player_id, const std::string& media_id) {
+    auto it = folder_items_.find(std::make_pair(player_id, media_id));
+    if (it == folder_items_.end()) {
+      stats_.misses++;
+      return std::nullopt;
+    }
+    stats_.hits++;
+    return it->second;
+  }
+
+  void SetFolderItems(Generation generation, uint16_t player_id,
+                      const std::string& media_id,
+                      std::vector<ListItem> items) {
+    if (generation != generation_) {
+      stats_.stale_responses++;
+      return;
+    }
+    // Browsing moves forward, the folders left behind are dropped first
+    if (folder_items_.size() >= kMaxFolders &&
+        folder_items_.find(std::make_pair(player_id, media_id)) ==
+            folder_items_.end()) {
+      folder_items_.clear();
+    }
+    folder_items_[std::make_pair(player_id, media_id)] = std::move(items);
+  }
+
+  // Drops the entries made stale by a SendMediaUpdate of the media layer
+  void OnMediaUpdate(bool track_changed, bool play_state, bool queue) {
+    generation_++;
+    if (track_changed) {
+      song_info_.reset();
+      play_status_.reset();
+      now_playing_list_.reset();
+    }
+    if (play_state) play_status_.reset();
+    if (queue) now_playing_list_.reset();
+  }
+
+  // Drops the entries made stale by a SendFolderUpdate of the media layer
+  void OnFolderUpdate(bool available_players, bool addressed_player,
+                      bool uids) {
+    if (addressed_player) {
+      Clear();
+      return;
+    }
+    generation_++;
+    if (available_players) media_player_list_.reset();
+    if (uids) {
+      now_playing_list_.reset();
+      folder_items_.clear();
+    }
+  }
+
+  void Clear() {
+    generation_++;
+    song_info_.reset();
+    play_status_.reset();
+    now_playing_list_.reset();
+    media_player_list_.reset();
+    folder_items_.clear();
+  }
+
+  const Stats& GetStats() const { return stats_; }
+
+ private:
+  template <typename T>
+  std::optional<T> Lookup(const std::optional<T>& entry) {
+    if (entry.has_value()) {
+      stats_.hits++;
+    } else {
+      stats_.misses++;
+    }
+    return entry;
+  }
+
+  template <typename T>
+  bool Store(Generation generation, std::optional<T>& entry, T value) {
+    if (generation != generation_) {
+      stats_.stale_responses++;
+      return false;
+    }
+    entry = std::move(value);
+    return true;
+  }
+
+  Generation generation_ = 0;
+  std::optional<SongInfo> song_info_;
+  std::optional<PlayStatus> play_status_;
+  Clock::time_point play_status_time_;
+  std::optional<NowPlayingList> now_playing_list_;
+  std::optional<MediaPlayerList> media_player_list_;
+  std::map<std::pair<uint16_t, std::string>, std::vector<ListItem>>
+      folder_items_;
+  Stats stats_;
+};
+
+}  // namespace avrcp
+}  // namespace bluetooth
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "media_info_cache.h"
+
+namespace bluetooth {
+namespace avrcp {
+
+using namespace std::chrono_literals;
+
+namespace {
+
+SongInfo MakeSong(std::string media_id) {
+  return SongInfo{.media_id = media_id, .attributes = {}};
+}
+
+}  // namespace
+
+class AvrcpMediaInfoCacheTest : public ::testing::Test {
+ protected:
+  MediaInfoCache cache_;
+  MediaInfoCache::Clock::time_point now_{MediaInfoCache::Clock::now()};
+};
+
+TEST_F(AvrcpMediaInfoCacheTest, song_info_until_track_change) {
+  ASSERT_FALSE(cache_.GetSongInfo().has_value());
+
+  cache_.SetSongInfo(cache_.GetGeneration(), MakeSong("1"));
+  ASSERT_EQ(cache_.GetSongInfo()->media_id, "1");
+  ASSERT_EQ(cache_.GetSongInfo()->media_id, "1");
+
+  // A play state change keeps the track
+  cache_.OnMediaUpdate(false, true, false);
+  ASSERT_EQ(cache_.GetSongInfo()->media_id, "1");
+
+  cache_.OnMediaUpdate(true, false, false);
+  ASSERT_FALSE(cache_.GetSongInfo().has_value());
+
+  ASSERT_EQ(cache_.GetStats().hits, 3u);
+  ASSERT_EQ(cache_.GetStats().misses, 2u);
+}
+
+TEST_F(AvrcpMediaInfoCacheTest, response_older_than_update_is_dropped) {
+  auto generation = cache_.GetGeneration();
+  cache_.OnMediaUpdate(true, false, false);
+  cache_.SetSongInfo(generation, MakeSong("1"));
+  ASSERT_FALSE(cache_.GetSongInfo().has_value());
+  ASSERT_EQ(cache_.GetStats().stale_responses, 1u);
+
+  cache_.SetSongInfo(cache_.GetGeneration(), MakeSong("2"));
+  ASSERT_EQ(cache_.GetSongInfo()->media_id, "2");
+}
+
+TEST_F(AvrcpMediaInfoCacheTest, play_status_position_is_extrapolated) {
+  cache_.SetPlayStatus(cache_.GetGeneration(),
+                       {.position = 1000,
+                        .duration = 4000,
+                        .state = PlayState::PLAYING},
+                       now_);
+  ASSERT_EQ(cache_.GetPlayStatus(now_ + 1500ms)->position, 2500u);
+  // The position does not go past the end of the track
+  ASSERT_EQ(cache_.GetPlayStatus(now_ + 4s)->position, 4000u);
+
+  cache_.OnMediaUpdate(false, true, false);
+  cache_.SetPlayStatus(cache_.GetGeneration(),
+                       {.position = 1000,
+                        .duration = 4000,
+                        .state = PlayState::PAUSED},
+                       now_);
+  ASSERT_EQ(cache_.GetPlayStatus(now_ + 1500ms)->position, 1000u);
+}
+
+TEST_F(AvrcpMediaInfoCacheTest, play_status_expires) {
+  cache_.SetPlayStatus(
+      cache_.GetGeneration(),
+      {.position = 0, .duration = 0, .state = PlayState::PLAYING}, now_);
+  ASSERT_EQ(cache_.GetPlayStatus(now_ + MediaInfoCache::kPlayStatusMaxAge)
+                ->position,
+            5000u);
+  ASSERT_FALSE(
+      cache_.GetPlayStatus(now_ + MediaInfoCache::kPlayStatusMaxAge + 1ms)
+          .has_value());
+}
+
+TEST_F(AvrcpMediaInfoCacheTest, folder_update) {
+  auto generation = cache_.GetGeneration();
+  cache_.SetSongInfo(generation, MakeSong("1"));
+  cache_.SetNowPlayingList(generation, {"1", {MakeSong("1"), MakeSong("2")}});
+  cache_.SetMediaPlayerList(generation, {1, {}});
+  cache_.SetFolderItems(generation, 1, "root", {});
+
+  cache_.OnFolderUpdate(false, false, true);
+  ASSERT_TRUE(cache_.GetSongInfo().has_value());
+  ASSERT_TRUE(cache_.GetMediaPlayerList().has_value());
+  ASSERT_FALSE(cache_.GetNowPlayingList().has_value());
+  ASSERT_FALSE(cache_.GetFolderItems(1, "root").has_value());
+
+  cache_.OnFolderUpdate(true, false, false);
+  ASSERT_TRUE(cache_.GetSongInfo().has_value());
+  ASSERT_FALSE(cache_.GetMediaPlayerList().has_value());
+
+  // A new addressed player has its own track
+  cache_.OnFolderUpdate(false, true, false);
+  ASSERT_FALSE(cache_.GetSongInfo().has_value());
+}
+
+TEST_F(AvrcpMediaInfoCacheTest, folder_items_per_player) {
+  cache_.SetFolderItems(cache_.GetGeneration(), 1, "root", {});
+  ASSERT_TRUE(cache_.GetFolderItems(1, "root").has_value());
+  ASSERT_FALSE(cache_.GetFolderItems(2, "root").has_value());
+
+  for (size_t i = 0; i < MediaInfoCache::kMaxFolders; i++) {
+    cache_.SetFolderItems(cache_.GetGeneration(), 1, std::to_string(i), {});
+  }
+  ASSERT_FALSE(cache_.GetFolderItems(1, "root").has_value());
+  ASSERT_TRUE(cache_.GetFolderItems(1, "7").has_value());
+}
+
+}  // namespace avrcp
+}  // namespace bluetooth
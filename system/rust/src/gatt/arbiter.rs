@@ -59,14 +59,16 @@ pub fn has_arbiter() -> bool {
 
 /// Test to see if a buffer contains a valid ATT packet with an opcode we
 /// are interested in intercepting (those intended for servers that are isolated)
+///
+/// The packet is only copied once its connection is known to be isolated.
 fn try_parse_att_server_packet(
     isolation_manager: &IsolationManager,
     tcb_idx: TransportIndex,
-    packet: Box<[u8]>,
+    packet: &[u8],
 ) -> Option<OwnedAttView> {
     isolation_manager.get_server_id(tcb_idx)?;
 
-    let att = OwnedAttView::try_parse(packet).ok()?;
+    let att = OwnedAttView::try_parse(packet.into()).ok()?;
 
     if att.view().get_opcode() == AttOpcode::EXCHANGE_MTU_REQUEST {
         // special case: this server opcode is handled by legacy stack, and we snoop
@@ -80,7 +82,9 @@ fn try_parse_att_server_packet(
     }
 }
 
-fn on_le_connect(tcb_idx: u8, advertiser: u8) {
+/// Returns whether the connection is isolated, in which case its ATT packets
+/// must be passed to intercept_packet
+fn on_le_connect(tcb_idx: u8, advertiser: u8) -> bool {
     let tcb_idx = TransportIndex(tcb_idx);
     let advertiser = AdvertiserId(advertiser);
     let is_isolated = with_arbiter(|arbiter| arbiter.is_advertiser_isolated(advertiser));
@@ -91,6 +95,7 @@ fn on_le_connect(tcb_idx: u8, advertiser: u8) {
             }
         })
     }
+    is_isolated
 }
 
 fn on_le_disconnect(tcb_idx: u8) {
@@ -113,7 +118,7 @@ fn on_le_disconnect(tcb_idx: u8) {
     }
 }
 
-fn intercept_packet(tcb_idx: u8, packet: Vec<u8>) -> InterceptAction {
+fn intercept_packet(tcb_idx: u8, packet: &[u8]) -> InterceptAction {
     // Events may be received after a FactoryReset
     // is initiated for Bluetooth and the rust arbiter is taken
     // down.
@@ -123,9 +128,8 @@ fn intercept_packet(tcb_idx: u8, packet: Vec<u8>) -> InterceptAction {
     }
 
     let tcb_idx = TransportIndex(tcb_idx);
-    if let Some(att) = with_arbiter(|arbiter| {
-        try_parse_att_server_packet(arbiter, tcb_idx, packet.into_boxed_slice())
-    }) {
+    if let Some(att) = with_arbiter(|arbiter| try_parse_att_server_packet(arbiter, tcb_idx, packet))
+    {
         do_in_rust_thread(move |modules| {
             trace!("pushing packet to GATT");
             if let Some(bearer) = modules.gatt_module.get_bearer(tcb_idx) {
@@ -188,11 +192,8 @@ mod test {
             _child_: AttReadRequestBuilder { attribute_handle: AttHandle(1).into() }.into(),
         };
 
-        let out = try_parse_att_server_packet(
-            &isolation_manager,
-            TCB_IDX,
-            packet.to_vec().unwrap().into(),
-        );
+        let out =
+            try_parse_att_server_packet(&isolation_manager, TCB_IDX, &packet.to_vec().unwrap());
 
         assert!(out.is_some());
     }
@@ -205,11 +206,8 @@ mod test {
             _child_: AttReadRequestBuilder { attribute_handle: AttHandle(1).into() }.into(),
         };
 
-        let out = try_parse_att_server_packet(
-            &isolation_manager,
-            TCB_IDX,
-            packet.to_vec().unwrap().into(),
-        );
+        let out =
+            try_parse_att_server_packet(&isolation_manager, TCB_IDX, &packet.to_vec().unwrap());
 
         assert!(out.is_none());
     }
@@ -222,11 +220,8 @@ mod test {
             _child_: AttExchangeMtuRequestBuilder { mtu: 64 }.into(),
         };
 
-        let out = try_parse_att_server_packet(
-            &isolation_manager,
-            TCB_IDX,
-            packet.to_vec().unwrap().into(),
-        );
+        let out =
+            try_parse_att_server_packet(&isolation_manager, TCB_IDX, &packet.to_vec().unwrap());
 
         assert!(out.is_none());
     }
@@ -239,11 +234,8 @@ mod test {
             _child_: AttReadRequestBuilder { attribute_handle: AttHandle(1).into() }.into(),
         };
 
-        let out = try_parse_att_server_packet(
-            &isolation_manager,
-            TCB_IDX,
-            packet.to_vec().unwrap().into(),
-        );
+        let out =
+            try_parse_att_server_packet(&isolation_manager, TCB_IDX, &packet.to_vec().unwrap());
 
         assert!(out.is_none());
     }
@@ -15,6 +15,7 @@
  */
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "a2dp"
 
 #include "a2dp_aac_decoder.h"
 
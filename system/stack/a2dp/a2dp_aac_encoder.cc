@@ -15,6 +15,7 @@
  */
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "a2dp"
 
 #include "a2dp_aac_encoder.h"
 
@@ -40,6 +41,16 @@
 // offset
 #define A2DP_AAC_OFFSET AVDT_MEDIA_OFFSET
 
+// Adaptive bit rate, in constant bit rate mode only: lowered by
+// A2DP_AAC_ABR_STEP_PERCENT of the configured bit rate as soon as this many
+// packets wait in the transmit queue, down to A2DP_AAC_ABR_MIN_PERCENT of it,
+// and raised back by one step after A2DP_AAC_ABR_RECOVERY_TICKS calls that
+// found the transmit queue empty.
+#define A2DP_AAC_ABR_CONGESTED_QUEUE_LENGTH 2
+#define A2DP_AAC_ABR_RECOVERY_TICKS 50
+#define A2DP_AAC_ABR_STEP_PERCENT 10
+#define A2DP_AAC_ABR_MIN_PERCENT 60
+
 using namespace bluetooth;
 
 namespace fmt {
@@ -90,6 +101,13 @@ typedef struct {
   tA2DP_AAC_ENCODER_PARAMS aac_encoder_params;
   tA2DP_AAC_FEEDING_STATE aac_feeding_state;
 
+  size_t TxQueueLength;
+  bool abr_enabled;            // True in constant bit rate mode
+  int configured_bit_rate;     // Bit rate of the codec configuration
+  int bit_rate;                // Current bit rate
+  size_t abr_recovery_ticks;   // Calls with an empty transmit queue
+  size_t abr_adjustments;
+
   a2dp_aac_encoder_stats_t stats;
 } tA2DP_AAC_ENCODER_CB;
 
@@ -294,6 +312,9 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
         aac_param_value, aac_error);
     return;  // TODO: Return an error?
   }
+  a2dp_aac_encoder_cb.configured_bit_rate = aac_param_value;
+  a2dp_aac_encoder_cb.bit_rate = aac_param_value;
+  a2dp_aac_encoder_cb.abr_recovery_ticks = 0;
 
   // Set the encoder's parameters: PEAK Bit Rate
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
@@ -372,6 +393,10 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
         static_cast<uint8_t>(bitrate_mode) & ~A2DP_AAC_VARIABLE_BIT_RATE_MASK;
   }
   log::info("AACENC_BITRATEMODE: {}", aac_param_value);
+  // The bit rate is ignored by the variable bit rate modes.
+  a2dp_aac_encoder_cb.abr_enabled =
+      (aac_param_value ==
+       static_cast<int>(AacEncoderBitrateMode::AACENC_BR_MODE_CBR));
   aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
                                   AACENC_BITRATEMODE, aac_param_value);
   if (aac_error != AACENC_OK) {
@@ -463,6 +488,42 @@ int a2dp_aac_get_effective_frame_size() {
   return a2dp_aac_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_aac_set_transmit_queue_length(size_t transmit_queue_length) {
+  a2dp_aac_encoder_cb.TxQueueLength = transmit_queue_length;
+  if (!a2dp_aac_encoder_cb.abr_enabled) return;
+
+  int configured_bit_rate = a2dp_aac_encoder_cb.configured_bit_rate;
+  int step = configured_bit_rate / 100 * A2DP_AAC_ABR_STEP_PERCENT;
+  int bit_rate = a2dp_aac_encoder_cb.bit_rate;
+  if (transmit_queue_length >= A2DP_AAC_ABR_CONGESTED_QUEUE_LENGTH) {
+    a2dp_aac_encoder_cb.abr_recovery_ticks = 0;
+    bit_rate = std::max(bit_rate - step, configured_bit_rate / 100 *
+                                             A2DP_AAC_ABR_MIN_PERCENT);
+  } else if (transmit_queue_length != 0 || bit_rate >= configured_bit_rate) {
+    a2dp_aac_encoder_cb.abr_recovery_ticks = 0;
+  } else if (++a2dp_aac_encoder_cb.abr_recovery_ticks >=
+             A2DP_AAC_ABR_RECOVERY_TICKS) {
+    a2dp_aac_encoder_cb.abr_recovery_ticks = 0;
+    bit_rate = std::min(bit_rate + step, configured_bit_rate);
+  }
+  if (bit_rate == a2dp_aac_encoder_cb.bit_rate) return;
+
+  // The encoder applies a new bit rate from the next frame on.
+  AACENC_ERROR aac_error = aacEncoder_SetParam(a2dp_aac_encoder_cb.aac_handle,
+                                               AACENC_BITRATE, bit_rate);
+  if (aac_error != AACENC_OK) {
+    log::error(
+        "Cannot set AAC parameter AACENC_BITRATE to {}: AAC error 0x{:x}",
+        bit_rate, aac_error);
+    a2dp_aac_encoder_cb.abr_enabled = false;
+    return;
+  }
+  log::info("bit rate {} -> {}, transmit queue length {}",
+            a2dp_aac_encoder_cb.bit_rate, bit_rate, transmit_queue_length);
+  a2dp_aac_encoder_cb.bit_rate = bit_rate;
+  a2dp_aac_encoder_cb.abr_adjustments++;
+}
+
 void a2dp_aac_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
@@ -710,6 +771,19 @@ void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
       ((codec_specific_1 & ~A2DP_AAC_VARIABLE_BIT_RATE_MASK) == 0 ? "Constant"
                                                                   : "Variable"),
       codec_specific_1);
+  if (a2dp_aac_encoder_cb.abr_enabled) {
+    dprintf(fd,
+            "  AAC bit rate (current/configured)                       : %d / "
+            "%d\n",
+            a2dp_aac_encoder_cb.bit_rate,
+            a2dp_aac_encoder_cb.configured_bit_rate);
+    dprintf(fd,
+            "  AAC adaptive bit rate adjustments                       : %zu\n",
+            a2dp_aac_encoder_cb.abr_adjustments);
+  }
+  dprintf(fd,
+          "  AAC saved transmit queue length                         : %zu\n",
+          a2dp_aac_encoder_cb.TxQueueLength);
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_aac_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_aac_get_effective_frame_size());
@@ -15,6 +15,7 @@
  */
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "a2dp"
 
 #include <bluetooth/log.h>
 #include <inttypes.h>
@@ -251,6 +252,9 @@ int a2dp_aac_get_effective_frame_size() {
   return a2dp_aac_encoder_cb.TxAaMtuSize;
 }
 
+// The bit rate of the ffmpeg encoder is fixed once it is opened.
+void a2dp_aac_set_transmit_queue_length(size_t /* transmit_queue_length */) {}
+
 void a2dp_aac_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
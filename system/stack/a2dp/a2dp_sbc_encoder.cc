@@ -18,6 +18,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "a2dp"
 
 #include "a2dp_sbc_encoder.h"
 
@@ -25,6 +26,8 @@
 #include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "a2dp_sbc.h"
 #include "a2dp_sbc_up_sample.h"
 #include "common/time_util.h"
@@ -52,6 +55,16 @@
 /* Define the bitrate step when trying to match bitpool value */
 #define A2DP_SBC_BITRATE_STEP 5
 
+/* Adaptive bitpool: lowered by A2DP_SBC_ABR_BITPOOL_STEP as soon as this many
+ * packets wait in the transmit queue, and raised back by the same step after
+ * A2DP_SBC_ABR_RECOVERY_TICKS calls that found the transmit queue empty. The
+ * bitpool is not lowered below the middle quality bitpool recommended by the
+ * A2DP specification, nor below the bitpool of the codec configuration. */
+#define A2DP_SBC_ABR_CONGESTED_QUEUE_LENGTH 2
+#define A2DP_SBC_ABR_RECOVERY_TICKS 50
+#define A2DP_SBC_ABR_BITPOOL_STEP 6
+#define A2DP_SBC_ABR_MIN_BITPOOL 35
+
 /* Readability constants */
 #define A2DP_SBC_FRAME_HEADER_SIZE_BYTES 4  // A2DP Spec v1.3, 12.4, Table 12.12
 #define A2DP_SBC_SCALE_FACTOR_BITS 4        // A2DP Spec v1.3, 12.4, Table 12.13
@@ -98,6 +111,12 @@ typedef struct {
   tA2DP_SBC_FEEDING_STATE feeding_state;
   int16_t pcmBuffer[SBC_MAX_PCM_BUFFER_SIZE];
 
+  size_t TxQueueLength;
+  int16_t configured_bitpool;   /* Bitpool of the codec configuration */
+  int16_t abr_min_bitpool;      /* Floor of the adaptive bitpool */
+  size_t abr_recovery_ticks;    /* Calls with an empty transmit queue */
+  size_t abr_adjustments;
+
   a2dp_sbc_encoder_stats_t stats;
 } tA2DP_SBC_ENCODER_CB;
 
@@ -330,6 +349,15 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   /* Reset the SBC encoder */
   SBC_Encoder_Init(&a2dp_sbc_encoder_cb.sbc_encoder_params);
   a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+
+  /* The frames per packet are computed for the configured bitpool, the
+   * smaller frames of a lowered bitpool still fit. */
+  a2dp_sbc_encoder_cb.configured_bitpool = p_encoder_params->s16BitPool;
+  a2dp_sbc_encoder_cb.abr_min_bitpool =
+      std::max<int16_t>(min_bitpool,
+                        std::min<int16_t>(A2DP_SBC_ABR_MIN_BITPOOL,
+                                          p_encoder_params->s16BitPool));
+  a2dp_sbc_encoder_cb.abr_recovery_ticks = 0;
 }
 
 void a2dp_sbc_encoder_cleanup(void) {
@@ -380,6 +408,33 @@ void a2dp_sbc_send_frames(uint64_t timestamp_us) {
   }
 }
 
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length) {
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+  int16_t bitpool = p_encoder_params->s16BitPool;
+  a2dp_sbc_encoder_cb.TxQueueLength = transmit_queue_length;
+
+  if (transmit_queue_length >= A2DP_SBC_ABR_CONGESTED_QUEUE_LENGTH) {
+    a2dp_sbc_encoder_cb.abr_recovery_ticks = 0;
+    bitpool = std::max<int16_t>(bitpool - A2DP_SBC_ABR_BITPOOL_STEP,
+                                a2dp_sbc_encoder_cb.abr_min_bitpool);
+  } else if (transmit_queue_length != 0 ||
+             bitpool >= a2dp_sbc_encoder_cb.configured_bitpool) {
+    a2dp_sbc_encoder_cb.abr_recovery_ticks = 0;
+  } else if (++a2dp_sbc_encoder_cb.abr_recovery_ticks >=
+             A2DP_SBC_ABR_RECOVERY_TICKS) {
+    a2dp_sbc_encoder_cb.abr_recovery_ticks = 0;
+    bitpool = std::min<int16_t>(bitpool + A2DP_SBC_ABR_BITPOOL_STEP,
+                                a2dp_sbc_encoder_cb.configured_bitpool);
+  }
+  if (bitpool == p_encoder_params->s16BitPool) return;
+
+  log::info("bitpool {} -> {}, transmit queue length {}",
+            p_encoder_params->s16BitPool, bitpool, transmit_queue_length);
+  // The bitpool is read for each frame, and written in its header.
+  p_encoder_params->s16BitPool = bitpool;
+  a2dp_sbc_encoder_cb.abr_adjustments++;
+}
+
 // Obtains the number of frames to send and number of iterations
 // to be used. |num_of_iterations| and |num_of_frames| parameters
 // are used as output param for returning the respective values.
@@ -887,6 +942,19 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
         A2DP_GetMinBitpoolSbc(codec_info), A2DP_GetMaxBitpoolSbc(codec_info));
   }
 
+  dprintf(fd,
+          "  SBC Bitpool (current/configured/adaptive floor)         : %d / %d "
+          "/ %d\n",
+          a2dp_sbc_encoder_cb.sbc_encoder_params.s16BitPool,
+          a2dp_sbc_encoder_cb.configured_bitpool,
+          a2dp_sbc_encoder_cb.abr_min_bitpool);
+  dprintf(fd,
+          "  SBC adaptive bitpool adjustments                        : %zu\n",
+          a2dp_sbc_encoder_cb.abr_adjustments);
+  dprintf(fd,
+          "  SBC saved transmit queue length                         : %zu\n",
+          a2dp_sbc_encoder_cb.TxQueueLength);
+
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_sbc_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_sbc_get_effective_frame_size());
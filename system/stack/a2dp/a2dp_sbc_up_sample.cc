@@ -25,6 +25,16 @@
 
 #include "a2dp_sbc_up_sample.h"
 
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define A2DP_SBC_UPS_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define A2DP_SBC_UPS_SSE2
+#endif
+
 typedef int(tA2DP_SBC_ACT)(void* p_src, void* p_dst, uint32_t src_samples,
                            uint32_t dst_samples, uint32_t* p_ret);
 
@@ -42,6 +52,82 @@ typedef struct {
 
 tA2DP_SBC_UPS_CB a2dp_sbc_ups_cb;
 
+/*******************************************************************************
+ *
+ * Function         a2dp_sbc_repeat_frames_16s
+ *
+ * Description      Writes each of the n_frames 16 bits stereo frames of p_src
+ *                  ratio times in a row to p_dst: the up sampling to a rate
+ *                  multiple of the source one.
+ *                  The frames are copied as 32 bits words, four source frames
+ *                  at a time with NEON or SSE2 for the ratios 2, 3 and 4
+ *                  (e.g. 24 kHz or 16 kHz to 48 kHz). The buffers are only
+ *                  required to be 16 bits aligned.
+ *
+ * Returns          none
+ *
+ ******************************************************************************/
+static void a2dp_sbc_repeat_frames_16s(const uint8_t* p_src, uint8_t* p_dst,
+                                       uint32_t n_frames, uint32_t ratio) {
+  if (ratio == 1) {
+    memcpy(p_dst, p_src, n_frames * 4);
+    return;
+  }
+
+#if defined(A2DP_SBC_UPS_NEON)
+  for (; n_frames >= 4 && ratio >= 2 && ratio <= 4; n_frames -= 4) {
+    uint32x4_t v = vreinterpretq_u32_u8(vld1q_u8(p_src));
+    if (ratio == 2) {
+      uint32x4x2_t out = {{v, v}};
+      vst2q_u32((uint32_t*)p_dst, out);
+    } else if (ratio == 3) {
+      uint32x4x3_t out = {{v, v, v}};
+      vst3q_u32((uint32_t*)p_dst, out);
+    } else {
+      uint32x4x4_t out = {{v, v, v, v}};
+      vst4q_u32((uint32_t*)p_dst, out);
+    }
+    p_src += 16;
+    p_dst += 16 * ratio;
+  }
+#elif defined(A2DP_SBC_UPS_SSE2)
+  for (; n_frames >= 4 && ratio >= 2 && ratio <= 4; n_frames -= 4) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p_src);
+    __m128i* p_out = (__m128i*)p_dst;
+    if (ratio == 2) {
+      _mm_storeu_si128(p_out, _mm_unpacklo_epi32(v, v));
+      _mm_storeu_si128(p_out + 1, _mm_unpackhi_epi32(v, v));
+    } else if (ratio == 3) {
+      _mm_storeu_si128(p_out, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 0, 0)));
+      _mm_storeu_si128(p_out + 1,
+                       _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 1, 1)));
+      _mm_storeu_si128(p_out + 2,
+                       _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 2)));
+    } else {
+      _mm_storeu_si128(p_out, _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+      _mm_storeu_si128(p_out + 1,
+                       _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1)));
+      _mm_storeu_si128(p_out + 2,
+                       _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2)));
+      _mm_storeu_si128(p_out + 3,
+                       _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+    p_src += 16;
+    p_dst += 16 * ratio;
+  }
+#endif
+
+  while (n_frames--) {
+    uint32_t frame;
+    memcpy(&frame, p_src, 4);
+    p_src += 4;
+    for (uint32_t i = 0; i < ratio; i++) {
+      memcpy(p_dst, &frame, 4);
+      p_dst += 4;
+    }
+  }
+}
+
 /*******************************************************************************
  *
  * Function         a2dp_sbc_init_up_sample
@@ -164,6 +250,26 @@ int a2dp_sbc_up_sample_16s(void* p_src, void* p_dst, uint32_t src_samples,
 
   a2dp_sbc_ups_cb.cur_pos = dst_sps;
 
+  /* With a rate multiple of the source one, every source frame is repeated
+   * the same number of times: expand the whole frames at once and leave the
+   * one cut by the end of p_dst to the loop below */
+  if (src_sps != 0 && dst_sps % src_sps == 0) {
+    uint32_t ratio = dst_sps / src_sps;
+    uint32_t n_frames = dst_samples / ratio;
+    if (n_frames > src_samples) n_frames = src_samples;
+
+    if (n_frames > 0) {
+      a2dp_sbc_repeat_frames_16s((uint8_t*)p_src_tmp, (uint8_t*)p_dst_tmp,
+                                 n_frames, ratio);
+      p_src_tmp += 2 * n_frames;
+      p_dst_tmp += 2 * n_frames * ratio;
+      *p_worker1 = p_src_tmp[-2];
+      *p_worker2 = p_src_tmp[-1];
+      src_samples -= n_frames;
+      dst_samples -= n_frames * ratio;
+    }
+  }
+
   while (src_samples-- && dst_samples) {
     *p_worker1 = *p_src_tmp++;
     *p_worker2 = *p_src_tmp++;
@@ -19,7 +19,7 @@
 #include <base/functional/bind.h>
 #include <bluetooth/log.h>
 
-#include <iterator>
+#include <algorithm>
 
 #include "osi/include/allocator.h"
 #include "stack/gatt/gatt_int.h"
@@ -33,9 +33,10 @@ namespace arbiter {
 
 namespace {
 struct RustArbiterCallbacks {
-  ::rust::Fn<void(uint8_t tcb_idx, uint8_t advertiser)> on_le_connect;
+  ::rust::Fn<bool(uint8_t tcb_idx, uint8_t advertiser)> on_le_connect;
   ::rust::Fn<void(uint8_t tcb_idx)> on_le_disconnect;
-  ::rust::Fn<InterceptAction(uint8_t tcb_idx, ::rust::Vec<uint8_t> buffer)>
+  ::rust::Fn<InterceptAction(uint8_t tcb_idx,
+                             ::rust::Slice<const uint8_t> buffer)>
       intercept_packet;
   ::rust::Fn<void(uint8_t tcb_idx)> on_outgoing_mtu_req;
   ::rust::Fn<void(uint8_t tcb_idx, size_t mtu)> on_incoming_mtu_resp;
@@ -50,7 +51,7 @@ void AclArbiter::OnLeConnect(uint8_t tcb_idx, uint16_t advertiser_id) {
   return;
 #endif
   log::info("Notifying Rust of LE connection");
-  callbacks_.on_le_connect(tcb_idx, advertiser_id);
+  isolated_tcbs_[tcb_idx] = callbacks_.on_le_connect(tcb_idx, advertiser_id);
 }
 
 void AclArbiter::OnLeDisconnect(uint8_t tcb_idx) {
@@ -58,6 +59,7 @@ void AclArbiter::OnLeDisconnect(uint8_t tcb_idx) {
   return;
 #endif
   log::info("Notifying Rust of LE disconnection");
+  isolated_tcbs_[tcb_idx] = false;
   callbacks_.on_le_disconnect(tcb_idx);
 }
 
@@ -66,14 +68,18 @@ InterceptAction AclArbiter::InterceptAttPacket(uint8_t tcb_idx,
 #ifdef TARGET_FLOSS
   return InterceptAction::FORWARD;
 #endif
-  log::debug("Intercepting ATT packet and forwarding to Rust");
+  // Rust only ever intercepts packets of isolated connections, don't cross the
+  // FFI for the others
+  if (!isolated_tcbs_[tcb_idx]) {
+    return InterceptAction::FORWARD;
+  }
 
-  uint8_t* packet_start = (uint8_t*)(packet + 1) + packet->offset;
-  uint8_t* packet_end = packet_start + packet->len;
+  log::debug("Intercepting ATT packet and forwarding to Rust");
 
-  auto vec = ::rust::Vec<uint8_t>();
-  std::copy(packet_start, packet_end, std::back_inserter(vec));
-  return callbacks_.intercept_packet(tcb_idx, std::move(vec));
+  // Rust copies the packet only if it ends up intercepting it
+  const uint8_t* packet_start = (const uint8_t*)(packet + 1) + packet->offset;
+  return callbacks_.intercept_packet(
+      tcb_idx, ::rust::Slice<const uint8_t>(packet_start, packet->len));
 }
 
 void AclArbiter::OnOutgoingMtuReq(uint8_t tcb_idx) {
@@ -127,9 +133,10 @@ void AclArbiter::SendPacketToPeer(uint8_t tcb_idx,
 }
 
 void StoreCallbacksFromRust(
-    ::rust::Fn<void(uint8_t tcb_idx, uint8_t advertiser)> on_le_connect,
+    ::rust::Fn<bool(uint8_t tcb_idx, uint8_t advertiser)> on_le_connect,
     ::rust::Fn<void(uint8_t tcb_idx)> on_le_disconnect,
-    ::rust::Fn<InterceptAction(uint8_t tcb_idx, ::rust::Vec<uint8_t> buffer)>
+    ::rust::Fn<InterceptAction(uint8_t tcb_idx,
+                               ::rust::Slice<const uint8_t> buffer)>
         intercept_packet,
     ::rust::Fn<void(uint8_t tcb_idx)> on_outgoing_mtu_req,
     ::rust::Fn<void(uint8_t tcb_idx, size_t mtu)> on_incoming_mtu_resp,
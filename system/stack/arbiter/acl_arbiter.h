@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <bitset>
+#include <cstdint>
+
 #include "rust/cxx.h"
 #include "stack/include/bt_hdr.h"
 #include "types/raw_address.h"
@@ -53,12 +56,18 @@ class AclArbiter {
   AclArbiter(AclArbiter&& other) = default;
   AclArbiter& operator=(AclArbiter&& other) = default;
   ~AclArbiter() = default;
+
+ private:
+  /// Connections, by tcb_idx, that Rust isolated when they were established.
+  /// Only the ATT packets of those are handed over to Rust.
+  std::bitset<UINT8_MAX + 1> isolated_tcbs_;
 };
 
 void StoreCallbacksFromRust(
-    ::rust::Fn<void(uint8_t tcb_idx, uint8_t advertiser)> on_le_connect,
+    ::rust::Fn<bool(uint8_t tcb_idx, uint8_t advertiser)> on_le_connect,
     ::rust::Fn<void(uint8_t tcb_idx)> on_le_disconnect,
-    ::rust::Fn<InterceptAction(uint8_t tcb_idx, ::rust::Vec<uint8_t> buffer)>
+    ::rust::Fn<InterceptAction(uint8_t tcb_idx,
+                               ::rust::Slice<const uint8_t> buffer)>
         intercept_packet,
     ::rust::Fn<void(uint8_t tcb_idx)> on_outgoing_mtu_req,
     ::rust::Fn<void(uint8_t tcb_idx, size_t mtu)> on_incoming_mtu_resp,
@@ -21,6 +21,7 @@
  *  This module contains action functions of the link control state machine.
  *
  ******************************************************************************/
+#include <algorithm>
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 #include <string.h>
@@ -43,6 +44,27 @@ const uint8_t avct_lcb_pkt_type_len[] = {AVCT_HDR_LEN_SINGLE,
                                          AVCT_HDR_LEN_START, AVCT_HDR_LEN_CONT,
                                          AVCT_HDR_LEN_END};
 
+/*******************************************************************************
+ *
+ * Function         avct_lcb_rx_msg_size
+ *
+ * Description      Size of the buffer reassembling the message started by
+ *                  p_buf. The start packet announces the number of packets of
+ *                  the message and the following ones carry at most our MTU,
+ *                  so small messages do not take the largest buffer.
+ *
+ *
+ * Returns          Buffer size, at most BT_DEFAULT_BUFFER_SIZE.
+ *
+ ******************************************************************************/
+static uint16_t avct_lcb_rx_msg_size(const BT_HDR* p_buf, uint8_t nosp) {
+  size_t size = sizeof(BT_HDR) + p_buf->offset + p_buf->len;
+  if (nosp > 1) {
+    size += (nosp - 1) * (kAvrcMtu - AVCT_HDR_LEN_CONT);
+  }
+  return (uint16_t)std::min<size_t>(size, BT_DEFAULT_BUFFER_SIZE);
+}
+
 /*******************************************************************************
  *
  * Function         avct_lcb_msg_asmbl
@@ -102,7 +124,8 @@ static BT_HDR* avct_lcb_msg_asmbl(tAVCT_LCB* p_lcb, BT_HDR* p_buf) {
       p_ret = NULL;
       return p_ret;
     }
-    p_lcb->p_rx_msg = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+    p_lcb->rx_msg_size = avct_lcb_rx_msg_size(p_buf, *(p + 1));
+    p_lcb->p_rx_msg = (BT_HDR*)osi_malloc(p_lcb->rx_msg_size);
     memcpy(p_lcb->p_rx_msg, p_buf, sizeof(BT_HDR) + p_buf->offset + p_buf->len);
 
     /* Free original buffer */
@@ -130,17 +153,26 @@ static BT_HDR* avct_lcb_msg_asmbl(tAVCT_LCB* p_lcb, BT_HDR* p_buf) {
       log::warn("Pkt type={} out of order", pkt_type);
       p_ret = NULL;
     } else {
-      /* get size of buffer holding assembled message */
-      /*
-       * NOTE: The buffer is allocated above at the beginning of the
-       * reassembly, and is always of size BT_DEFAULT_BUFFER_SIZE.
-       */
-      uint16_t buf_len = BT_DEFAULT_BUFFER_SIZE - sizeof(BT_HDR);
-
       /* adjust offset and len of fragment for header byte */
       p_buf->offset += AVCT_HDR_LEN_CONT;
       p_buf->len -= AVCT_HDR_LEN_CONT;
 
+      /* the peer sent more than announced in the start packet, move to the
+       * largest buffer */
+      if ((sizeof(BT_HDR) + p_lcb->p_rx_msg->offset + p_buf->len) >
+              p_lcb->rx_msg_size &&
+          p_lcb->rx_msg_size < BT_DEFAULT_BUFFER_SIZE) {
+        BT_HDR* p_rx_msg = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+        memcpy(p_rx_msg, p_lcb->p_rx_msg,
+               sizeof(BT_HDR) + p_lcb->p_rx_msg->offset);
+        osi_free(p_lcb->p_rx_msg);
+        p_lcb->p_rx_msg = p_rx_msg;
+        p_lcb->rx_msg_size = BT_DEFAULT_BUFFER_SIZE;
+      }
+
+      /* get size of buffer holding assembled message */
+      uint16_t buf_len = p_lcb->rx_msg_size - sizeof(BT_HDR);
+
       /* verify length */
       if ((p_lcb->p_rx_msg->offset + p_buf->len) > buf_len) {
         /* won't fit; free everything */
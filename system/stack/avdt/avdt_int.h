@@ -31,6 +31,7 @@
 #include "avdtc_api.h"
 #include "internal_include/bt_target.h"
 #include "l2c_api.h"
+#include "l2cdefs.h"
 #include "osi/include/alarm.h"
 #include "osi/include/fixed_queue.h"
 #include "stack/include/bt_hdr.h"
@@ -81,6 +82,12 @@ enum {
 */
 #define AVDT_MSG_OFFSET (L2CAP_MIN_OFFSET + AVDT_NUM_SEPS + AVDT_LEN_TYPE_START)
 
+/* headroom a media packet must have in front of its payload (or of its media
+ * packet header) for L2CAP and HCI to prepend their headers in place; the
+ * media transport channel is always in basic mode
+*/
+#define AVDT_MEDIA_L2CAP_HEADROOM (L2CAP_PKT_OVERHEAD + HCI_DATA_PREAMBLE_SIZE)
+
 /* scb transport channel connect timeout value (in milliseconds) */
 #define AVDT_SCB_TC_CONN_TIMEOUT_MS (10 * 1000)
 
@@ -416,6 +423,8 @@ class AvdtpScb {
         p_pkt(nullptr),
         p_ccb(nullptr),
         media_seq(0),
+        media_hdr{},
+        media_hdr_valid(false),
         allocated(false),
         in_use(false),
         role(0),
@@ -465,6 +474,7 @@ class AvdtpScb {
     p_pkt = nullptr;
     p_ccb = nullptr;
     media_seq = 0;
+    media_hdr_valid = false;
     allocated = false;
     in_use = false;
     role = 0;
@@ -489,6 +499,8 @@ class AvdtpScb {
   BT_HDR* p_pkt;                     // Packet waiting to be sent
   AvdtpCcb* p_ccb;                   // CCB associated with this SCB
   uint16_t media_seq;                // Media packet sequence number
+  uint8_t media_hdr[AVDT_MEDIA_HDR_SIZE];  // Media packet header template
+  bool media_hdr_valid;              // True if media_hdr is built
   bool allocated;                    // True if the SCB is allocated
   bool in_use;                       // True if used by peer
   uint8_t role;        // Initiator/acceptor role in current procedure
@@ -844,6 +856,7 @@ uint8_t avdt_scb_verify(AvdtpCcb* p_ccb, uint8_t state, uint8_t* p_seid,
                         uint16_t num_seid, uint8_t* p_err_code);
 void avdt_scb_peer_seid_list(tAVDT_MULTI* p_multi);
 uint32_t avdt_scb_gen_ssrc(AvdtpScb* p_scb);
+void avdt_scb_build_media_hdr(AvdtpScb* p_scb);
 
 /* SCB action functions */
 void avdt_scb_hdl_abort_cmd(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data);
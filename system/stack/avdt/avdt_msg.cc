@@ -27,6 +27,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth-a2dp"
+#define OSI_ALLOC_TAG "avdt"
 
 #include <bluetooth/log.h>
 #include <string.h>
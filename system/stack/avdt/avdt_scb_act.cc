@@ -74,6 +74,34 @@ uint32_t avdt_scb_gen_ssrc(AvdtpScb* p_scb) {
                      p_scb->stream_config.cfg.codec_info[2]));
 }
 
+/* The encoders reserve AVDT_MEDIA_OFFSET in front of their payload, which must
+ * leave room for all the headers prepended down to HCI. */
+static_assert(AVDT_MEDIA_OFFSET >= AVDT_MEDIA_HDR_SIZE + AVDT_MEDIA_L2CAP_HEADROOM,
+              "AVDT_MEDIA_OFFSET too small for the media packet headers");
+
+/*******************************************************************************
+ *
+ * Function         avdt_scb_build_media_hdr
+ *
+ * Description      This function builds the media packet header template of
+ *                  the stream: the fields constant for the stream are set
+ *                  once, the payload type, sequence number and timestamp
+ *                  are patched in each packet.
+ *
+ * Returns          Nothing.
+ *
+ ******************************************************************************/
+void avdt_scb_build_media_hdr(AvdtpScb* p_scb) {
+  uint8_t* p = p_scb->media_hdr;
+
+  UINT8_TO_BE_STREAM(p, AVDT_MEDIA_OCTET1);
+  UINT8_TO_BE_STREAM(p, 0);
+  UINT16_TO_BE_STREAM(p, 0);
+  UINT32_TO_BE_STREAM(p, 0);
+  UINT32_TO_BE_STREAM(p, avdt_scb_gen_ssrc(p_scb));
+  p_scb->media_hdr_valid = true;
+}
+
 /*******************************************************************************
  *
  * Function         avdt_scb_hdl_abort_cmd
@@ -794,6 +822,7 @@ void avdt_scb_hdl_tc_close(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
   /* clear sep variables */
   avdt_scb_clr_vars(p_scb, p_data);
   p_scb->media_seq = 0;
+  p_scb->media_hdr_valid = false;
   p_scb->cong = false;
 
   /* free pkt we're holding, if any */
@@ -984,8 +1013,8 @@ void avdt_scb_hdl_tc_open_sto(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
  *
  ******************************************************************************/
 void avdt_scb_hdl_write_req(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
+  BT_HDR* p_buf = p_data->apiwrite.p_buf;
   uint8_t* p;
-  uint32_t ssrc;
   bool add_rtp_header = !(p_data->apiwrite.opt & AVDT_DATA_OPT_NO_RTP);
 
   /* free packet we're holding, if any; to be replaced with new */
@@ -1002,28 +1031,40 @@ void avdt_scb_hdl_write_req(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
         A2DP_UsesRtpHeader(is_content_protection, p_scb->curr_cfg.codec_info);
   }
 
+  /* The headers are prepended in place down to HCI, the buffer must have been
+   * allocated with the headroom for all of them. */
+  uint16_t headroom = AVDT_MEDIA_L2CAP_HEADROOM;
+  if (add_rtp_header) {
+    headroom += AVDT_MEDIA_HDR_SIZE;
+  }
+  if (p_buf->offset < headroom) {
+    log::error("Dropped media packet; offset {} below headroom {}",
+               p_buf->offset, headroom);
+    osi_free(p_buf);
+    return;
+  }
+
   /* Build a media packet, and add an RTP header if required. */
   if (add_rtp_header) {
-    if (p_data->apiwrite.p_buf->offset < AVDT_MEDIA_HDR_SIZE) {
-      return;
+    if (!p_scb->media_hdr_valid) {
+      avdt_scb_build_media_hdr(p_scb);
     }
 
-    ssrc = avdt_scb_gen_ssrc(p_scb);
-
-    p_data->apiwrite.p_buf->len += AVDT_MEDIA_HDR_SIZE;
-    p_data->apiwrite.p_buf->offset -= AVDT_MEDIA_HDR_SIZE;
+    p_buf->len += AVDT_MEDIA_HDR_SIZE;
+    p_buf->offset -= AVDT_MEDIA_HDR_SIZE;
     p_scb->media_seq++;
-    p = (uint8_t*)(p_data->apiwrite.p_buf + 1) + p_data->apiwrite.p_buf->offset;
+    p = (uint8_t*)(p_buf + 1) + p_buf->offset;
 
-    UINT8_TO_BE_STREAM(p, AVDT_MEDIA_OCTET1);
+    /* copy the template, then patch the per packet fields */
+    memcpy(p, p_scb->media_hdr, AVDT_MEDIA_HDR_SIZE);
+    p++;
     UINT8_TO_BE_STREAM(p, p_data->apiwrite.m_pt);
     UINT16_TO_BE_STREAM(p, p_scb->media_seq);
     UINT32_TO_BE_STREAM(p, p_data->apiwrite.time_stamp);
-    UINT32_TO_BE_STREAM(p, ssrc);
   }
 
   /* store it */
-  p_scb->p_pkt = p_data->apiwrite.p_buf;
+  p_scb->p_pkt = p_buf;
 }
 
 /*******************************************************************************
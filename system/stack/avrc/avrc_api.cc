@@ -315,6 +315,46 @@ static void avrc_prep_end_frag(uint8_t handle) {
       p_data, (p_pkt_new->len - AVRC_VENDOR_HDR_SIZE - AVRC_MIN_META_HDR_SIZE));
 }
 
+/******************************************************************************
+ *
+ * Function         avrc_slice_frag
+ *
+ * Description      This function slices the next fragment off the serialized
+ *                  response held in the fragmentation control block, and
+ *                  prepares the left over as an end fragment.
+ *
+ * Returns          The fragment to send, of type pkt_type.
+ *
+ *****************************************************************************/
+static BT_HDR* avrc_slice_frag(uint8_t handle, uint8_t pkt_type) {
+  tAVRC_FRAG_CB* p_fcb = &avrc_cb.fcb[handle];
+  BT_HDR* p_fmsg = p_fcb->p_fmsg;
+  BT_HDR* p_pkt;
+  uint8_t* p_data;
+
+  /* the whole fragment is copied over, no need to clear the buffer */
+  p_pkt = (BT_HDR*)osi_malloc(BT_HDR_SIZE + AVCT_MSG_OFFSET +
+                              AVRC_MAX_CTRL_DATA_LEN);
+  p_pkt->len = AVRC_MAX_CTRL_DATA_LEN;
+  p_pkt->offset = AVCT_MSG_OFFSET;
+  p_pkt->layer_specific = p_fmsg->layer_specific;
+  p_pkt->event = p_fmsg->event;
+  p_data = (uint8_t*)(p_pkt + 1) + p_pkt->offset;
+  memcpy(p_data, (uint8_t*)(p_fmsg + 1) + p_fmsg->offset,
+         AVRC_MAX_CTRL_DATA_LEN);
+
+  p_data += AVRC_VENDOR_HDR_SIZE;
+  p_data++; /* pdu */
+  *p_data++ = pkt_type;
+  /* 4=pdu, pkt_type & len */
+  UINT16_TO_BE_STREAM(p_data, (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE -
+                               AVRC_MIN_META_HDR_SIZE));
+
+  /* prepare the left over for as an end fragment */
+  avrc_prep_end_frag(handle);
+  return p_pkt;
+}
+
 /******************************************************************************
  *
  * Function         avrc_send_continue_frag
@@ -327,8 +367,7 @@ static void avrc_prep_end_frag(uint8_t handle) {
  *****************************************************************************/
 static uint16_t avrc_send_continue_frag(uint8_t handle, uint8_t label) {
   tAVRC_FRAG_CB* p_fcb;
-  BT_HDR *p_pkt_old, *p_pkt;
-  uint8_t *p_old, *p_data;
+  BT_HDR* p_pkt;
   uint8_t cr = AVCT_RSP;
 
   p_fcb = &avrc_cb.fcb[handle];
@@ -336,26 +375,8 @@ static uint16_t avrc_send_continue_frag(uint8_t handle, uint8_t label) {
 
   log::verbose("handle = {} label = {} len = {}", handle, label, p_pkt->len);
   if (p_pkt->len > AVRC_MAX_CTRL_DATA_LEN) {
-    int offset_len = MAX(AVCT_MSG_OFFSET, p_pkt->offset);
-    p_pkt_old = p_fcb->p_fmsg;
-    p_pkt = (BT_HDR*)osi_calloc(AVRC_PACKET_LEN + offset_len + BT_HDR_SIZE);
-    p_pkt->len = AVRC_MAX_CTRL_DATA_LEN;
-    p_pkt->offset = AVCT_MSG_OFFSET;
-    p_pkt->layer_specific = p_pkt_old->layer_specific;
-    p_pkt->event = p_pkt_old->event;
-    p_old = (uint8_t*)(p_pkt_old + 1) + p_pkt_old->offset;
-    p_data = (uint8_t*)(p_pkt + 1) + p_pkt->offset;
-    memcpy(p_data, p_old, AVRC_MAX_CTRL_DATA_LEN);
     /* use AVRC continue packet type */
-    p_data += AVRC_VENDOR_HDR_SIZE;
-    p_data++; /* pdu */
-    *p_data++ = AVRC_PKT_CONTINUE;
-    /* 4=pdu, pkt_type & len */
-    UINT16_TO_BE_STREAM(p_data,
-                        (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE - 4));
-
-    /* prepare the left over for as an end fragment */
-    avrc_prep_end_frag(handle);
+    p_pkt = avrc_slice_frag(handle, AVRC_PKT_CONTINUE);
   } else {
     /* end fragment. clean the control block */
     p_fcb->frag_enabled = false;
@@ -1183,7 +1204,6 @@ uint16_t AVRC_MsgReq(uint8_t handle, uint8_t label, uint8_t ctype,
   bool chk_frag = true;
   uint8_t* p_start = NULL;
   tAVRC_FRAG_CB* p_fcb;
-  uint16_t len;
   uint16_t status;
   uint8_t msg_mask = 0;
   uint16_t peer_mtu;
@@ -1267,35 +1287,15 @@ uint16_t AVRC_MsgReq(uint8_t handle, uint8_t label, uint8_t ctype,
    * check for fragmentation only on the response */
   if ((cr == AVCT_RSP) && (chk_frag)) {
     if (p_pkt->len > AVRC_MAX_CTRL_DATA_LEN) {
-      int offset_len = MAX(AVCT_MSG_OFFSET, p_pkt->offset);
-      BT_HDR* p_pkt_new =
-          (BT_HDR*)osi_calloc(AVRC_PACKET_LEN + offset_len + BT_HDR_SIZE);
       if (p_start != NULL) {
+        /* the response is kept serialized, and each fragment is sliced off
+         * it when the peer asks for it */
         p_fcb->frag_enabled = true;
         p_fcb->p_fmsg = p_pkt;
         p_fcb->frag_pdu = *p_start;
-        p_pkt = p_pkt_new;
-        p_pkt_new = p_fcb->p_fmsg;
-        p_pkt->len = AVRC_MAX_CTRL_DATA_LEN;
-        p_pkt->offset = p_pkt_new->offset;
-        p_pkt->layer_specific = p_pkt_new->layer_specific;
-        p_pkt->event = p_pkt_new->event;
-        p_data = (uint8_t*)(p_pkt + 1) + p_pkt->offset;
-        p_start -= AVRC_VENDOR_HDR_SIZE;
-        memcpy(p_data, p_start, AVRC_MAX_CTRL_DATA_LEN);
         /* use AVRC start packet type */
-        p_data += AVRC_VENDOR_HDR_SIZE;
-        p_data++; /* pdu */
-        *p_data++ = AVRC_PKT_START;
-
-        /* 4 pdu, pkt_type & len */
-        len = (AVRC_MAX_CTRL_DATA_LEN - AVRC_VENDOR_HDR_SIZE -
-               AVRC_MIN_META_HDR_SIZE);
-        UINT16_TO_BE_STREAM(p_data, len);
-
-        /* prepare the left over for as an end fragment */
-        avrc_prep_end_frag(handle);
-        log::verbose("p_pkt len:{}/{}, next len:{}", p_pkt->len, len,
+        p_pkt = avrc_slice_frag(handle, AVRC_PKT_START);
+        log::verbose("p_pkt len:{}, next len:{}", p_pkt->len,
                      p_fcb->p_fmsg->len);
       } else {
         /* TODO: Is this "else" block valid? Remove it? */
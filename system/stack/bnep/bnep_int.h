@@ -122,10 +122,14 @@ typedef struct {
   uint16_t rcvd_num_filters;
   uint16_t rcvd_prot_filter_start[BNEP_MAX_PROT_FILTERS];
   uint16_t rcvd_prot_filter_end[BNEP_MAX_PROT_FILTERS];
+  /* Verdicts of the received protocol filters for IPv4, ARP and IPv6, one
+   * bit per protocol, computed when the filters are set */
+  uint8_t rcvd_prot_common_allowed;
 
+  /* The multicast address ranges are held as 48 bit big endian integers */
   uint16_t rcvd_mcast_filters;
-  RawAddress rcvd_mcast_filter_start[BNEP_MAX_MULTI_FILTERS];
-  RawAddress rcvd_mcast_filter_end[BNEP_MAX_MULTI_FILTERS];
+  uint64_t rcvd_mcast_filter_start[BNEP_MAX_MULTI_FILTERS];
+  uint64_t rcvd_mcast_filter_end[BNEP_MAX_MULTI_FILTERS];
 
   uint16_t bad_pkts_rcvd;
   uint8_t re_transmits;
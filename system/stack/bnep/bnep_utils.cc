@@ -51,6 +51,51 @@ void bnepu_process_peer_multicast_filter_set(tBNEP_CONN* p_bcb,
 void bnepu_send_peer_multicast_filter_rsp(tBNEP_CONN* p_bcb,
                                           uint16_t response_code);
 
+/* Protocols of nearly all the traffic, whose protocol filter verdicts are
+ * kept in rcvd_prot_common_allowed rather than looked up for every packet */
+#define BNEP_NUM_COMMON_PROTOCOLS 3
+static const uint16_t bnep_common_protocols[BNEP_NUM_COMMON_PROTOCOLS] = {
+    0x0800, /* IPv4 */
+    0x0806, /* ARP */
+    0x86DD, /* IPv6 */
+};
+
+/*******************************************************************************
+ *
+ * Function         bnep_is_protocol_in_filters
+ *
+ * Description      Checks whether the protocol is in one of the protocol
+ *                  filter ranges set by the peer
+ *
+ * Returns          true if the protocol is in one of the ranges
+ *
+ ******************************************************************************/
+static bool bnep_is_protocol_in_filters(const tBNEP_CONN* p_bcb,
+                                        uint16_t proto) {
+  for (uint16_t i = 0; i < p_bcb->rcvd_num_filters; i++) {
+    if ((p_bcb->rcvd_prot_filter_start[i] <= proto) &&
+        (proto <= p_bcb->rcvd_prot_filter_end[i]))
+      return true;
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bnep_mcast_filter_key
+ *
+ * Description      Converts an address to the 48 bit big endian integer used
+ *                  to compare it with the multicast filter ranges
+ *
+ * Returns          the integer value of the address
+ *
+ ******************************************************************************/
+static uint64_t bnep_mcast_filter_key(const uint8_t* p_addr) {
+  uint64_t key = 0;
+  for (int i = 0; i < BD_ADDR_LEN; i++) key = (key << 8) | p_addr[i];
+  return key;
+}
+
 /*******************************************************************************
  *
  * Function         bnepu_find_bcb_by_cid
@@ -928,6 +973,12 @@ void bnepu_process_peer_filter_set(tBNEP_CONN* p_bcb, uint8_t* p_filters,
     p_bcb->rcvd_prot_filter_end[xx] = end;
   }
 
+  p_bcb->rcvd_prot_common_allowed = 0;
+  for (xx = 0; xx < BNEP_NUM_COMMON_PROTOCOLS; xx++) {
+    if (bnep_is_protocol_in_filters(p_bcb, bnep_common_protocols[xx]))
+      p_bcb->rcvd_prot_common_allowed |= (1 << xx);
+  }
+
   bnepu_send_peer_filter_rsp(p_bcb, resp_code);
 }
 
@@ -1031,7 +1082,7 @@ void bnepu_process_peer_multicast_filter_set(tBNEP_CONN* p_bcb,
                                              uint8_t* p_filters, uint16_t len) {
   uint16_t resp_code = BNEP_FILTER_CRL_OK;
   uint16_t num_filters, xx;
-  uint8_t *p_temp_filters, null_bda[BD_ADDR_LEN] = {0, 0, 0, 0, 0, 0};
+  uint8_t* p_temp_filters;
 
   if ((p_bcb->con_state != BNEP_STATE_CONNECTED) &&
       (!(p_bcb->con_flags & BNEP_FLAGS_CONN_COMPLETED))) {
@@ -1073,17 +1124,15 @@ void bnepu_process_peer_multicast_filter_set(tBNEP_CONN* p_bcb,
   p_bcb->rcvd_mcast_filters = num_filters;
   p_temp_filters = p_filters;
   for (xx = 0; xx < num_filters; xx++) {
-    memcpy(p_bcb->rcvd_mcast_filter_start[xx].address, p_temp_filters, BD_ADDR_LEN);
-    memcpy(p_bcb->rcvd_mcast_filter_end[xx].address, p_temp_filters + BD_ADDR_LEN,
-           BD_ADDR_LEN);
+    p_bcb->rcvd_mcast_filter_start[xx] = bnep_mcast_filter_key(p_temp_filters);
+    p_bcb->rcvd_mcast_filter_end[xx] =
+        bnep_mcast_filter_key(p_temp_filters + BD_ADDR_LEN);
     p_temp_filters += (BD_ADDR_LEN * 2);
 
     /* Check if any of the ranges have all zeros as both starting and ending
      * addresses */
-    if ((memcmp(null_bda, p_bcb->rcvd_mcast_filter_start[xx].address,
-                BD_ADDR_LEN) == 0) &&
-        (memcmp(null_bda, p_bcb->rcvd_mcast_filter_end[xx].address,
-                BD_ADDR_LEN) == 0)) {
+    if (p_bcb->rcvd_mcast_filter_start[xx] == 0 &&
+        p_bcb->rcvd_mcast_filter_end[xx] == 0) {
       p_bcb->rcvd_mcast_filters = 0xFFFF;
       break;
     }
@@ -1224,13 +1273,19 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
       BE_STREAM_TO_UINT16(proto, p_data);
     }
 
-    for (i = 0; i < p_bcb->rcvd_num_filters; i++) {
-      if ((p_bcb->rcvd_prot_filter_start[i] <= proto) &&
-          (proto <= p_bcb->rcvd_prot_filter_end[i]))
-        break;
+    /* The verdict for the common protocols is computed with the filters */
+    for (i = 0; i < BNEP_NUM_COMMON_PROTOCOLS; i++) {
+      if (bnep_common_protocols[i] == proto) break;
+    }
+
+    bool allowed;
+    if (i < BNEP_NUM_COMMON_PROTOCOLS) {
+      allowed = p_bcb->rcvd_prot_common_allowed & (1 << i);
+    } else {
+      allowed = bnep_is_protocol_in_filters(p_bcb, proto);
     }
 
-    if (i == p_bcb->rcvd_num_filters) {
+    if (!allowed) {
       log::verbose("Ignoring protocol 0x{:x} in BNEP data write", proto);
       return BNEP_IGNORE_CMD;
     }
@@ -1242,12 +1297,12 @@ tBNEP_RESULT bnep_is_packet_allowed(tBNEP_CONN* p_bcb,
 
     /* Check if every multicast should be filtered */
     if (p_bcb->rcvd_mcast_filters != 0xFFFF) {
+      uint64_t key = bnep_mcast_filter_key(dest_addr.address);
+
       /* Check if the address is mentioned in the filter range */
       for (i = 0; i < p_bcb->rcvd_mcast_filters; i++) {
-        if ((memcmp(p_bcb->rcvd_mcast_filter_start[i].address,
-                    dest_addr.address, BD_ADDR_LEN) <= 0) &&
-            (memcmp(p_bcb->rcvd_mcast_filter_end[i].address, dest_addr.address,
-                    BD_ADDR_LEN) >= 0))
+        if (p_bcb->rcvd_mcast_filter_start[i] <= key &&
+            key <= p_bcb->rcvd_mcast_filter_end[i])
           break;
       }
     }
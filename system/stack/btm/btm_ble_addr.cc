@@ -65,6 +65,7 @@ extern tBTM_CB btm_cb;
 bool btm_ble_init_pseudo_addr(tBTM_SEC_DEV_REC* p_dev_rec,
                               const RawAddress& new_pseudo_addr) {
   if (p_dev_rec->ble.pseudo_addr.IsEmpty()) {
+    btm_sec_cb.sec_dev_index.Invalidate(new_pseudo_addr);
     p_dev_rec->ble.pseudo_addr = new_pseudo_addr;
     return true;
   }
@@ -105,6 +106,16 @@ bool btm_ble_addr_resolvable(const RawAddress& rpa,
 
   if ((p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) &&
       (p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_PID)) {
+    // Skip the AES when |rpa| is known to resolve to this record, or to
+    // none. Another record may share the IRK, so only this one is trusted.
+    tBTM_SEC_DEV_REC* p_resolved = nullptr;
+    if (btm_sec_cb.sec_dev_index.FindResolved(rpa, &p_resolved)) {
+      if (p_resolved == nullptr) return false;
+      if (p_resolved == p_dev_rec) {
+        btm_ble_init_pseudo_addr(p_dev_rec, rpa);
+        return true;
+      }
+    }
     if (rpa_matches_irk(rpa, p_dev_rec->sec_rec.ble_keys.irk)) {
       btm_ble_init_pseudo_addr(p_dev_rec, rpa);
       return true;
@@ -140,10 +151,19 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
+
+  // A miss costs one AES per bonded LE device, the result is cached until the
+  // IRKs change.
+  tBTM_SEC_DEV_REC* p_dev_rec = nullptr;
+  if (btm_sec_cb.sec_dev_index.FindResolved(random_bda, &p_dev_rec))
+    return p_dev_rec;
+
   list_node_t* n = list_foreach(btm_sec_cb.sec_dev_rec,
                                 btm_ble_match_random_bda, (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  p_dev_rec = (n == nullptr) ? (nullptr)
+                             : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  btm_sec_cb.sec_dev_index.LearnResolved(random_bda, p_dev_rec);
+  return p_dev_rec;
 }
 
 /*******************************************************************************
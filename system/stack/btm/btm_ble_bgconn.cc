@@ -130,6 +130,22 @@ void BTM_AcceptlistRemove(const RawAddress& address) {
   return;
 }
 
+/** Removes the devices from acceptlist, the controller list is updated at once
+ */
+void BTM_AcceptlistRemove(const std::vector<RawAddress>& addresses) {
+  if (!bluetooth::shim::GetController()->SupportsBle()) {
+    log::warn("Controller does not support Le");
+    return;
+  }
+
+  std::vector<tBLE_BD_ADDR> address_with_types;
+  address_with_types.reserve(addresses.size());
+  for (const auto& address : addresses) {
+    address_with_types.push_back(BTM_Sec_GetAddressWithType(address));
+  }
+  bluetooth::shim::ACL_IgnoreLeConnectionsFrom(address_with_types);
+}
+
 /** Clear the acceptlist, end any pending acceptlist connections */
 void BTM_AcceptlistClear() {
   if (!bluetooth::shim::GetController()->SupportsBle()) {
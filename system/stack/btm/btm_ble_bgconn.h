@@ -16,6 +16,8 @@
  *
  ******************************************************************************/
 
+#include <vector>
+
 #include "types/raw_address.h"
 
 /** Adds the device into acceptlist. Returns false if acceptlist is full and
@@ -30,5 +32,9 @@ bool BTM_AcceptlistAdd(const RawAddress& address, bool is_direct);
 /** Removes the device from acceptlist */
 void BTM_AcceptlistRemove(const RawAddress& address);
 
+/** Removes the devices from acceptlist, the controller list is updated at once
+ */
+void BTM_AcceptlistRemove(const std::vector<RawAddress>& addresses);
+
 /** Clear the acceptlist, end any pending acceptlist connections */
 void BTM_AcceptlistClear();
@@ -1948,22 +1948,21 @@ static DEV_CLASS btm_ble_appearance_to_cod(uint16_t appearance) {
   return dev_class;
 }
 
-DEV_CLASS btm_ble_get_appearance_as_cod(std::vector<uint8_t> const& data) {
+DEV_CLASS btm_ble_get_appearance_as_cod(const AdvertiseDataIndex& data) {
   /* Check to see the BLE device has the Appearance UUID in the advertising
    * data. If it does then try to convert the appearance value to a class of
    * device value Fluoride can use. Otherwise fall back to trying to infer if
    * it is a HID device based on the service class.
    */
   uint8_t len;
-  const uint8_t* p_uuid16 = AdvertiseDataParser::GetFieldByType(
-      data, BTM_BLE_AD_TYPE_APPEARANCE, &len);
+  const uint8_t* p_uuid16 =
+      data.GetFieldByType(BTM_BLE_AD_TYPE_APPEARANCE, &len);
   if (p_uuid16 && len == 2) {
     return btm_ble_appearance_to_cod((uint16_t)p_uuid16[0] |
                                      (p_uuid16[1] << 8));
   }
 
-  p_uuid16 = AdvertiseDataParser::GetFieldByType(
-      data, BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
+  p_uuid16 = data.GetFieldByType(BTM_BLE_AD_TYPE_16SRV_CMPL, &len);
   if (p_uuid16 == NULL) {
     return kDevClassUnclassified;
   }
@@ -2025,45 +2024,39 @@ static void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
 
   bool has_advertising_flags = false;
   if (!data.empty()) {
+    /* Index the fields once for all the lookups below */
+    AdvertiseDataIndex ad(data);
     uint8_t local_flag = 0;
-    const uint8_t* p_flag =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_FLAG, &len);
+    const uint8_t* p_flag = ad.GetFieldByType(BTM_BLE_AD_TYPE_FLAG, &len);
     if (p_flag != NULL && len != 0) {
       has_advertising_flags = true;
       p_cur->flag = *p_flag;
       local_flag = *p_flag;
     }
 
-    p_cur->dev_class = btm_ble_get_appearance_as_cod(data);
+    p_cur->dev_class = btm_ble_get_appearance_as_cod(ad);
 
-    const uint8_t* p_rsi =
-        AdvertiseDataParser::GetFieldByType(data, BTM_BLE_AD_TYPE_RSI, &len);
+    const uint8_t* p_rsi = ad.GetFieldByType(BTM_BLE_AD_TYPE_RSI, &len);
     if (p_rsi != nullptr && len == 6) {
       STREAM_TO_BDADDR(p_cur->ble_ad_rsi, p_rsi);
     }
 
-    const uint8_t* p_service_data = data.data();
-    uint8_t service_data_len = 0;
-
-    while ((p_service_data = AdvertiseDataParser::GetFieldByType(
-                p_service_data + service_data_len,
-                data.size() - (p_service_data - data.data()) - service_data_len,
-                BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE, &service_data_len))) {
-      uint16_t uuid;
-      const uint8_t* p_uuid = p_service_data;
-      if (service_data_len < 2) {
-        continue;
-      }
-      STREAM_TO_UINT16(uuid, p_uuid);
-
-      if (uuid == 0x184E /* Audio Stream Control service */ ||
-          uuid == 0x184F /* Broadcast Audio Scan service */ ||
-          uuid == 0x1850 /* Published Audio Capabilities service */ ||
-          uuid == 0x1853 /* Common Audio service */) {
-        p_cur->ble_ad_is_le_audio_capable = true;
-        break;
-      }
-    }
+    ad.ForEachField(BTM_BLE_AD_TYPE_SERVICE_DATA_TYPE,
+                    [p_cur](std::span<const uint8_t> service_data) {
+                      if (service_data.size() < 2) {
+                        return true;
+                      }
+                      uint16_t uuid = service_data[0] | (service_data[1] << 8);
+
+                      if (uuid == 0x184E /* Audio Stream Control service */ ||
+                          uuid == 0x184F /* Broadcast Audio Scan service */ ||
+                          uuid == 0x1850 /* Published Audio Capabilities */ ||
+                          uuid == 0x1853 /* Common Audio service */) {
+                        p_cur->ble_ad_is_le_audio_capable = true;
+                        return false;
+                      }
+                      return true;
+                    });
     if (com::android::bluetooth::flags::ensure_valid_adv_flag()) {
       // Non-connectable packets may omit flags entirely, in which case nothing
       // should be assumed about their values (CSSv10, 1.3.1). Thus, do not
@@ -571,8 +571,9 @@ bool BTM_ReadConnectedTransportAddress(RawAddress* remote_bda,
   return false;
 }
 
-tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
-                                 uint16_t tx_pdu_length) {
+static tBTM_STATUS btm_ble_set_data_length(const RawAddress& bd_addr,
+                                           uint16_t tx_pdu_length,
+                                           bool allow_decrease) {
   if (!bluetooth::shim::GetController()
            ->SupportsBleDataPacketLengthExtension()) {
     log::info("Local controller does not support le packet extension");
@@ -592,7 +593,9 @@ tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
   else if (tx_pdu_length < BTM_BLE_DATA_SIZE_MIN)
     tx_pdu_length = BTM_BLE_DATA_SIZE_MIN;
 
-  if (p_dev_rec->get_suggested_tx_octets() >= tx_pdu_length) {
+  if (p_dev_rec->get_suggested_tx_octets() == tx_pdu_length ||
+      (!allow_decrease &&
+       p_dev_rec->get_suggested_tx_octets() > tx_pdu_length)) {
     log::info("Suggested TX octect already set to controller {} >= {}",
               p_dev_rec->get_suggested_tx_octets(), tx_pdu_length);
     return BTM_SUCCESS;
@@ -632,6 +635,16 @@ tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
   return BTM_SUCCESS;
 }
 
+tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
+                                 uint16_t tx_pdu_length) {
+  return btm_ble_set_data_length(bd_addr, tx_pdu_length, false);
+}
+
+tBTM_STATUS BTM_RestoreBleDataLength(const RawAddress& bd_addr,
+                                     uint16_t tx_pdu_length) {
+  return btm_ble_set_data_length(bd_addr, tx_pdu_length, true);
+}
+
 /*******************************************************************************
  *
  * Function         btm_ble_determine_security_act
@@ -913,12 +926,14 @@ void btm_sec_save_le_key(const RawAddress& bd_addr, tBTM_LE_KEY_TYPE key_type,
         p_rec->ble.identity_address_with_type.type =
             p_keys->pid_key.identity_addr_type;
         p_rec->sec_rec.ble_keys.key_type |= BTM_LE_KEY_PID;
+        btm_sec_cb.sec_dev_index.InvalidateResolved();
         log::verbose(
             "BTM_LE_KEY_PID key_type=0x{:x} save peer IRK, change bd_addr={} "
             "to id_addr={} id_addr_type=0x{:x}",
             p_rec->sec_rec.ble_keys.key_type, p_rec->bd_addr,
             p_keys->pid_key.identity_addr, p_keys->pid_key.identity_addr_type);
         /* update device record address as identity address */
+        btm_sec_cb.sec_dev_index.Invalidate(p_keys->pid_key.identity_addr);
         p_rec->bd_addr = p_keys->pid_key.identity_addr;
         /* combine DUMO device security record if needed */
         btm_consolidate_dev(p_rec);
@@ -1530,6 +1545,8 @@ void btm_ble_connected(const RawAddress& bda, uint16_t handle,
     log::warn(
         "Please do not update device record from anonymous le advertisement");
 
+  btm_sec_cb.sec_dev_index.Invalidate(bda);
+  btm_sec_cb.sec_dev_index.Invalidate(handle);
   p_dev_rec->ble.pseudo_addr = bda;
   p_dev_rec->ble_hci_handle = handle;
   p_dev_rec->device_type |= BT_DEVICE_TYPE_BLE;
@@ -64,6 +64,7 @@ constexpr char kBtmLogTag[] = "BOND";
 static void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->sec_rec.link_key.fill(0);
   memset(&p_dev_rec->sec_rec.ble_keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_sec_cb.sec_dev_index.Remove(p_dev_rec);
   list_remove(btm_sec_cb.sec_dev_rec, p_dev_rec);
 }
 
@@ -306,9 +307,23 @@ static bool is_handle_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  // Disconnected records all share the invalid handle, leave those to the
+  // list scan.
+  bool use_index = handle != HCI_INVALID_HANDLE;
+  if (use_index) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        btm_sec_cb.sec_dev_index.FindByHandle(handle);
+    if (p_dev_rec) return p_dev_rec;
+  }
+
   list_node_t* n =
       list_foreach(btm_sec_cb.sec_dev_rec, is_handle_equal, &handle);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (use_index) btm_sec_cb.sec_dev_index.LearnHandle(handle, p_dev_rec);
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -338,9 +353,23 @@ static bool is_address_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  // A resolvable private address may also match an earlier record through its
+  // IRK, which only the list scan can tell.
+  bool use_index = !BTM_BLE_IS_RESOLVE_BDA(bd_addr);
+  if (use_index) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        btm_sec_cb.sec_dev_index.FindByAddress(bd_addr);
+    if (p_dev_rec) return p_dev_rec;
+  }
+
   list_node_t* n =
       list_foreach(btm_sec_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (use_index) btm_sec_cb.sec_dev_index.LearnAddress(bd_addr, p_dev_rec);
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -365,6 +394,16 @@ static bool has_lenc_and_address_is_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev_with_lenc(const RawAddress& bd_addr) {
   if (btm_sec_cb.sec_dev_rec == nullptr) return nullptr;
 
+  // The first record matching |bd_addr| is also the first one with an LTK
+  // matching it, if it has one.
+  if (!BTM_BLE_IS_RESOLVE_BDA(bd_addr)) {
+    tBTM_SEC_DEV_REC* p_dev_rec =
+        btm_sec_cb.sec_dev_index.FindByAddress(bd_addr);
+    if (p_dev_rec &&
+        (p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_LENC))
+      return p_dev_rec;
+  }
+
   list_node_t* n = list_foreach(btm_sec_cb.sec_dev_rec,
                                 has_lenc_and_address_is_equal, (void*)&bd_addr);
   if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
@@ -397,9 +436,11 @@ void btm_consolidate_dev(tBTM_SEC_DEV_REC* p_target_rec) {
     if (p_target_rec == p_dev_rec) continue;
 
     if (p_dev_rec->bd_addr == p_target_rec->bd_addr) {
+      btm_sec_cb.sec_dev_index.Invalidate(p_dev_rec->hci_handle);
       memcpy(p_target_rec, p_dev_rec, sizeof(tBTM_SEC_DEV_REC));
       p_target_rec->ble = temp_rec.ble;
       p_target_rec->sec_rec.ble_keys = temp_rec.sec_rec.ble_keys;
+      btm_sec_cb.sec_dev_index.InvalidateResolved();
       p_target_rec->ble_hci_handle = temp_rec.ble_hci_handle;
       p_target_rec->sec_rec.enc_key_size = temp_rec.sec_rec.enc_key_size;
       p_target_rec->conn_params = temp_rec.conn_params;
@@ -477,6 +518,7 @@ void btm_dev_consolidate_existing_connections(const RawAddress& bd_addr) {
           p_dev_rec->bd_addr, p_dev_rec->ble_hci_handle);
 
       RawAddress ble_conn_addr = p_dev_rec->bd_addr;
+      btm_sec_cb.sec_dev_index.Invalidate(p_dev_rec->ble_hci_handle);
       p_target_rec->ble_hci_handle = p_dev_rec->ble_hci_handle;
 
       /* remove the old LE record */
@@ -594,6 +636,7 @@ tBTM_SEC_DEV_REC* btm_sec_allocate_dev_rec(void) {
   p_dev_rec =
       static_cast<tBTM_SEC_DEV_REC*>(osi_calloc(sizeof(tBTM_SEC_DEV_REC)));
   list_append(btm_sec_cb.sec_dev_rec, p_dev_rec);
+  btm_sec_cb.sec_dev_index.Add(p_dev_rec);
 
   // Initialize defaults
   p_dev_rec->sec_rec.sec_flags = BTM_SEC_IN_USE;
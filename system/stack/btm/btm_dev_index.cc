@@ -0,0 +1,209 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include "stack/btm/btm_dev_index.h"
+
+#include <iterator>
+
+namespace {
+
+// Stale hints are only dropped when they are looked up; once the tables hold
+// more than this many entries per registered record they are swept. Valid
+// hints never exceed it: one per address and one per ACL handle.
+constexpr size_t kMaxHintsPerRecord = 4;
+constexpr size_t kMinHintsBeforePrune = 64;
+
+bool has_irk(const tBTM_SEC_DEV_REC* p_dev_rec) {
+  return (p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) &&
+         (p_dev_rec->sec_rec.ble_keys.key_type & BTM_LE_KEY_PID);
+}
+
+bool is_handle_of(const tBTM_SEC_DEV_REC* p_dev_rec, uint16_t handle) {
+  return p_dev_rec->hci_handle == handle || p_dev_rec->ble_hci_handle == handle;
+}
+
+template <typename Key, typename Valid>
+tBTM_SEC_DEV_REC* find_valid(std::unordered_map<Key, tBTM_SEC_DEV_REC*>& map,
+                             const Key& key, Valid valid) {
+  auto it = map.find(key);
+  if (it == map.end()) return nullptr;
+  if (valid(it->second)) return it->second;
+  map.erase(it);
+  return nullptr;
+}
+
+template <typename Key>
+void erase_if_points_to(std::unordered_map<Key, tBTM_SEC_DEV_REC*>& map,
+                        const Key& key, const tBTM_SEC_DEV_REC* p_dev_rec) {
+  auto it = map.find(key);
+  if (it != map.end() && it->second == p_dev_rec) map.erase(it);
+}
+
+}  // namespace
+
+void tBTM_SEC_DEV_INDEX::Enable() {
+  Disable();
+  enabled_ = true;
+}
+
+void tBTM_SEC_DEV_INDEX::Disable() {
+  enabled_ = false;
+  records_.clear();
+  by_address_.clear();
+  by_pseudo_address_.clear();
+  by_handle_.clear();
+  resolved_.clear();
+}
+
+void tBTM_SEC_DEV_INDEX::Add(tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!enabled_) return;
+  records_[p_dev_rec] = next_sequence_++;
+}
+
+void tBTM_SEC_DEV_INDEX::Remove(tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!enabled_ || !IsRegistered(p_dev_rec)) return;
+
+  erase_if_points_to(by_address_, p_dev_rec->bd_addr, p_dev_rec);
+  erase_if_points_to(by_pseudo_address_, p_dev_rec->ble.pseudo_addr,
+                     p_dev_rec);
+  erase_if_points_to(by_handle_, p_dev_rec->hci_handle, p_dev_rec);
+  erase_if_points_to(by_handle_, p_dev_rec->ble_hci_handle, p_dev_rec);
+  records_.erase(p_dev_rec);
+  PruneIfNeeded();
+}
+
+bool tBTM_SEC_DEV_INDEX::IsRegistered(
+    const tBTM_SEC_DEV_REC* p_dev_rec) const {
+  return records_.find(p_dev_rec) != records_.end();
+}
+
+tBTM_SEC_DEV_REC* tBTM_SEC_DEV_INDEX::FindByAddress(
+    const RawAddress& bd_addr) {
+  if (!enabled_) return nullptr;
+
+  tBTM_SEC_DEV_REC* p_by_address =
+      find_valid(by_address_, bd_addr, [&](const tBTM_SEC_DEV_REC* p) {
+        return IsRegistered(p) && p->bd_addr == bd_addr;
+      });
+  tBTM_SEC_DEV_REC* p_by_pseudo_address =
+      find_valid(by_pseudo_address_, bd_addr, [&](const tBTM_SEC_DEV_REC* p) {
+        return IsRegistered(p) && p->ble.pseudo_addr == bd_addr;
+      });
+
+  if (p_by_address == nullptr) return p_by_pseudo_address;
+  if (p_by_pseudo_address == nullptr) return p_by_address;
+  // The list lookup returns the first match in list order.
+  return records_.at(p_by_address) < records_.at(p_by_pseudo_address)
+             ? p_by_address
+             : p_by_pseudo_address;
+}
+
+tBTM_SEC_DEV_REC* tBTM_SEC_DEV_INDEX::FindByHandle(uint16_t handle) {
+  if (!enabled_) return nullptr;
+
+  return find_valid(by_handle_, handle, [&](const tBTM_SEC_DEV_REC* p) {
+    return IsRegistered(p) && is_handle_of(p, handle);
+  });
+}
+
+void tBTM_SEC_DEV_INDEX::LearnAddress(const RawAddress& bd_addr,
+                                      tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!enabled_ || !IsRegistered(p_dev_rec)) return;
+
+  if (p_dev_rec->bd_addr == bd_addr) {
+    by_address_[bd_addr] = p_dev_rec;
+  } else if (p_dev_rec->ble.pseudo_addr == bd_addr) {
+    by_pseudo_address_[bd_addr] = p_dev_rec;
+  } else {
+    // Matched by resolving |bd_addr| with the record's IRK, nothing to learn.
+    return;
+  }
+  PruneIfNeeded();
+}
+
+void tBTM_SEC_DEV_INDEX::LearnHandle(uint16_t handle,
+                                     tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!enabled_ || !IsRegistered(p_dev_rec) || !is_handle_of(p_dev_rec, handle))
+    return;
+
+  by_handle_[handle] = p_dev_rec;
+  PruneIfNeeded();
+}
+
+void tBTM_SEC_DEV_INDEX::Invalidate(const RawAddress& bd_addr) {
+  by_address_.erase(bd_addr);
+  by_pseudo_address_.erase(bd_addr);
+}
+
+void tBTM_SEC_DEV_INDEX::Invalidate(uint16_t handle) {
+  by_handle_.erase(handle);
+}
+
+bool tBTM_SEC_DEV_INDEX::FindResolved(const RawAddress& rpa,
+                                      tBTM_SEC_DEV_REC** p_dev_rec) {
+  if (!enabled_) return false;
+
+  auto it = resolved_.find(rpa);
+  if (it == resolved_.end()) return false;
+
+  // The record must still hold the IRK that resolved |rpa|.
+  tBTM_SEC_DEV_REC* p = it->second.p_dev_rec;
+  if (p != nullptr && !(IsRegistered(p) && has_irk(p) &&
+                        p->sec_rec.ble_keys.irk == it->second.irk)) {
+    resolved_.erase(it);
+    return false;
+  }
+  *p_dev_rec = p;
+  return true;
+}
+
+void tBTM_SEC_DEV_INDEX::LearnResolved(const RawAddress& rpa,
+                                       tBTM_SEC_DEV_REC* p_dev_rec) {
+  if (!enabled_) return;
+
+  if (p_dev_rec == nullptr) {
+    resolved_.insert_or_assign(rpa, tRESOLVED_RPA{nullptr, {}});
+    return;
+  }
+  if (!IsRegistered(p_dev_rec) || !has_irk(p_dev_rec)) return;
+  resolved_.insert_or_assign(
+      rpa, tRESOLVED_RPA{p_dev_rec, p_dev_rec->sec_rec.ble_keys.irk});
+}
+
+void tBTM_SEC_DEV_INDEX::InvalidateResolved() { resolved_.clear(); }
+
+void tBTM_SEC_DEV_INDEX::PruneIfNeeded() {
+  size_t hints =
+      by_address_.size() + by_pseudo_address_.size() + by_handle_.size();
+  if (hints < kMinHintsBeforePrune ||
+      hints <= kMaxHintsPerRecord * records_.size())
+    return;
+
+  for (auto it = by_address_.begin(); it != by_address_.end();) {
+    bool valid = IsRegistered(it->second) && it->second->bd_addr == it->first;
+    it = valid ? std::next(it) : by_address_.erase(it);
+  }
+  for (auto it = by_pseudo_address_.begin(); it != by_pseudo_address_.end();) {
+    bool valid =
+        IsRegistered(it->second) && it->second->ble.pseudo_addr == it->first;
+    it = valid ? std::next(it) : by_pseudo_address_.erase(it);
+  }
+  for (auto it = by_handle_.begin(); it != by_handle_.end();) {
+    bool valid = IsRegistered(it->second) && is_handle_of(it->second, it->first);
+    it = valid ? std::next(it) : by_handle_.erase(it);
+  }
+}
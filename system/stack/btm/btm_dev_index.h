@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "common/lru_cache.h"
+#include "stack/btm/security_device_record.h"
+#include "stack/include/bt_octets.h"
+#include "types/raw_address.h"
+
+// Hash indexes over the device records of |btm_sec_cb.sec_dev_rec|, keyed by
+// BD address, pseudo address and ACL handle, and a cache of the resolvable
+// private addresses resolved against the IRKs of the records.
+//
+// The record fields are written directly all over the stack, so the index
+// only holds hints: every hit is checked against the live record before it is
+// returned, and callers fall back to scanning the list on a miss and then
+// record the result with |Learn*|. Records must be registered when they are
+// appended to the list and unregistered before they are freed, and writers of
+// the indexed fields of an existing record must |Invalidate| the new value.
+class tBTM_SEC_DEV_INDEX {
+ public:
+  // The index is only enabled while |btm_sec_cb| owns the record list. Lists
+  // installed directly by tests bypass it entirely.
+  void Enable();
+  void Disable();
+  bool IsEnabled() const { return enabled_; }
+
+  void Add(tBTM_SEC_DEV_REC* p_dev_rec);
+  void Remove(tBTM_SEC_DEV_REC* p_dev_rec);
+
+  // Returns the earliest registered record whose BD address or pseudo address
+  // is |bd_addr|, or nullptr if the index holds no valid hint for it.
+  tBTM_SEC_DEV_REC* FindByAddress(const RawAddress& bd_addr);
+  // Returns the record whose BR/EDR or LE ACL handle is |handle|, or nullptr
+  // if the index holds no valid hint for it.
+  tBTM_SEC_DEV_REC* FindByHandle(uint16_t handle);
+
+  // Records that the list lookup of |bd_addr| or |handle| found |p_dev_rec|.
+  void LearnAddress(const RawAddress& bd_addr, tBTM_SEC_DEV_REC* p_dev_rec);
+  void LearnHandle(uint16_t handle, tBTM_SEC_DEV_REC* p_dev_rec);
+
+  // Drops the hints for |bd_addr| or |handle|. Must be called before either is
+  // assigned to a record that may precede the hinted one in the list, so that
+  // the lookup still returns the first match.
+  void Invalidate(const RawAddress& bd_addr);
+  void Invalidate(uint16_t handle);
+
+  // Returns true if |rpa| was resolved before and the result still holds, with
+  // the record it resolved to, or nullptr if no IRK resolved it, in
+  // |*p_dev_rec|.
+  bool FindResolved(const RawAddress& rpa, tBTM_SEC_DEV_REC** p_dev_rec);
+  // Records that |rpa| resolved to |p_dev_rec| with its current IRK, or that
+  // no IRK resolved it if |p_dev_rec| is nullptr.
+  void LearnResolved(const RawAddress& rpa, tBTM_SEC_DEV_REC* p_dev_rec);
+  // Drops all the resolution results. Must be called when a record gains an
+  // IRK, which may resolve addresses that were not resolvable before.
+  void InvalidateResolved();
+
+  size_t Size() const { return records_.size(); }
+
+ private:
+  bool IsRegistered(const tBTM_SEC_DEV_REC* p_dev_rec) const;
+  void PruneIfNeeded();
+
+  bool enabled_{false};
+  uint64_t next_sequence_{0};
+  // Registered records and the order in which they were appended to the list.
+  std::unordered_map<const tBTM_SEC_DEV_REC*, uint64_t> records_;
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> by_address_;
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> by_pseudo_address_;
+  std::unordered_map<uint16_t, tBTM_SEC_DEV_REC*> by_handle_;
+
+  struct tRESOLVED_RPA {
+    tBTM_SEC_DEV_REC* p_dev_rec;
+    // IRK of |p_dev_rec| when the address was resolved.
+    Octet16 irk;
+  };
+  // Scanning reports the same addresses over and over, most of them from
+  // devices that are not bonded.
+  static constexpr size_t kMaxResolvedRpas = 256;
+  bluetooth::common::LruCache<RawAddress, tRESOLVED_RPA> resolved_{
+      kMaxResolvedRpas};
+};
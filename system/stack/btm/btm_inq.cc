@@ -33,7 +33,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <list>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "advertise_data_parser.h"
 #include "bt_name.h"
@@ -49,6 +52,7 @@
 #include "main/shim/helpers.h"
 #include "main/shim/shim.h"
 #include "neighbor_inquiry.h"
+#include "os/system_properties.h"
 #include "osi/include/allocator.h"
 #include "osi/include/properties.h"
 #include "osi/include/stack_power_telemetry.h"
@@ -106,13 +110,30 @@ void btm_log_history_scan_mode(uint8_t scan_mode) {
 
 // Inquiry database lock
 std::mutex inq_db_lock_;
-// Inquiry database
-tINQ_DB_ENT inq_db_[BTM_INQ_DB_SIZE];
+// Inquiry database, sized on first use. The entries are handed out by
+// pointer, so it is never resized afterwards.
+std::vector<tINQ_DB_ENT> inq_db_;
+// Entries of the inquiry database not in use
+std::vector<tINQ_DB_ENT*> inq_db_free_;
+// Entry in use of the inquiry database
+struct tINQ_DB_INDEX {
+  tINQ_DB_ENT* p_ent;
+  bool is_ble;
+  std::list<RawAddress>::iterator lru;
+};
+// Entries in use of the inquiry database by address
+std::unordered_map<RawAddress, tINQ_DB_INDEX> inq_db_index_;
+// Addresses of the BR/EDR [0] and LE [1] entries, most recently used first
+std::list<RawAddress> inq_db_lru_[2];
+// Entries reused for a new device since the last inquiry, because the
+// database was full
+unsigned long inq_db_evictions_;
 
 // Inquiry bluetooth device database lock
 std::mutex bd_db_lock_;
-tINQ_BDADDR* p_bd_db_;    /* Pointer to memory that holds bdaddrs */
-uint16_t num_bd_entries_; /* Number of entries in database */
+// Devices that responded, with the counter of the inquiry they last responded
+std::unordered_map<RawAddress, uint32_t> bd_db_;
+bool bd_db_active_;       /* Whether responses are being filtered */
 uint16_t max_bd_entries_; /* Maximum number of entries that can be stored */
 
 }  // namespace
@@ -168,6 +189,13 @@ using bluetooth::Uuid;
 #define PROPERTY_INQ_BY_RSSI "persist.bluetooth.inq_by_rssi"
 #endif
 
+#ifndef PROPERTY_INQ_DB_SIZE
+#define PROPERTY_INQ_DB_SIZE "bluetooth.core.classic.inq_db_size"
+#endif
+
+/* Largest inquiry database that can be configured */
+#define BTM_INQ_DB_MAX_SIZE 1024
+
 #define BTIF_DM_DEFAULT_INQ_MAX_DURATION 10
 
 #ifndef PROPERTY_INQ_LENGTH
@@ -243,15 +271,57 @@ static tBTM_STATUS btm_initiate_rem_name(const RawAddress& remote_bda,
 
 static uint8_t btm_convert_uuid_to_eir_service(uint16_t uuid16);
 void btm_set_eir_uuid(const uint8_t* p_eir, tBTM_INQ_RESULTS* p_results);
-static const uint8_t* btm_eir_get_uuid_list(const uint8_t* p_eir,
-                                            size_t eir_len, uint8_t uuid_size,
+static const uint8_t* btm_eir_get_uuid_list(const AdvertiseDataIndex& eir,
+                                            uint8_t uuid_size,
                                             uint8_t* p_num_uuid,
                                             uint8_t* p_uuid_list_type);
 
 static void btm_process_cancel_complete(tHCI_STATUS status, uint8_t mode);
 static void on_incoming_hci_event(bluetooth::hci::EventView event);
 static bool is_inquery_by_rssi() {
-  return osi_property_get_bool(PROPERTY_INQ_BY_RSSI, false);
+  /* Checked for every inquiry result once the database is full */
+  static bluetooth::os::CachedSystemPropertyBool inq_by_rssi(
+      PROPERTY_INQ_BY_RSSI, false);
+  return inq_by_rssi.Get();
+}
+
+/* Sizes the inquiry database on first use, with inq_db_lock_ held */
+static void btm_inq_db_alloc_locked(void) {
+  if (!inq_db_.empty()) return;
+
+  int32_t size = osi_property_get_int32(PROPERTY_INQ_DB_SIZE, BTM_INQ_DB_SIZE);
+  if (size < 2 || size > BTM_INQ_DB_MAX_SIZE) {
+    log::warn("Invalid inquiry database size {}, using {}", size,
+              BTM_INQ_DB_SIZE);
+    size = BTM_INQ_DB_SIZE;
+  }
+
+  inq_db_.resize(size);
+  inq_db_free_.reserve(size);
+  for (auto it = inq_db_.rbegin(); it != inq_db_.rend(); it++) {
+    inq_db_free_.push_back(&*it);
+  }
+  inq_db_index_.reserve(size);
+}
+
+/* Marks an entry of the inquiry database as unused, with inq_db_lock_ held.
+ * Returns the index entry following it. */
+static std::unordered_map<RawAddress, tINQ_DB_INDEX>::iterator
+btm_inq_db_release_locked(
+    std::unordered_map<RawAddress, tINQ_DB_INDEX>::iterator it) {
+  it->second.p_ent->in_use = false;
+  inq_db_free_.push_back(it->second.p_ent);
+  inq_db_lru_[it->second.is_ble].erase(it->second.lru);
+  return inq_db_index_.erase(it);
+}
+
+/* Returns the entries reused because the inquiry database was full since the
+ * last call */
+static unsigned long btm_inq_db_take_evictions(void) {
+  std::lock_guard<std::mutex> lock(inq_db_lock_);
+  unsigned long evictions = inq_db_evictions_;
+  inq_db_evictions_ = 0;
+  return evictions;
 }
 /*******************************************************************************
  *
@@ -568,12 +638,12 @@ void BTM_CancelInquiry(void) {
   BTM_LogHistory(
       kBtmLogTag, RawAddress::kEmpty, "Classic inquiry canceled",
       base::StringPrintf(
-          "duration_s:%6.3f results:%lu std:%u rssi:%u ext:%u",
+          "duration_s:%6.3f results:%lu std:%u rssi:%u ext:%u evicted:%lu",
           duration_ms / 1000.0, btm_cb.neighbor.classic_inquiry.results,
           btm_cb.btm_inq_vars.inq_cmpl_info.resp_type[BTM_INQ_RESULT_STANDARD],
           btm_cb.btm_inq_vars.inq_cmpl_info.resp_type[BTM_INQ_RESULT_WITH_RSSI],
-          btm_cb.btm_inq_vars.inq_cmpl_info
-              .resp_type[BTM_INQ_RESULT_EXTENDED]));
+          btm_cb.btm_inq_vars.inq_cmpl_info.resp_type[BTM_INQ_RESULT_EXTENDED],
+          btm_inq_db_take_evictions()));
   btm_cb.neighbor.classic_inquiry = {};
 
   /* Only cancel if not in periodic mode, otherwise the caller should call
@@ -915,11 +985,11 @@ tBTM_INQ_INFO* BTM_InqDbRead(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tBTM_INQ_INFO* BTM_InqDbFirst(void) {
-  uint16_t xx;
+  size_t xx;
 
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  tINQ_DB_ENT* p_ent = inq_db_.data();
+  for (xx = 0; xx < inq_db_.size(); xx++, p_ent++) {
     if (p_ent->in_use) return (&p_ent->inq_info);
   }
 
@@ -939,16 +1009,16 @@ tBTM_INQ_INFO* BTM_InqDbFirst(void) {
  *
  ******************************************************************************/
 tBTM_INQ_INFO* BTM_InqDbNext(tBTM_INQ_INFO* p_cur) {
-  uint16_t inx;
+  size_t inx;
 
   std::lock_guard<std::mutex> lock(inq_db_lock_);
 
   if (p_cur) {
     tINQ_DB_ENT* p_ent =
         (tINQ_DB_ENT*)((uint8_t*)p_cur - offsetof(tINQ_DB_ENT, inq_info));
-    inx = (uint16_t)((p_ent - inq_db_) + 1);
+    inx = (size_t)((p_ent - inq_db_.data()) + 1);
 
-    for (p_ent = &inq_db_[inx]; inx < BTM_INQ_DB_SIZE; inx++, p_ent++) {
+    for (p_ent = inq_db_.data() + inx; inx < inq_db_.size(); inx++, p_ent++) {
       if (p_ent->in_use) return (&p_ent->inq_info);
     }
 
@@ -992,17 +1062,18 @@ tBTM_STATUS BTM_ClearInqDb(const RawAddress* p_bda) {
  *
  ******************************************************************************/
 void btm_clear_all_pending_le_entry(void) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (auto it = inq_db_index_.begin(); it != inq_db_index_.end();) {
+    tINQ_DB_ENT* p_ent = it->second.p_ent;
     /* mark all pending LE entry as unused if an LE only device has scan
      * response outstanding */
-    if ((p_ent->in_use) &&
-        (p_ent->inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
-        !p_ent->scan_rsp)
-      p_ent->in_use = false;
+    if ((p_ent->inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
+        !p_ent->scan_rsp) {
+      it = btm_inq_db_release_locked(it);
+    } else {
+      it++;
+    }
   }
 }
 
@@ -1093,21 +1164,19 @@ void btm_inq_db_reset(void) {
  *
  ******************************************************************************/
 void btm_clr_inq_db(const RawAddress* p_bda) {
-  uint16_t xx;
-
 #if (BTM_INQ_DEBUG == TRUE)
   log::verbose("btm_clr_inq_db: inq_active:0x{:x} state:{}",
                btm_cb.btm_inq_vars.inq_active, btm_cb.btm_inq_vars.state);
 #endif
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use) {
-      /* If this is the specified BD_ADDR or clearing all devices */
-      if (p_bda == NULL || (p_ent->inq_info.results.remote_bd_addr == *p_bda)) {
-        p_ent->in_use = false;
-      }
+  if (p_bda == NULL) {
+    /* Clearing all devices */
+    while (!inq_db_index_.empty()) {
+      btm_inq_db_release_locked(inq_db_index_.begin());
     }
+  } else {
+    auto it = inq_db_index_.find(*p_bda);
+    if (it != inq_db_index_.end()) btm_inq_db_release_locked(it);
   }
 #if (BTM_INQ_DEBUG == TRUE)
   log::verbose("inq_active:0x{:x} state:{}", btm_cb.btm_inq_vars.inq_active,
@@ -1128,23 +1197,25 @@ void btm_clr_inq_db(const RawAddress* p_bda) {
 static void btm_init_inq_result_flt(void) {
   std::lock_guard<std::mutex> lock(bd_db_lock_);
 
-  if (p_bd_db_ != nullptr) {
-    log::error("Memory leak with bluetooth device database");
+  if (bd_db_active_) {
+    log::error("Bluetooth device database was not cleared");
   }
 
-  /* Allocate memory to hold bd_addrs responding */
-  p_bd_db_ = (tINQ_BDADDR*)osi_calloc(BT_DEFAULT_BUFFER_SIZE);
+  /* Bound the number of bd_addrs responding */
   max_bd_entries_ = (uint16_t)(BT_DEFAULT_BUFFER_SIZE / sizeof(tINQ_BDADDR));
+  bd_db_.clear();
+  bd_db_.reserve(max_bd_entries_);
+  bd_db_active_ = true;
 }
 
 void btm_clr_inq_result_flt(void) {
   std::lock_guard<std::mutex> lock(bd_db_lock_);
-  if (p_bd_db_ == nullptr) {
+  if (!bd_db_active_) {
     log::warn("Memory being reset multiple times");
   }
 
-  osi_free_and_reset((void**)&p_bd_db_);
-  num_bd_entries_ = 0;
+  bd_db_ = {};
+  bd_db_active_ = false;
   max_bd_entries_ = 0;
 }
 
@@ -1160,22 +1231,16 @@ void btm_clr_inq_result_flt(void) {
  ******************************************************************************/
 bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
   std::lock_guard<std::mutex> lock(bd_db_lock_);
-  tINQ_BDADDR* p_db = p_bd_db_;
-  uint16_t xx;
 
   /* Don't bother searching, database doesn't exist or periodic mode */
-  if (!p_db) return (false);
-
-  for (xx = 0; xx < num_bd_entries_; xx++, p_db++) {
-    if (p_db->bd_addr == p_bda &&
-        p_db->inq_count == btm_cb.btm_inq_vars.inq_counter)
-      return (true);
-  }
-
-  if (xx < max_bd_entries_) {
-    p_db->inq_count = btm_cb.btm_inq_vars.inq_counter;
-    p_db->bd_addr = p_bda;
-    num_bd_entries_++;
+  if (!bd_db_active_) return (false);
+
+  auto it = bd_db_.find(p_bda);
+  if (it != bd_db_.end()) {
+    if (it->second == btm_cb.btm_inq_vars.inq_counter) return (true);
+    it->second = btm_cb.btm_inq_vars.inq_counter;
+  } else if (bd_db_.size() < max_bd_entries_) {
+    bd_db_.emplace(p_bda, btm_cb.btm_inq_vars.inq_counter);
   }
 
   /* If here, New Entry */
@@ -1193,71 +1258,70 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
 
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
+  auto it = inq_db_index_.find(p_bda);
+  if (it == inq_db_index_.end()) {
+    /* If here, not found */
+    return (NULL);
   }
 
-  /* If here, not found */
-  return (NULL);
+  /* Mark the entry as the most recently used of its transport */
+  std::list<RawAddress>& lru = inq_db_lru_[it->second.is_ble];
+  lru.splice(lru.begin(), lru, it->second.lru);
+  return (it->second.p_ent);
 }
 
 /*******************************************************************************
  *
  * Function         btm_inq_db_new
  *
- * Description      This function looks through the inquiry database for an
- *                  unused entry. If no entry is free, it allocates the oldest
- *                  entry.
+ * Description      This function takes an unused entry of the inquiry database
+ *                  for the device. Each transport owns half of the database:
+ *                  when its half is full, the least recently used entry of the
+ *                  transport is reused (the entry with the weakest RSSI when
+ *                  inquiring by RSSI).
  *
  * Returns          pointer to entry
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda, bool is_ble) {
-  uint16_t xx = 0, yy = 0;
-  uint32_t ot = 0xFFFFFFFF;
-  int8_t i_rssi = 0;
-
-  if (is_ble) yy = BTM_INQ_DB_SIZE / 2;
-  else yy = 0;
-
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = &inq_db_[yy];
-  tINQ_DB_ENT* p_old = &inq_db_[yy];
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE / 2; xx++, p_ent++) {
-    if (!p_ent->in_use) {
-      memset(p_ent, 0, sizeof(tINQ_DB_ENT));
-      p_ent->inq_info.results.remote_bd_addr = p_bda;
-      p_ent->in_use = true;
+  btm_inq_db_alloc_locked();
 
-      return (p_ent);
-    }
+  /* Never index the same device twice */
+  auto existing = inq_db_index_.find(p_bda);
+  if (existing != inq_db_index_.end()) btm_inq_db_release_locked(existing);
 
+  std::list<RawAddress>& lru = inq_db_lru_[is_ble];
+  if (lru.size() >= inq_db_.size() / 2 || inq_db_free_.empty()) {
+    /* If here, no free entry found. Reuse the oldest. */
+    auto victim = inq_db_index_.find(lru.back());
     if (is_inquery_by_rssi()) {
-      if (p_ent->inq_info.results.rssi < i_rssi) {
-        p_old = p_ent;
-        i_rssi = p_ent->inq_info.results.rssi;
-      }
-    } else {
-      if (p_ent->time_of_resp < ot) {
-        p_old = p_ent;
-        ot = p_ent->time_of_resp;
+      int8_t i_rssi = 0;
+      for (const RawAddress& bda : lru) {
+        auto it = inq_db_index_.find(bda);
+        if (it->second.p_ent->inq_info.results.rssi < i_rssi) {
+          victim = it;
+          i_rssi = it->second.p_ent->inq_info.results.rssi;
+        }
       }
     }
+    btm_inq_db_release_locked(victim);
+    inq_db_evictions_++;
   }
 
-  /* If here, no free entry found. Return the oldest. */
+  tINQ_DB_ENT* p_ent = inq_db_free_.back();
+  inq_db_free_.pop_back();
+
+  memset(p_ent, 0, sizeof(tINQ_DB_ENT));
+  p_ent->inq_info.results.remote_bd_addr = p_bda;
+  p_ent->in_use = true;
 
-  memset(p_old, 0, sizeof(tINQ_DB_ENT));
-  p_old->inq_info.results.remote_bd_addr = p_bda;
-  p_old->in_use = true;
+  lru.push_front(p_bda);
+  inq_db_index_.emplace(p_bda, tINQ_DB_INDEX{p_ent, is_ble, lru.begin()});
 
-  return (p_old);
+  return (p_ent);
 }
 
 /*******************************************************************************
@@ -1707,14 +1771,15 @@ static void btm_process_inq_results_extended(bluetooth::hci::EventView event) {
 void btm_sort_inq_result(void) {
   uint8_t xx, yy, num_resp;
   std::lock_guard<std::mutex> lock(inq_db_lock_);
-  tINQ_DB_ENT* p_ent = inq_db_;
-  tINQ_DB_ENT* p_next = inq_db_ + 1;
+  if (inq_db_.size() < 2) return;
+  tINQ_DB_ENT* p_ent = inq_db_.data();
+  tINQ_DB_ENT* p_next = inq_db_.data() + 1;
   int size;
   tINQ_DB_ENT* p_tmp = (tINQ_DB_ENT*)osi_malloc(sizeof(tINQ_DB_ENT));
 
-  num_resp = (btm_cb.btm_inq_vars.inq_cmpl_info.num_resp < BTM_INQ_DB_SIZE)
+  num_resp = (btm_cb.btm_inq_vars.inq_cmpl_info.num_resp < inq_db_.size())
                  ? btm_cb.btm_inq_vars.inq_cmpl_info.num_resp
-                 : BTM_INQ_DB_SIZE;
+                 : inq_db_.size();
 
   size = sizeof(tINQ_DB_ENT);
   for (xx = 0; xx < num_resp - 1; xx++, p_ent++) {
@@ -1728,6 +1793,17 @@ void btm_sort_inq_result(void) {
   }
 
   osi_free(p_tmp);
+
+  /* The entries moved, point the index at their new location */
+  inq_db_free_.clear();
+  for (tINQ_DB_ENT& ent : inq_db_) {
+    auto it = inq_db_index_.find(ent.inq_info.results.remote_bd_addr);
+    if (ent.in_use && it != inq_db_index_.end()) {
+      it->second.p_ent = &ent;
+    } else {
+      inq_db_free_.push_back(&ent);
+    }
+  }
 }
 
 /*******************************************************************************
@@ -1802,7 +1878,7 @@ void btm_process_inq_complete(tHCI_STATUS status, uint8_t mode) {
           kBtmLogTag, RawAddress::kEmpty, "Classic inquiry complete",
           base::StringPrintf(
               "duration_s:%6.3f results:%lu inq_active:0x%02x std:%u rssi:%u "
-              "ext:%u status:%s",
+              "ext:%u evicted:%lu status:%s",
               (end_time_ms - btm_cb.neighbor.classic_inquiry.start_time_ms) /
                   1000.0,
               btm_cb.neighbor.classic_inquiry.results, inq_active,
@@ -1812,7 +1888,7 @@ void btm_process_inq_complete(tHCI_STATUS status, uint8_t mode) {
                   .resp_type[BTM_INQ_RESULT_WITH_RSSI],
               btm_cb.btm_inq_vars.inq_cmpl_info
                   .resp_type[BTM_INQ_RESULT_EXTENDED],
-              hci_error_code_text(status).c_str()));
+              btm_inq_db_take_evictions(), hci_error_code_text(status).c_str()));
 
       btm_cb.neighbor.classic_inquiry.start_time_ms = 0;
       /* Clear the results callback if set */
@@ -1881,6 +1957,9 @@ tBTM_STATUS btm_initiate_rem_name(const RawAddress& remote_bda,
   } else {
     /* If the database entry exists for the device, use its clock offset */
     tINQ_DB_ENT* p_i = btm_inq_db_find(remote_bda);
+    // The names of bonded devices are needed by the profiles connecting to
+    // them, so they are not kept waiting behind the names of discovered ones.
+    bool prioritized = btm_sec_is_a_bonded_dev(remote_bda);
     if (p_i && (p_i->inq_info.results.inq_result_type & BT_DEVICE_TYPE_BREDR)) {
       tBTM_INQ_INFO* p_cur = &p_i->inq_info;
       uint16_t clock_offset =
@@ -1901,9 +1980,9 @@ tBTM_STATUS btm_initiate_rem_name(const RawAddress& remote_bda,
             page_scan_rep_mode, remote_bda);
         page_scan_rep_mode = HCI_PAGE_SCAN_REP_MODE_R1;
       }
-      bluetooth::shim::ACL_RemoteNameRequest(remote_bda, page_scan_rep_mode,
-                                             p_cur->results.page_scan_mode,
-                                             clock_offset);
+      bluetooth::shim::ACL_RemoteNameRequest(
+          remote_bda, page_scan_rep_mode, p_cur->results.page_scan_mode,
+          clock_offset, prioritized);
     } else {
       uint16_t clock_offset = 0;
       int clock_offset_in_cfg = 0;
@@ -1912,7 +1991,7 @@ tBTM_STATUS btm_initiate_rem_name(const RawAddress& remote_bda,
       }
       bluetooth::shim::ACL_RemoteNameRequest(
           remote_bda, HCI_PAGE_SCAN_REP_MODE_R1, HCI_MANDATARY_PAGE_SCAN_MODE,
-          clock_offset);
+          clock_offset, prioritized);
     }
 
     btm_cb.btm_inq_vars.p_remname_cmpl_cb = p_cb;
@@ -2218,8 +2297,8 @@ uint8_t BTM_GetEirUuidList(const uint8_t* p_eir, size_t eir_len,
   uint32_t* p_uuid32 = (uint32_t*)p_uuid_list;
   char buff[Uuid::kNumBytes128 * 2 + 1];
 
-  p_uuid_data =
-      btm_eir_get_uuid_list(p_eir, eir_len, uuid_size, p_num_uuid, &type);
+  AdvertiseDataIndex eir(p_eir, eir_len);
+  p_uuid_data = btm_eir_get_uuid_list(eir, uuid_size, p_num_uuid, &type);
   if (p_uuid_data == NULL) {
     return 0x00;
   }
@@ -2261,8 +2340,7 @@ uint8_t BTM_GetEirUuidList(const uint8_t* p_eir, size_t eir_len,
  *
  * Description      This function searches UUID list in EIR.
  *
- * Parameters       p_eir - address of EIR
- *                  eir_len - EIR length
+ * Parameters       eir - index of the EIR fields
  *                  uuid_size - size of UUID to find
  *                  p_num_uuid - number of UUIDs found
  *                  p_uuid_list_type - EIR data type
@@ -2271,8 +2349,8 @@ uint8_t BTM_GetEirUuidList(const uint8_t* p_eir, size_t eir_len,
  *                  beginning of UUID list in EIR - otherwise
  *
  ******************************************************************************/
-static const uint8_t* btm_eir_get_uuid_list(const uint8_t* p_eir,
-                                            size_t eir_len, uint8_t uuid_size,
+static const uint8_t* btm_eir_get_uuid_list(const AdvertiseDataIndex& eir,
+                                            uint8_t uuid_size,
                                             uint8_t* p_num_uuid,
                                             uint8_t* p_uuid_list_type) {
   const uint8_t* p_uuid_data;
@@ -2298,11 +2376,9 @@ static const uint8_t* btm_eir_get_uuid_list(const uint8_t* p_eir,
       break;
   }
 
-  p_uuid_data = AdvertiseDataParser::GetFieldByType(p_eir, eir_len,
-                                                    complete_type, &uuid_len);
+  p_uuid_data = eir.GetFieldByType(complete_type, &uuid_len);
   if (p_uuid_data == NULL) {
-    p_uuid_data = AdvertiseDataParser::GetFieldByType(p_eir, eir_len, more_type,
-                                                      &uuid_len);
+    p_uuid_data = eir.GetFieldByType(more_type, &uuid_len);
     *p_uuid_list_type = more_type;
   } else {
     *p_uuid_list_type = complete_type;
@@ -2387,9 +2463,10 @@ void btm_set_eir_uuid(const uint8_t* p_eir, tBTM_INQ_RESULTS* p_results) {
   uint16_t uuid16;
   uint8_t yy;
   uint8_t type = HCI_EIR_MORE_16BITS_UUID_TYPE;
+  AdvertiseDataIndex eir(p_eir, HCI_EXT_INQ_RESPONSE_LEN);
 
-  p_uuid_data = btm_eir_get_uuid_list(p_eir, HCI_EXT_INQ_RESPONSE_LEN,
-                                      Uuid::kNumBytes16, &num_uuid, &type);
+  p_uuid_data =
+      btm_eir_get_uuid_list(eir, Uuid::kNumBytes16, &num_uuid, &type);
 
   if (type == HCI_EIR_COMPLETE_16BITS_UUID_TYPE) {
     p_results->eir_complete_list = true;
@@ -2406,8 +2483,8 @@ void btm_set_eir_uuid(const uint8_t* p_eir, tBTM_INQ_RESULTS* p_results) {
     }
   }
 
-  p_uuid_data = btm_eir_get_uuid_list(p_eir, HCI_EXT_INQ_RESPONSE_LEN,
-                                      Uuid::kNumBytes32, &num_uuid, &type);
+  p_uuid_data =
+      btm_eir_get_uuid_list(eir, Uuid::kNumBytes32, &num_uuid, &type);
   if (p_uuid_data) {
     for (yy = 0; yy < num_uuid; yy++) {
       uuid16 = btm_convert_uuid_to_uuid16(p_uuid_data, Uuid::kNumBytes32);
@@ -2416,8 +2493,8 @@ void btm_set_eir_uuid(const uint8_t* p_eir, tBTM_INQ_RESULTS* p_results) {
     }
   }
 
-  p_uuid_data = btm_eir_get_uuid_list(p_eir, HCI_EXT_INQ_RESPONSE_LEN,
-                                      Uuid::kNumBytes128, &num_uuid, &type);
+  p_uuid_data =
+      btm_eir_get_uuid_list(eir, Uuid::kNumBytes128, &num_uuid, &type);
   if (p_uuid_data) {
     for (yy = 0; yy < num_uuid; yy++) {
       uuid16 = btm_convert_uuid_to_uuid16(p_uuid_data, Uuid::kNumBytes128);
@@ -2471,7 +2548,7 @@ namespace bluetooth {
 namespace legacy {
 namespace testing {
 void btm_clr_inq_db(const RawAddress* p_bda) { ::btm_clr_inq_db(p_bda); }
-uint16_t btm_get_num_bd_entries() { return num_bd_entries_; }
+uint16_t btm_get_num_bd_entries() { return bd_db_.size(); }
 }  // namespace testing
 }  // namespace legacy
 }  // namespace bluetooth
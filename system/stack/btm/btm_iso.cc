@@ -108,6 +108,14 @@ void IsoManager::SendIsoData(uint16_t iso_handle, const uint8_t* data,
   pimpl_->iso_impl_->send_iso_data(iso_handle, data, data_len);
 }
 
+uint8_t* IsoManager::AcquireIsoSdu(uint16_t iso_handle, uint16_t data_len) {
+  return pimpl_->iso_impl_->acquire_iso_sdu(iso_handle, data_len);
+}
+
+void IsoManager::SendIsoSdu(uint16_t iso_handle) {
+  pimpl_->iso_impl_->send_iso_sdu(iso_handle);
+}
+
 void IsoManager::CreateBig(uint8_t big_id,
                            struct iso_manager::big_create_params big_params) {
   pimpl_->iso_impl_->create_big(big_id, std::move(big_params));
@@ -123,6 +131,10 @@ void IsoManager::HandleIsoData(void* p_msg) {
     pimpl_->iso_impl_->handle_iso_data(static_cast<BT_HDR*>(p_msg));
 }
 
+void IsoManager::HandleIsoSdu(const uint8_t* packet, uint16_t len) {
+  if (pimpl_->IsRunning()) pimpl_->iso_impl_->handle_iso_sdu(packet, len);
+}
+
 void IsoManager::HandleDisconnect(uint16_t handle, uint8_t reason) {
   if (pimpl_->IsRunning())
     pimpl_->iso_impl_->disconnection_complete(handle, reason);
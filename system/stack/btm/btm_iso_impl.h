@@ -17,6 +17,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -25,6 +29,7 @@
 #include "base/functional/bind.h"
 #include "base/functional/callback.h"
 #include "btm_dev.h"
+#include "btm_iso_sdu_pool.h"
 #include "btm_iso_api.h"
 #include "common/time_util.h"
 #include "hci/controller_interface.h"
@@ -34,6 +39,7 @@
 #include "main/shim/entry.h"
 #include "main/shim/hci_layer.h"
 #include "os/log.h"
+#include "os/trace.h"
 #include "osi/include/allocator.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
@@ -47,6 +53,13 @@ namespace hci {
 namespace iso_manager {
 static constexpr uint8_t kIsoHeaderWithTsLen = 12;
 static constexpr uint8_t kIsoHeaderWithoutTsLen = 8;
+/* Connection handle and ISO data load length */
+static constexpr uint8_t kIsoPreambleLen = 4;
+static constexpr uint16_t kIsoHandleTsFlag = 0x4000;
+static constexpr uint16_t kIsoHandlePbFlagMask = 0x3000;
+static constexpr uint16_t kIsoHandlePbFlagCompleteSdu = 0x2000;
+static constexpr uint16_t kIsoDataLoadLenMask = 0x3fff;
+static constexpr uint16_t kIsoSduLenMask = 0x0fff;
 
 static constexpr uint8_t kStateFlagsNone = 0x00;
 static constexpr uint8_t kStateFlagIsConnecting = 0x01;
@@ -61,6 +74,8 @@ struct iso_sync_info {
 };
 
 struct iso_base {
+  ~iso_base() { osi_free(pending_sdu); }
+
   union {
     uint8_t cig_id;
     uint8_t big_handle;
@@ -83,8 +98,60 @@ struct iso_base {
     uint64_t evt_last_lost_us = 0;
   };
 
+  /* Latencies in 250 us buckets, the last one also takes all the longer ones */
+  struct latency_histogram {
+    static constexpr uint64_t kBucketUs = 250;
+    static constexpr size_t kNumBuckets = 160;
+
+    std::array<uint32_t, kNumBuckets> buckets = {};
+    size_t count = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+
+    void Add(uint64_t latency_us) {
+      buckets[std::min<uint64_t>(latency_us / kBucketUs, kNumBuckets - 1)]++;
+      count++;
+      total_us += latency_us;
+      max_us = std::max(max_us, latency_us);
+    }
+
+    /* Upper bound of the bucket holding the given percentile */
+    uint64_t Percentile(unsigned percent) const {
+      size_t rank = (count * percent + 99) / 100;
+      size_t seen = 0;
+      for (size_t i = 0; i < kNumBuckets; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+          return std::min((i + 1) * kBucketUs, max_us);
+        }
+      }
+      return max_us;
+    }
+  };
+
+  struct latency_stats {
+    /* HCI submission time of the SDUs not yet reported as completed */
+    std::deque<uint64_t> tx_submit_us;
+    /* Number of SDUs ever submitted, which numbers their trace slices */
+    uint32_t tx_submit_count = 0;
+    /* From the HCI submission to the Number Of Completed Packets event */
+    latency_histogram tx_completion;
+
+    /* Deviation of the SDU arrival spacing from their controller timestamp
+     * spacing, or from the SDU interval when there are no timestamps
+     */
+    latency_histogram rx_jitter;
+    uint64_t rx_last_arrival_us = 0;
+    uint32_t rx_last_ts = 0;
+    uint16_t rx_last_seq_nb = 0;
+  };
+
   credits_stats cr_stats;
   event_stats evt_stats;
+  latency_stats lat_stats;
+
+  /* SDU handed out by acquire_iso_sdu(), waiting for send_iso_sdu() */
+  BT_HDR* pending_sdu = nullptr;
 };
 
 typedef iso_base iso_cis;
@@ -424,7 +491,10 @@ struct iso_impl {
                        "handle:0x%04x, status:%s", conn_handle,
                        hci_status_code_text((tHCI_STATUS)(status)).c_str()));
 
-    if (status == HCI_SUCCESS) iso->state_flags &= ~kStateFlagHasDataPathSet;
+    if (status == HCI_SUCCESS) {
+      iso->state_flags &= ~kStateFlagHasDataPathSet;
+      IsoSduPool::GetInstance().Clear(conn_handle);
+    }
 
     if (iso->state_flags & kStateFlagIsBroadcast) {
       log::assert_that(big_callbacks_ != nullptr, "Invalid BIG callbacks");
@@ -521,11 +591,13 @@ struct iso_impl {
 
     /* Add 2 for handle, 2 for length */
     uint16_t iso_full_len = iso_data_load_len + 4;
-    BT_HDR* packet = (BT_HDR*)osi_malloc(iso_full_len + sizeof(BT_HDR));
+
+    /* Sized for the largest SDU, so that the buffers can be recycled */
+    BT_HDR* packet = IsoSduPool::GetInstance().Acquire(
+        iso_handle, iso_buffer_size_ + kIsoHeaderWithoutTsLen);
     packet->len = iso_full_len;
     packet->offset = 0;
     packet->event = MSG_STACK_TO_HC_HCI_ISO;
-    packet->layer_specific = 0;
 
     uint8_t* packet_data = packet->data;
     UINT16_TO_STREAM(packet_data, iso_handle);
@@ -537,29 +609,33 @@ struct iso_impl {
     return packet;
   }
 
-  void send_iso_data(uint16_t iso_handle, const uint8_t* data,
-                     uint16_t data_len) {
-    iso_base* iso = GetIsoIfKnown(iso_handle);
-    log::assert_that(iso != nullptr, "No such iso connection handle: {}",
-                     loghex(iso_handle));
-
+  bool iso_ready_for_data(iso_base* iso, uint16_t iso_handle) {
     if (!(iso->state_flags & kStateFlagIsBroadcast)) {
       if (!(iso->state_flags & kStateFlagIsConnected)) {
         log::warn("Cis handle: 0x{:x} not established", iso_handle);
-        return;
+        return false;
       }
     }
 
     if (!(iso->state_flags & kStateFlagHasDataPathSet)) {
       log::warn("Data path not set for handle: 0x{:04x}", iso_handle);
-      return;
+      return false;
     }
+    return true;
+  }
+
+  /* Takes the sequence number and the credit of the next SDU. Returns false
+   * when the SDU has to be dropped, which is accounted for here.
+   */
+  bool take_iso_sdu_slot(iso_base* iso, uint16_t iso_handle, uint16_t data_len,
+                         uint16_t* seq_nb) {
+    if (!iso_ready_for_data(iso, iso_handle)) return false;
 
     /* Calculate sequence number for the ISO data packet.
      * It should be incremented by 1 every SDU Interval.
      */
-    uint16_t seq_nb = iso->sync_info.seq_nb;
-    iso->sync_info.seq_nb = (seq_nb + 1) & 0xffff;
+    *seq_nb = iso->sync_info.seq_nb;
+    iso->sync_info.seq_nb = (*seq_nb + 1) & 0xffff;
 
     if (iso_credits_ == 0 || data_len > iso_buffer_size_) {
       iso->cr_stats.credits_underflow_bytes += data_len;
@@ -571,19 +647,82 @@ struct iso_impl {
           ", dropping ISO packet, len: {}, iso credits: {}, iso handle: 0x{:x}",
           static_cast<int>(data_len), static_cast<int>(iso_credits_),
           iso_handle);
-      return;
+      return false;
     }
 
     iso_credits_--;
     iso->used_credits++;
+    iso->lat_stats.tx_submit_us.push_back(
+        bluetooth::common::time_get_os_boottime_us());
+    BT_TRACE_ASYNC_BEGIN(
+        "ISO SDU", iso_sdu_trace_cookie(iso_handle, iso->lat_stats.tx_submit_count++));
+    BT_TRACE_COUNTER("ISO credits", iso_credits_.load());
+    return true;
+  }
 
-    BT_HDR* packet = prepare_hci_packet(iso_handle, seq_nb, data_len);
-    memcpy(packet->data + kIsoHeaderWithoutTsLen, data, data_len);
+  void transmit_iso_sdu(BT_HDR* packet) {
     auto hci = bluetooth::shim::hci_layer_get_interface();
     packet->event = MSG_STACK_TO_HC_HCI_ISO | 0x0001;
     hci->transmit_downward(packet, iso_buffer_size_);
   }
 
+  void send_iso_data(uint16_t iso_handle, const uint8_t* data,
+                     uint16_t data_len) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    log::assert_that(iso != nullptr, "No such iso connection handle: {}",
+                     loghex(iso_handle));
+
+    uint16_t seq_nb;
+    if (!take_iso_sdu_slot(iso, iso_handle, data_len, &seq_nb)) return;
+
+    BT_HDR* packet = prepare_hci_packet(iso_handle, seq_nb, data_len);
+    memcpy(packet->data + kIsoHeaderWithoutTsLen, data, data_len);
+    transmit_iso_sdu(packet);
+  }
+
+  uint8_t* acquire_iso_sdu(uint16_t iso_handle, uint16_t data_len) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    log::assert_that(iso != nullptr, "No such iso connection handle: {}",
+                     loghex(iso_handle));
+
+    /* Let send_iso_data() account for the SDUs which would be dropped */
+    uint8_t state_flags = iso->state_flags;
+    bool ready = (state_flags & kStateFlagHasDataPathSet) &&
+                 (state_flags & (kStateFlagIsBroadcast | kStateFlagIsConnected));
+    if (!ready || iso_credits_ == 0 || data_len > iso_buffer_size_) {
+      return nullptr;
+    }
+
+    /* The sequence number is only known once the SDU is sent */
+    osi_free(iso->pending_sdu);
+    iso->pending_sdu = prepare_hci_packet(iso_handle, 0, data_len);
+    return iso->pending_sdu->data + kIsoHeaderWithoutTsLen;
+  }
+
+  void send_iso_sdu(uint16_t iso_handle) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    log::assert_that(iso != nullptr, "No such iso connection handle: {}",
+                     loghex(iso_handle));
+
+    BT_HDR* packet = iso->pending_sdu;
+    if (packet == nullptr) {
+      log::warn("No SDU acquired for handle: 0x{:04x}", iso_handle);
+      return;
+    }
+    iso->pending_sdu = nullptr;
+
+    uint16_t data_len = packet->len - kIsoHeaderWithoutTsLen;
+    uint16_t seq_nb;
+    if (!take_iso_sdu_slot(iso, iso_handle, data_len, &seq_nb)) {
+      IsoSduPool::GetInstance().Release(iso_handle, packet);
+      return;
+    }
+
+    uint8_t* p_seq_nb = packet->data + 4;
+    UINT16_TO_STREAM(p_seq_nb, seq_nb);
+    transmit_iso_sdu(packet);
+  }
+
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
     cis_establish_cmpl_evt evt;
 
@@ -643,6 +782,7 @@ struct iso_impl {
         base::StringPrintf("cis_handle:0x%04x, reason:%s", handle,
                            hci_error_code_text((tHCI_REASON)(reason)).c_str()));
     cis_hdl_to_addr.erase(handle);
+    IsoSduPool::GetInstance().Clear(handle);
 
     if (cis->state_flags & kStateFlagIsConnected) {
       cis_disconnected_evt evt = {
@@ -657,6 +797,8 @@ struct iso_impl {
       /* return used credits */
       iso_credits_ += cis->used_credits;
       cis->used_credits = 0;
+      cis->lat_stats.tx_submit_us.clear();
+      cis->lat_stats.rx_last_arrival_us = 0;
 
       /* Data path is considered still valid, but can be reconfigured only once
        * CIS is reestablished.
@@ -664,11 +806,36 @@ struct iso_impl {
     }
   }
 
+  /* Identifies the trace slice of an SDU, from its submission to the HCI
+   * until the controller reports it as completed
+   */
+  static int32_t iso_sdu_trace_cookie(uint16_t iso_handle, uint32_t sdu_index) {
+    return static_cast<int32_t>((static_cast<uint32_t>(iso_handle) << 16) |
+                                (sdu_index & 0xffff));
+  }
+
+  static void trace_completed_pkts(iso_base* iso, uint16_t iso_handle,
+                                   uint16_t credits) {
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+    auto& submit_us = iso->lat_stats.tx_submit_us;
+    for (; credits > 0 && !submit_us.empty(); credits--) {
+      /* The SDUs are completed in the order they were submitted */
+      BT_TRACE_ASYNC_END(
+          "ISO SDU",
+          iso_sdu_trace_cookie(
+              iso_handle, iso->lat_stats.tx_submit_count - submit_us.size()));
+      iso->lat_stats.tx_completion.Add(now_us - submit_us.front());
+      submit_us.pop_front();
+    }
+  }
+
   void handle_gd_num_completed_pkts(uint16_t handle, uint16_t credits) {
     auto iter = conn_hdl_to_cis_map_.find(handle);
     if (iter != conn_hdl_to_cis_map_.end()) {
       iter->second->used_credits -= credits;
       iso_credits_ += credits;
+      trace_completed_pkts(iter->second.get(), handle, credits);
+      BT_TRACE_COUNTER("ISO credits", iso_credits_.load());
       return;
     }
 
@@ -676,6 +843,8 @@ struct iso_impl {
     if (iter != conn_hdl_to_bis_map_.end()) {
       iter->second->used_credits -= credits;
       iso_credits_ += credits;
+      trace_completed_pkts(iter->second.get(), handle, credits);
+      BT_TRACE_COUNTER("ISO credits", iso_credits_.load());
     }
   }
 
@@ -746,6 +915,7 @@ struct iso_impl {
     auto bis_it = conn_hdl_to_bis_map_.cbegin();
     while (bis_it != conn_hdl_to_bis_map_.cend()) {
       if (bis_it->second->big_handle == evt.big_id) {
+        IsoSduPool::GetInstance().Clear(bis_it->first);
         bis_it = conn_hdl_to_bis_map_.erase(bis_it);
         is_known_handle = true;
       } else {
@@ -815,14 +985,64 @@ struct iso_impl {
   }
 
   void handle_iso_data(BT_HDR* p_msg) {
-    const uint8_t* stream = p_msg->data;
-    cis_data_evt evt;
-    uint16_t handle, seq_nb;
+    bool has_ts = p_msg->layer_specific & BT_ISO_HDR_CONTAINS_TS;
+    if (p_msg->len <= (has_ts ? kIsoHeaderWithTsLen : kIsoHeaderWithoutTsLen))
+      return;
+
+    dispatch_iso_data(p_msg->data, has_ts, p_msg->data + p_msg->offset,
+                      p_msg->len - p_msg->offset, p_msg);
+  }
+
+  /* Handles an ISO data packet holding a complete SDU, read in place from the
+   * buffer of the HCI layer */
+  void handle_iso_sdu(const uint8_t* packet, uint16_t len) {
+    const uint8_t* stream = packet;
+    uint16_t handle, data_load_len, sdu_len;
+
+    if (len < kIsoHeaderWithoutTsLen) {
+      log::warn("Dropping ISO packet too small ({})", len);
+      return;
+    }
+
+    STREAM_TO_UINT16(handle, stream);
+    STREAM_TO_UINT16(data_load_len, stream);
+    if ((handle & kIsoHandlePbFlagMask) != kIsoHandlePbFlagCompleteSdu) {
+      log::error("Dropping ISO packet not holding a complete SDU");
+      return;
+    }
 
-    if (p_msg->len <= ((p_msg->layer_specific & BT_ISO_HDR_CONTAINS_TS)
-                           ? kIsoHeaderWithTsLen
-                           : kIsoHeaderWithoutTsLen))
+    bool has_ts = handle & kIsoHandleTsFlag;
+    uint8_t header_len = has_ts ? kIsoHeaderWithTsLen : kIsoHeaderWithoutTsLen;
+    if (len < header_len ||
+        (data_load_len & kIsoDataLoadLenMask) != len - kIsoPreambleLen) {
+      log::error("Dropping corrupted ISO packet of {} bytes", len);
       return;
+    }
+
+    /* The SDU length and the packet status flags end the header */
+    stream = packet + header_len - sizeof(uint16_t);
+    STREAM_TO_UINT16(sdu_len, stream);
+    if (sdu_len & ~kIsoSduLenMask) {
+      log::error("packet status flags: 0x{:02x}", sdu_len >> 14);
+    }
+    sdu_len &= kIsoSduLenMask;
+    if (sdu_len != len - header_len) {
+      log::error("Dropping ISO packet with invalid SDU length ({})", sdu_len);
+      return;
+    }
+
+    /* Silently ignore empty report */
+    if (sdu_len == 0) return;
+
+    dispatch_iso_data(packet, has_ts, packet + header_len, sdu_len, nullptr);
+  }
+
+  /* Reports the SDU of the ISO data packet starting at |stream| to the CIG
+   * callbacks. |p_msg| is the buffer holding the packet, if any. */
+  void dispatch_iso_data(const uint8_t* stream, bool has_ts,
+                         const uint8_t* sdu, uint16_t sdu_len, BT_HDR* p_msg) {
+    cis_data_evt evt;
+    uint16_t handle, seq_nb;
 
     log::assert_that(cig_callbacks_ != nullptr, "Invalid CIG callbacks");
 
@@ -836,7 +1056,7 @@ struct iso_impl {
     }
 
     STREAM_SKIP_UINT16(stream);
-    if (p_msg->layer_specific & BT_ISO_HDR_CONTAINS_TS) {
+    if (has_ts) {
       STREAM_TO_UINT32(evt.ts, stream);
     } else {
       evt.ts = 0;
@@ -857,12 +1077,36 @@ struct iso_impl {
       iso->evt_stats.seq_nb_mismatch_count++;
     }
 
+    trace_iso_data_arrival(iso, seq_nb, evt.ts, has_ts);
+
     evt.p_msg = p_msg;
+    evt.sdu = sdu;
+    evt.sdu_len = sdu_len;
     evt.cig_id = iso->cig_id;
     evt.seq_nb = seq_nb;
     cig_callbacks_->OnCisEvent(kIsoEventCisDataAvailable, &evt);
   }
 
+  static void trace_iso_data_arrival(iso_base* iso, uint16_t seq_nb,
+                                     uint32_t ts, bool has_ts) {
+    auto& stats = iso->lat_stats;
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+    if (stats.rx_last_arrival_us != 0) {
+      /* Timestamps wrap around with the sequence numbers */
+      int64_t expected_us =
+          has_ts ? (int64_t)(uint32_t)(ts - stats.rx_last_ts)
+                 : (int64_t)(uint16_t)(seq_nb - stats.rx_last_seq_nb) *
+                       iso->sdu_itv;
+      int64_t spacing_us = now_us - stats.rx_last_arrival_us;
+      stats.rx_jitter.Add(std::abs(spacing_us - expected_us));
+    }
+
+    stats.rx_last_arrival_us = now_us;
+    stats.rx_last_ts = ts;
+    stats.rx_last_seq_nb = seq_nb;
+  }
+
   iso_cis* GetCisIfKnown(uint16_t cis_conn_handle) {
     auto cis_it = conn_hdl_to_cis_map_.find(cis_conn_handle);
     return (cis_it != conn_hdl_to_cis_map_.end()) ? cis_it->second.get()
@@ -927,6 +1171,30 @@ struct iso_impl {
                  : 0llu));
   }
 
+  static void dump_latency_histogram(int fd, const char* name,
+                                     const iso_base::latency_histogram& hist) {
+    if (hist.count == 0) {
+      dprintf(fd, "          %s (us): none\n", name);
+      return;
+    }
+
+    dprintf(fd,
+            "          %s (us): count %zu, avg %llu, p50 %llu, p90 %llu, "
+            "p99 %llu, max %llu\n",
+            name, hist.count, (unsigned long long)(hist.total_us / hist.count),
+            (unsigned long long)hist.Percentile(50),
+            (unsigned long long)hist.Percentile(90),
+            (unsigned long long)hist.Percentile(99),
+            (unsigned long long)hist.max_us);
+  }
+
+  static void dump_latency_stats(int fd, const iso_base::latency_stats& stats) {
+    dprintf(fd, "        Latency Stats:\n");
+    dump_latency_histogram(fd, "TX submission to completion",
+                           stats.tx_completion);
+    dump_latency_histogram(fd, "RX arrival jitter", stats.rx_jitter);
+  }
+
   void dump(int fd) const {
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  ISO Manager:\n");
@@ -946,6 +1214,7 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_latency_stats(fd, cis_pair.second->lat_stats);
     }
     dprintf(fd, "    BISes:\n");
     for (auto const& cis_pair : conn_hdl_to_bis_map_) {
@@ -958,6 +1227,7 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_latency_stats(fd, cis_pair.second->lat_stats);
     }
     dprintf(fd, "  ----------------\n ");
   }
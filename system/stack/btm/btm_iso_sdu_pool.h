@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "osi/include/allocator.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/bt_types.h"
+
+namespace bluetooth::hci::iso_manager {
+
+// Recycles the BT_HDR buffers of the outgoing ISO SDUs, with a free list per
+// ISO handle, so that streaming does not allocate a buffer for every SDU.
+//
+// Buffers are acquired by the ISO manager and released by the HCI shim once
+// the SDU is handed to the controller, on a different thread. They are tagged
+// with BT_ISO_HDR_FROM_SDU_POOL and are regular osi_malloc() allocations: a
+// buffer freed with osi_free() instead is only lost for reuse.
+class IsoSduPool {
+ public:
+  // About the number of SDUs in flight per handle
+  static constexpr size_t kMaxFreeBuffersPerHandle = 4;
+
+  static IsoSduPool& GetInstance() {
+    // Never destroyed, buffers can be released during shutdown
+    static IsoSduPool* instance = new IsoSduPool();
+    return *instance;
+  }
+
+  // Returns a buffer with room for |data_size| bytes after the BT_HDR. All the
+  // SDUs are sized for the controller ISO buffer size, buffers of any other
+  // size are regular allocations left out of the pool.
+  BT_HDR* Acquire(uint16_t iso_handle, size_t data_size) {
+    BT_HDR* packet = nullptr;
+    uint16_t layer_specific = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (data_size_ == 0) data_size_ = data_size;
+      if (data_size == data_size_) {
+        layer_specific = BT_ISO_HDR_FROM_SDU_POOL;
+        auto& free_list = free_lists_[iso_handle];
+        if (!free_list.empty()) {
+          packet = free_list.back();
+          free_list.pop_back();
+        }
+      }
+    }
+
+    if (packet == nullptr) {
+      packet = static_cast<BT_HDR*>(osi_malloc(sizeof(BT_HDR) + data_size));
+    }
+    packet->layer_specific = layer_specific;
+    return packet;
+  }
+
+  void Release(uint16_t iso_handle, BT_HDR* packet) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = free_lists_.find(iso_handle);
+      if (it != free_lists_.end() &&
+          it->second.size() < kMaxFreeBuffersPerHandle) {
+        it->second.push_back(packet);
+        return;
+      }
+    }
+    osi_free(packet);
+  }
+
+  // Drops the free buffers of a handle which no longer streams
+  void Clear(uint16_t iso_handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_lists_.find(iso_handle);
+    if (it == free_lists_.end()) return;
+    FreeBuffers(it->second);
+    free_lists_.erase(it);
+  }
+
+ private:
+  using FreeList = std::vector<BT_HDR*>;
+
+  static void FreeBuffers(FreeList& free_list) {
+    for (auto* packet : free_list) osi_free(packet);
+    free_list.clear();
+  }
+
+  std::mutex mutex_;
+  size_t data_size_ = 0;
+  std::unordered_map<uint16_t, FreeList> free_lists_;
+};
+
+}  // namespace bluetooth::hci::iso_manager
@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "common/bidi_queue.h"
+#include "common/time_util.h"
 #include "device/include/device_iot_config.h"
 #include "hci/class_of_device.h"
 #include "hci/controller_interface.h"
@@ -91,7 +92,8 @@ using namespace bluetooth;
 using bluetooth::legacy::hci::GetInterface;
 
 // forward declaration for dequeueing packets
-static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet);
+static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet,
+                               uint64_t rx_ts_us);
 void btm_sco_conn_req(const RawAddress& bda, const DEV_CLASS& dev_class,
                       uint8_t link_type);
 void btm_sco_on_disconnected(uint16_t hci_handle, tHCI_REASON reason);
@@ -114,8 +116,9 @@ static void sco_data_callback() {
     log::info("Dropping invalid packet of size {}", packet->size());
     return;
   }
-  if (do_in_main_thread(FROM_HERE, base::Bind(&btm_route_sco_data, *packet)) !=
-      BT_STATUS_SUCCESS) {
+  uint64_t rx_ts_us = bluetooth::common::time_get_os_boottime_us();
+  if (do_in_main_thread(FROM_HERE, base::Bind(&btm_route_sco_data, *packet,
+                                              rx_ts_us)) != BT_STATUS_SUCCESS) {
     log::error("do_in_main_thread failed from sco_data_callback");
   }
 }
@@ -204,9 +207,37 @@ void tSCO_CB::Free() {
 
 /* Buffer used for reading PCM data from audio server that will be encoded into
  * mSBC packet. The BTM_SCO_DATA_SIZE_MAX should be set to a number divisible by
- * BTM_MSBC_CODE_SIZE(240) */
-static uint8_t btm_pcm_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
-static uint8_t packet_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
+ * BTM_MSBC_CODE_SIZE(240), so that the frames passed to the encoder are
+ * contiguous in the buffer and need no copy. */
+alignas(int16_t) static uint8_t btm_pcm_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
+/* Only used to linearize a frame that wraps around the end of btm_pcm_buf */
+alignas(int16_t) static uint8_t packet_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
+/* Collects the PCM decoded from one SCO packet so that it is written to the
+ * audio server at once */
+static uint8_t decoded_buf[BTM_SCO_DATA_SIZE_MAX] = {0};
+
+/* Host latency of the in-band data path. The queue delay is the time a received
+ * SCO packet waits for the main thread, the route time is the time spent
+ * decoding it, exchanging PCM with the audio server and sending the encoded
+ * reply. Reset on every in-band WBS/SWB connection. */
+struct tBTM_SCO_DATA_PATH_LATENCY {
+  uint64_t num_packets;
+  uint64_t total_queue_us;
+  uint64_t max_queue_us;
+  uint64_t total_route_us;
+  uint64_t max_route_us;
+
+  void update(uint64_t rx_ts_us, uint64_t start_us, uint64_t end_us) {
+    uint64_t queue_us = start_us - rx_ts_us;
+    uint64_t route_us = end_us - start_us;
+    num_packets++;
+    total_queue_us += queue_us;
+    total_route_us += route_us;
+    if (queue_us > max_queue_us) max_queue_us = queue_us;
+    if (route_us > max_route_us) max_route_us = route_us;
+  }
+};
+static tBTM_SCO_DATA_PATH_LATENCY btm_sco_data_path_latency = {};
 
 /* The read and write offset for btm_pcm_buf.
  * They are only used for WBS and the unit is byte. */
@@ -263,23 +294,12 @@ size_t btm_pcm_buf_avail_len() {
   return BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_data_len();
 }
 
-size_t write_btm_pcm_buf(uint8_t* source, size_t amount) {
-  if (btm_pcm_buf_avail_len() < amount) {
-    return 0;
-  }
-
+/* The space that can be written at btm_pcm_buf_write_offset without wrapping
+ * around the end of btm_pcm_buf. */
+size_t btm_pcm_buf_contiguous_avail_len() {
+  size_t avail = btm_pcm_buf_avail_len();
   size_t bytes_remaining = BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_write_offset;
-  if (bytes_remaining > amount) {
-    std::copy(source, source + amount, btm_pcm_buf + btm_pcm_buf_write_offset);
-  } else {
-    std::copy(source, source + bytes_remaining,
-              btm_pcm_buf + btm_pcm_buf_write_offset);
-    std::copy(source + bytes_remaining, source + amount, btm_pcm_buf);
-  }
-
-  incr_btm_pcm_buf_offset(btm_pcm_buf_write_offset, btm_pcm_buf_write_mirror,
-                          amount);
-  return amount;
+  return avail < bytes_remaining ? avail : bytes_remaining;
 }
 
 /******************************************************************************/
@@ -387,7 +407,9 @@ static tSCO_CONN* btm_get_active_sco() {
  * Returns          void
  *
  ******************************************************************************/
-static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
+static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet,
+                               uint64_t rx_ts_us) {
+  uint64_t start_us = bluetooth::common::time_get_os_boottime_us();
   uint16_t handle = valid_packet.GetHandle();
   if (handle > HCI_HANDLE_MAX) {
     log::error("Dropping SCO data with invalid handle: 0x{:X} > 0x{:X},",
@@ -428,6 +450,7 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
         data, status != bluetooth::hci::PacketStatusFlag::CORRECTLY_RECEIVED);
     if (!rc) log::debug("Failed to enqueue {} packet", codec);
 
+    size_t decoded_len = 0;
     while (rc) {
       auto decode = codec_type == BTM_SCO_CODEC_LC3
                         ? &bluetooth::audio::sco::swb::decode
@@ -435,7 +458,17 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
       rc = decode(&decoded);
       if (rc == 0) break;
 
-      written += bluetooth::audio::sco::write(decoded, rc);
+      if (decoded_len + rc > sizeof(decoded_buf)) {
+        written += bluetooth::audio::sco::write(decoded_buf, decoded_len);
+        decoded_len = 0;
+      }
+      std::copy(decoded, decoded + rc, decoded_buf + decoded_len);
+      decoded_len += rc;
+    }
+
+    /* Write all the frames completed by this packet in one go */
+    if (decoded_len) {
+      written += bluetooth::audio::sco::write(decoded_buf, decoded_len);
     }
   } else {
     written = bluetooth::audio::sco::write(rx_data, data.size());
@@ -448,14 +481,16 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
 
   if (codec_type == BTM_SCO_CODEC_MSBC || codec_type == BTM_SCO_CODEC_LC3) {
     while (written) {
-      size_t avail = btm_pcm_buf_avail_len();
+      size_t avail = btm_pcm_buf_contiguous_avail_len();
       if (avail) {
         size_t to_read = written < avail ? written : avail;
 
-        // Read to the packet_buf first and then copy to the btm_pcm_buf.
-        read = bluetooth::audio::sco::read(packet_buf, to_read);
-
-        write_btm_pcm_buf(packet_buf, read);
+        // Read straight into the btm_pcm_buf, the part that wraps around is
+        // read on the next iteration.
+        read = bluetooth::audio::sco::read(
+            btm_pcm_buf + btm_pcm_buf_write_offset, to_read);
+        incr_btm_pcm_buf_offset(btm_pcm_buf_write_offset,
+                                btm_pcm_buf_write_mirror, read);
 
         if (read != to_read) {
           log::info(
@@ -483,22 +518,23 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
       size_t data_len = btm_pcm_buf_data_len();
 
       if (data_len) {
-        // Copy all data to the packet_buf first and then call encode.
+        size_t code_size = codec_type == BTM_SCO_CODEC_LC3 ? BTM_LC3_CODE_SIZE
+                                                           : BTM_MSBC_CODE_SIZE;
         size_t bytes_remaining =
             BTM_SCO_DATA_SIZE_MAX - btm_pcm_buf_read_offset;
 
-        if (bytes_remaining > data_len) {
-          std::copy(btm_pcm_buf + btm_pcm_buf_read_offset,
-                    btm_pcm_buf + btm_pcm_buf_read_offset + data_len,
-                    packet_buf);
+        if (bytes_remaining >= code_size || bytes_remaining >= data_len) {
+          // The frame is contiguous, encode it in place.
+          rc = encode((int16_t*)(btm_pcm_buf + btm_pcm_buf_read_offset),
+                      bytes_remaining < data_len ? bytes_remaining : data_len);
         } else {
+          // Copy the frame that wraps around to the packet_buf first.
           std::copy(btm_pcm_buf + btm_pcm_buf_read_offset,
                     btm_pcm_buf + BTM_SCO_DATA_SIZE_MAX, packet_buf);
           std::copy(btm_pcm_buf, btm_pcm_buf + data_len - bytes_remaining,
                     packet_buf + bytes_remaining);
+          rc = encode((int16_t*)packet_buf, data_len);
         }
-
-        rc = encode((int16_t*)packet_buf, data_len);
         incr_btm_pcm_buf_offset(btm_pcm_buf_read_offset,
                                 btm_pcm_buf_read_mirror, rc);
 
@@ -544,6 +580,9 @@ static void btm_route_sco_data(bluetooth::hci::ScoView valid_packet) {
       btm_send_sco_packet(std::move(data));
     }
   }
+
+  btm_sco_data_path_latency.update(
+      rx_ts_us, start_us, bluetooth::common::time_get_os_boottime_us());
 }
 
 void btm_send_sco_packet(std::vector<uint8_t> data) {
@@ -1107,6 +1146,7 @@ void btm_sco_connected(const RawAddress& bda, uint16_t hci_handle,
             codec_type == BTM_SCO_CODEC_LC3) {
           btm_pcm_buf_read_offset = 0;
           btm_pcm_buf_write_offset = 0;
+          btm_sco_data_path_latency = {};
           auto init = codec_type == BTM_SCO_CODEC_LC3
                           ? &bluetooth::audio::sco::swb::init
                           : &bluetooth::audio::sco::wbs::init;
@@ -1356,6 +1396,16 @@ void btm_sco_on_disconnected(uint16_t hci_handle, tHCI_REASON reason) {
         log::warn("Failed to get the packet loss stats");
       }
 
+      const auto& latency = btm_sco_data_path_latency;
+      if (latency.num_packets) {
+        log::info(
+            "SCO data path num_packets:{}, queue_us avg:{} max:{}, route_us "
+            "avg:{} max:{}",
+            latency.num_packets, latency.total_queue_us / latency.num_packets,
+            latency.max_queue_us, latency.total_route_us / latency.num_packets,
+            latency.max_route_us);
+      }
+
       auto cleanup = codec_type == BTM_SCO_CODEC_LC3
                          ? bluetooth::audio::sco::swb::cleanup
                          : bluetooth::audio::sco::wbs::cleanup;
@@ -18,11 +18,9 @@
 
 #include <bluetooth/log.h>
 #include <grp.h>
-#include <math.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-#include <cfloat>
 #include <memory>
 
 #include "btif/include/core_callbacks.h"
@@ -30,6 +28,7 @@
 #include "os/log.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_sco.h"
+#include "stack/btm/btm_sco_plc.h"
 #include "udrv/include/uipc.h"
 
 #define SCO_DATA_READ_POLL_MS 10
@@ -44,17 +43,6 @@
 #define BTM_MSBC_PKT_FRAME_LEN 57 /* Packet length without the header */
 #define BTM_MSBC_SYNC_WORD 0xAD
 
-/* Used by PLC */
-#define BTM_MSBC_SAMPLE_SIZE 2 /* 2 bytes*/
-#define BTM_MSBC_FS 120        /* Frame Size */
-
-#define BTM_PLC_WL 256 /* 16ms - Window Length for pattern matching */
-#define BTM_PLC_TL 64  /* 4ms - Template Length for matching */
-#define BTM_PLC_HL \
-  (BTM_PLC_WL + BTM_MSBC_FS - 1) /* Length of History buffer required */
-#define BTM_PLC_SBCRL 36         /* SBC Reconvergence sample Length */
-#define BTM_PLC_OLAL 16          /* OverLap-Add Length */
-
 /* Disable the PLC when there are more than threshold of lost packets in the
  * window */
 #define BTM_PLC_WINDOW_SIZE 5
@@ -174,18 +162,6 @@ static const uint8_t btm_msbc_zero_packet[] = {
     /* End of Audio Samples */
     0x00 /* A padding byte defined by mSBC */};
 
-/* Raised Cosine table for OLA */
-static const float rcos[BTM_PLC_OLAL] = {
-    0.99148655f, 0.96623611f, 0.92510857f, 0.86950446f,
-    0.80131732f, 0.72286918f, 0.63683150f, 0.54613418f,
-    0.45386582f, 0.36316850f, 0.27713082f, 0.19868268f,
-    0.13049554f, 0.07489143f, 0.03376389f, 0.00851345f};
-
-static int16_t f_to_s16(float input) {
-  return input > INT16_MAX   ? INT16_MAX
-         : input < INT16_MIN ? INT16_MIN
-                             : (int16_t)input;
-}
 /* This structure tracks the packet loss for last PLC_WINDOW_SIZE of packets */
 struct tBTM_MSBC_BTM_PLC_WINDOW {
   bool loss_hist[BTM_PLC_WINDOW_SIZE]; /* The packet loss history of receiving
@@ -243,53 +219,6 @@ struct tBTM_MSBC_PLC {
   int num_decoded_frames; /* Number of total read mSBC frames. */
   int num_lost_frames;    /* Number of total lost mSBC frames. */
 
-  void overlap_add(int16_t* output, float scaler_d, const int16_t* desc,
-                   float scaler_a, const int16_t* asc) {
-    for (int i = 0; i < BTM_PLC_OLAL; i++) {
-      output[i] = f_to_s16(scaler_d * desc[i] * rcos[i] +
-                           scaler_a * asc[i] * rcos[BTM_PLC_OLAL - 1 - i]);
-    }
-  }
-
-  float cross_correlation(int16_t* x, int16_t* y) {
-    float sum = 0, x2 = 0, y2 = 0;
-
-    for (int i = 0; i < BTM_PLC_TL; i++) {
-      sum += ((float)x[i]) * y[i];
-      x2 += ((float)x[i]) * x[i];
-      y2 += ((float)y[i]) * y[i];
-    }
-    return sum / sqrtf(x2 * y2);
-  }
-
-  int pattern_match(int16_t* hist) {
-    int best = 0;
-    float cn, max_cn = FLT_MIN;
-
-    for (int i = 0; i < BTM_PLC_WL; i++) {
-      cn = cross_correlation(&hist[BTM_PLC_HL - BTM_PLC_TL], &hist[i]);
-      if (cn > max_cn) {
-        best = i;
-        max_cn = cn;
-      }
-    }
-    return best;
-  }
-
-  float amplitude_match(int16_t* x, int16_t* y) {
-    uint32_t sum_x = 0, sum_y = 0;
-    float scaler;
-    for (int i = 0; i < BTM_MSBC_FS; i++) {
-      sum_x += abs(x[i]);
-      sum_y += abs(y[i]);
-    }
-
-    if (sum_y == 0) return 1.2f;
-
-    scaler = (float)sum_x / sum_y;
-    return scaler > 1.2f ? 1.2f : scaler < 0.75f ? 0.75f : scaler;
-  }
-
  public:
   void init() {
     if (pl_window) osi_free(pl_window);
@@ -323,18 +252,20 @@ struct tBTM_MSBC_PLC {
     if (!pl_window->is_packet_loss_too_high()) {
       if (handled_bad_frames == 0) {
         /* Finds the best matching samples and amplitude */
-        best_lag = pattern_match(hist) + BTM_PLC_TL;
+        best_lag = plc::pattern_match(hist) + BTM_PLC_TL;
         best_match_hist = &hist[best_lag];
         scaler =
-            amplitude_match(&hist[BTM_PLC_HL - BTM_MSBC_FS], best_match_hist);
+            plc::amplitude_match(&hist[BTM_PLC_HL - BTM_MSBC_FS],
+                                 best_match_hist);
 
         /* Constructs the substitution samples */
-        overlap_add(frame_head, 1.0, decoded_buffer, scaler, best_match_hist);
-        for (int i = BTM_PLC_OLAL; i < BTM_MSBC_FS; i++)
-          hist[BTM_PLC_HL + i] = f_to_s16(scaler * best_match_hist[i]);
-        overlap_add(&frame_head[BTM_MSBC_FS], scaler,
-                    &best_match_hist[BTM_MSBC_FS], 1.0,
-                    &best_match_hist[BTM_MSBC_FS]);
+        plc::overlap_add(frame_head, 1.0, decoded_buffer, scaler,
+                         best_match_hist);
+        plc::scale(&frame_head[BTM_PLC_OLAL], &best_match_hist[BTM_PLC_OLAL],
+                   scaler, BTM_MSBC_FS - BTM_PLC_OLAL);
+        plc::overlap_add(&frame_head[BTM_MSBC_FS], scaler,
+                         &best_match_hist[BTM_MSBC_FS], 1.0,
+                         &best_match_hist[BTM_MSBC_FS]);
 
         memmove(&frame_head[BTM_MSBC_FS + BTM_PLC_OLAL],
                 &best_match_hist[BTM_MSBC_FS + BTM_PLC_OLAL],
@@ -386,8 +317,8 @@ struct tBTM_MSBC_PLC {
        * received samples to have it reconverge with the true output */
       std::copy(frame_head, &frame_head[BTM_PLC_SBCRL], input);
       /* Overlap the input frame with the previous output frame */
-      overlap_add(&input[BTM_PLC_SBCRL], 1.0, &frame_head[BTM_PLC_SBCRL], 1.0,
-                  &input[BTM_PLC_SBCRL]);
+      plc::overlap_add(&input[BTM_PLC_SBCRL], 1.0, &frame_head[BTM_PLC_SBCRL],
+                       1.0, &input[BTM_PLC_SBCRL]);
       handled_bad_frames = 0;
     }
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/btm/btm_sco_plc.h"
+
+#include <math.h>
+
+#include <cfloat>
+#include <cstdlib>
+
+namespace {
+
+/* Raised Cosine table for OLA */
+const float rcos[BTM_PLC_OLAL] = {
+    0.99148655f, 0.96623611f, 0.92510857f, 0.86950446f,
+    0.80131732f, 0.72286918f, 0.63683150f, 0.54613418f,
+    0.45386582f, 0.36316850f, 0.27713082f, 0.19868268f,
+    0.13049554f, 0.07489143f, 0.03376389f, 0.00851345f};
+
+/* Independent partial sums of the dot products, so that the loop can run in
+ * vector lanes without reordering any addition. */
+constexpr int kDotLanes = 8;
+static_assert(BTM_PLC_TL % kDotLanes == 0);
+
+/* Samples of the history read by pattern_match */
+constexpr int kMatchLen = BTM_PLC_WL + BTM_PLC_TL - 1;
+
+int16_t f_to_s16(float input) {
+  return input > INT16_MAX   ? INT16_MAX
+         : input < INT16_MIN ? INT16_MIN
+                             : (int16_t)input;
+}
+
+/* The samples are integers below 2^15, so the products and their sums below
+ * 2^53 are exact in double whatever the order of the additions. */
+double dot_product(const double* x, const double* y) {
+  double sum[kDotLanes] = {};
+
+  for (int i = 0; i < BTM_PLC_TL; i += kDotLanes) {
+    for (int j = 0; j < kDotLanes; j++) sum[j] += x[i + j] * y[i + j];
+  }
+
+  double total = 0;
+  for (int j = 0; j < kDotLanes; j++) total += sum[j];
+  return total;
+}
+
+}  // namespace
+
+namespace bluetooth {
+namespace audio {
+namespace sco {
+namespace wbs {
+namespace plc {
+
+void scale(int16_t* output, const int16_t* input, float scaler, size_t len) {
+  for (size_t i = 0; i < len; i++) output[i] = f_to_s16(scaler * input[i]);
+}
+
+void overlap_add(int16_t* output, float scaler_d, const int16_t* desc,
+                 float scaler_a, const int16_t* asc) {
+  for (int i = 0; i < BTM_PLC_OLAL; i++) {
+    output[i] = f_to_s16(scaler_d * desc[i] * rcos[i] +
+                         scaler_a * asc[i] * rcos[BTM_PLC_OLAL - 1 - i]);
+  }
+}
+
+/* Normalized cross correlation of the template with each of the BTM_PLC_WL
+ * windows of the history. The energy of the template is computed once and the
+ * energy of the window is updated as it slides, so only the dot product is
+ * computed for each window. */
+int pattern_match(const int16_t* hist) {
+  double h[kMatchLen];
+  double t[BTM_PLC_TL];
+
+  for (int i = 0; i < kMatchLen; i++) h[i] = hist[i];
+  for (int i = 0; i < BTM_PLC_TL; i++) t[i] = hist[BTM_PLC_HL - BTM_PLC_TL + i];
+
+  double x2 = dot_product(t, t);
+  double y2 = dot_product(h, h);
+
+  int best = 0;
+  double cn, max_cn = FLT_MIN;
+
+  for (int i = 0; i < BTM_PLC_WL; i++) {
+    if (i > 0) {
+      y2 += h[i + BTM_PLC_TL - 1] * h[i + BTM_PLC_TL - 1] - h[i - 1] * h[i - 1];
+    }
+    cn = dot_product(t, &h[i]) / sqrt(x2 * y2);
+    if (cn > max_cn) {
+      best = i;
+      max_cn = cn;
+    }
+  }
+  return best;
+}
+
+float amplitude_match(const int16_t* x, const int16_t* y) {
+  uint32_t sum_x = 0, sum_y = 0;
+  float scaler;
+  for (int i = 0; i < BTM_MSBC_FS; i++) {
+    sum_x += abs(x[i]);
+    sum_y += abs(y[i]);
+  }
+
+  if (sum_y == 0) return 1.2f;
+
+  scaler = (float)sum_x / sum_y;
+  return scaler > 1.2f ? 1.2f : scaler < 0.75f ? 0.75f : scaler;
+}
+
+}  // namespace plc
+}  // namespace wbs
+}  // namespace sco
+}  // namespace audio
+}  // namespace bluetooth
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* Used by PLC */
+#define BTM_MSBC_SAMPLE_SIZE 2 /* 2 bytes*/
+#define BTM_MSBC_FS 120        /* Frame Size */
+
+#define BTM_PLC_WL 256 /* 16ms - Window Length for pattern matching */
+#define BTM_PLC_TL 64  /* 4ms - Template Length for matching */
+#define BTM_PLC_HL \
+  (BTM_PLC_WL + BTM_MSBC_FS - 1) /* Length of History buffer required */
+#define BTM_PLC_SBCRL 36         /* SBC Reconvergence sample Length */
+#define BTM_PLC_OLAL 16          /* OverLap-Add Length */
+
+/* Signal processing steps of the mSBC packet loss concealment, written so that
+ * the compiler can vectorize them. */
+namespace bluetooth {
+namespace audio {
+namespace sco {
+namespace wbs {
+namespace plc {
+
+/* output[i] = scaler * input[i], saturated to int16_t, for i < len. output may
+ * overlap input at a higher address, each sample is read before any later one
+ * is written. */
+void scale(int16_t* output, const int16_t* input, float scaler, size_t len);
+
+/* Mixes BTM_PLC_OLAL samples of desc fading out with asc fading in. */
+void overlap_add(int16_t* output, float scaler_d, const int16_t* desc,
+                 float scaler_a, const int16_t* asc);
+
+/* Returns the offset, below BTM_PLC_WL, of the BTM_PLC_TL samples of hist best
+ * correlated with the BTM_PLC_TL samples ending at hist[BTM_PLC_HL]. */
+int pattern_match(const int16_t* hist);
+
+/* Returns the ratio of the amplitudes of the BTM_MSBC_FS samples of x and y,
+ * bounded to [0.75, 1.2]. */
+float amplitude_match(const int16_t* x, const int16_t* y);
+
+}  // namespace plc
+}  // namespace wbs
+}  // namespace sco
+}  // namespace audio
+}  // namespace bluetooth
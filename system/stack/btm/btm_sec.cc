@@ -1580,6 +1580,7 @@ tBTM_STATUS btm_sec_l2cap_access_req_by_requirement(
   tBTM_SEC_DEV_REC* p_dev_rec = btm_find_or_alloc_dev(bd_addr);
 
   p_dev_rec->hci_handle = BTM_GetHCIConnHandle(bd_addr, BT_TRANSPORT_BR_EDR);
+  btm_sec_cb.sec_dev_index.Invalidate(p_dev_rec->hci_handle);
 
   if ((!is_originator) && (security_required & BTM_SEC_MODE4_LEVEL4)) {
     bool local_supports_sc =
@@ -3858,6 +3859,7 @@ void btm_sec_connected(const RawAddress& bda, uint16_t handle,
                                       p_dev_rec->sec_rec.sec_flags));
   }
 
+  btm_sec_cb.sec_dev_index.Invalidate(handle);
   p_dev_rec->hci_handle = handle;
   btm_acl_created(bda, handle, assigned_role, BT_TRANSPORT_BR_EDR);
 
@@ -4237,7 +4239,8 @@ void btm_sec_link_key_notification(const RawAddress& p_bda,
      * resolution */
     if (we_are_bonding) {
       bluetooth::shim::ACL_RemoteNameRequest(p_bda, HCI_PAGE_SCAN_REP_MODE_R1,
-                                             HCI_MANDATARY_PAGE_SCAN_MODE, 0);
+                                             HCI_MANDATARY_PAGE_SCAN_MODE, 0,
+                                             true);
     }
 
     log::verbose("rmt_io_caps:{}, sec_flags:x{:x}, dev_class[1]:x{:02x}",
@@ -4548,9 +4551,9 @@ void btm_sec_pin_code_request(const RawAddress p_bda) {
       /* We received PIN code request for the device with unknown name */
       /* it is not user friendly just to ask for the PIN without name */
       /* try to get name at first */
-      bluetooth::shim::ACL_RemoteNameRequest(p_dev_rec->bd_addr,
-                                             HCI_PAGE_SCAN_REP_MODE_R1,
-                                             HCI_MANDATARY_PAGE_SCAN_MODE, 0);
+      bluetooth::shim::ACL_RemoteNameRequest(
+          p_dev_rec->bd_addr, HCI_PAGE_SCAN_REP_MODE_R1,
+          HCI_MANDATARY_PAGE_SCAN_MODE, 0, true);
     }
   }
 
@@ -4756,7 +4759,7 @@ static bool btm_sec_start_get_name(tBTM_SEC_DEV_REC* p_dev_rec) {
    * security get name case */
   bluetooth::shim::ACL_RemoteNameRequest(p_dev_rec->bd_addr,
                                          HCI_PAGE_SCAN_REP_MODE_R1,
-                                         HCI_MANDATARY_PAGE_SCAN_MODE, 0);
+                                         HCI_MANDATARY_PAGE_SCAN_MODE, 0, true);
   return true;
 }
 
@@ -59,12 +59,14 @@ void tBTM_SEC_CB::Init(uint8_t initial_security_mode) {
     *((tBTM_SEC_DEV_REC*)ptr) = {};
     osi_free(ptr);
   });
+  sec_dev_index.Enable();
 }
 
 void tBTM_SEC_CB::Free() {
   fixed_queue_free(sec_pending_q, nullptr);
   sec_pending_q = nullptr;
 
+  sec_dev_index.Disable();
   list_free(sec_dev_rec);
   sec_dev_rec = nullptr;
 
@@ -26,13 +26,19 @@
 #include <bluetooth/log.h>
 
 #include "common/message_loop_thread.h"
+#include "common/worker_pool.h"
 #include "include/hardware/bluetooth.h"
 #include "os/log.h"
 
 using bluetooth::common::MessageLoopThread;
+using bluetooth::common::WorkerPool;
 using namespace bluetooth;
 
+// Number of threads of the worker pool shared by the profiles
+static constexpr size_t kNumWorkerThreads = 2;
+
 static MessageLoopThread main_thread("bt_main_thread");
+static WorkerPool worker_pool("bt_worker", kNumWorkerThreads);
 
 bluetooth::common::MessageLoopThread* get_main_thread() { return &main_thread; }
 bluetooth::common::PostableContext* get_main() {
@@ -58,6 +64,15 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
   return BT_STATUS_SUCCESS;
 }
 
+bt_status_t do_in_worker_pool(const base::Location& from_here,
+                              base::OnceClosure task) {
+  if (!worker_pool.DoInWorker(from_here, std::move(task))) {
+    log::error("failed from {}", from_here.ToString());
+    return BT_STATUS_JNI_THREAD_ATTACH_ERROR;
+  }
+  return BT_STATUS_SUCCESS;
+}
+
 static void do_post_on_bt_main(BtMainClosure closure) { closure(); }
 
 void post_on_bt_main(BtMainClosure closure) {
@@ -82,6 +97,11 @@ void main_thread_start_up() {
     log::error("unable to enable real time scheduling");
 #endif
   }
+  worker_pool.StartUp();
 }
 
-void main_thread_shut_down() { main_thread.ShutDown(); }
+void main_thread_shut_down() {
+  // The pending tasks of the pool may still reply to the main thread
+  worker_pool.ShutDown();
+  main_thread.ShutDown();
+}
@@ -185,6 +185,15 @@ EattChannel* EattExtension::GetChannelAvailableForClientRequest(
   return pimpl_->eatt_impl_->get_channel_available_for_client_request(bd_addr);
 }
 
+std::vector<EattChannel*> EattExtension::GetOpenedChannels(
+    const RawAddress& bd_addr) {
+  return pimpl_->eatt_impl_->get_opened_channels(bd_addr);
+}
+
+void EattExtension::ConnectAdditionalChannel(const RawAddress& bd_addr) {
+  pimpl_->eatt_impl_->connect_additional_channel(bd_addr);
+}
+
 /* Start stop GATT indication timer per CID */
 void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr,
                                                      uint16_t cid) {
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <vector>
 
 #include "os/logging/log_adapter.h"
 #include "stack/gatt/gatt_int.h"
@@ -244,6 +245,25 @@ class EattExtension {
   virtual EattChannel* GetChannelAvailableForClientRequest(
       const RawAddress& bd_addr);
 
+  /**
+   * Get the opened EATT channels of the peer device.
+   *
+   * @param bd_addr peer device address
+   *
+   * @return pointers to the opened EATT channels.
+   */
+  virtual std::vector<EattChannel*> GetOpenedChannels(
+      const RawAddress& bd_addr);
+
+  /**
+   * Open one more EATT channel to the peer device, used when all the bearers
+   * are busy. Nothing is done when the device already has the maximum number
+   * of channels or is still opening some.
+   *
+   * @param bd_addr peer device address
+   */
+  virtual void ConnectAdditionalChannel(const RawAddress& bd_addr);
+
   /**
    * Start GATT indication timer per CID.
    *
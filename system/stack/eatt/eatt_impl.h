@@ -28,6 +28,7 @@
 #include "main/shim/entry.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/gatt/gatt_int.h"
 #include "stack/include/bt_hdr.h"
@@ -41,6 +42,11 @@ namespace eatt {
 
 #define BLE_GATT_SVR_SUP_FEAT_EATT_BITMASK 0x01
 
+/* Maximum number of EATT channels opened to a device, channels beyond the
+ * ones opened on connection are added while all the bearers are busy */
+static constexpr char kPropertyEattMaxChannels[] =
+    "bluetooth.core.le.eatt_max_channels";
+
 class eatt_device {
  public:
   RawAddress bda_;
@@ -51,8 +57,14 @@ class eatt_device {
 
   std::map<uint16_t, std::shared_ptr<EattChannel>> eatt_channels;
   bool collision;
+  /* The peer refused a channel, do not ask for more on this connection */
+  bool channel_refused;
   eatt_device(const RawAddress& bd_addr, uint16_t mtu, uint16_t mps)
-      : rx_mtu_(mtu), rx_mps_(mps), eatt_tcb_(nullptr), collision(false) {
+      : rx_mtu_(mtu),
+        rx_mps_(mps),
+        eatt_tcb_(nullptr),
+        collision(false),
+        channel_refused(false) {
     bda_ = bd_addr;
   }
 };
@@ -62,6 +74,7 @@ struct eatt_impl {
   uint16_t psm_;
   uint16_t default_mtu_;
   uint16_t max_mps_;
+  size_t max_channels_;
   tL2CAP_APPL_INFO reg_info_;
 
   base::WeakPtrFactory<eatt_impl> weak_factory_{this};
@@ -70,6 +83,10 @@ struct eatt_impl {
     default_mtu_ = EATT_DEFAULT_MTU;
     max_mps_ = EATT_MIN_MTU_MPS;
     psm_ = BT_PSM_EATT;
+    max_channels_ = std::max(
+        osi_property_get_int32(kPropertyEattMaxChannels,
+                               L2CAP_CREDIT_BASED_MAX_CIDS),
+        1);
   };
 
   ~eatt_impl() = default;
@@ -120,8 +137,12 @@ struct eatt_impl {
     }
 
     eatt_dev->eatt_channels.erase(lcid);
+    if (eatt_dev->eatt_tcb_) eatt_dev->eatt_tcb_->bearer_stats.erase(lcid);
 
-    if (eatt_dev->eatt_channels.size() == 0) eatt_dev->eatt_tcb_ = NULL;
+    if (eatt_dev->eatt_channels.size() == 0) {
+      eatt_dev->eatt_tcb_ = NULL;
+      eatt_dev->channel_refused = false;
+    }
   }
 
   void remove_channel_by_cid(uint16_t lcid) {
@@ -486,6 +507,7 @@ struct eatt_impl {
       case EattChannelState::EATT_CHANNEL_PENDING:
         log::warn("Channel for cid: 0x{:x} is not extablished, reason: 0x{:x}",
                   lcid, reason);
+        eatt_dev->channel_refused = true;
         remove_channel_by_cid(eatt_dev, lcid);
         break;
       case EattChannelState::EATT_CHANNEL_RECONFIGURING:
@@ -689,6 +711,40 @@ struct eatt_impl {
                                                    : iter->second.get();
   }
 
+  std::vector<EattChannel*> get_opened_channels(const RawAddress& bd_addr) {
+    std::vector<EattChannel*> channels;
+    eatt_device* eatt_dev = find_device_by_address(bd_addr);
+    if (!eatt_dev) return channels;
+
+    for (const auto& [cid, channel] : eatt_dev->eatt_channels) {
+      if (channel->state_ == EattChannelState::EATT_CHANNEL_OPENED) {
+        channels.push_back(channel.get());
+      }
+    }
+    return channels;
+  }
+
+  void connect_additional_channel(const RawAddress& bd_addr) {
+    eatt_device* eatt_dev = find_device_by_address(bd_addr);
+    if (!eatt_dev || !eatt_dev->eatt_tcb_ || eatt_dev->collision ||
+        eatt_dev->channel_refused) {
+      return;
+    }
+
+    /* Like the initial channels, the additional ones are opened by the
+     * central */
+    if (L2CA_GetBleConnRole(bd_addr) != HCI_ROLE_CENTRAL) return;
+
+    if (eatt_dev->eatt_channels.size() >= max_channels_ ||
+        is_channel_connection_pending(eatt_dev)) {
+      return;
+    }
+
+    log::info("All bearers busy, open channel {} of {} to {}",
+              eatt_dev->eatt_channels.size() + 1, max_channels_, bd_addr);
+    connect_eatt(eatt_dev, 1);
+  }
+
   void free_gatt_resources(const RawAddress& bd_addr) {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
     if (!eatt_dev) return;
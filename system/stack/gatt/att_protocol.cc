@@ -22,6 +22,8 @@
  *
  ******************************************************************************/
 
+#define OSI_ALLOC_TAG "gatt"
+
 #include <bluetooth/log.h>
 
 #include "gatt_int.h"
@@ -376,6 +378,9 @@ tGATT_STATUS attp_send_msg_to_l2cap(tGATT_TCB& tcb, uint16_t lcid,
                                     BT_HDR* p_toL2CAP) {
   uint16_t l2cap_ret;
 
+  /* L2CAP owns the buffer once it is sent */
+  uint16_t len = p_toL2CAP->len;
+
   if (lcid == L2CAP_ATT_CID) {
     log::debug("Sending ATT message on att fixed channel");
     l2cap_ret = L2CA_SendFixedChnlData(lcid, tcb.peer_bda, p_toL2CAP);
@@ -387,7 +392,11 @@ tGATT_STATUS attp_send_msg_to_l2cap(tGATT_TCB& tcb, uint16_t lcid,
   if (l2cap_ret == L2CAP_DW_FAILED) {
     log::error("failed to write data to L2CAP");
     return GATT_INTERNAL_ERROR;
-  } else if (l2cap_ret == L2CAP_DW_CONGESTED) {
+  }
+
+  gatt_tcb_count_bearer_traffic(tcb, lcid, len, true /* is_tx */);
+
+  if (l2cap_ret == L2CAP_DW_CONGESTED) {
     log::verbose("ATT congested, message accepted");
     return GATT_CONGESTED;
   }
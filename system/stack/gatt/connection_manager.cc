@@ -26,6 +26,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "internal_include/bt_trace.h"
 #include "main/shim/le_scanning_manager.h"
@@ -388,6 +389,18 @@ bool background_connect_remove(uint8_t app_id, const RawAddress& address) {
   return true;
 }
 
+tPENDING_CONNECTIONS get_pending_connections() {
+  tPENDING_CONNECTIONS pending{};
+  for (const auto& entry : bgconn_dev) {
+    pending.direct += entry.second.doing_direct_conn.size();
+    pending.background += entry.second.doing_bg_conn.size();
+    pending.targeted_announcement +=
+        entry.second.doing_targeted_announcements_conn.size();
+    if (entry.second.is_in_accept_list) pending.in_accept_list++;
+  }
+  return pending;
+}
+
 bool is_background_connection(const RawAddress& address) {
   return bgconn_dev.find(address) != bgconn_dev.end();
 }
@@ -397,6 +410,9 @@ void on_app_deregistered(uint8_t app_id) {
   log::debug("app_id={}", static_cast<int>(app_id));
   auto it = bgconn_dev.begin();
   auto end = bgconn_dev.end();
+  /* devices no other app is connecting to, removed from the acceptlist at
+   * once so that the controller list is only updated one time */
+  std::vector<RawAddress> removed;
   /* update the BG conn device list */
   while (it != end) {
     it->second.doing_bg_conn.erase(app_id);
@@ -408,9 +424,13 @@ void on_app_deregistered(uint8_t app_id) {
       continue;
     }
 
-    BTM_AcceptlistRemove(it->first);
+    removed.push_back(it->first);
     it = bgconn_dev.erase(it);
   }
+
+  if (!removed.empty()) {
+    BTM_AcceptlistRemove(removed);
+  }
 }
 
 static void remove_all_clients_with_pending_connections(
@@ -560,6 +580,12 @@ void dump(int fd) {
     return;
   }
 
+  auto pending = get_pending_connections();
+  dprintf(fd,
+          "\tpending connections: direct %zu, background %zu, targeted "
+          "announcement %zu, in the allow list %zu\n",
+          pending.direct, pending.background, pending.targeted_announcement,
+          pending.in_accept_list);
   dprintf(fd, "\tdevices attempting connection: %d", (int)bgconn_dev.size());
   for (const auto& entry : bgconn_dev) {
     // TODO: confirm whether we need to replace this
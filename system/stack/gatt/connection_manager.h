@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <set>
 
 #include "types/raw_address.h"
@@ -63,4 +64,15 @@ void on_connection_timed_out_from_shim(const RawAddress& address);
 
 bool is_background_connection(const RawAddress& address);
 
+/* Number of app registrations for each kind of pending connection, summed
+ * over all the devices, and number of devices in the acceptlist */
+struct tPENDING_CONNECTIONS {
+  size_t direct;
+  size_t background;
+  size_t targeted_announcement;
+  size_t in_accept_list;
+};
+
+tPENDING_CONNECTIONS get_pending_connections();
+
 }  // namespace connection_manager
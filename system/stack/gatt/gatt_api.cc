@@ -22,6 +22,7 @@
  *
  ******************************************************************************/
 #define LOG_TAG "gatt_api"
+#define OSI_ALLOC_TAG "gatt"
 
 #include "stack/include/gatt_api.h"
 
@@ -142,7 +143,7 @@ static void gatt_update_last_srv_info() {
 
 /** Update database hash and client status */
 static void gatt_update_for_database_change() {
-  gatt_cb.database_hash = gatts_calculate_database_hash(gatt_cb.srv_list_info);
+  gatts_mark_database_hash_stale();
 
   uint8_t i = 0;
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
@@ -535,7 +536,8 @@ static tGATT_STATUS GATTS_HandleMultipleValueNotification(
  *                  val_len: Length of the indicated attribute value.
  *                  p_val: Pointer to the indicated attribute value data.
  *
- * Returns          GATT_SUCCESS if successfully sent; otherwise error code.
+ * Returns          GATT_SUCCESS if successfully sent, or held until the
+ *                  link is not congested; otherwise error code.
  *
  ******************************************************************************/
 tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
@@ -600,6 +602,13 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   }
 #endif
 
+  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
+  if (gatt_sr_should_queue_notif(*p_tcb, cid)) {
+    gatt_sr_queue_notif(*p_tcb, p_reg->eatt_support, attr_handle, val_len,
+                        p_val);
+    return GATT_SUCCESS;
+  }
+
   memset(&notif, 0, sizeof(notif));
   notif.handle = attr_handle;
   notif.len = val_len;
@@ -610,7 +619,6 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   tGATT_SR_MSG gatt_sr_msg;
   gatt_sr_msg.attr_value = notif;
 
-  uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
   uint16_t payload_size = gatt_tcb_get_payload_size(*p_tcb, cid);
   BT_HDR* p_buf = attp_build_sr_msg(*p_tcb, GATT_HANDLE_VALUE_NOTIF,
                                     &gatt_sr_msg, payload_size);
@@ -623,6 +631,153 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   return cmd_sent;
 }
 
+/* Allocates a server PDU of at most |payload_size| bytes, starting with
+ * |op_code| */
+static BT_HDR* gatt_sr_alloc_notif(uint16_t payload_size, uint8_t op_code) {
+  BT_HDR* p_buf =
+      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  UINT8_TO_STREAM(p, op_code);
+  p_buf->offset = L2CAP_MIN_OFFSET;
+  p_buf->len = 1;
+  return p_buf;
+}
+
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleValueNotifications
+ *
+ * Description      This function sends handle value notifications of several
+ *                  attributes to a client. When the client supports them,
+ *                  the values fitting in one PDU are sent together in
+ *                  Multiple Handle Value Notifications.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  values: Handles and values of the notified attributes.
+ *
+ * Returns          GATT_SUCCESS if successfully sent, GATT_CONGESTED if sent
+ *                  but the channel is congested; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_HandleValueNotifications(
+    uint16_t conn_id, const std::vector<tGATT_NOTIF_VALUE>& values) {
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+
+  log::verbose("conn_id=0x{:x}, count={}", conn_id, values.size());
+
+  if ((p_reg == NULL) || (p_tcb == NULL)) {
+    log::error("Unknown  conn_id: {}", conn_id);
+    return (tGATT_STATUS)GATT_INVALID_CONN_ID;
+  }
+
+  for (const tGATT_NOTIF_VALUE& value : values) {
+    if (!GATT_HANDLE_IS_VALID(value.handle)) {
+      return GATT_ILLEGAL_PARAMETER;
+    }
+  }
+
+  bool multi_notif_supported =
+      values.size() > 1 &&
+      gatt_sr_is_cl_multi_variable_len_notif_supported(*p_tcb);
+  tGATT_STATUS status = GATT_SUCCESS;
+
+  size_t i = 0;
+  while (i < values.size()) {
+    /* the bearer is picked for each PDU, so that the notifications are spread
+     * over the EATT channels available */
+    uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
+    uint16_t payload_size = gatt_tcb_get_payload_size(*p_tcb, cid);
+    if (payload_size <= GATT_HDR_SIZE) {
+      log::error("payload size too small: {}", payload_size);
+      return GATT_NO_RESOURCES;
+    }
+
+    /* each value takes its handle, its length and the value itself */
+    size_t count = 0;
+    size_t pdu_len = 1;
+    while (multi_notif_supported && i + count < values.size() &&
+           pdu_len + 4 + values[i + count].len <= payload_size) {
+      pdu_len += 4 + values[i + count].len;
+      count++;
+    }
+
+    BT_HDR* p_buf;
+    if (count > 1) {
+      p_buf = gatt_sr_alloc_notif(payload_size, GATT_HANDLE_MULTI_VALUE_NOTIF);
+      uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len;
+      for (size_t j = i; j < i + count; j++) {
+        UINT16_TO_STREAM(p, values[j].handle);
+        UINT16_TO_STREAM(p, values[j].len);
+        ARRAY_TO_STREAM(p, values[j].p_value, values[j].len);
+      }
+      p_buf->len = static_cast<uint16_t>(pdu_len);
+      i += count;
+    } else {
+      const tGATT_NOTIF_VALUE& value = values[i];
+      uint16_t len = value.len;
+      if (len > payload_size - GATT_HDR_SIZE) {
+        len = payload_size - GATT_HDR_SIZE;
+        log::warn("attribute value too long, to be truncated to {}", len);
+      }
+      p_buf = gatt_sr_alloc_notif(payload_size, GATT_HANDLE_VALUE_NOTIF);
+      uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset + p_buf->len;
+      UINT16_TO_STREAM(p, value.handle);
+      ARRAY_TO_STREAM(p, value.p_value, len);
+      p_buf->len += 2 + len;
+      i++;
+    }
+
+    tGATT_STATUS sent = attp_send_sr_msg(*p_tcb, cid, p_buf);
+    if (sent == GATT_CONGESTED) {
+      status = GATT_CONGESTED;
+    } else if (sent != GATT_SUCCESS) {
+      return sent;
+    }
+  }
+  return status;
+}
+
+/*******************************************************************************
+ *
+ * Function         GATTS_SetAttributeValueCache
+ *
+ * Description      This function caches the value of a characteristic value or
+ *                  descriptor attribute of the application. Until the cache
+ *                  is cleared, read requests of the attribute are answered
+ *                  with this value without being sent to the application.
+ *
+ * Parameter        gatt_if: application interface owning the attribute.
+ *                  attr_handle: Attribute handle.
+ *                  value: the value to cache, or std::nullopt to clear the
+ *                         cache.
+ *
+ * Returns          GATT_SUCCESS if successfully set; otherwise error code.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATTS_SetAttributeValueCache(
+    tGATT_IF gatt_if, uint16_t attr_handle,
+    std::optional<std::vector<uint8_t>> value) {
+  log::verbose("gatt_if={}, attr_handle=0x{:x}, cached={}", gatt_if,
+               attr_handle, value.has_value());
+
+  auto it = gatt_sr_find_i_rcb_by_handle(attr_handle);
+  if (it == gatt_cb.srv_list_info->end()) {
+    log::error("no service for attr_handle=0x{:x}", attr_handle);
+    return GATT_INVALID_HANDLE;
+  }
+
+  if (it->gatt_if != gatt_if) {
+    log::error("attr_handle=0x{:x} not owned by gatt_if={}", attr_handle,
+               gatt_if);
+    return GATT_ILLEGAL_PARAMETER;
+  }
+
+  return gatts_db_set_cached_value(it->p_db, attr_handle, std::move(value));
+}
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -1606,6 +1761,40 @@ tGATT_STATUS GATT_Disconnect(uint16_t conn_id) {
   return GATT_SUCCESS;
 }
 
+/*******************************************************************************
+ *
+ * Function         GATT_SetThroughputProfile
+ *
+ * Description      This function declares the throughput profile of the
+ *                  registered application on the connection.
+ *
+ * Parameters       conn_id: connection identifier.
+ *                  profile: throughput profile of the application.
+ *
+ * Returns          GATT_SUCCESS if the profile was recorded.
+ *
+ ******************************************************************************/
+tGATT_STATUS GATT_SetThroughputProfile(uint16_t conn_id,
+                                       tGATT_THROUGHPUT_PROFILE profile) {
+  tGATT_IF gatt_if = GATT_GET_GATT_IF(conn_id);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(GATT_GET_TCB_IDX(conn_id));
+  tGATT_REG* p_reg = gatt_get_regcb(gatt_if);
+
+  if (p_tcb == nullptr || p_reg == nullptr) {
+    log::warn("Unknown connection conn_id:{}", conn_id);
+    return GATT_ILLEGAL_PARAMETER;
+  }
+
+  /* Data length and PHY only exist on LE links */
+  if (p_tcb->transport != BT_TRANSPORT_LE) {
+    return GATT_REQ_NOT_SUPPORTED;
+  }
+
+  log::info("conn_id:{} profile:{}", conn_id, static_cast<uint8_t>(profile));
+  gatt_set_bulk_transfer(*p_tcb, gatt_if, profile == GATT_THROUGHPUT_BULK);
+  return GATT_SUCCESS;
+}
+
 /*******************************************************************************
  *
  * Function         GATT_GetConnectionInfor
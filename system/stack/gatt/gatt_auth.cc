@@ -22,6 +22,8 @@
  *
  ******************************************************************************/
 
+#define OSI_ALLOC_TAG "gatt"
+
 #include <bluetooth/log.h>
 #include <string.h>
 
@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include "stack/gatt/gatt_bearer_pool.h"
+
+size_t gatt_select_bearer(const std::vector<tGATT_BEARER_LOAD>& bearers) {
+  size_t best = 0;
+  for (size_t i = 1; i < bearers.size(); i++) {
+    const tGATT_BEARER_LOAD& bearer = bearers[i];
+    if (bearer.queue_depth < bearers[best].queue_depth ||
+        (bearer.queue_depth == bearers[best].queue_depth &&
+         bearer.mtu > bearers[best].mtu)) {
+      best = i;
+    }
+  }
+  return best;
+}
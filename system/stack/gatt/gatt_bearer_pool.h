@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Load of a GATT bearer, the ATT fixed channel or an EATT channel */
+typedef struct {
+  uint16_t cid;
+  size_t queue_depth; /* client requests outstanding or queued */
+  uint16_t mtu;
+} tGATT_BEARER_LOAD;
+
+/* Picks the bearer a new client request is sent on: the one with the fewest
+ * outstanding requests, and among those the one with the largest MTU so that
+ * long reads and writes take fewer round trips. Equal bearers keep their
+ * order.
+ *
+ * Returns the index of the bearer in |bearers|, which must not be empty.
+ */
+size_t gatt_select_bearer(const std::vector<tGATT_BEARER_LOAD>& bearers);
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bluetooth"
+#define OSI_ALLOC_TAG "gatt"
 
 #include <bluetooth/log.h>
 #include <string.h>
@@ -25,6 +25,8 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "gatt_int.h"
 #include "l2c_api.h"
 #include "osi/include/osi.h"
@@ -180,6 +182,17 @@ static tGATT_STATUS read_attr_value(tGATT_ATTR& attr16, uint16_t offset,
                                                      sec_flag, key_size);
   if (status != GATT_SUCCESS) return status;
 
+  if (attr16.cached_value.has_value()) {
+    /* value cached by the application */
+    const std::vector<uint8_t>& value = attr16.cached_value.value();
+    if (offset > value.size()) return GATT_INVALID_OFFSET;
+
+    *p_len = std::min<size_t>(value.size() - offset, mtu);
+    ARRAY_TO_STREAM(p, value.data() + offset, *p_len);
+    *p_data = p;
+    return GATT_SUCCESS;
+  }
+
   if (!attr16.uuid.Is16Bit()) {
     /* characteristic description or characteristic value */
     return GATT_PENDING;
@@ -282,40 +295,48 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
   uint16_t len = 0;
   uint8_t* p = (uint8_t*)(p_rsp + 1) + p_rsp->len + L2CAP_MIN_OFFSET;
 
+  const std::vector<uint16_t>* indices = nullptr;
   if (p_db) {
-    for (tGATT_ATTR& attr : p_db->attr_list) {
-      if (attr.handle >= s_handle && type == attr.uuid) {
-        if (*p_len <= 2) {
-          status = GATT_NO_RESOURCES;
-          break;
-        }
+    auto type_it = p_db->attr_index_by_type.find(type);
+    if (type_it != p_db->attr_index_by_type.end()) indices = &type_it->second;
+  }
 
-        UINT16_TO_STREAM(p, attr.handle);
+  if (indices) {
+    auto index_it =
+        std::lower_bound(indices->begin(), indices->end(),
+                         gatts_db_attr_index_lower_bound(*p_db, s_handle));
+    for (; index_it != indices->end(); index_it++) {
+      tGATT_ATTR& attr = p_db->attr_list[*index_it];
+      if (*p_len <= 2) {
+        status = GATT_NO_RESOURCES;
+        break;
+      }
 
-        status = read_attr_value(attr, 0, &p, false, (uint16_t)(*p_len - 2),
-                                 &len, sec_flag, key_size);
+      UINT16_TO_STREAM(p, attr.handle);
 
-        if (status == GATT_PENDING) {
-          status = gatts_send_app_read_request(tcb, cid, op_code, attr.handle,
-                                               0, trans_id, attr.gatt_type);
+      status = read_attr_value(attr, 0, &p, false, (uint16_t)(*p_len - 2),
+                               &len, sec_flag, key_size);
 
-          /* one callback at a time */
-          break;
-        } else if (status == GATT_SUCCESS) {
-          if (p_rsp->offset == 0) p_rsp->offset = len + 2;
-
-          if (p_rsp->offset == len + 2) {
-            p_rsp->len += (len + 2);
-            *p_len -= (len + 2);
-          } else {
-            log::error("format mismatch");
-            status = GATT_NO_RESOURCES;
-            break;
-          }
+      if (status == GATT_PENDING) {
+        status = gatts_send_app_read_request(tcb, cid, op_code, attr.handle,
+                                             0, trans_id, attr.gatt_type);
+
+        /* one callback at a time */
+        break;
+      } else if (status == GATT_SUCCESS) {
+        if (p_rsp->offset == 0) p_rsp->offset = len + 2;
+
+        if (p_rsp->offset == len + 2) {
+          p_rsp->len += (len + 2);
+          *p_len -= (len + 2);
         } else {
-          *p_cur_handle = attr.handle;
+          log::error("format mismatch");
+          status = GATT_NO_RESOURCES;
           break;
         }
+      } else {
+        *p_cur_handle = attr.handle;
+        break;
       }
     }
   }
@@ -441,15 +462,59 @@ uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
 /******************************************************************************/
 /* Service Attribute Database Query Utility Functions */
 /******************************************************************************/
+/* Returns the index of the first attribute of |db| whose handle is not less
+ * than |handle|, or the number of attributes if there is none. */
+size_t gatts_db_attr_index_lower_bound(const tGATT_SVC_DB& db,
+                                       uint16_t handle) {
+  if (db.attr_list.empty() || handle <= db.attr_list.front().handle) return 0;
+
+  size_t index = handle - db.attr_list.front().handle;
+  return std::min(index, db.attr_list.size());
+}
+
 tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
   if (!p_db) return nullptr;
 
-  for (auto& attr : p_db->attr_list) {
-    if (attr.handle == handle) return &attr;
-    if (attr.handle > handle) return nullptr;
+  size_t index = gatts_db_attr_index_lower_bound(*p_db, handle);
+  if (index == p_db->attr_list.size()) return nullptr;
+
+  tGATT_ATTR& attr = p_db->attr_list[index];
+  return attr.handle == handle ? &attr : nullptr;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatts_db_set_cached_value
+ *
+ * Description      Set or clear the application cached value of a
+ *                  characteristic value or descriptor attribute.
+ *
+ * Parameter        p_db: pointer to the attribute database.
+ *                  handle: Attribute handle.
+ *                  value: the value to cache, or std::nullopt to clear it.
+ *
+ * Returns          Status of operation.
+ *
+ ******************************************************************************/
+tGATT_STATUS gatts_db_set_cached_value(
+    tGATT_SVC_DB* p_db, uint16_t handle,
+    std::optional<std::vector<uint8_t>> value) {
+  tGATT_ATTR* p_attr = find_attr_by_handle(p_db, handle);
+  if (!p_attr) return GATT_NOT_FOUND;
+
+  /* the declarations and the extended properties are served by the stack */
+  if ((p_attr->gatt_type != BTGATT_DB_CHARACTERISTIC &&
+       p_attr->gatt_type != BTGATT_DB_DESCRIPTOR) ||
+      p_attr->uuid == Uuid::From16Bit(GATT_UUID_CHAR_EXT_PROP)) {
+    return GATT_ILLEGAL_PARAMETER;
+  }
+
+  if (value.has_value() && value->size() > GATT_MAX_ATTR_LEN) {
+    return GATT_INVALID_ATTR_LEN;
   }
 
-  return nullptr;
+  p_attr->cached_value = std::move(value);
+  return GATT_SUCCESS;
 }
 
 /*******************************************************************************
@@ -681,6 +746,7 @@ static tGATT_ATTR& allocate_attr_in_db(tGATT_SVC_DB& db, const Uuid& uuid,
                db.end_handle, db.next_handle);
   }
 
+  db.attr_index_by_type[uuid].push_back(db.attr_list.size());
   db.attr_list.emplace_back();
   tGATT_ATTR& attr = db.attr_list.back();
   attr.handle = db.next_handle++;
@@ -23,8 +23,12 @@
 #include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 
+#include <chrono>
 #include <deque>
 #include <list>
+#include <map>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -82,6 +86,10 @@ inline std::string gatt_security_action_text(const tGATT_SEC_ACTION& action) {
 #define GATT_WAIT_FOR_DISC_RSP_TIMEOUT_MS (5 * 1000)
 #define GATT_REQ_RETRY_LIMIT 2
 
+/* Notifications held by the server for a congested link, the oldest one is
+ * dropped past it */
+#define GATT_NOTIF_QUEUE_MAX 32
+
 typedef struct {
   bool is_link_key_known;
   bool is_link_key_authed;
@@ -174,12 +182,19 @@ typedef struct {
   uint16_t handle;
   bluetooth::Uuid uuid;
   bt_gatt_db_attribute_type_t gatt_type;
+  /* value set by the application, read requests are answered with it
+   * instead of being forwarded to the application */
+  std::optional<std::vector<uint8_t>> cached_value;
 } tGATT_ATTR;
 
 /* Service Database definition
+ * Attributes are allocated with consecutive handles, so attr_list[i] holds
+ * handle attr_list[0].handle + i.
 */
 typedef struct {
   std::vector<tGATT_ATTR> attr_list; /* pointer to the attributes */
+  /* attr_list indices of each attribute type, in handle order */
+  std::unordered_map<bluetooth::Uuid, std::vector<uint16_t>> attr_index_by_type;
   uint16_t end_handle;       /* Last handle number           */
   uint16_t next_handle;      /* Next usable handle value     */
 } tGATT_SVC_DB;
@@ -288,8 +303,38 @@ typedef struct {
   uint16_t e_hdl;      /* service ending handle */
   tGATT_IF gatt_if;    /* this service is belong to which application */
   bool is_primary;
+  /* This service's part of the database hash input, byte reversed. Filled on
+   * first use; services do not change once registered. */
+  std::vector<uint8_t> hash_info;
 } tGATT_SRV_LIST_ELEM;
 
+/* Prepared write held by the server until the execute write, the fragments
+ * written to consecutive offsets of an attribute are reassembled in it */
+typedef struct {
+  tGATT_IF gatt_if;
+  uint16_t handle;
+  uint16_t offset; /* offset of the first fragment */
+  bt_gatt_db_attribute_type_t gatt_type;
+  std::vector<uint8_t> value;
+} tGATT_PREP_WRITE;
+
+/* Notification held by the server while its bearer is congested. A newer
+ * value of the same attribute replaces it in the queue. */
+typedef struct {
+  uint16_t handle;
+  bool eatt_support; /* of the application sending it */
+  std::vector<uint8_t> value;
+} tGATT_QUEUED_NOTIF;
+
+/* Traffic of a GATT bearer since its first PDU, reported in dumpsys */
+typedef struct {
+  uint64_t tx_bytes;
+  uint64_t rx_bytes;
+  uint32_t tx_pdus;
+  uint32_t rx_pdus;
+  std::chrono::steady_clock::time_point first_pdu;
+} tGATT_BEARER_STATS;
+
 typedef struct {
   std::deque<tGATT_CLCB*> pending_enc_clcb; /* pending encryption channel q */
   tGATT_SEC_ACTION sec_act;
@@ -318,6 +363,10 @@ typedef struct {
   uint8_t prep_cnt[GATT_MAX_APPS];
   uint8_t ind_count;
 
+  /* prepared writes reassembled by the stack, and their total length */
+  std::vector<tGATT_PREP_WRITE> prep_writes;
+  size_t prep_writes_len;
+
   std::deque<tGATT_CMD_Q> cl_cmd_q;
   alarm_t* ind_ack_timer; /* local app confirm to indication timer */
 
@@ -343,6 +392,19 @@ typedef struct {
   /* Used to set proper TX DATA LEN on the controller*/
   uint16_t max_user_mtu;
 
+  /* Applications that declared bulk transfers on the link, the data length
+   * and PHY of the link are maximized while not empty */
+  std::unordered_set<tGATT_IF> bulk_transfer_apps;
+
+  /* Traffic of the ATT channel and of the EATT channels, by cid */
+  std::map<uint16_t, tGATT_BEARER_STATS> bearer_stats;
+
+  /* Bearers reported congested by L2CAP, and the notifications held until
+   * they are not anymore */
+  std::unordered_set<uint16_t> congested_cids;
+  std::list<tGATT_QUEUED_NOTIF> notif_q;
+  uint32_t notif_q_dropped;
+
 } tGATT_TCB;
 
 /* logic channel */
@@ -402,6 +464,23 @@ typedef struct {
   uint16_t e_handle;
 } tGATT_PROFILE_CLCB;
 
+/* Database hash computation statistics, for dumpsys */
+typedef struct {
+  uint32_t count;    /* number of computations */
+  uint64_t last_us;  /* duration of the last computation */
+  uint64_t max_us;   /* longest computation */
+  uint64_t total_us; /* time spent in all computations */
+} tGATT_DB_HASH_STATS;
+
+/* Prepared write reassembly statistics, for dumpsys */
+typedef struct {
+  uint32_t fragments;  /* prepare write requests reassembled */
+  uint32_t writes;     /* reassembled writes delivered to the applications */
+  uint32_t cancelled;  /* queues cancelled by the clients */
+  uint32_t queue_full; /* prepare write requests over the size limit */
+  size_t max_len;      /* longest queue, in bytes */
+} tGATT_PREP_WRITE_STATS;
+
 typedef struct {
   tGATT_TCB tcb[GATT_MAX_PHY_CHANNEL];
   fixed_queue_t* sign_op_queue;
@@ -446,7 +525,11 @@ typedef struct {
   uint8_t gatt_cl_supported_feat_mask;
 
   uint16_t handle_of_database_hash;
+  /* Use gatts_get_database_hash(), it is computed lazily */
   Octet16 database_hash;
+  bool database_hash_stale; /* services changed since database_hash */
+  tGATT_DB_HASH_STATS database_hash_stats;
+  tGATT_PREP_WRITE_STATS prep_write_stats;
 
   tGATT_APPL_INFO cb_info;
 
@@ -577,6 +660,10 @@ void gatt_sr_send_req_callback(uint16_t conn_id, uint32_t trans_id,
                                uint8_t op_code, tGATTS_DATA* p_req_data);
 uint32_t gatt_sr_enqueue_cmd(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
                              uint16_t handle);
+bool gatt_sr_should_queue_notif(tGATT_TCB& tcb, uint16_t cid);
+void gatt_sr_queue_notif(tGATT_TCB& tcb, bool eatt_support, uint16_t handle,
+                         uint16_t len, const uint8_t* p_value);
+void gatt_sr_send_queued_notifs(tGATT_TCB& tcb);
 bool gatt_cancel_open(tGATT_IF gatt_if, const RawAddress& bda);
 void gatt_notify_phy_updated(tHCI_STATUS status, uint16_t handle,
                              uint8_t tx_phy, uint8_t rx_phy);
@@ -598,12 +685,15 @@ bool gatt_tcb_get_cid_available_for_indication(tGATT_TCB* p_tcb,
 bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
                                    uint16_t* indicated_handle_p);
 uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support);
+void gatt_tcb_count_bearer_traffic(tGATT_TCB& tcb, uint16_t cid, uint16_t len,
+                                   bool is_tx);
 uint16_t gatt_tcb_get_payload_size(tGATT_TCB& tcb, uint16_t cid);
 void gatt_clcb_invalidate(tGATT_TCB* p_tcb, const tGATT_CLCB* p_clcb);
 uint16_t gatt_get_mtu(const RawAddress& bda, tBT_TRANSPORT transport);
 bool gatt_is_pending_mtu_exchange(tGATT_TCB* p_tcb);
 void gatt_set_conn_id_waiting_for_mtu_exchange(tGATT_TCB* p_tcb,
                                                uint16_t conn_id);
+void gatt_set_bulk_transfer(tGATT_TCB& tcb, tGATT_IF gatt_if, bool bulk);
 
 void gatt_sr_copy_prep_cnt_to_cback_cnt(tGATT_TCB& p_tcb);
 bool gatt_sr_is_cback_cnt_zero(tGATT_TCB& p_tcb);
@@ -687,9 +777,17 @@ tGATT_STATUS gatts_read_attr_perm_check(tGATT_SVC_DB* p_db, bool is_long,
                                         tGATT_SEC_FLAG sec_flag,
                                         uint8_t key_size);
 bluetooth::Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db);
+tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle);
+tGATT_STATUS gatts_db_set_cached_value(
+    tGATT_SVC_DB* p_db, uint16_t handle,
+    std::optional<std::vector<uint8_t>> value);
+size_t gatts_db_attr_index_lower_bound(const tGATT_SVC_DB& db,
+                                       uint16_t handle);
 
 /* gatt_sr_hash.cc */
 Octet16 gatts_calculate_database_hash(std::list<tGATT_SRV_LIST_ELEM>* lst_ptr);
+void gatts_mark_database_hash_stale();
+const Octet16& gatts_get_database_hash();
 
 namespace fmt {
 template <>
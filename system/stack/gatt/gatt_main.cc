@@ -374,6 +374,11 @@ void gatt_update_app_use_link_flag(tGATT_IF gatt_if, tGATT_TCB* p_tcb,
     return;
   }
 
+  /* An application leaving the link ends its bulk transfers */
+  if (!is_add) {
+    gatt_set_bulk_transfer(*p_tcb, gatt_if, false);
+  }
+
   if (!check_acl_link) {
     log::info("check_acl_link is false, no need to check");
     return;
@@ -626,14 +631,22 @@ static void read_dis_cback(const RawAddress& bd_addr, tDIS_VALUE* p_dis_value) {
 }
 
 /** This function is called to process the congestion callback from lcb */
-static void gatt_channel_congestion(tGATT_TCB* p_tcb, bool congested) {
+static void gatt_channel_congestion(tGATT_TCB* p_tcb, uint16_t cid,
+                                    bool congested) {
   uint8_t i = 0;
   tGATT_REG* p_reg = NULL;
   uint16_t conn_id;
 
+  if (congested) {
+    p_tcb->congested_cids.insert(cid);
+  } else {
+    p_tcb->congested_cids.erase(cid);
+  }
+
   /* if uncongested, check to see if there is any more pending data */
   if (p_tcb != NULL && !congested) {
     gatt_cl_send_next_cmd_inq(*p_tcb);
+    gatt_sr_send_queued_notifs(*p_tcb);
   }
   /* notifying all applications for the connection up event */
   for (i = 0, p_reg = gatt_cb.cl_rcb; i < GATT_MAX_APPS; i++, p_reg++) {
@@ -720,7 +733,7 @@ static void gatt_le_cong_cback(const RawAddress& remote_bda, bool congested) {
   if (!p_tcb) return;
 
   /* if uncongested, check to see if there is any more pending data */
-    gatt_channel_congestion(p_tcb, congested);
+    gatt_channel_congestion(p_tcb, L2CAP_ATT_CID, congested);
 }
 
 /*******************************************************************************
@@ -924,7 +937,7 @@ static void gatt_l2cif_congest_cback(uint16_t lcid, bool congested) {
   tGATT_TCB* p_tcb = gatt_find_tcb_by_cid(lcid);
 
   if (p_tcb != NULL) {
-    gatt_channel_congestion(p_tcb, congested);
+    gatt_channel_congestion(p_tcb, lcid, congested);
   }
 }
 
@@ -1024,6 +1037,8 @@ void gatt_data_process(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_buf) {
     return;
   }
 
+  gatt_tcb_count_bearer_traffic(tcb, cid, p_buf->len, false /* is_tx */);
+
   uint16_t msg_len = p_buf->len - 1;
   STREAM_TO_UINT8(op_code, p);
 
@@ -22,6 +22,8 @@
  *
  ******************************************************************************/
 
+#define OSI_ALLOC_TAG "gatt"
+
 #include <bluetooth/log.h>
 #include <string.h>
 
@@ -32,6 +34,7 @@
 #include "internal_include/bt_target.h"
 #include "l2c_api.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "stack/arbiter/acl_arbiter.h"
 #include "stack/eatt/eatt.h"
 #include "stack/include/bt_hdr.h"
@@ -156,6 +159,93 @@ void gatt_dequeue_sr_cmd(tGATT_TCB& tcb, uint16_t cid) {
   memset(p_cmd, 0, sizeof(tGATT_SR_CMD));
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_sr_should_queue_notif
+ *
+ * Description      Check whether a notification to send on |cid| must be held
+ *                  in the notification queue of the link: while the bearer is
+ *                  congested, and while older notifications are held so they
+ *                  are delivered in order.
+ *
+ * Returns          true if the notification must be queued
+ *
+ ******************************************************************************/
+bool gatt_sr_should_queue_notif(tGATT_TCB& tcb, uint16_t cid) {
+  return !tcb.notif_q.empty() || tcb.congested_cids.count(cid) != 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_queue_notif
+ *
+ * Description      Hold a notification until the link is not congested. The
+ *                  value of a notification already held for |handle| is
+ *                  replaced, only the latest value of an attribute is sent.
+ *                  The oldest notification is dropped when the queue is full.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_sr_queue_notif(tGATT_TCB& tcb, bool eatt_support, uint16_t handle,
+                         uint16_t len, const uint8_t* p_value) {
+  for (auto& notif : tcb.notif_q) {
+    if (notif.handle == handle) {
+      notif.eatt_support = eatt_support;
+      notif.value.assign(p_value, p_value + len);
+      return;
+    }
+  }
+
+  if (tcb.notif_q.size() >= GATT_NOTIF_QUEUE_MAX) {
+    log::warn("{}, notification queue full, dropping handle 0x{:04x}",
+              tcb.peer_bda, tcb.notif_q.front().handle);
+    tcb.notif_q.pop_front();
+    tcb.notif_q_dropped++;
+  }
+  tcb.notif_q.push_back(
+      {.handle = handle,
+       .eatt_support = eatt_support,
+       .value = std::vector<uint8_t>(p_value, p_value + len)});
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_send_queued_notifs
+ *
+ * Description      Send the notifications held for the link, in order, until
+ *                  a bearer they are sent on gets congested again.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_sr_send_queued_notifs(tGATT_TCB& tcb) {
+  while (!tcb.notif_q.empty()) {
+    tGATT_QUEUED_NOTIF& queued = tcb.notif_q.front();
+    uint16_t cid = gatt_tcb_get_att_cid(tcb, queued.eatt_support);
+    if (tcb.congested_cids.count(cid) != 0) return;
+
+    tGATT_SR_MSG gatt_sr_msg;
+    memset(&gatt_sr_msg, 0, sizeof(gatt_sr_msg));
+    gatt_sr_msg.attr_value.handle = queued.handle;
+    gatt_sr_msg.attr_value.len = queued.value.size();
+    std::copy(queued.value.begin(), queued.value.end(),
+              gatt_sr_msg.attr_value.value);
+    gatt_sr_msg.attr_value.auth_req = GATT_AUTH_REQ_NONE;
+    tcb.notif_q.pop_front();
+
+    BT_HDR* p_buf =
+        attp_build_sr_msg(tcb, GATT_HANDLE_VALUE_NOTIF, &gatt_sr_msg,
+                          gatt_tcb_get_payload_size(tcb, cid));
+    if (p_buf == nullptr) {
+      log::error("{}, unable to build notification of handle 0x{:04x}",
+                 tcb.peer_bda, gatt_sr_msg.attr_value.handle);
+      continue;
+    }
+    if (attp_send_sr_msg(tcb, cid, p_buf) == GATT_CONGESTED) return;
+  }
+}
+
 static void build_read_multi_rsp(tGATT_SR_CMD* p_cmd, uint16_t mtu) {
   uint16_t ii;
   size_t total_len, len;
@@ -353,6 +443,125 @@ tGATT_STATUS gatt_sr_process_app_rsp(tGATT_TCB& tcb, tGATT_IF gatt_if,
   return ret_code;
 }
 
+/* Total length of the prepared writes a connection queues in the stack. When 0,
+ * the default, each prepare write request is forwarded to the application. */
+static size_t gatt_sr_get_prep_writes_max_len() {
+  static const size_t kPrepWritesMaxLen = std::max(
+      osi_property_get_int32(
+          "bluetooth.gatt.server.prepare_write_reassembly_max_len", 0),
+      0);
+  return kPrepWritesMaxLen;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_reassemble_prep_write
+ *
+ * Description      This function queues a prepare write request in the stack
+ *                  and responds to it. A fragment written right after the
+ *                  previous one, to the same attribute, is appended to it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void gatt_sr_reassemble_prep_write(
+    tGATT_TCB& tcb, uint16_t cid, tGATT_IF gatt_if, const tGATT_WRITE_REQ& req,
+    bt_gatt_db_attribute_type_t gatt_type) {
+  tGATT_PREP_WRITE_STATS& stats = gatt_cb.prep_write_stats;
+
+  if (gatt_type != BTGATT_DB_CHARACTERISTIC &&
+      gatt_type != BTGATT_DB_DESCRIPTOR) {
+    log::error(
+        "Attempt to write attribute that's not tied with characteristic or "
+        "descriptor value.");
+    gatt_send_error_rsp(tcb, cid, GATT_ERROR, GATT_REQ_PREPARE_WRITE,
+                        req.handle, false);
+    return;
+  }
+
+  if (tcb.prep_writes_len + req.len > gatt_sr_get_prep_writes_max_len()) {
+    log::warn("prepare write queue full, len={}", tcb.prep_writes_len);
+    stats.queue_full++;
+    gatt_send_error_rsp(tcb, cid, GATT_PREPARE_Q_FULL, GATT_REQ_PREPARE_WRITE,
+                        req.handle, false);
+    return;
+  }
+
+  tGATT_PREP_WRITE* p_write =
+      tcb.prep_writes.empty() ? nullptr : &tcb.prep_writes.back();
+  if (p_write == nullptr || p_write->gatt_if != gatt_if ||
+      p_write->handle != req.handle ||
+      p_write->offset + p_write->value.size() != req.offset ||
+      p_write->value.size() + req.len > GATT_MAX_ATTR_LEN) {
+    tcb.prep_writes.push_back({.gatt_if = gatt_if,
+                               .handle = req.handle,
+                               .offset = req.offset,
+                               .gatt_type = gatt_type});
+    p_write = &tcb.prep_writes.back();
+    p_write->value.reserve(GATT_MAX_ATTR_LEN);
+  }
+  p_write->value.insert(p_write->value.end(), req.value, req.value + req.len);
+  tcb.prep_writes_len += req.len;
+
+  stats.fragments++;
+  stats.max_len = std::max(stats.max_len, tcb.prep_writes_len);
+
+  /* the response echoes the request */
+  tGATT_SR_MSG msg;
+  msg.attr_value.handle = req.handle;
+  msg.attr_value.offset = req.offset;
+  msg.attr_value.len = req.len;
+  memcpy(msg.attr_value.value, req.value, req.len);
+  attp_send_sr_msg(tcb, cid,
+                   attp_build_sr_msg(tcb, GATT_RSP_PREPARE_WRITE, &msg,
+                                     gatt_tcb_get_payload_size(tcb, cid)));
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_flush_prep_writes
+ *
+ * Description      This function delivers the prepared writes reassembled by
+ *                  the stack to the applications, as one prepare write
+ *                  request each, or drops them if the client cancelled the
+ *                  writes. The applications are then sent the execute write
+ *                  request as usual.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void gatt_sr_flush_prep_writes(tGATT_TCB& tcb, uint8_t flag) {
+  tGATT_PREP_WRITE_STATS& stats = gatt_cb.prep_write_stats;
+
+  if (flag == GATT_PREP_WRITE_EXEC) {
+    for (const tGATT_PREP_WRITE& write : tcb.prep_writes) {
+      tGATTS_DATA sr_data;
+      memset(&sr_data, 0, sizeof(tGATTS_DATA));
+      sr_data.write_req.handle = write.handle;
+      sr_data.write_req.offset = write.offset;
+      sr_data.write_req.len = write.value.size();
+      memcpy(sr_data.write_req.value, write.value.data(), write.value.size());
+      /* the stack already responded to the prepare write requests */
+      sr_data.write_req.need_rsp = false;
+      sr_data.write_req.is_prep = true;
+
+      uint16_t conn_id = GATT_CREATE_CONN_ID(tcb.tcb_idx, write.gatt_if);
+      gatt_sr_send_req_callback(conn_id, 0,
+                                write.gatt_type == BTGATT_DB_DESCRIPTOR
+                                    ? GATTS_REQ_TYPE_WRITE_DESCRIPTOR
+                                    : GATTS_REQ_TYPE_WRITE_CHARACTERISTIC,
+                                &sr_data);
+      gatt_sr_update_prep_cnt(tcb, write.gatt_if, true, false);
+      stats.writes++;
+    }
+  } else {
+    stats.cancelled++;
+  }
+
+  tcb.prep_writes.clear();
+  tcb.prep_writes_len = 0;
+}
+
 /*******************************************************************************
  *
  * Function         gatt_process_exec_write_req
@@ -395,6 +604,18 @@ void gatt_process_exec_write_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
   /* mask the flag */
   flag &= GATT_PREP_WRITE_EXEC;
 
+  if (!tcb.prep_writes.empty()) {
+    gatt_sr_flush_prep_writes(tcb, flag);
+
+    /* the applications never saw the cancelled writes */
+    if (gatt_sr_is_prep_cnt_zero(tcb)) {
+      attp_send_sr_msg(tcb, cid,
+                       attp_build_sr_msg(tcb, GATT_RSP_EXEC_WRITE, NULL,
+                                         gatt_tcb_get_payload_size(tcb, cid)));
+      return;
+    }
+  }
+
   /* no prep write is queued */
   if (!gatt_sr_is_prep_cnt_zero(tcb)) {
     trans_id = gatt_sr_enqueue_cmd(tcb, cid, op_code, 0);
@@ -622,11 +843,11 @@ static tGATT_STATUS gatt_build_find_info_rsp(tGATT_SRV_LIST_ELEM& el,
 
   uint8_t* p = (uint8_t*)(p_msg + 1) + L2CAP_MIN_OFFSET + p_msg->len;
 
-  for (auto& attr : el.p_db->attr_list) {
+  for (size_t i = gatts_db_attr_index_lower_bound(*el.p_db, s_hdl);
+       i < el.p_db->attr_list.size(); i++) {
+    tGATT_ATTR& attr = el.p_db->attr_list[i];
     if (attr.handle > e_hdl) break;
 
-    if (attr.handle < s_hdl) continue;
-
     uint8_t uuid_len = attr.uuid.GetShortestRepresentationSize();
     if (p_msg->offset == 0)
       p_msg->offset = (uuid_len == Uuid::kNumBytes16) ? GATT_INFO_TYPE_PAIR_16
@@ -1023,6 +1244,13 @@ static void gatts_process_write_req(tGATT_TCB& tcb, uint16_t cid,
                                        sr_data.write_req.offset, p, len,
                                        sec_flag, key_size);
 
+  if (status == GATT_SUCCESS && op_code == GATT_REQ_PREPARE_WRITE &&
+      gatt_sr_get_prep_writes_max_len() > 0) {
+    gatt_sr_reassemble_prep_write(tcb, cid, el.gatt_if, sr_data.write_req,
+                                  gatt_type);
+    return;
+  }
+
   if (status == GATT_SUCCESS) {
     trans_id = gatt_sr_enqueue_cmd(tcb, cid, op_code, handle);
     if (trans_id != 0) {
@@ -1151,27 +1379,25 @@ void gatts_process_attribute_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
   if (GATT_HANDLE_IS_VALID(handle)) {
     for (auto& el : *gatt_cb.srv_list_info) {
       if (el.s_hdl <= handle && el.e_hdl >= handle) {
-        for (const auto& attr : el.p_db->attr_list) {
-          if (attr.handle == handle) {
-            switch (op_code) {
-              case GATT_REQ_READ: /* read char/char descriptor value */
-              case GATT_REQ_READ_BLOB:
-                gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
-                break;
-
-              case GATT_REQ_WRITE: /* write char/char descriptor value */
-              case GATT_CMD_WRITE:
-              case GATT_SIGN_CMD_WRITE:
-              case GATT_REQ_PREPARE_WRITE:
-                gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
-                                        attr.gatt_type);
-                break;
-              default:
-                break;
-            }
-            status = GATT_SUCCESS;
-            break;
+        const tGATT_ATTR* p_attr = find_attr_by_handle(el.p_db, handle);
+        if (p_attr) {
+          switch (op_code) {
+            case GATT_REQ_READ: /* read char/char descriptor value */
+            case GATT_REQ_READ_BLOB:
+              gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
+              break;
+
+            case GATT_REQ_WRITE: /* write char/char descriptor value */
+            case GATT_CMD_WRITE:
+            case GATT_SIGN_CMD_WRITE:
+            case GATT_REQ_PREPARE_WRITE:
+              gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
+                                      p_attr->gatt_type);
+              break;
+            default:
+              break;
           }
+          status = GATT_SUCCESS;
         }
         break;
       }
@@ -22,11 +22,13 @@
  *
  ******************************************************************************/
 #define LOG_TAG "gatt_utils"
+#define OSI_ALLOC_TAG "gatt"
 
 #include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
 #include <com_android_bluetooth_flags.h>
 
+#include <cinttypes>
 #include <cstdint>
 #include <deque>
 
@@ -39,11 +41,13 @@
 #include "stack/btm/btm_sec.h"
 #include "stack/eatt/eatt.h"
 #include "stack/gatt/connection_manager.h"
+#include "stack/gatt/gatt_bearer_pool.h"
 #include "stack/gatt/gatt_int.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_psm_types.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/bt_uuid16.h"
+#include "stack/include/btm_ble_api.h"
 #include "stack/include/l2cdefs.h"
 #include "stack/include/sdp_api.h"
 #include "types/bluetooth/uuid.h"
@@ -446,6 +450,41 @@ tGATT_TCB* gatt_find_tcb_by_addr(const RawAddress& bda,
   return p_tcb;
 }
 
+/* Prints the load and the throughput of the bearers of the link */
+static void gatt_tcb_dump_bearers(tGATT_TCB& tcb, std::stringstream& stream) {
+  auto now = std::chrono::steady_clock::now();
+  for (const auto& [cid, stats] : tcb.bearer_stats) {
+    size_t queue_depth;
+    uint16_t mtu;
+    if (cid == tcb.att_lcid) {
+      queue_depth = tcb.cl_cmd_q.size();
+      mtu = tcb.payload_size;
+    } else {
+      EattChannel* channel =
+          EattExtension::GetInstance()->FindEattChannelByCid(tcb.peer_bda, cid);
+      if (channel == nullptr) continue;
+      queue_depth = channel->cl_cmd_q_.size();
+      mtu = channel->tx_mtu_;
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          now - stats.first_pdu)
+                          .count();
+    uint64_t throughput_bps =
+        elapsed_ms > 0
+            ? (stats.tx_bytes + stats.rx_bytes) * 8 * 1000 / elapsed_ms
+            : 0;
+
+    stream << base::StringPrintf(
+        "    bearer cid: 0x%04x  %s  mtu: %u  queue: %zu  tx: %u pdus %" PRIu64
+        " bytes  rx: %u pdus %" PRIu64 " bytes  throughput: %" PRIu64
+        " bps\n",
+        cid, cid == tcb.att_lcid ? "ATT" : "EATT", mtu, queue_depth,
+        stats.tx_pdus, stats.tx_bytes, stats.rx_pdus, stats.rx_bytes,
+        throughput_bps);
+  }
+}
+
 /*******************************************************************************
  *
  * Function     gatt_tcb_dump
@@ -467,13 +506,30 @@ void gatt_tcb_dump(int fd) {
       stream << "  id: " << +p_tcb->tcb_idx
              << "  address: " << ADDRESS_TO_LOGGABLE_STR(p_tcb->peer_bda)
              << "  transport: " << bt_transport_text(p_tcb->transport)
-             << "  ch_state: " << gatt_channel_state_text(p_tcb->ch_state);
+             << "  ch_state: " << gatt_channel_state_text(p_tcb->ch_state)
+             << "  queued_notifs: " << p_tcb->notif_q.size()
+             << "  dropped_notifs: " << p_tcb->notif_q_dropped;
       stream << "\n";
+      gatt_tcb_dump_bearers(*p_tcb, stream);
     }
   }
 
   dprintf(fd, "TCB (GATT_MAX_PHY_CHANNEL: %d) in_use: %d\n%s\n",
           gatt_get_max_phy_channel(), in_use_cnt, stream.str().c_str());
+
+  const tGATT_DB_HASH_STATS& stats = gatt_cb.database_hash_stats;
+  dprintf(fd,
+          "Database hash computations: %u stale: %s last_us: %" PRIu64
+          " max_us: %" PRIu64 " total_us: %" PRIu64 "\n",
+          stats.count, gatt_cb.database_hash_stale ? "true" : "false",
+          stats.last_us, stats.max_us, stats.total_us);
+
+  const tGATT_PREP_WRITE_STATS& prep_stats = gatt_cb.prep_write_stats;
+  dprintf(fd,
+          "Prepared write reassembly fragments: %u writes: %u cancelled: %u "
+          "queue_full: %u max_len: %zu\n",
+          prep_stats.fragments, prep_stats.writes, prep_stats.cancelled,
+          prep_stats.queue_full, prep_stats.max_len);
 }
 
 /*******************************************************************************
@@ -541,6 +597,47 @@ void gatt_set_conn_id_waiting_for_mtu_exchange(tGATT_TCB* p_tcb,
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_set_bulk_transfer
+ *
+ * Description      Record whether the application gatt_if runs bulk transfers
+ *                  on the link. The link asks for the maximum data length and
+ *                  the 2M PHY when the first application declares bulk
+ *                  transfers, and goes back to the 1M PHY and to the data
+ *                  length needed by the ATT MTU once the last one is done.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_set_bulk_transfer(tGATT_TCB& tcb, tGATT_IF gatt_if, bool bulk) {
+  bool was_bulk = !tcb.bulk_transfer_apps.empty();
+  if (bulk) {
+    tcb.bulk_transfer_apps.insert(gatt_if);
+  } else {
+    tcb.bulk_transfer_apps.erase(gatt_if);
+  }
+  bool is_bulk = !tcb.bulk_transfer_apps.empty();
+  if (is_bulk == was_bulk || tcb.transport != BT_TRANSPORT_LE) return;
+
+  if (is_bulk) {
+    log::info("Bulk transfers on {}, request max data length and 2M PHY",
+              tcb.peer_bda);
+    /* Both procedures run in the controller alongside the MTU exchange */
+    BTM_BleSetPhy(tcb.peer_bda, PHY_LE_2M, PHY_LE_2M, 0);
+    BTM_SetBleDataLength(tcb.peer_bda, BTM_BLE_DATA_SIZE_MAX);
+    return;
+  }
+
+  log::info("No more bulk transfers on {}, restore low power link settings",
+            tcb.peer_bda);
+  BTM_BleSetPhy(tcb.peer_bda, PHY_LE_1M, PHY_LE_1M, 0);
+  BTM_RestoreBleDataLength(tcb.peer_bda,
+                           tcb.max_user_mtu == 0
+                               ? BTM_BLE_DATA_SIZE_MIN
+                               : tcb.max_user_mtu + L2CAP_PKT_OVERHEAD);
+}
+
 /** gatt_build_uuid_to_stream will convert 32bit UUIDs to 128bit. This function
  * will return lenght required to build uuid, either |UUID:kNumBytes16| or
  * |UUID::kNumBytes128| */
@@ -1173,15 +1270,48 @@ bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
  ******************************************************************************/
 
 uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support) {
-  if (eatt_support && tcb.eatt) {
-    EattChannel* channel =
-        EattExtension::GetInstance()->GetChannelAvailableForClientRequest(
-            tcb.peer_bda);
-    if (channel) {
-      return channel->cid_;
-    }
+  if (!eatt_support || !tcb.eatt) return tcb.att_lcid;
+
+  /* Balance the requests over the EATT channels and the ATT channel */
+  std::vector<tGATT_BEARER_LOAD> bearers;
+  for (EattChannel* channel :
+       EattExtension::GetInstance()->GetOpenedChannels(tcb.peer_bda)) {
+    bearers.push_back(
+        {channel->cid_, channel->cl_cmd_q_.size(), channel->tx_mtu_});
+  }
+  bearers.push_back({tcb.att_lcid, tcb.cl_cmd_q.size(), tcb.payload_size});
+
+  const tGATT_BEARER_LOAD& bearer = bearers[gatt_select_bearer(bearers)];
+  if (bearer.queue_depth > 0) {
+    /* Every bearer is busy, the request waits behind the others */
+    EattExtension::GetInstance()->ConnectAdditionalChannel(tcb.peer_bda);
+  }
+  return bearer.cid;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_tcb_count_bearer_traffic
+ *
+ * Description      This function accounts an ATT PDU sent or received on the
+ *                  bearer cid
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_tcb_count_bearer_traffic(tGATT_TCB& tcb, uint16_t cid, uint16_t len,
+                                   bool is_tx) {
+  auto [it, inserted] = tcb.bearer_stats.try_emplace(cid);
+  tGATT_BEARER_STATS& stats = it->second;
+  if (inserted) stats.first_pdu = std::chrono::steady_clock::now();
+
+  if (is_tx) {
+    stats.tx_bytes += len;
+    stats.tx_pdus++;
+  } else {
+    stats.rx_bytes += len;
+    stats.rx_pdus++;
   }
-  return tcb.att_lcid;
 }
 
 /*******************************************************************************
@@ -80,4 +80,9 @@ int a2dp_aac_get_effective_frame_size();
 // |timestamp_us| is the current timestamp (in microseconds).
 void a2dp_aac_send_frames(uint64_t timestamp_us);
 
+// Set transmit queue length for the A2DP AAC adaptive bit rate: in constant
+// bit rate mode, the bit rate is lowered while packets pile up in the
+// transmit queue.
+void a2dp_aac_set_transmit_queue_length(size_t transmit_queue_length);
+
 #endif  // A2DP_AAC_ENCODER_H
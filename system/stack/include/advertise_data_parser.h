@@ -20,6 +20,9 @@
 
 #include <array>
 #include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
 #include <vector>
 
 // Scan Response data from Traxxas
@@ -143,3 +146,116 @@ class AdvertiseDataParser {
     return GetFieldByType(ad.data(), ad.size(), type, p_length);
   }
 };
+
+/**
+ * Index of the fields of advertising or EIR data, built in a single pass.
+ *
+ * The fields are looked up in a table of offsets held by the index, rather than
+ * by walking the data again for each type, and are returned as views inside the
+ * data, which must outlive the index. Fields are delimited the same way as by
+ * AdvertiseDataParser::GetFieldByType().
+ */
+class AdvertiseDataIndex {
+ public:
+  AdvertiseDataIndex(const uint8_t* ad, size_t ad_len)
+      : ad_(ad), ad_len_(ad_len) {
+    tail_ = Walk(0, [this](size_t offset, uint8_t type, uint8_t length) {
+      if (num_fields_ == kMaxFields ||
+          offset > std::numeric_limits<uint16_t>::max()) {
+        return false;
+      }
+      fields_[num_fields_++] = {static_cast<uint16_t>(offset), type, length};
+      return true;
+    });
+  }
+
+  explicit AdvertiseDataIndex(const std::vector<uint8_t>& ad)
+      : AdvertiseDataIndex(ad.data(), ad.size()) {}
+
+  AdvertiseDataIndex(const AdvertiseDataIndex&) = delete;
+  AdvertiseDataIndex& operator=(const AdvertiseDataIndex&) = delete;
+
+  /**
+   * Calls |callback| with the data of each field of |type|, in order, until it
+   * returns false.
+   */
+  template <typename F>
+  void ForEachField(uint8_t type, F callback) const {
+    for (size_t i = 0; i < num_fields_; i++) {
+      if (fields_[i].type != type) continue;
+      if (!callback(std::span<const uint8_t>(ad_ + fields_[i].offset,
+                                             fields_[i].length))) {
+        return;
+      }
+    }
+
+    // Fields past the capacity of the table are looked up in the data
+    Walk(tail_, [&](size_t offset, uint8_t field_type, uint8_t length) {
+      if (field_type != type) return true;
+      return callback(std::span<const uint8_t>(ad_ + offset, length));
+    });
+  }
+
+  /**
+   * Returns the data of the first field of |type|, std::nullopt when there is
+   * none.
+   */
+  std::optional<std::span<const uint8_t>> GetField(uint8_t type) const {
+    std::optional<std::span<const uint8_t>> field;
+    ForEachField(type, [&field](std::span<const uint8_t> data) {
+      field = data;
+      return false;
+    });
+    return field;
+  }
+
+  /**
+   * Same as AdvertiseDataParser::GetFieldByType(), on the indexed data.
+   */
+  const uint8_t* GetFieldByType(uint8_t type, uint8_t* p_length) const {
+    auto field = GetField(type);
+    if (!field) {
+      *p_length = 0;
+      return NULL;
+    }
+    *p_length = field->size();
+    return field->data();
+  }
+
+ private:
+  // Enough for any EIR, where a field takes at least two bytes
+  static constexpr size_t kMaxFields = 120;
+
+  struct Field {
+    uint16_t offset;
+    uint8_t type;
+    uint8_t length;
+  };
+
+  /**
+   * Calls |on_field| with the offset of the data, type and data length of the
+   * fields starting at |position|, until it returns false. Returns the position
+   * of the field it returned false for, |ad_len_| when all were visited.
+   */
+  template <typename F>
+  size_t Walk(size_t position, F on_field) const {
+    while (position != ad_len_) {
+      uint8_t len = ad_[position];
+
+      if (len == 0) break;
+      if (position + len >= ad_len_) break;
+
+      if (!on_field(position + 2, ad_[position + 1], len - 1)) return position;
+
+      position += len + 1;
+    }
+    return ad_len_;
+  }
+
+  const uint8_t* ad_;
+  size_t ad_len_;
+  std::array<Field, kMaxFields> fields_;
+  size_t num_fields_ = 0;
+  // Position of the first field not in the table, |ad_len_| when all are
+  size_t tail_;
+};
@@ -88,7 +88,8 @@ inline std::string avdt_result_text(const tAVDT_RESULT& result) {
 
 /* The number of bytes needed by the protocol stack for the protocol headers
  * of a media packet.  This is the size of the media packet header, the
- * L2CAP packet header and HCI header.
+ * L2CAP packet header and HCI header.  The headers are prepended in place in
+ * this headroom, a media packet with less is dropped rather than copied.
 */
 #define AVDT_MEDIA_OFFSET 23
 
@@ -329,6 +329,19 @@ tBTM_STATUS BTM_BleGetEnergyInfo(tBTM_BLE_ENERGY_INFO_CBACK* p_ener_cback);
 tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
                                  uint16_t tx_pdu_length);
 
+/*******************************************************************************
+ *
+ * Function         BTM_RestoreBleDataLength
+ *
+ * Description      Set the BLE transmission packet size back to tx_pdu_length,
+ *                  lowering it when a larger size was set before.
+ *
+ * Returns          BTM_SUCCESS if success; otherwise failed.
+ *
+ ******************************************************************************/
+tBTM_STATUS BTM_RestoreBleDataLength(const RawAddress& bd_addr,
+                                     uint16_t tx_pdu_length);
+
 /*******************************************************************************
  *
  * Function         BTM_BleReadPhy
@@ -169,6 +169,25 @@ class IsoManager {
   virtual void SendIsoData(uint16_t conn_handle, const uint8_t* data,
                            uint16_t data_len);
 
+  /**
+   * Reserves the buffer of the next SDU, so that the caller can write the
+   * payload in place instead of passing a copy to SendIsoData.
+   *
+   * @param conn_handle handle of BIS or CIS connection
+   * @param data_len SDU payload length
+   * @return buffer of data_len bytes, valid until SendIsoSdu is called for the
+   * handle, or nullptr when the SDU would be dropped. SendIsoData should then
+   * be used so that the drop is accounted for.
+   */
+  virtual uint8_t* AcquireIsoSdu(uint16_t conn_handle, uint16_t data_len);
+
+  /**
+   * Sends the SDU acquired with AcquireIsoSdu to the controller
+   *
+   * @param conn_handle handle of BIS or CIS connection
+   */
+  virtual void SendIsoSdu(uint16_t conn_handle);
+
   /**
    * Creates the Broadcast Isochronous Group
    *
@@ -196,6 +215,15 @@ class IsoManager {
    */
   virtual void HandleIsoData(void* p_msg);
 
+  /**
+   * Handles an Iso Data packet holding a complete SDU, read in place
+   *
+   * @param packet HCI ISO data packet, with its header. It is only borrowed
+   * for the duration of the call.
+   * @param len length of the packet
+   */
+  virtual void HandleIsoSdu(const uint8_t* packet, uint16_t len);
+
   /**
    * Handles disconnect HCI event
    *
@@ -98,7 +98,12 @@ struct cis_data_evt {
   uint32_t ts;
   uint16_t evt_lost;
   uint16_t seq_nb;
+  /* Buffer of the packet, nullptr when the SDU is read in place from the
+   * HCI layer */
   BT_HDR* p_msg;
+  /* The SDU, only valid during the callback */
+  const uint8_t* sdu;
+  uint16_t sdu_len;
 };
 
 struct cis_establish_params {
@@ -23,7 +23,9 @@
 
 #include <cstdint>
 #include <list>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "btm_ble_api.h"
 #include "gattdefs.h"
@@ -190,6 +192,14 @@ typedef enum : uint8_t {
   MTU_EXCHANGE_ALREADY_DONE,
 } tGATTC_TryMtuRequestResult;
 
+/* Throughput profile an application declares on a connection */
+typedef enum : uint8_t {
+  /* Default link settings, favoring power consumption */
+  GATT_THROUGHPUT_LOW_POWER = 0x00,
+  /* Bulk transfers, the link runs with its maximum data length and PHY */
+  GATT_THROUGHPUT_BULK,
+} tGATT_THROUGHPUT_PROFILE;
+
 inline std::string gatt_op_code_text(const tGATT_OP_CODE& op_code) {
   switch (op_code) {
     case GATT_RSP_ERROR:
@@ -490,6 +500,14 @@ typedef struct {
   uint8_t value[GATT_MAX_ATTR_LEN]; /* the actual attribute value */
 } tGATT_VALUE;
 
+/* Attribute value of a notification, the value is not copied
+*/
+typedef struct {
+  uint16_t handle;        /* attribute handle */
+  uint16_t len;           /* length of attribute value */
+  const uint8_t* p_value; /* the attribute value */
+} tGATT_NOTIF_VALUE;
+
 /* Union of the event data which is used in the server respond API to carry the
  * server response information
 */
@@ -928,6 +946,46 @@ void GATTS_StopService(uint16_t service_handle);
                                                          uint16_t val_len,
                                                          uint8_t* p_val);
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleValueNotifications
+ *
+ * Description      This function sends handle value notifications of several
+ *                  attributes to a client. When the client supports them,
+ *                  the values fitting in one PDU are sent together in
+ *                  Multiple Handle Value Notifications.
+ *
+ * Parameter        conn_id: connection identifier.
+ *                  values: Handles and values of the notified attributes.
+ *
+ * Returns          GATT_SUCCESS if successfully sent, GATT_CONGESTED if sent
+ *                  but the channel is congested; otherwise error code.
+ *
+ ******************************************************************************/
+[[nodiscard]] tGATT_STATUS GATTS_HandleValueNotifications(
+    uint16_t conn_id, const std::vector<tGATT_NOTIF_VALUE>& values);
+
+/*******************************************************************************
+ *
+ * Function         GATTS_SetAttributeValueCache
+ *
+ * Description      This function caches the value of a characteristic value or
+ *                  descriptor attribute of the application. Until the cache
+ *                  is cleared, read requests of the attribute are answered
+ *                  with this value without being sent to the application.
+ *
+ * Parameter        gatt_if: application interface owning the attribute.
+ *                  attr_handle: Attribute handle.
+ *                  value: the value to cache, or std::nullopt to clear the
+ *                         cache.
+ *
+ * Returns          GATT_SUCCESS if successfully set; otherwise error code.
+ *
+ ******************************************************************************/
+[[nodiscard]] tGATT_STATUS GATTS_SetAttributeValueCache(
+    tGATT_IF gatt_if, uint16_t attr_handle,
+    std::optional<std::vector<uint8_t>> value);
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -1247,6 +1305,25 @@ void GATT_StartIf(tGATT_IF gatt_if);
  ******************************************************************************/
 [[nodiscard]] tGATT_STATUS GATT_Disconnect(uint16_t conn_id);
 
+/*******************************************************************************
+ *
+ * Function         GATT_SetThroughputProfile
+ *
+ * Description      Declare the throughput profile of the application on the
+ *                  connection. The LE link asks for the maximum data length
+ *                  and the 2M PHY while any of its applications runs bulk
+ *                  transfers, and goes back to the low power settings when
+ *                  the last one is done or leaves the link.
+ *
+ * Parameters       conn_id: connection identifier.
+ *                  profile: throughput profile of the application.
+ *
+ * Returns          GATT_SUCCESS if the profile was recorded.
+ *
+ ******************************************************************************/
+[[nodiscard]] tGATT_STATUS GATT_SetThroughputProfile(
+    uint16_t conn_id, tGATT_THROUGHPUT_PROFILE profile);
+
 /*******************************************************************************
  *
  * Function         GATT_GetConnectionInfor
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <base/functional/bind.h>
 #include <base/functional/callback.h>
 #include <base/location.h>
 #include <base/threading/thread.h>
@@ -37,3 +38,27 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
 void post_on_bt_main(BtMainClosure closure);
 void main_thread_start_up();
 void main_thread_shut_down();
+
+// Runs |task| on the shared worker pool, for work which does not need to be
+// ordered with the main thread, e.g. file I/O or CPU bound computations. The
+// task must not access the state owned by the main thread.
+bt_status_t do_in_worker_pool(const base::Location& from_here,
+                              base::OnceClosure task);
+
+// Runs |task| on the shared worker pool, then |reply| with its result on the
+// main thread
+template <typename R>
+bt_status_t do_in_worker_pool_and_reply(const base::Location& from_here,
+                                        base::OnceCallback<R()> task,
+                                        base::OnceCallback<void(R)> reply) {
+  return do_in_worker_pool(
+      from_here,
+      base::BindOnce(
+          [](const base::Location& from_here, base::OnceCallback<R()> task,
+             base::OnceCallback<void(R)> reply) {
+            do_in_main_thread(
+                from_here,
+                base::BindOnce(std::move(reply), std::move(task).Run()));
+          },
+          from_here, std::move(task), std::move(reply)));
+}
@@ -480,4 +480,17 @@ void RFCOMM_Init(void);
  ******************************************************************************/
 [[nodiscard]] int PORT_GetSecurityMask(uint16_t handle, uint16_t* sec_mask);
 
+/*******************************************************************************
+ *
+ * Function         PORT_Dumpsys
+ *
+ * Description      This function provides dumpsys data during the dumpsys
+ *                  procedure: the data and credit based flow control counters
+ *                  of the open ports.
+ *
+ * Parameters:      fd: Descriptor used to write the RFCOMM internals
+ *
+ ******************************************************************************/
+void PORT_Dumpsys(int fd);
+
 #endif /* PORT_API_H */
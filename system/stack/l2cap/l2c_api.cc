@@ -1794,6 +1794,14 @@ void L2CA_Dumpsys(int fd) {
           ccb->local_cid, ccb->remote_cid,
           ccb->ecoc ? "true" : "false",
           ccb->in_use ? "true" : "false");
+      if (ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) {
+        LOG_DUMPSYS(fd,
+                    "    ertm unacked:%zu retransmitted:%u rej_rcvd:%u "
+                    "srej_rcvd:%u srej_sent:%u",
+                    fixed_queue_length(ccb->fcrb.waiting_for_ack_q),
+                    ccb->fcrb.num_retransmitted, ccb->fcrb.num_rej_rcvd,
+                    ccb->fcrb.num_srej_rcvd, ccb->fcrb.num_srej_sent);
+      }
       ccb = ccb->p_next_ccb;
     }
   }
@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "l2c_ble"
+#define OSI_ALLOC_TAG "l2cap"
 
 #include <base/strings/stringprintf.h>
 #include <bluetooth/log.h>
@@ -77,7 +78,7 @@ void L2CA_Consolidate(const RawAddress& identity_addr, const RawAddress& rpa) {
   }
 
   log::info("consolidating l2c_lcb record {} -> {}", rpa, identity_addr);
-  p_lcb->remote_bd_addr = identity_addr;
+  l2cu_set_lcb_bd_addr(p_lcb, identity_addr);
 }
 
 hci_role_t L2CA_GetBleConnRole(const RawAddress& bd_addr) {
@@ -112,6 +113,9 @@ void l2cble_notify_le_connection(const RawAddress& bda) {
     /* update l2cap link status and send callback */
     p_lcb->link_state = LST_CONNECTED;
     l2cu_process_fixed_chnl_resp(p_lcb);
+
+    /* the new link may change the harmonic set of the central links */
+    if (p_lcb->IsLinkRoleCentral()) l2cble_rebalance_conn_intervals();
   }
 
   /* For all channels, send the event through their FSMs */
@@ -171,6 +175,7 @@ bool l2cble_conn_comp(uint16_t handle, tHCI_ROLE role, const RawAddress& bda,
   /* update link parameter, set peripheral link as non-spec default upon link up
    */
   p_lcb->min_interval = p_lcb->max_interval = conn_interval;
+  p_lcb->harmonic_interval = 0;
   p_lcb->timeout = conn_timeout;
   p_lcb->latency = conn_latency;
   p_lcb->conn_update_mask = L2C_BLE_NOT_DEFAULT_PARAM;
@@ -326,6 +331,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
           p_lcb->timeout = timeout;
           p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
 
+          l2cble_rebalance_conn_intervals();
           l2cble_start_conn_update(p_lcb);
         }
       } else
@@ -435,7 +441,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
           temp_p_ccb->peer_conn_cfg.credits = initial_credit;
 
           temp_p_ccb->tx_mps = mps;
-          temp_p_ccb->ble_sdu = NULL;
+          temp_p_ccb->ble_sdu = {};
           temp_p_ccb->ble_sdu_length = 0;
           temp_p_ccb->is_first_seg = true;
           temp_p_ccb->peer_cfg.fcr.mode = L2CAP_FCR_LE_COC_MODE;
@@ -586,7 +592,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
                           &con_info);
         } else {
           temp_p_ccb->tx_mps = mps;
-          temp_p_ccb->ble_sdu = NULL;
+          temp_p_ccb->ble_sdu = {};
           temp_p_ccb->ble_sdu_length = 0;
           temp_p_ccb->is_first_seg = true;
           temp_p_ccb->peer_cfg.fcr.mode = L2CAP_FCR_LE_COC_MODE;
@@ -783,7 +789,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
       p_ccb->peer_conn_cfg.credits = initial_credit;
 
       p_ccb->tx_mps = mps;
-      p_ccb->ble_sdu = NULL;
+      p_ccb->ble_sdu = {};
       p_ccb->ble_sdu_length = 0;
       p_ccb->is_first_seg = true;
       p_ccb->peer_cfg.fcr.mode = L2CAP_FCR_LE_COC_MODE;
@@ -835,7 +841,7 @@ void l2cble_process_sig_cmd(tL2C_LCB* p_lcb, uint8_t* p, uint16_t pkt_len) {
         }
 
         p_ccb->tx_mps = p_ccb->peer_conn_cfg.mps;
-        p_ccb->ble_sdu = NULL;
+        p_ccb->ble_sdu = {};
         p_ccb->ble_sdu_length = 0;
         p_ccb->is_first_seg = true;
         p_ccb->peer_cfg.fcr.mode = L2CAP_FCR_LE_COC_MODE;
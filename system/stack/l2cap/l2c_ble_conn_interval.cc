@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include "stack/l2cap/l2c_ble_conn_interval.h"
+
+#include <algorithm>
+
+#include "stack/include/btm_ble_api_types.h"
+
+/* Shortest harmonic of |base| within |range|, 0 if there is none */
+static uint16_t harmonic_in_range(uint32_t base,
+                                  const tL2C_BLE_CONN_INT_RANGE& range) {
+  uint32_t interval = base;
+  while (interval < range.min_int) {
+    interval <<= 1;
+  }
+  return interval <= range.max_int ? static_cast<uint16_t>(interval) : 0;
+}
+
+std::vector<uint16_t> l2c_ble_plan_conn_intervals(
+    const std::vector<tL2C_BLE_CONN_INT_RANGE>& ranges) {
+  std::vector<uint16_t> intervals(ranges.size(), 0);
+
+  uint32_t highest_max = 0;
+  for (const auto& range : ranges) {
+    if (range.min_int <= range.max_int) {
+      highest_max = std::max<uint32_t>(highest_max, range.max_int);
+    }
+  }
+  highest_max = std::min<uint32_t>(highest_max, BTM_BLE_CONN_INT_MAX);
+
+  /* The ranges are at most a few thousand slots wide and there are a handful
+   * of links, trying every base is cheap enough */
+  uint32_t best_base = 0;
+  size_t best_count = 0;
+  uint32_t best_sum = 0;
+  for (uint32_t base = BTM_BLE_CONN_INT_MIN; base <= highest_max; base++) {
+    size_t count = 0;
+    uint32_t sum = 0;
+    for (const auto& range : ranges) {
+      uint16_t interval = harmonic_in_range(base, range);
+      if (interval != 0) {
+        count++;
+        sum += interval;
+      }
+    }
+    if (count > best_count || (count == best_count && sum <= best_sum)) {
+      best_base = base;
+      best_count = count;
+      best_sum = sum;
+    }
+  }
+
+  if (best_count == 0) {
+    return intervals;
+  }
+  for (size_t i = 0; i < ranges.size(); i++) {
+    intervals[i] = harmonic_in_range(best_base, ranges[i]);
+  }
+  return intervals;
+}
+
+uint16_t l2c_ble_harmonic_subrate(uint16_t subrate_min, uint16_t subrate_max) {
+  uint32_t subrate = 1;
+  while (subrate < subrate_min) {
+    subrate <<= 1;
+  }
+  return subrate <= subrate_max ? static_cast<uint16_t>(subrate) : 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/* Connection interval range requested for an LE link, in 1.25 ms units */
+typedef struct {
+  uint16_t min_int;
+  uint16_t max_int;
+} tL2C_BLE_CONN_INT_RANGE;
+
+/* Picks the connection intervals of the LE links scheduled by the local
+ * controller as central.
+ *
+ * The intervals are taken from a harmonic set, the multiples by a power of two
+ * of a common base interval, so that the anchor points of the links recur in
+ * a fixed pattern and the controller can place them without collisions. The
+ * base is the one that harmonizes the most links, then the one that keeps the
+ * intervals closest to the minimum requested, then the longest one. Each link
+ * gets the shortest harmonic interval within its range.
+ *
+ * Returns the interval picked for each range, in the order of |ranges|, or 0
+ * for a range that contains no harmonic of the base. */
+std::vector<uint16_t> l2c_ble_plan_conn_intervals(
+    const std::vector<tL2C_BLE_CONN_INT_RANGE>& ranges);
+
+/* Returns the smallest power of two within [subrate_min, subrate_max], so
+ * that a subrated link stays on the harmonic set, or 0 if there is none. */
+uint16_t l2c_ble_harmonic_subrate(uint16_t subrate_min, uint16_t subrate_max);
@@ -27,14 +27,18 @@
 
 #include <bluetooth/log.h>
 
+#include <vector>
+
 #include "hci/controller_interface.h"
 #include "internal_include/stack_config.h"
 #include "main/shim/acl_api.h"
 #include "main/shim/entry.h"
+#include "os/system_properties.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/btm_ble_api_types.h"
 #include "stack/include/l2c_api.h"
+#include "stack/l2cap/l2c_ble_conn_interval.h"
 #include "stack/l2cap/l2c_int.h"
 #include "types/raw_address.h"
 
@@ -43,6 +47,9 @@ using namespace bluetooth;
 void l2cble_start_conn_update(tL2C_LCB* p_lcb);
 static void l2cble_start_subrate_change(tL2C_LCB* p_lcb);
 
+static const char kPropertyHarmonicConnIntervals[] =
+    "bluetooth.core.le.harmonic_conn_intervals";
+
 /*******************************************************************************
  *
  *  Function        L2CA_UpdateBleConnParams
@@ -86,6 +93,7 @@ bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
   p_lcb->min_ce_len = min_ce_len;
   p_lcb->max_ce_len = max_ce_len;
 
+  l2cble_rebalance_conn_intervals();
   l2cble_start_conn_update(p_lcb);
 
   return (true);
@@ -180,11 +188,95 @@ static bool l2c_enable_update_ble_conn_params(tL2C_LCB* p_lcb, bool enable) {
     p_lcb->subrate_req_mask |= L2C_BLE_SUBRATE_REQ_DISABLE;
   }
 
+  l2cble_rebalance_conn_intervals();
   l2cble_start_conn_update(p_lcb);
 
   return (true);
 }
 
+/*******************************************************************************
+ *
+ *  Function        l2cble_get_conn_interval
+ *
+ *  Description     Get the connection interval range to request for the link:
+ *                  its harmonic interval if it has one, the range requested
+ *                  for the link otherwise.
+ *
+ *  Parameters:     lcb : l2cap link control block
+ *
+ *  Return value:   none
+ *
+ ******************************************************************************/
+static void l2cble_get_conn_interval(const tL2C_LCB* p_lcb, uint16_t* min_int,
+                                     uint16_t* max_int) {
+  if (p_lcb->harmonic_interval != 0) {
+    *min_int = *max_int = p_lcb->harmonic_interval;
+  } else {
+    *min_int = p_lcb->min_interval;
+    *max_int = p_lcb->max_interval;
+  }
+}
+
+/* Links whose interval the local controller picks within a requested range */
+static bool l2cble_is_harmonizable_link(const tL2C_LCB& lcb) {
+  return lcb.in_use && lcb.is_transport_ble() && lcb.IsLinkRoleCentral() &&
+         lcb.link_state == LST_CONNECTED &&
+         !(lcb.conn_update_mask & L2C_BLE_CONN_UPDATE_DISABLE);
+}
+
+/*******************************************************************************
+ *
+ *  Function        l2cble_rebalance_conn_intervals
+ *
+ *  Description     Pick the connection intervals of the central LE links from
+ *                  a harmonic set, so that the controller can schedule their
+ *                  anchor points without collisions, and update the links
+ *                  whose interval changed. Called when a link joins or leaves
+ *                  and when the requested parameters of a link change.
+ *
+ *  Return value:   none
+ *
+ ******************************************************************************/
+void l2cble_rebalance_conn_intervals(void) {
+  static bluetooth::os::CachedSystemPropertyBool harmonic_conn_intervals(
+      kPropertyHarmonicConnIntervals, true);
+  if (!harmonic_conn_intervals.Get()) return;
+
+  std::vector<tL2C_LCB*> links;
+  std::vector<tL2C_BLE_CONN_INT_RANGE> ranges;
+  for (int i = 0; i < MAX_L2CAP_LINKS; i++) {
+    tL2C_LCB* p_lcb = &l2cb.lcb_pool[i];
+    if (!l2cble_is_harmonizable_link(*p_lcb)) {
+      p_lcb->harmonic_interval = 0;
+      continue;
+    }
+    links.push_back(p_lcb);
+    ranges.push_back({p_lcb->min_interval, p_lcb->max_interval});
+  }
+
+  /* a single link does not collide with anything, leave its range alone */
+  std::vector<uint16_t> intervals(links.size(), 0);
+  if (links.size() > 1) {
+    intervals = l2c_ble_plan_conn_intervals(ranges);
+  }
+
+  for (size_t i = 0; i < links.size(); i++) {
+    tL2C_LCB* p_lcb = links[i];
+    if (p_lcb->harmonic_interval == intervals[i]) continue;
+
+    uint16_t old_min, old_max, new_min, new_max;
+    l2cble_get_conn_interval(p_lcb, &old_min, &old_max);
+    p_lcb->harmonic_interval = intervals[i];
+    l2cble_get_conn_interval(p_lcb, &new_min, &new_max);
+    if (old_min == new_min && old_max == new_max) continue;
+
+    log::info("{} connection interval {}-{} ==> {}-{}", p_lcb->remote_bd_addr,
+              old_min, old_max, new_min, new_max);
+    p_lcb->conn_update_mask |= L2C_BLE_NEW_CONN_PARAM;
+    l2cble_start_conn_update(p_lcb);
+  }
+}
+
 /*******************************************************************************
  *
  *  Function        l2cble_start_conn_update
@@ -250,6 +342,7 @@ void l2cble_start_conn_update(tL2C_LCB* p_lcb) {
   } else {
     /* application allows to do update, if we were delaying one do it now */
     if (p_lcb->conn_update_mask & L2C_BLE_NEW_CONN_PARAM) {
+      l2cble_get_conn_interval(p_lcb, &min_conn_int, &max_conn_int);
       /* if both side 4.1, or we are central device, send HCI command */
       if (p_lcb->IsLinkRoleCentral() ||
           (bluetooth::shim::GetController()
@@ -257,14 +350,12 @@ void l2cble_start_conn_update(tL2C_LCB* p_lcb) {
            acl_peer_supports_ble_connection_parameters_request(
                p_lcb->remote_bd_addr))) {
         acl_ble_connection_parameters_request(
-            p_lcb->Handle(), p_lcb->min_interval, p_lcb->max_interval,
-            p_lcb->latency, p_lcb->timeout, p_lcb->min_ce_len,
-            p_lcb->max_ce_len);
+            p_lcb->Handle(), min_conn_int, max_conn_int, p_lcb->latency,
+            p_lcb->timeout, p_lcb->min_ce_len, p_lcb->max_ce_len);
         p_lcb->conn_update_mask |= L2C_BLE_UPDATE_PENDING;
       } else {
-        l2cu_send_peer_ble_par_req(p_lcb, p_lcb->min_interval,
-                                   p_lcb->max_interval, p_lcb->latency,
-                                   p_lcb->timeout);
+        l2cu_send_peer_ble_par_req(p_lcb, min_conn_int, max_conn_int,
+                                   p_lcb->latency, p_lcb->timeout);
       }
       p_lcb->conn_update_mask &= ~L2C_BLE_NEW_CONN_PARAM;
       p_lcb->conn_update_mask |= L2C_BLE_NOT_DEFAULT_PARAM;
@@ -403,10 +494,21 @@ static void l2cble_start_subrate_change(tL2C_LCB* p_lcb) {
     return;
   }
 
+  /* keep a harmonized link on the harmonic set once subrated */
+  uint16_t subrate_min = p_lcb->subrate_min;
+  uint16_t subrate_max = p_lcb->subrate_max;
+  if (p_lcb->harmonic_interval != 0) {
+    uint16_t subrate = l2c_ble_harmonic_subrate(subrate_min, subrate_max);
+    if (subrate != 0) {
+      subrate_min = subrate_max = subrate;
+    }
+  }
+
   log::verbose("Sending HCI cmd for subrate req");
-  bluetooth::shim::ACL_LeSubrateRequest(
-      p_lcb->Handle(), p_lcb->subrate_min, p_lcb->subrate_max,
-      p_lcb->max_latency, p_lcb->cont_num, p_lcb->supervision_tout);
+  bluetooth::shim::ACL_LeSubrateRequest(p_lcb->Handle(), subrate_min,
+                                        subrate_max, p_lcb->max_latency,
+                                        p_lcb->cont_num,
+                                        p_lcb->supervision_tout);
 
   p_lcb->subrate_req_mask |= L2C_BLE_SUBRATE_REQ_PENDING;
   p_lcb->subrate_req_mask &= ~L2C_BLE_NEW_SUBRATE_PARAM;
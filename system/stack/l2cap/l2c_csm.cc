@@ -1758,12 +1758,9 @@ void l2c_enqueue_peer_data(tL2C_CCB* p_ccb, BT_HDR* p_buf) {
 
   l2cu_check_channel_congestion(p_ccb);
 
-  /* if new packet is higher priority than serving ccb and it is not overrun */
-  if ((p_ccb->p_lcb->rr_pri > p_ccb->ccb_priority) &&
-      (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].quota > 0)) {
-    /* send out higher priority packet */
-    p_ccb->p_lcb->rr_pri = p_ccb->ccb_priority;
-  }
+  /* queue the channel for service, a higher priority packet is sent first */
+  l2c_run_queue_activate(&p_ccb->p_lcb->run_queue, &p_ccb->run_node,
+                         p_ccb->ccb_priority);
 
   /* if we are doing a round robin scheduling, set the flag */
   if (p_ccb->p_lcb->link_xmit_quota == 0) l2cb.check_round_robin = true;
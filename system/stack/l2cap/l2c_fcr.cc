@@ -23,6 +23,8 @@
  *
  ******************************************************************************/
 
+#define OSI_ALLOC_TAG "l2cap"
+
 #include <bluetooth/log.h>
 #include <stdlib.h>
 #include <string.h>
@@ -34,6 +36,7 @@
 #include "stack/include/bt_types.h"
 #include "stack/include/l2c_api.h"
 #include "stack/include/l2cdefs.h"
+#include "stack/l2cap/l2c_fcr_crc.h"
 #include "stack/l2cap/l2c_int.h"
 
 /* Flag passed to retransmit_i_frames() when all packets should be retransmitted
@@ -49,39 +52,6 @@ static const char* SAR_types[] = {"Unsegmented", "Start", "End",
                                   "Continuation"};
 static const char* SUP_types[] = {"RR", "REJ", "RNR", "SREJ"};
 
-/* Look-up table for the CRC calculation */
-static const unsigned short crctab[256] = {
-    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241, 0xc601,
-    0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440, 0xcc01, 0x0cc0,
-    0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40, 0x0a00, 0xcac1, 0xcb81,
-    0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841, 0xd801, 0x18c0, 0x1980, 0xd941,
-    0x1b00, 0xdbc1, 0xda81, 0x1a40, 0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01,
-    0x1dc0, 0x1c80, 0xdc41, 0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0,
-    0x1680, 0xd641, 0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081,
-    0x1040, 0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
-    0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441, 0x3c00,
-    0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41, 0xfa01, 0x3ac0,
-    0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840, 0x2800, 0xe8c1, 0xe981,
-    0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41, 0xee01, 0x2ec0, 0x2f80, 0xef41,
-    0x2d00, 0xedc1, 0xec81, 0x2c40, 0xe401, 0x24c0, 0x2580, 0xe541, 0x2700,
-    0xe7c1, 0xe681, 0x2640, 0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0,
-    0x2080, 0xe041, 0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281,
-    0x6240, 0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
-    0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41, 0xaa01,
-    0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840, 0x7800, 0xb8c1,
-    0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41, 0xbe01, 0x7ec0, 0x7f80,
-    0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40, 0xb401, 0x74c0, 0x7580, 0xb541,
-    0x7700, 0xb7c1, 0xb681, 0x7640, 0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101,
-    0x71c0, 0x7080, 0xb041, 0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0,
-    0x5280, 0x9241, 0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481,
-    0x5440, 0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
-    0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841, 0x8801,
-    0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40, 0x4e00, 0x8ec1,
-    0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41, 0x4400, 0x84c1, 0x8581,
-    0x4540, 0x8701, 0x47c0, 0x4680, 0x8641, 0x8201, 0x42c0, 0x4380, 0x8341,
-    0x4100, 0x81c1, 0x8081, 0x4040,
-};
-
 /*******************************************************************************
  *  Static local functions
 */
@@ -95,28 +65,6 @@ static void prepare_I_frame(tL2C_CCB* p_ccb, BT_HDR* p_buf,
 static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
                               uint16_t ctrl_word);
 
-/*******************************************************************************
- *
- * Function         l2c_fcr_updcrc
- *
- * Description      This function computes the CRC using the look-up table.
- *
- * Returns          CRC
- *
- ******************************************************************************/
-static unsigned short l2c_fcr_updcrc(unsigned short icrc, unsigned char* icp,
-                                     int icnt) {
-  unsigned short crc = icrc;
-  unsigned char* cp = icp;
-  int cnt = icnt;
-
-  while (cnt--) {
-    crc = ((crc >> 8) & 0xff) ^ crctab[(crc & 0xff) ^ *cp++];
-  }
-
-  return (crc);
-}
-
 /*******************************************************************************
  *
  * Function         l2c_fcr_tx_get_fcs
@@ -151,6 +99,115 @@ static uint16_t l2c_fcr_rx_get_fcs(BT_HDR* p_buf) {
       l2c_fcr_updcrc(L2CAP_FCR_INIT_CRC, p, p_buf->len + L2CAP_PKT_OVERHEAD));
 }
 
+/*******************************************************************************
+ *
+ * Function         l2c_fcr_hold_for_ack
+ *
+ * Description      This function queues a transmitted I-frame until the peer
+ *                  acknowledges it. Frames are queued in TxSeq order.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+static void l2c_fcr_hold_for_ack(tL2C_FCRB* p_fcrb, BT_HDR* p_buf) {
+  uint8_t tx_seq = (p_fcrb->last_rx_ack +
+                    fixed_queue_length(p_fcrb->waiting_for_ack_q)) &
+                   L2CAP_FCR_SEQ_MODULO;
+
+  p_fcrb->unacked_frames[tx_seq] = p_buf;
+  fixed_queue_enqueue(p_fcrb->waiting_for_ack_q, p_buf);
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_fcr_find_unacked
+ *
+ * Description      This function looks up an I-frame waiting for ack by its
+ *                  TxSeq.
+ *
+ * Returns          pointer to the frame, or NULL if it is not outstanding
+ *
+ ******************************************************************************/
+static BT_HDR* l2c_fcr_find_unacked(tL2C_FCRB* p_fcrb, uint8_t tx_seq) {
+  size_t index = (tx_seq - p_fcrb->last_rx_ack) & L2CAP_FCR_SEQ_MODULO;
+
+  if (index >= fixed_queue_length(p_fcrb->waiting_for_ack_q)) {
+    return NULL;
+  }
+  return p_fcrb->unacked_frames[tx_seq];
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_rx_sdu_start
+ *
+ * Description      This function starts the reassembly of a new SDU.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+static void l2c_rx_sdu_start(tL2C_RX_SDU* p_sdu) {
+  p_sdu->segments = list_new(osi_free);
+  p_sdu->len = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_rx_sdu_append
+ *
+ * Description      This function takes ownership of a received segment and
+ *                  holds it until the SDU is complete.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+static void l2c_rx_sdu_append(tL2C_RX_SDU* p_sdu, BT_HDR* p_buf) {
+  p_sdu->len += p_buf->len;
+  list_append(p_sdu->segments, p_buf);
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_rx_sdu_free
+ *
+ * Description      This function drops the SDU being reassembled, if any.
+ *
+ * Returns          -
+ *
+ ******************************************************************************/
+static void l2c_rx_sdu_free(tL2C_RX_SDU* p_sdu) {
+  list_free(p_sdu->segments);
+  p_sdu->segments = NULL;
+  p_sdu->len = 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2c_rx_sdu_flatten
+ *
+ * Description      This function copies the segments of a complete SDU into a
+ *                  single buffer at the requested offset, and frees them.
+ *
+ * Returns          pointer to the buffer holding the SDU
+ *
+ ******************************************************************************/
+static BT_HDR* l2c_rx_sdu_flatten(tL2C_RX_SDU* p_sdu, uint16_t offset) {
+  BT_HDR* p_data = (BT_HDR*)osi_malloc(BT_HDR_SIZE + offset + p_sdu->len);
+  uint8_t* p = (uint8_t*)(p_data + 1) + offset;
+
+  p_data->offset = offset;
+  p_data->len = p_sdu->len;
+  for (const list_node_t* node = list_begin(p_sdu->segments);
+       node != list_end(p_sdu->segments); node = list_next(node)) {
+    BT_HDR* p_seg = (BT_HDR*)list_node(node);
+    memcpy(p, (uint8_t*)(p_seg + 1) + p_seg->offset, p_seg->len);
+    p += p_seg->len;
+  }
+
+  l2c_rx_sdu_free(p_sdu);
+  return p_data;
+}
+
 /*******************************************************************************
  *
  * Function         l2c_fcr_start_timer
@@ -211,7 +268,8 @@ void l2c_fcr_cleanup(tL2C_CCB* p_ccb) {
   alarm_free(p_fcrb->ack_timer);
   p_fcrb->ack_timer = NULL;
 
-  osi_free_and_reset((void**)&p_fcrb->p_rx_sdu);
+  l2c_rx_sdu_free(&p_fcrb->rx_sdu);
+  l2c_rx_sdu_free(&p_ccb->ble_sdu);
 
   fixed_queue_free(p_fcrb->waiting_for_ack_q, osi_free);
   p_fcrb->waiting_for_ack_q = NULL;
@@ -398,6 +456,8 @@ void l2c_fcr_send_S_frame(tL2C_CCB* p_ccb, uint16_t function_code,
     l2c_fcr_start_timer(p_ccb);
   }
 
+  if (function_code == L2CAP_FCR_SUP_SREJ) p_ccb->fcrb.num_srej_sent++;
+
   /* Create the control word to use */
   ctrl_word = (function_code << L2CAP_FCR_SUP_SHIFT) | L2CAP_FCR_S_FRAME_BIT;
   ctrl_word |= (p_ccb->fcrb.next_seq_expected << L2CAP_FCR_REQ_SEQ_BITS_SHIFT);
@@ -720,54 +780,44 @@ void l2c_lcc_proc_pdu(tL2C_CCB* p_ccb, BT_HDR* p_buf) {
       return;
     }
 
-    p_data = (BT_HDR*)osi_malloc(BT_HDR_SIZE + sdu_length);
-    if (p_data == NULL) {
-      osi_free(p_buf);
+    /* Unsegmented SDU, deliver the received buffer as is */
+    if (sdu_length == p_buf->len) {
+      l2c_csm_execute(p_ccb, L2CEVT_L2CAP_DATA, p_buf);
       return;
     }
 
-    p_ccb->ble_sdu = p_data;
-    p_data->len = 0;
+    l2c_rx_sdu_start(&p_ccb->ble_sdu);
     p_ccb->ble_sdu_length = sdu_length;
     log::verbose("SDU Length = {}", sdu_length);
-    p_data->offset = 0;
 
   } else {
-    p_data = p_ccb->ble_sdu;
-    if (p_data == NULL) {
+    if (p_ccb->ble_sdu.segments == NULL) {
       osi_free(p_buf);
       return;
     }
-    if (p_buf->len > (p_ccb->ble_sdu_length - p_data->len)) {
-      log::error("buffer length={} too big. max={}. Dropped", p_data->len,
-                 p_ccb->ble_sdu_length - p_data->len);
+    if (p_buf->len > (p_ccb->ble_sdu_length - p_ccb->ble_sdu.len)) {
+      log::error("buffer length={} too big. max={}. Dropped", p_buf->len,
+                 p_ccb->ble_sdu_length - p_ccb->ble_sdu.len);
       osi_free(p_buf);
 
       /* Throw away all pending fragments and disconnects */
       p_ccb->is_first_seg = true;
-      osi_free(p_ccb->ble_sdu);
-      p_ccb->ble_sdu = NULL;
+      l2c_rx_sdu_free(&p_ccb->ble_sdu);
       p_ccb->ble_sdu_length = 0;
       l2cu_disconnect_chnl(p_ccb);
       return;
     }
   }
 
-  memcpy((uint8_t*)(p_data + 1) + p_data->offset + p_data->len,
-         (uint8_t*)(p_buf + 1) + p_buf->offset, p_buf->len);
-  p_data->len += p_buf->len;
-  p = (uint8_t*)(p_data + 1) + p_data->offset;
-  if (p_data->len == p_ccb->ble_sdu_length) {
-    l2c_csm_execute(p_ccb, L2CEVT_L2CAP_DATA, p_data);
+  l2c_rx_sdu_append(&p_ccb->ble_sdu, p_buf);
+  if (p_ccb->ble_sdu.len == p_ccb->ble_sdu_length) {
+    p_data = l2c_rx_sdu_flatten(&p_ccb->ble_sdu, 0);
     p_ccb->is_first_seg = true;
-    p_ccb->ble_sdu = NULL;
     p_ccb->ble_sdu_length = 0;
-  } else if (p_data->len < p_ccb->ble_sdu_length) {
+    l2c_csm_execute(p_ccb, L2CEVT_L2CAP_DATA, p_data);
+  } else {
     p_ccb->is_first_seg = false;
   }
-
-  osi_free(p_buf);
-  return;
 }
 
 /*******************************************************************************
@@ -879,6 +929,8 @@ static bool process_reqseq(tL2C_CCB* p_ccb, uint16_t ctrl_word) {
     for (xx = 0; xx < num_bufs_acked; xx++) {
       BT_HDR* p_tmp =
           (BT_HDR*)fixed_queue_try_dequeue(p_fcrb->waiting_for_ack_q);
+      p_fcrb->unacked_frames[(req_seq - num_bufs_acked + xx) &
+                             L2CAP_FCR_SEQ_MODULO] = NULL;
       ls = p_tmp->layer_specific & L2CAP_FCR_SAR_BITS;
 
       if ((ls == L2CAP_FCR_UNSEG_SDU) || (ls == L2CAP_FCR_END_SDU))
@@ -952,6 +1004,7 @@ static void process_s_frame(tL2C_CCB* p_ccb, BT_HDR* p_buf,
       break;
 
     case L2CAP_FCR_SUP_REJ:
+      p_fcrb->num_rej_rcvd++;
       p_fcrb->remote_busy = false;
       all_ok = retransmit_i_frames(p_ccb, L2C_FCR_RETX_ALL_PKTS);
       break;
@@ -962,6 +1015,7 @@ static void process_s_frame(tL2C_CCB* p_ccb, BT_HDR* p_buf,
       break;
 
     case L2CAP_FCR_SUP_SREJ:
+      p_fcrb->num_srej_rcvd++;
       p_fcrb->remote_busy = false;
       all_ok = retransmit_i_frames(
           p_ccb, (uint8_t)((ctrl_word & L2CAP_FCR_REQ_SEQ_BITS) >>
@@ -1167,11 +1221,11 @@ static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
 
   /* Check if the SAR state is correct */
   if ((sar_type == L2CAP_FCR_UNSEG_SDU) || (sar_type == L2CAP_FCR_START_SDU)) {
-    if (p_fcrb->p_rx_sdu != NULL) {
+    if (p_fcrb->rx_sdu.segments != NULL) {
       log::warn(
           "SAR - got unexpected unsegmented or start SDU  Expected len: {}  "
           "Got so far: {}",
-          p_fcrb->rx_sdu_len, p_fcrb->p_rx_sdu->len);
+          p_fcrb->rx_sdu_len, p_fcrb->rx_sdu.len);
 
       packet_ok = false;
     }
@@ -1182,7 +1236,7 @@ static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
       packet_ok = false;
     }
   } else {
-    if (p_fcrb->p_rx_sdu == NULL) {
+    if (p_fcrb->rx_sdu.segments == NULL) {
       log::warn("SAR - got unexpected cont or end SDU");
       packet_ok = false;
     }
@@ -1203,37 +1257,27 @@ static bool do_sar_reassembly(tL2C_CCB* p_ccb, BT_HDR* p_buf,
                   p_ccb->max_rx_mtu);
         packet_ok = false;
       } else {
-        p_fcrb->p_rx_sdu = (BT_HDR*)osi_malloc(
-            BT_HDR_SIZE + OBX_BUF_MIN_OFFSET + p_fcrb->rx_sdu_len);
-        p_fcrb->p_rx_sdu->offset = OBX_BUF_MIN_OFFSET;
-        p_fcrb->p_rx_sdu->len = 0;
+        l2c_rx_sdu_start(&p_fcrb->rx_sdu);
       }
     }
 
     if (packet_ok) {
-      if ((p_fcrb->p_rx_sdu->len + p_buf->len) > p_fcrb->rx_sdu_len) {
+      if ((p_fcrb->rx_sdu.len + p_buf->len) > p_fcrb->rx_sdu_len) {
         log::error("SAR - SDU len exceeded  Type: {}   Lengths: {} {} {}",
-                   sar_type, p_fcrb->p_rx_sdu->len, p_buf->len,
+                   sar_type, p_fcrb->rx_sdu.len, p_buf->len,
                    p_fcrb->rx_sdu_len);
         packet_ok = false;
       } else if ((sar_type == L2CAP_FCR_END_SDU) &&
-                 ((p_fcrb->p_rx_sdu->len + p_buf->len) != p_fcrb->rx_sdu_len)) {
+                 ((p_fcrb->rx_sdu.len + p_buf->len) != p_fcrb->rx_sdu_len)) {
         log::warn("SAR - SDU end rcvd but SDU incomplete: {} {} {}",
-                  p_fcrb->p_rx_sdu->len, p_buf->len, p_fcrb->rx_sdu_len);
+                  p_fcrb->rx_sdu.len, p_buf->len, p_fcrb->rx_sdu_len);
         packet_ok = false;
       } else {
-        memcpy(((uint8_t*)(p_fcrb->p_rx_sdu + 1)) + p_fcrb->p_rx_sdu->offset +
-                   p_fcrb->p_rx_sdu->len,
-               p, p_buf->len);
-
-        p_fcrb->p_rx_sdu->len += p_buf->len;
-
-        osi_free(p_buf);
+        l2c_rx_sdu_append(&p_fcrb->rx_sdu, p_buf);
         p_buf = NULL;
 
         if (sar_type == L2CAP_FCR_END_SDU) {
-          p_buf = p_fcrb->p_rx_sdu;
-          p_fcrb->p_rx_sdu = NULL;
+          p_buf = l2c_rx_sdu_flatten(&p_fcrb->rx_sdu, OBX_BUF_MIN_OFFSET);
         }
       }
     }
@@ -1270,9 +1314,6 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
   log::assert_that(p_ccb != NULL, "assert failed: p_ccb != NULL");
 
   BT_HDR* p_buf = NULL;
-  uint8_t* p;
-  uint8_t buf_seq;
-  uint16_t ctrl_word;
 
   if ((!fixed_queue_is_empty(p_ccb->fcrb.waiting_for_ack_q)) &&
       (p_ccb->peer_cfg.fcr.max_transmit != 0) &&
@@ -1290,38 +1331,19 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
 
   /* tx_seq indicates whether to retransmit a specific sequence or all (if ==
    * L2C_FCR_RETX_ALL_PKTS) */
-  list_t* list_ack = NULL;
-  const list_node_t* node_ack = NULL;
-  if (!fixed_queue_is_empty(p_ccb->fcrb.waiting_for_ack_q)) {
-    list_ack = fixed_queue_get_list(p_ccb->fcrb.waiting_for_ack_q);
-    node_ack = list_begin(list_ack);
-  }
   if (tx_seq != L2C_FCR_RETX_ALL_PKTS) {
-    /* If sending only one, the sequence number tells us which one. Look for it.
-    */
-    if (list_ack != NULL) {
-      for (; node_ack != list_end(list_ack); node_ack = list_next(node_ack)) {
-        p_buf = (BT_HDR*)list_node(node_ack);
-        /* Get the old control word */
-        p = ((uint8_t*)(p_buf + 1)) + p_buf->offset + L2CAP_PKT_OVERHEAD;
-
-        STREAM_TO_UINT16(ctrl_word, p);
-
-        buf_seq =
-            (ctrl_word & L2CAP_FCR_TX_SEQ_BITS) >> L2CAP_FCR_TX_SEQ_BITS_SHIFT;
-
-        log::verbose("retransmit_i_frames()   cur seq: {}  looking for: {}",
-                     buf_seq, tx_seq);
-
-        if (tx_seq == buf_seq) break;
-      }
-    }
-
+    /* If sending only one, the sequence number tells us which one */
+    p_buf = l2c_fcr_find_unacked(&p_ccb->fcrb, tx_seq);
     if (!p_buf) {
       log::error("retransmit_i_frames() UNKNOWN seq: {}  q_count: {}", tx_seq,
                  fixed_queue_length(p_ccb->fcrb.waiting_for_ack_q));
       return (true);
     }
+
+    BT_HDR* p_buf2 = l2c_fcr_clone_buf(p_buf, p_buf->offset, p_buf->len);
+    p_buf2->layer_specific = p_buf->layer_specific;
+    fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf2);
+    p_ccb->fcrb.num_retransmitted++;
   } else {
     // Iterate though list and flush the amount requested from
     // the transmit data queue that satisfy the layer and event conditions.
@@ -1341,25 +1363,23 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
     while (!fixed_queue_is_empty(p_ccb->fcrb.retrans_q))
       osi_free(fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q));
 
-    if (list_ack != NULL) node_ack = list_begin(list_ack);
-  }
-
-  if (list_ack != NULL) {
-    while (node_ack != list_end(list_ack)) {
+    list_t* list_ack = fixed_queue_get_list(p_ccb->fcrb.waiting_for_ack_q);
+    for (const list_node_t* node_ack = list_begin(list_ack);
+         node_ack != list_end(list_ack); node_ack = list_next(node_ack)) {
       p_buf = (BT_HDR*)list_node(node_ack);
-      node_ack = list_next(node_ack);
 
       BT_HDR* p_buf2 = l2c_fcr_clone_buf(p_buf, p_buf->offset, p_buf->len);
-      if (p_buf2) {
-        p_buf2->layer_specific = p_buf->layer_specific;
-
-        fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf2);
-      }
-
-      if ((tx_seq != L2C_FCR_RETX_ALL_PKTS) || (p_buf2 == NULL)) break;
+      p_buf2->layer_specific = p_buf->layer_specific;
+      fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf2);
+      p_ccb->fcrb.num_retransmitted++;
     }
   }
 
+  if (!fixed_queue_is_empty(p_ccb->fcrb.retrans_q)) {
+    l2c_run_queue_activate(&p_ccb->p_lcb->run_queue, &p_ccb->run_node,
+                           p_ccb->ccb_priority);
+  }
+
   l2c_link_check_send_pkts(p_ccb->p_lcb, 0, NULL);
 
   if (fixed_queue_length(p_ccb->fcrb.waiting_for_ack_q)) {
@@ -1503,14 +1523,14 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
       p_xmit->len -= L2CAP_FCS_LEN;
 
       /* Pretend we sent it and it got lost */
-      fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_xmit);
+      l2c_fcr_hold_for_ack(&p_ccb->fcrb, p_xmit);
       return (NULL);
     } else {
       /* We will not save the FCS in case we reconfigure and change options */
       p_wack->len -= L2CAP_FCS_LEN;
 
       p_wack->layer_specific = p_xmit->layer_specific;
-      fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_wack);
+      l2c_fcr_hold_for_ack(&p_ccb->fcrb, p_wack);
     }
 
   }
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include "stack/l2cap/l2c_fcr_crc.h"
+
+#include <array>
+
+namespace {
+
+/* Reversed representation of x^16 + x^15 + x^2 + 1 */
+constexpr uint16_t kFcsPolynomial = 0xa001;
+constexpr size_t kSlices = 8;
+
+using CrcTables = std::array<std::array<uint16_t, 256>, kSlices>;
+
+/* tables[0][b] is the CRC of the byte b, and tables[k][b] the CRC of the
+ * byte b followed by k zero bytes. */
+constexpr CrcTables MakeCrcTables() {
+  CrcTables tables{};
+  for (uint32_t b = 0; b < 256; b++) {
+    uint16_t crc = b;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ kFcsPolynomial : crc >> 1;
+    }
+    tables[0][b] = crc;
+  }
+  for (size_t k = 1; k < kSlices; k++) {
+    for (size_t b = 0; b < 256; b++) {
+      uint16_t crc = tables[k - 1][b];
+      tables[k][b] = (crc >> 8) ^ tables[0][crc & 0xff];
+    }
+  }
+  return tables;
+}
+
+constexpr CrcTables kCrcTables = MakeCrcTables();
+
+static_assert(kCrcTables[0][1] == 0xc0c1 && kCrcTables[0][255] == 0x4040,
+              "FCS table does not match the L2CAP polynomial");
+
+}  // namespace
+
+uint16_t l2c_fcr_updcrc_bytewise(uint16_t crc, const uint8_t* data,
+                                 size_t len) {
+  while (len--) {
+    crc = (crc >> 8) ^ kCrcTables[0][(crc ^ *data++) & 0xff];
+  }
+  return crc;
+}
+
+uint16_t l2c_fcr_updcrc(uint16_t crc, const uint8_t* data, size_t len) {
+  const auto& t = kCrcTables;
+  /* The CRC only overlaps the first 2 bytes of each 8 bytes block, the other
+   * ones are looked up independently of it */
+  while (len >= kSlices) {
+    uint16_t x = crc ^ (data[0] | (data[1] << 8));
+    crc = t[7][x & 0xff] ^ t[6][x >> 8] ^ t[5][data[2]] ^ t[4][data[3]] ^
+          t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+    data += kSlices;
+    len -= kSlices;
+  }
+  return l2c_fcr_updcrc_bytewise(crc, data, len);
+}
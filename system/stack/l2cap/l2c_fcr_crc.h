@@ -0,0 +1,31 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* CRC-16 of the L2CAP Frame Check Sequence, generator polynomial
+ * x^16 + x^15 + x^2 + 1 with the bits processed LSB first.
+ *
+ * l2c_fcr_updcrc() folds 8 bytes per step with slice-by-8 tables.
+ * l2c_fcr_updcrc_bytewise() is the one byte per step reference, kept for the
+ * unit tests and benchmarks. Both return |crc| updated with |len| bytes of
+ * |data|. */
+uint16_t l2c_fcr_updcrc(uint16_t crc, const uint8_t* data, size_t len);
+uint16_t l2c_fcr_updcrc_bytewise(uint16_t crc, const uint8_t* data, size_t len);
@@ -40,6 +40,7 @@
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_sec_api_types.h"
 #include "stack/include/hci_error_code.h"
+#include "stack/l2cap/l2c_run_queue.h"
 #include "types/hci_role.h"
 #include "types/raw_address.h"
 
@@ -218,6 +219,13 @@ typedef enum : uint16_t {
 
 typedef uint8_t tL2C_BLE_FIXED_CHNLS_MASK;
 
+/* SDU being reassembled. The received segments are held as they are and only
+ * copied once, into the buffer delivered when the SDU is complete. */
+typedef struct {
+  list_t* segments; /* BT_HDR segments, NULL when no SDU is in progress */
+  uint16_t len;     /* Total length of the segments */
+} tL2C_RX_SDU;
+
 typedef struct {
   uint8_t next_tx_seq;       /* Next sequence number to be Tx'ed */
   uint8_t last_rx_ack;       /* Last sequence number ack'ed by the peer */
@@ -236,7 +244,7 @@ typedef struct {
   bool send_f_rsp; /* We need to send an F-bit response */
 
   uint16_t rx_sdu_len; /* Length of the SDU being received */
-  BT_HDR* p_rx_sdu;    /* Buffer holding the SDU being received */
+  tL2C_RX_SDU rx_sdu;  /* Segments of the SDU being received */
   fixed_queue_t*
       waiting_for_ack_q;          /* Buffers sent and waiting for peer to ack */
   fixed_queue_t* srej_rcv_hold_q; /* Buffers rcvd but held pending SREJ rsp */
@@ -245,6 +253,14 @@ typedef struct {
   alarm_t* ack_timer;         /* Timer delaying RR */
   alarm_t* mon_retrans_timer; /* Timer Monitor or Retransmission */
 
+  /* Frames of waiting_for_ack_q indexed by TxSeq, the queue holds consecutive
+   * sequence numbers starting at last_rx_ack */
+  BT_HDR* unacked_frames[L2CAP_FCR_SEQ_MODULO + 1];
+
+  uint32_t num_retransmitted; /* I-frames queued for retransmission */
+  uint32_t num_rej_rcvd;      /* REJ frames received */
+  uint32_t num_srej_rcvd;     /* SREJ frames received */
+  uint32_t num_srej_sent;     /* SREJ frames sent */
 } tL2C_FCRB;
 
 typedef struct {
@@ -286,7 +302,7 @@ typedef struct t_l2c_ccb {
       peer_conn_cfg;       /* Peer device config ble conn oriented channel */
   bool is_first_seg;       /* Dtermine whether the received packet is the first
                               segment or not */
-  BT_HDR* ble_sdu;         /* Buffer for storing unassembled sdu*/
+  tL2C_RX_SDU ble_sdu;     /* Segments of the unassembled sdu */
   uint16_t ble_sdu_length; /* Length of unassembled sdu length*/
   struct t_l2c_ccb* p_next_ccb; /* Next CCB in the chain */
   struct t_l2c_ccb* p_prev_ccb; /* Previous CCB in the chain */
@@ -322,6 +338,7 @@ typedef struct t_l2c_ccb {
   uint16_t buff_quota;        /* Buffer quota before sending congestion */
 
   tL2CAP_CHNL_PRIORITY ccb_priority;  /* Channel priority */
+  tL2C_RUN_NODE run_node;             /* Entry in the link run queue */
   tL2CAP_CHNL_DATA_RATE tx_data_rate; /* Channel Tx data rate */
   tL2CAP_CHNL_DATA_RATE rx_data_rate; /* Channel Rx data rate */
 
@@ -379,27 +396,6 @@ typedef struct {
   tL2C_CCB* p_last_ccb;  /* The last  channel in this queue */
 } tL2C_CCB_Q;
 
-/* Round-Robin service for the same priority channels */
-#define L2CAP_NUM_CHNL_PRIORITY \
-  3 /* Total number of priority group (high, medium, low)*/
-#define L2CAP_CHNL_PRIORITY_WEIGHT \
-  5 /* weight per priority for burst transmission quota */
-#define L2CAP_GET_PRIORITY_QUOTA(pri) \
-  ((L2CAP_NUM_CHNL_PRIORITY - (pri)) * L2CAP_CHNL_PRIORITY_WEIGHT)
-
-/* CCBs within the same LCB are served in round robin with priority It will make
- * sure that low priority channel (for example, HF signaling on RFCOMM) can be
- * sent to the headset even if higher priority channel (for example, AV media
- * channel) is congested.
- */
-
-typedef struct {
-  tL2C_CCB* p_serve_ccb; /* current serving ccb within priority group */
-  tL2C_CCB* p_first_ccb; /* first ccb of priority group */
-  uint8_t num_ccb;       /* number of channels in priority group */
-  uint8_t quota;         /* burst transmission quota */
-} tL2C_RR_SERV;
-
 typedef enum : uint8_t {
   /* disable update connection parameters */
   L2C_BLE_CONN_UPDATE_DISABLE = (1u << 0),
@@ -440,6 +436,7 @@ typedef struct t_l2c_linkcb {
   tL2C_CCB* p_pending_ccb;  /* ccb of waiting channel during link disconnect */
   alarm_t* info_resp_timer; /* Timer entry for info resp timeout evt */
   RawAddress remote_bd_addr; /* The BD address of the remote */
+  uint8_t next_by_addr;      /* Next LCB index + 1 in its address bucket */
 
  private:
   tHCI_ROLE link_role_{HCI_ROLE_CENTRAL}; /* Central or peripheral */
@@ -536,6 +533,9 @@ typedef struct t_l2c_linkcb {
   uint16_t timeout;
   uint16_t min_ce_len;
   uint16_t max_ce_len;
+  /* interval picked in the requested range to harmonize the central links,
+   * 0 to let the controller pick one in the range */
+  uint16_t harmonic_interval;
 
 #define L2C_BLE_SUBRATE_REQ_DISABLE 0x1  // disable subrate req
 #define L2C_BLE_NEW_SUBRATE_PARAM 0x2    // new subrate req parameter to be set
@@ -550,10 +550,8 @@ typedef struct t_l2c_linkcb {
 
   uint8_t subrate_req_mask;
 
-  /* each priority group is limited burst transmission */
-  /* round robin service for the same priority channels */
-  tL2C_RR_SERV rr_serv[L2CAP_NUM_CHNL_PRIORITY];
-  uint8_t rr_pri; /* current serving priority group */
+  /* channels with data to send, served by priority in round robin */
+  tL2C_RUN_QUEUE run_queue;
 
   /* Pending ECOC reconfiguration data */
   tL2CAP_LE_CFG_INFO pending_ecoc_reconfig_cfg;
@@ -581,6 +579,12 @@ typedef struct t_l2c_linkcb {
 
 /* Define the L2CAP control structure
 */
+/* Size of the LCB lookup tables of the control block, ACL handles are 12 bits
+ * and the address hash is a power of 2 */
+#define L2C_LCB_HANDLE_TABLE_SIZE 0x1000
+#define L2C_LCB_ADDR_HASH_SIZE 32
+static_assert(MAX_L2CAP_LINKS < 0xff, "LCB index + 1 must fit a uint8_t");
+
 typedef struct {
   uint16_t controller_xmit_window; /* Total ACL window for all links */
 
@@ -604,6 +608,10 @@ typedef struct {
   tL2C_CCB ccb_pool[MAX_L2CAP_CHANNELS]; /* Channel Control Block pool */
   tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS];  /* Registration info pool */
 
+  /* Lookup tables over lcb_pool, entries are an LCB index + 1, 0 if none */
+  uint8_t lcb_by_handle[L2C_LCB_HANDLE_TABLE_SIZE]; /* by HCI handle */
+  uint8_t lcb_by_addr[L2C_LCB_ADDR_HASH_SIZE]; /* address bucket heads */
+
   tL2C_CCB* p_free_ccb_first; /* Pointer to first free CCB */
   tL2C_CCB* p_free_ccb_last;  /* Pointer to last  free CCB */
 
@@ -707,6 +715,7 @@ void l2c_acl_flush(uint16_t handle);
 tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
                             tBT_TRANSPORT transport);
 void l2cu_release_lcb(tL2C_LCB* p_lcb);
+void l2cu_set_lcb_bd_addr(tL2C_LCB* p_lcb, const RawAddress& bd_addr);
 tL2C_LCB* l2cu_find_lcb_by_bd_addr(const RawAddress& p_bd_addr,
                                    tBT_TRANSPORT transport);
 tL2C_LCB* l2cu_find_lcb_by_handle(uint16_t handle);
@@ -886,6 +895,8 @@ void l2cble_process_subrate_change_evt(uint16_t handle, uint8_t status,
                                        uint16_t peripheral_latency,
                                        uint16_t cont_num, uint16_t timeout);
 
+void l2cble_rebalance_conn_intervals(void);
+
 namespace fmt {
 template <>
 struct formatter<tL2C_LINK_STATE> : enum_formatter<tL2C_LINK_STATE> {};
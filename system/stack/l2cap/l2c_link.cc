@@ -33,6 +33,7 @@
 #include "device/include/device_iot_config.h"
 #include "internal_include/bt_target.h"
 #include "os/log.h"
+#include "os/trace.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/acl_api.h"
@@ -404,6 +405,9 @@ bool l2c_link_hci_disc_comp(uint16_t handle, tHCI_REASON reason) {
 
     /* Release the LCB */
     if (lcb_is_free) l2cu_release_lcb(p_lcb);
+
+    /* the remaining central LE links may be harmonized differently */
+    if (p_lcb->transport == BT_TRANSPORT_LE) l2cble_rebalance_conn_intervals();
   }
 
   /* Now that we have a free acl connection, see if any lcbs are pending */
@@ -834,6 +838,7 @@ static bool l2c_link_check_power_mode(tL2C_LCB* p_lcb) {
  ******************************************************************************/
 void l2c_link_check_send_pkts(tL2C_LCB* p_lcb, uint16_t local_cid,
                               BT_HDR* p_buf) {
+  BT_TRACE_SCOPE("l2c_link_check_send_pkts");
   bool single_write = false;
 
   /* Save the channel ID for faster counting */
@@ -1168,97 +1173,74 @@ void l2cble_update_sec_act(const RawAddress& bd_addr, uint16_t sec_act) {
 
 /******************************************************************************
  *
- * Function         l2cu_get_next_channel_in_rr
+ * Function         l2cu_get_channel_run_state
  *
- * Description      get the next channel to send on a link. It also adjusts the
- *                  CCB queue to do a basic priority and round-robin scheduling.
+ * Description      check whether a channel of the run queue can send now.
  *
- * Returns          pointer to CCB or NULL
+ * Returns          L2C_RUN_READY if it can, L2C_RUN_BLOCKED if its data is
+ *                  held back, L2C_RUN_IDLE if it has nothing to send
  *
  ******************************************************************************/
-tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
-  tL2C_CCB* p_serve_ccb = NULL;
-  tL2C_CCB* p_ccb;
-
-  int i, j;
-
-  /* scan all of priority until finding a channel to serve */
-  for (i = 0; (i < L2CAP_NUM_CHNL_PRIORITY) && (!p_serve_ccb); i++) {
-    /* scan all channel within serving priority group until finding a channel to
-     * serve */
-    for (j = 0; (j < p_lcb->rr_serv[p_lcb->rr_pri].num_ccb) && (!p_serve_ccb);
-         j++) {
-      /* scaning from next serving channel */
-      p_ccb = p_lcb->rr_serv[p_lcb->rr_pri].p_serve_ccb;
-
-      if (!p_ccb) {
-        log::error("p_serve_ccb is NULL, rr_pri={}", p_lcb->rr_pri);
-        return NULL;
-      }
+static tL2C_RUN_STATE l2cu_get_channel_run_state(tL2C_RUN_NODE* p_node) {
+  tL2C_CCB* p_ccb = static_cast<tL2C_CCB*>(p_node->p_owner);
 
-      log::verbose("RR scan pri={}, lcid=0x{:04x}, q_cout={}",
-                   p_ccb->ccb_priority, p_ccb->local_cid,
-                   fixed_queue_length(p_ccb->xmit_hold_q));
-
-      /* store the next serving channel */
-      /* this channel is the last channel of its priority group */
-      if ((p_ccb->p_next_ccb == NULL) ||
-          (p_ccb->p_next_ccb->ccb_priority != p_ccb->ccb_priority)) {
-        /* next serving channel is set to the first channel in the group */
-        p_lcb->rr_serv[p_lcb->rr_pri].p_serve_ccb =
-            p_lcb->rr_serv[p_lcb->rr_pri].p_first_ccb;
-      } else {
-        /* next serving channel is set to the next channel in the group */
-        p_lcb->rr_serv[p_lcb->rr_pri].p_serve_ccb = p_ccb->p_next_ccb;
-      }
+  log::verbose("RR scan pri={}, lcid=0x{:04x}, q_cout={}", p_ccb->ccb_priority,
+               p_ccb->local_cid, fixed_queue_length(p_ccb->xmit_hold_q));
 
-      if (p_ccb->chnl_state != CST_OPEN) continue;
-
-      if (p_ccb->p_lcb->transport == BT_TRANSPORT_LE) {
-        log::debug("Connection oriented channel");
-        if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
+  if (p_ccb->p_lcb->transport == BT_TRANSPORT_LE) {
+    if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) return L2C_RUN_IDLE;
+    if (p_ccb->chnl_state != CST_OPEN) return L2C_RUN_BLOCKED;
 
-      } else {
-        /* eL2CAP option in use */
-        if (p_ccb->peer_cfg.fcr.mode != L2CAP_FCR_BASIC_MODE) {
-          if (p_ccb->fcrb.wait_ack || p_ccb->fcrb.remote_busy) continue;
+    /* Check credits, other channels of the link may still have some */
+    if (p_ccb->peer_conn_cfg.credits == 0) return L2C_RUN_BLOCKED;
 
-          if (fixed_queue_is_empty(p_ccb->fcrb.retrans_q)) {
-            if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
+    return L2C_RUN_READY;
+  }
 
-            /* If in eRTM mode, check for window closure */
-            if ((p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) &&
-                (l2c_fcr_is_flow_controlled(p_ccb)))
-              continue;
-          }
-        } else {
-          if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) continue;
-        }
-      }
+  /* eL2CAP option in use */
+  if (p_ccb->peer_cfg.fcr.mode != L2CAP_FCR_BASIC_MODE) {
+    if (fixed_queue_is_empty(p_ccb->fcrb.retrans_q) &&
+        fixed_queue_is_empty(p_ccb->xmit_hold_q))
+      return L2C_RUN_IDLE;
+    if (p_ccb->chnl_state != CST_OPEN) return L2C_RUN_BLOCKED;
+    if (p_ccb->fcrb.wait_ack || p_ccb->fcrb.remote_busy) return L2C_RUN_BLOCKED;
+
+    /* If in eRTM mode, check for window closure */
+    if (fixed_queue_is_empty(p_ccb->fcrb.retrans_q) &&
+        (p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) &&
+        (l2c_fcr_is_flow_controlled(p_ccb)))
+      return L2C_RUN_BLOCKED;
+
+    return L2C_RUN_READY;
+  }
 
-      /* found a channel to serve */
-      p_serve_ccb = p_ccb;
-      /* decrease quota of its priority group */
-      p_lcb->rr_serv[p_lcb->rr_pri].quota--;
-    }
+  if (fixed_queue_is_empty(p_ccb->xmit_hold_q)) return L2C_RUN_IDLE;
+  if (p_ccb->chnl_state != CST_OPEN) return L2C_RUN_BLOCKED;
 
-    /* if there is no more quota of the priority group or no channel to have
-     * data to send */
-    if ((p_lcb->rr_serv[p_lcb->rr_pri].quota == 0) || (!p_serve_ccb)) {
-      /* serve next priority group */
-      p_lcb->rr_pri = (p_lcb->rr_pri + 1) % L2CAP_NUM_CHNL_PRIORITY;
-      /* initialize its quota */
-      p_lcb->rr_serv[p_lcb->rr_pri].quota =
-          L2CAP_GET_PRIORITY_QUOTA(p_lcb->rr_pri);
-    }
-  }
+  return L2C_RUN_READY;
+}
 
-  if (p_serve_ccb) {
-    log::verbose("RR service pri={}, quota={}, lcid=0x{:04x}",
-                 p_serve_ccb->ccb_priority,
-                 p_lcb->rr_serv[p_serve_ccb->ccb_priority].quota,
-                 p_serve_ccb->local_cid);
-  }
+/******************************************************************************
+ *
+ * Function         l2cu_get_next_channel_in_rr
+ *
+ * Description      get the next channel to send on a link. Only the channels
+ *                  with data to send are in the run queue of the link, which
+ *                  does a basic priority and round-robin scheduling.
+ *
+ * Returns          pointer to CCB or NULL
+ *
+ ******************************************************************************/
+tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb) {
+  tL2C_RUN_NODE* p_node =
+      l2c_run_queue_select(&p_lcb->run_queue, l2cu_get_channel_run_state);
+  if (p_node == NULL) return NULL;
+
+  tL2C_CCB* p_serve_ccb = static_cast<tL2C_CCB*>(p_node->p_owner);
+  log::verbose("RR service pri={}, quota={}, lcid=0x{:04x}",
+               p_serve_ccb->ccb_priority,
+               p_lcb->run_queue.group[p_serve_ccb->ccb_priority].quota,
+               p_serve_ccb->local_cid);
 
   return p_serve_ccb;
 }
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include "stack/l2cap/l2c_run_queue.h"
+
+namespace {
+
+void l2c_run_group_append(tL2C_RUN_GROUP* p_group, tL2C_RUN_NODE* p_node) {
+  p_node->p_next = nullptr;
+  p_node->p_prev = p_group->p_last;
+  if (p_group->p_last != nullptr) {
+    p_group->p_last->p_next = p_node;
+  } else {
+    p_group->p_first = p_node;
+  }
+  p_group->p_last = p_node;
+}
+
+void l2c_run_group_unlink(tL2C_RUN_GROUP* p_group, tL2C_RUN_NODE* p_node) {
+  if (p_node->p_prev != nullptr) {
+    p_node->p_prev->p_next = p_node->p_next;
+  } else {
+    p_group->p_first = p_node->p_next;
+  }
+  if (p_node->p_next != nullptr) {
+    p_node->p_next->p_prev = p_node->p_prev;
+  } else {
+    p_group->p_last = p_node->p_prev;
+  }
+  p_node->p_next = p_node->p_prev = nullptr;
+}
+
+/* Moves the head of the group to its end, the next channel is served first */
+void l2c_run_group_rotate(tL2C_RUN_GROUP* p_group) {
+  tL2C_RUN_NODE* p_node = p_group->p_first;
+  if (p_node == nullptr || p_node == p_group->p_last) return;
+  l2c_run_group_unlink(p_group, p_node);
+  l2c_run_group_append(p_group, p_node);
+}
+
+}  // namespace
+
+void l2c_run_queue_init(tL2C_RUN_QUEUE* p_queue) {
+  *p_queue = {};
+  for (uint8_t pri = 0; pri < L2CAP_NUM_CHNL_PRIORITY; pri++) {
+    p_queue->group[pri].quota = L2CAP_GET_PRIORITY_QUOTA(pri);
+  }
+}
+
+void l2c_run_queue_activate(tL2C_RUN_QUEUE* p_queue, tL2C_RUN_NODE* p_node,
+                            uint8_t priority) {
+  if (priority >= L2CAP_NUM_CHNL_PRIORITY) {
+    priority = L2CAP_NUM_CHNL_PRIORITY - 1;
+  }
+
+  if (!p_node->active) {
+    l2c_run_group_append(&p_queue->group[priority], p_node);
+    p_queue->group[priority].num_active++;
+    p_node->priority = priority;
+    p_node->active = true;
+  }
+
+  /* if new data is higher priority than serving group and it is not overrun */
+  if ((p_queue->serve_pri > p_node->priority) &&
+      (p_queue->group[p_node->priority].quota > 0)) {
+    p_queue->serve_pri = p_node->priority;
+  }
+}
+
+void l2c_run_queue_deactivate(tL2C_RUN_QUEUE* p_queue, tL2C_RUN_NODE* p_node) {
+  if (!p_node->active) return;
+
+  tL2C_RUN_GROUP* p_group = &p_queue->group[p_node->priority];
+  l2c_run_group_unlink(p_group, p_node);
+  p_group->num_active--;
+  p_node->active = false;
+}
+
+tL2C_RUN_NODE* l2c_run_queue_select(tL2C_RUN_QUEUE* p_queue,
+                                    tL2C_RUN_CHECK_CB p_check) {
+  tL2C_RUN_NODE* p_serve = nullptr;
+
+  /* scan the priority groups until finding a channel to serve */
+  for (int i = 0; (i < L2CAP_NUM_CHNL_PRIORITY) && (p_serve == nullptr); i++) {
+    tL2C_RUN_GROUP* p_group = &p_queue->group[p_queue->serve_pri];
+
+    /* each queued channel is checked at most once per group */
+    uint16_t num_checks = p_group->num_active;
+    while ((num_checks-- > 0) && (p_serve == nullptr)) {
+      tL2C_RUN_NODE* p_node = p_group->p_first;
+      switch (p_check(p_node)) {
+        case L2C_RUN_IDLE:
+          l2c_run_queue_deactivate(p_queue, p_node);
+          break;
+        case L2C_RUN_BLOCKED:
+          l2c_run_group_rotate(p_group);
+          break;
+        case L2C_RUN_READY:
+          l2c_run_group_rotate(p_group);
+          p_serve = p_node;
+          /* decrease quota of its priority group */
+          p_group->quota--;
+          break;
+      }
+    }
+
+    /* if there is no more quota of the priority group or no channel to have
+     * data to send */
+    if ((p_group->quota == 0) || (p_serve == nullptr)) {
+      /* serve next priority group */
+      p_queue->serve_pri = (p_queue->serve_pri + 1) % L2CAP_NUM_CHNL_PRIORITY;
+      /* initialize its quota */
+      p_queue->group[p_queue->serve_pri].quota =
+          L2CAP_GET_PRIORITY_QUOTA(p_queue->serve_pri);
+    }
+  }
+
+  return p_serve;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/* Round-Robin service for the same priority channels */
+#define L2CAP_NUM_CHNL_PRIORITY \
+  3 /* Total number of priority group (high, medium, low)*/
+#define L2CAP_CHNL_PRIORITY_WEIGHT \
+  5 /* weight per priority for burst transmission quota */
+#define L2CAP_GET_PRIORITY_QUOTA(pri) \
+  ((L2CAP_NUM_CHNL_PRIORITY - (pri)) * L2CAP_CHNL_PRIORITY_WEIGHT)
+
+/* Entry of a channel in the run queue of its link */
+typedef struct t_l2c_run_node {
+  struct t_l2c_run_node* p_next;
+  struct t_l2c_run_node* p_prev;
+  void* p_owner;    /* channel control block of the entry */
+  uint8_t priority; /* priority group the entry is queued in */
+  bool active;      /* entry is queued */
+} tL2C_RUN_NODE;
+
+typedef struct {
+  tL2C_RUN_NODE* p_first; /* next channel to serve in the group */
+  tL2C_RUN_NODE* p_last;
+  uint16_t num_active; /* number of channels queued in the group */
+  uint8_t quota;       /* remaining burst transmission quota */
+} tL2C_RUN_GROUP;
+
+/* Channels of a link that have data to send, one ring per priority group.
+ *
+ * A channel joins the ring of its priority when data is queued on it and
+ * leaves it when it is found with nothing left to send, so the scheduler
+ * only looks at the backlogged channels of the link instead of all of them.
+ * Each group is served for up to L2CAP_GET_PRIORITY_QUOTA packets before the
+ * next group gets its turn, which keeps the low priority channels (for
+ * example, HF signaling on RFCOMM) going while a higher priority one (for
+ * example, AV media) is busy. */
+typedef struct {
+  tL2C_RUN_GROUP group[L2CAP_NUM_CHNL_PRIORITY];
+  uint8_t serve_pri; /* current serving priority group */
+} tL2C_RUN_QUEUE;
+
+typedef enum : uint8_t {
+  L2C_RUN_IDLE,    /* nothing to send, the channel leaves the queue */
+  L2C_RUN_BLOCKED, /* data is waiting for credits, acks or the window */
+  L2C_RUN_READY,   /* the channel can send now */
+} tL2C_RUN_STATE;
+
+typedef tL2C_RUN_STATE (*tL2C_RUN_CHECK_CB)(tL2C_RUN_NODE* p_node);
+
+/* Resets |p_queue| with all its groups holding their full quota */
+void l2c_run_queue_init(tL2C_RUN_QUEUE* p_queue);
+
+/* Queues |p_node| at the end of the group of |priority| if it is not queued
+ * yet. The group becomes the serving one if it has a higher priority than the
+ * current one and quota left. */
+void l2c_run_queue_activate(tL2C_RUN_QUEUE* p_queue, tL2C_RUN_NODE* p_node,
+                            uint8_t priority);
+
+/* Removes |p_node| from the queue if it is queued */
+void l2c_run_queue_deactivate(tL2C_RUN_QUEUE* p_queue, tL2C_RUN_NODE* p_node);
+
+/* Returns the next channel to serve, or nullptr if no queued channel is
+ * ready. |p_check| gives the state of the channels met on the way: idle ones
+ * are removed and blocked ones are moved to the end of their group. The
+ * selection takes a single check when the channel at the head of the serving
+ * group is ready. */
+tL2C_RUN_NODE* l2c_run_queue_select(tL2C_RUN_QUEUE* p_queue,
+                                    tL2C_RUN_CHECK_CB p_check);
@@ -22,6 +22,7 @@
  *
  ******************************************************************************/
 #define LOG_TAG "l2c_utils"
+#define OSI_ALLOC_TAG "l2cap"
 
 #include <bluetooth/log.h>
 #include <string.h>
@@ -50,6 +51,29 @@ using namespace bluetooth;
 
 tL2C_CCB* l2cu_get_next_channel_in_rr(tL2C_LCB* p_lcb); // TODO Move
 
+/* Returns the bucket of |bd_addr| in the LCB address hash */
+static uint8_t l2cu_lcb_addr_hash(const RawAddress& bd_addr) {
+  uint8_t hash = 0;
+  for (uint8_t octet : bd_addr.address) hash = hash * 31 + octet;
+  return hash & (L2C_LCB_ADDR_HASH_SIZE - 1);
+}
+
+/* Removes |p_lcb| from the bucket of its address, if it is there */
+static void l2cu_unlink_lcb_by_addr(tL2C_LCB* p_lcb) {
+  uint8_t index = (uint8_t)(p_lcb - l2cb.lcb_pool) + 1;
+  uint8_t bucket = l2cu_lcb_addr_hash(p_lcb->remote_bd_addr);
+  uint8_t* p_next = &l2cb.lcb_by_addr[bucket];
+
+  while (*p_next != 0) {
+    if (*p_next == index) {
+      *p_next = p_lcb->next_by_addr;
+      break;
+    }
+    p_next = &l2cb.lcb_pool[*p_next - 1].next_by_addr;
+  }
+  p_lcb->next_by_addr = 0;
+}
+
 /*******************************************************************************
  *
  * Function         l2cu_allocate_lcb
@@ -68,9 +92,10 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
     if (!p_lcb->in_use) {
       alarm_free(p_lcb->l2c_lcb_timer);
       alarm_free(p_lcb->info_resp_timer);
+      l2cu_unlink_lcb_by_addr(p_lcb);
       memset(p_lcb, 0, sizeof(tL2C_LCB));
 
-      p_lcb->remote_bd_addr = p_bd_addr;
+      l2cu_set_lcb_bd_addr(p_lcb, p_bd_addr);
 
       p_lcb->in_use = true;
       p_lcb->with_active_local_clients = false;
@@ -89,6 +114,7 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
       p_lcb->tx_data_len =
           bluetooth::shim::GetController()->GetLeSuggestedDefaultDataLength();
       p_lcb->le_sec_pending_q = fixed_queue_new(SIZE_MAX);
+      l2c_run_queue_init(&p_lcb->run_queue);
 
       if (transport == BT_TRANSPORT_LE) {
         l2cb.num_ble_links_active++;
@@ -112,6 +138,27 @@ void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle) {
               p_lcb.Handle(), handle);
   }
   p_lcb.SetHandle(handle);
+  l2cb.lcb_by_handle[handle & (L2C_LCB_HANDLE_TABLE_SIZE - 1)] =
+      (uint8_t)(&p_lcb - l2cb.lcb_pool) + 1;
+}
+
+/*******************************************************************************
+ *
+ * Function         l2cu_set_lcb_bd_addr
+ *
+ * Description      Set the remote BD address of an LCB and move the LCB to
+ *                  the bucket of that address.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void l2cu_set_lcb_bd_addr(tL2C_LCB* p_lcb, const RawAddress& bd_addr) {
+  l2cu_unlink_lcb_by_addr(p_lcb);
+  p_lcb->remote_bd_addr = bd_addr;
+
+  uint8_t* p_head = &l2cb.lcb_by_addr[l2cu_lcb_addr_hash(bd_addr)];
+  p_lcb->next_by_addr = *p_head;
+  *p_head = (uint8_t)(p_lcb - l2cb.lcb_pool) + 1;
 }
 
 /*******************************************************************************
@@ -151,6 +198,7 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   tL2C_CCB* p_ccb;
 
   p_lcb->in_use = false;
+  l2cu_unlink_lcb_by_addr(p_lcb);
   p_lcb->ResetBonding();
 
   /* Stop and free timers */
@@ -230,22 +278,23 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
  *
  * Function         l2cu_find_lcb_by_bd_addr
  *
- * Description      Look through all active LCBs for a match based on the
- *                  remote BD address.
+ * Description      Look through the active LCBs in the address bucket for a
+ *                  match based on the remote BD address.
  *
  * Returns          pointer to matched LCB, or NULL if no match
  *
  ******************************************************************************/
 tL2C_LCB* l2cu_find_lcb_by_bd_addr(const RawAddress& p_bd_addr,
                                    tBT_TRANSPORT transport) {
-  int xx;
-  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  uint8_t index = l2cb.lcb_by_addr[l2cu_lcb_addr_hash(p_bd_addr)];
 
-  for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
+  while (index != 0) {
+    tL2C_LCB* p_lcb = &l2cb.lcb_pool[index - 1];
     if ((p_lcb->in_use) && p_lcb->transport == transport &&
         (p_lcb->remote_bd_addr == p_bd_addr)) {
       return (p_lcb);
     }
+    index = p_lcb->next_by_addr;
   }
 
   /* If here, no match found */
@@ -1206,22 +1255,6 @@ void l2cu_enqueue_ccb(tL2C_CCB* p_ccb) {
       p_q->p_last_ccb = p_ccb;
     }
   }
-
-  /* Adding CCB into round robin service table of its LCB */
-  if (p_ccb->p_lcb != NULL) {
-    /* if this is the first channel in this priority group */
-    if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb == 0) {
-      /* Set the first channel to this CCB */
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = p_ccb;
-      /* Set the next serving channel in this group to this CCB */
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = p_ccb;
-      /* Initialize quota of this priority group based on its priority */
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].quota =
-          L2CAP_GET_PRIORITY_QUOTA(p_ccb->ccb_priority);
-    }
-    /* increase number of channels in this group */
-    p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb++;
-  }
 }
 
 /******************************************************************************
@@ -1251,29 +1284,8 @@ void l2cu_dequeue_ccb(tL2C_CCB* p_ccb) {
     return;
   }
 
-  /* Removing CCB from round robin service table of its LCB */
-  if (p_ccb->p_lcb != NULL) {
-    /* decrease number of channels in this priority group */
-    p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb--;
-
-    /* if it was the last channel in the priority group */
-    if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb == 0) {
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = NULL;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = NULL;
-    } else {
-      /* if it is the first channel of this group */
-      if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb == p_ccb) {
-        p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb =
-            p_ccb->p_next_ccb;
-      }
-      /* if it is the next serving channel of this group */
-      if (p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb == p_ccb) {
-        /* simply, start serving from the first channel */
-        p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb =
-            p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb;
-      }
-    }
-  }
+  /* Removing CCB from the run queue of its LCB */
+  l2c_run_queue_deactivate(&p_ccb->p_lcb->run_queue, &p_ccb->run_node);
 
   if (p_ccb == p_q->p_first_ccb) {
     /* We are removing the first in a queue */
@@ -1307,6 +1319,8 @@ void l2cu_dequeue_ccb(tL2C_CCB* p_ccb) {
  ******************************************************************************/
 void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
   if (p_ccb->ccb_priority != priority) {
+    bool has_pending_data = p_ccb->run_node.active;
+
     /* If CCB is not the only guy on the queue */
     if ((p_ccb->p_next_ccb != NULL) || (p_ccb->p_prev_ccb != NULL)) {
       log::verbose("Update CCB list in logical link");
@@ -1319,18 +1333,16 @@ void l2cu_change_pri_ccb(tL2C_CCB* p_ccb, tL2CAP_CHNL_PRIORITY priority) {
     }
     else {
       /* If CCB is the only guy on the queue, no need to re-enqueue */
-      /* update only round robin service data */
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb = 0;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = NULL;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = NULL;
+      /* update only the run queue */
+      l2c_run_queue_deactivate(&p_ccb->p_lcb->run_queue, &p_ccb->run_node);
 
       p_ccb->ccb_priority = priority;
+    }
 
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_first_ccb = p_ccb;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].p_serve_ccb = p_ccb;
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].quota =
-          L2CAP_GET_PRIORITY_QUOTA(p_ccb->ccb_priority);
-      p_ccb->p_lcb->rr_serv[p_ccb->ccb_priority].num_ccb = 1;
+    /* Pending data is served in the group of the new priority */
+    if (has_pending_data) {
+      l2c_run_queue_activate(&p_ccb->p_lcb->run_queue, &p_ccb->run_node,
+                             p_ccb->ccb_priority);
     }
   }
 }
@@ -1396,6 +1408,8 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid, bool is_eatt) {
 
   /* Set priority then insert ccb into LCB queue (if we have an LCB) */
   p_ccb->ccb_priority = L2CAP_CHNL_PRIORITY_LOW;
+  p_ccb->run_node = {};
+  p_ccb->run_node.p_owner = p_ccb;
 
   if (p_lcb) l2cu_enqueue_ccb(p_ccb);
 
@@ -3383,16 +3397,27 @@ void l2cu_send_peer_ble_credit_based_disconn_req(tL2C_CCB* p_ccb) {
  *
  * Function         l2cu_find_lcb_by_handle
  *
- * Description      Look through all active LCBs for a match based on the
- *                  HCI handle.
+ * Description      Look up the LCB of an HCI handle in the handle table, or
+ *                  through all active LCBs if the table has no match.
  *
  * Returns          pointer to matched LCB, or NULL if no match
  *
  ******************************************************************************/
 tL2C_LCB* l2cu_find_lcb_by_handle(uint16_t handle) {
   int xx;
-  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  tL2C_LCB* p_lcb;
+
+  /* The table holds the last LCB given the handle */
+  uint8_t index = l2cb.lcb_by_handle[handle & (L2C_LCB_HANDLE_TABLE_SIZE - 1)];
+  if (index != 0) {
+    p_lcb = &l2cb.lcb_pool[index - 1];
+    if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
+      return (p_lcb);
+    }
+  }
 
+  /* Handles beyond 12 bits share entries, look through all LCBs */
+  p_lcb = &l2cb.lcb_pool[0];
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
     if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
       return (p_lcb);
@@ -21,7 +21,6 @@
 #include <dbus/bus.h>
 #include <dbus/message.h>
 #include <dbus/object_proxy.h>
-#include <poll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -222,30 +221,15 @@ int CodecClient::transcode(uint8_t* i_buf, int i_len, uint8_t* o_buf,
     return -EIO;
   }
 
-  struct pollfd pfd;
-  pfd.fd = skt_fd_;
-  pfd.events = POLLIN;
-
-  int pollret = poll(&pfd, 1, -1);
-  if (pollret < 0) {
-    log::error("Failed to poll: {}", strerror(errno));
-    return -errno;
-  }
-
-  if (pfd.revents & (POLLHUP | POLLNVAL)) {
-    log::error("Socket closed remotely.");
-    return -EIO;
-  }
-
-  // POLLIN is returned..
+  // Blocking recv, waits for the transcoded data without a separate poll.
   rc = recv(skt_fd_, o_buf, o_len, MSG_NOSIGNAL);
   if (rc < 0) {
     log::error("Failed to recv data: {}", strerror(errno));
     return -errno;
   }
-  // Should be able to recv data when POLLIN is returned.
+  // Empty packets are never sent, 0 means the socket is closed.
   if (rc == 0) {
-    log::error("Failed to recv data");
+    log::error("Socket closed remotely.");
     return -EIO;
   }
 
@@ -22,7 +22,6 @@
 #include <base/task/single_thread_task_runner.h>
 #include <base/unguessable_token.h>
 #include <bluetooth/log.h>
-#include <poll.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
@@ -67,27 +66,16 @@ void StartSocketListener(int fd, struct sockaddr_un addr,
   std::array<uint8_t, kMaximumBufferSize> i_buf = {};
   std::array<uint8_t, kMaximumBufferSize> o_buf = {};
 
-  struct pollfd pfd;
-  pfd.fd = client_fd;
-  pfd.events = POLLIN;
-
   while (1) {
-    // Blocking poll.
-    int poll_ret = poll(&pfd, 1, -1);
-    if (poll_ret <= 0) {
-      log::error("Poll failed: {}", strerror(errno));
-      break;
-    }
-
-    // Ignore remaining data in the closed socket.
-    if (pfd.revents & (POLLHUP | POLLNVAL)) {
+    // Blocking recv, waits for the next frame without a separate poll.
+    int i_data_len =
+        recv(client_fd, i_buf.data(), kMaximumBufferSize, MSG_NOSIGNAL);
+    // Empty packets are never sent, 0 means the socket is closed.
+    if (i_data_len == 0) {
       log::info("Socket disconnected");
       break;
     }
-
-    int i_data_len =
-        recv(client_fd, i_buf.data(), kMaximumBufferSize, MSG_NOSIGNAL);
-    if (i_data_len <= 0) {
+    if (i_data_len < 0) {
       log::error("Failed to recv data: {}", strerror(errno));
       break;
     }
@@ -105,7 +93,6 @@ void StartSocketListener(int fd, struct sockaddr_un addr,
       log::error("Failed to send data: {}", strerror(errno));
       break;
     }
-    o_buf.fill(0);
   }
   close(client_fd);
   unlink(addr.sun_path);
@@ -16,6 +16,8 @@
 
 #include "mmc/metrics/mmc_rtt_logger.h"
 
+#include <bluetooth/log.h>
+
 #include <algorithm>
 #include <cmath>
 #include <string>
@@ -25,7 +27,11 @@
 namespace mmc {
 
 MmcRttLogger::MmcRttLogger(int codec_type)
-    : codec_type_(codec_type), num_requests_(0), rtt_sum_(0), maximum_rtt_(0) {}
+    : codec_type_(codec_type),
+      num_requests_(0),
+      rtt_sum_(0),
+      maximum_rtt_(0),
+      rtt_histogram_({}) {}
 
 MmcRttLogger::~MmcRttLogger() {}
 
@@ -34,16 +40,38 @@ void MmcRttLogger::RecordRtt(int64_t elapsed_time) {
   num_requests_ += 1;
   rtt_sum_ += elapsed_time;
   maximum_rtt_ = std::max(maximum_rtt_, elapsed_time);
+  size_t bucket = std::min<int64_t>(elapsed_time / kBucketWidth,
+                                    kNumBuckets - 1);
+  rtt_histogram_[bucket] += 1;
   return;
 }
 
+int64_t MmcRttLogger::Percentile(int percentile) const {
+  // Rank of the rtt, rounded up.
+  int64_t rank = (num_requests_ * percentile + 99) / 100;
+  int64_t count = 0;
+  for (size_t bucket = 0; bucket < kNumBuckets - 1; bucket++) {
+    count += rtt_histogram_[bucket];
+    if (count >= rank) {
+      return std::min<int64_t>((bucket + 1) * kBucketWidth, maximum_rtt_);
+    }
+  }
+  return maximum_rtt_;
+}
+
 void MmcRttLogger::UploadTranscodeRttStatics() {
   if (num_requests_ == 0) return;
   log_mmc_transcode_rtt_stats(maximum_rtt_, rtt_sum_ / num_requests_,
                               num_requests_, codec_type_);
+  bluetooth::log::info(
+      "codec_type={} num_requests={} rtt_us: mean={} p50={} p90={} p99={} "
+      "max={}",
+      codec_type_, num_requests_, rtt_sum_ / num_requests_, Percentile(50),
+      Percentile(90), Percentile(99), maximum_rtt_);
   num_requests_ = 0;
   rtt_sum_ = 0;
   maximum_rtt_ = 0;
+  rtt_histogram_.fill(0);
   return;
 }
 
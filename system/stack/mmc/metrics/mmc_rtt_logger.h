@@ -17,6 +17,7 @@
 #ifndef MMC_METRICS_MMC_RTT_LOGGER_H_
 #define MMC_METRICS_MMC_RTT_LOGGER_H_
 
+#include <array>
 #include <cstdint>
 #include <string>
 
@@ -24,6 +25,8 @@ namespace mmc {
 
 // MmcRttLogger computes and uploads below rtt stats:
 //   Maximum rtt, mean rtt, num requests, codec type.
+// It also logs the 50th, 90th and 99th percentile rtt, computed from a
+// histogram of the recorded rtts.
 class MmcRttLogger {
  public:
   explicit MmcRttLogger(int codec_type);
@@ -42,10 +45,19 @@ class MmcRttLogger {
   void UploadTranscodeRttStatics();
 
  private:
+  // Histogram buckets are |kBucketWidth| microseconds wide, rtts longer than
+  // the histogram range are counted in the last bucket.
+  static constexpr int64_t kBucketWidth = 100;
+  static constexpr size_t kNumBuckets = 200;
+
+  // Returns the upper bound of the bucket holding the |percentile|th rtt.
+  int64_t Percentile(int percentile) const;
+
   int codec_type_;
   int64_t num_requests_;
   double rtt_sum_;  // for computing mean rtt
   int64_t maximum_rtt_;
+  std::array<int64_t, kNumBuckets> rtt_histogram_;
 };
 
 }  // namespace mmc
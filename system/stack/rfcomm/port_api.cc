@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "bt_port_api"
+#define OSI_ALLOC_TAG "rfcomm"
 
 #include "stack/include/port_api.h"
 
@@ -30,6 +31,7 @@
 #include <bluetooth/log.h>
 
 #include <cstdint>
+#include <cstdio>
 
 #include "internal_include/bt_target.h"
 #include "internal_include/bt_trace.h"
@@ -689,7 +691,6 @@ int PORT_FlowControl_MaxCredit(uint16_t handle, bool enable) {
  ******************************************************************************/
 int PORT_ReadData(uint16_t handle, char* p_data, uint16_t max_len,
                   uint16_t* p_len) {
-  BT_HDR* p_buf;
   uint16_t count;
 
   log::verbose("PORT_ReadData() handle:{} max_len:{}", handle, max_len);
@@ -715,52 +716,16 @@ int PORT_ReadData(uint16_t handle, char* p_data, uint16_t max_len,
     return (PORT_LINE_ERR);
   }
 
-  if (fixed_queue_is_empty(p_port->rx.queue)) {
+  if (p_port->rx_frame_count == 0) {
     log::warn("Read on empty input queue");
     return (PORT_SUCCESS);
   }
 
-  count = 0;
-
-  while (max_len) {
-    p_buf = (BT_HDR*)fixed_queue_try_peek_first(p_port->rx.queue);
-    if (p_buf == NULL) break;
-
-    if (p_buf->len > max_len) {
-      memcpy(p_data, (uint8_t*)(p_buf + 1) + p_buf->offset, max_len);
-      p_buf->offset += max_len;
-      p_buf->len -= max_len;
-
-      *p_len += max_len;
-
-      mutex_global_lock();
-
-      p_port->rx.queue_size -= max_len;
-
-      mutex_global_unlock();
-
-      break;
-    } else {
-      memcpy(p_data, (uint8_t*)(p_buf + 1) + p_buf->offset, p_buf->len);
-
-      *p_len += p_buf->len;
-      max_len -= p_buf->len;
-
-      mutex_global_lock();
-
-      p_port->rx.queue_size -= p_buf->len;
-
-      if (max_len) {
-        p_data += p_buf->len;
-      }
-
-      osi_free(fixed_queue_try_dequeue(p_port->rx.queue));
+  mutex_global_lock();
 
-      mutex_global_unlock();
+  *p_len = port_rx_read(p_port, (uint8_t*)p_data, max_len, &count);
 
-      count++;
-    }
-  }
+  mutex_global_unlock();
 
   if (*p_len == 1) {
     log::verbose("PORT_ReadData queue:{} returned:{} {:x}",
@@ -1155,3 +1120,39 @@ int PORT_GetSecurityMask(uint16_t handle, uint16_t* sec_mask) {
   *sec_mask = p_port->sec_mask;
   return (PORT_SUCCESS);
 }
+
+/*******************************************************************************
+ *
+ * Function         PORT_Dumpsys
+ *
+ * Description      This function provides dumpsys data during the dumpsys
+ *                  procedure.
+ *
+ ******************************************************************************/
+void PORT_Dumpsys(int fd) {
+  dprintf(fd, "\nRFCOMM ports:\n");
+  for (int i = 0; i < MAX_RFC_PORTS; i++) {
+    const tPORT& port = rfc_cb.port.port[i];
+    if (!port.in_use || port.state == PORT_CONNECTION_STATE_CLOSED) continue;
+
+    dprintf(fd, "  handle:%u peer:%s dlci:%u scn:%u mtu:%u peer_mtu:%u\n",
+            port.handle, ADDRESS_TO_LOGGABLE_CSTR(port.bd_addr), port.dlci,
+            port.scn, port.mtu, port.peer_mtu);
+    dprintf(fd, "    rx_bytes:%llu tx_bytes:%llu\n",
+            (unsigned long long)port.stats.rx_bytes,
+            (unsigned long long)port.stats.tx_bytes);
+    if (port.rfc.p_mcb == nullptr || port.rfc.p_mcb->flow != PORT_FC_CREDIT)
+      continue;
+    dprintf(fd,
+            "    credit_tx:%u credit_rx:%u credit_rx_max:%u (base:%u limit:%u) "
+            "granted:%u\n",
+            port.credit_tx, port.credit_rx, port.credit_rx_max,
+            port.credit_rx_base, port.credit_rx_limit,
+            port.stats.credits_granted);
+    dprintf(fd,
+            "    rx_credit_starved:%u tx_credit_starved:%u window grown:%u "
+            "shrunk:%u\n",
+            port.stats.rx_credit_starved, port.stats.tx_credit_starved,
+            port.stats.credit_window_grown, port.stats.credit_window_shrunk);
+  }
+}
@@ -31,6 +31,7 @@
 #include "internal_include/bt_target.h"
 #include "osi/include/alarm.h"
 #include "osi/include/fixed_queue.h"
+#include "osi/include/ringbuffer.h"
 #include "stack/include/l2c_api.h"
 #include "stack/include/port_api.h"
 #include "stack/include/rfcdefs.h"
@@ -48,13 +49,26 @@
  * Define Port Data Transfere control block
 */
 typedef struct {
-  fixed_queue_t* queue; /* Queue of buffers waiting to be sent */
+  fixed_queue_t* queue; /* Queue of buffers waiting to be sent, tx only */
   bool peer_fc; /* true if flow control is set based on peer's request */
   bool user_fc; /* true if flow control is set based on user's request  */
   uint32_t queue_size;        /* Number of data bytes in the queue */
   tPORT_CALLBACK* p_callback; /* Address of the callback function */
 } tPORT_DATA;
 
+/*
+ * Per DLC data and credit based flow control counters
+*/
+typedef struct {
+  uint64_t rx_bytes;          /* Data bytes received from the peer */
+  uint64_t tx_bytes;          /* Data bytes sent to the peer */
+  uint32_t credits_granted;   /* Number of credits granted to the peer */
+  uint32_t rx_credit_starved; /* Times the peer used all its credits */
+  uint32_t tx_credit_starved; /* Times data waited for credits from the peer */
+  uint32_t credit_window_grown;  /* Times credit_rx_max was scaled up */
+  uint32_t credit_window_shrunk; /* Times credit_rx_max was scaled down */
+} tPORT_STATS;
+
 /*
  * Port control structure used to pass modem info
 */
@@ -208,6 +222,18 @@ typedef struct {
       credit_rx_max; /* Max number of credits we will allow this guy to sent */
   uint16_t credit_rx_low;   /* Number of credits when we send credit update */
   uint16_t rx_buf_critical; /* port receive queue critical watermark level */
+  uint16_t credit_rx_base;  /* credit_rx_max selected for the MTU */
+  uint16_t
+      credit_rx_limit; /* Max credit_rx_max when scaled up for a fast reader */
+  tPORT_STATS stats; /* Data and flow control counters */
+
+  /* Data received from the peer waiting for PORT_ReadData, allocated with the
+   * first frame queued. The frames lengths are kept to give back one credit
+   * per frame read. rx.queue_size is the number of bytes in the ring. */
+  ringbuffer_t* rx_ring;
+  uint16_t rx_frame_len[PORT_RX_BUF_CRITICAL_WM]; /* Bytes left per frame */
+  uint8_t rx_frame_first; /* Index of the first frame in rx_frame_len */
+  uint8_t rx_frame_count; /* Number of frames in rx_ring */
   bool keep_port_handle;    /* true if port is not deallocated when closing */
   /* it is set to true for server when allocating port */
   uint16_t keep_mtu; /* Max MTU that port can receive by server */
@@ -237,6 +263,11 @@ uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals,
                                  uint8_t signal);
 uint32_t port_flow_control_user(tPORT* p_port);
 void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count);
+void port_scale_credit_rx(tPORT* p_port, bool drained);
+bool port_rx_enqueue(tPORT* p_port, const BT_HDR* p_buf);
+uint16_t port_rx_read(tPORT* p_port, uint8_t* p_data, uint16_t max_len,
+                      uint16_t* p_frames);
+void port_rx_flush(tPORT* p_port);
 
 /*
  * Functions provided by the port_rfc.cc
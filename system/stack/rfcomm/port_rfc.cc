@@ -779,6 +779,10 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
     osi_free(p_buf);
     return;
   }
+  p_port->stats.rx_bytes += p_buf->len;
+  /* The peer used the last credit it was granted */
+  if (p_mcb->flow == PORT_FC_CREDIT && p_port->credit_rx <= 1)
+    p_port->stats.rx_credit_starved++;
   /* If client registered callout callback with flow control we can just deliver
    * receive data */
   if (p_port->p_data_co_callback) {
@@ -803,7 +807,7 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
   }
   /* Check if rx queue exceeds the limit */
   if ((p_port->rx.queue_size + p_buf->len > PORT_RX_CRITICAL_WM) ||
-      (fixed_queue_length(p_port->rx.queue) + 1 > p_port->rx_buf_critical)) {
+      (p_port->rx_frame_count + 1 > p_port->rx_buf_critical)) {
     log::verbose("PORT_DataInd. Buffer over run. Dropping the buffer");
     osi_free(p_buf);
     RFCOMM_LineStatusReq(p_mcb, dlci, LINE_STATUS_OVERRUN);
@@ -824,11 +828,17 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
 
   mutex_global_lock();
 
-  fixed_queue_enqueue(p_port->rx.queue, p_buf);
-  p_port->rx.queue_size += p_buf->len;
+  bool queued = port_rx_enqueue(p_port, p_buf);
 
   mutex_global_unlock();
 
+  osi_free(p_buf);
+  if (!queued) {
+    log::verbose("PORT_DataInd. Buffer over run. Dropping the buffer");
+    RFCOMM_LineStatusReq(p_mcb, dlci, LINE_STATUS_OVERRUN);
+    return;
+  }
+
   /* perform flow control procedures if necessary */
   port_flow_control_peer(p_port, false, 0);
 
@@ -26,6 +26,7 @@
 
 #include <bluetooth/log.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
@@ -117,6 +118,7 @@ void port_set_defaults(tPORT* p_port) {
 
   p_port->credit_tx = 0;
   p_port->credit_rx = 0;
+  memset(&p_port->stats, 0, sizeof(p_port->stats));
 
   memset(&p_port->local_ctrl, 0, sizeof(p_port->local_ctrl));
   memset(&p_port->peer_ctrl, 0, sizeof(p_port->peer_ctrl));
@@ -124,7 +126,7 @@ void port_set_defaults(tPORT* p_port) {
   memset(&p_port->tx, 0, sizeof(p_port->tx));
 
   p_port->tx.queue = fixed_queue_new(SIZE_MAX);
-  p_port->rx.queue = fixed_queue_new(SIZE_MAX);
+  port_rx_flush(p_port);
 }
 
 /*******************************************************************************
@@ -186,9 +188,145 @@ void port_select_mtu(tPORT* p_port) {
   p_port->rx_buf_critical = (PORT_RX_CRITICAL_WM / p_port->mtu);
   if (p_port->rx_buf_critical > PORT_RX_BUF_CRITICAL_WM)
     p_port->rx_buf_critical = PORT_RX_BUF_CRITICAL_WM;
-  log::verbose("credit_rx_max {}, credit_rx_low {}, rx_buf_critical {}",
-               p_port->credit_rx_max, p_port->credit_rx_low,
-               p_port->rx_buf_critical);
+  p_port->credit_rx_base = p_port->credit_rx_max;
+  p_port->credit_rx_limit = (PORT_RX_MAX_CREDIT_WM / p_port->mtu);
+  if (p_port->credit_rx_limit > PORT_RX_BUF_MAX_CREDIT_WM)
+    p_port->credit_rx_limit = PORT_RX_BUF_MAX_CREDIT_WM;
+  if (p_port->credit_rx_limit < p_port->credit_rx_max)
+    p_port->credit_rx_limit = p_port->credit_rx_max;
+  log::verbose(
+      "credit_rx_max {}, credit_rx_low {}, rx_buf_critical {}, "
+      "credit_rx_limit {}",
+      p_port->credit_rx_max, p_port->credit_rx_low, p_port->rx_buf_critical,
+      p_port->credit_rx_limit);
+}
+
+/*******************************************************************************
+ *
+ * Function         port_scale_credit_rx
+ *
+ * Description      Scale the number of credits granted to the peer with the
+ *                  rate at which the application drains the received data.
+ *                  The window doubles, up to credit_rx_limit, each time the
+ *                  credits are replenished while the application keeps up,
+ *                  and halves, down to the value selected with the MTU, when
+ *                  the application asks to stop the data flow.
+ *
+ *                  Only applications receiving the data through callbacks are
+ *                  affected, data queued in the port is bound by
+ *                  rx_buf_critical.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void port_scale_credit_rx(tPORT* p_port, bool drained) {
+  if (!p_port->p_data_callback && !p_port->p_data_co_callback) return;
+
+  uint16_t credit_rx_max = p_port->credit_rx_max;
+  if (drained) {
+    credit_rx_max = std::min<uint16_t>(credit_rx_max * 2,
+                                       p_port->credit_rx_limit);
+  } else {
+    credit_rx_max = std::max<uint16_t>(credit_rx_max / 2,
+                                       p_port->credit_rx_base);
+  }
+  if (credit_rx_max == p_port->credit_rx_max) return;
+
+  if (credit_rx_max > p_port->credit_rx_max)
+    p_port->stats.credit_window_grown++;
+  else
+    p_port->stats.credit_window_shrunk++;
+
+  /* Keep the credit update threshold at the same share of the window */
+  p_port->credit_rx_low = (uint16_t)(credit_rx_max * PORT_RX_BUF_LOW_WM /
+                                     PORT_RX_BUF_HIGH_WM);
+  p_port->credit_rx_max = credit_rx_max;
+  log::verbose("handle:{} credit_rx_max {}, credit_rx_low {}", p_port->handle,
+               p_port->credit_rx_max, p_port->credit_rx_low);
+}
+
+/*******************************************************************************
+ *
+ * Function         port_rx_enqueue
+ *
+ * Description      Copy the data of a frame received from the peer at the end
+ *                  of the port receive ring, allocated on the first call with
+ *                  room for rx_buf_critical frames of the port MTU.
+ *
+ * Returns          false if there is no room left for the frame
+ *
+ ******************************************************************************/
+bool port_rx_enqueue(tPORT* p_port, const BT_HDR* p_buf) {
+  if (p_port->rx_frame_count >= p_port->rx_buf_critical ||
+      p_port->rx_frame_count >= PORT_RX_BUF_CRITICAL_WM)
+    return false;
+
+  if (p_port->rx_ring == nullptr) {
+    size_t size = (size_t)p_port->rx_buf_critical * p_port->mtu;
+    p_port->rx_ring =
+        ringbuffer_init(std::min<size_t>(size, PORT_RX_CRITICAL_WM));
+  }
+  if (ringbuffer_available(p_port->rx_ring) < p_buf->len) return false;
+
+  ringbuffer_insert(p_port->rx_ring, p_buf->data + p_buf->offset, p_buf->len);
+  uint8_t last = (p_port->rx_frame_first + p_port->rx_frame_count) %
+                 PORT_RX_BUF_CRITICAL_WM;
+  p_port->rx_frame_len[last] = p_buf->len;
+  p_port->rx_frame_count++;
+  p_port->rx.queue_size += p_buf->len;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         port_rx_read
+ *
+ * Description      Copy up to |max_len| bytes from the port receive ring to
+ *                  |p_data|, and set |p_frames| to the number of frames read
+ *                  completely.
+ *
+ * Returns          the number of bytes copied
+ *
+ ******************************************************************************/
+uint16_t port_rx_read(tPORT* p_port, uint8_t* p_data, uint16_t max_len,
+                      uint16_t* p_frames) {
+  *p_frames = 0;
+  if (p_port->rx_ring == nullptr) return 0;
+
+  uint16_t len = (uint16_t)ringbuffer_pop(p_port->rx_ring, p_data, max_len);
+  p_port->rx.queue_size -= len;
+
+  uint16_t left = len;
+  while (p_port->rx_frame_count) {
+    uint16_t* frame_len = &p_port->rx_frame_len[p_port->rx_frame_first];
+    uint16_t consumed = std::min(left, *frame_len);
+    *frame_len -= consumed;
+    left -= consumed;
+    if (*frame_len != 0) break;
+
+    p_port->rx_frame_first =
+        (p_port->rx_frame_first + 1) % PORT_RX_BUF_CRITICAL_WM;
+    p_port->rx_frame_count--;
+    (*p_frames)++;
+  }
+  return len;
+}
+
+/*******************************************************************************
+ *
+ * Function         port_rx_flush
+ *
+ * Description      Drop the data of the port receive ring, and release it.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void port_rx_flush(tPORT* p_port) {
+  ringbuffer_free(p_port->rx_ring);
+  p_port->rx_ring = nullptr;
+  p_port->rx_frame_first = 0;
+  p_port->rx_frame_count = 0;
+  p_port->rx.queue_size = 0;
 }
 
 /*******************************************************************************
@@ -205,13 +343,9 @@ void port_release_port(tPORT* p_port) {
                p_port->rfc.state, p_port->keep_port_handle);
 
   mutex_global_lock();
-  BT_HDR* p_buf;
-  while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->rx.queue)) !=
-         nullptr) {
-    osi_free(p_buf);
-  }
-  p_port->rx.queue_size = 0;
+  port_rx_flush(p_port);
 
+  BT_HDR* p_buf;
   while ((p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_port->tx.queue)) !=
          nullptr) {
     osi_free(p_buf);
@@ -236,8 +370,6 @@ void port_release_port(tPORT* p_port) {
     mutex_global_lock();
     fixed_queue_free(p_port->tx.queue, nullptr);
     p_port->tx.queue = nullptr;
-    fixed_queue_free(p_port->rx.queue, nullptr);
-    p_port->rx.queue = nullptr;
     mutex_global_unlock();
 
     if (p_port->keep_port_handle) {
@@ -467,8 +599,12 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* There might be a special case when we just adjusted rx_max */
       if ((p_port->credit_rx <= p_port->credit_rx_low) && !p_port->rx.user_fc &&
           (p_port->credit_rx_max > p_port->credit_rx)) {
-        rfc_send_credit(p_port->rfc.p_mcb, p_port->dlci,
-                        (uint8_t)(p_port->credit_rx_max - p_port->credit_rx));
+        /* The application kept up with the data sent for the last credits */
+        if (!p_port->rx.peer_fc) port_scale_credit_rx(p_port, true);
+
+        uint8_t credits = (uint8_t)(p_port->credit_rx_max - p_port->credit_rx);
+        rfc_send_credit(p_port->rfc.p_mcb, p_port->dlci, credits);
+        p_port->stats.credits_granted += credits;
 
         p_port->credit_rx = p_port->credit_rx_max;
 
@@ -479,10 +615,11 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
     else {
       /* if client registered data callback, just do what they want */
       if (p_port->p_data_callback || p_port->p_data_co_callback) {
+        if (!p_port->rx.peer_fc) port_scale_credit_rx(p_port, false);
         p_port->rx.peer_fc = true;
       }
       /* if queue count reached credit rx max, set peer fc */
-      else if (fixed_queue_length(p_port->rx.queue) >= p_port->credit_rx_max) {
+      else if (p_port->rx_frame_count >= p_port->credit_rx_max) {
         p_port->rx.peer_fc = true;
       }
     }
@@ -494,7 +631,7 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* If rfcomm suspended traffic from the peer based on the rx_queue_size */
       /* check if it can be resumed now */
       if (p_port->rx.peer_fc && (p_port->rx.queue_size < PORT_RX_LOW_WM) &&
-          (fixed_queue_length(p_port->rx.queue) < PORT_RX_BUF_LOW_WM)) {
+          (p_port->rx_frame_count < PORT_RX_BUF_LOW_WM)) {
         p_port->rx.peer_fc = false;
 
         /* If user did not force flow control allow traffic now */
@@ -512,7 +649,7 @@ void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count) {
       /* Check the size of the rx queue.  If it exceeds certain */
       /* level and flow control has not been sent to the peer do it now */
       else if (((p_port->rx.queue_size > PORT_RX_HIGH_WM) ||
-                (fixed_queue_length(p_port->rx.queue) > PORT_RX_BUF_HIGH_WM)) &&
+                (p_port->rx_frame_count > PORT_RX_BUF_HIGH_WM)) &&
                !p_port->rx.peer_fc) {
         log::verbose("PORT_DataInd Data reached HW. Sending FC set.");
 
@@ -494,9 +494,11 @@ void rfc_port_sm_opened(tPORT* p_port, tRFC_PORT_EVENT event, void* p_data) {
         ((BT_HDR*)p_data)->layer_specific =
             (uint8_t)(p_port->credit_rx_max - p_port->credit_rx);
         p_port->credit_rx = p_port->credit_rx_max;
+        p_port->stats.credits_granted += ((BT_HDR*)p_data)->layer_specific;
       } else {
         ((BT_HDR*)p_data)->layer_specific = 0;
       }
+      p_port->stats.tx_bytes += ((BT_HDR*)p_data)->len;
       rfc_send_buf_uih(p_port->rfc.p_mcb, p_port->dlci, (BT_HDR*)p_data);
       rfc_dec_credit(p_port);
       return;
@@ -524,7 +526,7 @@ void rfc_port_sm_opened(tPORT* p_port, tRFC_PORT_EVENT event, void* p_data) {
                 p_port->bd_addr, p_port->handle, p_port->dlci, p_port->scn);
       p_port->rfc.state = RFC_STATE_CLOSED;
       rfc_send_ua(p_port->rfc.p_mcb, p_port->dlci);
-      if (!fixed_queue_is_empty(p_port->rx.queue)) {
+      if (p_port->rx_frame_count != 0) {
         /* give a chance to upper stack to close port properly */
         log::verbose("port queue is not empty");
         rfc_port_timer_start(p_port, RFC_DISC_TIMEOUT);
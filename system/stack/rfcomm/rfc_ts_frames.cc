@@ -23,6 +23,7 @@
  ******************************************************************************/
 
 #define LOG_TAG "rfcomm"
+#define OSI_ALLOC_TAG "rfcomm"
 
 #include <bluetooth/log.h>
 
@@ -397,7 +397,11 @@ void rfc_dec_credit(tPORT* p_port) {
   if (p_port->rfc.p_mcb->flow == PORT_FC_CREDIT) {
     if (p_port->credit_tx > 0) p_port->credit_tx--;
 
-    if (p_port->credit_tx == 0) p_port->tx.peer_fc = true;
+    if (p_port->credit_tx == 0) {
+      p_port->tx.peer_fc = true;
+      if (!fixed_queue_is_empty(p_port->tx.queue))
+        p_port->stats.tx_credit_starved++;
+    }
   }
 }
 
@@ -28,7 +28,12 @@
 #include <bluetooth/log.h>
 #include <string.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
 
 #include "internal_include/bt_target.h"
 #include "os/log.h"
@@ -41,24 +46,60 @@
 
 using namespace bluetooth;
 
+/* UUIDs contained in each record of the server database, sorted, indexed by
+ * record position */
+static std::array<std::vector<Uuid>, SDP_MAX_RECORDS> sdp_record_uuids;
+
+/* Positions of the records containing each UUID, in increasing order */
+static std::unordered_map<Uuid, std::vector<uint16_t>> sdp_uuid_records;
+
+/*******************************************************************************
+ *
+ * Function         sdp_uuid_from_array
+ *
+ * Description      This function converts a big endian UUID of 2, 4 or 16
+ *                  bytes to its 128-bit form.
+ *
+ * Returns          true if the UUID length is valid, else false
+ *
+ ******************************************************************************/
+static bool sdp_uuid_from_array(const uint8_t* p_uuid, uint32_t uuid_len,
+                                Uuid* p_out) {
+  switch (uuid_len) {
+    case Uuid::kNumBytes16:
+      *p_out = Uuid::From16Bit((p_uuid[0] << 8) | p_uuid[1]);
+      return true;
+    case Uuid::kNumBytes32:
+      *p_out = Uuid::From32Bit((p_uuid[0] << 24) | (p_uuid[1] << 16) |
+                               (p_uuid[2] << 8) | p_uuid[3]);
+      return true;
+    case Uuid::kNumBytes128:
+      *p_out = Uuid::From128BitBE(p_uuid);
+      return true;
+    default:
+      return false;
+  }
+}
+
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         collect_uuids_in_seq
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Description      This function collects the UUIDs of a data element
+ *                  sequence.
  *
- * Returns          true if found, else false
+ * Returns          void
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static void collect_uuids_in_seq(uint8_t* p, uint32_t seq_len, int nest_level,
+                                 std::vector<Uuid>* p_uuids) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
+  Uuid uuid;
 
   /* A little safety check to avoid excessive recursion */
-  if (nest_level > 3) return (false);
+  if (nest_level > 3) return;
 
   while (p < p_end) {
     type = *p++;
@@ -69,16 +110,70 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) return (true);
+      if (sdp_uuid_from_array(p, len, &uuid)) p_uuids->push_back(uuid);
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1))
-        return (true);
+      collect_uuids_in_seq(p, len, nest_level + 1, p_uuids);
     }
     p = p + len;
   }
+}
 
-  /* If here, failed to match */
-  return (false);
+/*******************************************************************************
+ *
+ * Function         sdp_db_build_uuid_index
+ *
+ * Description      This function indexes the UUIDs of every record of the
+ *                  server database, so that service searches don't walk the
+ *                  attribute values. The index is rebuilt on the first search
+ *                  after the database changed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_build_uuid_index(void) {
+  Uuid uuid;
+
+  sdp_uuid_records.clear();
+  for (uint16_t xx = 0; xx < sdp_cb.server_db.num_records; xx++) {
+    const tSDP_RECORD* p_rec = &sdp_cb.server_db.record[xx];
+    std::vector<Uuid>& uuids = sdp_record_uuids[xx];
+
+    uuids.clear();
+    for (uint16_t yy = 0; yy < p_rec->num_attributes; yy++) {
+      const tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[yy];
+      if (p_attr->type == UUID_DESC_TYPE) {
+        if (sdp_uuid_from_array(p_attr->value_ptr, p_attr->len, &uuid))
+          uuids.push_back(uuid);
+      } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
+        collect_uuids_in_seq(p_attr->value_ptr, p_attr->len, 0, &uuids);
+      }
+    }
+    std::sort(uuids.begin(), uuids.end());
+    uuids.erase(std::unique(uuids.begin(), uuids.end()), uuids.end());
+
+    for (const Uuid& record_uuid : uuids)
+      sdp_uuid_records[record_uuid].push_back(xx);
+  }
+  sdp_cb.server_db.uuid_index_valid = true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_invalidate_uuid_index
+ *
+ * Description      This function is called when a record is changed. The
+ *                  records which are not in the server database, such as the
+ *                  PBAP records rewritten for a peer, are not indexed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_invalidate_uuid_index(const tSDP_RECORD* p_rec) {
+  const tSDP_RECORD* p_begin = &sdp_cb.server_db.record[0];
+  if (std::less_equal<const tSDP_RECORD*>()(p_begin, p_rec) &&
+      std::less<const tSDP_RECORD*>()(p_rec, p_begin + SDP_MAX_RECORDS)) {
+    sdp_cb.server_db.uuid_index_valid = false;
+  }
 }
 
 /*******************************************************************************
@@ -94,41 +189,43 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
  ******************************************************************************/
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          const tSDP_UUID_SEQ* p_seq) {
-  uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+  uint16_t start, yy;
+  Uuid uuid;
 
   /* If NULL, start at the beginning, else start at the first specified record
    */
   if (!p_rec)
-    p_rec = &sdp_cb.server_db.record[0];
+    start = 0;
   else
-    p_rec++;
-
-  /* Look through the records. The spec says that a match occurs if */
-  /* the record contains all the passed UUIDs in it.                */
-  for (; p_rec < p_end; p_rec++) {
-    for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len))
-            break;
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len,
-                               &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0))
-            break;
-        }
-      }
-      /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) break;
+    start = (uint16_t)(p_rec - &sdp_cb.server_db.record[0]) + 1;
+
+  if (start >= sdp_cb.server_db.num_records) return (NULL);
+  if (p_seq->num_uids == 0) return (&sdp_cb.server_db.record[start]);
+
+  if (!sdp_cb.server_db.uuid_index_valid) sdp_db_build_uuid_index();
+
+  /* The spec says that a match occurs if the record contains all the passed
+   * UUIDs in it. Look through the records containing the first UUID. */
+  if (!sdp_uuid_from_array(&p_seq->uuid_entry[0].value[0],
+                           p_seq->uuid_entry[0].len, &uuid))
+    return (NULL);
+  auto it = sdp_uuid_records.find(uuid);
+  if (it == sdp_uuid_records.end()) return (NULL);
+
+  const std::vector<uint16_t>& positions = it->second;
+  for (auto pos = std::lower_bound(positions.begin(), positions.end(), start);
+       pos != positions.end(); pos++) {
+    const std::vector<Uuid>& uuids = sdp_record_uuids[*pos];
+    for (yy = 1; yy < p_seq->num_uids; yy++) {
+      /* If any UUID was not found, on to the next record */
+      if (!sdp_uuid_from_array(&p_seq->uuid_entry[yy].value[0],
+                               p_seq->uuid_entry[yy].len, &uuid) ||
+          !std::binary_search(uuids.begin(), uuids.end(), uuid))
+        break;
     }
 
     /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) return (p_rec);
+    if (yy == p_seq->num_uids) return (&sdp_cb.server_db.record[*pos]);
   }
 
   /* If here, no more records found */
@@ -359,6 +456,7 @@ uint32_t SDP_CreateRecord(void) {
     p_db->record[p_db->num_records].record_handle = handle;
 
     p_db->num_records++;
+    p_db->uuid_index_valid = false;
     log::verbose("SDP_CreateRecord ok, num_records:{}", p_db->num_records);
     /* Add the first attribute (the handle) automatically */
     UINT32_TO_BE_FIELD(buf, handle);
@@ -392,6 +490,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
   if (handle == 0 || sdp_cb.server_db.num_records == 0) {
     /* Delete all records in the database */
     sdp_cb.server_db.num_records = 0;
+    sdp_cb.server_db.uuid_index_valid = false;
 
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
@@ -411,6 +510,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
         }
 
         sdp_cb.server_db.num_records--;
+        sdp_cb.server_db.uuid_index_valid = false;
 
         log::verbose("SDP_DeleteRecord ok, num_records:{}",
                      sdp_cb.server_db.num_records);
@@ -447,6 +547,8 @@ bool SDP_AddAttributeToRecord(tSDP_RECORD* p_rec, uint16_t attr_id,
   uint16_t xx, yy;
   tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
 
+  sdp_db_invalidate_uuid_index(p_rec);
+
   /* Found the record. Now, see if the attribute already exists */
   for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
     /* The attribute exists. replace it */
@@ -866,6 +968,7 @@ bool SDP_DeleteAttributeFromRecord(tSDP_RECORD* p_rec, uint16_t attr_id) {
   for (uint16_t attribute_index = 0; attribute_index < p_rec->num_attributes;
        attribute_index++, p_attr++) {
     if (p_attr->id == attr_id) {
+      sdp_db_invalidate_uuid_index(p_rec);
       pad_ptr = p_attr->value_ptr;
       len = p_attr->len;
 
@@ -113,6 +113,8 @@ typedef struct {
       di_primary_handle; /* Device ID Primary record or NULL if nonexistent */
   uint16_t num_records;
   tSDP_RECORD record[SDP_MAX_RECORDS];
+  bool uuid_index_valid; /* false when the records changed since the UUID
+                            index used by service searches was built */
 } tSDP_DB;
 
 /* Continuation information for the SDP server response */
@@ -38,8 +38,8 @@ static void p_256_copy_point(Point* q, Point* p) {
   memcpy(q, p, sizeof(Point));
 }
 
-// q=2q
-static void ECC_Double(Point* q, Point* p) {
+// q=2p, p must not be infinity, q may be p
+static void ECC_Double_Jacobian(Point* q, Point* p) {
   uint32_t t1[KEY_LENGTH_DWORDS_P256];
   uint32_t t2[KEY_LENGTH_DWORDS_P256];
   uint32_t t3[KEY_LENGTH_DWORDS_P256];
@@ -50,11 +50,6 @@ static void ECC_Double(Point* q, Point* p) {
   uint32_t* z1;
   uint32_t* z3;
 
-  if (multiprecision_iszero(p->z)) {
-    multiprecision_init(q->z);
-    return;  // return infinity
-  }
-
   x1 = p->x;
   y1 = p->y;
   z1 = p->z;
@@ -87,6 +82,16 @@ static void ECC_Double(Point* q, Point* p) {
   multiprecision_sub_mod(y3, t1, y3);            // y3=t1-y3
 }
 
+// q=2q
+static void ECC_Double(Point* q, Point* p) {
+  if (multiprecision_iszero(p->z)) {
+    multiprecision_init(q->z);
+    return;  // return infinity
+  }
+
+  ECC_Double_Jacobian(q, p);
+}
+
 // q=q+p,     zp must be 1
 static void ECC_Add(Point* r, Point* p, Point* q) {
   uint32_t t1[KEY_LENGTH_DWORDS_P256];
@@ -241,6 +246,274 @@ void ECC_PointMult_Bin_NAF(Point* q, Point* p, uint32_t* n) {
   multiprecision_mersenns_mult_mod(q->y, q->y, q->z);
 }
 
+// Order of the base point
+static uint32_t curve_p256_n[KEY_LENGTH_DWORDS_P256] = {
+    0xFC632551, 0xF3B9CAC2, 0xA7179E84, 0xBCE6FAAD,
+    0xFFFFFFFF, 0xFFFFFFFF, 0x00000000, 0xFFFFFFFF};
+
+// Returns all ones if a is zero, 0 otherwise, a < 2^31
+static uint32_t ECC_ZeroMask(uint32_t a) { return 0 - ((a - 1) >> 31); }
+
+// c=a where mask is all ones, c is unchanged where mask is 0
+static void ECC_CondCopy(uint32_t* c, const uint32_t* a, uint32_t mask) {
+  for (uint32_t i = 0; i < KEY_LENGTH_DWORDS_P256; i++)
+    c[i] ^= (c[i] ^ a[i]) & mask;
+}
+
+static void ECC_CondCopyPoint(Point* q, const Point* p, uint32_t mask) {
+  ECC_CondCopy(q->x, p->x, mask);
+  ECC_CondCopy(q->y, p->y, mask);
+  ECC_CondCopy(q->z, p->z, mask);
+}
+
+// q=-q where mask is all ones
+static void ECC_CondNegate(Point* q, uint32_t mask) {
+  uint32_t minus_y[KEY_LENGTH_DWORDS_P256];
+
+  multiprecision_sub(minus_y, curve_p256.p, q->y);
+  ECC_CondCopy(q->y, minus_y, mask);
+}
+
+// r=p+q, q must be affine, p and q must not be infinity, equal or opposite.
+// r may be p.
+static void ECC_Add_Mixed(Point* r, Point* p, Point* q) {
+  uint32_t t1[KEY_LENGTH_DWORDS_P256];
+  uint32_t t2[KEY_LENGTH_DWORDS_P256];
+  uint32_t t3[KEY_LENGTH_DWORDS_P256];
+  uint32_t t4[KEY_LENGTH_DWORDS_P256];
+
+  multiprecision_mersenns_squa_mod(t1, p->z);      // t1=z1^2
+  multiprecision_mersenns_mult_mod(t2, p->z, t1);  // t2=t1*z1
+  multiprecision_mersenns_mult_mod(t1, q->x, t1);  // t1=t1*x2
+  multiprecision_mersenns_mult_mod(t2, q->y, t2);  // t2=t2*y2
+  multiprecision_sub_mod(t1, t1, p->x);            // t1=t1-x1
+  multiprecision_sub_mod(t2, t2, p->y);            // t2=t2-y1
+
+  multiprecision_mersenns_mult_mod(r->z, p->z, t1);  // z3=z1*t1
+  multiprecision_mersenns_squa_mod(t3, t1);          // t3=t1^2
+  multiprecision_mersenns_mult_mod(t4, t3, t1);      // t4=t3*t1
+  multiprecision_mersenns_mult_mod(t3, t3, p->x);    // t3=t3*x1
+  multiprecision_lshift_mod(t1, t3);                 // t1=2*t3
+  multiprecision_mersenns_squa_mod(r->x, t2);        // x3=t2^2
+  multiprecision_sub_mod(r->x, r->x, t1);            // x3=x3-t1
+  multiprecision_sub_mod(r->x, r->x, t4);            // x3=x3-t4
+  multiprecision_sub_mod(t3, t3, r->x);              // t3=t3-x3
+  multiprecision_mersenns_mult_mod(t3, t3, t2);      // t3=t3*t2
+  multiprecision_mersenns_mult_mod(t4, t4, p->y);    // t4=t4*y1
+  multiprecision_sub_mod(r->y, t3, t4);              // y3=t3-t4
+}
+
+// r=p+q, p and q must not be infinity, equal or opposite. r may be p.
+static void ECC_Add_Jacobian(Point* r, Point* p, Point* q) {
+  uint32_t u1[KEY_LENGTH_DWORDS_P256];
+  uint32_t s1[KEY_LENGTH_DWORDS_P256];
+  uint32_t t1[KEY_LENGTH_DWORDS_P256];
+  uint32_t t2[KEY_LENGTH_DWORDS_P256];
+  uint32_t t3[KEY_LENGTH_DWORDS_P256];
+
+  multiprecision_mersenns_squa_mod(t1, q->z);      // t1=z2^2
+  multiprecision_mersenns_mult_mod(u1, p->x, t1);  // u1=x1*z2^2
+  multiprecision_mersenns_mult_mod(t1, t1, q->z);  // t1=z2^3
+  multiprecision_mersenns_mult_mod(s1, p->y, t1);  // s1=y1*z2^3
+
+  multiprecision_mersenns_squa_mod(t1, p->z);      // t1=z1^2
+  multiprecision_mersenns_mult_mod(t2, p->z, t1);  // t2=z1^3
+  multiprecision_mersenns_mult_mod(t1, q->x, t1);  // t1=x2*z1^2
+  multiprecision_mersenns_mult_mod(t2, q->y, t2);  // t2=y2*z1^3
+  multiprecision_sub_mod(t1, t1, u1);              // t1=h
+  multiprecision_sub_mod(t2, t2, s1);              // t2=r
+
+  multiprecision_mersenns_mult_mod(r->z, p->z, q->z);  // z3=z1*z2*h
+  multiprecision_mersenns_mult_mod(r->z, r->z, t1);
+  multiprecision_mersenns_squa_mod(t3, t1);        // t3=h^2
+  multiprecision_mersenns_mult_mod(t1, t3, t1);    // t1=h^3
+  multiprecision_mersenns_mult_mod(u1, u1, t3);    // u1=u1*h^2
+  multiprecision_lshift_mod(t3, u1);               // t3=2*u1
+  multiprecision_mersenns_squa_mod(r->x, t2);      // x3=r^2
+  multiprecision_sub_mod(r->x, r->x, t1);          // x3=x3-h^3
+  multiprecision_sub_mod(r->x, r->x, t3);          // x3=x3-t3
+  multiprecision_sub_mod(u1, u1, r->x);            // u1=u1-x3
+  multiprecision_mersenns_mult_mod(u1, u1, t2);    // u1=u1*r
+  multiprecision_mersenns_mult_mod(s1, s1, t1);    // s1=s1*h^3
+  multiprecision_sub_mod(r->y, u1, s1);            // y3=u1-s1
+}
+
+// Converts the num points of p to affine coordinates with a single inversion
+static void ECC_Normalize(Point* p, int num) {
+  uint32_t acc[16][KEY_LENGTH_DWORDS_P256];
+  uint32_t inv[KEY_LENGTH_DWORDS_P256];
+  uint32_t z_inv[KEY_LENGTH_DWORDS_P256];
+  uint32_t z_inv2[KEY_LENGTH_DWORDS_P256];
+
+  // acc[i]=z0*...*zi
+  multiprecision_copy(acc[0], p[0].z);
+  for (int i = 1; i < num; i++)
+    multiprecision_mersenns_mult_mod(acc[i], acc[i - 1], p[i].z);
+
+  multiprecision_copy(z_inv, acc[num - 1]);
+  multiprecision_inv_mod(inv, z_inv);
+
+  for (int i = num - 1; i >= 0; i--) {
+    if (i > 0) {
+      multiprecision_mersenns_mult_mod(z_inv, inv, acc[i - 1]);
+      multiprecision_mersenns_mult_mod(inv, inv, p[i].z);
+    } else {
+      multiprecision_copy(z_inv, inv);
+    }
+    multiprecision_mersenns_squa_mod(z_inv2, z_inv);
+    multiprecision_mersenns_mult_mod(p[i].x, p[i].x, z_inv2);
+    multiprecision_mersenns_mult_mod(z_inv2, z_inv2, z_inv);
+    multiprecision_mersenns_mult_mod(p[i].y, p[i].y, z_inv2);
+    multiprecision_init(p[i].z);
+    p[i].z[0] = 1;
+  }
+}
+
+// Returns the count bits of k starting at bit pos, count < DWORD_BITS
+static uint32_t ECC_ScalarBits(const uint32_t* k, uint32_t pos,
+                               uint32_t count) {
+  uint32_t i = pos >> DWORD_BITS_SHIFT;
+  uint32_t shift = pos & (DWORD_BITS - 1);
+  uint32_t bits = 0;
+
+  if (i < KEY_LENGTH_DWORDS_P256) bits = k[i] >> shift;
+  if (shift != 0 && i + 1 < KEY_LENGTH_DWORDS_P256)
+    bits |= k[i + 1] << (DWORD_BITS - shift);
+
+  return bits & ((1u << count) - 1);
+}
+
+// Fixed window point multiplication, q=n*p.
+//
+// n is made odd, by replacing it with its opposite modulo the order when it
+// is even, and recoded in 64 signed odd digits of 4 bits. No digit is 0 and,
+// but for n=2 and n=order-2, the partial sums never hit the special cases of
+// the addition, so the sequence of operations and the table accesses do not
+// depend on n.
+void ECC_PointMult_Window(Point* q, Point* p, uint32_t* n) {
+  uint32_t k[KEY_LENGTH_DWORDS_P256];
+  uint32_t t[KEY_LENGTH_DWORDS_P256];
+  Point table[8];  // table[i]=(2i+1)p
+  Point p2;
+  Point r;
+  uint32_t mask;
+
+  multiprecision_init(p->z);
+  p->z[0] = 1;
+
+  // k=n mod order, n < 2*order
+  mask = multiprecision_sub(t, n, curve_p256_n) - 1;
+  multiprecision_copy(k, n);
+  ECC_CondCopy(k, t, mask);
+
+  // k=order-k if k is even
+  uint32_t even = (k[0] & 0x01) - 1;
+  multiprecision_sub(t, curve_p256_n, k);
+  ECC_CondCopy(k, t, even);
+
+  // Odd multiples of p
+  ECC_Double_Jacobian(&p2, p);
+  p_256_copy_point(&table[0], p);
+  for (int i = 1; i < 8; i++) ECC_Add_Jacobian(&table[i], &table[i - 1], &p2);
+  ECC_Normalize(table, 8);
+
+  // The most significant digit is always 1
+  p_256_copy_point(q, p);
+
+  for (int i = 63; i >= 0; i--) {
+    for (int j = 0; j < 4; j++) ECC_Double_Jacobian(q, q);
+
+    // digit=(bits|1)-16, odd and in [-15, 15]
+    uint32_t bits = ECC_ScalarBits(k, 4 * i, 5);
+    uint32_t sign = 0 - ((bits >> 4) ^ 1);  // all ones if digit < 0
+    uint32_t index = ((bits >> 1) & 0x07) ^ (sign & 0x07);
+
+    for (uint32_t j = 0; j < 8; j++)
+      ECC_CondCopyPoint(&r, &table[j], ECC_ZeroMask(j ^ index));
+    ECC_CondNegate(&r, sign);
+    ECC_Add_Mixed(q, q, &r);
+  }
+
+  ECC_CondNegate(q, even);
+  ECC_Normalize(q, 1);
+}
+
+// Comb table of the base point, p[i] is the sum of 2^(64j)*G for each bit j
+// set in i. p[0] is unused.
+struct EccBaseTable {
+  Point p[16];
+};
+
+static EccBaseTable ECC_ComputeBaseTable() {
+  EccBaseTable table;
+  Point g[4];  // g[j]=2^(64j)*G
+
+  p_256_init_curve();
+
+  p_256_copy_point(&g[0], &curve_p256.G);
+  multiprecision_init(g[0].z);
+  g[0].z[0] = 1;
+  for (int j = 1; j < 4; j++) {
+    p_256_copy_point(&g[j], &g[j - 1]);
+    for (int i = 0; i < 64; i++) ECC_Double_Jacobian(&g[j], &g[j]);
+    ECC_Normalize(&g[j], 1);
+  }
+
+  p_256_init_point(&table.p[0]);
+  for (int i = 1; i < 16; i++) {
+    int j = multiprecision_dword_bits(i) - 1;
+    int rest = i ^ (1 << j);
+    if (rest == 0)
+      p_256_copy_point(&table.p[i], &g[j]);
+    else
+      ECC_Add_Mixed(&table.p[i], &table.p[rest], &g[j]);
+  }
+  ECC_Normalize(&table.p[1], 15);
+
+  return table;
+}
+
+static const Point* ECC_BaseTable() {
+  static const EccBaseTable table = ECC_ComputeBaseTable();
+  return table.p;
+}
+
+// Base point multiplication, q=n*G, with a comb of 4 teeth 64 bits apart.
+//
+// Needs a quarter of the doublings of ECC_PointMult_Window. The table access
+// and the handling of empty columns and of the leading infinity do not branch
+// on n.
+void ECC_PointMult_Base(Point* q, uint32_t* n) {
+  const Point* table = ECC_BaseTable();
+  Point r;
+  Point sum;
+  uint32_t q_is_inf = 0xFFFFFFFF;
+
+  p_256_init_point(q);
+
+  for (int i = 63; i >= 0; i--) {
+    ECC_Double_Jacobian(q, q);
+
+    uint32_t index = ECC_ScalarBits(n, i, 1) |
+                     ECC_ScalarBits(n, 64 + i, 1) << 1 |
+                     ECC_ScalarBits(n, 128 + i, 1) << 2 |
+                     ECC_ScalarBits(n, 192 + i, 1) << 3;
+    uint32_t index_is_zero = ECC_ZeroMask(index);
+
+    p_256_init_point(&r);
+    for (uint32_t j = 1; j < 16; j++)
+      ECC_CondCopyPoint(&r, &table[j], ECC_ZeroMask(j ^ index));
+    ECC_Add_Mixed(&sum, q, &r);
+
+    // q=r if q is infinity, q is unchanged if the column is empty
+    ECC_CondCopyPoint(&sum, &r, q_is_inf);
+    ECC_CondCopyPoint(q, &sum, ~index_is_zero);
+    q_is_inf &= index_is_zero;
+  }
+
+  ECC_Normalize(q, 1);
+}
+
 bool ECC_ValidatePoint(const Point& pt) {
   p_256_init_curve();
 
@@ -60,6 +60,12 @@ bool ECC_ValidatePoint(const Point& p);
 
 void ECC_PointMult_Bin_NAF(Point* q, Point* p, uint32_t* n);
 
-#define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
+// q=n*p, in constant time
+void ECC_PointMult_Window(Point* q, Point* p, uint32_t* n);
+
+// q=n*G, in constant time, with a precomputed table of the base point
+void ECC_PointMult_Base(Point* q, uint32_t* n);
+
+#define ECC_PointMult(q, p, n) ECC_PointMult_Window(q, p, n)
 
 void p_256_init_curve();
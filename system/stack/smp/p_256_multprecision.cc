@@ -24,6 +24,8 @@
 
 #include "p_256_multprecision.h"
 
+#include <cstring>
+
 #include "p_256_ecc_pp.h"
 
 void multiprecision_init(uint32_t* c) {
@@ -189,6 +191,35 @@ uint32_t multiprecision_lshift(uint32_t* c, uint32_t* a) {
   return carrier;
 }
 
+#if defined(__SIZEOF_INT128__)
+#define KEY_LENGTH_QWORDS_P256 (KEY_LENGTH_DWORDS_P256 / 2)
+
+// c=a*b; c must have a buffer of 2*Key_LENGTH_uint32_tS, c != a != b
+// 64 bit limbs: a quarter of the multiplications of the 32 bit version.
+void multiprecision_mult(uint32_t* c, uint32_t* a, uint32_t* b) {
+  uint64_t a64[KEY_LENGTH_QWORDS_P256];
+  uint64_t b64[KEY_LENGTH_QWORDS_P256];
+  uint64_t c64[2 * KEY_LENGTH_QWORDS_P256] = {0};
+
+  // assume little endian right now
+  memcpy(a64, a, sizeof(a64));
+  memcpy(b64, b, sizeof(b64));
+
+  for (uint32_t i = 0; i < KEY_LENGTH_QWORDS_P256; i++) {
+    uint64_t U = 0;
+    for (uint32_t j = 0; j < KEY_LENGTH_QWORDS_P256; j++) {
+      unsigned __int128 result = (unsigned __int128)a64[i] * b64[j];
+      result += c64[i + j];
+      result += U;
+      c64[i + j] = (uint64_t)result;
+      U = (uint64_t)(result >> 64);
+    }
+    c64[i + KEY_LENGTH_QWORDS_P256] = U;
+  }
+
+  memcpy(c, c64, sizeof(c64));
+}
+#else
 // c=a*b; c must have a buffer of 2*Key_LENGTH_uint32_tS, c != a != b
 void multiprecision_mult(uint32_t* c, uint32_t* a, uint32_t* b) {
   uint32_t W;
@@ -216,6 +247,7 @@ void multiprecision_mult(uint32_t* c, uint32_t* a, uint32_t* b) {
     c[i + KEY_LENGTH_DWORDS_P256] = U;
   }
 }
+#endif
 
 void multiprecision_fast_mod_P256(uint32_t* c, uint32_t* a) {
   uint32_t A;
@@ -20,6 +20,7 @@
 
 #include <bluetooth/log.h>
 
+#include "common/time_util.h"
 #include "os/log.h"
 #include "smp_int.h"
 #include "types/hci_role.h"
@@ -253,6 +254,16 @@ void smp_set_br_state(tSMP_BR_STATE br_state) {
     log::verbose("BR_State change:{}({})==>{}({})",
                  smp_get_br_state_name(smp_cb.br_state), smp_cb.br_state,
                  smp_get_br_state_name(br_state), br_state);
+    if (smp_cb.br_state != br_state) {
+      uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+      if (smp_cb.br_state != SMP_BR_STATE_IDLE) {
+        smp_cb.br_state_time_ms[smp_cb.br_state] +=
+            now_ms - smp_cb.br_state_start_ms;
+      } else if (smp_cb.pairing_start_ms == 0) {
+        smp_cb.pairing_start_ms = now_ms;
+      }
+      smp_cb.br_state_start_ms = now_ms;
+    }
     smp_cb.br_state = br_state;
   } else {
     log::verbose("invalid br_state={}", br_state);
@@ -358,6 +358,13 @@ class tSMP_CB {
   tSMP_STATUS cert_failure; /*failure case for certification */
   alarm_t* delayed_auth_timer_ent;
   tBLE_BD_ADDR pairing_ble_bd_addr;
+
+  /* pairing latency, split by state of the LE and BR/EDR state machines */
+  uint64_t pairing_start_ms;
+  uint64_t state_start_ms;
+  uint64_t br_state_start_ms;
+  uint32_t state_time_ms[SMP_STATE_MAX];
+  uint32_t br_state_time_ms[SMP_BR_STATE_MAX];
 };
 
 /* Server Action functions are of this type */
@@ -370,6 +377,7 @@ bool smp_sm_event(tSMP_CB* p_cb, tSMP_EVENT event, tSMP_INT_DATA* p_data);
 
 tSMP_STATE smp_get_state(void);
 void smp_set_state(tSMP_STATE state);
+void smp_log_pairing_timing(tSMP_CB* p_cb);
 
 /* smp_br_main */
 void smp_br_state_machine_event(tSMP_CB* p_cb, tSMP_BR_EVENT event,
@@ -508,6 +516,10 @@ void smp_save_local_oob_data(tSMP_CB* p_cb);
 void smp_clear_local_oob_data();
 bool smp_has_local_oob_data();
 
+/* Pool of LE Secure Connections key pairs generated ahead of the pairings */
+void smp_key_pool_fill();
+void smp_key_pool_clear();
+
 namespace fmt {
 template <>
 struct formatter<tSMP_EVENT> : enum_formatter<tSMP_EVENT> {};
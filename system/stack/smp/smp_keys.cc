@@ -30,10 +30,14 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <deque>
+#include <memory>
 
 #include "crypto_toolbox/crypto_toolbox.h"
 #include "hci/controller_interface.h"
+#include "common/time_util.h"
 #include "main/shim/entry.h"
+#include "osi/include/properties.h"
 #include "p_256_ecc_pp.h"
 #include "smp_int.h"
 #include "stack/btm/btm_ble_sec.h"
@@ -49,6 +53,7 @@
 
 using bluetooth::common::BindOnce;
 using bluetooth::common::OnceCallback;
+using bluetooth::common::OnceClosure;
 using crypto_toolbox::aes_128;
 using namespace bluetooth;
 
@@ -59,6 +64,7 @@ using namespace bluetooth;
 static void smp_process_stk(tSMP_CB* p_cb, Octet16* p);
 static Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb);
 static void smp_process_private_key(tSMP_CB* p_cb);
+static void smp_process_key_pair(tSMP_CB* p_cb);
 
 static void send_ble_rand(OnceCallback<void(uint64_t)> callback);
 
@@ -74,6 +80,26 @@ void smp_save_local_oob_data(tSMP_CB* p_cb) {
 
 void smp_clear_local_oob_data() { saved_local_oob_data = {}; }
 
+// LE Secure Connections key pairs generated between pairings, so that a
+// pairing does not wait for the controller random numbers and the public key.
+// A key pair is used by a single pairing, and dropped once older than
+// SMP_KEY_POOL_MAX_AGE_MS. There is no pool unless SMP_KEY_POOL_SIZE_PROPERTY
+// is set.
+#define SMP_KEY_POOL_SIZE_PROPERTY "bluetooth.core.smp.key_pool_size"
+#define SMP_KEY_POOL_MAX_SIZE 4
+#define SMP_KEY_POOL_MAX_AGE_MS (10 * 60 * 1000)
+
+typedef struct {
+  BT_OCTET32 private_key;
+  tSMP_PUBLIC_KEY publ_key;
+  uint64_t created_ms;
+} tSMP_KEY_PAIR;
+
+static std::deque<tSMP_KEY_PAIR> smp_key_pool;
+static bool smp_key_pool_filling = false;
+// Changed by smp_key_pool_clear to drop the key pair being generated
+static uint32_t smp_key_pool_generation = 0;
+
 static bool is_oob_data_empty(tSMP_LOC_OOB_DATA* data) {
   tSMP_LOC_OOB_DATA empty_data = {};
   return memcmp(data, &empty_data, sizeof(tSMP_LOC_OOB_DATA)) == 0;
@@ -588,6 +614,107 @@ Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb) {
   return aes_128(p_cb->tk, text);
 }
 
+/* Fills the BT_OCTET32_LEN octets of private_key from offset with controller
+ * random numbers, then runs done */
+static void smp_generate_private_key(uint8_t* private_key, OnceClosure done,
+                                     size_t offset = 0) {
+  send_ble_rand(BindOnce(
+      [](uint8_t* private_key, OnceClosure done, size_t offset,
+         uint64_t rand) {
+        memcpy(&private_key[offset], (uint8_t*)&rand, sizeof(uint64_t));
+        offset += sizeof(uint64_t);
+        if (offset < BT_OCTET32_LEN) {
+          smp_generate_private_key(private_key, std::move(done), offset);
+        } else {
+          std::move(done).Run();
+        }
+      },
+      private_key, std::move(done), offset));
+}
+
+static void smp_key_pool_add(uint32_t generation,
+                             std::unique_ptr<tSMP_KEY_PAIR> key_pair) {
+  if (generation != smp_key_pool_generation) return;
+  smp_key_pool_filling = false;
+
+  Point public_key;
+  BT_OCTET32 private_key;
+  memcpy(private_key, key_pair->private_key, BT_OCTET32_LEN);
+  ECC_PointMult_Base(&public_key, (uint32_t*)private_key);
+  memcpy(key_pair->publ_key.x, public_key.x, BT_OCTET32_LEN);
+  memcpy(key_pair->publ_key.y, public_key.y, BT_OCTET32_LEN);
+  key_pair->created_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  smp_key_pool.push_back(*key_pair);
+  memset(key_pair->private_key, 0, BT_OCTET32_LEN);
+  log::verbose("{} key pairs in pool", smp_key_pool.size());
+
+  smp_key_pool_fill();
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_key_pool_fill
+ *
+ * Description      Generates key pairs, one after the other, until the pool
+ *                  holds the number set by SMP_KEY_POOL_SIZE_PROPERTY.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_key_pool_fill() {
+  if (smp_key_pool_filling) return;
+
+  size_t size = std::clamp<int32_t>(
+      osi_property_get_int32(SMP_KEY_POOL_SIZE_PROPERTY, 0), 0,
+      SMP_KEY_POOL_MAX_SIZE);
+  if (smp_key_pool.size() >= size) return;
+
+  smp_key_pool_filling = true;
+  auto key_pair = std::make_unique<tSMP_KEY_PAIR>();
+  uint8_t* private_key = key_pair->private_key;
+  smp_generate_private_key(
+      private_key,
+      BindOnce(&smp_key_pool_add, smp_key_pool_generation,
+               std::move(key_pair)));
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_key_pool_clear
+ *
+ * Description      Drops the pooled key pairs, and the one being generated.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void smp_key_pool_clear() {
+  for (auto& key_pair : smp_key_pool) {
+    memset(key_pair.private_key, 0, BT_OCTET32_LEN);
+  }
+  smp_key_pool.clear();
+  smp_key_pool_filling = false;
+  smp_key_pool_generation++;
+}
+
+/* Moves a pooled key pair to p_cb, returns false if there is none */
+static bool smp_key_pool_take(tSMP_CB* p_cb) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+
+  while (!smp_key_pool.empty()) {
+    tSMP_KEY_PAIR& key_pair = smp_key_pool.front();
+    bool expired = now_ms - key_pair.created_ms > SMP_KEY_POOL_MAX_AGE_MS;
+    if (!expired) {
+      memcpy(p_cb->private_key, key_pair.private_key, BT_OCTET32_LEN);
+      p_cb->loc_publ_key = key_pair.publ_key;
+    }
+    memset(key_pair.private_key, 0, BT_OCTET32_LEN);
+    smp_key_pool.pop_front();
+    if (!expired) return true;
+  }
+  return false;
+}
+
 /*******************************************************************************
  *
  * Function         smp_create_private_key
@@ -625,29 +752,14 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* /* p_data */) {
     log::warn("OOB Association Model with no saved data present");
   }
 
-  send_ble_rand(BindOnce(
-      [](tSMP_CB* p_cb, uint64_t rand) {
-        memcpy(p_cb->private_key, (uint8_t*)&rand, sizeof(uint64_t));
-        send_ble_rand(BindOnce(
-            [](tSMP_CB* p_cb, uint64_t rand) {
-              memcpy(&p_cb->private_key[8], (uint8_t*)&rand, sizeof(uint64_t));
-              send_ble_rand(BindOnce(
-                  [](tSMP_CB* p_cb, uint64_t rand) {
-                    memcpy(&p_cb->private_key[16], (uint8_t*)&rand,
-                           sizeof(uint64_t));
-                    send_ble_rand(BindOnce(
-                        [](tSMP_CB* p_cb, uint64_t rand) {
-                          memcpy(&p_cb->private_key[24], (uint8_t*)&rand,
-                                 sizeof(uint64_t));
-                          smp_process_private_key(p_cb);
-                        },
-                        p_cb));
-                  },
-                  p_cb));
-            },
-            p_cb));
-      },
-      p_cb));
+  if (smp_key_pool_take(p_cb)) {
+    log::verbose("using pooled key pair");
+    smp_process_key_pair(p_cb);
+    return;
+  }
+
+  smp_generate_private_key(p_cb->private_key,
+                           BindOnce(&smp_process_private_key, p_cb));
 }
 
 /*******************************************************************************
@@ -726,10 +838,24 @@ void smp_process_private_key(tSMP_CB* p_cb) {
   log::verbose("addr:{}", p_cb->pairing_bda);
 
   memcpy(private_key, p_cb->private_key, BT_OCTET32_LEN);
-  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)private_key);
+  ECC_PointMult_Base(&public_key, (uint32_t*)private_key);
   memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
   memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
 
+  smp_process_key_pair(p_cb);
+}
+
+/*******************************************************************************
+ *
+ * Function         smp_process_key_pair
+ *
+ * Description      This function notifies SM that the private key / public key
+ *                  pair is created.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void smp_process_key_pair(tSMP_CB* p_cb) {
   smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
                                       BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)",
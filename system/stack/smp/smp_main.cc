@@ -20,6 +20,9 @@
 
 #include <bluetooth/log.h>
 
+#include <string>
+
+#include "common/time_util.h"
 #include "os/log.h"
 #include "smp_int.h"
 #include "stack/include/btm_log_history.h"
@@ -97,6 +100,7 @@ const char* const smp_event_name[] = {"PAIRING_REQ_EVT",
 
 const char* smp_get_event_name(tSMP_EVENT event);
 const char* smp_get_state_name(tSMP_STATE state);
+const char* smp_get_br_state_name(tSMP_BR_STATE state);
 
 #define SMP_SM_IGNORE 0
 #define SMP_NUM_ACTIONS 2
@@ -964,6 +968,14 @@ void smp_set_state(tSMP_STATE state) {
           kBtmLogTag, smp_cb.pairing_ble_bd_addr, "Security state changed",
           base::StringPrintf("%s => %s", smp_get_state_name(smp_cb.state),
                              smp_get_state_name(state)));
+
+      uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+      if (smp_cb.state != SMP_STATE_IDLE) {
+        smp_cb.state_time_ms[smp_cb.state] += now_ms - smp_cb.state_start_ms;
+      } else if (smp_cb.pairing_start_ms == 0) {
+        smp_cb.pairing_start_ms = now_ms;
+      }
+      smp_cb.state_start_ms = now_ms;
     }
     smp_cb.state = state;
   } else {
@@ -971,6 +983,45 @@ void smp_set_state(tSMP_STATE state) {
   }
 }
 
+/*******************************************************************************
+ * Function     smp_log_pairing_timing
+ *
+ * Description  Logs the duration of the pairing, and the time spent in each
+ *              state of the LE and BR/EDR state machines, to tell the local
+ *              computations from the waits for the peer and the user.
+ *
+ * Returns      None
+ ******************************************************************************/
+void smp_log_pairing_timing(tSMP_CB* p_cb) {
+  if (p_cb->pairing_start_ms == 0) return;
+
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  if (p_cb->state != SMP_STATE_IDLE && p_cb->state < SMP_STATE_MAX) {
+    p_cb->state_time_ms[p_cb->state] += now_ms - p_cb->state_start_ms;
+  }
+  if (p_cb->br_state != SMP_BR_STATE_IDLE &&
+      p_cb->br_state < SMP_BR_STATE_MAX) {
+    p_cb->br_state_time_ms[p_cb->br_state] += now_ms - p_cb->br_state_start_ms;
+  }
+
+  std::string states;
+  for (tSMP_STATE state = 0; state < SMP_STATE_MAX; state++) {
+    if (p_cb->state_time_ms[state] != 0) {
+      states += fmt::format(" {}:{}ms", smp_get_state_name(state),
+                            p_cb->state_time_ms[state]);
+    }
+  }
+  for (tSMP_BR_STATE state = 0; state < SMP_BR_STATE_MAX; state++) {
+    if (p_cb->br_state_time_ms[state] != 0) {
+      states += fmt::format(" {}:{}ms", smp_get_br_state_name(state),
+                            p_cb->br_state_time_ms[state]);
+    }
+  }
+  log::info("Pairing timing remote:{} over_br:{} total:{}ms{}",
+            p_cb->pairing_bda, p_cb->smp_over_br,
+            now_ms - p_cb->pairing_start_ms, states);
+}
+
 /*******************************************************************************
  * Function     smp_get_state
  * Returns      The smp state
@@ -899,6 +899,7 @@ void tSMP_CB::init(uint8_t security_mode) {
   smp_l2cap_if_init();
   /* initialization of P-256 parameters */
   p_256_init_curve();
+  smp_key_pool_clear();
 
   /* Initialize failure case for certification */
   smp_cb.cert_failure = static_cast<tSMP_STATUS>(
@@ -1053,12 +1054,18 @@ void smp_proc_pairing_cmpl(tSMP_CB* p_cb) {
                           metric_status);
   }
 
+  smp_log_pairing_timing(p_cb);
+
   if (p_cb->status == SMP_SUCCESS && p_cb->smp_over_br) {
     btm_dev_consolidate_existing_connections(pairing_bda);
   }
 
   smp_reset_control_value(p_cb);
 
+  /* Replace the key pair used by this pairing, off the critical path of the
+   * next one */
+  smp_key_pool_fill();
+
   if (p_callback) (*p_callback)(SMP_COMPLT_EVT, pairing_bda, &evt_data);
 }
 
@@ -29,6 +29,7 @@
 #include "osi/include/allocator.h"
 #include "stack/include/a2dp_sbc_decoder.h"
 #include "stack/include/a2dp_sbc_encoder.h"
+#include "stack/include/a2dp_sbc_up_sample.h"
 #include "stack/include/avdt_api.h"
 #include "stack/include/bt_hdr.h"
 #include "test_util.h"
@@ -191,6 +192,45 @@ TEST_F(A2dpSbcTest, a2dp_enqueue_cb_is_invoked) {
   promise.get_future().wait();
 }
 
+TEST_F(A2dpSbcTest, bitpool_adapts_to_transmit_queue_length) {
+  static uint8_t bitpool;
+  auto read_cb = +[](uint8_t* p_buf, uint32_t len) -> uint32_t { return len; };
+  auto enqueue_cb = +[](BT_HDR* p_buf, size_t frames_n, uint32_t len) -> bool {
+    // The bitpool is the third byte of the SBC frame header
+    bitpool = Data(p_buf)[2];
+    osi_free(p_buf);
+    return false;
+  };
+  InitializeEncoder(true, read_cb, enqueue_cb);
+  uint64_t timestamp_us = 0;
+  auto send_frames = [&](size_t transmit_queue_length) {
+    bitpool = 0;
+    timestamp_us += encoder_iface_->get_encoder_interval_ms() * 1000;
+    encoder_iface_->set_transmit_queue_length(transmit_queue_length);
+    encoder_iface_->send_frames(timestamp_us);
+    return bitpool;
+  };
+
+  const uint8_t configured_bitpool = send_frames(0);
+  ASSERT_NE(configured_bitpool, 0);
+
+  // Lowered while packets pile up, down to the floor
+  uint8_t congested_bitpool = send_frames(2);
+  ASSERT_LT(congested_bitpool, configured_bitpool);
+  for (int i = 0; i < 10; i++) {
+    congested_bitpool = send_frames(3);
+  }
+  ASSERT_GE(congested_bitpool, 35);
+  ASSERT_EQ(send_frames(3), congested_bitpool);
+
+  // Raised back once the transmit queue stays empty
+  uint8_t recovered_bitpool = congested_bitpool;
+  for (int i = 0; i < 1000 && recovered_bitpool < configured_bitpool; i++) {
+    recovered_bitpool = send_frames(0);
+  }
+  ASSERT_EQ(recovered_bitpool, configured_bitpool);
+}
+
 TEST_F(A2dpSbcTest, decoded_data_cb_not_invoked_when_empty_packet) {
   auto data_cb = +[](uint8_t* p_buf, uint32_t len) { FAIL(); };
   InitializeDecoder(data_cb);
@@ -287,5 +327,40 @@ TEST_F(A2dpSbcTest, get_track_bits_per_sample) {
   ASSERT_EQ(A2DP_GetTrackBitsPerSampleSbc(kCodecInfoSbcCapability), 16);
 }
 
+TEST_F(A2dpSbcTest, up_sample_16s_integer_ratio) {
+  // 13 frames leave a remainder to the SIMD paths
+  constexpr uint32_t kSrcFrames = 13;
+  int16_t src[2 * kSrcFrames];
+  for (uint32_t i = 0; i < 2 * kSrcFrames; i++) {
+    src[i] = (int16_t)(1000 * i - 7000);
+  }
+
+  for (uint32_t ratio : {1, 2, 3, 4, 6}) {
+    int16_t dst[2 * kSrcFrames * 6] = {};
+    uint32_t src_used = 0;
+    a2dp_sbc_init_up_sample(8000, 8000 * ratio, 16, 2);
+    ASSERT_EQ(a2dp_sbc_up_sample(src, dst, sizeof(src),
+                                 4 * kSrcFrames * ratio, &src_used),
+              (int)(4 * kSrcFrames * ratio));
+    ASSERT_EQ(src_used, sizeof(src));
+    for (uint32_t i = 0; i < kSrcFrames * ratio; i++) {
+      ASSERT_EQ(dst[2 * i], src[2 * (i / ratio)]);
+      ASSERT_EQ(dst[2 * i + 1], src[2 * (i / ratio) + 1]);
+    }
+  }
+
+  // The destination ends within the repetitions of the fifth frame
+  int16_t dst[2 * 14] = {};
+  uint32_t src_used = 0;
+  a2dp_sbc_init_up_sample(16000, 48000, 16, 2);
+  ASSERT_EQ(a2dp_sbc_up_sample(src, dst, sizeof(src), sizeof(dst), &src_used),
+            (int)sizeof(dst));
+  ASSERT_EQ(src_used, 4u * 5);
+  for (uint32_t i = 0; i < 14; i++) {
+    ASSERT_EQ(dst[2 * i], src[2 * (i / 3)]);
+    ASSERT_EQ(dst[2 * i + 1], src[2 * (i / 3) + 1]);
+  }
+}
+
 }  // namespace testing
 }  // namespace bluetooth
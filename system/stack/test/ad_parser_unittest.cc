@@ -210,4 +210,92 @@ TEST(AdvertiseDataParserTest, GetFieldByTypeInLoop) {
     match_no++;
   }
   EXPECT_EQ(match_no, 3);
-}
\ No newline at end of file
+}
+TEST(AdvertiseDataIndexTest, GetField) {
+  const std::vector<uint8_t> data0{0x02, 0x01, 0x06, 0x03, 0x02, 0x01, 0x02,
+                                   0x01, 0x0a, 0x03, 0x02, 0x03, 0x04};
+  AdvertiseDataIndex index(data0);
+
+  auto field = index.GetField(0x02);
+  ASSERT_TRUE(field.has_value());
+  EXPECT_EQ(data0.data() + 5, field->data());
+  EXPECT_EQ(2u, field->size());
+
+  // A field with no data is found, with an empty view
+  field = index.GetField(0x0a);
+  ASSERT_TRUE(field.has_value());
+  EXPECT_EQ(0u, field->size());
+
+  EXPECT_FALSE(index.GetField(0x09).has_value());
+
+  uint8_t p_length;
+  EXPECT_EQ(data0.data() + 2, index.GetFieldByType(0x01, &p_length));
+  EXPECT_EQ(1, p_length);
+  EXPECT_EQ(nullptr, index.GetFieldByType(0x09, &p_length));
+  EXPECT_EQ(0, p_length);
+}
+
+TEST(AdvertiseDataIndexTest, BadLength) {
+  // Two fields, second field length too long.
+  const std::vector<uint8_t> data1{0x02, 0x02, 0x00, 0x03, 0x00};
+  AdvertiseDataIndex index(data1);
+
+  EXPECT_TRUE(index.GetField(0x02).has_value());
+  EXPECT_FALSE(index.GetField(0x03).has_value());
+
+  // Nothing is indexed past zero padding
+  const std::vector<uint8_t> data2{0x02, 0x01, 0x06, 0x00, 0x02, 0x09, 0x41};
+  AdvertiseDataIndex padded(data2);
+  EXPECT_TRUE(padded.GetField(0x01).has_value());
+  EXPECT_FALSE(padded.GetField(0x09).has_value());
+}
+
+TEST(AdvertiseDataIndexTest, ForEachField) {
+  const uint8_t AD_TYPE_SVC_DATA = 0x16;
+  const std::vector<uint8_t> data0{
+    0x02, 0x01, 0x02,
+    0x07, 0x2e, 0x6a, 0xc1, 0x19, 0x52, 0x1e, 0x49,
+    0x09, 0x16, 0x4e, 0x18, 0x00, 0xff, 0x0f, 0x03, 0x00, 0x00,
+    0x02, 0x0a, 0x7f,
+    0x03, 0x16, 0x4f, 0x18,
+    0x04, 0x16, 0x53, 0x18, 0x00,
+    0x0f, 0x09, 0x48, 0x5f, 0x43, 0x33, 0x45, 0x41, 0x31, 0x36, 0x33, 0x46, 0x35, 0x36, 0x34, 0x46 };
+  AdvertiseDataIndex index(data0);
+
+  std::vector<std::pair<long, size_t>> fields;
+  index.ForEachField(AD_TYPE_SVC_DATA, [&](std::span<const uint8_t> data) {
+    fields.emplace_back(data.data() - data0.data(), data.size());
+    return true;
+  });
+  EXPECT_EQ(fields, (std::vector<std::pair<long, size_t>>{{13, 8}, {26, 2}, {30, 3}}));
+
+  // Stops when the callback returns false
+  int match_no = 0;
+  index.ForEachField(AD_TYPE_SVC_DATA, [&](std::span<const uint8_t>) {
+    match_no++;
+    return false;
+  });
+  EXPECT_EQ(1, match_no);
+}
+
+TEST(AdvertiseDataIndexTest, MoreFieldsThanTable) {
+  // Extended advertising data can hold more fields than the index table
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 500; i++) {
+    data.insert(data.end(), {0x02, 0x0a, static_cast<uint8_t>(i)});
+  }
+  data.insert(data.end(), {0x02, 0x09, 0x41});
+  AdvertiseDataIndex index(data);
+
+  int count = 0;
+  index.ForEachField(0x0a, [&](std::span<const uint8_t> field) {
+    EXPECT_EQ(static_cast<uint8_t>(count), field[0]);
+    count++;
+    return true;
+  });
+  EXPECT_EQ(500, count);
+
+  auto name = index.GetField(0x09);
+  ASSERT_TRUE(name.has_value());
+  EXPECT_EQ(data.data() + data.size() - 1, name->data());
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "stack/include/a2dp_sbc_up_sample.h"
+
+using ::benchmark::State;
+
+namespace {
+
+/* Source frames converted per call, a few SBC frames worth of PCM */
+constexpr uint32_t kSrcFrames = 1024;
+constexpr uint32_t kDstSampleRate = 48000;
+
+/* Converts 16 bits stereo PCM at the sample rate given as argument to 48 kHz,
+ * as done by the SBC encoder when the audio HAL feeds another rate */
+void BM_UpSample16s(State& state) {
+  uint32_t src_sample_rate = state.range(0);
+  uint32_t dst_frames =
+      (uint64_t)kSrcFrames * kDstSampleRate / src_sample_rate + 1;
+  std::vector<int16_t> src(2 * kSrcFrames);
+  std::vector<int16_t> dst(2 * dst_frames);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = (int16_t)(i * 997);
+  }
+
+  for (auto _ : state) {
+    uint32_t src_used;
+    a2dp_sbc_init_up_sample(src_sample_rate, kDstSampleRate, 16, 2);
+    benchmark::DoNotOptimize(a2dp_sbc_up_sample(
+        src.data(), dst.data(), src.size() * sizeof(int16_t),
+        dst.size() * sizeof(int16_t), &src_used));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * src.size() * sizeof(int16_t));
+}
+
+}  // namespace
+
+BENCHMARK(BM_UpSample16s)->Arg(16000)->Arg(24000)->Arg(32000)->Arg(44100);
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "stack/l2cap/l2c_fcr_crc.h"
+
+using ::benchmark::State;
+
+namespace {
+
+/* L2CAP_FCR_INIT_CRC */
+constexpr uint16_t kInitCrc = 0;
+
+std::vector<uint8_t> MakeFrame(size_t len) {
+  std::vector<uint8_t> frame(len);
+  for (size_t i = 0; i < len; i++) {
+    frame[i] = (i * 37 + 11) & 0xff;
+  }
+  return frame;
+}
+
+template <uint16_t (*Crc)(uint16_t, const uint8_t*, size_t)>
+void BM_FcrCrc(State& state) {
+  auto frame = MakeFrame(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Crc(kInitCrc, frame.data(), frame.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * frame.size());
+}
+
+}  // namespace
+
+/* Frame sizes from a bare S-frame to the maximum ERTM PDU */
+BENCHMARK_TEMPLATE(BM_FcrCrc, l2c_fcr_updcrc_bytewise)
+    ->Arg(6)
+    ->Arg(64)
+    ->Arg(672)
+    ->Arg(1021);
+BENCHMARK_TEMPLATE(BM_FcrCrc, l2c_fcr_updcrc)
+    ->Arg(6)
+    ->Arg(64)
+    ->Arg(672)
+    ->Arg(1021);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "stack/l2cap/l2c_run_queue.h"
+
+using ::benchmark::State;
+
+namespace {
+
+/* Channel of a link, the last |backlogged| channels have data to send */
+struct Channel {
+  tL2C_RUN_NODE node;
+  bool has_data;
+};
+
+tL2C_RUN_STATE GetRunState(tL2C_RUN_NODE* p_node) {
+  return static_cast<Channel*>(p_node->p_owner)->has_data ? L2C_RUN_READY
+                                                          : L2C_RUN_IDLE;
+}
+
+std::vector<Channel> MakeChannels(size_t num_channels, size_t backlogged) {
+  std::vector<Channel> channels(num_channels);
+  for (size_t i = 0; i < num_channels; i++) {
+    channels[i].has_data = i >= num_channels - backlogged;
+  }
+  return channels;
+}
+
+/* Send path before the run queue: the ring of all the channels of the link
+ * is walked from the next serving channel until one has data. */
+void BM_ChannelRing(State& state) {
+  auto channels = MakeChannels(state.range(0), state.range(1));
+  size_t serve = 0;
+  for (auto _ : state) {
+    for (size_t j = 0; j < channels.size(); j++) {
+      Channel* p_channel = &channels[serve];
+      serve = (serve + 1) % channels.size();
+      if (p_channel->has_data) {
+        benchmark::DoNotOptimize(p_channel);
+        break;
+      }
+    }
+  }
+}
+
+void BM_RunQueue(State& state) {
+  auto channels = MakeChannels(state.range(0), state.range(1));
+  tL2C_RUN_QUEUE queue;
+  l2c_run_queue_init(&queue);
+  /* Idle channels leave the queue on the first selections */
+  for (auto& channel : channels) {
+    channel.node = {};
+    channel.node.p_owner = &channel;
+    l2c_run_queue_activate(&queue, &channel.node, 2);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(l2c_run_queue_select(&queue, GetRunState));
+  }
+}
+
+}  // namespace
+
+/* From a single channel to a link carrying AVDTP, AVRCP, RFCOMM and dynamic
+ * ATT channels, with one or all of them backlogged */
+BENCHMARK(BM_ChannelRing)
+    ->Args({1, 1})
+    ->Args({8, 1})
+    ->Args({32, 1})
+    ->Args({128, 1})
+    ->Args({32, 32});
+BENCHMARK(BM_RunQueue)
+    ->Args({1, 1})
+    ->Args({8, 1})
+    ->Args({32, 1})
+    ->Args({128, 1})
+    ->Args({32, 32});
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
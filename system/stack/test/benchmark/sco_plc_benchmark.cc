@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <math.h>
+
+#include <cstdint>
+
+#include "stack/btm/btm_sco_plc.h"
+
+using ::benchmark::State;
+using namespace bluetooth::audio::sco::wbs;
+
+namespace {
+
+/* Size of the history buffer of tBTM_MSBC_PLC */
+constexpr int kHistLen =
+    BTM_PLC_HL + BTM_MSBC_FS + BTM_PLC_SBCRL + BTM_PLC_OLAL;
+
+/* A voiced like signal, a 200 Hz tone with harmonics at 16 kHz */
+void MakeHistory(int16_t* hist) {
+  for (int i = 0; i < kHistLen; i++) {
+    double t = 2 * M_PI * 200 * i / 16000;
+    hist[i] = (int16_t)(8000 * sin(t) + 3000 * sin(3 * t) + 1000 * sin(7 * t));
+  }
+}
+
+void BM_PatternMatch(State& state) {
+  int16_t hist[kHistLen];
+  MakeHistory(hist);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(plc::pattern_match(hist));
+  }
+}
+
+/* The whole substitution of one lost 7.5 ms frame */
+void BM_ConcealFrame(State& state) {
+  int16_t hist[kHistLen];
+  int16_t decoded[BTM_MSBC_FS] = {};
+  MakeHistory(hist);
+  for (auto _ : state) {
+    int16_t* frame_head = &hist[BTM_PLC_HL];
+    int16_t* best_match_hist = &hist[plc::pattern_match(hist) + BTM_PLC_TL];
+    float scaler = plc::amplitude_match(&hist[BTM_PLC_HL - BTM_MSBC_FS],
+                                        best_match_hist);
+    plc::overlap_add(frame_head, 1.0, decoded, scaler, best_match_hist);
+    plc::scale(&frame_head[BTM_PLC_OLAL], &best_match_hist[BTM_PLC_OLAL],
+               scaler, BTM_MSBC_FS - BTM_PLC_OLAL);
+    benchmark::ClobberMemory();
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_PatternMatch);
+BENCHMARK(BM_ConcealFrame);
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "stack/smp/p_256_ecc_pp.h"
+
+using ::benchmark::State;
+
+namespace {
+
+/* Private keys of the LE Secure Connections sample data */
+constexpr uint32_t kPrivateKeyA[KEY_LENGTH_DWORDS_P256] = {
+    0xcd3c1abd, 0x5899b8a6, 0xeb40b799, 0x4aff607b,
+    0xd2103f50, 0x74c9b3e3, 0xa3c55f38, 0x3f49f6d4};
+constexpr uint32_t kPrivateKeyB[KEY_LENGTH_DWORDS_P256] = {
+    0xf47fc5fd, 0x6b4fdd49, 0xf19d7cfb, 0x59cb9ac2,
+    0xeed4e72a, 0x900afcfb, 0x32f6bb9a, 0x55188b3d};
+
+/* Public key generation, as in smp_process_private_key */
+void BM_PublicKey_Bin_NAF(State& state) {
+  p_256_init_curve();
+  for (auto _ : state) {
+    uint32_t k[KEY_LENGTH_DWORDS_P256];
+    Point g, q;
+    memcpy(k, kPrivateKeyA, sizeof(k));
+    memcpy(&g, &curve_p256.G, sizeof(g));
+    ECC_PointMult_Bin_NAF(&q, &g, k);
+    benchmark::DoNotOptimize(q);
+  }
+}
+
+void BM_PublicKey_Base(State& state) {
+  p_256_init_curve();
+  for (auto _ : state) {
+    uint32_t k[KEY_LENGTH_DWORDS_P256];
+    Point q;
+    memcpy(k, kPrivateKeyA, sizeof(k));
+    ECC_PointMult_Base(&q, k);
+    benchmark::DoNotOptimize(q);
+  }
+}
+
+/* DHKey computation, as in smp_compute_dhkey */
+template <void (*PointMult)(Point*, Point*, uint32_t*)>
+void BM_DhKey(State& state) {
+  p_256_init_curve();
+  uint32_t k[KEY_LENGTH_DWORDS_P256];
+  Point peer;
+  memcpy(k, kPrivateKeyB, sizeof(k));
+  ECC_PointMult_Base(&peer, k);
+
+  for (auto _ : state) {
+    Point p, q;
+    memcpy(k, kPrivateKeyA, sizeof(k));
+    memcpy(&p, &peer, sizeof(p));
+    PointMult(&q, &p, k);
+    benchmark::DoNotOptimize(q);
+  }
+}
+
+/* Both halves of the pairing: the local key pair, then the DHKey */
+void BM_Pairing(State& state) {
+  p_256_init_curve();
+  uint32_t k[KEY_LENGTH_DWORDS_P256];
+  Point peer;
+  memcpy(k, kPrivateKeyB, sizeof(k));
+  ECC_PointMult_Base(&peer, k);
+
+  for (auto _ : state) {
+    Point p, q;
+    memcpy(k, kPrivateKeyA, sizeof(k));
+    ECC_PointMult_Base(&q, k);
+    benchmark::DoNotOptimize(q);
+    memcpy(k, kPrivateKeyA, sizeof(k));
+    memcpy(&p, &peer, sizeof(p));
+    ECC_PointMult(&q, &p, k);
+    benchmark::DoNotOptimize(q);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_PublicKey_Bin_NAF);
+BENCHMARK(BM_PublicKey_Base);
+BENCHMARK_TEMPLATE(BM_DhKey, ECC_PointMult_Bin_NAF);
+BENCHMARK_TEMPLATE(BM_DhKey, ECC_PointMult_Window);
+BENCHMARK(BM_Pairing);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -18,8 +18,11 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "crypto_toolbox/crypto_toolbox.h"
+#include "stack/btm/btm_ble_int.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/btm/btm_sec_cb.h"
+#include "stack/include/btm_ble_addr.h"
 #include "stack/test/btm/btm_test_fixtures.h"
 #include "test/mock/mock_main_shim_entry.h"
 
@@ -41,3 +44,173 @@ TEST_F(StackBtmDevTest, btm_sec_allocate_dev_rec__with_list) {
   ASSERT_NE(nullptr, btm_sec_allocate_dev_rec());
   ::btm_sec_cb.Free();
 }
+
+namespace bluetooth {
+namespace testing {
+namespace legacy {
+void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec);
+}  // namespace legacy
+}  // namespace testing
+}  // namespace bluetooth
+
+namespace {
+
+const RawAddress kRawAddress = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kRawAddress2 =
+    RawAddress({0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc});
+constexpr uint16_t kHciHandle = 0x0123;
+constexpr uint16_t kBleHciHandle = 0x0456;
+
+tBTM_SEC_DEV_REC* allocate_dev_rec(const RawAddress& bd_addr) {
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_sec_allocate_dev_rec();
+  p_dev_rec->bd_addr = bd_addr;
+  p_dev_rec->hci_handle = HCI_INVALID_HANDLE;
+  p_dev_rec->ble_hci_handle = HCI_INVALID_HANDLE;
+  return p_dev_rec;
+}
+
+const Octet16 kIrk = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                      0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+const Octet16 kIrk2 = {0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                       0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20};
+
+// Generates the resolvable private address of |irk| for |prand|.
+RawAddress make_rpa(const Octet16& irk, uint8_t prand) {
+  RawAddress rpa({0x40, 0x00, prand, 0x00, 0x00, 0x00});
+  Octet16 r{};
+  r[0] = rpa.address[2];
+  r[1] = rpa.address[1];
+  r[2] = rpa.address[0];
+  Octet16 hash = bluetooth::crypto_toolbox::aes_128(irk, r);
+  rpa.address[5] = hash[0];
+  rpa.address[4] = hash[1];
+  rpa.address[3] = hash[2];
+  return rpa;
+}
+
+void set_irk(tBTM_SEC_DEV_REC* p_dev_rec, const Octet16& irk) {
+  p_dev_rec->device_type |= BT_DEVICE_TYPE_BLE;
+  p_dev_rec->sec_rec.ble_keys.key_type |= BTM_LE_KEY_PID;
+  p_dev_rec->sec_rec.ble_keys.irk = irk;
+  ::btm_sec_cb.sec_dev_index.InvalidateResolved();
+}
+
+}  // namespace
+
+class StackBtmDevIndexTest : public StackBtmDevTest {
+ protected:
+  void SetUp() override {
+    StackBtmDevTest::SetUp();
+    ::btm_sec_cb.Init(BTM_SEC_MODE_SC);
+  }
+  void TearDown() override {
+    ::btm_sec_cb.Free();
+    StackBtmDevTest::TearDown();
+  }
+};
+
+TEST_F(StackBtmDevIndexTest, find_dev__follows_address_changes) {
+  tBTM_SEC_DEV_REC* p_dev_rec = allocate_dev_rec(kRawAddress);
+  ASSERT_EQ(p_dev_rec, btm_find_dev(kRawAddress));
+  ASSERT_EQ(p_dev_rec, btm_find_dev(kRawAddress));
+
+  // Fields are written directly by the rest of the stack.
+  p_dev_rec->bd_addr = kRawAddress2;
+  ASSERT_EQ(nullptr, btm_find_dev(kRawAddress));
+  ASSERT_EQ(p_dev_rec, btm_find_dev(kRawAddress2));
+
+  p_dev_rec->ble.pseudo_addr = kRawAddress;
+  ASSERT_EQ(p_dev_rec, btm_find_dev(kRawAddress));
+}
+
+TEST_F(StackBtmDevIndexTest, find_dev__first_of_duplicates) {
+  tBTM_SEC_DEV_REC* p_first = allocate_dev_rec(kRawAddress2);
+  tBTM_SEC_DEV_REC* p_second = allocate_dev_rec(kRawAddress);
+  p_first->ble.pseudo_addr = kRawAddress;
+  ASSERT_EQ(p_first, btm_find_dev(kRawAddress));
+
+  p_first->ble.pseudo_addr = RawAddress::kEmpty;
+  ASSERT_EQ(p_second, btm_find_dev(kRawAddress));
+
+  // An earlier record starting to match takes precedence again.
+  ASSERT_TRUE(btm_ble_init_pseudo_addr(p_first, kRawAddress));
+  ASSERT_EQ(p_first, btm_find_dev(kRawAddress));
+}
+
+TEST_F(StackBtmDevIndexTest, find_dev__removed_record) {
+  tBTM_SEC_DEV_REC* p_dev_rec = allocate_dev_rec(kRawAddress);
+  p_dev_rec->hci_handle = kHciHandle;
+  ASSERT_EQ(p_dev_rec, btm_find_dev(kRawAddress));
+  ASSERT_EQ(p_dev_rec, btm_find_dev_by_handle(kHciHandle));
+
+  bluetooth::testing::legacy::wipe_secrets_and_remove(p_dev_rec);
+  ASSERT_EQ(nullptr, btm_find_dev(kRawAddress));
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(kHciHandle));
+  ASSERT_EQ(0u, ::btm_sec_cb.sec_dev_index.Size());
+}
+
+TEST_F(StackBtmDevIndexTest, find_dev_by_handle__both_transports) {
+  tBTM_SEC_DEV_REC* p_dev_rec = allocate_dev_rec(kRawAddress);
+  p_dev_rec->hci_handle = kHciHandle;
+  p_dev_rec->ble_hci_handle = kBleHciHandle;
+  ASSERT_EQ(p_dev_rec, btm_find_dev_by_handle(kHciHandle));
+  ASSERT_EQ(p_dev_rec, btm_find_dev_by_handle(kBleHciHandle));
+
+  p_dev_rec->ble_hci_handle = HCI_INVALID_HANDLE;
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(kBleHciHandle));
+  ASSERT_EQ(p_dev_rec, btm_find_dev_by_handle(kHciHandle));
+}
+
+TEST_F(StackBtmDevIndexTest, find_dev_with_lenc) {
+  tBTM_SEC_DEV_REC* p_no_key = allocate_dev_rec(kRawAddress);
+  tBTM_SEC_DEV_REC* p_with_key = allocate_dev_rec(kRawAddress);
+  p_with_key->sec_rec.ble_keys.key_type = BTM_LE_KEY_LENC;
+  ASSERT_EQ(p_no_key, btm_find_dev(kRawAddress));
+  ASSERT_EQ(p_with_key, btm_find_dev_with_lenc(kRawAddress));
+
+  p_no_key->sec_rec.ble_keys.key_type = BTM_LE_KEY_LENC;
+  ASSERT_EQ(p_no_key, btm_find_dev_with_lenc(kRawAddress));
+}
+
+TEST_F(StackBtmDevIndexTest, resolve_random_addr__cached) {
+  tBTM_SEC_DEV_REC* p_other = allocate_dev_rec(kRawAddress2);
+  set_irk(p_other, kIrk2);
+  tBTM_SEC_DEV_REC* p_dev_rec = allocate_dev_rec(kRawAddress);
+  set_irk(p_dev_rec, kIrk);
+
+  const RawAddress rpa = make_rpa(kIrk, 0x01);
+  ASSERT_EQ(p_dev_rec, btm_ble_resolve_random_addr(rpa));
+  ASSERT_EQ(p_dev_rec, btm_ble_resolve_random_addr(rpa));
+  ASSERT_TRUE(btm_ble_addr_resolvable(rpa, p_dev_rec));
+  ASSERT_FALSE(btm_ble_addr_resolvable(rpa, p_other));
+
+  // The cached result follows the IRK of the record.
+  p_dev_rec->sec_rec.ble_keys.irk = kIrk2;
+  ASSERT_EQ(p_other, btm_ble_resolve_random_addr(make_rpa(kIrk2, 0x01)));
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+}
+
+TEST_F(StackBtmDevIndexTest, resolve_random_addr__unresolvable) {
+  tBTM_SEC_DEV_REC* p_dev_rec = allocate_dev_rec(kRawAddress);
+  set_irk(p_dev_rec, kIrk2);
+
+  const RawAddress rpa = make_rpa(kIrk, 0x02);
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+  ASSERT_FALSE(btm_ble_addr_resolvable(rpa, p_dev_rec));
+
+  // A new IRK may resolve the address.
+  tBTM_SEC_DEV_REC* p_new = allocate_dev_rec(kRawAddress2);
+  set_irk(p_new, kIrk);
+  ASSERT_EQ(p_new, btm_ble_resolve_random_addr(rpa));
+}
+
+TEST_F(StackBtmDevIndexTest, resolve_random_addr__removed_record) {
+  tBTM_SEC_DEV_REC* p_dev_rec = allocate_dev_rec(kRawAddress);
+  set_irk(p_dev_rec, kIrk);
+
+  const RawAddress rpa = make_rpa(kIrk, 0x03);
+  ASSERT_EQ(p_dev_rec, btm_ble_resolve_random_addr(rpa));
+  bluetooth::testing::legacy::wipe_secrets_and_remove(p_dev_rec);
+  ASSERT_EQ(nullptr, btm_ble_resolve_random_addr(rpa));
+}
@@ -18,6 +18,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <string>
+
 #include "btm_iso_api.h"
 #include "hci/controller_interface_mock.h"
 #include "hci/hci_packets.h"
@@ -25,6 +28,7 @@
 #include "mock_hcic_layer.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_dev.h"
+#include "stack/btm/btm_iso_sdu_pool.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/hci_error_code.h"
@@ -84,8 +88,19 @@ static void transmit_command(const BT_HDR* /* command */,
 }
 
 static void transmit_downward(void* data, uint16_t /* iso_Data_size */) {
-  iso_interface->HciSend((BT_HDR*)data);
-  osi_free(data);
+  BT_HDR* packet = (BT_HDR*)data;
+  iso_interface->HciSend(packet);
+
+  // Return the buffer as the HCI layer does once the SDU is sent
+  if (packet->layer_specific & BT_ISO_HDR_FROM_SDU_POOL) {
+    const uint8_t* p = packet->data;
+    uint16_t handle;
+    STREAM_TO_UINT16(handle, p);
+    bluetooth::hci::iso_manager::IsoSduPool::GetInstance().Release(
+        HCID_GET_HANDLE(handle), packet);
+  } else {
+    osi_free(data);
+  }
 }
 
 static hci_t interface = {.set_data_cb = set_data_cb,
@@ -2146,6 +2161,103 @@ TEST_F(IsoManagerTest, SendIsoDataCigValid) {
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoDataReusesSduBuffers) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  std::vector<BT_HDR*> sent;
+  EXPECT_CALL(iso_interface_, HciSend).Times(3).WillRepeatedly([&](BT_HDR* p) {
+    ASSERT_TRUE(p->layer_specific & BT_ISO_HDR_FROM_SDU_POOL);
+    sent.push_back(p);
+  });
+
+  std::vector<uint8_t> data_vec(108, 0);
+  for (int i = 0; i < 3; i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+  }
+
+  // Each SDU is released before the next one, they all share one buffer
+  ASSERT_EQ(sent.size(), 3u);
+  ASSERT_EQ(sent[0], sent[1]);
+  ASSERT_EQ(sent[1], sent[2]);
+}
+
+TEST_F(IsoManagerTest, SendIsoSduInPlace) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  constexpr uint16_t data_len = 108;
+  std::vector<uint16_t> seq_nbs;
+  EXPECT_CALL(iso_interface_, HciSend)
+      .Times(2)
+      .WillRepeatedly([&seq_nbs](BT_HDR* p_msg) {
+        ASSERT_EQ(p_msg->len, data_len + 8);
+        uint8_t* p = p_msg->data + 4;
+        uint16_t seq_nb;
+        uint16_t msg_data_len;
+        STREAM_TO_UINT16(seq_nb, p);
+        STREAM_TO_UINT16(msg_data_len, p);
+        ASSERT_EQ(msg_data_len, data_len);
+        ASSERT_EQ(p[0], 0xa5);
+        ASSERT_EQ(p[data_len - 1], 0x5a);
+        seq_nbs.push_back(seq_nb);
+      });
+
+  std::vector<uint8_t> data_vec(data_len, 0);
+  data_vec.front() = 0xa5;
+  data_vec.back() = 0x5a;
+  IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                         data_vec.size());
+
+  uint8_t* sdu = IsoManager::GetInstance()->AcquireIsoSdu(handle, data_len);
+  ASSERT_NE(sdu, nullptr);
+  std::copy(data_vec.begin(), data_vec.end(), sdu);
+  IsoManager::GetInstance()->SendIsoSdu(handle);
+
+  // The SDU written in place takes the next sequence number
+  ASSERT_EQ(seq_nbs.size(), 2u);
+  ASSERT_EQ(seq_nbs[1], seq_nbs[0] + 1);
+
+  // Nothing left to send
+  IsoManager::GetInstance()->SendIsoSdu(handle);
+}
+
+TEST_F(IsoManagerTest, AcquireIsoSduWithNoDataPath) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  EXPECT_CALL(iso_interface_, HciSend).Times(0);
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  ASSERT_EQ(IsoManager::GetInstance()->AcquireIsoSdu(handle, 108), nullptr);
+}
+
 TEST_F(IsoManagerTest, SendIsoDataBigValid) {
   IsoManager::GetInstance()->CreateBig(volatile_test_big_params_evt_.big_id,
                                        kDefaultBigParams);
@@ -2326,6 +2438,42 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoDataLatencyDumped) {
+  std::vector<uint8_t> data_vec(108, 0);
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  for (auto& handle : volatile_test_cig_create_cmpl_evt_.conn_handles) {
+    params.conn_pairs.push_back({handle, 1});
+  }
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  EXPECT_CALL(iso_interface_, HciSend).Times(2);
+  for (int i = 0; i < 2; i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+  }
+  IsoManager::GetInstance()->HandleNumComplDataPkts(handle, 2);
+
+  FILE* dump = tmpfile();
+  ASSERT_NE(dump, nullptr);
+  IsoManager::GetInstance()->Dump(fileno(dump));
+
+  std::string dumped(16384, '\0');
+  rewind(dump);
+  dumped.resize(fread(dumped.data(), 1, dumped.size(), dump));
+  fclose(dump);
+
+  ASSERT_NE(dumped.find("TX submission to completion (us): count 2,"),
+            std::string::npos);
+}
+
 TEST_F(IsoManagerTest, SendIsoDataCreditsReturnedByDisconnection) {
   uint8_t num_buffers =
       controller_.GetControllerIsoBufferSize().total_num_le_packets_;
@@ -2509,6 +2657,41 @@ TEST_F(IsoManagerTest, HandleIsoData) {
   IsoManager::GetInstance()->HandleIsoData(dummy_msg.data());
 }
 
+TEST_F(IsoManagerTest, HandleIsoSdu) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  IsoManager::GetInstance()->EstablishCis({{{handle, 1}}});
+
+  std::vector<uint8_t> packet(12);
+  uint8_t* p = packet.data();
+  UINT16_TO_STREAM(p, handle | 0x2000);  // Complete SDU
+  UINT16_TO_STREAM(p, 8);                // Data load length
+  UINT16_TO_STREAM(p, 0);                // Packet sequence number
+  UINT16_TO_STREAM(p, 4);                // SDU length
+
+  // The SDU is read in place, without a buffer
+  EXPECT_CALL(
+      *cig_callbacks_,
+      OnCisEvent(bluetooth::hci::iso_manager::kIsoEventCisDataAvailable, _))
+      .WillOnce([&packet](uint8_t /* event */, void* data) {
+        auto* evt = static_cast<bluetooth::hci::iso_manager::cis_data_evt*>(
+            data);
+        ASSERT_EQ(evt->p_msg, nullptr);
+        ASSERT_EQ(evt->sdu, packet.data() + 8);
+        ASSERT_EQ(evt->sdu_len, 4);
+      });
+  IsoManager::GetInstance()->HandleIsoSdu(packet.data(), packet.size());
+
+  // A packet shorter than its header tells is dropped
+  EXPECT_CALL(
+      *cig_callbacks_,
+      OnCisEvent(bluetooth::hci::iso_manager::kIsoEventCisDataAvailable, _))
+      .Times(0);
+  IsoManager::GetInstance()->HandleIsoSdu(packet.data(), packet.size() - 1);
+}
+
 /* This test case simulates HCI thread scheduling events on the main thread,
  * without knowing the we are already shutting down the stack and Iso Manager
  * is already stopped.
@@ -98,6 +98,15 @@ EattChannel* EattExtension::GetChannelAvailableForClientRequest(
   return pimpl_->GetChannelAvailableForClientRequest(bd_addr);
 }
 
+std::vector<EattChannel*> EattExtension::GetOpenedChannels(
+    const RawAddress& bd_addr) {
+  return pimpl_->GetOpenedChannels(bd_addr);
+}
+
+void EattExtension::ConnectAdditionalChannel(const RawAddress& bd_addr) {
+  pimpl_->ConnectAdditionalChannel(bd_addr);
+}
+
 /* Start stop GATT indication timer per CID */
 void EattExtension::StartIndicationConfirmationTimer(const RawAddress& bd_addr,
                                                      uint16_t cid) {
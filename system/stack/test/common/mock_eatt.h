@@ -56,6 +56,9 @@ class MockEattExtension : public EattExtension {
               (const RawAddress& bd_addr));
   MOCK_METHOD((EattChannel*), GetChannelAvailableForClientRequest,
               (const RawAddress& bd_addr));
+  MOCK_METHOD((std::vector<EattChannel*>), GetOpenedChannels,
+              (const RawAddress& bd_addr));
+  MOCK_METHOD((void), ConnectAdditionalChannel, (const RawAddress& bd_addr));
   MOCK_METHOD((void), StartIndicationConfirmationTimer,
               (const RawAddress& bd_addr, uint16_t cid));
   MOCK_METHOD((void), StopIndicationConfirmationTimer,
@@ -424,6 +424,65 @@ TEST_F(EattTest, ConnectSucceedMultipleChannels) {
   DisconnectEattDevice(connected_cids_);
 }
 
+TEST_F(EattTest, ConnectAdditionalChannel) {
+  ConnectDeviceEattSupported(5);
+
+  // All the channels are already open
+  EXPECT_CALL(l2cap_interface_,
+              ConnectCreditBasedReq(BT_PSM_EATT, test_address, _))
+      .Times(0);
+  eatt_instance_->ConnectAdditionalChannel(test_address);
+  testing::Mock::VerifyAndClearExpectations(&l2cap_interface_);
+
+  // The peer closes one of them, it is replaced once the bearers are busy
+  l2cap_app_info_.pL2CA_DisconnectInd_Cb(connected_cids_.back(), false);
+  connected_cids_.pop_back();
+  ASSERT_EQ(eatt_instance_->GetOpenedChannels(test_address).size(), 4u);
+
+  EXPECT_CALL(l2cap_interface_,
+              ConnectCreditBasedReq(BT_PSM_EATT, test_address, _))
+      .WillOnce([](uint16_t /* psm */, const RawAddress& /* bd_addr */,
+                   tL2CAP_LE_CFG_INFO* p_cfg) {
+        EXPECT_EQ(p_cfg->number_of_channels, 1);
+        return std::vector<uint16_t>{66};
+      });
+  eatt_instance_->ConnectAdditionalChannel(test_address);
+
+  // No other channel while this one is pending
+  eatt_instance_->ConnectAdditionalChannel(test_address);
+
+  l2cap_app_info_.pL2CA_CreditBasedConnectCfm_Cb(
+      test_address, 66, EATT_MIN_MTU_MPS, L2CAP_CONN_OK);
+  connected_cids_.push_back(66);
+  ASSERT_EQ(eatt_instance_->GetOpenedChannels(test_address).size(), 5u);
+  ASSERT_EQ(test_tcb.eatt, 5);
+
+  DisconnectEattDevice(connected_cids_);
+}
+
+TEST_F(EattTest, NoAdditionalChannelAfterRefusal) {
+  // The peer accepted 2 of the 5 channels
+  ConnectDeviceEattSupported(2);
+
+  EXPECT_CALL(l2cap_interface_, ConnectCreditBasedReq(_, _, _)).Times(0);
+  eatt_instance_->ConnectAdditionalChannel(test_address);
+
+  DisconnectEattDevice(connected_cids_);
+}
+
+TEST_F(EattTest, NoAdditionalChannelAsPeripheral) {
+  ConnectDeviceEattSupported(5);
+  l2cap_app_info_.pL2CA_DisconnectInd_Cb(connected_cids_.back(), false);
+  connected_cids_.pop_back();
+
+  ON_CALL(l2cap_interface_, GetBleConnRole(_))
+      .WillByDefault(Return(HCI_ROLE_PERIPHERAL));
+  EXPECT_CALL(l2cap_interface_, ConnectCreditBasedReq(_, _, _)).Times(0);
+  eatt_instance_->ConnectAdditionalChannel(test_address);
+
+  DisconnectEattDevice(connected_cids_);
+}
+
 TEST_F(EattTest, ConnectFailedEattNotSupported) {
   ON_CALL(gatt_interface_, ClientReadSupportedFeatures)
       .WillByDefault(
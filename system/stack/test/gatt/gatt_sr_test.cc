@@ -34,7 +34,13 @@ namespace {
 struct TestMutables {
   struct {
     uint8_t op_code_;
+    bool return_buffer_{false};
+    std::vector<uint16_t> handles_;
   } attp_build_sr_msg;
+  struct {
+    int access_count_{0};
+    tGATT_STATUS return_status_{GATT_SUCCESS};
+  } attp_send_sr_msg;
   struct {
     uint16_t conn_id_{0};
     uint32_t trans_id_{0};
@@ -65,7 +71,9 @@ bool is_background_connection(const RawAddress& address) { return false; }
 BT_HDR* attp_build_sr_msg(tGATT_TCB& tcb, uint8_t op_code, tGATT_SR_MSG* p_msg,
                           uint16_t payload_size) {
   test_state_.attp_build_sr_msg.op_code_ = op_code;
-  return nullptr;
+  if (!test_state_.attp_build_sr_msg.return_buffer_) return nullptr;
+  test_state_.attp_build_sr_msg.handles_.push_back(p_msg->attr_value.handle);
+  return (BT_HDR*)osi_calloc(sizeof(BT_HDR));
 }
 tGATT_STATUS attp_send_cl_confirmation_msg(tGATT_TCB& tcb, uint16_t cid) {
   return GATT_SUCCESS;
@@ -75,7 +83,9 @@ tGATT_STATUS attp_send_cl_msg(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
   return GATT_SUCCESS;
 }
 tGATT_STATUS attp_send_sr_msg(tGATT_TCB& tcb, uint16_t cid, BT_HDR* p_msg) {
-  return GATT_SUCCESS;
+  osi_free(p_msg);
+  test_state_.attp_send_sr_msg.access_count_++;
+  return test_state_.attp_send_sr_msg.return_status_;
 }
 
 void gatt_act_discovery(tGATT_CLCB* p_clcb) {}
@@ -90,6 +100,13 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
 }
 void gatt_set_ch_state(tGATT_TCB* p_tcb, tGATT_CH_STATE ch_state) {}
 Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db) { return nullptr; }
+tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
+  return nullptr;
+}
+size_t gatts_db_attr_index_lower_bound(const tGATT_SVC_DB& db,
+                                       uint16_t handle) {
+  return 0;
+}
 tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
                                          uint16_t val_len, uint8_t* p_val) {
   return GATT_SUCCESS;
@@ -164,6 +181,25 @@ class GattSrTest : public ::testing::Test {
   tGATT_SRV_LIST_ELEM el_;
 };
 
+/* Server notification queue test */
+class GattSrNotifQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tcb_.att_lcid = L2CAP_ATT_CID;
+    tcb_.payload_size = GATT_DEF_BLE_MTU_SIZE;
+    tcb_.congested_cids.insert(L2CAP_ATT_CID);
+
+    test_state_ = TestMutables();
+    test_state_.attp_build_sr_msg.return_buffer_ = true;
+  }
+
+  void QueueNotif(uint16_t handle, uint8_t value) {
+    gatt_sr_queue_notif(tcb_, false, handle, 1, &value);
+  }
+
+  tGATT_TCB tcb_{};
+};
+
 /* Server Robust Caching Test */
 class GattSrRobustCachingTest : public ::testing::Test {
  protected:
@@ -564,3 +600,63 @@ TEST_F(GattSrRobustCachingTest,
 
   ASSERT_FALSE(should_ignore);
 }
+
+TEST_F(GattSrNotifQueueTest, notif_queued_while_congested) {
+  ASSERT_TRUE(gatt_sr_should_queue_notif(tcb_, L2CAP_ATT_CID));
+
+  tcb_.congested_cids.clear();
+  ASSERT_FALSE(gatt_sr_should_queue_notif(tcb_, L2CAP_ATT_CID));
+
+  // Notifications are kept in order behind the ones already held
+  QueueNotif(1, 0x01);
+  ASSERT_TRUE(gatt_sr_should_queue_notif(tcb_, L2CAP_ATT_CID));
+}
+
+TEST_F(GattSrNotifQueueTest, notif_of_same_handle_coalesced) {
+  QueueNotif(1, 0x01);
+  QueueNotif(2, 0x02);
+  QueueNotif(1, 0x03);
+
+  ASSERT_EQ(2u, tcb_.notif_q.size());
+  ASSERT_EQ(1, tcb_.notif_q.front().handle);
+  ASSERT_EQ(std::vector<uint8_t>{0x03}, tcb_.notif_q.front().value);
+  ASSERT_EQ(0u, tcb_.notif_q_dropped);
+}
+
+TEST_F(GattSrNotifQueueTest, oldest_notif_dropped_when_queue_full) {
+  for (uint16_t handle = 1; handle <= GATT_NOTIF_QUEUE_MAX + 1; handle++) {
+    QueueNotif(handle, 0x00);
+  }
+
+  ASSERT_EQ((size_t)GATT_NOTIF_QUEUE_MAX, tcb_.notif_q.size());
+  ASSERT_EQ(2, tcb_.notif_q.front().handle);
+  ASSERT_EQ(1u, tcb_.notif_q_dropped);
+}
+
+TEST_F(GattSrNotifQueueTest, queued_notifs_sent_when_uncongested) {
+  QueueNotif(1, 0x01);
+  QueueNotif(2, 0x02);
+
+  gatt_sr_send_queued_notifs(tcb_);
+  ASSERT_EQ(0, test_state_.attp_send_sr_msg.access_count_);
+
+  tcb_.congested_cids.erase(L2CAP_ATT_CID);
+  gatt_sr_send_queued_notifs(tcb_);
+  ASSERT_EQ(2, test_state_.attp_send_sr_msg.access_count_);
+  ASSERT_EQ((std::vector<uint16_t>{1, 2}),
+            test_state_.attp_build_sr_msg.handles_);
+  ASSERT_EQ(GATT_HANDLE_VALUE_NOTIF, test_state_.attp_build_sr_msg.op_code_);
+  ASSERT_TRUE(tcb_.notif_q.empty());
+}
+
+TEST_F(GattSrNotifQueueTest, queued_notifs_held_when_congested_again) {
+  QueueNotif(1, 0x01);
+  QueueNotif(2, 0x02);
+  tcb_.congested_cids.erase(L2CAP_ATT_CID);
+  test_state_.attp_send_sr_msg.return_status_ = GATT_CONGESTED;
+
+  gatt_sr_send_queued_notifs(tcb_);
+  ASSERT_EQ(1, test_state_.attp_send_sr_msg.access_count_);
+  ASSERT_EQ(1u, tcb_.notif_q.size());
+  ASSERT_EQ(2, tcb_.notif_q.front().handle);
+}
@@ -23,15 +23,18 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/strings.h"
 #include "gd/os/rand.h"
 #include "osi/include/allocator.h"
+#include "stack/gatt/gatt_bearer_pool.h"
 #include "stack/gatt/gatt_int.h"
 #include "stack/include/bt_types.h"
 #include "stack/include/gatt_api.h"
 #include "stack/include/l2c_api.h"
 #include "stack/sdp/internal/sdp_api.h"
+#include "test/mock/mock_stack_btm_ble.h"
 #include "test/mock/mock_stack_sdp_legacy_api.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
@@ -389,3 +392,73 @@ TEST_F(StackGattTest, attp_build_value_cmd_read_by_type_test_long_data) {
       payload_size, op_code, handle, offset_0, data_size, data);
   ASSERT_EQ(ret, nullptr);
 }
+
+TEST_F(StackGattTest, gatt_set_bulk_transfer) {
+  std::vector<uint8_t> phys;
+  std::vector<uint16_t> data_lengths;
+  test::mock::stack_btm_ble::BTM_BleSetPhy.body =
+      [&phys](const RawAddress& /* bd_addr */, uint8_t tx_phys,
+              uint8_t /* rx_phys */,
+              uint16_t /* phy_options */) { phys.push_back(tx_phys); };
+  test::mock::stack_btm_ble::BTM_SetBleDataLength.body =
+      [&data_lengths](const RawAddress& /* bd_addr */, uint16_t tx_pdu_length) {
+        data_lengths.push_back(tx_pdu_length);
+        return BTM_SUCCESS;
+      };
+  test::mock::stack_btm_ble::BTM_RestoreBleDataLength.body =
+      [&data_lengths](const RawAddress& /* bd_addr */, uint16_t tx_pdu_length) {
+        data_lengths.push_back(tx_pdu_length);
+        return BTM_SUCCESS;
+      };
+
+  tGATT_TCB tcb{};
+  tcb.transport = BT_TRANSPORT_LE;
+  tcb.max_user_mtu = 100;
+
+  // The first application maximizes the link, the second one shares it
+  gatt_set_bulk_transfer(tcb, 1, true);
+  gatt_set_bulk_transfer(tcb, 2, true);
+  ASSERT_EQ(phys, std::vector<uint8_t>({PHY_LE_2M}));
+  ASSERT_EQ(data_lengths, std::vector<uint16_t>({BTM_BLE_DATA_SIZE_MAX}));
+
+  // The link stays maximized until the last application is done
+  gatt_set_bulk_transfer(tcb, 1, false);
+  gatt_set_bulk_transfer(tcb, 1, false);
+  ASSERT_EQ(phys.size(), 1u);
+  gatt_set_bulk_transfer(tcb, 2, false);
+  ASSERT_EQ(phys, std::vector<uint8_t>({PHY_LE_2M, PHY_LE_1M}));
+  ASSERT_EQ(data_lengths,
+            std::vector<uint16_t>(
+                {BTM_BLE_DATA_SIZE_MAX, 100 + L2CAP_PKT_OVERHEAD}));
+
+  // BR/EDR links are left alone
+  tcb.transport = BT_TRANSPORT_BR_EDR;
+  gatt_set_bulk_transfer(tcb, 1, true);
+  ASSERT_EQ(phys.size(), 2u);
+
+  test::mock::stack_btm_ble::BTM_BleSetPhy = {};
+  test::mock::stack_btm_ble::BTM_SetBleDataLength = {};
+  test::mock::stack_btm_ble::BTM_RestoreBleDataLength = {};
+}
+
+TEST_F(StackGattTest, gatt_select_bearer) {
+  // The idle bearer is picked over the busy ones
+  ASSERT_EQ(
+      gatt_select_bearer({{0x40, 1, 256}, {0x41, 0, 256}, {0x04, 2, 517}}),
+      1u);
+
+  // Among idle bearers the one with the largest MTU takes the request
+  ASSERT_EQ(
+      gatt_select_bearer({{0x40, 0, 256}, {0x41, 0, 256}, {0x04, 0, 517}}),
+      2u);
+
+  // Equal bearers keep their order
+  ASSERT_EQ(gatt_select_bearer({{0x40, 0, 256}, {0x41, 0, 256}}), 0u);
+
+  // When all are busy, the shortest queue wins
+  ASSERT_EQ(
+      gatt_select_bearer({{0x40, 3, 256}, {0x41, 2, 256}, {0x04, 4, 517}}),
+      1u);
+
+  ASSERT_EQ(gatt_select_bearer({{0x04, 5, 23}}), 0u);
+}
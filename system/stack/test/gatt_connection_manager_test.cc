@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <vector>
 
 #include "common/init_flags.h"
 #include "osi/include/alarm.h"
@@ -29,6 +30,7 @@ class AcceptlistMock {
   MOCK_METHOD1(AcceptlistAdd, bool(const RawAddress&));
   MOCK_METHOD2(AcceptlistAdd, bool(const RawAddress&, bool is_direct));
   MOCK_METHOD1(AcceptlistRemove, void(const RawAddress&));
+  MOCK_METHOD1(AcceptlistRemoveMany, void(const std::vector<RawAddress>&));
   MOCK_METHOD0(AcceptlistClear, void());
   MOCK_METHOD2(OnConnectionTimedOut, void(uint8_t, const RawAddress&));
 
@@ -61,6 +63,10 @@ void BTM_AcceptlistRemove(const RawAddress& address) {
   return localAcceptlistMock->AcceptlistRemove(address);
 }
 
+void BTM_AcceptlistRemove(const std::vector<RawAddress>& addresses) {
+  return localAcceptlistMock->AcceptlistRemoveMany(addresses);
+}
+
 void BTM_AcceptlistClear() { return localAcceptlistMock->AcceptlistClear(); }
 
 void BTM_BleTargetAnnouncementObserve(bool enable,
@@ -256,14 +262,51 @@ TEST_F(BleConnectionManager, test_app_unregister) {
   EXPECT_TRUE(direct_connect_add(CLIENT2, address2));
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 
-  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address1)).Times(1);
+  EXPECT_CALL(*localAcceptlistMock,
+              AcceptlistRemoveMany(std::vector<RawAddress>{address1}))
+      .Times(1);
   on_app_deregistered(CLIENT1);
   Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
 
-  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(address2)).Times(1);
+  EXPECT_CALL(*localAcceptlistMock,
+              AcceptlistRemoveMany(std::vector<RawAddress>{address2}))
+      .Times(1);
   on_app_deregistered(CLIENT2);
 }
 
+/** Verify that all the devices left by an unregistered application are removed
+ * from the acceptlist with a single update */
+TEST_F(BleConnectionManager, test_app_unregister_batches_removal) {
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1))
+      .WillOnce(Return(true));
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address2))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(background_connect_add(CLIENT1, address1));
+  EXPECT_TRUE(background_connect_add(CLIENT1, address2));
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  auto pending = get_pending_connections();
+  EXPECT_EQ(pending.background, 2u);
+  EXPECT_EQ(pending.direct, 0u);
+  EXPECT_EQ(pending.in_accept_list, 2u);
+
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemove(_)).Times(0);
+  EXPECT_CALL(*localAcceptlistMock,
+              AcceptlistRemoveMany(
+                  std::vector<RawAddress>{address1, address2}))
+      .Times(1);
+  on_app_deregistered(CLIENT1);
+  Mock::VerifyAndClearExpectations(localAcceptlistMock.get());
+
+  pending = get_pending_connections();
+  EXPECT_EQ(pending.background, 0u);
+  EXPECT_EQ(pending.in_accept_list, 0u);
+
+  // Nothing left to remove
+  EXPECT_CALL(*localAcceptlistMock, AcceptlistRemoveMany(_)).Times(0);
+  on_app_deregistered(CLIENT1);
+}
+
 /** Verify adding device to both direct connection and background connection. */
 TEST_F(BleConnectionManager, test_direct_and_background_connect) {
   EXPECT_CALL(*localAcceptlistMock, AcceptlistAdd(address1, true))
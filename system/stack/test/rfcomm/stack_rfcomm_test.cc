@@ -30,6 +30,7 @@
 #include "stack/include/l2cdefs.h"
 #include "stack/include/port_api.h"
 #include "stack/include/rfcdefs.h"
+#include "stack/rfcomm/port_int.h"
 #include "stack_rfcomm_test_utils.h"
 #include "stack_test_packet_utils.h"
 #include "types/raw_address.h"
@@ -888,4 +889,77 @@ TEST_F(StackRfcommTest, DISABLED_TestConnectionCollision) {
   l2cap_appl_info_.pL2CA_DataInd_Cb(new_lcid, uih_msc_rsp_from_peer);
 }
 
+int port_data_co_cback(uint16_t /* port_handle */, uint8_t* /* p_buf */,
+                       uint16_t /* len */, int /* type */) {
+  return 1;
+}
+
+TEST(StackRfcommCreditTest, ScaleCreditRxWithApplicationDrain) {
+  tPORT port = {};
+  port.credit_rx_base = port.credit_rx_max = 10;
+  port.credit_rx_low = 4;
+  port.credit_rx_limit = 64;
+
+  // Data queued in the port is not scaled
+  port_scale_credit_rx(&port, true);
+  EXPECT_EQ(port.credit_rx_max, 10);
+
+  port.p_data_co_callback = port_data_co_cback;
+  port_scale_credit_rx(&port, true);
+  EXPECT_EQ(port.credit_rx_max, 20);
+  EXPECT_EQ(port.credit_rx_low, 8);
+  port_scale_credit_rx(&port, true);
+  port_scale_credit_rx(&port, true);
+  EXPECT_EQ(port.credit_rx_max, 64);
+  port_scale_credit_rx(&port, true);
+  EXPECT_EQ(port.credit_rx_max, 64);
+  EXPECT_EQ(port.stats.credit_window_grown, 3u);
+
+  port_scale_credit_rx(&port, false);
+  EXPECT_EQ(port.credit_rx_max, 32);
+  port_scale_credit_rx(&port, false);
+  port_scale_credit_rx(&port, false);
+  EXPECT_EQ(port.credit_rx_max, 10);
+  EXPECT_EQ(port.credit_rx_low, 4);
+  EXPECT_EQ(port.stats.credit_window_shrunk, 3u);
+}
+
+TEST(StackRfcommRxRingTest, ReadAcrossFrames) {
+  tPORT port = {};
+  port.mtu = 8;
+  port.rx_buf_critical = 3;
+
+  BT_HDR* p_buf = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + 8);
+  for (uint8_t i = 0; i < 3; i++) {
+    p_buf->len = 6;
+    memset(p_buf->data, 'a' + i, p_buf->len);
+    EXPECT_TRUE(port_rx_enqueue(&port, p_buf));
+  }
+  // Out of frames
+  EXPECT_FALSE(port_rx_enqueue(&port, p_buf));
+  EXPECT_EQ(port.rx.queue_size, 18u);
+
+  uint8_t data[16];
+  uint16_t frames;
+  EXPECT_EQ(port_rx_read(&port, data, 8, &frames), 8);
+  EXPECT_EQ(frames, 1);
+  EXPECT_EQ(std::string((char*)data, 8), "aaaaaabb");
+
+  // The ring wraps around
+  p_buf->len = 8;
+  memset(p_buf->data, 'd', p_buf->len);
+  EXPECT_TRUE(port_rx_enqueue(&port, p_buf));
+  EXPECT_EQ(port_rx_read(&port, data, sizeof(data), &frames), 16);
+  EXPECT_EQ(frames, 2);
+  EXPECT_EQ(std::string((char*)data, 16), "bbbbccccccdddddd");
+  EXPECT_EQ(port_rx_read(&port, data, sizeof(data), &frames), 2);
+  EXPECT_EQ(frames, 1);
+  EXPECT_EQ(port.rx_frame_count, 0);
+  EXPECT_EQ(port.rx.queue_size, 0u);
+
+  port_rx_flush(&port);
+  EXPECT_EQ(port.rx_ring, nullptr);
+  osi_free(p_buf);
+}
+
 }  // namespace
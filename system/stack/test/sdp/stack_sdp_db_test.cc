@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
+#include "stack/include/bt_uuid16.h"
 #include "stack/include/sdp_api.h"
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdpint.h"
@@ -196,3 +199,74 @@ TEST_F(StackSdpDbTest, SDP_AddAttribute__three_attributes_replace_middle) {
   ASSERT_TRUE(
       get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(record_handle));
 }
+
+namespace {
+tSDP_UUID_SEQ make_uuid_seq(const std::vector<bluetooth::Uuid>& uuids,
+                            size_t uuid_len) {
+  tSDP_UUID_SEQ seq{};
+  for (const auto& uuid : uuids) {
+    tUID_ENT& entry = seq.uuid_entry[seq.num_uids++];
+    entry.len = uuid_len;
+    if (uuid_len == bluetooth::Uuid::kNumBytes16) {
+      entry.value[0] = uuid.As16Bit() >> 8;
+      entry.value[1] = uuid.As16Bit() & 0xff;
+    } else {
+      memcpy(entry.value, uuid.To128BitBE().data(),
+             bluetooth::Uuid::kNumBytes128);
+    }
+  }
+  return seq;
+}
+}  // namespace
+
+TEST_F(StackSdpDbTest, sdp_db_service_search__uuid_index) {
+  uint16_t serial_port = UUID_SERVCLASS_SERIAL_PORT;
+  uint16_t services[] = {UUID_SERVCLASS_AUDIO_SOURCE,
+                         UUID_SERVCLASS_SERIAL_PORT};
+  const bluetooth::Uuid kSerialPort =
+      bluetooth::Uuid::From16Bit(UUID_SERVCLASS_SERIAL_PORT);
+  const bluetooth::Uuid kAudioSource =
+      bluetooth::Uuid::From16Bit(UUID_SERVCLASS_AUDIO_SOURCE);
+
+  uint32_t first_handle = get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  uint32_t second_handle =
+      get_legacy_stack_sdp_api()->handle.SDP_CreateRecord();
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(
+      first_handle, 1, &serial_port));
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(
+      second_handle, 2, services));
+
+  // The records are returned in database order, whatever the UUID size.
+  tSDP_UUID_SEQ seq = make_uuid_seq({kSerialPort}, 2);
+  const tSDP_RECORD* record = sdp_db_service_search(nullptr, &seq);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(first_handle, record->record_handle);
+  record = sdp_db_service_search(record, &seq);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(second_handle, record->record_handle);
+  ASSERT_EQ(nullptr, sdp_db_service_search(record, &seq));
+
+  // A record matches when it contains all the UUIDs.
+  seq = make_uuid_seq({kSerialPort, kAudioSource}, 16);
+  record = sdp_db_service_search(nullptr, &seq);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(second_handle, record->record_handle);
+
+  // The index follows the changes of the records.
+  ASSERT_TRUE(get_legacy_stack_sdp_api()->handle.SDP_AddServiceClassIdList(
+      first_handle, 2, services));
+  record = sdp_db_service_search(nullptr, &seq);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(first_handle, record->record_handle);
+
+  ASSERT_TRUE(
+      get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(first_handle));
+  record = sdp_db_service_search(nullptr, &seq);
+  ASSERT_TRUE(record != nullptr);
+  ASSERT_EQ(second_handle, record->record_handle);
+  ASSERT_EQ(nullptr, sdp_db_service_search(record, &seq));
+
+  ASSERT_TRUE(
+      get_legacy_stack_sdp_api()->handle.SDP_DeleteRecord(second_handle));
+  ASSERT_EQ(nullptr, sdp_db_service_search(nullptr, &seq));
+}
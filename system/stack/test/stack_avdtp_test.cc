@@ -449,3 +449,51 @@ TEST_F(StackAvdtpTest, avdt_scb_hdl_pkt_no_frag_regression_test3) {
   // thus vt_data.p_pkt will be set to nullptr
   ASSERT_EQ(evt_data.p_pkt, nullptr);
 }
+
+TEST_F(StackAvdtpTest, avdt_scb_build_media_hdr) {
+  AvdtpScb* pscb = avdt_scb_by_hdl(scb_handle_);
+  ASSERT_NE(pscb, nullptr);
+  pscb->stream_config.cfg.codec_info[1] = 0x01;
+  pscb->stream_config.cfg.codec_info[2] = 0x02;
+
+  avdt_scb_build_media_hdr(pscb);
+
+  const uint8_t expected[AVDT_MEDIA_HDR_SIZE] = {
+      0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03};
+  ASSERT_TRUE(pscb->media_hdr_valid);
+  ASSERT_EQ(memcmp(pscb->media_hdr, expected, AVDT_MEDIA_HDR_SIZE), 0);
+}
+
+TEST_F(StackAvdtpTest, avdt_scb_hdl_write_req_without_headroom) {
+  BT_HDR* p_pkt = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + 100);
+  p_pkt->offset = AVDT_MEDIA_L2CAP_HEADROOM - 1;
+  p_pkt->len = 10;
+  tAVDT_SCB_EVT evt_data{};
+  evt_data.apiwrite.p_buf = p_pkt;
+  evt_data.apiwrite.opt = AVDT_DATA_OPT_NO_RTP;
+
+  AvdtpScb* pscb = avdt_scb_by_hdl(scb_handle_);
+  ASSERT_NE(pscb, nullptr);
+
+  // the packet is dropped, any leak would be caught by the address sanitizer
+  avdt_scb_hdl_write_req(pscb, &evt_data);
+  ASSERT_EQ(pscb->p_pkt, nullptr);
+}
+
+TEST_F(StackAvdtpTest, avdt_scb_hdl_write_req_with_headroom) {
+  BT_HDR* p_pkt = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + 100);
+  p_pkt->offset = AVDT_MEDIA_L2CAP_HEADROOM;
+  p_pkt->len = 10;
+  tAVDT_SCB_EVT evt_data{};
+  evt_data.apiwrite.p_buf = p_pkt;
+  evt_data.apiwrite.opt = AVDT_DATA_OPT_NO_RTP;
+
+  AvdtpScb* pscb = avdt_scb_by_hdl(scb_handle_);
+  ASSERT_NE(pscb, nullptr);
+
+  avdt_scb_hdl_write_req(pscb, &evt_data);
+  ASSERT_EQ(pscb->p_pkt, p_pkt);
+  ASSERT_EQ(p_pkt->offset, AVDT_MEDIA_L2CAP_HEADROOM);
+  ASSERT_EQ(p_pkt->len, 10);
+  osi_free_and_reset((void**)&pscb->p_pkt);
+}
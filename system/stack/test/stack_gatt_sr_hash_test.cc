@@ -18,7 +18,14 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <list>
+#include <vector>
+
+#include "osi/include/allocator.h"
 #include "stack/gatt/gatt_int.h"
+#include "stack/include/l2c_api.h"
+#include "stack/include/l2cdefs.h"
 #include "types/bluetooth/uuid.h"
 
 using bluetooth::Uuid;
@@ -83,3 +90,92 @@ TEST(GattDatabaseTest, matchExampleInBtSpecV52) {
 
   ASSERT_EQ(result_hash, expected_hash);
 }
+
+TEST(GattDatabaseTest, findAttributeByHandle) {
+  tGATT_SVC_DB db;
+  gatts_init_service_db(db, Uuid::From16Bit(0x1800), true, 0x0010, 6);
+  gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A00));
+  gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A01));
+  gatts_add_char_descr(db, GATT_PERM_READ, Uuid::From16Bit(0x2902));
+
+  for (uint16_t handle = 0x0010; handle <= 0x0015; handle++) {
+    tGATT_ATTR* p_attr = find_attr_by_handle(&db, handle);
+    ASSERT_NE(nullptr, p_attr);
+    ASSERT_EQ(handle, p_attr->handle);
+  }
+  ASSERT_EQ(nullptr, find_attr_by_handle(&db, 0x000F));
+  ASSERT_EQ(nullptr, find_attr_by_handle(&db, 0x0016));
+  ASSERT_EQ(nullptr, find_attr_by_handle(nullptr, 0x0010));
+
+  ASSERT_EQ(0u, gatts_db_attr_index_lower_bound(db, 0x0001));
+  ASSERT_EQ(3u, gatts_db_attr_index_lower_bound(db, 0x0013));
+  ASSERT_EQ(6u, gatts_db_attr_index_lower_bound(db, 0x0100));
+}
+
+TEST(GattDatabaseTest, readAttributeValueByType) {
+  tGATT_SVC_DB db;
+  gatts_init_service_db(db, Uuid::From16Bit(0x1800), true, 0x0010, 6);
+  gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A00));
+  gatts_add_char_descr(db, GATT_PERM_READ, Uuid::From16Bit(0x2902));
+  gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_WRITE,
+                           Uuid::From16Bit(0x2A01));
+
+  const Uuid char_declare = Uuid::From16Bit(GATT_UUID_CHAR_DECLARE);
+  ASSERT_EQ((std::vector<uint16_t>{1, 4}), db.attr_index_by_type[char_declare]);
+
+  tGATT_TCB tcb;
+  tGATT_SEC_FLAG sec_flag{};
+  BT_HDR* p_rsp = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + 64);
+  uint16_t len = 64;
+  uint16_t err_hdl = 0;
+  // Starts past the first characteristic declaration.
+  ASSERT_EQ(GATT_SUCCESS,
+            gatts_db_read_attr_value_by_type(
+                tcb, L2CAP_ATT_CID, &db, GATT_REQ_READ_BY_TYPE, p_rsp, 0x0012,
+                0xFFFF, char_declare, &len, sec_flag, 0, 0, &err_hdl));
+
+  // handle, properties, value handle, value UUID
+  const uint8_t expected[] = {0x14, 0x00, GATT_CHAR_PROP_BIT_WRITE,
+                              0x15, 0x00, 0x01, 0x2A};
+  ASSERT_EQ(sizeof(expected), p_rsp->len);
+  ASSERT_EQ(0, memcmp(expected, (uint8_t*)(p_rsp + 1) + L2CAP_MIN_OFFSET,
+                      sizeof(expected)));
+  osi_free(p_rsp);
+}
+
+TEST(GattDatabaseTest, databaseHashIsComputedLazily) {
+  tGATT_SVC_DB local_db[2];
+  std::list<tGATT_SRV_LIST_ELEM> srv_list_info;
+  add_item_to_list(srv_list_info, &local_db[0], true);
+  gatts_init_service_db(local_db[0], Uuid::From16Bit(0x1800), true, 0x0001, 3);
+  gatts_add_characteristic(local_db[0], GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A00));
+  gatt_cb.srv_list_info = &srv_list_info;
+
+  gatts_mark_database_hash_stale();
+  uint32_t count = gatt_cb.database_hash_stats.count;
+  Octet16 first_hash = gatts_get_database_hash();
+  ASSERT_EQ(first_hash, gatts_get_database_hash());
+  ASSERT_EQ(count + 1, gatt_cb.database_hash_stats.count);
+  ASSERT_FALSE(srv_list_info.front().hash_info.empty());
+
+  add_item_to_list(srv_list_info, &local_db[1], false);
+  gatts_init_service_db(local_db[1], Uuid::From16Bit(0x180F), false, 0x0004, 3);
+  gatts_add_characteristic(local_db[1], GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                           Uuid::From16Bit(0x2A19));
+  gatts_mark_database_hash_stale();
+  ASSERT_EQ(count + 1, gatt_cb.database_hash_stats.count);
+
+  Octet16 second_hash = gatts_get_database_hash();
+  ASSERT_NE(first_hash, second_hash);
+  ASSERT_EQ(count + 2, gatt_cb.database_hash_stats.count);
+
+  // Cached service serializations give the same result as a fresh one.
+  for (auto& el : srv_list_info) el.hash_info.clear();
+  ASSERT_EQ(second_hash, gatts_calculate_database_hash(&srv_list_info));
+
+  gatt_cb.srv_list_info = nullptr;
+}
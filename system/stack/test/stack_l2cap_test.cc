@@ -20,15 +20,21 @@
 #include <gtest/gtest.h>
 #include <sys/socket.h>
 
+#include <algorithm>
+
 #include "bt_psm_types.h"
 #include "common/init_flags.h"
 #include "hci/controller_interface_mock.h"
 #include "osi/include/allocator.h"
 #include "stack/btm/btm_int_types.h"
+#include "stack/include/bt_types.h"
 #include "stack/include/l2cap_controller_interface.h"
 #include "stack/include/l2cap_hci_link_interface.h"
 #include "stack/include/l2cdefs.h"
+#include "stack/l2cap/l2c_ble_conn_interval.h"
+#include "stack/l2cap/l2c_fcr_crc.h"
 #include "stack/l2cap/l2c_int.h"
+#include "stack/l2cap/l2c_run_queue.h"
 #include "test/mock/mock_main_shim_entry.h"
 
 tBTM_CB btm_cb;
@@ -90,6 +96,43 @@ TEST_F(StackL2capTest, l2cble_process_data_length_change_event) {
   ASSERT_EQ(0x001b, l2cb.lcb_pool[0].tx_data_len);
 }
 
+TEST_F(StackL2capTest, lcb_lookup_tables) {
+  const RawAddress kRpa({0x41, 0x22, 0x33, 0x44, 0x55, 0x66});
+  const RawAddress kIdentity({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+  tL2C_LCB* p_br = l2cu_allocate_lcb(kRpa, false, BT_TRANSPORT_BR_EDR);
+  tL2C_LCB* p_le = l2cu_allocate_lcb(kRpa, false, BT_TRANSPORT_LE);
+  ASSERT_EQ(p_br, l2cu_find_lcb_by_bd_addr(kRpa, BT_TRANSPORT_BR_EDR));
+  ASSERT_EQ(p_le, l2cu_find_lcb_by_bd_addr(kRpa, BT_TRANSPORT_LE));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_bd_addr(kIdentity, BT_TRANSPORT_LE));
+
+  l2cu_set_lcb_handle(*p_br, 0x0001);
+  l2cu_set_lcb_handle(*p_le, 0x0040);
+  ASSERT_EQ(p_br, l2cu_find_lcb_by_handle(0x0001));
+  ASSERT_EQ(p_le, l2cu_find_lcb_by_handle(0x0040));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0002));
+
+  // The LE link moves to the bucket of the identity address
+  L2CA_Consolidate(kIdentity, kRpa);
+  ASSERT_EQ(p_le, l2cu_find_lcb_by_bd_addr(kIdentity, BT_TRANSPORT_LE));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_bd_addr(kRpa, BT_TRANSPORT_LE));
+  ASSERT_EQ(p_br, l2cu_find_lcb_by_bd_addr(kRpa, BT_TRANSPORT_BR_EDR));
+
+  l2cu_release_lcb(p_br);
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_bd_addr(kRpa, BT_TRANSPORT_BR_EDR));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0001));
+  ASSERT_EQ(p_le, l2cu_find_lcb_by_bd_addr(kIdentity, BT_TRANSPORT_LE));
+
+  // A released LCB is reused for another peer
+  tL2C_LCB* p_lcb = l2cu_allocate_lcb(kIdentity, false, BT_TRANSPORT_BR_EDR);
+  ASSERT_EQ(p_br, p_lcb);
+  ASSERT_EQ(p_lcb, l2cu_find_lcb_by_bd_addr(kIdentity, BT_TRANSPORT_BR_EDR));
+  ASSERT_EQ(p_le, l2cu_find_lcb_by_bd_addr(kIdentity, BT_TRANSPORT_LE));
+
+  l2cu_release_lcb(p_lcb);
+  l2cu_release_lcb(p_le);
+}
+
 class StackL2capChannelTest : public StackL2capTest {
  protected:
   void SetUp() override { StackL2capTest::SetUp(); }
@@ -118,7 +161,7 @@ class StackL2capChannelTest : public StackL2capTest {
               .number_of_channels = L2CAP_CREDIT_BASED_MAX_CIDS,
           },
       .is_first_seg = false,
-      .ble_sdu = nullptr,     // BT_HDR*; Buffer for storing unassembled sdu
+      .ble_sdu = {},          // tL2C_RX_SDU; Segments of unassembled sdu
       .ble_sdu_length = 0,    /* Length of unassembled sdu length*/
       .p_next_ccb = nullptr,  // struct t_l2c_ccb* Next CCB in the chain
       .p_prev_ccb = nullptr,  // struct t_l2c_ccb* Previous CCB in the chain
@@ -165,8 +208,7 @@ class StackL2capChannelTest : public StackL2capTest {
               .rej_after_srej = false,
               .send_f_rsp = false,
               .rx_sdu_len = 0,
-              .p_rx_sdu =
-                  nullptr,  // BT_HDR* Buffer holding the SDU being received
+              .rx_sdu = {},  // tL2C_RX_SDU Segments of the SDU being received
               .waiting_for_ack_q = nullptr,  // fixed_queue_t*
               .srej_rcv_hold_q = nullptr,    // fixed_queue_t*
               .retrans_q = nullptr,          // fixed_queue_t*
@@ -204,6 +246,29 @@ TEST_F(StackL2capChannelTest, l2c_lcc_proc_pdu__NextSegment) {
   l2c_lcc_proc_pdu(&ccb_, p_buf);
 }
 
+TEST_F(StackL2capChannelTest, l2c_lcc_proc_pdu__HoldsSegments) {
+  ccb_.is_first_seg = true;
+
+  BT_HDR* p_buf = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + 32);
+  p_buf->len = 32;
+  uint8_t* p = (uint8_t*)(p_buf + 1);
+  UINT16_TO_STREAM(p, 80);
+  l2c_lcc_proc_pdu(&ccb_, p_buf);
+  ASSERT_FALSE(ccb_.is_first_seg);
+  ASSERT_EQ(80, ccb_.ble_sdu_length);
+  ASSERT_EQ(30, ccb_.ble_sdu.len);
+
+  p_buf = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + 32);
+  p_buf->len = 32;
+  l2c_lcc_proc_pdu(&ccb_, p_buf);
+  ASSERT_FALSE(ccb_.is_first_seg);
+  ASSERT_EQ(62, ccb_.ble_sdu.len);
+  ASSERT_EQ(2u, list_length(ccb_.ble_sdu.segments));
+
+  l2c_fcr_cleanup(&ccb_);
+  ASSERT_EQ(nullptr, ccb_.ble_sdu.segments);
+}
+
 TEST_F(StackL2capChannelTest, l2c_link_init) {
   l2cb.num_lm_acl_bufs = 0;
   l2cb.controller_xmit_window = 0;
@@ -295,3 +360,179 @@ TEST_F(StackL2capTest, bt_psm_text) {
     bluetooth::log::info("{} {} ", bt_psm_text(it.first), it.second);
   }
 }
+
+TEST(StackL2capFcsTest, known_value) {
+  const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  ASSERT_EQ(0xbb3d, l2c_fcr_updcrc(L2CAP_FCR_INIT_CRC, data, sizeof(data)));
+  ASSERT_EQ(0xbb3d,
+            l2c_fcr_updcrc_bytewise(L2CAP_FCR_INIT_CRC, data, sizeof(data)));
+}
+
+TEST(StackL2capFcsTest, matches_bytewise_for_all_lengths_and_offsets) {
+  std::vector<uint8_t> data(256);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = (i * 37 + 11) & 0xff;
+  }
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t len = 0; offset + len <= data.size(); len++) {
+      ASSERT_EQ(l2c_fcr_updcrc_bytewise(0x1234, data.data() + offset, len),
+                l2c_fcr_updcrc(0x1234, data.data() + offset, len))
+          << "offset " << offset << " len " << len;
+    }
+  }
+}
+
+TEST(StackL2capFcsTest, incremental_update) {
+  std::vector<uint8_t> data(100, 0xa5);
+  uint16_t crc = l2c_fcr_updcrc(L2CAP_FCR_INIT_CRC, data.data(), 13);
+  crc = l2c_fcr_updcrc(crc, data.data() + 13, data.size() - 13);
+  ASSERT_EQ(l2c_fcr_updcrc(L2CAP_FCR_INIT_CRC, data.data(), data.size()), crc);
+}
+
+TEST(StackL2capConnIntervalTest, no_links) {
+  ASSERT_TRUE(l2c_ble_plan_conn_intervals({}).empty());
+}
+
+TEST(StackL2capConnIntervalTest, harmonic_intervals) {
+  // 30-50 ms and 50-100 ms
+  auto intervals = l2c_ble_plan_conn_intervals({{24, 40}, {40, 80}});
+  ASSERT_EQ(intervals, std::vector<uint16_t>({24, 48}));
+}
+
+TEST(StackL2capConnIntervalTest, intervals_are_powers_of_two_apart) {
+  std::vector<tL2C_BLE_CONN_INT_RANGE> ranges = {
+      {6, 12}, {24, 40}, {30, 60}, {80, 160}, {300, 800}};
+  auto intervals = l2c_ble_plan_conn_intervals(ranges);
+  ASSERT_EQ(intervals.size(), ranges.size());
+  uint16_t shortest = *std::min_element(intervals.begin(), intervals.end());
+  for (size_t i = 0; i < ranges.size(); i++) {
+    ASSERT_GE(intervals[i], ranges[i].min_int);
+    ASSERT_LE(intervals[i], ranges[i].max_int);
+    ASSERT_EQ(intervals[i] % shortest, 0);
+    uint16_t ratio = intervals[i] / shortest;
+    ASSERT_EQ(ratio & (ratio - 1), 0) << "interval " << intervals[i];
+  }
+}
+
+TEST(StackL2capConnIntervalTest, fixed_interval_without_harmonic) {
+  // 7.5 ms and 37.5 ms are 5 apart, only one of them can be harmonized
+  auto intervals = l2c_ble_plan_conn_intervals({{6, 6}, {30, 30}});
+  ASSERT_EQ(intervals, std::vector<uint16_t>({6, 0}));
+}
+
+TEST(StackL2capConnIntervalTest, harmonic_subrate) {
+  ASSERT_EQ(l2c_ble_harmonic_subrate(1, 1), 1);
+  ASSERT_EQ(l2c_ble_harmonic_subrate(3, 5), 4);
+  ASSERT_EQ(l2c_ble_harmonic_subrate(5, 7), 0);
+}
+
+namespace {
+
+tL2C_RUN_STATE run_states[4];
+tL2C_RUN_NODE run_nodes[4];
+
+tL2C_RUN_STATE get_run_state(tL2C_RUN_NODE* p_node) {
+  return run_states[p_node - run_nodes];
+}
+
+class StackL2capRunQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    l2c_run_queue_init(&queue_);
+    for (size_t i = 0; i < 4; i++) {
+      run_nodes[i] = {};
+      run_states[i] = L2C_RUN_READY;
+    }
+  }
+
+  int Select() {
+    tL2C_RUN_NODE* p_node = l2c_run_queue_select(&queue_, get_run_state);
+    return p_node == nullptr ? -1 : p_node - run_nodes;
+  }
+
+  tL2C_RUN_QUEUE queue_;
+};
+
+}  // namespace
+
+TEST_F(StackL2capRunQueueTest, empty) { ASSERT_EQ(-1, Select()); }
+
+TEST_F(StackL2capRunQueueTest, round_robin_within_group) {
+  for (size_t i = 0; i < 3; i++) {
+    l2c_run_queue_activate(&queue_, &run_nodes[i], L2CAP_CHNL_PRIORITY_LOW);
+  }
+  ASSERT_EQ(0, Select());
+  ASSERT_EQ(1, Select());
+  ASSERT_EQ(2, Select());
+  ASSERT_EQ(0, Select());
+
+  // Activating a queued channel does not move it
+  l2c_run_queue_activate(&queue_, &run_nodes[1], L2CAP_CHNL_PRIORITY_LOW);
+  ASSERT_EQ(1, Select());
+}
+
+TEST_F(StackL2capRunQueueTest, idle_channels_leave_the_queue) {
+  l2c_run_queue_activate(&queue_, &run_nodes[0], L2CAP_CHNL_PRIORITY_LOW);
+  l2c_run_queue_activate(&queue_, &run_nodes[1], L2CAP_CHNL_PRIORITY_LOW);
+  run_states[0] = L2C_RUN_IDLE;
+
+  ASSERT_EQ(1, Select());
+  ASSERT_FALSE(run_nodes[0].active);
+  ASSERT_EQ(1, queue_.group[L2CAP_CHNL_PRIORITY_LOW].num_active);
+
+  run_states[1] = L2C_RUN_IDLE;
+  ASSERT_EQ(-1, Select());
+  ASSERT_EQ(0, queue_.group[L2CAP_CHNL_PRIORITY_LOW].num_active);
+}
+
+TEST_F(StackL2capRunQueueTest, blocked_channels_are_skipped) {
+  l2c_run_queue_activate(&queue_, &run_nodes[0], L2CAP_CHNL_PRIORITY_HIGH);
+  l2c_run_queue_activate(&queue_, &run_nodes[1], L2CAP_CHNL_PRIORITY_LOW);
+  run_states[0] = L2C_RUN_BLOCKED;
+
+  // A channel without credits does not hold back the other ones
+  ASSERT_EQ(1, Select());
+  ASSERT_TRUE(run_nodes[0].active);
+
+  run_states[0] = L2C_RUN_READY;
+  l2c_run_queue_activate(&queue_, &run_nodes[0], L2CAP_CHNL_PRIORITY_HIGH);
+  ASSERT_EQ(0, Select());
+}
+
+TEST_F(StackL2capRunQueueTest, priority_quota) {
+  l2c_run_queue_activate(&queue_, &run_nodes[0], L2CAP_CHNL_PRIORITY_HIGH);
+  l2c_run_queue_activate(&queue_, &run_nodes[1], L2CAP_CHNL_PRIORITY_LOW);
+
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < L2CAP_GET_PRIORITY_QUOTA(L2CAP_CHNL_PRIORITY_HIGH);
+         i++) {
+      ASSERT_EQ(0, Select());
+    }
+    for (int i = 0; i < L2CAP_GET_PRIORITY_QUOTA(L2CAP_CHNL_PRIORITY_LOW);
+         i++) {
+      ASSERT_EQ(1, Select());
+    }
+  }
+}
+
+TEST_F(StackL2capRunQueueTest, higher_priority_data_is_served_first) {
+  l2c_run_queue_activate(&queue_, &run_nodes[0], L2CAP_CHNL_PRIORITY_LOW);
+  ASSERT_EQ(0, Select());
+  ASSERT_EQ(L2CAP_CHNL_PRIORITY_LOW, queue_.serve_pri);
+
+  l2c_run_queue_activate(&queue_, &run_nodes[1], L2CAP_CHNL_PRIORITY_HIGH);
+  ASSERT_EQ(1, Select());
+}
+
+TEST_F(StackL2capRunQueueTest, deactivate) {
+  l2c_run_queue_activate(&queue_, &run_nodes[0], L2CAP_CHNL_PRIORITY_MEDIUM);
+  l2c_run_queue_activate(&queue_, &run_nodes[1], L2CAP_CHNL_PRIORITY_MEDIUM);
+  l2c_run_queue_activate(&queue_, &run_nodes[2], L2CAP_CHNL_PRIORITY_MEDIUM);
+  l2c_run_queue_deactivate(&queue_, &run_nodes[1]);
+  l2c_run_queue_deactivate(&queue_, &run_nodes[1]);
+
+  ASSERT_EQ(2, queue_.group[L2CAP_CHNL_PRIORITY_MEDIUM].num_active);
+  ASSERT_EQ(0, Select());
+  ASSERT_EQ(2, Select());
+  ASSERT_EQ(0, Select());
+}
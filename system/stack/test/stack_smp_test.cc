@@ -402,6 +402,83 @@ TEST(SmpEccValidationTest, test_invalid_points) {
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
 
+// Test ECC point multiplication
+TEST(SmpEccPointMultTest, test_sample_keys) {
+  // Test data from Bluetooth Core Specification
+  // Version 5.0 | Vol 2, Part G | 7.1.2, Sample 1
+  const uint32_t private_a[KEY_LENGTH_DWORDS_P256] = {
+      0xcd3c1abd, 0x5899b8a6, 0xeb40b799, 0x4aff607b,
+      0xd2103f50, 0x74c9b3e3, 0xa3c55f38, 0x3f49f6d4};
+  const uint32_t private_b[KEY_LENGTH_DWORDS_P256] = {
+      0xf47fc5fd, 0x6b4fdd49, 0xf19d7cfb, 0x59cb9ac2,
+      0xeed4e72a, 0x900afcfb, 0x32f6bb9a, 0x55188b3d};
+  const uint32_t public_a_x[KEY_LENGTH_DWORDS_P256] = {
+      0x0e359de6, 0xcc030148, 0xacf4fddb, 0xeff49111,
+      0xe9f9a5b9, 0x5e2c83a7, 0xf297be2c, 0x20b003d2};
+  const uint32_t public_b_x[KEY_LENGTH_DWORDS_P256] = {
+      0x2faaa190, 0x559077b2, 0x8615a69f, 0x47b58afd,
+      0xf19e4c00, 0x09592284, 0x1faf1d96, 0x1ea1f0f0};
+  const uint32_t dhkey[KEY_LENGTH_DWORDS_P256] = {
+      0x73bfa698, 0x868d34f3, 0xb4f866f1, 0x99796b13,
+      0x0a397d9b, 0x341010a6, 0x57c8ad05, 0xec0234a3};
+
+  p_256_init_curve();
+
+  uint32_t k[KEY_LENGTH_DWORDS_P256];
+  Point public_a, public_b, g, dhkey_a, dhkey_b;
+
+  memcpy(k, private_a, sizeof(k));
+  ECC_PointMult_Base(&public_a, k);
+  EXPECT_EQ(0, memcmp(public_a.x, public_a_x, sizeof(public_a_x)));
+  EXPECT_TRUE(ECC_ValidatePoint(public_a));
+
+  memcpy(&g, &curve_p256.G, sizeof(g));
+  memcpy(k, private_b, sizeof(k));
+  ECC_PointMult_Window(&public_b, &g, k);
+  EXPECT_EQ(0, memcmp(public_b.x, public_b_x, sizeof(public_b_x)));
+  EXPECT_TRUE(ECC_ValidatePoint(public_b));
+
+  memcpy(k, private_a, sizeof(k));
+  ECC_PointMult_Window(&dhkey_a, &public_b, k);
+  EXPECT_EQ(0, memcmp(dhkey_a.x, dhkey, sizeof(dhkey)));
+
+  memcpy(k, private_b, sizeof(k));
+  ECC_PointMult_Window(&dhkey_b, &public_a, k);
+  EXPECT_EQ(0, memcmp(dhkey_b.x, dhkey, sizeof(dhkey)));
+}
+
+TEST(SmpEccPointMultTest, test_matches_bin_naf) {
+  p_256_init_curve();
+
+  uint32_t k[KEY_LENGTH_DWORDS_P256];
+  for (uint32_t i = 0; i < 64; i++) {
+    for (uint32_t j = 0; j < KEY_LENGTH_DWORDS_P256; j++)
+      k[j] = 0x9e3779b9 * (i * KEY_LENGTH_DWORDS_P256 + j + 1);
+    // Small and even scalars too
+    if (i < 8) multiprecision_init(k);
+    if (i < 16) k[0] = i + 3;
+
+    uint32_t k_naf[KEY_LENGTH_DWORDS_P256];
+    uint32_t k_window[KEY_LENGTH_DWORDS_P256];
+    uint32_t k_base[KEY_LENGTH_DWORDS_P256];
+    memcpy(k_naf, k, sizeof(k));
+    memcpy(k_window, k, sizeof(k));
+    memcpy(k_base, k, sizeof(k));
+
+    Point g, expected, window, base;
+    memcpy(&g, &curve_p256.G, sizeof(g));
+    ECC_PointMult_Bin_NAF(&expected, &g, k_naf);
+    memcpy(&g, &curve_p256.G, sizeof(g));
+    ECC_PointMult_Window(&window, &g, k_window);
+    ECC_PointMult_Base(&base, k_base);
+
+    EXPECT_EQ(0, memcmp(window.x, expected.x, sizeof(expected.x)));
+    EXPECT_EQ(0, memcmp(window.y, expected.y, sizeof(expected.y)));
+    EXPECT_EQ(0, memcmp(base.x, expected.x, sizeof(expected.x)));
+    EXPECT_EQ(0, memcmp(base.y, expected.y, sizeof(expected.y)));
+  }
+}
+
 TEST(SmpStatusText, smp_status_text) {
   std::vector<std::pair<tSMP_STATUS, std::string>> status = {
       std::make_pair(SMP_SUCCESS, "SMP_SUCCESS"),
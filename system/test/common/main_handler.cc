@@ -56,6 +56,13 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
   return BT_STATUS_SUCCESS;
 }
 
+// Tests do not need the parallelism of the worker pool
+bt_status_t do_in_worker_pool(const base::Location& /* from_here */,
+                              base::OnceClosure task) {
+  std::move(task).Run();
+  return BT_STATUS_SUCCESS;
+}
+
 void post_on_bt_main(BtMainClosure closure) {
   bluetooth::log::assert_that(
       do_in_main_thread(
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "bt_headless_perf"
+
+#include "test/headless/perf/perf.h"
+
+#include <bluetooth/log.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/hardware/bt_sock.h"
+#include "test/headless/get_options.h"
+#include "test/headless/headless.h"
+#include "test/headless/log.h"
+#include "types/raw_address.h"
+
+using namespace bluetooth::test;
+using namespace bluetooth;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Payload written by the RFCOMM workload, within the default RFCOMM MTU
+constexpr size_t kRfcommWriteSize = 990;
+constexpr auto kConnectTimeout = 10s;
+constexpr int kPollTimeoutMs = 100;
+
+struct Workload {
+  btsock_type_t type{BTSOCK_RFCOMM};
+  // RFCOMM channel or LE PSM, unused when connecting to a service uuid
+  int channel{0};
+  std::chrono::seconds duration{10};
+  // Size of the writes, zero for the largest the connection takes
+  size_t write_size{0};
+};
+
+struct ConnectionStats {
+  RawAddress bd_addr;
+  bool connected{false};
+  uint64_t tx_bytes{0};
+  uint64_t rx_bytes{0};
+  // How long each write waited for the stack to take the payload, which
+  // grows when the connection runs out of credits
+  std::vector<uint64_t> write_latency_us;
+};
+
+// CPU time spent by a thread of this process
+struct ThreadCpu {
+  std::string name;
+  uint64_t ticks{0};
+};
+
+std::map<pid_t, ThreadCpu> read_thread_cpu() {
+  std::map<pid_t, ThreadCpu> threads;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator("/proc/self/task", ec)) {
+    std::ifstream stat(entry.path() / "stat");
+    std::string line;
+    if (!std::getline(stat, line)) continue;
+    // The thread name is within parentheses and may hold spaces
+    size_t open = line.find('(');
+    size_t close = line.rfind(')');
+    if (open == std::string::npos || close == std::string::npos) continue;
+
+    // The fields following the name start with the state, the user and
+    // system times are the 12th and 13th of them
+    std::istringstream fields(line.substr(close + 1));
+    std::vector<std::string> values;
+    std::string value;
+    while (values.size() < 13 && fields >> value) values.push_back(value);
+    if (values.size() < 13) continue;
+
+    pid_t tid = std::stoi(entry.path().filename().string());
+    threads[tid] = ThreadCpu{
+        .name = line.substr(open + 1, close - open - 1),
+        .ticks = std::stoull(values[11]) + std::stoull(values[12]),
+    };
+  }
+  return threads;
+}
+
+void report_thread_cpu(const std::map<pid_t, ThreadCpu>& before,
+                       const std::map<pid_t, ThreadCpu>& after,
+                       std::chrono::milliseconds elapsed) {
+  const uint64_t ticks_per_second = sysconf(_SC_CLK_TCK);
+  std::vector<std::pair<uint64_t, std::string>> usage;
+  for (const auto& [tid, thread] : after) {
+    auto it = before.find(tid);
+    uint64_t ticks = thread.ticks - (it != before.end() ? it->second.ticks : 0);
+    if (ticks == 0) continue;
+    usage.emplace_back(ticks * 1000 / ticks_per_second,
+                       thread.name + ":" + std::to_string(tid));
+  }
+  std::sort(usage.rbegin(), usage.rend());
+
+  LOG_CONSOLE("CPU per thread over %" PRId64 "ms:", (int64_t)elapsed.count());
+  for (const auto& [cpu_ms, name] : usage) {
+    LOG_CONSOLE("  %-32s %6" PRIu64 "ms %5.1f%%", name.c_str(), cpu_ms,
+                100.0 * cpu_ms / std::max<int64_t>(elapsed.count(), 1));
+  }
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, unsigned percent) {
+  if (sorted.empty()) return 0;
+  return sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)];
+}
+
+bool read_all(int fd, void* data, size_t size,
+              std::chrono::steady_clock::time_point deadline) {
+  uint8_t* p = static_cast<uint8_t*>(data);
+  while (size > 0) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0) return false;
+    struct pollfd pfd = {.fd = fd, .events = POLLIN, .revents = 0};
+    if (poll(&pfd, 1, remaining.count()) <= 0) return false;
+    ssize_t n = recv(fd, p, size, 0);
+    if (n <= 0) return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+// Opens a socket to |bd_addr|, and returns its fd once connected, or -1
+int connect_socket(const btsock_interface_t* sock, const RawAddress& bd_addr,
+                   const Workload& workload, const bluetooth::Uuid* uuid,
+                   size_t* max_tx_packet_size) {
+  int fd = -1;
+  bt_status_t status =
+      sock->connect(&bd_addr, workload.type, uuid, workload.channel, &fd,
+                    /* flags */ 0, getuid());
+  if (status != BT_STATUS_SUCCESS || fd == -1) {
+    LOG_CONSOLE("Unable to connect to %s status:%d", STR(bd_addr), status);
+    return -1;
+  }
+
+  // The stack sends the channel in use, then the connection signal once
+  // connected
+  auto deadline = std::chrono::steady_clock::now() + kConnectTimeout;
+  int channel = 0;
+  sock_connect_signal_t signal = {};
+  if (!read_all(fd, &channel, sizeof(channel), deadline) ||
+      !read_all(fd, &signal, sizeof(signal), deadline) || signal.status != 0) {
+    LOG_CONSOLE("Connection to %s failed status:%d", STR(bd_addr),
+                signal.status);
+    close(fd);
+    return -1;
+  }
+  *max_tx_packet_size = signal.max_tx_packet_size;
+  LOG_CONSOLE("Connected to %s channel:%d max_tx:%hu max_rx:%hu",
+              STR(bd_addr), signal.channel, signal.max_tx_packet_size,
+              signal.max_rx_packet_size);
+  return fd;
+}
+
+// Writes to the connection as fast as it takes the payload until the end of
+// the workload, while draining what the peer sends back
+void stream(int fd, size_t write_size, std::chrono::seconds duration,
+            ConnectionStats* stats) {
+  std::vector<uint8_t> payload(write_size);
+  std::vector<uint8_t> rx(65536);
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN | POLLOUT, .revents = 0};
+    auto poll_start = std::chrono::steady_clock::now();
+    if (poll(&pfd, 1, kPollTimeoutMs) < 0) break;
+    if (pfd.revents & (POLLERR | POLLHUP)) {
+      LOG_CONSOLE("Connection to %s closed", STR(stats->bd_addr));
+      break;
+    }
+    if (pfd.revents & POLLIN) {
+      ssize_t n = recv(fd, rx.data(), rx.size(), MSG_DONTWAIT);
+      if (n > 0) stats->rx_bytes += n;
+    }
+    if (pfd.revents & POLLOUT) {
+      ssize_t n = send(fd, payload.data(), payload.size(), MSG_DONTWAIT);
+      if (n > 0) {
+        stats->tx_bytes += n;
+        stats->write_latency_us.push_back(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - poll_start)
+                .count());
+      }
+    }
+  }
+}
+
+bool parse_workload(std::list<std::string> options, Workload* workload) {
+  if (options.empty()) return false;
+  std::string name = options.front();
+  options.pop_front();
+  if (name == "rfcomm") {
+    workload->type = BTSOCK_RFCOMM;
+  } else if (name == "l2cap") {
+    workload->type = BTSOCK_L2CAP_LE;
+  } else {
+    return false;
+  }
+
+  for (const auto& option : options) {
+    auto v = bluetooth::test::headless::GetOpt::Split(option);
+    if (v.size() != 2) return false;
+    if (v[0] == "channel" || v[0] == "psm") {
+      workload->channel = std::stoi(v[1], nullptr, 0);
+    } else if (v[0] == "duration") {
+      workload->duration = std::chrono::seconds(std::stoul(v[1]));
+    } else if (v[0] == "size") {
+      workload->write_size = std::stoul(v[1]);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void usage() {
+  LOG_CONSOLE("Usage: bt_headless --device=<device,> [--uuid=<uuid>] perf "
+              "<rfcomm|l2cap> [channel=<n>|psm=<n>] [duration=<seconds>] "
+              "[size=<bytes>]");
+  LOG_CONSOLE("  rfcomm: RFCOMM bulk stream to the service uuid or channel");
+  LOG_CONSOLE("  l2cap:  LE L2CAP connection oriented channel to the psm");
+}
+
+int do_perf(const std::list<RawAddress>& devices,
+            const std::list<bluetooth::Uuid>& uuids, const Workload& workload) {
+  auto sock = static_cast<const btsock_interface_t*>(
+      bluetoothInterface.get_profile_interface(BT_PROFILE_SOCKETS_ID));
+  if (sock == nullptr) {
+    LOG_CONSOLE("Socket interface unavailable");
+    return -1;
+  }
+  const bluetooth::Uuid* uuid =
+      (workload.type == BTSOCK_RFCOMM && !uuids.empty()) ? &uuids.front()
+                                                         : nullptr;
+
+  // Each device gets its own connection, all of them streaming concurrently
+  std::vector<ConnectionStats> stats(devices.size());
+  std::vector<int> fds;
+  std::vector<size_t> write_sizes;
+  size_t index = 0;
+  for (const auto& bd_addr : devices) {
+    stats[index].bd_addr = bd_addr;
+    size_t max_tx_packet_size = 0;
+    int fd =
+        connect_socket(sock, bd_addr, workload, uuid, &max_tx_packet_size);
+    fds.push_back(fd);
+    size_t write_size = workload.write_size;
+    if (write_size == 0) {
+      write_size = (workload.type == BTSOCK_RFCOMM || max_tx_packet_size == 0)
+                       ? kRfcommWriteSize
+                       : max_tx_packet_size;
+    }
+    write_sizes.push_back(write_size);
+    stats[index].connected = fd != -1;
+    index++;
+  }
+
+  auto cpu_before = read_thread_cpu();
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < fds.size(); i++) {
+    if (fds[i] == -1) continue;
+    threads.emplace_back(stream, fds[i], write_sizes[i], workload.duration,
+                         &stats[i]);
+  }
+  for (auto& thread : threads) thread.join();
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  auto cpu_after = read_thread_cpu();
+
+  for (int fd : fds) {
+    if (fd != -1) close(fd);
+  }
+
+  uint64_t total_tx_bytes = 0;
+  size_t connected = 0;
+  const double seconds = std::max<int64_t>(elapsed.count(), 1) / 1000.0;
+  for (auto& connection : stats) {
+    if (!connection.connected) {
+      LOG_CONSOLE("%s: not connected", STR(connection.bd_addr));
+      continue;
+    }
+    connected++;
+    total_tx_bytes += connection.tx_bytes;
+    auto& latencies = connection.write_latency_us;
+    std::sort(latencies.begin(), latencies.end());
+    LOG_CONSOLE(
+        "%s: tx %.1f kbps rx %.1f kbps writes:%zu latency p50:%" PRIu64
+        "us p99:%" PRIu64 "us max:%" PRIu64 "us",
+        STR(connection.bd_addr), connection.tx_bytes * 8 / seconds / 1000,
+        connection.rx_bytes * 8 / seconds / 1000, latencies.size(),
+        percentile(latencies, 50), percentile(latencies, 99),
+        latencies.empty() ? 0 : latencies.back());
+  }
+  LOG_CONSOLE("Total: %zu/%zu connections tx %.1f kbps", connected,
+              stats.size(), total_tx_bytes * 8 / seconds / 1000);
+  report_thread_cpu(cpu_before, cpu_after, elapsed);
+
+  return connected == stats.size() ? 0 : -1;
+}
+
+}  // namespace
+
+int bluetooth::test::headless::Perf::Run() {
+  Workload workload;
+  if (options_.device_.empty() ||
+      !parse_workload(options_.non_options_, &workload)) {
+    usage();
+    options_.Usage();
+    return -1;
+  }
+  return RunOnHeadlessStack<int>([this, workload]() {
+    return do_perf(options_.device_, options_.uuid_, workload);
+  });
+}
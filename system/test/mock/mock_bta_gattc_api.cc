@@ -89,6 +89,10 @@ void BTA_GATTC_ConfigureMTU(uint16_t /* conn_id */, uint16_t /* mtu */,
                             void* /* cb_data */) {
   inc_func_call_count(__func__);
 }
+void BTA_GATTC_SetThroughputProfile(
+    uint16_t /* conn_id */, tGATT_THROUGHPUT_PROFILE /* profile */) {
+  inc_func_call_count(__func__);
+}
 void BTA_GATTC_DiscoverServiceByUuid(uint16_t /* conn_id */,
                                      const bluetooth::Uuid& /* srvc_uuid */) {
   inc_func_call_count(__func__);
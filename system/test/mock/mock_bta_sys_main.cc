@@ -36,10 +36,12 @@ namespace bta_sys_main {
 
 // Function state capture and return values, if needed
 struct BTA_sys_signal_hw_error BTA_sys_signal_hw_error;
+struct bta_sys_debug_dump bta_sys_debug_dump;
 struct bta_sys_deregister bta_sys_deregister;
 struct bta_sys_disable bta_sys_disable;
 struct bta_sys_init bta_sys_init;
 struct bta_sys_is_register bta_sys_is_register;
+struct bta_sys_msg_alloc bta_sys_msg_alloc;
 struct bta_sys_register bta_sys_register;
 struct bta_sys_sendmsg bta_sys_sendmsg;
 struct bta_sys_sendmsg_delayed bta_sys_sendmsg_delayed;
@@ -54,6 +56,10 @@ void BTA_sys_signal_hw_error() {
   inc_func_call_count(__func__);
   test::mock::bta_sys_main::BTA_sys_signal_hw_error();
 }
+void bta_sys_debug_dump(int fd) {
+  inc_func_call_count(__func__);
+  test::mock::bta_sys_main::bta_sys_debug_dump(fd);
+}
 void bta_sys_deregister(uint8_t id) {
   inc_func_call_count(__func__);
   test::mock::bta_sys_main::bta_sys_deregister(id);
@@ -70,6 +76,10 @@ bool bta_sys_is_register(uint8_t id) {
   inc_func_call_count(__func__);
   return test::mock::bta_sys_main::bta_sys_is_register(id);
 }
+void* bta_sys_msg_alloc(size_t size) {
+  inc_func_call_count(__func__);
+  return test::mock::bta_sys_main::bta_sys_msg_alloc(size);
+}
 void bta_sys_register(uint8_t id, const tBTA_SYS_REG* p_reg) {
   inc_func_call_count(__func__);
   test::mock::bta_sys_main::bta_sys_register(id, p_reg);
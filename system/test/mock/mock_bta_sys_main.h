@@ -27,6 +27,7 @@
 // Original included files, if any
 #include "bta/sys/bta_sys.h"
 #include "osi/include/alarm.h"
+#include "osi/include/allocator.h"
 
 // Mocked compile conditionals, if any
 
@@ -53,6 +54,15 @@ struct bta_sys_deregister {
 };
 extern struct bta_sys_deregister bta_sys_deregister;
 
+// Name: bta_sys_debug_dump
+// Params: int fd
+// Return: void
+struct bta_sys_debug_dump {
+  std::function<void(int fd)> body{[](int /* fd */) {}};
+  void operator()(int fd) { body(fd); };
+};
+extern struct bta_sys_debug_dump bta_sys_debug_dump;
+
 // Name: bta_sys_disable
 // Params:
 // Return: void
@@ -82,6 +92,16 @@ struct bta_sys_is_register {
 };
 extern struct bta_sys_is_register bta_sys_is_register;
 
+// Name: bta_sys_msg_alloc
+// Params: size_t size
+// Return: void*
+struct bta_sys_msg_alloc {
+  std::function<void*(size_t size)> body{
+      [](size_t size) { return osi_calloc(size); }};
+  void* operator()(size_t size) { return body(size); };
+};
+extern struct bta_sys_msg_alloc bta_sys_msg_alloc;
+
 // Name: bta_sys_register
 // Params: uint8_t id, const tBTA_SYS_REG* p_reg
 // Return: void
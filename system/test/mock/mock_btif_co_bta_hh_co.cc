@@ -27,7 +27,8 @@
 #include "test/common/mock_functions.h"
 #include "types/raw_address.h"
 
-int bta_hh_co_write(int /* fd */, uint8_t* /* rpt */, uint16_t /* len */) {
+int bta_hh_co_write(int /* fd */, const uint8_t* /* rpt */,
+                    uint16_t /* len */) {
   inc_func_call_count(__func__);
   return 0;
 }
@@ -40,7 +41,7 @@ tBTA_HH_RPT_CACHE_ENTRY* bta_hh_le_co_cache_load(
 void bta_hh_co_close(btif_hh_device_t* /* p_dev */) {
   inc_func_call_count(__func__);
 }
-void bta_hh_co_data(uint8_t /* dev_handle */, uint8_t* /* p_rpt */,
+void bta_hh_co_data(uint8_t /* dev_handle */, const uint8_t* /* p_rpt */,
                     uint16_t /* len */) {
   inc_func_call_count(__func__);
 }
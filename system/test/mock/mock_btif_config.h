@@ -28,6 +28,7 @@
 
 // Original included files, if any
 
+#include "main/shim/config.h"
 #include "types/raw_address.h"
 
 // Mocked compile conditionals, if any
@@ -210,6 +211,19 @@ struct btif_config_get_paired_devices {
   std::vector<RawAddress> operator()() { return body(); };
 };
 extern struct btif_config_get_paired_devices btif_config_get_paired_devices;
+// Name: btif_config_get_paired_device_properties
+// Params:
+// Returns: std::vector<bluetooth::shim::DeviceProperties>
+struct btif_config_get_paired_device_properties {
+  std::vector<bluetooth::shim::DeviceProperties> devices;
+  std::function<std::vector<bluetooth::shim::DeviceProperties>()> body{
+      [this]() { return devices; }};
+  std::vector<bluetooth::shim::DeviceProperties> operator()() {
+    return body();
+  };
+};
+extern struct btif_config_get_paired_device_properties
+    btif_config_get_paired_device_properties;
 // Name: btif_config_remove
 // Params: const std::string& section, const std::string& key
 // Returns: bool
@@ -65,6 +65,8 @@ struct btif_storage_load_bonded_devices btif_storage_load_bonded_devices;
 struct btif_storage_load_le_devices btif_storage_load_le_devices;
 struct btif_storage_remove_ble_bonding_keys
     btif_storage_remove_ble_bonding_keys;
+struct btif_storage_invalidate_remote_device_properties
+    btif_storage_invalidate_remote_device_properties;
 struct btif_storage_remove_bonded_device btif_storage_remove_bonded_device;
 struct btif_storage_remove_gatt_cl_db_hash btif_storage_remove_gatt_cl_db_hash;
 struct btif_storage_remove_gatt_cl_supp_feat
@@ -259,6 +261,12 @@ bt_status_t btif_storage_remove_ble_bonding_keys(
   return test::mock::btif_storage::btif_storage_remove_ble_bonding_keys(
       remote_bd_addr);
 }
+void btif_storage_invalidate_remote_device_properties(
+    const RawAddress* remote_bd_addr) {
+  inc_func_call_count(__func__);
+  test::mock::btif_storage::btif_storage_invalidate_remote_device_properties(
+      remote_bd_addr);
+}
 bt_status_t btif_storage_remove_bonded_device(
     const RawAddress* remote_bd_addr) {
   inc_func_call_count(__func__);
@@ -415,6 +415,17 @@ struct btif_storage_remove_ble_local_keys {
 extern struct btif_storage_remove_ble_local_keys
     btif_storage_remove_ble_local_keys;
 
+// Name: btif_storage_invalidate_remote_device_properties
+// Params: const RawAddress* remote_bd_addr
+// Return: void
+struct btif_storage_invalidate_remote_device_properties {
+  std::function<void(const RawAddress* remote_bd_addr)> body{
+      [](const RawAddress* /* remote_bd_addr */) {}};
+  void operator()(const RawAddress* remote_bd_addr) { body(remote_bd_addr); };
+};
+extern struct btif_storage_invalidate_remote_device_properties
+    btif_storage_invalidate_remote_device_properties;
+
 // Name: btif_storage_remove_bonded_device
 // Params: const RawAddress* remote_bd_addr
 // Return: bt_status_t
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:4
+ *   Functions generated:5
  */
 
 #include <openssl/hmac.h>
@@ -46,6 +46,10 @@ void AddressObfuscator::Initialize(const Octet32& salt_256bit) {
   inc_func_call_count(__func__);
   salt_256bit_ = salt_256bit;
 }
+AddressObfuscator::CacheStats AddressObfuscator::GetCacheStats() {
+  inc_func_call_count(__func__);
+  return {};
+}
 
 }  // namespace common
 }  // namespace bluetooth
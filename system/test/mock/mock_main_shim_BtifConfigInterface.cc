@@ -84,6 +84,23 @@ std::vector<std::string>
 bluetooth::shim::BtifConfigInterface::GetPersistentDevices() {
   return std::vector<std::string>();
 }
+std::vector<bluetooth::shim::DeviceProperties>
+bluetooth::shim::BtifConfigInterface::GetPersistentDeviceProperties() {
+  return std::vector<bluetooth::shim::DeviceProperties>();
+}
 void bluetooth::shim::BtifConfigInterface::
     ConvertEncryptOrDecryptKeyIfNeeded(){};
 void bluetooth::shim::BtifConfigInterface::Clear(){};
+bool bluetooth::shim::DeviceProperties::HasProperty(
+    const std::string& /* property */) const {
+  return false;
+}
+bool bluetooth::shim::DeviceProperties::GetInt(
+    const std::string& /* property */, int* /* value */) const {
+  return false;
+}
+bool bluetooth::shim::DeviceProperties::GetBin(
+    const std::string& /* property */, uint8_t* /* value */,
+    size_t* /* length */) const {
+  return false;
+}
@@ -93,6 +93,11 @@ void shim::legacy::Acl::IgnoreLeConnectionFrom(
   inc_func_call_count(__func__);
 }
 
+void shim::legacy::Acl::IgnoreLeConnectionsFrom(
+    const std::vector<hci::AddressWithType>& /* address_with_types */) {
+  inc_func_call_count(__func__);
+}
+
 void bluetooth::shim::legacy::Acl::OnClassicLinkDisconnected(
     HciHandle /* handle */, hci::ErrorCode /* reason */) {
   inc_func_call_count(__func__);
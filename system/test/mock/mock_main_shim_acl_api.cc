@@ -46,6 +46,10 @@ void bluetooth::shim::ACL_IgnoreLeConnectionFrom(
     const tBLE_BD_ADDR& /* legacy_address_with_type */) {
   inc_func_call_count(__func__);
 }
+void bluetooth::shim::ACL_IgnoreLeConnectionsFrom(
+    const std::vector<tBLE_BD_ADDR>& /* legacy_address_with_types */) {
+  inc_func_call_count(__func__);
+}
 void bluetooth::shim::ACL_ConfigureLePrivacy(bool /* is_le_privacy_enabled */) {
   inc_func_call_count(__func__);
 }
@@ -125,6 +129,7 @@ void bluetooth::shim::ACL_CancelRemoteNameRequest(
 void bluetooth::shim::ACL_RemoteNameRequest(const RawAddress& /* addr */,
                                             uint8_t /* page_scan_rep_mode */,
                                             uint8_t /* page_scan_mode */,
-                                            uint16_t /* clock_offset */) {
+                                            uint16_t /* clock_offset */,
+                                            bool /* prioritized */) {
   inc_func_call_count(__func__);
 }
@@ -76,6 +76,12 @@ void* osi_malloc(size_t size) {
   inc_func_call_count(__func__);
   return test::mock::osi_allocator::osi_malloc(size);
 }
+void* osi_calloc_tagged(size_t size, const char* /* tag */) {
+  return osi_calloc(size);
+}
+void* osi_malloc_tagged(size_t size, const char* /* tag */) {
+  return osi_malloc(size);
+}
 char* osi_strdup(const char* str) {
   inc_func_call_count(__func__);
   return test::mock::osi_allocator::osi_strdup(str);
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:8
+ *   Functions generated:12
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -35,13 +35,17 @@ namespace osi_ringbuffer {
 
 // Function state capture and return values, if needed
 struct ringbuffer_available ringbuffer_available;
+struct ringbuffer_commit ringbuffer_commit;
 struct ringbuffer_delete ringbuffer_delete;
 struct ringbuffer_free ringbuffer_free;
 struct ringbuffer_init ringbuffer_init;
+struct ringbuffer_init_pow2 ringbuffer_init_pow2;
 struct ringbuffer_insert ringbuffer_insert;
 struct ringbuffer_peek ringbuffer_peek;
 struct ringbuffer_pop ringbuffer_pop;
+struct ringbuffer_read_spans ringbuffer_read_spans;
 struct ringbuffer_size ringbuffer_size;
+struct ringbuffer_write_spans ringbuffer_write_spans;
 
 }  // namespace osi_ringbuffer
 }  // namespace mock
@@ -52,6 +56,10 @@ size_t ringbuffer_available(const ringbuffer_t* rb) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_available(rb);
 }
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_commit(rb, length);
+}
 size_t ringbuffer_delete(ringbuffer_t* rb, size_t length) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_delete(rb, length);
@@ -64,6 +72,10 @@ ringbuffer_t* ringbuffer_init(const size_t size) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_init(size);
 }
+ringbuffer_t* ringbuffer_init_pow2(const size_t size) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_init_pow2(size);
+}
 size_t ringbuffer_insert(ringbuffer_t* rb, const uint8_t* p, size_t length) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_insert(rb, p, length);
@@ -77,9 +89,17 @@ size_t ringbuffer_pop(ringbuffer_t* rb, uint8_t* p, size_t length) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_pop(rb, p, length);
 }
+size_t ringbuffer_read_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_read_spans(rb, spans);
+}
 size_t ringbuffer_size(const ringbuffer_t* rb) {
   inc_func_call_count(__func__);
   return test::mock::osi_ringbuffer::ringbuffer_size(rb);
 }
+size_t ringbuffer_write_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_ringbuffer::ringbuffer_write_spans(rb, spans);
+}
 // Mocked functions complete
 // END mockcify generation
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:8
+ *   Functions generated:12
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -83,6 +83,17 @@ struct ringbuffer_init {
 };
 extern struct ringbuffer_init ringbuffer_init;
 
+// Name: ringbuffer_init_pow2
+// Params: const size_t size
+// Return: ringbuffer_t*
+struct ringbuffer_init_pow2 {
+  ringbuffer_t* return_value{0};
+  std::function<ringbuffer_t*(const size_t size)> body{
+      [this](const size_t /* size */) { return return_value; }};
+  ringbuffer_t* operator()(const size_t size) { return body(size); };
+};
+extern struct ringbuffer_init_pow2 ringbuffer_init_pow2;
+
 // Name: ringbuffer_insert
 // Params: ringbuffer_t* rb, const uint8_t* p, size_t length
 // Return: size_t
@@ -140,6 +151,51 @@ struct ringbuffer_size {
 };
 extern struct ringbuffer_size ringbuffer_size;
 
+// Name: ringbuffer_read_spans
+// Params: ringbuffer_t* rb, ringbuffer_span_t spans[2]
+// Return: size_t
+struct ringbuffer_read_spans {
+  size_t return_value{0};
+  std::function<size_t(ringbuffer_t* rb, ringbuffer_span_t spans[2])> body{
+      [this](ringbuffer_t* /* rb */, ringbuffer_span_t /* spans */[2]) {
+        return return_value;
+      }};
+  size_t operator()(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+    return body(rb, spans);
+  };
+};
+extern struct ringbuffer_read_spans ringbuffer_read_spans;
+
+// Name: ringbuffer_write_spans
+// Params: ringbuffer_t* rb, ringbuffer_span_t spans[2]
+// Return: size_t
+struct ringbuffer_write_spans {
+  size_t return_value{0};
+  std::function<size_t(ringbuffer_t* rb, ringbuffer_span_t spans[2])> body{
+      [this](ringbuffer_t* /* rb */, ringbuffer_span_t /* spans */[2]) {
+        return return_value;
+      }};
+  size_t operator()(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+    return body(rb, spans);
+  };
+};
+extern struct ringbuffer_write_spans ringbuffer_write_spans;
+
+// Name: ringbuffer_commit
+// Params: ringbuffer_t* rb, size_t length
+// Return: size_t
+struct ringbuffer_commit {
+  size_t return_value{0};
+  std::function<size_t(ringbuffer_t* rb, size_t length)> body{
+      [this](ringbuffer_t* /* rb */, size_t /* length */) {
+        return return_value;
+      }};
+  size_t operator()(ringbuffer_t* rb, size_t length) {
+    return body(rb, length);
+  };
+};
+extern struct ringbuffer_commit ringbuffer_commit;
+
 }  // namespace osi_ringbuffer
 }  // namespace mock
 }  // namespace test
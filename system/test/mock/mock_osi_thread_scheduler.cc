@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:2
+ *   Functions generated:5
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -34,6 +34,7 @@ namespace osi_thread_scheduler {
 // Function state capture and return values, if needed
 struct thread_scheduler_enable_real_time thread_scheduler_enable_real_time;
 struct thread_scheduler_get_priority_range thread_scheduler_get_priority_range;
+struct thread_scheduler_apply_policy thread_scheduler_apply_policy;
 
 }  // namespace osi_thread_scheduler
 }  // namespace mock
@@ -50,5 +51,15 @@ bool thread_scheduler_get_priority_range(int& min, int& max) {
   return test::mock::osi_thread_scheduler::thread_scheduler_get_priority_range(
       min, max);
 }
+const char* thread_role_text(ThreadRole /* role */) {
+  inc_func_call_count(__func__);
+  return "";
+}
+bool thread_scheduler_apply_policy(pid_t linux_tid, ThreadRole role) {
+  inc_func_call_count(__func__);
+  return test::mock::osi_thread_scheduler::thread_scheduler_apply_policy(
+      linux_tid, role);
+}
+void thread_scheduler_dump(int /* fd */) { inc_func_call_count(__func__); }
 // Mocked functions complete
 // END mockcify generation
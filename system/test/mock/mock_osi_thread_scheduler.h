@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:2
+ *   Functions generated:5
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -26,6 +26,7 @@
 #include <functional>
 
 // Original included files, if any
+#include "osi/include/thread_scheduler.h"
 
 // Mocked compile conditionals, if any
 
@@ -58,6 +59,21 @@ struct thread_scheduler_get_priority_range {
 extern struct thread_scheduler_get_priority_range
     thread_scheduler_get_priority_range;
 
+// Name: thread_scheduler_apply_policy
+// Params: pid_t linux_tid, ThreadRole role
+// Return: bool
+struct thread_scheduler_apply_policy {
+  bool return_value{false};
+  std::function<bool(pid_t linux_tid, ThreadRole role)> body{
+      [this](pid_t /* linux_tid */, ThreadRole /* role */) {
+        return return_value;
+      }};
+  bool operator()(pid_t linux_tid, ThreadRole role) {
+    return body(linux_tid, role);
+  };
+};
+extern struct thread_scheduler_apply_policy thread_scheduler_apply_policy;
+
 }  // namespace osi_thread_scheduler
 }  // namespace mock
 }  // namespace test
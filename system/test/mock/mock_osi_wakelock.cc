@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:6
+ *   Functions generated:7
  *
  *  mockcify.pl ver 0.3.0
  */
@@ -38,6 +38,7 @@ struct wakelock_debug_dump wakelock_debug_dump;
 struct wakelock_release wakelock_release;
 struct wakelock_set_os_callouts wakelock_set_os_callouts;
 struct wakelock_set_paths wakelock_set_paths;
+struct wakelock_set_release_delay wakelock_set_release_delay;
 
 }  // namespace osi_wakelock
 }  // namespace mock
@@ -68,5 +69,9 @@ void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   inc_func_call_count(__func__);
   test::mock::osi_wakelock::wakelock_set_paths(lock_path, unlock_path);
 }
+void wakelock_set_release_delay(int64_t delay_ms) {
+  inc_func_call_count(__func__);
+  test::mock::osi_wakelock::wakelock_set_release_delay(delay_ms);
+}
 // Mocked functions complete
 // END mockcify generation
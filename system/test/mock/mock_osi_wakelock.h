@@ -16,11 +16,12 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:6
+ *   Functions generated:7
  *
  *  mockcify.pl ver 0.3.0
  */
 
+#include <cstdint>
 #include <functional>
 
 #include "include/hardware/bluetooth.h"
@@ -95,6 +96,15 @@ struct wakelock_set_paths {
 };
 extern struct wakelock_set_paths wakelock_set_paths;
 
+// Name: wakelock_set_release_delay
+// Params: int64_t delay_ms
+// Return: void
+struct wakelock_set_release_delay {
+  std::function<void(int64_t delay_ms)> body{[](int64_t /* delay_ms */) {}};
+  void operator()(int64_t delay_ms) { body(delay_ms); };
+};
+extern struct wakelock_set_release_delay wakelock_set_release_delay;
+
 }  // namespace osi_wakelock
 }  // namespace mock
 }  // namespace test
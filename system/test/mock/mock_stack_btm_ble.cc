@@ -61,6 +61,7 @@ struct BTM_SecAddBleDevice BTM_SecAddBleDevice;
 struct BTM_SecAddBleKey BTM_SecAddBleKey;
 struct BTM_SecurityGrant BTM_SecurityGrant;
 struct BTM_SetBleDataLength BTM_SetBleDataLength;
+struct BTM_RestoreBleDataLength BTM_RestoreBleDataLength;
 struct BTM_UseLeLink BTM_UseLeLink;
 struct btm_ble_connected btm_ble_connected;
 struct btm_ble_get_acl_remote_addr btm_ble_get_acl_remote_addr;
@@ -110,6 +111,7 @@ const Octet16 BTM_GetDeviceIDRoot::return_value{
     0xff, 0xff, 0xb2, 0xec, 0x71, 0x2b, 0xae, 0xab};
 bool BTM_ReadConnectedTransportAddress::return_value = false;
 tBTM_STATUS BTM_SetBleDataLength::return_value = 0;
+tBTM_STATUS BTM_RestoreBleDataLength::return_value = 0;
 bool BTM_UseLeLink::return_value = false;
 bool btm_ble_get_acl_remote_addr::return_value = false;
 bool btm_ble_get_enc_key_type::return_value = false;
@@ -245,6 +247,12 @@ tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
   return test::mock::stack_btm_ble::BTM_SetBleDataLength(bd_addr,
                                                          tx_pdu_length);
 }
+tBTM_STATUS BTM_RestoreBleDataLength(const RawAddress& bd_addr,
+                                     uint16_t tx_pdu_length) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_btm_ble::BTM_RestoreBleDataLength(bd_addr,
+                                                             tx_pdu_length);
+}
 bool BTM_UseLeLink(const RawAddress& bd_addr) {
   inc_func_call_count(__func__);
   return test::mock::stack_btm_ble::BTM_UseLeLink(bd_addr);
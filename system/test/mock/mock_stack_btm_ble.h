@@ -385,6 +385,21 @@ struct BTM_SetBleDataLength {
 };
 extern struct BTM_SetBleDataLength BTM_SetBleDataLength;
 
+// Name: BTM_RestoreBleDataLength
+// Params: const RawAddress& bd_addr, uint16_t tx_pdu_length
+// Return: tBTM_STATUS
+struct BTM_RestoreBleDataLength {
+  static tBTM_STATUS return_value;
+  std::function<tBTM_STATUS(const RawAddress& bd_addr, uint16_t tx_pdu_length)>
+      body{[](const RawAddress& /* bd_addr */, uint16_t /* tx_pdu_length */) {
+        return return_value;
+      }};
+  tBTM_STATUS operator()(const RawAddress& bd_addr, uint16_t tx_pdu_length) {
+    return body(bd_addr, tx_pdu_length);
+  };
+};
+extern struct BTM_RestoreBleDataLength BTM_RestoreBleDataLength;
+
 // Name: BTM_UseLeLink
 // Params: const RawAddress& bd_addr
 // Return: bool
@@ -42,6 +42,7 @@ struct BTM_SetLeConnectionModeToSlow BTM_SetLeConnectionModeToSlow;
 struct BTM_AcceptlistAdd BTM_AcceptlistAdd;
 struct BTM_AcceptlistAddDirect BTM_AcceptlistAddDirect;
 struct BTM_AcceptlistRemove BTM_AcceptlistRemove;
+struct BTM_AcceptlistRemoveMany BTM_AcceptlistRemoveMany;
 struct BTM_AcceptlistClear BTM_AcceptlistClear;
 
 }  // namespace stack_btm_ble_bgconn
@@ -74,6 +75,10 @@ void BTM_AcceptlistRemove(const RawAddress& address) {
   inc_func_call_count(__func__);
   test::mock::stack_btm_ble_bgconn::BTM_AcceptlistRemove(address);
 }
+void BTM_AcceptlistRemove(const std::vector<RawAddress>& addresses) {
+  inc_func_call_count(__func__);
+  test::mock::stack_btm_ble_bgconn::BTM_AcceptlistRemoveMany(addresses);
+}
 void BTM_AcceptlistClear() {
   inc_func_call_count(__func__);
   test::mock::stack_btm_ble_bgconn::BTM_AcceptlistClear();
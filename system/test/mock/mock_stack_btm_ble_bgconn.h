@@ -22,6 +22,7 @@
  */
 
 #include <functional>
+#include <vector>
 
 // Original included files, if any
 #include "stack/include/btm_ble_api_types.h"
@@ -88,6 +89,17 @@ struct BTM_AcceptlistRemove {
   void operator()(const RawAddress& address) { body(address); };
 };
 extern struct BTM_AcceptlistRemove BTM_AcceptlistRemove;
+// Name: BTM_AcceptlistRemoveMany
+// Params: const std::vector<RawAddress>& addresses
+// Returns: void
+struct BTM_AcceptlistRemoveMany {
+  std::function<void(const std::vector<RawAddress>& addresses)> body{
+      [](const std::vector<RawAddress>& /* addresses */) {}};
+  void operator()(const std::vector<RawAddress>& addresses) {
+    body(addresses);
+  };
+};
+extern struct BTM_AcceptlistRemoveMany BTM_AcceptlistRemoveMany;
 // Name: BTM_AcceptlistClear
 // Params:
 // Returns: void
@@ -24,6 +24,7 @@
 
 #include "stack/btm/btm_ble_int.h"
 #include "stack/btm/btm_ble_int_types.h"
+#include "stack/include/advertise_data_parser.h"
 #include "stack/include/bt_dev_class.h"
 #include "stack/include/btm_api_types.h"
 #include "stack/include/hci_error_code.h"
@@ -123,7 +124,7 @@ void btm_ble_increment_link_topology_mask(uint8_t /* link_role */) {
 }
 void btm_ble_init(void) { inc_func_call_count(__func__); }
 DEV_CLASS btm_ble_get_appearance_as_cod(
-    std::vector<uint8_t> const& /* data */) {
+    const AdvertiseDataIndex& /* data */) {
   inc_func_call_count(__func__);
   return kDevClassUnclassified;
 }
@@ -103,6 +103,16 @@ void IsoManager::SendIsoData(uint16_t iso_handle, const uint8_t* data,
   pimpl_->SendIsoData(iso_handle, data, data_len);
 }
 
+uint8_t* IsoManager::AcquireIsoSdu(uint16_t iso_handle, uint16_t data_len) {
+  if (!pimpl_) return nullptr;
+  return pimpl_->AcquireIsoSdu(iso_handle, data_len);
+}
+
+void IsoManager::SendIsoSdu(uint16_t iso_handle) {
+  if (!pimpl_) return;
+  pimpl_->SendIsoSdu(iso_handle);
+}
+
 void IsoManager::CreateBig(uint8_t big_id,
                            struct iso_manager::big_create_params big_params) {
   if (!pimpl_) return;
@@ -119,6 +129,11 @@ void IsoManager::HandleIsoData(void* p_msg) {
   pimpl_->HandleIsoData(static_cast<BT_HDR*>(p_msg));
 }
 
+void IsoManager::HandleIsoSdu(const uint8_t* packet, uint16_t len) {
+  if (!pimpl_) return;
+  pimpl_->HandleIsoSdu(packet, len);
+}
+
 void IsoManager::HandleDisconnect(uint16_t handle, uint8_t reason) {
   if (!pimpl_) return;
   pimpl_->HandleDisconnect(handle, reason);
@@ -58,6 +58,9 @@ struct MockIsoManager {
               (uint16_t iso_handle, uint8_t data_path_dir));
   MOCK_METHOD((void), SendIsoData,
               (uint16_t iso_handle, const uint8_t* data, uint16_t data_len));
+  MOCK_METHOD((uint8_t*), AcquireIsoSdu,
+              (uint16_t iso_handle, uint16_t data_len));
+  MOCK_METHOD((void), SendIsoSdu, (uint16_t iso_handle));
   MOCK_METHOD((void), ReadIsoLinkQuality, (uint16_t iso_handle));
   MOCK_METHOD(
       (void), CreateBig,
@@ -65,6 +68,7 @@ struct MockIsoManager {
        struct bluetooth::hci::iso_manager::big_create_params big_params));
   MOCK_METHOD((void), TerminateBig, (uint8_t big_id, uint8_t reason));
   MOCK_METHOD((void), HandleIsoData, (void* p_msg));
+  MOCK_METHOD((void), HandleIsoSdu, (const uint8_t* packet, uint16_t len));
   MOCK_METHOD((void), HandleDisconnect, (uint16_t handle, uint8_t reason));
   MOCK_METHOD((void), HandleNumComplDataPkts,
               (uint16_t handle, uint16_t credits));
@@ -51,6 +51,8 @@ struct GATTS_AddService GATTS_AddService;
 struct GATTS_DeleteService GATTS_DeleteService;
 struct GATTS_HandleValueIndication GATTS_HandleValueIndication;
 struct GATTS_HandleValueNotification GATTS_HandleValueNotification;
+struct GATTS_HandleValueNotifications GATTS_HandleValueNotifications;
+struct GATTS_SetAttributeValueCache GATTS_SetAttributeValueCache;
 struct GATTS_NVRegister GATTS_NVRegister;
 struct GATTS_SendRsp GATTS_SendRsp;
 struct GATTS_StopService GATTS_StopService;
@@ -58,6 +60,7 @@ struct GATT_CancelConnect GATT_CancelConnect;
 struct GATT_Connect GATT_Connect;
 struct GATT_Deregister GATT_Deregister;
 struct GATT_Disconnect GATT_Disconnect;
+struct GATT_SetThroughputProfile GATT_SetThroughputProfile;
 struct GATT_GetConnIdIfConnected GATT_GetConnIdIfConnected;
 struct GATT_GetConnectionInfor GATT_GetConnectionInfor;
 struct GATT_Register GATT_Register;
@@ -90,11 +93,14 @@ tGATT_STATUS GATTS_AddService::return_value = GATT_SUCCESS;
 bool GATTS_DeleteService::return_value = false;
 tGATT_STATUS GATTS_HandleValueIndication::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTS_HandleValueNotification::return_value = GATT_SUCCESS;
+tGATT_STATUS GATTS_HandleValueNotifications::return_value = GATT_SUCCESS;
+tGATT_STATUS GATTS_SetAttributeValueCache::return_value = GATT_SUCCESS;
 bool GATTS_NVRegister::return_value = false;
 tGATT_STATUS GATTS_SendRsp::return_value = GATT_SUCCESS;
 bool GATT_CancelConnect::return_value = false;
 bool GATT_Connect::return_value = false;
 tGATT_STATUS GATT_Disconnect::return_value = GATT_SUCCESS;
+tGATT_STATUS GATT_SetThroughputProfile::return_value = GATT_SUCCESS;
 bool GATT_GetConnIdIfConnected::return_value = false;
 bool GATT_GetConnectionInfor::return_value = false;
 tGATT_IF GATT_Register::return_value = 0;
@@ -180,6 +186,19 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   return test::mock::stack_gatt_api::GATTS_HandleValueNotification(
       conn_id, attr_handle, val_len, p_val);
 }
+tGATT_STATUS GATTS_HandleValueNotifications(
+    uint16_t conn_id, const std::vector<tGATT_NOTIF_VALUE>& values) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTS_HandleValueNotifications(conn_id,
+                                                                    values);
+}
+tGATT_STATUS GATTS_SetAttributeValueCache(
+    tGATT_IF gatt_if, uint16_t attr_handle,
+    std::optional<std::vector<uint8_t>> value) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATTS_SetAttributeValueCache(
+      gatt_if, attr_handle, std::move(value));
+}
 bool GATTS_NVRegister(tGATT_APPL_INFO* p_cb_info) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATTS_NVRegister(p_cb_info);
@@ -216,6 +235,12 @@ tGATT_STATUS GATT_Disconnect(uint16_t conn_id) {
   inc_func_call_count(__func__);
   return test::mock::stack_gatt_api::GATT_Disconnect(conn_id);
 }
+tGATT_STATUS GATT_SetThroughputProfile(uint16_t conn_id,
+                                       tGATT_THROUGHPUT_PROFILE profile) {
+  inc_func_call_count(__func__);
+  return test::mock::stack_gatt_api::GATT_SetThroughputProfile(conn_id,
+                                                               profile);
+}
 bool GATT_GetConnIdIfConnected(tGATT_IF gatt_if, const RawAddress& bd_addr,
                                uint16_t* p_conn_id, tBT_TRANSPORT transport) {
   inc_func_call_count(__func__);
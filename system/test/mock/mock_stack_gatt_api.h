@@ -253,6 +253,42 @@ struct GATTS_HandleValueNotification {
 };
 extern struct GATTS_HandleValueNotification GATTS_HandleValueNotification;
 
+// Name: GATTS_HandleValueNotifications
+// Params: uint16_t conn_id, const std::vector<tGATT_NOTIF_VALUE>& values
+// Return: tGATT_STATUS
+struct GATTS_HandleValueNotifications {
+  static tGATT_STATUS return_value;
+  std::function<tGATT_STATUS(uint16_t conn_id,
+                             const std::vector<tGATT_NOTIF_VALUE>& values)>
+      body{[](uint16_t /* conn_id */,
+              const std::vector<tGATT_NOTIF_VALUE>& /* values */) {
+        return return_value;
+      }};
+  tGATT_STATUS operator()(uint16_t conn_id,
+                          const std::vector<tGATT_NOTIF_VALUE>& values) {
+    return body(conn_id, values);
+  };
+};
+extern struct GATTS_HandleValueNotifications GATTS_HandleValueNotifications;
+
+// Name: GATTS_SetAttributeValueCache
+// Params: tGATT_IF gatt_if, uint16_t attr_handle,
+// std::optional<std::vector<uint8_t>> value Return: tGATT_STATUS
+struct GATTS_SetAttributeValueCache {
+  static tGATT_STATUS return_value;
+  std::function<tGATT_STATUS(tGATT_IF gatt_if, uint16_t attr_handle,
+                             std::optional<std::vector<uint8_t>> value)>
+      body{[](tGATT_IF /* gatt_if */, uint16_t /* attr_handle */,
+              std::optional<std::vector<uint8_t>> /* value */) {
+        return return_value;
+      }};
+  tGATT_STATUS operator()(tGATT_IF gatt_if, uint16_t attr_handle,
+                          std::optional<std::vector<uint8_t>> value) {
+    return body(gatt_if, attr_handle, std::move(value));
+  };
+};
+extern struct GATTS_SetAttributeValueCache GATTS_SetAttributeValueCache;
+
 // Name: GATTS_NVRegister
 // Params: tGATT_APPL_INFO* p_cb_info
 // Return: bool
@@ -350,6 +386,22 @@ struct GATT_Disconnect {
 };
 extern struct GATT_Disconnect GATT_Disconnect;
 
+// Name: GATT_SetThroughputProfile
+// Params: uint16_t conn_id, tGATT_THROUGHPUT_PROFILE profile
+// Return: tGATT_STATUS
+struct GATT_SetThroughputProfile {
+  static tGATT_STATUS return_value;
+  std::function<tGATT_STATUS(uint16_t conn_id,
+                             tGATT_THROUGHPUT_PROFILE profile)>
+      body{[](uint16_t /* conn_id */, tGATT_THROUGHPUT_PROFILE /* profile */) {
+        return return_value;
+      }};
+  tGATT_STATUS operator()(uint16_t conn_id, tGATT_THROUGHPUT_PROFILE profile) {
+    return body(conn_id, profile);
+  };
+};
+extern struct GATT_SetThroughputProfile GATT_SetThroughputProfile;
+
 // Name: GATT_GetConnIdIfConnected
 // Params: tGATT_IF gatt_if, const RawAddress& bd_addr, uint16_t* p_conn_id,
 // tBT_TRANSPORT transport Return: bool
@@ -59,6 +59,11 @@ std::set<tAPP_ID> connection_manager::get_apps_connecting_to(
   return std::set<tAPP_ID>();
 }
 void connection_manager::dump(int /* fd */) { inc_func_call_count(__func__); }
+connection_manager::tPENDING_CONNECTIONS
+connection_manager::get_pending_connections() {
+  inc_func_call_count(__func__);
+  return {};
+}
 void connection_manager::on_app_deregistered(uint8_t /* app_id */) {
   inc_func_call_count(__func__);
 }
@@ -107,3 +107,4 @@ int PORT_GetSecurityMask(uint16_t /* handle */, uint16_t* /* sec_mask */) {
   return 0;
 }
 void RFCOMM_Init(void) { inc_func_call_count(__func__); }
+void PORT_Dumpsys(int /* fd */) { inc_func_call_count(__func__); }
@@ -29,6 +29,7 @@
 #include "os/log.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
+#include "osi/include/buffer_pool.h"
 #include "osi/include/config.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/future.h"
@@ -38,6 +39,7 @@
 #include "osi/include/ringbuffer.h"
 #include "osi/include/socket.h"
 #include "osi/include/thread.h"
+#include "osi/include/thread_scheduler.h"
 #include "osi/include/wakelock.h"
 #include "osi/src/compat.cc"  // For strlcpy
 #include "test/common/fake_osi.h"
@@ -255,6 +257,16 @@ void thread_free(thread_t* thread) { inc_func_call_count(__func__); }
 void thread_join(thread_t* thread) { inc_func_call_count(__func__); }
 void thread_stop(thread_t* thread) { inc_func_call_count(__func__); }
 
+const char* thread_role_text(ThreadRole role) {
+  inc_func_call_count(__func__);
+  return "";
+}
+bool thread_scheduler_apply_policy(pid_t linux_tid, ThreadRole role) {
+  inc_func_call_count(__func__);
+  return true;
+}
+void thread_scheduler_dump(int fd) { inc_func_call_count(__func__); }
+
 char* osi_strdup(const char* str) {
   inc_func_call_count(__func__);
   return nullptr;
@@ -273,6 +285,25 @@ void* osi_malloc(size_t size) {
   inc_func_call_count(__func__);
   return nullptr;
 }
+void* osi_calloc_tagged(size_t size, const char* tag) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+void* osi_malloc_tagged(size_t size, const char* tag) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+void osi_alloc_accounting_dump(int fd) { inc_func_call_count(__func__); }
+void* buffer_pool_alloc(size_t size) {
+  inc_func_call_count(__func__);
+  return nullptr;
+}
+void buffer_pool_free(void* ptr) { inc_func_call_count(__func__); }
+bool buffer_pool_owns(const void* ptr) {
+  inc_func_call_count(__func__);
+  return false;
+}
+void buffer_pool_debug_dump(int fd) { inc_func_call_count(__func__); }
 
 bool fixed_queue_is_empty(fixed_queue_t* queue) {
   inc_func_call_count(__func__);
@@ -544,6 +575,18 @@ size_t ringbuffer_size(const ringbuffer_t* rb) {
   return 0;
 }
 void ringbuffer_free(ringbuffer_t* rb) { inc_func_call_count(__func__); }
+size_t ringbuffer_read_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+  inc_func_call_count(__func__);
+  return 0;
+}
+size_t ringbuffer_write_spans(ringbuffer_t* rb, ringbuffer_span_t spans[2]) {
+  inc_func_call_count(__func__);
+  return 0;
+}
+size_t ringbuffer_commit(ringbuffer_t* rb, size_t length) {
+  inc_func_call_count(__func__);
+  return 0;
+}
 
 bool osi_property_get_bool(const char* key, bool default_value) {
   inc_func_call_count(__func__);
@@ -585,3 +628,6 @@ void wakelock_set_os_callouts(bt_os_callouts_t* callouts) {
 void wakelock_set_paths(const char* lock_path, const char* unlock_path) {
   inc_func_call_count(__func__);
 }
+void wakelock_set_release_delay(int64_t delay_ms) {
+  inc_func_call_count(__func__);
+}
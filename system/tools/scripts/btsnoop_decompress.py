@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+This script decompresses a btsnoop log written with
+persist.bluetooth.btsnoopcompression enabled back to a btsnoop log file,
+which can be viewed using standard tools like Wireshark.
+
+The compressed log is a gzip stream of the btsnoop log. It is flushed at
+sync points from where it can be decompressed on its own, listed in a
+sidecar index file (<log>.idx):
+
+index {
+  magic "BTSNPIDX"
+  repeated {
+    btsnoop timestamp of the first record    (big endian, 8 bytes)
+    offset of the sync point in the log      (big endian, 8 bytes)
+    offset of the record once decompressed   (big endian, 8 bytes)
+  }
+}
+
+With --since, the index is used to start decompressing from the closest sync
+point instead of the beginning of the log.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+BTSNOOP_FILE_HEADER = b'btsnoop\x00\x00\x00\x00\x01\x00\x00\x03\xea'
+BTSNOOP_RECORD_HEADER = '>IIIIQ'
+BTSNOOP_RECORD_HEADER_SIZE = struct.calcsize(BTSNOOP_RECORD_HEADER)
+
+# Epoch in microseconds since 01/01/0000.
+BTSNOOP_EPOCH_DELTA = 0x00dcddb30f2f8000
+
+INDEX_MAGIC = b'BTSNPIDX'
+INDEX_ENTRY = '>QQQ'
+INDEX_ENTRY_SIZE = struct.calcsize(INDEX_ENTRY)
+
+
+def read_index(index_path):
+    """
+  Returns the (timestamp, compressed offset, decompressed offset) entries of
+  the index file.
+  """
+    with open(index_path, 'rb') as f:
+        index = f.read()
+    if not index.startswith(INDEX_MAGIC):
+        raise RuntimeError('%s is not a btsnoop index' % index_path)
+    entries = []
+    offset = len(INDEX_MAGIC)
+    while offset + INDEX_ENTRY_SIZE <= len(index):
+        entries.append(struct.unpack_from(INDEX_ENTRY, index, offset))
+        offset += INDEX_ENTRY_SIZE
+    return entries
+
+
+def decompress(data, offset):
+    """
+  Decompresses the log from |offset|, the gzip header at offset 0 or a sync
+  point otherwise. A log not closed properly is decompressed up to its last
+  sync point.
+  """
+    decompressor = zlib.decompressobj(15 + 16 if offset == 0 else -15)
+    return decompressor.decompress(data[offset:])
+
+
+def skip_records_before(records, timestamp):
+    """
+  Returns |records| from the first one logged at or after |timestamp|.
+  """
+    offset = 0
+    while offset + BTSNOOP_RECORD_HEADER_SIZE <= len(records):
+        _, included_length, _, _, record_timestamp = struct.unpack_from(BTSNOOP_RECORD_HEADER, records, offset)
+        if record_timestamp >= timestamp:
+            break
+        offset += BTSNOOP_RECORD_HEADER_SIZE + included_length
+    return records[offset:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decompresses a compressed btsnoop log.')
+    parser.add_argument('log', help='compressed btsnoop log, e.g. btsnoop_hci.log.gz')
+    parser.add_argument('output', help='btsnoop log to write')
+    parser.add_argument('--since',
+                        type=float,
+                        help='only keep the records logged from this time, in seconds since the Unix epoch')
+    args = parser.parse_args()
+
+    with open(args.log, 'rb') as f:
+        data = f.read()
+
+    if args.since is None:
+        decompressed = decompress(data, 0)
+    else:
+        timestamp = int(args.since * 1000000) + BTSNOOP_EPOCH_DELTA
+        index_path = args.log + '.idx'
+        start = (0, 0)
+        if os.path.exists(index_path):
+            for entry_timestamp, compressed_offset, decompressed_offset in read_index(index_path):
+                if entry_timestamp > timestamp:
+                    break
+                start = (compressed_offset, decompressed_offset)
+        else:
+            sys.stderr.write('No index found, decompressing the whole log.\n')
+
+        records = decompress(data, start[0])
+        if start[0] == 0:
+            records = records[len(BTSNOOP_FILE_HEADER):]
+        decompressed = BTSNOOP_FILE_HEADER + skip_records_before(records, timestamp)
+
+    with open(args.output, 'wb') as f:
+        f.write(decompressed)
+
+
+if __name__ == '__main__':
+    main()
@@ -68,6 +68,14 @@ void Beacon::Tick() {
   }
 }
 
+bool Beacon::IsListening(LinkLayerPacketView const& packet,
+                         Phy::Type type) const {
+  // Beacons only answer the scan requests they are the target of.
+  return type == Phy::Type::LOW_ENERGY &&
+         packet.GetType() == PacketType::LE_SCAN &&
+         packet.GetDestinationAddress() == address_;
+}
+
 void Beacon::ReceiveLinkLayerPacket(LinkLayerPacketView packet,
                                     Phy::Type /*type*/, int8_t /*rssi*/) {
   if (packet.GetDestinationAddress() == address_ &&
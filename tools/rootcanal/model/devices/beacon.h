@@ -47,6 +47,8 @@ class Beacon : public Device {
   virtual void ReceiveLinkLayerPacket(
       model::packets::LinkLayerPacketView packet, Phy::Type type,
       int8_t rssi) override;
+  virtual bool IsListening(model::packets::LinkLayerPacketView const& packet,
+                           Phy::Type type) const override;
 
  protected:
   model::packets::LegacyAdvertisingType advertising_type_{};
@@ -59,6 +59,16 @@ class Device {
       model::packets::LinkLayerPacketView /*packet*/, Phy::Type /*type*/,
       int8_t /*rssi*/) {}
 
+  // Return false if the device ignores the link layer packet, in which case
+  // the phy layer skips it without computing the RSSI or delivering
+  // the packet. Devices that handle only a few packets override this
+  // to be cheap to simulate in dense environments.
+  virtual bool IsListening(
+      model::packets::LinkLayerPacketView const& /*packet*/,
+      Phy::Type /*type*/) const {
+    return true;
+  }
+
   void SendLinkLayerPacket(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
       Phy::Type type, int8_t tx_power = 0);
@@ -48,18 +48,14 @@ void PhyDevice::SetAddress(bluetooth::hci::Address address) {
   device_->SetAddress(std::move(address));
 }
 
-void PhyDevice::Receive(std::vector<uint8_t> const& packet, Phy::Type type,
-                        int8_t rssi) {
-  std::shared_ptr<std::vector<uint8_t>> packet_copy =
-      std::make_shared<std::vector<uint8_t>>(packet);
-  model::packets::LinkLayerPacketView packet_view =
-      model::packets::LinkLayerPacketView::Create(
-          pdl::packet::slice(packet_copy));
-  if (packet_view.IsValid()) {
-    device_->ReceiveLinkLayerPacket(std::move(packet_view), type, rssi);
-  } else {
-    WARNING("received invalid LL packet");
-  }
+bool PhyDevice::IsListening(model::packets::LinkLayerPacketView const& packet,
+                            Phy::Type type) const {
+  return device_->IsListening(packet, type);
+}
+
+void PhyDevice::Receive(model::packets::LinkLayerPacketView const& packet,
+                        Phy::Type type, int8_t rssi) {
+  device_->ReceiveLinkLayerPacket(packet, type, rssi);
 }
 
 void PhyDevice::Send(std::vector<uint8_t> const& packet, Phy::Type type,
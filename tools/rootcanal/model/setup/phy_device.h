@@ -39,7 +39,10 @@ class PhyDevice {
   void Unregister(PhyLayer* phy);
 
   void Tick();
-  void Receive(std::vector<uint8_t> const& packet, Phy::Type type, int8_t rssi);
+  bool IsListening(model::packets::LinkLayerPacketView const& packet,
+                   Phy::Type type) const;
+  void Receive(model::packets::LinkLayerPacketView const& packet,
+               Phy::Type type, int8_t rssi);
   void Send(std::vector<uint8_t> const& packet, Phy::Type type,
             int8_t tx_power);
 
@@ -16,6 +16,8 @@
 
 #include "phy_layer.h"
 
+#include <log.h>
+
 #include <sstream>
 
 namespace rootcanal {
@@ -57,10 +59,23 @@ int8_t PhyLayer::ComputeRssi(PhyDevice::Identifier /*sender_id*/,
 
 void PhyLayer::Send(std::vector<uint8_t> const& packet, int8_t tx_power,
                     PhyDevice::Identifier sender_id) {
+  // Parse the packet once for all the receivers, the view shares
+  // the packet bytes instead of copying them to each receiver.
+  std::shared_ptr<std::vector<uint8_t>> packet_copy =
+      std::make_shared<std::vector<uint8_t>>(packet);
+  model::packets::LinkLayerPacketView packet_view =
+      model::packets::LinkLayerPacketView::Create(
+          pdl::packet::slice(packet_copy));
+  if (!packet_view.IsValid()) {
+    WARNING("sent invalid LL packet");
+    return;
+  }
+
   for (const auto& device : phy_devices_) {
-    // Do not send the packet back to the sender.
-    if (sender_id != device->id) {
-      device->Receive(packet, type,
+    // Do not send the packet back to the sender, nor to devices
+    // that ignore it.
+    if (sender_id != device->id && device->IsListening(packet_view, type)) {
+      device->Receive(packet_view, type,
                       ComputeRssi(sender_id, device->id, tx_power));
     }
   }
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/setup/phy_layer.h"
+
+#include <gtest/gtest.h>
+
+#include "model/devices/device.h"
+#include "packets/link_layer_packets.h"
+
+namespace rootcanal {
+
+using namespace model::packets;
+
+// Device counting the link layer packets it receives, and listening only
+// to the packets sent to its address when filtering is enabled.
+class CountingDevice : public Device {
+ public:
+  CountingDevice(Address address, bool filtering) : filtering_(filtering) {
+    SetAddress(address);
+  }
+
+  std::string GetTypeString() const override { return "counting_device"; }
+
+  bool IsListening(LinkLayerPacketView const& packet,
+                   Phy::Type /*type*/) const override {
+    return !filtering_ || packet.GetDestinationAddress() == address_;
+  }
+
+  void ReceiveLinkLayerPacket(LinkLayerPacketView packet, Phy::Type /*type*/,
+                              int8_t /*rssi*/) override {
+    ASSERT_TRUE(packet.IsValid());
+    received_++;
+  }
+
+  size_t received_{0};
+
+ private:
+  bool filtering_;
+};
+
+// Phy layer counting the RSSI computations.
+class CountingPhyLayer : public PhyLayer {
+ public:
+  CountingPhyLayer() : PhyLayer(0, Phy::Type::LOW_ENERGY) {}
+
+  int8_t ComputeRssi(PhyDevice::Identifier /*sender_id*/,
+                     PhyDevice::Identifier /*receiver_id*/,
+                     int8_t /*tx_power*/) override {
+    rssi_computations_++;
+    return -50;
+  }
+
+  size_t rssi_computations_{0};
+};
+
+class PhyLayerTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<CountingDevice> AddDevice(uint8_t address_byte,
+                                            bool filtering) {
+    Address address(std::array<uint8_t, 6>{address_byte, 0, 0, 0, 0, 0});
+    auto device = std::make_shared<CountingDevice>(address, filtering);
+    phy_devices_.push_back(std::make_shared<PhyDevice>("test", device));
+    phy_layer_.Register(phy_devices_.back());
+    return device;
+  }
+
+  static std::vector<uint8_t> ScanPacket(Address source, Address destination) {
+    return LeScanBuilder::Create(source, destination, AddressType::PUBLIC,
+                                 AddressType::PUBLIC)
+        ->SerializeToBytes();
+  }
+
+  void TearDown() override { phy_layer_.UnregisterAll(); }
+
+  CountingPhyLayer phy_layer_;
+  std::vector<std::shared_ptr<PhyDevice>> phy_devices_;
+};
+
+TEST_F(PhyLayerTest, DeliveredToAllDevicesButSender) {
+  constexpr size_t kDeviceCount = 100;
+  std::vector<std::shared_ptr<CountingDevice>> devices;
+  for (size_t i = 0; i < kDeviceCount; i++) {
+    devices.push_back(AddDevice(static_cast<uint8_t>(i), false));
+  }
+
+  phy_layer_.Send(ScanPacket(devices[0]->GetAddress(), Address::kEmpty), 0,
+                  devices[0]->id_);
+
+  ASSERT_EQ(devices[0]->received_, 0u);
+  for (size_t i = 1; i < kDeviceCount; i++) {
+    ASSERT_EQ(devices[i]->received_, 1u);
+  }
+  ASSERT_EQ(phy_layer_.rssi_computations_, kDeviceCount - 1);
+}
+
+TEST_F(PhyLayerTest, SkipsDevicesNotListening) {
+  auto sender = AddDevice(1, false);
+  auto target = AddDevice(2, true);
+  auto other = AddDevice(3, true);
+
+  phy_layer_.Send(ScanPacket(sender->GetAddress(), target->GetAddress()), 0,
+                  sender->id_);
+
+  ASSERT_EQ(target->received_, 1u);
+  ASSERT_EQ(other->received_, 0u);
+  ASSERT_EQ(phy_layer_.rssi_computations_, 1u);
+}
+
+TEST_F(PhyLayerTest, InvalidPacketDropped) {
+  auto sender = AddDevice(1, false);
+  auto receiver = AddDevice(2, false);
+
+  phy_layer_.Send(std::vector<uint8_t>{0x01, 0x02}, 0, sender->id_);
+
+  ASSERT_EQ(receiver->received_, 0u);
+  ASSERT_EQ(phy_layer_.rssi_computations_, 0u);
+}
+
+}  // namespace rootcanal